@@ -0,0 +1,137 @@
+#include <ATen/BatchedFallback.h>
+#include <ATen/VmapTransforms.h>
+#include <ATen/Utils.h>
+
+#include <algorithm>
+
+namespace at {
+
+// Returns true if the operator writes to any of its arguments.
+static bool isInplaceOp(const c10::FunctionSchema& schema) {
+  return schema.is_mutable();
+}
+
+// Returns true if any of the returns of the operator is a view of an argument.
+static bool returnsAlias(const c10::FunctionSchema& schema) {
+  return std::any_of(
+      schema.returns().begin(),
+      schema.returns().end(),
+      [](const c10::Argument& ret) { return ret.alias_info().has_value(); });
+}
+
+static bool areAllReturnsTensors(const c10::FunctionSchema& schema) {
+  return std::all_of(
+      schema.returns().begin(),
+      schema.returns().end(),
+      [](const c10::Argument& ret) { return ret.type() == c10::TensorType::get(); });
+}
+
+void batchedTensorForLoopFallback(const c10::OperatorHandle& op, torch::jit::Stack* stack) {
+  const auto& schema = op.schema();
+  TORCH_CHECK(
+      !isInplaceOp(schema) && !returnsAlias(schema),
+      "Batching rule not implemented for ", schema.name(), ". ",
+      "We could not generate a fallback for it because it is an in-place or ",
+      "view operation.");
+  TORCH_CHECK(
+      areAllReturnsTensors(schema),
+      "Batching rule not implemented for ", schema.name(), ". ",
+      "We could not generate a fallback for it because it doesn't only return Tensors.");
+
+  const auto num_returns = schema.returns().size();
+  const auto num_arguments = schema.arguments().size();
+  auto arguments = torch::jit::pop(*stack, num_arguments);
+
+  // Figure out which arguments are BatchedTensors and give all of them the
+  // same batch dims, at the front.
+  SmallVector<int64_t, kVmapTransformStaticInputSize> batched_tensor_inputs_position;
+  std::vector<Tensor> batched_tensor_inputs;
+  for (int64_t idx = 0; idx < arguments.size(); ++idx) {
+    const auto& ivalue = arguments[idx];
+    if (ivalue.isTensorList()) {
+      for (const auto& tensor : ivalue.toTensorVector()) {
+        TORCH_CHECK(
+            !isBatched(tensor),
+            "Batching rule not implemented for ", schema.name(), ". ",
+            "We could not generate a fallback for it because it takes a list of ",
+            "Tensors, one of which is being vmapped over.");
+      }
+      continue;
+    }
+    if (!ivalue.isTensor()) {
+      continue;
+    }
+    const auto& tensor = ivalue.toTensor();
+    if (!tensor.defined() || !isBatched(tensor)) {
+      continue;
+    }
+    batched_tensor_inputs.push_back(tensor);
+    batched_tensor_inputs_position.push_back(idx);
+  }
+  TORCH_INTERNAL_ASSERT(!batched_tensor_inputs.empty());
+  auto input_physical_views = MultiBatchVmapTransform::logicalToPhysical(batched_tensor_inputs);
+
+  const auto num_batch_dims = input_physical_views.front().numBatchDims();
+  const auto batch_sizes =
+      input_physical_views.front().tensor().sizes().slice(0, num_batch_dims);
+  const auto num_batches = prod_intlist(batch_sizes);
+  TORCH_CHECK(
+      num_batches > 0,
+      "Batching rule not implemented for ", schema.name(), ". ",
+      "We could not generate a fallback for it because the batch is empty.");
+
+  // Run the operator once per example. The returns of example `b` are
+  // output_slices[b * num_returns, (b + 1) * num_returns).
+  std::vector<Tensor> output_slices;
+  output_slices.reserve(num_batches * num_returns);
+  VmapDimVector index(num_batch_dims, 0);
+  for (int64_t linear_idx = 0; linear_idx < num_batches; ++linear_idx) {
+    int64_t batched_idx = 0;
+    for (int64_t arg_idx = 0; arg_idx < num_arguments; ++arg_idx) {
+      if (batched_idx < batched_tensor_inputs_position.size() &&
+          batched_tensor_inputs_position[batched_idx] == arg_idx) {
+        auto slice = input_physical_views[batched_idx].tensor();
+        for (int64_t bdim = 0; bdim < num_batch_dims; ++bdim) {
+          slice = slice.select(0, index[bdim]);
+        }
+        torch::jit::push(stack, slice);
+        batched_idx++;
+      } else {
+        torch::jit::push(stack, arguments[arg_idx]);
+      }
+    }
+
+    op.callBoxed(stack);
+
+    auto returns = torch::jit::pop(*stack, num_returns);
+    for (const auto& ret : returns) {
+      output_slices.push_back(ret.toTensor());
+    }
+
+    // Move on to the next example, in row-major order of the batch dims.
+    for (int64_t bdim = num_batch_dims - 1; bdim >= 0; --bdim) {
+      if (++index[bdim] < batch_sizes[bdim]) {
+        break;
+      }
+      index[bdim] = 0;
+    }
+  }
+
+  // Stack the slices of each return and put the batch dims back.
+  for (int64_t return_idx = 0; return_idx < num_returns; ++return_idx) {
+    std::vector<Tensor> slices;
+    slices.reserve(num_batches);
+    for (int64_t linear_idx = 0; linear_idx < num_batches; ++linear_idx) {
+      slices.push_back(output_slices[linear_idx * num_returns + return_idx]);
+    }
+    auto stacked = at::stack(slices);
+    VmapDimVector physical_sizes(batch_sizes.begin(), batch_sizes.end());
+    auto slice_sizes = slices.front().sizes();
+    physical_sizes.insert(physical_sizes.end(), slice_sizes.begin(), slice_sizes.end());
+    torch::jit::push(
+        stack,
+        input_physical_views.front().newLogicalFromPhysical(stacked.view(physical_sizes)));
+  }
+}
+
+} // namespace at
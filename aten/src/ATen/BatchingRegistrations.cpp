@@ -1,6 +1,8 @@
 #include <torch/library.h>
 #include <ATen/VmapTransforms.h>
+#include <ATen/BatchedFallback.h>
 #include <ATen/ATen.h>
+#include <ATen/Utils.h>
 
 namespace at {
 
@@ -18,7 +20,8 @@ namespace at {
 // NOTE: [When should I add a batching rule?]
 // When you are adding a new operator, you'll need to add a batching rule so
 // that vmap can work efficiently with said operator. If you do not, we'll attempt
-// to generate a slow fallback for the batching rule (this is not yet implemented).
+// to generate a slow fallback for the batching rule
+// (see NOTE in BatchedFallback.h).
 
 // NOTE: [How to write batching rules?]
 // The signature of a batching rule should look like exactly like the C++ signature
@@ -47,19 +50,74 @@ namespace at {
 // if not use the same mechanism. In order to accomplish that we might have to
 // do some refactoring.
 
-Tensor sum_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
-  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
-  auto dims_physical = self_physical.getPhysicalDims(dims);
-  auto result = at::sum(self_physical.tensor(), dims_physical, keepdim, dtype);
-  return self_physical.newLogicalFromPhysical(result);
+// Pointwise unary ops don't care where the batch dims are: the op runs on the
+// underlying physical tensor, whose result has the same sizes and hence the
+// same batch dims.
+template <typename F, F Func, typename... ExtraArgs>
+Tensor unwrap_and_call(const Tensor& input, ExtraArgs... args) {
+  auto* input_batched = unsafeGetBatched(input);
+  auto output_physical = Func(input_batched->value(), args...);
+  auto old_bdims = input_batched->bdims();
+  return makeBatched(output_physical, BatchDims(old_bdims.begin(), old_bdims.end()));
 }
 
-Tensor mul_batching_rule(const Tensor& self, const Tensor& other) {
+template <typename F, F Func, typename... ExtraArgs>
+Tensor binary_pointwise_batching_rule(
+    const Tensor& self, const Tensor& other, ExtraArgs... args) {
+  // If only one of the tensors is batched and the other one doesn't have more
+  // (logical) dims, the batch dims at the front of the physical tensor are
+  // already lined up for broadcasting. This skips the views of
+  // BroadcastingVmapTransform and keeps a wrapped number (e.g. `x * 2.`)
+  // a 0-dim tensor, which doesn't participate in type promotion.
+  if (!isBatched(other) && other.dim() <= self.dim()) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto result = Func(self_physical.tensor(), other, args...);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  if (!isBatched(self) && self.dim() <= other.dim()) {
+    auto other_physical = MultiBatchVmapTransform::logicalToPhysical(other);
+    auto result = Func(self, other_physical.tensor(), args...);
+    return other_physical.newLogicalFromPhysical(result);
+  }
   auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
-  auto result = at::mul(physical_args[0].tensor(), physical_args[1].tensor());
+  auto result = Func(physical_args[0].tensor(), physical_args[1].tensor(), args...);
   return physical_args[0].newLogicalFromPhysical(result);
 }
 
+// Reductions over the logical `dims` of self. As for the operators, an empty
+// `dims` reduces over all of the (logical) dims.
+template <typename F, F Func>
+Tensor reduction_dims_batching_rule(
+    const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto self_physical_tensor = self_physical.tensor();
+  VmapDimVector dims_physical;
+  if (self.dim() == 0) {
+    // Reducing a (logical) scalar is the identity up to dtype promotion. The
+    // physical tensor gets a size-one dim to reduce over, the batch dims would
+    // be reduced over otherwise.
+    for (auto dim : dims) {
+      maybe_wrap_dim(dim, /*logical_dim*/0);
+    }
+    self_physical_tensor = self_physical_tensor.unsqueeze(-1);
+    dims_physical.push_back(self_physical_tensor.dim() - 1);
+    keepdim = false;
+  } else if (dims.empty()) {
+    for (int64_t dim = self_physical.numBatchDims(); dim < self_physical_tensor.dim(); dim++) {
+      dims_physical.push_back(dim);
+    }
+  } else {
+    dims_physical = self_physical.getPhysicalDims(dims);
+  }
+  auto result = Func(self_physical_tensor, dims_physical, keepdim, dtype);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+template <typename F, F Func>
+Tensor reduction_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  return reduction_dims_batching_rule<F, Func>(self, /*dims=*/{}, /*keepdim=*/false, dtype);
+}
+
 Tensor expand_batching_rule(const Tensor& self, IntArrayRef size, bool implicit) {
   auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
   auto size_physical = self_physical.getPhysicalShape(size);
@@ -142,12 +200,212 @@ Tensor permute_batching_rule(const Tensor& self, IntArrayRef dims) {
   return self_physical.newLogicalFromPhysical(result);
 }
 
-void batchedTensorFallback(const c10::OperatorHandle& op, torch::jit::Stack* stack) {
-  TORCH_CHECK(false, "NYI: Calling ", op.schema().name(), " inside of vmap");
+Tensor squeeze_batching_rule(const Tensor& self) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto physical_sizes = self_physical.tensor().sizes();
+  auto num_batch_dims = self_physical.numBatchDims();
+
+  // Don't squeeze the batch dims, even if some of them have size one.
+  VmapDimVector squeezed_sizes(physical_sizes.begin(), physical_sizes.begin() + num_batch_dims);
+  for (int64_t dim = num_batch_dims; dim < physical_sizes.size(); dim++) {
+    if (physical_sizes[dim] != 1) {
+      squeezed_sizes.push_back(physical_sizes[dim]);
+    }
+  }
+  auto result = self_physical.tensor().view(squeezed_sizes);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor view_batching_rule(const Tensor& self, IntArrayRef size) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto size_physical = self_physical.getPhysicalShape(size);
+  auto result = self_physical.tensor().view(size_physical);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor reshape_batching_rule(const Tensor& self, IntArrayRef shape) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto shape_physical = self_physical.getPhysicalShape(shape);
+  auto result = self_physical.tensor().reshape(shape_physical);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor select_batching_rule(const Tensor& self, int64_t dim, int64_t index) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto dim_physical = self_physical.getPhysicalDim(dim);
+  auto result = self_physical.tensor().select(dim_physical, index);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor slice_batching_rule(const Tensor& self, int64_t dim, int64_t start, int64_t end, int64_t step) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto dim_physical = self_physical.getPhysicalDim(dim);
+  auto result = self_physical.tensor().slice(dim_physical, start, end, step);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor diagonal_batching_rule(const Tensor& self, int64_t offset, int64_t dim1, int64_t dim2) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto dim1_physical = self_physical.getPhysicalDim(dim1);
+  auto dim2_physical = self_physical.getPhysicalDim(dim2);
+  auto result = at::diagonal(self_physical.tensor(), offset, dim1_physical, dim2_physical);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor unfold_batching_rule(const Tensor& self, int64_t dim, int64_t size, int64_t step) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto dim_physical = self_physical.getPhysicalDim(dim);
+  auto result = self_physical.tensor().unfold(dim_physical, size, step);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+std::vector<Tensor> unbind_batching_rule(const Tensor& self, int64_t dim) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto dim_physical = self_physical.getPhysicalDim(dim);
+  auto result = at::unbind(self_physical.tensor(), dim_physical);
+  for (auto& tensor : result) {
+    tensor = self_physical.newLogicalFromPhysical(tensor);
+  }
+  return result;
+}
+
+std::vector<Tensor> split_batching_rule(const Tensor& self, int64_t split_size, int64_t dim) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto dim_physical = self_physical.getPhysicalDim(dim);
+  auto result = at::split(self_physical.tensor(), split_size, dim_physical);
+  for (auto& tensor : result) {
+    tensor = self_physical.newLogicalFromPhysical(tensor);
+  }
+  return result;
+}
+
+// Implements at::matmul's semantics on the logical tensors; mm, mv, dot and
+// bmm are special cases of it.
+Tensor matmul_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(self.dim() > 0 && other.dim() > 0,
+      "matmul: both arguments need to be at least 1D, but they are ",
+      self.dim(), "D and ", other.dim(), "D");
+
+  // The common case of per-example inputs multiplied with a shared matrix
+  // (e.g. the weight of a linear layer): at::matmul treats the batch dims of
+  // self as more rows of one matrix product.
+  if (!isBatched(other) && other.dim() <= 2) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto result = at::matmul(self_physical.tensor(), other);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+
+  // Otherwise vectors become matrices (a row for self, a column for other), so
+  // that after BroadcastingVmapTransform pads both of them to the same number of
+  // dims, at::matmul broadcasts their batch dims and the logical ones alike.
+  const bool self_is_vector = self.dim() == 1;
+  const bool other_is_vector = other.dim() == 1;
+  auto physical_args = BroadcastingVmapTransform::logicalToPhysical({
+      self_is_vector ? self.unsqueeze(0) : self,
+      other_is_vector ? other.unsqueeze(1) : other});
+  auto result = physical_args[0].newLogicalFromPhysical(
+      at::matmul(physical_args[0].tensor(), physical_args[1].tensor()));
+  if (other_is_vector) {
+    result = result.squeeze(-1);
+  }
+  if (self_is_vector) {
+    result = result.squeeze(other_is_vector ? -1 : -2);
+  }
+  return result;
+}
+
+Tensor mm_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(self.dim() == 2 && other.dim() == 2,
+      "mm: expected two matrices, but got tensors of ", self.dim(), "D and ", other.dim(), "D");
+  return matmul_batching_rule(self, other);
+}
+
+Tensor mv_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(self.dim() == 2 && other.dim() == 1,
+      "mv: expected a matrix and a vector, but got tensors of ", self.dim(), "D and ", other.dim(), "D");
+  return matmul_batching_rule(self, other);
+}
+
+Tensor dot_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(self.dim() == 1 && other.dim() == 1,
+      "dot: expected 1D tensors, but got tensors of ", self.dim(), "D and ", other.dim(), "D");
+  return matmul_batching_rule(self, other);
+}
+
+Tensor bmm_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(self.dim() == 3 && other.dim() == 3,
+      "bmm: expected 3D tensors, but got tensors of ", self.dim(), "D and ", other.dim(), "D");
+  TORCH_CHECK(self.size(0) == other.size(0),
+      "bmm: expected tensors with the same batch size, but got ", self.size(0), " and ", other.size(0));
+  return matmul_batching_rule(self, other);
+}
+
+Tensor conv2d_batching_rule(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  TORCH_CHECK(input.dim() == 4 && weight.dim() == 4,
+      "conv2d: expected a 4D input and a 4D weight, but got tensors of ",
+      input.dim(), "D and ", weight.dim(), "D");
+
+  // Per-example inputs with shared parameters: the batch dims are more
+  // examples of a single convolution.
+  if (!isBatched(weight) && !(bias.defined() && isBatched(bias))) {
+    auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+    auto physical_sizes = input_physical.tensor().sizes();
+    auto num_batch_dims = input_physical.numBatchDims();
+    auto num_examples = prod_intlist(physical_sizes.slice(0, num_batch_dims + 1));
+    auto output = at::conv2d(
+        input_physical.tensor().reshape({num_examples, input.size(1), input.size(2), input.size(3)}),
+        weight, bias, stride, padding, dilation, groups);
+    VmapDimVector output_sizes(physical_sizes.begin(), physical_sizes.begin() + num_batch_dims + 1);
+    output_sizes.insert(output_sizes.end(), output.sizes().begin() + 1, output.sizes().end());
+    return input_physical.newLogicalFromPhysical(output.view(output_sizes));
+  }
+
+  // Batched parameters (e.g. an ensemble of models): the E models of the
+  // batch become E groups of a grouped convolution over the channels.
+  std::vector<Tensor> logical_tensors = {input, weight};
+  if (bias.defined()) {
+    logical_tensors.push_back(bias);
+  }
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical(logical_tensors);
+  auto num_batch_dims = physical_args[0].numBatchDims();
+  auto batch_sizes = physical_args[0].tensor().sizes().slice(0, num_batch_dims);
+  auto num_models = prod_intlist(batch_sizes);
+  auto batch_size = input.size(0);
+  auto in_channels = input.size(1);
+  auto out_channels = weight.size(0);
+
+  // (E, N, C, H, W) -> (N, E * C, H, W)
+  auto input_grouped = physical_args[0].tensor()
+      .reshape({num_models, batch_size, in_channels, input.size(2), input.size(3)})
+      .transpose(0, 1)
+      .reshape({batch_size, num_models * in_channels, input.size(2), input.size(3)});
+  // (E, O, C / groups, kh, kw) -> (E * O, C / groups, kh, kw)
+  auto weight_grouped = physical_args[1].tensor()
+      .reshape({num_models * out_channels, weight.size(1), weight.size(2), weight.size(3)});
+  auto bias_grouped = bias.defined()
+      ? physical_args[2].tensor().reshape({num_models * out_channels})
+      : Tensor();
+  auto output = at::conv2d(
+      input_grouped, weight_grouped, bias_grouped, stride, padding, dilation, groups * num_models);
+
+  // (N, E * O, H', W') -> (E, N, O, H', W'), with E split in the batch dims
+  VmapDimVector output_sizes(batch_sizes.begin(), batch_sizes.end());
+  output_sizes.insert(output_sizes.end(), {batch_size, out_channels, output.size(2), output.size(3)});
+  auto result = output.view({batch_size, num_models, out_channels, output.size(2), output.size(3)})
+      .transpose(0, 1)
+      .view(output_sizes);
+  return physical_args[0].newLogicalFromPhysical(result);
 }
 
 TORCH_LIBRARY_IMPL(_, Batched, m) {
-  m.fallback(torch::CppFunction::makeFromBoxedFunction<&batchedTensorFallback>());
+  m.fallback(torch::CppFunction::makeFromBoxedFunction<&batchedTensorForLoopFallback>());
 }
 
 TORCH_LIBRARY_IMPL(aten, Batched, m) {
@@ -159,13 +417,104 @@ TORCH_LIBRARY_IMPL(aten, Batched, m) {
   m.impl("_add_batch_dim", native::_add_batch_dim);
   m.impl("_remove_batch_dim", native::_remove_batch_dim);
 
-  m.impl_UNBOXED("sum.dim_IntList", sum_batching_rule);
-  m.impl_UNBOXED("mul.Tensor", mul_batching_rule);
+  // NB: Composite operators (the ones without a dispatch section in
+  // native_functions.yaml) would go to the fallback, which takes precedence
+  // over their catch-all kernel. The ones registered with their native
+  // implementation below decompose into operators that have batching rules.
+  m.impl("narrow",
+         static_cast<Tensor (*)(const Tensor&, int64_t, int64_t, int64_t)>(native::narrow));
+  m.impl("t", native::t);
+  m.impl("chunk", native::chunk);
+  m.impl("flatten.using_ints",
+         static_cast<Tensor (*)(const Tensor&, int64_t, int64_t)>(native::flatten));
+
+  // view operations
   m.impl("expand", expand_batching_rule);
   m.impl("transpose.int", transpose_int_batching_rule);
   m.impl("unsqueeze", unsqueeze_batching_rule);
+  m.impl("squeeze", squeeze_batching_rule);
   m.impl("squeeze.dim", squeeze_dim_batching_rule);
   m.impl("permute", permute_batching_rule);
+  m.impl("view", view_batching_rule);
+  m.impl("reshape", reshape_batching_rule);
+  m.impl("select.int", select_batching_rule);
+  m.impl("slice.Tensor", slice_batching_rule);
+  m.impl("diagonal", diagonal_batching_rule);
+  m.impl("unfold", unfold_batching_rule);
+  m.impl("unbind.int", unbind_batching_rule);
+  m.impl("split.Tensor", split_batching_rule);
+
+  // unary pointwise, out-of-place, no additional arguments.
+#define UNARY_POINTWISE(op) m.impl(#op, \
+    unwrap_and_call<Tensor (*)(const Tensor&), at::op>);
+  UNARY_POINTWISE(abs);
+  UNARY_POINTWISE(acos);
+  UNARY_POINTWISE(asin);
+  UNARY_POINTWISE(atan);
+  UNARY_POINTWISE(ceil);
+  UNARY_POINTWISE(cos);
+  UNARY_POINTWISE(cosh);
+  UNARY_POINTWISE(digamma);
+  UNARY_POINTWISE(erf);
+  UNARY_POINTWISE(exp);
+  UNARY_POINTWISE(expm1);
+  UNARY_POINTWISE(floor);
+  UNARY_POINTWISE(frac);
+  UNARY_POINTWISE(lgamma);
+  UNARY_POINTWISE(log);
+  UNARY_POINTWISE(log10);
+  UNARY_POINTWISE(log1p);
+  UNARY_POINTWISE(log2);
+  UNARY_POINTWISE(neg);
+  UNARY_POINTWISE(reciprocal);
+  UNARY_POINTWISE(relu);
+  UNARY_POINTWISE(round);
+  UNARY_POINTWISE(rsqrt);
+  UNARY_POINTWISE(sigmoid);
+  UNARY_POINTWISE(sign);
+  UNARY_POINTWISE(sin);
+  UNARY_POINTWISE(sinh);
+  UNARY_POINTWISE(sqrt);
+  UNARY_POINTWISE(tan);
+  UNARY_POINTWISE(tanh);
+  UNARY_POINTWISE(trunc);
+#undef UNARY_POINTWISE
+
+  // pointwise with scalar arguments
+  using TensorScalarType = Tensor (*)(const Tensor&, Scalar);
+  using TensorScalarScalarType = Tensor (*)(const Tensor&, Scalar, Scalar);
+  m.impl("add.Scalar", unwrap_and_call<TensorScalarScalarType, at::add, Scalar, Scalar>);
+  m.impl("sub.Scalar", unwrap_and_call<TensorScalarScalarType, at::sub, Scalar, Scalar>);
+  m.impl("mul.Scalar", unwrap_and_call<TensorScalarType, at::mul, Scalar>);
+  m.impl("div.Scalar", unwrap_and_call<TensorScalarType, at::div, Scalar>);
+  m.impl("pow.Tensor_Scalar", unwrap_and_call<TensorScalarType, at::pow, Scalar>);
+  m.impl("threshold", unwrap_and_call<TensorScalarScalarType, at::threshold, Scalar, Scalar>);
+
+  // binary pointwise
+  using BinaryType = Tensor (*)(const Tensor&, const Tensor&);
+  using BinaryWithAlphaType = Tensor (*)(const Tensor&, const Tensor&, Scalar);
+  m.impl("add.Tensor", binary_pointwise_batching_rule<BinaryWithAlphaType, at::add, Scalar>);
+  m.impl("sub.Tensor", binary_pointwise_batching_rule<BinaryWithAlphaType, at::sub, Scalar>);
+  m.impl_UNBOXED("mul.Tensor", binary_pointwise_batching_rule<BinaryType, at::mul>);
+  m.impl("div.Tensor", binary_pointwise_batching_rule<BinaryType, at::div>);
+  m.impl("pow.Tensor_Tensor", binary_pointwise_batching_rule<BinaryType, at::pow>);
+  m.impl("atan2", binary_pointwise_batching_rule<BinaryType, at::atan2>);
+
+  // reductions
+  using ReductionType = Tensor (*)(const Tensor&, optional<ScalarType>);
+  using ReductionDimsType = Tensor (*)(const Tensor&, IntArrayRef, bool, optional<ScalarType>);
+  m.impl("sum", reduction_batching_rule<ReductionType, at::sum>);
+  m.impl_UNBOXED("sum.dim_IntList", reduction_dims_batching_rule<ReductionDimsType, at::sum>);
+  m.impl("mean", reduction_batching_rule<ReductionType, at::mean>);
+  m.impl("mean.dim", reduction_dims_batching_rule<ReductionDimsType, at::mean>);
+
+  // matrix products
+  m.impl("matmul", matmul_batching_rule);
+  m.impl("mm", mm_batching_rule);
+  m.impl("mv", mv_batching_rule);
+  m.impl("dot", dot_batching_rule);
+  m.impl("bmm", bmm_batching_rule);
+  m.impl_UNBOXED("conv2d", conv2d_batching_rule);
 }
 
 } // namespace at
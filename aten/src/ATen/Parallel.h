@@ -34,6 +34,18 @@ CAFFE2_API int get_thread_num();
 // Checks whether the code runs in parallel region
 CAFFE2_API bool in_parallel_region();
 
+// Enables or disables nested parallelism. By default parallel_for and
+// parallel_reduce run serially when called from inside a parallel region.
+// With nested parallelism enabled, inner regions share the intra-op pool
+// with the outer ones instead: the calling thread keeps working on its own
+// range and only threads that are idle at that moment join in, so the number
+// of busy threads never exceeds the size of the pool.
+// Only supported by the native backends; a no-op (with a warning) otherwise.
+CAFFE2_API void set_nested_parallelism(bool enabled);
+
+// Returns whether nested parallelism is enabled
+CAFFE2_API bool get_nested_parallelism();
+
 namespace internal {
 
 // Initialise num_threads lazily at first parallel call
@@ -45,6 +57,12 @@ inline CAFFE2_API void lazy_init_num_threads() {
   }
 }
 
+// Whether parallel primitives called from the current thread have to run
+// serially, i.e. we are in a parallel region that may not be nested into
+inline bool _in_serial_region() {
+  return in_parallel_region() && !get_nested_parallelism();
+}
+
 }
 
 /*
@@ -131,6 +149,10 @@ CAFFE2_API int get_num_interop_threads();
 CAFFE2_API void launch(std::function<void()> func);
 namespace internal {
 void launch_no_thread_state(std::function<void()> fn);
+
+// Runs one queued inter-op task on the calling thread if it is an inter-op
+// thread, see TaskThreadPoolBase::runPendingTask. Returns whether a task ran.
+CAFFE2_API bool run_pending_interop_task();
 } // namespace internal
 
 // Launches intra-op parallel task
@@ -151,4 +173,6 @@ CAFFE2_API int intraop_default_num_threads();
 #include <ATen/ParallelNative.h>
 #elif AT_PARALLEL_NATIVE_TBB
 #include <ATen/ParallelNativeTBB.h>
+#elif AT_PARALLEL_NATIVE_WS
+#include <ATen/ParallelNativeWS.h>
 #endif
@@ -4,6 +4,7 @@
 #include <ATen/PTThreadPool.h>
 #include <ATen/Version.h>
 
+#include <atomic>
 #include <sstream>
 #include <thread>
 
@@ -40,6 +41,8 @@ size_t get_env_num_threads(const char* var_name, size_t def_value = 0) {
   return def_value;
 }
 
+std::atomic<bool> nested_parallelism{false};
+
 } // namespace
 
 std::string get_parallel_info() {
@@ -78,12 +81,19 @@ std::string get_parallel_info() {
   ss << "native thread pool";
   #elif AT_PARALLEL_NATIVE_TBB
   ss << "native thread pool and TBB";
+  #elif AT_PARALLEL_NATIVE_WS
+  ss << "native work-stealing thread pool";
   #endif
   #ifdef C10_MOBILE
   ss << " [mobile]";
+  #elif AT_PARALLEL_NATIVE_PTHREADPOOL
+  ss << " [pthreadpool]";
   #endif
   ss << std::endl;
 
+  ss << "\tat::get_nested_parallelism() : "
+     << at::get_nested_parallelism() << std::endl;
+
   #if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
   ss << "Experimental: single thread pool" << std::endl;
   #endif
@@ -91,6 +101,23 @@ std::string get_parallel_info() {
   return ss.str();
 }
 
+void set_nested_parallelism(bool enabled) {
+#if (AT_PARALLEL_NATIVE || AT_PARALLEL_NATIVE_WS) && \
+    !defined(C10_MOBILE) && !AT_PARALLEL_NATIVE_PTHREADPOOL
+  nested_parallelism.store(enabled);
+#else
+  if (enabled) {
+    TORCH_WARN(
+      "Nested parallelism is only supported by the native parallel backends, "
+      "inner parallel regions will keep running serially");
+  }
+#endif
+}
+
+bool get_nested_parallelism() {
+  return nested_parallelism.load(std::memory_order_relaxed);
+}
+
 int intraop_default_num_threads() {
 #ifdef C10_MOBILE
   // Intraop thread pool size should be determined by mobile cpuinfo.
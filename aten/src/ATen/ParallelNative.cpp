@@ -3,13 +3,24 @@
 #include <ATen/Parallel.h>
 #include <ATen/PTThreadPool.h>
 
-#ifndef C10_MOBILE
+// The intra-op pool is caffe2::pthreadpool(), the pool the QNNPACK and XNNPACK
+// kernels run on, on mobile and with ATEN_THREADING=NATIVE_PTHREADPOOL. Models
+// mixing those kernels with ATen ops then keep a single set of threads, with a
+// single thread count, instead of two sets spinning on the same cores.
+#if defined(C10_MOBILE) || AT_PARALLEL_NATIVE_PTHREADPOOL
+#define AT_INTRAOP_PTHREADPOOL 1
+#else
+#define AT_INTRAOP_PTHREADPOOL 0
+#endif
+
+#if !AT_INTRAOP_PTHREADPOOL
 #include <c10/core/thread_pool.h>
 #else
 #include <caffe2/utils/threadpool/pthreadpool-cpp.h>
-#endif // C10_MOBILE
+#endif // AT_INTRAOP_PTHREADPOOL
 
 #include <atomic>
+#include <memory>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -36,11 +47,7 @@ void _set_thread_num(size_t thread_num) {
   thread_num_ = thread_num;
 }
 
-void _unset_thread_num() {
-  thread_num_ = 0;
-}
-
-#ifndef C10_MOBILE
+#if !AT_INTRAOP_PTHREADPOOL
 
 const int NOT_SET = -1;
 const int CONSUMED = -2;
@@ -75,12 +82,12 @@ TaskThreadPoolBase& _get_intraop_pool() {
   return *pool;
 }
 
-#endif // C10_MOBILE
+#endif // AT_INTRAOP_PTHREADPOOL
 
 // Run lambda function `fn` over `task_id` in [0, `range`) with threadpool.
 // `fn` will be called with params: (thread_pool_task_id, task_id).
 void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
-#ifndef C10_MOBILE
+#if !AT_INTRAOP_PTHREADPOOL
   for (size_t i = 1; i < range; ++i) {
     _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
   }
@@ -96,20 +103,28 @@ void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
     [&fn](const size_t task_id) {
       fn(0 /* unused */, task_id);
     }, range);
-#endif // C10_MOBILE
+#endif // AT_INTRAOP_PTHREADPOOL
 }
 
 // RAII guard helps to support in_parallel_region() and get_thread_num() API.
+// The previous state is restored on exit, so that nested regions leave the
+// enclosing one intact.
 struct ParallelRegionGuard {
-  ParallelRegionGuard(int64_t task_id) {
+  ParallelRegionGuard(int64_t task_id)
+    : prev_in_parallel_region_(in_parallel_region_),
+      prev_thread_num_(thread_num_) {
     _set_thread_num(task_id);
     _set_in_parallel_region(true);
   }
 
   ~ParallelRegionGuard() {
-    _set_in_parallel_region(false);
-    _unset_thread_num();
+    _set_in_parallel_region(prev_in_parallel_region_);
+    _set_thread_num(prev_thread_num_);
   }
+
+ private:
+  const bool prev_in_parallel_region_;
+  const size_t prev_thread_num_;
 };
 
 } // namespace
@@ -127,47 +142,66 @@ void _parallel_run(
   std::tie(num_tasks, chunk_size) =
       internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
 
-  struct {
+  // Tasks don't own a chunk each; instead every task keeps claiming chunks
+  // until none are left. That way the caller can finish the whole range by
+  // itself if no pool thread is free, and pool tasks that start after all
+  // chunks have been claimed return without touching f. The state is shared
+  // with those late tasks, so it must outlive this call.
+  struct State {
+    std::atomic<size_t> next_chunk{0};
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
     std::mutex mutex;
-    volatile size_t remaining;
+    size_t remaining;
     std::condition_variable cv;
-  } state;
-
-  auto task = [f, &state, begin, end, chunk_size]
-      (int /* unused */, size_t task_id) {
-    int64_t local_start = begin + task_id * chunk_size;
-    if (local_start < end) {
-      int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
-      try {
-        ParallelRegionGuard guard(task_id);
-        f(local_start, local_end, task_id);
-      } catch (...) {
-        if (!state.err_flag.test_and_set()) {
-          state.eptr = std::current_exception();
+  };
+  auto state = std::make_shared<State>();
+  state->remaining = num_tasks;
+  const auto* fn = &f;
+
+  auto task = [fn, state, begin, end, chunk_size, num_tasks]
+      (int /* unused */, size_t /* unused */) {
+    size_t task_id;
+    while ((task_id = state->next_chunk++) < num_tasks) {
+      int64_t local_start = begin + task_id * chunk_size;
+      if (local_start < end) {
+        int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
+        try {
+          ParallelRegionGuard guard(task_id);
+          (*fn)(local_start, local_end, task_id);
+        } catch (...) {
+          if (!state->err_flag.test_and_set()) {
+            state->eptr = std::current_exception();
+          }
         }
       }
-    }
-    {
-      std::unique_lock<std::mutex> lk(state.mutex);
-      if (--state.remaining == 0) {
-        state.cv.notify_one();
+      {
+        std::unique_lock<std::mutex> lk(state->mutex);
+        if (--state->remaining == 0) {
+          state->cv.notify_one();
+        }
       }
     }
   };
-  state.remaining = num_tasks;
-  _run_with_pool(task, num_tasks);
 
-  // Wait for all tasks to finish.
+  size_t num_pool_tasks = num_tasks;
+#if !AT_INTRAOP_PTHREADPOOL
+  if (in_parallel_region()) {
+    // Nested region: only hand out work to the threads that are idle right
+    // now, the busy ones would only pick it up once it is all done anyway.
+    num_pool_tasks = std::min(
+        num_tasks, _get_intraop_pool().numAvailable() + 1);
+  }
+#endif // AT_INTRAOP_PTHREADPOOL
+  _run_with_pool(task, num_pool_tasks);
+
+  // Wait for the chunks that are still running on other threads.
   {
-    std::unique_lock<std::mutex> lk(state.mutex);
-    if (state.remaining != 0) {
-      state.cv.wait(lk);
-    }
+    std::unique_lock<std::mutex> lk(state->mutex);
+    state->cv.wait(lk, [&state] { return state->remaining == 0; });
   }
-  if (state.eptr) {
-    std::rethrow_exception(state.eptr);
+  if (state->eptr) {
+    std::rethrow_exception(state->eptr);
   }
 }
 
@@ -182,13 +216,13 @@ void init_num_threads() {
   mkl_set_num_threads(1);
 #endif
 
-#ifdef C10_MOBILE
+#if AT_INTRAOP_PTHREADPOOL
   caffe2::pthreadpool();
 #endif
 }
 
 void set_num_threads(int nthreads) {
-#ifndef C10_MOBILE
+#if !AT_INTRAOP_PTHREADPOOL
   TORCH_CHECK(nthreads > 0, "Expected positive number of threads");
   int no_value = NOT_SET;
   if (!num_intraop_threads.compare_exchange_strong(no_value, nthreads)) {
@@ -210,11 +244,11 @@ void set_num_threads(int nthreads) {
   caffe2::PThreadPool* const pool = caffe2::pthreadpool();
   TORCH_INTERNAL_ASSERT(pool, "Invalid thread pool!");
   pool->set_thread_count(nthreads);
-#endif // C10_MOBILE
+#endif // AT_INTRAOP_PTHREADPOOL
 }
 
 int get_num_threads() {
-#ifndef C10_MOBILE
+#if !AT_INTRAOP_PTHREADPOOL
   // not initializing pool unnecessarily,
   // because pool cannot be resized after initialization
   int nthreads = num_intraop_threads.load();
@@ -230,7 +264,7 @@ int get_num_threads() {
   caffe2::PThreadPool* const pool = caffe2::pthreadpool();
   TORCH_INTERNAL_ASSERT(pool, "Invalid thread pool!")
   return in_parallel_region() ? 1 /* current thread */ : pool->get_thread_count();
-#endif // C10_MOBILE
+#endif // AT_INTRAOP_PTHREADPOOL
 }
 
 int get_thread_num() {
@@ -238,7 +272,7 @@ int get_thread_num() {
 }
 
 bool in_parallel_region() {
-#ifndef C10_MOBILE
+#if !AT_INTRAOP_PTHREADPOOL
   return in_parallel_region_ || (
     num_intraop_threads.load() == CONSUMED &&
     // Needed as intraop_launch() doesn't set in_parallel_region().
@@ -246,11 +280,11 @@ bool in_parallel_region() {
   );
 #else
   return in_parallel_region_;
-#endif // C10_MOBILE
+#endif // AT_INTRAOP_PTHREADPOOL
 }
 
 void intraop_launch(std::function<void()> func) {
-#ifndef C10_MOBILE
+#if !AT_INTRAOP_PTHREADPOOL
   if (!in_parallel_region() && get_num_threads() > 1) {
     _get_intraop_pool().run(func);
   } else {
@@ -261,12 +295,12 @@ void intraop_launch(std::function<void()> func) {
   // TODO: caffe2::PThreadPool only provides a data-parallel API.
   // Task parallelism is not currently supported.
   func();
-#endif // C10_MOBILE
+#endif // AT_INTRAOP_PTHREADPOOL
 }
 
 std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
     std::function<void()> func) {
-#ifndef C10_MOBILE
+#if !AT_INTRAOP_PTHREADPOOL
   auto future = std::make_shared<c10::ivalue::Future>(c10::NoneType::get());
   if (!in_parallel_region() && get_num_threads() > 1) {
     _get_intraop_pool().run(
@@ -287,7 +321,7 @@ std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
   func();
   future->markCompleted();
   return future;
-#endif // C10_MOBILE
+#endif // AT_INTRAOP_PTHREADPOOL
 }
 
 } // namespace at
@@ -40,7 +40,7 @@ inline void parallel_for(
   if (begin >= end) {
     return;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size || internal::_in_serial_region()) {
     f(begin, end);
     return;
   }
@@ -66,7 +66,7 @@ inline scalar_t parallel_reduce(
   if (begin >= end) {
     return ident;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size || internal::_in_serial_region()) {
     return f(begin, end, ident);
   }
   size_t num_tasks, chunk_size;
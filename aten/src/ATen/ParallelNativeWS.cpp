@@ -0,0 +1,481 @@
+#include <ATen/Config.h>
+#if AT_PARALLEL_NATIVE_WS
+#include <ATen/Parallel.h>
+
+#include <c10/util/thread_name.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef TH_BLAS_MKL
+#include <mkl.h>
+#endif
+
+namespace at {
+namespace {
+// used with _set_in_parallel_region to mark master thread
+// as in parallel region while executing parallel primitives
+thread_local bool in_parallel_region_ = false;
+
+// thread number set by parallel primitive
+thread_local size_t thread_num_ = 0;
+
+// set on the worker threads of the intra-op pool
+thread_local bool in_intraop_pool_ = false;
+
+// index of the own deque of a worker thread, 0 outside of the pool
+thread_local size_t worker_id_ = 0;
+
+const int NOT_SET = -1;
+const int CONSUMED = -2;
+
+// Number of threads set by the user
+// NOT_SET -> positive value -> CONSUMED
+// or
+// NOT_SET -> CONSUMED
+// Meaning:
+//  - NOT_SET - pool not initialized, user value is not set
+//  - positive value - pool not initialized, user value set
+//  - CONSUMED - pool is initialized
+std::atomic<int> num_intraop_threads{NOT_SET};
+
+// Lazy splitting stops at this many chunks per thread even if grain_size
+// would allow smaller ones, to bound the scheduling overhead.
+constexpr int64_t kMaxChunksPerThread = 32;
+
+// Number of unsuccessful steal attempts before a worker goes to sleep.
+constexpr int kStealAttemptsBeforeSleep = 64;
+
+// RAII guard helps to support in_parallel_region() and get_thread_num() API.
+// The previous state is restored on exit, so that nested regions leave the
+// enclosing one intact.
+struct ParallelRegionGuard {
+  ParallelRegionGuard(int64_t thread_num)
+    : prev_in_parallel_region_(in_parallel_region_),
+      prev_thread_num_(thread_num_) {
+    thread_num_ = thread_num;
+    in_parallel_region_ = true;
+  }
+
+  ~ParallelRegionGuard() {
+    in_parallel_region_ = prev_in_parallel_region_;
+    thread_num_ = prev_thread_num_;
+  }
+
+ private:
+  const bool prev_in_parallel_region_;
+  const size_t prev_thread_num_;
+};
+
+// State shared by all chunks of one _parallel_run call.
+struct Job {
+  Job(const std::function<void(int64_t, int64_t, size_t)>& f,
+      int64_t min_chunk,
+      int64_t size)
+    : f(f), min_chunk(min_chunk), remaining(size) {}
+
+  // Marks `count` elements as done; wakes up the caller after the last one.
+  void finish(int64_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    remaining -= count;
+    if (remaining == 0) {
+      cv.notify_all();
+    }
+  }
+
+  void set_exception(std::exception_ptr e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!eptr) {
+      eptr = std::move(e);
+    }
+    failed = true;
+  }
+
+  const std::function<void(int64_t, int64_t, size_t)>& f;
+  const int64_t min_chunk;
+
+  // once set, the remaining chunks are skipped
+  std::atomic<bool> failed{false};
+
+  // guarded by mutex
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::exception_ptr eptr;
+  int64_t remaining; // elements not processed yet
+};
+
+// A unit of work: either a subrange of a job or a task from intraop_launch.
+struct Work {
+  Job* job = nullptr;
+  int64_t begin = 0;
+  int64_t end = 0;
+  std::function<void()> task;
+};
+
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(int num_workers) : stop_(false), pending_(0), sleeping_(0) {
+    // queue 0 is shared by all threads outside of the pool
+    for (int i = 0; i <= num_workers; ++i) {
+      queues_.emplace_back(new Queue());
+    }
+    const char* pin = std::getenv("ATEN_PIN_THREADS");
+    const bool pin_threads = !(pin && std::string(pin) == "0");
+    for (int i = 1; i <= num_workers; ++i) {
+      threads_.emplace_back([this, i, pin_threads]() {
+        c10::setThreadName("PTIntraOpWS");
+        if (pin_threads) {
+          pin_to_core(i);
+        }
+        at::init_num_threads();
+        in_intraop_pool_ = true;
+        worker_id_ = i;
+        worker_loop(i);
+      });
+    }
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+      sleep_cv_.notify_all();
+    }
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  size_t size() const {
+    return threads_.size();
+  }
+
+  void run(std::function<void()> func) {
+    Work work;
+    work.task = std::move(func);
+    push(0, std::move(work));
+  }
+
+  void parallel_run(Job& job, int64_t begin, int64_t end) {
+    // The caller works on the range and on whatever of it is left in the
+    // deques; it never picks up chunks of other jobs. A worker thread running
+    // a nested region shares work through its own deque and keeps its
+    // thread number; all other callers use deque 0 and thread number 0.
+    const size_t id = worker_id_;
+    run_range(id, id, &job, begin, end);
+    Work work;
+    std::unique_lock<std::mutex> lock(job.mutex);
+    while (job.remaining != 0) {
+      lock.unlock();
+      if (steal_from_job(&job, work)) {
+        run_range(id, id, work.job, work.begin, work.end);
+        lock.lock();
+        continue;
+      }
+      lock.lock();
+      job.cv.wait_for(
+          lock, std::chrono::microseconds(100), [&job] { return job.remaining == 0; });
+    }
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Work> deque;
+  };
+
+  static void pin_to_core(int worker_id) {
+#ifdef __linux__
+    const unsigned num_cores = std::thread::hardware_concurrency();
+    if (num_cores == 0) {
+      return;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(worker_id % num_cores, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+  }
+
+  void push(size_t queue_id, Work work) {
+    {
+      std::lock_guard<std::mutex> lock(queues_[queue_id]->mutex);
+      queues_[queue_id]->deque.push_back(std::move(work));
+    }
+    pending_++;
+    if (sleeping_.load() > 0) {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      sleep_cv_.notify_one();
+    }
+  }
+
+  bool queue_empty(size_t queue_id) {
+    std::lock_guard<std::mutex> lock(queues_[queue_id]->mutex);
+    return queues_[queue_id]->deque.empty();
+  }
+
+  // Newest work from the own deque (LIFO, it is still warm in cache).
+  bool pop(size_t queue_id, Work& work) {
+    std::lock_guard<std::mutex> lock(queues_[queue_id]->mutex);
+    auto& deque = queues_[queue_id]->deque;
+    if (deque.empty()) {
+      return false;
+    }
+    work = std::move(deque.back());
+    deque.pop_back();
+    pending_--;
+    return true;
+  }
+
+  // Oldest (and thus largest) work from any other deque.
+  bool steal(size_t thief_id, Work& work) {
+    const size_t num_queues = queues_.size();
+    for (size_t i = 1; i < num_queues; ++i) {
+      auto& queue = *queues_[(thief_id + i) % num_queues];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.deque.empty()) {
+        work = std::move(queue.deque.front());
+        queue.deque.pop_front();
+        pending_--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool steal_from_job(Job* job, Work& work) {
+    for (auto& queue : queues_) {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      auto& deque = queue->deque;
+      for (auto it = deque.begin(); it != deque.end(); ++it) {
+        if (it->job == job) {
+          work = std::move(*it);
+          deque.erase(it);
+          pending_--;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void run_range(size_t queue_id, size_t thread_num, Job* job, int64_t begin, int64_t end) {
+    int64_t done = 0;
+    while (begin < end) {
+      // Lazy binary splitting: only share work when nobody has anything
+      // queued from us yet.
+      if (end - begin >= 2 * job->min_chunk && queue_empty(queue_id)) {
+        const int64_t mid = begin + (end - begin) / 2;
+        Work rest;
+        rest.job = job;
+        rest.begin = mid;
+        rest.end = end;
+        push(queue_id, std::move(rest));
+        end = mid;
+      }
+      const int64_t chunk_end = std::min(end, begin + job->min_chunk);
+      if (!job->failed.load(std::memory_order_relaxed)) {
+        try {
+          ParallelRegionGuard guard(thread_num);
+          job->f(begin, chunk_end, thread_num);
+        } catch (...) {
+          job->set_exception(std::current_exception());
+        }
+      }
+      done += chunk_end - begin;
+      begin = chunk_end;
+    }
+    job->finish(done);
+  }
+
+  void execute(size_t worker_id, Work& work) {
+    if (work.job) {
+      run_range(worker_id, worker_id, work.job, work.begin, work.end);
+    } else {
+      work.task();
+    }
+  }
+
+  void worker_loop(size_t worker_id) {
+    Work work;
+    int failed_attempts = 0;
+    while (true) {
+      if (pop(worker_id, work) || steal(worker_id, work)) {
+        execute(worker_id, work);
+        work = Work();
+        failed_attempts = 0;
+        continue;
+      }
+      if (++failed_attempts < kStealAttemptsBeforeSleep) {
+        std::this_thread::yield();
+        continue;
+      }
+      failed_attempts = 0;
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      if (stop_) {
+        return;
+      }
+      sleeping_++;
+      sleep_cv_.wait(lock, [this] { return stop_ || pending_.load() > 0; });
+      sleeping_--;
+      if (stop_) {
+        return;
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  bool stop_;
+  // number of Work items in all deques
+  std::atomic<int64_t> pending_;
+  std::atomic<int> sleeping_;
+};
+
+int _num_pool_threads(int nthreads) {
+  if (nthreads == NOT_SET) {
+    nthreads = intraop_default_num_threads();
+  } else {
+    TORCH_INTERNAL_ASSERT(nthreads > 0);
+  }
+  // minus one because of the master thread
+  return nthreads - 1;
+}
+
+WorkStealingPool& _get_intraop_pool() {
+  static WorkStealingPool pool(
+      _num_pool_threads(num_intraop_threads.exchange(CONSUMED)));
+  return pool;
+}
+
+} // namespace
+
+namespace internal {
+
+void _parallel_run(
+  const int64_t begin,
+  const int64_t end,
+  const int64_t grain_size,
+  const std::function<void(int64_t, int64_t, size_t)>& f) {
+  at::internal::lazy_init_num_threads();
+
+  const int64_t num_threads = get_num_threads();
+  if (num_threads == 1) {
+    ParallelRegionGuard guard(0);
+    f(begin, end, 0);
+    return;
+  }
+  const int64_t min_chunk = std::max(
+      std::max(grain_size, (int64_t)1),
+      divup(end - begin, num_threads * kMaxChunksPerThread));
+
+  Job job(f, min_chunk, end - begin);
+  _get_intraop_pool().parallel_run(job, begin, end);
+  if (job.eptr) {
+    std::rethrow_exception(job.eptr);
+  }
+}
+
+} // namespace internal
+
+void init_num_threads() {
+#ifdef _OPENMP
+  omp_set_num_threads(1);
+#endif
+
+#ifdef TH_BLAS_MKL
+  mkl_set_num_threads(1);
+#endif
+}
+
+void set_num_threads(int nthreads) {
+  TORCH_CHECK(nthreads > 0, "Expected positive number of threads");
+  int no_value = NOT_SET;
+  if (!num_intraop_threads.compare_exchange_strong(no_value, nthreads)) {
+    // num_intraop_threads either stores a positive integer or CONSUMED,
+    // check that requested size is the same as the current one
+    int stored_nthreads = num_intraop_threads.load();
+    if (stored_nthreads <= 0) {
+      // plus one because of master thread
+      stored_nthreads = _get_intraop_pool().size() + 1;
+    }
+    if (stored_nthreads != nthreads) {
+      TORCH_WARN(
+        "Cannot set number of intraop threads "
+        "after parallel work has started or after set_num_threads call "
+        "when using native work-stealing parallel backend");
+    }
+  }
+}
+
+int get_num_threads() {
+  // not initializing pool unnecessarily,
+  // because pool cannot be resized after initialization
+  int nthreads = num_intraop_threads.load();
+  if (nthreads > 0) {
+    return nthreads;
+  } else if (nthreads == NOT_SET) {
+    return intraop_default_num_threads();
+  } else {
+    TORCH_INTERNAL_ASSERT(nthreads == CONSUMED);
+    return _get_intraop_pool().size() + 1;
+  }
+}
+
+int get_thread_num() {
+  return thread_num_;
+}
+
+bool in_parallel_region() {
+  // in_intraop_pool_ is needed as intraop_launch() doesn't set
+  // in_parallel_region().
+  return in_parallel_region_ || in_intraop_pool_;
+}
+
+void intraop_launch(std::function<void()> func) {
+  if (!in_parallel_region() && get_num_threads() > 1) {
+    _get_intraop_pool().run(func);
+  } else {
+    // execute inline if we're in parallel region
+    func();
+  }
+}
+
+std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
+    std::function<void()> func) {
+  auto future = std::make_shared<c10::ivalue::Future>(c10::NoneType::get());
+  if (!in_parallel_region() && get_num_threads() > 1) {
+    _get_intraop_pool().run(
+      [func, future]() {
+        func();
+        future->markCompleted();
+      }
+    );
+  } else {
+    func();
+    future->markCompleted();
+  }
+  return future;
+}
+
+} // namespace at
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+#define INTRA_OP_PARALLEL
+
+namespace at {
+namespace internal {
+
+// Runs f over [begin, end) on the work-stealing intra-op pool.
+//
+// The calling thread starts with the whole range. Ranges are split lazily:
+// whenever the thread working on a range finds its own deque empty, it pushes
+// the upper half of what it has left onto that deque, where idle threads can
+// steal it. Chunks are never smaller than grain_size elements.
+//
+// f is called as f(chunk_begin, chunk_end, thread_num), where thread_num
+// identifies the executing thread and is smaller than get_num_threads(). A
+// thread may run several chunks of the same range, in any order.
+CAFFE2_API void _parallel_run(
+  const int64_t begin,
+  const int64_t end,
+  const int64_t grain_size,
+  const std::function<void(int64_t, int64_t, size_t)>& f);
+
+} // namespace internal
+
+template <class F>
+inline void parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const F& f) {
+  TORCH_CHECK(grain_size >= 0);
+  if (begin >= end) {
+    return;
+  }
+  if ((end - begin) < grain_size || internal::_in_serial_region()) {
+    f(begin, end);
+    return;
+  }
+  internal::_parallel_run(
+      begin,
+      end,
+      grain_size,
+      [f](int64_t start, int64_t end, size_t /* unused */) {
+        f(start, end);
+      }
+  );
+}
+
+// Partial results are accumulated per thread and combined with sf, so sf must
+// be associative and commutative; the order in which chunks are combined is
+// not deterministic.
+template <class scalar_t, class F, class SF>
+inline scalar_t parallel_reduce(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const scalar_t ident,
+    const F& f,
+    const SF& sf) {
+  TORCH_CHECK(grain_size >= 0);
+  if (begin >= end) {
+    return ident;
+  }
+  if ((end - begin) < grain_size || internal::_in_serial_region()) {
+    return f(begin, end, ident);
+  }
+  std::vector<scalar_t> results(get_num_threads(), ident);
+  std::vector<char> has_result(results.size(), 0);
+  scalar_t* results_data = results.data();
+  char* has_result_data = has_result.data();
+  internal::_parallel_run(
+      begin,
+      end,
+      grain_size,
+      [f, sf, ident, results_data, has_result_data](
+          int64_t start, int64_t end, size_t thread_num) {
+        auto partial_result = f(start, end, ident);
+        if (has_result_data[thread_num]) {
+          results_data[thread_num] = sf(results_data[thread_num], partial_result);
+        } else {
+          results_data[thread_num] = partial_result;
+          has_result_data[thread_num] = 1;
+        }
+      }
+  );
+  scalar_t result = ident;
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (has_result[i]) {
+      result = sf(result, results[i]);
+    }
+  }
+  return result;
+}
+
+} // namespace at
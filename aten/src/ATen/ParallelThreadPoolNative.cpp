@@ -1,5 +1,5 @@
 #include <ATen/Config.h>
-#if AT_PARALLEL_OPENMP || AT_PARALLEL_NATIVE || AT_PARALLEL_NATIVE_TBB
+#if AT_PARALLEL_OPENMP || AT_PARALLEL_NATIVE || AT_PARALLEL_NATIVE_TBB || AT_PARALLEL_NATIVE_WS
 #include <ATen/Parallel.h>
 #include <ATen/PTThreadPool.h>
 #include <ATen/ThreadLocalState.h>
@@ -76,6 +76,14 @@ void launch_no_thread_state(std::function<void()> fn) {
   get_pool().run(std::move(fn));
 #endif
 }
+
+bool run_pending_interop_task() {
+#if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
+  return false;
+#else
+  return get_pool().runPendingTask();
+#endif
+}
 } // namespace internal
 
 void launch(std::function<void()> func) {
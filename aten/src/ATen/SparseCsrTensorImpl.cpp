@@ -0,0 +1,108 @@
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/InitialTensorOptions.h>
+
+namespace at {
+
+namespace {
+  DeviceType sparseCsrTensorSetToDeviceType(DispatchKeySet key_set) {
+    if (key_set.has(DispatchKey::SparseCsrCPU)) {
+      return kCPU;
+    } else if (key_set.has(DispatchKey::SparseCsrCUDA)) {
+      return kCUDA;
+    } else {
+      AT_ERROR("Cannot construct SparseCsrTensor with non-sparse CSR tensor type ID ", key_set);
+    }
+  }
+}
+
+// An empty sparse CSR tensor is a [0, 0] matrix: one row pointer and no
+// column indices or values.
+SparseCsrTensorImpl::SparseCsrTensorImpl(at::DispatchKeySet key_set, const caffe2::TypeMeta& data_type)
+  :   SparseCsrTensorImpl(key_set, data_type
+      , at::zeros({1}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(ScalarType::Long))
+      , at::empty({0}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(ScalarType::Long))
+      , at::empty({0}, at::initialTensorOptions().device(sparseCsrTensorSetToDeviceType(key_set)).dtype(data_type))) {}
+
+SparseCsrTensorImpl::SparseCsrTensorImpl(
+    at::DispatchKeySet key_set,
+    const caffe2::TypeMeta& data_type,
+    at::Tensor crow_indices,
+    at::Tensor col_indices,
+    at::Tensor values)
+    : TensorImpl(key_set, data_type, values.device())
+    , crow_indices_(std::move(crow_indices))
+    , col_indices_(std::move(col_indices))
+    , values_(std::move(values)) {
+  sizes_ = {0, 0};
+  refresh_numel();
+}
+
+IntArrayRef SparseCsrTensorImpl::strides() const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+bool SparseCsrTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  AT_ERROR("sparse CSR tensors do not have is_contiguous");
+}
+int64_t SparseCsrTensorImpl::stride(int64_t d) const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+void SparseCsrTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  AT_ERROR("sparse CSR tensors do not have set_size");
+}
+void SparseCsrTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  AT_ERROR("sparse CSR tensors do not have set_stride");
+}
+void SparseCsrTensorImpl::set_storage_offset(int64_t storage_offset) {
+  AT_ERROR("sparse CSR tensors do not have set_storage_offset");
+}
+
+int64_t SparseCsrTensorImpl::dim() const {
+  return 2;
+}
+bool SparseCsrTensorImpl::has_storage() const {
+  return false;
+}
+const Storage& SparseCsrTensorImpl::storage() const {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+int64_t SparseCsrTensorImpl::storage_offset() const {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+
+void SparseCsrTensorImpl::set_member_tensors_unsafe(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "set_member_tensors_unsafe ", err_msg_tensor_metadata_change_not_allowed);
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-dimensional, but got size ", size);
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided && values.layout() == kStrided,
+              "expected crow_indices, col_indices and values to be strided tensors");
+  TORCH_CHECK(crow_indices.scalar_type() == kLong && col_indices.scalar_type() == kLong,
+              "crow_indices and col_indices must be int64 tensors");
+  TORCH_CHECK(values.scalar_type() == typeMetaToScalarType(dtype()),
+              "dtype of values (", values.scalar_type(), ") must match dtype of sparse CSR tensor (",
+              typeMetaToScalarType(dtype()), ")");
+  TORCH_CHECK(crow_indices.device() == values.device() && col_indices.device() == values.device(),
+              "crow_indices, col_indices and values must be on the same device, but got ",
+              crow_indices.device(), ", ", col_indices.device(), " and ", values.device());
+  TORCH_CHECK(values.device().type() == device().type(),
+              "device type of values (", values.device().type(), ") must match device type of the sparse CSR tensor (",
+              device().type(), ")");
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+              "crow_indices, col_indices and values must be 1-dimensional");
+  TORCH_CHECK(crow_indices.numel() == size[0] + 1,
+              "crow_indices must have size(0) + 1 = ", size[0] + 1, " elements, but got ", crow_indices.numel());
+  TORCH_CHECK(col_indices.numel() == values.numel(),
+              "col_indices and values must have the same number of elements, but got ",
+              col_indices.numel(), " and ", values.numel());
+
+  crow_indices_ = crow_indices.contiguous();
+  col_indices_ = col_indices.contiguous();
+  values_ = values.contiguous();
+  sizes_ = size.vec();
+  refresh_numel();
+}
+
+} // namespace at
@@ -1,37 +1,111 @@
 #include <ATen/ThreadLocalState.h>
 
+#include <c10/core/InferenceMode.h>
+
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
 #include <ATen/core/grad_mode.h>
 #endif
 
 namespace at {
 
-ThreadLocalState::ThreadLocalState(bool keep_grad_mode)
-    : dispatch_key_(c10::impl::tls_local_dispatch_key_set()),
-      debug_info_(c10::ThreadLocalDebugInfo::current()) {
-  callbacks_ = _getTLSCallbacks();
+struct ThreadLocalState::Snapshot {
+  explicit Snapshot(bool keep_grad_mode)
+      : dispatch_key_(c10::impl::tls_local_dispatch_key_set()),
+        inference_mode_enabled_(c10::InferenceMode::is_enabled()),
+        debug_info_(c10::ThreadLocalDebugInfo::current()),
+        callbacks_(_getTLSCallbacks()) {
+#if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
+    keep_grad_mode_ = keep_grad_mode;
+    if (keep_grad_mode_) {
+      grad_mode_enabled_ = GradMode::is_enabled();
+    }
+#endif
+  }
+
+  // Whether the thread local variables of the current thread still
+  // have the values of this snapshot
+  bool isCurrent() const {
+    const auto dispatch_key = c10::impl::tls_local_dispatch_key_set();
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
-  keep_grad_mode_ = keep_grad_mode;
-  if (keep_grad_mode_) {
-    grad_mode_enabled_ = GradMode::is_enabled();
+    if (keep_grad_mode_ && grad_mode_enabled_ != GradMode::is_enabled()) {
+      return false;
+    }
+#endif
+    return dispatch_key.included_ == dispatch_key_.included_ &&
+        dispatch_key.excluded_ == dispatch_key_.excluded_ &&
+        inference_mode_enabled_ == c10::InferenceMode::is_enabled() &&
+        debug_info_ == c10::ThreadLocalDebugInfo::current() &&
+        _hasTLSCallbacks(callbacks_);
   }
+
+  c10::impl::LocalDispatchKeySet dispatch_key_;
+  bool inference_mode_enabled_;
+
+  // ThreadLocalDebugInfo does not change after being created
+  // with DebugInfoGuard
+  std::shared_ptr<c10::ThreadLocalDebugInfo> debug_info_;
+
+  // RecordFunction TLS callbacks
+  RecordFunctionCallbacks callbacks_;
+
+#if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
+  bool keep_grad_mode_ = true;
+  bool grad_mode_enabled_;
 #endif
+};
+
+/* static */
+std::shared_ptr<const ThreadLocalState::Snapshot>
+ThreadLocalState::currentSnapshot(bool keep_grad_mode) {
+  // The last snapshot taken on this thread, for either value of
+  // keep_grad_mode. The cache does not own the snapshots that hold debug
+  // info or callbacks, so that it doesn't extend their lifetime past the
+  // last ThreadLocalState referring to them. The others hold nothing and
+  // are kept, so that e.g. the guards of the tasks running on a pool
+  // thread share the snapshot of its idle state.
+  struct SnapshotCache {
+    std::weak_ptr<const Snapshot> last;
+    std::shared_ptr<const Snapshot> kept;
+  };
+  static thread_local SnapshotCache caches[2];
+
+  auto& cache = caches[keep_grad_mode ? 1 : 0];
+  auto snapshot = cache.last.lock();
+  if (snapshot && snapshot->isCurrent()) {
+    return snapshot;
+  }
+  snapshot = std::make_shared<const Snapshot>(keep_grad_mode);
+  cache.last = snapshot;
+  if (!snapshot->debug_info_ && snapshot->callbacks_.empty()) {
+    cache.kept = snapshot;
+  } else {
+    cache.kept.reset();
+  }
+  return snapshot;
 }
 
+ThreadLocalState::ThreadLocalState(bool keep_grad_mode)
+    : snapshot_(currentSnapshot(keep_grad_mode)) {}
+
 /* static */
 void ThreadLocalState::setThreadLocalState(
     const ThreadLocalState& state) {
+  const Snapshot& snapshot = *state.snapshot_;
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
-  if (state.keep_grad_mode_) {
-    GradMode::set_enabled(state.grad_mode_enabled_);
+  if (snapshot.keep_grad_mode_) {
+    GradMode::set_enabled(snapshot.grad_mode_enabled_);
   }
 #endif
 
-  _setTLSCallbacks(state.callbacks_);
+  _setTLSCallbacks(snapshot.callbacks_);
+
+  c10::ThreadLocalDebugInfo::_forceCurrentDebugInfo(snapshot.debug_info_);
 
-  c10::ThreadLocalDebugInfo::_forceCurrentDebugInfo(state.debug_info_);
+  // Sets the Autograd exclusion that goes with inference mode, so this needs
+  // to come before the dispatch keys.
+  c10::InferenceMode::set_enabled(snapshot.inference_mode_enabled_);
 
-  c10::impl::_force_tls_local_dispatch_key_set(state.dispatch_key_);
+  c10::impl::_force_tls_local_dispatch_key_set(snapshot.dispatch_key_);
 }
 
 } // namespace at
@@ -24,19 +24,15 @@ class TORCH_API ThreadLocalState {
   static void setThreadLocalState(const ThreadLocalState& state);
 
  private:
-  c10::impl::LocalDispatchKeySet dispatch_key_;
+  // The captured values never change after the snapshot is created, so
+  // copies of a ThreadLocalState (e.g. into every at::launch task) share
+  // a single snapshot and only copy this pointer. A thread reuses its last
+  // snapshot while its thread local values stay the same, and takes a new
+  // one once they change.
+  struct Snapshot;
+  std::shared_ptr<const Snapshot> snapshot_;
 
-  // ThreadLocalDebugInfo does not change after being created
-  // with DebugInfoGuard
-  std::shared_ptr<c10::ThreadLocalDebugInfo> debug_info_;
-
-  // RecordFunction TLS callbacks
-  RecordFunctionCallbacks callbacks_;
-
-#if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
-  bool keep_grad_mode_ = true;
-  bool grad_mode_enabled_;
-#endif
+  static std::shared_ptr<const Snapshot> currentSnapshot(bool keep_grad_mode);
 
   friend class ThreadLocalStateGuard;
 };
@@ -46,8 +42,11 @@ class TORCH_API ThreadLocalStateGuard {
  public:
   explicit ThreadLocalStateGuard(const ThreadLocalState& state)
       : prev_state_(ThreadLocalState()) {
-    // set the given state across the thread boundary
-    ThreadLocalState::setThreadLocalState(state);
+    // set the given state across the thread boundary, unless it is
+    // the one the thread already has
+    if (state.snapshot_ != prev_state_.snapshot_) {
+      ThreadLocalState::setThreadLocalState(state);
+    }
   }
 
   ~ThreadLocalStateGuard() {
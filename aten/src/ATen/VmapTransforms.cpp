@@ -55,11 +55,6 @@ VmapPhysicalView MultiBatchVmapTransform::logicalToPhysical(const Tensor& logica
   return { permuteBatchDimsToFront(batched), createLevelsBitset(batched->bdims()) };
 }
 
-std::vector<VmapPhysicalView>
-MultiBatchVmapTransform::logicalToPhysical(TensorList logical_tensors) {
-  TORCH_INTERNAL_ASSERT(false, "NYI");
-}
-
 int64_t VmapPhysicalView::numBatchDims() {
   return levels_.count();
 }
@@ -198,6 +193,45 @@ getLevelsAndLargestLogicalDim(TensorList logical_tensors) {
   return { levels, largest_logical_dim };
 }
 
+VmapPhysicalViewVec
+MultiBatchVmapTransform::logicalToPhysical(TensorList logical_tensors) {
+  TORCH_INTERNAL_ASSERT(logical_tensors.size() > 0);
+  std::bitset<kVmapNumLevels> levels;
+  for (const auto& tensor : logical_tensors) {
+    auto* batched = maybeGetBatched(tensor);
+    if (batched) {
+      levels = levels | createLevelsBitset(batched->bdims());
+    }
+  }
+  const auto num_batch_dims = static_cast<int64_t>(levels.count());
+
+  // Align the batch dims first. A tensor gets a size-one dimension for each
+  // level it isn't batched at, which the expand below fills in.
+  SmallVector<Tensor, kVmapTransformStaticInputSize> aligned_tensors;
+  VmapDimVector batch_sizes(num_batch_dims, 1);
+  for (const auto& tensor : logical_tensors) {
+    auto aligned = alignBatchDimsAtFront(tensor, levels, /*logical dim*/tensor.dim());
+    for (int64_t bdim = 0; bdim < num_batch_dims; bdim++) {
+      if (aligned.size(bdim) != 1) {
+        batch_sizes[bdim] = aligned.size(bdim);
+      }
+    }
+    aligned_tensors.push_back(std::move(aligned));
+  }
+
+  VmapPhysicalViewVec result;
+  for (const auto& aligned : aligned_tensors) {
+    VmapDimVector expanded_sizes(batch_sizes.begin(), batch_sizes.end());
+    auto aligned_sizes = aligned.sizes();
+    expanded_sizes.insert(
+        expanded_sizes.end(),
+        aligned_sizes.begin() + num_batch_dims,
+        aligned_sizes.end());
+    result.emplace_back(aligned.expand(expanded_sizes), levels);
+  }
+  return result;
+}
+
 VmapPhysicalViewVec BroadcastingVmapTransform::logicalToPhysical(TensorList logical_tensors) {
   TORCH_INTERNAL_ASSERT(
       logical_tensors.size() == 2,
@@ -51,9 +51,14 @@ using VmapDimVector = SmallVector<int64_t, kVmapStaticDimVecSize>;
 // permutes all of the batch dims to the front of the tensor, aligns
 // and expands the batch dims to match each other (according to their `level`),
 // and returns a VmapPhysicalView on the tensor(s).
+//
+// For example: given inputs of size (B0, 2) and (B1, 3) where B0 and B1 are
+// batch dimensions of levels 0 and 1, MultiBatchVmapTransform returns
+// VmapPhysicalViews that wrap tensors of size (B0, B1, 2) and (B0, B1, 3).
+// Unlike BroadcastingVmapTransform, the non-batch dims are left untouched.
 struct TORCH_API MultiBatchVmapTransform {
   static VmapPhysicalView logicalToPhysical(const Tensor& logical_tensor);
-  static std::vector<VmapPhysicalView> logicalToPhysical(TensorList logical_tensors);
+  static VmapPhysicalViewVec logicalToPhysical(TensorList logical_tensors);
 };
 
 // VmapTransform for operators that broadcast all inputs.
@@ -5,9 +5,11 @@
 
 #include <c10/util/intrusive_ptr.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
+#include <ATen/core/grad_mode.h>
 
 #include <iostream>
 #include <exception>
+#include <mutex>
 
 namespace at {
 namespace autocast {
@@ -36,9 +38,100 @@ namespace {
 //
 // I'm not using the weak_intrusive_ptr as the key because it's more difficult to compare
 // directly against incoming TensorImpl*s.
+//
+// The value also records the source's version counter at the time of the cast.  A cast
+// is only reused while the version matches, so in-place updates of the weight (e.g. by
+// the optimizer) invalidate it.  This lets a persistent cache (see autocast's
+// persistent_cache argument) survive across autocast regions.
 using weakref_type = c10::weak_intrusive_ptr<TensorImpl, UndefinedTensorImpl>;
-using val_type = std::tuple<weakref_type, Tensor>;
-thread_local std::unordered_map<TensorImpl*, val_type> cached_casts;
+struct CachedCast {
+  weakref_type source;
+  Tensor casted;
+  uint32_t version;
+};
+
+// Bytes held by the casts of all threads' caches, per device.  Reported along with the
+// CUDA allocator stats, see cast_cache_stats().
+std::mutex cast_cache_stats_mutex;
+std::vector<CastCacheStats> cast_cache_stats_per_device;
+
+void update_cast_cache_stats(const Tensor& casted, int64_t sign) {
+  const auto device = casted.get_device();
+  std::lock_guard<std::mutex> lock(cast_cache_stats_mutex);
+  if (device >= static_cast<int64_t>(cast_cache_stats_per_device.size())) {
+    cast_cache_stats_per_device.resize(device + 1);
+  }
+  auto& stats = cast_cache_stats_per_device[device];
+  stats.current_bytes += sign * static_cast<int64_t>(casted.nbytes());
+  stats.peak_bytes = std::max(stats.peak_bytes, stats.current_bytes);
+}
+
+uint32_t version_of(const Tensor& t) {
+  return t.unsafeGetTensorImpl()->version_counter().current_version();
+}
+
+class CastCache {
+ public:
+  ~CastCache() {
+    clear();
+  }
+
+  // Returns the cached cast of `arg`, or an undefined tensor if there is no valid one.
+  Tensor lookup(const Tensor& arg) {
+    auto it = casts_.find(arg.unsafeGetTensorImpl());
+    if (it == casts_.end()) {
+      return Tensor();
+    }
+    const auto& entry = it->second;
+    // A cast made under no_grad isn't part of the graph, so it can't be reused
+    // when grad mode is enabled, and vice versa.
+    if (entry.version == version_of(arg) &&
+        entry.casted.requires_grad() == GradMode::is_enabled()) {
+      return entry.casted;
+    }
+    update_cast_cache_stats(entry.casted, -1);
+    casts_.erase(it);
+    return Tensor();
+  }
+
+  void insert(const Tensor& arg, const Tensor& casted) {
+    // Persistent caches outlive the weights they were built for, drop the casts of
+    // deleted ones once in a while.  The threshold doubles, so this is amortized O(1).
+    if (casts_.size() >= sweep_threshold_) {
+      sweep();
+      sweep_threshold_ = std::max<size_t>(2 * casts_.size(), 64);
+    }
+    update_cast_cache_stats(casted, 1);
+    casts_.emplace(
+        arg.unsafeGetTensorImpl(),
+        CachedCast{weakref_type(arg.getIntrusivePtr()), casted, version_of(arg)});
+  }
+
+  void clear() {
+    for (const auto& kv : casts_) {
+      update_cast_cache_stats(kv.second.casted, -1);
+    }
+    casts_.clear();
+    sweep_threshold_ = 0;
+  }
+
+ private:
+  void sweep() {
+    for (auto it = casts_.begin(); it != casts_.end();) {
+      if (it->second.source.expired()) {
+        update_cast_cache_stats(it->second.casted, -1);
+        it = casts_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  std::unordered_map<TensorImpl*, CachedCast> casts_;
+  size_t sweep_threshold_ = 0;
+};
+
+thread_local CastCache cached_casts;
 
 // nesting tracks the nesting depth of the Python-side context manager.
 // When the autocast context manager exits to a nesting level that's outside
@@ -51,6 +144,22 @@ void clear_cache() {
   cached_casts.clear();
 }
 
+CastCacheStats cast_cache_stats(int64_t device) {
+  std::lock_guard<std::mutex> lock(cast_cache_stats_mutex);
+  if (device < 0 || device >= static_cast<int64_t>(cast_cache_stats_per_device.size())) {
+    return CastCacheStats();
+  }
+  return cast_cache_stats_per_device[device];
+}
+
+void reset_peak_cast_cache_stats(int64_t device) {
+  std::lock_guard<std::mutex> lock(cast_cache_stats_mutex);
+  if (device >= 0 && device < static_cast<int64_t>(cast_cache_stats_per_device.size())) {
+    auto& stats = cast_cache_stats_per_device[device];
+    stats.peak_bytes = stats.current_bytes;
+  }
+}
+
 int increment_nesting() {
   return ++nesting;
 }
@@ -149,12 +258,12 @@ inline Tensor cached_cast(at::ScalarType to_type, const Tensor& arg) {
     // See cached_casts declaration above for detailed strategy.
     bool can_try_cache = (to_type == at::kHalf && arg.scalar_type() == at::kFloat && arg.requires_grad() && arg.is_leaf());
     if (can_try_cache) {
-      auto it = cached_casts.find(arg.unsafeGetTensorImpl());
-      if (it != cached_casts.end()) {
-        return std::get<1>(it->second);
+      auto cached = cached_casts.lookup(arg);
+      if (cached.defined()) {
+        return cached;
       } else {
         auto casted_arg = arg.to(to_type);
-        cached_casts.emplace(arg.unsafeGetTensorImpl(), val_type{weakref_type(arg.getIntrusivePtr()), casted_arg});
+        cached_casts.insert(arg, casted_arg);
         return casted_arg;
       }
     } else {
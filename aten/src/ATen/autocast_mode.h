@@ -9,5 +9,14 @@ TORCH_API void clear_cache();
 TORCH_API int increment_nesting();
 TORCH_API int decrement_nesting();
 
+// Memory held by the cached casts of all threads, for one CUDA device.
+struct CastCacheStats {
+  int64_t current_bytes = 0;
+  int64_t peak_bytes = 0;
+};
+
+TORCH_API CastCacheStats cast_cache_stats(int64_t device);
+TORCH_API void reset_peak_cast_cache_stats(int64_t device);
+
 } // namespace autocast
 } // namespace at
@@ -62,6 +62,7 @@ _(aten, _cudnn_rnn_backward) \
 _(aten, _cudnn_rnn_flatten_weight) \
 _(aten, _cufft_clear_plan_cache) \
 _(aten, _cufft_get_plan_cache_max_size) \
+_(aten, _cufft_get_plan_cache_padded_size) \
 _(aten, _cufft_get_plan_cache_size) \
 _(aten, _cufft_set_plan_cache_max_size) \
 _(aten, _cumprod) \
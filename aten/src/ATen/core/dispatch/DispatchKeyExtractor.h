@@ -5,6 +5,7 @@
 #include <ATen/core/jit_type.h>
 #include <c10/util/Bitset.h>
 #include <c10/core/DispatchKeySet.h>
+#include <c10/core/impl/LocalDispatchKeySet.h>
 #include <ATen/core/Variadic.h>
 #include <ATen/core/stack.h>
 
@@ -12,11 +13,6 @@ namespace c10 {
 
 namespace impl {
 
-// Some keys are ALWAYS considered for inclusion by default, so they are
-// included in the set here.  (const appears to be sufficient for
-// always_included to get inlined, constexpr not necessary)
-const DispatchKeySet always_included{DispatchKey::Autograd, DispatchKey::BackendSelect};
-
 // Take a DispatchKeySet for a Tensor and determine what the actual dispatch
 // DispatchKey should be, taking into account TLS, and skipping backends which
 // fall through.
@@ -39,13 +35,9 @@ static inline DispatchKey dispatchTypeId(
     // function (as opposed to just applying it to the input 'ks').
     DispatchKeySet key_mask
 ) {
-  c10::impl::LocalDispatchKeySet local = c10::impl::tls_local_dispatch_key_set();
-  // TODO: It's a bit irritating that we have to do logical ORs here, it would
-  // be nice to only do one.  Can always_included be folded into the TLS?  Well,
-  // it's a bit troublesome, because fastpath TLS access requires the type of
-  // the TLS in question to be zero-initialized, so you don't actually win
-  // anyting in that case.
-  return (((ks | local.included_ | always_included) - local.excluded_) & key_mask).highestPriorityTypeId();
+  // The TLS caches (included | always_included) - excluded, so only the keys
+  // of the tensors are masked here.
+  return (c10::impl::tls_local_dispatch_key_set().apply(ks) & key_mask).highestPriorityTypeId();
 }
 
 }
@@ -127,8 +119,10 @@ public:
         // no safe toTensorRef method, alas)
         ks = ks | ivalue.unsafeToTensorImpl()->key_set();
       } else if (C10_UNLIKELY(ivalue.isTensorList())) {
-        for (const at::Tensor tensor : ivalue.toTensorList()) {
-          ks = ks | tensor.key_set();
+        // Borrows the elements, copying the list or its tensors would cost
+        // refcount updates for each of them.
+        for (const IValue& element : ivalue.toListRef()) {
+          ks = ks | element.unsafeToTensorImpl()->key_set();
         }
       }
     });
@@ -1,9 +1,48 @@
 #include <ATen/core/dispatch/Dispatcher.h>
+#include <array>
+#include <atomic>
 #include <list>
 #include <sstream>
 
 namespace c10 {
 
+namespace impl {
+
+namespace {
+constexpr size_t kNumDispatchKeys = static_cast<size_t>(DispatchKey::NumDispatchKeys);
+
+std::array<std::atomic<uint64_t>, kNumDispatchKeys>& dispatchCounts() {
+  static std::array<std::atomic<uint64_t>, kNumDispatchKeys> counts{};
+  return counts;
+}
+}
+
+bool dispatchStatsEnabled() {
+#ifdef USE_DISPATCH_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint64_t getDispatchCount(DispatchKey k) {
+  return dispatchCounts()[static_cast<size_t>(k)].load(std::memory_order_relaxed);
+}
+
+void resetDispatchCounts() {
+  for (auto& count : dispatchCounts()) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+#ifdef USE_DISPATCH_STATS
+void recordDispatch(DispatchKey k) {
+  dispatchCounts()[static_cast<size_t>(k)].fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+} // namespace impl
+
 namespace detail {
 
 class RegistrationListenerList final {
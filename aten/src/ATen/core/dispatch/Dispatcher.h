@@ -34,6 +34,27 @@ class RegistrationListenerList;
 }
 class SchemaRegistrationHandleRAII;
 
+namespace impl {
+
+/**
+ * Per dispatch key counters of the kernels the dispatcher invoked, for
+ * catching per-op overhead regressions: every call, redispatch and boxed
+ * call increments the counter of the key it ended up at, so an op that
+ * goes through Autograd and then CPU counts once for each.
+ *
+ * Counting costs an atomic increment per dispatch, so it is compiled in
+ * only when building with USE_DISPATCH_STATS=1. Otherwise the counters stay
+ * zero and dispatchStatsEnabled() returns false.
+ */
+CAFFE2_API bool dispatchStatsEnabled();
+CAFFE2_API uint64_t getDispatchCount(DispatchKey k);
+CAFFE2_API void resetDispatchCounts();
+#ifdef USE_DISPATCH_STATS
+CAFFE2_API void recordDispatch(DispatchKey k);
+#endif
+
+} // namespace impl
+
 /**
  * Top-level dispatch interface for dispatching via the dynamic dispatcher.
  * Most end users shouldn't use this directly; if you're trying to register
@@ -328,6 +349,9 @@ template<class Return, class... Args>
 inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(Args...)>& op, DispatchKey dispatchKey, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
   const KernelFunction& kernel = op.operatorIterator_->op.lookup(dispatchKey);
+#ifdef USE_DISPATCH_STATS
+  impl::recordDispatch(dispatchKey);
+#endif
   return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
 }
 
@@ -358,7 +382,47 @@ inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const
   const auto& entry = op.operatorIterator_->op;
   auto dispatchKey = entry.dispatchKeyExtractor().getDispatchKeyBoxed(stack);
   const auto& kernel = entry.lookup(dispatchKey);
+#ifdef USE_DISPATCH_STATS
+  impl::recordDispatch(dispatchKey);
+#endif
   kernel.callBoxed(op, stack);
 }
 
 } // namespace c10
+
+/**
+ * Returns a const reference to the OperatorHandle of `name`.`overload_name`.
+ * The operator is looked up on the first use of each call site and the
+ * handle is cached in a function-local static, so later calls skip the string
+ * lookup in the dispatcher's operator table:
+ *
+ *   const auto& op = TORCH_OPERATOR_HANDLE("myops::foo", "");
+ *
+ * The lookup is lazy rather than done at static initialization, so it doesn't
+ * depend on whether the TORCH_LIBRARY block defining the operator ran
+ * first. Like the handles cached by the codegen, a cached handle must not be
+ * used once its operator has been deregistered.
+ */
+#define TORCH_OPERATOR_HANDLE(name, overload_name)                         \
+  ([]() -> const ::c10::OperatorHandle& {                                  \
+    static const ::c10::OperatorHandle handle =                            \
+        ::c10::Dispatcher::singleton().findSchemaOrThrow(name, overload_name); \
+    return handle;                                                         \
+  }())
+
+/**
+ * Like TORCH_OPERATOR_HANDLE, but returns a TypedOperatorHandle for the given
+ * C++ function type, which is checked against the registered kernels only on
+ * the first use:
+ *
+ *   TORCH_TYPED_OPERATOR_HANDLE("myops::foo", "", Tensor(const Tensor&))
+ *       .call(self);
+ */
+#define TORCH_TYPED_OPERATOR_HANDLE(name, overload_name, ...)              \
+  ([]() -> const ::c10::TypedOperatorHandle<__VA_ARGS__>& {                \
+    static const ::c10::TypedOperatorHandle<__VA_ARGS__> handle =          \
+        ::c10::Dispatcher::singleton()                                     \
+            .findSchemaOrThrow(name, overload_name)                        \
+            .typed<__VA_ARGS__>();                                         \
+    return handle;                                                         \
+  }())
@@ -69,6 +69,8 @@ namespace c10 {
   _(prim, StringIndex)               \
   _(prim, NumToTensor)               \
   _(prim, Uninitialized)             \
+  _(prim, AllocateArena)             \
+  _(prim, ArenaTensor)               \
   _(prim, With)                      \
   _(prim, Enter)                     \
   _(prim, Exit)                      \
@@ -96,6 +98,7 @@ namespace c10 {
   _(prim, ConstantChunk)             \
   _(prim, MMTreeReduce)              \
   _(prim, MMBatchSide)               \
+  _(prim, BatchLinear)               \
   _(prim, min)                       \
   _(prim, max)                       \
   _(prim, abs)                       \
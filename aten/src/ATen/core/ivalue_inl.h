@@ -11,6 +11,7 @@
 #include <ATen/core/Dict.h>
 #include <ATen/core/List.h>
 #include <ATen/core/rref_interface.h>
+#include <c10/util/SmallVector.h>
 
 namespace torch {
 namespace jit {
@@ -183,7 +184,12 @@ struct CAFFE2_API Tuple : c10::intrusive_ptr_target {
 
   template <typename... Args>
   static c10::intrusive_ptr<Tuple> create(Args... elements_) {
-    return c10::make_intrusive<Tuple>(std::vector<IValue>{IValue(elements_)...});
+    // Emplaced instead of listed, since initializer lists copy their elements
+    std::vector<IValue> elements;
+    elements.reserve(sizeof...(Args));
+    (void)std::initializer_list<int>{
+        (elements.emplace_back(std::move(elements_)), 0)...};
+    return c10::make_intrusive<Tuple>(std::move(elements));
   }
 
  const std::vector<IValue>& elements() const & {
@@ -231,6 +237,11 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
 
  public:
   explicit Future(TypePtr type) : type_(type) {}
+
+  // Runs a callback, e.g. inline or by scheduling it on a thread pool such as
+  // at::launch.
+  using Executor = std::function<void(std::function<void(void)>)>;
+
   struct CAFFE2_API FutureError final : public std::exception {
     explicit FutureError(std::string&& error_msg_)
         : error_msg(std::move(error_msg_)) {}
@@ -248,6 +259,9 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
    * Wait on the future until it completes.
    */
   void wait() {
+    if (completed()) {
+      return;
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     while (!completed_) {
       finished_cv_.wait(lock);
@@ -263,17 +277,11 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
         !completed(),
         "Attempting to mark a completed Future as complete again. Note that "
         "a Future can only be marked completed once.");
-    completed_ = true;
+    // Set the value first, addCallback and wait check completed_ without
+    // taking the lock.
     value_ = std::move(value);
-
-    std::vector<std::function<void(void)>> cbs;
-    cbs.swap(callbacks_);
-    lock.unlock();
-
-    finished_cv_.notify_all();
-    for (auto& callback : cbs) {
-      callback();
-    }
+    completed_ = true;
+    runCallbacks(lock);
   }
 
   void markCompleted() {
@@ -327,8 +335,14 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
    * The callbacks will be executed once the future completes.
    * If the future has already completed,
    * this function will execute the callback immediately.
+   * The callbacks run inline on the thread that completes the future.
    */
   void addCallback(std::function<void(void)> callback) {
+    if (completed()) {
+      // No lock needed, completed_ is never reset.
+      callback();
+      return;
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     if (completed()) {
       lock.unlock();
@@ -338,27 +352,41 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
     callbacks_.emplace_back(std::move(callback));
   }
 
+  /**
+   * Same as above, but the callback is handed to `executor` once the future
+   * completes instead of being run inline.
+   */
+  void addCallback(std::function<void(void)> callback, Executor executor) {
+    addCallback(
+        [cb = std::move(callback), ex = std::move(executor)]() mutable {
+          ex(std::move(cb));
+        });
+  }
+
   /**
    * Add a callback to the future, and return another Future to hold the return
    * value of the callback. This is necessary when the callback provider needs
    * to know for sure when the callback has finished.
    */
+  template <typename T>
+  c10::intrusive_ptr<Future> then(T callback, TypePtr type) {
+    auto fut = c10::make_intrusive<Future>(std::move(type));
+    // The callback is stored as is rather than in a std::function of its own,
+    // so the chained callback is a single allocation.
+    addCallback(thenCallback(fut, std::move(callback)));
+    return fut;
+  }
+
+  /**
+   * Same as above, but `callback` is run by `executor`.
+   */
+  template <typename T>
   c10::intrusive_ptr<Future> then(
-      std::function<IValue(void)> callback,
-      TypePtr type) {
-    auto fut = c10::make_intrusive<Future>(type);
-    // Cannot move capture std::function in lambda, because it cannot deduce
-    // the template type for std::function. Hence use std::bind to explicitly
-    // specify types.
-    addCallback(std::bind(
-        [fut](std::function<IValue(void)> cb) {
-          try {
-            fut->markCompleted(cb());
-          } catch (std::exception& e) {
-            fut->setError(e.what());
-          }
-        },
-        std::move(callback)));
+      T callback,
+      TypePtr type,
+      Executor executor) {
+    auto fut = c10::make_intrusive<Future>(std::move(type));
+    addCallback(thenCallback(fut, std::move(callback)), std::move(executor));
     return fut;
   }
 
@@ -395,11 +423,14 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
       FutureError error,
       std::unique_lock<std::mutex>& lock) {
     AT_ASSERT(!completed());
-    completed_ = true;
     error_ = std::move(error);
+    completed_ = true;
+    runCallbacks(lock);
+  }
 
-    std::vector<std::function<void(void)>> cbs;
-    cbs.swap(callbacks_);
+  void runCallbacks(std::unique_lock<std::mutex>& lock) {
+    auto cbs = std::move(callbacks_);
+    callbacks_.clear();
     lock.unlock();
 
     finished_cv_.notify_all();
@@ -408,13 +439,30 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
     }
   }
 
+  template <typename T>
+  static std::function<void(void)> thenCallback(
+      c10::intrusive_ptr<Future> fut,
+      T callback) {
+    static_assert(
+        std::is_convertible<decltype(callback()), IValue>::value,
+        "The callback of then() must return an IValue");
+    return [fut = std::move(fut), cb = std::move(callback)]() mutable {
+      try {
+        fut->markCompleted(cb());
+      } catch (std::exception& e) {
+        fut->setError(e.what());
+      }
+    };
+  }
+
   mutable std::mutex mutex_;
   std::atomic_bool completed_ = {false}; // is this future complete
   std::condition_variable finished_cv_;
 
   IValue value_; // when finished the value
   TypePtr type_;
-  std::vector<std::function<void(void)>> callbacks_;
+  // Most futures get a single callback, keep it inline.
+  c10::SmallVector<std::function<void(void)>, 1> callbacks_;
   c10::optional<FutureError> error_;
 };
 
@@ -611,10 +659,18 @@ std::vector<Elem> generic_to(
     _fake_type<std::vector<Elem>>) {
   // We need to do a deep copy of the vector because there might be other
   // references to this same IValue that also use the list. We can't just
-  // move the elements out.
+  // move the elements out, unless we hold the only reference, which is the
+  // common case of a list built for a boxed call; that saves a refcount
+  // increment and decrement per element.
   auto list = std::move(ivalue).to<List<Elem>>();
   std::vector<Elem> result;
   result.reserve(list.size());
+  if (list.use_count() == 1) {
+    for (size_t i = 0, N = list.size(); i < N; ++i) {
+      result.push_back(list.extract(i));
+    }
+    return result;
+  }
   for (Elem v : list) {
     result.push_back(std::move(v));
   }
@@ -1710,6 +1710,30 @@ TEST(NewOperatorRegistrationTest, testDelayedListener) {
   EXPECT_EQ(initial_num_deregisters + 1, listener_ptr->num_deregisters_);
 }
 
+
+TORCH_LIBRARY(_test_handle, m) {
+  m.def("identity(Tensor self) -> Tensor", [](const Tensor& self) { return self; });
+}
+
+const OperatorHandle& cachedIdentityHandle() {
+  return TORCH_OPERATOR_HANDLE("_test_handle::identity", "");
+}
+
+Tensor callCachedIdentity(const Tensor& self) {
+  return TORCH_TYPED_OPERATOR_HANDLE("_test_handle::identity", "", Tensor(const Tensor&)).call(self);
+}
+
+TEST(NewOperatorRegistrationTest, operatorHandleMacros) {
+  const auto& op = cachedIdentityHandle();
+  EXPECT_EQ("_test_handle::identity", op.operator_name().name);
+  // Every call site does the lookup once and hands out the same handle.
+  EXPECT_EQ(&op, &cachedIdentityHandle());
+
+  auto t = dummyTensor(DispatchKey::CPU);
+  EXPECT_TRUE(callCachedIdentity(t).is_same(t));
+  EXPECT_TRUE(callCachedIdentity(t).is_same(t));
+}
+
 }
 
 #pragma GCC diagnostic pop
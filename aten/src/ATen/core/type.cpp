@@ -1252,6 +1252,16 @@ void ClassType::unsafeRemoveAttribute(const std::string& name) {
   AT_ASSERT(attributes_.size() == attributeTypes_.size());
 }
 
+void ClassType::unsafeChangeAttributeType(
+    const std::string& name,
+    TypePtr new_ty) {
+  auto slot = getAttributeSlot(name);
+  auto old_attr = attributes_.at(slot);
+  attributes_[slot] =
+      ClassAttribute(old_attr.getKind(), new_ty, old_attr.getName());
+  attributeTypes_[slot] = std::move(new_ty);
+}
+
 size_t ClassType::addConstant(const std::string& name, const IValue& value) {
   checkNotExist(name, "constant");
   size_t slot = constantNames_.size();
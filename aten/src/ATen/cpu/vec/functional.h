@@ -0,0 +1,13 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/cpu/vec256/functional.h>
+#if defined(CPU_CAPABILITY_AVX512)
+#include <ATen/cpu/vec512/functional.h>
+#endif
+
+// at::vec::map, reduce_all, ... operate on at::vec::Vectorized; see
+// ATen/cpu/vec/vec.h.
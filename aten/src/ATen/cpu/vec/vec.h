@@ -0,0 +1,32 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/vec256.h>
+#if defined(CPU_CAPABILITY_AVX512)
+#include <ATen/cpu/vec512/vec512.h>
+#endif
+
+namespace at {
+namespace vec {
+
+// Vectorized<T> is the widest vector type available to the file being
+// compiled: Vec512<T> when it is built for the AVX512 CPU capability and
+// Vec256<T> otherwise. Kernels that only rely on the common Vec256 / Vec512
+// interface (size(), loadu, store, the math methods and the free functions
+// below) should use it, together with the unqualified free functions
+// brought into this namespace, so that they pick up the wider registers for
+// free. Code that hardcodes an element count (e.g. 8 floats) must keep using
+// Vec256 directly.
+#if defined(CPU_CAPABILITY_AVX512)
+using namespace vec512;
+template <class T>
+using Vectorized = vec512::Vec512<T>;
+#else
+using namespace vec256;
+template <class T>
+using Vectorized = vec256::Vec256<T>;
+#endif
+
+}} // namespace at::vec
@@ -743,6 +743,13 @@ inline Vec256<T> fmadd(const Vec256<T>& a, const Vec256<T>& b, const Vec256<T>&
   return a * b + c;
 }
 
+// a * b.conj(), the product of cross-correlations and of the backward of
+// complex products. The complex specializations do it in one pass.
+template <typename T>
+inline Vec256<T> mul_conj(const Vec256<T>& a, const Vec256<T>& b) {
+  return a * b.conj();
+}
+
 template <int64_t scale = 1, typename T = void>
 std::enable_if_t<scale == 1 || scale == 2 || scale == 4 || scale == 8, Vec256<T>>
 inline gather(T const* base_addr, const Vec256<int_same_size_t<T>>& vindex) {
@@ -23,6 +23,12 @@ static inline void cvtbf16_fp32(const __m256i& a, __m256& o1, __m256& o2) {
   o2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(hi), 16));
 }
 static inline __m256i cvtfp32_bf16(const __m256& a, const __m256& b) {
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+  // vcvtneps2bf16 rounds to nearest even like the code below, but it treats
+  // denormal inputs as zero and keeps the payload of NaNs instead of
+  // returning 0x7fc0.
+  return (__m256i)_mm256_cvtne2ps_pbh(b, a);
+#else
   __m256i lo = _mm256_castps_si256(a);
   __m256i hi = _mm256_castps_si256(b);
   __m256i nan = _mm256_set1_epi32(0x7fc0);
@@ -48,6 +54,7 @@ static inline __m256i cvtfp32_bf16(const __m256& a, const __m256& b) {
 
   t_lo = _mm256_packus_epi32(t_lo, t_hi);      // t_hi[4-7] t_lo[4-7] t_hi[0-4] t_lo[0-4]
   return _mm256_permute4x64_epi64(t_lo, 0xd8); // 11        01        10        00
+#endif
 }
 
 template <> class Vec256<BFloat16> {
@@ -559,6 +566,44 @@ inline void convert(const BFloat16* src, BFloat16* dst, int64_t n) {
   }
 }
 
+template <>
+inline void convert(const BFloat16* src, float* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<BFloat16>::size()); i += Vec256<BFloat16>::size()) {
+    __m256 lo, hi;
+    cvtbf16_fp32(Vec256<BFloat16>::loadu(src + i), lo, hi);
+    _mm256_storeu_ps(dst + i, lo);
+    _mm256_storeu_ps(dst + i + Vec256<BFloat16>::size() / 2, hi);
+  }
+  // Half a vector, e.g. when filling a Vec256<float>
+  if (i + Vec256<BFloat16>::size() / 2 <= n) {
+    auto o = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))), 16));
+    _mm256_storeu_ps(dst + i, o);
+    i += Vec256<BFloat16>::size() / 2;
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, BFloat16* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<BFloat16>::size()); i += Vec256<BFloat16>::size()) {
+    auto lo = _mm256_loadu_ps(src + i);
+    auto hi = _mm256_loadu_ps(src + i + Vec256<BFloat16>::size() / 2);
+    Vec256<BFloat16>(cvtfp32_bf16(lo, hi)).store(dst + i);
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<BFloat16>(src[i]);
+  }
+}
+
 template <>
 Vec256<BFloat16> inline fmadd(const Vec256<BFloat16>& a,
     const Vec256<BFloat16>& b, const Vec256<BFloat16>& c) {
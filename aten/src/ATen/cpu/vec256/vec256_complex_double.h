@@ -159,7 +159,9 @@ public:
   }
   Vec256<c10::complex<double>> log() const {
     // Most trigonomic ops use the log() op to improve complex number performance.
-    return map(std::log);
+    // log(a + bi) = log(abs()) + angle()i
+    auto ln = Sleef_logd4_u10(abs_());                                //ln(abs)       ln(abs)
+    return _mm256_blend_pd(ln, angle_(), 0x0A);                       //ln(abs)       angle
   }
   Vec256<c10::complex<double>> log2() const {
     const __m256d log2_ = _mm256_set1_pd(std::log(2));
@@ -357,6 +359,19 @@ template <> Vec256<c10::complex<double>> inline operator/(const Vec256<c10::comp
   return _mm256_div_pd(re_im, b.abs_2_());
 }
 
+template <> Vec256<c10::complex<double>> inline mul_conj(const Vec256<c10::complex<double>> &a, const Vec256<c10::complex<double>> &b) {
+  //(a + bi)  * (c - di) = (ac + bd) + (bc - ad)i, the numerator of a / b
+  const __m256d sign_mask = _mm256_setr_pd(-0.0, 0.0, -0.0, 0.0);
+  auto ac_bd = _mm256_mul_pd(a, b);         //ac       bd
+
+  auto d_c = _mm256_permute_pd(b, 0x05);    //d        c
+  d_c = _mm256_xor_pd(sign_mask, d_c);      //-d       c
+  auto ad_bc = _mm256_mul_pd(a, d_c);       //-ad      bc
+
+  auto re_im = _mm256_hadd_pd(ac_bd, ad_bc);//ac + bd  bc - ad
+  return re_im;
+}
+
 // reciprocal. Implement this here so we can use multiplication.
 Vec256<c10::complex<double>> Vec256<c10::complex<double>>::reciprocal() const{
   //re + im*i = (a + bi)  / (c + di)
@@ -196,7 +196,9 @@ public:
   }
   Vec256<c10::complex<float>> log() const {
     // Most trigonomic ops use the log() op to improve complex number performance.
-    return map(std::log);
+    // log(a + bi) = log(abs()) + angle()i
+    auto ln = Sleef_logf8_u10(abs_());                                //ln(abs)       ln(abs)
+    return _mm256_blend_ps(ln, angle_(), 0xAA);                       //ln(abs)       angle
   }
   Vec256<c10::complex<float>> log2() const {
     const __m256 log2_ = _mm256_set1_ps(std::log(2));
@@ -397,6 +399,20 @@ template <> Vec256<c10::complex<float>> inline operator/(const Vec256<c10::compl
   return _mm256_div_ps(re_im, b.abs_2_());
 }
 
+template <> Vec256<c10::complex<float>> inline mul_conj(const Vec256<c10::complex<float>> &a, const Vec256<c10::complex<float>> &b) {
+  //(a + bi)  * (c - di) = (ac + bd) + (bc - ad)i, the numerator of a / b
+  const __m256 sign_mask = _mm256_setr_ps(-0.0, 0.0, -0.0, 0.0, -0.0, 0.0, -0.0, 0.0);
+  auto ac_bd = _mm256_mul_ps(a, b);         //ac       bd
+
+  auto d_c = _mm256_permute_ps(b, 0xB1);    //d        c
+  d_c = _mm256_xor_ps(sign_mask, d_c);      //-d       c
+  auto ad_bc = _mm256_mul_ps(a, d_c);       //-ad      bc
+
+  auto re_im = _mm256_hadd_ps(ac_bd, ad_bc);//ac + bd  bc - ad
+  re_im = _mm256_permute_ps(re_im, 0xD8);
+  return re_im;
+}
+
 // reciprocal. Implement this here so we can use multiplication.
 Vec256<c10::complex<float>> Vec256<c10::complex<float>>::reciprocal() const {
   //re + im*i = (a + bi)  / (c + di)
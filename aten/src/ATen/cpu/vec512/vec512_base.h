@@ -0,0 +1,470 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#if defined(__GNUC__)
+#define __at_align64__ __attribute__((aligned(64)))
+#elif defined(_WIN32)
+#define __at_align64__ __declspec(align(64))
+#else
+#define __at_align64__
+#endif
+
+// Note [Vec512]
+// ~~~~~~~~~~~~~
+// Vec512<T> is the 512-bit counterpart of Vec256<T> and has the same
+// interface, with twice as many elements.
+//
+// The generic Vec512<T> below is built from two Vec256<T> halves and forwards
+// every operation to them, so every T that has a Vec256 also has a Vec512 and
+// it is never slower than two Vec256 operations. When a file is compiled with
+// CPU_CAPABILITY_AVX512, float, double, int64_t, int32_t, int16_t and BFloat16
+// are specialized to operate on zmm registers directly; the quantized types
+// keep the two-halves layout (see vec512_qint.h).
+//
+// Every Vec512<T>, generic or specialized, can be constructed from its two
+// halves and exposes them through get_low() and get_high(). The generic free
+// functions in this file only rely on that, so a specialization only needs to
+// override the operations it can do better.
+//
+// Kernels should not name Vec512 directly: use at::vec::Vectorized from
+// ATen/cpu/vec/vec.h, which picks the widest vector the file is compiled for.
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+using vec256::int_same_size_t;
+using vec256::convert;
+
+template <class T>
+struct Vec512 {
+private:
+  using half_t = vec256::Vec256<T>;
+  half_t lo_;
+  half_t hi_;
+public:
+  using value_type = typename half_t::value_type;
+  // See Note [constexpr static function to avoid odr-usage compiler bug]
+  static constexpr int size() {
+    return 2 * half_t::size();
+  }
+  Vec512() : lo_(), hi_() {}
+  Vec512(T val) : lo_(val), hi_(val) {}
+  Vec512(const half_t& lo, const half_t& hi) : lo_(lo), hi_(hi) {}
+  template<typename... Args,
+           typename = std::enable_if_t<(sizeof...(Args) == size())>>
+  Vec512(Args... vals) {
+    __at_align64__ T buffer[size()] = {static_cast<T>(vals)...};
+    *this = loadu(buffer);
+  }
+  const half_t& get_low() const {
+    return lo_;
+  }
+  const half_t& get_high() const {
+    return hi_;
+  }
+  template <int64_t mask>
+  static Vec512<T> blend(const Vec512<T>& a, const Vec512<T>& b) {
+    constexpr int64_t half_mask = (int64_t(1) << half_t::size()) - 1;
+    return Vec512<T>(
+        half_t::template blend<(mask & half_mask)>(a.lo_, b.lo_),
+        half_t::template blend<((mask >> half_t::size()) & half_mask)>(a.hi_, b.hi_));
+  }
+  static Vec512<T> blendv(const Vec512<T>& a, const Vec512<T>& b,
+                          const Vec512<T>& mask) {
+    return Vec512<T>(
+        half_t::blendv(a.lo_, b.lo_, mask.lo_),
+        half_t::blendv(a.hi_, b.hi_, mask.hi_));
+  }
+  template<typename step_t>  // step sometimes requires a higher precision type (e.g., T=int, step_t=double)
+  static Vec512<T> arange(T base = static_cast<T>(0), step_t step = static_cast<step_t>(1)) {
+    return Vec512<T>(
+        half_t::arange(base, step),
+        half_t::arange(static_cast<T>(base + half_t::size() * step), step));
+  }
+  static Vec512<T> set(const Vec512<T>& a, const Vec512<T>& b, int64_t count = size()) {
+    if (count <= half_t::size()) {
+      return Vec512<T>(half_t::set(a.lo_, b.lo_, count), a.hi_);
+    }
+    return Vec512<T>(b.lo_, half_t::set(a.hi_, b.hi_, count - half_t::size()));
+  }
+  static Vec512<T> loadu(const void* ptr) {
+    auto hi_ptr = static_cast<const char*>(ptr) + half_t::size() * sizeof(value_type);
+    return Vec512<T>(half_t::loadu(ptr), half_t::loadu(hi_ptr));
+  }
+  static Vec512<T> loadu(const void* ptr, int64_t count) {
+    if (count == size()) {
+      return loadu(ptr);
+    }
+    if (count <= half_t::size()) {
+      return Vec512<T>(half_t::loadu(ptr, count), half_t(static_cast<T>(0)));
+    }
+    auto hi_ptr = static_cast<const char*>(ptr) + half_t::size() * sizeof(value_type);
+    return Vec512<T>(half_t::loadu(ptr), half_t::loadu(hi_ptr, count - half_t::size()));
+  }
+  void store(void* ptr, int count = size()) const {
+    auto hi_ptr = static_cast<char*>(ptr) + half_t::size() * sizeof(value_type);
+    if (count <= half_t::size()) {
+      lo_.store(ptr, count);
+    } else {
+      lo_.store(ptr);
+      hi_.store(hi_ptr, count - half_t::size());
+    }
+  }
+  int64_t zero_mask() const {
+    // returns an integer mask where all zero elements are translated to 1-bit and others are translated to 0-bit
+    return static_cast<int64_t>(lo_.zero_mask()) |
+        (static_cast<int64_t>(hi_.zero_mask()) << half_t::size());
+  }
+  Vec512<T> map(T (*f)(T)) const {
+    return Vec512<T>(lo_.map(f), hi_.map(f));
+  }
+  Vec512<T> map(T (*f)(const T &)) const {
+    return Vec512<T>(lo_.map(f), hi_.map(f));
+  }
+  Vec512<T> abs() const {
+    return Vec512<T>(lo_.abs(), hi_.abs());
+  }
+  Vec512<T> angle() const {
+    return Vec512<T>(lo_.angle(), hi_.angle());
+  }
+  Vec512<T> real() const {
+    return Vec512<T>(lo_.real(), hi_.real());
+  }
+  Vec512<T> imag() const {
+    return Vec512<T>(lo_.imag(), hi_.imag());
+  }
+  Vec512<T> conj() const {
+    return Vec512<T>(lo_.conj(), hi_.conj());
+  }
+  Vec512<T> acos() const {
+    return Vec512<T>(lo_.acos(), hi_.acos());
+  }
+  Vec512<T> asin() const {
+    return Vec512<T>(lo_.asin(), hi_.asin());
+  }
+  Vec512<T> atan() const {
+    return Vec512<T>(lo_.atan(), hi_.atan());
+  }
+  Vec512<T> atan2(const Vec512<T> &b) const {
+    return Vec512<T>(lo_.atan2(b.lo_), hi_.atan2(b.hi_));
+  }
+  Vec512<T> erf() const {
+    return Vec512<T>(lo_.erf(), hi_.erf());
+  }
+  Vec512<T> erfc() const {
+    return Vec512<T>(lo_.erfc(), hi_.erfc());
+  }
+  Vec512<T> erfinv() const {
+    return Vec512<T>(lo_.erfinv(), hi_.erfinv());
+  }
+  Vec512<T> exp() const {
+    return Vec512<T>(lo_.exp(), hi_.exp());
+  }
+  Vec512<T> expm1() const {
+    return Vec512<T>(lo_.expm1(), hi_.expm1());
+  }
+  Vec512<T> frac() const {
+    return Vec512<T>(lo_.frac(), hi_.frac());
+  }
+  Vec512<T> fmod(const Vec512<T>& q) const {
+    return Vec512<T>(lo_.fmod(q.lo_), hi_.fmod(q.hi_));
+  }
+  Vec512<T> log() const {
+    return Vec512<T>(lo_.log(), hi_.log());
+  }
+  Vec512<T> log10() const {
+    return Vec512<T>(lo_.log10(), hi_.log10());
+  }
+  Vec512<T> log1p() const {
+    return Vec512<T>(lo_.log1p(), hi_.log1p());
+  }
+  Vec512<T> log2() const {
+    return Vec512<T>(lo_.log2(), hi_.log2());
+  }
+  Vec512<T> ceil() const {
+    return Vec512<T>(lo_.ceil(), hi_.ceil());
+  }
+  Vec512<T> cos() const {
+    return Vec512<T>(lo_.cos(), hi_.cos());
+  }
+  Vec512<T> cosh() const {
+    return Vec512<T>(lo_.cosh(), hi_.cosh());
+  }
+  Vec512<T> floor() const {
+    return Vec512<T>(lo_.floor(), hi_.floor());
+  }
+  Vec512<T> neg() const {
+    return Vec512<T>(lo_.neg(), hi_.neg());
+  }
+  Vec512<T> round() const {
+    return Vec512<T>(lo_.round(), hi_.round());
+  }
+  Vec512<T> sin() const {
+    return Vec512<T>(lo_.sin(), hi_.sin());
+  }
+  Vec512<T> sinh() const {
+    return Vec512<T>(lo_.sinh(), hi_.sinh());
+  }
+  Vec512<T> tan() const {
+    return Vec512<T>(lo_.tan(), hi_.tan());
+  }
+  Vec512<T> tanh() const {
+    return Vec512<T>(lo_.tanh(), hi_.tanh());
+  }
+  Vec512<T> trunc() const {
+    return Vec512<T>(lo_.trunc(), hi_.trunc());
+  }
+  Vec512<T> lgamma() const {
+    return Vec512<T>(lo_.lgamma(), hi_.lgamma());
+  }
+  Vec512<T> sqrt() const {
+    return Vec512<T>(lo_.sqrt(), hi_.sqrt());
+  }
+  Vec512<T> reciprocal() const {
+    return Vec512<T>(lo_.reciprocal(), hi_.reciprocal());
+  }
+  Vec512<T> rsqrt() const {
+    return Vec512<T>(lo_.rsqrt(), hi_.rsqrt());
+  }
+  Vec512<T> pow(const Vec512<T> &exp) const {
+    return Vec512<T>(lo_.pow(exp.lo_), hi_.pow(exp.hi_));
+  }
+  Vec512<T> operator==(const Vec512<T>& other) const {
+    return Vec512<T>(lo_ == other.lo_, hi_ == other.hi_);
+  }
+  Vec512<T> operator!=(const Vec512<T>& other) const {
+    return Vec512<T>(lo_ != other.lo_, hi_ != other.hi_);
+  }
+  Vec512<T> operator>=(const Vec512<T>& other) const {
+    return Vec512<T>(lo_ >= other.lo_, hi_ >= other.hi_);
+  }
+  Vec512<T> operator<=(const Vec512<T>& other) const {
+    return Vec512<T>(lo_ <= other.lo_, hi_ <= other.hi_);
+  }
+  Vec512<T> operator>(const Vec512<T>& other) const {
+    return Vec512<T>(lo_ > other.lo_, hi_ > other.hi_);
+  }
+  Vec512<T> operator<(const Vec512<T>& other) const {
+    return Vec512<T>(lo_ < other.lo_, hi_ < other.hi_);
+  }
+  Vec512<T> eq(const Vec512<T>& other) const {
+    return Vec512<T>(lo_.eq(other.lo_), hi_.eq(other.hi_));
+  }
+  Vec512<T> ne(const Vec512<T>& other) const {
+    return Vec512<T>(lo_.ne(other.lo_), hi_.ne(other.hi_));
+  }
+  Vec512<T> gt(const Vec512<T>& other) const {
+    return Vec512<T>(lo_.gt(other.lo_), hi_.gt(other.hi_));
+  }
+  Vec512<T> ge(const Vec512<T>& other) const {
+    return Vec512<T>(lo_.ge(other.lo_), hi_.ge(other.hi_));
+  }
+  Vec512<T> lt(const Vec512<T>& other) const {
+    return Vec512<T>(lo_.lt(other.lo_), hi_.lt(other.hi_));
+  }
+  Vec512<T> le(const Vec512<T>& other) const {
+    return Vec512<T>(lo_.le(other.lo_), hi_.le(other.hi_));
+  }
+};
+
+template <class T> Vec512<T> inline operator+(const Vec512<T> &a, const Vec512<T> &b) {
+  return Vec512<T>(a.get_low() + b.get_low(), a.get_high() + b.get_high());
+}
+
+template <class T> Vec512<T> inline operator-(const Vec512<T> &a, const Vec512<T> &b) {
+  return Vec512<T>(a.get_low() - b.get_low(), a.get_high() - b.get_high());
+}
+
+template <class T> Vec512<T> inline operator*(const Vec512<T> &a, const Vec512<T> &b) {
+  return Vec512<T>(a.get_low() * b.get_low(), a.get_high() * b.get_high());
+}
+
+template <class T> Vec512<T> inline operator/(const Vec512<T> &a, const Vec512<T> &b) __ubsan_ignore_float_divide_by_zero__ {
+  return Vec512<T>(a.get_low() / b.get_low(), a.get_high() / b.get_high());
+}
+
+template <class T> Vec512<T> inline operator&(const Vec512<T> &a, const Vec512<T> &b) {
+  return Vec512<T>(a.get_low() & b.get_low(), a.get_high() & b.get_high());
+}
+
+template <class T> Vec512<T> inline operator|(const Vec512<T> &a, const Vec512<T> &b) {
+  return Vec512<T>(a.get_low() | b.get_low(), a.get_high() | b.get_high());
+}
+
+template <class T> Vec512<T> inline operator^(const Vec512<T> &a, const Vec512<T> &b) {
+  return Vec512<T>(a.get_low() ^ b.get_low(), a.get_high() ^ b.get_high());
+}
+
+// Like vec256::maximum, propagates NaN if either input is a NaN.
+template <class T> Vec512<T> inline maximum(const Vec512<T> &a, const Vec512<T> &b) {
+  return Vec512<T>(
+      vec256::maximum(a.get_low(), b.get_low()),
+      vec256::maximum(a.get_high(), b.get_high()));
+}
+
+// Like vec256::minimum, propagates NaN if either input is a NaN.
+template <class T> Vec512<T> inline minimum(const Vec512<T> &a, const Vec512<T> &b) {
+  return Vec512<T>(
+      vec256::minimum(a.get_low(), b.get_low()),
+      vec256::minimum(a.get_high(), b.get_high()));
+}
+
+template <class T>
+Vec512<T> inline clamp(const Vec512<T> &a, const Vec512<T> &min_vec, const Vec512<T> &max_vec) {
+  return Vec512<T>(
+      vec256::clamp(a.get_low(), min_vec.get_low(), max_vec.get_low()),
+      vec256::clamp(a.get_high(), min_vec.get_high(), max_vec.get_high()));
+}
+
+template <class T>
+Vec512<T> inline clamp_max(const Vec512<T> &a, const Vec512<T> &max_vec) {
+  return Vec512<T>(
+      vec256::clamp_max(a.get_low(), max_vec.get_low()),
+      vec256::clamp_max(a.get_high(), max_vec.get_high()));
+}
+
+template <class T>
+Vec512<T> inline clamp_min(const Vec512<T> &a, const Vec512<T> &min_vec) {
+  return Vec512<T>(
+      vec256::clamp_min(a.get_low(), min_vec.get_low()),
+      vec256::clamp_min(a.get_high(), min_vec.get_high()));
+}
+
+template <typename T>
+inline Vec512<T>& operator += (Vec512<T>& a, const Vec512<T>& b) {
+  a = a + b;
+  return a;
+}
+template <typename T>
+inline Vec512<T>& operator -= (Vec512<T>& a, const Vec512<T>& b) {
+  a = a - b;
+  return a;
+}
+template <typename T>
+inline Vec512<T>& operator /= (Vec512<T>& a, const Vec512<T>& b) {
+  a = a / b;
+  return a;
+}
+template <typename T>
+inline Vec512<T>& operator *= (Vec512<T>& a, const Vec512<T>& b) {
+  a = a * b;
+  return a;
+}
+
+template <typename T>
+inline Vec512<T> fmadd(const Vec512<T>& a, const Vec512<T>& b, const Vec512<T>& c) {
+  return Vec512<T>(
+      vec256::fmadd(a.get_low(), b.get_low(), c.get_low()),
+      vec256::fmadd(a.get_high(), b.get_high(), c.get_high()));
+}
+
+template <typename T>
+inline Vec512<T> mul_conj(const Vec512<T>& a, const Vec512<T>& b) {
+  return Vec512<T>(
+      vec256::mul_conj(a.get_low(), b.get_low()),
+      vec256::mul_conj(a.get_high(), b.get_high()));
+}
+
+template <int64_t scale = 1, typename T = void>
+std::enable_if_t<scale == 1 || scale == 2 || scale == 4 || scale == 8, Vec512<T>>
+inline gather(T const* base_addr, const Vec512<int_same_size_t<T>>& vindex) {
+  return Vec512<T>(
+      vec256::gather<scale>(base_addr, vindex.get_low()),
+      vec256::gather<scale>(base_addr, vindex.get_high()));
+}
+
+template <int64_t scale = 1, typename T = void>
+std::enable_if_t<scale == 1 || scale == 2 || scale == 4 || scale == 8, Vec512<T>>
+inline mask_gather(const Vec512<T>& src, T const* base_addr,
+                   const Vec512<int_same_size_t<T>>& vindex, Vec512<T>& mask) {
+  auto mask_lo = mask.get_low();
+  auto mask_hi = mask.get_high();
+  auto lo = vec256::mask_gather<scale>(src.get_low(), base_addr, vindex.get_low(), mask_lo);
+  auto hi = vec256::mask_gather<scale>(src.get_high(), base_addr, vindex.get_high(), mask_hi);
+  mask = Vec512<T>(mask_lo, mask_hi);  // both halves were zeroed out
+  return Vec512<T>(lo, hi);
+}
+
+// Cast a given vector to another type without changing the bits representation.
+// See vec256::cast.
+template<typename dst_t, typename src_t>
+struct CastImpl {
+  static inline Vec512<dst_t> apply(const Vec512<src_t>& src) {
+    return Vec512<dst_t>(
+        vec256::cast<dst_t, src_t>(src.get_low()),
+        vec256::cast<dst_t, src_t>(src.get_high()));
+  }
+};
+
+template<typename scalar_t>
+struct CastImpl<scalar_t, scalar_t> {
+  static inline Vec512<scalar_t> apply(const Vec512<scalar_t>& src) {
+    return src;
+  }
+};
+
+template<typename dst_t, typename src_t>
+inline Vec512<dst_t> cast(const Vec512<src_t>& src) {
+  return CastImpl<dst_t, src_t>::apply(src);
+}
+
+template <typename T>
+inline Vec512<int_same_size_t<T>> convert_to_int_of_same_size(const Vec512<T>& src) {
+  return Vec512<int_same_size_t<T>>(
+      vec256::convert_to_int_of_same_size(src.get_low()),
+      vec256::convert_to_int_of_same_size(src.get_high()));
+}
+
+// The elements are paired across the whole 512-bit vector, so this cannot be
+// done half by half. See vec256::deinterleave2 for the layout.
+template <typename T>
+inline std::enable_if_t<Vec512<T>::size() % 2 == 0, std::pair<Vec512<T>, Vec512<T>>>
+deinterleave2(const Vec512<T>& a, const Vec512<T>& b) {
+  static constexpr int size = Vec512<T>::size();
+  static constexpr int half_size = size / 2;
+  T a_arr[size];
+  T b_arr[size];
+  T buffer1[size];
+  T buffer2[size];
+  a.store(static_cast<void*>(a_arr));
+  b.store(static_cast<void*>(b_arr));
+  for (int64_t i = 0; i < half_size; i++) {
+    buffer1[i] = a_arr[i * 2];
+    buffer1[half_size + i] = b_arr[i * 2];
+    buffer2[i] = a_arr[i * 2 + 1];
+    buffer2[half_size + i] = b_arr[i * 2 + 1];
+  }
+  return std::make_pair(Vec512<T>::loadu(static_cast<void*>(buffer1)),
+                        Vec512<T>::loadu(static_cast<void*>(buffer2)));
+}
+
+// inverse operation of deinterleave2
+template <typename T>
+inline std::enable_if_t<Vec512<T>::size() % 2 == 0, std::pair<Vec512<T>, Vec512<T>>>
+interleave2(const Vec512<T>& a, const Vec512<T>& b) {
+  static constexpr int size = Vec512<T>::size();
+  static constexpr int half_size = size / 2;
+  T a_arr[size];
+  T b_arr[size];
+  T buffer1[size];
+  T buffer2[size];
+  a.store(static_cast<void*>(a_arr));
+  b.store(static_cast<void*>(b_arr));
+  for (int64_t i = 0; i < half_size; i++) {
+    buffer1[i * 2] = a_arr[i];
+    buffer1[i * 2 + 1] = b_arr[i];
+    buffer2[i * 2] = a_arr[half_size + i];
+    buffer2[i * 2 + 1] = b_arr[half_size + i];
+  }
+  return std::make_pair(Vec512<T>::loadu(static_cast<void*>(buffer1)),
+                        Vec512<T>::loadu(static_cast<void*>(buffer2)));
+}
+
+}}}
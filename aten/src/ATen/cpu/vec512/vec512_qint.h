@@ -0,0 +1,207 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/vec256_qint.h>
+#include <ATen/cpu/vec512/vec512_base.h>
+#include <ATen/cpu/vec512/vec512_float.h>
+#include <c10/util/qint32.h>
+#include <c10/util/qint8.h>
+#include <c10/util/quint8.h>
+
+#include <array>
+
+// The quantized Vec512 types keep the two Vec256 halves of the generic
+// Vec512 (see Note [Vec512]) and only add the quantization interface of
+// Vec256<qint8> and friends on top of them.
+//
+// dequantize() and quantize() convert between one quantized vector and
+// float_num_vecs() float vectors holding consecutive elements, exactly as
+// Vec256 does: element i of the quantized vector lands in lane
+// i % Vec512<float>::size() of float vector i / Vec512<float>::size(). The
+// scale and zero point vectors passed to dequantize() are expected to be
+// broadcasts of a single value, which is how every quantized kernel uses them.
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+template <typename T>
+struct Vec512qi {
+ protected:
+  using half_t = vec256::Vec256<T>;
+  half_t lo_;
+  half_t hi_;
+
+  // Regroups the 2 * N Vec256<U> pieces produced by the two halves (low half
+  // first) into N Vec512<U>, each made of two consecutive pieces.
+  template <typename U, size_t N>
+  static std::array<Vec512<U>, N> combine(
+      const std::array<vec256::Vec256<U>, N>& lo,
+      const std::array<vec256::Vec256<U>, N>& hi) {
+    std::array<Vec512<U>, N> out;
+    for (size_t k = 0; k < N; ++k) {
+      const auto& first = (2 * k < N) ? lo[2 * k] : hi[2 * k - N];
+      const auto& second = (2 * k + 1 < N) ? lo[2 * k + 1] : hi[2 * k + 1 - N];
+      out[k] = Vec512<U>(first, second);
+    }
+    return out;
+  }
+
+  // Inverse of combine().
+  template <typename U, size_t N>
+  static void split(
+      const std::array<Vec512<U>, N>& in,
+      std::array<vec256::Vec256<U>, N>& lo,
+      std::array<vec256::Vec256<U>, N>& hi) {
+    for (size_t k = 0; k < N; ++k) {
+      auto& first = (2 * k < N) ? lo[2 * k] : hi[2 * k - N];
+      auto& second = (2 * k + 1 < N) ? lo[2 * k + 1] : hi[2 * k + 1 - N];
+      first = in[k].get_low();
+      second = in[k].get_high();
+    }
+  }
+
+ public:
+  static constexpr int size() {
+    return 2 * half_t::size();
+  }
+  static constexpr int float_num_vecs() {
+    return half_t::float_num_vecs();
+  }
+  static constexpr int int_num_vecs() {
+    return half_t::int_num_vecs();
+  }
+
+  using float_vec_return_type = std::array<Vec512<float>, half_t::float_num_vecs()>;
+  using int_vec_return_type = std::array<Vec512<c10::qint32>, half_t::int_num_vecs()>;
+  using value_type = typename half_t::value_type;
+
+  Vec512qi() {}
+  Vec512qi(const T& val) : lo_(val), hi_(val) {}
+  Vec512qi(const half_t& lo, const half_t& hi) : lo_(lo), hi_(hi) {}
+
+  half_t get_low() const {
+    return lo_;
+  }
+  half_t get_high() const {
+    return hi_;
+  }
+
+  static Vec512<T> loadu(const void* ptr) {
+    const auto* p = reinterpret_cast<const value_type*>(ptr);
+    return Vec512<T>(half_t::loadu(p), half_t::loadu(p + half_t::size()));
+  }
+
+  void store(void* ptr, int count = size()) const {
+    auto* p = reinterpret_cast<value_type*>(ptr);
+    if (count <= half_t::size()) {
+      lo_.store(p, count);
+    } else {
+      lo_.store(p);
+      hi_.store(p + half_t::size(), count - half_t::size());
+    }
+  }
+
+  float_vec_return_type dequantize(
+      Vec512<float> scale,
+      Vec512<float> zero_point,
+      Vec512<float> scale_zp_premul) const {
+    auto lo = lo_.dequantize(
+        scale.get_low(), zero_point.get_low(), scale_zp_premul.get_low());
+    auto hi = hi_.dequantize(
+        scale.get_high(), zero_point.get_high(), scale_zp_premul.get_high());
+    return combine(lo, hi);
+  }
+
+  static Vec512<T> quantize(
+      const float_vec_return_type& rhs,
+      float scale,
+      int32_t zero_point,
+      float inverse_scale) {
+    typename half_t::float_vec_return_type lo, hi;
+    split(rhs, lo, hi);
+    return Vec512<T>(
+        half_t::quantize(lo, scale, zero_point, inverse_scale),
+        half_t::quantize(hi, scale, zero_point, inverse_scale));
+  }
+
+  Vec512<T> maximum(Vec512<T> b) const {
+    return Vec512<T>(lo_.maximum(b.get_low()), hi_.maximum(b.get_high()));
+  }
+
+  Vec512<T> minimum(Vec512<T> b) const {
+    return Vec512<T>(lo_.minimum(b.get_low()), hi_.minimum(b.get_high()));
+  }
+
+  Vec512<T> relu(Vec512<T> zero_point) const {
+    return Vec512<T>(
+        lo_.relu(zero_point.get_low()), hi_.relu(zero_point.get_high()));
+  }
+
+  Vec512<T> relu6(Vec512<T> zero_point, Vec512<T> q_six) {
+    return Vec512<T>(
+        lo_.relu6(zero_point.get_low(), q_six.get_low()),
+        hi_.relu6(zero_point.get_high(), q_six.get_high()));
+  }
+
+  int_vec_return_type widening_subtract(Vec512<T> b) const {
+    auto lo = lo_.widening_subtract(b.get_low());
+    auto hi = hi_.widening_subtract(b.get_high());
+    return combine(lo, hi);
+  }
+
+  static Vec512<T> requantize_from_int(
+      const int_vec_return_type& inp,
+      float multiplier,
+      int32_t zero_point) {
+    typename half_t::int_vec_return_type lo, hi;
+    split(inp, lo, hi);
+    return Vec512<T>(
+        half_t::requantize_from_int(lo, multiplier, zero_point),
+        half_t::requantize_from_int(hi, multiplier, zero_point));
+  }
+
+  void dump() const {
+    lo_.dump();
+    hi_.dump();
+  }
+};
+
+template <>
+struct Vec512<c10::qint32> : public Vec512qi<c10::qint32> {
+  using Vec512qi::Vec512qi;
+  Vec512() {}
+};
+
+template <>
+struct Vec512<c10::qint8> : public Vec512qi<c10::qint8> {
+  using Vec512qi::Vec512qi;
+  Vec512() {}
+};
+
+template <>
+struct Vec512<c10::quint8> : public Vec512qi<c10::quint8> {
+  using Vec512qi::Vec512qi;
+  Vec512() {}
+};
+
+template <>
+Vec512<c10::qint32> inline operator*(
+    const Vec512<c10::qint32>& a,
+    const Vec512<c10::qint32>& b) {
+  return Vec512<c10::qint32>(
+      a.get_low() * b.get_low(), a.get_high() * b.get_high());
+}
+
+template <>
+Vec512<c10::qint32> inline operator+(
+    const Vec512<c10::qint32>& a,
+    const Vec512<c10::qint32>& b) {
+  return Vec512<c10::qint32>(
+      a.get_low() + b.get_low(), a.get_high() + b.get_high());
+}
+
+}}}
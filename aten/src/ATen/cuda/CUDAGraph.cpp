@@ -0,0 +1,94 @@
+#include <ATen/cuda/CUDAGraph.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <c10/cuda/CUDAGuard.h>
+
+namespace at { namespace cuda {
+
+CUDAGraph::CUDAGraph() {
+#if defined(__HIP_PLATFORM_HCC__) || CUDA_VERSION < 11000
+  TORCH_CHECK(false, "CUDA graphs require CUDA 11");
+#endif
+}
+
+void CUDAGraph::capture_begin() {
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+  TORCH_CHECK(!has_graph_exec_ && !capture_stream_,
+              "This CUDAGraph instance already owns a captured graph, call reset() "
+              "before capturing another one");
+  auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(stream != getDefaultCUDAStream(),
+              "CUDA graphs must be captured on a stream other than the default stream");
+
+  capture_device_ = c10::cuda::current_device();
+  mempool_id_ = c10::cuda::CUDACachingAllocator::createPoolId();
+  c10::cuda::CUDACachingAllocator::beginAllocateStreamToPool(
+      capture_device_, stream.stream(), mempool_id_);
+  // The relaxed mode lets the caching allocator call cudaMalloc and query
+  // its events while the stream is captured.
+  auto err = cudaStreamBeginCapture(stream.stream(), cudaStreamCaptureModeRelaxed);
+  if (err != cudaSuccess) {
+    c10::cuda::CUDACachingAllocator::endAllocateStreamToPool(capture_device_, stream.stream());
+    c10::cuda::CUDACachingAllocator::releasePool(capture_device_, mempool_id_);
+    AT_CUDA_CHECK(err);
+  }
+  capture_stream_ = stream;
+#endif
+}
+
+void CUDAGraph::capture_end() {
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+  TORCH_CHECK(capture_stream_, "capture_end() called without capture_begin()");
+  auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(stream == *capture_stream_,
+              "capture_end() must be called on the stream of capture_begin()");
+
+  auto err = cudaStreamEndCapture(stream.stream(), &graph_);
+  c10::cuda::CUDACachingAllocator::endAllocateStreamToPool(capture_device_, stream.stream());
+  capture_stream_ = c10::nullopt;
+  AT_CUDA_CHECK(err);
+  TORCH_CHECK(graph_ != nullptr, "Invalid capture");
+  has_graph_ = true;
+
+  AT_CUDA_CHECK(cudaGraphInstantiate(&graph_exec_, graph_, nullptr, nullptr, 0));
+  has_graph_exec_ = true;
+  // the executable graph is all replay() needs
+  AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+  has_graph_ = false;
+#endif
+}
+
+void CUDAGraph::replay() {
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+  TORCH_CHECK(has_graph_exec_, "Called CUDAGraph::replay without a preceding successful capture");
+  c10::cuda::CUDAGuard device_guard{static_cast<DeviceIndex>(capture_device_)};
+  AT_CUDA_CHECK(cudaGraphLaunch(graph_exec_, getCurrentCUDAStream()));
+#endif
+}
+
+void CUDAGraph::reset() {
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+  // Called by the destructor too, so errors are only warned about.
+  if (has_graph_) {
+    C10_CUDA_CHECK_WARN(cudaGraphDestroy(graph_));
+    has_graph_ = false;
+  }
+  if (has_graph_exec_) {
+    C10_CUDA_CHECK_WARN(cudaGraphExecDestroy(graph_exec_));
+    has_graph_exec_ = false;
+  }
+  if (mempool_id_ != 0 && !capture_stream_) {
+    // the pool is freed once the tensors allocated during the capture are
+    c10::cuda::CUDACachingAllocator::releasePool(capture_device_, mempool_id_);
+    mempool_id_ = 0;
+  }
+#endif
+}
+
+CUDAGraph::~CUDAGraph() {
+  reset();
+}
+
+}} // namespace at::cuda
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+
+namespace at { namespace cuda {
+
+/*
+* A CUDAGraph records the kernels launched on the current stream between
+* capture_begin() and capture_end(), and replay() launches all of them again
+* with a single cudaGraphLaunch, which saves the launch overhead of workloads
+* made of many small kernels.
+*
+* The kernels read and write the same addresses on every replay: the memory
+* allocated during the capture comes from a private pool of the caching
+* allocator that is kept until reset() or destruction, and inputs must be
+* copied into, and outputs read from, the tensors used during the capture.
+*
+* The capture must run on a stream other than the default stream, after a
+* warmup run that did the lazy initializations (cuBLAS and cuDNN handles,
+* workspaces, autotuning). Random number generation is captured with the
+* seed and offset of the capture, so it replays the same numbers.
+* Requires CUDA 11.
+*/
+struct TORCH_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  void capture_begin();
+  void capture_end();
+  void replay();
+  void reset();
+
+ private:
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 11000
+  cudaGraph_t graph_ = nullptr;
+  cudaGraphExec_t graph_exec_ = nullptr;
+#endif
+  bool has_graph_ = false;
+  bool has_graph_exec_ = false;
+  // the private pool of the allocations made during the capture
+  c10::cuda::CUDACachingAllocator::MempoolId_t mempool_id_ = 0;
+  int capture_device_ = -1;
+  c10::optional<c10::cuda::CUDAStream> capture_stream_;
+};
+
+}} // namespace at::cuda
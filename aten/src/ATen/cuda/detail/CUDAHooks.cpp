@@ -337,6 +337,14 @@ void CUDAHooks::cuFFTClearPlanCache(int64_t device_index) const {
 #endif
 }
 
+int64_t CUDAHooks::cuFFTGetPlanCachePaddedSize(int64_t device_index, int64_t signal_size, double max_padding) const {
+#ifndef __HIP_PLATFORM_HCC__
+  return at::native::detail::cufft_get_plan_cache_padded_size_impl(device_index, signal_size, max_padding);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
 int CUDAHooks::getNumGPUs() const {
   return at::cuda::device_count();
 }
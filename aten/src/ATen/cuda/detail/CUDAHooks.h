@@ -35,6 +35,7 @@ struct CUDAHooks : public at::CUDAHooksInterface {
   void cuFFTSetPlanCacheMaxSize(int64_t device_index, int64_t max_size) const override;
   int64_t cuFFTGetPlanCacheSize(int64_t device_index) const override;
   void cuFFTClearPlanCache(int64_t device_index) const override;
+  int64_t cuFFTGetPlanCachePaddedSize(int64_t device_index, int64_t signal_size, double max_padding) const override;
   int getNumGPUs() const override;
 };
 
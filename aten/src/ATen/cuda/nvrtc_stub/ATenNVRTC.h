@@ -51,7 +51,8 @@ namespace at { namespace cuda {
   _(cuDevicePrimaryCtxGetState)                  \
   _(cuLinkCreate)                                \
   _(cuLinkAddData)                               \
-  _(cuLinkComplete)
+  _(cuLinkComplete)                              \
+  _(cuLinkDestroy)
 
 #else
 
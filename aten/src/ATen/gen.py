@@ -182,7 +182,8 @@ def backend_to_devicetype(backend):
     return backend
 
 backends = ['CPU', 'CUDA']
-densities = ['Dense', 'Sparse', 'Mkldnn']  # TODO: layout instead of densities?
+densities = ['Dense', 'Sparse', 'SparseCsr', 'Mkldnn']  # TODO: layout instead of densities?
+sparse_densities = ['Sparse', 'SparseCsr']
 
 quantized_backends = ['QuantizedCPU', 'QuantizedCUDA']
 
@@ -295,7 +296,7 @@ def generate_storage_type_and_tensor(backend, density, declarations, per_op_regi
     if not is_whitelisted_backend(env['Backend']):
         return
     env['storage_tensor_headers'] = []
-    if density != 'Sparse':
+    if density not in sparse_densities:
         env['storage_tensor_headers'] = ['#include <c10/core/TensorImpl.h>']
 
     # used for generating switch logic for external functions
@@ -365,7 +366,7 @@ def generate_storage_type_and_tensor(backend, density, declarations, per_op_regi
         fm.write('LegacyTHFunctions' + env['Backend'] + ".h", LEGACY_TH_FUNCTIONS_H, env)
         fm.write('LegacyTHFunctions' + env['Backend'] + ".cpp", LEGACY_TH_FUNCTIONS_CPP, env)
 
-    if density != 'Sparse':
+    if density not in sparse_densities:
         fm.write(env['Type'] + ".cpp", TYPE_DERIVED_CPP, env)
     else:
         fm.write(env['Type'] + ".cpp", SPARSE_TYPE_DERIVED_CPP, env)
@@ -418,7 +419,7 @@ def declare_outputs():
         if is_cuda_backend(backend):
             fm = cuda_file_manager
         for kind in ["Type"]:
-            if kind != 'Type' and density == "Sparse":
+            if kind != 'Type' and density in sparse_densities:
                 # No Storage or Tensor for sparse
                 continue
             fm.will_write("{}{}.h".format(full_backend, kind))
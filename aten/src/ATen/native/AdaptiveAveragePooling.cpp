@@ -1,21 +1,16 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <ATen/native/AdaptivePooling.h>
 #include <tuple>
 
 
 namespace at {
 namespace native {
 
-namespace {
-
-  inline int start_index(int a, int b, int c) {
-    return (int)std::floor((float)(a * c) / b);
-  }
+DEFINE_DISPATCH(adaptive_avg_pool2d_channels_last_kernel);
 
-  inline int end_index(int a, int b, int c) {
-    return (int)std::ceil((float)((a + 1) * c) / b);
-  }
+namespace {
 
   template <typename scalar_t>
   static void adaptive_avg_pool2d_single_out_frame(
@@ -128,6 +123,17 @@ namespace {
     auto osizeH = output_size[0];
     auto osizeW = output_size[1];
 
+    /* channels last input is pooled with the channels innermost, into a
+       channels last output, instead of across its strides */
+    if (input.ndimension() == 4
+        && input.suggest_memory_format() == at::MemoryFormat::ChannelsLast
+        && (input.scalar_type() == kFloat || input.scalar_type() == kDouble))
+    {
+      output.resize_({input.size(0), sizeD, osizeH, osizeW}, at::MemoryFormat::ChannelsLast);
+      adaptive_avg_pool2d_channels_last_kernel(kCPU, output, input, output_size);
+      return;
+    }
+
     /* resize output */
     if (input.ndimension() == 3 || input.size(-4) == 1)
     {
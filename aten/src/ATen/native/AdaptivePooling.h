@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+#include <c10/util/ArrayRef.h>
+
+#include <cmath>
+
+namespace at {
+
+namespace native {
+
+// Channels last input and output, see adaptive_avg_pool2d_out_cpu_template.
+using adaptive_avg_pooling_fn = void(*)(Tensor& output, const Tensor& input, IntArrayRef output_size);
+DECLARE_DISPATCH(adaptive_avg_pooling_fn, adaptive_avg_pool2d_channels_last_kernel);
+
+// First and one past the last input index of the window of output index a,
+// for an output of size b and an input of size c.
+static inline int64_t start_index(int64_t a, int64_t b, int64_t c) {
+  return (int64_t)std::floor((float)(a * c) / b);
+}
+
+static inline int64_t end_index(int64_t a, int64_t b, int64_t c) {
+  return (int64_t)std::ceil((float)((a + 1) * c) / b);
+}
+
+} // namespace native
+
+} // namespace at
@@ -10,6 +10,8 @@
 
 #include <TH/TH.h>  // for USE_LAPACK
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 // First the required LAPACK implementations are registered here.
@@ -302,6 +304,246 @@ template<> void lapackLuSolve<float>(char trans, int n, int nrhs, float *a, int
 }
 #endif
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ batches of small matrices ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// For matrices up to kSmallMatrixMaxDim the factorizations are unrolled over
+// a register-resident copy of the matrix: the cost of a LAPACK call would
+// dominate. They follow the unblocked LAPACK algorithms (getf2, potf2), so the
+// factors and the infos are the ones LAPACK returns. The matrices are column
+// major, as cloneBatchedColumnMajor makes them.
+constexpr int64_t kSmallMatrixMaxDim = 4;
+
+// Up to kParallelBatchMaxDim the matrices of a batch are spread over the
+// threads; larger ones are factorized one at a time and let LAPACK use the
+// threads instead.
+constexpr int64_t kParallelBatchMaxDim = 32;
+
+template <typename loop_t>
+static void batch_loop(int64_t batch_size, int64_t n, const loop_t& loop) {
+  if (n <= kParallelBatchMaxDim) {
+    const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, n * n * n));
+    at::parallel_for(0, batch_size, grain_size, loop);
+  } else {
+    loop(0, batch_size);
+  }
+}
+
+template <typename scalar_t, int N>
+struct SmallMatrix {
+  scalar_t a[N][N];  // a[row][column]
+
+  void load(const scalar_t* ptr) {
+    for (int c = 0; c < N; c++) {
+      for (int r = 0; r < N; r++) {
+        a[r][c] = ptr[r + c * N];
+      }
+    }
+  }
+
+  void store(scalar_t* ptr) const {
+    for (int c = 0; c < N; c++) {
+      for (int r = 0; r < N; r++) {
+        ptr[r + c * N] = a[r][c];
+      }
+    }
+  }
+
+  // LU factorization with partial pivoting in place, as getf2 computes it.
+  // Returns the LAPACK info.
+  int lu(int (&piv)[N]) {
+    int info = 0;
+    for (int j = 0; j < N; j++) {
+      int p = j;
+      scalar_t max_abs = std::abs(a[j][j]);
+      for (int i = j + 1; i < N; i++) {
+        if (std::abs(a[i][j]) > max_abs) {
+          max_abs = std::abs(a[i][j]);
+          p = i;
+        }
+      }
+      piv[j] = p;
+      if (a[p][j] != scalar_t(0)) {
+        if (p != j) {
+          for (int c = 0; c < N; c++) {
+            std::swap(a[j][c], a[p][c]);
+          }
+        }
+        const scalar_t inv_pivot = scalar_t(1) / a[j][j];
+        for (int i = j + 1; i < N; i++) {
+          a[i][j] *= inv_pivot;
+        }
+      } else if (info == 0) {
+        info = j + 1;
+      }
+      for (int i = j + 1; i < N; i++) {
+        for (int c = j + 1; c < N; c++) {
+          a[i][c] -= a[i][j] * a[j][c];
+        }
+      }
+    }
+    return info;
+  }
+
+  // Solves with the factors of lu() for the column x.
+  void lu_solve(const int (&piv)[N], scalar_t (&x)[N]) const {
+    for (int j = 0; j < N; j++) {
+      std::swap(x[j], x[piv[j]]);
+    }
+    for (int j = 0; j < N; j++) {
+      for (int i = j + 1; i < N; i++) {
+        x[i] -= a[i][j] * x[j];
+      }
+    }
+    for (int j = N - 1; j >= 0; j--) {
+      x[j] /= a[j][j];
+      for (int i = 0; i < j; i++) {
+        x[i] -= a[i][j] * x[j];
+      }
+    }
+  }
+
+  // Cholesky factorization in place, as potf2 computes it: only the `upper`
+  // or the lower triangle is read and written. Returns the LAPACK info.
+  int cholesky(bool upper) {
+    for (int j = 0; j < N; j++) {
+      scalar_t ajj = a[j][j];
+      for (int k = 0; k < j; k++) {
+        const scalar_t l = upper ? a[k][j] : a[j][k];
+        ajj -= l * l;
+      }
+      if (!(ajj > scalar_t(0))) {
+        a[j][j] = ajj;
+        return j + 1;
+      }
+      ajj = std::sqrt(ajj);
+      a[j][j] = ajj;
+      for (int i = j + 1; i < N; i++) {
+        scalar_t& aij = upper ? a[j][i] : a[i][j];
+        for (int k = 0; k < j; k++) {
+          aij -= upper ? a[k][j] * a[k][i] : a[j][k] * a[i][k];
+        }
+        aij /= ajj;
+      }
+    }
+    return 0;
+  }
+};
+
+// The small kernels return false when they don't handle the size or the
+// dtype, which leaves the batch to LAPACK. Complex matrices always go to
+// LAPACK.
+
+template <typename scalar_t, int N>
+static void small_solve_batch(scalar_t* A_data, scalar_t* b_data, int64_t A_mat_stride, int64_t b_mat_stride,
+                              int64_t batch_size, int64_t nrhs, std::vector<int64_t>& infos) {
+  batch_loop(batch_size, N, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      SmallMatrix<scalar_t, N> A;
+      A.load(&A_data[i * A_mat_stride]);
+      int piv[N];
+      infos[i] = A.lu(piv);
+      A.store(&A_data[i * A_mat_stride]);
+      if (infos[i] != 0) {
+        return;
+      }
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      for (int64_t c = 0; c < nrhs; c++) {
+        scalar_t x[N];
+        std::copy(b_working_ptr + c * N, b_working_ptr + (c + 1) * N, x);
+        A.lu_solve(piv, x);
+        std::copy(x, x + N, b_working_ptr + c * N);
+      }
+    }
+  });
+}
+
+template <typename scalar_t, int N>
+static void small_inverse_batch(scalar_t* self_data, int64_t self_matrix_stride, int64_t batch_size,
+                                std::vector<int64_t>& infos) {
+  batch_loop(batch_size, N, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      SmallMatrix<scalar_t, N> A;
+      A.load(&self_data[i * self_matrix_stride]);
+      int piv[N];
+      infos[i] = A.lu(piv);
+      if (infos[i] != 0) {
+        return;
+      }
+      SmallMatrix<scalar_t, N> inverse;
+      for (int c = 0; c < N; c++) {
+        scalar_t x[N] = {};
+        x[c] = scalar_t(1);
+        A.lu_solve(piv, x);
+        for (int r = 0; r < N; r++) {
+          inverse.a[r][c] = x[r];
+        }
+      }
+      inverse.store(&self_data[i * self_matrix_stride]);
+    }
+  });
+}
+
+template <typename scalar_t, int N>
+static void small_cholesky_batch(scalar_t* self_data, int64_t self_matrix_stride, int64_t batch_size,
+                                 bool upper, std::vector<int64_t>& infos) {
+  batch_loop(batch_size, N, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      SmallMatrix<scalar_t, N> A;
+      A.load(&self_data[i * self_matrix_stride]);
+      infos[i] = A.cholesky(upper);
+      A.store(&self_data[i * self_matrix_stride]);
+      if (infos[i] != 0) {
+        return;
+      }
+    }
+  });
+}
+
+#define SMALL_MATRIX_SWITCH(n, FN, ...)                        \
+  switch (n) {                                                 \
+    case 1: FN<scalar_t, 1>(__VA_ARGS__); return true;          \
+    case 2: FN<scalar_t, 2>(__VA_ARGS__); return true;          \
+    case 3: FN<scalar_t, 3>(__VA_ARGS__); return true;          \
+    case 4: FN<scalar_t, 4>(__VA_ARGS__); return true;          \
+    default: return false;                                     \
+  }
+
+template <typename scalar_t, typename std::enable_if<!c10::is_complex_t<scalar_t>::value, int>::type = 0>
+static bool small_solve(scalar_t* A_data, scalar_t* b_data, int64_t A_mat_stride, int64_t b_mat_stride,
+                        int64_t batch_size, int64_t n, int64_t nrhs, std::vector<int64_t>& infos) {
+  static_assert(kSmallMatrixMaxDim == 4, "SMALL_MATRIX_SWITCH handles sizes up to 4");
+  SMALL_MATRIX_SWITCH(n, small_solve_batch, A_data, b_data, A_mat_stride, b_mat_stride, batch_size, nrhs, infos)
+}
+
+template <typename scalar_t, typename std::enable_if<c10::is_complex_t<scalar_t>::value, int>::type = 0>
+static bool small_solve(scalar_t*, scalar_t*, int64_t, int64_t, int64_t, int64_t, int64_t, std::vector<int64_t>&) {
+  return false;
+}
+
+template <typename scalar_t, typename std::enable_if<!c10::is_complex_t<scalar_t>::value, int>::type = 0>
+static bool small_inverse(scalar_t* self_data, int64_t self_matrix_stride, int64_t batch_size, int64_t n,
+                          std::vector<int64_t>& infos) {
+  SMALL_MATRIX_SWITCH(n, small_inverse_batch, self_data, self_matrix_stride, batch_size, infos)
+}
+
+template <typename scalar_t, typename std::enable_if<c10::is_complex_t<scalar_t>::value, int>::type = 0>
+static bool small_inverse(scalar_t*, int64_t, int64_t, int64_t, std::vector<int64_t>&) {
+  return false;
+}
+
+template <typename scalar_t, typename std::enable_if<!c10::is_complex_t<scalar_t>::value, int>::type = 0>
+static bool small_cholesky(scalar_t* self_data, int64_t self_matrix_stride, int64_t batch_size, int64_t n,
+                           bool upper, std::vector<int64_t>& infos) {
+  SMALL_MATRIX_SWITCH(n, small_cholesky_batch, self_data, self_matrix_stride, batch_size, upper, infos)
+}
+
+template <typename scalar_t, typename std::enable_if<c10::is_complex_t<scalar_t>::value, int>::type = 0>
+static bool small_cholesky(scalar_t*, int64_t, int64_t, int64_t, bool, std::vector<int64_t>&) {
+  return false;
+}
+
+#undef SMALL_MATRIX_SWITCH
+
 // Below of the definitions of the functions operating on a batch that are going to be dispatched
 // in the main helper functions for the linear algebra operations
 
@@ -320,19 +562,25 @@ static void apply_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  auto ipiv = at::empty({n}, b.options().dtype(kInt));
-  auto ipiv_data = ipiv.data_ptr<int>();
+  if (small_solve<scalar_t>(A_data, b_data, A_mat_stride, b_mat_stride, batch_size, n, nrhs, infos)) {
+    return;
+  }
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-    scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-    lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv_data, b_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  batch_loop(batch_size, n, [&](int64_t begin, int64_t end) {
+    auto ipiv = at::empty({n}, b.options().dtype(kInt));
+    auto ipiv_data = ipiv.data_ptr<int>();
+
+    int info;
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv_data, b_working_ptr, n, &info);
+      infos[i] = info;
+      if (info != 0) {
+        return;
+      }
     }
-  }
+  });
 #endif
 }
 
@@ -383,8 +631,9 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  auto ipiv = at::empty({n}, self.options().dtype(kInt));
-  auto ipiv_data = ipiv.data_ptr<int>();
+  if (small_inverse<scalar_t>(self_data, self_matrix_stride, batch_size, n, infos)) {
+    return;
+  }
 
   int info;
   // Run once, first to get the optimum work size
@@ -393,26 +642,33 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
   // and (batch_size - 1) calls to allocate and deallocate workspace using at::empty()
   int lwork = -1;
   scalar_t wkopt;
-  lapackGetri<scalar_t>(n, self_data, n, ipiv_data, &wkopt, lwork, &info);
+  int ipiv_query;
+  lapackGetri<scalar_t>(n, self_data, n, &ipiv_query, &wkopt, lwork, &info);
   lwork = static_cast<int>(real_impl<scalar_t, value_t>(wkopt));
-  Tensor work = at::empty({lwork}, self.options());
-  auto work_data = work.data_ptr<scalar_t>();
 
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv_data, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  batch_loop(batch_size, n, [&](int64_t begin, int64_t end) {
+    auto ipiv = at::empty({n}, self.options().dtype(kInt));
+    auto ipiv_data = ipiv.data_ptr<int>();
+    Tensor work = at::empty({lwork}, self.options());
+    auto work_data = work.data_ptr<scalar_t>();
+
+    int info;
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv_data, &info);
+      infos[i] = info;
+      if (info != 0) {
+        return;
+      }
 
-    // now compute the actual inverse
-    lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv_data, work_data, lwork, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+      // now compute the actual inverse
+      lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv_data, work_data, lwork, &info);
+      infos[i] = info;
+      if (info != 0) {
+        return;
+      }
     }
-  }
+  });
 #endif
 }
 
@@ -523,15 +779,21 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  if (small_cholesky<scalar_t>(self_data, self_matrix_stride, batch_size, n, upper, infos)) {
+    return;
   }
+
+  batch_loop(batch_size, n, [&](int64_t begin, int64_t end) {
+    int info;
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
+      infos[i] = info;
+      if (info != 0) {
+        return;
+      }
+    }
+  });
 #endif
 }
 
@@ -16,6 +16,7 @@ DEFINE_DISPATCH(add_stub);
 DEFINE_DISPATCH(add_clamp_stub);
 DEFINE_DISPATCH(sub_stub);
 DEFINE_DISPATCH(mul_stub);
+DEFINE_DISPATCH(mul_conj_stub);
 DEFINE_DISPATCH(div_stub);
 DEFINE_DISPATCH(remainder_stub);
 DEFINE_DISPATCH(atan2_stub);
@@ -254,6 +255,19 @@ Tensor& mul_(Tensor& self, const Tensor& other) {
   return native::mul_out(self, self, other);
 }
 
+Tensor _mul_conj(const Tensor& self, const Tensor& other) {
+  // Only the CPU has a fused kernel, and only complex numbers have a
+  // conjugate that isn't a no-op
+  if (self.device().is_cpu() && other.device().is_cpu() &&
+      (self.is_complex() || other.is_complex())) {
+    Tensor result;
+    auto iter = TensorIterator::binary_op(result, self, other);
+    mul_conj_stub(iter.device_type(), iter);
+    return iter.output();
+  }
+  return at::mul(self, other.conj());
+}
+
 Tensor& sub_out(Tensor& result, const Tensor& self, const Tensor& other, Scalar alpha) {
   sub_check(self, other);
   auto iter = TensorIterator::binary_op(result, self, other,
@@ -853,7 +867,7 @@ Tensor binary_op_meta(const Tensor& self, const Tensor& other) {
     int64_t j = -1 - i;
     if (i >= self.dim() || self.size(j) == 1) {
       sizes[dim + j] = other.size(j);
-    } else if (i >= other.dim() || self.size(i) == 1) {
+    } else if (i >= other.dim() || other.size(j) == 1) {
       sizes[dim + j] = self.size(j);
     } else {
       TORCH_CHECK(
@@ -872,6 +886,9 @@ Tensor binary_op_with_scalar_meta(const Tensor& self, const Tensor& other, Scala
 
 TORCH_LIBRARY_IMPL(aten, Meta, m) {
   m.impl("add.Tensor", binary_op_with_scalar_meta);
+  m.impl("sub.Tensor", binary_op_with_scalar_meta);
+  m.impl("mul.Tensor", binary_op_meta);
+  m.impl("div.Tensor", binary_op_meta);
 }
 
 
@@ -1,5 +1,7 @@
 #include <limits>
 #include <algorithm>
+#include <type_traits>
+#include <vector>
 #include <ATen/ATen.h>
 #include <ATen/Config.h>
 
@@ -36,6 +38,26 @@ namespace at { namespace native {
 
 namespace blas_impl {
 
+// The type the naive kernels multiply and sum in: Half and BFloat16 products
+// are summed in float, like the BLAS libraries that support them do.
+template <typename scalar_t>
+struct OpMathType {
+  using type = scalar_t;
+};
+
+template <>
+struct OpMathType<at::Half> {
+  using type = float;
+};
+
+template <>
+struct OpMathType<at::BFloat16> {
+  using type = float;
+};
+
+template <typename scalar_t>
+using opmath_t = typename OpMathType<scalar_t>::type;
+
 template <typename scalar_t>
 bool scal_use_fast_path(int64_t n, int64_t incx) {
   return false;
@@ -154,18 +176,37 @@ bool gemv(char trans, int64_t m, int64_t n, scalar_t alpha, scalar_t *a, int64_t
     return true;
   }
 
+  using opmath_t = blas_impl::opmath_t<scalar_t>;
   if ((trans == 'T') || (trans == 't')) {
     for (int64_t i = 0; i < n; i++)
     {
-      scalar_t sum = 0;
+      opmath_t sum = 0;
       scalar_t *row_ = a + lda * i;
       for (int64_t j = 0; j < m; j++) {
-        sum += x[j * incx] * row_[j];
+        sum += static_cast<opmath_t>(x[j * incx]) * static_cast<opmath_t>(row_[j]);
       }
       if (beta == scalar_t(0)) {
-        y[i * incy] = alpha * sum;
+        y[i * incy] = static_cast<opmath_t>(alpha) * sum;
+      } else {
+        y[i * incy] = static_cast<opmath_t>(beta) * static_cast<opmath_t>(y[i * incy]) +
+            static_cast<opmath_t>(alpha) * sum;
+      }
+    }
+  } else if (!std::is_same<opmath_t, scalar_t>::value) {
+    // Accumulate y in opmath_t, rounding it to scalar_t once at the end
+    std::vector<opmath_t> sum(m, opmath_t(0));
+    for (int64_t j = 0; j < n; j++) {
+      scalar_t *column_ = a + lda * j;
+      opmath_t z = static_cast<opmath_t>(alpha) * static_cast<opmath_t>(x[j * incx]);
+      for (int64_t i = 0; i < m; i++) {
+        sum[i] += z * static_cast<opmath_t>(column_[i]);
+      }
+    }
+    for (int64_t i = 0; i < m; i++) {
+      if (beta == scalar_t(0)) {
+        y[i * incy] = sum[i];
       } else {
-        y[i * incy] = beta * y[i * incy] + alpha * sum;
+        y[i * incy] = static_cast<opmath_t>(beta) * static_cast<opmath_t>(y[i * incy]) + sum[i];
       }
     }
   } else {
@@ -206,12 +247,13 @@ scalar_t dot_naive(
     int64_t incx,
     scalar_t* y,
     int64_t incy) {
+  using acc_t = opmath_t<scalar_t>;
   int64_t i;
-  scalar_t sum = 0;
+  acc_t sum = 0;
   for (i = 0; i < n; i++) {
-    sum += x[i * incx] * y[i * incy];
+    sum += static_cast<acc_t>(x[i * incx]) * static_cast<acc_t>(y[i * incy]);
   }
-  return sum;
+  return static_cast<scalar_t>(sum);
 }
 
 } // namespace blas_impl
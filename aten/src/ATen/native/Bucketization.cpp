@@ -43,6 +43,29 @@ const input_t* cus_lower_bound(const input_t* start, const input_t* end, input_t
   return start;
 }
 
+// boundaries up to this size are searched by branchless_bound, they fit in L1
+// where the mispredicted branches of the binary search dominate
+constexpr int64_t SEARCHSORTED_BRANCHLESS_MAX_SIZE = 1024;
+
+// Binary search without a data dependent branch: the comparison selects the
+// next base with a conditional move and the trip count only depends on len, so
+// the searches of consecutive values can overlap. Gives the same position as
+// cus_lower_bound (right == false) or std::upper_bound (right == true), with
+// the same comparisons, so 'nan' still lands at the end of the boundary.
+template<typename input_t>
+const input_t* branchless_bound(const input_t* base, int64_t len, input_t val, bool right) {
+  if (len == 0) {
+    return base;
+  }
+  while (len > 1) {
+    const int64_t half = len >> 1;
+    const input_t mid_val = base[half];
+    base = (right ? !(val < mid_val) : !(mid_val >= val)) ? base + half : base;
+    len -= half;
+  }
+  return base + (right ? !(val < *base) : !(*base >= val));
+}
+
 template<typename input_t, typename output_t>
 void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tensor& boundaries, const bool& right) {
   int64_t numel_in = input.numel();
@@ -56,6 +79,16 @@ void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tens
   output_t *data_out = result.data_ptr<output_t>();
 
   bool is_1d_boundaries = boundaries.dim() == 1;
+  if (idim_bd <= SEARCHSORTED_BRANCHLESS_MAX_SIZE) {
+    at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; ++i) {
+        int64_t start_bd = is_1d_boundaries ? 0 : i / idim_in * idim_bd;
+        const input_t *data_bd_start = &data_bd[start_bd];
+        data_out[i] = branchless_bound(data_bd_start, idim_bd, data_in[i], right) - data_bd_start;
+      }
+    });
+    return;
+  }
   at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
     for (int64_t i = start; i < end; ++i) {
       // If boundaries tensor is 1d, we always search the entire boundary tensor
@@ -5,6 +5,7 @@
 #include <ATen/native/utils/ParamUtils.h>
 #include <ATen/native/ConvUtils.h>
 #include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/mkldnn/Utils.h>
 
 #include <ATen/Config.h>
 #include <c10/macros/Macros.h>
@@ -22,6 +23,7 @@ constexpr int MIOPEN_DIM_MAX = 5;
 namespace at { namespace native {
 
 DEFINE_DISPATCH(convolution_depthwise3x3_winograd_stub);
+DEFINE_DISPATCH(convolution_depthwise_stub);
 
 struct ConvParams {
   std::vector<int64_t> stride;
@@ -43,6 +45,7 @@ struct ConvParams {
   bool is_stride_nonpos() const;
   void view1d_as_2d();
   bool use_cpu_depthwise3x3_winograd(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_depthwise(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
@@ -163,6 +166,32 @@ auto ConvParams::use_cpu_depthwise3x3_winograd(
 #endif
 }
 
+auto ConvParams::use_cpu_depthwise(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  // The direct kernels only implement the forward pass, so they are skipped
+  // whenever autograd has to record the convolution.
+  const bool requires_grad = at::GradMode::is_enabled() &&
+      (input.requires_grad() || weight.requires_grad() ||
+       (bias.defined() && bias.requires_grad()));
+  return (input.ndimension() == 4) &&
+         (input.device().type() == c10::DeviceType::CPU) &&
+         !input.is_mkldnn() &&
+         (input.scalar_type() == at::kFloat || input.scalar_type() == at::kDouble) &&
+         (groups > 1) &&
+         (input.size(1) == groups) &&
+         (weight.ndimension() == 4) &&
+         (weight.size(0) % input.size(1) == 0) &&
+         (weight.device().type() == c10::DeviceType::CPU) &&
+         (weight.scalar_type() == input.scalar_type()) &&
+         (!bias.defined() ||
+            ((bias.device().type() == c10::DeviceType::CPU) &&
+             (bias.scalar_type() == input.scalar_type()))) &&
+         !transposed &&
+         !requires_grad;
+}
+
 auto ConvParams::needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const -> bool {
   constexpr int64_t int_max = std::numeric_limits<int>::max();
   int64_t numel_input = input.numel();
@@ -234,7 +263,9 @@ auto ConvParams::use_mkldnn(const at::Tensor& input) const -> bool {
   }
   return (input.is_mkldnn()) || // input is mkldnn Tensor
     (input.options().backend() == at::Backend::CPU &&
-     input.scalar_type() == kFloat && // only on CPU Float Tensors
+     (input.scalar_type() == kFloat || // only on CPU Float Tensors
+      (input.scalar_type() == kBFloat16 && // or BFloat16 ones where the CPU
+       mkldnn_bf16_device_check())) && // has oneDNN's bf16 kernels
      !transposed && // or transposed tensors
      input.ndimension() == 4); // must be in NCHW format
 #endif
@@ -775,6 +806,15 @@ at::Tensor _convolution(
         params.stride,
         params.padding,
         params.groups);
+  } else if (params.use_cpu_depthwise(input, weight, bias)) {
+    output = convolution_depthwise_stub(
+        input.device().type(),
+        input,
+        weight,
+        bias,
+        params.stride,
+        params.padding,
+        params.dilation);
   } else if (
         !params.transposed && (input.ndimension() == 5) &&
         (input.device().type() == c10::DeviceType::CPU) &&
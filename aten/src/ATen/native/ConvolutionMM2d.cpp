@@ -135,7 +135,11 @@ static Tensor view_weight_2d(const Tensor& weight_) {
   }
 }
 
-static void slow_conv2d_update_output_frame(
+// Computes the output rows [output_row_begin, output_row_end) of a frame:
+// the columns of finput of these rows are unfolded, and multiplied by the
+// weight while they are still in cache. The whole of finput is filled once
+// all the tiles of the frame are computed, as the backward needs it.
+static void slow_conv2d_update_output_tile(
     Tensor& input,
     Tensor& output,
     const Tensor& weight,
@@ -152,26 +156,10 @@ static void slow_conv2d_update_output_frame(
     int64_t input_width,
     int64_t n_output_plane,
     int64_t output_height,
-    int64_t output_width) {
-  // Note: this is a no_group conv2d
-  if ((input.ndimension() == 4) && (kernel_height == 1) && (stride_height == 1) && (pad_height == 0) &&
-      (kernel_width == 1) && (stride_width == 1) && (pad_width == 0)) {
-    auto output2d =
-        output.reshape({n_output_plane, output_height * output_width});
-    auto weight_new =
-        weight.view({n_output_plane, n_input_plane});
-    auto input_new =
-        input.view({n_input_plane, output_height * output_width});
-
-    if (bias.defined()) {
-      output.copy_(bias.unsqueeze(-1).unsqueeze(-1));
-      output2d.addmm_(weight_new, input_new, 1, 1);
-    } else {
-      at::mm_out(output2d, weight_new, input_new);
-    }
-    return;
-  }
-  unfolded2d_copy_stub(
+    int64_t output_width,
+    int64_t output_row_begin,
+    int64_t output_row_end) {
+  unfolded2d_copy_rows_stub(
       kCPU,
       finput,
       input,
@@ -185,17 +173,46 @@ static void slow_conv2d_update_output_frame(
       input_height,
       input_width,
       output_height,
-      output_width);
-
-  auto output2d =
-      output.reshape({n_output_plane, output_height * output_width});
+      output_width,
+      output_row_begin,
+      output_row_end);
+
+  const int64_t col_begin = output_row_begin * output_width;
+  const int64_t col_end = output_row_end * output_width;
+  auto output2d = output.view({n_output_plane, output_height * output_width})
+                      .slice(1, col_begin, col_end);
+  auto finput2d = finput.slice(1, col_begin, col_end);
   if (bias.defined()) {
-    output.copy_(bias.unsqueeze(-1).unsqueeze(-1));
+    output2d.copy_(bias.unsqueeze(-1));
   } else {
-    output.zero_();
+    output2d.zero_();
   }
 
-  output2d.addmm_(weight, finput, 1, 1);
+  output2d.addmm_(weight, finput2d, 1, 1);
+}
+
+// Number of output rows in the tiles of a frame. The columns of finput of a
+// tile are sized to stay in L2 between the unfolding and the GEMM, without
+// making the GEMM too narrow to be efficient, and frames are split into
+// enough tiles for all threads to have work with small batches.
+static int64_t slow_conv2d_tile_rows(
+    int64_t batch_size,
+    int64_t finput_rows,
+    int64_t output_height,
+    int64_t output_width,
+    int64_t element_size) {
+  constexpr int64_t kTileBytes = 512 * 1024;
+  constexpr int64_t kMinTileColumns = 256;
+
+  const int64_t row_bytes =
+      std::max<int64_t>(1, finput_rows * output_width * element_size);
+  int64_t rows = std::max<int64_t>(1, kTileBytes / row_bytes);
+  rows = std::max(rows, divup(kMinTileColumns, output_width));
+
+  const int64_t min_tiles_per_frame =
+      divup(at::get_num_threads(), std::max<int64_t>(1, batch_size));
+  rows = std::min(rows, divup(output_height, min_tiles_per_frame));
+  return std::max<int64_t>(1, std::min(rows, output_height));
 }
 
 void slow_conv2d_backward_update_grad_input_frame(
@@ -439,14 +456,29 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv2d_forward_out_cpu(
                   output_height * output_width});
   output.resize_({batch_size, n_output_plane, output_height, output_width});
 
-  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+  // Parallel over the tiles of all frames, rather than over frames only, so
+  // that a single large frame is computed by all threads. GEMMs are then
+  // called from the parallel region, and so run single threaded.
+  const int64_t tile_rows = slow_conv2d_tile_rows(
+      batch_size,
+      n_input_plane * kernel_height * kernel_width,
+      output_height,
+      output_width,
+      input.element_size());
+  const int64_t tiles_per_frame = divup(output_height, tile_rows);
+
+  at::parallel_for(0, batch_size * tiles_per_frame, 0, [&](int64_t start, int64_t end) {
     NoGradGuard no_grad;
     AutoNonVariableTypeMode non_variable_type_mode;
-    for (int64_t t = start; t < end; t++) {
+    for (int64_t i = start; i < end; i++) {
+      const int64_t t = i / tiles_per_frame;
+      const int64_t output_row_begin = (i % tiles_per_frame) * tile_rows;
+      const int64_t output_row_end =
+          std::min(output_row_begin + tile_rows, output_height);
       Tensor input_t = input[t];
       Tensor output_t = output[t];
       Tensor finput_t = finput[t];
-      slow_conv2d_update_output_frame(
+      slow_conv2d_update_output_tile(
           input_t,
           output_t,
           weight_2d,
@@ -463,7 +495,9 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv2d_forward_out_cpu(
           input_width,
           n_output_plane,
           output_height,
-          output_width);
+          output_width,
+          output_row_begin,
+          output_row_end);
     }
   });
 
@@ -0,0 +1,176 @@
+#include <ATen/native/CrossEntropyLoss.h>
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/core/Reduction.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(cross_entropy_stub);
+DEFINE_DISPATCH(cross_entropy_backward_stub);
+
+namespace {
+
+void check_cross_entropy_inputs(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    double label_smoothing) {
+  TORCH_CHECK(
+      self.dim() == 2 && self.size(1) > 0,
+      "_fused_cross_entropy: expected a 2D input with at least one class, but got input of size ",
+      self.sizes());
+  TORCH_CHECK(
+      target.dim() == 1 && target.size(0) == self.size(0),
+      "size mismatch (got input: ",
+      self.sizes(),
+      ", target: ",
+      target.sizes(),
+      ")");
+  TORCH_CHECK(
+      target.scalar_type() == kLong,
+      "_fused_cross_entropy: expected a Long target, but got ",
+      target.scalar_type());
+  TORCH_CHECK(
+      !weight.defined() || weight.numel() == self.size(1),
+      "weight tensor should be defined either for all ",
+      self.size(1),
+      " classes or no classes"
+      " but got weight tensor of shape: ",
+      weight.sizes());
+  TORCH_CHECK(
+      target.device() == self.device() &&
+          (!weight.defined() || weight.device() == self.device()),
+      "_fused_cross_entropy: expected target and weight on the device of the input, ",
+      self.device());
+  TORCH_CHECK(
+      !weight.defined() || weight.scalar_type() == self.scalar_type(),
+      "_fused_cross_entropy: expected a weight of the dtype of the input, ",
+      self.scalar_type(),
+      ", but got ",
+      weight.scalar_type());
+  TORCH_CHECK(
+      label_smoothing >= 0 && label_smoothing <= 1,
+      "label_smoothing must be between 0.0 and 1.0, but got ",
+      label_smoothing);
+}
+
+ScalarType cross_entropy_logsumexp_dtype(const Tensor& self) {
+  return self.scalar_type() == kHalf ? kFloat : self.scalar_type();
+}
+
+// The divisor of the mean reduction, see Note [Fused cross entropy]. As in
+// nll_loss, a zero total weight gives a zero loss unless the batch is empty.
+Tensor cross_entropy_total_weight(
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    ScalarType dtype) {
+  const auto valid = target.ne(ignore_index);
+  auto total_weight = weight.defined()
+      ? weight.index_select(0, target.masked_select(valid)).sum().to(dtype)
+      : valid.sum().to(dtype);
+  if (target.numel() > 0) {
+    total_weight.masked_fill_(total_weight.eq(0), 1);
+  }
+  return total_weight;
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> fused_cross_entropy(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    double label_smoothing) {
+  check_cross_entropy_inputs(self, target, weight, label_smoothing);
+  const auto batch_size = self.size(0);
+  const auto weight_contiguous = weight.defined() ? weight.contiguous() : weight;
+
+  Tensor output = at::empty({batch_size}, self.options());
+  Tensor logsumexp = at::empty(
+      {batch_size}, self.options().dtype(cross_entropy_logsumexp_dtype(self)));
+  if (batch_size > 0) {
+    cross_entropy_stub(
+        self.device().type(),
+        output,
+        logsumexp,
+        self.contiguous(),
+        target.contiguous(),
+        weight_contiguous,
+        ignore_index,
+        label_smoothing);
+  }
+
+  if (reduction == Reduction::Sum) {
+    output = output.sum();
+  } else if (reduction == Reduction::Mean) {
+    output = output.sum() /
+        cross_entropy_total_weight(target, weight_contiguous, ignore_index, self.scalar_type());
+  }
+  return std::make_tuple(output, logsumexp);
+}
+
+Tensor fused_cross_entropy_backward(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    double label_smoothing,
+    const Tensor& logsumexp) {
+  check_cross_entropy_inputs(self, target, weight, label_smoothing);
+  const auto batch_size = self.size(0);
+  TORCH_CHECK(
+      logsumexp.dim() == 1 && logsumexp.size(0) == batch_size &&
+          logsumexp.scalar_type() == cross_entropy_logsumexp_dtype(self),
+      "_fused_cross_entropy_backward: logsumexp doesn't match the input, got ",
+      logsumexp.scalar_type(),
+      " logsumexp of size ",
+      logsumexp.sizes());
+  const auto weight_contiguous = weight.defined() ? weight.contiguous() : weight;
+
+  Tensor grad_scale;
+  if (reduction == Reduction::None) {
+    TORCH_CHECK(
+        grad_output.numel() == batch_size,
+        "_fused_cross_entropy_backward: expected grad_output of ",
+        batch_size,
+        " elements, but got ",
+        grad_output.numel());
+    grad_scale = grad_output.reshape({batch_size});
+  } else {
+    TORCH_CHECK(
+        grad_output.numel() == 1,
+        "_fused_cross_entropy_backward: expected a grad_output of one element, but got ",
+        grad_output.numel());
+    grad_scale = grad_output.reshape({});
+    if (reduction == Reduction::Mean) {
+      grad_scale = grad_scale /
+          cross_entropy_total_weight(target, weight_contiguous, ignore_index, grad_scale.scalar_type());
+    }
+    grad_scale = grad_scale.expand({batch_size});
+  }
+  grad_scale = grad_scale.to(logsumexp.scalar_type()).contiguous();
+
+  auto self_contiguous = self.contiguous();
+  Tensor grad_input = at::empty_like(self_contiguous, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (batch_size > 0) {
+    cross_entropy_backward_stub(
+        self.device().type(),
+        grad_input,
+        grad_scale,
+        self_contiguous,
+        target.contiguous(),
+        weight_contiguous,
+        ignore_index,
+        label_smoothing,
+        logsumexp.contiguous());
+  }
+  return grad_input;
+}
+
+}} // namespace at::native
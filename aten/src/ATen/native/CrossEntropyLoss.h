@@ -0,0 +1,52 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Note [Fused cross entropy]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// _fused_cross_entropy computes the loss of log_softmax followed by nll_loss,
+// with label smoothing eps, directly from the 2-d logits self (N, C), without
+// materializing the log-probabilities. With w the class weights (1 without
+// weight) and t = target[i], the loss of row i is
+//
+//   loss[i] = sum_c a[i][c] * (lse[i] - self[i][c])
+//   a[i][c] = (1 - eps) * w[t] * (c == t) + eps * w[c] / C
+//
+// where lse[i] is the logsumexp of the row, and 0 when t == ignore_index.
+// The mean reduction divides the sum of the losses by the sum of w[t] over
+// the rows that aren't ignored. The gradient of row i is
+//
+//   grad_input[i][c] = grad_scale[i] * (A[i] * softmax(self[i])[c] - a[i][c])
+//
+// with A[i] = sum_c a[i][c], and grad_scale[i] the gradient of loss[i].
+// The kernels only keep lse from the forward.
+
+// Fills output (N) with the unreduced loss and logsumexp (N) with lse, for
+// contiguous self, target and weight (which may be undefined).
+using cross_entropy_fn = void(*)(
+    Tensor& output,
+    Tensor& logsumexp,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing);
+// Fills the contiguous grad_input (N, C) from grad_scale (N), of the dtype of
+// logsumexp.
+using cross_entropy_backward_fn = void(*)(
+    Tensor& grad_input,
+    const Tensor& grad_scale,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing,
+    const Tensor& logsumexp);
+
+DECLARE_DISPATCH(cross_entropy_fn, cross_entropy_stub);
+DECLARE_DISPATCH(cross_entropy_backward_fn, cross_entropy_backward_stub);
+
+}} // at::native
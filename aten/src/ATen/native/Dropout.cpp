@@ -1,6 +1,11 @@
+#include <ATen/native/Dropout.h>
+
 #include <ATen/ATen.h>
+#include <ATen/CPUGeneratorImpl.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NamedTensorUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/Utils.h>
 
 namespace at { namespace native {
 
@@ -25,6 +30,14 @@ bool is_fused_kernel_acceptable(const Tensor& input, double p) {
   return input.is_cuda() && p > 0 && p < 1 && input.numel() > 0;
 }
 
+// The CPU kernel works on contiguous tensors, so that its output keeps the
+// layout of the input.
+bool is_packed_fused_kernel_acceptable(const Tensor& input, double p) {
+  return input.device().is_cpu() && input.layout() == kStrided &&
+      (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+      input.is_contiguous() && p > 0 && p < 1 && input.numel() > 0;
+}
+
 // NB: sure, we could have used different overloads here, but I would feel insecure
 // knowing that this dispatch depends only on the constness of the references
 template<bool inplace>
@@ -82,12 +95,58 @@ ALIAS_SPECIALIZATION(_feature_alpha_dropout, true,  true )
 
 } // anomymous namepsace
 
+DEFINE_DISPATCH(fused_dropout_packed_stub);
+DEFINE_DISPATCH(masked_scale_packed_stub);
+
+// p is the probability to keep an element. The mask for the backward is
+// packed, see Dropout.h, which takes 8 times less memory than the Byte mask
+// of _fused_dropout.
+std::tuple<Tensor, Tensor> fused_dropout_packed_cpu(const Tensor& self, double p, c10::optional<Generator> gen_) {
+  TORCH_CHECK(p > 0 && p <= 1, "_fused_dropout_packed: keep probability has to be in (0, 1], but got ", p);
+  TORCH_CHECK(self.scalar_type() == kFloat || self.scalar_type() == kDouble,
+      "_fused_dropout_packed: expected a float or double tensor, but got ", self.scalar_type());
+  auto self_c = self.contiguous();
+  Tensor output = at::empty_like(self_c, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor mask = at::empty({divup(self.numel(), 8)}, self.options().dtype(kByte));
+  if (self.numel() == 0) {
+    return std::make_tuple(output, mask);
+  }
+
+  auto gen = get_generator_or_default<CPUGeneratorImpl>(gen_, detail::getDefaultCPUGenerator());
+  uint64_t key;
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    key = gen->random64();
+  }
+  fused_dropout_packed_stub(kCPU, output, mask, self_c, p, key);
+  return std::make_tuple(output, mask);
+}
+
+Tensor masked_scale_packed_cpu(const Tensor& self, const Tensor& mask, double scale) {
+  TORCH_CHECK(self.scalar_type() == kFloat || self.scalar_type() == kDouble,
+      "_masked_scale_packed: expected a float or double tensor, but got ", self.scalar_type());
+  TORCH_CHECK(mask.scalar_type() == kByte && mask.dim() == 1 && mask.numel() == divup(self.numel(), 8),
+      "_masked_scale_packed: expected a packed Byte mask of ", divup(self.numel(), 8),
+      " elements, but got a ", mask.scalar_type(), " tensor of size ", mask.sizes());
+  auto self_c = self.contiguous();
+  Tensor output = at::empty_like(self_c, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (self.numel() == 0) {
+    return output;
+  }
+  masked_scale_packed_stub(kCPU, output, self_c, mask.contiguous(), scale);
+  return output;
+}
+
 Tensor dropout(const Tensor& input, double p, bool train) {
   auto result = [&]() {
     NoNamesGuard guard;
     if (train && is_fused_kernel_acceptable(input, p)) {
       return std::get<0>(at::_fused_dropout(input, 1 - p));
     }
+    if (train && is_packed_fused_kernel_acceptable(input, p)) {
+      return std::get<0>(at::_fused_dropout_packed(input, 1 - p));
+    }
     return _dropout<false>(input, p, train);
   }();
   namedinference::propagate_names(result, input);
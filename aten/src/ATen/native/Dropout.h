@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The packed dropout mask of a tensor of n elements is a contiguous Byte
+// tensor of divup(n, 8) elements, bit j of byte i being set when the element
+// 8 * i + j of the contiguous tensor is kept.
+
+// Keeps each element of the contiguous tensor self with probability p,
+// scaled by 1 / p, into the contiguous output, and stores which ones are kept
+// in mask. The random bits are taken from the Philox stream of key, see
+// Note [Parallel CPU random fills].
+using fused_dropout_packed_fn = void(*)(Tensor& output, Tensor& mask, const Tensor& self, double p, uint64_t key);
+// output = self * scale where mask is set, 0 elsewhere, for contiguous output
+// and self.
+using masked_scale_packed_fn = void(*)(Tensor& output, const Tensor& self, const Tensor& mask, double scale);
+
+DECLARE_DISPATCH(fused_dropout_packed_fn, fused_dropout_packed_stub);
+DECLARE_DISPATCH(masked_scale_packed_fn, masked_scale_packed_stub);
+
+}} // at::native
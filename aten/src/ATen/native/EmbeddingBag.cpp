@@ -2,6 +2,8 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/cpu/EmbeddingBagKernel.h>
+#include <ATen/record_function.h>
 
 #include <TH/THBlasUtils.h>
 
@@ -12,9 +14,13 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <tuple>
 #include <vector>
@@ -29,6 +35,8 @@ namespace {
 namespace at {
 namespace native {
 
+DEFINE_DISPATCH(embedding_bag_backward_stub);
+
 template<typename scalar_t>
 scalar_t dot_impl(int64_t n, scalar_t *x, int64_t incx, scalar_t *y, int64_t incy);
 
@@ -49,6 +57,83 @@ bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor&
   return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1 && scale.stride(0) == 1;
 }
 
+#ifdef USE_FBGEMM
+// The prefetch distance of the fbgemm kernel and the number of bags per
+// parallel task of the fast paths below.
+struct EmbeddingBagKernelConfig {
+  int prefetch;
+  int64_t grain_size;
+};
+
+constexpr EmbeddingBagKernelConfig kDefaultEmbeddingBagKernelConfig{16, 1};
+
+// Setting ATEN_EMBEDDING_BAG_AUTOTUNE=1 makes the first call for each table
+// shape time the fast path with every candidate config, and cache the fastest
+// one for the later calls. How far ahead rows need to be prefetched to hide
+// the DRAM latency depends a lot on the table size. The trials show up in the
+// profiler as embedding_bag_autotune(prefetch=..., grain_size=...) ranges.
+bool embedding_bag_autotune_enabled() {
+  static const bool enabled = [] {
+    const char* envar = std::getenv("ATEN_EMBEDDING_BAG_AUTOTUNE");
+    return envar && strcmp(envar, "0") != 0;
+  }();
+  return enabled;
+}
+
+// Calls run(generate(prefetch), grain_size) with the config of the table
+// shape, tuning it first if needed. Every run computes the whole output, so
+// the output of the last trial is as good as any.
+template <typename GenerateKernel, typename RunKernel>
+void run_embedding_bag_kernel(
+    int64_t num_rows,
+    int64_t ddim,
+    bool has_weight,
+    const GenerateKernel& generate,
+    const RunKernel& run) {
+  if (!embedding_bag_autotune_enabled()) {
+    run(generate(kDefaultEmbeddingBagKernelConfig.prefetch),
+        kDefaultEmbeddingBagKernelConfig.grain_size);
+    return;
+  }
+
+  using Key = std::tuple<int64_t, int64_t, bool>;
+  static std::mutex mutex;
+  static std::map<Key, EmbeddingBagKernelConfig> configs;
+  const Key key{num_rows, ddim, has_weight};
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = configs.find(key);
+    if (it != configs.end()) {
+      run(generate(it->second.prefetch), it->second.grain_size);
+      return;
+    }
+  }
+
+  RECORD_FUNCTION("embedding_bag_autotune", std::vector<c10::IValue>());
+  EmbeddingBagKernelConfig best = kDefaultEmbeddingBagKernelConfig;
+  auto best_time = std::chrono::steady_clock::duration::max();
+  for (int prefetch : {0, 8, 16, 32, 64}) {
+    // generating the kernel jits it, which shouldn't count
+    auto kernel = generate(prefetch);
+    for (int64_t grain_size : {1, 16, 64}) {
+      std::ostringstream name;
+      name << "embedding_bag_autotune(prefetch=" << prefetch
+           << ", grain_size=" << grain_size << ")";
+      RECORD_FUNCTION(name.str(), std::vector<c10::IValue>());
+      const auto start = std::chrono::steady_clock::now();
+      run(kernel, grain_size);
+      const auto time = std::chrono::steady_clock::now() - start;
+      if (time < best_time) {
+        best_time = time;
+        best = {prefetch, grain_size};
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  configs.emplace(key, best);
+}
+#endif
+
 // This function combines index_select (using select_indices as the index) and
 // index_add (using add_indices as the index), without creating an intermediary
 // tensor to hold the selected embeddings
@@ -109,29 +194,37 @@ void index_select_add<float>(const Tensor &select_indices,
     }
 
 #ifdef USE_FBGEMM
-    auto kernel_fp32_i64 =
-      fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
-        /* block_size */ddim,
-        /* has_weight */false,
-        /* normalize_by_lengths */false,
-        /* prefetch */16,
-        /* is_weight_positional */false,
-        /* use_offsets */true
-      );
-#endif
+    run_embedding_bag_kernel(
+        src.size(0),
+        ddim,
+        /*has_weight=*/false,
+        [&](int prefetch) {
+          return fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
+            /* block_size */ddim,
+            /* has_weight */false,
+            /* normalize_by_lengths */false,
+            /* prefetch */prefetch,
+            /* is_weight_positional */false,
+            /* use_offsets */true
+          );
+        },
+        [&](const auto& kernel_fp32_i64, int64_t grain_size) {
+          at::parallel_for(
+              0, output_size, grain_size, [&](int64_t start_idx, int64_t end_idx) {
+                kernel_fp32_i64(
+                  /* output_size */end_idx - start_idx,
+                  /* index_size */offsets_data[end_idx] - offsets_data[start_idx],
+                  /* data_size */src.size(0),
+                  /* input */src_data,
+                  /* indices */select_indices_data + offsets_data[start_idx],
+                  /* offsets_or_lengths */offsets_data + start_idx,
+                  /* weights */nullptr,
+                  /* output */output_data + start_idx * ddim);
+              });
+        });
+#else
     at::parallel_for(
         0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
-#ifdef USE_FBGEMM
-          kernel_fp32_i64(
-            /* output_size */end_idx - start_idx,
-            /* index_size */offsets_data[end_idx] - offsets_data[start_idx],
-            /* data_size */src.size(0),
-            /* input */src_data,
-            /* indices */select_indices_data + offsets_data[start_idx],
-            /* offsets_or_lengths */offsets_data + start_idx,
-            /* weights */nullptr,
-            /* output */output_data + start_idx * ddim);
-#else
           caffe2::EmbeddingLookupIdx(
               /*block_size=*/ddim,
               /*output_size=*/end_idx - start_idx,
@@ -144,8 +237,8 @@ void index_select_add<float>(const Tensor &select_indices,
               /*scale_bias=*/nullptr,
               /*normalize_by_lengths=*/false,
               /*out=*/output_data + start_idx * ddim);
-#endif
         });
+#endif
   } else {
     AT_ASSERT(select_indices.numel() == add_indices.numel());
     auto* add_indices_data = add_indices.data_ptr<int64_t>();
@@ -236,29 +329,37 @@ void index_select_scale_add<float>(const Tensor &select_indices,
     }
 
 #ifdef USE_FBGEMM
-    auto kernel_fp32_i64 =
-      fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
-        /* block_size */ddim,
-        /* has_weight */true,
-        /* normalize_by_lengths */false,
-        /* prefetch */16,
-        /* is_weight_positional */false,
-        /* use_offsets */true
-      );
-#endif
+    run_embedding_bag_kernel(
+        src.size(0),
+        ddim,
+        /*has_weight=*/true,
+        [&](int prefetch) {
+          return fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
+            /* block_size */ddim,
+            /* has_weight */true,
+            /* normalize_by_lengths */false,
+            /* prefetch */prefetch,
+            /* is_weight_positional */false,
+            /* use_offsets */true
+          );
+        },
+        [&](const auto& kernel_fp32_i64, int64_t grain_size) {
+          at::parallel_for(
+              0, output_size, grain_size, [&](int64_t start_idx, int64_t end_idx) {
+                kernel_fp32_i64(
+                  /* output_size */end_idx - start_idx,
+                  /* index_size */offsets_data[end_idx] - offsets_data[start_idx],
+                  /* data_size */src.size(0),
+                  /* input */src_data,
+                  /* indices */select_indices_data + offsets_data[start_idx],
+                  /* offsets_or_lengths */offsets_data + start_idx,
+                  /* weights */scale_data + offsets_data[start_idx],
+                  /* output */output_data + start_idx * ddim);
+              });
+        });
+#else
     at::parallel_for(
         0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
-#ifdef USE_FBGEMM
-          kernel_fp32_i64(
-            /* output_size */end_idx - start_idx,
-            /* index_size */offsets_data[end_idx] - offsets_data[start_idx],
-            /* data_size */src.size(0),
-            /* input */src_data,
-            /* indices */select_indices_data + offsets_data[start_idx],
-            /* offsets_or_lengths */offsets_data + start_idx,
-            /* weights */scale_data + offsets_data[start_idx],
-            /* output */output_data + start_idx * ddim);
-#else
           caffe2::EmbeddingLookupIdx(
               /*block_size=*/ddim,
               /*output_size=*/end_idx - start_idx,
@@ -271,8 +372,8 @@ void index_select_scale_add<float>(const Tensor &select_indices,
               /*scale_bias=*/nullptr,
               /*normalize_by_lengths=*/false,
               /*out=*/output_data + start_idx * ddim);
-#endif
         });
+#endif
   } else {
     AT_ASSERT(select_indices.numel() == add_indices.numel());
     auto* add_indices_data = add_indices.data_ptr<int64_t>();
@@ -695,50 +796,43 @@ void _embedding_bag_dense_backward_cpu_sum_mean(
   auto* offsets_data = offsets_.data_ptr<int64_t>();
   auto* offset2bag_data = offset2bag.data_ptr<int64_t>();
   int64_t numel = indices.numel();
+  int64_t num_bags = offsets_.size(0);
 
   auto counts = compute_counts(num_weights, indices_data, numel);
   auto next_unique_index_idx =
       compute_counts_uniq(num_weights, indices_data, numel, counts);
 
-  auto loop = [&](int64_t start, int64_t end) {
-    for (int64_t i = start; i < end; i++) {
-      int64_t start = i == 0 ? 0 : next_unique_index_idx[i - 1];
-      int64_t index = indices_data[start];
-      for (int64_t j = start; j < next_unique_index_idx[i]; j++) {
-        int64_t source = offset2bag_data[j];
-        double scale = 1.0;
-        if (per_sample_weights) {
-          AT_ASSERT(mode == MODE_SUM);
-          scale = per_sample_weights_data[*per_sample_weights_stride * j];
-        }
-        if (scale_grad_by_freq) {
-          scale /= counts[indices_data[i]];
-        }
-        if (mode == 1) { // MODE_MEAN
-          if (offsets_.size(0) == 1) {
-            auto bag_size = indices.size(0);
-            scale /= bag_size;
-          } else {
-            if (source == offsets_.size(0) - 1) {
-              scale /= indices.size(0) - offsets_data[offsets_.size(0) - 1];
-            } else {
-              scale /= offsets_data[source + 1] - offsets_data[source];
-            }
-          }
+  // Compute the weight of every (sorted) entry up front, so that the
+  // accumulation kernel only has to do the fused multiply-adds.
+  auto scales = at::empty({numel}, grad.options());
+  auto* scales_data = scales.data_ptr<scalar_t>();
+  at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t start, int64_t end) {
+    for (int64_t j = start; j < end; j++) {
+      int64_t source = offset2bag_data[j];
+      double scale = 1.0;
+      if (per_sample_weights) {
+        AT_ASSERT(mode == MODE_SUM);
+        scale = per_sample_weights_data[*per_sample_weights_stride * j];
+      }
+      if (scale_grad_by_freq) {
+        scale /= counts[indices_data[j]];
+      }
+      if (mode == MODE_MEAN) {
+        if (num_bags == 1) {
+          scale /= numel;
+        } else if (source == num_bags - 1) {
+          scale /= numel - offsets_data[num_bags - 1];
+        } else {
+          scale /= offsets_data[source + 1] - offsets_data[source];
         }
-        int64_t ddim = grad.size(1);
-        auto igwd = index_grad_weight.data_ptr<scalar_t>();
-        auto gd = grad.data_ptr<scalar_t>();
-        THBlas_axpy<scalar_t>(ddim, (scalar_t)scale, gd + ddim * source, 1,
-                    igwd + ddim * index, 1);
       }
+      scales_data[j] = static_cast<scalar_t>(scale);
     }
-  };
-  if (numel > 1000) {
-    at::parallel_for(0, (int64_t)next_unique_index_idx.size(), 0, loop);
-  } else {
-    loop(0, (int64_t)next_unique_index_idx.size());
-  }
+  });
+
+  embedding_bag_backward_stub(
+      kCPU, index_grad_weight, grad, indices, offset2bag, scales,
+      next_unique_index_idx);
 }
 
 Tensor _embedding_bag_dense_backward_cpu(const Tensor &grad_, const Tensor &indices_,
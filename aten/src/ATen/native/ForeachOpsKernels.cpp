@@ -0,0 +1,131 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+// The slow paths apply the regular ops to each tensor; CUDA lists that can't
+// go through the multi tensor apply kernels fall back to them too.
+
+#define FOREACH_BINARY_OP_SCALAR(NAME)                                                   \
+void foreach_tensor_##NAME##_scalar_kernel_slow_(TensorList tensors, Scalar scalar) {   \
+  check_foreach_api_restrictions(tensors);                                               \
+                                                                                         \
+  for (auto& t: tensors) {                                                               \
+    t.NAME##_(scalar);                                                                   \
+  }                                                                                      \
+}                                                                                        \
+                                                                                         \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_slow(TensorList tensors, Scalar scalar) { \
+  check_foreach_api_restrictions(tensors);                                               \
+                                                                                         \
+  std::vector<Tensor> result;                                                            \
+  result.reserve(tensors.size());                                                        \
+  for (const auto& t: tensors) {                                                         \
+    result.emplace_back(t.NAME(scalar));                                                 \
+  }                                                                                      \
+  return result;                                                                         \
+}
+
+FOREACH_BINARY_OP_SCALAR(add)
+FOREACH_BINARY_OP_SCALAR(mul)
+
+void foreach_tensor_add_list_kernel_slow_(TensorList self, TensorList other, Scalar alpha) {
+  check_foreach_api_restrictions(self, other);
+
+  for (size_t i = 0; i < self.size(); i++) {
+    self[i].add_(other[i], alpha);
+  }
+}
+
+std::vector<Tensor> foreach_tensor_add_list_kernel_slow(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+
+  std::vector<Tensor> result;
+  result.reserve(tensors1.size());
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    result.emplace_back(tensors1[i].add(tensors2[i], alpha));
+  }
+  return result;
+}
+
+void foreach_tensor_mul_list_kernel_slow_(TensorList self, TensorList other) {
+  check_foreach_api_restrictions(self, other);
+
+  for (size_t i = 0; i < self.size(); i++) {
+    self[i].mul_(other[i]);
+  }
+}
+
+std::vector<Tensor> foreach_tensor_mul_list_kernel_slow(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+
+  std::vector<Tensor> result;
+  result.reserve(tensors1.size());
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    result.emplace_back(tensors1[i].mul(tensors2[i]));
+  }
+  return result;
+}
+
+void _fused_adam_slow_(
+    TensorList self,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay,
+    int64_t step) {
+  check_foreach_api_restrictions(self, grads);
+  check_foreach_api_restrictions(self, exp_avgs);
+  check_foreach_api_restrictions(self, exp_avg_sqs);
+  TORCH_CHECK(step > 0, "_fused_adam_ expects a positive step, got ", step);
+
+  const auto bias_correction1 = 1 - std::pow(beta1, step);
+  const auto bias_correction2 = 1 - std::pow(beta2, step);
+  const auto step_size = lr / bias_correction1;
+  for (size_t i = 0; i < self.size(); i++) {
+    auto grad = grads[i];
+    if (weight_decay != 0) {
+      grad = grad.add(self[i], weight_decay);
+    }
+    exp_avgs[i].mul_(beta1).add_(grad, 1 - beta1);
+    exp_avg_sqs[i].mul_(beta2).addcmul_(grad, grad, 1 - beta2);
+    const auto denom = (exp_avg_sqs[i].sqrt() / std::sqrt(bias_correction2)).add_(eps);
+    self[i].addcdiv_(exp_avgs[i], denom, -step_size);
+  }
+}
+
+void _fused_sgd_slow_(
+    TensorList self,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov) {
+  check_foreach_api_restrictions(self, grads);
+  check_foreach_api_restrictions(self, momentum_buffers);
+
+  for (size_t i = 0; i < self.size(); i++) {
+    auto d_p = grads[i];
+    if (weight_decay != 0) {
+      d_p = d_p.add(self[i], weight_decay);
+    }
+    momentum_buffers[i].mul_(momentum).add_(d_p, 1 - dampening);
+    if (nesterov) {
+      d_p = d_p.add(momentum_buffers[i], momentum);
+    } else {
+      d_p = momentum_buffers[i];
+    }
+    self[i].add_(d_p, -lr);
+  }
+}
+
+}} // namespace at::native
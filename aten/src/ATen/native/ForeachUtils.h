@@ -0,0 +1,55 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// Checks shared by the _foreach_ ops and the fused optimizer steps, which
+// apply the same operation to every tensor of one or several lists.
+
+inline void check_foreach_api_restrictions(TensorList tensors) {
+  TORCH_CHECK(tensors.size() > 0, "Tensor list must have at least one tensor.");
+}
+
+inline void check_foreach_api_restrictions(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions(tensors1);
+  TORCH_CHECK(tensors1.size() == tensors2.size(),
+              "Tensor lists must have the same number of tensors, got ",
+              tensors1.size(), " and ", tensors2.size());
+  for (size_t i = 0; i < tensors1.size(); ++i) {
+    TORCH_CHECK(tensors1[i].sizes() == tensors2[i].sizes(),
+                "Corresponding tensors in lists must have the same size, got ",
+                tensors1[i].sizes(), " and ", tensors2[i].sizes());
+  }
+}
+
+// Whether the lists can go through the multi tensor apply kernels, which
+// walk the memory of each tensor linearly: all the tensors must be dense and
+// non-overlapping Half, Float or Double CUDA tensors of the same dtype on the same
+// device, and tensors at the same position in different lists must have the
+// same strides.
+inline bool can_use_fast_route(std::initializer_list<TensorList> tensor_lists) {
+  const auto& first = tensor_lists.begin()->front();
+  const auto dtype = first.scalar_type();
+  if (!first.is_cuda() ||
+      (dtype != kHalf && dtype != kFloat && dtype != kDouble)) {
+    return false;
+  }
+  for (const auto& tensors : tensor_lists) {
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      const auto& t = tensors[i];
+      if (t.device() != first.device() ||
+          t.scalar_type() != dtype ||
+          t.layout() != at::kStrided ||
+          !t.unsafeGetTensorImpl()->is_non_overlapping_and_dense() ||
+          t.strides() != tensor_lists.begin()->at(i).strides()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,264 @@
+#include <ATen/native/FusedAttention.h>
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(fused_attention_stub);
+DEFINE_DISPATCH(fused_attention_backward_stub);
+
+namespace {
+
+// The chunked implementation materializes the scores of at most this many
+// queries of every batch at once
+constexpr int64_t kQueryChunkSize = 256;
+
+void check_attention_inputs(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask) {
+  TORCH_CHECK(query.dim() >= 3,
+              "_fused_attention(): expected query to have at least 3 dimensions, got ",
+              query.dim());
+  TORCH_CHECK(key.dim() == query.dim() && value.dim() == query.dim(),
+              "_fused_attention(): expected query, key and value to have the same number of dimensions");
+  const auto batch_sizes = query.sizes().slice(0, query.dim() - 2);
+  TORCH_CHECK(key.sizes().slice(0, key.dim() - 2) == batch_sizes &&
+              value.sizes().slice(0, value.dim() - 2) == batch_sizes,
+              "_fused_attention(): expected query, key and value to have the same batch sizes, got ",
+              query.sizes(), ", ", key.sizes(), " and ", value.sizes());
+  TORCH_CHECK(key.size(-1) == query.size(-1),
+              "_fused_attention(): expected query and key to have the same embedding size, got ",
+              query.size(-1), " and ", key.size(-1));
+  TORCH_CHECK(value.size(-2) == key.size(-2),
+              "_fused_attention(): expected key and value to have the same sequence length, got ",
+              key.size(-2), " and ", value.size(-2));
+  TORCH_CHECK(query.is_floating_point(),
+              "_fused_attention(): expected a floating point query, got ", query.scalar_type());
+  TORCH_CHECK(key.scalar_type() == query.scalar_type() &&
+              value.scalar_type() == query.scalar_type(),
+              "_fused_attention(): expected query, key and value to have the same dtype");
+  TORCH_CHECK(key.device() == query.device() && value.device() == query.device(),
+              "_fused_attention(): expected query, key and value to be on the same device");
+  if (attn_mask.defined()) {
+    TORCH_CHECK(attn_mask.scalar_type() == kBool ||
+                attn_mask.scalar_type() == query.scalar_type(),
+                "_fused_attention(): expected a bool attn_mask or one with the dtype of query, got ",
+                attn_mask.scalar_type());
+    TORCH_CHECK(attn_mask.device() == query.device(),
+                "_fused_attention(): expected attn_mask to be on the device of query");
+  }
+}
+
+// The additive mask, expanded without a copy to [*, Lq, Lk]. True elements
+// of a bool mask are masked out.
+Tensor expand_attention_mask(
+    const Tensor& attn_mask,
+    const Tensor& query,
+    const Tensor& key) {
+  if (!attn_mask.defined()) {
+    return attn_mask;
+  }
+  Tensor mask = attn_mask;
+  if (mask.scalar_type() == kBool) {
+    mask = at::zeros(mask.sizes(), query.options()).masked_fill_(
+        mask, -std::numeric_limits<double>::infinity());
+  }
+  auto sizes = query.sizes().vec();
+  sizes.back() = key.size(-2);
+  return mask.expand(sizes);
+}
+
+// The offsets of the [Lq, Lk] masks of the flattened batches in an expanded
+// mask, see fused_attention_fn.
+Tensor attention_mask_offsets(const Tensor& mask) {
+  if (!mask.defined()) {
+    return Tensor();
+  }
+  const int64_t batch_dims = mask.dim() - 2;
+  int64_t batch = 1;
+  for (int64_t d = 0; d < batch_dims; ++d) {
+    batch *= mask.size(d);
+  }
+  Tensor offsets = at::empty({batch}, at::kLong);
+  int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  for (int64_t b = 0; b < batch; ++b) {
+    int64_t index = b;
+    int64_t offset = 0;
+    for (int64_t d = batch_dims - 1; d >= 0; --d) {
+      offset += (index % mask.size(d)) * mask.stride(d);
+      index /= mask.size(d);
+    }
+    offsets_data[b] = offset;
+  }
+  return offsets.to(mask.device());
+}
+
+ScalarType logsumexp_type(const Tensor& query) {
+  const auto dtype = query.scalar_type();
+  return dtype == kHalf || dtype == kBFloat16 ? kFloat : dtype;
+}
+
+// Whether the fused kernels of the device support the inputs. The others run
+// through the chunked implementation below.
+bool use_fused_attention_kernel(
+    const Tensor& query,
+    const Tensor& value) {
+  const auto dtype = query.scalar_type();
+  if (query.is_cuda()) {
+    return (dtype == kFloat || dtype == kDouble || dtype == kHalf) &&
+        std::max(query.size(-1), value.size(-1)) <= kFusedAttentionMaxCUDAHeadDim;
+  }
+  return query.device().type() == kCPU && (dtype == kFloat || dtype == kDouble);
+}
+
+// Computes the attention of kQueryChunkSize queries at a time with matmul, so
+// that only the scores of those queries are materialized.
+std::tuple<Tensor, Tensor> fused_attention_chunked(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask) {
+  auto output_sizes = query.sizes().vec();
+  output_sizes.back() = value.size(-1);
+  Tensor output = at::empty(output_sizes, query.options());
+  Tensor logsumexp = at::empty(
+      query.sizes().slice(0, query.dim() - 1),
+      query.options().dtype(logsumexp_type(query)));
+  const Tensor key_t = key.transpose(-2, -1);
+  const int64_t num_queries = query.size(-2);
+  for (int64_t start = 0; start < num_queries; start += kQueryChunkSize) {
+    const int64_t length = std::min(kQueryChunkSize, num_queries - start);
+    Tensor scores = at::matmul(query.narrow(-2, start, length), key_t);
+    if (mask.defined()) {
+      scores.add_(mask.narrow(-2, start, length));
+    }
+    const Tensor chunk_logsumexp =
+        at::logsumexp(scores.to(logsumexp.scalar_type()), -1, /*keepdim=*/true);
+    output.narrow(-2, start, length).copy_(at::matmul(
+        at::exp(scores - chunk_logsumexp).to(query.scalar_type()), value));
+    logsumexp.narrow(-1, start, length).copy_(chunk_logsumexp.squeeze(-1));
+  }
+  return std::make_tuple(std::move(output), std::move(logsumexp));
+}
+
+std::tuple<Tensor, Tensor, Tensor> fused_attention_backward_chunked(
+    const Tensor& grad_output,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& output,
+    const Tensor& logsumexp) {
+  Tensor grad_query = at::empty_like(query, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor grad_key = at::zeros_like(key, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor grad_value = at::zeros_like(value, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  // The softmax of fully masked rows is nan; they get no gradient
+  const Tensor safe_logsumexp = logsumexp.masked_fill(
+      logsumexp == -std::numeric_limits<double>::infinity(), 0).unsqueeze(-1);
+  const Tensor grad_dot_output = (grad_output * output).sum(-1, /*keepdim=*/true);
+  const Tensor key_t = key.transpose(-2, -1);
+  const Tensor value_t = value.transpose(-2, -1);
+  const int64_t num_queries = query.size(-2);
+  for (int64_t start = 0; start < num_queries; start += kQueryChunkSize) {
+    const int64_t length = std::min(kQueryChunkSize, num_queries - start);
+    const Tensor query_chunk = query.narrow(-2, start, length);
+    const Tensor grad_output_chunk = grad_output.narrow(-2, start, length);
+    Tensor scores = at::matmul(query_chunk, key_t);
+    if (mask.defined()) {
+      scores.add_(mask.narrow(-2, start, length));
+    }
+    const Tensor probs =
+        at::exp(scores - safe_logsumexp.narrow(-2, start, length))
+            .to(query.scalar_type());
+    grad_value.add_(at::matmul(probs.transpose(-2, -1), grad_output_chunk));
+    const Tensor grad_scores = probs *
+        (at::matmul(grad_output_chunk, value_t) -
+         grad_dot_output.narrow(-2, start, length));
+    grad_query.narrow(-2, start, length).copy_(at::matmul(grad_scores, key));
+    grad_key.add_(at::matmul(grad_scores.transpose(-2, -1), query_chunk));
+  }
+  return std::make_tuple(
+      std::move(grad_query), std::move(grad_key), std::move(grad_value));
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> fused_attention(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask /* optional */) {
+  check_attention_inputs(query, key, value, attn_mask);
+  const Tensor mask = expand_attention_mask(attn_mask, query, key);
+  if (!use_fused_attention_kernel(query, value)) {
+    return fused_attention_chunked(query, key, value, mask);
+  }
+
+  auto output_sizes = query.sizes().vec();
+  output_sizes.back() = value.size(-1);
+  Tensor output = at::empty(output_sizes, query.options());
+  Tensor logsumexp = at::empty(
+      query.sizes().slice(0, query.dim() - 1),
+      query.options().dtype(logsumexp_type(query)));
+  if (output.numel() > 0) {
+    fused_attention_stub(
+        query.device().type(),
+        query.contiguous(),
+        key.contiguous(),
+        value.contiguous(),
+        mask,
+        attention_mask_offsets(mask),
+        output,
+        logsumexp);
+  }
+  return std::make_tuple(std::move(output), std::move(logsumexp));
+}
+
+std::tuple<Tensor, Tensor, Tensor> fused_attention_backward(
+    const Tensor& grad_output,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask /* optional */,
+    const Tensor& output,
+    const Tensor& logsumexp) {
+  check_attention_inputs(query, key, value, attn_mask);
+  const Tensor mask = expand_attention_mask(attn_mask, query, key);
+  // The CUDA backward pass accumulates the gradients of the keys and values
+  // over all queries, which the chunked implementation does with matmul.
+  if (query.is_cuda() || !use_fused_attention_kernel(query, value)) {
+    return fused_attention_backward_chunked(
+        grad_output, query, key, value, mask, output, logsumexp);
+  }
+
+  Tensor grad_query = at::empty_like(query, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor grad_key = at::empty_like(key, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor grad_value = at::empty_like(value, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (query.numel() > 0 || key.numel() > 0 || value.numel() > 0) {
+    fused_attention_backward_stub(
+        query.device().type(),
+        grad_output.contiguous(),
+        query.contiguous(),
+        key.contiguous(),
+        value.contiguous(),
+        mask,
+        attention_mask_offsets(mask),
+        output.contiguous(),
+        logsumexp.contiguous(),
+        grad_query,
+        grad_key,
+        grad_value);
+  }
+  return std::make_tuple(
+      std::move(grad_query), std::move(grad_key), std::move(grad_value));
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The largest head dimension (of the queries and keys, or of the values) the
+// CUDA kernel keeps in registers; larger ones use the chunked implementation.
+constexpr int64_t kFusedAttentionMaxCUDAHeadDim = 128;
+
+// query [B, Lq, E], key [B, Lk, E], value [B, Lk, Ev], output [B, Lq, Ev] and
+// logsumexp [B, Lq] are contiguous, with the batch dimensions flattened into
+// B. attn_mask, if defined, has the dtype of query and holds the [Lq, Lk]
+// additive mask of batch b at attn_mask.data_ptr() + mask_offsets[b], with
+// the strides attn_mask.stride(-2) and attn_mask.stride(-1). mask_offsets is
+// a Long tensor on the device of query.
+using fused_attention_fn = void(*)(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask,
+    const Tensor& mask_offsets,
+    Tensor& output,
+    Tensor& logsumexp);
+
+// Same layouts as above; grad_output and output are [B, Lq, Ev], and the
+// gradients have the layouts of their inputs.
+using fused_attention_backward_fn = void(*)(
+    const Tensor& grad_output,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask,
+    const Tensor& mask_offsets,
+    const Tensor& output,
+    const Tensor& logsumexp,
+    Tensor& grad_query,
+    Tensor& grad_key,
+    Tensor& grad_value);
+
+DECLARE_DISPATCH(fused_attention_fn, fused_attention_stub);
+DECLARE_DISPATCH(fused_attention_backward_fn, fused_attention_backward_stub);
+
+}} // at::native
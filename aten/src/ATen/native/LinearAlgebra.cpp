@@ -3,6 +3,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/LinearAlgebraUtils.h>
+#include <ATen/native/mkldnn/Matmul.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/LegacyTHFunctionsCPU.h>
@@ -183,18 +184,67 @@ Tensor& addbmm_cpu_out(Tensor& result, const Tensor& self, const Tensor& batch1,
   return legacy::cpu::_th_addbmm_out(result, b_self, batch1, batch2, beta, alpha);
 }
 
+static inline bool is_bf16_matmul(const Tensor& result, const Tensor& mat1, const Tensor& mat2) {
+  return result.scalar_type() == kBFloat16 && mat1.scalar_type() == kBFloat16 &&
+      mat2.scalar_type() == kBFloat16;
+}
+
+// BFloat16 matrix products go through oneDNN's bf16 matmul where the CPU has
+// it (see mkldnn/Matmul.h), and otherwise through the BLAS float gemm on
+// converted copies. Both are blocked and accumulate in float, unlike the
+// naive BFloat16 gemm of TH, which is left for builds without BLAS.
+static Tensor& addmm_bf16_cpu_out(Tensor& result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha) {
+  TORCH_CHECK(mat1.dim() == 2 && mat2.dim() == 2, "addmm: expected 2-D matrices, got ",
+              mat1.dim(), "-D and ", mat2.dim(), "-D tensors");
+  TORCH_CHECK(mat1.size(1) == mat2.size(0), "size mismatch, m1: ", mat1.sizes(), ", m2: ", mat2.sizes());
+  TORCH_CHECK(self.sizes() == IntArrayRef({mat1.size(0), mat2.size(1)}),
+              "addmm: self of size ", self.sizes(), " doesn't match the product");
+  if (use_mkldnn_bf16_matmul(mat1, mat2, result)) {
+    const float beta_ = beta.to<float>();
+    result.resize_({mat1.size(0), mat2.size(1)});
+    if (beta_ != 0 && !result.is_same(self)) {
+      result.copy_(self);
+    }
+    mkldnn_matmul(mat1, mat2, result, beta_, alpha.to<float>());
+    return result;
+  }
+#if AT_BUILD_WITH_BLAS()
+  if (mat1.numel() != 0 && mat2.numel() != 0) {
+    const Tensor product = legacy::cpu::_th_addmm(
+        self.to(kFloat), mat1.to(kFloat), mat2.to(kFloat), beta, alpha);
+    result.resize_(product.sizes());
+    return result.copy_(product);
+  }
+#endif
+  return legacy::cpu::_th_addmm_out(result, self, mat1, mat2, beta, alpha);
+}
+
 Tensor addmm_cpu(const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha) {
   Tensor b_self;
   std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm");
+  if (is_bf16_matmul(self, mat1, mat2)) {
+    Tensor result = at::empty({0}, self.options());
+    return addmm_bf16_cpu_out(result, b_self, mat1, mat2, beta, alpha);
+  }
   return legacy::cpu::_th_addmm(b_self, mat1, mat2, beta, alpha);
 }
 
 Tensor& addmm_cpu_out(Tensor &result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha) {
   Tensor b_self;
   std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  if (is_bf16_matmul(result, mat1, mat2) && self.scalar_type() == kBFloat16) {
+    return addmm_bf16_cpu_out(result, b_self, mat1, mat2, beta, alpha);
+  }
   return legacy::cpu::_th_addmm_out(result, b_self, mat1, mat2, beta, alpha);
 }
 
+Tensor& addmm__cpu(Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha) {
+  if (is_bf16_matmul(self, mat1, mat2)) {
+    return addmm_bf16_cpu_out(self, self, mat1, mat2, beta, alpha);
+  }
+  return legacy::cpu::_th_addmm_(self, mat1, mat2, beta, alpha);
+}
+
 Tensor mm_cpu(const Tensor & self, const Tensor & mat2) {
   Tensor result = at::empty({0}, self.options());
   return mm_cpu_out(result, self, mat2);
@@ -202,6 +252,9 @@ Tensor mm_cpu(const Tensor & self, const Tensor & mat2) {
 
 Tensor& mm_cpu_out(Tensor & result, const Tensor & self, const Tensor & mat2) {
   result.resize_({ self.size(0), mat2.size(1) });
+  if (is_bf16_matmul(result, self, mat2)) {
+    return addmm_bf16_cpu_out(result, result, self, mat2, 0, 1);
+  }
   return legacy::cpu::_th_addmm_out(result, result, self, mat2, 0, 1);
 }
 
@@ -298,7 +351,12 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             || (t.stride(1) == 1 && t.stride(2) >= t.size(1));
   };
 
-  if (contraction_size * res_rows * res_cols < 400) {
+  // BFloat16 batches go to oneDNN whole where it has a bf16 matmul, and to the
+  // float accumulating BFloat16 mm/addmm one matrix at a time otherwise
+  const bool is_bf16 = self_or_result.scalar_type() == kBFloat16;
+  if (is_bf16 && use_mkldnn_bf16_matmul(batch1, batch2, self_or_result)) {
+    mkldnn_matmul(batch1, batch2, self_or_result, is_bmm_out ? 0 : beta.to<float>(), alpha.to<float>());
+  } else if (!is_bf16 && contraction_size * res_rows * res_cols < 400) {
     if (is_bmm_out) {
       AT_DISPATCH_ALL_TYPES(batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
@@ -308,7 +366,7 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
           baddbmm_cpu_kernel<scalar_t, false>(self_or_result, batch1, batch2, beta, alpha);
         });
     }
-  } else if (at::hasMKL() && at::native::is_floating_point(self_or_result)
+  } else if (at::hasMKL() && at::native::is_floating_point(self_or_result) && !is_bf16
             && batch_items_contiguous_or_transposed(batch1)
             && batch_items_contiguous_or_transposed(batch2)
             && self_or_result.is_contiguous()) {
@@ -1,5 +1,11 @@
 #include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/InferSize.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/core/op_registration/hacky_wrapper_for_legacy_signatures.h>
+#include <ATen/native/TensorFactories.h>
+#include <torch/library.h>
 
 namespace at {
 namespace native {
@@ -39,5 +45,121 @@ Tensor empty_meta(
   return tensor;
 }
 
+Tensor empty_strided_meta(
+  IntArrayRef size,
+  IntArrayRef stride,
+  const TensorOptions& options
+) {
+  check_size_nonnegative(size);
+  auto tensor = at::native::empty_meta({0}, options, c10::nullopt);
+  // There is no storage to check the strides against
+  tensor.unsafeGetTensorImpl()->set_sizes_and_strides(size, stride);
+  return tensor;
+}
+
+// Meta tensors have no storage for a view to share, so a view is a new
+// TensorImpl with the key set, dtype and device of its base.
+Tensor as_strided_meta(const Tensor& self, IntArrayRef size, IntArrayRef stride, optional<int64_t> storage_offset_) {
+  auto storage_offset = storage_offset_.value_or(self.storage_offset());
+  TORCH_CHECK(size.size() == stride.size(), "mismatch in length of strides and shape");
+  TORCH_CHECK(storage_offset >= 0, "Tensor: invalid storage offset ", storage_offset);
+  for (auto val : stride) {
+    TORCH_CHECK(val >= 0,
+                "as_strided: Negative strides are not supported at the moment, "
+                "got strides: ", stride);
+  }
+  auto result = detail::make_tensor<TensorImpl>(self.key_set(), self.dtype(), self.device());
+  result.unsafeGetTensorImpl()->set_storage_offset(storage_offset);
+  result.unsafeGetTensorImpl()->set_sizes_and_strides(size, stride);
+  return result;
+}
+
+Tensor view_meta(const Tensor& self, IntArrayRef size) {
+  auto inferred_size = at::infer_size(size, self.numel());
+  auto stride = at::detail::computeStride(self.sizes(),
+                                          self.strides(),
+                                          inferred_size);
+  TORCH_CHECK(stride.has_value(), "view size is "
+    "not compatible with input tensor's size and stride (at least one dimension"
+    " spans across two contiguous subspaces). Use .reshape(...) instead.");
+  return as_strided_meta(self, inferred_size, *stride, self.storage_offset());
+}
+
+// The in-place initializers have no data to write, so that modules, and the
+// nn.init functions they are reset with, can run on meta tensors.
+Tensor& fill_meta_(Tensor& self, Scalar value) {
+  return self;
+}
+
+Tensor& fill_meta_(Tensor& self, const Tensor& value) {
+  TORCH_CHECK(value.dim() == 0, "fill_ only supports 0-dimension value tensor but got tensor with ", value.dim(), " dimensions.");
+  return self;
+}
+
+Tensor& zero_meta_(Tensor& self) {
+  return self;
+}
+
+Tensor& uniform_meta_(Tensor& self, double from, double to, c10::optional<Generator> gen) {
+  TORCH_CHECK(from <= to, "uniform_ expects to return a [from, to) range, but found from=", from, " > to=", to);
+  return self;
+}
+
+Tensor& normal_meta_(Tensor& self, double mean, double std, c10::optional<Generator> gen) {
+  TORCH_CHECK(std >= 0.0, "normal_ expects std >= 0.0, but found std=", std);
+  return self;
+}
+
+Tensor& random_meta_(Tensor& self, c10::optional<Generator> gen) {
+  return self;
+}
+
+Tensor& random_meta_(Tensor& self, int64_t from, optional<int64_t> to, c10::optional<Generator> gen) {
+  return self;
+}
+
+Tensor& random_meta_(Tensor& self, int64_t to, c10::optional<Generator> gen) {
+  return self;
+}
+
+Tensor& bernoulli_meta_(Tensor& self, double p, c10::optional<Generator> gen) {
+  TORCH_CHECK(0 <= p && p <= 1, "bernoulli_ expects p to be in [0, 1], but got p=", p);
+  return self;
+}
+
+Tensor& exponential_meta_(Tensor& self, double lambda, c10::optional<Generator> gen) {
+  TORCH_CHECK(lambda >= 0.0, "exponential_ expects lambda >= 0.0, but found lambda=", lambda);
+  return self;
+}
+
+// Copying into a meta tensor only checks the shapes. There is no data to copy
+// out of one, e.g. with .to(), which has to materialize with empty_like and
+// initialize the real tensor instead.
+Tensor& copy_meta_(Tensor& self, const Tensor& src, bool non_blocking) {
+  TORCH_CHECK(self.is_meta(), "Cannot copy out of meta tensor; it has no data");
+  TORCH_CHECK(is_expandable_to(src.sizes(), self.sizes()),
+              "The size of the source tensor ", src.sizes(),
+              " must be broadcastable to the size of the destination ", self.sizes());
+  return self;
+}
+
+TORCH_LIBRARY_IMPL(aten, Meta, m) {
+  m.impl("empty.memory_format", c10::impl::hacky_wrapper_for_legacy_signatures(TORCH_FN(empty_meta)));
+  m.impl("empty_strided", c10::impl::hacky_wrapper_for_legacy_signatures(TORCH_FN(empty_strided_meta)));
+  m.impl("as_strided", as_strided_meta);
+  m.impl("view", view_meta);
+  m.impl_UNBOXED("fill_.Scalar", static_cast<Tensor& (*)(Tensor&, Scalar)>(fill_meta_));
+  m.impl_UNBOXED("fill_.Tensor", static_cast<Tensor& (*)(Tensor&, const Tensor&)>(fill_meta_));
+  m.impl_UNBOXED("zero_", zero_meta_);
+  m.impl_UNBOXED("uniform_", uniform_meta_);
+  m.impl_UNBOXED("normal_", normal_meta_);
+  m.impl_UNBOXED("random_", static_cast<Tensor& (*)(Tensor&, c10::optional<Generator>)>(random_meta_));
+  m.impl_UNBOXED("random_.from", static_cast<Tensor& (*)(Tensor&, int64_t, optional<int64_t>, c10::optional<Generator>)>(random_meta_));
+  m.impl_UNBOXED("random_.to", static_cast<Tensor& (*)(Tensor&, int64_t, c10::optional<Generator>)>(random_meta_));
+  m.impl_UNBOXED("bernoulli_.float", bernoulli_meta_);
+  m.impl_UNBOXED("exponential_", exponential_meta_);
+  m.impl_UNBOXED("copy_", copy_meta_);
+}
+
 } // namespace native
 } // namespace at
@@ -2,6 +2,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/div_rtn.h>
+#include <ATen/native/DispatchStub.h>
 #include <tuple>
 
 #pragma once
@@ -249,5 +250,12 @@ avg_pool3d_backward_shape_check(
 
 } // namespace
 
+// Channels last input, output and indices, see
+// max_pool2d_with_indices_out_cpu_template. The indices are the offsets of the
+// maxima in their input planes, as in the contiguous case.
+using max_pool2d_fn = void(*)(Tensor& output, Tensor& indices, const Tensor& input,
+    int kW, int kH, int dW, int dH, int padW, int padH, int dilationW, int dilationH);
+DECLARE_DISPATCH(max_pool2d_fn, max_pool2d_channels_last_kernel);
+
 } // at::native
 } // at
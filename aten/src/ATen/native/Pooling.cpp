@@ -3,6 +3,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/NamedTensorUtils.h>
+#include <ATen/native/vulkan/VulkanAten.h>
 #include <ATen/native/xnnpack/Engine.h>
 #include <c10/macros/Macros.h>
 #include <c10/util/Exception.h>
@@ -134,6 +135,12 @@ Tensor max_pool2d(
     return at::mkldnn_max_pool2d(
         self, kernel_size, stride, padding, dilation, ceil_mode);
   }
+#ifdef USE_VULKAN
+  if (self.is_vulkan()) {
+    return at::native::vulkan_max_pool2d(
+        self, kernel_size, stride, padding, dilation, ceil_mode);
+  }
+#endif
 
 #if defined(C10_MOBILE)
   if(xnnpack::use_max_pool2d(self, kernel_size, padding, stride,
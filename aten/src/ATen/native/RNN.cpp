@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
@@ -13,6 +14,13 @@ torch::class_<LinearPackedParamsBase> register_linear_params();
 
 namespace at { namespace native {
 
+DEFINE_DISPATCH(lstm_cell_epilogue_stub);
+DEFINE_DISPATCH(gru_cell_epilogue_stub);
+DEFINE_DISPATCH(fused_lstm_cell_stub);
+DEFINE_DISPATCH(fused_lstm_cell_backward_stub);
+DEFINE_DISPATCH(fused_gru_cell_stub);
+DEFINE_DISPATCH(fused_gru_cell_backward_stub);
+
 namespace {
 
 // Check if pytorch is compiled with MIOpen.
@@ -682,6 +690,29 @@ struct SimpleCell : Cell<Tensor, cell_params> {
   }
 };
 
+// Whether the gates of a CPU cell can go through its fused kernels, which only
+// handle batched floating point gates. Shape mismatches are left to the
+// unfused path to report.
+bool use_fused_cell(
+    const Tensor& gates,
+    const Tensor& hidden,
+    int64_t num_gates) {
+  return gates.dim() == 2 && hidden.dim() == 2 &&
+      gates.size(0) == hidden.size(0) &&
+      gates.size(1) == num_gates * hidden.size(1) &&
+      gates.scalar_type() == hidden.scalar_type() &&
+      (gates.scalar_type() == kFloat || gates.scalar_type() == kDouble);
+}
+
+// The cell epilogues have no derivative, when something requires grad the
+// cells go through _thnn_fused_lstm_cell and _thnn_fused_gru_cell, which save
+// the activated gates for their fused backward.
+bool any_requires_grad(TensorList tensors) {
+  return std::any_of(tensors.begin(), tensors.end(), [](const Tensor& t) {
+    return t.requires_grad();
+  });
+}
+
 // TODO: can use inplace ops?
 template <typename cell_params>
 struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
@@ -705,8 +736,19 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
     }
 
-    const auto gates = params.linear_hh(hx).add_(
-        pre_compute_input ? input : params.linear_ih(input));
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    auto hgates = params.linear_hh(hx);
+    if (use_fused_cell(igates, cx, 4) && use_fused_cell(hgates, cx, 4)) {
+      if (any_requires_grad({igates, hgates, cx})) {
+        auto result = at::_thnn_fused_lstm_cell(igates, hgates, cx);
+        return std::make_tuple(
+            std::move(std::get<0>(result)), std::move(std::get<1>(result)));
+      }
+      Tensor hy, cy;
+      lstm_cell_epilogue_stub(kCPU, hy, cy, hgates.add_(igates), cx);
+      return std::make_tuple(std::move(hy), std::move(cy));
+    }
+    const auto gates = hgates.add_(igates);
     auto chunked_gates = gates.chunk(4, 1);
     auto ingate = chunked_gates[0].sigmoid_();
     auto forgetgate = chunked_gates[1].sigmoid_();
@@ -737,10 +779,19 @@ struct GRUCell : Cell<Tensor, cell_params> {
       // Slice off the workspace argument (it's needed only for AD).
       return std::move(std::get<0>(result));
     }
-    const auto chunked_igates = pre_compute_input
-        ? input.chunk(3, 1)
-        : params.linear_ih(input).chunk(3, 1);
-    auto chunked_hgates = params.linear_hh(hidden).chunk(3, 1);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    auto hgates = params.linear_hh(hidden);
+    if (use_fused_cell(igates, hidden, 3) &&
+        use_fused_cell(hgates, hidden, 3)) {
+      if (any_requires_grad({igates, hgates, hidden})) {
+        return std::get<0>(at::_thnn_fused_gru_cell(igates, hgates, hidden));
+      }
+      Tensor hy;
+      gru_cell_epilogue_stub(kCPU, hy, igates, hgates, hidden);
+      return hy;
+    }
+    const auto chunked_igates = igates.chunk(3, 1);
+    auto chunked_hgates = hgates.chunk(3, 1);
     const auto reset_gate =
         chunked_hgates[0].add_(chunked_igates[0]).sigmoid_();
     const auto input_gate =
@@ -1548,6 +1599,143 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_differentiable_gru_cell
                          std::move(grad_hx), std::move(grad_input_bias), std::move(grad_hidden_bias));
 }
 
+namespace {
+
+void check_fused_cell_sizes(
+    CheckedFrom c,
+    const TensorArg& input_gates,
+    const TensorArg& hidden_gates,
+    const TensorArg& input_bias,
+    const TensorArg& hidden_bias,
+    int64_t factor,
+    const TensorArg& prev_hidden) {
+  checkDim(c, input_gates, 2);
+  checkSameSize(c, input_gates, hidden_gates);
+  const int64_t gates_size = input_gates->size(1);
+
+  if (input_bias->defined()) {
+    checkDim(c, input_bias, 1);
+    checkNumel(c, input_bias, gates_size);
+    checkSameSize(c, input_bias, hidden_bias);
+    checkSameType(c, input_gates, input_bias);
+    checkSameType(c, input_gates, hidden_bias);
+  }
+
+  checkDim(c, prev_hidden, 2);
+  checkNumel(c, prev_hidden, input_gates->size(0) * gates_size / factor);
+  checkSameType(c, input_gates, hidden_gates);
+  checkSameType(c, input_gates, prev_hidden);
+}
+
+} // anonymous namespace
+
+std::tuple<Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_cpu(
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& cx,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias) {
+  check_fused_cell_sizes(
+      "_thnn_fused_lstm_cell_cpu",
+      {input_gates, "input_gates", 1},
+      {hidden_gates, "hidden_gates", 2},
+      {input_bias, "input_bias", 3},
+      {hidden_bias, "hidden_bias", 4},
+      /*factor=*/4,
+      {cx, "prev_hidden", 5});
+  Tensor hy, cy, workspace;
+  fused_lstm_cell_stub(
+      kCPU, hy, cy, workspace, input_gates, hidden_gates, input_bias,
+      hidden_bias, cx);
+  return std::make_tuple(std::move(hy), std::move(cy), std::move(workspace));
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>
+_thnn_fused_lstm_cell_backward_cpu(
+    const Tensor& grad_hy,
+    const Tensor& grad_cy,
+    const Tensor& cx,
+    const Tensor& cy,
+    const Tensor& workspace,
+    bool has_bias) {
+  if (!grad_hy.defined() && !grad_cy.defined()) {
+    return std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>();
+  }
+  CheckedFrom c = "_thnn_fused_lstm_cell_backward_cpu";
+  const TensorArg grad_hy_arg{grad_hy, "grad_hy", 1};
+  const TensorArg grad_cy_arg{grad_cy, "grad_cy", 2};
+  const TensorArg& defined_grad = grad_hy.defined() ? grad_hy_arg : grad_cy_arg;
+  checkDim(c, defined_grad, 2);
+  const auto exp_size = defined_grad->sizes();
+  if (grad_hy.defined()) {
+    checkSize(c, grad_hy_arg, exp_size);
+  }
+  if (grad_cy.defined()) {
+    checkSize(c, grad_cy_arg, exp_size);
+  }
+  const TensorArg workspace_arg{workspace, "workspace", 5};
+  checkSize(c, TensorArg{cx, "cx", 3}, exp_size);
+  checkSize(c, TensorArg{cy, "cy", 4}, exp_size);
+  checkDim(c, workspace_arg, 2);
+  checkNumel(c, workspace_arg, exp_size[0] * exp_size[1] * 4);
+
+  Tensor grad_gates, grad_cx;
+  fused_lstm_cell_backward_stub(
+      kCPU, grad_gates, grad_cx, grad_hy, grad_cy, cx, cy, workspace);
+  auto grad_bias =
+      has_bias ? grad_gates.sum(0, /*keepdim=*/false) : at::Tensor{};
+  return std::make_tuple(
+      grad_gates, grad_gates, std::move(grad_cx), grad_bias, grad_bias);
+}
+
+std::tuple<Tensor, Tensor> _thnn_fused_gru_cell_cpu(
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& hx,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias) {
+  check_fused_cell_sizes(
+      "_thnn_fused_gru_cell_cpu",
+      {input_gates, "input_gates", 1},
+      {hidden_gates, "hidden_gates", 2},
+      {input_bias, "input_bias", 3},
+      {hidden_bias, "hidden_bias", 4},
+      /*factor=*/3,
+      {hx, "prev_hidden", 5});
+  Tensor hy, workspace;
+  fused_gru_cell_stub(
+      kCPU, hy, workspace, input_gates, hidden_gates, input_bias, hidden_bias,
+      hx);
+  return std::make_tuple(std::move(hy), std::move(workspace));
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>
+_thnn_fused_gru_cell_backward_cpu(
+    const Tensor& grad_hy,
+    const Tensor& workspace,
+    bool has_bias) {
+  CheckedFrom c = "_thnn_fused_gru_cell_backward_cpu";
+  const TensorArg grad_hy_arg{grad_hy, "grad_hy", 1};
+  checkDim(c, grad_hy_arg, 2);
+  checkSize(
+      c,
+      TensorArg{workspace, "workspace", 2},
+      {grad_hy.size(0), grad_hy.size(1) * 5});
+
+  Tensor grad_input_gates, grad_hidden_gates, grad_hx;
+  fused_gru_cell_backward_stub(
+      kCPU, grad_input_gates, grad_hidden_gates, grad_hx, grad_hy, workspace);
+  Tensor grad_input_bias, grad_hidden_bias;
+  if (has_bias) {
+    grad_input_bias = grad_input_gates.sum(0, /*keepdim=*/false);
+    grad_hidden_bias = grad_hidden_gates.sum(0, /*keepdim=*/false);
+  }
+  return std::make_tuple(
+      std::move(grad_input_gates), std::move(grad_hidden_gates),
+      std::move(grad_hx), std::move(grad_input_bias),
+      std::move(grad_hidden_bias));
+}
+
 Tensor gru_cell(
     const Tensor& input, const Tensor& hx,
     const Tensor& w_ih, const Tensor& w_hh, const Tensor& b_ih, const Tensor& b_hh) {
@@ -27,6 +27,41 @@ DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_miopen_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_miopen_stub);
 
+// Epilogues of the CPU LSTM and GRU cells, which apply the gate
+// nonlinearities and compute the new hidden state in a single pass over the
+// gates, once their matrix products (biases included) have been computed:
+// (hy, cy, gates, cx) for LSTM and (hy, igates, hgates, hx) for GRU. They have
+// no derivative, so they are only used when nothing requires grad.
+using lstm_cell_epilogue_fn = void(*)(Tensor&, Tensor&, const Tensor&, const Tensor&);
+using gru_cell_epilogue_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const Tensor&);
+
+DECLARE_DISPATCH(lstm_cell_epilogue_fn, lstm_cell_epilogue_stub);
+DECLARE_DISPATCH(gru_cell_epilogue_fn, gru_cell_epilogue_stub);
+
+// The CPU kernels of _thnn_fused_lstm_cell and _thnn_fused_gru_cell, which add
+// the matrix products of the input and the hidden state, and the biases if
+// defined, apply the gate nonlinearities and save the activated gates for
+// their backward in the same pass. The workspaces have the layouts of the
+// CUDA kernels:
+//   lstm: (hy, cy, workspace, input_gates, hidden_gates, input_bias,
+//          hidden_bias, cx), the workspace holding the 4 activated gates
+//   lstm backward: (grad_gates, grad_cx, grad_hy, grad_cy, cx, cy, workspace),
+//          where grad_hy or grad_cy may be undefined
+//   gru: (hy, workspace, input_gates, hidden_gates, input_bias, hidden_bias,
+//          hx), the workspace holding the 3 activated gates, hx, and the
+//          hidden product of the new gate
+//   gru backward: (grad_input_gates, grad_hidden_gates, grad_hx, grad_hy,
+//          workspace)
+using fused_lstm_cell_fn = void(*)(Tensor&, Tensor&, Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&);
+using fused_lstm_cell_backward_fn = void(*)(Tensor&, Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&);
+using fused_gru_cell_fn = void(*)(Tensor&, Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&);
+using fused_gru_cell_backward_fn = void(*)(Tensor&, Tensor&, Tensor&, const Tensor&, const Tensor&);
+
+DECLARE_DISPATCH(fused_lstm_cell_fn, fused_lstm_cell_stub);
+DECLARE_DISPATCH(fused_lstm_cell_backward_fn, fused_lstm_cell_backward_stub);
+DECLARE_DISPATCH(fused_gru_cell_fn, fused_gru_cell_stub);
+DECLARE_DISPATCH(fused_gru_cell_backward_fn, fused_gru_cell_backward_stub);
+
 inline void check_device(const Tensor& input, const TensorList& params, const TensorList& hiddens) {
   auto input_device = input.device();
 
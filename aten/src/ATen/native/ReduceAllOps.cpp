@@ -8,6 +8,7 @@ namespace native {
 
 DEFINE_DISPATCH(min_all_stub);
 DEFINE_DISPATCH(max_all_stub);
+DEFINE_DISPATCH(_aminmax_all_stub);
 
 Tensor min(const Tensor &self) {
   TORCH_CHECK(!self.is_complex(), "min is not yet implemented for complex tensors.");
@@ -25,4 +26,17 @@ Tensor max(const Tensor &self) {
   return result;
 }
 
+// Both the min and the max of self, computed in a single pass over it on CPU
+std::tuple<Tensor, Tensor> _aminmax_all(const Tensor &self) {
+  TORCH_CHECK(!self.is_complex(), "_aminmax is not yet implemented for complex tensors.");
+  TORCH_CHECK(self.numel() > 0, "operation does not have an identity.");
+  if (self.device().type() != DeviceType::CPU || self.scalar_type() == ScalarType::Bool) {
+    return std::make_tuple(at::min(self), at::max(self));
+  }
+  Tensor min_result = at::empty({}, self.options());
+  Tensor max_result = at::empty({}, self.options());
+  _aminmax_all_stub(self.device().type(), min_result, max_result, self.contiguous());
+  return std::make_tuple(min_result, max_result);
+}
+
 }} // namesapce at::native
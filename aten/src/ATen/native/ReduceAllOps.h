@@ -9,4 +9,8 @@ using reduce_all_fn = void (*)(Tensor & result, const Tensor & self);
 DECLARE_DISPATCH(reduce_all_fn, min_all_stub);
 DECLARE_DISPATCH(reduce_all_fn, max_all_stub);
 
+using reduce_all_two_outputs_fn =
+    void (*)(Tensor & result1, Tensor & result2, const Tensor & self);
+DECLARE_DISPATCH(reduce_all_two_outputs_fn, _aminmax_all_stub);
+
 }}
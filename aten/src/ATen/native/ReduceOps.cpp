@@ -33,6 +33,7 @@ DEFINE_DISPATCH(and_stub);
 DEFINE_DISPATCH(or_stub);
 DEFINE_DISPATCH(min_values_stub);
 DEFINE_DISPATCH(max_values_stub);
+DEFINE_DISPATCH(aminmax_stub);
 DEFINE_DISPATCH(argmax_stub);
 DEFINE_DISPATCH(argmin_stub);
 DEFINE_DISPATCH(cumsum_stub);
@@ -619,6 +620,22 @@ Tensor max_values(const Tensor& self, IntArrayRef dims, bool keepdim) {
   }
 }
 
+// The min and the max of self over dim, computed in a single pass on CPU
+std::tuple<Tensor, Tensor> _aminmax(const Tensor& self, int64_t dim, bool keepdim) {
+  TORCH_CHECK(!self.is_complex(), "_aminmax is not yet implemented for complex tensors.");
+  if (self.device().type() != DeviceType::CPU || self.scalar_type() == ScalarType::Bool) {
+    return std::make_tuple(
+        std::get<0>(self.min(dim, keepdim)), std::get<0>(self.max(dim, keepdim)));
+  }
+  Tensor min_result = at::empty({0}, self.options());
+  Tensor max_result = at::empty({0}, self.options());
+  auto iter = make_reduction(
+      "_aminmax", min_result, max_result, self, dim, keepdim, self.scalar_type());
+  TORCH_CHECK(iter.numel() > 0, "_aminmax on a tensor with no elements is not defined.");
+  aminmax_stub(iter.device_type(), iter);
+  return std::make_tuple(min_result, max_result);
+}
+
 Tensor min_values(const Tensor& self, DimnameList dims, bool keepdim) {
   TORCH_CHECK(false, "NYI: min_values with names");
   return at::min_values(self, dimnames_to_positions(self, dims), keepdim);
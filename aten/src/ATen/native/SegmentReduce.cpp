@@ -0,0 +1,123 @@
+#include <ATen/native/SegmentReduce.h>
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(segment_reduce_stub);
+
+namespace {
+
+SEGMENT_REDUCTION_TYPE get_reduction_enum(const std::string& reduce) {
+  if (reduce == "max") {
+    return SEGMENT_REDUCTION_TYPE::MAX;
+  } else if (reduce == "mean") {
+    return SEGMENT_REDUCTION_TYPE::MEAN;
+  } else if (reduce == "sum") {
+    return SEGMENT_REDUCTION_TYPE::SUM;
+  }
+  TORCH_CHECK(false,
+              "segment_reduce(): reduce argument must be either of max, mean or sum, got ", reduce);
+}
+
+// The sizes of a tensor with one element per segment, broadcasting against
+// the reduced rows.
+std::vector<int64_t> segment_sizes(const Tensor& data, int64_t num_segments) {
+  std::vector<int64_t> sizes(data.dim(), 1);
+  sizes[0] = num_segments;
+  return sizes;
+}
+
+} // namespace
+
+Tensor segment_reduce(
+    const Tensor& data,
+    std::string reduce,
+    const Tensor& lengths,
+    const Tensor& offsets,
+    int64_t axis,
+    bool unsafe) {
+  TORCH_CHECK(lengths.defined() != offsets.defined(),
+              "segment_reduce(): expected exactly one of lengths or offsets");
+  TORCH_CHECK(data.dim() >= 1, "segment_reduce(): expected data to have at least one dimension");
+  TORCH_CHECK(maybe_wrap_dim(axis, data.dim()) == 0,
+              "segment_reduce(): only axis 0 is supported, got ", axis);
+  get_reduction_enum(reduce);
+
+  const Tensor& segments = lengths.defined() ? lengths : offsets;
+  TORCH_CHECK(segments.dim() == 1 && segments.scalar_type() == kLong,
+              "segment_reduce(): expected ", lengths.defined() ? "lengths" : "offsets",
+              " to be a 1-d Long tensor");
+  TORCH_CHECK(segments.device() == data.device(),
+              "segment_reduce(): expected ", lengths.defined() ? "lengths" : "offsets",
+              " to be on the device of data");
+
+  // offsets are the start of each segment, the last one ending at the end
+  // of data, as for embedding_bag
+  Tensor segment_lengths = lengths;
+  if (offsets.defined() && offsets.numel() == 0) {
+    segment_lengths = offsets;
+  } else if (offsets.defined()) {
+    auto ends = at::cat({offsets.narrow(0, 1, offsets.numel() - 1),
+                         at::full({1}, data.size(0), offsets.options())});
+    segment_lengths = ends - offsets;
+    if (!unsafe) {
+      TORCH_CHECK(offsets[0].item<int64_t>() == 0,
+                  "segment_reduce(): expected offsets to start at 0");
+    }
+  }
+  if (!unsafe) {
+    TORCH_CHECK((segment_lengths >= 0).all().item<bool>(),
+                "segment_reduce(): expected ", lengths.defined() ? "lengths" : "offsets",
+                " to describe segments of non-negative length");
+    TORCH_CHECK(segment_lengths.sum().item<int64_t>() == data.size(0),
+                "segment_reduce(): expected the segments to cover the ", data.size(0),
+                " rows of data");
+  }
+  return at::_segment_reduce(data, segment_lengths, reduce);
+}
+
+Tensor _segment_reduce_cpu_cuda(const Tensor& data, const Tensor& lengths, std::string reduce) {
+  const int64_t num_segments = lengths.numel();
+  auto output_sizes = data.sizes().vec();
+  output_sizes[0] = num_segments;
+  Tensor output = at::empty(output_sizes, data.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+
+  Tensor offsets = at::cat({at::zeros({1}, lengths.options()), lengths.cumsum(0)});
+  segment_reduce_stub(
+      data.device().type(), output, data.contiguous(), offsets, get_reduction_enum(reduce));
+  return output;
+}
+
+Tensor _segment_reduce_backward(
+    const Tensor& grad,
+    const Tensor& output,
+    const Tensor& data,
+    const Tensor& lengths,
+    std::string reduce) {
+  const int64_t num_segments = lengths.numel();
+  const Tensor segment_ids = at::repeat_interleave(lengths);
+  switch (get_reduction_enum(reduce)) {
+    case SEGMENT_REDUCTION_TYPE::SUM:
+      return grad.index_select(0, segment_ids);
+    case SEGMENT_REDUCTION_TYPE::MEAN: {
+      auto counts = lengths.clamp_min(1).to(grad.scalar_type()).view(segment_sizes(data, num_segments));
+      return (grad / counts).index_select(0, segment_ids);
+    }
+    case SEGMENT_REDUCTION_TYPE::MAX: {
+      // the gradient is split evenly between the maxima of each segment
+      auto is_max = data == output.index_select(0, segment_ids);
+      auto counts = at::zeros_like(output).index_add_(0, segment_ids, is_max.to(grad.scalar_type()));
+      return at::where(is_max, (grad / counts).index_select(0, segment_ids), at::zeros_like(data));
+    }
+  }
+  TORCH_INTERNAL_ASSERT(false, "unexpected segment reduction");
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+enum class SEGMENT_REDUCTION_TYPE: uint8_t {MAX, MEAN, SUM};
+
+// Reduces the rows [offsets[i], offsets[i + 1]) of the contiguous tensor
+// data, viewed as [data.size(0), -1], into the row i of the contiguous
+// tensor output. offsets is a contiguous Long tensor on the device of data.
+using segment_reduce_fn = void(*)(Tensor& output, const Tensor& data, const Tensor& offsets, SEGMENT_REDUCTION_TYPE reduction);
+
+DECLARE_DISPATCH(segment_reduce_fn, segment_reduce_stub);
+
+}} // at::native
@@ -148,6 +148,10 @@ void _cufft_clear_plan_cache(int64_t device_index) {
   detail::getCUDAHooks().cuFFTClearPlanCache(device_index);
 }
 
+int64_t _cufft_get_plan_cache_padded_size(int64_t device_index, int64_t signal_size, double max_padding) {
+  return detail::getCUDAHooks().cuFFTGetPlanCachePaddedSize(device_index, signal_size, max_padding);
+}
+
 Tensor fft(const Tensor& self, const int64_t signal_ndim, const bool normalized) {
   return _fft(self, signal_ndim, /* complex_input */ true,
               /* complex_output */ true, /* inverse */ false, {}, normalized,
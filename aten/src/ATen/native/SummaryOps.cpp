@@ -2,11 +2,57 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace at { namespace native {
 
+namespace {
+
+// Adds to hist_p (nbins, zeroed) the histogram of [0, n) computed by
+// add(hist, begin, end). Large inputs are split in chunks which each fill
+// their own histogram, and the chunk histograms are then summed bin by bin in
+// chunk order, so the result doesn't depend on the number of threads running.
+template <typename hist_t, typename partial_t, typename func_t>
+void parallel_histogram(hist_t* hist_p, int64_t nbins, int64_t n, const func_t& add) {
+  // A chunk has to be worth the cost of zeroing and merging its histogram.
+  const int64_t num_chunks = std::min<int64_t>(
+      at::get_num_threads(), n / std::max(nbins, at::internal::GRAIN_SIZE));
+  if (num_chunks <= 1) {
+    if (std::is_same<hist_t, partial_t>::value) {
+      add(reinterpret_cast<partial_t*>(hist_p), 0, n);
+      return;
+    }
+    std::vector<partial_t> partial(nbins, 0);
+    add(partial.data(), 0, n);
+    for (int64_t b = 0; b < nbins; b++) {
+      hist_p[b] += static_cast<hist_t>(partial[b]);
+    }
+    return;
+  }
+
+  std::vector<partial_t> partials(num_chunks * nbins, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      add(partials.data() + c * nbins, c * n / num_chunks, (c + 1) * n / num_chunks);
+    }
+  });
+  at::parallel_for(0, nbins, at::internal::GRAIN_SIZE / num_chunks, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      partial_t sum = 0;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        sum += partials[c * nbins + b];
+      }
+      hist_p[b] += static_cast<hist_t>(sum);
+    }
+  });
+}
+
+} // namespace
+
 ///////////////// bincount /////////////////
 namespace {
 
@@ -40,15 +86,21 @@ Tensor _bincount_cpu_template(
     output = native::zeros({nbins}, weights.options());
     weights_t* output_p = output.data_ptr<weights_t>();
     const weights_t* weights_p = weights.data_ptr<weights_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += weights_p[i];
-    }
+    parallel_histogram<weights_t, weights_t>(
+        output_p, nbins, self_size, [&](weights_t* hist, int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            hist[self_p[i]] += weights_p[i];
+          }
+        });
   } else {
     output = native::zeros({nbins}, kLong);
     int64_t* output_p = output.data_ptr<int64_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += 1L;
-    }
+    parallel_histogram<int64_t, int64_t>(
+        output_p, nbins, self_size, [&](int64_t* hist, int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            hist[self_p[i]] += 1L;
+          }
+        });
   }
   return output;
 }
@@ -65,4 +117,79 @@ _bincount_cpu(const Tensor& self, const Tensor& weights, int64_t minlength) {
   });
 }
 
+///////////////// histc /////////////////
+namespace {
+
+template <typename input_t>
+void _histc_cpu_template(
+    Tensor& hist,
+    const Tensor& self,
+    int64_t nbins,
+    input_t min,
+    input_t max) {
+  if (nbins <= 0) {
+    AT_ERROR("bins must be > 0");
+  }
+  hist.resize_({nbins});
+  hist.zero_();
+  input_t minvalue = min;
+  input_t maxvalue = max;
+  if (min == max) {
+    minvalue = self.min().item<input_t>();
+    maxvalue = self.max().item<input_t>();
+  }
+  if (minvalue == maxvalue) {
+    minvalue = minvalue - 1;
+    maxvalue = maxvalue + 1;
+  }
+
+  TORCH_CHECK(
+      !(std::isinf(minvalue) || std::isinf(maxvalue) || std::isnan(minvalue) ||
+        std::isnan(maxvalue)),
+      "range of [",
+      minvalue,
+      ", ",
+      maxvalue,
+      "] is not finite");
+  TORCH_CHECK(minvalue < maxvalue, "max must be larger than min");
+
+  const Tensor self_contiguous = self.contiguous();
+  const input_t* self_p = self_contiguous.data_ptr<input_t>();
+  // Counted as integers, which stay exact past 2^24 elements in a float bin.
+  parallel_histogram<input_t, int64_t>(
+      hist.data_ptr<input_t>(),
+      nbins,
+      self_contiguous.numel(),
+      [&](int64_t* counts, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const input_t value = self_p[i];
+          if (value >= minvalue && value <= maxvalue) {
+            const int64_t bin = static_cast<int64_t>((value - minvalue) / (maxvalue - minvalue) * nbins);
+            counts[std::min(bin, nbins - 1)] += 1;
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& _histc_out_cpu(Tensor& result, const Tensor& self, int64_t bins, Scalar min, Scalar max) {
+  TORCH_CHECK(
+      result.scalar_type() == self.scalar_type(),
+      "histc: expected an output of dtype ",
+      self.scalar_type(),
+      ", but got ",
+      result.scalar_type());
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histc_cpu", [&] {
+    _histc_cpu_template<scalar_t>(result, self, bins, min.to<scalar_t>(), max.to<scalar_t>());
+  });
+  return result;
+}
+
+Tensor _histc_cpu(const Tensor& self, int64_t bins, Scalar min, Scalar max) {
+  Tensor result = at::empty({0}, self.options());
+  _histc_out_cpu(result, self, bins, min, max);
+  return result;
+}
+
 }} // namespace at::native
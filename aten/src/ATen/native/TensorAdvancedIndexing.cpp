@@ -75,6 +75,7 @@ DEFINE_DISPATCH(masked_select_serial_stub);
 DEFINE_DISPATCH(masked_select_stub);
 
 DEFINE_DISPATCH(gather_stub);
+DEFINE_DISPATCH(index_select_contiguous_stub);
 DEFINE_DISPATCH(scatter_stub);
 DEFINE_DISPATCH(scatter_fill_stub);
 DEFINE_DISPATCH(scatter_add_stub);
@@ -466,18 +467,9 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
     if (slice_size >= grain_size) {
       outer_loop(0, numel);
     } else {
-      // use a fast loop when self and result are contiguous and of the same data type
+      // use a fast kernel when self and result are contiguous and of the same data type
       if (iter.is_contiguous() && self.scalar_type() == result.scalar_type()) {
-        auto slice_size_bytes = slice_size * elementSize(self.scalar_type());
-        at::parallel_for(0, numel, grain_size / slice_size, [&](int64_t start, int64_t end) {
-          for (int64_t i = start; i < end; i++) {
-            auto self_i = index_data[i];
-            TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_dim_size), "index out of range in self");
-            auto self_data = static_cast<char*>(selfSlice_data) + self_i * self_stride_bytes;
-            auto result_data = static_cast<char*>(resultSlice_data) + i * result_stride_bytes;
-            memcpy(result_data, self_data, slice_size_bytes);
-          }
-        });
+        index_select_contiguous_stub(kCPU, result, self, dim, index_contig);
       } else {
         at::parallel_for(0, numel, grain_size / slice_size, outer_loop);
       }
@@ -485,6 +477,13 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
   } else {
     TORCH_CHECK(result.dim() <= 1, "result.dim() (", result.dim(), ") must one or zero for given self.dim() (", self.dim(), ")");
 
+    if (self.dim() == 1 && self.stride(0) == 1 && result.stride(0) == 1) {
+      if (numel > 0) {
+        index_select_contiguous_stub(kCPU, result, self, dim, index_contig);
+      }
+      return result;
+    }
+
     AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "index_select", [&] {
       auto self_stride = self.dim() == 0 ? 1 : self.stride(dim);
       auto result_stride = result.dim() == 0 ? 1 : result.stride(dim);
@@ -121,10 +121,10 @@ Tensor empty_cpu(IntArrayRef size, const TensorOptions& options_, c10::optional<
   int64_t nelements = prod_intlist(size);
   auto dtype = options.dtype();
   int64_t size_bytes = nelements * dtype.itemsize();
+  // Lets StorageImpl keep small tensors inline.
   auto storage_impl = c10::make_intrusive<StorageImpl>(
       c10::StorageImpl::use_byte_size_t(),
       size_bytes,
-      allocator->allocate(size_bytes),
       allocator,
       /*resizeable=*/true);
 
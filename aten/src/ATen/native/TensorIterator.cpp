@@ -1,6 +1,9 @@
 #include <ATen/native/TensorIterator.h>
 
 #include <array>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/TypeProperties.h>
@@ -1126,6 +1129,166 @@ TensorIterator::TensorIterator(TensorIteratorConfig& config) {
   build(config);
 }
 
+// Note [TensorIterator setup cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Most of build() only looks at the geometry of the operands: broadcasting
+// the shapes, computing byte strides, reordering and coalescing dimensions
+// and choosing the layout of allocated outputs. When the same op is called
+// over and over on operands with the same sizes, strides, dtypes and devices,
+// that work produces the same result every time, and for small tensors it can
+// cost more than the kernel itself.
+//
+// When the setup cache is enabled, build() packs everything that this geometry
+// depends on into a key (see compute_setup_cache_key) and looks it up in a
+// small thread-local cache. On a hit, compute_shape() and the fast_set_up() /
+// compute_strides() / reorder_dimensions() / allocate_outputs() /
+// coalesce_dimensions() sequence are replaced by copying the cached results
+// (see apply_setup_cache_entry); outputs are still freshly allocated with the
+// cached sizes and strides. Everything that depends on the tensors themselves
+// rather than on their geometry (output marking, memory overlap checks, name
+// inference, output resizing and type computation) always runs.
+//
+// Iterators with a static shape are never cached. The cache is disabled by
+// default; enabling it and reading its hit/miss counters is done through the
+// static TensorIterator::*setup_cache* functions.
+
+struct TensorIterator::SetupCacheEntry {
+  std::vector<int64_t> key;
+  // Results of compute_shape()
+  DimVector broadcast_shape;
+  bool all_ops_same_shape;
+  // Results of the fast or slow setup path
+  DimVector shape;
+  DimVector perm;
+  bool has_coalesced_dimensions;
+  SmallVector<StrideVector, 4> stride_bytes;
+  // Outputs allocated by the iterator, in the order of the outputs. Outputs
+  // that were passed in have allocated == false.
+  struct Output {
+    bool allocated = false;
+    DimVector sizes;
+    DimVector strides;
+  };
+  SmallVector<Output, 1> outputs;
+};
+
+namespace {
+
+using SetupCacheKey = SmallVector<int64_t, 64>;
+
+// Bounds the memory held by each thread's cache; a full cache is cleared.
+constexpr size_t kMaxSetupCacheEntries = 512;
+
+std::atomic<bool> setup_cache_enabled_{false};
+std::atomic<int64_t> setup_cache_hits_{0};
+std::atomic<int64_t> setup_cache_misses_{0};
+
+size_t hash_setup_cache_key(ArrayRef<int64_t> key) {
+  size_t seed = key.size();
+  for (int64_t v : key) {
+    seed ^= std::hash<int64_t>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+// Entries are keyed by hash; the full key stored in the entry is compared on
+// lookup, and a colliding key simply replaces the old entry. Entries are
+// handed out as shared_ptrs because building an iterator can build other
+// iterators (e.g. when promoting inputs) that modify the cache.
+using SetupCache =
+    std::unordered_map<size_t, std::shared_ptr<const TensorIterator::SetupCacheEntry>>;
+
+SetupCache& thread_setup_cache() {
+  static thread_local SetupCache cache;
+  return cache;
+}
+
+} // namespace
+
+void TensorIterator::set_setup_cache_enabled(bool enabled) {
+  setup_cache_enabled_.store(enabled);
+}
+
+bool TensorIterator::setup_cache_enabled() {
+  return setup_cache_enabled_.load(std::memory_order_relaxed);
+}
+
+TensorIterator::SetupCacheStats TensorIterator::setup_cache_stats() {
+  SetupCacheStats stats;
+  stats.hits = setup_cache_hits_.load();
+  stats.misses = setup_cache_misses_.load();
+  return stats;
+}
+
+void TensorIterator::reset_setup_cache_stats() {
+  setup_cache_hits_.store(0);
+  setup_cache_misses_.store(0);
+}
+
+bool TensorIterator::compute_setup_cache_key(const TensorIteratorConfig& config, SmallVectorImpl<int64_t>& key) const {
+  if (config.static_shape_.has_value()) {
+    return false;
+  }
+  int64_t flags = 0;
+  for (bool flag : {config.check_mem_overlap_, config.allow_cpu_scalars_,
+                    config.is_reduction_, config.resize_outputs_,
+                    config.check_all_same_dtype_, config.check_all_same_device_,
+                    config.enforce_safe_casting_to_output_,
+                    config.promote_inputs_to_common_dtype_,
+                    config.cast_common_dtype_to_outputs_}) {
+    flags = (flags << 1) | flag;
+  }
+  key.push_back(flags);
+  if (config.static_dtype_and_device_.has_value()) {
+    const auto& static_dtype_and_device = *config.static_dtype_and_device_;
+    key.push_back(static_cast<int64_t>(static_dtype_and_device.first));
+    key.push_back(static_cast<int64_t>(static_dtype_and_device.second.type()));
+    key.push_back(static_dtype_and_device.second.index());
+  } else {
+    key.push_back(-1);
+  }
+  key.push_back(num_outputs_);
+  key.push_back(ntensors());
+  for (const auto& op : operands_) {
+    key.push_back(static_cast<int64_t>(op.target_dtype));
+    key.push_back(static_cast<int64_t>(op.device.type()));
+    key.push_back(op.device.index());
+    key.push_back(op.is_read_write);
+    if (!op.tensor.defined()) {
+      key.push_back(-1);
+      continue;
+    }
+    // Wrapped numbers take part in type promotion differently, which can
+    // change the dtype (and hence the strides) of temporaries.
+    key.push_back(op.tensor.unsafeGetTensorImpl()->is_wrapped_number());
+    key.push_back(static_cast<int64_t>(op.current_dtype));
+    key.push_back(op.tensor.dim());
+    auto sizes = op.tensor.sizes();
+    key.append(sizes.begin(), sizes.end());
+    auto strides = op.tensor.strides();
+    key.append(strides.begin(), strides.end());
+  }
+  return true;
+}
+
+void TensorIterator::apply_setup_cache_entry(const SetupCacheEntry& entry) {
+  for (int i = 0; i < num_outputs_; i++) {
+    auto& op = operands_[i];
+    const auto& output = entry.outputs[i];
+    if (output.allocated) {
+      TORCH_INTERNAL_ASSERT(!op.tensor.defined() && op.is_type_defined(), "no type for operand", i);
+      op.tensor = at::empty_strided(output.sizes, output.strides, op.options());
+      op.current_dtype = op.target_dtype;
+    }
+  }
+  shape_ = entry.shape;
+  perm_ = entry.perm;
+  has_coalesced_dimensions_ = entry.has_coalesced_dimensions;
+  for (int i = 0; i < ntensors(); i++) {
+    operands_[i].stride_bytes = entry.stride_bytes[i];
+  }
+}
+
 void TensorIterator::build(TensorIteratorConfig& config) {
   // populate some persistent configuration fields
   is_reduction_ = config.is_reduction_;
@@ -1139,22 +1302,77 @@ void TensorIterator::build(TensorIteratorConfig& config) {
   compute_mem_overlaps(config);
   // Check that input dimensions are aligned correctly & compute outnames.
   compute_names(config);
-  // compute the broadcasted shape
-  compute_shape(config);
+  // look up the geometry in the setup cache
+  // See Note [TensorIterator setup cache]
+  SetupCacheKey key;
+  std::shared_ptr<const SetupCacheEntry> cached;
+  const bool use_cache = setup_cache_enabled() && compute_setup_cache_key(config, key);
+  if (use_cache) {
+    auto& cache = thread_setup_cache();
+    auto it = cache.find(hash_setup_cache_key(key));
+    if (it != cache.end() && ArrayRef<int64_t>(it->second->key).equals(key)) {
+      cached = it->second;
+      setup_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      setup_cache_misses_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (cached) {
+    shape_ = cached->broadcast_shape;
+    all_ops_same_shape_ = cached->all_ops_same_shape;
+  } else {
+    // compute the broadcasted shape
+    compute_shape(config);
+  }
   // resize outputs if necessary
   resize_outputs(config);
   // compute the result dtype and device
   compute_types(config);
-  // try fast setup output tensor, if failed, fallback to normal setup
-  if (!fast_set_up(config)) {
-    // compute each tensor's stride after broadcasting
-    compute_strides(config);
-    // re-order dimensions to improve coalescing
-    reorder_dimensions(config);
-    // allocate the output tensor if it's not provided
-    allocate_outputs();
-    // coalesce adjacent dimensions when possible
-    coalesce_dimensions();
+  if (cached) {
+    apply_setup_cache_entry(*cached);
+  } else {
+    std::shared_ptr<SetupCacheEntry> entry;
+    if (use_cache) {
+      entry = std::make_shared<SetupCacheEntry>();
+      entry->key.assign(key.begin(), key.end());
+      entry->broadcast_shape = shape_;
+      entry->all_ops_same_shape = all_ops_same_shape_;
+      entry->outputs.resize(num_outputs_);
+      for (int i = 0; i < num_outputs_; i++) {
+        entry->outputs[i].allocated = !operands_[i].tensor.defined();
+      }
+    }
+    // try fast setup output tensor, if failed, fallback to normal setup
+    if (!fast_set_up(config)) {
+      // compute each tensor's stride after broadcasting
+      compute_strides(config);
+      // re-order dimensions to improve coalescing
+      reorder_dimensions(config);
+      // allocate the output tensor if it's not provided
+      allocate_outputs();
+      // coalesce adjacent dimensions when possible
+      coalesce_dimensions();
+    }
+    if (entry) {
+      for (int i = 0; i < num_outputs_; i++) {
+        auto& output = entry->outputs[i];
+        if (output.allocated) {
+          output.sizes = operands_[i].tensor.sizes();
+          output.strides = operands_[i].tensor.strides();
+        }
+      }
+      entry->shape = shape_;
+      entry->perm = perm_;
+      entry->has_coalesced_dimensions = has_coalesced_dimensions_;
+      for (const auto& op : operands_) {
+        entry->stride_bytes.push_back(op.stride_bytes);
+      }
+      auto& cache = thread_setup_cache();
+      if (cache.size() >= kMaxSetupCacheEntries) {
+        cache.clear();
+      }
+      cache[hash_setup_cache_key(key)] = std::move(entry);
+    }
   }
   // perform name inference
   propagate_names_to_outputs();
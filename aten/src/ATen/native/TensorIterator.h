@@ -164,6 +164,19 @@ struct CAFFE2_API TensorIterator {
   static TensorIterator reduce_op(Tensor& out, const Tensor& a);
   static TensorIterator reduce_op(Tensor& out1, Tensor& out2, const Tensor& a);
 
+  /// Setup cache, see Note [TensorIterator setup cache]. Disabled by default.
+  struct SetupCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+  };
+  static void set_setup_cache_enabled(bool enabled);
+  static bool setup_cache_enabled();
+  /// Hits and misses summed over all threads since the last reset.
+  static SetupCacheStats setup_cache_stats();
+  static void reset_setup_cache_stats();
+  /// Defined in TensorIterator.cpp.
+  struct SetupCacheEntry;
+
   int ndim() const { return shape_.size(); }
   IntArrayRef shape() const { return shape_; }
   int64_t numel() const;
@@ -320,6 +333,8 @@ protected:
   bool requires_channels_last_2d_output();
   bool requires_channels_last_3d_output();
 
+  bool compute_setup_cache_key(const TensorIteratorConfig&, SmallVectorImpl<int64_t>& key) const;
+  void apply_setup_cache_entry(const SetupCacheEntry&);
 
 protected:
 
@@ -9,25 +9,68 @@ namespace at {
 
 using loop2d_t = TensorIterator::loop2d_t;
 
-static bool use_two_pass_reduction(TensorIterator& iter);
+namespace {
+
+/// The ways parallel_reduce splits a reduction between threads:
+///  - SplitOutputs: every thread reduces a range of the output elements.
+///  - SplitReduction: every thread reduces a range of the input into its own
+///    copy of the output, and the copies are reduced at the end.
+///  - Blocked2D: the output elements are split into column blocks and the
+///    reduced dimension into row groups, and every thread reduces one block of
+///    one group into the copy of the output of that group.
+enum class ReductionStrategy { SplitOutputs, SplitReduction, Blocked2D };
+
+struct ReductionPlan {
+  ReductionStrategy strategy;
+  // For Blocked2D: the dimensions that are split and in how many pieces
+  int split_dim = -1;
+  int64_t cols_per_task = 1;
+  int64_t col_tasks = 1;
+  int reduced_dim = -1;
+  int64_t row_groups = 1;
+};
+
+} // namespace
+
+static ReductionPlan plan_parallel_reduction(TensorIterator& iter);
 static void two_pass_reduction(TensorIterator& iter, loop2d_t loop);
 static void parallel_dim_reduction(TensorIterator& iter, loop2d_t loop);
+static void blocked_reduction(
+    TensorIterator& iter, loop2d_t loop, const ReductionPlan& plan);
 
 void TensorIterator::parallel_reduce(loop2d_t loop) {
   TORCH_CHECK(ntensors() == 2, "parallel_reduce only supports one input and one output");
   int64_t numel = this->numel();
   if (numel < at::internal::GRAIN_SIZE || at::get_num_threads() == 1 ||
-      at::in_parallel_region()) {
+      at::internal::_in_serial_region()) {
     serial_for_each(loop, {0, numel});
-  } else if (use_two_pass_reduction(*this)) {
-    two_pass_reduction(*this, loop);
-  } else {
-    parallel_dim_reduction(*this, loop);
+    return;
+  }
+  auto plan = plan_parallel_reduction(*this);
+  switch (plan.strategy) {
+    case ReductionStrategy::SplitReduction:
+      two_pass_reduction(*this, loop);
+      break;
+    case ReductionStrategy::Blocked2D:
+      blocked_reduction(*this, loop, plan);
+      break;
+    case ReductionStrategy::SplitOutputs:
+      parallel_dim_reduction(*this, loop);
+      break;
   }
 }
 
-static bool use_two_pass_reduction(TensorIterator& iter) {
-  return iter.output(0).numel() == 1;
+/// Reduces the partial outputs in buffer, stacked along its first dimension,
+/// into dst. Only the outputs are split, as splitting the linear range would
+/// let two threads accumulate into the same output element.
+static void reduce_partial_outputs(const Tensor& dst, const Tensor& buffer, loop2d_t loop) {
+  auto unsqueezed = dst.unsqueeze(0);
+  auto final_reduce = TensorIterator::reduce_op(unsqueezed, buffer);
+  if (dst.numel() == 1 || final_reduce.numel() < at::internal::GRAIN_SIZE) {
+    final_reduce.serial_for_each(loop, {0, final_reduce.numel()});
+  } else {
+    parallel_dim_reduction(final_reduce, loop);
+  }
 }
 
 static void two_pass_reduction(TensorIterator& iter, loop2d_t loop) {
@@ -58,9 +101,7 @@ static void two_pass_reduction(TensorIterator& iter, loop2d_t loop) {
     }
   }
 
-  auto unsqueezed = dst.unsqueeze(0);
-  auto final_reduce = TensorIterator::reduce_op(unsqueezed, buffer);
-  final_reduce.for_each(loop);
+  reduce_partial_outputs(dst, buffer, loop);
 }
 
 /// Chooses a dimension over which to parallelize. Prefers the outer-most
@@ -93,6 +134,81 @@ round_columns(TensorIterator& iter, int dim, int multiple, int64_t begin, int64_
   return std::make_tuple(begin, end);
 }
 
+/// The columns of dim per task when splitting it into at most max_tasks,
+/// rounded to multiples of 128 bytes if adjacent columns are contiguous in
+/// memory, as parallel_dim_reduction does.
+static int64_t column_block_size(TensorIterator& iter, int dim, int64_t max_tasks) {
+  int64_t cols = iter.shape()[dim];
+  int element_size = iter.element_size(/*arg=*/1);
+  int64_t multiple = 1;
+  if (iter.strides(1)[dim] == element_size) {
+    multiple = std::max<int64_t>(128 / element_size, 1);
+  }
+  return divup(divup(cols, max_tasks), multiple) * multiple;
+}
+
+/// The largest reduced dimension, or -1 if there is none to split.
+static int find_reduced_split_dim(TensorIterator& iter) {
+  auto shape = iter.shape();
+  int best_dim = -1;
+  for (int dim = 0; dim < iter.ndim(); dim++) {
+    if (iter.is_dim_reduced(dim) && shape[dim] > 1 &&
+        (best_dim < 0 || shape[dim] > shape[best_dim])) {
+      best_dim = dim;
+    }
+  }
+  return best_dim;
+}
+
+/// Partial outputs are only worth it while they are small next to the input:
+/// every copy costs a write of every output element, and a read of it in the
+/// final reduction, so each one should stand for at least this many input
+/// elements per output element.
+constexpr int64_t kMinInputPerPartialOutput = 16;
+
+/// A cost model choosing between the strategies. Splitting the outputs needs
+/// no extra memory, so it is used as long as it keeps every thread busy. When
+/// there are fewer output columns than threads (reducing the inner dimension
+/// of a tall-skinny tensor, or reducing all but a few elements), the reduction
+/// itself is split as well, across all threads if the copies of the output
+/// stay small, and otherwise into as many row groups as the idle threads need.
+static ReductionPlan plan_parallel_reduction(TensorIterator& iter) {
+  const int64_t num_threads = at::get_num_threads();
+  const int64_t numel = iter.numel();
+  const int64_t num_outputs = iter.output(0).numel();
+  if (num_outputs == 1) {
+    return {ReductionStrategy::SplitReduction};
+  }
+
+  ReductionPlan plan{ReductionStrategy::SplitOutputs};
+  plan.split_dim = find_split_dim(iter);
+  plan.cols_per_task = column_block_size(iter, plan.split_dim, num_threads);
+  plan.col_tasks = divup(iter.shape()[plan.split_dim], plan.cols_per_task);
+  if (plan.col_tasks >= num_threads) {
+    return plan;
+  }
+
+  const int64_t max_partial_outputs =
+      numel / (num_outputs * kMinInputPerPartialOutput);
+  if (max_partial_outputs >= num_threads) {
+    plan.strategy = ReductionStrategy::SplitReduction;
+    return plan;
+  }
+
+  plan.reduced_dim = find_reduced_split_dim(iter);
+  if (plan.reduced_dim < 0) {
+    return plan;
+  }
+  plan.row_groups = std::min({
+      divup(num_threads, plan.col_tasks),
+      max_partial_outputs,
+      iter.shape()[plan.reduced_dim]});
+  if (plan.row_groups > 1) {
+    plan.strategy = ReductionStrategy::Blocked2D;
+  }
+  return plan;
+}
+
 static void parallel_dim_reduction(TensorIterator& iter, loop2d_t loop) {
   AT_ASSERT(iter.ndim() >= 1);
   int dim = find_split_dim(iter);
@@ -116,6 +232,46 @@ static void parallel_dim_reduction(TensorIterator& iter, loop2d_t loop) {
   });
 }
 
+static void blocked_reduction(
+    TensorIterator& iter, loop2d_t loop, const ReductionPlan& plan) {
+  auto dst = iter.output(0);
+  auto buffer_shape = DimVector(dst.sizes());
+  buffer_shape.insert(buffer_shape.begin(), plan.row_groups);
+  auto buffer = at::empty(buffer_shape, dst.options());
+  buffer.copy_(dst.unsqueeze(0));
+
+  // The slices of the buffer are laid out alike, so the iterators over them
+  // all order their dimensions the same way. The plan's dimensions are those
+  // of iter, so they can only be reused if that order is iter's as well.
+  auto probe = TensorIterator::reduce_op(buffer[0], iter.input(0));
+  if (probe.shape() != iter.shape() || probe.strides(1) != iter.strides(1)) {
+    two_pass_reduction(iter, loop);
+    return;
+  }
+
+  const int64_t cols = iter.shape()[plan.split_dim];
+  const int64_t rows = iter.shape()[plan.reduced_dim];
+  const int64_t rows_per_group = divup(rows, plan.row_groups);
+  at::parallel_for(0, plan.col_tasks * plan.row_groups, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t task = begin; task < end; task++) {
+      const int64_t group = task / plan.col_tasks;
+      const int64_t col_begin = (task % plan.col_tasks) * plan.cols_per_task;
+      const int64_t row_begin = group * rows_per_group;
+      if (col_begin >= cols || row_begin >= rows) {
+        continue;
+      }
+      auto sub_iter = TensorIterator::reduce_op(buffer[group], iter.input(0));
+      sub_iter.narrow(
+          plan.split_dim, col_begin, std::min(plan.cols_per_task, cols - col_begin));
+      sub_iter.narrow(
+          plan.reduced_dim, row_begin, std::min(rows_per_group, rows - row_begin));
+      sub_iter.serial_for_each(loop, {0, sub_iter.numel()});
+    }
+  });
+
+  reduce_partial_outputs(dst, buffer, loop);
+}
+
 void TensorIterator::foreach_reduced_elt(loop_subiter_t loop, bool parallelize) {
   AT_ASSERT(ninputs() == 1);
   AT_ASSERT(noutputs() >= 1);
@@ -128,7 +284,7 @@ void TensorIterator::foreach_reduced_elt(loop_subiter_t loop, bool parallelize)
     loop(*this);
   }
   else if (numel() < at::internal::GRAIN_SIZE || at::get_num_threads() == 1 ||
-      at::in_parallel_region() || !parallelize) {
+      at::internal::_in_serial_region() || !parallelize) {
     auto reduce_dims = num_reduce_dims();
 
     auto non_reduced_shape = shape.slice(reduce_dims, shape.size() - reduce_dims);
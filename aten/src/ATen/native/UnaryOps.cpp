@@ -59,6 +59,19 @@ static inline Tensor& unary_op_impl_with_complex_to_float_out(Tensor& result, co
             "result type ", float_type, " can't be cast to the desired output type ",
             result.scalar_type());
 
+      // The CPU kernels write the real values straight into a result of the
+      // value type
+      if (self.device().is_cpu() && result.scalar_type() == float_type) {
+        auto iter = TensorIteratorConfig()
+          .set_check_mem_overlap(true)
+          .add_output(result)
+          .add_input(self)
+          .check_all_same_dtype(false)
+          .build();
+        stub(iter.device_type(), iter);
+        return result;
+      }
+
       // Runs the function complex->complex, as TensorIterator expects
       Tensor complex_result = at::empty({0}, self.options());
       auto iter = TensorIterator::unary_op(complex_result, self,
@@ -4,5 +4,6 @@ namespace at { namespace native {
 
 DEFINE_DISPATCH(unfolded2d_copy_stub);
 DEFINE_DISPATCH(unfolded2d_acc_stub);
+DEFINE_DISPATCH(unfolded2d_copy_rows_stub);
 
 }}
@@ -25,4 +25,27 @@ using unfold2d_fn =
 DECLARE_DISPATCH(unfold2d_fn, unfolded2d_copy_stub);
 DECLARE_DISPATCH(unfold2d_fn, unfolded2d_acc_stub);
 
+// Same as unfolded2d_copy_stub, for the columns of finput of the output rows
+// [output_row_begin, output_row_end) only.
+using unfold2d_rows_fn =
+    void (*)(
+    Tensor& finput,
+    Tensor& input,
+    int64_t kH,
+    int64_t kW,
+    int64_t dH,
+    int64_t dW,
+    int64_t padH,
+    int64_t padW,
+    int64_t n_input_plane,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t output_height,
+    int64_t output_width,
+    int64_t output_row_begin,
+    int64_t output_row_end
+);
+
+DECLARE_DISPATCH(unfold2d_rows_fn, unfolded2d_copy_rows_stub);
+
 }} // namespace at::native
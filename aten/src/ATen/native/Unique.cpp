@@ -2,17 +2,26 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <c10/util/flat_hash_map.h>
 
+#include <numeric>
 #include <set>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Inputs are split into at most one chunk per thread, of at least
+// GRAIN_SIZE elements. The number of chunks only depends on numel, so that
+// passes over the same chunks can be split in the same way.
+inline int64_t unique_chunk_size(int64_t numel) {
+  return std::max<int64_t>(
+      internal::GRAIN_SIZE, divup(numel, at::get_num_threads()));
+}
+
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -26,7 +35,24 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
+  // Each chunk is deduplicated into its own table, then the tables are
+  // merged, which only touches the unique elements.
+  const int64_t chunk_size = unique_chunk_size(numel);
+  const int64_t num_chunks = divup(numel, chunk_size);
+  std::vector<ska::flat_hash_set<scalar_t>> chunk_sets(std::max<int64_t>(num_chunks, 1));
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      auto* first = input_data + c * chunk_size;
+      auto* last = input_data + std::min(numel, (c + 1) * chunk_size);
+      chunk_sets[c].insert(first, last);
+    }
+  });
+  ska::flat_hash_set<scalar_t>& set = chunk_sets[0];
+  for (int64_t c = 1; c < num_chunks; c++) {
+    set.insert(chunk_sets[c].begin(), chunk_sets[c].end());
+    chunk_sets[c].clear();
+  }
+
   output = at::empty({static_cast<int64_t>(set.size())}, input.options());
   scalar_t *output_data = output.data_ptr<scalar_t>();
 
@@ -41,28 +67,25 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   if (return_inverse || return_counts) {
     inverse_indices.resize_(input.sizes());
     int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
+    ska::flat_hash_map<scalar_t, int64_t> inverse_map;
     inverse_map.reserve(output.numel());
     for (int64_t i = 0; i < output.numel(); ++i) {
       inverse_map[output_data[i]] = i;
     }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
-    }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
-      }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    // the map is only read from here on, so it is shared by the threads
+    at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        // NaNs are never found, and as before map to 0
+        auto it = inverse_map.find(input_data[i]);
+        inverse_indices_data[i] = it == inverse_map.end() ? 0 : it->second;
       }
+    });
+    if (return_counts) {
       counts.resize_(output.sizes());
       counts.fill_(0);
       int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+      for (int64_t i = 0; i < numel; i++) {
+        counts_data[inverse_indices_data[i]] += 1;
       }
     }
   }
@@ -87,33 +110,50 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
 
   if (numel > 0) {
     scalar_t *output_data = output.data_ptr<scalar_t>();
-    int64_t *inverse_data = inverse_indices.data_ptr<int64_t>();;
-    int64_t *counts_data = nullptr;
-    *output_data = *input_data;
-
-    if (return_counts) {
-      counts.resize_({numel});
-      counts_data = counts.data_ptr<int64_t>();
-    }
-    scalar_t *p = output_data;
-    int64_t *q = counts_data;
-    int64_t last = 0;
-    for (int64_t i = 0; i < numel; i++) {
-      if (input_data[i] != *p) {
-        *(++p) = input_data[i];
-        if (return_counts) {
-          *(q++) = i - last;
-          last = i;
+    int64_t *inverse_data = inverse_indices.data_ptr<int64_t>();
+
+    // An element starts a run when it differs from the previous one. The
+    // runs starting in each chunk are counted first, which gives the output
+    // position of the first run of every chunk, then the chunks are written
+    // independently.
+    const int64_t chunk_size = unique_chunk_size(numel);
+    const int64_t num_chunks = divup(numel, chunk_size);
+    std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t runs = 0;
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          runs += i == 0 || input_data[i] != input_data[i - 1];
         }
+        chunk_offsets[c + 1] = runs;
       }
-      if (return_inverse) {
-        inverse_data[i] = p - output_data;
+    });
+    std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+    int64_t output_size = chunk_offsets[num_chunks];
+
+    std::vector<int64_t> run_starts(return_counts ? output_size + 1 : 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t p = chunk_offsets[c] - 1;
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          if (i == 0 || input_data[i] != input_data[i - 1]) {
+            output_data[++p] = input_data[i];
+            if (return_counts) {
+              run_starts[p] = i;
+            }
+          }
+          if (return_inverse) {
+            inverse_data[i] = p;
+          }
+        }
       }
-    }
-    int64_t output_size = p - output_data + 1;
+    });
+
     if (return_counts) {
-      *q = numel - last;
+      run_starts[output_size] = numel;
       counts.resize_({output_size});
+      int64_t *counts_data = counts.data_ptr<int64_t>();
+      std::adjacent_difference(run_starts.begin() + 1, run_starts.end(), counts_data);
     }
     output.resize_({output_size});
   }
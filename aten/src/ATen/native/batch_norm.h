@@ -12,6 +12,13 @@ using batch_norm_fn = void (*)(Tensor&, const Tensor&, const Tensor&,
 
 DECLARE_DISPATCH(batch_norm_fn, batch_norm_cpu_inference_contiguous_stub);
 
+// output(n, h, w, c) = input(n, h, w, c) * alpha(c) + beta(c), for input and
+// output in channels last memory format.
+using batch_norm_transform_fn = void (*)(Tensor&, const Tensor&, const Tensor&,
+    const Tensor&);
+
+DECLARE_DISPATCH(batch_norm_transform_fn, batch_norm_cpu_channels_last_stub);
+
 } // namespace native
 
 } // namespace at
@@ -1,67 +1,73 @@
 #include <ATen/ATen.h>
 
-#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/cpu/CatKernel.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cstring>
 
 namespace at { namespace native {
 
 namespace {
 
 struct InputMeta {
-  void* data_ptr;
+  const char* data_ptr;
+  // bytes of the input in one slice of the outer dimensions
   int64_t inner_size;
 
   InputMeta(const Tensor& t, int64_t dim, int64_t inner)
-    : data_ptr(t.data_ptr())
+    : data_ptr(static_cast<const char*>(t.data_ptr()))
     , inner_size(t.size(dim) * inner) {}
 };
 
-template <typename scalar_t>
-void cat_serial_kernel_impl(Tensor& result, TensorList tensors, int64_t dim) {
-  int64_t outer = result.numel() / (result.size(dim) * result.stride(dim));
-  scalar_t* result_data = result.data_ptr<scalar_t>();
-  int64_t ninputs = tensors.size();
+// The result is a sequence of `outer` rows, each of which is the inner block
+// of every input in turn. Its bytes are split evenly across the threads and
+// every thread memcpys the pieces of the blocks that fall in its range, so a
+// single parallel_for covers any number of inputs, of any size.
+void cat_contiguous_kernel(Tensor& result, TensorList tensors, int64_t dim) {
+  const int64_t element_size = result.element_size();
+  const int64_t outer = result.numel() / (result.size(dim) * result.stride(dim));
+  const int64_t inner = result.stride(dim) * element_size;
   std::vector<InputMeta> inputs;
-  inputs.reserve(ninputs);
+  // offsets[j] is the position of input j in a row of the result
+  std::vector<int64_t> offsets;
+  inputs.reserve(tensors.size());
+  offsets.reserve(tensors.size());
+  int64_t row_size = 0;
   for (auto const &tensor : tensors) {
-    inputs.emplace_back(tensor, dim, result.stride(dim));
+    if (tensor.numel() == 0) {
+      continue;
+    }
+    inputs.emplace_back(tensor, dim, inner);
+    offsets.push_back(row_size);
+    row_size += inputs.back().inner_size;
   }
+  const int64_t ninputs = inputs.size();
+  char* result_data = static_cast<char*>(result.data_ptr());
 
-  using Vec = vec256::Vec256<scalar_t>;
-  scalar_t* result_ptr = result_data;
-  for (int64_t i = 0; i < outer; ++i) {
-    for (int64_t j = 0; j < ninputs; j++) {
-      int64_t local_inner = inputs[j].inner_size;
-      scalar_t* input_ptr = (scalar_t*)(inputs[j].data_ptr) + i * local_inner;
-      if (local_inner < Vec::size()) {
-        #ifndef _MSC_VER
-        # pragma unroll
-        #endif
-        for (int64_t k = 0; k < local_inner; k++) {
-          result_ptr[k] = input_ptr[k];
+  at::parallel_for(0, outer * row_size, at::internal::GRAIN_SIZE * element_size, [&](int64_t begin, int64_t end) {
+    int64_t i = begin / row_size;
+    int64_t j = std::upper_bound(offsets.begin(), offsets.end(), begin % row_size) - offsets.begin() - 1;
+    int64_t within = begin % row_size - offsets[j];
+    for (int64_t pos = begin; pos < end;) {
+      const InputMeta& input = inputs[j];
+      const int64_t n = std::min(input.inner_size - within, end - pos);
+      std::memcpy(result_data + pos, input.data_ptr + i * input.inner_size + within, n);
+      pos += n;
+      within += n;
+      if (within == input.inner_size) {
+        within = 0;
+        if (++j == ninputs) {
+          j = 0;
+          i++;
         }
-      } else {
-        vec256::map(
-            [](Vec x) { return x; },
-            result_ptr,
-            input_ptr,
-            local_inner);
       }
-      result_ptr += local_inner;
     }
-  }
-}
-
-void cat_serial_kernel(Tensor& result, TensorList tensors, int64_t dim) {
-  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cat_serial_kernel", [&]() {
-    cat_serial_kernel_impl<scalar_t>(result, tensors, dim);
   });
 }
 
 } // anonymous namespace
 
-REGISTER_DISPATCH(cat_serial_stub, &cat_serial_kernel);
+REGISTER_DISPATCH(cat_contiguous_stub, &cat_contiguous_kernel);
 
 }} // at::native
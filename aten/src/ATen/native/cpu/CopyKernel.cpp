@@ -1,6 +1,7 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/intrinsics.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -10,8 +11,193 @@ namespace at {
 namespace native {
 namespace {
 
+// Note [Blocked transpose copy]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// TensorIterator orders the dimensions by the strides of the output, so when
+// the output is contiguous along dim 0 and the input along dim 1 (e.g.
+// .contiguous() of a transposed matrix, or NCHW <-> NHWC conversions, where
+// H and W are coalesced), an elementwise loop reads or writes with a large
+// stride. The copy is then done in square tiles, which are transposed with
+// shuffles between registers for 4 and 8-byte elements. Since a same dtype
+// copy only moves bits, the tiles are dispatched on the element size.
+
+// Tile edge, in elements; 32x32 doubles are 8KB on each side.
+constexpr int64_t kTransposeBlock = 32;
+// Both dims have to be at least this long for the tiles to pay off.
+constexpr int64_t kTransposeMinSize = 16;
+
+// out[i1 * ld_out + i0] = in[i0 * ld_in + i1] for i0 < n0, i1 < n1
+template <typename scalar_t>
+inline void transpose_block_scalar(
+    scalar_t* out, int64_t ld_out, const scalar_t* in, int64_t ld_in, int64_t n0, int64_t n1) {
+  for (int64_t i1 = 0; i1 < n1; i1++) {
+    for (int64_t i0 = 0; i0 < n0; i0++) {
+      out[i1 * ld_out + i0] = in[i0 * ld_in + i1];
+    }
+  }
+}
+
+template <typename scalar_t>
+struct TransposeTile {
+  static constexpr int64_t size = 1;
+  static void apply(scalar_t* out, int64_t ld_out, const scalar_t* in, int64_t ld_in) {
+    *out = *in;
+  }
+};
+
+#if (defined(CPU_CAPABILITY_AVX) || defined(CPU_CAPABILITY_AVX2)) && !defined(_MSC_VER)
+
+template <>
+struct TransposeTile<uint32_t> {
+  static constexpr int64_t size = 8;
+  static void apply(uint32_t* out, int64_t ld_out, const uint32_t* in, int64_t ld_in) {
+    __m256 r[8];
+    __m256 t[8];
+    for (int k = 0; k < 8; k++) {
+      r[k] = _mm256_loadu_ps(reinterpret_cast<const float*>(in + k * ld_in));
+    }
+    for (int k = 0; k < 8; k += 2) {
+      t[k] = _mm256_unpacklo_ps(r[k], r[k + 1]);
+      t[k + 1] = _mm256_unpackhi_ps(r[k], r[k + 1]);
+    }
+    for (int k = 0; k < 8; k += 4) {
+      r[k] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(1, 0, 1, 0));
+      r[k + 1] = _mm256_shuffle_ps(t[k], t[k + 2], _MM_SHUFFLE(3, 2, 3, 2));
+      r[k + 2] = _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(1, 0, 1, 0));
+      r[k + 3] = _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int k = 0; k < 4; k++) {
+      t[k] = _mm256_permute2f128_ps(r[k], r[k + 4], 0x20);
+      t[k + 4] = _mm256_permute2f128_ps(r[k], r[k + 4], 0x31);
+    }
+    for (int k = 0; k < 8; k++) {
+      _mm256_storeu_ps(reinterpret_cast<float*>(out + k * ld_out), t[k]);
+    }
+  }
+};
+
+template <>
+struct TransposeTile<uint64_t> {
+  static constexpr int64_t size = 4;
+  static void apply(uint64_t* out, int64_t ld_out, const uint64_t* in, int64_t ld_in) {
+    __m256d r[4];
+    for (int k = 0; k < 4; k++) {
+      r[k] = _mm256_loadu_pd(reinterpret_cast<const double*>(in + k * ld_in));
+    }
+    const __m256d t0 = _mm256_unpacklo_pd(r[0], r[1]);
+    const __m256d t1 = _mm256_unpackhi_pd(r[0], r[1]);
+    const __m256d t2 = _mm256_unpacklo_pd(r[2], r[3]);
+    const __m256d t3 = _mm256_unpackhi_pd(r[2], r[3]);
+    r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+    for (int k = 0; k < 4; k++) {
+      _mm256_storeu_pd(reinterpret_cast<double*>(out + k * ld_out), r[k]);
+    }
+  }
+};
+
+#endif
+
+template <typename scalar_t>
+inline void transpose_block(
+    scalar_t* out, int64_t ld_out, const scalar_t* in, int64_t ld_in, int64_t n0, int64_t n1) {
+  using Tile = TransposeTile<scalar_t>;
+  if (Tile::size == 1) {
+    transpose_block_scalar(out, ld_out, in, ld_in, n0, n1);
+    return;
+  }
+  const int64_t m0 = n0 - n0 % Tile::size;
+  const int64_t m1 = n1 - n1 % Tile::size;
+  for (int64_t i0 = 0; i0 < m0; i0 += Tile::size) {
+    for (int64_t i1 = 0; i1 < m1; i1 += Tile::size) {
+      Tile::apply(out + i1 * ld_out + i0, ld_out, in + i0 * ld_in + i1, ld_in);
+    }
+  }
+  // the edges of the block that don't fill a tile
+  transpose_block_scalar(out + m1 * ld_out, ld_out, in + m1, ld_in, n0, n1 - m1);
+  transpose_block_scalar(out + m0, ld_out, in + m0 * ld_in, ld_in, n0 - m0, m1);
+}
+
+bool use_transpose_copy(const TensorIterator& iter) {
+  if (iter.ndim() < 2 || iter.dtype(0) != iter.dtype(1)) {
+    return false;
+  }
+  const int64_t element_size = iter.element_size(0);
+  if (element_size != 1 && element_size != 2 && element_size != 4 && element_size != 8) {
+    return false;
+  }
+  return iter.strides(0)[0] == element_size && iter.strides(1)[1] == element_size &&
+      iter.shape()[0] >= kTransposeMinSize && iter.shape()[1] >= kTransposeMinSize;
+}
+
+// See Note [Blocked transpose copy]
+template <typename scalar_t>
+void transpose_copy(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t size0, int64_t size1) {
+    auto* out = reinterpret_cast<scalar_t*>(data[0]);
+    const auto* in = reinterpret_cast<const scalar_t*>(data[1]);
+    // the dim 1 stride of the output and the dim 0 stride of the input
+    const int64_t ld_out = strides[2] / sizeof(scalar_t);
+    const int64_t ld_in = strides[1] / sizeof(scalar_t);
+    for (int64_t b0 = 0; b0 < size0; b0 += kTransposeBlock) {
+      for (int64_t b1 = 0; b1 < size1; b1 += kTransposeBlock) {
+        transpose_block(
+            out + b1 * ld_out + b0, ld_out, in + b0 * ld_in + b1, ld_in,
+            std::min(kTransposeBlock, size0 - b0), std::min(kTransposeBlock, size1 - b1));
+      }
+    }
+  });
+}
+
+// Half and BFloat16 <-> float copies, which mixed precision code does all the
+// time, convert 16 elements at a time with vec256::convert (F16C for Half)
+// when both sides are contiguous along the inner dim.
+bool is_reduced_float_conversion(ScalarType dst, ScalarType src) {
+  auto is_reduced = [](ScalarType t) { return t == ScalarType::Half || t == ScalarType::BFloat16; };
+  return (dst == ScalarType::Float && is_reduced(src)) || (is_reduced(dst) && src == ScalarType::Float);
+}
+
+template <typename dest_t, typename src_t>
+void conversion_copy(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    auto* out = data[0];
+    const auto* in = data[1];
+    if (strides[0] == sizeof(dest_t) && strides[1] == sizeof(src_t)) {
+      vec256::convert(reinterpret_cast<const src_t*>(in), reinterpret_cast<dest_t*>(out), n);
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<dest_t*>(out + i * strides[0]) =
+          static_cast<dest_t>(*reinterpret_cast<const src_t*>(in + i * strides[1]));
+    }
+  });
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
+  if (use_transpose_copy(iter)) {
+    switch (iter.element_size(0)) {
+      case 1: transpose_copy<uint8_t>(iter); break;
+      case 2: transpose_copy<uint16_t>(iter); break;
+      case 4: transpose_copy<uint32_t>(iter); break;
+      default: transpose_copy<uint64_t>(iter); break;
+    }
+    return;
+  }
+  if (is_reduced_float_conversion(dtype, iter.dtype(1))) {
+    if (dtype == ScalarType::Half) {
+      conversion_copy<at::Half, float>(iter);
+    } else if (dtype == ScalarType::BFloat16) {
+      conversion_copy<at::BFloat16, float>(iter);
+    } else if (iter.dtype(1) == ScalarType::Half) {
+      conversion_copy<float, at::Half>(iter);
+    } else {
+      conversion_copy<float, at::BFloat16>(iter);
+    }
+    return;
+  }
   if (dtype == iter.dtype(1)) {
     if (dtype == ScalarType::Half) {
       cpu_kernel(iter, [=](at::Half a) -> at::Half { return a; });
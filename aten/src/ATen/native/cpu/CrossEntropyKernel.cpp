@@ -0,0 +1,237 @@
+#include <ATen/native/CrossEntropyLoss.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+
+#include <algorithm>
+#include <limits>
+
+// See Note [Fused cross entropy] for what the kernels compute.
+
+namespace at { namespace native { namespace {
+
+// The logits of a row are processed in chunks of this many bytes, which stay
+// in L1 between the passes over them.
+constexpr int64_t kChunkBytes = 8192;
+
+// Scalar exp and log through Vectorized, see [Note AVX-SSE transitions] in
+// SoftMaxKernel.cpp.
+template <typename scalar_t, typename Op>
+scalar_t scalar_vec_op(scalar_t x, const Op& op) {
+  using Vec = vec::Vectorized<scalar_t>;
+  scalar_t result[Vec::size()];
+  op(Vec(x)).store(result);
+  return result[0];
+}
+
+template <typename scalar_t>
+int64_t cross_entropy_grain_size(int64_t n_classes) {
+  // Same estimate as the softmax kernels: 16 computations per logit.
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / (16 * n_classes));
+}
+
+template <typename scalar_t>
+void cross_entropy_kernel_impl(
+    Tensor& output,
+    Tensor& logsumexp,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing) {
+  using Vec = vec::Vectorized<scalar_t>;
+  constexpr int64_t chunk_size = kChunkBytes / sizeof(scalar_t);
+  const int64_t batch_size = self.size(0);
+  const int64_t n_classes = self.size(1);
+  const scalar_t* self_data = self.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  const scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  scalar_t* logsumexp_data = logsumexp.data_ptr<scalar_t>();
+
+  const scalar_t eps = static_cast<scalar_t>(label_smoothing);
+  const bool smooth = label_smoothing > 0;
+  const scalar_t weight_sum = weight_data != nullptr
+      ? vec::reduce_all<scalar_t>(
+            [](Vec& x, Vec& y) { return x + y; },
+            const_cast<scalar_t*>(weight_data),
+            n_classes)
+      : static_cast<scalar_t>(n_classes);
+
+  at::parallel_for(0, batch_size, cross_entropy_grain_size<scalar_t>(n_classes), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t cur_target = target_data[i];
+      if (cur_target == ignore_index) {
+        output_data[i] = 0;
+        logsumexp_data[i] = 0;
+        continue;
+      }
+      TORCH_CHECK_INDEX(
+          cur_target >= 0 && cur_target < n_classes,
+          "Target ",
+          cur_target,
+          " is out of bounds.");
+
+      // Online logsumexp: the sum of the exps is rescaled when a chunk
+      // raises the max.
+      const scalar_t* row = self_data + i * n_classes;
+      scalar_t max_input = -std::numeric_limits<scalar_t>::infinity();
+      scalar_t sum_exp = 0;
+      // sum_c w[c] * self[i][c], for the smoothing term
+      scalar_t weighted_sum = 0;
+      for (int64_t c = 0; c < n_classes; c += chunk_size) {
+        const int64_t size = std::min(chunk_size, n_classes - c);
+        scalar_t* chunk = const_cast<scalar_t*>(row + c);
+        const scalar_t new_max = std::max(
+            max_input,
+            vec::reduce_all<scalar_t>(
+                [](Vec& x, Vec& y) { return vec::maximum(x, y); }, chunk, size));
+        if (new_max != max_input) {
+          sum_exp *= scalar_vec_op(max_input - new_max, [](Vec x) { return x.exp(); });
+          max_input = new_max;
+        }
+        sum_exp += vec::map_reduce_all<scalar_t>(
+            [new_max](Vec x) { return (x - Vec(new_max)).exp(); },
+            [](Vec x, Vec y) { return x + y; },
+            chunk,
+            size);
+        if (smooth) {
+          weighted_sum += weight_data != nullptr
+              ? vec::map2_reduce_all<scalar_t>(
+                    [](Vec x, Vec w) { return x * w; },
+                    [](Vec x, Vec y) { return x + y; },
+                    chunk,
+                    weight_data + c,
+                    size)
+              : vec::reduce_all<scalar_t>(
+                    [](Vec& x, Vec& y) { return x + y; }, chunk, size);
+        }
+      }
+      const scalar_t log_sum_exp = scalar_vec_op(sum_exp, [](Vec x) { return x.log(); });
+      const scalar_t lse = max_input + log_sum_exp;
+
+      const scalar_t cur_weight = weight_data != nullptr ? weight_data[cur_target]
+                                                         : static_cast<scalar_t>(1);
+      // (max - x) + log(sum) rather than lse - x, see the note on the order
+      // of the operations in SoftMaxKernel.cpp.
+      scalar_t loss = (1 - eps) * cur_weight * ((max_input - row[cur_target]) + log_sum_exp);
+      if (smooth) {
+        loss += eps / n_classes * (weight_sum * lse - weighted_sum);
+      }
+      output_data[i] = loss;
+      logsumexp_data[i] = lse;
+    }
+  });
+}
+
+template <typename scalar_t>
+void cross_entropy_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_scale,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing,
+    const Tensor& logsumexp) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t batch_size = self.size(0);
+  const int64_t n_classes = self.size(1);
+  const scalar_t* self_data = self.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  const scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* grad_scale_data = grad_scale.data_ptr<scalar_t>();
+  const scalar_t* logsumexp_data = logsumexp.data_ptr<scalar_t>();
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+
+  const scalar_t eps = static_cast<scalar_t>(label_smoothing);
+  const scalar_t weight_sum = weight_data != nullptr
+      ? vec::reduce_all<scalar_t>(
+            [](Vec& x, Vec& y) { return x + y; },
+            const_cast<scalar_t*>(weight_data),
+            n_classes)
+      : static_cast<scalar_t>(n_classes);
+
+  at::parallel_for(0, batch_size, cross_entropy_grain_size<scalar_t>(n_classes), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* grad_row = grad_input_data + i * n_classes;
+      const int64_t cur_target = target_data[i];
+      if (cur_target == ignore_index) {
+        std::fill(grad_row, grad_row + n_classes, scalar_t(0));
+        continue;
+      }
+      TORCH_CHECK_INDEX(
+          cur_target >= 0 && cur_target < n_classes,
+          "Target ",
+          cur_target,
+          " is out of bounds.");
+
+      const scalar_t* row = self_data + i * n_classes;
+      const scalar_t scale = grad_scale_data[i];
+      const scalar_t lse = logsumexp_data[i];
+      const scalar_t cur_weight = weight_data != nullptr ? weight_data[cur_target]
+                                                         : static_cast<scalar_t>(1);
+      // scale * A and scale * eps / C, A being the sum of the coefficients
+      const scalar_t scale_sum = scale * ((1 - eps) * cur_weight + eps * weight_sum / n_classes);
+      const scalar_t scale_smooth = scale * eps / n_classes;
+      if (weight_data != nullptr && label_smoothing > 0) {
+        vec::map2(
+            [scale_sum, scale_smooth, lse](Vec x, Vec w) {
+              return Vec(scale_sum) * (x - Vec(lse)).exp() - Vec(scale_smooth) * w;
+            },
+            grad_row,
+            const_cast<scalar_t*>(row),
+            const_cast<scalar_t*>(weight_data),
+            n_classes);
+      } else {
+        vec::map(
+            [scale_sum, scale_smooth, lse](Vec x) {
+              return Vec(scale_sum) * (x - Vec(lse)).exp() - Vec(scale_smooth);
+            },
+            grad_row,
+            row,
+            n_classes);
+      }
+      grad_row[cur_target] -= scale * (1 - eps) * cur_weight;
+    }
+  });
+}
+
+void cross_entropy_kernel(
+    Tensor& output,
+    Tensor& logsumexp,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cross_entropy_cpu", [&] {
+    cross_entropy_kernel_impl<scalar_t>(
+        output, logsumexp, self, target, weight, ignore_index, label_smoothing);
+  });
+}
+
+void cross_entropy_backward_kernel(
+    Tensor& grad_input,
+    const Tensor& grad_scale,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing,
+    const Tensor& logsumexp) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cross_entropy_backward_cpu", [&] {
+    cross_entropy_backward_kernel_impl<scalar_t>(
+        grad_input, grad_scale, self, target, weight, ignore_index, label_smoothing, logsumexp);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(cross_entropy_stub, &cross_entropy_kernel);
+REGISTER_DISPATCH(cross_entropy_backward_stub, &cross_entropy_backward_kernel);
+
+}} // namespace at::native
@@ -1,6 +1,11 @@
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/ConvUtils.h>
+
+#include <algorithm>
 
 #ifdef __ARM_NEON__
 #include <arm_neon.h>
@@ -297,9 +302,233 @@ Tensor _convolution_depthwise3x3_winograd(
   return output;
 }
 
+struct DepthwiseArguments final {
+  int64_t batch;
+  int64_t channels;
+  // Output channels per input channel
+  int64_t multiplier;
+  int64_t in_rows;
+  int64_t in_cols;
+  int64_t out_rows;
+  int64_t out_cols;
+  int64_t kernel_rows;
+  int64_t kernel_cols;
+  int64_t stride_rows;
+  int64_t stride_cols;
+  int64_t pad_rows;
+  int64_t pad_cols;
+  int64_t dilation_rows;
+  int64_t dilation_cols;
+};
+
+// The range [begin, end) of output positions o for which the input position
+// o * stride + offset lies in [0, size).
+inline std::pair<int64_t, int64_t> valid_output_range(
+    const int64_t offset,
+    const int64_t stride,
+    const int64_t size,
+    const int64_t out_size) {
+  const int64_t begin = offset >= 0 ? 0 : (-offset + stride - 1) / stride;
+  const int64_t end = size - 1 - offset < 0
+      ? 0
+      : std::min(out_size, (size - 1 - offset) / stride + 1);
+  return {begin, std::max(begin, end)};
+}
+
+// NCHW: every output plane is the sum of the shifted input rows scaled by the
+// kernel taps, so the inner loop is an axpy along the output row, vectorized
+// when the input row is read contiguously (unit column stride).
+template <typename scalar_t>
+void convolution_depthwise_nchw(
+    const DepthwiseArguments& args,
+    const scalar_t* const input,
+    const scalar_t* const weight,
+    const scalar_t* const bias,
+    scalar_t* const output) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t out_channels = args.channels * args.multiplier;
+  const int64_t in_hxw = args.in_rows * args.in_cols;
+  const int64_t out_hxw = args.out_rows * args.out_cols;
+  const int64_t kernel_hxw = args.kernel_rows * args.kernel_cols;
+
+  at::parallel_for(
+      0, args.batch * out_channels, 0, [&](int64_t start, int64_t end) {
+    for (int64_t k = start; k < end; ++k) {
+      const int64_t n = k / out_channels;
+      const int64_t oc = k % out_channels;
+      const scalar_t* const in =
+          input + (n * args.channels + oc / args.multiplier) * in_hxw;
+      const scalar_t* const w = weight + oc * kernel_hxw;
+      scalar_t* const out = output + k * out_hxw;
+      std::fill_n(out, out_hxw, bias ? bias[oc] : scalar_t(0));
+
+      for (int64_t oh = 0; oh < args.out_rows; ++oh) {
+        scalar_t* const out_row = out + oh * args.out_cols;
+        for (int64_t kh = 0; kh < args.kernel_rows; ++kh) {
+          const int64_t ih =
+              oh * args.stride_rows - args.pad_rows + kh * args.dilation_rows;
+          if (ih < 0 || ih >= args.in_rows) {
+            continue;
+          }
+          const scalar_t* const in_row = in + ih * args.in_cols;
+          for (int64_t kw = 0; kw < args.kernel_cols; ++kw) {
+            const int64_t offset = kw * args.dilation_cols - args.pad_cols;
+            const auto range = valid_output_range(
+                offset, args.stride_cols, args.in_cols, args.out_cols);
+            const scalar_t tap = w[kh * args.kernel_cols + kw];
+            int64_t ow = range.first;
+            if (args.stride_cols == 1) {
+              const Vec vtap(tap);
+              for (; ow + Vec::size() <= range.second; ow += Vec::size()) {
+                vec::fmadd(
+                    vtap,
+                    Vec::loadu(in_row + ow + offset),
+                    Vec::loadu(out_row + ow))
+                    .store(out_row + ow);
+              }
+            }
+            for (; ow < range.second; ++ow) {
+              out_row[ow] += tap * in_row[ow * args.stride_cols + offset];
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+// NHWC: the channels of a pixel are contiguous, so the taps are applied to
+// whole pixels, vectorized along the channels for any stride and dilation.
+// The weight is expected in [kernel_rows, kernel_cols, channels] layout.
+template <typename scalar_t>
+void convolution_depthwise_nhwc(
+    const DepthwiseArguments& args,
+    const scalar_t* const input,
+    const scalar_t* const weight,
+    const scalar_t* const bias,
+    scalar_t* const output) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t channels = args.channels;
+
+  at::parallel_for(
+      0, args.batch * args.out_rows, 0, [&](int64_t start, int64_t end) {
+    for (int64_t k = start; k < end; ++k) {
+      const int64_t n = k / args.out_rows;
+      const int64_t oh = k % args.out_rows;
+      for (int64_t ow = 0; ow < args.out_cols; ++ow) {
+        scalar_t* const out = output + (k * args.out_cols + ow) * channels;
+        if (bias) {
+          std::copy_n(bias, channels, out);
+        } else {
+          std::fill_n(out, channels, scalar_t(0));
+        }
+        for (int64_t kh = 0; kh < args.kernel_rows; ++kh) {
+          const int64_t ih =
+              oh * args.stride_rows - args.pad_rows + kh * args.dilation_rows;
+          if (ih < 0 || ih >= args.in_rows) {
+            continue;
+          }
+          for (int64_t kw = 0; kw < args.kernel_cols; ++kw) {
+            const int64_t iw =
+                ow * args.stride_cols - args.pad_cols + kw * args.dilation_cols;
+            if (iw < 0 || iw >= args.in_cols) {
+              continue;
+            }
+            const scalar_t* const in = input +
+                ((n * args.in_rows + ih) * args.in_cols + iw) * channels;
+            const scalar_t* const w =
+                weight + (kh * args.kernel_cols + kw) * channels;
+            int64_t c = 0;
+            for (; c + Vec::size() <= channels; c += Vec::size()) {
+              vec::fmadd(
+                  Vec::loadu(w + c), Vec::loadu(in + c), Vec::loadu(out + c))
+                  .store(out + c);
+            }
+            for (; c < channels; ++c) {
+              out[c] += w[c] * in[c];
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+Tensor _convolution_depthwise(
+    const Tensor & input,
+    const Tensor & weight,
+    const Tensor & bias,
+    const IntArrayRef stride,
+    const IntArrayRef padding,
+    const IntArrayRef dilation)
+{
+  const IntArrayRef input_sizes = input.sizes();
+  const IntArrayRef weight_sizes = weight.sizes();
+  const auto output_sizes =
+      conv_output_size(input_sizes, weight_sizes, padding, stride, dilation);
+
+  const DepthwiseArguments args {
+      input_sizes[0],                     // Batch
+      input_sizes[1],                     // Input channels
+      weight_sizes[0] / input_sizes[1],   // Depth multiplier
+      input_sizes[2],                     // Input H
+      input_sizes[3],                     // Input W
+      output_sizes[2],                    // Output H
+      output_sizes[3],                    // Output W
+      weight_sizes[2],                    // Kernel H
+      weight_sizes[3],                    // Kernel W
+      stride[0],                          // Stride rows
+      stride[1],                          // Stride columns
+      padding[0],                         // Padding rows
+      padding[1],                         // Padding columns
+      dilation[0],                        // Dilation rows
+      dilation[1],                        // Dilation columns
+  };
+
+  const bool channels_last = args.multiplier == 1 &&
+      input.suggest_memory_format() == at::MemoryFormat::ChannelsLast;
+  const auto memory_format = channels_last
+      ? at::MemoryFormat::ChannelsLast
+      : at::MemoryFormat::Contiguous;
+  const Tensor input_ = input.contiguous(memory_format);
+  // [C, 1, kH, kW] -> [kH, kW, C] for NHWC
+  const Tensor weight_ = channels_last
+      ? weight.reshape({args.channels, -1}).t().contiguous()
+      : weight.contiguous();
+  const Tensor bias_ = bias.defined() ? bias.contiguous() : bias;
+  Tensor output = at::empty(
+      output_sizes, input.options().memory_format(memory_format));
+  if (output.numel() == 0) {
+    return output;
+  }
+
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "convolution_depthwise", [&] {
+    const scalar_t* const bias_data =
+        bias_.defined() ? bias_.data_ptr<scalar_t>() : nullptr;
+    if (channels_last) {
+      convolution_depthwise_nhwc<scalar_t>(
+          args,
+          input_.data_ptr<scalar_t>(),
+          weight_.data_ptr<scalar_t>(),
+          bias_data,
+          output.data_ptr<scalar_t>());
+    } else {
+      convolution_depthwise_nchw<scalar_t>(
+          args,
+          input_.data_ptr<scalar_t>(),
+          weight_.data_ptr<scalar_t>(),
+          bias_data,
+          output.data_ptr<scalar_t>());
+    }
+  });
+
+  return output;
+}
+
 }  // namespace
 
 REGISTER_DISPATCH(convolution_depthwise3x3_winograd_stub, &_convolution_depthwise3x3_winograd);
+REGISTER_DISPATCH(convolution_depthwise_stub, &_convolution_depthwise);
 
 }  // namespace native
 }  // namespace at
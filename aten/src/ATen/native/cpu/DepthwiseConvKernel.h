@@ -15,5 +15,15 @@ using convolution_depthwise3x3_winograd_fn =
 
 DECLARE_DISPATCH(convolution_depthwise3x3_winograd_fn, convolution_depthwise3x3_winograd_stub);
 
+/*
+  Direct depthwise convolution operator for any kernel size, stride and
+  dilation, on contiguous (NCHW) and channels last (NHWC) inputs
+*/
+
+using convolution_depthwise_fn =
+    Tensor (*)(const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef);
+
+DECLARE_DISPATCH(convolution_depthwise_fn, convolution_depthwise_stub);
+
 }  // namespace native
 }  // namespace at
@@ -2,7 +2,9 @@
 
 #include <ATen/Dispatch.h>
 #include <ATen/CPUApplyUtils.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <limits>
@@ -19,6 +21,67 @@ namespace templates {
 namespace cpu {
 namespace {
 
+// ================================================ Parallel fills ====================================================
+
+// Note [Parallel CPU random fills]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The CPU generators are sequential, so the kernels below fill tensors
+// serially while holding the generator lock. Large contiguous uniform, normal
+// and bernoulli fills instead take a single 64-bit key from the generator and
+// compute element i from the i-th 64 bits of the Philox stream of that key,
+// see Note [Philox Engine implementation]. Any range of elements can then be
+// filled on its own, so these fills are split across threads, and the result
+// only depends on the state of the generator, not on the number of threads.
+constexpr int64_t kParallelFillMinSize = at::internal::GRAIN_SIZE;
+
+// Hands the 64 random bits of one element to the at:: distributions, which
+// take 32 bits for float types and 64 bits for double.
+struct PhiloxElementRNG {
+  uint32_t random() {
+    return lo;
+  }
+  uint64_t random64() {
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+  }
+  uint32_t lo;
+  uint32_t hi;
+};
+
+template<typename RNG>
+uint64_t philox_fill_key(RNG generator) {
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(generator->mutex_);
+  return generator->random64();
+}
+
+// Calls f(i, rng) for the elements i in [begin, end) of the stream of key.
+template<typename func_t>
+void philox_serial_for(uint64_t key, int64_t begin, int64_t end, const func_t& f) {
+  // Each 128-bit output of the engine covers two elements.
+  at::Philox4_32_10 engine(key, /*subsequence=*/0, /*offset=*/begin / 2);
+  if (begin % 2 != 0) {
+    engine();
+    engine();
+  }
+  for (int64_t i = begin; i < end; ++i) {
+    PhiloxElementRNG rng;
+    rng.lo = engine();
+    rng.hi = engine();
+    f(i, &rng);
+  }
+}
+
+// data[i] = sample(rng) for the size elements of a contiguous tensor.
+template<typename scalar_t, typename RNG, typename func_t>
+void philox_parallel_fill(scalar_t* data, int64_t size, RNG generator, const func_t& sample) {
+  const uint64_t key = philox_fill_key(generator);
+  at::parallel_for(0, size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    philox_serial_for(key, begin, end, [&](int64_t i, PhiloxElementRNG* rng) {
+      data[i] = sample(rng);
+    });
+  });
+}
+
 // ==================================================== Random ========================================================
 
 template<typename RNG>
@@ -83,6 +146,35 @@ struct RandomKernel {
 
 // ==================================================== Normal ========================================================
 
+// normal_fill with the uniforms taken from the Philox stream of the generator,
+// splitting the fill and the Box-Muller transform fill_16 across threads. See
+// Note [Parallel CPU random fills]. The 16 uniforms of the recomputed tail
+// are the elements [size, size + 16) of the stream.
+template <typename scalar_t, typename RNG, typename fill_16_t>
+void normal_fill_parallel(Tensor& self, RNG generator, const fill_16_t& fill_16) {
+  scalar_t *data = self.data_ptr<scalar_t>();
+  const int64_t size = self.numel();
+  const uint64_t key = philox_fill_key(generator);
+  at::uniform_real_distribution<scalar_t> uniform(0, 1);
+  auto sample = [&](scalar_t* out, int64_t begin, int64_t end) {
+    philox_serial_for(key, begin, end, [&](int64_t i, PhiloxElementRNG* rng) {
+      out[i - begin] = static_cast<scalar_t>(uniform(rng));
+    });
+  };
+
+  at::parallel_for(0, size / 16, at::internal::GRAIN_SIZE / 16, [&](int64_t begin, int64_t end) {
+    sample(data + begin * 16, begin * 16, end * 16);
+    for (int64_t i = begin; i < end; ++i) {
+      fill_16(data + i * 16);
+    }
+  });
+  if (size % 16 != 0) {
+    // Recompute the last 16 values.
+    sample(data + size - 16, size, size + 16);
+    fill_16(data + size - 16);
+  }
+}
+
 #ifdef CPU_CAPABILITY_AVX2
 static void normal_fill_16_AVX2(float *data,
                          const __m256* two_pi,
@@ -107,17 +199,25 @@ template<typename RNG>
 void normal_fill_AVX2(Tensor& self, const float mean, const float std, RNG generator) {
   float *data = self.data_ptr<float>();
   auto size = self.numel();
-  std::lock_guard<std::mutex> lock(generator->mutex_);
-  for (int64_t i = 0; i < size; ++i) {
-    at::uniform_real_distribution<float> uniform(0, 1);
-    data[i] = uniform(generator);
-  }
   const __m256 two_pi = _mm256_set1_ps(2.0f * M_PI);
   const __m256 one = _mm256_set1_ps(1.0f);
   const __m256 minus_two = _mm256_set1_ps(-2.0f);
   const __m256 mean_v = _mm256_set1_ps(mean);
   const __m256 std_v = _mm256_set1_ps(std);
 
+  if (size >= kParallelFillMinSize) {
+    normal_fill_parallel<float>(self, generator, [&](float* data_16) {
+      normal_fill_16_AVX2(data_16, &two_pi, &one, &minus_two, &mean_v, &std_v);
+    });
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(generator->mutex_);
+  for (int64_t i = 0; i < size; ++i) {
+    at::uniform_real_distribution<float> uniform(0, 1);
+    data[i] = uniform(generator);
+  }
+
   for (int64_t i = 0; i < size - 15; i += 16) {
     normal_fill_16_AVX2(data + i, &two_pi, &one, &minus_two, &mean_v, &std_v);
   }
@@ -150,6 +250,12 @@ template <typename scalar_t, typename RNG>
 void normal_fill(Tensor& self, const scalar_t mean, const scalar_t std, RNG generator) {
   scalar_t *data = self.data_ptr<scalar_t>();
   auto size = self.numel();
+  if (size >= kParallelFillMinSize) {
+    normal_fill_parallel<scalar_t>(self, generator, [&](scalar_t* data_16) {
+      normal_fill_16<scalar_t>(data_16, mean, std);
+    });
+    return;
+  }
   std::lock_guard<std::mutex> lock(generator->mutex_);
   for (int64_t i = 0; i < size; ++i) {
     at::uniform_real_distribution<scalar_t> uniform(0, 1);
@@ -209,10 +315,18 @@ struct NormalKernel {
 template<typename RNG>
 void uniform_kernel(TensorIterator& iter, double from_, double to_, RNG generator) {
   AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, iter.dtype(), "uniform_kernel_cpu", [&]() {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
     auto from = static_cast<scalar_t>(from_);
     auto to = static_cast<scalar_t>(to_);
     at::uniform_real_distribution<scalar_t> uniform(from, to);
+    if (iter.numel() >= kParallelFillMinSize && iter.is_contiguous()) {
+      // See Note [Parallel CPU random fills]
+      philox_parallel_fill(static_cast<scalar_t*>(iter.data_ptr(0)), iter.numel(), generator,
+        [&uniform](PhiloxElementRNG* rng) -> scalar_t {
+          return static_cast<scalar_t>(uniform(rng));
+        });
+      return;
+    }
+    std::lock_guard<std::mutex> lock(generator->mutex_);
     cpu_serial_kernel(iter, [&uniform, generator]() -> scalar_t {
       return static_cast<scalar_t>(uniform(generator));
     });
@@ -340,6 +454,15 @@ void bernoulli_kernel(Tensor& self, const Tensor& p_, RNG generator) {
 template<typename RNG>
 void bernoulli_kernel(Tensor& self, double p, RNG generator) {
   AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
+    if (self.numel() >= kParallelFillMinSize && self.is_contiguous()) {
+      // See Note [Parallel CPU random fills]
+      at::bernoulli_distribution<double> bernoulli(p);
+      philox_parallel_fill(self.data_ptr<scalar_t>(), self.numel(), generator,
+        [&bernoulli](PhiloxElementRNG* rng) -> scalar_t {
+          return static_cast<scalar_t>(bernoulli(rng));
+        });
+      return;
+    }
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(generator->mutex_);
     auto iter = TensorIterator::nullary_op(self);
@@ -0,0 +1,112 @@
+#include <ATen/native/Dropout.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/PhiloxRNGEngine.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native { namespace {
+
+using namespace vec256;
+
+// Mask bytes generated before they are applied, so that they stay in cache.
+constexpr int64_t kMaskBlockBytes = 64;
+
+// output_data[i] = self_data[i] * scale where the packed mask is set, for i in
+// [begin, end), begin being a multiple of 8. Multiplying by 0 rather than
+// masking the bits keeps NaNs, as the unfused dropout does.
+template <typename scalar_t>
+void masked_scale_packed_range(
+    scalar_t* output_data,
+    const scalar_t* self_data,
+    const uint8_t* mask_data,
+    int64_t begin,
+    int64_t end,
+    scalar_t scale) {
+  using Vec = Vec256<scalar_t>;
+  using int_t = int_same_size_t<scalar_t>;
+  using iVec = Vec256<int_t>;
+  static_assert(8 % Vec::size() == 0, "a mask byte has to cover whole vectors");
+
+  int_t lane_bits_arr[Vec::size()];
+  for (int64_t j = 0; j < Vec::size(); ++j) {
+    lane_bits_arr[j] = int_t(1) << j;
+  }
+  const iVec lane_bits = iVec::loadu(lane_bits_arr);
+  const Vec scale_vec(scale);
+
+  int64_t i = begin;
+  for (; i <= end - Vec::size(); i += Vec::size()) {
+    const iVec bits(static_cast<int_t>(mask_data[i / 8] >> (i % 8)));
+    const Vec keep = cast<scalar_t>((bits & lane_bits) == lane_bits);
+    (Vec::loadu(self_data + i) * (scale_vec & keep)).store(output_data + i);
+  }
+  for (; i < end; ++i) {
+    const bool keep = (mask_data[i / 8] >> (i % 8)) & 1;
+    output_data[i] = self_data[i] * (keep ? scale : scalar_t(0));
+  }
+}
+
+void fused_dropout_packed_kernel(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& self,
+    double p,
+    uint64_t key) {
+  const int64_t numel = self.numel();
+  // An element is kept when its 32 random bits are below p * 2^32.
+  const uint64_t threshold = static_cast<uint64_t>(p * 4294967296.0);
+  uint8_t* mask_data = mask.data_ptr<uint8_t>();
+
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "fused_dropout_packed_cpu", [&] {
+    const scalar_t* self_data = self.data_ptr<scalar_t>();
+    scalar_t* output_data = output.data_ptr<scalar_t>();
+    const scalar_t scale = static_cast<scalar_t>(1. / p);
+
+    at::parallel_for(0, mask.numel(), at::internal::GRAIN_SIZE / 8, [&](int64_t begin, int64_t end) {
+      // Each byte of the mask takes 8 random numbers, i.e. two 128-bit
+      // outputs of the engine.
+      at::Philox4_32_10 engine(key, /*subsequence=*/0, /*offset=*/2 * begin);
+      for (int64_t block = begin; block < end; block += kMaskBlockBytes) {
+        const int64_t block_end = std::min(block + kMaskBlockBytes, end);
+        for (int64_t b = block; b < block_end; ++b) {
+          uint8_t bits = 0;
+          for (int j = 0; j < 8; ++j) {
+            bits |= static_cast<uint8_t>(static_cast<uint64_t>(engine()) < threshold) << j;
+          }
+          mask_data[b] = bits;
+        }
+        masked_scale_packed_range(
+            output_data, self_data, mask_data,
+            block * 8, std::min(block_end * 8, numel), scale);
+      }
+    });
+  });
+}
+
+void masked_scale_packed_kernel(
+    Tensor& output,
+    const Tensor& self,
+    const Tensor& mask,
+    double scale) {
+  const int64_t numel = self.numel();
+  const uint8_t* mask_data = mask.data_ptr<uint8_t>();
+
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "masked_scale_packed_cpu", [&] {
+    const scalar_t* self_data = self.data_ptr<scalar_t>();
+    scalar_t* output_data = output.data_ptr<scalar_t>();
+    at::parallel_for(0, mask.numel(), at::internal::GRAIN_SIZE / 8, [&](int64_t begin, int64_t end) {
+      masked_scale_packed_range(
+          output_data, self_data, mask_data,
+          begin * 8, std::min(end * 8, numel), static_cast<scalar_t>(scale));
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(fused_dropout_packed_stub, &fused_dropout_packed_kernel);
+REGISTER_DISPATCH(masked_scale_packed_stub, &masked_scale_packed_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,84 @@
+#include <ATen/native/cpu/EmbeddingBagKernel.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/vec.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+namespace {
+
+template <typename scalar_t>
+void embedding_bag_backward_kernel_impl(
+    Tensor& index_grad_weight,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& bag_ids,
+    const Tensor& scales,
+    IntArrayRef segment_ends) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t ddim = grad.size(1);
+  const int64_t num_segments = segment_ends.size();
+  if (num_segments == 0 || ddim == 0) {
+    return;
+  }
+  const scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  const int64_t* indices_data = indices.data_ptr<int64_t>();
+  const int64_t* bag_ids_data = bag_ids.data_ptr<int64_t>();
+  const scalar_t* scales_data = scales.data_ptr<scalar_t>();
+  scalar_t* igw_data = index_grad_weight.data_ptr<scalar_t>();
+
+  // Split the distinct rows so that every task touches roughly GRAIN_SIZE
+  // elements of grad.
+  const int64_t numel = segment_ends[num_segments - 1];
+  const int64_t work_per_segment = std::max<int64_t>(1, numel / num_segments * ddim);
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / work_per_segment);
+
+  at::parallel_for(0, num_segments, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t s = begin; s < end; s++) {
+      const int64_t seg_begin = s == 0 ? 0 : segment_ends[s - 1];
+      const int64_t seg_end = segment_ends[s];
+      scalar_t* out = igw_data + indices_data[seg_begin] * ddim;
+      // Keep a vector of the output row in a register while all the grad
+      // rows of the segment are added to it.
+      int64_t d = 0;
+      for (; d + Vec::size() <= ddim; d += Vec::size()) {
+        Vec acc = Vec::loadu(out + d);
+        for (int64_t j = seg_begin; j < seg_end; j++) {
+          const scalar_t* grad_row = grad_data + bag_ids_data[j] * ddim;
+          acc = vec::fmadd(Vec(scales_data[j]), Vec::loadu(grad_row + d), acc);
+        }
+        acc.store(out + d);
+      }
+      for (; d < ddim; d++) {
+        scalar_t acc = out[d];
+        for (int64_t j = seg_begin; j < seg_end; j++) {
+          acc += scales_data[j] * grad_data[bag_ids_data[j] * ddim + d];
+        }
+        out[d] = acc;
+      }
+    }
+  });
+}
+
+void embedding_bag_backward_kernel(
+    Tensor& index_grad_weight,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& bag_ids,
+    const Tensor& scales,
+    IntArrayRef segment_ends) {
+  AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "embedding_bag_backward_cpu", [&] {
+    embedding_bag_backward_kernel_impl<scalar_t>(
+        index_grad_weight, grad, indices, bag_ids, scales, segment_ends);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(embedding_bag_backward_stub, &embedding_bag_backward_kernel);
+
+}}  // namespace at::native
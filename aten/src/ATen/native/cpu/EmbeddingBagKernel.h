@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Accumulates the weighted rows of grad into index_grad_weight for the sum
+// and mean modes of embedding_bag backward.
+//
+// indices, bag_ids and scales describe one entry per looked-up index, sorted
+// by index: entry j adds scales[j] * grad[bag_ids[j]] to the row
+// index_grad_weight[indices[j]]. segment_ends[i] is one past the last entry
+// of the i-th distinct index, so every row of index_grad_weight belongs to
+// exactly one segment and segments can be accumulated in parallel.
+using embedding_bag_backward_fn = void(*)(
+    Tensor& index_grad_weight,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& bag_ids,
+    const Tensor& scales,
+    IntArrayRef segment_ends);
+DECLARE_DISPATCH(embedding_bag_backward_fn, embedding_bag_backward_stub);
+
+}}  // namespace at::native
@@ -0,0 +1,319 @@
+#include <ATen/native/FusedAttention.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+// The scores of a block of kBlockQueries x kBlockKeys queries and keys, and
+// the output rows of the queries, are kept in buffers small enough to stay
+// in the L1/L2 cache while the keys are streamed through.
+constexpr int64_t kBlockQueries = 32;
+constexpr int64_t kBlockKeys = 64;
+
+int64_t flattened_batch_size(const Tensor& t) {
+  const auto sizes = t.sizes();
+  return std::accumulate(
+      sizes.begin(), sizes.end() - 2, int64_t(1), std::multiplies<int64_t>());
+}
+
+template <typename scalar_t>
+scalar_t dot(const scalar_t* a, const scalar_t* b, int64_t size) {
+  using Vec = vec::Vectorized<scalar_t>;
+  int64_t d = 0;
+  Vec acc(scalar_t(0));
+  for (; d + Vec::size() <= size; d += Vec::size()) {
+    acc = vec::fmadd(Vec::loadu(a + d), Vec::loadu(b + d), acc);
+  }
+  scalar_t partial[Vec::size()];
+  acc.store(partial);
+  scalar_t sum = std::accumulate(partial, partial + Vec::size(), scalar_t(0));
+  for (; d < size; d++) {
+    sum += a[d] * b[d];
+  }
+  return sum;
+}
+
+// out += alpha * x
+template <typename scalar_t>
+void axpy(scalar_t* out, scalar_t alpha, const scalar_t* x, int64_t size) {
+  using Vec = vec::Vectorized<scalar_t>;
+  int64_t d = 0;
+  const Vec valpha(alpha);
+  for (; d + Vec::size() <= size; d += Vec::size()) {
+    vec::fmadd(valpha, Vec::loadu(x + d), Vec::loadu(out + d)).store(out + d);
+  }
+  for (; d < size; d++) {
+    out[d] += alpha * x[d];
+  }
+}
+
+// Fills scores [num_queries, kBlockKeys] with the scores of the queries with
+// the keys [key_start, key_start + num_keys) of a batch.
+template <typename scalar_t>
+void compute_scores(
+    scalar_t* scores,
+    const scalar_t* query,
+    const scalar_t* key,
+    const scalar_t* mask,
+    int64_t mask_row_stride,
+    int64_t mask_col_stride,
+    int64_t num_queries,
+    int64_t key_start,
+    int64_t num_keys,
+    int64_t embed_dim) {
+  for (int64_t i = 0; i < num_queries; i++) {
+    const scalar_t* q = query + i * embed_dim;
+    scalar_t* row = scores + i * kBlockKeys;
+    for (int64_t j = 0; j < num_keys; j++) {
+      row[j] = dot(q, key + (key_start + j) * embed_dim, embed_dim);
+    }
+    if (mask != nullptr) {
+      const scalar_t* mask_row = mask + i * mask_row_stride;
+      for (int64_t j = 0; j < num_keys; j++) {
+        row[j] += mask_row[(key_start + j) * mask_col_stride];
+      }
+    }
+  }
+}
+
+template <typename scalar_t>
+void fused_attention_kernel_impl(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask,
+    const Tensor& mask_offsets,
+    Tensor& output,
+    Tensor& logsumexp) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t batch = flattened_batch_size(query);
+  const int64_t num_queries = query.size(-2);
+  const int64_t num_keys = key.size(-2);
+  const int64_t embed_dim = query.size(-1);
+  const int64_t value_dim = value.size(-1);
+  const scalar_t* query_data = query.data_ptr<scalar_t>();
+  const scalar_t* key_data = key.data_ptr<scalar_t>();
+  const scalar_t* value_data = value.data_ptr<scalar_t>();
+  const scalar_t* mask_data =
+      attn_mask.defined() ? attn_mask.data_ptr<scalar_t>() : nullptr;
+  const int64_t* offsets_data =
+      attn_mask.defined() ? mask_offsets.data_ptr<int64_t>() : nullptr;
+  const int64_t mask_row_stride = attn_mask.defined() ? attn_mask.stride(-2) : 0;
+  const int64_t mask_col_stride = attn_mask.defined() ? attn_mask.stride(-1) : 0;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  scalar_t* logsumexp_data = logsumexp.data_ptr<scalar_t>();
+
+  const int64_t query_blocks = (num_queries + kBlockQueries - 1) / kBlockQueries;
+  at::parallel_for(0, batch * query_blocks, 1, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> scores(kBlockQueries * kBlockKeys);
+    std::vector<scalar_t> row_max(kBlockQueries);
+    std::vector<scalar_t> row_sum(kBlockQueries);
+    for (int64_t task = begin; task < end; task++) {
+      const int64_t b = task / query_blocks;
+      const int64_t query_start = (task % query_blocks) * kBlockQueries;
+      const int64_t block_queries =
+          std::min(kBlockQueries, num_queries - query_start);
+      const scalar_t* q = query_data + (b * num_queries + query_start) * embed_dim;
+      const scalar_t* k = key_data + b * num_keys * embed_dim;
+      const scalar_t* v = value_data + b * num_keys * value_dim;
+      const scalar_t* mask = mask_data == nullptr ? nullptr
+          : mask_data + offsets_data[b] + query_start * mask_row_stride;
+      // The output rows accumulate the unnormalized softmax times the values
+      scalar_t* out = output_data + (b * num_queries + query_start) * value_dim;
+      std::fill_n(out, block_queries * value_dim, scalar_t(0));
+      std::fill_n(row_max.begin(), block_queries,
+                  -std::numeric_limits<scalar_t>::infinity());
+      std::fill_n(row_sum.begin(), block_queries, scalar_t(0));
+
+      for (int64_t key_start = 0; key_start < num_keys; key_start += kBlockKeys) {
+        const int64_t block_keys = std::min(kBlockKeys, num_keys - key_start);
+        compute_scores(
+            scores.data(), q, k, mask, mask_row_stride, mask_col_stride,
+            block_queries, key_start, block_keys, embed_dim);
+        for (int64_t i = 0; i < block_queries; i++) {
+          scalar_t* row = scores.data() + i * kBlockKeys;
+          const scalar_t new_max =
+              std::max(row_max[i], *std::max_element(row, row + block_keys));
+          if (new_max == -std::numeric_limits<scalar_t>::infinity()) {
+            // All keys so far are masked out
+            continue;
+          }
+          // Rescale what has been accumulated with the previous maximum
+          const scalar_t correction = std::exp(row_max[i] - new_max);
+          scalar_t* out_row = out + i * value_dim;
+          if (correction != scalar_t(1)) {
+            row_sum[i] *= correction;
+            vec::map([correction](Vec x) { return x * Vec(correction); },
+                     out_row, out_row, value_dim);
+          }
+          vec::map([new_max](Vec x) { return (x - Vec(new_max)).exp(); },
+                   row, row, block_keys);
+          for (int64_t j = 0; j < block_keys; j++) {
+            row_sum[i] += row[j];
+            axpy(out_row, row[j], v + (key_start + j) * value_dim, value_dim);
+          }
+          row_max[i] = new_max;
+        }
+      }
+
+      for (int64_t i = 0; i < block_queries; i++) {
+        const scalar_t inv_sum = scalar_t(1) / row_sum[i];
+        scalar_t* out_row = out + i * value_dim;
+        vec::map([inv_sum](Vec x) { return x * Vec(inv_sum); },
+                 out_row, out_row, value_dim);
+        logsumexp_data[b * num_queries + query_start + i] =
+            row_max[i] + std::log(row_sum[i]);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void fused_attention_backward_kernel_impl(
+    const Tensor& grad_output,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask,
+    const Tensor& mask_offsets,
+    const Tensor& output,
+    const Tensor& logsumexp,
+    Tensor& grad_query,
+    Tensor& grad_key,
+    Tensor& grad_value) {
+  const int64_t batch = flattened_batch_size(query);
+  const int64_t num_queries = query.size(-2);
+  const int64_t num_keys = key.size(-2);
+  const int64_t embed_dim = query.size(-1);
+  const int64_t value_dim = value.size(-1);
+  const scalar_t* grad_output_data = grad_output.data_ptr<scalar_t>();
+  const scalar_t* query_data = query.data_ptr<scalar_t>();
+  const scalar_t* key_data = key.data_ptr<scalar_t>();
+  const scalar_t* value_data = value.data_ptr<scalar_t>();
+  const scalar_t* mask_data =
+      attn_mask.defined() ? attn_mask.data_ptr<scalar_t>() : nullptr;
+  const int64_t* offsets_data =
+      attn_mask.defined() ? mask_offsets.data_ptr<int64_t>() : nullptr;
+  const int64_t mask_row_stride = attn_mask.defined() ? attn_mask.stride(-2) : 0;
+  const int64_t mask_col_stride = attn_mask.defined() ? attn_mask.stride(-1) : 0;
+  const scalar_t* output_data = output.data_ptr<scalar_t>();
+  const scalar_t* logsumexp_data = logsumexp.data_ptr<scalar_t>();
+  scalar_t* grad_query_data = grad_query.data_ptr<scalar_t>();
+  scalar_t* grad_key_data = grad_key.data_ptr<scalar_t>();
+  scalar_t* grad_value_data = grad_value.data_ptr<scalar_t>();
+
+  // The gradients of the keys and values sum over all queries of a batch, so
+  // every task computes whole batches.
+  at::parallel_for(0, batch, 1, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> probs(kBlockQueries * kBlockKeys);
+    std::vector<scalar_t> grad_dot_output(num_queries);
+    for (int64_t b = begin; b < end; b++) {
+      const scalar_t* go = grad_output_data + b * num_queries * value_dim;
+      const scalar_t* q = query_data + b * num_queries * embed_dim;
+      const scalar_t* k = key_data + b * num_keys * embed_dim;
+      const scalar_t* v = value_data + b * num_keys * value_dim;
+      const scalar_t* o = output_data + b * num_queries * value_dim;
+      const scalar_t* lse = logsumexp_data + b * num_queries;
+      scalar_t* gq = grad_query_data + b * num_queries * embed_dim;
+      scalar_t* gk = grad_key_data + b * num_keys * embed_dim;
+      scalar_t* gv = grad_value_data + b * num_keys * value_dim;
+      std::fill_n(gq, num_queries * embed_dim, scalar_t(0));
+      std::fill_n(gk, num_keys * embed_dim, scalar_t(0));
+      std::fill_n(gv, num_keys * value_dim, scalar_t(0));
+      for (int64_t i = 0; i < num_queries; i++) {
+        grad_dot_output[i] =
+            dot(go + i * value_dim, o + i * value_dim, value_dim);
+      }
+
+      for (int64_t query_start = 0; query_start < num_queries;
+           query_start += kBlockQueries) {
+        const int64_t block_queries =
+            std::min(kBlockQueries, num_queries - query_start);
+        const scalar_t* mask = mask_data == nullptr ? nullptr
+            : mask_data + offsets_data[b] + query_start * mask_row_stride;
+        for (int64_t key_start = 0; key_start < num_keys;
+             key_start += kBlockKeys) {
+          const int64_t block_keys = std::min(kBlockKeys, num_keys - key_start);
+          compute_scores(
+              probs.data(), q + query_start * embed_dim, k, mask,
+              mask_row_stride, mask_col_stride, block_queries, key_start,
+              block_keys, embed_dim);
+          for (int64_t i = 0; i < block_queries; i++) {
+            const int64_t qi = query_start + i;
+            // The softmax of fully masked rows is nan; they get no gradient
+            if (lse[qi] == -std::numeric_limits<scalar_t>::infinity()) {
+              continue;
+            }
+            const scalar_t* row = probs.data() + i * kBlockKeys;
+            for (int64_t j = 0; j < block_keys; j++) {
+              const int64_t kj = key_start + j;
+              const scalar_t p = std::exp(row[j] - lse[qi]);
+              if (p == scalar_t(0)) {
+                continue;
+              }
+              axpy(gv + kj * value_dim, p, go + qi * value_dim, value_dim);
+              const scalar_t grad_score = p *
+                  (dot(go + qi * value_dim, v + kj * value_dim, value_dim) -
+                   grad_dot_output[qi]);
+              axpy(gq + qi * embed_dim, grad_score, k + kj * embed_dim, embed_dim);
+              axpy(gk + kj * embed_dim, grad_score, q + qi * embed_dim, embed_dim);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void fused_attention_kernel(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask,
+    const Tensor& mask_offsets,
+    Tensor& output,
+    Tensor& logsumexp) {
+  AT_DISPATCH_FLOATING_TYPES(query.scalar_type(), "fused_attention_cpu", [&] {
+    fused_attention_kernel_impl<scalar_t>(
+        query, key, value, attn_mask, mask_offsets, output, logsumexp);
+  });
+}
+
+void fused_attention_backward_kernel(
+    const Tensor& grad_output,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask,
+    const Tensor& mask_offsets,
+    const Tensor& output,
+    const Tensor& logsumexp,
+    Tensor& grad_query,
+    Tensor& grad_key,
+    Tensor& grad_value) {
+  AT_DISPATCH_FLOATING_TYPES(query.scalar_type(), "fused_attention_backward_cpu", [&] {
+    fused_attention_backward_kernel_impl<scalar_t>(
+        grad_output, query, key, value, attn_mask, mask_offsets, output,
+        logsumexp, grad_query, grad_key, grad_value);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(fused_attention_stub, &fused_attention_kernel);
+REGISTER_DISPATCH(fused_attention_backward_stub, &fused_attention_backward_kernel);
+
+}} // at::native
@@ -116,6 +116,10 @@ void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
         cpu_index_kernel<float>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
           cpu_atomic_add_float((float*)(dst + offset), *(float*)src);
         });
+      } else if (iter.dtype() == at::ScalarType::Double && use_parallel_for) {
+        cpu_index_kernel<double>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
+          cpu_atomic_add_double((double*)(dst + offset), *(double*)src);
+        });
       } else {
         // TODO: investigate parallelization of the accumulate kernel. Unlike the non-accumulate case,
         // this needs to be thread-safe.
@@ -1,6 +1,7 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/Lerp.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -19,14 +20,31 @@ static void lerp_kernel_scalar(
                                         /*check_mem_overlap=*/true);
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(ret.scalar_type(), "lerp_kernel_scalar", [&] {
     using value_t = typename c10::scalar_value_type<scalar_t>::type;
-    scalar_t weight_val = weight.to<scalar_t>();
-    at::native::cpu_kernel(
-        iter,
-        [weight_val](scalar_t self_val, scalar_t end_val) {
-          return (zabs<scalar_t, value_t>(weight_val) < 0.5)
-              ? self_val + weight_val * (end_val - self_val)
-              : end_val - (end_val - self_val) * (scalar_t(1) - weight_val);
-        });
+    using Vec = Vec256<scalar_t>;
+    const scalar_t weight_val = weight.to<scalar_t>();
+    const Vec weight_vec(weight_val);
+    // The weight is the same for every element, so is the formula
+    if (zabs<scalar_t, value_t>(weight_val) < 0.5) {
+      at::native::cpu_kernel_vec(
+          iter,
+          [weight_val](scalar_t self_val, scalar_t end_val) -> scalar_t {
+            return self_val + weight_val * (end_val - self_val);
+          },
+          [weight_vec](Vec self_vec, Vec end_vec) -> Vec {
+            return self_vec + weight_vec * (end_vec - self_vec);
+          });
+    } else {
+      const scalar_t rest_val = scalar_t(1) - weight_val;
+      const Vec rest_vec(rest_val);
+      at::native::cpu_kernel_vec(
+          iter,
+          [rest_val](scalar_t self_val, scalar_t end_val) -> scalar_t {
+            return end_val - (end_val - self_val) * rest_val;
+          },
+          [rest_vec](Vec self_vec, Vec end_vec) -> Vec {
+            return end_vec - (end_vec - self_vec) * rest_vec;
+          });
+    }
   });
 }
 
@@ -44,14 +62,37 @@ static void lerp_kernel_tensor(
     .add_input(end)
     .add_input(weights)
     .build();
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(ret.scalar_type(), "lerp_kernel_tensor", [&] {
-    using value_t = typename c10::scalar_value_type<scalar_t>::type;
-    at::native::cpu_kernel(
+  if (isComplexType(ret.scalar_type())) {
+    AT_DISPATCH_COMPLEX_TYPES(ret.scalar_type(), "lerp_kernel_tensor", [&] {
+      using value_t = typename c10::scalar_value_type<scalar_t>::type;
+      at::native::cpu_kernel(
+          iter,
+          [](scalar_t self_val, scalar_t end_val, scalar_t weight_val) {
+            return (zabs<scalar_t, value_t>(weight_val) < 0.5)
+                ? self_val + weight_val * (end_val - self_val)
+                : end_val - (end_val - self_val) * (scalar_t(1) - weight_val);
+          });
+    });
+    return;
+  }
+  AT_DISPATCH_FLOATING_TYPES(ret.scalar_type(), "lerp_kernel_tensor", [&] {
+    using Vec = Vec256<scalar_t>;
+    const Vec half_vec(0.5);
+    const Vec one_vec(1);
+    at::native::cpu_kernel_vec(
         iter,
-        [](scalar_t self_val, scalar_t end_val, scalar_t weight_val) {
-          return (zabs<scalar_t, value_t>(weight_val) < 0.5)
+        [](scalar_t self_val, scalar_t end_val, scalar_t weight_val) -> scalar_t {
+          return (std::abs(weight_val) < 0.5)
               ? self_val + weight_val * (end_val - self_val)
               : end_val - (end_val - self_val) * (scalar_t(1) - weight_val);
+        },
+        [half_vec, one_vec](Vec self_vec, Vec end_vec, Vec weight_vec) -> Vec {
+          // Both formulas, picking the one the scalar loop would use per lane
+          const Vec diff_vec = end_vec - self_vec;
+          const Vec low_vec = self_vec + weight_vec * diff_vec;
+          const Vec high_vec = end_vec - diff_vec * (one_vec - weight_vec);
+          return Vec::blendv(
+              high_vec, low_vec, weight_vec.abs() < half_vec);
         });
   });
 }
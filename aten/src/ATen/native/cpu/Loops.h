@@ -22,6 +22,10 @@
 //     [](float a, float b) { return a * b; },
 //     [](Vec256<float> a, Vec256<float> b) { return a * b; });
 //
+// The vectorized lambda may take any vector type (Vec256<float> above, or
+// at::vec::Vectorized<float> to use 512-bit vectors in AVX512 builds); the
+// loop takes the vector type from the lambda's return type.
+//
 // See BinaryOpsKernel.cpp for the complete implementation
 //
 //
@@ -136,7 +140,7 @@ static inline void
 vectorized_loop(char** C10_RESTRICT data_, int64_t n, int64_t S, func_t&& op, vec_func_t&& vop) {
   using traits = function_traits<vec_func_t>;
   using scalar_t = typename function_traits<func_t>::result_type;
-  using Vec = Vec256<scalar_t>;
+  using Vec = typename traits::result_type;
   constexpr int ntensors = traits::arity + 1;
 
   char* C10_RESTRICT data[ntensors];
@@ -0,0 +1,160 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/Pool.h>
+#include <ATen/native/cpu/utils.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace at {
+namespace native {
+namespace {
+
+template <typename scalar_t>
+void cpu_max_pool_channels_last(
+    Tensor& output_,
+    Tensor& indices_,
+    const Tensor& input_,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  auto memory_format = at::MemoryFormat::ChannelsLast;
+  auto input = input_.contiguous(memory_format);
+  auto output = output_.contiguous(memory_format);
+  auto indices = indices_.contiguous(memory_format);
+
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+  auto indices_data = indices.data_ptr<int64_t>();
+
+  int64_t nbatch = input.size(0);
+  int64_t channels = input.size(1);
+  int64_t input_height = input.size(2);
+  int64_t input_width = input.size(3);
+  int64_t output_height = output.size(2);
+  int64_t output_width = output.size(3);
+
+  using Vec = vec256::Vec256<scalar_t>;
+  // The indices are tracked in vectors of integers of the same width as
+  // scalar_t, so that the masks of the comparisons select their lanes too.
+  using integer_t = vec256::int_same_size_t<scalar_t>;
+  using iVec = vec256::Vec256<integer_t>;
+  TORCH_CHECK(input_height * input_width <= std::numeric_limits<integer_t>::max(),
+      "max_pool2d: input planes of ", input_height * input_width,
+      " elements are too large for the channels last kernel");
+
+  // parallel on dim N, H, W
+  at::parallel_for(0, nbatch * output_height * output_width, 0, [&](int64_t begin, int64_t end) {
+    int64_t n = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(begin, n, nbatch, oh, output_height, ow, output_width);
+
+    int64_t size = channels;
+    int64_t len = size - (size % Vec::size());
+    // temp buffer holding the indices of the vectorized part, as integer_t
+    std::unique_ptr<integer_t []> index_buffer(new integer_t[len]);
+
+    for (int64_t i = begin; i < end; i++) {
+      int64_t ih0 = oh * dH - padH;
+      int64_t iw0 = ow * dW - padW;
+      int64_t ih1 = std::min(ih0 + (kH - 1) * dilationH + 1, input_height);
+      int64_t iw1 = std::min(iw0 + (kW - 1) * dilationW + 1, input_width);
+      while(ih0 < 0) { ih0 += dilationH; }
+      while(iw0 < 0) { iw0 += dilationW; }
+
+      scalar_t* out = output_data + i * channels;
+      int64_t* ind = indices_data + i * channels;
+
+      // Pass I: init out lane
+      iVec index0_vec = iVec(static_cast<integer_t>(ih0 * input_width + iw0));
+      Vec out_vec = Vec(-std::numeric_limits<scalar_t>::infinity());
+      int64_t d1 = 0;
+      for (; d1 < len; d1 += Vec::size()) {
+        index0_vec.store(index_buffer.get() + d1);
+        out_vec.store(out + d1);
+      }
+      for (; d1 < size; d1++) {
+        ind[d1] = ih0 * input_width + iw0;
+        out[d1] = -std::numeric_limits<scalar_t>::infinity();
+      }
+
+      // Pass II: compute local max, in the same order as the contiguous
+      // kernel so that ties pick the same indices
+      for (int64_t ih = ih0; ih < ih1; ih += dilationH) {
+        for (int64_t iw = iw0; iw < iw1; iw += dilationW) {
+          scalar_t* in = input_data + n * input_height * input_width * channels +
+              ih * input_width * channels + iw * channels;
+
+          iVec index_vec = iVec(static_cast<integer_t>(ih * input_width + iw));
+          int64_t d2 = 0;
+          for (; d2 < len; d2 += Vec::size()) {
+            Vec val_vec = Vec::loadu(in + d2);
+            iVec maxindex_vec = iVec::loadu(index_buffer.get() + d2);
+            Vec maxval_vec = Vec::loadu(out + d2);
+
+            // true = all ones, false = all zeros
+            Vec mask = (val_vec > maxval_vec) | (val_vec != val_vec);
+            iVec imask = vec256::cast<integer_t>(mask);
+            Vec out_vec = Vec::blendv(maxval_vec, val_vec, mask);
+            iVec ind_vec = iVec::blendv(maxindex_vec, index_vec, imask);
+
+            out_vec.store(out + d2);
+            ind_vec.store(index_buffer.get() + d2);
+          }
+          for (; d2 < size; d2++) {
+            int64_t index = ih * input_width + iw;
+            scalar_t val = in[d2];
+            int64_t maxindex = ind[d2];
+            scalar_t maxval = out[d2];
+
+            bool mask = (val > maxval) || std::isnan(val);
+            out[d2] = mask ? val : maxval;
+            ind[d2] = mask ? index : maxindex;
+          }
+        }
+      }
+
+      // convert indices from integer_t to int64_t
+      for (int64_t d3 = 0; d3 < len; d3++) {
+        ind[d3] = static_cast<int64_t>(index_buffer[d3]);
+      }
+
+      // move on to next output index
+      data_index_step(n, nbatch, oh, output_height, ow, output_width);
+    }
+  });
+
+  if (!output_.is_contiguous(memory_format)) {
+    output_.copy_(output);
+  }
+  if (!indices_.is_contiguous(memory_format)) {
+    indices_.copy_(indices);
+  }
+}
+
+void max_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    Tensor& indices,
+    const Tensor& input,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "max_pool2d_channels_last", [&] {
+    cpu_max_pool_channels_last<scalar_t>(
+        output, indices, input, kW, kH, dW, dH, padW, padH, dilationW, dilationH);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(max_pool2d_channels_last_kernel, &max_pool2d_channels_last_kernel_impl);
+
+} // namespace native
+} // namespace at
@@ -10,6 +10,56 @@ namespace at { namespace native {
 
 namespace {
 
+// The largest exponent pow_tensor_scalar_kernel unrolls into multiplications
+// for floating and integral types.
+constexpr int64_t kMaxUnrolledPowExponent = 8;
+
+// base ** exp by repeated squaring, expanded at compile time so the scalar
+// and the Vec256 lambdas of integral_pow_kernel are straight-line multiplies.
+template <int exp>
+struct IntegralPow {
+  template <typename T>
+  static inline __ubsan_ignore_signed_int_overflow__ T apply(const T& base) {
+    const T half = IntegralPow<exp / 2>::apply(base);
+    return exp % 2 == 0 ? T(half * half) : T(half * half * base);
+  }
+};
+
+template <>
+struct IntegralPow<1> {
+  template <typename T>
+  static inline T apply(const T& base) {
+    return base;
+  }
+};
+
+template <int exp, typename scalar_t>
+void integral_pow_kernel(TensorIterator& iter) {
+  using Vec = Vec256<scalar_t>;
+  cpu_kernel_vec(iter,
+    [](scalar_t base) -> scalar_t {
+      return IntegralPow<exp>::apply(base);
+    },
+    [](Vec base) -> Vec { return IntegralPow<exp>::apply(base); }
+  );
+}
+
+// Runs the unrolled kernel for 2 <= exp <= kMaxUnrolledPowExponent, returns
+// false for the other exponents.
+template <typename scalar_t>
+bool unrolled_pow_kernel(TensorIterator& iter, int64_t exp) {
+  switch (exp) {
+    case 2: integral_pow_kernel<2, scalar_t>(iter); return true;
+    case 3: integral_pow_kernel<3, scalar_t>(iter); return true;
+    case 4: integral_pow_kernel<4, scalar_t>(iter); return true;
+    case 5: integral_pow_kernel<5, scalar_t>(iter); return true;
+    case 6: integral_pow_kernel<6, scalar_t>(iter); return true;
+    case 7: integral_pow_kernel<7, scalar_t>(iter); return true;
+    case 8: integral_pow_kernel<8, scalar_t>(iter); return true;
+    default: return false;
+  }
+}
+
 void pow_tensor_tensor_kernel(TensorIterator& iter) {
   if (isFloatingType(iter.dtype()) || isComplexType(iter.dtype())) {
     AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "pow", [&]() {
@@ -47,20 +97,9 @@ void pow_tensor_scalar_kernel(TensorIterator& iter, Scalar exp_scalar) {
           },
           [](Vec base) -> Vec { return base.sqrt(); }
         );
-      } else if (exp == 2) {
-        cpu_kernel_vec(iter,
-          [](scalar_t base) -> scalar_t {
-            return base * base;
-          },
-          [](Vec base) -> Vec { return base * base; }
-        );
-      } else if (exp == 3) {
-        cpu_kernel_vec(iter,
-          [](scalar_t base) -> scalar_t {
-            return base * base * base;
-          },
-          [](Vec base) -> Vec { return base * base * base; }
-        );
+      } else if (exp >= 2 && exp <= kMaxUnrolledPowExponent &&
+                 exp == std::trunc(exp)) {
+        unrolled_pow_kernel<scalar_t>(iter, static_cast<int64_t>(exp));
       } else if (exp == -0.5) {
         cpu_kernel_vec(iter,
           [](scalar_t base) -> scalar_t {
@@ -149,6 +188,9 @@ void pow_tensor_scalar_kernel(TensorIterator& iter, Scalar exp_scalar) {
     });
   } else {
     AT_DISPATCH_INTEGRAL_TYPES(iter.dtype(), "pow", [&]() {
+      if (unrolled_pow_kernel<scalar_t>(iter, exp_scalar.to<int64_t>())) {
+        return;
+      }
       const scalar_t exp = exp_scalar.to<scalar_t>();
       cpu_kernel(iter,
         [=](scalar_t base) -> scalar_t {
@@ -0,0 +1,385 @@
+#include <ATen/native/RNN.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native { namespace {
+
+using namespace vec256;
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sigmoid(const Vec256<scalar_t>& x) {
+  const Vec256<scalar_t> one(scalar_t(1));
+  return one / (one + x.neg().exp());
+}
+
+// gates is (batch, 4 * hidden), in the order of the chunks of the weights:
+// input, forget, cell and output gates.
+void lstm_cell_epilogue_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& gates,
+    const Tensor& cx) {
+  const auto batch = gates.size(0);
+  const auto hidden = cx.size(1);
+  const auto gates_c = gates.contiguous();
+  const auto cx_c = cx.contiguous();
+  hy = at::empty_like(cx_c);
+  cy = at::empty_like(cx_c);
+  AT_DISPATCH_FLOATING_TYPES(gates.scalar_type(), "lstm_cell_epilogue", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* gates_data = gates_c.data_ptr<scalar_t>();
+    const scalar_t* cx_data = cx_c.data_ptr<scalar_t>();
+    scalar_t* hy_data = hy.data_ptr<scalar_t>();
+    scalar_t* cy_data = cy.data_ptr<scalar_t>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / (4 * hidden));
+    at::parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        const scalar_t* g = gates_data + b * 4 * hidden;
+        const scalar_t* c = cx_data + b * hidden;
+        scalar_t* h_out = hy_data + b * hidden;
+        scalar_t* c_out = cy_data + b * hidden;
+        for (int64_t j = 0; j < hidden; j += Vec::size()) {
+          const auto count = std::min<int64_t>(Vec::size(), hidden - j);
+          const auto ingate = sigmoid(Vec::loadu(g + j, count));
+          const auto forgetgate = sigmoid(Vec::loadu(g + hidden + j, count));
+          const auto cellgate = Vec::loadu(g + 2 * hidden + j, count).tanh();
+          const auto outgate = sigmoid(Vec::loadu(g + 3 * hidden + j, count));
+          const auto cell = forgetgate * Vec::loadu(c + j, count) +
+              ingate * cellgate;
+          cell.store(c_out + j, count);
+          (outgate * cell.tanh()).store(h_out + j, count);
+        }
+      }
+    });
+  });
+}
+
+// igates and hgates are (batch, 3 * hidden), in the order of the chunks of the
+// weights: reset, input and new gates.
+void gru_cell_epilogue_kernel(
+    Tensor& hy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx) {
+  const auto batch = igates.size(0);
+  const auto hidden = hx.size(1);
+  const auto igates_c = igates.contiguous();
+  const auto hgates_c = hgates.contiguous();
+  const auto hx_c = hx.contiguous();
+  hy = at::empty_like(hx_c);
+  AT_DISPATCH_FLOATING_TYPES(igates.scalar_type(), "gru_cell_epilogue", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* igates_data = igates_c.data_ptr<scalar_t>();
+    const scalar_t* hgates_data = hgates_c.data_ptr<scalar_t>();
+    const scalar_t* hx_data = hx_c.data_ptr<scalar_t>();
+    scalar_t* hy_data = hy.data_ptr<scalar_t>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / (3 * hidden));
+    at::parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        const scalar_t* ig = igates_data + b * 3 * hidden;
+        const scalar_t* hg = hgates_data + b * 3 * hidden;
+        const scalar_t* h = hx_data + b * hidden;
+        scalar_t* h_out = hy_data + b * hidden;
+        for (int64_t j = 0; j < hidden; j += Vec::size()) {
+          const auto count = std::min<int64_t>(Vec::size(), hidden - j);
+          const auto reset_gate = sigmoid(
+              Vec::loadu(ig + j, count) + Vec::loadu(hg + j, count));
+          const auto input_gate = sigmoid(
+              Vec::loadu(ig + hidden + j, count) +
+              Vec::loadu(hg + hidden + j, count));
+          const auto new_gate = (Vec::loadu(ig + 2 * hidden + j, count) +
+                                 Vec::loadu(hg + 2 * hidden + j, count) *
+                                     reset_gate)
+                                    .tanh();
+          ((Vec::loadu(h + j, count) - new_gate) * input_gate + new_gate)
+              .store(h_out + j, count);
+        }
+      }
+    });
+  });
+}
+
+// The sum of the input and hidden gates at offset in a row, plus the bias if
+// any.
+template <typename scalar_t>
+inline Vec256<scalar_t> load_gate(
+    const scalar_t* input_gates,
+    const scalar_t* hidden_gates,
+    const scalar_t* bias,
+    int64_t offset,
+    int64_t count) {
+  auto gate = Vec256<scalar_t>::loadu(input_gates + offset, count) +
+      Vec256<scalar_t>::loadu(hidden_gates + offset, count);
+  if (bias != nullptr) {
+    gate = gate + Vec256<scalar_t>::loadu(bias + offset, count);
+  }
+  return gate;
+}
+
+// The biases are only used if input_bias is defined, like in the CUDA kernels,
+// and are then summed once for the whole batch.
+Tensor fused_cell_bias(const Tensor& input_bias, const Tensor& hidden_bias) {
+  return input_bias.defined() ? (input_bias + hidden_bias).contiguous()
+                              : Tensor();
+}
+
+// The gates are (batch, 4 * hidden), and the workspace holds the activated
+// input, forget, cell and output gates in the same layout.
+void fused_lstm_cell_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    Tensor& workspace,
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias,
+    const Tensor& cx) {
+  const auto batch = input_gates.size(0);
+  const auto hidden = input_gates.size(1) / 4;
+  const auto input_gates_c = input_gates.contiguous();
+  const auto hidden_gates_c = hidden_gates.contiguous();
+  const auto bias = fused_cell_bias(input_bias, hidden_bias);
+  const auto cx_c = cx.contiguous();
+  hy = at::empty_like(cx_c);
+  cy = at::empty_like(cx_c);
+  workspace = at::empty_like(input_gates_c);
+  AT_DISPATCH_FLOATING_TYPES(input_gates.scalar_type(), "fused_lstm_cell", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* ig_data = input_gates_c.data_ptr<scalar_t>();
+    const scalar_t* hg_data = hidden_gates_c.data_ptr<scalar_t>();
+    const scalar_t* bias_data =
+        bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* cx_data = cx_c.data_ptr<scalar_t>();
+    scalar_t* hy_data = hy.data_ptr<scalar_t>();
+    scalar_t* cy_data = cy.data_ptr<scalar_t>();
+    scalar_t* workspace_data = workspace.data_ptr<scalar_t>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / (8 * hidden));
+    at::parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        const scalar_t* ig = ig_data + b * 4 * hidden;
+        const scalar_t* hg = hg_data + b * 4 * hidden;
+        scalar_t* w = workspace_data + b * 4 * hidden;
+        for (int64_t j = 0; j < hidden; j += Vec::size()) {
+          const auto count = std::min<int64_t>(Vec::size(), hidden - j);
+          auto gate = [&](int64_t k) {
+            return load_gate(ig, hg, bias_data, k * hidden + j, count);
+          };
+          const auto ingate = sigmoid(gate(0));
+          const auto forgetgate = sigmoid(gate(1));
+          const auto cellgate = gate(2).tanh();
+          const auto outgate = sigmoid(gate(3));
+          const auto cell =
+              forgetgate * Vec::loadu(cx_data + b * hidden + j, count) +
+              ingate * cellgate;
+          cell.store(cy_data + b * hidden + j, count);
+          (outgate * cell.tanh()).store(hy_data + b * hidden + j, count);
+          ingate.store(w + j, count);
+          forgetgate.store(w + hidden + j, count);
+          cellgate.store(w + 2 * hidden + j, count);
+          outgate.store(w + 3 * hidden + j, count);
+        }
+      }
+    });
+  });
+}
+
+void fused_lstm_cell_backward_kernel(
+    Tensor& grad_gates,
+    Tensor& grad_cx,
+    const Tensor& grad_hy,
+    const Tensor& grad_cy,
+    const Tensor& cx,
+    const Tensor& cy,
+    const Tensor& workspace) {
+  const auto batch = workspace.size(0);
+  const auto hidden = workspace.size(1) / 4;
+  const auto grad_hy_c = grad_hy.defined() ? grad_hy.contiguous() : Tensor();
+  const auto grad_cy_c = grad_cy.defined() ? grad_cy.contiguous() : Tensor();
+  const auto cx_c = cx.contiguous();
+  const auto cy_c = cy.contiguous();
+  const auto workspace_c = workspace.contiguous();
+  grad_gates = at::empty_like(workspace_c);
+  grad_cx = at::empty_like(cx_c);
+  AT_DISPATCH_FLOATING_TYPES(workspace.scalar_type(), "fused_lstm_cell_backward", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* grad_hy_data =
+        grad_hy_c.defined() ? grad_hy_c.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* grad_cy_data =
+        grad_cy_c.defined() ? grad_cy_c.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* cx_data = cx_c.data_ptr<scalar_t>();
+    const scalar_t* cy_data = cy_c.data_ptr<scalar_t>();
+    const scalar_t* workspace_data = workspace_c.data_ptr<scalar_t>();
+    scalar_t* grad_gates_data = grad_gates.data_ptr<scalar_t>();
+    scalar_t* grad_cx_data = grad_cx.data_ptr<scalar_t>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / (8 * hidden));
+    at::parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+      const Vec one(scalar_t(1));
+      const Vec zero(scalar_t(0));
+      for (int64_t b = begin; b < end; ++b) {
+        const scalar_t* w = workspace_data + b * 4 * hidden;
+        scalar_t* gg = grad_gates_data + b * 4 * hidden;
+        for (int64_t j = 0; j < hidden; j += Vec::size()) {
+          const auto count = std::min<int64_t>(Vec::size(), hidden - j);
+          const auto offset = b * hidden + j;
+          const auto ig = Vec::loadu(w + j, count);
+          const auto fg = Vec::loadu(w + hidden + j, count);
+          const auto cg = Vec::loadu(w + 2 * hidden + j, count);
+          const auto og = Vec::loadu(w + 3 * hidden + j, count);
+          const auto go = grad_hy_data != nullptr
+              ? Vec::loadu(grad_hy_data + offset, count)
+              : zero;
+          const auto goc = grad_cy_data != nullptr
+              ? Vec::loadu(grad_cy_data + offset, count)
+              : zero;
+          const auto tanh_cy = Vec::loadu(cy_data + offset, count).tanh();
+          const auto gcx = go * og * (one - tanh_cy * tanh_cy) + goc;
+          (gcx * cg * (one - ig) * ig).store(gg + j, count);
+          (gcx * Vec::loadu(cx_data + offset, count) * (one - fg) * fg)
+              .store(gg + hidden + j, count);
+          (gcx * ig * (one - cg * cg)).store(gg + 2 * hidden + j, count);
+          (go * tanh_cy * (one - og) * og).store(gg + 3 * hidden + j, count);
+          (gcx * fg).store(grad_cx_data + offset, count);
+        }
+      }
+    });
+  });
+}
+
+// The gates are (batch, 3 * hidden), and the workspace (batch, 5 * hidden)
+// holds the activated reset, input and new gates, hx, and the hidden gate of
+// the new gate plus its bias.
+void fused_gru_cell_kernel(
+    Tensor& hy,
+    Tensor& workspace,
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias,
+    const Tensor& hx) {
+  const auto batch = input_gates.size(0);
+  const auto hidden = input_gates.size(1) / 3;
+  const auto input_gates_c = input_gates.contiguous();
+  const auto hidden_gates_c = hidden_gates.contiguous();
+  const auto input_bias_c =
+      input_bias.defined() ? input_bias.contiguous() : Tensor();
+  const auto hidden_bias_c =
+      input_bias.defined() ? hidden_bias.contiguous() : Tensor();
+  const auto hx_c = hx.contiguous();
+  hy = at::empty_like(hx_c);
+  workspace = at::empty({batch, hidden * 5}, hx_c.options());
+  AT_DISPATCH_FLOATING_TYPES(input_gates.scalar_type(), "fused_gru_cell", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* ig_data = input_gates_c.data_ptr<scalar_t>();
+    const scalar_t* hg_data = hidden_gates_c.data_ptr<scalar_t>();
+    const scalar_t* b1 =
+        input_bias_c.defined() ? input_bias_c.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* b2 =
+        hidden_bias_c.defined() ? hidden_bias_c.data_ptr<scalar_t>() : nullptr;
+    const scalar_t* hx_data = hx_c.data_ptr<scalar_t>();
+    scalar_t* hy_data = hy.data_ptr<scalar_t>();
+    scalar_t* workspace_data = workspace.data_ptr<scalar_t>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / (8 * hidden));
+    at::parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        const scalar_t* ig = ig_data + b * 3 * hidden;
+        const scalar_t* hg = hg_data + b * 3 * hidden;
+        scalar_t* w = workspace_data + b * 5 * hidden;
+        for (int64_t j = 0; j < hidden; j += Vec::size()) {
+          const auto count = std::min<int64_t>(Vec::size(), hidden - j);
+          auto bias = [&](const scalar_t* data, int64_t k) {
+            return data != nullptr ? Vec::loadu(data + k * hidden + j, count)
+                                   : Vec(scalar_t(0));
+          };
+          const auto reset_gate = sigmoid(
+              load_gate(ig, hg, b1, j, count) + bias(b2, 0));
+          const auto input_gate = sigmoid(
+              load_gate(ig, hg, b1, hidden + j, count) +
+              bias(b2, 1));
+          const auto hn = Vec::loadu(hg + 2 * hidden + j, count) + bias(b2, 2);
+          const auto new_gate = (Vec::loadu(ig + 2 * hidden + j, count) +
+                                 bias(b1, 2) + reset_gate * hn)
+                                    .tanh();
+          const auto h = Vec::loadu(hx_data + b * hidden + j, count);
+          (new_gate + input_gate * (h - new_gate))
+              .store(hy_data + b * hidden + j, count);
+          reset_gate.store(w + j, count);
+          input_gate.store(w + hidden + j, count);
+          new_gate.store(w + 2 * hidden + j, count);
+          h.store(w + 3 * hidden + j, count);
+          hn.store(w + 4 * hidden + j, count);
+        }
+      }
+    });
+  });
+}
+
+void fused_gru_cell_backward_kernel(
+    Tensor& grad_input_gates,
+    Tensor& grad_hidden_gates,
+    Tensor& grad_hx,
+    const Tensor& grad_hy,
+    const Tensor& workspace) {
+  const auto batch = workspace.size(0);
+  const auto hidden = workspace.size(1) / 5;
+  const auto grad_hy_c = grad_hy.contiguous();
+  const auto workspace_c = workspace.contiguous();
+  grad_input_gates = at::empty({batch, hidden * 3}, workspace_c.options());
+  grad_hidden_gates = at::empty({batch, hidden * 3}, workspace_c.options());
+  grad_hx = at::empty_like(grad_hy_c);
+  AT_DISPATCH_FLOATING_TYPES(workspace.scalar_type(), "fused_gru_cell_backward", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* grad_hy_data = grad_hy_c.data_ptr<scalar_t>();
+    const scalar_t* workspace_data = workspace_c.data_ptr<scalar_t>();
+    scalar_t* gi_data = grad_input_gates.data_ptr<scalar_t>();
+    scalar_t* gh_data = grad_hidden_gates.data_ptr<scalar_t>();
+    scalar_t* grad_hx_data = grad_hx.data_ptr<scalar_t>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / (8 * hidden));
+    at::parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+      const Vec one(scalar_t(1));
+      for (int64_t b = begin; b < end; ++b) {
+        const scalar_t* w = workspace_data + b * 5 * hidden;
+        scalar_t* gi = gi_data + b * 3 * hidden;
+        scalar_t* gh = gh_data + b * 3 * hidden;
+        for (int64_t j = 0; j < hidden; j += Vec::size()) {
+          const auto count = std::min<int64_t>(Vec::size(), hidden - j);
+          const auto rg = Vec::loadu(w + j, count);
+          const auto ig = Vec::loadu(w + hidden + j, count);
+          const auto ng = Vec::loadu(w + 2 * hidden + j, count);
+          const auto hx = Vec::loadu(w + 3 * hidden + j, count);
+          const auto hn = Vec::loadu(w + 4 * hidden + j, count);
+          const auto go = Vec::loadu(grad_hy_data + b * hidden + j, count);
+          const auto gig = go * (hx - ng) * (one - ig) * ig;
+          const auto gin = go * (one - ig) * (one - ng * ng);
+          const auto grg = gin * hn * (one - rg) * rg;
+          grg.store(gi + j, count);
+          gig.store(gi + hidden + j, count);
+          gin.store(gi + 2 * hidden + j, count);
+          grg.store(gh + j, count);
+          gig.store(gh + hidden + j, count);
+          (gin * rg).store(gh + 2 * hidden + j, count);
+          (go * ig).store(grad_hx_data + b * hidden + j, count);
+        }
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(lstm_cell_epilogue_stub, &lstm_cell_epilogue_kernel);
+REGISTER_DISPATCH(gru_cell_epilogue_stub, &gru_cell_epilogue_kernel);
+REGISTER_DISPATCH(fused_lstm_cell_stub, &fused_lstm_cell_kernel);
+REGISTER_DISPATCH(fused_lstm_cell_backward_stub, &fused_lstm_cell_backward_kernel);
+REGISTER_DISPATCH(fused_gru_cell_stub, &fused_gru_cell_kernel);
+REGISTER_DISPATCH(fused_gru_cell_backward_stub, &fused_gru_cell_backward_kernel);
+
+}} // namespace at::native
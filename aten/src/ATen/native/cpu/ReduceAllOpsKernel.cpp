@@ -58,6 +58,87 @@ inline void reduce_all_impl(
   output.fill_(result);
 }
 
+// Reduces the input with two ops at once: the chunk of every thread is read
+// once, and both accumulators are updated from each vector of it.
+template <typename scalar_t, typename func_t1, typename func_t2,
+          typename vec_func_t1, typename vec_func_t2>
+inline void reduce_all_impl_vec_two_outputs(
+    Tensor& output1,
+    Tensor& output2,
+    const Tensor& input,
+    const std::pair<scalar_t, scalar_t>& ident_v,
+    func_t1 op1,
+    func_t2 op2,
+    vec_func_t1 vop1,
+    vec_func_t2 vop2) {
+  using Vec = Vec256<scalar_t>;
+  using acc_t = std::pair<scalar_t, scalar_t>;
+  const int64_t input_numel = input.numel();
+  auto input_data = input.data_ptr<scalar_t>();
+  acc_t result = at::parallel_reduce(0, input_numel, internal::GRAIN_SIZE, ident_v,
+    [&](int64_t start, int64_t end, const acc_t& ident) -> acc_t {
+      const scalar_t* data = input_data + start;
+      const int64_t size = end - start;
+      acc_t partial_out = ident;
+      int64_t d = 0;
+      if (size >= Vec::size()) {
+        Vec acc_vec1 = Vec::loadu(data);
+        Vec acc_vec2 = acc_vec1;
+        for (d = Vec::size(); d + Vec::size() <= size; d += Vec::size()) {
+          Vec data_vec = Vec::loadu(data + d);
+          acc_vec1 = vop1(acc_vec1, data_vec);
+          acc_vec2 = vop2(acc_vec2, data_vec);
+        }
+        __at_align32__ scalar_t acc_arr1[Vec::size()];
+        __at_align32__ scalar_t acc_arr2[Vec::size()];
+        acc_vec1.store(acc_arr1);
+        acc_vec2.store(acc_arr2);
+        for (int64_t i = 0; i < Vec::size(); i++) {
+          partial_out.first = op1(partial_out.first, acc_arr1[i]);
+          partial_out.second = op2(partial_out.second, acc_arr2[i]);
+        }
+      }
+      for (; d < size; d++) {
+        partial_out.first = op1(partial_out.first, data[d]);
+        partial_out.second = op2(partial_out.second, data[d]);
+      }
+      return partial_out;
+    },
+    [&](const acc_t& a, const acc_t& b) -> acc_t {
+      return {op1(a.first, b.first), op2(a.second, b.second)};
+    });
+  output1.fill_(result.first);
+  output2.fill_(result.second);
+}
+
+// For operation not support in avx/avx2
+template <typename scalar_t, typename func_t1, typename func_t2>
+inline void reduce_all_impl_two_outputs(
+    Tensor& output1,
+    Tensor& output2,
+    const Tensor& input,
+    const std::pair<scalar_t, scalar_t>& ident_v,
+    func_t1 op1,
+    func_t2 op2) {
+  using acc_t = std::pair<scalar_t, scalar_t>;
+  const int64_t input_numel = input.numel();
+  auto input_data = input.data_ptr<scalar_t>();
+  acc_t result = at::parallel_reduce(0, input_numel, internal::GRAIN_SIZE, ident_v,
+    [&](int64_t start, int64_t end, const acc_t& ident) -> acc_t {
+      acc_t partial_out = ident;
+      for (int64_t i = start; i < end; i++) {
+        partial_out.first = op1(partial_out.first, input_data[i]);
+        partial_out.second = op2(partial_out.second, input_data[i]);
+      }
+      return partial_out;
+    },
+    [&](const acc_t& a, const acc_t& b) -> acc_t {
+      return {op1(a.first, b.first), op2(a.second, b.second)};
+    });
+  output1.fill_(result.first);
+  output2.fill_(result.second);
+}
+
 static void min_all_kernel_impl(Tensor& result, const Tensor& input) {
   if (input.scalar_type() == ScalarType::Bool) {
     TensorIterator iter = TensorIteratorConfig()
@@ -108,9 +189,31 @@ static void max_all_kernel_impl(Tensor& result, const Tensor& input) {
   }
 }
 
+static void _aminmax_all_kernel_impl(Tensor& min_result, Tensor& max_result, const Tensor& input) {
+  if (input.scalar_type() == ScalarType::Long) {
+    // for int64_t, vectorized implementation have performance issue,
+    // just use scalar path
+    reduce_all_impl_two_outputs<int64_t>(min_result, max_result, input,
+      std::make_pair(upper_bound<int64_t>(), lower_bound<int64_t>()),
+      [=](int64_t a, int64_t b) -> int64_t { return min_impl(a, b); },
+      [=](int64_t a, int64_t b) -> int64_t { return max_impl(a, b); });
+  } else {
+    AT_DISPATCH_ALL_TYPES(input.scalar_type(), "_aminmax_all", [&] {
+      using Vec = vec256::Vec256<scalar_t>;
+      reduce_all_impl_vec_two_outputs<scalar_t>(min_result, max_result, input,
+        std::make_pair(upper_bound<scalar_t>(), lower_bound<scalar_t>()),
+        [=](scalar_t a, scalar_t b) -> scalar_t { return min_impl(a, b); },
+        [=](scalar_t a, scalar_t b) -> scalar_t { return max_impl(a, b); },
+        [=](Vec a, Vec b) -> Vec { return minimum(a, b); },
+        [=](Vec a, Vec b) -> Vec { return maximum(a, b); });
+    });
+  }
+}
+
 } // namespace
 
 REGISTER_DISPATCH(min_all_stub, &min_all_kernel_impl);
 REGISTER_DISPATCH(max_all_stub, &max_all_kernel_impl);
+REGISTER_DISPATCH(_aminmax_all_stub, &_aminmax_all_kernel_impl);
 
 }}
@@ -3,7 +3,9 @@
 #include <algorithm>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/functional.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/ReduceOpsUtils.h>
 #include <ATen/native/TensorIterator.h>
@@ -18,12 +20,95 @@ namespace at { namespace native { namespace {
 
 using namespace vec256;
 
-template <typename scalar_t, typename func_t>
+// Scans longer than this, of which there are fewer than threads, are split into
+// blocks that are scanned in parallel, see cpu_cum_parallel_scan.
+constexpr int64_t kParallelScanMinSize = 4 * at::internal::GRAIN_SIZE;
+
+// op over the elements of a block, starting from init_val.
+template <typename scalar_t, typename acc_t, typename op_t>
+static inline acc_t cpu_cum_block_total(
+    const scalar_t* self_data, int64_t self_dim_stride, int64_t size,
+    const op_t& op, acc_t init_val) {
+  acc_t acc = init_val;
+  for (int64_t i = 0; i < size; ++i) {
+    acc = op(acc, static_cast<acc_t>(self_data[i * self_dim_stride]));
+  }
+  return acc;
+}
+
+// Same as cpu_cum_block_total, with vec_op on contiguous blocks. Only used when
+// scalar_t is the accumulation type, so that the precision doesn't change.
+template <typename scalar_t, typename acc_t, typename op_t, typename vec_op_t>
+static inline acc_t cpu_cum_block_total_vec(
+    const scalar_t* self_data, int64_t self_dim_stride, int64_t size,
+    const op_t& op, const vec_op_t& vec_op, acc_t init_val) {
+  if (!std::is_same<scalar_t, acc_t>::value || self_dim_stride != 1) {
+    return cpu_cum_block_total(self_data, self_dim_stride, size, op, init_val);
+  }
+  return op(init_val, static_cast<acc_t>(
+      reduce_all<scalar_t>(vec_op, const_cast<scalar_t*>(self_data), size)));
+}
+
+template <typename scalar_t, typename acc_t, typename op_t>
+static inline void cpu_cum_block_scan(
+    scalar_t* result_data, int64_t result_dim_stride,
+    const scalar_t* self_data, int64_t self_dim_stride, int64_t size,
+    const op_t& op, acc_t init_val) {
+  acc_t acc = init_val;
+  for (int64_t i = 0; i < size; ++i) {
+    acc = op(acc, static_cast<acc_t>(self_data[i * self_dim_stride]));
+    result_data[i * result_dim_stride] = static_cast<scalar_t>(acc);
+  }
+}
+
+// Blocked scan of a single long dimension: the totals of the blocks are
+// computed in parallel, then each block is scanned in parallel starting from
+// the op of the totals of the blocks before it. op must be associative; the
+// result can differ in rounding from the serial scan.
+template <typename scalar_t, typename acc_t, typename op_t, typename total_t>
+static void cpu_cum_parallel_scan(
+    scalar_t* result_data, int64_t result_dim_stride,
+    const scalar_t* self_data, int64_t self_dim_stride, int64_t size,
+    const op_t& op, const total_t& block_total, acc_t init_val) {
+  const int64_t num_blocks = std::min<int64_t>(
+      at::get_num_threads(), divup(size, at::internal::GRAIN_SIZE));
+  const int64_t block_size = divup(size, num_blocks);
+
+  // The total of the last block isn't needed.
+  std::vector<acc_t> offsets(num_blocks, init_val);
+  at::parallel_for(0, num_blocks - 1, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const int64_t start = b * block_size;
+      offsets[b + 1] = block_total(
+          self_data + start * self_dim_stride, self_dim_stride,
+          std::min(block_size, size - start));
+    }
+  });
+  for (int64_t b = 1; b < num_blocks; ++b) {
+    offsets[b] = op(offsets[b - 1], offsets[b]);
+  }
+
+  at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const int64_t start = b * block_size;
+      cpu_cum_block_scan(
+          result_data + start * result_dim_stride, result_dim_stride,
+          self_data + start * self_dim_stride, self_dim_stride,
+          std::min(block_size, size - start), op, offsets[b]);
+    }
+  });
+}
+
+// Scans self along dim into result: result[i] = op(result[i - 1], self[i]),
+// starting from init_val. block_total(self_data, self_dim_stride, size) is
+// op over a block, starting from init_val.
+template <typename scalar_t, typename acc_t, typename op_t, typename total_t>
 static inline void cpu_cum_base_kernel(Tensor& result,
     const Tensor& self,
     int64_t dim,
-    const func_t& f,
-    scalar_t init_val) {
+    const op_t& op,
+    const total_t& block_total,
+    acc_t init_val) {
   if (result.sizes() != self.sizes()) {
     result.resize_as_(self);
   }
@@ -46,80 +131,88 @@ static inline void cpu_cum_base_kernel(Tensor& result,
 
   auto result_dim_stride = ensure_nonempty_stride(result, dim);
   auto self_dim_stride = ensure_nonempty_stride(self, dim);
+  const int64_t self_dim_size = ensure_nonempty_size(self, dim);
+
+  // iter runs in parallel over the scans, which leaves threads idle when there
+  // are few of them: split each scan instead.
+  const bool parallel_scan = self_dim_size >= kParallelScanMinSize &&
+      iter.numel() < at::get_num_threads() && !at::in_parallel_region();
 
   auto loop = [&](char** data, const int64_t* strides, int64_t n) {
     auto* result_data_bytes = data[0];
     const auto* self_data_bytes = data[1];
 
     for (int64_t i = 0; i < n; ++i) {
-      f(
-        (scalar_t*)result_data_bytes, result_dim_stride,
-        (scalar_t*)self_data_bytes, self_dim_stride, init_val
-      );
+      if (parallel_scan) {
+        cpu_cum_parallel_scan(
+          (scalar_t*)result_data_bytes, result_dim_stride,
+          (scalar_t*)self_data_bytes, self_dim_stride, self_dim_size,
+          op, block_total, init_val
+        );
+      } else {
+        cpu_cum_block_scan(
+          (scalar_t*)result_data_bytes, result_dim_stride,
+          (scalar_t*)self_data_bytes, self_dim_stride, self_dim_size,
+          op, init_val
+        );
+      }
       result_data_bytes += strides[0];
       self_data_bytes += strides[1];
     }
   };
 
-  iter.for_each(loop);
+  if (parallel_scan) {
+    iter.serial_for_each(loop, {0, iter.numel()});
+  } else {
+    iter.for_each(loop);
+  }
 }
 
 static void cumsum_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumsum_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number += self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 0
+    using acc_t = at::acc_type<scalar_t, false>;
+    auto op = [](acc_t a, acc_t b) -> acc_t { return a + b; };
+    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, op,
+      [&](const scalar_t* self_data, int64_t self_dim_stride, int64_t size) {
+        return cpu_cum_block_total_vec(self_data, self_dim_stride, size, op,
+          [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a + b; },
+          static_cast<acc_t>(0));
+      }, /*init_val=*/ static_cast<acc_t>(0)
     );
   });
 }
 
 static void cumprod_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumprod_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number *= self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 1
+    using acc_t = at::acc_type<scalar_t, false>;
+    auto op = [](acc_t a, acc_t b) -> acc_t { return a * b; };
+    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, op,
+      [&](const scalar_t* self_data, int64_t self_dim_stride, int64_t size) {
+        return cpu_cum_block_total_vec(self_data, self_dim_stride, size, op,
+          [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a * b; },
+          static_cast<acc_t>(1));
+      }, /*init_val=*/ static_cast<acc_t>(1)
     );
   });
 }
 
 static void logcumsumexp_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "logcumsumexp_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        scalar_t cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          scalar_t x = self_data[i * self_dim_stride];
-
-          // Reference : https://www.tensorflow.org/api_docs/python/tf/math/cumulative_logsumexp
-          auto log_add_exp = [](scalar_t x, scalar_t y) -> scalar_t {
-            return std::log1p(std::exp(std::min(x, y) - std::max(x, y))) + std::max(x, y);
-          };
-          cum_number = log_add_exp(x, cum_number);
-          result_data[i * result_dim_stride] = static_cast<scalar_t>(cum_number);
-        }
-      }, /*init_val=*/ -std::numeric_limits<scalar_t>::infinity()
+    // Reference : https://www.tensorflow.org/api_docs/python/tf/math/cumulative_logsumexp
+    auto log_add_exp = [](scalar_t x, scalar_t y) -> scalar_t {
+      return std::log1p(std::exp(std::min(x, y) - std::max(x, y))) + std::max(x, y);
+    };
+    const scalar_t init_val = -std::numeric_limits<scalar_t>::infinity();
+    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, log_add_exp,
+      [&](const scalar_t* self_data, int64_t self_dim_stride, int64_t size) {
+        return cpu_cum_block_total(self_data, self_dim_stride, size, log_add_exp, init_val);
+      }, init_val
     );
   });
 }
@@ -275,6 +368,38 @@ static void max_values_kernel_impl(TensorIterator& iter) {
   });
 }
 
+// Accumulates the min and the max of the input together, so that both are
+// reduced in a single pass with one output each
+template <typename scalar_t>
+struct MinMaxOps {
+  using acc_t = std::pair<scalar_t, scalar_t>;
+
+  acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    return {min_impl(acc.first, data), max_impl(acc.second, data)};
+  }
+
+  acc_t combine(acc_t a, acc_t b) const {
+    return {min_impl(a.first, b.first), max_impl(a.second, b.second)};
+  }
+
+  std::tuple<scalar_t, scalar_t> project(acc_t acc) const {
+    return std::make_tuple(acc.first, acc.second);
+  }
+
+  acc_t translate_idx(acc_t acc, int64_t /*base_idx*/) const {
+    return acc;
+  }
+};
+
+static void aminmax_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.dtype(), "_aminmax_cpu", [&iter] {
+    binary_kernel_reduce(
+      iter,
+      MinMaxOps<scalar_t>{},
+      std::make_pair(upper_bound<scalar_t>(), lower_bound<scalar_t>()));
+  });
+}
+
 static void argmax_kernel_impl(TensorIterator &iter) {
   AT_DISPATCH_ALL_TYPES_AND(kHalf, iter.dtype(1), "argmax_cpu", [&] {
     binary_kernel_reduce(
@@ -303,6 +428,7 @@ REGISTER_DISPATCH(and_stub, &and_kernel_impl);
 REGISTER_DISPATCH(or_stub, &or_kernel_impl);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_impl);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_impl);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_impl);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_impl);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
 REGISTER_DISPATCH(cumprod_stub, &cumprod_cpu_kernel);
@@ -2,8 +2,13 @@
 #include <ATen/native/DispatchStub.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/TensorAdvancedIndexing.h>
+#include <ATen/native/cpu/AtomicAddFloat.h>
+#include <ATen/cpu/vec256/intrinsics.h>
 #include <ATen/Parallel.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace at { namespace native {
 
 namespace {
@@ -31,6 +36,24 @@ public:
 };
 ReduceAdd reduce_add;
 
+// Only used for float and double, see scatter_add_cpu_kernel.
+class ReduceAddAtomic {
+public:
+  template <typename scalar_t>
+  void operator() (scalar_t * self_data, scalar_t * src_data) const {
+    *self_data += *src_data;
+  };
+
+  void operator() (float * self_data, float * src_data) const {
+    cpu_atomic_add_float(self_data, *src_data);
+  };
+
+  void operator() (double * self_data, double * src_data) const {
+    cpu_atomic_add_double(self_data, *src_data);
+  };
+};
+ReduceAddAtomic reduce_add_atomic;
+
 class ReduceSubtract {
 public:
   template <typename scalar_t>
@@ -211,7 +234,8 @@ struct cpu_scatter_gather_base_kernel {
             }
           }
         };
-        iter.for_each(loop);
+        // every element of the iterator loops over index_dim_size elements
+        iter.for_each(loop, divup(internal::GRAIN_SIZE, index_dim_size));
       }
     );
   }
@@ -312,13 +336,193 @@ struct cpu_scatter_gather_base_kernel {
             }
           }
         };
-        iter.for_each(loop);
+        // every element of the iterator loops over index_dim_size elements
+        iter.for_each(loop, divup(internal::GRAIN_SIZE, index_dim_size));
       }
     );
   }
 };
 
+// Note [Random gathers]
+// ~~~~~~~~~~~~~~~~~~~~~
+// index_select and gather over contiguous tensors read rows or elements of
+// self in the order of the index, which for embedding lookups or negative
+// sampling is random, so the hardware prefetcher can't help. The kernels
+// below prefetch the rows kGatherPrefetchDistance indices ahead and, for
+// rows of a single 4 or 8-byte element, load them with AVX2 gathers.
+// A same dtype gather only moves bits, so it is dispatched on the element
+// size.
+
+constexpr int64_t kGatherPrefetchDistance = 16;
+// Bytes prefetched at the start of each row.
+constexpr int64_t kGatherPrefetchBytes = 256;
+constexpr int64_t kCacheLineBytes = 64;
+// Indices bounds-checked at once before they are gathered.
+constexpr int64_t kGatherBlock = 256;
+
+inline void prefetch_read(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address, /*rw=*/0, /*locality=*/1);
+#endif
+}
+
+// out[k] = src[index[k]] for k < n, the indices being in bounds
+template <typename scalar_t>
+struct GatherElements {
+  static void apply(scalar_t* out, const scalar_t* src, const int64_t* index, int64_t n) {
+    for (int64_t k = 0; k < n; k++) {
+      out[k] = src[index[k]];
+    }
+  }
+};
+
+#if defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+
+template <>
+struct GatherElements<uint32_t> {
+  static void apply(uint32_t* out, const uint32_t* src, const int64_t* index, int64_t n) {
+    int64_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+      const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + k));
+      const __m128i v = _mm256_i64gather_epi32(reinterpret_cast<const int*>(src), idx, 4);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), v);
+    }
+    for (; k < n; k++) {
+      out[k] = src[index[k]];
+    }
+  }
+};
+
+template <>
+struct GatherElements<uint64_t> {
+  static void apply(uint64_t* out, const uint64_t* src, const int64_t* index, int64_t n) {
+    int64_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+      const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + k));
+      const __m256i v = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), idx, 8);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), v);
+    }
+    for (; k < n; k++) {
+      out[k] = src[index[k]];
+    }
+  }
+};
+
+#endif
+
+// Calls f(type) with an unsigned integer type of the given size, or returns
+// false if there is none.
+template <typename func_t>
+bool dispatch_element_size(int64_t element_size, const func_t& f) {
+  switch (element_size) {
+    case 1: f(uint8_t()); return true;
+    case 2: f(uint16_t()); return true;
+    case 4: f(uint32_t()); return true;
+    case 8: f(uint64_t()); return true;
+    default: return false;
+  }
+}
+
+// See Note [Random gathers]
+void index_select_contiguous_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  const int64_t numel = index.numel();
+  const int64_t self_dim_size = self.size(dim);
+  // self_dim_size is only 0 for 1-d self, whose slices are single elements
+  const int64_t slice_size = self_dim_size == 0 ? 1 : self.numel() / self_dim_size;
+  const int64_t element_size = self.element_size();
+  const int64_t* index_data = index.data_ptr<int64_t>();
+  const char* self_data = static_cast<const char*>(self.data_ptr());
+  char* result_data = static_cast<char*>(result.data_ptr());
+
+  if (slice_size == 1 && self.stride(dim) == 1 && result.stride(dim) == 1) {
+    const bool dispatched = dispatch_element_size(element_size, [&](auto dummy) {
+      using scalar_t = decltype(dummy);
+      const auto* src = reinterpret_cast<const scalar_t*>(self_data);
+      auto* out = reinterpret_cast<scalar_t*>(result_data);
+      at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; b += kGatherBlock) {
+          const int64_t n = std::min(kGatherBlock, end - b);
+          for (int64_t k = b; k < b + n; k++) {
+            TORCH_CHECK_INDEX((index_data[k] >= 0) && (index_data[k] < self_dim_size), "index out of range in self");
+          }
+          GatherElements<scalar_t>::apply(out + b, src, index_data + b, n);
+        }
+      });
+    });
+    if (dispatched) {
+      return;
+    }
+  }
+
+  const int64_t self_stride_bytes = self.stride(dim) * element_size;
+  const int64_t result_stride_bytes = result.stride(dim) * element_size;
+  const int64_t slice_size_bytes = slice_size * element_size;
+  const int64_t prefetch_bytes = std::min(slice_size_bytes, kGatherPrefetchBytes);
+  at::parallel_for(0, numel, std::max<int64_t>(1, internal::GRAIN_SIZE / slice_size), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      if (i + kGatherPrefetchDistance < end) {
+        const int64_t next_i = index_data[i + kGatherPrefetchDistance];
+        if (next_i >= 0 && next_i < self_dim_size) {
+          const char* next_row = self_data + next_i * self_stride_bytes;
+          for (int64_t offset = 0; offset < prefetch_bytes; offset += kCacheLineBytes) {
+            prefetch_read(next_row + offset);
+          }
+        }
+      }
+      const int64_t self_i = index_data[i];
+      TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_dim_size), "index out of range in self");
+      std::memcpy(result_data + i * result_stride_bytes, self_data + self_i * self_stride_bytes, slice_size_bytes);
+    }
+  });
+}
+
+// gather along the last dim of contiguous tensors where index has the sizes
+// of self in the other dims: row r of result gathers from row r of self.
+// Returns false when the inputs don't have this layout.
+bool gather_last_dim_contiguous(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  if (self.dim() == 0 || dim != self.dim() - 1 || index.dim() != self.dim() ||
+      !self.is_contiguous() || !index.is_contiguous() || !result.is_contiguous() ||
+      self.scalar_type() != result.scalar_type() || index.numel() == 0) {
+    return false;
+  }
+  for (int64_t d = 0; d < dim; d++) {
+    if (index.size(d) != self.size(d)) {
+      return false;
+    }
+  }
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t index_dim_size = index.size(dim);
+  const int64_t rows = index.numel() / index_dim_size;
+  const int64_t* index_data = index.data_ptr<int64_t>();
+  return dispatch_element_size(self.element_size(), [&](auto dummy) {
+    using scalar_t = decltype(dummy);
+    const auto* src = static_cast<const scalar_t*>(self.data_ptr());
+    auto* out = static_cast<scalar_t*>(result.data_ptr());
+    at::parallel_for(0, rows, divup(internal::GRAIN_SIZE, index_dim_size), [&](int64_t begin, int64_t end) {
+      for (int64_t r = begin; r < end; r++) {
+        const int64_t* row_index = index_data + r * index_dim_size;
+        for (int64_t k = 0; k < index_dim_size; k++) {
+          TORCH_CHECK(row_index[k] >= 0 && row_index[k] < self_dim_size,
+            "index ", row_index[k],
+            " is out of bounds for dimension ", dim,
+            " with size ", self_dim_size);
+        }
+        GatherElements<scalar_t>::apply(
+          out + r * index_dim_size, src + r * self_dim_size, row_index, index_dim_size);
+      }
+    });
+  });
+}
+
 void gather_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  if (index.numel() > 0) {
+    dim = maybe_wrap_dim(dim, self.dim());
+    scatter_gather_dtype_check("gather_out_cpu", result, index, self);
+    gather_shape_check(result, dim, index, self);
+    if (gather_last_dim_contiguous(result, self, dim, index)) {
+      return;
+    }
+  }
   cpu_scatter_gather_base_kernel</*is_scatter_like=*/false>()(
     result, dim, index, self,
     "gather_out_cpu", tensor_assign);
@@ -335,6 +539,37 @@ void scatter_fill_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, Sca
 }
 
 void scatter_add_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  // The kernel is parallel over the slices of index along `dim`, each of which
+  // adds into its own slice of self. When there are fewer slices than
+  // threads, e.g. for 1-d inputs, float and double slices are instead split
+  // along `dim` between the threads, and accumulated with atomic adds.
+  if (index.numel() >= internal::GRAIN_SIZE && !at::in_parallel_region() &&
+      (self.scalar_type() == ScalarType::Float || self.scalar_type() == ScalarType::Double)) {
+    dim = maybe_wrap_dim(dim, self.dim());
+    scatter_gather_dtype_check("scatter_add_", self, index, src);
+    scatter_shape_check(self, dim, index, src);
+    auto index_dim_size = ensure_nonempty_size(index, dim);
+    auto num_slices = index.numel() / index_dim_size;
+    auto num_chunks = std::min<int64_t>(
+      at::get_num_threads(), divup(index.numel(), internal::GRAIN_SIZE));
+    if (num_slices < num_chunks) {
+      auto chunk_size = divup(index_dim_size, num_chunks);
+      at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t c = begin; c < end; ++c) {
+          auto start = c * chunk_size;
+          if (start >= index_dim_size) {
+            break;
+          }
+          auto length = std::min(chunk_size, index_dim_size - start);
+          cpu_scatter_gather_base_kernel<>()(
+            self, dim, index.narrow(dim, start, length), src.narrow(dim, start, length),
+            "scatter_add_", reduce_add_atomic);
+        }
+      });
+      return;
+    }
+  }
+
   cpu_scatter_gather_base_kernel<>()(
     self, dim, index, src,
     "scatter_add_", reduce_add);
@@ -386,6 +621,7 @@ void scatter_scalar_reduce_cpu_kernel(Tensor& self, const int64_t dim, const Ten
 } // anonymous namespace
 
 REGISTER_DISPATCH(gather_stub, &gather_cpu_kernel);
+REGISTER_DISPATCH(index_select_contiguous_stub, &index_select_contiguous_cpu_kernel);
 REGISTER_DISPATCH(scatter_stub, &scatter_cpu_kernel);
 REGISTER_DISPATCH(scatter_fill_stub, &scatter_fill_cpu_kernel);
 REGISTER_DISPATCH(scatter_add_stub, &scatter_add_cpu_kernel);
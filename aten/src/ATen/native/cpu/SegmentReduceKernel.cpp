@@ -0,0 +1,85 @@
+#include <ATen/native/SegmentReduce.h>
+
+#include <limits>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+
+namespace at { namespace native {
+
+namespace {
+
+template <typename scalar_t>
+void segment_reduce_kernel_impl(
+    Tensor& output,
+    const Tensor& data,
+    const Tensor& offsets,
+    SEGMENT_REDUCTION_TYPE reduction) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t num_segments = offsets.numel() - 1;
+  const int64_t inner_size = output.numel() / num_segments;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  scalar_t* data_data = data.data_ptr<scalar_t>();
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+
+  // Each task reduces roughly GRAIN_SIZE elements of data
+  const int64_t rows_per_segment = std::max<int64_t>(data.size(0) / num_segments, 1);
+  const int64_t grain_size = std::max<int64_t>(
+      internal::GRAIN_SIZE / (rows_per_segment * inner_size), 1);
+  at::parallel_for(0, num_segments, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* output_row = output_data + i * inner_size;
+      const int64_t start = offsets_data[i];
+      const int64_t length = offsets_data[i + 1] - start;
+      // empty segments are 0 for sum, NaN for mean and -inf for max
+      const scalar_t initial = reduction == SEGMENT_REDUCTION_TYPE::MAX
+          ? -std::numeric_limits<scalar_t>::infinity()
+          : scalar_t(0);
+      std::fill(output_row, output_row + inner_size, initial);
+      for (int64_t row = start; row < start + length; row++) {
+        scalar_t* data_row = data_data + row * inner_size;
+        if (reduction == SEGMENT_REDUCTION_TYPE::MAX) {
+          vec::map2(
+              [](Vec x, Vec y) { return vec::maximum(x, y); },
+              output_row,
+              output_row,
+              data_row,
+              inner_size);
+        } else {
+          vec::map2(
+              [](Vec x, Vec y) { return x + y; },
+              output_row,
+              output_row,
+              data_row,
+              inner_size);
+        }
+      }
+      if (reduction == SEGMENT_REDUCTION_TYPE::MEAN) {
+        const scalar_t count = static_cast<scalar_t>(length);
+        vec::map(
+            [count](Vec x) { return x / Vec(count); },
+            output_row,
+            output_row,
+            inner_size);
+      }
+    }
+  });
+}
+
+void segment_reduce_kernel(
+    Tensor& output,
+    const Tensor& data,
+    const Tensor& offsets,
+    SEGMENT_REDUCTION_TYPE reduction) {
+  AT_DISPATCH_FLOATING_TYPES(data.scalar_type(), "segment_reduce_cpu", [&] {
+    segment_reduce_kernel_impl<scalar_t>(output, data, offsets, reduction);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_kernel);
+
+}} // at::native
@@ -5,10 +5,66 @@
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace at { namespace native {
 
 namespace {
 
+// Selects the k first elements of `values` according to `comp` into the
+// front of `queue`, sorted. Only the k best elements seen so far are kept,
+// in a heap whose front is the worst of them, so the slice isn't copied.
+// Large slices are split into one range per thread, whose candidates are
+// then merged.
+template <typename scalar_t, typename Comp>
+void topk_heap(
+    const TensorAccessor<scalar_t, 1>& values,
+    int64_t k,
+    const Comp& comp,
+    std::vector<std::pair<scalar_t, int64_t>>& queue) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  if (k == 0) {
+    return;
+  }
+  auto n = values.size(0);
+  auto select_range = [&](int64_t begin, int64_t end, std::vector<elem_t>& heap) {
+    heap.reserve(k);
+    for (int64_t j = begin; j < end; j++) {
+      elem_t elem(values[j], j);
+      if (static_cast<int64_t>(heap.size()) < k) {
+        heap.push_back(elem);
+        std::push_heap(heap.begin(), heap.end(), comp);
+      } else if (comp(elem, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), comp);
+        heap.back() = elem;
+        std::push_heap(heap.begin(), heap.end(), comp);
+      }
+    }
+  };
+
+  int64_t num_ranges = in_parallel_region()
+      ? 1
+      : std::min<int64_t>(get_num_threads(), n / internal::GRAIN_SIZE);
+  if (num_ranges <= 1) {
+    select_range(0, n, queue);
+    std::sort_heap(queue.begin(), queue.end(), comp);
+    return;
+  }
+
+  std::vector<std::vector<elem_t>> heaps(num_ranges);
+  int64_t range_size = divup(n, num_ranges);
+  parallel_for(0, num_ranges, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) {
+      select_range(r * range_size, std::min(n, (r + 1) * range_size), heaps[r]);
+    }
+  });
+  for (const auto& heap : heaps) {
+    queue.insert(queue.end(), heap.begin(), heap.end());
+  }
+  std::partial_sort(queue.begin(), queue.begin() + k, queue.end(), comp);
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -30,26 +86,28 @@ static void topk_kernel(
           auto use_partial_sort = k * 64 <= n;
 
           using elem_t = std::pair<scalar_t, int64_t>;
-          std::vector<elem_t> queue(n);
-          for (int64_t j = 0; j < n; j++) {
-            queue[j].first = tmp_values[j];
-            queue[j].second = j;
-          }
+          std::vector<elem_t> queue;
 
           // we want NaN to be sorted as top for numpy compatibility
           if (use_partial_sort) {
             if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
+              topk_heap(tmp_values, k,
                 [](const elem_t& x, const elem_t& y) -> bool {
                   return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
+                }, queue);
             } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
+              topk_heap(tmp_values, k,
                 [](const elem_t& x, const elem_t& y) -> bool {
                   return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
+                }, queue);
             }
           } else {
+            queue.resize(n);
+            for (int64_t j = 0; j < n; j++) {
+              queue[j].first = tmp_values[j];
+              queue[j].second = j;
+            }
+
             if (largest) {
               std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
                 [](const elem_t& x, const elem_t& y) -> bool {
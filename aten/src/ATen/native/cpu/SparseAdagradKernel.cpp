@@ -0,0 +1,127 @@
+#include <ATen/native/cpu/SparseAdagradKernel.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+template <typename scalar_t>
+void sparse_adagrad_kernel_impl(
+    Tensor& param,
+    Tensor& state_sum,
+    const Tensor& values,
+    const Tensor& rows,
+    const Tensor& order,
+    IntArrayRef segment_ends,
+    double lr,
+    double eps,
+    bool rowwise) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t row_size = values.size(1);
+  const int64_t num_segments = segment_ends.size();
+  if (num_segments == 0 || row_size == 0) {
+    return;
+  }
+  scalar_t* param_data = param.data_ptr<scalar_t>();
+  scalar_t* sum_data = state_sum.data_ptr<scalar_t>();
+  scalar_t* values_data = values.data_ptr<scalar_t>();
+  const int64_t* rows_data = rows.data_ptr<int64_t>();
+  const int64_t* order_data = order.defined() ? order.data_ptr<int64_t>() : nullptr;
+  const scalar_t lr_ = static_cast<scalar_t>(lr);
+  const scalar_t eps_ = static_cast<scalar_t>(eps);
+
+  const int64_t nnz = segment_ends[num_segments - 1];
+  const int64_t work_per_segment = std::max<int64_t>(1, nnz / num_segments * row_size);
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / work_per_segment);
+
+  at::parallel_for(0, num_segments, grain_size, [&](int64_t begin, int64_t end) {
+    // Only used for rows that appear more than once in the gradient.
+    std::vector<scalar_t> grad_buffer;
+    for (int64_t s = begin; s < end; s++) {
+      const int64_t seg_begin = s == 0 ? 0 : segment_ends[s - 1];
+      const int64_t seg_end = segment_ends[s];
+      const int64_t row = rows_data[seg_begin];
+      auto value_row = [&](int64_t j) {
+        return values_data + (order_data ? order_data[j] : j) * row_size;
+      };
+
+      scalar_t* grad = value_row(seg_begin);
+      if (seg_end - seg_begin > 1) {
+        grad_buffer.resize(row_size);
+        std::copy(grad, grad + row_size, grad_buffer.data());
+        for (int64_t j = seg_begin + 1; j < seg_end; j++) {
+          vec::map2(
+              [](Vec x, Vec y) { return x + y; },
+              grad_buffer.data(),
+              grad_buffer.data(),
+              value_row(j),
+              row_size);
+        }
+        grad = grad_buffer.data();
+      }
+
+      scalar_t* p = param_data + row * row_size;
+      if (rowwise) {
+        const scalar_t sq_sum = vec::map_reduce_all(
+            [](Vec x) { return x * x; },
+            [](Vec x, Vec y) { return x + y; },
+            grad,
+            row_size);
+        sum_data[row] += sq_sum / row_size;
+        const scalar_t step = lr_ / (std::sqrt(sum_data[row]) + eps_);
+        vec::map2(
+            [step](Vec x, Vec g) { return x - Vec(step) * g; },
+            p,
+            p,
+            grad,
+            row_size);
+        continue;
+      }
+
+      scalar_t* h = sum_data + row * row_size;
+      int64_t d = 0;
+      for (; d + Vec::size() <= row_size; d += Vec::size()) {
+        Vec g = Vec::loadu(grad + d);
+        Vec h_vec = vec::fmadd(g, g, Vec::loadu(h + d));
+        h_vec.store(h + d);
+        Vec p_vec = Vec::loadu(p + d) - Vec(lr_) * g / (h_vec.sqrt() + Vec(eps_));
+        p_vec.store(p + d);
+      }
+      for (; d < row_size; d++) {
+        h[d] += grad[d] * grad[d];
+        p[d] -= lr_ * grad[d] / (std::sqrt(h[d]) + eps_);
+      }
+    }
+  });
+}
+
+void sparse_adagrad_kernel(
+    Tensor& param,
+    Tensor& state_sum,
+    const Tensor& values,
+    const Tensor& rows,
+    const Tensor& order,
+    IntArrayRef segment_ends,
+    double lr,
+    double eps,
+    bool rowwise) {
+  AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "sparse_adagrad_cpu", [&] {
+    sparse_adagrad_kernel_impl<scalar_t>(
+        param, state_sum, values, rows, order, segment_ends, lr, eps, rowwise);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(sparse_adagrad_stub, &sparse_adagrad_kernel);
+
+}}  // namespace at::native
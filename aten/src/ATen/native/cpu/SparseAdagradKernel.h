@@ -0,0 +1,30 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Applies one Adagrad step to the rows of param touched by a sparse gradient.
+//
+// values holds one gradient row per entry of the (uncoalesced) gradient,
+// flattened to [nnz, row_size]. rows holds the row of param each entry
+// belongs to, sorted, and order maps the sorted position back to the entry
+// in values; order is undefined when values is already in sorted order.
+// segment_ends[i] is one past the last entry of the i-th distinct row, so the
+// entries of a segment are summed before the update, exactly as if the
+// gradient had been coalesced. If rowwise is true, state_sum has one
+// accumulator per row, which grows by the mean of the squared gradient row.
+using sparse_adagrad_fn = void(*)(
+    Tensor& param,
+    Tensor& state_sum,
+    const Tensor& values,
+    const Tensor& rows,
+    const Tensor& order,
+    IntArrayRef segment_ends,
+    double lr,
+    double eps,
+    bool rowwise);
+DECLARE_DISPATCH(sparse_adagrad_fn, sparse_adagrad_stub);
+
+}}  // namespace at::native
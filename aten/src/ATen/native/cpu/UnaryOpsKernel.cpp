@@ -8,8 +8,8 @@
 #include <ATen/Parallel.h>
 
 #include <ATen/cpu/vml.h>
-#include <ATen/cpu/vec256/vec256.h>
-#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/cpu/vec/functional.h>
 
 #include <ATen/native/Distributions.h>
 #include <ATen/native/TensorIterator.h>
@@ -29,17 +29,17 @@
 namespace at { namespace native {
 namespace {
 
-using namespace vec256;
+using namespace vec;
 
 static void sigmoid_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), "sigmoid_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return (static_cast<scalar_t>(1) / (static_cast<scalar_t>(1) + std::exp((-a)))); },
-        [=](Vec256<scalar_t> a) {
-          a = Vec256<scalar_t>(static_cast<scalar_t>(0)) - a;
+        [=](Vectorized<scalar_t> a) {
+          a = Vectorized<scalar_t>(static_cast<scalar_t>(0)) - a;
           a = a.exp();
-          a = Vec256<scalar_t>(static_cast<scalar_t>(1)) + a;
+          a = Vectorized<scalar_t>(static_cast<scalar_t>(1)) + a;
           a = a.reciprocal();
           return a;
         });
@@ -55,21 +55,71 @@ uint8_t abs_impl(uint8_t v) {
   return v;
 }
 
+// abs and angle of complex inputs into real outputs, see
+// unary_op_impl_with_complex_to_float_out. The contiguous parts are split
+// into vectors of real and imaginary parts, so that the op runs on full
+// vectors of the value type.
+template <typename scalar_t, typename op_t, typename vec_op_t>
+static void complex_to_real_kernel(TensorIterator& iter, op_t op, vec_op_t vec_op) {
+  using value_t = typename scalar_t::value_type;
+  using Vec = vec256::Vec256<value_t>;
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    int64_t i = 0;
+    if (strides[0] == sizeof(value_t) && strides[1] == sizeof(scalar_t)) {
+      value_t* out = reinterpret_cast<value_t*>(data[0]);
+      const value_t* in = reinterpret_cast<const value_t*>(data[1]);
+      for (; i + Vec::size() <= n; i += Vec::size()) {
+        auto re_im = vec256::deinterleave2(
+            Vec::loadu(in + 2 * i), Vec::loadu(in + 2 * i + Vec::size()));
+        vec_op(re_im.first, re_im.second).store(out + i);
+      }
+    }
+    for (; i < n; i++) {
+      *reinterpret_cast<value_t*>(data[0] + i * strides[0]) =
+          op(*reinterpret_cast<const scalar_t*>(data[1] + i * strides[1]));
+    }
+  });
+}
+
+static bool is_complex_to_real(TensorIterator& iter) {
+  return isComplexType(iter.input_dtype()) && !isComplexType(iter.dtype());
+}
+
 static void abs_kernel(TensorIterator& iter) {
+  if (is_complex_to_real(iter)) {
+    AT_DISPATCH_COMPLEX_TYPES(iter.input_dtype(), "abs_cpu", [&]() {
+      using Vec = vec256::Vec256<typename scalar_t::value_type>;
+      complex_to_real_kernel<scalar_t>(
+          iter,
+          [](scalar_t a) { return std::abs(a); },
+          [](Vec re, Vec im) { return (re * re + im * im).sqrt(); });
+    });
+    return;
+  }
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kBFloat16, kHalf, iter.dtype(), "abs_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return abs_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.abs(); });
+        [=](Vectorized<scalar_t> a) { return a.abs(); });
   });
 }
 
 static void angle_kernel(TensorIterator& iter) {
+  if (is_complex_to_real(iter)) {
+    AT_DISPATCH_COMPLEX_TYPES(iter.input_dtype(), "angle_cpu", [&]() {
+      using Vec = vec256::Vec256<typename scalar_t::value_type>;
+      complex_to_real_kernel<scalar_t>(
+          iter,
+          [](scalar_t a) { return std::arg(a); },
+          [](Vec re, Vec im) { return im.atan2(re); });
+    });
+    return;
+  }
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kBFloat16, kHalf, iter.dtype(), "angle_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return angle_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.angle(); });
+        [=](Vectorized<scalar_t> a) { return a.angle(); });
   });
 }
 
@@ -78,7 +128,7 @@ static void real_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return real_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.real(); });
+        [=](Vectorized<scalar_t> a) { return a.real(); });
   });
 }
 
@@ -87,7 +137,7 @@ static void imag_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return imag_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.imag(); });
+        [=](Vectorized<scalar_t> a) { return a.imag(); });
   });
 }
 
@@ -96,7 +146,7 @@ static void conj_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return conj_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.conj(); });
+        [=](Vectorized<scalar_t> a) { return a.conj(); });
   });
 }
 
@@ -125,7 +175,7 @@ static void frac_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return a - std::trunc(a); },
-        [=](Vec256<scalar_t> a) { return a.frac(); });
+        [=](Vectorized<scalar_t> a) { return a.frac(); });
   });
 }
 
@@ -146,7 +196,7 @@ static void reciprocal_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return static_cast<scalar_t>(1.0) / a; },
-        [=](Vec256<scalar_t> a) { return a.reciprocal(); });
+        [=](Vectorized<scalar_t> a) { return a.reciprocal(); });
   });
 }
 
@@ -155,7 +205,7 @@ static void neg_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return -a; },
-        [=](Vec256<scalar_t> a) { return a.neg(); });
+        [=](Vectorized<scalar_t> a) { return a.neg(); });
   });
 }
 
@@ -164,17 +214,17 @@ static void sign_kernel(TensorIterator& iter){
       cpu_kernel(iter, [=](bool x) -> bool { return x; });
   } else {
     AT_DISPATCH_ALL_TYPES_AND2(kBFloat16, ScalarType::Half, iter.dtype(), "sign_cpu", [&]() {
-        auto zero_vec = Vec256<scalar_t>(static_cast<scalar_t>(0));
-        auto one_vec = Vec256<scalar_t>(static_cast<scalar_t>(1));
+        auto zero_vec = Vectorized<scalar_t>(static_cast<scalar_t>(0));
+        auto one_vec = Vectorized<scalar_t>(static_cast<scalar_t>(1));
 
         cpu_kernel_vec(
             iter,
             [=](scalar_t a) -> scalar_t { return (0 < a) - (a < 0); },
-            [=](Vec256<scalar_t> self_vec){
+            [=](Vectorized<scalar_t> self_vec){
 
                 // Comparision operators returns bitmask.
-                auto left = Vec256<scalar_t>::blendv(zero_vec, one_vec, zero_vec < self_vec);
-                auto right = Vec256<scalar_t>::blendv(zero_vec, one_vec, self_vec < zero_vec);
+                auto left = Vectorized<scalar_t>::blendv(zero_vec, one_vec, zero_vec < self_vec);
+                auto right = Vectorized<scalar_t>::blendv(zero_vec, one_vec, self_vec < zero_vec);
 
                 return left - right;
             });
@@ -187,7 +237,7 @@ static void sinh_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return std::sinh(a); },
-        [=](Vec256<scalar_t> self_vec){return self_vec.sinh();});
+        [=](Vectorized<scalar_t> self_vec){return self_vec.sinh();});
   });
 }
 
@@ -196,7 +246,7 @@ static void cosh_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return std::cosh(a); },
-        [=](Vec256<scalar_t> self_vec){return self_vec.cosh();});
+        [=](Vectorized<scalar_t> self_vec){return self_vec.cosh();});
   });
 }
 
@@ -253,11 +303,11 @@ static void clamp_kernel(TensorIterator& iter, Scalar min_scalar, Scalar max_sca
     c10::scalar_value_type<scalar_t>::type (*zabs_)(scalar_t) = zabs;
     auto min = min_scalar.to<scalar_t>();
     auto max = max_scalar.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min);
-    auto max_vec = Vec256<scalar_t>(max);
+    auto min_vec = Vectorized<scalar_t>(min);
+    auto max_vec = Vectorized<scalar_t>(max);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) < zabs_(min) ? min : (zabs_(a) > zabs_(max) ? max : a); },
-     [=](Vec256<scalar_t> a) { return vec256::clamp(a, min_vec, max_vec); });
+     [=](Vectorized<scalar_t> a) { return vec::clamp(a, min_vec, max_vec); });
   });
 }
 
@@ -265,10 +315,10 @@ static void clamp_max_kernel(TensorIterator& iter, Scalar max_scalar) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "clamp_max_cpu", [&]() {
     c10::scalar_value_type<scalar_t>::type (*zabs_)(scalar_t) = zabs;
     auto max = max_scalar.to<scalar_t>();
-    auto max_vec = Vec256<scalar_t>(max);
+    auto max_vec = Vectorized<scalar_t>(max);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) > zabs_(max) ? max : a; },
-     [=](Vec256<scalar_t> a) { return vec256::clamp_max(a, max_vec); });
+     [=](Vectorized<scalar_t> a) { return vec::clamp_max(a, max_vec); });
   });
 }
 
@@ -276,10 +326,10 @@ static void clamp_min_kernel(TensorIterator& iter, Scalar min_scalar) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "clamp_min_cpu", [&]() {
     c10::scalar_value_type<scalar_t>::type (*zabs_)(scalar_t) = zabs;
     auto min = min_scalar.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min);
+    auto min_vec = Vectorized<scalar_t>(min);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) < zabs_(min) ? min : a; },
-     [=](Vec256<scalar_t> a) { return vec256::clamp_min(a, min_vec); });
+     [=](Vectorized<scalar_t> a) { return vec::clamp_min(a, min_vec); });
   });
 }
 
@@ -341,7 +391,7 @@ void bernoulli_scalar_kernel(Tensor &self, double p, c10::optional<Generator> ge
           if (!std::is_same<scalar_t, int>::value && contig) {
             scalar_t *self_seg = self_ptr + begin;
             int* tmp_seg = sample_int_ptr + begin;
-            at::vec256::convert<int, scalar_t>(tmp_seg, self_seg, len);
+            vec::convert<int, scalar_t>(tmp_seg, self_seg, len);
           }
         }
       };
@@ -410,7 +460,7 @@ static void rsqrt_kernel(TensorIterator& iter) {
         [=](scalar_t a) -> scalar_t {
           return (static_cast<scalar_t>(1)) / std::sqrt(a);
         },
-        [=](Vec256<scalar_t> a) { return a.rsqrt(); });
+        [=](Vectorized<scalar_t> a) { return a.rsqrt(); });
   });
 }
 
@@ -165,7 +165,9 @@ static void unfolded2d_copy(
     int64_t input_height,
     int64_t input_width,
     int64_t output_height,
-    int64_t output_width) {
+    int64_t output_width,
+    int64_t output_row_begin,
+    int64_t output_row_end) {
   at::parallel_for(
       0, (int64_t)n_input_plane * kH * kW, 0, [&](int64_t start, int64_t end) {
         for (auto k = start; k < end; k++) {
@@ -183,7 +185,7 @@ static void unfolded2d_copy(
               input_data + nip * ((size_t)input_height * input_width);
           if (padW > 0 || padH > 0) {
             int64_t lpad, rpad;
-            for (y = 0; y < output_height; y++) {
+            for (y = output_row_begin; y < output_row_end; y++) {
               iy = (int64_t)y * dH - padH + kh;
               if (iy < 0 || iy >= input_height) {
                 memset(
@@ -234,7 +236,7 @@ static void unfolded2d_copy(
               }
             }
           } else {
-            for (y = 0; y < output_height; y++) {
+            for (y = output_row_begin; y < output_row_end; y++) {
               iy = (int64_t)y * dH + kh;
               ix = 0 + kw;
               if (dW == 1)
@@ -293,13 +295,56 @@ void unfolded2d_copy_kernel(
             input_height,
             input_width,
             output_height,
-            output_width);
+            output_width,
+            0,
+            output_height);
+      });
+}
+
+void unfolded2d_copy_rows_kernel(
+    Tensor& finput,
+    Tensor& input,
+    int64_t kH,
+    int64_t kW,
+    int64_t dH,
+    int64_t dW,
+    int64_t padH,
+    int64_t padW,
+    int64_t n_input_plane,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t output_height,
+    int64_t output_width,
+    int64_t output_row_begin,
+    int64_t output_row_end) {
+  AT_DISPATCH_ALL_TYPES_AND(
+      at::ScalarType::BFloat16, input.scalar_type(), "unfolded2d_copy_rows", [&] {
+        scalar_t* input_data = input.data_ptr<scalar_t>();
+        scalar_t* finput_data = finput.data_ptr<scalar_t>();
+
+        unfolded2d_copy(
+            input_data,
+            finput_data,
+            kH,
+            kW,
+            dH,
+            dW,
+            padH,
+            padW,
+            n_input_plane,
+            input_height,
+            input_width,
+            output_height,
+            output_width,
+            output_row_begin,
+            output_row_end);
       });
 }
 
 } // namespace
 
 REGISTER_DISPATCH(unfolded2d_copy_stub, &unfolded2d_copy_kernel);
+REGISTER_DISPATCH(unfolded2d_copy_rows_stub, &unfolded2d_copy_rows_kernel);
 REGISTER_DISPATCH(unfolded2d_acc_stub, &unfolded2d_acc_kernel);
 
 } // namespace native
@@ -107,8 +107,73 @@ void batch_norm_cpu_inference_contiguous_kernel(Tensor& output, const Tensor& in
   });
 }
 
+/// A fast path for CPU when the input is channels last contiguous. The
+/// channels are innermost, so alpha and beta are loaded as vectors along with
+/// the input.
+template<typename scalar_t>
+void batch_norm_cpu_channels_last_impl(Tensor& output, const Tensor& input,
+    const Tensor& alpha, const Tensor& beta) {
+
+  using Vec = Vec256<scalar_t>;
+  int64_t n_channel = input.size(1);
+  int64_t n_pixel = input.numel() / n_channel;
+
+  const scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
+  const scalar_t* beta_data = beta.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+
+  // output(n, h, w, c) = input(n, h, w, c) * alpha(c) + beta(c)
+  // No need to use parallel_for as this function is supposed to be
+  // memory-limited.
+  if (n_channel != 1) {
+    const int64_t loop_size = n_channel - (n_channel % Vec::size());
+    for (int64_t i = 0; i < n_pixel; i++) {
+      const scalar_t* input_ptr = input_data + i * n_channel;
+      scalar_t* output_ptr = output_data + i * n_channel;
+      int64_t d = 0;
+      for (; d < loop_size; d += Vec::size()) {
+        Vec alpha_vec = Vec::loadu(alpha_data + d);
+        Vec beta_vec = Vec::loadu(beta_data + d);
+        Vec data_vec = Vec::loadu(input_ptr + d);
+        Vec output_vec = data_vec * alpha_vec + beta_vec;
+        output_vec.store(output_ptr + d);
+      }
+      if (n_channel - d > 0) {
+        Vec alpha_vec = Vec::loadu(alpha_data + d, n_channel - d);
+        Vec beta_vec = Vec::loadu(beta_data + d, n_channel - d);
+        Vec data_vec = Vec::loadu(input_ptr + d, n_channel - d);
+        Vec output_vec = data_vec * alpha_vec + beta_vec;
+        output_vec.store(output_ptr + d, n_channel - d);
+      }
+    }
+  } else {
+    // n_channel == 1, the terms are the same for all elements
+    const Vec alpha_vec(alpha_data[0]);
+    const Vec beta_vec(beta_data[0]);
+    const int64_t loop_size = n_pixel - (n_pixel % Vec::size());
+    int64_t d = 0;
+    for (; d < loop_size; d += Vec::size()) {
+      Vec data_vec = Vec::loadu(input_data + d);
+      Vec output_vec = data_vec * alpha_vec + beta_vec;
+      output_vec.store(output_data + d);
+    }
+    for (; d < n_pixel; d++) {
+      output_data[d] = input_data[d] * alpha_data[0] + beta_data[0];
+    }
+  }
+}
+
+void batch_norm_cpu_channels_last_kernel(Tensor& output, const Tensor& input,
+    const Tensor& alpha, const Tensor& beta) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_channels_last", [&] {
+    batch_norm_cpu_channels_last_impl<scalar_t>(output, input, alpha, beta);
+  });
+}
+
 }// anonymous namespace
 
 REGISTER_DISPATCH(batch_norm_cpu_inference_contiguous_stub, &batch_norm_cpu_inference_contiguous_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_channels_last_stub, &batch_norm_cpu_channels_last_kernel);
 
 }} // namespace at::native
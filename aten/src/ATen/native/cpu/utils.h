@@ -0,0 +1,41 @@
+#pragma once
+
+#include <utility>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Helpers to walk the indices of the outer dimensions of channels last
+// kernels, from the outermost one to the innermost one: data_index_init sets
+// them from a flat offset, data_index_step increments them by one.
+template <typename T>
+inline T data_index_init(T offset) {
+  return offset;
+}
+
+template <typename T, typename... Args>
+inline T data_index_init(T offset, T &x, const T &X, Args &&... args) {
+  offset = data_index_init(offset, std::forward<Args>(args)...);
+  x = offset % X;
+  return offset / X;
+}
+
+inline bool data_index_step() {
+  return true;
+}
+
+template <typename T, typename... Args>
+inline bool data_index_step(T &x, const T &X, Args &&... args) {
+  if (data_index_step(std::forward<Args>(args)...)) {
+    x = ((x + 1) == X) ? 0 : (x + 1);
+    return x == 0;
+  }
+  return false;
+}
+
+} // namespace
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,248 @@
+#include <ATen/native/CrossEntropyLoss.h>
+
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cuda/block_reduce.cuh>
+#include <THC/THCDeviceUtils.cuh>
+
+#include <c10/cuda/CUDAMathCompat.h>
+
+#include <limits>
+
+// See Note [Fused cross entropy] for what the kernels compute.
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int kCUDANumThreads = 256;
+
+// Merges the running logsumexp (max, sum) with another one, sum being the sum
+// of the exps of the inputs minus max.
+template <typename T>
+__device__ __forceinline__ void LogSumExpMerge(T& max, T& sum, T other_max, T other_sum) {
+  if (other_max == -std::numeric_limits<T>::infinity()) {
+    return;
+  }
+  if (max < other_max) {
+    sum = sum * c10::cuda::compat::exp(max - other_max) + other_sum;
+    max = other_max;
+  } else {
+    sum += other_sum * c10::cuda::compat::exp(other_max - max);
+  }
+}
+
+template <typename T>
+__inline__ __device__ void WarpReduceLogSumExp(T& max, T& sum) {
+#pragma unroll
+  for (int offset = (C10_WARP_SIZE >> 1); offset > 0; offset >>= 1) {
+    const T other_max = WARP_SHFL_DOWN(max, offset);
+    const T other_sum = WARP_SHFL_DOWN(sum, offset);
+    LogSumExpMerge(max, sum, other_max, other_sum);
+  }
+}
+
+// Same structure as cuda_utils::BlockReduceSum, the result is in thread 0.
+template <typename T>
+__inline__ __device__ void BlockReduceLogSumExp(T& max, T& sum, T* max_shared, T* sum_shared) {
+  const int lid = threadIdx.x % C10_WARP_SIZE;
+  const int wid = threadIdx.x / C10_WARP_SIZE;
+  WarpReduceLogSumExp(max, sum);
+  __syncthreads();
+  if (lid == 0) {
+    max_shared[wid] = max;
+    sum_shared[wid] = sum;
+  }
+  __syncthreads();
+  if (threadIdx.x < blockDim.x / C10_WARP_SIZE) {
+    max = max_shared[lid];
+    sum = sum_shared[lid];
+  } else {
+    max = -std::numeric_limits<T>::infinity();
+    sum = 0;
+  }
+  if (wid == 0) {
+    WarpReduceLogSumExp(max, sum);
+  }
+}
+
+// One block per row. Every thread keeps an online logsumexp of its strided
+// part of the row, which needs one exp per logit, and the block merges them.
+template <typename T>
+__global__ void CrossEntropyForwardCUDAKernel(
+    int64_t C,
+    int64_t ignore_index,
+    acc_type<T, true> eps,
+    const T* X,
+    const int64_t* target,
+    const T* weight,
+    const acc_type<T, true>* weight_sum,
+    T* loss,
+    acc_type<T, true>* logsumexp) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC max_shared[C10_WARP_SIZE];
+  __shared__ T_ACC sum_shared[C10_WARP_SIZE];
+  __shared__ T_ACC wx_shared[C10_WARP_SIZE];
+  const int64_t i = blockIdx.x;
+  const int64_t t = target[i];
+  if (t == ignore_index) {
+    if (threadIdx.x == 0) {
+      loss[i] = 0;
+      logsumexp[i] = 0;
+    }
+    return;
+  }
+  CUDA_KERNEL_ASSERT(t >= 0 && t < C);
+
+  const T* X_row = X + i * C;
+  T_ACC max = -std::numeric_limits<T_ACC>::infinity();
+  T_ACC sum = 0;
+  T_ACC wx = 0;
+  for (int64_t j = threadIdx.x; j < C; j += blockDim.x) {
+    const T_ACC x = static_cast<T_ACC>(X_row[j]);
+    if (x > max) {
+      sum = sum * c10::cuda::compat::exp(max - x) + T_ACC(1);
+      max = x;
+    } else {
+      sum += c10::cuda::compat::exp(x - max);
+    }
+    if (eps > 0) {
+      wx += (weight == nullptr ? T_ACC(1) : static_cast<T_ACC>(weight[j])) * x;
+    }
+  }
+  BlockReduceLogSumExp<T_ACC>(max, sum, max_shared, sum_shared);
+  if (eps > 0) {
+    wx = cuda_utils::BlockReduceSum<T_ACC>(wx, wx_shared);
+  }
+  if (threadIdx.x == 0) {
+    const T_ACC log_sum = c10::cuda::compat::log(sum);
+    const T_ACC lse = max + log_sum;
+    const T_ACC w_t = weight == nullptr ? T_ACC(1) : static_cast<T_ACC>(weight[t]);
+    T_ACC l = (T_ACC(1) - eps) * w_t *
+        ((max - static_cast<T_ACC>(X_row[t])) + log_sum);
+    if (eps > 0) {
+      const T_ACC W = weight == nullptr ? static_cast<T_ACC>(C) : *weight_sum;
+      l += eps / static_cast<T_ACC>(C) * (W * lse - wx);
+    }
+    loss[i] = static_cast<T>(l);
+    logsumexp[i] = lse;
+  }
+}
+
+template <typename T>
+__global__ void CrossEntropyBackwardCUDAKernel(
+    int64_t C,
+    int64_t ignore_index,
+    acc_type<T, true> eps,
+    const acc_type<T, true>* grad_scale,
+    const T* X,
+    const int64_t* target,
+    const T* weight,
+    const acc_type<T, true>* weight_sum,
+    const acc_type<T, true>* logsumexp,
+    T* dX) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t i = blockIdx.x;
+  const int64_t t = target[i];
+  T* dX_row = dX + i * C;
+  if (t == ignore_index) {
+    for (int64_t j = threadIdx.x; j < C; j += blockDim.x) {
+      dX_row[j] = T(0);
+    }
+    return;
+  }
+  CUDA_KERNEL_ASSERT(t >= 0 && t < C);
+
+  const T* X_row = X + i * C;
+  const T_ACC scale = grad_scale[i];
+  const T_ACC lse = logsumexp[i];
+  const T_ACC w_t = weight == nullptr ? T_ACC(1) : static_cast<T_ACC>(weight[t]);
+  const T_ACC W = weight == nullptr ? static_cast<T_ACC>(C) : *weight_sum;
+  // scale * A and scale * eps / C, A being the sum of the coefficients
+  const T_ACC scale_sum = scale * ((T_ACC(1) - eps) * w_t + eps * W / static_cast<T_ACC>(C));
+  const T_ACC scale_smooth = scale * eps / static_cast<T_ACC>(C);
+  for (int64_t j = threadIdx.x; j < C; j += blockDim.x) {
+    const T_ACC w = weight == nullptr ? T_ACC(1) : static_cast<T_ACC>(weight[j]);
+    T_ACC g = scale_sum * c10::cuda::compat::exp(static_cast<T_ACC>(X_row[j]) - lse) -
+        scale_smooth * w;
+    if (j == t) {
+      g -= scale * (T_ACC(1) - eps) * w_t;
+    }
+    dX_row[j] = static_cast<T>(g);
+  }
+}
+
+void cross_entropy_kernel_cuda(
+    Tensor& output,
+    Tensor& logsumexp,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing) {
+  const int64_t N = self.size(0);
+  const int64_t C = self.size(1);
+  // logsumexp has the accumulate type of the kernels
+  const Tensor weight_sum =
+      weight.defined() ? weight.sum(logsumexp.scalar_type()) : Tensor();
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "cross_entropy_cuda", [&] {
+    using T_ACC = acc_type<scalar_t, true>;
+    CrossEntropyForwardCUDAKernel<scalar_t>
+        <<<N, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+            C,
+            ignore_index,
+            static_cast<T_ACC>(label_smoothing),
+            self.data_ptr<scalar_t>(),
+            target.data_ptr<int64_t>(),
+            weight.defined() ? weight.data_ptr<scalar_t>() : nullptr,
+            weight_sum.defined() ? weight_sum.data_ptr<T_ACC>() : nullptr,
+            output.data_ptr<scalar_t>(),
+            logsumexp.data_ptr<T_ACC>());
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+}
+
+void cross_entropy_backward_kernel_cuda(
+    Tensor& grad_input,
+    const Tensor& grad_scale,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing,
+    const Tensor& logsumexp) {
+  const int64_t N = self.size(0);
+  const int64_t C = self.size(1);
+  // logsumexp has the accumulate type of the kernels
+  const Tensor weight_sum =
+      weight.defined() ? weight.sum(logsumexp.scalar_type()) : Tensor();
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "cross_entropy_backward_cuda", [&] {
+    using T_ACC = acc_type<scalar_t, true>;
+    CrossEntropyBackwardCUDAKernel<scalar_t>
+        <<<N, kCUDANumThreads, 0, cuda_stream>>>(
+            C,
+            ignore_index,
+            static_cast<T_ACC>(label_smoothing),
+            grad_scale.data_ptr<T_ACC>(),
+            self.data_ptr<scalar_t>(),
+            target.data_ptr<int64_t>(),
+            weight.defined() ? weight.data_ptr<scalar_t>() : nullptr,
+            weight_sum.defined() ? weight_sum.data_ptr<T_ACC>() : nullptr,
+            logsumexp.data_ptr<T_ACC>(),
+            grad_input.data_ptr<scalar_t>());
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(cross_entropy_stub, &cross_entropy_kernel_cuda);
+REGISTER_DISPATCH(cross_entropy_backward_stub, &cross_entropy_backward_kernel_cuda);
+
+} // namespace native
+} // namespace at
@@ -5,6 +5,8 @@
 #include <ATen/native/utils/ParamsHash.h>
 
 #include <list>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <string>
 #include <stdexcept>
@@ -28,6 +30,9 @@ struct CuFFTParams
   bool complex_output_;
   int64_t signal_sizes_[max_rank];
   bool onesided_;
+  // A cuFFT plan can't run on two streams at once, so each stream gets its
+  // own instance of a plan.
+  c10::StreamId stream_id_;
 };
 
 // NB: This can't be a constructor, because then CuFFTParams
@@ -51,6 +56,7 @@ static inline void setCuFFTParams(CuFFTParams* params,
     params->signal_sizes_[i] = checked_signal_sizes[i];
   }
   params->onesided_ = onesided;
+  params->stream_id_ = at::cuda::getCurrentCUDAStream().id();
 }
 
 struct CuFFTHandleDeleter {
@@ -73,6 +79,8 @@ static bool is_pow_of_two(int64_t x) {
 //   1. the plan
 //   2. whether to clone input before executing the plan
 //   3. the workspace size needed
+//   4. a mutex guarding the stream and work area set on the plan until the
+//      plan is enqueued
 //
 // This class will be the **value** in the plan cache.
 // It **owns** the raw plan via a unique_ptr.
@@ -335,10 +343,13 @@ public:
 
   int64_t workspace_size() const { return ws_size; }
 
+  std::mutex &exec_mutex() const { return exec_mutex_; }
+
 private:
   std::unique_ptr<cufftHandle, CuFFTHandleDeleter> plan_ptr;
   bool clone_input;
   int64_t ws_size;
+  mutable std::mutex exec_mutex_;
 };
 
 #if CUDA_VERSION < 10000
@@ -358,14 +369,28 @@ static_assert(CUFFT_MAX_PLAN_NUM >= 0 && CUFFT_MAX_PLAN_NUM <= std::numeric_limi
 static_assert(CUFFT_DEFAULT_CACHE_SIZE >= 0 && CUFFT_DEFAULT_CACHE_SIZE <= CUFFT_MAX_PLAN_NUM,
               "CUFFT_DEFAULT_CACHE_SIZE not in [0, CUFFT_MAX_PLAN_NUM] range");
 
+// Returns whether n has no prime factor larger than 7. cuFFT has its fastest
+// kernels for such sizes.
+static inline bool is_cufft_friendly_size(int64_t n) {
+  for (int64_t p : {2, 3, 5, 7}) {
+    while (n % p == 0) {
+      n /= p;
+    }
+  }
+  return n == 1;
+}
+
 // This cache assumes that the mapping from key to value never changes.
-// This is **NOT** thread-safe. Please use a mutex when using it **AND** the
-// value returned from try_emplace_value.
+// This is **NOT** thread-safe. Please use a mutex when using it.
+// The value returned from try_emplace_value is shared, so it stays alive when
+// evicted and may be used after the mutex is released. Executing it must then
+// hold the exec_mutex() of the config, which only contends with threads on the
+// same device and stream because the key contains the stream.
 // The contract of using this cache is that try_emplace_value should only be
 // used when the max_size is positive.
 class CuFFTParamsLRUCache {
 public:
-  using kv_t = typename std::pair<CuFFTParams, CuFFTConfig>;
+  using kv_t = typename std::pair<CuFFTParams, std::shared_ptr<const CuFFTConfig>>;
   using map_t = typename std::unordered_map<std::reference_wrapper<CuFFTParams>,
                                             typename std::list<kv_t>::iterator,
                                             ParamsHash<CuFFTParams>,
@@ -393,11 +418,11 @@ public:
 
   // If key is in this cache, return the cached config. Otherwise, emplace the
   // config in this cache using value_args and return it.
-  // Return const reference because CuFFTConfig shouldn't be tampered with once
-  // created.
+  // Return a pointer to const because CuFFTConfig shouldn't be tampered with
+  // once created.
   // This is similar to c++ 17 try_emplace.
   template<typename K, class ...VArgs>
-  const CuFFTConfig &try_emplace_value(K&& key, VArgs&&... value_args) {
+  std::shared_ptr<const CuFFTConfig> try_emplace_value(K&& key, VArgs&&... value_args) {
     AT_ASSERT(_max_size > 0);
 
     map_kkv_iter_t map_it = _cache_map.find(key);
@@ -417,9 +442,7 @@ public:
     }
 
     // construct new plan at list front, then insert into _cache_map
-    _usage_list.emplace_front(std::piecewise_construct,
-                       std::forward_as_tuple(key),
-                       std::forward_as_tuple(value_args...));
+    _usage_list.emplace_front(key, std::make_shared<CuFFTConfig>(value_args...));
     auto kv_it = _usage_list.begin();
     _cache_map.emplace(std::piecewise_construct,
                 std::forward_as_tuple(kv_it->first),
@@ -447,6 +470,34 @@ public:
 
   size_t size() const { return _cache_map.size(); }
 
+  // Returns the length to zero-pad a signal of length n to, so that signals
+  // of varying lengths share a few plans instead of each creating its own. It
+  // is the smallest last signal dimension of a cached plan in
+  // [n, n * (1 + max_padding)], or else the smallest size of at least n
+  // without prime factors above 7, so that later lengths find it cached.
+  int64_t padded_signal_size(int64_t n, double max_padding) const {
+    TORCH_CHECK(n > 0, "cuFFT padded signal size expects a positive size, but got ", n);
+    TORCH_CHECK(max_padding >= 0,
+             "cuFFT padded signal size expects a non-negative max_padding, but got ", max_padding);
+    const auto limit = static_cast<int64_t>(n * (1 + max_padding));
+    int64_t best = -1;
+    for (const auto& kv : _usage_list) {
+      const auto& params = kv.first;
+      const auto size = params.signal_sizes_[params.signal_ndim_ - 1];
+      if (size >= n && size <= limit && (best < 0 || size < best)) {
+        best = size;
+      }
+    }
+    if (best > 0) {
+      return best;
+    }
+    int64_t size = n;
+    while (!is_cufft_friendly_size(size)) {
+      size++;
+    }
+    return size;
+  }
+
   size_t max_size() const noexcept { return _max_size; }
 
   std::mutex mutex;
@@ -474,10 +525,12 @@ private:
 // (at cuda/detail/CUDAHooks.cpp), and call the hooked functions from the actual
 // native function counterparts (at native/SpectralOps.cpp), i.e.,
 // _cufft_get_plan_cache_max_size, _cufft_set_plan_cache_max_size
-// _cufft_get_plan_cache_size, and _cufft_clear_plan_cache.
+// _cufft_get_plan_cache_size, _cufft_clear_plan_cache and
+// _cufft_get_plan_cache_padded_size.
 int64_t cufft_get_plan_cache_max_size_impl(int64_t device_index);
 void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size);
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index);
 void cufft_clear_plan_cache_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_padded_size_impl(int64_t device_index, int64_t signal_size, double max_padding);
 
 }}} // namespace at::native::detail
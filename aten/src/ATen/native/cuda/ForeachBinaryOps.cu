@@ -0,0 +1,142 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+#include <functional>
+
+namespace at { namespace native {
+
+namespace {
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_binary_op(TensorList tensors, Scalar scalar) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  std::vector<at::Tensor> vec_res;
+  vec_res.reserve(tensors.size());
+  for (const auto& t: tensors) {
+    vec_res.emplace_back(at::empty_like(t));
+  }
+
+  tensor_lists.emplace_back(tensors.vec());
+  tensor_lists.emplace_back(vec_res);
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors[0].scalar_type(), "foreach_binary_op_scalar_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, true>;
+    multi_tensor_apply<2>(tensor_lists,
+                          BinaryOpScalarFunctor<scalar_t, /*depth=*/2, /*res_arg_index=*/1, Op>(),
+                          scalar.to<opmath_t>());
+  });
+  return tensor_lists[1];
+}
+
+template<template<class> class Op>
+void foreach_binary_op_(TensorList tensors, Scalar scalar) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors.vec());
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors[0].scalar_type(), "foreach_binary_op_scalar_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, true>;
+    multi_tensor_apply<1>(tensor_lists,
+                          BinaryOpScalarFunctor<scalar_t, /*depth=*/1, /*res_arg_index=*/0, Op>(),
+                          scalar.to<opmath_t>());
+  });
+}
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_binary_op(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  std::vector<at::Tensor> vec_res;
+  vec_res.reserve(tensors1.size());
+  for (const auto& t: tensors1) {
+    vec_res.emplace_back(at::empty_like(t));
+  }
+
+  tensor_lists.emplace_back(tensors1.vec());
+  tensor_lists.emplace_back(tensors2.vec());
+  tensor_lists.emplace_back(vec_res);
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors1[0].scalar_type(), "foreach_binary_op_list_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, true>;
+    multi_tensor_apply<3>(tensor_lists,
+                          BinaryOpListAlphaFunctor<scalar_t, /*depth=*/3, /*res_arg_index=*/2, Op>(),
+                          alpha.to<opmath_t>());
+  });
+  return tensor_lists[2];
+}
+
+template<template<class> class Op>
+void foreach_binary_op_(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors1.vec());
+  tensor_lists.emplace_back(tensors2.vec());
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors1[0].scalar_type(), "foreach_binary_op_list_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, true>;
+    multi_tensor_apply<2>(tensor_lists,
+                          BinaryOpListAlphaFunctor<scalar_t, /*depth=*/2, /*res_arg_index=*/0, Op>(),
+                          alpha.to<opmath_t>());
+  });
+}
+
+} // namespace
+
+#define FOREACH_BINARY_OP_SCALAR(NAME, OP)                                                    \
+void foreach_tensor_##NAME##_scalar_kernel_cuda_(TensorList tensors, Scalar scalar) {        \
+  check_foreach_api_restrictions(tensors);                                                    \
+  if (!can_use_fast_route({tensors}) || scalar.isComplex()) {                                 \
+    return at::native::foreach_tensor_##NAME##_scalar_kernel_slow_(tensors, scalar);          \
+  }                                                                                           \
+                                                                                              \
+  foreach_binary_op_<OP>(tensors, scalar);                                                    \
+}                                                                                             \
+                                                                                              \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_cuda(TensorList tensors, Scalar scalar) { \
+  check_foreach_api_restrictions(tensors);                                                    \
+  if (!can_use_fast_route({tensors}) || scalar.isComplex()) {                                 \
+    return at::native::foreach_tensor_##NAME##_scalar_kernel_slow(tensors, scalar);           \
+  }                                                                                           \
+                                                                                              \
+  return foreach_binary_op<OP>(tensors, scalar);                                              \
+}
+
+FOREACH_BINARY_OP_SCALAR(add, std::plus)
+FOREACH_BINARY_OP_SCALAR(mul, std::multiplies)
+
+void foreach_tensor_add_list_kernel_cuda_(TensorList self, TensorList other, Scalar alpha) {
+  check_foreach_api_restrictions(self, other);
+  if (!can_use_fast_route({self, other}) || alpha.isComplex()) {
+    return at::native::foreach_tensor_add_list_kernel_slow_(self, other, alpha);
+  }
+
+  foreach_binary_op_<std::plus>(self, other, alpha);
+}
+
+std::vector<Tensor> foreach_tensor_add_list_kernel_cuda(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  if (!can_use_fast_route({tensors1, tensors2}) || alpha.isComplex()) {
+    return at::native::foreach_tensor_add_list_kernel_slow(tensors1, tensors2, alpha);
+  }
+
+  return foreach_binary_op<std::plus>(tensors1, tensors2, alpha);
+}
+
+void foreach_tensor_mul_list_kernel_cuda_(TensorList self, TensorList other) {
+  check_foreach_api_restrictions(self, other);
+  if (!can_use_fast_route({self, other})) {
+    return at::native::foreach_tensor_mul_list_kernel_slow_(self, other);
+  }
+
+  foreach_binary_op_<std::multiplies>(self, other, /*alpha=*/1);
+}
+
+std::vector<Tensor> foreach_tensor_mul_list_kernel_cuda(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  if (!can_use_fast_route({tensors1, tensors2})) {
+    return at::native::foreach_tensor_mul_list_kernel_slow(tensors1, tensors2);
+  }
+
+  return foreach_binary_op<std::multiplies>(tensors1, tensors2, /*alpha=*/1);
+}
+
+}} // namespace at::native
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <ATen/AccumulateType.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+// Applies `op(r, ii)` to the elements of the chunk of the block, kILP
+// elements at a time: r[d][ii] holds an element of the d-th tensor list.
+// Only the lists in `read_mask` are loaded and only those in `write_mask`
+// are stored back, with vectorized accesses when every chunk is aligned.
+template<typename T, int depth, int read_mask, int write_mask, typename Op>
+__device__ __forceinline__ void foreach_chunk(
+    int chunk_size,
+    TensorListMetadata<depth>& tl,
+    Op op) {
+  const int tensor_loc = tl.block_to_tensor[blockIdx.x];
+  const int chunk_idx = tl.block_to_chunk[blockIdx.x];
+  const int64_t n = tl.numel_for_tensor[tensor_loc] - static_cast<int64_t>(chunk_idx) * chunk_size;
+
+  T* ptrs[depth];
+  bool all_aligned = n % kILP == 0 && chunk_size % kILP == 0;
+#pragma unroll
+  for (int d = 0; d < depth; d++) {
+    ptrs[d] = static_cast<T*>(tl.addresses[d][tensor_loc]) + static_cast<int64_t>(chunk_idx) * chunk_size;
+    all_aligned = all_aligned && is_aligned(ptrs[d]);
+  }
+
+  T r[depth][kILP];
+  if (all_aligned) {
+    for (int64_t i_start = threadIdx.x; i_start * kILP < n && i_start * kILP < chunk_size; i_start += blockDim.x) {
+#pragma unroll
+      for (int d = 0; d < depth; d++) {
+        if (read_mask & (1 << d)) {
+          load_store(r[d], ptrs[d], 0, i_start);
+        }
+      }
+#pragma unroll
+      for (int ii = 0; ii < kILP; ii++) {
+        op(r, ii);
+      }
+#pragma unroll
+      for (int d = 0; d < depth; d++) {
+        if (write_mask & (1 << d)) {
+          load_store(ptrs[d], r[d], i_start, 0);
+        }
+      }
+    }
+  } else {
+    for (int64_t i_start = 0; i_start < n && i_start < chunk_size; i_start += blockDim.x * kILP) {
+#pragma unroll
+      for (int ii = 0; ii < kILP; ii++) {
+        const int64_t i = i_start + threadIdx.x + ii * blockDim.x;
+        if (i < n && i < chunk_size) {
+#pragma unroll
+          for (int d = 0; d < depth; d++) {
+            if (read_mask & (1 << d)) {
+              r[d][ii] = ptrs[d][i];
+            }
+          }
+        }
+      }
+      // the values out of the chunk are computed but never stored
+#pragma unroll
+      for (int ii = 0; ii < kILP; ii++) {
+        op(r, ii);
+      }
+#pragma unroll
+      for (int ii = 0; ii < kILP; ii++) {
+        const int64_t i = i_start + threadIdx.x + ii * blockDim.x;
+        if (i < n && i < chunk_size) {
+#pragma unroll
+          for (int d = 0; d < depth; d++) {
+            if (write_mask & (1 << d)) {
+              ptrs[d][i] = r[d][ii];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// result = op(self, scalar), in place when res_arg_index is 0.
+template<typename T, int depth, int res_arg_index, template<class> class Op>
+struct BinaryOpScalarFunctor {
+  using opmath_t = acc_type<T, true>;
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      TensorListMetadata<depth>& tl,
+      opmath_t scalar) {
+    foreach_chunk<T, depth, /*read_mask=*/1, /*write_mask=*/1 << res_arg_index>(
+        chunk_size, tl, [&](T (*r)[kILP], int ii) {
+          r[res_arg_index][ii] = static_cast<T>(
+              Op<opmath_t>()(static_cast<opmath_t>(r[0][ii]), scalar));
+        });
+  }
+};
+
+// result = op(self, alpha * other), in place when res_arg_index is 0.
+template<typename T, int depth, int res_arg_index, template<class> class Op>
+struct BinaryOpListAlphaFunctor {
+  using opmath_t = acc_type<T, true>;
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      TensorListMetadata<depth>& tl,
+      opmath_t alpha) {
+    foreach_chunk<T, depth, /*read_mask=*/3, /*write_mask=*/1 << res_arg_index>(
+        chunk_size, tl, [&](T (*r)[kILP], int ii) {
+          r[res_arg_index][ii] = static_cast<T>(Op<opmath_t>()(
+              static_cast<opmath_t>(r[0][ii]), alpha * static_cast<opmath_t>(r[1][ii])));
+        });
+  }
+};
+
+} // namespace
+
+}} // namespace at::native
@@ -0,0 +1,178 @@
+#include <ATen/native/FusedAttention.h>
+
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace at { namespace native {
+
+namespace {
+
+// Every thread computes the output of one query, keeping the query and its
+// output row in registers, while the block streams tiles of the keys and
+// values through shared memory, so the scores never leave the chip.
+constexpr int kNumThreads = 64;
+constexpr int kKeyTileSize = 16;
+
+template <typename scalar_t, int kMaxDim>
+__global__ void fused_attention_cuda_kernel(
+    const scalar_t* __restrict__ query,
+    const scalar_t* __restrict__ key,
+    const scalar_t* __restrict__ value,
+    const scalar_t* __restrict__ mask,
+    const int64_t* __restrict__ mask_offsets,
+    int64_t mask_row_stride,
+    int64_t mask_col_stride,
+    int64_t num_queries,
+    int64_t num_keys,
+    int embed_dim,
+    int value_dim,
+    scalar_t* __restrict__ output,
+    acc_type<scalar_t, true>* __restrict__ logsumexp) {
+  using acc_t = acc_type<scalar_t, true>;
+  __shared__ acc_t key_tile[kKeyTileSize][kMaxDim];
+  __shared__ acc_t value_tile[kKeyTileSize][kMaxDim];
+  const int64_t b = blockIdx.x;
+  const int64_t i = static_cast<int64_t>(blockIdx.y) * blockDim.x + threadIdx.x;
+  const bool active = i < num_queries;
+  const acc_t neg_inf = -std::numeric_limits<acc_t>::infinity();
+
+  acc_t q[kMaxDim];
+  acc_t out[kMaxDim];
+#pragma unroll
+  for (int d = 0; d < kMaxDim; ++d) {
+    q[d] = active && d < embed_dim
+        ? static_cast<acc_t>(query[(b * num_queries + i) * embed_dim + d])
+        : acc_t(0);
+    out[d] = acc_t(0);
+  }
+  const scalar_t* mask_row = mask != nullptr && active
+      ? mask + mask_offsets[b] + i * mask_row_stride
+      : nullptr;
+  acc_t row_max = neg_inf;
+  acc_t row_sum = acc_t(0);
+
+  for (int64_t start = 0; start < num_keys; start += kKeyTileSize) {
+    const int tile_keys =
+        static_cast<int>(std::min<int64_t>(kKeyTileSize, num_keys - start));
+    for (int index = threadIdx.x; index < tile_keys * kMaxDim;
+         index += blockDim.x) {
+      const int j = index / kMaxDim;
+      const int d = index % kMaxDim;
+      const int64_t row = b * num_keys + start + j;
+      key_tile[j][d] = d < embed_dim
+          ? static_cast<acc_t>(key[row * embed_dim + d]) : acc_t(0);
+      value_tile[j][d] = d < value_dim
+          ? static_cast<acc_t>(value[row * value_dim + d]) : acc_t(0);
+    }
+    __syncthreads();
+    if (active) {
+      for (int j = 0; j < tile_keys; ++j) {
+        acc_t score = acc_t(0);
+#pragma unroll
+        for (int d = 0; d < kMaxDim; ++d) {
+          score += q[d] * key_tile[j][d];
+        }
+        if (mask_row != nullptr) {
+          score += static_cast<acc_t>(mask_row[(start + j) * mask_col_stride]);
+        }
+        if (score == neg_inf) {
+          continue;
+        }
+        if (score > row_max) {
+          // Rescale what has been accumulated with the previous maximum
+          const acc_t correction = ::exp(row_max - score);
+          row_sum *= correction;
+#pragma unroll
+          for (int d = 0; d < kMaxDim; ++d) {
+            out[d] *= correction;
+          }
+          row_max = score;
+        }
+        const acc_t p = ::exp(score - row_max);
+        row_sum += p;
+#pragma unroll
+        for (int d = 0; d < kMaxDim; ++d) {
+          out[d] += p * value_tile[j][d];
+        }
+      }
+    }
+    __syncthreads();
+  }
+
+  if (active) {
+#pragma unroll
+    for (int d = 0; d < kMaxDim; ++d) {
+      if (d < value_dim) {
+        output[(b * num_queries + i) * value_dim + d] =
+            static_cast<scalar_t>(out[d] / row_sum);
+      }
+    }
+    logsumexp[b * num_queries + i] = row_max + ::log(row_sum);
+  }
+}
+
+template <typename scalar_t, int kMaxDim>
+void launch_fused_attention_kernel(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask,
+    const Tensor& mask_offsets,
+    Tensor& output,
+    Tensor& logsumexp) {
+  using acc_t = acc_type<scalar_t, true>;
+  const int64_t num_queries = query.size(-2);
+  const int64_t batch = logsumexp.numel() / num_queries;
+  const dim3 grid(batch, (num_queries + kNumThreads - 1) / kNumThreads);
+  fused_attention_cuda_kernel<scalar_t, kMaxDim>
+      <<<grid, kNumThreads, 0, at::cuda::getCurrentCUDAStream()>>>(
+          query.data_ptr<scalar_t>(),
+          key.data_ptr<scalar_t>(),
+          value.data_ptr<scalar_t>(),
+          attn_mask.defined() ? attn_mask.data_ptr<scalar_t>() : nullptr,
+          attn_mask.defined() ? mask_offsets.data_ptr<int64_t>() : nullptr,
+          attn_mask.defined() ? attn_mask.stride(-2) : 0,
+          attn_mask.defined() ? attn_mask.stride(-1) : 0,
+          num_queries,
+          key.size(-2),
+          query.size(-1),
+          value.size(-1),
+          output.data_ptr<scalar_t>(),
+          logsumexp.data_ptr<acc_t>());
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+void fused_attention_cuda(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& attn_mask,
+    const Tensor& mask_offsets,
+    Tensor& output,
+    Tensor& logsumexp) {
+  const int64_t max_dim = std::max(query.size(-1), value.size(-1));
+  TORCH_INTERNAL_ASSERT(max_dim <= kFusedAttentionMaxCUDAHeadDim);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(query.scalar_type(), "fused_attention_cuda", [&] {
+    if (max_dim <= 32) {
+      launch_fused_attention_kernel<scalar_t, 32>(
+          query, key, value, attn_mask, mask_offsets, output, logsumexp);
+    } else if (max_dim <= 64) {
+      launch_fused_attention_kernel<scalar_t, 64>(
+          query, key, value, attn_mask, mask_offsets, output, logsumexp);
+    } else {
+      launch_fused_attention_kernel<scalar_t, kFusedAttentionMaxCUDAHeadDim>(
+          query, key, value, attn_mask, mask_offsets, output, logsumexp);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(fused_attention_stub, &fused_attention_cuda);
+
+}} // at::native
@@ -0,0 +1,143 @@
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+namespace {
+
+// Lists: params, grads, exp_avgs, exp_avg_sqs.
+template<typename T>
+struct FusedAdamFunctor {
+  using opmath_t = acc_type<T, true>;
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      TensorListMetadata<4>& tl,
+      opmath_t beta1,
+      opmath_t beta2,
+      opmath_t eps,
+      opmath_t weight_decay,
+      opmath_t step_size,
+      opmath_t bias_correction2_sqrt) {
+    foreach_chunk<T, /*depth=*/4, /*read_mask=*/0b1111, /*write_mask=*/0b1101>(
+        chunk_size, tl, [&](T (*r)[kILP], int ii) {
+          opmath_t param = static_cast<opmath_t>(r[0][ii]);
+          opmath_t grad = static_cast<opmath_t>(r[1][ii]);
+          opmath_t exp_avg = static_cast<opmath_t>(r[2][ii]);
+          opmath_t exp_avg_sq = static_cast<opmath_t>(r[3][ii]);
+          if (weight_decay != 0) {
+            grad += weight_decay * param;
+          }
+          exp_avg = beta1 * exp_avg + (1 - beta1) * grad;
+          exp_avg_sq = beta2 * exp_avg_sq + (1 - beta2) * grad * grad;
+          const opmath_t denom = ::sqrt(exp_avg_sq) / bias_correction2_sqrt + eps;
+          param -= step_size * exp_avg / denom;
+          r[0][ii] = static_cast<T>(param);
+          r[2][ii] = static_cast<T>(exp_avg);
+          r[3][ii] = static_cast<T>(exp_avg_sq);
+        });
+  }
+};
+
+// Lists: params, grads, momentum_buffers.
+template<typename T>
+struct FusedSGDFunctor {
+  using opmath_t = acc_type<T, true>;
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      TensorListMetadata<3>& tl,
+      opmath_t lr,
+      opmath_t momentum,
+      opmath_t dampening,
+      opmath_t weight_decay,
+      bool nesterov) {
+    foreach_chunk<T, /*depth=*/3, /*read_mask=*/0b111, /*write_mask=*/0b101>(
+        chunk_size, tl, [&](T (*r)[kILP], int ii) {
+          opmath_t param = static_cast<opmath_t>(r[0][ii]);
+          opmath_t d_p = static_cast<opmath_t>(r[1][ii]);
+          opmath_t buf = static_cast<opmath_t>(r[2][ii]);
+          if (weight_decay != 0) {
+            d_p += weight_decay * param;
+          }
+          buf = momentum * buf + (1 - dampening) * d_p;
+          d_p = nesterov ? d_p + momentum * buf : buf;
+          param -= lr * d_p;
+          r[0][ii] = static_cast<T>(param);
+          r[2][ii] = static_cast<T>(buf);
+        });
+  }
+};
+
+} // namespace
+
+void _fused_adam_cuda_(
+    TensorList self,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay,
+    int64_t step) {
+  check_foreach_api_restrictions(self, grads);
+  check_foreach_api_restrictions(self, exp_avgs);
+  check_foreach_api_restrictions(self, exp_avg_sqs);
+  if (!can_use_fast_route({self, grads, exp_avgs, exp_avg_sqs})) {
+    return at::native::_fused_adam_slow_(
+        self, grads, exp_avgs, exp_avg_sqs, lr, beta1, beta2, eps, weight_decay, step);
+  }
+  TORCH_CHECK(step > 0, "_fused_adam_ expects a positive step, got ", step);
+
+  const auto bias_correction1 = 1 - std::pow(beta1, step);
+  const auto bias_correction2 = 1 - std::pow(beta2, step);
+  std::vector<std::vector<at::Tensor>> tensor_lists{
+      self.vec(), grads.vec(), exp_avgs.vec(), exp_avg_sqs.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_adam_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, true>;
+    multi_tensor_apply<4>(tensor_lists,
+                          FusedAdamFunctor<scalar_t>(),
+                          static_cast<opmath_t>(beta1),
+                          static_cast<opmath_t>(beta2),
+                          static_cast<opmath_t>(eps),
+                          static_cast<opmath_t>(weight_decay),
+                          static_cast<opmath_t>(lr / bias_correction1),
+                          static_cast<opmath_t>(std::sqrt(bias_correction2)));
+  });
+}
+
+void _fused_sgd_cuda_(
+    TensorList self,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov) {
+  check_foreach_api_restrictions(self, grads);
+  check_foreach_api_restrictions(self, momentum_buffers);
+  if (!can_use_fast_route({self, grads, momentum_buffers})) {
+    return at::native::_fused_sgd_slow_(
+        self, grads, momentum_buffers, lr, momentum, dampening, weight_decay, nesterov);
+  }
+
+  std::vector<std::vector<at::Tensor>> tensor_lists{
+      self.vec(), grads.vec(), momentum_buffers.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_sgd_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, true>;
+    multi_tensor_apply<3>(tensor_lists,
+                          FusedSGDFunctor<scalar_t>(),
+                          static_cast<opmath_t>(lr),
+                          static_cast<opmath_t>(momentum),
+                          static_cast<opmath_t>(dampening),
+                          static_cast<opmath_t>(weight_decay),
+                          nesterov);
+  });
+}
+
+}} // namespace at::native
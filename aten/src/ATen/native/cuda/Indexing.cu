@@ -16,6 +16,7 @@
 #include <thrust/execution_policy.h>
 #include <thrust/sort.h>
 #include <THC/THCAtomics.cuh>
+#include <ATen/native/cuda/SortedIndexSum.cuh>
 
 #include <c10/macros/Macros.h>
 
@@ -459,6 +460,16 @@ Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const
   if (sliceSize == 0) {
     return self;
   }
+
+  if (use_sorted_index_sum(self.scalar_type(), numIndex, selfAddDimSize)) {
+    // The slices along `dim` are the rows of the reduction.
+    auto source_rows = source_.transpose(0, dim).contiguous().view({numIndex, -1});
+    auto sums = sorted_index_sum_cuda(source_rows, index, selfAddDimSize);
+    auto self_t = self_.transpose(0, dim);
+    self_t.add_(sums.view(self_t.sizes()));
+    return self;
+  }
+
   const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
   bool indContig = index.is_contiguous();
 
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cuda/MemoryAccess.cuh>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <vector>
+
+namespace at { namespace native {
+
+// Multi tensor apply launches one kernel for the chunks of many tensors
+// instead of one kernel per tensor, which dominates the cost of elementwise
+// updates of many small tensors, like optimizer steps.
+//
+// The tensors are split into chunks of kChunkSize elements and every block
+// of a launch processes one chunk. The addresses and sizes of the tensors are
+// passed as a kernel argument, a TensorListMetadata, whose size is bounded by
+// the 4KB kernel argument limit: a launch covers at most
+// depth_to_max_tensors[depth - 1] tensors and depth_to_max_blocks[depth - 1]
+// chunks, `depth` being the number of tensor lists.
+
+namespace {
+
+constexpr int kILP = 4;
+constexpr int kChunkSize = 65536;
+constexpr int kBlockSize = 512;
+
+constexpr int depth_to_max_tensors[5] = {110, 64, 48, 36, 30};
+constexpr int depth_to_max_blocks[5] = {320, 320, 320, 320, 320};
+
+template<int n> struct TensorListMetadata {
+  void* addresses[n][depth_to_max_tensors[n - 1]];
+  int64_t numel_for_tensor[depth_to_max_tensors[n - 1]];
+  unsigned char block_to_tensor[depth_to_max_blocks[n - 1]];
+  int block_to_chunk[depth_to_max_blocks[n - 1]];
+};
+
+template<typename T>
+__device__ __forceinline__ bool is_aligned(T* p) {
+  return ((uint64_t)p) % (kILP * sizeof(T)) == 0;
+}
+
+template<typename T>
+__device__ __forceinline__ void load_store(T* dst, T* src, int64_t dst_offset, int64_t src_offset) {
+  using LT = at::native::memory::aligned_vector<T, kILP>;
+  ((LT*)dst)[dst_offset] = ((LT*)src)[src_offset];
+}
+
+template<typename T, typename U, typename... ArgTypes>
+C10_LAUNCH_BOUNDS_1(kBlockSize)
+__global__ void multi_tensor_apply_kernel(
+    T tensorListMeta,
+    U callable,
+    ArgTypes... args) {
+  // Hand the chunk information to the user-supplied functor to process however it likes.
+  callable(kChunkSize, tensorListMeta, args...);
+}
+
+} // namespace
+
+// Calls `callable(kChunkSize, metadata, args...)` in every block of the
+// launches covering the elements of the tensors of `tensor_lists`. All the
+// lists have the same number of tensors, and tensors at the same position in
+// different lists have the same number of elements.
+template<int depth, typename T, typename... ArgTypes>
+void multi_tensor_apply(
+    std::vector<std::vector<at::Tensor>>& tensor_lists,
+    T callable,
+    ArgTypes... args) {
+  TORCH_CHECK(tensor_lists.size() == depth, "Number of tensor lists has to match the depth.");
+  const auto n_tensors = tensor_lists[0].size();
+  const c10::cuda::OptionalCUDAGuard device_guard(device_of(tensor_lists[0][0]));
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  TensorListMetadata<depth> tensorListMeta;
+  int loc_block_info = 0;
+  int loc_tensor_info = 0;
+  for (size_t t = 0; t < n_tensors; t++) {
+    const auto numel = tensor_lists[0][t].numel();
+    if (numel == 0) {
+      continue;
+    }
+    tensorListMeta.numel_for_tensor[loc_tensor_info] = numel;
+    for (int d = 0; d < depth; d++) {
+      tensorListMeta.addresses[d][loc_tensor_info] = tensor_lists[d][t].data_ptr();
+    }
+    loc_tensor_info++;
+
+    const auto chunks = (numel + kChunkSize - 1) / kChunkSize;
+    for (int64_t chunk = 0; chunk < chunks; chunk++) {
+      tensorListMeta.block_to_tensor[loc_block_info] = loc_tensor_info - 1;
+      tensorListMeta.block_to_chunk[loc_block_info] = chunk;
+      loc_block_info++;
+
+      const bool tensors_full = (loc_tensor_info == depth_to_max_tensors[depth - 1] &&
+          chunk == chunks - 1);
+      const bool blocks_full = (loc_block_info == depth_to_max_blocks[depth - 1]);
+      if (tensors_full || blocks_full) {
+        multi_tensor_apply_kernel<<<loc_block_info, kBlockSize, 0, stream>>>(
+            tensorListMeta, callable, args...);
+        AT_CUDA_CHECK(cudaGetLastError());
+
+        // Reset. The current tensor carries over to the next launch if it
+        // has chunks left.
+        loc_block_info = 0;
+        if (chunk == chunks - 1) {
+          loc_tensor_info = 0;
+        } else {
+          tensorListMeta.numel_for_tensor[0] = tensorListMeta.numel_for_tensor[loc_tensor_info - 1];
+          for (int d = 0; d < depth; d++) {
+            tensorListMeta.addresses[d][0] = tensorListMeta.addresses[d][loc_tensor_info - 1];
+          }
+          loc_tensor_info = 1;
+        }
+      }
+    }
+  }
+  if (loc_block_info > 0) {
+    multi_tensor_apply_kernel<<<loc_block_info, kBlockSize, 0, stream>>>(
+        tensorListMeta, callable, args...);
+    AT_CUDA_CHECK(cudaGetLastError());
+  }
+}
+
+}} // namespace at::native
@@ -8,6 +8,7 @@
 #include <ATen/native/TensorIterator.h>
 
 #include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/cuda/SortedIndexSum.cuh>
 #include <ATen/cuda/detail/OffsetCalculator.cuh>
 #include <ATen/cuda/CUDAContext.h>
 #include <THC/THCAtomics.cuh>
@@ -302,7 +303,43 @@ void scatter_fill_cuda_kernel(Tensor& self, int64_t dim, const Tensor& index, Sc
   );
 }
 
+// scatter_add_ with sorted_index_sum_cuda: the values of src are summed into
+// the elements of a contiguous tensor of the shape of self, whose linear
+// positions are the keys of the reduction.
+static void scatter_add_sorted_cuda(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  scatter_gather_dtype_check("scatter_add_cuda_", self, index, src);
+  scatter_shape_check(self, dim, index, src);
+
+  const auto self_dim_size = self.size(dim);
+  const bool out_of_bounds = index.lt(0).logical_or_(index.ge(self_dim_size)).any().item<bool>();
+  TORCH_CHECK_INDEX(!out_of_bounds,
+                    "scatter_add_(): index out of bounds for dimension ", dim,
+                    " with size ", self_dim_size);
+
+  std::vector<int64_t> contiguous_strides(self.dim(), 1);
+  for (int64_t d = self.dim() - 2; d >= 0; d--) {
+    contiguous_strides[d] = contiguous_strides[d + 1] * self.size(d + 1);
+  }
+  auto positions = index.mul(contiguous_strides[dim]);
+  for (int64_t d = 0; d < self.dim(); d++) {
+    if (d == dim) {
+      continue;
+    }
+    std::vector<int64_t> shape(self.dim(), 1);
+    shape[d] = index.size(d);
+    positions.add_(at::arange(index.size(d), index.options()).mul_(contiguous_strides[d]).view(shape));
+  }
+  auto values = src.as_strided(index.sizes(), src.strides()).contiguous().view({-1, 1});
+
+  auto sums = sorted_index_sum_cuda(values, positions, self.numel());
+  self.add_(sums.view(self.sizes()));
+}
+
 void scatter_add_cuda_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  if (self.dim() > 0 && use_sorted_index_sum(self.scalar_type(), index.numel(), self.numel())) {
+    return scatter_add_sorted_cuda(self, dim, index, src);
+  }
   cuda_scatter_gather_base_kernel</*is_scatter_like=*/true, /*cast_to_opaque=*/false>()(
     self, dim, index, src,
     "scatter_add_cuda_", []C10_DEVICE(auto* lhs, const auto* rhs) {
@@ -0,0 +1,77 @@
+#include <ATen/native/SegmentReduce.h>
+
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+
+namespace at { namespace native {
+
+namespace {
+
+// One thread per element of the output, which reduces the column of its
+// segment. Consecutive threads read consecutive elements of each row.
+template <typename scalar_t>
+__global__ void segment_reduce_cuda_kernel(
+    scalar_t* output_data,
+    const scalar_t* data_data,
+    const int64_t* offsets_data,
+    int64_t num_segments,
+    int64_t inner_size,
+    SEGMENT_REDUCTION_TYPE reduction) {
+  using accscalar_t = at::acc_type<scalar_t, /*is_cuda=*/true>;
+  int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
+  int64_t stride = blockDim.x * gridDim.x;
+  for (; index < num_segments * inner_size; index += stride) {
+    const int64_t segment = index / inner_size;
+    const int64_t column = index % inner_size;
+    const int64_t start = offsets_data[segment];
+    const int64_t end = offsets_data[segment + 1];
+    // empty segments are 0 for sum, NaN for mean and -inf for max
+    accscalar_t result = reduction == SEGMENT_REDUCTION_TYPE::MAX
+        ? -std::numeric_limits<accscalar_t>::infinity()
+        : accscalar_t(0);
+    for (int64_t row = start; row < end; row++) {
+      const accscalar_t value = data_data[row * inner_size + column];
+      if (reduction == SEGMENT_REDUCTION_TYPE::MAX) {
+        if (at::_isnan(value) || value > result) {
+          result = value;
+        }
+      } else {
+        result += value;
+      }
+    }
+    if (reduction == SEGMENT_REDUCTION_TYPE::MEAN) {
+      result /= static_cast<accscalar_t>(end - start);
+    }
+    output_data[index] = static_cast<scalar_t>(result);
+  }
+}
+
+void segment_reduce_kernel(
+    Tensor& output,
+    const Tensor& data,
+    const Tensor& offsets,
+    SEGMENT_REDUCTION_TYPE reduction) {
+  const int64_t num_segments = offsets.numel() - 1;
+  const int64_t inner_size = output.numel() / num_segments;
+  const int64_t block = 512;
+  const int64_t grid = std::min<int64_t>((output.numel() + block - 1) / block, 2048L);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(data.scalar_type(), "segment_reduce_cuda", [&] {
+    segment_reduce_cuda_kernel<scalar_t><<<grid, block, 0, at::cuda::getCurrentCUDAStream()>>>(
+        output.data_ptr<scalar_t>(),
+        data.data_ptr<scalar_t>(),
+        offsets.data_ptr<int64_t>(),
+        num_segments,
+        inner_size,
+        reduction);
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_kernel);
+
+}} // at::native
@@ -160,6 +160,18 @@ inline dim3 SoftMax_getBlockSize(int ILP, uint64_t dim_size) {
   return dim3(block_size);
 }
 
+// Whether the kernels keeping a row in shared memory can be used: the row
+// must fit in shared memory next to the reduction buffer, and all the rows of
+// `data` and `other` must be aligned for loads and stores of ILP elements.
+inline bool SoftMax_canUseSmem(int ILP, int64_t dim_size, size_t elem_size,
+                               size_t reduction_smem_size, const void* data, const void* other) {
+  const size_t max_smem = at::cuda::getCurrentDeviceProperties()->sharedMemPerBlock;
+  return dim_size * elem_size + reduction_smem_size <= max_smem &&
+      dim_size % ILP == 0 &&
+      reinterpret_cast<uintptr_t>(data) % ALIGN_BYTES == 0 &&
+      reinterpret_cast<uintptr_t>(other) % ALIGN_BYTES == 0;
+}
+
 template<typename T>
 struct Add {
   __device__ __forceinline__ T operator()(T a, T b) const {
@@ -682,6 +694,113 @@ cunn_SoftMaxBackward(scalar_t *gradInput, outscalar_t *output, outscalar_t *grad
   }
 }
 
+// Same as cunn_SoftMaxForward, but the row is read from global memory once,
+// with vectorized loads, and kept in shared memory for the reductions and
+// the epilogue, which long rows otherwise read three times. Requires the
+// rows to be aligned and their size to be a multiple of ILP.
+template <int ILP, typename scalar_t, typename accscalar_t, typename outscalar_t, template <typename, typename, typename> class Epilogue>
+__global__ void
+cunn_SoftMaxForwardSmem(outscalar_t *output, scalar_t *input, int classes)
+{
+  using LoadT = at::native::memory::aligned_vector<scalar_t, ILP>;
+  using StoreT = at::native::memory::aligned_vector<outscalar_t, ILP>;
+
+  // the row is followed by the reduction buffer
+  extern __shared__ unsigned char smem[];
+  auto row = reinterpret_cast<LoadT*>(smem);
+  auto sdata = reinterpret_cast<accscalar_t*>(smem + classes * sizeof(scalar_t));
+
+  input += blockIdx.x * classes;
+  output += blockIdx.x * classes;
+  const int vec_classes = classes / ILP;
+
+  // load the row while finding the max
+  MaxFloat<scalar_t, accscalar_t> max_op;
+  accscalar_t threadMax = -at::numeric_limits<accscalar_t>::max();
+  for (int offset = threadIdx.x; offset < vec_classes; offset += blockDim.x) {
+    LoadT v = reinterpret_cast<LoadT*>(input)[offset];
+    row[offset] = v;
+    #pragma unroll
+    for (int j = 0; j < ILP; ++j) {
+      threadMax = max_op(threadMax, v.val[j]);
+    }
+  }
+  accscalar_t max_k = blockReduce<Max, accscalar_t>(
+      sdata, threadMax, Max<accscalar_t>(), -at::numeric_limits<accscalar_t>::max());
+
+  // blockReduce synchronizes, so the whole row is visible from here on
+  SumExpFloat<scalar_t, accscalar_t> sum_exp_op(max_k);
+  accscalar_t threadExp = static_cast<accscalar_t>(0);
+  for (int offset = threadIdx.x; offset < vec_classes; offset += blockDim.x) {
+    LoadT v = row[offset];
+    #pragma unroll
+    for (int j = 0; j < ILP; ++j) {
+      threadExp = sum_exp_op(threadExp, v.val[j]);
+    }
+  }
+  accscalar_t sumAll = blockReduce<Add, accscalar_t>(
+      sdata, threadExp, Add<accscalar_t>(), static_cast<accscalar_t>(0));
+
+  Epilogue<scalar_t, accscalar_t, outscalar_t> epilogue(max_k, sumAll);
+
+  for (int offset = threadIdx.x; offset < vec_classes; offset += blockDim.x) {
+    LoadT v = row[offset];
+    StoreT out;
+    #pragma unroll
+    for (int j = 0; j < ILP; ++j) {
+      out.val[j] = epilogue(v.val[j]);
+    }
+    reinterpret_cast<StoreT*>(output)[offset] = out;
+  }
+}
+
+// Same as cunn_SoftMaxBackward, but gradOutput is read from global memory
+// once and kept in shared memory between the reduction and the epilogue.
+// Requires the rows to be aligned and their size to be a multiple of ILP.
+template <int ILP, typename scalar_t, typename accscalar_t, typename outscalar_t, template<typename, typename, typename> class Epilogue>
+__global__ void
+cunn_SoftMaxBackwardSmem(scalar_t *gradInput, outscalar_t *output, outscalar_t *gradOutput, int classes)
+{
+  using gradInputT = at::native::memory::aligned_vector<scalar_t, ILP>;
+  using outputT = at::native::memory::aligned_vector<outscalar_t, ILP>;
+
+  // the row of gradOutput is followed by the reduction buffer
+  extern __shared__ unsigned char smem[];
+  auto row = reinterpret_cast<outputT*>(smem);
+  auto sdata = reinterpret_cast<accscalar_t*>(smem + classes * sizeof(outscalar_t));
+
+  gradInput += blockIdx.x * classes;
+  output += blockIdx.x * classes;
+  gradOutput += blockIdx.x * classes;
+  const int vec_classes = classes / ILP;
+
+  AddFloat<outscalar_t, accscalar_t> add_op;
+  accscalar_t threadSum = accscalar_t(0);
+  for (int offset = threadIdx.x; offset < vec_classes; offset += blockDim.x) {
+    outputT dY = reinterpret_cast<outputT*>(gradOutput)[offset];
+    row[offset] = dY;
+    #pragma unroll
+    for (int j = 0; j < ILP; ++j) {
+      threadSum = add_op(threadSum, dY.val[j]);
+    }
+  }
+  accscalar_t sum_k = blockReduce<Add, accscalar_t>(
+        sdata, threadSum, Add<accscalar_t>(), accscalar_t(0));
+
+  Epilogue<scalar_t, accscalar_t, outscalar_t> epilogue(sum_k);
+
+  for (int offset = threadIdx.x; offset < vec_classes; offset += blockDim.x) {
+    outputT Y = reinterpret_cast<outputT*>(output)[offset];
+    outputT dY = row[offset];
+    gradInputT dX;
+    #pragma unroll
+    for (int j = 0; j < ILP; ++j) {
+      dX.val[j] = epilogue(dY.val[j], Y.val[j]);
+    }
+    reinterpret_cast<gradInputT*>(gradInput)[offset] = dX;
+  }
+}
+
 template<template<typename, typename, typename> class Epilogue, bool is_log_softmax>
 Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_to_float){
   if (half_to_float) AT_ASSERTM(input_.scalar_type() == ScalarType::Half,"conversion is supported for Half type only");
@@ -716,10 +835,18 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
         } else {
           constexpr int ILP = sizeof(float4) / sizeof(scalar_t);
           dim3 block = SoftMax_getBlockSize(ILP, dim_size);
-          cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
-            <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
-              output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size
-          );
+          if (SoftMax_canUseSmem(ILP, dim_size, sizeof(scalar_t), block.x * sizeof(accscalar_t),
+                                 input.data_ptr(), output.data_ptr())) {
+            cunn_SoftMaxForwardSmem<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
+              <<<grid, block, dim_size * sizeof(scalar_t) + block.x * sizeof(accscalar_t), stream>>>(
+                output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size
+            );
+          } else {
+            cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
+              <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
+                output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size
+            );
+          }
         }
       } else {
         if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
@@ -728,10 +855,18 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
         } else {
           constexpr int ILP = sizeof(float4) / sizeof(accscalar_t);
           dim3 block = SoftMax_getBlockSize(ILP, dim_size);
-          cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
-            <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
-              output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size
-          );
+          if (SoftMax_canUseSmem(ILP, dim_size, sizeof(scalar_t), block.x * sizeof(accscalar_t),
+                                 input.data_ptr(), output.data_ptr())) {
+            cunn_SoftMaxForwardSmem<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
+              <<<grid, block, dim_size * sizeof(scalar_t) + block.x * sizeof(accscalar_t), stream>>>(
+                output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size
+            );
+          } else {
+            cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
+              <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
+                output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size
+            );
+          }
         }
       }
       });
@@ -806,10 +941,19 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
       } else {
         constexpr int ILP = sizeof(float4) / sizeof(scalar_t);
         dim3 block = SoftMax_getBlockSize(ILP, dim_size);
-        cunn_SoftMaxBackward<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
-         <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
-            gI.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), dim_size
-        );
+        if (SoftMax_canUseSmem(ILP, dim_size, sizeof(scalar_t), block.x * sizeof(accscalar_t),
+                               grad.data_ptr(), output.data_ptr()) &&
+            reinterpret_cast<uintptr_t>(gI.data_ptr()) % ALIGN_BYTES == 0) {
+          cunn_SoftMaxBackwardSmem<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
+           <<<grid, block, dim_size * sizeof(scalar_t) + block.x * sizeof(accscalar_t), stream>>>(
+              gI.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), dim_size
+          );
+        } else {
+          cunn_SoftMaxBackward<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
+           <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
+              gI.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), dim_size
+          );
+        }
       }
     } else {
       if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
@@ -818,10 +962,19 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
       } else {
         constexpr int ILP = sizeof(float4) / sizeof(accscalar_t);
         dim3 block = SoftMax_getBlockSize(ILP, dim_size);
-        cunn_SoftMaxBackward<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
-         <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
-            gI.data_ptr<scalar_t>(), output.data_ptr<accscalar_t>(), grad.data_ptr<accscalar_t>(), dim_size
-        );
+        if (SoftMax_canUseSmem(ILP, dim_size, sizeof(accscalar_t), block.x * sizeof(accscalar_t),
+                               grad.data_ptr(), output.data_ptr()) &&
+            reinterpret_cast<uintptr_t>(gI.data_ptr()) % ALIGN_BYTES == 0) {
+          cunn_SoftMaxBackwardSmem<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
+           <<<grid, block, dim_size * sizeof(accscalar_t) + block.x * sizeof(accscalar_t), stream>>>(
+              gI.data_ptr<scalar_t>(), output.data_ptr<accscalar_t>(), grad.data_ptr<accscalar_t>(), dim_size
+          );
+        } else {
+          cunn_SoftMaxBackward<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
+           <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
+              gI.data_ptr<scalar_t>(), output.data_ptr<accscalar_t>(), grad.data_ptr<accscalar_t>(), dim_size
+          );
+        }
       }
     }
     });
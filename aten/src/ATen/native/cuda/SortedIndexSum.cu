@@ -0,0 +1,48 @@
+#include <ATen/native/cuda/SortedIndexSum.cuh>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
+#include <THC/THCThrustAllocator.cuh>
+
+#include <thrust/execution_policy.h>
+#include <thrust/sort.h>
+
+namespace at {
+namespace native {
+
+Tensor sorted_index_sum_cuda(const Tensor& src, const Tensor& index, int64_t num_rows) {
+  TORCH_INTERNAL_ASSERT(src.dim() == 2 && src.is_contiguous());
+  const int64_t num_indices = index.numel();
+  TORCH_INTERNAL_ASSERT(num_indices == src.size(0) && num_indices > 0);
+
+  auto sorted_indices = index.reshape(-1).clone(LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto orig_indices = at::empty_like(sorted_indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  {
+    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+    auto policy = thrust::cuda::par(allocator).on(at::cuda::getCurrentCUDAStream());
+    using device_ptr = thrust::device_ptr<int64_t>;
+
+    auto count_iter = thrust::counting_iterator<int64_t>(0);
+    auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
+    thrust::copy(policy, count_iter, count_iter + num_indices, orig_data);
+
+    // The radix sort of the integer keys is stable, so the rows of a run are
+    // always summed in the same order.
+    auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
+    thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data);
+  }
+
+  // The segmented reduction doesn't check the indices, which the atomic
+  // kernels do.
+  const auto bounds = at::stack({sorted_indices[0], sorted_indices[-1]}).cpu();
+  const auto min_index = bounds[0].item<int64_t>();
+  const auto max_index = bounds[1].item<int64_t>();
+  TORCH_CHECK_INDEX(min_index >= 0 && max_index < num_rows,
+                    "index ", min_index < 0 ? min_index : max_index,
+                    " is out of bounds for dimension with size ", num_rows);
+
+  return embedding_backward_cuda_kernel(
+      src, orig_indices, sorted_indices, /*count=*/Tensor(), num_rows);
+}
+
+}} // namespace at::native
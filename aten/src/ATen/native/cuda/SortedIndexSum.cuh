@@ -0,0 +1,35 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// index_add_ and scatter_add_ accumulate with atomics, which is not
+// deterministic for floating point types and is slow when many values go to
+// the same rows. sorted_index_sum_cuda is the alternative: the indices are
+// sorted and the rows of each run of equal indices are summed by the
+// segmented reduction of embedding_backward_cuda_kernel.
+
+// Values per destination row from which the atomics contend enough for the
+// sort to pay off.
+constexpr int64_t kSortedIndexSumMinValuesPerRow = 16;
+
+// Whether accumulating `num_indices` values into `num_rows` rows should use
+// sorted_index_sum_cuda: in deterministic mode, or when there are many
+// values per row. Integer atomics are deterministic, so only floating point
+// types are concerned.
+inline bool use_sorted_index_sum(ScalarType dtype, int64_t num_indices, int64_t num_rows) {
+  if (num_indices == 0 ||
+      (dtype != kHalf && dtype != kFloat && dtype != kDouble)) {
+    return false;
+  }
+  return globalContext().deterministic() ||
+      num_indices >= kSortedIndexSumMinValuesPerRow * num_rows;
+}
+
+// Returns the [num_rows, src.size(1)] tensor whose row i is the sum of the
+// rows j of the contiguous 2-d `src` with index[j] == i.
+Tensor sorted_index_sum_cuda(const Tensor& src, const Tensor& index, int64_t num_rows);
+
+}} // namespace at::native
@@ -187,11 +187,15 @@ static inline Tensor _run_cufft(
 
   // set output
   auto output = at::empty(output_sizes, input.options());
+  auto ws = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
+
+  // The stream and work area are state of the plan, so they are only held
+  // until the plan is enqueued. Configs from the cache are per stream, hence
+  // this only waits on other threads that use the same stream.
+  std::unique_lock<std::mutex> exec_lock(config.exec_mutex());
 
   // set to current stream
   CUFFT_CHECK(cufftSetStream(plan, at::cuda::getCurrentCUDAStream()));
-
-  auto ws = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
   CUFFT_CHECK(cufftSetWorkArea(plan, ws.data_ptr()));
 
   // run
@@ -234,6 +238,7 @@ static inline Tensor _run_cufft(
   CUFFT_CHECK(cufftXtExec(plan, input.data_ptr(), output.data_ptr(),
     inverse ? CUFFT_INVERSE : CUFFT_FORWARD));
 #endif
+  exec_lock.unlock();
 
   // rescale if needed by normalized flag or inverse transform
   auto size_last_signal_dim = checked_signal_sizes[signal_ndim - 1];
@@ -318,6 +323,16 @@ void cufft_clear_plan_cache_impl(int64_t device_index) {
   return cufft_get_plan_cache(device_index).clear();
 }
 
+int64_t cufft_get_plan_cache_padded_size_impl(int64_t device_index, int64_t signal_size, double max_padding) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_get_plan_cache_padded_size: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  CuFFTParamsLRUCache& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  return plan_cache.padded_signal_size(signal_size, max_padding);
+}
+
 } // namespace at::native::detail
 
 // cuFFT
@@ -366,17 +381,25 @@ Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
 
   // This read is not locked for perf reason. Shouldn't matter too much because
   // we check again after acquiring the lock.
+  //
+  // The cache lock is only held for the lookup. The config is shared, so it
+  // outlives an eviction by another thread while this one runs it.
   if (plan_cache.max_size() > 0) {
     CuFFTParams params;
     setCuFFTParams(&params, input, signal_ndim, complex_input,
       complex_output, checked_signal_sizes, onesided);
-    std::lock_guard<std::mutex> guard(plan_cache.mutex);
-    if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
-      const CuFFTConfig &config = plan_cache.try_emplace_value(std::move(params),
-                                             input, signal_ndim, complex_input,
-                                             complex_output, checked_signal_sizes,
-                                             onesided, output_sizes);
-      return _run_cufft(config, input, signal_ndim, complex_input,
+    std::shared_ptr<const CuFFTConfig> config;
+    {
+      std::lock_guard<std::mutex> guard(plan_cache.mutex);
+      if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
+        config = plan_cache.try_emplace_value(std::move(params),
+                                              input, signal_ndim, complex_input,
+                                              complex_output, checked_signal_sizes,
+                                              onesided, output_sizes);
+      }
+    }
+    if (config) {
+      return _run_cufft(*config, input, signal_ndim, complex_input,
                         complex_output, inverse, checked_signal_sizes, normalized,
                         onesided, output_sizes, input_was_cloned);
     }
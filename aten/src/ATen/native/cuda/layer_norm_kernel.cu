@@ -5,7 +5,9 @@
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/detail/IndexUtils.cuh>
+#include <ATen/native/cuda/MemoryAccess.cuh>
 #include <ATen/native/cuda/block_reduce.cuh>
 #include <THC/THCDeviceUtils.cuh>
 
@@ -71,6 +73,75 @@ __global__ void LayerNormForwardCUDAKernel(
   }
 }
 
+// Computes the moments of a row and normalizes it in one kernel. The row is
+// read from global memory once, with vectorized loads, and kept in shared
+// memory between the two steps. Requires N to be a multiple of vec_size and
+// X and Y to be aligned for vectorized accesses.
+template <typename T, int vec_size>
+__global__ void LayerNormFusedForwardCUDAKernel(
+    int64_t N,
+    T eps,
+    const T* X,
+    const T* gamma,
+    const T* beta,
+    T* mean,
+    T* rstd,
+    T* Y) {
+  using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, vec_size>;
+  __shared__ T_ACC m_shared[C10_WARP_SIZE];
+  __shared__ T_ACC v_shared[C10_WARP_SIZE];
+  __shared__ T_ACC stats_shared[2];
+  extern __shared__ unsigned char row_shared[];
+  vec_t* row = reinterpret_cast<vec_t*>(row_shared);
+  const int64_t i = blockIdx.x;
+  const int64_t vec_N = N / vec_size;
+  const vec_t* X_vec = reinterpret_cast<const vec_t*>(X + i * N);
+  vec_t* Y_vec = reinterpret_cast<vec_t*>(Y + i * N);
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t j = threadIdx.x; j < vec_N; j += blockDim.x) {
+    const vec_t v = X_vec[j];
+    row[j] = v;
+#pragma unroll
+    for (int k = 0; k < vec_size; ++k) {
+      const T_ACC x = static_cast<T_ACC>(v.val[k]);
+      sum1 += x;
+      sum2 += x * x;
+    }
+  }
+  sum1 = cuda_utils::BlockReduceSum<T_ACC>(sum1, m_shared);
+  sum2 = cuda_utils::BlockReduceSum<T_ACC>(sum2, v_shared);
+  if (threadIdx.x == 0) {
+    const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
+    sum1 *= scale;
+    sum2 = c10::cuda::compat::max(sum2 * scale - sum1 * sum1, T_ACC(0));
+    mean[i] = sum1;
+    rstd[i] = c10::cuda::compat::rsqrt(sum2 + static_cast<T_ACC>(eps));
+    // normalize with the rounded statistics, as LayerNormForwardCUDAKernel
+    stats_shared[0] = static_cast<T_ACC>(mean[i]);
+    stats_shared[1] = static_cast<T_ACC>(rstd[i]);
+  }
+  __syncthreads();
+  const T_ACC mean_v = stats_shared[0];
+  const T_ACC rstd_v = stats_shared[1];
+  for (int64_t j = threadIdx.x; j < vec_N; j += blockDim.x) {
+    const vec_t v = row[j];
+    vec_t out;
+#pragma unroll
+    for (int k = 0; k < vec_size; ++k) {
+      const int64_t index = j * vec_size + k;
+      const T_ACC gamma_v =
+          gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[index]);
+      const T_ACC beta_v =
+          beta == nullptr ? T_ACC(0) : static_cast<T_ACC>(beta[index]);
+      out.val[k] =
+          (static_cast<T_ACC>(v.val[k]) - mean_v) * rstd_v * gamma_v + beta_v;
+    }
+    Y_vec[j] = out;
+  }
+}
+
 template <typename T>
 __global__ void ComputeInternalGradientsCUDAKernel(
     int64_t N,
@@ -147,6 +218,79 @@ __global__ void LayerNormBackwardCUDAKenrel(
   }
 }
 
+// Computes dX in one kernel, fusing ComputeInternalGradientsCUDAKernel,
+// ComputeGradientFusedParamsCUDAKernel and LayerNormBackwardCUDAKenrel: the
+// rows of dY and X are read from global memory once, with vectorized loads,
+// and kept in shared memory. Requires N to be a multiple of vec_size and dY,
+// X and dX to be aligned for vectorized accesses.
+template <typename T, int vec_size>
+__global__ void LayerNormFusedBackwardCUDAKernel(
+    int64_t N,
+    const T* dY,
+    const T* X,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    T* dX) {
+  using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, vec_size>;
+  __shared__ T_ACC ds_shared[C10_WARP_SIZE];
+  __shared__ T_ACC db_shared[C10_WARP_SIZE];
+  __shared__ T_ACC params_shared[2];
+  extern __shared__ unsigned char rows_shared[];
+  const int64_t i = blockIdx.x;
+  const int64_t vec_N = N / vec_size;
+  vec_t* dY_row = reinterpret_cast<vec_t*>(rows_shared);
+  vec_t* X_row = dY_row + vec_N;
+  const vec_t* dY_vec = reinterpret_cast<const vec_t*>(dY + i * N);
+  const vec_t* X_vec = reinterpret_cast<const vec_t*>(X + i * N);
+  vec_t* dX_vec = reinterpret_cast<vec_t*>(dX + i * N);
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t j = threadIdx.x; j < vec_N; j += blockDim.x) {
+    const vec_t dy = dY_vec[j];
+    const vec_t x = X_vec[j];
+    dY_row[j] = dy;
+    X_row[j] = x;
+#pragma unroll
+    for (int k = 0; k < vec_size; ++k) {
+      const int64_t index = j * vec_size + k;
+      const T_ACC gamma_v =
+          gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[index]);
+      sum1 += static_cast<T_ACC>(dy.val[k]) * static_cast<T_ACC>(x.val[k]) *
+          gamma_v;
+      sum2 += static_cast<T_ACC>(dy.val[k]) * gamma_v;
+    }
+  }
+  sum1 = cuda_utils::BlockReduceSum<T_ACC>(sum1, ds_shared);
+  sum2 = cuda_utils::BlockReduceSum<T_ACC>(sum2, db_shared);
+  const T_ACC rstd_v = static_cast<T_ACC>(rstd[i]);
+  if (threadIdx.x == 0) {
+    const T_ACC mean_v = static_cast<T_ACC>(mean[i]);
+    const T_ACC s = T_ACC(1) / static_cast<T_ACC>(N);
+    const T_ACC a = (sum2 * mean_v - sum1) * rstd_v * rstd_v * rstd_v * s;
+    params_shared[0] = a;
+    params_shared[1] = -(a * mean_v + sum2 * rstd_v * s);
+  }
+  __syncthreads();
+  const T_ACC b = params_shared[0];
+  const T_ACC c = params_shared[1];
+  for (int64_t j = threadIdx.x; j < vec_N; j += blockDim.x) {
+    const vec_t dy = dY_row[j];
+    const vec_t x = X_row[j];
+    vec_t dx;
+#pragma unroll
+    for (int k = 0; k < vec_size; ++k) {
+      const int64_t index = j * vec_size + k;
+      const T_ACC gamma_v =
+          gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[index]);
+      dx.val[k] = rstd_v * static_cast<T_ACC>(dy.val[k]) * gamma_v +
+          b * static_cast<T_ACC>(x.val[k]) + c;
+    }
+    dX_vec[j] = dx;
+  }
+}
+
 template <typename T>
 __global__ void GammaBetaBackwardSimpleCUDAKernel(
     int64_t M,
@@ -254,6 +398,24 @@ __global__ void GammaBetaBackwardCUDAKernel(
   }
 }
 
+// Whether the fused kernels, which keep `num_rows` rows of N elements of type
+// T in shared memory, can be used for the given pointers.
+template <typename T>
+bool CanUseFusedKernel(int64_t N, int num_rows, std::initializer_list<const void*> ptrs) {
+  constexpr int kVecSize = sizeof(float4) / sizeof(T);
+  if (N % kVecSize != 0 ||
+      num_rows * N * sizeof(T) >
+          at::cuda::getCurrentDeviceProperties()->sharedMemPerBlock) {
+    return false;
+  }
+  for (const void* ptr : ptrs) {
+    if (reinterpret_cast<uintptr_t>(ptr) % sizeof(float4) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <typename T>
 void LayerNormKernelImplInternal(
     const Tensor& X,
@@ -275,6 +437,22 @@ void LayerNormKernelImplInternal(
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  if (CanUseFusedKernel<T>(N, 1, {X_data, Y_data})) {
+    constexpr int kVecSize = sizeof(float4) / sizeof(T);
+    LayerNormFusedForwardCUDAKernel<T, kVecSize>
+        <<<M, cuda_utils::kCUDABlockReduceNumThreads, N * sizeof(T),
+           cuda_stream>>>(
+            N,
+            eps,
+            X_data,
+            gamma_data,
+            beta_data,
+            mean_data,
+            rstd_data,
+            Y_data);
+    AT_CUDA_CHECK(cudaGetLastError());
+    return;
+  }
   RowwiseMomentsCUDAKernel<T>
       <<<M, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
           N, eps, X_data, mean_data, rstd_data);
@@ -328,7 +506,14 @@ void LayerNormBackwardKernelImplInternal(
       gamma.defined() ? gamma.template data_ptr<T>() : nullptr;
   T* dX_data = dX->defined() ? dX->template data_ptr<T>() : nullptr;
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
-  if (dX_data != nullptr) {
+  if (dX_data != nullptr &&
+      CanUseFusedKernel<T>(N, 2, {dY_data, X_data, dX_data})) {
+    constexpr int kVecSize = sizeof(float4) / sizeof(T);
+    LayerNormFusedBackwardCUDAKernel<T, kVecSize>
+        <<<M, cuda_utils::kCUDABlockReduceNumThreads, 2 * N * sizeof(T),
+           cuda_stream>>>(
+            N, dY_data, X_data, mean_data, rstd_data, gamma_data, dX_data);
+  } else if (dX_data != nullptr) {
     const auto kAccType = (X.scalar_type() == kHalf || X.scalar_type() == kBFloat16) ? kFloat : X.scalar_type();
     Tensor ds = at::empty({M}, X.options().dtype(kAccType));
     Tensor db = at::empty({M}, X.options().dtype(kAccType));
@@ -7,6 +7,7 @@
 #include <ATen/cuda/CUDAConfig.h>
 #include <ATen/cuda/Exceptions.h>
 #include <ATen/native/ConvUtils.h>
+#include <ATen/native/cudnn/ConvBenchmarkCache.h>
 
 #if !AT_CUDNN_ENABLED()
 
@@ -70,12 +71,21 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
   AT_ERROR("cudnn_convolution_transpose_backward: ATen not compiled with cuDNN support");
 }
 
+int64_t cudnn_save_conv_benchmark_cache(const std::string& path) {
+  AT_ERROR("cudnn_save_conv_benchmark_cache: ATen not compiled with cuDNN support");
+}
+
+int64_t cudnn_load_conv_benchmark_cache(const std::string& path) {
+  AT_ERROR("cudnn_load_conv_benchmark_cache: ATen not compiled with cuDNN support");
+}
+
 }}
 
 #else  // AT_CUDNN_ENABLED
 
 #include <THC/THC.h>
 
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cudnn/cudnn-wrapper.h>
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
@@ -84,6 +94,8 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 
 #include <ATen/TensorUtils.h>
 
+#include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <iterator>
 #include <sstream>
@@ -292,12 +304,110 @@ struct BenchmarkCache {
     std::lock_guard<std::mutex> guard(mutex);
     map[params] = results;
   }
+
+  // ConvolutionParams and the cuDNN perf structs are PODs, and the params
+  // are zeroed before being set, so the entries are written as raw bytes.
+  int64_t save(std::ostream& out) {
+    std::lock_guard<std::mutex> guard(mutex);
+    uint64_t size = map.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    for (const auto& entry : map) {
+      out.write(reinterpret_cast<const char*>(&entry.first), sizeof(entry.first));
+      out.write(reinterpret_cast<const char*>(&entry.second), sizeof(entry.second));
+    }
+    return size;
+  }
+
+  int64_t load(std::istream& in) {
+    uint64_t size = 0;
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    std::vector<std::pair<ConvolutionParams, T>> entries(in ? size : 0);
+    for (auto& entry : entries) {
+      in.read(reinterpret_cast<char*>(&entry.first), sizeof(entry.first));
+      in.read(reinterpret_cast<char*>(&entry.second), sizeof(entry.second));
+    }
+    TORCH_CHECK(in, "cudnn_load_conv_benchmark_cache: truncated file");
+    std::lock_guard<std::mutex> guard(mutex);
+    for (const auto& entry : entries) {
+      map[entry.first] = entry.second;
+    }
+    return size;
+  }
 };
 
 BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+namespace {
+
+constexpr char kBenchmarkCacheMagic[] = "PYTORCH_CUDNN_CONV_BENCHMARK_CACHE";
+constexpr uint32_t kBenchmarkCacheFormatVersion = 1;
+
+// What the cached algorithms depend on besides the ConvolutionParams. The
+// sizes of the structs guard against reading a file of another build.
+std::string benchmarkCacheKey() {
+  std::ostringstream key;
+  key << kBenchmarkCacheMagic << " " << kBenchmarkCacheFormatVersion
+      << " cudnn " << cudnnGetVersion()
+      << " gpu " << at::cuda::getCurrentDeviceProperties()->name
+      << " sizes " << sizeof(ConvolutionParams)
+      << " " << sizeof(cudnnConvolutionFwdAlgoPerf_t)
+      << " " << sizeof(cudnnConvolutionBwdDataAlgoPerf_t)
+      << " " << sizeof(cudnnConvolutionBwdFilterAlgoPerf_t);
+  return key.str();
+}
+
+void preloadBenchmarkCache() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    const char* path = std::getenv("TORCH_CUDNN_BENCHMARK_CACHE");
+    if (path == nullptr || std::ifstream(path).fail()) {
+      return;
+    }
+    try {
+      cudnn_load_conv_benchmark_cache(path);
+    } catch (const c10::Error& e) {
+      TORCH_WARN("Ignoring the cuDNN benchmark cache ", path, ": ", e.what_without_backtrace());
+    }
+  });
+}
+
+} // namespace
+
+int64_t cudnn_save_conv_benchmark_cache(const std::string& path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  TORCH_CHECK(out, "cudnn_save_conv_benchmark_cache: can't open ", path);
+  const auto key = benchmarkCacheKey();
+  uint64_t key_size = key.size();
+  out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+  out.write(key.data(), key.size());
+  int64_t count = fwd_algos.save(out);
+  count += bwd_data_algos.save(out);
+  count += bwd_filter_algos.save(out);
+  TORCH_CHECK(out, "cudnn_save_conv_benchmark_cache: can't write ", path);
+  return count;
+}
+
+int64_t cudnn_load_conv_benchmark_cache(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  TORCH_CHECK(in, "cudnn_load_conv_benchmark_cache: can't open ", path);
+  uint64_t key_size = 0;
+  in.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+  const auto key = benchmarkCacheKey();
+  std::string file_key(in && key_size == key.size() ? key_size : 0, '\0');
+  in.read(&file_key[0], file_key.size());
+  if (!in || file_key != key) {
+    TORCH_WARN("Not loading the cuDNN benchmark cache ", path,
+               ", which was saved with another cuDNN version, GPU model or PyTorch build");
+    return 0;
+  }
+  int64_t count = fwd_algos.load(in);
+  count += bwd_data_algos.load(in);
+  count += bwd_filter_algos.load(in);
+  return count;
+}
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
@@ -665,6 +775,7 @@ public:
 
   void try_all(std::function<void (const perf_t &perf)> f) {
     bool only_use_default = args.params.deterministic && !benchmark;
+    preloadBenchmarkCache();
 
     auto& cache = search::cache();
     perf_t algoPerf;
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <c10/macros/Export.h>
+
+#include <cstdint>
+#include <string>
+
+namespace at { namespace native {
+
+// The cuDNN convolution algorithms are cached per convolution shape, and,
+// when cudnn.benchmark is set, found by running every algorithm. These save
+// the cache to a file, and add the entries of such a file to the cache, so
+// that later processes don't benchmark the same shapes again.
+//
+// The file records the cuDNN version and the name of the current GPU, and
+// loading a file saved with another cuDNN version or on another GPU model
+// loads nothing. Both return the number of saved or loaded entries.
+//
+// The file named by the TORCH_CUDNN_BENCHMARK_CACHE environment variable, if
+// any, is loaded before the first convolution.
+TORCH_CUDA_API int64_t cudnn_save_conv_benchmark_cache(const std::string& path);
+TORCH_CUDA_API int64_t cudnn_load_conv_benchmark_cache(const std::string& path);
+
+}} // namespace at::native
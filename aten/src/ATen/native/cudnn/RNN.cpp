@@ -63,6 +63,11 @@ Tensor _cudnn_init_dropout_state(double dropout, bool train, int64_t dropout_see
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
 #include <ATen/cudnn/Utils.h>
+#include <ATen/native/utils/ParamsHash.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace at { namespace native {
 
@@ -169,29 +174,125 @@ namespace {
     }
   };
 
+  // RNNDescriptor cache
+  //
+  // Setting an RNN descriptor is not free, and neither the sequence length
+  // nor the batch size are part of it, so variable length inputs can all
+  // share the descriptor of their configuration. Descriptors are set against
+  // a handle, which is per thread and device, so the handle is part of the
+  // key. A cached descriptor holds on to its dropout state, hence the state
+  // pointer can't be reused by another state while its entry exists.
+
+  // NB: This is a POD, zeroed before being set, so it can be hashed bytewise.
+  struct RNNDescriptorKey {
+    cudnnHandle_t handle;
+    int64_t hidden_size;
+    int64_t num_layers;
+    cudnnDirectionMode_t bidirectional;
+    cudnnRNNMode_t mode;
+    cudnnDataType_t datatype;
+    cudnnDataType_t input_datatype;
+    cudnnRNNAlgo_t algo;
+    cudnnRNNInputMode_t input_mode;
+    double dropout;
+    void* dropout_state;
+  };
+
+  RNNDescriptorKey rnn_descriptor_key(cudnnHandle_t handle, const RNNDescriptorParams& rnn,
+                                      double dropout_p, const Tensor& dropout_state) {
+    RNNDescriptorKey key;
+    memset(&key, 0, sizeof(key));
+    key.handle = handle;
+    key.hidden_size = rnn.hidden_size;
+    key.num_layers = rnn.num_layers;
+    key.bidirectional = rnn.bidirectional;
+    key.mode = rnn.mode;
+    key.datatype = rnn.datatype;
+    key.input_datatype = rnn.input_datatype;
+    key.algo = rnn.algo;
+    key.input_mode = rnn.input_mode;
+    key.dropout = dropout_p;
+    key.dropout_state = dropout_p == 0 ? nullptr : dropout_state.data_ptr();
+    return key;
+  }
+
+  // Bounds the memory held by dropout states of descriptors that will never
+  // be looked up again. The cache is simply dropped when it is full; users
+  // of an evicted descriptor keep it alive.
+  constexpr size_t kMaxCachedRNNDescriptors = 1024;
+
+  struct RNNDescriptorCache {
+    std::mutex mutex;
+    std::unordered_map<RNNDescriptorKey, std::shared_ptr<RNNDescriptor>,
+                       ParamsHash<RNNDescriptorKey>, ParamsEqual<RNNDescriptorKey>> map;
+  };
+
+  std::shared_ptr<RNNDescriptor> get_rnn_descriptor(
+      cudnnHandle_t handle, const RNNDescriptorParams& rnn, const DropoutDescriptorParams& dropout) {
+    static RNNDescriptorCache cache;
+    auto dropout_p = dropout.train ? dropout.dropout : 0;
+    auto key = rnn_descriptor_key(handle, rnn, dropout_p, dropout.dropout_state);
+
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    auto it = cache.map.find(key);
+    if (it != cache.map.end()) {
+      return it->second;
+    }
+    if (cache.map.size() >= kMaxCachedRNNDescriptors) {
+      cache.map.clear();
+    }
+    auto rnn_desc = std::make_shared<RNNDescriptor>(rnn.descriptor(handle, dropout.descriptor(handle)));
+    cache.map.emplace(key, rnn_desc);
+    return rnn_desc;
+  }
+
+  // The cached counterpart of RNNDescriptorParams::descriptor(handle), for
+  // callers that don't need the dropout descriptor.
+  std::shared_ptr<RNNDescriptor> get_rnn_descriptor(cudnnHandle_t handle, const RNNDescriptorParams& rnn) {
+    DropoutDescriptorParams no_dropout;
+    no_dropout.set(/*train=*/false, /*dropout=*/0, Tensor());
+    return get_rnn_descriptor(handle, rnn, no_dropout);
+  }
+
   // TensorDescriptor list
 
-  std::vector<TensorDescriptor> rnn_descriptor_sequence(const Tensor& tensor, IntArrayRef batch_sizes) {
-    std::vector<TensorDescriptor> descriptors(batch_sizes.size());
-    size_t i = 0;
+  // cuDNN takes one tensor descriptor per time step, but the steps only
+  // differ in their batch size. The batch sizes of packed input are
+  // non-increasing, so steps of equal batch size are consecutive and share a
+  // descriptor; unpacked input needs a single one.
+  struct TensorDescriptorSequence {
+    // One per distinct batch size, in order
+    std::vector<TensorDescriptor> descriptors;
+    // One per time step, pointing into descriptors
+    std::vector<cudnnTensorDescriptor_t> steps;
+  };
+
+  TensorDescriptorSequence rnn_descriptor_sequence(const Tensor& tensor, IntArrayRef batch_sizes) {
+    TensorDescriptorSequence sequence;
+    sequence.steps.reserve(batch_sizes.size());
     // To be mutated in the loop
     auto batch_tensor_size = tensor.sizes().vec();
+    int64_t last_batch_size = -1;
     for (auto batch_size : batch_sizes) {
-      batch_tensor_size[0] = batch_size;
-      // NB: cuDNN RNN API does not support 2d descriptors, so we
-      // must pad it out to 3d.
-      descriptors[i].set(getCudnnDataType(tensor), batch_tensor_size, tensor.strides(), 3);
-      i++;
+      if (batch_size != last_batch_size) {
+        batch_tensor_size[0] = batch_size;
+        sequence.descriptors.emplace_back();
+        // NB: cuDNN RNN API does not support 2d descriptors, so we
+        // must pad it out to 3d.
+        sequence.descriptors.back().set(getCudnnDataType(tensor), batch_tensor_size, tensor.strides(), 3);
+        last_batch_size = batch_size;
+      }
+      sequence.steps.push_back(sequence.descriptors.back().desc());
     }
-    return descriptors;
+    return sequence;
   }
 
-  std::vector<TensorDescriptor> rnn_descriptor(const Tensor& tensor, int64_t N) {
-    std::vector<TensorDescriptor> descriptors(N);
-    for (int64_t i = 0; i < N; i++) {
-      descriptors[i].set(tensor, 5);
-    }
-    return descriptors;
+  TensorDescriptorSequence rnn_descriptor(const Tensor& tensor, int64_t N) {
+    TensorDescriptorSequence sequence;
+    sequence.descriptors.emplace_back();
+    sequence.descriptors.back().set(tensor, 5);
+    sequence.steps.assign(N, sequence.descriptors.back().desc());
+    return sequence;
   }
 
   // The best way to understand the meaning of the values stored in
@@ -295,7 +396,7 @@ namespace {
     }
 
     // TODO: check x for consistency with input_size?
-    std::vector<TensorDescriptor> descriptors(Tensor x) const {
+    TensorDescriptorSequence descriptors(Tensor x) const {
       auto is_input_packed = batch_sizes.size() != 0;
       if (is_input_packed) {
         return rnn_descriptor_sequence(x, batch_sizes);
@@ -315,18 +416,16 @@ namespace {
 
   // NB: Doesn't include the weight descriptor
   struct RNNDescriptors {
-    RNNDescriptor rnn_desc;
-    // NB: this won't actually lay out the tensor descriptor pointers
-    // in the right way, so you'll have to preprocess them
-    std::vector<TensorDescriptor> x_descs;
-    std::vector<TensorDescriptor> y_descs;
+    std::shared_ptr<RNNDescriptor> rnn_desc;
+    TensorDescriptorSequence x_descs;
+    TensorDescriptorSequence y_descs;
     TensorDescriptor hx_desc;
     TensorDescriptor hy_desc;
     TensorDescriptor cx_desc;
     TensorDescriptor cy_desc;
 
     RNNDescriptors(const RNNParams& fn, cudnnHandle_t handle, Tensor x, Tensor y, Tensor hx, Tensor cx) {
-      rnn_desc = fn.rnn.descriptor(handle, fn.dropout.descriptor(handle));
+      rnn_desc = get_rnn_descriptor(handle, fn.rnn, fn.dropout);
       x_descs = fn.tensors.descriptors(x);
       y_descs = fn.tensors.descriptors(y);
       hx_desc.set(hx, 5);
@@ -337,23 +436,12 @@ namespace {
       }
     }
 
-    // TODO: This is annoying, having to put the cudnnTensorDescriptor_t
-    // in a contiguous array...
-    std::vector<cudnnTensorDescriptor_t> get_descs(const std::vector<TensorDescriptor>& descs) {
-      std::vector<cudnnTensorDescriptor_t> r;
-      r.reserve(descs.size());
-      for (auto& desc : descs) {
-        r.emplace_back(desc.desc());
-      }
-      return r;
-    }
-
     std::vector<cudnnTensorDescriptor_t> get_x_descs() {
-      return get_descs(x_descs);
+      return x_descs.steps;
     }
 
     std::vector<cudnnTensorDescriptor_t> get_y_descs() {
-      return get_descs(y_descs);
+      return y_descs.steps;
     }
   };
 
@@ -526,6 +614,43 @@ namespace {
     return data_ptrs;
   }
 
+  // NB: This is a POD, zeroed before being set, so it can be hashed bytewise.
+  struct WeightLayoutKey {
+    RNNDescriptorKey rnn;
+    int64_t input_size;
+  };
+
+  // The byte offsets into weight_buf of the pointers get_expected_data_ptrs
+  // returns. They only depend on the configuration, so they are computed once
+  // per configuration instead of being queried from cuDNN on every call.
+  std::vector<int64_t> get_expected_data_offsets(
+        const Tensor& weight_buf, cudnnHandle_t handle, const RNNDescriptorParams& rnn,
+        const RNNDescriptor& rnn_desc, const TensorDescriptor& x_desc, cudnnDataType_t datatype,
+        int64_t input_size) {
+    static std::mutex mutex;
+    static std::unordered_map<WeightLayoutKey, std::vector<int64_t>,
+                              ParamsHash<WeightLayoutKey>, ParamsEqual<WeightLayoutKey>> layouts;
+
+    WeightLayoutKey key;
+    memset(&key, 0, sizeof(key));
+    key.rnn = rnn_descriptor_key(handle, rnn, /*dropout_p=*/0, Tensor());
+    key.input_size = input_size;
+
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = layouts.find(key);
+    if (it != layouts.end()) {
+      return it->second;
+    }
+    auto data_ptrs = get_expected_data_ptrs(weight_buf, handle, rnn, rnn_desc, x_desc, datatype);
+    std::vector<int64_t> offsets;
+    offsets.reserve(data_ptrs.size());
+    for (auto data_ptr : data_ptrs) {
+      offsets.push_back(static_cast<char*>(data_ptr) - static_cast<char*>(weight_buf.data_ptr()));
+    }
+    layouts.emplace(key, offsets);
+    return offsets;
+  }
+
   void _viewOrCopyParams(MatrixRef<Tensor> params_from, MatrixRef<Tensor> params_to, bool copy) {
     AT_ASSERTM(params_from.size(0) == params_to.size(0), "number of layers mismatch");
     for (size_t i = 0; i < params_from.size(0); i++) {
@@ -595,6 +720,16 @@ namespace {
               }
           }
       }
+      //the persistent kernel keeps the recurrent weights on chip, which pays
+      //off for small hidden sizes and small batches over many time steps.
+      //pascal and newer, any precision but double.
+      const auto datatype = getCudnnDataType(input);
+      if (prop->major >= 6 && datatype != CUDNN_DATA_DOUBLE && !tensors.is_input_packed()) {
+          if (rnn.num_directions() == 1 && rnn.hidden_size <= 128 && rnn.hidden_size % 8 == 0 &&
+                  bsize <= 64 && tensors.seq_length >= 16) {
+              return CUDNN_RNN_ALGO_PERSIST_STATIC;
+          }
+      }
       return CUDNN_RNN_ALGO_STANDARD;
   }
 
@@ -629,13 +764,13 @@ Tensor _cudnn_rnn_flatten_weight(
   rnn.set(fn_mode, fn_hidden_size, fn_num_layers, fn_bidirectional, promote_rnn_math_type(datatype), datatype);
 
   auto handle = getCudnnHandle();
-  RNNDescriptor rnn_desc = rnn.descriptor(handle);
+  auto rnn_desc = get_rnn_descriptor(handle, rnn);
 
   TensorGeometry x_geom({1, input_size});
   TensorDescriptor x_desc;
   x_desc.set(getCudnnDataType(any_param), x_geom.sizes(), x_geom.strides(), 5);
 
-  auto num_weights = get_num_weights(handle, rnn_desc, x_desc, datatype);
+  auto num_weights = get_num_weights(handle, *rnn_desc, x_desc, datatype);
   auto weight_buf = at::zeros(num_weights, any_param.options());
 
   FilterDescriptor w_desc;
@@ -644,7 +779,7 @@ Tensor _cudnn_rnn_flatten_weight(
   // Slice off views into weight_buf
   std::vector<Tensor> params_arr;
   size_t params_stride0;
-  std::tie(params_arr, params_stride0) = get_parameters(handle, rnn, rnn_desc, x_desc, w_desc, weight_buf);
+  std::tie(params_arr, params_stride0) = get_parameters(handle, rnn, *rnn_desc, x_desc, w_desc, weight_buf);
 
   MatrixRef<Tensor> weight{weight_arr, static_cast<size_t>(weight_stride0)},
                     params{params_arr, params_stride0};
@@ -729,13 +864,13 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
 
   FilterDescriptor w_desc;
   if (!weight_buf.defined()) {
-    auto num_weights = get_num_weights(handle, descs.rnn_desc, descs.x_descs[0], datatype);
+    auto num_weights = get_num_weights(handle, *descs.rnn_desc, descs.x_descs.descriptors[0], datatype);
     weight_buf = at::empty(num_weights, x.options());
     w_desc.set(weight_buf, 3);
     weight_buf.zero_();
     std::vector<Tensor> params;
     size_t params_stride0;
-    std::tie(params, params_stride0) = get_parameters(handle, fn.rnn, descs.rnn_desc, descs.x_descs[0], w_desc, weight_buf);
+    std::tie(params, params_stride0) = get_parameters(handle, fn.rnn, *descs.rnn_desc, descs.x_descs.descriptors[0], w_desc, weight_buf);
     _copyParams(MatrixRef<Tensor>{weight, static_cast<size_t>(weight_stride0)},
                 MatrixRef<Tensor>{params, params_stride0});
   } else {
@@ -750,7 +885,7 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
   auto y_descs_arr = descs.get_y_descs();
   AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
         handle,
-        descs.rnn_desc.desc(),
+        descs.rnn_desc->desc(),
         fn.tensors.seq_length,
         x_descs_arr.data(),
         &workspace_size
@@ -764,7 +899,7 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
     size_t reserve_size;
     AT_CUDNN_CHECK(cudnnGetRNNTrainingReserveSize(
           handle,
-          descs.rnn_desc.desc(),
+          descs.rnn_desc->desc(),
           fn.tensors.seq_length,
           x_descs_arr.data(),
           &reserve_size
@@ -772,7 +907,7 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
     reserve = at::empty(reserve_size, input.options().dtype(kByte));
     AT_CUDNN_CHECK(cudnnRNNForwardTraining(
           handle,
-          descs.rnn_desc.desc(),
+          descs.rnn_desc->desc(),
           fn.tensors.seq_length,
           x_descs_arr.data(), x.data_ptr(),
           descs.hx_desc.desc(), hx.data_ptr(),
@@ -788,7 +923,7 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
     reserve = at::empty({0}, input.options().dtype(kByte));
     AT_CUDNN_CHECK(cudnnRNNForwardInference(
           handle,
-          descs.rnn_desc.desc(),
+          descs.rnn_desc->desc(),
           fn.tensors.seq_length,
           x_descs_arr.data(), x.data_ptr(),
           descs.hx_desc.desc(), hx.data_ptr(),
@@ -897,7 +1032,7 @@ std::tuple<Tensor, Tensor, Tensor> _cudnn_rnn_backward_input(
   auto y_descs_arr = descs.get_y_descs();
   AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
         handle,
-        descs.rnn_desc.desc(),
+        descs.rnn_desc->desc(),
         fn.tensors.seq_length,
         x_descs_arr.data(),
         &workspace_size
@@ -906,7 +1041,7 @@ std::tuple<Tensor, Tensor, Tensor> _cudnn_rnn_backward_input(
   Tensor workspace = at::empty(workspace_size, input.options().dtype(kByte));
   AT_CUDNN_CHECK(cudnnRNNBackwardData(
         handle,
-        descs.rnn_desc.desc(),
+        descs.rnn_desc->desc(),
         fn.tensors.seq_length,
         y_descs_arr.data(), y.data_ptr(),
         y_descs_arr.data(), dy.data_ptr(),
@@ -1001,7 +1136,7 @@ std::vector<Tensor> _cudnn_rnn_backward_weight(
   auto y_descs_arr = descs.get_y_descs();
   AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
         handle,
-        descs.rnn_desc.desc(),
+        descs.rnn_desc->desc(),
         fn.tensors.seq_length,
         x_descs_arr.data(),
         &workspace_size
@@ -1009,7 +1144,7 @@ std::vector<Tensor> _cudnn_rnn_backward_weight(
   Tensor workspace = at::empty(workspace_size, input.options().dtype(kByte));
   AT_CUDNN_CHECK(cudnnRNNBackwardWeights(
         handle,
-        descs.rnn_desc.desc(),
+        descs.rnn_desc->desc(),
         fn.tensors.seq_length,
         x_descs_arr.data(), x.data_ptr(),
         descs.hx_desc.desc(), hx.data_ptr(),
@@ -1022,7 +1157,7 @@ std::vector<Tensor> _cudnn_rnn_backward_weight(
 
   std::vector<Tensor> grad_params_arr;
   size_t grad_params_stride0;
-  std::tie(grad_params_arr, grad_params_stride0) = get_parameters(handle, fn.rnn, descs.rnn_desc, descs.x_descs[0], w_desc, dw);
+  std::tie(grad_params_arr, grad_params_stride0) = get_parameters(handle, fn.rnn, *descs.rnn_desc, descs.x_descs.descriptors[0], w_desc, dw);
   if (grad_params_stride0 == static_cast<size_t>(weight_stride0)) {
      _viewParams(MatrixRef<Tensor>{grad_params_arr, grad_params_stride0},
               MatrixRef<Tensor>{weight_arr, static_cast<size_t>(weight_stride0)});
@@ -1178,13 +1313,13 @@ Tensor try_get_weight_buf(
 
   RNNDescriptorParams rnn;
   rnn.set(mode, hidden_size, num_layers, bidirectional, promote_rnn_math_type(datatype), datatype);
-  RNNDescriptor rnn_desc = rnn.descriptor(handle);
+  auto rnn_desc = get_rnn_descriptor(handle, rnn);
 
   TensorGeometry x_geom ({1, input.size(-1)});
   TensorDescriptor x_desc;
   x_desc.set(datatype, x_geom.sizes(), x_geom.strides(), 5);
 
-  auto num_params = get_num_weights(handle, rnn_desc, x_desc, datatype);
+  auto num_params = get_num_weights(handle, *rnn_desc, x_desc, datatype);
 
   // Try to get parameter storage
   auto & any_param = parameters.at(0);
@@ -1197,18 +1332,19 @@ Tensor try_get_weight_buf(
   }
 
   // Get and check data pointers
-  auto expected_data_ptrs = get_expected_data_ptrs(
-      weight_buf, handle, rnn, rnn_desc, x_desc, datatype);
+  auto expected_data_offsets = get_expected_data_offsets(
+      weight_buf, handle, rnn, *rnn_desc, x_desc, datatype, input.size(-1));
+  auto weight_buf_ptr = static_cast<char*>(weight_buf.data_ptr());
 
   int64_t num_parameters = parameters.size();
-  int64_t num_ptrs = expected_data_ptrs.size();
+  int64_t num_ptrs = expected_data_offsets.size();
   AT_ASSERT(num_ptrs == (num_parameters * (has_biases ? 1 : 2)));
   AT_ASSERT(num_ptrs % (has_biases ? 4 : 2) == 0);
   for (int64_t param_i = 0, ptr_i = 0;
        ptr_i < num_ptrs;
        ptr_i += (has_biases ? 2 : 4), param_i += 2) {
-    if (expected_data_ptrs[ptr_i] != parameters[param_i].data_ptr()) return {};
-    if (expected_data_ptrs[ptr_i + 1] != parameters[param_i + 1].data_ptr()) return {};
+    if (weight_buf_ptr + expected_data_offsets[ptr_i] != parameters[param_i].data_ptr()) return {};
+    if (weight_buf_ptr + expected_data_offsets[ptr_i + 1] != parameters[param_i + 1].data_ptr()) return {};
   }
   if (!parameters[num_parameters - 1].is_contiguous()) return {};
   return weight_buf;
@@ -0,0 +1,131 @@
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/NativeFunctions.h>
+
+#if !AT_MKL_ENABLED()
+
+namespace at { namespace native {
+
+Tensor _mkl_reorder_linear_weight(const Tensor& weight, int64_t batch_size) {
+  AT_ERROR("_mkl_reorder_linear_weight: ATen not compiled with MKL support");
+}
+
+Tensor _mkl_linear(
+    const Tensor& self,
+    const Tensor& mkl_weight,
+    const Tensor& origin_weight,
+    const Tensor& bias,
+    int64_t prepack_batch_size) {
+  AT_ERROR("_mkl_linear: ATen not compiled with MKL support");
+}
+
+}}
+
+#else // AT_MKL_ENABLED
+
+#include <mkl.h>
+
+#include <limits>
+
+namespace at { namespace native {
+
+namespace {
+
+bool fits_mkl_int(int64_t value) {
+  return value <= std::numeric_limits<int>::max();
+}
+
+} // namespace
+
+// Packs the weight (N, K) of a linear with cblas_sgemm_pack, for products with
+// an input of batch_size rows. The packed buffer is held in a 1-d float tensor.
+Tensor _mkl_reorder_linear_weight(const Tensor& weight, int64_t batch_size) {
+  TORCH_CHECK(
+      weight.device().is_cpu() && weight.layout() == kStrided &&
+          weight.scalar_type() == kFloat && weight.dim() == 2,
+      "_mkl_reorder_linear_weight: expected a 2-d dense float CPU weight, but got ",
+      weight.toString(),
+      " of size ",
+      weight.sizes());
+  const int64_t M = batch_size;
+  const int64_t N = weight.size(0);
+  const int64_t K = weight.size(1);
+  TORCH_CHECK(
+      M > 0 && N > 0 && K > 0 && fits_mkl_int(M) && fits_mkl_int(N) &&
+          fits_mkl_int(K),
+      "_mkl_reorder_linear_weight: unsupported sizes, batch size ",
+      batch_size,
+      " and weight of size ",
+      weight.sizes());
+  const Tensor weight_contig = weight.contiguous();
+  const size_t bytes = cblas_sgemm_pack_get_size(CblasBMatrix, M, N, K);
+  Tensor packed = at::empty(
+      {static_cast<int64_t>((bytes + sizeof(float) - 1) / sizeof(float))},
+      weight.options());
+  // op(B) = weight^T, (K, N)
+  cblas_sgemm_pack(
+      CblasRowMajor,
+      CblasBMatrix,
+      CblasTrans,
+      M,
+      N,
+      K,
+      1.0f,
+      weight_contig.data_ptr<float>(),
+      K,
+      packed.data_ptr<float>());
+  return packed;
+}
+
+// linear(self, origin_weight, bias), with mkl_weight packed by
+// _mkl_reorder_linear_weight(origin_weight, prepack_batch_size). The packed
+// weight is only valid for inputs of prepack_batch_size rows, the others go
+// through linear.
+Tensor _mkl_linear(
+    const Tensor& self,
+    const Tensor& mkl_weight,
+    const Tensor& origin_weight,
+    const Tensor& bias,
+    int64_t prepack_batch_size) {
+  TORCH_CHECK(
+      self.dim() >= 1 && self.size(-1) == origin_weight.size(1),
+      "_mkl_linear: expected an input with ",
+      origin_weight.size(1),
+      " features, but got an input of size ",
+      self.sizes());
+  const int64_t K = origin_weight.size(1);
+  const int64_t N = origin_weight.size(0);
+  const int64_t M = K == 0 ? 0 : self.numel() / K;
+  if (M != prepack_batch_size || !self.device().is_cpu() ||
+      self.layout() != kStrided || self.scalar_type() != kFloat) {
+    return at::linear(self, origin_weight, bias);
+  }
+
+  const Tensor input = self.reshape({M, K}).contiguous();
+  Tensor output = at::empty({M, N}, self.options());
+  if (bias.defined()) {
+    output.copy_(bias.expand({M, N}));
+  }
+  cblas_sgemm_compute(
+      CblasRowMajor,
+      CblasNoTrans,
+      CblasPacked,
+      M,
+      N,
+      K,
+      input.data_ptr<float>(),
+      K,
+      mkl_weight.data_ptr<float>(),
+      K,
+      bias.defined() ? 1.0f : 0.0f,
+      output.data_ptr<float>(),
+      N);
+
+  auto output_size = self.sizes().vec();
+  output_size.back() = N;
+  return output.view(output_size);
+}
+
+}} // namespace at::native
+
+#endif // AT_MKL_ENABLED
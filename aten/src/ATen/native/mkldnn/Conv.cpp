@@ -30,6 +30,13 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> mkldnn_convolution_backward(
   AT_ERROR("mkldnn_convolution_backward: ATen not compiled with MKLDNN support");
 }
 
+at::Tensor _mkldnn_convolution_fused(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias,
+    IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups,
+    const at::Tensor& other, std::string attr, Scalar alpha, Scalar beta) {
+  AT_ERROR("_mkldnn_convolution_fused: ATen not compiled with MKLDNN support");
+}
+
 }}
 
 #else // AT_MKLDNN_EBABLED
@@ -62,7 +69,9 @@ ideep::tensor _mkldnn_conv2d(
     at::IntArrayRef padding,
     at::IntArrayRef stride,
     at::IntArrayRef dilation,
-    int64_t groups) {
+    int64_t groups,
+    const ideep::attr_t& attr = ideep::attr_t(),
+    ideep::tensor y = ideep::tensor()) {
 
   auto kernel_size = w.get_dims();
 
@@ -70,7 +79,8 @@ ideep::tensor _mkldnn_conv2d(
   std::vector<int64_t> output_sizes =
       conv_output_size(input_size, kernel_size, padding, stride, dilation);
 
-  ideep::tensor y;
+  // y may be given, e.g. as a view of a dense tensor for a sum post-op. It is
+  // reallocated if the convolution picks another layout for it.
   if (b.has_value()) {
     ideep::convolution_forward::compute(
         x,
@@ -82,7 +92,11 @@ ideep::tensor _mkldnn_conv2d(
         {dilation.begin(), dilation.end()},
         {padding.begin(), padding.end()},
         {padding.begin(), padding.end()},
-        groups);
+        groups,
+        ideep::scale_t(),
+        ideep::scale_t(),
+        ideep::scale_t(),
+        attr);
   } else {
     ideep::convolution_forward::compute(
         x,
@@ -93,7 +107,11 @@ ideep::tensor _mkldnn_conv2d(
         {dilation.begin(), dilation.end()},
         {padding.begin(), padding.end()},
         {padding.begin(), padding.end()},
-        groups);
+        groups,
+        ideep::scale_t(),
+        ideep::scale_t(),
+        ideep::scale_t(),
+        attr);
   }
   return y;
 }
@@ -130,6 +148,89 @@ at::Tensor mkldnn_convolution(
   }
 }
 
+// See Note [MKLDNN fused epilogues]
+at::Tensor _mkldnn_convolution_fused(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias,
+    IntArrayRef padding,
+    IntArrayRef stride,
+    IntArrayRef dilation,
+    int64_t groups,
+    const at::Tensor& other,
+    std::string attr,
+    Scalar alpha,
+    Scalar beta) {
+  check_fused_epilogue(attr);
+  // Dense tensors are viewed by the convolution as contiguous ones
+  const Tensor input_ = input.is_mkldnn() ? input : input.contiguous();
+  const Tensor weight_ = weight.is_mkldnn() ? weight : weight.contiguous();
+  const Tensor bias_ =
+      !bias.defined() || bias.is_mkldnn() ? bias : bias.contiguous();
+  const ideep::tensor mkldnn_input = get_mkldnn_tensor(input_);
+  const ideep::tensor mkldnn_weight = get_mkldnn_tensor(weight_);
+  c10::optional<ideep::tensor> mkldnn_bias{c10::nullopt};
+  if (bias_.defined()) {
+    mkldnn_bias = get_mkldnn_tensor(bias_);
+  }
+
+  const auto output_size = conv_output_size(
+      mkldnn_input.get_dims(),
+      mkldnn_weight.get_dims(),
+      padding,
+      stride,
+      dilation);
+  // The sum post-op accumulates into the destination, which then has to hold
+  // a dense copy of other.
+  const bool fuse_sum = other.defined() && !input.is_mkldnn() &&
+      !other.is_mkldnn() && other.device().is_cpu() &&
+      other.scalar_type() == input.scalar_type() &&
+      other.sizes() == output_size;
+  if (fuse_sum) {
+    Tensor output = other.clone(at::MemoryFormat::Contiguous);
+    const ideep::tensor y = _mkldnn_conv2d(
+        mkldnn_input,
+        mkldnn_weight,
+        mkldnn_bias,
+        padding,
+        stride,
+        dilation,
+        groups,
+        fused_epilogue_attr(attr, alpha, beta, /*fuse_sum=*/true),
+        itensor_view_from_dense(output));
+    if (y.get_data_handle() == output.data_ptr()) {
+      return output;
+    }
+    // The convolution wrote into a buffer of its own layout, which didn't
+    // hold other.
+    return apply_fused_epilogue(
+        at::mkldnn_convolution(
+            input_, weight_, bias_, padding, stride, dilation, groups),
+        other,
+        attr,
+        alpha,
+        beta);
+  }
+
+  ideep::tensor mkldnn_output = _mkldnn_conv2d(
+      mkldnn_input,
+      mkldnn_weight,
+      mkldnn_bias,
+      padding,
+      stride,
+      dilation,
+      groups,
+      fused_epilogue_attr(
+          other.defined() ? "none" : attr, alpha, beta, /*fuse_sum=*/false));
+  Tensor output = new_with_itensor_mkldnn(std::move(mkldnn_output), input.options());
+  if (!input.is_mkldnn()) {
+    output = mkldnn_to_dense(output);
+  }
+  return other.defined()
+      ? apply_fused_epilogue(std::move(output), other, attr, alpha, beta)
+      : output;
+}
+
 Tensor mkldnn_convolution_backward_input(
     IntArrayRef input_size, const at::Tensor& grad_output, const at::Tensor& weight,
     IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups, bool bias_defined)
@@ -14,12 +14,24 @@ Tensor mkldnn_linear(
   AT_ERROR("mkldnn_linear: ATen not compiled with MKLDNN support");
 }
 
+Tensor _mkldnn_linear_fused(
+    const Tensor& self,
+    const Tensor& weight,
+    const Tensor& bias,
+    const Tensor& other,
+    std::string attr,
+    Scalar alpha,
+    Scalar beta) {
+  AT_ERROR("_mkldnn_linear_fused: ATen not compiled with MKLDNN support");
+}
+
 } // namespace native
 } // namespace at
 
 #else // AT_MKLDNN_EBABLED
 
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
+#include <ATen/native/mkldnn/Utils.h>
 
 namespace at {
 namespace native {
@@ -58,6 +70,76 @@ Tensor mkldnn_linear(
   return new_with_itensor_mkldnn(std::move(y), self.options());
 }
 
+// See Note [MKLDNN fused epilogues]
+Tensor _mkldnn_linear_fused(
+    const Tensor& self,
+    const Tensor& weight,
+    const Tensor& bias,
+    const Tensor& other,
+    std::string attr,
+    Scalar alpha,
+    Scalar beta) {
+  check_fused_epilogue(attr);
+  const auto is_dense_float = [](const Tensor& t) {
+    return !t.defined() ||
+        (t.device().is_cpu() && t.layout() == kStrided &&
+         t.scalar_type() == kFloat);
+  };
+  if (self.dim() < 2 || !is_dense_float(self) || !is_dense_float(weight) ||
+      !is_dense_float(bias)) {
+    return apply_fused_epilogue(
+        at::linear(self, weight, bias), other, attr, alpha, beta);
+  }
+  TORCH_CHECK(
+      weight.dim() == 2 && self.size(-1) == weight.size(1),
+      "_mkldnn_linear_fused: expected an input with ",
+      weight.size(-1),
+      " features, but got an input of size ",
+      self.sizes());
+
+  // Dense tensors are viewed by the inner product as contiguous ones
+  const Tensor input = self.reshape({-1, self.size(-1)}).contiguous();
+  const Tensor weight_ = weight.contiguous();
+  const Tensor bias_ = bias.defined() ? bias.contiguous() : bias;
+  const ideep::tensor x = itensor_view_from_dense(input);
+  const ideep::tensor w = itensor_view_from_dense(weight_);
+  auto output_size = self.sizes().vec();
+  output_size.back() = weight.size(0);
+
+  // The sum post-op accumulates into the destination, which then has to hold
+  // a dense copy of other.
+  const bool fuse_sum = other.defined() && is_dense_float(other) &&
+      other.sizes() == output_size;
+  Tensor output = fuse_sum
+      ? other.clone(at::MemoryFormat::Contiguous)
+            .view({input.size(0), weight.size(0)})
+      : at::empty({input.size(0), weight.size(0)}, self.options());
+  ideep::tensor y = itensor_view_from_dense(output);
+  const ideep::attr_t op_attr = fused_epilogue_attr(
+      other.defined() && !fuse_sum ? "none" : attr, alpha, beta, fuse_sum);
+  if (bias_.defined()) {
+    const ideep::tensor b = itensor_view_from_dense(bias_);
+    ideep::inner_product_forward::compute(
+        x, w, b, y, ideep::scale_t(), ideep::scale_t(), ideep::scale_t(), op_attr);
+  } else {
+    ideep::inner_product_forward::compute(
+        x, w, y, ideep::scale_t(), ideep::scale_t(), ideep::scale_t(), op_attr);
+  }
+  if (y.get_data_handle() != output.data_ptr()) {
+    // The inner product wrote into a buffer of its own layout
+    if (fuse_sum) {
+      return apply_fused_epilogue(
+          at::linear(self, weight, bias), other, attr, alpha, beta);
+    }
+    output = mkldnn_to_dense(
+        new_with_itensor_mkldnn(std::move(y), self.options()));
+  }
+  output = output.view(output_size);
+  return other.defined() && !fuse_sum
+      ? apply_fused_epilogue(std::move(output), other, attr, alpha, beta)
+      : output;
+}
+
 } // namespace native
 } // namespace at
 
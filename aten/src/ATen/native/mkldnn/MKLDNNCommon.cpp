@@ -40,6 +40,17 @@ using IDeepTensorWrapperPtr = c10::intrusive_ptr<IDeepTensorWrapper>;
 using MKLDNNTensorImpl = OpaqueTensorImpl<IDeepTensorWrapperPtr>;
 using MKLDNNTensor = Tensor;
 
+ideep::tensor::data_type get_mkldnn_dtype(ScalarType type) {
+  switch (type) {
+    case ScalarType::Float:
+      return ideep::tensor::data_type::f32;
+    case ScalarType::BFloat16:
+      return ideep::tensor::data_type::bf16;
+    default:
+      TORCH_CHECK(false, "get_mkldnn_dtype: unsupported data type ", type);
+  }
+}
+
 Tensor new_with_itensor_mkldnn(ideep::tensor&& it, const TensorOptions& options) {
   // NOTE: int32_t dims from ideep::tensor but sizes needs int64_t
   // TODO: support int64_t dims in ideep::tensor to avoid extra conversion
@@ -66,12 +77,38 @@ ideep::tensor itensor_view_from_dense(const Tensor& tensor) {
   AT_ASSERTM(
       tensor.layout() == Layout::Strided,
       "itensor_view_from_dense expects dense tensor input");
-  AT_ASSERTM(tensor.scalar_type() == ScalarType::Float,
-             "itensor_view_from_dense expects float tensor input");
+  AT_ASSERTM(
+      tensor.scalar_type() == ScalarType::Float ||
+          tensor.scalar_type() == ScalarType::BFloat16,
+      "itensor_view_from_dense expects float or bfloat16 tensor input");
   TORCH_INTERNAL_ASSERT(at::impl::variable_excluded_from_dispatch());
   return {{{tensor.sizes().cbegin(), tensor.sizes().cend()},
-           ideep::tensor::data_type::f32},
-          tensor.template data_ptr<float>()};
+           get_mkldnn_dtype(tensor.scalar_type())},
+          tensor.data_ptr()};
+}
+
+ideep::attr_t fused_epilogue_attr(
+    const std::string& attr,
+    Scalar alpha,
+    Scalar beta,
+    bool fuse_sum) {
+  ideep::post_ops ops;
+  if (fuse_sum) {
+    ops.append_sum(1.f);
+  }
+  if (attr == "relu") {
+    ops.append_eltwise(1.f, ideep::algorithm::eltwise_relu, 0.f, 0.f);
+  } else if (attr == "gelu") {
+    ops.append_eltwise(1.f, ideep::algorithm::eltwise_gelu_erf, 0.f, 0.f);
+  } else if (attr == "clamp") {
+    ops.append_eltwise(
+        1.f, ideep::algorithm::eltwise_clip, alpha.to<float>(), beta.to<float>());
+  } else {
+    TORCH_INTERNAL_ASSERT(attr == "none", "unexpected fused epilogue ", attr);
+  }
+  ideep::attr_t op_attr;
+  op_attr.set_post_ops(ops);
+  return op_attr;
 }
 }}
 
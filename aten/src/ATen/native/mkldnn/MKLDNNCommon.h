@@ -8,6 +8,9 @@
 
 namespace at { namespace native {
 
+// The oneDNN data type of a Float or BFloat16 tensor
+ideep::tensor::data_type get_mkldnn_dtype(ScalarType type);
+
 // Construct aten MKL-DNN tensor given an ideep tensor
 Tensor new_with_itensor_mkldnn(ideep::tensor&& it, const TensorOptions& options);
 
@@ -17,6 +20,14 @@ ideep::tensor& itensor_from_mkldnn(const Tensor& mkldnn_tensor);
 // Construct an `ideep::tensor` "view" from dense tensor, note the
 // ideep::tensor will share the underlying buffer
 ideep::tensor itensor_view_from_dense(const Tensor& tensor);
+
+// The oneDNN post-ops of a fused epilogue, a sum into the destination if
+// `fuse_sum`, followed by `attr`. See Note [MKLDNN fused epilogues].
+ideep::attr_t fused_epilogue_attr(
+    const std::string& attr,
+    Scalar alpha,
+    Scalar beta,
+    bool fuse_sum);
 }}
 
 #endif // AT_MKLDNN_ENABLED
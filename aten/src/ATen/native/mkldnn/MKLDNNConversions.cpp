@@ -16,7 +16,8 @@ Tensor mkldnn_to_dense(const Tensor& mkldnn_tensor) {
     std::vector<int64_t>(dims.begin(), dims.end()),
     mkldnn_tensor.options().layout(c10::kStrided));
   if (stensor.is_empty()) return cpu_tensor;
-  auto pub_tensor = stensor.to_public(cpu_tensor.template data_ptr<float>());
+  auto pub_tensor = stensor.to_public(
+      cpu_tensor.data_ptr(), get_mkldnn_dtype(cpu_tensor.scalar_type()));
   cpu_tensor.as_strided_(dims, pub_tensor.get_strides());
   return cpu_tensor;
 }
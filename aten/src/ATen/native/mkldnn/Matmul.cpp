@@ -0,0 +1,110 @@
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/native/mkldnn/Matmul.h>
+
+#if !AT_MKLDNN_ENABLED()
+
+namespace at { namespace native {
+
+bool use_mkldnn_bf16_matmul(
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Tensor& result) {
+  return false;
+}
+
+void mkldnn_matmul(
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Tensor& result,
+    float beta,
+    float alpha) {
+  AT_ERROR("mkldnn_matmul: ATen not compiled with MKLDNN support");
+}
+
+}}
+
+#else // AT_MKLDNN_ENABLED
+
+#include <ATen/native/mkldnn/MKLDNNCommon.h>
+#include <ATen/native/mkldnn/Utils.h>
+
+namespace at { namespace native {
+
+bool use_mkldnn_bf16_matmul(
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Tensor& result) {
+  auto is_bf16_cpu = [](const Tensor& t) {
+    return t.scalar_type() == kBFloat16 && t.device().is_cpu() &&
+        t.layout() == Layout::Strided;
+  };
+  return at::globalContext().userEnabledMkldnn() && is_bf16_cpu(mat1) &&
+      is_bf16_cpu(mat2) && is_bf16_cpu(result) && mat1.numel() != 0 &&
+      mat2.numel() != 0 && mkldnn_bf16_device_check();
+}
+
+void mkldnn_matmul(
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Tensor& result,
+    float beta,
+    float alpha) {
+  TORCH_CHECK(
+      (mat1.dim() == 2 && mat2.dim() == 2 && result.dim() == 2) ||
+          (mat1.dim() == 3 && mat2.dim() == 3 && result.dim() == 3),
+      "mkldnn_matmul: expects 2-D matrices or 3-D batches of them");
+  TORCH_CHECK(
+      mkldnn_bf16_device_check(),
+      "mkldnn_matmul: the bfloat16 path needs a CPU with avx512bw, avx512vl "
+      "and avx512dq");
+  if (alpha == 0) {
+    if (beta == 0) {
+      result.zero_();
+    } else {
+      result.mul_(beta);
+    }
+    return;
+  }
+
+  // The ideep views are contiguous, so are the matrices and the destination
+  const Tensor mat1_ = mat1.contiguous();
+  const Tensor mat2_ = mat2.contiguous();
+  Tensor result_ = result;
+  if (!result.is_contiguous()) {
+    result_ = beta == 0 ? at::empty_like(result, MemoryFormat::Contiguous)
+                        : result.contiguous();
+  }
+
+  const ideep::tensor x = itensor_view_from_dense(mat1_);
+  const ideep::tensor w = itensor_view_from_dense(mat2_);
+  ideep::tensor y = itensor_view_from_dense(result_);
+  // oneDNN's matmul only adds 1-D biases, beta * result is added by a sum
+  // post-op on the destination instead.
+  ideep::attr_t op_attr;
+  if (beta != 0) {
+    op_attr = ideep::attr_t::fuse_sum();
+  }
+  ideep::matmul_forward::compute(
+      x,
+      w,
+      y,
+      alpha,
+      beta,
+      ideep::scale_t(),
+      ideep::scale_t(),
+      ideep::scale_t(),
+      op_attr);
+  if (y.get_data_handle() != result_.data_ptr()) {
+    // ideep wrote into a buffer of the layout oneDNN prefers
+    ideep::tensor public_y = itensor_view_from_dense(result_);
+    y.reorder_to(public_y);
+  }
+  if (!result_.is_same(result)) {
+    result.copy_(result_);
+  }
+}
+
+}}
+
+#endif // AT_MKLDNN_ENABLED
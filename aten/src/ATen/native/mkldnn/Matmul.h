@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+
+namespace at { namespace native {
+
+// Whether mat1 @ mat2 into result goes through oneDNN's BFloat16 matmul,
+// which is blocked and accumulates in float: they are non empty BFloat16 CPU
+// tensors, mkldnn is enabled and mkldnn_bf16_device_check() holds.
+bool use_mkldnn_bf16_matmul(
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Tensor& result);
+
+// result = beta * result + alpha * (mat1 @ mat2) for 2-D matrices, or for
+// batches of them in 3-D tensors. result has to have its final size.
+void mkldnn_matmul(
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Tensor& result,
+    float beta,
+    float alpha);
+
+}}
@@ -1,8 +1,18 @@
 #include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/Pool.h>
+#include <cpuinfo.h>
 
 namespace at { namespace native {
 
+bool mkldnn_bf16_device_check() {
+#if !defined(__powerpc__) && !defined(__s390x__)
+  return cpuinfo_initialize() && cpuinfo_has_x86_avx512bw() &&
+      cpuinfo_has_x86_avx512vl() && cpuinfo_has_x86_avx512dq();
+#else
+  return false;
+#endif
+}
+
 std::vector<int64_t> pool_output_sizes(
     IntArrayRef input_size,
     IntArrayRef kernel_size,
@@ -31,4 +41,36 @@ std::vector<int64_t> pool_output_sizes(
    return output_size;
 }
 
+void check_fused_epilogue(const std::string& attr) {
+  TORCH_CHECK(
+      attr == "none" || attr == "relu" || attr == "gelu" || attr == "clamp",
+      "unsupported fused epilogue \"", attr, "\", expected one of \"none\", ",
+      "\"relu\", \"gelu\" or \"clamp\"");
+}
+
+Tensor apply_fused_epilogue(
+    Tensor output,
+    const Tensor& other,
+    const std::string& attr,
+    Scalar alpha,
+    Scalar beta) {
+  check_fused_epilogue(attr);
+  const bool is_mkldnn = output.is_mkldnn();
+  if (is_mkldnn) {
+    output = output.to_dense();
+  }
+  if (other.defined()) {
+    // Out of place, other may be broadcast to a larger size
+    output = at::add(output, other.is_mkldnn() ? other.to_dense() : other);
+  }
+  if (attr == "relu") {
+    output.relu_();
+  } else if (attr == "gelu") {
+    output = at::gelu(output);
+  } else if (attr == "clamp") {
+    output.clamp_(alpha, beta);
+  }
+  return is_mkldnn ? output.to_mkldnn() : output;
+}
+
 }}
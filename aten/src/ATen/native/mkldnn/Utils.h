@@ -1,6 +1,8 @@
 #pragma once
 
+#include <ATen/ATen.h>
 #include <c10/util/ArrayRef.h>
+#include <string>
 #include <vector>
 
 namespace at { namespace native {
@@ -13,4 +15,31 @@ std::vector<int64_t> pool_output_sizes(
     IntArrayRef padding_r,
     IntArrayRef dilation,
     bool ceil_mode);
+
+// Whether the CPU has the AVX512 extensions (avx512bw, avx512vl and
+// avx512dq) oneDNN's BFloat16 kernels need. They use the AVX512-BF16
+// instructions on CPUs that also have those, and emulate them otherwise.
+bool mkldnn_bf16_device_check();
+
+// Note [MKLDNN fused epilogues]
+// _mkldnn_convolution_fused and _mkldnn_linear_fused compute
+// attr(op(self) + other), where other is optional and attr is one of
+//
+//   "none"   the identity
+//   "relu"   relu
+//   "gelu"   gelu, i.e. the erf form
+//   "clamp"  clamp(min=alpha, max=beta), which covers hardtanh and relu6
+//
+// The sum and the activation run as oneDNN post-ops in the epilogue of the
+// convolution or the inner product, so the output isn't read back from
+// memory. Cases oneDNN can't fuse go through apply_fused_epilogue.
+void check_fused_epilogue(const std::string& attr);
+
+// The unfused epilogue, on the output of the convolution or the linear.
+Tensor apply_fused_epilogue(
+    Tensor output,
+    const Tensor& other,
+    const std::string& attr,
+    Scalar alpha,
+    Scalar beta);
 }}
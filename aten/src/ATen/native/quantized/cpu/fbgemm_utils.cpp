@@ -336,6 +336,9 @@ torch::class_<LinearPackedParamsBase> register_linear_params() {
   static auto register_linear_params =
       torch::class_<LinearPackedParamsBase>(
           "quantized", "LinearPackedParamsBase")
+          .def(
+              "set_input_range_cache",
+              &LinearPackedParamsBase::set_input_range_cache)
           .def_pickle(
               [](const c10::intrusive_ptr<LinearPackedParamsBase>& params)
                   -> SerializationType { // __getstate__
@@ -10,6 +10,77 @@
 #include <ATen/native/quantized/cpu/packed_params.h>
 #include <c10/core/QScheme.h>
 
+#include <mutex>
+
+// The ranges of the inputs of a dynamically quantized linear layer, averaged
+// over the inputs that were measured. See
+// LinearPackedParamsBase::set_input_range_cache.
+class InputRangeCache {
+ public:
+  void configure(
+      double averaging_constant,
+      double margin,
+      int64_t refresh_interval) {
+    TORCH_CHECK(
+        averaging_constant > 0 && averaging_constant <= 1,
+        "averaging_constant should be in (0, 1], got ",
+        averaging_constant);
+    TORCH_CHECK(margin >= 0, "margin should not be negative, got ", margin);
+    TORCH_CHECK(
+        refresh_interval >= 1,
+        "refresh_interval should be positive, got ",
+        refresh_interval);
+    std::lock_guard<std::mutex> lock(mutex_);
+    averaging_constant_ = averaging_constant;
+    margin_ = margin;
+    refresh_interval_ = refresh_interval;
+    skipped_ = 0;
+    valid_ = false;
+  }
+
+  // Returns whether the range of the next input can be taken from the cache,
+  // and if so sets min and max to it. Otherwise the caller measures it, and
+  // reports it with observe().
+  bool lookup(float* min, float* max) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!valid_ || skipped_ + 1 >= refresh_interval_) {
+      skipped_ = 0;
+      return false;
+    }
+    ++skipped_;
+    const float widening = margin_ * (max_ - min_);
+    *min = min_ - widening;
+    *max = max_ + widening;
+    return true;
+  }
+
+  void observe(float min, float max) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (refresh_interval_ == 1) {
+      return;
+    }
+    if (!valid_) {
+      min_ = min;
+      max_ = max;
+      valid_ = true;
+    } else {
+      min_ += averaging_constant_ * (min - min_);
+      max_ += averaging_constant_ * (max - max_);
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  double averaging_constant_ = 0.01;
+  double margin_ = 0;
+  int64_t refresh_interval_ = 1;
+  // The number of inputs quantized with the cached range since the last one
+  // that was measured.
+  int64_t skipped_ = 0;
+  bool valid_ = false;
+  float min_ = 0;
+  float max_ = 0;
+};
 
 // The struct for the packed weight matrix (PackBMatrix) and the corresponding
 // column offsets used for the fully connect layer, which are both prepared in
@@ -59,6 +130,13 @@ struct CAFFE2_API PackedLinearWeight : public LinearPackedParamsBase {
     return bias_;
   }
 
+  void set_input_range_cache(
+      double averaging_constant,
+      double margin,
+      int64_t refresh_interval) override {
+    input_range_.configure(averaging_constant, margin, refresh_interval);
+  }
+
   static c10::intrusive_ptr<LinearPackedParamsBase> prepack(
       at::Tensor weight,
       c10::optional<at::Tensor> bias);
@@ -72,6 +150,8 @@ struct CAFFE2_API PackedLinearWeight : public LinearPackedParamsBase {
 
   template <bool ReluFused>
   at::Tensor apply_dynamic_impl(at::Tensor input, bool reduce_range=false);
+
+  InputRangeCache input_range_;
 };
 
 struct CAFFE2_API PackedLinearWeightFp16 : public LinearPackedParamsBase {
@@ -24,4 +24,18 @@ struct LinearPackedParamsBase : public torch::jit::CustomClassHolder {
         "set_bias is not implemented for this packed "
         "parameter type");
   }
+
+  // Lets apply_dynamic() measure the range of only one input out of
+  // refresh_interval, and quantize the others with a moving average of the
+  // measured ranges, widened by margin times its width on each side. Values
+  // out of that range saturate. A refresh_interval of 1 measures every input,
+  // which is the default. The setting is not serialized.
+  virtual void set_input_range_cache(
+      double averaging_constant,
+      double margin,
+      int64_t refresh_interval) {
+    throw std::runtime_error(
+        "set_input_range_cache is not implemented for this packed "
+        "parameter type");
+  }
 };
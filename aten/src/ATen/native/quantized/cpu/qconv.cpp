@@ -5,10 +5,12 @@
 #include <ATen/ATen.h>
 #include <ATen/Parallel.h>
 #include <ATen/SmallVector.h>
+#include <ATen/quantized/Quantizer.h>
 #include <torch/library.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/native/quantized/cpu/quant_utils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/native/quantized/cpu/conv_packed_params.h>
 #include <caffe2/utils/threadpool/pthreadpool-cpp.h>
 
@@ -704,6 +706,56 @@ class QConv1dInt8 final {
   }
 };
 
+// Convolution followed by the addition of `accum` (e.g. the shortcut of a
+// residual block) and optionally a ReLU. The output of the convolution is
+// still rounded to (conv_scale, conv_zero_point), so that the result is the
+// same as the one of quantized::conv2d followed by quantized::add(_relu), but
+// the addition is done in place in the output of the convolution, instead of
+// reading it back to write a third tensor.
+template <bool kReluFused>
+class QConvAddInt8 final {
+ public:
+  static Tensor run(
+      Tensor act,
+      Tensor accum,
+      const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+      double conv_scale,
+      int64_t conv_zero_point,
+      double output_scale,
+      int64_t output_zero_point) {
+    const Tensor conv_out =
+        packed_weight->apply(act, conv_scale, conv_zero_point);
+    TORCH_CHECK(
+        accum.qscheme() == kPerTensorAffine,
+        "[QConv2D] Only per tensor quantization is supported for the "
+        "accumulated tensor.");
+    TORCH_CHECK(
+        accum.scalar_type() == conv_out.scalar_type(),
+        "[QConv2D] Expected the accumulated tensor to have type ",
+        conv_out.scalar_type(),
+        ", but got ",
+        accum.scalar_type());
+    TORCH_CHECK(
+        accum.sizes() == conv_out.sizes(),
+        "[QConv2D] Expected the accumulated tensor to have the shape of the "
+        "output ",
+        conv_out.sizes(),
+        ", but got ",
+        accum.sizes());
+    // An alias of the output of the convolution with the quantization
+    // parameters of the result.
+    Tensor output = at::alias(conv_out);
+    output.set_quantizer_(make_per_tensor_affine_quantizer(
+        output_scale, output_zero_point, conv_out.scalar_type()));
+    if (kReluFused) {
+      qadd_relu_stub(output.device().type(), output, conv_out, accum);
+    } else {
+      qadd_stub(output.device().type(), output, conv_out, accum);
+    }
+    return output;
+  }
+};
+
 // kernel for maintaining backward compatibility
 template <int kSpatialDim, bool kReluFused>
 class QConvInt8ForBC final {
@@ -738,6 +790,8 @@ TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl("conv1d_relu",     QConv1dInt8<true>::run);
   m.impl("conv2d.new",      QConvInt8<2, false>::run);
   m.impl("conv2d_relu.new", QConvInt8<2, true>::run);
+  m.impl("conv2d_add",      QConvAddInt8<false>::run);
+  m.impl("conv2d_add_relu", QConvAddInt8<true>::run);
   m.impl("conv3d.new",      QConvInt8<3, false>::run);
   m.impl("conv3d_relu.new", QConvInt8<3, true>::run);
   // for backward compatibility
@@ -78,10 +78,7 @@ c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackedConvWeight<
     TORCH_CHECK(
         axis == 0,
         "Only per output channel quantization is supported for the weights");
-    zero_points.resize(output_channels);
-    for (int i = 0; i < output_channels; ++i) {
-      zero_points[i] = weight.q_per_channel_zero_points()[i].item<int32_t>();
-    }
+    zero_points = quant_utils::PerChannelZeroPoints(weight);
   } else {
     TORCH_CHECK(false, "Unsupported qscheme: ", toString(qtype));
   }
@@ -120,10 +117,7 @@ c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackedConvWeight<
   if (qtype == c10::kPerTensorAffine) {
     scales = {static_cast<float>(weight.q_scale())};
   } else if (qtype == c10::kPerChannelAffine) {
-    scales.resize(output_channels);
-    for (int i = 0; i < output_channels; ++i) {
-      scales[i] = weight.q_per_channel_scales()[i].item<float>();
-    }
+    scales = quant_utils::PerChannelScales(weight);
   }
 
   c10::optional<at::Tensor> bias_contig;
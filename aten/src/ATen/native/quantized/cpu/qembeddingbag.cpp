@@ -109,16 +109,18 @@ Tensor embedding_bag_byte_rowwise_offsets(
   return output;
 }
 
-Tensor embedding_bag_4bit_rowwise_offsets(
+// Shared by the 4-bit and 2-bit lookups. Every row of weight holds
+// D / NUM_ELEM_PER_BYTE bytes of packed values followed by an fp16 scale and
+// an fp16 bias, see quantized::embedding_bag_{4,2}bit_prepack.
+Tensor embedding_bag_nbit_helper(
     const Tensor& weight,
     const Tensor& indices,
     const Tensor& offsets,
-    const bool /* scale_grad_by_freq */,
-    const int64_t /* mode */,
     bool sparse,
     const c10::optional<Tensor>& per_sample_weights_,
     const c10::optional<Tensor>& compressed_indices_mapping,
-    bool include_last_offset) {
+    bool include_last_offset,
+    int bit_width) {
   TORCH_CHECK(weight.ndimension() == 2);
   TORCH_CHECK(indices.ndimension() == 1);
   TORCH_CHECK(offsets.ndimension() == 1);
@@ -147,8 +149,9 @@ Tensor embedding_bag_4bit_rowwise_offsets(
 
   const auto indices_data = indices.data_ptr<int64_t>();
   const int64_t N = weight.size(0);
-  const int64_t D =
-      (weight.size(1) - 4) * 2; // NB: 2-byte fp16 scale and 2-byte zero_offset
+  const int NUM_ELEM_PER_BYTE = 8 / bit_width;
+  const int64_t D = (weight.size(1) - 4) *
+      NUM_ELEM_PER_BYTE; // NB: 2-byte fp16 scale and 2-byte zero_offset
   const int64_t M = offsets.size(0);
 
   int64_t output_size = M - 1;
@@ -169,14 +172,16 @@ Tensor embedding_bag_4bit_rowwise_offsets(
   auto output = at::empty(shape, weight.options().dtype(at::kFloat));
   auto* output_data = output.data_ptr<float>();
   const int64_t block_size = output.size(1);
-  TORCH_CHECK(block_size % 2 == 0, "block size must be divisible by 2");
+  TORCH_CHECK(
+      block_size % NUM_ELEM_PER_BYTE == 0,
+      "block size must be divisible by ", NUM_ELEM_PER_BYTE);
   const int index_size = indices.numel();
   constexpr int prefetch_distance = 16;
 #ifdef USE_FBGEMM
   if (!sparse) {
     // Generate the fbgemm kernel
     auto kernel_64_ = fbgemm::GenerateEmbeddingSpMDMNBit<std::int64_t>(
-        /*bit rate=*/4,
+        /*bit rate=*/bit_width,
         /*block size=*/block_size,
         /*has weights=*/per_sample_weights_.has_value(),
         /*normalize_by_lengths=*/false,
@@ -198,11 +203,13 @@ Tensor embedding_bag_4bit_rowwise_offsets(
 
     TORCH_CHECK(
         success,
-        "FBGEMM GenerateEmbeddingSpMDMNBit kernel failed for 4-bit input");
+        "FBGEMM GenerateEmbeddingSpMDMNBit kernel failed for ",
+        bit_width,
+        "-bit input");
   } else {
     auto kernel_64_ =
         fbgemm::GenerateEmbeddingSpMDMNBitRowWiseSparse<std::int64_t>(
-            /*bit rate=*/4,
+            /*bit rate=*/bit_width,
             /*block_size=*/block_size,
             /*has weights=*/per_sample_weights_.has_value(),
             /*normalize_by_lengths=*/false,
@@ -223,7 +230,9 @@ Tensor embedding_bag_4bit_rowwise_offsets(
         /*compressed_indices_table=*/compressed_indices_mapping_data);
     TORCH_CHECK(
         success,
-        "FBGEMM GenerateEmbeddingSpMDMNBitRowWiseSparse kernel failed for 4-bit input");
+        "FBGEMM GenerateEmbeddingSpMDMNBitRowWiseSparse kernel failed for ",
+        bit_width,
+        "-bit input");
   }
 #else
 
@@ -277,9 +286,9 @@ Tensor embedding_bag_4bit_rowwise_offsets(
 
       for (int j = 0; j < block_size; ++j) {
         uint8_t quantized =
-            input_data[idx * weight.size(1) + j / /*NUM_ELEM_PER_BYTE*/ 2];
-        quantized >>= (j % 2) * 4;
-        quantized &= (1 << 4) - 1;
+            input_data[idx * weight.size(1) + j / NUM_ELEM_PER_BYTE];
+        quantized >>= (j % NUM_ELEM_PER_BYTE) * bit_width;
+        quantized &= (1 << bit_width) - 1;
 
         output_data[j] = fma(scale, quantized, output_data[j] + bias);
       }
@@ -291,9 +300,52 @@ Tensor embedding_bag_4bit_rowwise_offsets(
   return output;
 }
 
+Tensor embedding_bag_4bit_rowwise_offsets(
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const bool /* scale_grad_by_freq */,
+    const int64_t /* mode */,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  return embedding_bag_nbit_helper(
+      weight,
+      indices,
+      offsets,
+      sparse,
+      per_sample_weights_,
+      compressed_indices_mapping,
+      include_last_offset,
+      4 /*bit_width*/);
+}
+
+Tensor embedding_bag_2bit_rowwise_offsets(
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const bool /* scale_grad_by_freq */,
+    const int64_t /* mode */,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    const c10::optional<Tensor>& compressed_indices_mapping,
+    bool include_last_offset) {
+  return embedding_bag_nbit_helper(
+      weight,
+      indices,
+      offsets,
+      sparse,
+      per_sample_weights_,
+      compressed_indices_mapping,
+      include_last_offset,
+      2 /*bit_width*/);
+}
+
 TORCH_LIBRARY_IMPL(quantized, CPU, m) {
     m.impl("embedding_bag_byte_rowwise_offsets", embedding_bag_byte_rowwise_offsets);
     m.impl("embedding_bag_4bit_rowwise_offsets", embedding_bag_4bit_rowwise_offsets);
+    m.impl("embedding_bag_2bit_rowwise_offsets", embedding_bag_2bit_rowwise_offsets);
 }
 
 }
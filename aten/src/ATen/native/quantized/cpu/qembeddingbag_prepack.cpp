@@ -0,0 +1,151 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <torch/library.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace at {
+namespace native {
+namespace {
+
+// Packs a float [N, D] embedding table into the fused 8-bit rowwise format
+// read by quantized::embedding_bag_byte_rowwise_offsets: every row holds its
+// D uint8 values followed by a float scale and a float bias (the row min).
+Tensor qembeddingbag_byte_prepack(const Tensor& weight) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "quantized::embedding_bag_byte_prepack expects a 2-D weight, but got ",
+      weight.dim(), " dimensions");
+  TORCH_CHECK(
+      weight.scalar_type() == at::kFloat,
+      "quantized::embedding_bag_byte_prepack expects a float weight");
+  const auto weight_contig = weight.contiguous();
+  const auto* weight_data = weight_contig.data_ptr<float>();
+
+  const int64_t embedding_rows = weight.size(0);
+  const int64_t embedding_cols = weight.size(1);
+  // Add 8 bytes per row for the scale and the bias.
+  const int64_t output_columns = embedding_cols + 2 * sizeof(float);
+  auto output = at::empty(
+      {embedding_rows, output_columns}, weight.options().dtype(at::kByte));
+  auto* output_data = output.data_ptr<uint8_t>();
+
+  constexpr float kEpsilon = 1e-8f;
+  at::parallel_for(0, embedding_rows, 1, [&](int64_t start_idx, int64_t end_idx) {
+    for (int64_t row = start_idx; row < end_idx; ++row) {
+      const float* input_row = weight_data + row * embedding_cols;
+      uint8_t* output_row = output_data + row * output_columns;
+      float* output_row_scale_bias =
+          reinterpret_cast<float*>(output_row + embedding_cols);
+
+      const auto minmax = std::minmax_element(input_row, input_row + embedding_cols);
+      const float minimum_element = embedding_cols > 0 ? *minmax.first : 0.0f;
+      const float maximum_element = embedding_cols > 0 ? *minmax.second : 0.0f;
+      const float range = maximum_element - minimum_element;
+
+      output_row_scale_bias[0] = range / 255.0f;
+      output_row_scale_bias[1] = minimum_element;
+      const float inverse_scale = 255.0f / (range + kEpsilon);
+      for (int64_t col = 0; col < embedding_cols; ++col) {
+        output_row[col] =
+            std::lrintf((input_row[col] - minimum_element) * inverse_scale);
+      }
+    }
+  });
+  return output;
+}
+
+// Packs a float [N, D] embedding table into the fused N-bit rowwise format
+// read by quantized::embedding_bag_{4,2}bit_rowwise_offsets: every row holds
+// D / (8 / bit_width) bytes, with element j in the (j % (8 / bit_width))-th
+// group of bits of byte j / (8 / bit_width), followed by an fp16 scale and an
+// fp16 bias (the row min).
+Tensor qembeddingbag_nbit_prepack_helper(const Tensor& weight, int bit_width) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "quantized::embedding_bag_", bit_width,
+      "bit_prepack expects a 2-D weight, but got ", weight.dim(), " dimensions");
+  TORCH_CHECK(
+      weight.scalar_type() == at::kFloat,
+      "quantized::embedding_bag_", bit_width, "bit_prepack expects a float weight");
+  const int64_t embedding_rows = weight.size(0);
+  const int64_t embedding_cols = weight.size(1);
+  const int NUM_ELEM_PER_BYTE = 8 / bit_width;
+  TORCH_CHECK(
+      embedding_cols % NUM_ELEM_PER_BYTE == 0,
+      "quantized::embedding_bag_", bit_width,
+      "bit_prepack expects the embedding dimension to be divisible by ",
+      NUM_ELEM_PER_BYTE, ", but got ", embedding_cols);
+  const auto weight_contig = weight.contiguous();
+  const auto* weight_data = weight_contig.data_ptr<float>();
+
+  // Add 4 bytes per row for the fp16 scale and bias.
+  const int64_t output_columns =
+      embedding_cols / NUM_ELEM_PER_BYTE + 2 * sizeof(at::Half);
+  auto output = at::empty(
+      {embedding_rows, output_columns}, weight.options().dtype(at::kByte));
+  auto* output_data = output.data_ptr<uint8_t>();
+  const int max_quantized = (1 << bit_width) - 1;
+
+  at::parallel_for(0, embedding_rows, 1, [&](int64_t start_idx, int64_t end_idx) {
+    for (int64_t row = start_idx; row < end_idx; ++row) {
+      const float* input_row = weight_data + row * embedding_cols;
+      uint8_t* output_row = output_data + row * output_columns;
+      at::Half* output_row_scale_bias = reinterpret_cast<at::Half*>(
+          output_row + embedding_cols / NUM_ELEM_PER_BYTE);
+
+      const auto minmax = std::minmax_element(input_row, input_row + embedding_cols);
+      // Round the min to fp16 up front, since that is what the lookup adds.
+      float minimum_element = embedding_cols > 0 ? *minmax.first : 0.0f;
+      minimum_element = static_cast<at::Half>(minimum_element);
+      const float maximum_element = embedding_cols > 0 ? *minmax.second : 0.0f;
+      const float range = maximum_element - minimum_element;
+
+      // Quantize with the fp16 scale that is stored, and fall back to a scale
+      // of 1 when the row is constant or the scale underflows in fp16.
+      float scale = range == 0 ? 1.0f : range / max_quantized;
+      scale = static_cast<at::Half>(scale);
+      float inverse_scale = scale == 0 ? 1.0f : 1.0f / scale;
+      if (scale == 0 || std::isinf(inverse_scale)) {
+        scale = 1.0f;
+        inverse_scale = 1.0f;
+      }
+      output_row_scale_bias[0] = scale;
+      output_row_scale_bias[1] = minimum_element;
+
+      for (int64_t col = 0; col < embedding_cols; ++col) {
+        const int quantized = std::max(
+            0,
+            std::min<int>(
+                std::lrintf((input_row[col] - minimum_element) * inverse_scale),
+                max_quantized));
+        if (col % NUM_ELEM_PER_BYTE == 0) {
+          output_row[col / NUM_ELEM_PER_BYTE] = quantized;
+        } else {
+          output_row[col / NUM_ELEM_PER_BYTE] |=
+              quantized << ((col % NUM_ELEM_PER_BYTE) * bit_width);
+        }
+      }
+    }
+  });
+  return output;
+}
+
+Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
+  return qembeddingbag_nbit_prepack_helper(weight, 4 /*bit_width*/);
+}
+
+Tensor qembeddingbag_2bit_prepack(const Tensor& weight) {
+  return qembeddingbag_nbit_prepack_helper(weight, 2 /*bit_width*/);
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte_prepack", qembeddingbag_byte_prepack);
+  m.impl("embedding_bag_4bit_prepack", qembeddingbag_4bit_prepack);
+  m.impl("embedding_bag_2bit_prepack", qembeddingbag_2bit_prepack);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
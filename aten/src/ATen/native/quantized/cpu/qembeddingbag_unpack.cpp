@@ -0,0 +1,108 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <torch/library.h>
+
+namespace at {
+namespace native {
+namespace {
+
+// Dequantizes a table in the fused 8-bit rowwise format produced by
+// quantized::embedding_bag_byte_prepack back to a float [N, D] tensor.
+Tensor qembeddingbag_byte_unpack(const Tensor& packed_weight) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 && packed_weight.scalar_type() == at::kByte,
+      "quantized::embedding_bag_byte_unpack expects a 2-D uint8 weight");
+  const int64_t input_rows = packed_weight.size(0);
+  const int64_t input_columns = packed_weight.size(1);
+  // The last 8 bytes of each row are the float scale and bias.
+  const int64_t output_columns = input_columns - 2 * sizeof(float);
+  TORCH_CHECK(
+      output_columns >= 0,
+      "quantized::embedding_bag_byte_unpack expects at least 8 bytes per row");
+  const auto packed_contig = packed_weight.contiguous();
+  const auto* input_data = packed_contig.data_ptr<uint8_t>();
+
+  auto output = at::empty(
+      {input_rows, output_columns}, packed_weight.options().dtype(at::kFloat));
+  auto* output_data = output.data_ptr<float>();
+
+  at::parallel_for(0, input_rows, 1, [&](int64_t start_idx, int64_t end_idx) {
+    for (int64_t row = start_idx; row < end_idx; ++row) {
+      const uint8_t* input_row = input_data + row * input_columns;
+      const float* input_row_scale_bias =
+          reinterpret_cast<const float*>(input_row + output_columns);
+      float* output_row = output_data + row * output_columns;
+
+      for (int64_t col = 0; col < output_columns; ++col) {
+        output_row[col] =
+            input_row[col] * input_row_scale_bias[0] + input_row_scale_bias[1];
+      }
+    }
+  });
+  return output;
+}
+
+// Dequantizes a table in the fused N-bit rowwise format produced by
+// quantized::embedding_bag_{4,2}bit_prepack back to a float [N, D] tensor.
+Tensor qembeddingbag_nbit_unpack_helper(
+    const Tensor& packed_weight,
+    int bit_width) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 && packed_weight.scalar_type() == at::kByte,
+      "quantized::embedding_bag_", bit_width,
+      "bit_unpack expects a 2-D uint8 weight");
+  const int64_t input_rows = packed_weight.size(0);
+  const int64_t input_columns = packed_weight.size(1);
+  TORCH_CHECK(
+      input_columns >= static_cast<int64_t>(2 * sizeof(at::Half)),
+      "quantized::embedding_bag_", bit_width,
+      "bit_unpack expects at least 4 bytes per row");
+  const int NUM_ELEM_PER_BYTE = 8 / bit_width;
+  // The last 4 bytes of each row are the fp16 scale and bias.
+  const int64_t packed_columns = input_columns - 2 * sizeof(at::Half);
+  const int64_t output_columns = packed_columns * NUM_ELEM_PER_BYTE;
+  const auto packed_contig = packed_weight.contiguous();
+  const auto* input_data = packed_contig.data_ptr<uint8_t>();
+
+  auto output = at::empty(
+      {input_rows, output_columns}, packed_weight.options().dtype(at::kFloat));
+  auto* output_data = output.data_ptr<float>();
+  const uint8_t mask = (1 << bit_width) - 1;
+
+  at::parallel_for(0, input_rows, 1, [&](int64_t start_idx, int64_t end_idx) {
+    for (int64_t row = start_idx; row < end_idx; ++row) {
+      const uint8_t* input_row = input_data + row * input_columns;
+      const at::Half* input_row_scale_bias =
+          reinterpret_cast<const at::Half*>(input_row + packed_columns);
+      const float scale = input_row_scale_bias[0];
+      const float bias = input_row_scale_bias[1];
+      float* output_row = output_data + row * output_columns;
+
+      for (int64_t col = 0; col < output_columns; ++col) {
+        uint8_t quantized = input_row[col / NUM_ELEM_PER_BYTE];
+        quantized >>= (col % NUM_ELEM_PER_BYTE) * bit_width;
+        quantized &= mask;
+        output_row[col] = scale * quantized + bias;
+      }
+    }
+  });
+  return output;
+}
+
+Tensor qembeddingbag_4bit_unpack(const Tensor& packed_weight) {
+  return qembeddingbag_nbit_unpack_helper(packed_weight, 4 /*bit_width*/);
+}
+
+Tensor qembeddingbag_2bit_unpack(const Tensor& packed_weight) {
+  return qembeddingbag_nbit_unpack_helper(packed_weight, 2 /*bit_width*/);
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte_unpack", qembeddingbag_byte_unpack);
+  m.impl("embedding_bag_4bit_unpack", qembeddingbag_4bit_unpack);
+  m.impl("embedding_bag_2bit_unpack", qembeddingbag_2bit_unpack);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -48,13 +48,19 @@ at::Tensor PackedLinearWeight::apply_dynamic_impl(at::Tensor input, bool reduce_
       "The number of rows in the packB should be equal to K: " +
           std::to_string(K));
 
-  // Calculate statistics for quantization of the input Tensor
+  // Calculate statistics for quantization of the input Tensor, unless the
+  // range cache has them.
   float x_min, x_max;
-  fbgemm::FindMinMax(
-      /*m=*/input_ptr,
-      /*min=*/&x_min,
-      /*max=*/&x_max,
-      /*len=*/input.numel());
+  if (!input_range_.lookup(&x_min, &x_max)) {
+    fbgemm::FindMinMax(
+        /*m=*/input_ptr,
+        /*min=*/&x_min,
+        /*max=*/&x_max,
+        /*len=*/input.numel());
+    if (input.numel() > 0) {
+      input_range_.observe(x_min, x_max);
+    }
+  }
 
   // Input tensor is quantized as 8-bit unsigned values
   static constexpr int precision = 8;
@@ -4,6 +4,7 @@
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cpu/quant_utils.h>
 #include <ATen/quantized/Quantizer.h>
 #include <torch/custom_class.h>
 #include <torch/library.h>
@@ -57,20 +58,16 @@ c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeight::prepack(
   if (qtype == c10::kPerTensorAffine) {
     weight_zero_points_int32[0] = weight.q_zero_point();
   } else if (qtype == c10::kPerChannelAffine) {
-    weight_zero_points_int32.resize(N, 0);
-    for (int i = 0; i < N; ++i) {
-      weight_zero_points_int32[i] =
-          weight.q_per_channel_zero_points()[i].item<int32_t>();
-    }
+    TORCH_CHECK(
+        weight.q_per_channel_axis() == 0,
+        "Only per output channel quantization is supported for the weights");
+    weight_zero_points_int32 = quant_utils::PerChannelZeroPoints(weight);
   }
   std::vector<float> weight_scales_float(1, 0.0);
   if (qtype == c10::kPerTensorAffine) {
     weight_scales_float[0] = weight.q_scale();
   } else if (qtype == c10::kPerChannelAffine) {
-    weight_scales_float.resize(N, 0.0);
-    for (int i = 0; i < N; ++i) {
-      weight_scales_float[i] = weight.q_per_channel_scales()[i].item<float>();
-    }
+    weight_scales_float = quant_utils::PerChannelScales(weight);
   }
 
   int8_t* weight_ptr_int8 =
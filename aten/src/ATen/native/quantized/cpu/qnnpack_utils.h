@@ -7,8 +7,11 @@
 
 #include <ATen/native/quantized/cpu/conv_packed_params.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
+#include <ATen/native/quantized/cpu/quant_utils.h>
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 struct QnnpackOperatorDeleter {
   void operator()(pytorch_qnnp_operator_t op) {
@@ -279,11 +282,10 @@ std::pair<std::vector<uint8_t>, at::Tensor> make_zero_points_and_scales_tensor(
       weight_zp[i] = (uint8_t)(weight_contig.q_zero_point() + 128);
     }
   } else if (qtype == at::kPerChannelAffine) {
+    const std::vector<int32_t> zero_points =
+        quant_utils::PerChannelZeroPoints(weight_contig);
     for (int i = 0; i < num_output_channels; ++i) {
-      weight_zp[i] =
-          (uint8_t)(
-              weight_contig.q_per_channel_zero_points()[i].item<int32_t>() +
-              128);
+      weight_zp[i] = (uint8_t)(zero_points[i] + 128);
     }
   } else {
     TORCH_INTERNAL_ASSERT("Unsupported quantization scheme.");
@@ -298,10 +300,10 @@ std::pair<std::vector<uint8_t>, at::Tensor> make_zero_points_and_scales_tensor(
       weight_scales_data[i] = weight_contig.q_scale();
     }
   } else if (qtype == at::kPerChannelAffine) {
-    for (int i = 0; i < num_output_channels; ++i) {
-      weight_scales_data[i] =
-        weight_contig.q_per_channel_scales()[i].item<float>();
-    }
+    const std::vector<float> scales =
+        quant_utils::PerChannelScales(weight_contig);
+    std::copy(scales.begin(), scales.begin() + num_output_channels,
+              weight_scales_data);
   } else {
     TORCH_INTERNAL_ASSERT("Unsupported quantization scheme.");
   }
@@ -3,6 +3,7 @@
 #include <ATen/ATen.h>
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace quant_utils {
 using namespace std;
@@ -136,4 +137,22 @@ static torch::List<int64_t> MakeArgForConv1d(const torch::List<int64_t>& arg,
   return result;
 }
 
+// The per channel zero points and scales of a quantized tensor, converted in
+// one pass over the tensors of quantization parameters instead of with an
+// item() for each channel, which adds up when prepacking all the weights of a
+// model on load.
+inline std::vector<int32_t> PerChannelZeroPoints(const at::Tensor& qtensor) {
+  const at::Tensor zero_points =
+      qtensor.q_per_channel_zero_points().to(at::kInt).contiguous();
+  const int32_t* data = zero_points.data_ptr<int32_t>();
+  return std::vector<int32_t>(data, data + zero_points.numel());
+}
+
+inline std::vector<float> PerChannelScales(const at::Tensor& qtensor) {
+  const at::Tensor scales =
+      qtensor.q_per_channel_scales().to(at::kFloat).contiguous();
+  const float* data = scales.data_ptr<float>();
+  return std::vector<float>(data, data + scales.numel());
+}
+
 } // namespace quant_utils
@@ -0,0 +1,74 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/cpu/SparseAdagradKernel.h>
+
+#include <vector>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(sparse_adagrad_stub);
+
+// Fused Adagrad step for a parameter whose gradient is sparse along its first
+// dimension, e.g. the weight of EmbeddingBag(sparse=True). The gradient does
+// not need to be coalesced: only its (1-D) row indices are sorted, and the
+// duplicated rows are summed inside the kernel, so neither a coalesced copy of
+// the values nor sparse temporaries for the squared gradient and the update
+// are materialized.
+void _fused_sparse_adagrad_cpu_(
+    Tensor& self,
+    Tensor& state_sum,
+    const Tensor& grad,
+    double lr,
+    double eps,
+    bool rowwise) {
+  TORCH_CHECK(!self.is_sparse() && !state_sum.is_sparse(),
+      "_fused_sparse_adagrad_: expected a dense parameter and state_sum");
+  TORCH_CHECK(grad.is_sparse(), "_fused_sparse_adagrad_: expected a sparse gradient");
+  TORCH_CHECK(!self.is_cuda() && !state_sum.is_cuda(),
+      "_fused_sparse_adagrad_: expected CPU tensors, but got CUDA tensors");
+  TORCH_CHECK(self.dim() >= 1, "_fused_sparse_adagrad_: expected a parameter with at least one dimension");
+  TORCH_CHECK(grad.sizes().equals(self.sizes()),
+      "_fused_sparse_adagrad_: expected the gradient to have the size of the parameter, but got ",
+      grad.sizes(), " and ", self.sizes());
+  TORCH_CHECK(grad.sparse_dim() == 1,
+      "_fused_sparse_adagrad_: expected a gradient with one sparse dimension, but got ", grad.sparse_dim());
+  TORCH_CHECK(self.scalar_type() == grad.scalar_type() && self.scalar_type() == state_sum.scalar_type(),
+      "_fused_sparse_adagrad_: expected the parameter, state_sum and gradient to have the same dtype");
+  TORCH_CHECK(self.is_contiguous() && state_sum.is_contiguous(),
+      "_fused_sparse_adagrad_: expected a contiguous parameter and state_sum");
+  if (rowwise) {
+    TORCH_CHECK(state_sum.dim() == 1 && state_sum.size(0) == self.size(0),
+        "_fused_sparse_adagrad_: expected state_sum of size [", self.size(0),
+        "] for a rowwise update, but got ", state_sum.sizes());
+  } else {
+    TORCH_CHECK(state_sum.sizes().equals(self.sizes()),
+        "_fused_sparse_adagrad_: expected state_sum of size ", self.sizes(), ", but got ", state_sum.sizes());
+  }
+
+  const int64_t nnz = grad._nnz();
+  if (nnz == 0 || self.numel() == 0) {
+    return;
+  }
+  auto rows = grad._indices().select(0, 0);
+  auto values = grad._values().reshape({nnz, self.numel() / self.size(0)}).contiguous();
+
+  Tensor order;
+  if (grad.is_coalesced()) {
+    rows = rows.contiguous();
+  } else {
+    std::tie(rows, order) = rows.sort();
+  }
+
+  const int64_t* rows_data = rows.data_ptr<int64_t>();
+  std::vector<int64_t> segment_ends;
+  for (int64_t i = 1; i < nnz; i++) {
+    if (rows_data[i] != rows_data[i - 1]) {
+      segment_ends.push_back(i);
+    }
+  }
+  segment_ends.push_back(nnz);
+
+  sparse_adagrad_stub(kCPU, self, state_sum, values, rows, order, segment_ends, lr, eps, rowwise);
+}
+
+}}  // namespace at::native
@@ -0,0 +1,331 @@
+// Basic functions on sparse CSR tensors
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseTensorUtils.h>
+#include <ATen/native/BinaryOps.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse;
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+int64_t _nnz_sparse_csr(const Tensor& self) {
+  return get_sparse_csr_impl(self)->nnz();
+}
+
+Tensor crow_indices_sparse_csr(const Tensor& self) {
+  return get_sparse_csr_impl(self)->crow_indices().alias();
+}
+
+Tensor col_indices_sparse_csr(const Tensor& self) {
+  return get_sparse_csr_impl(self)->col_indices().alias();
+}
+
+Tensor values_sparse_csr(const Tensor& self) {
+  return get_sparse_csr_impl(self)->values().alias();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+namespace {
+
+Tensor new_sparse_csr(const TensorOptions& options) {
+  DispatchKey dispatch_key;
+  if (options.device().is_cuda()) {
+    dispatch_key = DispatchKey::SparseCsrCUDA;
+  } else {
+    dispatch_key = DispatchKey::SparseCsrCPU;
+  }
+  return detail::make_tensor<SparseCsrTensorImpl>(
+      DispatchKeySet(dispatch_key), options.dtype());
+}
+
+// Like the members of sparse COO tensors, the members of sparse CSR tensors
+// don't carry AutogradMeta, so they are shallow-copied.
+Tensor shallow_copy_member(const Tensor& t) {
+  return Tensor(t.unsafeGetTensorImpl()->shallow_copy_and_detach(
+      /*version_counter=*/t.unsafeGetTensorImpl()->version_counter(),
+      /*allow_tensor_metadata_change=*/true));
+}
+
+void set_sparse_csr_members(
+    const Tensor& self,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  get_sparse_csr_impl(self)->set_member_tensors_unsafe(
+      shallow_copy_member(crow_indices),
+      shallow_copy_member(col_indices),
+      shallow_copy_member(values),
+      size);
+}
+
+// Builds a sparse CSR tensor without checking the indices.
+Tensor sparse_csr_tensor_unsafe(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  Tensor self = new_sparse_csr(values.options());
+  set_sparse_csr_members(self, crow_indices, col_indices, values, size);
+  return self;
+}
+
+// Row index of every stored element: the row r of element p is the one with
+// crow_indices[r] <= p < crow_indices[r + 1].
+Tensor csr_row_indices(const Tensor& crow_indices, int64_t nnz) {
+  const auto rows = crow_indices.numel() - 1;
+  return at::searchsorted(
+      crow_indices.narrow(0, 1, rows),
+      at::arange(nnz, crow_indices.options()),
+      /*out_int32=*/false,
+      /*right=*/true);
+}
+
+// Row pointers of the (sorted) row indices of a coalesced COO matrix.
+Tensor coo_to_csr_row_pointers(const Tensor& row_indices, int64_t rows) {
+  return at::searchsorted(
+      row_indices,
+      at::arange(rows + 1, row_indices.options()),
+      /*out_int32=*/false,
+      /*right=*/false);
+}
+
+} // namespace
+
+Tensor sparse_csr_tensor(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  TORCH_CHECK(size.size() == 2, "sparse_csr_tensor: expected a 2-dimensional size, but got ", size);
+  TORCH_CHECK(size[0] >= 0 && size[1] >= 0, "sparse_csr_tensor: expected non-negative sizes, but got ", size);
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided && values.layout() == kStrided,
+              "sparse_csr_tensor: expected crow_indices, col_indices and values to be strided tensors");
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+              "sparse_csr_tensor: expected crow_indices, col_indices and values to be 1-dimensional");
+  TORCH_CHECK(crow_indices.scalar_type() == kLong && col_indices.scalar_type() == kLong,
+              "sparse_csr_tensor: expected crow_indices and col_indices to be int64 tensors");
+  TORCH_CHECK(crow_indices.numel() == size[0] + 1,
+              "sparse_csr_tensor: expected crow_indices to have size(0) + 1 = ", size[0] + 1,
+              " elements, but got ", crow_indices.numel());
+  TORCH_CHECK(col_indices.numel() == values.numel(),
+              "sparse_csr_tensor: expected col_indices and values to have the same number of elements, but got ",
+              col_indices.numel(), " and ", values.numel());
+  TORCH_CHECK(crow_indices.device() == values.device() && col_indices.device() == values.device(),
+              "sparse_csr_tensor: expected crow_indices, col_indices and values to be on the same device, but got ",
+              crow_indices.device(), ", ", col_indices.device(), " and ", values.device());
+
+  // Checks the bounds with one synchronization, as sparse_coo_tensor does;
+  // the order of the row pointers and of the columns isn't checked.
+  const auto nnz = values.numel();
+  std::vector<Tensor> bounds{crow_indices[0], crow_indices[-1]};
+  if (nnz > 0) {
+    bounds.push_back(col_indices.min());
+    bounds.push_back(col_indices.max());
+  }
+  const auto bounds_cpu = at::stack(bounds).cpu();
+  const auto bounds_acc = bounds_cpu.accessor<int64_t, 1>();
+  TORCH_CHECK(bounds_acc[0] == 0, "sparse_csr_tensor: expected crow_indices[0] to be 0, but got ", bounds_acc[0]);
+  TORCH_CHECK(bounds_acc[1] == nnz,
+              "sparse_csr_tensor: expected crow_indices[-1] to be the number of values ", nnz,
+              ", but got ", bounds_acc[1]);
+  if (nnz > 0) {
+    TORCH_CHECK(bounds_acc[2] >= 0, "sparse_csr_tensor: found negative column index ", bounds_acc[2]);
+    TORCH_CHECK(bounds_acc[3] < size[1],
+                "sparse_csr_tensor: column index ", bounds_acc[3], " is out of bounds for size ", size[1]);
+  }
+
+  return sparse_csr_tensor_unsafe(crow_indices, col_indices, values, size);
+}
+
+Tensor clone_sparse_csr(const Tensor& self, c10::optional<c10::MemoryFormat> optional_memory_format) {
+  TORCH_CHECK(
+      !optional_memory_format.has_value(),
+      "unsupported memory format option ",
+      optional_memory_format.value());
+  return sparse_csr_tensor_unsafe(
+      self.crow_indices().clone(), self.col_indices().clone(), self.values().clone(), self.sizes());
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+Tensor sparse_csr_to_dense(const Tensor& self) {
+  Tensor dst = at::zeros(self.sizes(), self.options().layout(kStrided));
+  const auto nnz = self._nnz();
+  if (nnz > 0) {
+    const auto rows = csr_row_indices(self.crow_indices(), nnz);
+    at::index_put_(dst, {rows, self.col_indices()}, self.values());
+  }
+  return dst;
+}
+
+Tensor sparse_csr_to_sparse(const Tensor& self) {
+  const auto nnz = self._nnz();
+  const auto indices = at::stack({csr_row_indices(self.crow_indices(), nnz), self.col_indices()});
+  return at::_sparse_coo_tensor_unsafe(indices, self.values().clone(), self.sizes(), self.options().layout(kSparse))
+      ._coalesced_(true);
+}
+
+Tensor sparse_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.sparse_dim() == 2 && self.dense_dim() == 0,
+              "to_sparse_csr: expected a sparse matrix without dense dimensions, but got sparse_dim ",
+              self.sparse_dim(), " and dense_dim ", self.dense_dim());
+  const auto coalesced = self.coalesce();
+  const auto indices = coalesced._indices();
+  return sparse_csr_tensor_unsafe(
+      coo_to_csr_row_pointers(indices.select(0, 0).contiguous(), self.size(0)),
+      indices.select(0, 1).clone(at::MemoryFormat::Contiguous),
+      coalesced._values().clone(at::MemoryFormat::Contiguous),
+      self.sizes());
+}
+
+Tensor dense_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.dim() == 2, "to_sparse_csr: expected a 2-dimensional tensor, but got ", self.dim(), "D tensor");
+  return sparse_to_sparse_csr(self.to_sparse());
+}
+
+/******************************************************************************
+ * elementwise operations
+ ******************************************************************************/
+
+// The stored elements of sparse CSR tensors are kept in row-major order, so
+// two tensors with the same row pointers and column indices can be combined
+// through their values only. Otherwise the operations go through the COO
+// kernels, or through indexing when the other operand is strided.
+
+namespace {
+
+// The members are contiguous, so tensors whose members share their data have
+// the same indices.
+bool have_same_indices(const Tensor& a, const Tensor& b) {
+  const auto a_impl = get_sparse_csr_impl(a);
+  const auto b_impl = get_sparse_csr_impl(b);
+  return a_impl->crow_indices().data_ptr() == b_impl->crow_indices().data_ptr() &&
+      a_impl->col_indices().data_ptr() == b_impl->col_indices().data_ptr() &&
+      a_impl->nnz() == b_impl->nnz() &&
+      a.sizes().equals(b.sizes());
+}
+
+// Replaces the members of `out` with the ones of `src`.
+void set_sparse_csr_from(const Tensor& out, const Tensor& src) {
+  set_sparse_csr_members(out, src.crow_indices(), src.col_indices(), src.values(), src.sizes());
+}
+
+} // namespace
+
+Tensor& add_out_sparse_csr(Tensor& out, const Tensor& self, const Tensor& other, Scalar alpha) {
+  TORCH_CHECK(self.sizes().equals(other.sizes()),
+              "add: expected self and other to have the same size, but got ", self.sizes(), " and ", other.sizes());
+  const auto common_dtype = at::result_type(self, other);
+  alpha_check(common_dtype, alpha);
+  TORCH_CHECK(canCast(common_dtype, out.scalar_type()),
+              "add: result type ", common_dtype, " can't be cast to the desired output type ", out.scalar_type());
+
+  if (self.is_sparse_csr() && other.is_sparse_csr()) {
+    TORCH_CHECK(out.is_sparse_csr(), "add: expected out to be a sparse CSR tensor when self and other are");
+    Tensor sum;
+    if (have_same_indices(self, other)) {
+      sum = sparse_csr_tensor_unsafe(
+          self.crow_indices(), self.col_indices(),
+          at::add(self.values(), other.values(), alpha).to(out.scalar_type()), self.sizes());
+    } else {
+      sum = at::add(self.to_sparse(), other.to_sparse(), alpha).to(out.scalar_type()).to_sparse_csr();
+    }
+    set_sparse_csr_from(out, sum);
+    return out;
+  }
+
+  // One of the operands is strided, and so is the result.
+  TORCH_CHECK(!out.is_sparse_csr(),
+              "add: expected out to be a strided tensor when one of self and other is");
+  const auto& sparse = self.is_sparse_csr() ? self : other;
+  const auto nnz = sparse._nnz();
+  auto values = sparse.values().to(out.scalar_type());
+  if (self.is_sparse_csr()) {
+    at::mul_out(out, other, at::scalar_tensor(alpha, other.options().dtype(common_dtype)));
+  } else {
+    if (!is_same_tensor(out, self)) {
+      out.resize_as_(self).copy_(self);
+    }
+    values = values.mul(alpha);
+  }
+  if (nnz > 0) {
+    const auto rows = csr_row_indices(sparse.crow_indices(), nnz);
+    at::index_put_(out, {rows, sparse.col_indices()}, values, /*accumulate=*/true);
+  }
+  return out;
+}
+
+Tensor add_sparse_csr(const Tensor& self, const Tensor& other, Scalar alpha) {
+  const auto common_dtype = at::result_type(self, other);
+  Tensor out;
+  if (self.is_sparse_csr() && other.is_sparse_csr()) {
+    out = new_sparse_csr(self.options().dtype(common_dtype));
+  } else {
+    const auto& dense = self.is_sparse_csr() ? other : self;
+    out = at::empty({0}, dense.options().dtype(common_dtype));
+  }
+  return add_out_sparse_csr(out, self, other, alpha);
+}
+
+Tensor& add_sparse_csr_(Tensor& self, const Tensor& other, Scalar alpha) {
+  return add_out_sparse_csr(self, self, other, alpha);
+}
+
+Tensor& mul_out_sparse_csr(Tensor& out, const Tensor& self_, const Tensor& other_) {
+  // mul is commutative: make self the sparse CSR operand.
+  const auto& self = self_.is_sparse_csr() ? self_ : other_;
+  const auto& other = self_.is_sparse_csr() ? other_ : self_;
+  TORCH_CHECK(out.is_sparse_csr(), "mul: expected out to be a sparse CSR tensor");
+
+  Tensor product;
+  if (other.is_sparse_csr()) {
+    TORCH_CHECK(self.sizes().equals(other.sizes()),
+                "mul: expected self and other to have the same size, but got ", self.sizes(), " and ", other.sizes());
+    if (have_same_indices(self, other)) {
+      product = sparse_csr_tensor_unsafe(
+          self.crow_indices(), self.col_indices(), at::mul(self.values(), other.values()), self.sizes());
+    } else {
+      product = at::mul(self.to_sparse(), other.to_sparse()).to_sparse_csr();
+    }
+  } else if (other.dim() == 0) {
+    product = sparse_csr_tensor_unsafe(
+        self.crow_indices(), self.col_indices(), at::mul(self.values(), other), self.sizes());
+  } else {
+    TORCH_CHECK(self.sizes().equals(other.sizes()),
+                "mul: expected self and other to have the same size, but got ", self.sizes(), " and ", other.sizes());
+    const auto nnz = self._nnz();
+    const auto rows = csr_row_indices(self.crow_indices(), nnz);
+    product = sparse_csr_tensor_unsafe(
+        self.crow_indices(), self.col_indices(),
+        at::mul(self.values(), at::index(other, {rows, self.col_indices()})), self.sizes());
+  }
+  TORCH_CHECK(canCast(product.scalar_type(), out.scalar_type()),
+              "mul: result type ", product.scalar_type(), " can't be cast to the desired output type ", out.scalar_type());
+  set_sparse_csr_members(
+      out, product.crow_indices(), product.col_indices(), product.values().to(out.scalar_type()), product.sizes());
+  return out;
+}
+
+Tensor mul_sparse_csr(const Tensor& self, const Tensor& other) {
+  const auto& sparse = self.is_sparse_csr() ? self : other;
+  Tensor out = new_sparse_csr(sparse.options().dtype(at::result_type(self, other)));
+  return mul_out_sparse_csr(out, self, other);
+}
+
+Tensor& mul_sparse_csr_(Tensor& self, const Tensor& other) {
+  return mul_out_sparse_csr(self, self, other);
+}
+
+}} // namespace at::native
@@ -0,0 +1,153 @@
+// Matrix products of sparse CSR tensors and strided tensors
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/ScalarOps.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseTensorUtils.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+using namespace at::sparse;
+
+namespace {
+
+// r = beta * t + alpha * mat1 * dense. The rows of the result are
+// independent, so they are split across threads without any synchronization.
+template <typename scalar_t>
+void addmm_sparse_csr_dense_worker(
+    Tensor& r,
+    Scalar beta,
+    const Tensor& t,
+    Scalar alpha,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  const scalar_t cast_beta = beta.to<scalar_t>();
+  const scalar_t cast_alpha = alpha.to<scalar_t>();
+  if (cast_beta == 0) {
+    r.zero_();
+  } else if (cast_beta == 1) {
+    if (!is_same_tensor(r, t)) {
+      r.copy_(t);
+    }
+  } else {
+    at::mul_out(r, t, scalar_to_tensor(beta));
+  }
+
+  const int64_t m = r.size(0);
+  const int64_t n = r.size(1);
+  const int64_t nnz = values.numel();
+  if (nnz == 0 || n == 0) {
+    return;
+  }
+
+  const int64_t* crow_ptr = crow_indices.data_ptr<int64_t>();
+  const int64_t* col_ptr = col_indices.data_ptr<int64_t>();
+  const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+  const scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+  scalar_t* r_ptr = r.data_ptr<scalar_t>();
+
+  const int64_t dense_stride0 = dense.stride(0);
+  const int64_t dense_stride1 = dense.stride(1);
+  const int64_t r_stride0 = r.stride(0);
+  const int64_t r_stride1 = r.stride(1);
+
+  const int64_t work_per_row = std::max<int64_t>(1, nnz / std::max<int64_t>(1, m) * n);
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_row);
+  at::parallel_for(0, m, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      scalar_t* r_row = r_ptr + row * r_stride0;
+      for (int64_t p = crow_ptr[row]; p < crow_ptr[row + 1]; p++) {
+        const scalar_t val = cast_alpha * values_ptr[p];
+        const scalar_t* dense_row = dense_ptr + col_ptr[p] * dense_stride0;
+        for (int64_t j = 0; j < n; j++) {
+          r_row[j * r_stride1] += val * dense_row[j * dense_stride1];
+        }
+      }
+    }
+  });
+}
+
+} // namespace
+
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& result,
+    const Tensor& self,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(mat1.is_sparse_csr(), "addmm: expected 'mat1' to be a sparse CSR tensor");
+  TORCH_CHECK(!mat2.is_sparse() && !mat2.is_sparse_csr(), "addmm: expected 'mat2' to be a strided tensor");
+  TORCH_CHECK(!self.is_cuda(), "addmm: expected 'self' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(!result.is_cuda(), "addmm: expected 'out' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(!mat2.is_cuda(), "addmm: expected 'mat2' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(mat2.dim() == 2, "addmm: matrices expected, got ", mat2.dim(), "D tensor");
+  TORCH_CHECK(mat1.scalar_type() == mat2.scalar_type() && mat1.scalar_type() == result.scalar_type(),
+              "addmm: expected 'mat1', 'mat2' and 'out' to have the same dtype, but got ",
+              mat1.scalar_type(), ", ", mat2.scalar_type(), " and ", result.scalar_type());
+
+  // mxk * kxn = mxn
+  const int64_t m = mat1.size(0);
+  const int64_t k = mat1.size(1);
+  const int64_t n = mat2.size(1);
+  TORCH_CHECK(mat2.size(0) == k,
+      "addmm: Argument #3 (mat2): Expected dim 0 size ", k, ", got ", mat2.size(0));
+
+  Tensor t;
+  std::tie(t) = expand_size(self, {m, n}, "addmm_out");
+  result.resize_({m, n});
+
+  const auto impl = get_sparse_csr_impl(mat1);
+  AT_DISPATCH_ALL_TYPES(mat1.scalar_type(), "addmm_sparse_csr_dense", [&] {
+    addmm_sparse_csr_dense_worker<scalar_t>(
+        result, beta, t, alpha, impl->crow_indices(), impl->col_indices(), impl->values(), mat2);
+  });
+  return result;
+}
+
+Tensor addmm_sparse_csr_dense(
+    const Tensor& self,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  Tensor result = at::empty({0}, mat2.options());
+  at::addmm_out(result, self, mat1, mat2, beta, alpha);
+  return result;
+}
+
+Tensor& addmm_sparse_csr_dense_(
+    Tensor& self,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  return at::addmm_out(self, self, mat1, mat2, beta, alpha);
+}
+
+Tensor& mm_out_sparse_csr(Tensor& result, const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.is_sparse_csr(), "mm: expected 'self' to be a sparse CSR tensor");
+  return at::addmm_out(result, at::zeros({}, mat2.options()), self, mat2, /*beta=*/0, /*alpha=*/1);
+}
+
+Tensor mm_sparse_csr(const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.is_sparse_csr(), "mm: expected 'self' to be a sparse CSR tensor");
+  return at::addmm(at::zeros({}, mat2.options()), self, mat2, /*beta=*/0, /*alpha=*/1);
+}
+
+Tensor mv_sparse_csr(const Tensor& self, const Tensor& vec) {
+  TORCH_CHECK(vec.dim() == 1, "mv: expected a 1-dimensional vector, but got ", vec.dim(), "D tensor");
+  TORCH_CHECK(self.size(1) == vec.size(0),
+              "mv: size mismatch, got ", self.size(0), "x", self.size(1), " and ", vec.size(0));
+  return at::mm(self, vec.unsqueeze(1)).squeeze(1);
+}
+
+}} // namespace at::native
@@ -0,0 +1,67 @@
+#pragma once
+
+// Helpers for the multithreaded CPU kernels of sparse COO tensors: coalesce
+// and the merge of add.
+
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace at { namespace native { namespace sparse_parallel {
+
+// Sorts (key, position) pairs. The chunks of the input are sorted on their
+// own thread and then merged pairwise, so that every merge round runs in
+// parallel too. Pairs compare by key and then by position, which makes the
+// order of duplicate keys the one of the input.
+inline void sort_pairs(std::vector<std::pair<int64_t, int64_t>>& items) {
+  const int64_t n = items.size();
+  const int64_t num_chunks = std::min<int64_t>(
+      at::get_num_threads(), at::divup(n, at::internal::GRAIN_SIZE));
+  if (num_chunks <= 1) {
+    std::sort(items.begin(), items.end());
+    return;
+  }
+  const int64_t chunk_size = at::divup(n, num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      std::sort(items.begin() + std::min(n, c * chunk_size),
+                items.begin() + std::min(n, (c + 1) * chunk_size));
+    }
+  });
+
+  std::vector<std::pair<int64_t, int64_t>> buffer(n);
+  for (int64_t width = chunk_size; width < n; width *= 2) {
+    const int64_t num_merges = at::divup(n, 2 * width);
+    at::parallel_for(0, num_merges, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t m = begin; m < end; m++) {
+        const int64_t lo = m * 2 * width;
+        const int64_t mid = std::min(n, lo + width);
+        const int64_t hi = std::min(n, lo + 2 * width);
+        std::merge(items.begin() + lo, items.begin() + mid,
+                   items.begin() + mid, items.begin() + hi,
+                   buffer.begin() + lo);
+      }
+    });
+    items.swap(buffer);
+  }
+}
+
+// y += alpha * x for a block of `n` contiguous elements.
+template <typename scalar_t>
+inline void axpy_block(int64_t n, scalar_t alpha, const scalar_t* x, scalar_t* y) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec alpha_vec(alpha);
+  int64_t d = 0;
+  for (; d < n - (n % Vec::size()); d += Vec::size()) {
+    Vec out = Vec::loadu(y + d) + alpha_vec * Vec::loadu(x + d);
+    out.store(y + d);
+  }
+  for (; d < n; d++) {
+    y[d] += alpha * x[d];
+  }
+}
+
+}}} // namespace at::native::sparse_parallel
@@ -7,8 +7,11 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/InitialTensorOptions.h>
 #include <ATen/SparseTensorUtils.h>
+#include <ATen/native/sparse/SparseParallel.h>
 
-#include <TH/THBlasUtils.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace at { namespace native {
 
@@ -375,53 +378,67 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   int64_t dense_dim = self.dense_dim();
   int64_t nnz = self._nnz();
 
-  LongTensor indices_scalar = flatten_indices(indices, self.sizes());
+  LongTensor indices_scalar = flatten_indices(indices, self.sizes()).contiguous();
+
+  // Sort the flattened indices together with their positions, then find where
+  // the runs of duplicate indices start.
+  std::vector<std::pair<int64_t, int64_t>> sorted(nnz);
+  const int64_t* indices_scalar_ptr = indices_scalar.data_ptr<int64_t>();
+  at::parallel_for(0, nnz, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; j++) {
+      sorted[j] = {indices_scalar_ptr[j], j};
+    }
+  });
+  sparse_parallel::sort_pairs(sorted);
+
+  std::vector<int64_t> run_starts;
+  for (int64_t j = 0; j < nnz; j++) {
+    if (j == 0 || sorted[j].first != sorted[j - 1].first) {
+      run_starts.push_back(j);
+    }
+  }
+  const int64_t new_nnz = run_starts.size();
+  run_starts.push_back(nnz);
 
   SparseTensor dst = new_sparse(self.options());
   get_sparse_impl(dst)->resize_(sparse_dim, dense_dim, self.sizes());
-  // TODO: is there a more idiomatic way to do this?
-  LongTensor newIndices = at::empty(indices.sizes(), indices.options());
-  Tensor newValues = at::empty(values.sizes(), values.options());
+  LongTensor newIndices = at::empty({sparse_dim, new_nnz}, indices.options());
+  Tensor newValues = new_values_with_size_of(values, new_nnz);
   alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
   // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
 
-  int64_t i = -1;
+  // Every run of duplicates is reduced into its own row of newValues, so the
+  // runs are independent.
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
         int64_t blockSize = values.stride(0);
+        bool has_values = values.numel() > 0;  // if values is an empty tensor, there are no elements to copy
         scalar_t* values_ptr = values.data_ptr<scalar_t>();
         scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
+        const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, blockSize));
+        at::parallel_for(0, new_nnz, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            int64_t pos = sorted[run_starts[i]].second;
             for (int64_t d = 0; d < sparse_dim; d++) {
               newIndicesAccessor[d][i] = indicesAccessor[d][pos];
             }
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+            if (!has_values) {
+              continue;
+            }
+            scalar_t* out = newValues_ptr + i * blockSize;
+            std::copy(values_ptr + pos * blockSize, values_ptr + (pos + 1) * blockSize, out);
+            for (int64_t j = run_starts[i] + 1; j < run_starts[i + 1]; j++) {
+              sparse_parallel::axpy_block<scalar_t>(
+                  blockSize, 1, values_ptr + sorted[j].second * blockSize, out);
             }
           }
-          prev = curr;
-        }
+        });
     });
 
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
 
   return dst;
 }
@@ -9,9 +9,11 @@
 #include <ATen/SparseTensorUtils.h>
 #include <ATen/WrapDimUtilsMulti.h>
 #include <ATen/native/BinaryOps.h>
+#include <ATen/native/sparse/SparseParallel.h>
 #include <TH/THBlasUtils.h>
 
 #include <algorithm>
+#include <vector>
 
 namespace at { namespace native {
 
@@ -407,29 +409,82 @@ Tensor& sub_out_sparse(Tensor& r, const Tensor& self, const Tensor& other, Scala
 }
 
 
+// Merges two coalesced tensors. The larger one is cut into chunks and every
+// chunk takes the entries of the other with the same range of indices, so the
+// chunks are merged on their own threads: a first pass counts the entries of
+// each chunk and a second one writes them at their offsets.
 SparseTensor& add_out_sparse_contiguous(SparseTensor& r, const SparseTensor& t, const SparseTensor& src, Scalar value, ScalarType commonDtype) {
     // saving those because they can be overwritten when doing in-place operations
-    int64_t t_nnz = t._nnz(), s_nnz = src._nnz(), max_nnz = t_nnz + s_nnz;
-    bool coalesced = t.is_coalesced() && src.is_coalesced();
+    int64_t t_nnz = t._nnz(), s_nnz = src._nnz();
     int64_t sparse_dim = src.sparse_dim();
 
-    LongTensor r_indices = at::empty({src.sparse_dim(), max_nnz}, t._indices().options());
+    auto t_indices = t._indices();
+    auto src_indices = src._indices();
+    LongTensor t_keys = flatten_indices(t_indices, t.sizes()).contiguous();
+    LongTensor s_keys = flatten_indices(src_indices, src.sizes()).contiguous();
+    const int64_t* t_keys_ptr = t_keys.data_ptr<int64_t>();
+    const int64_t* s_keys_ptr = s_keys.data_ptr<int64_t>();
 
     Tensor t_values = t._values().to(commonDtype);
     Tensor s_values = src._values().to(commonDtype);
 
-    Tensor r_values = new_values_with_size_of(s_values, max_nnz).zero_();
+    const bool t_drives = t_nnz >= s_nnz;
+    const int64_t drive_nnz = t_drives ? t_nnz : s_nnz;
+    const int64_t* drive_keys = t_drives ? t_keys_ptr : s_keys_ptr;
+    const int64_t* other_keys = t_drives ? s_keys_ptr : t_keys_ptr;
+    const int64_t other_nnz = t_drives ? s_nnz : t_nnz;
+    const int64_t num_chunks = std::max<int64_t>(1, std::min<int64_t>(
+        at::get_num_threads(), at::divup(t_nnz + s_nnz, at::internal::GRAIN_SIZE)));
+
+    // chunk c merges [drive_begin[c], drive_begin[c + 1]) of the larger tensor
+    // with [other_begin[c], other_begin[c + 1]) of the other one
+    std::vector<int64_t> drive_begin(num_chunks + 1), other_begin(num_chunks + 1);
+    for (int64_t c = 0; c <= num_chunks; c++) {
+      drive_begin[c] = std::min(drive_nnz, c * at::divup(drive_nnz, num_chunks));
+      other_begin[c] = drive_begin[c] == drive_nnz ? other_nnz :
+          std::lower_bound(other_keys, other_keys + other_nnz, drive_keys[drive_begin[c]]) - other_keys;
+    }
+    other_begin[0] = 0;
+
+    // Calls emit(t_i, s_i) for every entry of chunk c, with -1 for a
+    // missing side.
+    auto merge_chunk = [&](int64_t c, auto&& emit) {
+      int64_t t_i = t_drives ? drive_begin[c] : other_begin[c];
+      int64_t t_end = t_drives ? drive_begin[c + 1] : other_begin[c + 1];
+      int64_t s_i = t_drives ? other_begin[c] : drive_begin[c];
+      int64_t s_end = t_drives ? other_begin[c + 1] : drive_begin[c + 1];
+      while (t_i < t_end || s_i < s_end) {
+        if (s_i >= s_end || (t_i < t_end && t_keys_ptr[t_i] < s_keys_ptr[s_i])) {
+          emit(t_i++, -1);
+        } else if (t_i >= t_end || s_keys_ptr[s_i] < t_keys_ptr[t_i]) {
+          emit(-1, s_i++);
+        } else {
+          emit(t_i++, s_i++);
+        }
+      }
+    };
+
+    std::vector<int64_t> r_begin(num_chunks + 1, 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t count = 0;
+        merge_chunk(c, [&](int64_t, int64_t) { count++; });
+        r_begin[c + 1] = count;
+      }
+    });
+    for (int64_t c = 0; c < num_chunks; c++) {
+      r_begin[c + 1] += r_begin[c];
+    }
+    int64_t r_nnz = r_begin[num_chunks];
 
-    int64_t blockSize = r_values.stride(0);
-    int64_t cmp, d;
-    int64_t r_i = 0, t_i = 0, s_i = 0;
-    auto t_indices = t._indices();
-    auto src_indices = src._indices();
+    LongTensor r_indices = at::empty({sparse_dim, r_nnz}, t_indices.options());
+    Tensor r_values = new_values_with_size_of(s_values, r_nnz);
 
-    // NB: relies on nnz tests above
+    int64_t blockSize = r_values.stride(0);
     auto t_indices_accessor = t_indices.accessor<int64_t, 2>();
     auto r_indices_accessor = r_indices.accessor<int64_t, 2>();
     auto src_indices_accessor = src_indices.accessor<int64_t, 2>();
+    bool has_values = r_values.numel() > 0;  // there are no elements to add when values are empty
 
     AT_DISPATCH_ALL_TYPES(
         commonDtype, "cadd_sparse", [&] {
@@ -437,48 +492,28 @@ SparseTensor& add_out_sparse_contiguous(SparseTensor& r, const SparseTensor& t,
           scalar_t* s_values_ptr = s_values.data_ptr<scalar_t>();
           scalar_t* r_values_ptr = r_values.data_ptr<scalar_t>();
           scalar_t cast_value = value.to<scalar_t>();
-          while (t_i < t_nnz || s_i < s_nnz) {
-            if (t_i >= t_nnz) {
-              cmp = -1;
-            } else if (s_i >= s_nnz) {
-              cmp = 1;
-            } else {
-              cmp = 0;
-              for (d = 0; d < sparse_dim; d++) {
-                if (t_indices_accessor[d][t_i] < src_indices_accessor[d][s_i]) {
-                  cmp = 1;
-                  break;
+          at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+            for (int64_t c = begin; c < end; c++) {
+              int64_t r_i = r_begin[c];
+              merge_chunk(c, [&](int64_t t_i, int64_t s_i) {
+                for (int64_t d = 0; d < sparse_dim; d++) {
+                  r_indices_accessor[d][r_i] = t_i >= 0 ? t_indices_accessor[d][t_i] : src_indices_accessor[d][s_i];
                 }
-                if (t_indices_accessor[d][t_i] > src_indices_accessor[d][s_i]) {
-                  cmp = -1;
-                  break;
+                if (has_values) {
+                  scalar_t* out = r_values_ptr + r_i * blockSize;
+                  if (t_i >= 0) {
+                    std::copy(t_values_ptr + t_i * blockSize, t_values_ptr + (t_i + 1) * blockSize, out);
+                  } else {
+                    std::fill(out, out + blockSize, scalar_t(0));
+                  }
+                  if (s_i >= 0) {
+                    sparse_parallel::axpy_block<scalar_t>(blockSize, cast_value, s_values_ptr + s_i * blockSize, out);
+                  }
                 }
-              }
+                r_i++;
+              });
             }
-            if (cmp >= 0) {
-              for (d = 0; d < sparse_dim; d++) {
-                r_indices_accessor[d][r_i] = t_indices_accessor[d][t_i];
-              }
-              if (t_values.numel() > 0) {  // We add all elements from t_values to r_values only if t_values is not an empty tensor
-                THBlas_axpy<scalar_t>(blockSize, 1,
-                  t_values_ptr + t_i * blockSize, 1,
-                  r_values_ptr + r_i * blockSize, 1);
-              }
-              t_i++;
-            }
-            if (cmp <= 0) {
-              for (d = 0; d < sparse_dim; d++) {
-                r_indices_accessor[d][r_i] = src_indices_accessor[d][s_i];
-              }
-              if (s_values.numel() > 0) {  // We add all elements from s_values to r_values only if s_values is not an empty tensor
-                THBlas_axpy<scalar_t>(blockSize, cast_value,
-                  s_values_ptr + s_i * blockSize, 1,
-                  r_values_ptr + r_i * blockSize, 1);
-              }
-              s_i++;
-            }
-            r_i++;
-          }
+          });
         }
     );
 
@@ -486,21 +521,16 @@ SparseTensor& add_out_sparse_contiguous(SparseTensor& r, const SparseTensor& t,
       r_values = r_values.to(r.scalar_type());
     }
     get_sparse_impl(r)->set_indices_and_values_unsafe(r_indices, r_values);
-    get_sparse_impl(r)->set_nnz_and_narrow(r_i);
 
-    // TODO: I think it may be possible to track inside the loop and
-    // detect when we are uncoalesced (e.g., by observing that an
-    // index goes backwards) which may be more precise than using the
-    // coalesced flag here.  But this is easy.
-    return r._coalesced_(coalesced);
+    return r._coalesced_(true);
 }
 
 SparseTensor& add_out_sparse_non_contiguous(SparseTensor& r, const SparseTensor& t, const SparseTensor& src, Scalar value, ScalarType commonDtype) {
     Tensor t_values = t._values().to(commonDtype);
     Tensor s_values = src._values().to(commonDtype);
 
-    // If `t` or `src` contains non-contiguous `values`, `THBlas_axpy` doesn't work
-    // and we concat the indices and values tensors instead.
+    // If `t` or `src` contains non-contiguous `values` or is uncoalesced, we
+    // concat the indices and values tensors instead of merging them.
     AT_DISPATCH_ALL_TYPES(
       commonDtype, "add_out_sparse_cpu", [&] {
           if (value.to<scalar_t>() != static_cast<scalar_t>(1)) {
@@ -551,7 +581,8 @@ SparseTensor& add_out_sparse_cpu(SparseTensor& r, const SparseTensor& t, const S
 
   r.resize_as_(src);
 
-  if (src._values().is_contiguous() && t._values().is_contiguous()) {
+  if (src._values().is_contiguous() && t._values().is_contiguous() &&
+      t.is_coalesced() && src.is_coalesced()) {
     return add_out_sparse_contiguous(r, t, src, value, commonDtype);
   } else {
     return add_out_sparse_non_contiguous(r, t, src, value, commonDtype);
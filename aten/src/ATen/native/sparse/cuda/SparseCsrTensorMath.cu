@@ -0,0 +1,137 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/ScalarOps.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseTensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAUtils.h>
+#include <ATen/native/sparse/cuda/SparseCUDABlas.cuh>
+
+namespace at { namespace native {
+
+using namespace at::sparse;
+
+namespace {
+
+// Unlike the COO kernel, the row pointers are already there: only the
+// indices are narrowed to the int32 that cuSPARSE takes.
+template <typename scalar_t>
+void addmm_out_sparse_csr_dense_cuda_worker(
+    int64_t nnz,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    Tensor& r_,
+    Scalar beta,
+    const Tensor& t,
+    Scalar alpha,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  scalar_t cast_beta = beta.to<scalar_t>();
+  scalar_t cast_alpha = alpha.to<scalar_t>();
+  if (cast_beta == 0) {
+    r_.zero_();
+  } else if (cast_beta == 1) {
+    if (!is_same_tensor(t, r_)) {
+      r_.copy_(t);
+    }
+  } else {
+    at::mul_out(r_, t, scalar_to_tensor(beta));
+  }
+  if (nnz == 0 || n == 0) {
+    return;
+  }
+
+  // cuSPARSE works on column-major matrices.
+  Tensor r__;
+  if (r_.stride(0) == 1 && r_.stride(1) == r_.size(0)) {
+    r__ = r_;
+  } else {
+    r__ = r_.transpose(0, 1).clone(at::MemoryFormat::Contiguous);
+    r__.transpose_(0, 1);
+  }
+
+  Tensor dense_;
+  char transpose_dense;
+  if (dense.stride(0) == 1 && dense.stride(1) == dense.size(0)) {
+    transpose_dense = 'n';
+    dense_ = dense;
+  } else if (dense.stride(1) == 1 && dense.stride(0) != dense.size(1)) {
+    transpose_dense = 't';
+    dense_ = dense;
+  } else {
+    transpose_dense = 't';
+    dense_ = dense.contiguous();
+  }
+
+  Tensor crow_indices_int = crow_indices.to(kInt);
+  Tensor col_indices_int = col_indices.to(kInt);
+  Tensor values_ = values.contiguous();
+
+  sparse::cuda::csrmm2(
+    'n',
+    transpose_dense,
+    m,
+    n,
+    k,
+    nnz,
+    cast_alpha,
+    values_.data_ptr<scalar_t>(),
+    crow_indices_int.data_ptr<int32_t>(),
+    col_indices_int.data_ptr<int32_t>(),
+    dense_.data_ptr<scalar_t>(),
+    (transpose_dense == 'n' ? dense_.stride(1) : dense_.stride(0)),
+    /*beta=*/1,
+    r__.data_ptr<scalar_t>(),
+    r__.stride(1));
+
+  if (!r__.is_same(r_)) {
+    r_.copy_(r__);
+  }
+}
+
+} // namespace
+
+Tensor& addmm_out_sparse_csr_dense_cuda(
+    Tensor& result,
+    const Tensor& self,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(mat1.is_sparse_csr(), "addmm: expected 'mat1' to be a sparse CSR tensor");
+  TORCH_CHECK(!mat2.is_sparse() && !mat2.is_sparse_csr(), "addmm: expected 'mat2' to be a strided tensor");
+  TORCH_CHECK(self.is_cuda(), "addmm: expected 'self' to be CUDA, but got CPU");
+  TORCH_CHECK(result.is_cuda(), "addmm: expected 'out' to be CUDA, but got CPU");
+  TORCH_CHECK(mat2.is_cuda(), "addmm: expected 'mat2' to be CUDA, but got CPU");
+  TORCH_CHECK(cuda::check_device({mat1, result, self, mat2}));
+  TORCH_CHECK(mat2.dim() == 2, "addmm: 2D tensor expected, got ", mat2.dim(), "D tensor");
+  TORCH_CHECK(mat1.scalar_type() == mat2.scalar_type() && mat1.scalar_type() == result.scalar_type(),
+              "addmm: expected 'mat1', 'mat2' and 'out' to have the same dtype, but got ",
+              mat1.scalar_type(), ", ", mat2.scalar_type(), " and ", result.scalar_type());
+
+  // mxk * kxn = mxn
+  int64_t m = mat1.size(0);
+  int64_t k = mat1.size(1);
+  int64_t n = mat2.size(1);
+  TORCH_CHECK(mat2.size(0) == k,
+      "addmm: Argument #3 (mat2): Expected dim 0 size ", k, ", got ", mat2.size(0));
+
+  Tensor t;
+  std::tie(t) = expand_size(self, {m, n}, "addmm_out");
+  result.resize_({m, n});
+
+  const auto impl = get_sparse_csr_impl(mat1);
+  AT_DISPATCH_FLOATING_TYPES(mat1.scalar_type(), "addmm_sparse_csr_dense_cuda", [&] {
+    addmm_out_sparse_csr_dense_cuda_worker<scalar_t>(
+        impl->nnz(), m, n, k, result, beta, t, alpha,
+        impl->crow_indices(), impl->col_indices(), impl->values(), mat2);
+  });
+  return result;
+}
+
+}} // namespace at::native
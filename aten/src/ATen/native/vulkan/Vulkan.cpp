@@ -1,9 +1,14 @@
 #include <stdio.h>
 #include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <numeric>
+#include <string>
 
 #include <c10/util/ArrayRef.h>
 #include <c10/util/Exception.h>
@@ -40,9 +45,12 @@ VContext::VContext(bool enableValidationLayers)
   createInstance();
   findPhysicalDevice();
   createDevice();
+  createPipelineCache();
 }
 
 VContext::~VContext() {
+  savePipelineCache();
+  vkDestroyPipelineCache(device_, pipelineCache_, nullptr);
   vkDestroyCommandPool(device_, commandPool_, nullptr);
   if (enableValidationLayers_) {
     auto func = (PFN_vkDestroyDebugReportCallbackEXT)vkGetInstanceProcAddr(
@@ -230,6 +238,89 @@ void VContext::createDevice() {
   physicalDeviceLimits_ = physicalDeviceProperties.limits;
 }
 
+namespace {
+// The pipeline cache is loaded from and saved to the file at this path, so
+// that the shaders compiled by the driver are reused across processes.
+// Empty if the cache is only kept in memory.
+std::string pipelineCachePath() {
+  const char* const path = std::getenv("PYTORCH_VULKAN_PIPELINE_CACHE");
+  return path ? path : "";
+}
+
+// Whether pipeline cache data was saved by the same driver on the same
+// device, following the layout of VK_PIPELINE_CACHE_HEADER_VERSION_ONE.
+bool isPipelineCacheCompatible(
+    VkPhysicalDevice physicalDevice,
+    const std::vector<char>& data) {
+  struct Header {
+    uint32_t size;
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint8_t uuid[VK_UUID_SIZE];
+  } header;
+  if (data.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+  return header.version == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+      header.vendorID == properties.vendorID &&
+      header.deviceID == properties.deviceID &&
+      std::memcmp(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) ==
+      0;
+}
+} // namespace
+
+void VContext::createPipelineCache() {
+  std::vector<char> initialData;
+  const std::string path = pipelineCachePath();
+  if (!path.empty()) {
+    std::ifstream file(path, std::ios::binary);
+    initialData.assign(
+        std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (!isPipelineCacheCompatible(physicalDevice_, initialData)) {
+      initialData.clear();
+    }
+  }
+
+  VkPipelineCacheCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  createInfo.initialDataSize = initialData.size();
+  createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+  VK_CHECK(
+      vkCreatePipelineCache(device_, &createInfo, nullptr, &pipelineCache_));
+}
+
+void VContext::savePipelineCache() {
+  const std::string path = pipelineCachePath();
+  if (path.empty()) {
+    return;
+  }
+  size_t size = 0;
+  if (vkGetPipelineCacheData(device_, pipelineCache_, &size, nullptr) !=
+      VK_SUCCESS) {
+    return;
+  }
+  std::vector<char> data(size);
+  if (vkGetPipelineCacheData(device_, pipelineCache_, &size, data.data()) !=
+      VK_SUCCESS) {
+    return;
+  }
+  // Write a temporary file and rename it, so that a process loading the cache
+  // concurrently never reads a partially written one.
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), size);
+    if (!file) {
+      return;
+    }
+  }
+  std::rename(tmpPath.c_str(), path.c_str());
+}
+
 static std::unique_ptr<VContext> gContext;
 const VContext& context() {
   TORCH_INTERNAL_ASSERT_DEBUG_ONLY(gContext);
@@ -763,7 +854,12 @@ void ComputeUnit::createComputePipeline(
   pipelineCreateInfo.layout = pipelineLayout_;
 
   VK_CHECK(vkCreateComputePipelines(
-      device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline_));
+      device,
+      context().pipelineCache(),
+      1,
+      &pipelineCreateInfo,
+      nullptr,
+      &pipeline_));
 }
 
 #ifdef USE_VULKAN_SHADERC_RUNTIME
@@ -163,11 +163,16 @@ class VContext final {
   inline VkQueue queue() const {
     return queue_;
   }
+  inline VkPipelineCache pipelineCache() const {
+    return pipelineCache_;
+  }
 
  private:
   void createInstance();
   void findPhysicalDevice();
   void createDevice();
+  void createPipelineCache();
+  void savePipelineCache();
   uint32_t getComputeQueueFamilyIndex();
 
   VkInstance instance_;
@@ -180,6 +185,7 @@ class VContext final {
   uint32_t queueFamilyIndex_;
   bool enableValidationLayers_;
   VkCommandPool commandPool_;
+  VkPipelineCache pipelineCache_;
 };
 
 class VBuffer final {
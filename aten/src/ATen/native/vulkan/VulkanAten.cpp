@@ -2,6 +2,7 @@
 #include <ATen/ATen.h>
 #include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/Pool.h>
 #include <ATen/native/UpSample.h>
 #include <ATen/native/utils/ParamUtils.h>
 #include <ATen/native/vulkan/Vulkan.h>
@@ -142,6 +143,122 @@ at::Tensor upsample_nearest2d_vulkan(
   return output;
 }
 
+namespace {
+// The value of a parameter of a 2d pooling for height (0) or width (1), given
+// as one value for both or as two values.
+int pool2d_param(IntArrayRef param, int64_t i) {
+  return safe_downcast<int, int64_t>(param.size() == 1 ? param[0] : param[i]);
+}
+} // namespace
+
+at::Tensor vulkan_max_pool2d(
+    const at::Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode) {
+  TORCH_CHECK(
+      self.dim() == 4, "vulkan_max_pool2d expects a 4-dimensional input");
+  TORCH_CHECK(
+      kernel_size.size() == 1 || kernel_size.size() == 2,
+      "max_pool2d: kernel_size must either be a single int, or a tuple of two ints");
+  TORCH_CHECK(
+      stride.empty() || stride.size() == 1 || stride.size() == 2,
+      "max_pool2d: stride must either be omitted, a single int, or a tuple of two ints");
+  TORCH_CHECK(
+      padding.size() == 1 || padding.size() == 2,
+      "max_pool2d: padding must either be a single int, or a tuple of two ints");
+  TORCH_CHECK(
+      dilation.size() == 1 || dilation.size() == 2,
+      "max_pool2d: dilation must be either a single int, or a tuple of two ints");
+  if (stride.empty()) {
+    stride = kernel_size;
+  }
+  const int kH = pool2d_param(kernel_size, 0);
+  const int kW = pool2d_param(kernel_size, 1);
+  const int dH = pool2d_param(stride, 0);
+  const int dW = pool2d_param(stride, 1);
+  const int padH = pool2d_param(padding, 0);
+  const int padW = pool2d_param(padding, 1);
+  const int dilationH = pool2d_param(dilation, 0);
+  const int dilationW = pool2d_param(dilation, 1);
+
+  const auto inputSizes = self.sizes();
+  const int64_t in = inputSizes[0];
+  const int64_t ic = inputSizes[1];
+  const int64_t ih = inputSizes[2];
+  const int64_t iw = inputSizes[3];
+  const int64_t oh =
+      pooling_output_shape<int64_t>(ih, kH, padH, dH, dilationH, ceil_mode);
+  const int64_t ow =
+      pooling_output_shape<int64_t>(iw, kW, padW, dW, dilationW, ceil_mode);
+  pool2d_shape_check(
+      self, kH, kW, dH, dW, padH, padW, dilationH, dilationW,
+      ic, ih, iw, oh, ow);
+
+  VulkanTensor& x = vtensor_from_vulkan(self);
+  Tensor output = empty_vulkan({in, ic, oh, ow}, self.options(), {});
+  VulkanTensor& y = vtensor_from_vulkan(output);
+  y.allocate_storage();
+  vulkan::detail::max_pool2d(
+      y, x, ih, iw, oh, ow, in, ic,
+      kH, kW, dH, dW, padH, padW, dilationH, dilationW);
+  return output;
+}
+
+at::Tensor vulkan_avg_pool2d(
+    const at::Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  TORCH_CHECK(
+      self.dim() == 4, "vulkan_avg_pool2d expects a 4-dimensional input");
+  TORCH_CHECK(
+      kernel_size.size() == 1 || kernel_size.size() == 2,
+      "avg_pool2d: kernel_size must either be a single int, or a tuple of two ints");
+  TORCH_CHECK(
+      stride.empty() || stride.size() == 1 || stride.size() == 2,
+      "avg_pool2d: stride must either be omitted, a single int, or a tuple of two ints");
+  TORCH_CHECK(
+      padding.size() == 1 || padding.size() == 2,
+      "avg_pool2d: padding must either be a single int, or a tuple of two ints");
+  TORCH_CHECK(
+      !divisor_override.has_value() || divisor_override.value() != 0,
+      "divisor must be not zero");
+  if (stride.empty()) {
+    stride = kernel_size;
+  }
+  const int kH = pool2d_param(kernel_size, 0);
+  const int kW = pool2d_param(kernel_size, 1);
+  const int dH = pool2d_param(stride, 0);
+  const int dW = pool2d_param(stride, 1);
+  const int padH = pool2d_param(padding, 0);
+  const int padW = pool2d_param(padding, 1);
+
+  const auto inputSizes = self.sizes();
+  const int64_t in = inputSizes[0];
+  const int64_t ic = inputSizes[1];
+  const int64_t ih = inputSizes[2];
+  const int64_t iw = inputSizes[3];
+  const int64_t oh = pooling_output_shape<int64_t>(ih, kH, padH, dH, 1, ceil_mode);
+  const int64_t ow = pooling_output_shape<int64_t>(iw, kW, padW, dW, 1, ceil_mode);
+  pool2d_shape_check(
+      self, kH, kW, dH, dW, padH, padW, 1, 1, ic, ih, iw, oh, ow);
+
+  VulkanTensor& x = vtensor_from_vulkan(self);
+  Tensor output = empty_vulkan({in, ic, oh, ow}, self.options(), {});
+  VulkanTensor& y = vtensor_from_vulkan(output);
+  y.allocate_storage();
+  vulkan::detail::avg_pool2d(
+      y, x, ih, iw, oh, ow, in, ic,
+      kH, kW, dH, dW, padH, padW, count_include_pad, divisor_override);
+  return output;
+}
+
 Tensor vulkan_add(const Tensor& self, const Tensor& other, Scalar alpha) {
   VulkanTensor& x = vtensor_from_vulkan(self);
   VulkanTensor& y = vtensor_from_vulkan(other);
@@ -16,6 +16,14 @@ at::Tensor vulkan_convolution(
     IntArrayRef dilation,
     int64_t groups);
 
+at::Tensor vulkan_max_pool2d(
+    const at::Tensor& self, // Vulkan
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode);
+
 at::Tensor vulkan_convolution_prepack_weights(const at::Tensor& weight);
 
 at::Tensor vulkan_convolution_prepacked(
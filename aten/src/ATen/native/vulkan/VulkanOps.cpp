@@ -71,6 +71,154 @@ void upsample_nearest2d(
   vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 }
 
+namespace {
+// Shader is the GLSL_SPV() of the shader of the pooling, which is either its
+// source or its SPIR-V code and size.
+template <typename ConstBlock, typename... Shader>
+void pool2d(
+    VulkanTensor& output,
+    const VulkanTensor& input,
+    const ConstBlock& cb,
+    int64_t OH,
+    int64_t OW,
+    int64_t N,
+    int64_t C,
+    Shader... shader) {
+  auto device = context().device();
+  VBuffer constBuffer = makeUniformConstBuffer((void*)&cb, sizeof(cb));
+
+  VkDescriptorSetLayout descriptorSetLayout{};
+  VkDescriptorPool descriptorPool{};
+  VkDescriptorSet descriptorSet{};
+  std::vector<VkDescriptorType> descriptorTypes{
+      VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+      VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
+  createDescriptorSetLayoutSinglePool(
+      device,
+      descriptorTypes,
+      &descriptorSetLayout,
+      &descriptorPool,
+      &descriptorSet);
+
+  output.image()->bindStorageImage(descriptorSet, 0);
+  input.image()->bindShaderRead(descriptorSet, 1);
+  constBuffer.bind(descriptorSet, 2);
+
+  WorkGroupSize workGroupSize{8, 8, 1};
+  ComputeUnit computeUnit{shader..., descriptorSetLayout, workGroupSize};
+  computeUnit.createCommandBuffer(descriptorSet);
+  auto commandBuffer = computeUnit.commandBuffer();
+  output.image()->addImageMemoryBarrierToGeneral(commandBuffer);
+  input.image()->addImageMemoryBarrierToShaderRead(commandBuffer);
+  computeUnit.dispatchCommandBuffer(
+      OW, OH, UP_DIV(N * C, 4), workGroupSize);
+  computeUnit.endCommandBuffer();
+  computeUnit.submitAndWaitCommandBuffer();
+  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+}
+} // namespace
+
+void max_pool2d(
+    VulkanTensor& output,
+    const VulkanTensor& input,
+    const int iH,
+    const int iW,
+    const int oH,
+    const int oW,
+    const int _n,
+    const int _c,
+    const int kH,
+    const int kW,
+    const int dH,
+    const int dW,
+    const int padH,
+    const int padW,
+    const int dilationH,
+    const int dilationW) {
+  struct ConstBlock {
+    int32_t IW;
+    int32_t IH;
+    int32_t OW;
+    int32_t OH;
+    int32_t KW;
+    int32_t KH;
+    int32_t SX;
+    int32_t SY;
+    int32_t PX;
+    int32_t PY;
+    int32_t DX;
+    int32_t DY;
+  };
+  ConstBlock cb{
+      iW, iH, oW, oH, kW, kH, dW, dH, padW, padH, dilationW, dilationH};
+  pool2d(
+      output,
+      input,
+      cb,
+      oH,
+      oW,
+      _n,
+      _c,
+      at::native::vulkan::GLSL_SPV(max_pool2d));
+}
+
+void avg_pool2d(
+    VulkanTensor& output,
+    const VulkanTensor& input,
+    const int iH,
+    const int iW,
+    const int oH,
+    const int oW,
+    const int _n,
+    const int _c,
+    const int kH,
+    const int kW,
+    const int dH,
+    const int dW,
+    const int padH,
+    const int padW,
+    const bool countIncludePad,
+    const c10::optional<int64_t> divisorOverride) {
+  struct ConstBlock {
+    int32_t IW;
+    int32_t IH;
+    int32_t OW;
+    int32_t OH;
+    int32_t KW;
+    int32_t KH;
+    int32_t SX;
+    int32_t SY;
+    int32_t PX;
+    int32_t PY;
+    int32_t countIncludePad;
+    int32_t divisorOverride;
+  };
+  ConstBlock cb{
+      iW,
+      iH,
+      oW,
+      oH,
+      kW,
+      kH,
+      dW,
+      dH,
+      padW,
+      padH,
+      countIncludePad,
+      static_cast<int32_t>(divisorOverride.value_or(0))};
+  pool2d(
+      output,
+      input,
+      cb,
+      oH,
+      oW,
+      _n,
+      _c,
+      at::native::vulkan::GLSL_SPV(avg_pool2d));
+}
+
 void add(
     VulkanTensor& output,
     const VulkanTensor& input0,
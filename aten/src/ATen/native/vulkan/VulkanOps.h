@@ -19,6 +19,42 @@ void upsample_nearest2d(
     float scaleH,
     float scaleW);
 
+void max_pool2d(
+    VulkanTensor& output,
+    const VulkanTensor& input,
+    const int inputHeight,
+    const int inputWidth,
+    const int outputHeight,
+    const int outputWidth,
+    const int batchSize,
+    const int channels,
+    const int kernelHeight,
+    const int kernelWidth,
+    const int strideHeight,
+    const int strideWidth,
+    const int paddingHeight,
+    const int paddingWidth,
+    const int dilationHeight,
+    const int dilationWidth);
+
+void avg_pool2d(
+    VulkanTensor& output,
+    const VulkanTensor& input,
+    const int inputHeight,
+    const int inputWidth,
+    const int outputHeight,
+    const int outputWidth,
+    const int batchSize,
+    const int channels,
+    const int kernelHeight,
+    const int kernelWidth,
+    const int strideHeight,
+    const int strideWidth,
+    const int paddingHeight,
+    const int paddingWidth,
+    const bool countIncludePad,
+    const c10::optional<int64_t> divisorOverride);
+
 void add(
     VulkanTensor& output,
     const VulkanTensor& input0,
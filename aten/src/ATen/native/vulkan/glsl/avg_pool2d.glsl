@@ -0,0 +1,52 @@
+#version 450 core
+layout(std430) buffer;
+layout(std430) uniform;
+layout(set = 0, rgba16f, binding = 0) writeonly mediump uniform image3D uOutput;
+layout(set = 0, binding = 1) uniform mediump sampler3D uInput;
+layout(set = 0, binding = 2) uniform constBlock {
+  int IW;
+  int IH;
+  int OW;
+  int OH;
+  int KW;
+  int KH;
+  int SX;
+  int SY;
+  int PX;
+  int PY;
+  int countIncludePad;
+  int divisorOverride;
+}
+uConstBlock;
+
+layout(local_size_x_id = 1, local_size_y_id = 2, local_size_z_id = 3) in;
+
+void main() {
+  ivec3 pos = ivec3(gl_GlobalInvocationID);
+  if (pos.x < uConstBlock.OW && pos.y < uConstBlock.OH) {
+    int sx = pos.x * uConstBlock.SX - uConstBlock.PX;
+    int sy = pos.y * uConstBlock.SY - uConstBlock.PY;
+    // The window clipped to the padded input, then to the input.
+    int ex = min(sx + uConstBlock.KW, uConstBlock.IW + uConstBlock.PX);
+    int ey = min(sy + uConstBlock.KH, uConstBlock.IH + uConstBlock.PY);
+    int poolSize = (ex - sx) * (ey - sy);
+    sx = max(sx, 0);
+    sy = max(sy, 0);
+    ex = min(ex, uConstBlock.IW);
+    ey = min(ey, uConstBlock.IH);
+
+    vec4 acc = vec4(0);
+    for (int y = sy; y < ey; ++y) {
+      for (int x = sx; x < ex; ++x) {
+        acc += texelFetch(uInput, ivec3(x, y, pos.z), 0);
+      }
+    }
+
+    int divisor = uConstBlock.divisorOverride;
+    if (divisor == 0) {
+      divisor = uConstBlock.countIncludePad != 0 ? poolSize
+                                                 : (ex - sx) * (ey - sy);
+    }
+    imageStore(uOutput, pos, acc / float(divisor));
+  }
+}
@@ -0,0 +1,45 @@
+#version 450 core
+layout(std430) buffer;
+layout(std430) uniform;
+layout(set = 0, rgba16f, binding = 0) writeonly mediump uniform image3D uOutput;
+layout(set = 0, binding = 1) uniform mediump sampler3D uInput;
+layout(set = 0, binding = 2) uniform constBlock {
+  int IW;
+  int IH;
+  int OW;
+  int OH;
+  int KW;
+  int KH;
+  int SX;
+  int SY;
+  int PX;
+  int PY;
+  int DX;
+  int DY;
+}
+uConstBlock;
+
+layout(local_size_x_id = 1, local_size_y_id = 2, local_size_z_id = 3) in;
+
+void main() {
+  ivec3 pos = ivec3(gl_GlobalInvocationID);
+  if (pos.x < uConstBlock.OW && pos.y < uConstBlock.OH) {
+    int sx = pos.x * uConstBlock.SX - uConstBlock.PX;
+    int sy = pos.y * uConstBlock.SY - uConstBlock.PY;
+    vec4 outValue = vec4(-65504.0);
+    for (int ky = 0; ky < uConstBlock.KH; ++ky) {
+      int y = sy + ky * uConstBlock.DY;
+      if (y < 0 || y >= uConstBlock.IH) {
+        continue;
+      }
+      for (int kx = 0; kx < uConstBlock.KW; ++kx) {
+        int x = sx + kx * uConstBlock.DX;
+        if (x < 0 || x >= uConstBlock.IW) {
+          continue;
+        }
+        outValue = max(outValue, texelFetch(uInput, ivec3(x, y, pos.z), 0));
+      }
+    }
+    imageStore(uOutput, pos, outValue);
+  }
+}
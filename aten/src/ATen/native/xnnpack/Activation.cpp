@@ -0,0 +1,106 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/xnnpack/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+
+// Supports FP32 hardswish of tensors of any shape and memory format, in and
+// out of place.
+
+bool use_hardswish(
+    const Tensor& input) {
+  return xnnpack::internal::available() &&
+      (1 <= input.ndimension()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      !input.requires_grad() &&
+      true;
+}
+
+static Tensor& hardswish_impl(
+    const Tensor& input,
+    Tensor& output) {
+  using namespace internal;
+
+  xnn_operator_t hardswish_op{};
+
+  // The operation is elementwise, so the tensors are handled as a batch of
+  // numel() rows of one channel, which XNNPACK processes as one contiguous
+  // array.
+  const xnn_status create_status = xnn_create_hardswish_nc_f32(
+      1u,                 // channels
+      1u,                 // input_stride
+      1u,                 // output_stride
+      0u,                 // flags
+      &hardswish_op);     // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_hardswish_nc_f32 failed!");
+
+  const Operator hardswish_scoped_op(hardswish_op);
+
+  const xnn_status setup_status = xnn_setup_hardswish_nc_f32(
+      hardswish_op,               // operator
+      input.numel(),              // batch_size
+      input.data_ptr<float>(),    // input
+      output.data_ptr<float>(),   // output
+      caffe2::pthreadpool_());    // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_hardswish_nc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      hardswish_op,             // operator
+      caffe2::pthreadpool_());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output;
+}
+
+Tensor hardswish(
+    const Tensor& input) {
+  const Tensor input_padded_contig = internal::allocate_padded_contiguous_if_needed(
+      input,
+      input.suggest_memory_format());
+
+  Tensor output_padded_contig = internal::empty_with_tail_padding(
+      input_padded_contig.sizes(),
+      input_padded_contig.options().dtype(),
+      input.suggest_memory_format(),
+      input_padded_contig.names());
+
+  hardswish_impl(input_padded_contig, output_padded_contig);
+  return output_padded_contig.contiguous(input.suggest_memory_format());
+}
+
+Tensor& hardswish_(
+    Tensor& input) {
+  Tensor input_padded_contig = internal::allocate_padded_contiguous_if_needed(
+      input,
+      input.suggest_memory_format());
+
+  // Don't need to allocate an output if the input was already padded and
+  // contiguous, since XNNPACK supports in place operation.
+  if (input_padded_contig.data_ptr() == input.data_ptr()) {
+    hardswish_impl(input, input);
+    return input;
+  }
+
+  hardswish_impl(input_padded_contig, input_padded_contig);
+  return input.copy_(input_padded_contig);
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
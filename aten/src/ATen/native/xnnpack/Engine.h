@@ -66,6 +66,19 @@ Tensor max_pool2d(
     float output_min = -std::numeric_limits<float>::infinity(),
     float output_max = +std::numeric_limits<float>::infinity());
 
+//
+// Hardswish
+//
+
+bool use_hardswish(
+    const Tensor& input);
+
+Tensor hardswish(
+    const Tensor& input);
+
+Tensor& hardswish_(
+    Tensor& input);
+
 } // namespace xnnpack
 } // namespace native
 } // namespace at
@@ -88,6 +88,21 @@ Tensor max_pool2d(
   TORCH_CHECK(false, internal::kError);
 }
 
+bool use_hardswish(
+    const Tensor&) {
+  return false;
+}
+
+Tensor hardswish(
+    const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+Tensor& hardswish_(
+    Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
 } // namespace xnnpack
 
 } // namespace native
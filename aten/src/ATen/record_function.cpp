@@ -35,6 +35,9 @@ class CallbackManager {
   }
 
   CallbackHandle addGlobalCallback(RecordFunctionCallback cb) {
+    if (!cb.isLowProbSampled()) {
+      ++num_non_low_prob_global_callbacks_;
+    }
     auto handle = next_unique_callback_handle();
     sorted_global_callbacks_.emplace_back(std::move(cb), handle);
     return handle;
@@ -60,6 +63,9 @@ class CallbackManager {
     auto found = find_and_remove(sorted_tls_callbacks_);
     if (!found) {
       found = find_and_remove(sorted_global_callbacks_);
+      if (found) {
+        recountGlobalCallbacks();
+      }
     }
     if (!found) {
       LOG(WARNING) << "Requested callback is not found";
@@ -68,6 +74,7 @@ class CallbackManager {
 
   void clearGlobalCallbacks() {
     sorted_global_callbacks_.clear();
+    num_non_low_prob_global_callbacks_ = 0;
   }
 
   void clearThreadLocalCallbacks() {
@@ -82,20 +89,25 @@ class CallbackManager {
     return !sorted_tls_callbacks_.empty();
   }
 
+  // whether every global callback can be pre-sampled
+  inline bool allGlobalCallbacksLowProb() const {
+    return num_non_low_prob_global_callbacks_ == 0;
+  }
+
   // init is called by RecordFunction in constructor to
   // determine which thread local and global callbacks are going
   // to be executed and whether any of them need inputs
-  inline void init(RecordFunction& rec_fn) {
+  inline void init(RecordFunction& rec_fn, bool pre_sampled) {
     auto scope = rec_fn.scope();
     bool found_active_cb = false;
     bool found_needs_inputs = false;
     bool found_needs_ids = false;
     auto init_handles = [
-        scope, &found_active_cb, &found_needs_inputs, &found_needs_ids](
+        scope, pre_sampled, &found_active_cb, &found_needs_inputs, &found_needs_ids](
           CallbackHandles& handles, RecordFunctionCallbacks& cbs) {
       handles.clear();
       for (const auto& cb : cbs) {
-        if (cb.first.shouldRun(scope)) {
+        if (cb.first.shouldRun(scope, pre_sampled)) {
           handles.push_back(cb.second);
           found_active_cb = true;
           if (cb.first.needsInputs()) {
@@ -194,8 +206,20 @@ class CallbackManager {
     }
   }
 
+  void recountGlobalCallbacks() {
+    num_non_low_prob_global_callbacks_ = std::count_if(
+        sorted_global_callbacks_.begin(),
+        sorted_global_callbacks_.end(),
+        [](const std::pair<RecordFunctionCallback, CallbackHandle>& el) {
+          return !el.first.isLowProbSampled();
+        });
+  }
+
   // Global callbacks; must be sorted in increasing handle order
   RecordFunctionCallbacks sorted_global_callbacks_;
+  // Number of global callbacks that can't be pre-sampled;
+  // atomic since it is read by every thread running RecordFunction
+  std::atomic<size_t> num_non_low_prob_global_callbacks_ {0};
 };
 
 // Enumerates thread ids logically;
@@ -230,9 +254,24 @@ double sample_zero_one() {
   return dist(*gen);
 }
 
+// Flips a coin with kLowProb probability, replacing the flip with the thread
+// local number of tries tries_left_ sampled from the geometric distribution
+inline bool sample_low_prob() {
+  if (tries_left_ == 0) {
+    tries_left_ = sample_geometric();
+    return true;
+  }
+  --tries_left_;
+  return false;
+}
+
 } // namespace
 
-bool RecordFunctionCallback::shouldRun(RecordScope scope) const {
+bool RecordFunctionCallback::isLowProbSampled() const {
+  return !should_run_ && sampling_prob_ < kLowProb;
+}
+
+bool RecordFunctionCallback::shouldRun(RecordScope scope, bool pre_sampled) const {
   // first check whether this callback is interested in
   // the given scope type
   if (!checkScope(scope)) {
@@ -250,13 +289,14 @@ bool RecordFunctionCallback::shouldRun(RecordScope scope) const {
     // flip for kLowProb with a thread local number of tries tries_left_
     // sampled from the geometric distribution
     if (sampling_prob_ < kLowProb) {
-      if (tries_left_ == 0) {
-        tries_left_ = sample_geometric();
+      // the kLowProb coin was already flipped by shouldRunRecordFunction
+      if (pre_sampled) {
         return (sample_zero_one() < sampling_prob_ / kLowProb);
-      } else {
-        --tries_left_;
-        return false;
       }
+      if (sample_low_prob()) {
+        return (sample_zero_one() < sampling_prob_ / kLowProb);
+      }
+      return false;
     } else {
       return (sample_zero_one() < sampling_prob_);
     }
@@ -269,6 +309,10 @@ RecordFunctionCallbacks _getTLSCallbacks() {
 }
 
 void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks) {
+  // the handles are unique, so there is nothing to copy when they match
+  if (_hasTLSCallbacks(callbacks)) {
+    return;
+  }
   // keep the original handles
   sorted_tls_callbacks_ = callbacks;
   std::sort(
@@ -280,6 +324,18 @@ void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks) {
   });
 }
 
+bool _hasTLSCallbacks(const RecordFunctionCallbacks& callbacks) {
+  return std::equal(
+      sorted_tls_callbacks_.begin(),
+      sorted_tls_callbacks_.end(),
+      callbacks.begin(),
+      callbacks.end(),
+      [](const std::pair<RecordFunctionCallback, CallbackHandle>& l,
+          const std::pair<RecordFunctionCallback, CallbackHandle>& r) {
+        return l.second == r.second;
+  });
+}
+
 bool hasCallbacks() {
   auto& m = manager();
   return m.hasGlobalCallbacks() || m.hasThreadLocalCallbacks();
@@ -329,9 +385,28 @@ void enableRecordFunction(bool enable) {
   c10::impl::tls_set_dispatch_key_included(c10::DispatchKey::Profiler, enable);
 }
 
-RecordFunction::RecordFunction(RecordScope scope) : scope_(scope) {
+bool shouldRunRecordFunction(bool* pre_sampled) {
+  auto& m = manager();
+  *pre_sampled = false;
+  if (!m.hasThreadLocalCallbacks()) {
+    if (!m.hasGlobalCallbacks()) {
+      return false;
+    }
+    if (m.allGlobalCallbacksLowProb()) {
+      if (!isRecordFunctionEnabled()) {
+        return false;
+      }
+      *pre_sampled = true;
+      return sample_low_prob();
+    }
+  }
+  return isRecordFunctionEnabled();
+}
+
+RecordFunction::RecordFunction(RecordScope scope, bool pre_sampled)
+    : scope_(scope) {
   if (hasCallbacks() && isRecordFunctionEnabled()) {
-    manager().init(*this);
+    manager().init(*this, pre_sampled);
   }
 }
 
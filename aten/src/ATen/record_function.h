@@ -1,8 +1,10 @@
 #pragma once
 
 #include <ATen/core/ivalue.h>
+#include <c10/util/Optional.h>
 #include <c10/util/SmallVector.h>
 #include <c10/macros/Export.h>
+#include <c10/macros/Macros.h>
 #include <memory>
 
 #include <functional>
@@ -81,8 +83,11 @@ typedef uint64_t RecordFunctionHandle;
 struct TORCH_API RecordFunction {
   // Default constructor is used with before function called afterwards:
   //  scope - record scope that this function tracks
+  //  pre_sampled - whether the low probability coin flip for the sampled
+  //    callbacks was already made (see shouldRunRecordFunction)
   RecordFunction(
-      RecordScope scope = RecordScope::FUNCTION);
+      RecordScope scope = RecordScope::FUNCTION,
+      bool pre_sampled = false);
 
   template <typename F>
   void before(
@@ -303,8 +308,14 @@ class TORCH_API RecordFunctionCallback {
     return end_;
   }
 
-  // whether the callbacks should run in the given scope
-  bool shouldRun(RecordScope scope) const;
+  // whether the callbacks should run in the given scope;
+  // pre_sampled - whether the low probability coin flip was already made by
+  // shouldRunRecordFunction
+  bool shouldRun(RecordScope scope, bool pre_sampled = false) const;
+
+  // whether the callback is sampled with a probability low enough to be
+  // pre-sampled before RecordFunction is constructed
+  bool isLowProbSampled() const;
 
  private:
   std::function<void(const RecordFunction&)> start_;
@@ -316,16 +327,29 @@ class TORCH_API RecordFunctionCallback {
   std::array<bool, static_cast<size_t>(RecordScope::NUM_SCOPES)> scopes_ = {};
 };
 
+/**
+ * shouldRunRecordFunction returns whether a RecordFunction needs to be
+ * constructed for the current scope at all; when the only callbacks
+ * are global callbacks sampled with a low probability, the coin flip is made
+ * here, once per scope, with a thread local countdown and pre_sampled is set
+ * to true, so that most scopes skip RecordFunction construction entirely
+ */
+TORCH_API bool shouldRunRecordFunction(bool* pre_sampled);
+
 // Using macro to minimize inputs copies,
 // optional argument - function's seq_no
 #define RECORD_FUNCTION_WITH_SCOPE(scope, fn, inputs, ...) \
-  at::RecordFunction guard(scope); \
-  if (guard.active) { \
-    guard._setCurrent(); \
-    if (guard.needs_inputs) { \
-      guard.before(fn, inputs, ##__VA_ARGS__); \
-    } else { \
-      guard.before(fn, ##__VA_ARGS__); \
+  c10::optional<at::RecordFunction> guard; \
+  bool guard_pre_sampled = false; \
+  if (C10_UNLIKELY(at::shouldRunRecordFunction(&guard_pre_sampled))) { \
+    guard.emplace(scope, guard_pre_sampled); \
+    if (guard->active) { \
+      guard->_setCurrent(); \
+      if (guard->needs_inputs) { \
+        guard->before(fn, inputs, ##__VA_ARGS__); \
+      } else { \
+        guard->before(fn, ##__VA_ARGS__); \
+      } \
     } \
   }
 
@@ -354,6 +378,10 @@ class TORCH_API RecordFunctionCallback {
 //  - we allow the added callbacks to be sampled, by specifying a sampling
 //    probability for each callback pair, if the start callback is
 //    not picked to run, the corresponding end callback won't be called
+//  - if all the registered callbacks are global and sampled with a
+//    probability below 0.001, the sampling is done before a RecordFunction
+//    is constructed (see shouldRunRecordFunction), making an always on,
+//    sampled observer cheap
 //  - a typical use case for the global callbacks is passive monitoring
 //    in the background (e.g. fleet-wide monitoring), without focusing on
 //    the specific peice of code
@@ -459,5 +487,7 @@ class TORCH_API DisableRecordFunctionGuard : public RecordFunctionGuard {
 // Internal, used in ThreadLocalState to propagate TLS callbacks across threads
 TORCH_API RecordFunctionCallbacks _getTLSCallbacks();
 TORCH_API void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks);
+// Whether the TLS callbacks are the given ones, compared by their handles
+TORCH_API bool _hasTLSCallbacks(const RecordFunctionCallbacks& callbacks);
 
 } // namespace at
@@ -314,6 +314,9 @@ class CAFFE2_API Tensor {
   /// Returns if a `Tensor` has sparse backend.
   bool is_sparse() const;
 
+  /// Returns if a `Tensor` has sparse CSR backend.
+  bool is_sparse_csr() const;
+
   /// Returns if a `Tensor` is mkldnn tensor.
   bool is_mkldnn() const;
 
@@ -528,6 +531,12 @@ class CAFFE2_API Tensor {
     return impl_->requires_grad();
   }
 
+  /// Whether this tensor was created in `c10::InferenceMode`. Such tensors
+  /// can't be used in autograd.
+  bool is_inference() const {
+    return impl_->is_inference();
+  }
+
   /// Return a mutable reference to the gradient. This is conventionally
   /// used as `t.grad() = x` to set a gradient to a completely new tensor.
   Tensor& grad() {
@@ -144,6 +144,40 @@ TEST(IValueTest, FutureExceptions) {
   ASSERT_EQ(std::string(f3->error()->what()), std::string("My Error"));
 }
 
+TEST(IValueTest, FutureThen) {
+  auto f1 = c10::make_intrusive<ivalue::Future>(IntType::get());
+  auto f2 = f1->then([f1]() -> IValue { return f1->value().toInt() + 1; },
+                     IntType::get());
+  auto f3 = f2->then([]() -> IValue { throw std::runtime_error("My Error"); },
+                     IntType::get());
+  ASSERT_FALSE(f2->completed());
+  f1->markCompleted(IValue(42));
+  ASSERT_EQ(f2->value().toInt(), 43);
+  ASSERT_TRUE(f3->hasError());
+  ASSERT_EQ(std::string(f3->error()->what()), std::string("My Error"));
+}
+
+TEST(IValueTest, FutureExecutor) {
+  std::vector<std::function<void(void)>> scheduled;
+  auto executor = [&scheduled](std::function<void(void)> cb) {
+    scheduled.push_back(std::move(cb));
+  };
+  auto f1 = c10::make_intrusive<ivalue::Future>(IntType::get());
+  int calledTimes = 0;
+  f1->addCallback([&calledTimes]() { ++calledTimes; }, executor);
+  auto f2 = f1->then([]() -> IValue { return 1; }, IntType::get(), executor);
+  f1->markCompleted(IValue(42));
+  // Completing the future only hands the callbacks to the executor.
+  ASSERT_EQ(calledTimes, 0);
+  ASSERT_FALSE(f2->completed());
+  ASSERT_EQ(scheduled.size(), 2);
+  for (auto& cb : scheduled) {
+    cb();
+  }
+  ASSERT_EQ(calledTimes, 1);
+  ASSERT_EQ(f2->value().toInt(), 1);
+}
+
 TEST(IValueTest, ValueEquality) {
   EXPECT_EQ(IValue("asdf"), IValue("asdf"));
   EXPECT_NE(IValue("asdf"), IValue("ASDF"));
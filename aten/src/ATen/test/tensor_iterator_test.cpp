@@ -210,3 +210,33 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   config.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(config.build());
 }
+
+TEST(TensorIteratorTest, SetupCache) {
+  TensorIterator::set_setup_cache_enabled(true);
+  TensorIterator::reset_setup_cache_stats();
+  auto a = at::randn({4, 3});
+  auto b = at::randn({3});
+  auto t = at::randn({3, 4}).t();
+
+  auto expected = a + b;
+  auto expected_t = a + t;
+  auto expected_strides = expected_t.strides().vec();
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE((a + b).equal(expected));
+    auto out_t = a + t;
+    ASSERT_TRUE(out_t.equal(expected_t));
+    ASSERT_EQ(out_t.strides(), IntArrayRef(expected_strides));
+  }
+  auto stats = TensorIterator::setup_cache_stats();
+  EXPECT_GE(stats.hits, 6);
+  EXPECT_GE(stats.misses, 2);
+
+  // A new shape misses and still computes the right result.
+  auto c = at::randn({5, 3});
+  ASSERT_TRUE((c + b).equal(c + b.expand({5, 3}).contiguous()));
+  EXPECT_GT(TensorIterator::setup_cache_stats().misses, stats.misses);
+
+  TensorIterator::reset_setup_cache_stats();
+  EXPECT_EQ(TensorIterator::setup_cache_stats().hits, 0);
+  TensorIterator::set_setup_cache_enabled(false);
+}
@@ -4,9 +4,12 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <string.h>
 #include <sstream>
+#include <thread>
 
 using namespace at;
 
@@ -36,6 +39,80 @@ TEST(TestParallel, NestedParallel) {
   });
 }
 
+TEST(TestParallel, UnevenWork) {
+  // every element must be visited exactly once, even when a few chunks are
+  // much slower than the others
+  const int64_t n = 100000;
+  std::vector<std::atomic<int>> visits(n);
+  for (auto& v : visits) {
+    v = 0;
+  }
+  at::parallel_for(0, n, 16, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (i % 10007 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+      visits[i]++;
+    }
+  });
+  for (auto& v : visits) {
+    ASSERT_EQ(v.load(), 1);
+  }
+
+  const int64_t sum = at::parallel_reduce(
+      0, n, 16, (int64_t)0,
+      [](int64_t begin, int64_t end, int64_t ident) {
+        int64_t partial = ident;
+        for (int64_t i = begin; i < end; ++i) {
+          partial += i;
+        }
+        return partial;
+      },
+      [](int64_t a, int64_t b) { return a + b; });
+  ASSERT_EQ(sum, n * (n - 1) / 2);
+}
+
+TEST(TestParallel, NestedParallelism) {
+  const bool prev_nested = at::get_nested_parallelism();
+  at::set_nested_parallelism(true);
+
+  // inner regions may now run in parallel too, but every element must still
+  // be visited exactly once
+  const int64_t outer = 16;
+  const int64_t inner = 10000;
+  std::vector<std::atomic<int>> visits(outer * inner);
+  for (auto& v : visits) {
+    v = 0;
+  }
+  at::parallel_for(0, outer, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      at::parallel_for(0, inner, 100, [&](int64_t inner_begin, int64_t inner_end) {
+        for (int64_t j = inner_begin; j < inner_end; ++j) {
+          visits[i * inner + j]++;
+        }
+      });
+    }
+  });
+  for (auto& v : visits) {
+    ASSERT_EQ(v.load(), 1);
+  }
+
+  // reductions running inside a parallel region give the same result
+  Tensor a = ones({1024, 1024});
+  auto expected = a.sum();
+  std::atomic<int> mismatches{0};
+  at::parallel_for(0, 4, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (!a.sum().equal(expected)) {
+        mismatches++;
+      }
+    }
+  });
+  ASSERT_EQ(mismatches.load(), 0);
+
+  at::set_nested_parallelism(prev_nested);
+}
+
 TEST(TestParallel, Exceptions) {
   // parallel case
   ASSERT_THROW(
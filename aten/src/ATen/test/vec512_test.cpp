@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <ATen/cpu/vec512/vec512.h>
+#include <ATen/cpu/vec512/functional.h>
+#include <ATen/cpu/vec/vec.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace at::vec512;
+using at::vec256::Vec256;
+
+// These tests are built without AVX512 flags, so they exercise the generic
+// Vec512 that forwards to two Vec256 halves (see Note [Vec512]).
+
+template <typename T>
+class Vec512Test : public ::testing::Test {};
+
+using Vec512Types = ::testing::Types<float, double, int64_t, int32_t, int16_t>;
+TYPED_TEST_CASE(Vec512Test, Vec512Types);
+
+template <typename T>
+void fill(T* a, T* b) {
+  for (int64_t i = 0; i < Vec512<T>::size(); ++i) {
+    a[i] = static_cast<T>(i + 1);
+    b[i] = static_cast<T>(2 * i - 7);
+  }
+}
+
+TYPED_TEST(Vec512Test, Size) {
+  using T = TypeParam;
+  ASSERT_EQ(Vec512<T>::size(), 2 * Vec256<T>::size());
+}
+
+TYPED_TEST(Vec512Test, LoadStore) {
+  using T = TypeParam;
+  using Vec = Vec512<T>;
+  T a[Vec::size()], b[Vec::size()], out[Vec::size()];
+  fill(a, b);
+  Vec::loadu(a).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], a[i]);
+  }
+  // Partial loads zero-fill, partial stores leave the tail untouched.
+  const int64_t count = Vec256<T>::size() + 3;
+  Vec::loadu(a, count).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], i < count ? a[i] : T(0));
+  }
+  std::fill(out, out + Vec::size(), T(42));
+  Vec::loadu(a).store(out, count);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], i < count ? a[i] : T(42));
+  }
+}
+
+TYPED_TEST(Vec512Test, Halves) {
+  using T = TypeParam;
+  using Vec = Vec512<T>;
+  T a[Vec::size()], b[Vec::size()], out[Vec::size()];
+  fill(a, b);
+  auto v = Vec::loadu(a);
+  Vec(v.get_low(), v.get_high()).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], a[i]);
+  }
+  v.get_high().store(out);
+  for (int64_t i = 0; i < Vec256<T>::size(); ++i) {
+    ASSERT_EQ(out[i], a[Vec256<T>::size() + i]);
+  }
+}
+
+TYPED_TEST(Vec512Test, BlendAndSet) {
+  using T = TypeParam;
+  using Vec = Vec512<T>;
+  T a[Vec::size()], b[Vec::size()], out[Vec::size()];
+  fill(a, b);
+  auto va = Vec::loadu(a);
+  auto vb = Vec::loadu(b);
+  constexpr int64_t mask = 0x5;
+  Vec::template blend<mask>(va, vb).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], ((mask >> i) & 1) ? b[i] : a[i]);
+  }
+  Vec::blendv(va, vb, va < vb).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], a[i] < b[i] ? b[i] : a[i]);
+  }
+  const int64_t count = Vec256<T>::size() + 1;
+  Vec::set(va, vb, count).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], i < count ? b[i] : a[i]);
+  }
+  Vec::arange(T(3), 2).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], T(3 + 2 * i));
+  }
+}
+
+TYPED_TEST(Vec512Test, Arithmetic) {
+  using T = TypeParam;
+  using Vec = Vec512<T>;
+  T a[Vec::size()], b[Vec::size()], out[Vec::size()];
+  fill(a, b);
+  auto va = Vec::loadu(a);
+  auto vb = Vec::loadu(b);
+  (va + vb).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], T(a[i] + b[i]));
+  }
+  (va * vb - va).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], T(a[i] * b[i] - a[i]));
+  }
+  maximum(va, vb).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], std::max(a[i], b[i]));
+  }
+  clamp(vb, Vec(T(-2)), Vec(T(5))).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], std::min(std::max(b[i], T(-2)), T(5)));
+  }
+  va.le(vb).store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], T(a[i] <= b[i]));
+  }
+}
+
+TYPED_TEST(Vec512Test, Interleave) {
+  using T = TypeParam;
+  using Vec = Vec512<T>;
+  T a[Vec::size()], b[Vec::size()], out[Vec::size()];
+  fill(a, b);
+  auto interleaved = interleave2(Vec::loadu(a), Vec::loadu(b));
+  interleaved.first.store(out);
+  for (int64_t i = 0; i < Vec::size() / 2; ++i) {
+    ASSERT_EQ(out[2 * i], a[i]);
+    ASSERT_EQ(out[2 * i + 1], b[i]);
+  }
+  auto deinterleaved = deinterleave2(interleaved.first, interleaved.second);
+  deinterleaved.first.store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], a[i]);
+  }
+  deinterleaved.second.store(out);
+  for (int64_t i = 0; i < Vec::size(); ++i) {
+    ASSERT_EQ(out[i], b[i]);
+  }
+}
+
+TEST(Vec512TestFloat, Functional) {
+  using Vec = Vec512<float>;
+  float data[100];
+  float out[100];
+  float sum = 0;
+  for (int64_t i = 0; i < 100; ++i) {
+    data[i] = 0.25f * i - 3.f;
+    sum += data[i];
+  }
+  float vec_sum = at::vec512::reduce_all<float>(
+      [](Vec& x, Vec& y) { return x + y; }, data, 100);
+  ASSERT_NEAR(vec_sum, sum, 1e-3);
+  float vec_max = at::vec512::reduce_all<float>(
+      [](Vec& x, Vec& y) { return maximum(x, y); }, data, 37);
+  ASSERT_EQ(vec_max, data[36]);
+  at::vec512::map([](Vec x) { return x * Vec(2.f); }, out, data, 100);
+  for (int64_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(out[i], 2.f * data[i]);
+  }
+}
+
+TEST(Vec512TestFloat, Vectorized) {
+  // Without AVX512 flags at::vec::Vectorized is Vec256.
+  ASSERT_EQ(at::vec::Vectorized<float>::size(), Vec256<float>::size());
+}
@@ -257,6 +257,42 @@ TEST(VmapTest, TestMultiBatchVmapTransform) {
     ASSERT_EQ(result.tensor().sizes(), expected_result_sizes);
   }
 }
+TEST(VmapTest, TestMultiBatchVmapTransformMultipleTensors) {
+  {
+    // Batch dims get moved to the front and aligned to the levels of all of
+    // the tensors, the example dims don't change.
+    int64_t B0 = 5, B1 = 7;
+    Tensor x = at::randn({2, B0, 3});
+    Tensor y = at::randn({B1, 4});
+    Tensor batched_x = makeBatched(x, {{0, 1}});
+    Tensor batched_y = makeBatched(y, {{1, 0}});
+
+    auto result = MultiBatchVmapTransform::logicalToPhysical({batched_x, batched_y});
+    ASSERT_EQ(result.size(), 2);
+    ASSERT_EQ(result[0].numBatchDims(), 2);
+    ASSERT_EQ(result[1].numBatchDims(), 2);
+    ASSERT_EQ(result[0].tensor().data_ptr(), x.data_ptr());
+    ASSERT_EQ(result[0].tensor().sizes(), IntArrayRef({B0, B1, 2, 3}));
+    ASSERT_EQ(result[1].tensor().sizes(), IntArrayRef({B0, B1, 4}));
+    ASSERT_TRUE(at::allclose(
+        result[0].tensor(), x.permute({1, 0, 2}).unsqueeze(1).expand({B0, B1, 2, 3})));
+    ASSERT_TRUE(at::allclose(result[1].tensor(), y.expand({B0, B1, 4})));
+  }
+  {
+    // Regular tensors get expanded to all of the batch dims
+    int64_t B0 = 5;
+    Tensor x = at::randn({B0, 3});
+    Tensor y = at::randn({2});
+    Tensor batched_x = makeBatched(x, {{0, 0}});
+
+    auto result = MultiBatchVmapTransform::logicalToPhysical({batched_x, y});
+    ASSERT_EQ(result[0].tensor().data_ptr(), x.data_ptr());
+    ASSERT_TRUE(at::allclose(result[0].tensor(), x));
+    ASSERT_EQ(result[1].tensor().data_ptr(), y.data_ptr());
+    ASSERT_EQ(result[1].tensor().sizes(), IntArrayRef({B0, 2}));
+  }
+}
+
 TEST(VmapTest, TestVmapPhysicalViewGetPhysicalDim) {
   VmapPhysicalView physical_view(ones({2, 3, 4, 5, 6}), 1 | 4);
 
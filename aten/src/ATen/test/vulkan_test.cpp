@@ -175,6 +175,28 @@ TEST(VulkanTest, mean) {
   ASSERT_TRUE(almostEqual(t_out, t_out_expected));
 }
 
+TEST(VulkanTest, max_pool2d) {
+  if (!at::vulkan::is_available())
+    return;
+  auto t_in = at::rand({2, 5, 7, 7}, at::device(at::kCPU).dtype(at::kFloat));
+  auto t_out_expected = at::max_pool2d(t_in, {3, 3}, {2, 2}, {1, 1}, {1, 1});
+  auto tv_in = t_in.vulkan();
+  auto tv_out = at::max_pool2d(tv_in, {3, 3}, {2, 2}, {1, 1}, {1, 1});
+  auto t_out = tv_out.cpu();
+  ASSERT_TRUE(almostEqual(t_out, t_out_expected));
+}
+
+TEST(VulkanTest, avg_pool2d) {
+  if (!at::vulkan::is_available())
+    return;
+  auto t_in = at::rand({2, 5, 7, 7}, at::device(at::kCPU).dtype(at::kFloat));
+  auto t_out_expected = at::avg_pool2d(t_in, {3, 3}, {2, 2}, {1, 1});
+  auto tv_in = t_in.vulkan();
+  auto tv_out = at::avg_pool2d(tv_in, {3, 3}, {2, 2}, {1, 1});
+  auto t_out = tv_out.cpu();
+  ASSERT_TRUE(almostEqual(t_out, t_out_expected));
+}
+
 enum class OpType { conv2d, hardtanh_, mean, addmm };
 
 class BaseOp {
@@ -273,6 +273,40 @@ void THBlas_(gemm)(
   }
 #endif
 
+#if defined(TH_REAL_IS_HALF) || defined(TH_REAL_IS_BFLOAT16)
+  // Half and BFloat16 only have 11 and 8 bits of mantissa, so the products are
+  // summed in float and every element of c is rounded once
+  {
+    float *acc = (float*)THAlloc(m * sizeof(float));
+    for (int64_t j = 0; j < n; j++) {
+      for (int64_t i = 0; i < m; i++) {
+        acc[i] = 0;
+      }
+      for (int64_t l = 0; l < k; l++) {
+        const float b_lj = transb_ ? b[j + l * ldb] : b[l + j * ldb];
+        if (transa_) {
+          for (int64_t i = 0; i < m; i++) {
+            acc[i] += a[l + i * lda] * b_lj;
+          }
+        } else {
+          for (int64_t i = 0; i < m; i++) {
+            acc[i] += a[i + l * lda] * b_lj;
+          }
+        }
+      }
+      for (int64_t i = 0; i < m; i++) {
+        if (beta == 0) {
+          c[j * ldc + i] = alpha * acc[i];
+        } else {
+          c[j * ldc + i] = static_cast<float>(beta) * c[j * ldc + i] + alpha * acc[i];
+        }
+      }
+    }
+    THFree(acc);
+    return;
+  }
+#endif
+
   {
     if(!transa_ && !transb_)
     {
@@ -230,6 +230,87 @@ static void THTensor_(quicksortdescend)(scalar_t *arr, int64_t *idx, int64_t ele
 #undef MAX_LEVELS
 #undef M_SMALL
 
+/* Merges the sorted runs [lo, mid) and [mid, hi) of vals/inds into
+   out_vals/out_inds. Equal elements keep the order of the runs. */
+static void THTensor_(mergeruns)(const scalar_t *vals, const int64_t *inds,
+                                 scalar_t *out_vals, int64_t *out_inds,
+                                 int64_t lo, int64_t mid, int64_t hi, int descendingOrder)
+{
+  int64_t i = lo, j = mid, k = lo;
+  while (i < mid && j < hi) {
+    bool right_first = descendingOrder ? GT_OR_NAN(vals[j], vals[i]) : GT_OR_NAN(vals[i], vals[j]);
+    if (right_first) {
+      out_vals[k] = vals[j];
+      out_inds[k++] = inds[j++];
+    } else {
+      out_vals[k] = vals[i];
+      out_inds[k++] = inds[i++];
+    }
+  }
+  for (; i < mid; i++, k++) {
+    out_vals[k] = vals[i];
+    out_inds[k] = inds[i];
+  }
+  for (; j < hi; j++, k++) {
+    out_vals[k] = vals[j];
+    out_inds[k] = inds[j];
+  }
+}
+
+/* The quicksorts above run on a single thread, so sorting a few large
+   slices leaves the other cores idle. This instead splits the slice into
+   one run per thread, quicksorts the runs in parallel, then merges them
+   pairwise, each round of merges running in parallel, and writes the
+   result and its indices back to arr/idx. */
+static void THTensor_(parallelsort)(scalar_t *arr, int64_t *idx, int64_t elements, int64_t stride, int descendingOrder)
+{
+  int64_t num_runs = std::min<int64_t>(
+      at::get_num_threads(), at::divup(elements, TH_OMP_OVERHEAD_THRESHOLD));
+  int64_t run_size = at::divup(elements, num_runs);
+
+  std::vector<scalar_t> vals(elements), tmp_vals(elements);
+  std::vector<int64_t> inds(elements), tmp_inds(elements);
+  at::parallel_for(0, num_runs, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) {
+      int64_t lo = r * run_size;
+      int64_t hi = std::min(elements, lo + run_size);
+      for (int64_t i = lo; i < hi; i++) {
+        vals[i] = arr[i*stride];
+        inds[i] = i;
+      }
+      if (lo < hi) {
+        if (descendingOrder) {
+          THTensor_(quicksortdescend)(vals.data() + lo, inds.data() + lo, hi - lo, 1);
+        } else {
+          THTensor_(quicksortascend)(vals.data() + lo, inds.data() + lo, hi - lo, 1);
+        }
+      }
+    }
+  });
+
+  scalar_t *src_vals = vals.data(), *dst_vals = tmp_vals.data();
+  int64_t *src_inds = inds.data(), *dst_inds = tmp_inds.data();
+  for (int64_t width = run_size; width < elements; width *= 2) {
+    at::parallel_for(0, at::divup(elements, 2 * width), 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; p++) {
+        int64_t lo = p * 2 * width;
+        int64_t mid = std::min(elements, lo + width);
+        int64_t hi = std::min(elements, lo + 2 * width);
+        THTensor_(mergeruns)(src_vals, src_inds, dst_vals, dst_inds, lo, mid, hi, descendingOrder);
+      }
+    });
+    std::swap(src_vals, dst_vals);
+    std::swap(src_inds, dst_inds);
+  }
+
+  at::parallel_for(0, elements, TH_OMP_OVERHEAD_THRESHOLD, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      arr[i*stride] = src_vals[i];
+      idx[i*stride] = src_inds[i];
+    }
+  });
+}
+
 void THTensor_(sort)(THTensor *rt_, THLongTensor *ri_, THTensor *t, int dimension, int descendingOrder)
 {
   dimension = at::maybe_wrap_dim(dimension, t);
@@ -242,7 +323,19 @@ void THTensor_(sort)(THTensor *rt_, THLongTensor *ri_, THTensor *t, int dimensio
   at::native::copy_(rt__wrap, t_wrap);
   THLongTensor_resize(ri_, t->sizes(), {});
 
-  if(descendingOrder)
+  /* Slices are sorted one after the other, so when there are fewer of them
+     than threads, the large ones are sorted in parallel instead. */
+  int64_t slice_size = THTensor_sizeLegacyNoScalars(t, dimension);
+  int64_t num_slices = slice_size > 0 ? THTensor_(nElement)(t) / slice_size : 0;
+  bool parallel_slices = num_slices < at::get_num_threads() && !at::in_parallel_region() &&
+      slice_size >= 2 * TH_OMP_OVERHEAD_THRESHOLD;
+
+  if(parallel_slices)
+  {
+    TH_TENSOR_DIM_APPLY2(scalar_t, rt_, int64_t, ri_, dimension,
+                         THTensor_(parallelsort)(rt__data, ri__data, rt__size, rt__stride, descendingOrder);)
+  }
+  else if(descendingOrder)
   {
     TH_TENSOR_DIM_APPLY2(scalar_t, rt_, int64_t, ri_, dimension,
                          int64_t i;
@@ -679,43 +772,6 @@ accreal THTensor_(std_all)(THTensor *tensor, bool unbiased)
   return sqrt(THTensor_(var_all)(tensor, unbiased));
 }
 
-void THTensor_(histc)(THTensor *hist, THTensor *tensor, int64_t nbins, scalar_t minvalue, scalar_t maxvalue)
-{
-  if (nbins <= 0) {
-      THError("bins must be > 0");
-  }
-  scalar_t minval;
-  scalar_t maxval;
-  scalar_t *h_data;
-
-  THTensor_(resize1d)(hist, nbins);
-  THTensor_wrap(hist).zero_();
-  minval = minvalue;
-  maxval = maxvalue;
-  if (minval == maxval)
-  {
-    minval = THTensor_wrap(tensor).min().item<scalar_t>();
-    maxval = THTensor_wrap(tensor).max().item<scalar_t>();
-  }
-  if (minval == maxval)
-  {
-    minval = minval - 1;
-    maxval = maxval + 1;
-  }
-
-  TORCH_CHECK(!(std::isinf(minval) || std::isinf(maxval) || std::isnan(minval) || std::isnan(maxval)), "range of [", minval, ", ", maxval, "] is not finite");
-  TORCH_CHECK(minval < maxval, "max must be larger than min");
-
-  h_data = hist->data<scalar_t>();
-
-  TH_TENSOR_APPLY(scalar_t, tensor,
-    if (*tensor_data >= minval && *tensor_data <= maxval) {
-      const int bin = (int)((*tensor_data-minval) / (maxval-minval) * nbins);
-      h_data[THMin(bin, nbins-1)] += 1;
-    }
-  );
-}
-
 #endif
 
 #undef TH_MATH_NAME
@@ -107,6 +107,8 @@ static inline uint32_t detectHostSIMDExtensions()
 {
   using at::native::CPUCapability;
   switch (at::native::get_cpu_capability()) {
+  // TH has no AVX512 kernels; use the AVX2 ones.
+  case CPUCapability::AVX512:
   case CPUCapability::AVX2:
     return SIMDExtension_AVX2 | SIMDExtension_AVX | SIMDExtension_SSE;
   case CPUCapability::AVX:
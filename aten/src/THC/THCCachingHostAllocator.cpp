@@ -4,44 +4,151 @@
 
 
 #include <cuda_runtime_api.h>
+#include <algorithm>
+#include <cctype>
 #include <deque>
+#include <fstream>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <set>
 #include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace {
 
+// Allocations are rounded up to size classes, four per power of two and at
+// least a page apart, so that a cached block is reused for every size of its
+// class while wasting at most a quarter of it.
+constexpr size_t kMinAllocSize = 4096;
+
+size_t roundSize(size_t size)
+{
+  if (size <= kMinAllocSize) {
+    return kMinAllocSize;
+  }
+  size_t pow2 = kMinAllocSize;
+  while (pow2 < size / 2 + size % 2) {
+    pow2 *= 2;
+  }
+  // pow2 < size <= 2 * pow2
+  const size_t step = std::max(pow2 / 4, kMinAllocSize);
+  return (size + step - 1) / step * step;
+}
+
+// Returns the NUMA node closest to the device, or -1 if it is unknown.
+int deviceNumaNode(int device)
+{
+#ifdef __linux__
+  char bus_id[32];
+  if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device) != cudaSuccess) {
+    cudaGetLastError(); // clear CUDA error
+    return -1;
+  }
+  std::string path = "/sys/bus/pci/devices/";
+  for (const char* c = bus_id; *c; ++c) {
+    path += static_cast<char>(std::tolower(*c));
+  }
+  std::ifstream numa_node(path + "/numa_node");
+  int node = -1;
+  if (!(numa_node >> node)) {
+    return -1;
+  }
+  return node;
+#else
+  return -1;
+#endif
+}
+
 struct BlockSize
 {
+  int     node; // NUMA node the block is cached for, or -1
   size_t  size; // allocation size
   void*   ptr;  // host memory pointer
 
-  BlockSize(size_t size, void* ptr=NULL) : size(size), ptr(ptr) {}
+  BlockSize(int node, size_t size, void* ptr=NULL) : node(node), size(size), ptr(ptr) {}
 };
 
 struct Block : public BlockSize
 {
   bool  allocated;    // true if the block is currently allocated
+  bool  registered;   // true if mapped by us and cudaHostRegister'ed
   int   event_count;  // number of outstanding cuda events
   std::unordered_set<at::cuda::CUDAStream> streams;
 
-  Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
+  Block(int node, size_t size, void* ptr, bool allocated, bool registered) :
+      BlockSize(node, size, ptr), allocated(allocated), registered(registered),
+      event_count(0), streams() {}
 };
 
 static bool BlockComparator(const BlockSize& a, const BlockSize& b)
 {
-  // sort by size, break ties with pointer
+  // sort by node, then size, break ties with pointer
+  if (a.node != b.node) {
+    return a.node < b.node;
+  }
   if (a.size != b.size) {
     return a.size < b.size;
   }
   return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
 }
 
+// Allocates pinned memory, bound to NUMA node if it is not -1 so that copies
+// to the GPUs attached to that node don't cross the socket interconnect.
+cudaError_t allocPinned(void** ptr, size_t size, int node, bool* registered)
+{
+#ifdef __linux__
+  if (node >= 0) {
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped != MAP_FAILED) {
+      // MPOL_PREFERRED, so that the memory comes from the other nodes rather
+      // than failing when the node is full. cudaHostRegister faults the pages
+      // in under this policy.
+      constexpr int kMpolPreferred = 1;
+      constexpr size_t kBitsPerLong = 8 * sizeof(unsigned long);
+      std::vector<unsigned long> node_mask(node / kBitsPerLong + 1, 0);
+      node_mask[node / kBitsPerLong] |= 1UL << (node % kBitsPerLong);
+      syscall(SYS_mbind, mapped, size, kMpolPreferred, node_mask.data(),
+              node_mask.size() * kBitsPerLong + 1, 0);
+      cudaError_t err = cudaHostRegister(mapped, size, cudaHostRegisterPortable);
+      if (err == cudaSuccess) {
+        *ptr = mapped;
+        *registered = true;
+        return cudaSuccess;
+      }
+      // fall back to cudaHostAlloc, e.g. under a driver that can't register
+      // memory
+      cudaGetLastError(); // clear CUDA error
+      munmap(mapped, size);
+    }
+  }
+#endif
+  *registered = false;
+  return cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+}
+
+cudaError_t freePinned(const Block& block)
+{
+#ifdef __linux__
+  if (block.registered) {
+    cudaError_t err = cudaHostUnregister(block.ptr);
+    munmap(block.ptr, block.size);
+    return err;
+  }
+#endif
+  return cudaFreeHost(block.ptr);
+}
+
 struct HostAllocator
 {
   typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
@@ -58,30 +165,46 @@ struct HostAllocator
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
 
+  // NUMA node closest to each device, -2 until looked up
+  std::vector<int> device_nodes;
+
   HostAllocator() : available(BlockComparator) {}
 
   cudaError_t malloc(void** ptr, size_t size)
   {
+    if (size == 0) {
+      *ptr = nullptr;
+      return cudaSuccess;
+    }
+
     std::lock_guard<std::mutex> lock(mutex);
 
-    // process outstanding cuda events which may have occurred
-    cudaError_t err = processEvents();
+    // the memory is bound to the node closest to the current device, which
+    // pinned memory is mostly allocated for copies to
+    int device = 0;
+    cudaError_t err = cudaGetDevice(&device);
     if (err != cudaSuccess) {
       return err;
     }
+    const int node = numaNode(device);
+    size = roundSize(size);
 
-    // search for the smallest block which can hold this allocation
-    BlockSize search_key(size);
-    auto it = available.lower_bound(search_key);
-    if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
-      THAssert(!block.allocated && block.event_count == 0);
-      block.allocated = true;
-      *ptr = block.ptr;
-      available.erase(it);
+    if (takeAvailable(ptr, node, size)) {
       return cudaSuccess;
     }
 
+    // Only poll the outstanding cuda events on a cache miss, rather than on
+    // every call, and retry
+    if (!cuda_events.empty()) {
+      err = processEvents();
+      if (err != cudaSuccess) {
+        return err;
+      }
+      if (takeAvailable(ptr, node, size)) {
+        return cudaSuccess;
+      }
+    }
+
     // Pinned memory pointers allocated by any device can be directly used by any
     // other device, regardless of the current device at the time of allocation,
     // since we assume unified addressing.
@@ -93,16 +216,17 @@ struct HostAllocator
       device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
     }
 
-    // note that cudaHostAlloc may not touch pointer if size is 0
     *ptr = 0;
 
     // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    bool registered = false;
+    err = allocPinned(ptr, size, node, &registered);
     if (err != cudaSuccess) {
       return err;
     }
 
-    blocks.insert({*ptr, Block(size, *ptr, true)});
+    // cached for node even if binding it failed, so that we don't retry
+    blocks.insert({*ptr, Block(node, size, *ptr, true, registered)});
     return cudaSuccess;
   }
 
@@ -114,12 +238,6 @@ struct HostAllocator
       return cudaSuccess;
     }
 
-    // process outstanding cuda events which may have occurred
-    cudaError_t err = processEvents();
-    if (err != cudaSuccess) {
-      return err;
-    }
-
     auto it = blocks.find(ptr);
     THAssert(it != blocks.end());
 
@@ -131,7 +249,7 @@ struct HostAllocator
     block.allocated = false;
 
     // insert CUDA events for each stream on which this block was used. This
-    err = insertEvents(block);
+    cudaError_t err = insertEvents(block);
     if (err != cudaSuccess) {
       return err;
     }
@@ -164,32 +282,36 @@ struct HostAllocator
   {
     // Process outstanding cudaEvents. Events that are completed are removed
     // from the queue, and the 'event_count' for the corresponding allocation
-    // is decremented. Stops at the first event which has not been completed.
-    // Since events on different devices or streams may occur out of order,
-    // the processing of some events may be delayed.
-    while (!cuda_events.empty()) {
-      auto& e = cuda_events.front();
-      cudaEvent_t event = e.first;
-
-      cudaError_t err = cudaEventQuery(event);
+    // is decremented. Every event is queried once per call, since events on
+    // different devices or streams may occur out of order.
+    std::deque<std::pair<cudaEvent_t, void*>> pending;
+    cudaError_t err = cudaSuccess;
+    auto it = cuda_events.begin();
+    for (; it != cuda_events.end(); ++it) {
+      err = cudaEventQuery(it->first);
       if (err == cudaErrorNotReady) {
-        break;
+        cudaGetLastError(); // clear CUDA error
+        err = cudaSuccess;
+        pending.push_back(*it);
+        continue;
       } else if (err != cudaSuccess) {
-        return err;
+        break;
       }
-      err = cudaEventDestroy(event);
+      err = cudaEventDestroy(it->first);
       if (err != cudaSuccess) {
-        return err;
+        break;
       }
 
-      Block& block = blocks.at(e.second);
+      Block& block = blocks.at(it->second);
       block.event_count--;
       if (block.event_count == 0 && !block.allocated) {
         available.insert(block);
       }
-      cuda_events.pop_front();
     }
-    return cudaSuccess;
+    // on error, keep the events that weren't processed
+    pending.insert(pending.end(), it, cuda_events.end());
+    cuda_events.swap(pending);
+    return err;
   }
 
   void emptyCache()
@@ -216,7 +338,7 @@ struct HostAllocator
     for (auto it = blocks.begin(); it != blocks.end();) {
       Block& block = it->second;
       if (!block.allocated) {
-        THCudaCheckWarn(cudaFreeHost(block.ptr));
+        THCudaCheckWarn(freePinned(block));
         it = blocks.erase(it);
       } else {
         ++it;
@@ -251,6 +373,32 @@ struct HostAllocator
     cudaSetDevice(prev_device);
     return err;
   }
+
+  // Takes a cached block of exactly size bytes on node, if there is one.
+  bool takeAvailable(void** ptr, int node, size_t size)
+  {
+    auto it = available.lower_bound(BlockSize(node, size));
+    if (it == available.end() || it->node != node || it->size != size) {
+      return false;
+    }
+    Block& block = blocks.at(it->ptr);
+    THAssert(!block.allocated && block.event_count == 0);
+    block.allocated = true;
+    *ptr = block.ptr;
+    available.erase(it);
+    return true;
+  }
+
+  int numaNode(int device)
+  {
+    if (device >= static_cast<int>(device_nodes.size())) {
+      device_nodes.resize(device + 1, -2);
+    }
+    if (device_nodes[device] == -2) {
+      device_nodes[device] = deviceNumaNode(device);
+    }
+    return device_nodes[device];
+  }
 };
 
 }  // namespace
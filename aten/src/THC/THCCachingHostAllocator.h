@@ -19,7 +19,11 @@
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
 // Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// blocks, unlike the caching device allocator. Instead, sizes are rounded up
+// to size classes, four per power of two, and freed blocks are reused for
+// their class. On Linux, the memory is bound to the NUMA node closest to the
+// current device, and cached per node. Outstanding events are only polled
+// when no cached block fits an allocation.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
@@ -224,6 +224,141 @@ bitonicSortKVInPlace(TensorInfo<K, IndexType> keys,
   }
 }
 
+// Number of threads of the blocks of warpBitonicSortKVInPlace
+constexpr int kWarpBitonicSortBlockSize = 128;
+
+// Same as bitonicSort, for a sort of Power2SortSize <= 2 * warpSize
+// elements done by the Power2SortSize / 2 threads of a warp that own them,
+// `lane` being the index of the thread within those
+template <typename Comparator, typename K, typename V, int Power2SortSize>
+__device__ inline void warpBitonicSort(K keys[Power2SortSize],
+                                       V values[Power2SortSize],
+                                       bool valid[Power2SortSize],
+                                       unsigned int lane,
+                                       const Comparator& comp) {
+#ifndef __HIP_PLATFORM_HCC__
+#define WARP_BITONIC_SORT_SYNC() __syncwarp()
+#else
+#define WARP_BITONIC_SORT_SYNC() __syncthreads()
+#endif
+
+#ifndef __HIP_PLATFORM_HCC__
+#pragma unroll
+#endif
+  for (unsigned int size = 2; size < Power2SortSize; size *= 2) {
+    bool flag = ((lane & (size / 2)) != 0);
+
+#ifndef __HIP_PLATFORM_HCC__
+#pragma unroll
+#endif
+    for (unsigned int stride = size / 2; stride > 0; stride /= 2) {
+
+      WARP_BITONIC_SORT_SYNC();
+
+      unsigned int pos = 2 * lane - (lane & (stride - 1));
+      bitonicSwap<Comparator, K, V>(
+        keys[pos], values[pos], valid[pos],
+        keys[pos + stride], values[pos + stride], valid[pos + stride],
+        flag, comp);
+    }
+  }
+
+#ifndef __HIP_PLATFORM_HCC__
+#pragma unroll
+#endif
+  for (unsigned int stride = Power2SortSize / 2; stride > 0; stride /= 2) {
+
+    WARP_BITONIC_SORT_SYNC();
+
+    unsigned int pos = 2 * lane - (lane & (stride - 1));
+    bitonicSwap<Comparator, K, V>(
+      keys[pos], values[pos], valid[pos],
+      keys[pos + stride], values[pos + stride], valid[pos + stride],
+      false, comp);
+  }
+
+  WARP_BITONIC_SORT_SYNC();
+
+#undef WARP_BITONIC_SORT_SYNC
+}
+
+// Sorts (key, value) pairs in-place like bitonicSortKVInPlace, for slices
+// of at most Power2SortSize <= 32 elements. One block per slice would
+// have most of its threads idle and be dominated by the launch of the
+// blocks, so every block sorts kWarpBitonicSortBlockSize /
+// (Power2SortSize / 2) slices, each by threads of the same warp.
+template <typename K, typename V,
+          int KeyDims, int ValueDims,
+          typename Comparator, typename IndexType, int Power2SortSize>
+C10_LAUNCH_BOUNDS_1(kWarpBitonicSortBlockSize)
+__global__ void
+warpBitonicSortKVInPlace(TensorInfo<K, IndexType> keys,
+                         IndexType keySlices,
+                         IndexType keySliceSize,
+                         IndexType keySliceStride,
+                         TensorInfo<V, IndexType> values,
+                         IndexType valueSliceStride,
+                         Comparator comp) {
+  static_assert(Power2SortSize >= 2 && Power2SortSize <= 32,
+                "warpBitonicSortKVInPlace sorts 2 to 32 elements");
+  constexpr int kThreadsPerSlice = Power2SortSize / 2;
+  constexpr int kSlicesPerBlock =
+    kWarpBitonicSortBlockSize / kThreadsPerSlice;
+
+  __shared__ K sharedKeys[kSlicesPerBlock][Power2SortSize];
+  __shared__ V sharedValues[kSlicesPerBlock][Power2SortSize];
+  __shared__ bool sharedValid[kSlicesPerBlock][Power2SortSize];
+
+  const int blockSlice = threadIdx.x / kThreadsPerSlice;
+  const unsigned int lane = threadIdx.x % kThreadsPerSlice;
+  const IndexType linearIndex =
+    getLinearBlockId<IndexType>() * kSlicesPerBlock + blockSlice;
+  // The threads of the slices past the end still take part in the sort
+  // of their warp, with invalid entries only
+  const bool sliceValid = linearIndex < keySlices;
+
+  const IndexType keyStartOffset = sliceValid ?
+    IndexToOffset<K, IndexType, KeyDims>::get(linearIndex, keys) : 0;
+  const IndexType valueStartOffset = sliceValid ?
+    IndexToOffset<V, IndexType, ValueDims>::get(linearIndex, values) : 0;
+
+  // Every thread loads and stores 2 elements
+  const int elem1 = lane;
+  const int elem2 = lane + kThreadsPerSlice;
+
+  bool valid1 = sliceValid && (elem1 < keySliceSize);
+  sharedKeys[blockSlice][elem1] = valid1 ?
+    keys.data[keyStartOffset + elem1 * keySliceStride] : ScalarConvert<int, K>::to(0);
+  sharedValues[blockSlice][elem1] = valid1 ?
+    values.data[valueStartOffset + elem1 * valueSliceStride] : ScalarConvert<int, V>::to(0);
+  sharedValid[blockSlice][elem1] = valid1;
+
+  bool valid2 = sliceValid && (elem2 < keySliceSize);
+  sharedKeys[blockSlice][elem2] = valid2 ?
+    keys.data[keyStartOffset + elem2 * keySliceStride] : ScalarConvert<int, K>::to(0);
+  sharedValues[blockSlice][elem2] = valid2 ?
+    values.data[valueStartOffset + elem2 * valueSliceStride] : ScalarConvert<int, V>::to(0);
+  sharedValid[blockSlice][elem2] = valid2;
+
+  warpBitonicSort<Comparator, K, V, Power2SortSize>(
+    sharedKeys[blockSlice], sharedValues[blockSlice], sharedValid[blockSlice],
+    lane, comp);
+
+  if (valid1) {
+    keys.data[keyStartOffset + elem1 * keySliceStride] =
+      sharedKeys[blockSlice][elem1];
+    values.data[valueStartOffset + elem1 * valueSliceStride] =
+      sharedValues[blockSlice][elem1];
+  }
+
+  if (valid2) {
+    keys.data[keyStartOffset + elem2 * keySliceStride] =
+      sharedKeys[blockSlice][elem2];
+    values.data[valueStartOffset + elem2 * valueSliceStride] =
+      sharedValues[blockSlice][elem2];
+  }
+}
+
 uint64_t nextHighestPowerOf2(uint64_t n);
 
 #endif // THC_SORT_UTILS_INC
@@ -75,6 +75,43 @@ void THCTensor_(sortKeyValueInplace)(THCState* state,
     }                                                                   \
   } while (0)
 
+  // Slices of up to 32 elements are sorted by the threads of a warp,
+  // many slices per block
+#define HANDLE_WARP_CASE(TYPE, A, SIZE)                                 \
+  do {                                                                  \
+    const int64_t slicesPerBlock =                                      \
+      kWarpBitonicSortBlockSize / (SIZE / 2);                           \
+    dim3 warpGrid;                                                      \
+    if (!THC_getGridFromTiles(                                          \
+          THCCeilDiv<int64_t>(keySlices, slicesPerBlock), warpGrid)) {  \
+      THError("Slice to sort is too large");                            \
+    }                                                                   \
+                                                                        \
+    dim3 block(kWarpBitonicSortBlockSize);                              \
+                                                                        \
+    if (dir) {                                                          \
+      warpBitonicSortKVInPlace<scalar_t, int64_t, A, -1, GTComp<scalar_t, true>, TYPE, SIZE> \
+        <<<warpGrid, block, 0, c10::cuda::getCurrentCUDAStream()>>>(     \
+          keyInfo,                                                      \
+          keySlices,                                                    \
+          (TYPE) keySliceSize,                                          \
+          (TYPE) keyInfo.strides[collapseKeyDim],                       \
+          valueInfo,                                                    \
+          (TYPE) valueInfo.strides[collapseValueDim],                   \
+          GTComp<scalar_t, true>());                                    \
+    } else {                                                            \
+      warpBitonicSortKVInPlace<scalar_t, int64_t, A, -1, LTComp<scalar_t, true>, TYPE, SIZE> \
+        <<<warpGrid, block, 0, c10::cuda::getCurrentCUDAStream()>>>(     \
+          keyInfo,                                                      \
+          keySlices,                                                    \
+          (TYPE) keySliceSize,                                          \
+          (TYPE) keyInfo.strides[collapseKeyDim],                       \
+          valueInfo,                                                    \
+          (TYPE) valueInfo.strides[collapseValueDim],                   \
+          LTComp<scalar_t, true>());                                    \
+    }                                                                   \
+  } while (0)
+
 #define HANDLE_SORT_CASE(TYPE, A)                       \
   {                                                     \
     switch (ceilPowerOf2) {                             \
@@ -92,10 +129,12 @@ void THCTensor_(sortKeyValueInplace)(THCState* state,
       break;                                            \
       case 32:                                          \
       case 16:                                          \
+      HANDLE_WARP_CASE(TYPE, A, 32);                    \
+      break;                                            \
       case 8:                                           \
       case 4:                                           \
       case 2:                                           \
-      HANDLE_CASE(TYPE, A, 32);                         \
+      HANDLE_WARP_CASE(TYPE, A, 8);                     \
       break;                                            \
       case 1:                                           \
       /* Nothing to do, data already sorted */          \
@@ -145,6 +184,7 @@ void THCTensor_(sortKeyValueInplace)(THCState* state,
     HANDLE_SORT_CASE(uint64_t, -1);
   }
 #undef HANDLE_CASE
+#undef HANDLE_WARP_CASE
 #undef HANDLE_SORT_CASE
 #undef HANDLE_A_CASE
 
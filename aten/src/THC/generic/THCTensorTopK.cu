@@ -155,7 +155,9 @@ void THCTensor_(topk)(THCState* state,
 #else
     int maxSliceSize = 2048;
 #endif
-    if (sliceSize <= maxSliceSize) {
+    // The slices of topK have k elements, so a small k is sorted in place
+    // (by warps for k <= 32) whatever the size of the input slices
+    if (k <= maxSliceSize) {
       // This avoids any memory allocations and performs all sorting
       // work inplace along the slice
       THCTensor_(sortKeyValueInplace)(state, topK, indices, dim, dir);
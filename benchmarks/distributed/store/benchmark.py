@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+#
+# Measure the startup time of a TCPStore with many workers.
+#
+# This program starts a TCPStore server and a number of client processes,
+# which all connect to it and then exchange one key per rank, the way
+# rendezvous shares the addresses of the ranks. It reports the time it takes
+# for all workers to join, and for every worker to read the keys of all the
+# others, with one get() per key and with a single multi_get().
+#
+
+import argparse
+import multiprocessing
+import socket
+import time
+from datetime import timedelta
+
+import torch.distributed as dist
+
+
+def worker(rank, world_size, port, method, start, queue):
+    store = dist.TCPStore("127.0.0.1", port, world_size, False)
+    store.set_timeout(timedelta(seconds=600))
+    joined = time.time()
+    store.set("rank/{}".format(rank), "value/{}".format(rank))
+    keys = ["rank/{}".format(i) for i in range(world_size)]
+    if method == "get":
+        for key in keys:
+            store.get(key)
+    else:
+        store.multi_get(keys)
+    queue.put((joined - start, time.time() - joined))
+
+
+def find_free_port():
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.bind(("127.0.0.1", 0))
+        return sock.getsockname()[1]
+
+
+def run(world_size, method):
+    ctx = multiprocessing.get_context("fork")
+    queue = ctx.Queue()
+
+    # The server doesn't wait for the workers, which are timed instead.
+    port = find_free_port()
+    server = dist.TCPStore("127.0.0.1", port, 1, True)  # noqa: F841
+    start = time.time()
+    processes = [
+        ctx.Process(
+            target=worker,
+            args=(rank, world_size, port, method, start, queue))
+        for rank in range(world_size)
+    ]
+    for process in processes:
+        process.start()
+    times = [queue.get() for _ in range(world_size)]
+    for process in processes:
+        process.join()
+    return max(t[0] for t in times), max(t[1] for t in times)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TCPStore benchmark")
+    parser.add_argument("--world-sizes", type=int, nargs="+",
+                        default=[16, 64, 256, 1024])
+    args = parser.parse_args()
+
+    print("{:>12} {:>8} {:>12} {:>14}".format(
+        "world size", "method", "join (s)", "exchange (s)"))
+    for world_size in args.world_sizes:
+        for method in ["get", "multi_get"]:
+            join_time, exchange_time = run(world_size, method)
+            print("{:>12} {:>8} {:>12.3f} {:>14.3f}".format(
+                world_size, method, join_time, exchange_time))
+
+
+if __name__ == "__main__":
+    main()
@@ -6,6 +6,7 @@ import gc
 import sys
 import json
 import copy
+import time
 
 from .runner import get_nn_runners
 
@@ -42,15 +43,31 @@ def pretty_print(benchresult, colwidth=16, sep=' '):
     return sep.join(items)
 
 
+class WallClockEvent(object):
+    # Stands in for torch.cuda.Event on the CPU, where the ops are synchronous
+    def __init__(self):
+        self.time = None
+
+    def record(self):
+        self.time = time.perf_counter()
+
+    def elapsed_time(self, end_event):
+        return (end_event.time - self.time) * 1000
+
+
 def trainbench(name, rnn_creator, nloops=100, warmup=10,
                seqLength=100, numLayers=1, inputSize=512, hiddenSize=512,
                miniBatch=64, device='cuda', seed=None):
     def train_batch(modeldef):
         # CUDA events for timing
-        fwd_start_event = torch.cuda.Event(enable_timing=True)
-        fwd_end_event = torch.cuda.Event(enable_timing=True)
-        bwd_start_event = torch.cuda.Event(enable_timing=True)
-        bwd_end_event = torch.cuda.Event(enable_timing=True)
+        if device == 'cuda':
+            fwd_start_event = torch.cuda.Event(enable_timing=True)
+            fwd_end_event = torch.cuda.Event(enable_timing=True)
+            bwd_start_event = torch.cuda.Event(enable_timing=True)
+            bwd_end_event = torch.cuda.Event(enable_timing=True)
+        else:
+            fwd_start_event, fwd_end_event, bwd_start_event, bwd_end_event = (
+                WallClockEvent() for _ in range(4))
 
         gc.collect()
 
@@ -78,13 +95,14 @@ def trainbench(name, rnn_creator, nloops=100, warmup=10,
                 assert param.grad is not None
                 param.grad.data.zero_()
 
-        torch.cuda.synchronize()
+        if device == 'cuda':
+            torch.cuda.synchronize()
 
         fwd_time = fwd_start_event.elapsed_time(fwd_end_event)
         bwd_time = bwd_start_event.elapsed_time(bwd_end_event)
         return fwd_time, bwd_time
 
-    assert device == 'cuda'
+    assert device in ('cuda', 'cpu')
     creator_args = creator_args = {
         'seqLength': seqLength, 'numLayers': numLayers,
         'inputSize': inputSize, 'hiddenSize': hiddenSize,
@@ -8,6 +8,18 @@ def add_tensors_loop(x, y):
         z = torch.add(z, x)
     return z
 
+def add_tensors_operator_loop(x, y):
+    z = x + y
+    for i in range(NUM_LOOP_ITERS):
+        z = z + x
+    return z
+
+def relu_method_loop(x, y):
+    z = x.relu()
+    for i in range(NUM_LOOP_ITERS):
+        z = z.relu()
+    return z
+
 class SimpleAddModule(torch.nn.Module):
     def __init__(self, add_op):
         super(SimpleAddModule, self).__init__()
@@ -3,12 +3,14 @@ from utils import ms_to_us, benchmark_module, BenchmarkConfig, ModuleConfig
 import argparse
 from C2Module import C2SimpleNet
 
-from SimpleAddModule import SimpleAddModule, add_tensors_loop
+from SimpleAddModule import SimpleAddModule, add_tensors_loop, add_tensors_operator_loop, relu_method_loop
 from pt_wrapper_module import WrapperModule
 
 """ Framework overhead benchmark script.
 Benchmark framework overhead.
-Currently supported ops: add.
+Currently supported ops: add, add_operator and relu_method. The latter two
+call Tensor.__add__ and Tensor.relu, whose Python argument parsing is a large
+part of the eager mode overhead.
 As of now runs only forward pass.
 Supports both graph mode and eager mode. In graph mode the module is traced via JIT tracing.
 Debug option prints the traced graph is graph_mode is enabled.
@@ -24,7 +26,7 @@ buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_ben
  --add_op --benchmark_c2_net
 """
 
-SUPPORTED_OPS = {"add_op"}
+SUPPORTED_OPS = {"add_op", "add_operator_op", "relu_method_op"}
 
 def parse_op_args(op):
     op_list = ops.split(",")
@@ -94,6 +96,11 @@ def main():
         else:
             module_config = ModuleConfig(add_tensors_loop, None, num_params, graph_mode)
         benchmark_simple_fn(args, config, module_config, SimpleAddModule, result)
+    elif args.op in ("add_operator_op", "relu_method_op"):
+        assert not args.benchmark_c2_net, "{} has no C2 counterpart".format(args.op)
+        pt_fn = add_tensors_operator_loop if args.op == "add_operator_op" else relu_method_loop
+        module_config = ModuleConfig(pt_fn, None, 2, graph_mode)
+        benchmark_simple_fn(args, config, module_config, SimpleAddModule, result)
     print_results(result)
 
 if __name__ == "__main__":
@@ -10,6 +10,7 @@ import json
 import torch
 import copy
 import ast
+import os
 
 # needs to be imported after torch
 import torch.utils.cpp_extension as cpp_extension # noqa
@@ -360,9 +361,29 @@ class BenchmarkRunner(object):
 
         return False
 
+    def _export_cpp_test(self, test_case, configs_file):
+        """ Export a forward PyTorch test for the C++ runner. The CPU tests are
+            the only ones it runs.
+        """
+        test_config = test_case.test_config
+        if (test_case.framework != "PyTorch" or test_config.run_backward or
+                'cuda' in test_config.test_name):
+            return
+        print("# Exporting {}".format(test_config.test_name))
+        file_name = test_config.test_name + ".pt"
+        test_case.export_for_cpp(os.path.join(self.args.export_cpp_dir, file_name))
+        configs_file.write("{}\t{}\t{}\n".format(
+            test_config.test_name, file_name, test_config.input_config))
+
     def run(self):
         self._print_header()
 
+        configs_file = None
+        if self.args.export_cpp_dir:
+            if not os.path.exists(self.args.export_cpp_dir):
+                os.makedirs(self.args.export_cpp_dir)
+            configs_file = open(os.path.join(self.args.export_cpp_dir, "configs.txt"), "w")
+
         for test_metainfo in BENCHMARK_TESTER:
             for test in _build_test(*test_metainfo):
                 full_test_id, test_case = test
@@ -381,6 +402,10 @@ class BenchmarkRunner(object):
                 # requirement.
                 np.random.seed(seed=hash(full_test_id) & ((1 << 32) - 1))
 
+                if configs_file is not None:
+                    self._export_cpp_test(test_case, configs_file)
+                    continue
+
                 print("# Benchmarking {}: {}".format(
                     test_case.framework,
                     test_case.op_bench.module_name()))
@@ -398,3 +423,6 @@ class BenchmarkRunner(object):
                                  for _ in range(self.num_runs)]
 
                 self._print_perf_result(reported_time, test_case)
+
+        if configs_file is not None:
+            configs_file.close()
@@ -134,6 +134,20 @@ class PyTorchOperatorTestCase(object):
             self.op_bench._jit_forward = self.op_bench._generate_jit_forward_graph()
         self.op_bench._jit_forward(num_runs, self.place_holder_tensor)
 
+    def export_for_cpp(self, path):
+        """ Save the forward path of an op, traced with its inputs, which the
+            C++ runner (binaries/operator_benchmark_torch.cc) calls through the
+            dispatcher
+        """
+        op_bench = self.op_bench
+
+        class _Forward(torch.nn.Module):
+            def forward(self, place_holder):
+                return op_bench.forward()
+
+        traced = torch.jit.trace(_Forward(), self.place_holder_tensor, check_trace=False)
+        traced.save(path)
+
     def _print_per_iter(self):
         # print last 50 values
         length = min(len(self.time_series), 50)
@@ -122,6 +122,12 @@ def main():
         help="Only run the forward path of operators"
     )
 
+    parser.add_argument(
+        '--export_cpp_dir',
+        help='Export the forward CPU PyTorch tests to this directory instead of running them, '
+             'for the C++ runner binaries/operator_benchmark_torch.cc',
+        default=None)
+
     parser.add_argument(
         '--framework',
         help='Comma-delimited list of frameworks to test (Caffe2, PyTorch)',
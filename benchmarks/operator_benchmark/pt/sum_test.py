@@ -41,5 +41,42 @@ class SumBenchmark(op_bench.TorchBenchmarkBase):
 
 op_bench.generate_pt_test(sum_configs, SumBenchmark)
 
+
+# Shapes exercising the ways TensorIterator splits a parallel reduction:
+# over the outputs, over the reduced dims, or over both in 2-D blocks.
+# Sweep the thread counts with --omp_num_threads, e.g.
+#   for t in 1 2 4 8 16; do
+#     python -m pt.sum_test --tag_filter reduce_strategy --omp_num_threads $t
+#   done
+# or with ./operator_benchmark_torch --threads=1,2,4,8,16 on the exported tests.
+sum_strategy_configs = op_bench.config_list(
+    attr_names=['shape', 'dims'],
+    attrs=[
+        [(8, 1 << 20), (1,)],       # inner dim of a tall-skinny tensor
+        [(1 << 20, 8), (0,)],       # outer dim, a few contiguous columns
+        [(4096, 4096), (0,)],
+        [(4096, 4096), (1,)],
+        [(16, 4096, 64), (0, 2)],   # several non-contiguous dims
+        [(64, 256, 256), (1, 2)],
+        [(2, 1 << 16, 16), (1,)],   # few columns, many partial outputs
+    ],
+    cross_product_configs={
+        'device': ['cpu'],
+    },
+    tags=['reduce_strategy'],
+)
+
+
+class SumStrategyBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, shape, dims, device):
+        self.input_tensor = torch.rand(shape, device=device)
+        self.dims = dims
+        self.set_module_name("sum")
+
+    def forward(self):
+        return self.input_tensor.sum(dim=self.dims)
+
+op_bench.generate_pt_test(sum_strategy_configs, SumStrategyBenchmark)
+
 if __name__ == "__main__":
     op_bench.benchmark_runner.main()
@@ -8,6 +8,7 @@ from . import attention      # noqa: F401
 from . import broadcast      # noqa: F401
 # from . import conv           # noqa: F401
 from . import elementwise    # noqa: F401
+from . import fusion_patterns  # noqa: F401
 from . import matmul         # noqa: F401
 # from . import normalization  # noqa: F401
 # from . import pooling        # noqa: F401
@@ -78,7 +79,7 @@ Works only with Python3.\n A few examples:
         "--cuda_fuser",
         type=str,
         default="te",
-        help="The Cuda fuser backend to use: one of {te, old, none}",
+        help="The Cuda fuser backend to use: one of {te, nvf, old, none}",
     )
     parser.add_argument(
         "--output",
@@ -93,6 +94,12 @@ Works only with Python3.\n A few examples:
         import torch
 
         torch._C._jit_set_texpr_fuser_enabled(True)
+    elif args.cuda_fuser == "nvf":
+        import torch
+
+        # The CUDA fuser works on the graphs of the profiling executor
+        torch._C._jit_set_profiling_executor(True)
+        torch._C._jit_set_profiling_mode(True)
 
     def set_global_threads(num_threads):
         os.environ["OMP_NUM_THREADS"] = str(num_threads)
@@ -111,6 +111,7 @@ class Benchmark(object):
     def run(self, args):
         torch._C._jit_override_can_fuse_on_gpu(args.cuda_fuser == "old")
         torch._C._jit_set_texpr_fuser_enabled(args.cuda_fuser == "te")
+        torch._C._jit_set_nvfuser_enabled(args.cuda_fuser == "nvf")
         with cuda_pointwise_context(
             args.cuda_pointwise_loop_levels,
             args.cuda_pointwise_block_count,
@@ -0,0 +1,147 @@
+from . import benchmark
+import torch
+
+
+# Common fusion patterns, written in the pointwise ops and reductions that the
+# fusers handle, so that fused kernels can be judged against the eager ones.
+
+
+class LayerNormPatternBench(benchmark.Benchmark):
+    def __init__(self, mode, device, M, N):
+        super().__init__(mode, device)
+        self.M = M
+        self.N = N
+        self.data = self.rand([M, N], device=device, requires_grad=self.requires_grad)
+        self.weight = self.rand([N], device=device, requires_grad=self.requires_grad)
+        self.bias = self.rand([N], device=device, requires_grad=self.requires_grad)
+        self.inputs = [self.data, self.weight, self.bias]
+
+    def forward(self, inp, weight, bias):
+        mean = torch.sum(inp, [1]) / self.N
+        centered = inp - mean.unsqueeze(1)
+        var = torch.sum(centered * centered, [1]) / self.N
+        y = centered * torch.rsqrt(var + 1e-5).unsqueeze(1) * weight + bias
+        return y
+
+    def reference(self):
+        return self.numpy(self.forward(*self.inputs))
+
+    def config(self):
+        return [self.M, self.N]
+
+    @staticmethod
+    def module():
+        return "layernorm_pattern"
+
+    def memory_workload(self):
+        if self.mode == "fwd":
+            sol_count = 1 + 1
+            algorithmic_count = 3 + 1
+        else:
+            sol_count = (1 + 1) + (1 + 1)
+            algorithmic_count = (3 + 1) + (3 + 1)
+
+        buffer_size = self.M * self.N * 4
+        return {
+            "sol": buffer_size * sol_count,
+            "algorithmic": buffer_size * algorithmic_count,
+        }
+
+    @staticmethod
+    def default_configs():
+        return [[4096, 1024], [1 << 16, 64], [64, 1 << 16]]
+
+
+class SoftmaxPatternBench(benchmark.Benchmark):
+    def __init__(self, mode, device, M, N):
+        super().__init__(mode, device)
+        self.M = M
+        self.N = N
+        self.data = self.rand([M, N], device=device, requires_grad=self.requires_grad)
+        self.inputs = [self.data]
+
+    def forward(self, inp):
+        # rand inputs are in [0, 1), exp doesn't overflow without subtracting
+        # the max
+        e = torch.exp(inp)
+        y = e / torch.sum(e, [1]).unsqueeze(1)
+        return y
+
+    def reference(self):
+        return self.numpy(self.forward(self.data))
+
+    def config(self):
+        return [self.M, self.N]
+
+    @staticmethod
+    def module():
+        return "softmax_pattern"
+
+    def memory_workload(self):
+        if self.mode == "fwd":
+            sol_count = 1 + 1
+            algorithmic_count = 3 + 1
+        else:
+            sol_count = (1 + 1) + (1 + 1)
+            algorithmic_count = (3 + 1) + (3 + 1)
+
+        buffer_size = self.M * self.N * 4
+        return {
+            "sol": buffer_size * sol_count,
+            "algorithmic": buffer_size * algorithmic_count,
+        }
+
+    @staticmethod
+    def default_configs():
+        return [[4096, 1024], [1 << 16, 64], [64, 1 << 16]]
+
+
+class BiasDropoutResidualBench(benchmark.Benchmark):
+    def __init__(self, mode, device, M, N):
+        super().__init__(mode, device)
+        self.M = M
+        self.N = N
+        self.p = 0.1
+        self.data = self.rand([M, N], device=device, requires_grad=self.requires_grad)
+        self.bias = self.rand([N], device=device, requires_grad=self.requires_grad)
+        self.residual = self.rand([M, N], device=device, requires_grad=self.requires_grad)
+        self.inputs = [self.data, self.bias, self.residual]
+        self.zeros = torch.zeros(M, N, device=device)
+
+    def forward(self, inp, bias, residual):
+        keep = torch.rand_like(inp) > self.p
+        dropped = torch.where(keep, (inp + bias) * (1.0 / (1.0 - self.p)), self.zeros)
+        y = dropped + residual
+        return y
+
+    # No reference, the dropout mask is random.
+
+    def config(self):
+        return [self.M, self.N]
+
+    @staticmethod
+    def module():
+        return "bias_dropout_residual"
+
+    def memory_workload(self):
+        if self.mode == "fwd":
+            sol_count = 2 + 1
+            algorithmic_count = 4 + 1
+        else:
+            sol_count = (2 + 1) + (1 + 2)
+            algorithmic_count = (4 + 1) + (2 + 2)
+
+        buffer_size = self.M * self.N * 4
+        return {
+            "sol": buffer_size * sol_count,
+            "algorithmic": buffer_size * algorithmic_count,
+        }
+
+    @staticmethod
+    def default_configs():
+        return [[4096, 1024]]
+
+
+benchmark.register_benchmark_class(LayerNormPatternBench)
+benchmark.register_benchmark_class(SoftmaxPatternBench)
+benchmark.register_benchmark_class(BiasDropoutResidualBench)
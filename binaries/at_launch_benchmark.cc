@@ -1,4 +1,6 @@
 #include "ATen/Parallel.h"
+#include "ATen/ThreadLocalState.h"
+#include "ATen/record_function.h"
 
 #include "c10/util/Flags.h"
 #include "caffe2/core/init.h"
@@ -6,6 +8,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <iostream>
+#include <string>
 #include <mutex>
 #include <ctime>
 
@@ -13,6 +16,7 @@ C10_DEFINE_int(iter, 10e4, "Number of at::launch iterations (tasks)");
 C10_DEFINE_int(warmup_iter, 10, "Number of warmup iterations")
 C10_DEFINE_int(inter_op_threads, 0, "Number of inter-op threads");
 C10_DEFINE_int(benchmark_iter, 3, "Number of times to run benchmark")
+C10_DEFINE_int(tls_iter, 10e6, "Number of thread local state propagations");
 
 namespace {
 int iter = 0;
@@ -49,6 +53,31 @@ void launch_tasks_and_wait(int tasks_num) {
   }
 }
 
+// Captures the thread local state and propagates it the way at::launch
+// does: one copy into the task and a guard around it
+void propagate_tls(int tasks_num) {
+  for (auto idx = 0; idx < tasks_num; ++idx) {
+    at::ThreadLocalState state;
+    auto task_state = state;
+    at::ThreadLocalStateGuard guard(task_state);
+  }
+}
+
+void benchmark_tls(const std::string& name) {
+  typedef std::chrono::high_resolution_clock clock;
+  typedef std::chrono::nanoseconds ns;
+
+  for (auto bench_iter = 0; bench_iter < FLAGS_benchmark_iter; ++bench_iter) {
+    auto start_time = clock::now();
+    propagate_tls(FLAGS_tls_iter);
+    auto duration = static_cast<float>(
+        std::chrono::duration_cast<ns>(clock::now() - start_time).count());
+
+    std::cout << "Thread local state propagation (" << name << "): "
+              << (duration / FLAGS_tls_iter) << " ns." << std::endl;
+  }
+}
+
 int main(int argc, char** argv) {
   if (!c10::ParseCommandLineFlags(&argc, &argv)) {
     std::cout << "Failed to parse command line flags" << std::endl;
@@ -89,5 +118,13 @@ int main(int argc, char** argv) {
               << (duration/1000.0) << " s." << std::endl;
   }
 
+  benchmark_tls("default");
+  {
+    auto handle = at::addThreadLocalCallback(
+        at::RecordFunctionCallback([](const at::RecordFunction&) {}));
+    benchmark_tls("with a callback");
+    at::removeCallback(handle);
+  }
+
   return 0;
 }
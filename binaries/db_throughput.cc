@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <thread>
 #include <vector>
@@ -32,6 +33,15 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_int(
+    batch_size,
+    1,
+    "The number of items each reading thread reads at once from the reader.");
+C10_DEFINE_bool(
+    use_sharded_cursors,
+    false,
+    "If true, each reading thread iterates its own cursor over a disjoint "
+    "shard of the db instead of sharing a reader.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
@@ -64,10 +74,20 @@ void TestThroughputWithDB() {
 
 void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
   string key, value;
+  std::vector<string> keys, values;
   for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
     caffe2::Timer timer;
-    for (int i = 0; i < FLAGS_report_interval; ++i) {
-      reader->Read(&key, &value);
+    if (FLAGS_batch_size > 1) {
+      for (int i = 0; i < FLAGS_report_interval; i += FLAGS_batch_size) {
+        reader->Read(
+            std::min(FLAGS_batch_size, FLAGS_report_interval - i),
+            &keys,
+            &values);
+      }
+    } else {
+      for (int i = 0; i < FLAGS_report_interval; ++i) {
+        reader->Read(&key, &value);
+      }
     }
     double elapsed_seconds = timer.Seconds();
     printf(
@@ -93,9 +113,63 @@ void TestThroughputWithReader() {
   }
 }
 
+// Moves the cursor to the first item of the shard
+void SeekToShard(Cursor* cursor, int shard_id) {
+  cursor->SeekToFirst();
+  for (int s = 0; s < shard_id; ++s) {
+    cursor->Next();
+    CAFFE_ENFORCE(cursor->Valid(), "Db has fewer items than threads");
+  }
+}
+
+void TestThroughputWithShardedCursorWorker(DB* db, int thread_id) {
+  std::unique_ptr<Cursor> cursor(db->NewCursor());
+  SeekToShard(cursor.get(), thread_id);
+  for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
+    caffe2::Timer timer;
+    for (int i = 0; i < FLAGS_report_interval; ++i) {
+      string key = cursor->key();
+      string value = cursor->value();
+      // Skips the items of the other shards
+      for (int s = 0; s < FLAGS_num_read_threads; ++s) {
+        cursor->Next();
+        if (!cursor->Valid()) {
+          SeekToShard(cursor.get(), thread_id);
+          break;
+        }
+      }
+    }
+    double elapsed_seconds = timer.Seconds();
+    printf(
+        "Thread %03d iteration %03d, took %4.5f seconds, "
+        "throughput %f items/sec.\n",
+        thread_id,
+        iter_id,
+        elapsed_seconds,
+        FLAGS_report_interval / elapsed_seconds);
+  }
+}
+
+void TestThroughputWithShardedCursors() {
+  // The threads share the db, as e.g. leveldb can't be opened twice
+  std::unique_ptr<DB> in_db(caffe2::db::CreateDB(
+      FLAGS_input_db_type, FLAGS_input_db, caffe2::db::READ));
+  std::vector<std::unique_ptr<std::thread>> reading_threads(
+      FLAGS_num_read_threads);
+  for (int i = 0; i < reading_threads.size(); ++i) {
+    reading_threads[i].reset(new std::thread(
+        TestThroughputWithShardedCursorWorker, in_db.get(), i));
+  }
+  for (int i = 0; i < reading_threads.size(); ++i) {
+    reading_threads[i]->join();
+  }
+}
+
 int main(int argc, char** argv) {
   caffe2::GlobalInit(&argc, &argv);
-  if (FLAGS_use_reader) {
+  if (FLAGS_use_sharded_cursors) {
+    TestThroughputWithShardedCursors();
+  } else if (FLAGS_use_reader) {
     TestThroughputWithReader();
   } else {
     TestThroughputWithDB();
@@ -0,0 +1,287 @@
+// Measures the layers of an eager mode op call, so that regressions of the
+// per-op overhead show up in isolation:
+//
+//   * a direct call of the kernel, as the baseline;
+//   * DispatchKeyExtractor, computing the dispatch key from the arguments;
+//   * callWithDispatchKey, i.e. OperatorEntry::lookup and the unboxed kernel
+//     call without key extraction;
+//   * Dispatcher::call, for a few common signatures, and with the operator
+//     looked up by name on every call or cached by TORCH_OPERATOR_HANDLE;
+//   * one redispatch from Autograd to CPU, and a boxed call;
+//   * at::add through the VariableType (Autograd) kernel, without it, and
+//     with the Tracer key hop on top.
+//
+// When built with USE_DISPATCH_STATS=1, every benchmark also reports the
+// number of kernels the dispatcher invoked per iteration, overall and per
+// dispatch key.
+
+#include <ATen/ATen.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <c10/core/impl/LocalDispatchKeySet.h>
+#include <torch/library.h>
+
+#include "benchmark/benchmark.h"
+
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+namespace {
+
+NOINLINE at::Tensor unary_kernel(const at::Tensor& self) {
+  return self;
+}
+
+NOINLINE at::Tensor binary_kernel(const at::Tensor& self, const at::Tensor& other) {
+  return self;
+}
+
+NOINLINE at::Tensor scalar_kernel(const at::Tensor& self, const at::Tensor& other, c10::Scalar alpha) {
+  return self;
+}
+
+NOINLINE at::Tensor list_kernel(at::TensorList tensors) {
+  return tensors[0];
+}
+
+const c10::TypedOperatorHandle<at::Tensor(const at::Tensor&)>& redispatch_op() {
+  return TORCH_TYPED_OPERATOR_HANDLE(
+      "_dispatch_bench::redispatch", "", at::Tensor(const at::Tensor&));
+}
+
+at::Tensor redispatch_autograd_kernel(const at::Tensor& self) {
+  return c10::Dispatcher::singleton().redispatch<at::Tensor, const at::Tensor&>(
+      redispatch_op(), c10::DispatchKey::Autograd, self);
+}
+
+template <class FuncType>
+c10::TypedOperatorHandle<FuncType> find_op(const char* name) {
+  return c10::Dispatcher::singleton().findSchemaOrThrow(name, "").typed<FuncType>();
+}
+
+// Reports the dispatcher invocations per iteration. Only meaningful in builds
+// with USE_DISPATCH_STATS; the counters are skipped otherwise.
+class DispatchCounts {
+ public:
+  DispatchCounts() {
+    c10::impl::resetDispatchCounts();
+  }
+
+  void report(benchmark::State& state) const {
+    if (!c10::impl::dispatchStatsEnabled()) {
+      return;
+    }
+    uint64_t total = 0;
+    for (uint8_t k = 0; k < static_cast<uint8_t>(c10::DispatchKey::NumDispatchKeys); k++) {
+      const auto key = static_cast<c10::DispatchKey>(k);
+      const auto count = c10::impl::getDispatchCount(key);
+      if (count > 0) {
+        state.counters[c10::toString(key)] =
+            benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+        total += count;
+      }
+    }
+    state.counters["dispatches"] =
+        benchmark::Counter(total, benchmark::Counter::kAvgIterations);
+  }
+};
+
+} // namespace
+
+TORCH_LIBRARY(_dispatch_bench, m) {
+  m.def("unary(Tensor self) -> Tensor");
+  m.def("binary(Tensor self, Tensor other) -> Tensor");
+  m.def("scalar(Tensor self, Tensor other, Scalar alpha) -> Tensor");
+  m.def("list(Tensor[] tensors) -> Tensor");
+  m.def("redispatch(Tensor self) -> Tensor");
+}
+
+TORCH_LIBRARY_IMPL(_dispatch_bench, CPU, m) {
+  m.impl("unary", unary_kernel);
+  m.impl("binary", binary_kernel);
+  m.impl("scalar", scalar_kernel);
+  m.impl("list", list_kernel);
+  m.impl("redispatch", unary_kernel);
+}
+
+TORCH_LIBRARY_IMPL(_dispatch_bench, Autograd, m) {
+  m.impl("redispatch", redispatch_autograd_kernel);
+}
+
+static void BM_DirectCall(benchmark::State& state) {
+  auto t = at::ones({1});
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(unary_kernel(t));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_DirectCall);
+
+static void BM_DispatchKeyExtractor(benchmark::State& state) {
+  auto op = find_op<at::Tensor(const at::Tensor&)>("_dispatch_bench::unary");
+  auto extractor = c10::DispatchKeyExtractor::make(op.schema());
+  auto t = at::ones({1});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        extractor.getDispatchKeyUnboxed<const at::Tensor&>(c10::DispatchKeySet::FULL, t));
+  }
+}
+BENCHMARK(BM_DispatchKeyExtractor);
+
+static void BM_DispatchKeyExtractorTensorList(benchmark::State& state) {
+  auto op = find_op<at::Tensor(at::TensorList)>("_dispatch_bench::list");
+  auto extractor = c10::DispatchKeyExtractor::make(op.schema());
+  std::vector<at::Tensor> tensors(state.range(0), at::ones({1}));
+  at::TensorList list(tensors);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        extractor.getDispatchKeyUnboxed<at::TensorList>(c10::DispatchKeySet::FULL, list));
+  }
+}
+BENCHMARK(BM_DispatchKeyExtractorTensorList)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_CallWithDispatchKey(benchmark::State& state) {
+  auto op = find_op<at::Tensor(const at::Tensor&)>("_dispatch_bench::unary");
+  auto t = at::ones({1});
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.callWithDispatchKey(c10::DispatchKey::CPU, t));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_CallWithDispatchKey);
+
+static void BM_FindSchemaAndCall(benchmark::State& state) {
+  auto t = at::ones({1});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        find_op<at::Tensor(const at::Tensor&)>("_dispatch_bench::unary").call(t));
+  }
+}
+BENCHMARK(BM_FindSchemaAndCall);
+
+static void BM_CachedHandleCall(benchmark::State& state) {
+  auto t = at::ones({1});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        TORCH_TYPED_OPERATOR_HANDLE(
+            "_dispatch_bench::unary", "", at::Tensor(const at::Tensor&))
+            .call(t));
+  }
+}
+BENCHMARK(BM_CachedHandleCall);
+
+static void BM_DispatcherCallUnary(benchmark::State& state) {
+  auto op = find_op<at::Tensor(const at::Tensor&)>("_dispatch_bench::unary");
+  auto t = at::ones({1});
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(t));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_DispatcherCallUnary);
+
+static void BM_DispatcherCallBinary(benchmark::State& state) {
+  auto op = find_op<at::Tensor(const at::Tensor&, const at::Tensor&)>("_dispatch_bench::binary");
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(a, b));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_DispatcherCallBinary);
+
+static void BM_DispatcherCallScalar(benchmark::State& state) {
+  auto op = find_op<at::Tensor(const at::Tensor&, const at::Tensor&, c10::Scalar)>(
+      "_dispatch_bench::scalar");
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(a, b, 1));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_DispatcherCallScalar);
+
+static void BM_DispatcherCallTensorList(benchmark::State& state) {
+  auto op = find_op<at::Tensor(at::TensorList)>("_dispatch_bench::list");
+  std::vector<at::Tensor> tensors(state.range(0), at::ones({1}));
+  at::TensorList list(tensors);
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(list));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_DispatcherCallTensorList)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_DispatcherRedispatch(benchmark::State& state) {
+  auto op = redispatch_op();
+  auto t = at::ones({1});
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op.call(t));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_DispatcherRedispatch);
+
+static void BM_DispatcherCallBoxed(benchmark::State& state) {
+  auto op = c10::Dispatcher::singleton().findSchemaOrThrow("_dispatch_bench::unary", "");
+  auto t = at::ones({1});
+  torch::jit::Stack stack;
+  DispatchCounts counts;
+  for (auto _ : state) {
+    stack.clear();
+    stack.emplace_back(t);
+    op.callBoxed(&stack);
+    benchmark::DoNotOptimize(stack);
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_DispatcherCallBoxed);
+
+static void BM_AtenAdd(benchmark::State& state) {
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_AtenAdd);
+
+static void BM_AtenAddNonVariable(benchmark::State& state) {
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  at::AutoNonVariableTypeMode non_var_guard(true);
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_AtenAddNonVariable);
+
+static void BM_AtenAddTracer(benchmark::State& state) {
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  // Without a tracing state, the Tracer kernels only redispatch.
+  c10::impl::IncludeDispatchKeyGuard tracer_guard(c10::DispatchKey::Tracer);
+  DispatchCounts counts;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  counts.report(state);
+}
+BENCHMARK(BM_AtenAddTracer);
+
+BENCHMARK_MAIN();
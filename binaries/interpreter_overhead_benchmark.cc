@@ -0,0 +1,112 @@
+// Measures the per-op overhead of the TorchScript interpreter on tiny
+// tensors, where it dominates the runtime of the ops themselves:
+//
+//   * a straight-line graph of elementwise ops run by InterpreterState;
+//   * the same with a list argument built by prim::ListConstruct;
+//   * a boxed call of aten::cat with a tensor list on the stack.
+//
+// When built with USE_REFCOUNT_STATS=1, every benchmark also reports the
+// number of atomic refcount updates per iteration and per op.
+
+#include <ATen/ATen.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <c10/util/intrusive_ptr.h>
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/runtime/interpreter.h>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+const char* kElementwiseGraph = R"IR(
+graph(%a : Tensor, %b : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %c : Tensor = aten::add(%a, %b, %one)
+  %d : Tensor = aten::mul(%c, %b)
+  %e : Tensor = aten::sub(%d, %a, %one)
+  %f : Tensor = aten::mul(%e, %c)
+  return (%f)
+)IR";
+constexpr int kElementwiseOps = 4;
+
+const char* kListGraph = R"IR(
+graph(%a : Tensor, %b : Tensor):
+  %zero : int = prim::Constant[value=0]()
+  %l : Tensor[] = prim::ListConstruct(%a, %b, %a, %b)
+  %c : Tensor = aten::cat(%l, %zero)
+  return (%c)
+)IR";
+constexpr int kListOps = 2;
+
+std::shared_ptr<torch::jit::Graph> parse(const char* ir) {
+  auto graph = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(ir, graph.get());
+  return graph;
+}
+
+// Reports the refcount updates per iteration and per op. Only meaningful in
+// builds with USE_REFCOUNT_STATS; the counters are skipped otherwise.
+class RefcountUpdates {
+ public:
+  RefcountUpdates() {
+    c10::resetRefcountUpdates();
+  }
+
+  void report(benchmark::State& state, int num_ops) const {
+    if (!c10::refcountStatsEnabled()) {
+      return;
+    }
+    const auto count = c10::getRefcountUpdates();
+    state.counters["refcount_updates"] =
+        benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+    state.counters["refcount_updates_per_op"] = benchmark::Counter(
+        static_cast<double>(count) / num_ops,
+        benchmark::Counter::kAvgIterations);
+  }
+};
+
+void runGraph(benchmark::State& state, const char* ir, int num_ops) {
+  torch::jit::Code code(parse(ir), "bench");
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  torch::jit::Stack stack;
+  RefcountUpdates updates;
+  for (auto _ : state) {
+    stack.clear();
+    stack.emplace_back(a);
+    stack.emplace_back(b);
+    torch::jit::InterpreterState(code).run(stack);
+    benchmark::DoNotOptimize(stack);
+  }
+  updates.report(state, num_ops);
+}
+
+} // namespace
+
+static void BM_InterpreterElementwise(benchmark::State& state) {
+  runGraph(state, kElementwiseGraph, kElementwiseOps);
+}
+BENCHMARK(BM_InterpreterElementwise);
+
+static void BM_InterpreterTensorList(benchmark::State& state) {
+  runGraph(state, kListGraph, kListOps);
+}
+BENCHMARK(BM_InterpreterTensorList);
+
+static void BM_BoxedCallTensorList(benchmark::State& state) {
+  auto op = c10::Dispatcher::singleton().findSchemaOrThrow("aten::cat", "");
+  std::vector<at::Tensor> tensors(state.range(0), at::ones({1}));
+  torch::jit::Stack stack;
+  RefcountUpdates updates;
+  for (auto _ : state) {
+    stack.clear();
+    stack.emplace_back(c10::List<at::Tensor>(tensors));
+    stack.emplace_back(0);
+    op.callBoxed(&stack);
+    benchmark::DoNotOptimize(stack);
+  }
+  updates.report(state, 1);
+}
+BENCHMARK(BM_BoxedCallTensorList)->Arg(2)->Arg(16);
+
+BENCHMARK_MAIN();
@@ -21,6 +21,9 @@ C10_DEFINE_int(benchmark_iter, 10, "Number of times to run benchmark")
 C10_DEFINE_bool(extra_stats, false,
     "Collect extra stats; warning: skews results");
 C10_DEFINE_string(task_type, "add", "Tensor operation: add or mm");
+C10_DEFINE_bool(nested_parallelism, false,
+    "Let tensor operations inside the benchmark's parallel_for use the "
+    "intra-op pool too (use a large tensor_dim to see the effect)");
 
 namespace {
 std::atomic<int> counter{0};
@@ -117,6 +120,7 @@ int main(int argc, char** argv) {
   if (FLAGS_intra_op_threads > 0) {
     at::set_num_threads(FLAGS_intra_op_threads);
   }
+  at::set_nested_parallelism(FLAGS_nested_parallelism);
 
   TORCH_CHECK(FLAGS_task_type == "add" || FLAGS_task_type == "mm");
   run_mm = FLAGS_task_type == "mm";
@@ -142,7 +146,9 @@ int main(int argc, char** argv) {
             << at::get_num_interop_threads() << " inter-op threads and "
             << at::get_num_threads() << " intra-op threads, "
             << "tensor dim: " << FLAGS_tensor_dim
-            << ", task type: " << FLAGS_task_type << std::endl;
+            << ", task type: " << FLAGS_task_type
+            << ", nested parallelism: "
+            << (at::get_nested_parallelism() ? "on" : "off") << std::endl;
 
   std::vector<float> runtimes;
   for (auto bench_iter = 0; bench_iter < FLAGS_benchmark_iter; ++bench_iter) {
@@ -0,0 +1,354 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runs the operator benchmarks of benchmarks/operator_benchmark from C++,
+// calling the operators through the dispatcher, without the Python and
+// binding overhead of the Python runner. The tests are exported by the Python
+// runner, with the same filters:
+//
+//   python -m benchmark_all_test --export_cpp_dir=<dir> --tag_filter=short
+//   ./operator_benchmark_torch --config_dir=<dir> --threads=1,2,4
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+#include "ATen/core/dispatch/Dispatcher.h"
+#include "caffe2/core/timer.h"
+#include "caffe2/utils/string_utils.h"
+#include "torch/csrc/autograd/grad_mode.h"
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/inliner.h"
+#include "torch/csrc/jit/serialization/import.h"
+#include "torch/script.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+C10_DEFINE_string(
+    config_dir,
+    "",
+    "The directory the operator_benchmark runner exported the tests to "
+    "with --export_cpp_dir.");
+C10_DEFINE_string(
+    test_name,
+    "",
+    "Only run the tests whose name contains this string.");
+C10_DEFINE_string(
+    threads,
+    "1",
+    "Comma separated numbers of intra-op threads to run every test with.");
+C10_DEFINE_int(warmup, 100, "The number of iterations to warm up.");
+C10_DEFINE_int(
+    iter,
+    0,
+    "The number of iterations to time, or 0 to double them from 100 until "
+    "they run for --min_time_per_test.");
+C10_DEFINE_double(
+    min_time_per_test,
+    1.0,
+    "The minimum time (seconds) the timed iterations run for.");
+C10_DEFINE_bool(
+    perf_counters,
+    false,
+    "Whether to count the cycles, instructions and cache misses of the timed "
+    "iterations (Linux). The calling thread is counted, along with the "
+    "intra-op threads it starts while counting.");
+
+namespace {
+
+std::vector<std::string>
+split(char separator, const std::string& string, bool ignore_empty = true) {
+  std::vector<std::string> pieces;
+  std::stringstream ss(string);
+  std::string item;
+  while (getline(ss, item, separator)) {
+    if (!ignore_empty || !item.empty()) {
+      pieces.push_back(std::move(item));
+    }
+  }
+  return pieces;
+}
+
+// The traced forward of a test, flattened into the calls of its operators on
+// registers holding the constants, inputs and intermediate values. The
+// operators with a schema are called through the dispatcher.
+class OperatorProgram {
+ public:
+  explicit OperatorProgram(const torch::jit::Module& module) {
+    auto graph = module.get_method("forward").graph()->copy();
+    torch::jit::Inline(*graph);
+
+    std::unordered_map<const torch::jit::Value*, size_t> value_registers;
+    auto add_register = [&](const torch::jit::Value* value, c10::IValue iv) {
+      value_registers[value] = registers_.size();
+      registers_.push_back(std::move(iv));
+      return registers_.size() - 1;
+    };
+    CAFFE_ENFORCE_EQ(graph->inputs().size(), 2);
+    add_register(graph->inputs()[0], module._ivalue());
+    // The place holder the forward was traced with
+    add_register(graph->inputs()[1], at::ones({1}));
+
+    for (const auto node : graph->nodes()) {
+      CAFFE_ENFORCE(
+          node->blocks().empty(),
+          "Unsupported control flow node ",
+          node->kind().toQualString());
+      if (node->kind() == c10::prim::Constant) {
+        add_register(node->output(), *torch::jit::toIValue(node->output()));
+        continue;
+      }
+      if (node->kind() == c10::prim::GetAttr) {
+        const auto& object = registers_[value_registers.at(node->input())];
+        add_register(
+            node->output(),
+            object.toObject()->getAttr(node->s(c10::attr::name)));
+        continue;
+      }
+
+      Step step;
+      for (const auto input : node->inputs()) {
+        step.inputs.push_back(value_registers.at(input));
+      }
+      for (const auto output : node->outputs()) {
+        step.outputs.push_back(add_register(output, c10::IValue()));
+      }
+      if (const auto schema = node->maybeSchema()) {
+        step.op = c10::Dispatcher::singleton().findSchema(
+            {schema->name(), schema->overload_name()});
+      }
+      if (!step.op) {
+        step.operation = node->getOperation();
+      }
+      steps_.push_back(std::move(step));
+    }
+  }
+
+  void run() {
+    for (const auto& step : steps_) {
+      stack_.clear();
+      for (const auto input : step.inputs) {
+        stack_.push_back(registers_[input]);
+      }
+      if (step.op) {
+        step.op->callBoxed(&stack_);
+      } else {
+        step.operation(&stack_);
+      }
+      for (size_t i = 0; i < step.outputs.size(); ++i) {
+        registers_[step.outputs[i]] = std::move(stack_[i]);
+      }
+    }
+  }
+
+ private:
+  struct Step {
+    c10::optional<c10::OperatorHandle> op;
+    // For the operators the dispatcher doesn't know about
+    torch::jit::Operation operation;
+    std::vector<size_t> inputs;
+    std::vector<size_t> outputs;
+  };
+
+  std::vector<c10::IValue> registers_;
+  std::vector<Step> steps_;
+  torch::jit::Stack stack_;
+};
+
+#ifdef __linux__
+// Hardware counters of the current thread and the threads it starts
+class PerfCounters {
+ public:
+  enum Counter { CYCLES = 0, INSTRUCTIONS, CACHE_REFERENCES, CACHE_MISSES };
+
+  PerfCounters() {
+    for (const auto config :
+         {PERF_COUNT_HW_CPU_CYCLES,
+          PERF_COUNT_HW_INSTRUCTIONS,
+          PERF_COUNT_HW_CACHE_REFERENCES,
+          PERF_COUNT_HW_CACHE_MISSES}) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = config;
+      attr.disabled = 1;
+      attr.inherit = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      const int fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fd < 0) {
+        LOG(WARNING) << "Can't open the perf counters: " << strerror(errno);
+        close_all();
+        return;
+      }
+      fds_.push_back(fd);
+    }
+  }
+
+  ~PerfCounters() {
+    close_all();
+  }
+
+  bool available() const {
+    return !fds_.empty();
+  }
+
+  void start() {
+    for (const auto fd : fds_) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  std::vector<uint64_t> stop() {
+    std::vector<uint64_t> values;
+    for (const auto fd : fds_) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      uint64_t value = 0;
+      CAFFE_ENFORCE_EQ(read(fd, &value, sizeof(value)), sizeof(value));
+      values.push_back(value);
+    }
+    return values;
+  }
+
+ private:
+  void close_all() {
+    for (const auto fd : fds_) {
+      close(fd);
+    }
+    fds_.clear();
+  }
+
+  std::vector<int> fds_;
+};
+#endif
+
+float time_iterations(OperatorProgram& program, int64_t iters) {
+  caffe2::Timer timer;
+  for (int64_t i = 0; i < iters; ++i) {
+    program.run();
+  }
+  return timer.Seconds();
+}
+
+void run_test(
+    const std::string& test_name,
+    const std::string& input_config,
+    OperatorProgram& program,
+    const std::vector<int>& threads) {
+  for (const auto num_threads : threads) {
+    at::set_num_threads(num_threads);
+    time_iterations(program, FLAGS_warmup);
+
+    int64_t iters = FLAGS_iter;
+    if (iters == 0) {
+      iters = 100;
+      while (time_iterations(program, iters) < FLAGS_min_time_per_test) {
+        iters *= 2;
+      }
+    }
+
+#ifdef __linux__
+    std::unique_ptr<PerfCounters> counters;
+    if (FLAGS_perf_counters) {
+      counters = std::make_unique<PerfCounters>();
+      counters->start();
+    }
+#endif
+    const auto seconds = time_iterations(program, iters);
+
+    std::cout << "# Name: " << test_name << std::endl
+              << "# Input: " << input_config << std::endl
+              << "# Threads: " << num_threads << std::endl;
+    printf("Forward Execution Time (us) : %.3f\n", 1e6 * seconds / iters);
+#ifdef __linux__
+    if (counters && counters->available()) {
+      const auto values = counters->stop();
+      const double cycles = values[PerfCounters::CYCLES];
+      const double references = values[PerfCounters::CACHE_REFERENCES];
+      const double misses = values[PerfCounters::CACHE_MISSES];
+      printf(
+          "Cycles per iteration : %.0f\n"
+          "IPC : %.3f\n"
+          "Cache misses per iteration : %.1f\n"
+          "Cache miss rate : %.2f%%\n",
+          cycles / iters,
+          cycles > 0 ? values[PerfCounters::INSTRUCTIONS] / cycles : 0.0,
+          misses / iters,
+          references > 0 ? 100.0 * misses / references : 0.0);
+    }
+#endif
+    std::cout << std::endl;
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  c10::SetUsageMessage(
+      "Run the operator benchmarks exported by benchmarks/operator_benchmark.\n"
+      "Example usage:\n"
+      "./operator_benchmark_torch"
+      " --config_dir=<export_cpp_dir>"
+      " --threads=1,4"
+      " --perf_counters");
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags!" << std::endl;
+    return 1;
+  }
+  CAFFE_ENFORCE(!FLAGS_config_dir.empty(), "--config_dir must be specified.");
+  CAFFE_ENFORCE_GE(FLAGS_warmup, 0, "--warmup must be non negative.");
+  CAFFE_ENFORCE_GE(FLAGS_iter, 0, "--iter must be non negative.");
+
+  std::vector<int> threads;
+  for (const auto& num_threads : split(',', FLAGS_threads)) {
+    threads.push_back(c10::stoi(num_threads));
+    CAFFE_ENFORCE_GT(threads.back(), 0, "Thread counts must be positive.");
+  }
+
+  torch::autograd::AutoGradMode guard(false);
+  std::ifstream configs(FLAGS_config_dir + "/configs.txt");
+  CAFFE_ENFORCE(configs, "Can't read ", FLAGS_config_dir, "/configs.txt");
+  std::string line;
+  while (std::getline(configs, line)) {
+    // test name, file, input config
+    const auto fields = split('\t', line, /*ignore_empty=*/false);
+    CAFFE_ENFORCE_EQ(fields.size(), 3, "Malformed test config: ", line);
+    if (fields[0].find(FLAGS_test_name) == std::string::npos) {
+      continue;
+    }
+    auto module = torch::jit::load(FLAGS_config_dir + "/" + fields[1]);
+    module.eval();
+    OperatorProgram program(module);
+    run_test(fields[0], fields[2], program, threads);
+  }
+  return 0;
+}
@@ -20,6 +20,8 @@ const int kSmallTensorSize = 1;
 const float kSampingProb = 0.1;
 
 const float kLowSamplingProb = 0.0001;
+// Overhead target for an always on, sampled observer
+const float kTargetOverheadPct = 1.0;
 }
 
 void setupBenchmarkCallbacks() {
@@ -102,6 +104,39 @@ int main(int argc, char** argv) {
             << ", expected number: ~" << (int)(FLAGS_rec_fn_iter * kLowSamplingProb)
             << " invocations" << std::endl;
 
+  at::clearCallbacks();
+
+  // Overhead of an always on observer, sampled with a low probability, over
+  // running the same ops with RecordFunction disabled
+  at::enableRecordFunction(false);
+  runBench(kSmallTensorSize, FLAGS_warmup_iter);
+  auto baseline = runBench(kSmallTensorSize, FLAGS_iter);
+
+  at::enableRecordFunction(true);
+  cb_count = 0;
+  at::addGlobalCallback(at::RecordFunctionCallback(
+      [&](const at::RecordFunction& fn) {
+        ++cb_count;
+      },
+      [](const at::RecordFunction&) {})
+    .needsInputs(true)
+    .samplingProb(kLowSamplingProb)
+  );
+  bool pre_sampled = false;
+  at::shouldRunRecordFunction(&pre_sampled);
+  runBench(kSmallTensorSize, FLAGS_warmup_iter);
+  duration = runBench(kSmallTensorSize, FLAGS_iter);
+  auto overhead_pct = (duration - baseline) / baseline * 100;
+  std::cout << "Sampled observer overhead ("
+            << kSmallTensorSize
+            << "x"
+            << kSmallTensorSize
+            << ", sampling prob. " << kLowSamplingProb
+            << (pre_sampled ? ", pre-sampled" : "")
+            << "): " << overhead_pct << "%, target: < "
+            << kTargetOverheadPct << "%, number of callback invocations: "
+            << cb_count << std::endl;
+
   at::clearCallbacks();
   return 0;
 }
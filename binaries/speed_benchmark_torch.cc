@@ -14,10 +14,18 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "ATen/ATen.h"
+#include "ATen/record_function.h"
+#include "c10/core/Allocator.h"
+#include "c10/util/ThreadLocalDebugInfo.h"
 #include "caffe2/core/timer.h"
 #include "caffe2/utils/string_utils.h"
 #include "torch/csrc/autograd/grad_mode.h"
@@ -61,6 +69,23 @@ C10_DEFINE_bool(
   false,
   "Whether to print performance stats for AI-PEP.");
 
+C10_DEFINE_bool(
+  report_op_time,
+  false,
+  "Whether to report the time of every op in additional profiled runs, "
+  "recorded through RecordFunction.");
+C10_DEFINE_bool(
+  report_memory,
+  false,
+  "Whether to report the peak and average CPU memory allocated by the "
+  "model in additional profiled runs (not supported by the mobile CPU "
+  "allocator).");
+C10_DEFINE_bool(
+  report_cold_start,
+  false,
+  "Whether to report the time to read the model file, to deserialize it "
+  "and to run it for the first time.");
+
 C10_DEFINE_int(pytext_len, 0, "Length of input sequence.");
 C10_DEFINE_bool(vulkan, false, "Whether to use Vulkan backend (GPU).");
 
@@ -77,6 +102,140 @@ split(char separator, const std::string& string, bool ignore_empty = true) {
   return pieces;
 }
 
+// Prints a metric, as a PyTorchObserver record for AI-PEP with --report_pep
+void report_metric(
+    const std::string& type,
+    const std::string& metric,
+    const std::string& unit,
+    double value) {
+  if (FLAGS_report_pep) {
+    std::cout << "PyTorchObserver {\"type\": \"" << type
+              << "\", \"unit\": \"" << unit << "\", \"metric\": \""
+              << metric << "\", \"value\": \"" << value << "\"}"
+              << std::endl;
+  } else {
+    std::cout << type << " " << metric << ": " << value << " " << unit
+              << std::endl;
+  }
+}
+
+// Accumulates the time spent in every op, including the ops it calls
+class OpTimer {
+ public:
+  OpTimer() {
+    handle_ = at::addThreadLocalCallback(
+        at::RecordFunctionCallback(
+            [](const at::RecordFunction&) {
+              start_times().push_back(high_resolution_clock::now());
+            },
+            [this](const at::RecordFunction& fn) {
+              auto& starts = start_times();
+              if (starts.empty()) {
+                return;
+              }
+              const auto duration = duration_cast<microseconds>(
+                  high_resolution_clock::now() - starts.back());
+              starts.pop_back();
+              std::lock_guard<std::mutex> guard(mutex_);
+              auto& stats = stats_[fn.name().str()];
+              ++stats.calls;
+              stats.total_us += duration.count();
+            })
+            .scopes({at::RecordScope::FUNCTION}));
+  }
+
+  ~OpTimer() {
+    at::removeCallback(handle_);
+  }
+
+  // Prints the time and number of calls per iteration of every op, the
+  // most expensive first
+  void report(int iterations) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::vector<std::pair<std::string, Stats>> stats(
+        stats_.begin(), stats_.end());
+    std::sort(
+        stats.begin(),
+        stats.end(),
+        [](const std::pair<std::string, Stats>& a,
+           const std::pair<std::string, Stats>& b) {
+          return a.second.total_us > b.second.total_us;
+        });
+    for (const auto& op : stats) {
+      report_metric(
+          op.first, "latency", "us", op.second.total_us / iterations);
+      report_metric(
+          op.first, "calls", "count", op.second.calls / iterations);
+    }
+  }
+
+ private:
+  struct Stats {
+    double calls = 0;
+    double total_us = 0;
+  };
+
+  static std::vector<high_resolution_clock::time_point>& start_times() {
+    thread_local std::vector<high_resolution_clock::time_point> starts;
+    return starts;
+  }
+
+  at::CallbackHandle handle_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, Stats> stats_;
+};
+
+// Tracks the CPU memory allocated while it is installed as profiler state,
+// see c10::reportMemoryUsageToProfiler
+class MemoryTracker : public c10::MemoryReportingInfoBase {
+ public:
+  MemoryTracker() : last_report_(high_resolution_clock::now()) {
+    start_ = last_report_;
+  }
+
+  void reportMemoryUsage(void* /* ptr */, int64_t alloc_size, c10::Device)
+      override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    accumulate();
+    allocated_ += alloc_size;
+    peak_ = std::max(peak_, allocated_);
+  }
+
+  bool memoryProfilingEnabled() const override {
+    return true;
+  }
+
+  // Prints the peak and the time-weighted average of the memory allocated
+  // since the tracker was created
+  void report() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    accumulate();
+    const double total_us =
+        duration_cast<microseconds>(last_report_ - start_).count();
+    report_metric("NET", "peak_memory", "bytes", peak_);
+    report_metric(
+        "NET",
+        "average_memory",
+        "bytes",
+        total_us > 0 ? weighted_sum_ / total_us : 0);
+  }
+
+ private:
+  void accumulate() {
+    const auto now = high_resolution_clock::now();
+    weighted_sum_ += static_cast<double>(allocated_) *
+        duration_cast<microseconds>(now - last_report_).count();
+    last_report_ = now;
+  }
+
+  std::mutex mutex_;
+  int64_t allocated_ = 0;
+  int64_t peak_ = 0;
+  double weighted_sum_ = 0;
+  high_resolution_clock::time_point start_;
+  high_resolution_clock::time_point last_report_;
+};
+
 std::vector<c10::IValue> create_inputs() {
   if (FLAGS_no_inputs) {
     return {};
@@ -173,7 +332,14 @@ int main(int argc, char** argv) {
 
   torch::autograd::AutoGradMode guard(false);
   torch::jit::GraphOptimizerEnabledGuard no_optimizer_guard(false);
-  auto module = torch::jit::load(FLAGS_model);
+  auto read_start = high_resolution_clock::now();
+  std::ifstream model_file(FLAGS_model, std::ios::binary);
+  CAFFE_ENFORCE(model_file, "Failed to open the model ", FLAGS_model);
+  std::stringstream model_data;
+  model_data << model_file.rdbuf();
+  auto load_start = high_resolution_clock::now();
+  auto module = torch::jit::load(model_data);
+  auto load_stop = high_resolution_clock::now();
 
   if (FLAGS_use_bundled_input >= 0) {
     auto get_method = module.find_method("get_all_bundled_inputs");
@@ -194,6 +360,27 @@ int main(int argc, char** argv) {
   }
 
   module.eval();
+  if (FLAGS_report_cold_start) {
+    auto first_run_start = high_resolution_clock::now();
+    module.forward(inputs);
+    auto first_run_stop = high_resolution_clock::now();
+    report_metric(
+        "NET",
+        "model_read_time",
+        "us",
+        duration_cast<microseconds>(load_start - read_start).count());
+    report_metric(
+        "NET",
+        "model_load_time",
+        "us",
+        duration_cast<microseconds>(load_stop - load_start).count());
+    report_metric(
+        "NET",
+        "first_run_time",
+        "us",
+        duration_cast<microseconds>(first_run_stop - first_run_start)
+            .count());
+  }
   if (FLAGS_print_output) {
     std::cout << module.forward(inputs) << std::endl;
   }
@@ -236,5 +423,31 @@ int main(int argc, char** argv) {
             << ". Iters per second: " << 1000.0 * 1000 * FLAGS_iter / micros
             << std::endl;
 
+  // Recording ops and allocations slows the model down, so they are
+  // measured in runs of their own
+  if ((FLAGS_report_op_time || FLAGS_report_memory) && FLAGS_iter > 0) {
+    std::cout << "Profiled runs." << std::endl;
+    std::unique_ptr<OpTimer> op_timer;
+    if (FLAGS_report_op_time) {
+      op_timer = std::make_unique<OpTimer>();
+    }
+    std::shared_ptr<MemoryTracker> memory_tracker;
+    std::unique_ptr<c10::DebugInfoGuard> memory_guard;
+    if (FLAGS_report_memory) {
+      memory_tracker = std::make_shared<MemoryTracker>();
+      memory_guard = std::make_unique<c10::DebugInfoGuard>(
+          c10::DebugInfoKind::PROFILER_STATE, memory_tracker);
+    }
+    for (int i = 0; i < FLAGS_iter; ++i) {
+      module.forward(inputs);
+    }
+    if (op_timer) {
+      op_timer->report(FLAGS_iter);
+    }
+    if (memory_tracker) {
+      memory_tracker->report();
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,83 @@
+#include <torch/csrc/jit/runtime/graph_executor.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+#include <torch/torch.h>
+
+#include "c10/util/Flags.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+C10_DEFINE_int(iter, 10000, "Number of iterations");
+C10_DEFINE_int(warmup_iter, 100, "Number of warmup iterations");
+C10_DEFINE_int(num_ops, 32, "Number of ops in the benchmarked graph");
+C10_DEFINE_int(tensor_size, 1, "Size of the tensors the ops run on");
+
+namespace {
+
+// A chain of small elementwise ops, whose runtime is dominated by the
+// overhead of running each op.
+torch::jit::Module buildModule(int num_ops) {
+  std::stringstream src;
+  src << "def forward(self, x, y):\n";
+  src << "  h = x\n";
+  for (auto idx = 0; idx < num_ops; ++idx) {
+    src << (idx % 2 == 0 ? "  h = torch.add(h, y)\n"
+                         : "  h = torch.mul(h, y)\n");
+  }
+  src << "  return h\n";
+  torch::jit::Module m("m");
+  m.define(src.str());
+  m.eval();
+  return m;
+}
+
+template <typename F>
+float runBench(F&& fn, int iter) {
+  typedef std::chrono::high_resolution_clock clock;
+  typedef std::chrono::microseconds us;
+  std::chrono::time_point<clock> start_time = clock::now();
+  for (auto idx = 0; idx < iter; ++idx) {
+    fn();
+  }
+  return static_cast<float>(
+      std::chrono::duration_cast<us>(clock::now() - start_time).count());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+
+  auto module = buildModule(FLAGS_num_ops);
+  auto x = torch::randn({FLAGS_tensor_size});
+  auto y = torch::randn({FLAGS_tensor_size});
+
+  torch::jit::StaticRuntime runtime(module);
+  // The graph executor runs the same frozen, inlined graph.
+  torch::jit::GraphExecutor executor(runtime.graph(), "forward");
+
+  auto run_executor = [&]() {
+    torch::jit::Stack stack{x, y};
+    executor.run(stack);
+  };
+  auto run_static = [&]() { runtime.run(std::vector<at::Tensor>{x, y}); };
+
+  torch::NoGradGuard no_grad;
+  runBench(run_executor, FLAGS_warmup_iter);
+  runBench(run_static, FLAGS_warmup_iter);
+  auto executor_us = runBench(run_executor, FLAGS_iter);
+  auto static_us = runBench(run_static, FLAGS_iter);
+
+  auto num_ops = static_cast<float>(FLAGS_iter) * FLAGS_num_ops;
+  std::cout << "GraphExecutor: " << (executor_us / FLAGS_iter)
+            << " us per run, " << (executor_us * 1000 / num_ops)
+            << " ns per op" << std::endl;
+  std::cout << "StaticRuntime: " << (static_us / FLAGS_iter)
+            << " us per run, " << (static_us * 1000 / num_ops)
+            << " ns per op" << std::endl;
+  return 0;
+}
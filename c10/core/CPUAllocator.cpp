@@ -94,11 +94,27 @@ void free_cpu(void* data) {
 #endif
 }
 
+namespace {
+thread_local CPUAllocationCounters cpu_allocation_counters;
+} // namespace
+
+CPUAllocationCounters thread_cpu_allocation_counters() {
+  return cpu_allocation_counters;
+}
+
+void count_cpu_allocation(size_t nbytes) {
+  ++cpu_allocation_counters.num_allocations;
+  cpu_allocation_counters.allocated_bytes += nbytes;
+}
+
 struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
     void* data = alloc_cpu(nbytes);
+    if (nbytes > 0) {
+      count_cpu_allocation(nbytes);
+    }
     profiledCPUMemoryReporter().New(data, nbytes);
     return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
   }
@@ -169,6 +185,7 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
 
     auto alloc_size = PreGuardBytes + nbytes + PostGuardBytes;
     void* const data = c10::alloc_cpu(alloc_size);
+    count_cpu_allocation(nbytes);
     //  profiledCPUMemoryReporter().New(data, alloc_size);
     return {
         reinterpret_cast<uint8_t*>(data) + PreGuardBytes,
@@ -37,6 +37,19 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
+// Counts the allocations the CPU allocators make for the current thread.
+// The counters never decrease, so the difference between two reads gives
+// the allocations of the code that ran in between, e.g. of an op sampled by
+// the lite interpreter. Keeping them costs an increment per allocation.
+struct CPUAllocationCounters {
+  uint64_t num_allocations = 0;
+  uint64_t allocated_bytes = 0;
+};
+
+C10_API CPUAllocationCounters thread_cpu_allocation_counters();
+// Called by the CPU allocators for every allocation of nbytes > 0 bytes
+C10_API void count_cpu_allocation(size_t nbytes);
+
 // A simple struct that is used to report C10's memory allocation and
 // deallocation status to the profiler
 class C10_API ProfiledCPUMemoryReporter {
@@ -0,0 +1,268 @@
+#include <c10/core/CachingCPUAllocator.h>
+
+#include <c10/core/DeviceType.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace c10 {
+
+namespace {
+
+// Size classes are the powers of two from kMinCachedSize to kMaxCachedSize.
+constexpr size_t kMinCachedSize = 64;
+constexpr size_t kNumSizeClasses = 15;
+static_assert(
+    kMinCachedSize << (kNumSizeClasses - 1) == CachingCPUAllocator::kMaxCachedSize,
+    "size classes must end at kMaxCachedSize");
+
+// Size class of blocks that bypass the cache.
+constexpr uint32_t kUncached = static_cast<uint32_t>(-1);
+
+// Upper bound on the bytes a thread caches per size class.
+constexpr size_t kThreadCacheBytesPerClass = 4 << 20;
+constexpr size_t kMaxThreadCacheBlocksPerClass = 256;
+
+// Every block starts with a header recording where it goes when freed. The
+// header takes gAlignment bytes so that the user pointer remains aligned.
+struct BlockHeader {
+  uint32_t size_class;
+  int32_t numa_node;
+};
+static_assert(sizeof(BlockHeader) <= gAlignment, "header must fit in gAlignment");
+
+inline BlockHeader* header_of(void* data) {
+  return reinterpret_cast<BlockHeader*>(static_cast<char*>(data) - gAlignment);
+}
+
+inline void* data_of(BlockHeader* header) {
+  return reinterpret_cast<char*>(header) + gAlignment;
+}
+
+inline size_t class_size(uint32_t size_class) {
+  return kMinCachedSize << size_class;
+}
+
+inline uint32_t size_class_for(size_t nbytes) {
+  uint32_t size_class = 0;
+  while (class_size(size_class) < nbytes) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+inline size_t thread_cache_capacity(uint32_t size_class) {
+  return std::max<size_t>(
+      2,
+      std::min(
+          kMaxThreadCacheBlocksPerClass,
+          kThreadCacheBytesPerClass / class_size(size_class)));
+}
+
+inline int current_node() {
+  return std::max(GetCurrentNUMANode(), 0);
+}
+
+// Blocks freed back from thread caches, shared by all threads of a NUMA node.
+struct CentralCache {
+  std::mutex mutex;
+  std::array<std::vector<BlockHeader*>, kNumSizeClasses> blocks;
+  size_t cached_bytes = 0;
+};
+
+// Intentionally leaked so that thread caches flushed during process teardown
+// never touch a destroyed object.
+std::vector<std::unique_ptr<CentralCache>>& central_caches() {
+  static auto* caches = [] {
+    auto* result = new std::vector<std::unique_ptr<CentralCache>>();
+    const int num_nodes = std::max(GetNumNUMANodes(), 1);
+    for (int i = 0; i < num_nodes; ++i) {
+      result->emplace_back(new CentralCache());
+    }
+    return result;
+  }();
+  return *caches;
+}
+
+CentralCache& central_cache(int numa_node) {
+  auto& caches = central_caches();
+  return *caches[std::min<size_t>(numa_node, caches.size() - 1)];
+}
+
+void release_to_central(
+    int numa_node,
+    uint32_t size_class,
+    BlockHeader* const* blocks,
+    size_t count) {
+  auto& central = central_cache(numa_node);
+  std::lock_guard<std::mutex> guard(central.mutex);
+  auto& list = central.blocks[size_class];
+  list.insert(list.end(), blocks, blocks + count);
+  central.cached_bytes += count * class_size(size_class);
+}
+
+// Set once the calling thread's cache has been destroyed; blocks freed after
+// that point (e.g. by other thread_local destructors) go to the central cache.
+thread_local bool tls_cache_destroyed = false;
+
+struct ThreadCache {
+  ThreadCache() : numa_node(current_node()) {}
+
+  ~ThreadCache() {
+    flush();
+    tls_cache_destroyed = true;
+  }
+
+  void flush() {
+    for (uint32_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      auto& list = blocks[size_class];
+      if (!list.empty()) {
+        release_to_central(numa_node, size_class, list.data(), list.size());
+        list.clear();
+      }
+    }
+  }
+
+  BlockHeader* pop(uint32_t size_class) {
+    auto& list = blocks[size_class];
+    if (list.empty()) {
+      refill(size_class);
+      if (list.empty()) {
+        return nullptr;
+      }
+    }
+    BlockHeader* header = list.back();
+    list.pop_back();
+    return header;
+  }
+
+  void push(BlockHeader* header) {
+    auto& list = blocks[header->size_class];
+    const size_t capacity = thread_cache_capacity(header->size_class);
+    if (list.size() >= capacity) {
+      const size_t count = capacity / 2;
+      release_to_central(
+          numa_node,
+          header->size_class,
+          list.data() + list.size() - count,
+          count);
+      list.resize(list.size() - count);
+    }
+    list.push_back(header);
+  }
+
+  void refill(uint32_t size_class) {
+    auto& central = central_cache(numa_node);
+    std::lock_guard<std::mutex> guard(central.mutex);
+    auto& src = central.blocks[size_class];
+    const size_t count =
+        std::min(src.size(), thread_cache_capacity(size_class) / 2);
+    auto& dst = blocks[size_class];
+    dst.insert(dst.end(), src.end() - count, src.end());
+    src.resize(src.size() - count);
+    central.cached_bytes -= count * class_size(size_class);
+  }
+
+  const int numa_node;
+  std::array<std::vector<BlockHeader*>, kNumSizeClasses> blocks;
+};
+
+ThreadCache& thread_cache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+BlockHeader* alloc_block(uint32_t size_class, size_t nbytes) {
+  auto* header = static_cast<BlockHeader*>(alloc_cpu(gAlignment + nbytes));
+  header->size_class = size_class;
+  header->numa_node = current_node();
+  return header;
+}
+
+void delete_block(void* data) {
+  if (!data) {
+    return;
+  }
+  profiledCPUMemoryReporter().Delete(data);
+  BlockHeader* header = header_of(data);
+  if (header->size_class == kUncached) {
+    free_cpu(header);
+  } else if (
+      tls_cache_destroyed || header->numa_node != thread_cache().numa_node) {
+    release_to_central(header->numa_node, header->size_class, &header, 1);
+  } else {
+    thread_cache().push(header);
+  }
+}
+
+} // namespace
+
+at::DataPtr CachingCPUAllocator::allocate(size_t nbytes) const {
+  if (nbytes == 0) {
+    return {nullptr, nullptr, &delete_block, at::Device(at::DeviceType::CPU)};
+  }
+
+  BlockHeader* header = nullptr;
+  if (nbytes > kMaxCachedSize) {
+    header = alloc_block(kUncached, nbytes);
+  } else {
+    const uint32_t size_class = size_class_for(nbytes);
+    if (!tls_cache_destroyed) {
+      header = thread_cache().pop(size_class);
+    }
+    if (header) {
+      // alloc_cpu only fills fresh memory; do the same for recycled blocks.
+      if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+        memset(data_of(header), 0, nbytes);
+      } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+        memset_junk(data_of(header), nbytes);
+      }
+    } else {
+      header = alloc_block(size_class, class_size(size_class));
+    }
+  }
+
+  void* data = data_of(header);
+  count_cpu_allocation(nbytes);
+  profiledCPUMemoryReporter().New(data, nbytes);
+  return {data, data, &delete_block, at::Device(at::DeviceType::CPU)};
+}
+
+at::DeleterFnPtr CachingCPUAllocator::raw_deleter() const {
+  return &delete_block;
+}
+
+void CachingCPUAllocator::emptyCache() {
+  if (!tls_cache_destroyed) {
+    thread_cache().flush();
+  }
+  for (auto& central : central_caches()) {
+    std::lock_guard<std::mutex> guard(central->mutex);
+    for (auto& list : central->blocks) {
+      for (BlockHeader* header : list) {
+        free_cpu(header);
+      }
+      list.clear();
+    }
+    central->cached_bytes = 0;
+  }
+}
+
+size_t CachingCPUAllocator::cachedBytes() const {
+  size_t total = 0;
+  for (auto& central : central_caches()) {
+    std::lock_guard<std::mutex> guard(central->mutex);
+    total += central->cached_bytes;
+  }
+  return total;
+}
+
+CachingCPUAllocator* GetCachingCPUAllocator() {
+  static CachingCPUAllocator allocator;
+  return &allocator;
+}
+
+} // namespace c10
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/core/CPUAllocator.h>
+
+namespace c10 {
+
+// A size-classed caching allocator for CPU tensors.
+//
+// - Requests up to kMaxCachedSize bytes are rounded up to a power of two and
+//   served from a per-thread cache of freed blocks of that size class, so the
+//   common case of small, short-lived intermediates never reaches malloc.
+// - A thread cache that grows past its limit hands half of its blocks back to
+//   a central cache shared by all threads on the same NUMA node; a thread
+//   whose cache is empty refills from that central cache first.
+// - Blocks are always returned to the central cache of the NUMA node they
+//   were allocated on, so memory is not silently migrated across nodes.
+// - Larger requests go straight to alloc_cpu/free_cpu.
+//
+// Allocations are reported through ProfiledCPUMemoryReporter exactly like the
+// default allocator does. Install it with
+//
+//   c10::SetCPUAllocator(c10::GetCachingCPUAllocator());
+//
+class C10_API CachingCPUAllocator final : public at::Allocator {
+ public:
+  // Largest request (in bytes) that is served from the cache.
+  static constexpr size_t kMaxCachedSize = 1 << 20;
+
+  CachingCPUAllocator() = default;
+  ~CachingCPUAllocator() override = default;
+
+  at::DataPtr allocate(size_t nbytes) const override;
+  at::DeleterFnPtr raw_deleter() const override;
+
+  // Returns the blocks held by the central caches (but not by other threads'
+  // caches) to the system. The calling thread's cache is flushed first.
+  void emptyCache();
+
+  // Bytes currently held by the central caches.
+  size_t cachedBytes() const;
+};
+
+C10_API CachingCPUAllocator* GetCachingCPUAllocator();
+
+} // namespace c10
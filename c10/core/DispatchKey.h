@@ -99,6 +99,8 @@ enum class DispatchKey : uint8_t {
   SparseCUDA, // registered at build/aten/src/ATen/SparseCUDAType.cpp
   SparseHIP, // TODO: I think this is not actually used, due to Note
              // [Masquerading as CUDA]
+  SparseCsrCPU, // registered at build/aten/src/ATen/SparseCsrCPUType.cpp
+  SparseCsrCUDA, // registered at build/aten/src/ATen/SparseCsrCUDAType.cpp
 
   // Here are reserved backends for user-defined backends, see Note [Private use
   // DispatchKey]
@@ -0,0 +1,44 @@
+#include <c10/core/InferenceMode.h>
+
+namespace c10 {
+
+namespace {
+
+/// In the CAFFE2_FB_LIMITED_MOBILE_CAPABILITY build setting,
+/// thread_local is not supported.
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+thread_local bool InferenceMode_enabled = false;
+#else
+static bool InferenceMode_enabled = false;
+#endif
+
+} // anonymous namespace
+
+InferenceMode::InferenceMode(bool enabled)
+    : prev_mode_(InferenceMode_enabled),
+      prev_autograd_excluded_(
+          impl::tls_is_dispatch_key_excluded(DispatchKey::Autograd)) {
+  InferenceMode_enabled = enabled;
+  // Disabling an enabled inference mode brings Autograd back; otherwise keep
+  // an exclusion done outside of it, e.g. by AutoNonVariableTypeMode.
+  impl::tls_set_dispatch_key_excluded(
+      DispatchKey::Autograd,
+      enabled || (!prev_mode_ && prev_autograd_excluded_));
+}
+
+InferenceMode::~InferenceMode() {
+  InferenceMode_enabled = prev_mode_;
+  impl::tls_set_dispatch_key_excluded(
+      DispatchKey::Autograd, prev_autograd_excluded_);
+}
+
+bool InferenceMode::is_enabled() {
+  return InferenceMode_enabled;
+}
+
+void InferenceMode::set_enabled(bool enabled) {
+  InferenceMode_enabled = enabled;
+  impl::tls_set_dispatch_key_excluded(DispatchKey::Autograd, enabled);
+}
+
+} // namespace c10
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <c10/core/impl/LocalDispatchKeySet.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// Inference mode is a thread local mode for code that never runs backward,
+// e.g. serving a model.  While it is enabled:
+//
+//  - Autograd is excluded from dispatch, so calls go straight to the backend
+//    kernels (like AutoNonVariableTypeMode).  GradMode is left alone, the
+//    Python torch.inference_mode() disables it too.
+//  - Tensors created in it ("inference tensors") don't allocate a version
+//    counter.  In-place updates of them are not tracked, so autograd must not
+//    see them: saving one for backward, setting requires_grad on it, or
+//    modifying it in-place outside of inference mode raises an error.
+//
+// Tensors created outside of inference mode can still be used in it, but
+// nothing is recorded for them there either: in particular, their version
+// counter is not bumped by in-place updates, so don't modify tensors saved
+// for a pending backward pass in inference mode.
+struct C10_API InferenceMode {
+  InferenceMode(bool enabled = true);
+  ~InferenceMode();
+  InferenceMode(const InferenceMode&) = delete;
+  InferenceMode& operator=(const InferenceMode&) = delete;
+
+  static bool is_enabled();
+
+  // Non-RAII API, for the Python context manager and ThreadLocalState.
+  // Disabling also re-enables Autograd dispatch, prefer the guard.
+  static void set_enabled(bool enabled);
+
+ private:
+  bool prev_mode_;
+  bool prev_autograd_excluded_;
+};
+
+} // namespace c10
@@ -1 +1,22 @@
 #include <c10/core/StorageImpl.h>
+
+#include <c10/core/CPUAllocator.h>
+
+namespace c10 {
+
+constexpr size_t StorageImpl::kInlineBufferSize;
+
+bool StorageImpl::use_inline_buffer(
+    size_t size_bytes,
+    const at::Allocator* allocator) {
+#ifdef C10_MOBILE
+  // The mobile allocator pads allocations for QNNPACK and XNNPACK, which may
+  // read past the end of their inputs.
+  return false;
+#else
+  return size_bytes > 0 && size_bytes <= kInlineBufferSize &&
+      allocator == GetDefaultCPUAllocator() && !memoryProfilingEnabled();
+#endif
+}
+
+} // namespace c10
@@ -5,6 +5,9 @@
 
 #include <c10/util/intrusive_ptr.h>
 
+#include <cstddef>
+#include <cstring>
+
 namespace c10 {
 
 struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
@@ -28,6 +31,8 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
     }
   }
 
+  // Small storages of the default CPU allocator keep their data in
+  // inline_buffer_ instead of a separate allocation, see use_inline_buffer.
   StorageImpl(
       use_byte_size_t use_byte_size,
       size_t size_bytes,
@@ -36,17 +41,46 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
       : StorageImpl(
             use_byte_size_t(),
             size_bytes,
-            allocator->allocate(size_bytes),
+            use_inline_buffer(size_bytes, allocator)
+                ? at::DataPtr(inline_buffer_, at::Device(DeviceType::CPU))
+                : allocator->allocate(size_bytes),
             allocator,
             resizable) {}
 
-  StorageImpl& operator=(StorageImpl&& other) = default;
+  StorageImpl& operator=(StorageImpl&& other) {
+    data_ptr_ = std::move(other.data_ptr_);
+    size_bytes_ = other.size_bytes_;
+    resizable_ = other.resizable_;
+    received_cuda_ = other.received_cuda_;
+    allocator_ = other.allocator_;
+    take_inline_buffer(other);
+    return *this;
+  }
   StorageImpl& operator=(const StorageImpl&) = delete;
   StorageImpl() = delete;
-  StorageImpl(StorageImpl&& other) = default;
+  StorageImpl(StorageImpl&& other)
+      : data_ptr_(std::move(other.data_ptr_)),
+        size_bytes_(other.size_bytes_),
+        resizable_(other.resizable_),
+        received_cuda_(other.received_cuda_),
+        allocator_(other.allocator_) {
+    take_inline_buffer(other);
+  }
   StorageImpl(const StorageImpl&) = delete;
   ~StorageImpl() = default;
 
+  // Storages of up to this many bytes can be kept inline.
+  static constexpr size_t kInlineBufferSize = 64;
+
+  // Whether a storage of `size_bytes` from `allocator` is kept inline. Only
+  // the default CPU allocator qualifies, and only when the memory profiler
+  // is off, so that it doesn't miss allocations.
+  static bool use_inline_buffer(size_t size_bytes, const at::Allocator* allocator);
+
+  bool is_inline() const {
+    return data_ptr_.get() == inline_buffer_;
+  }
+
   void reset() {
     data_ptr_.clear();
     size_bytes_ = 0;
@@ -175,5 +209,20 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
   // local to process cuda memory allocation
   bool received_cuda_;
   Allocator* allocator_;
+  // Holds the data of small storages, see use_inline_buffer.  Resizing one
+  // past kInlineBufferSize moves the data to the allocator like for any
+  // other storage; the buffer then stays unused.  malloc'ed objects only
+  // give max_align_t alignment, which is less than gAlignment: the kernels
+  // don't rely on more for tensors this small.
+  alignas(alignof(std::max_align_t)) char inline_buffer_[kInlineBufferSize];
+
+  // The move operations copy an inline buffer along, so that data_ptr_
+  // doesn't point into the moved-from object (e.g. THStorage_swap).
+  void take_inline_buffer(const StorageImpl& other) {
+    if (data_ptr_.get() == other.inline_buffer_) {
+      std::memcpy(inline_buffer_, other.inline_buffer_, kInlineBufferSize);
+      data_ptr_ = at::DataPtr(inline_buffer_, data_ptr_.device());
+    }
+  }
 };
 } // namespace c10
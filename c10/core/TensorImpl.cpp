@@ -1,6 +1,7 @@
 #include <c10/core/TensorImpl.h>
 
 #include <c10/core/Backend.h>
+#include <c10/core/InferenceMode.h>
 #include <c10/core/WrapDimMinimal.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
 #include <c10/util/Optional.h>
@@ -28,6 +29,73 @@ const char * const TensorImpl::err_msg_tensor_metadata_change_not_allowed =
     "    with torch.no_grad():\n"
     "        x.set_(y)";
 
+// The free list keeps use after free bugs from ASAN
+#if defined(__SANITIZE_ADDRESS__)
+#define C10_TENSORIMPL_FREE_LIST 0
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define C10_TENSORIMPL_FREE_LIST 0
+#endif
+#endif
+#ifndef C10_TENSORIMPL_FREE_LIST
+#define C10_TENSORIMPL_FREE_LIST 1
+#endif
+
+#if C10_TENSORIMPL_FREE_LIST
+namespace {
+
+constexpr size_t kMaxFreeTensorImpls = 64;
+
+// The memory of the last TensorImpls this thread freed. Trivially
+// destructible, so that it stays usable while the thread exits, after the
+// destructors of the other thread locals, which may free tensors, ran.
+struct TensorImplFreeList {
+  void* blocks[kMaxFreeTensorImpls];
+  size_t size;
+  // Set when the thread exits, the TensorImpls freed after are deleted
+  bool closed;
+};
+
+thread_local TensorImplFreeList tensor_impl_free_list;
+
+// Deletes the free list of a thread when it exits
+struct TensorImplFreeListCloser {
+  ~TensorImplFreeListCloser() {
+    auto& free_list = tensor_impl_free_list;
+    free_list.closed = true;
+    while (free_list.size > 0) {
+      ::operator delete(free_list.blocks[--free_list.size]);
+    }
+  }
+};
+
+} // namespace
+#endif
+
+void* TensorImpl::operator new(std::size_t size) {
+#if C10_TENSORIMPL_FREE_LIST
+  auto& free_list = tensor_impl_free_list;
+  if (size == sizeof(TensorImpl) && free_list.size > 0) {
+    return free_list.blocks[--free_list.size];
+  }
+#endif
+  return ::operator new(size);
+}
+
+void TensorImpl::operator delete(void* ptr, std::size_t size) {
+#if C10_TENSORIMPL_FREE_LIST
+  auto& free_list = tensor_impl_free_list;
+  if (size == sizeof(TensorImpl) && !free_list.closed &&
+      free_list.size < kMaxFreeTensorImpls) {
+    static thread_local TensorImplFreeListCloser closer;
+    (void)closer;
+    free_list.blocks[free_list.size++] = ptr;
+    return;
+  }
+#endif
+  ::operator delete(ptr);
+}
+
 at::Tensor& TensorImpl::grad() {
   if (!autograd_meta_) autograd_meta_ = impl::GetAutogradMetaFactory()->make();
   return autograd_meta_->grad();
@@ -56,6 +124,9 @@ TensorImpl::TensorImpl(DispatchKeySet key_set, const caffe2::TypeMeta& data_type
 TensorImpl::TensorImpl(Storage&& storage, DispatchKeySet key_set, const caffe2::TypeMeta& data_type,
                        c10::optional<c10::Device> device_opt)
     : storage_(std::move(storage)),
+      version_counter_(
+          InferenceMode::is_enabled() ? VariableVersion(VariableVersion::DISABLED)
+                                      : VariableVersion(0)),
       sizes_{0},
       storage_offset_(0),
       numel_(0),
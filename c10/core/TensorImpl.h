@@ -215,6 +215,11 @@ struct C10_API NamedTensorMetaInterface {
 // when saving a tensor can introduce race conditions when we are running the forward
 // pass in multi-thread scenarios, thus making the forward pass not thread-safe anymore,
 // which breaks the invariant.
+//
+// The exception are the tensors created in InferenceMode: they never meet
+// autograd, so they don't allocate a version counter at all (see
+// VariableVersion::DISABLED).  Bumping such a counter is an error; they are
+// only modified in-place without bumping, i.e. in InferenceMode.
 struct C10_API VariableVersion {
  private:
   struct VersionCounter : intrusive_ptr_target {
@@ -224,6 +229,8 @@ struct C10_API VariableVersion {
   c10::intrusive_ptr<VersionCounter> version_counter_;
 
  public:
+  enum Disabled { DISABLED };
+
   bool unique() const {
     return 1 == version_counter_.use_count();
   }
@@ -232,13 +239,24 @@ struct C10_API VariableVersion {
   // https://cplusplus.github.io/LWG/issue2334.
   VariableVersion(uint32_t version = 0)
       : version_counter_(c10::make_intrusive<VersionCounter>(version)) {}
+  VariableVersion(Disabled) {}
+
+  bool enabled() const {
+    return version_counter_.defined();
+  }
 
-  void bump() noexcept {
+  void bump() {
+    TORCH_CHECK(
+        version_counter_,
+        "Inplace update to inference tensor outside InferenceMode is not allowed. "
+        "You can make a clone to get a normal tensor before doing inplace update.");
     ++version_counter_->version_;
   }
 
+  // Inference tensors stay at version 0, they can't be saved for backward
+  // anyway.
   uint32_t current_version() const noexcept {
-    return version_counter_->version_;
+    return version_counter_ ? version_counter_->version_.load() : 0;
   }
 };
 
@@ -355,6 +373,15 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   TensorImpl(TensorImpl&&) = default;
   TensorImpl& operator=(TensorImpl&&) = default;
 
+  /**
+   * TensorImpls, and the subclasses of the same size, are allocated from a
+   * per-thread list of the last ones the thread freed. Creating views of a
+   * tensor in a loop (x[i], narrow, view, ...) then reuses the TensorImpl of
+   * the view the previous iteration released instead of calling malloc.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr, std::size_t size);
+
   /**
    * Release (decref) storage, and any other external allocations.  This
    * override is for `intrusive_ptr_target` and is used to implement weak
@@ -437,6 +464,12 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
            key_set_.has(DispatchKey::SparseHIP);
   }
 
+  bool is_sparse_csr() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::SparseCsrCPU) ||
+           key_set_.has(DispatchKey::SparseCsrCUDA);
+  }
+
   bool is_quantized() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::QuantizedCPU) ||
@@ -452,6 +485,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::CUDA) ||
         key_set_.has(DispatchKey::SparseCUDA) ||
+        key_set_.has(DispatchKey::SparseCsrCUDA) ||
         key_set_.has(DispatchKey::QuantizedCUDA);
   }
 
@@ -489,6 +523,8 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for perf.
     if (is_sparse()) {
       return kSparse;
+    } else if (is_sparse_csr()) {
+      return kSparseCsr;
     } else if (is_mkldnn()) {
       return kMkldnn;
     } else {
@@ -912,7 +948,13 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
              ts.has(DispatchKey::SparseCUDA) ||
              ts.has(DispatchKey::SparseHIP);
     };
-    return (key_set_ == from) || (is_dense(key_set_) && is_dense(from)) || (is_sparse(key_set_) && is_sparse(from));
+    auto is_sparse_csr = [](DispatchKeySet ts) {
+      return ts.has(DispatchKey::SparseCsrCPU) ||
+             ts.has(DispatchKey::SparseCsrCUDA);
+    };
+    return (key_set_ == from) || (is_dense(key_set_) && is_dense(from)) ||
+        (is_sparse(key_set_) && is_sparse(from)) ||
+        (is_sparse_csr(key_set_) && is_sparse_csr(from));
   }
 
   /**
@@ -961,10 +1003,18 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     return version_counter_;
   }
 
-  void bump_version() noexcept {
+  void bump_version() {
     version_counter_.bump();
   }
 
+  /**
+   * Whether this tensor was created in InferenceMode, i.e. has no version
+   * counter.
+   */
+  bool is_inference() const {
+    return !version_counter_.enabled();
+  }
+
   inline void set_pyobj(PyObject* pyobj) noexcept {
     pyobj_ = pyobj;
   }
@@ -40,10 +40,8 @@ LocalDispatchKeySet tls_local_dispatch_key_set() {
 }
 
 void _force_tls_local_dispatch_key_set(LocalDispatchKeySet key_set) {
-  raw_local_dispatch_key_set = PODLocalDispatchKeySet {
-    key_set.included_.raw_repr(),
-    key_set.excluded_.raw_repr()
-  };
+  raw_local_dispatch_key_set.set_included(key_set.included_);
+  raw_local_dispatch_key_set.set_excluded(key_set.excluded_);
 }
 
 // An RAII guard could snapshot and restore the entire state (entire DispatchKeySet) as
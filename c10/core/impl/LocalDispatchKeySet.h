@@ -25,11 +25,23 @@ namespace impl {
 
 C10_DECLARE_bool(disable_variable_dispatch);
 
+// Some keys are ALWAYS considered for inclusion by default, so they are
+// included in the set here.  (const appears to be sufficient for
+// always_included to get inlined, constexpr not necessary)
+const DispatchKeySet always_included{DispatchKey::Autograd, DispatchKey::BackendSelect};
+
 // POD version of LocalDispatchKeySet.  Declared here just so that
 // we can put it in the guards.
+//
+// Besides the raw sets, this caches the keys every dispatch adds on top of
+// the ones of the tensors, i.e. (included | always_included) - excluded, so
+// that the dispatcher doesn't need to recompute it on every call.  The
+// setters keep it up to date.  To keep the zero-initialized TLS valid, it is
+// stored XOR'ed with always_included.
 struct C10_API PODLocalDispatchKeySet {
   uint64_t included_;
   uint64_t excluded_;
+  uint64_t forced_xor_always_included_;
 
   DispatchKeySet included() const {
     return DispatchKeySet(DispatchKeySet::RAW, included_);
@@ -38,20 +50,43 @@ struct C10_API PODLocalDispatchKeySet {
     return DispatchKeySet(DispatchKeySet::RAW, excluded_);
   }
 
+  DispatchKeySet forced() const {
+    return DispatchKeySet(DispatchKeySet::RAW,
+        forced_xor_always_included_ ^ always_included.raw_repr());
+  }
+
   void set_included(DispatchKeySet x) {
     included_ = x.raw_repr();
+    update_forced();
   }
   void set_excluded(DispatchKeySet x) {
     excluded_ = x.raw_repr();
+    update_forced();
+  }
+
+ private:
+  void update_forced() {
+    forced_xor_always_included_ =
+        ((included() | always_included) - excluded()).raw_repr() ^
+        always_included.raw_repr();
   }
 };
 static_assert(std::is_pod<PODLocalDispatchKeySet>::value, "PODLocalDispatchKeySet must be a POD type.");
 
 struct C10_API LocalDispatchKeySet {
   /* implicit */ LocalDispatchKeySet(PODLocalDispatchKeySet x)
-    : included_(x.included()), excluded_(x.excluded()) {}
+    : included_(x.included()), excluded_(x.excluded()), forced_(x.forced()) {}
   DispatchKeySet included_;
   DispatchKeySet excluded_;
+  // (included_ | always_included) - excluded_, see PODLocalDispatchKeySet.
+  // Derived state: _force_tls_local_dispatch_key_set only reads the two
+  // sets above.
+  DispatchKeySet forced_;
+
+  // The keys dispatch considers for a call with tensors of key set `ks`.
+  DispatchKeySet apply(DispatchKeySet ks) const {
+    return (ks - excluded_) | forced_;
+  }
 };
 
 C10_API LocalDispatchKeySet tls_local_dispatch_key_set();
@@ -75,6 +75,46 @@ void ThreadPool::waitWorkComplete() {
   }
 }
 
+bool ThreadPool::runPendingTask() {
+  std::size_t index = 0;
+  while (index < threads_.size() &&
+         threads_[index].get_id() != std::this_thread::get_id()) {
+    ++index;
+  }
+  // Only pool threads run tasks inline, the ids passed to tasks are the ones
+  // of pool threads.
+  if (index == threads_.size()) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (tasks_.empty() || !running_) {
+    return false;
+  }
+  // The calling thread is already busy with the task that waits, so the
+  // number of available threads doesn't change.
+  task_element_t task = std::move(tasks_.front());
+  tasks_.pop();
+  lock.unlock();
+
+  run_task(task, index);
+  return true;
+}
+
+void ThreadPool::run_task(task_element_t& task, std::size_t index) {
+  try {
+    if (task.run_with_id) {
+      task.with_id(index);
+    } else {
+      task.no_id();
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Exception in thread pool task: " << e.what();
+  } catch (...) {
+    LOG(ERROR) << "Exception in thread pool task: unknown";
+  }
+}
+
 void ThreadPool::main_loop(std::size_t index) {
   std::unique_lock<std::mutex> lock(mutex_);
   while (running_) {
@@ -101,18 +141,7 @@ void ThreadPool::main_loop(std::size_t index) {
 
       lock.unlock();
 
-      // Run the task.
-      try {
-        if (tasks.run_with_id) {
-          tasks.with_id(index);
-        } else {
-          tasks.no_id();
-        }
-      } catch (const std::exception& e) {
-        LOG(ERROR) << "Exception in thread pool task: " << e.what();
-      } catch (...) {
-        LOG(ERROR) << "Exception in thread pool task: unknown";
-      }
+      run_task(tasks, index);
 
       // Update status of empty, maybe
       // Need to recover the lock first
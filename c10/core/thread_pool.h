@@ -31,6 +31,16 @@ class C10_API TaskThreadPoolBase {
    */
   virtual bool inThreadPool() const = 0;
 
+  /**
+   * Runs one queued task on the calling thread, if there is one. Returns
+   * false if the queue is empty or the pool can't run tasks inline.
+   * A pool thread that would block on the result of other tasks calls it to
+   * make progress on them instead of holding on to its slot in the pool.
+   */
+  virtual bool runPendingTask() {
+    return false;
+  }
+
   virtual ~TaskThreadPoolBase() noexcept {}
 
   static size_t defaultNumThreads() {
@@ -82,6 +92,8 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
 
   bool inThreadPool() const override;
 
+  bool runPendingTask() override;
+
   void run(std::function<void()> func) override;
 
   template <typename Task>
@@ -101,6 +113,9 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
  private:
   // @brief Entry point for pool threads.
   void main_loop(std::size_t index);
+
+  // @brief Runs a task that has been removed from the queue.
+  static void run_task(task_element_t& task, std::size_t index);
 };
 
 class C10_API TaskThreadPool : public c10::ThreadPool {
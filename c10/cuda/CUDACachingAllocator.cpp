@@ -3,17 +3,23 @@
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
+#include <c10/util/Backtrace.h>
 #include <c10/util/UniqueVoidPtr.h>
 
+#include <cuda.h>
 #include <cuda_runtime_api.h>
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <cstdlib>
 #include <deque>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -51,6 +57,19 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Expandable segments (opt-in via PYTORCH_CUDA_ALLOC_CONF=expandable_segments:True):
+//
+// - Instead of one cudaMalloc per segment, the allocator reserves a large
+//   virtual address range per (stream, pool) and maps physical pages into the
+//   end of it on demand with the CUDA virtual memory management API
+//   (cuMemCreate/cuMemMap).
+// - A segment grows in place, so the free block at its tail is always merged
+//   with newly mapped memory instead of leaving a hole next to a new segment.
+// - free_cached_blocks() unmaps the page-aligned part of a free tail block; it
+//   never punches holes in the middle of a segment.
+// - Blocks in expandable segments cannot be shared over CUDA IPC, since they do
+//   not come from cudaMalloc.
+//
 
 
 namespace {
@@ -66,6 +85,59 @@ constexpr size_t kRoundLarge = 2097152;     // round up large allocs to 2 MiB
 
 typedef std::bitset<static_cast<size_t>(StatType::NUM_TYPES)> StatTypes;
 
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 10020 && !defined(_WIN32) && !defined(__HIP_PLATFORM_HCC__)
+#define C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+#endif
+
+// Options parsed from the PYTORCH_CUDA_ALLOC_CONF environment variable, which
+// holds a comma separated list of "key:value" pairs, e.g.
+// PYTORCH_CUDA_ALLOC_CONF=expandable_segments:True
+class CachingAllocatorConfig {
+ public:
+  static bool expandable_segments() {
+    return instance().expandable_segments_;
+  }
+
+ private:
+  CachingAllocatorConfig() : expandable_segments_(false) {
+    parseArgs(getenv("PYTORCH_CUDA_ALLOC_CONF"));
+  }
+
+  static CachingAllocatorConfig& instance() {
+    static CachingAllocatorConfig config;
+    return config;
+  }
+
+  void parseArgs(const char* env) {
+    if (env == nullptr) {
+      return;
+    }
+    std::stringstream options(env);
+    std::string option;
+    while (std::getline(options, option, ',')) {
+      const auto colon = option.find(':');
+      TORCH_CHECK(colon != std::string::npos,
+        "PYTORCH_CUDA_ALLOC_CONF: expected key:value pair, got '", option, "'");
+      const std::string key = option.substr(0, colon);
+      const std::string value = option.substr(colon + 1);
+      if (key == "expandable_segments") {
+        TORCH_CHECK(value == "True" || value == "False",
+          "PYTORCH_CUDA_ALLOC_CONF: expandable_segments expects True or False, got '", value, "'");
+        expandable_segments_ = (value == "True");
+#ifndef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+        TORCH_WARN_ONCE(
+          "expandable_segments requires CUDA 10.2 or newer on Linux; ignoring it");
+        expandable_segments_ = false;
+#endif
+      } else {
+        TORCH_CHECK(false, "PYTORCH_CUDA_ALLOC_CONF: unrecognized option '", key, "'");
+      }
+    }
+  }
+
+  bool expandable_segments_;
+};
+
 void update_stat(Stat& stat, int64_t amount) {
   stat.current += amount;
 
@@ -98,8 +170,18 @@ void update_stat_array(StatArray& stat_array, int64_t amount, const StatTypes& s
 }
 
 struct Block;
+struct ExpandableSegment;
+struct PrivatePool;
 typedef bool (*Comparison)(const Block*, const Block*);
-typedef std::set<Block*, Comparison> BlockPool;
+
+struct BlockPool {
+  BlockPool(Comparison comparator, bool small, PrivatePool* private_pool = nullptr) :
+    blocks(comparator), is_small(small), owner_PrivatePool(private_pool) {}
+
+  std::set<Block*, Comparison> blocks;
+  const bool is_small;
+  PrivatePool* owner_PrivatePool; // nullptr for the device's default pools
+};
 
 struct Block {
   int           device;      // gpu
@@ -112,21 +194,144 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  ExpandableSegment* expandable_segment; // owning segment, if not from cudaMalloc
+  int64_t       stack_id;    // recorded stack trace of the allocation, or -1
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable_segment(nullptr), stack_id(-1) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable_segment(nullptr), stack_id(-1) { }
 
   bool is_split() const {
     return (prev != nullptr) || (next != nullptr);
   }
 };
 
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+
+#define C10_CUDA_DRIVER_CHECK(EXPR)                                   \
+  do {                                                                \
+    CUresult __err = EXPR;                                            \
+    if (__err != CUDA_SUCCESS) {                                      \
+      const char* __msg = nullptr;                                    \
+      cuGetErrorString(__err, &__msg);                                \
+      TORCH_CHECK(false, "CUDA driver error: ", __msg ? __msg : "unknown"); \
+    }                                                                 \
+  } while (0)
+
+// A virtual address range reserved once per (device, stream, pool) into which
+// physical memory is mapped in page-sized chunks. Only the end of the mapped
+// range ever moves, so the blocks carved out of a segment always form a single
+// contiguous prev/next chain starting at ptr().
+struct ExpandableSegment {
+  ExpandableSegment(int device, cudaStream_t stream, BlockPool* pool,
+                    size_t page_size, size_t max_size) :
+    device(device), stream(stream), pool(pool), tail(nullptr),
+    page_size_(page_size), base_(0), mapped_size_(0) {
+    max_pages_ = (max_size + page_size - 1) / page_size;
+    C10_CUDA_DRIVER_CHECK(
+      cuMemAddressReserve(&base_, max_pages_ * page_size_, 0, 0, 0));
+  }
+
+  ~ExpandableSegment() {
+    unmap_to(0);
+    C10_CUDA_DRIVER_CHECK(cuMemAddressFree(base_, max_pages_ * page_size_));
+  }
+
+  char* ptr() const { return reinterpret_cast<char*>(base_); }
+  size_t page_size() const { return page_size_; }
+  size_t mapped_size() const { return mapped_size_; }
+
+  // Maps at least nbytes of new memory at the end of the segment, returning
+  // the number of bytes mapped. On failure returns 0 and leaves the segment
+  // unchanged; *err is set to cudaErrorMemoryAllocation if the device is out
+  // of memory.
+  size_t grow(size_t nbytes, cudaError_t* err) {
+    const size_t num_pages = (nbytes + page_size_ - 1) / page_size_;
+    if (handles_.size() + num_pages > max_pages_) {
+      *err = cudaErrorMemoryAllocation;
+      return 0;
+    }
+    CUmemAllocationProp prop = {};
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    CUmemAccessDesc desc = {};
+    desc.location = prop.location;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+
+    const size_t old_size = mapped_size_;
+    for (size_t i = 0; i < num_pages; ++i) {
+      CUmemGenericAllocationHandle handle;
+      CUresult status = cuMemCreate(&handle, page_size_, &prop, 0);
+      if (status == CUDA_ERROR_OUT_OF_MEMORY) {
+        unmap_to(old_size);
+        *err = cudaErrorMemoryAllocation;
+        return 0;
+      }
+      C10_CUDA_DRIVER_CHECK(status);
+      C10_CUDA_DRIVER_CHECK(cuMemMap(base_ + mapped_size_, page_size_, 0, handle, 0));
+      handles_.push_back(handle);
+      C10_CUDA_DRIVER_CHECK(cuMemSetAccess(base_ + mapped_size_, page_size_, &desc, 1));
+      mapped_size_ += page_size_;
+    }
+    return mapped_size_ - old_size;
+  }
+
+  // Unmaps all pages past new_size, which must be a multiple of the page size.
+  void unmap_to(size_t new_size) {
+    TORCH_INTERNAL_ASSERT(new_size % page_size_ == 0 && new_size <= mapped_size_);
+    while (mapped_size_ > new_size) {
+      mapped_size_ -= page_size_;
+      C10_CUDA_DRIVER_CHECK(cuMemUnmap(base_ + mapped_size_, page_size_));
+      C10_CUDA_DRIVER_CHECK(cuMemRelease(handles_.back()));
+      handles_.pop_back();
+    }
+  }
+
+  int device;
+  cudaStream_t stream;
+  BlockPool* pool;
+  Block* tail;   // last block of the chain, or nullptr if nothing is mapped
+
+ private:
+  size_t page_size_;
+  size_t max_pages_;
+  CUdeviceptr base_;
+  size_t mapped_size_;
+  std::vector<CUmemGenericAllocationHandle> handles_;
+};
+
+#else
+
+// Stub so that the allocator compiles on platforms without the CUDA virtual
+// memory management API; CachingAllocatorConfig never enables it there.
+struct ExpandableSegment {
+  ExpandableSegment(int device, cudaStream_t stream, BlockPool* pool,
+                    size_t page_size, size_t max_size) :
+    device(device), stream(stream), pool(pool), tail(nullptr) {
+    AT_ERROR("expandable segments are not supported on this platform");
+  }
+  char* ptr() const { return nullptr; }
+  size_t page_size() const { return 1; }
+  size_t mapped_size() const { return 0; }
+  size_t grow(size_t nbytes, cudaError_t* err) { return 0; }
+  void unmap_to(size_t new_size) {}
+
+  int device;
+  cudaStream_t stream;
+  BlockPool* pool;
+  Block* tail;
+};
+
+#endif // C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+
 static bool BlockComparator(const Block* a, const Block* b)
 {
   if (a->stream != b->stream) {
@@ -138,6 +343,24 @@ static bool BlockComparator(const Block* a, const Block* b)
   return (uintptr_t)a->ptr < (uintptr_t)b->ptr;
 }
 
+// A set of small/large pools that only serves the streams routed to it with
+// beginAllocateStreamToPool. Its cached blocks are never handed out to other
+// pools and are not returned to the device by emptyCache(); they are released
+// as a whole by releasePool once every allocation made from it is freed.
+struct PrivatePool {
+  PrivatePool() :
+    large_blocks(BlockComparator, false, this),
+    small_blocks(BlockComparator, true, this),
+    allocation_count(0) {}
+  PrivatePool(const PrivatePool&) = delete;
+  PrivatePool& operator=(const PrivatePool&) = delete;
+
+  BlockPool large_blocks;
+  BlockPool small_blocks;
+  // number of blocks from this pool that are allocated or pending free
+  int allocation_count;
+};
+
 static std::string format_size(uint64_t size) {
   std::ostringstream os;
   os.precision(2);
@@ -164,7 +387,8 @@ struct AllocParams {
     pool(pool),
     alloc_size(alloc_size),
     block(nullptr),
-    err(cudaSuccess) {}
+    err(cudaSuccess),
+    stack_id(-1) {}
 
   int device() { return search_key.device; }
   cudaStream_t stream() { return search_key.stream; }
@@ -176,6 +400,7 @@ struct AllocParams {
   Block* block;
   StatTypes stat_types;
   cudaError_t err;
+  int64_t stack_id;
 };
 
 } // namespace
@@ -196,17 +421,43 @@ class DeviceCachingAllocator {
   // unallocated cached blocks 1 MB or smaller
   BlockPool small_blocks;
 
+  // private pools by id, and the pool each routed stream allocates from
+  std::map<MempoolId_t, std::unique_ptr<PrivatePool>> private_pools;
+  std::unordered_map<cudaStream_t, PrivatePool*> stream_to_pool;
+
+  // released private pools that still have live allocations
+  std::vector<std::unique_ptr<PrivatePool>> released_private_pools;
+
   // allocated or in use by a stream
   std::unordered_set<Block*> active_blocks;
 
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
+  // virtual address ranges grown on demand (expandable_segments mode)
+  std::vector<std::unique_ptr<ExpandableSegment>> expandable_segments;
+
+  // cudaIpcMemHandle_t of the cudaMalloc allocations sent to other processes,
+  // by base pointer, until the allocation is freed
+  std::unordered_map<void*, std::string> ipc_mem_handles;
+
+  // allocation history (recordHistory): a ring buffer of the last
+  // history_max_entries events, the oldest at history_next once it is full
+  bool record_history = false;
+  bool record_stacks = false;
+  size_t history_max_entries = 0;
+  size_t history_next = 0;
+  std::vector<TraceEntry> history;
+
+  // distinct stack traces recorded, and their ids
+  std::vector<std::string> stacks;
+  std::unordered_map<std::string, int64_t> stack_ids;
+
  public:
 
   DeviceCachingAllocator() :
-      large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      large_blocks(BlockComparator, false),
+      small_blocks(BlockComparator, true) {}
 
   // All public methods (except the above) acquire the allocator mutex.
   // Thus, do not call a public method from another public method.
@@ -217,13 +468,17 @@ class DeviceCachingAllocator {
 
     // process outstanding cudaEvents
     process_events();
+    release_idle_private_pools();
 
     size = round_size(size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, stream);
     const size_t alloc_size = get_allocation_size(size);
     AllocParams params(device, size, stream, &pool, alloc_size, stats);
     params.stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
     params.stat_types[static_cast<size_t>(get_stat_type_for_pool(pool))] = true;
+    if (record_stacks) {
+      params.stack_id = current_stack_id();
+    }
 
     bool block_found =
       // Search pool
@@ -243,6 +498,7 @@ class DeviceCachingAllocator {
         C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
 
         stats.num_ooms += 1;
+        record_trace(TraceEntryAction::OOM, nullptr, size, stream, params.stack_id);
 
         // "total capacity": total global memory on GPU
         // "already allocated": memory allocated by the program using the
@@ -284,6 +540,7 @@ class DeviceCachingAllocator {
       remaining = block;
 
       block = new Block(device, stream, size, &pool, block->ptr);
+      block->expandable_segment = remaining->expandable_segment;
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -293,7 +550,7 @@ class DeviceCachingAllocator {
       remaining->prev = block;
       remaining->ptr = static_cast<char*>(remaining->ptr) + size;
       remaining->size -= size;
-      pool.insert(remaining);
+      pool.blocks.insert(remaining);
 
       if (already_split) {
         // An already-split inactive block is being shrunk by size bytes.
@@ -311,7 +568,11 @@ class DeviceCachingAllocator {
     }
 
     block->allocated = true;
+    block->stack_id = params.stack_id;
     active_blocks.insert(block);
+    if (pool.owner_PrivatePool) {
+      pool.owner_PrivatePool->allocation_count++;
+    }
 
     c10::reportMemoryUsageToProfiler(
         block, block->size, c10::Device(c10::DeviceType::CUDA, device));
@@ -321,6 +582,7 @@ class DeviceCachingAllocator {
     update_stat_array(stats.active, 1, params.stat_types);
     update_stat_array(stats.active_bytes, block->size, params.stat_types);
 
+    record_trace(TraceEntryAction::ALLOC, block->ptr, block->size, stream, params.stack_id);
     return block;
   }
 
@@ -329,6 +591,7 @@ class DeviceCachingAllocator {
     std::lock_guard<std::recursive_mutex> lock(mutex);
 
     block->allocated = false;
+    record_trace(TraceEntryAction::FREE, block->ptr, block->size, block->stream, block->stack_id);
 
     c10::reportMemoryUsageToProfiler(
         block, -block->size, c10::Device(c10::DeviceType::CUDA, block->device));
@@ -344,10 +607,14 @@ class DeviceCachingAllocator {
     } else {
       free_block(block);
     }
+    release_idle_private_pools();
   }
 
   void* getBaseAllocation(Block* block, size_t* outSize) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(!block->expandable_segment,
+      "getBaseAllocation: blocks in expandable segments have no base cudaMalloc "
+      "allocation and cannot be shared over CUDA IPC");
     while (block->prev) {
       block = block->prev;
     }
@@ -363,6 +630,21 @@ class DeviceCachingAllocator {
     return basePtr;
   }
 
+  std::string getIpcMemHandle(Block* block) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    void* base_ptr = getBaseAllocation(block, nullptr);
+    auto it = ipc_mem_handles.find(base_ptr);
+    if (it == ipc_mem_handles.end()) {
+      cuda::CUDAGuard device_guard(block->device);
+      cudaIpcMemHandle_t handle;
+      C10_CUDA_CHECK(cudaIpcGetMemHandle(&handle, base_ptr));
+      it = ipc_mem_handles.emplace(
+          base_ptr,
+          std::string(reinterpret_cast<const char*>(&handle), sizeof(handle))).first;
+    }
+    return it->second;
+  }
+
   void recordStream(Block* block, cuda::CUDAStream stream) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     if (stream.stream() == block->stream) {
@@ -373,6 +655,38 @@ class DeviceCachingAllocator {
     block->stream_uses.insert(stream);
   }
 
+  /** routes all allocations on stream to the private pool pool_id **/
+  void beginAllocateStreamToPool(cudaStream_t stream, MempoolId_t pool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(stream_to_pool.find(stream) == stream_to_pool.end(),
+      "beginAllocateStreamToPool: stream is already allocating to a private pool");
+    auto it = private_pools.find(pool_id);
+    if (it == private_pools.end()) {
+      it = private_pools.emplace(pool_id, std::unique_ptr<PrivatePool>(new PrivatePool())).first;
+    }
+    stream_to_pool.emplace(stream, it->second.get());
+  }
+
+  /** stops routing allocations on stream to a private pool **/
+  void endAllocateStreamToPool(cudaStream_t stream) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    stream_to_pool.erase(stream);
+  }
+
+  /** returns the memory of private pool pool_id to the system allocator **/
+  void releasePool(MempoolId_t pool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = private_pools.find(pool_id);
+    TORCH_CHECK(it != private_pools.end(), "releasePool: no private pool with id ", pool_id);
+    PrivatePool* pool = it->second.get();
+    for (auto s = stream_to_pool.begin(); s != stream_to_pool.end();) {
+      s = (s->second == pool) ? stream_to_pool.erase(s) : std::next(s);
+    }
+    released_private_pools.push_back(std::move(it->second));
+    private_pools.erase(it);
+    release_idle_private_pools();
+  }
+
   /** returns cached blocks to the system allocator **/
   void emptyCache() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
@@ -390,6 +704,10 @@ class DeviceCachingAllocator {
     }
     cache_info_aux(large_blocks, total, largest);
     cache_info_aux(small_blocks, total, largest);
+    for (const auto& it : private_pools) {
+      cache_info_aux(it.second->large_blocks, total, largest);
+      cache_info_aux(it.second->small_blocks, total, largest);
+    }
   }
 
   /** Returns a copy of the memory allocator stats **/
@@ -448,7 +766,8 @@ class DeviceCachingAllocator {
       SegmentInfo& segment_info = result.back();
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
-      segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.is_large = !head_block->pool->is_small;
+      segment_info.is_expandable = (head_block->expandable_segment != nullptr);
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -458,6 +777,7 @@ class DeviceCachingAllocator {
         block_info.size = block->size;
         block_info.allocated = block->allocated;
         block_info.active = block->allocated || (block->event_count > 0);
+        block_info.stack_id = block->stack_id;
 
         segment_info.total_size += block_info.size;
         if (block_info.allocated) {
@@ -478,6 +798,31 @@ class DeviceCachingAllocator {
     return result;
   }
 
+  /** starts, changes or stops recording the allocation history **/
+  void recordHistory(bool enabled, bool stacks_enabled, size_t max_entries) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(!enabled || max_entries > 0,
+      "recordHistory: max_entries must be positive");
+    record_history = enabled;
+    record_stacks = enabled && stacks_enabled;
+    history_max_entries = enabled ? max_entries : 0;
+    history_next = 0;
+    history.clear();
+    history.shrink_to_fit();
+    history.reserve(history_max_entries);
+  }
+
+  /** Returns the recorded allocation history, oldest event first **/
+  AllocatorHistory getHistory() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    AllocatorHistory result;
+    result.entries.reserve(history.size());
+    result.entries.insert(result.entries.end(), history.begin() + history_next, history.end());
+    result.entries.insert(result.entries.end(), history.begin(), history.begin() + history_next);
+    result.stacks = stacks;
+    return result;
+  }
+
   static size_t round_size(size_t size) {
     if (size < kMinBlockSize) {
       return kMinBlockSize;
@@ -492,16 +837,59 @@ class DeviceCachingAllocator {
 
   std::vector<const Block*> get_all_blocks() const {
     std::vector<const Block*> blocks;
-    blocks.insert(blocks.end(), small_blocks.begin(), small_blocks.end());
-    blocks.insert(blocks.end(), large_blocks.begin(), large_blocks.end());
+    blocks.insert(blocks.end(), small_blocks.blocks.begin(), small_blocks.blocks.end());
+    blocks.insert(blocks.end(), large_blocks.blocks.begin(), large_blocks.blocks.end());
+    for (const auto& it : private_pools) {
+      const PrivatePool& pool = *it.second;
+      blocks.insert(blocks.end(), pool.small_blocks.blocks.begin(), pool.small_blocks.blocks.end());
+      blocks.insert(blocks.end(), pool.large_blocks.blocks.begin(), pool.large_blocks.blocks.end());
+    }
+    for (const auto& pool : released_private_pools) {
+      blocks.insert(blocks.end(), pool->small_blocks.blocks.begin(), pool->small_blocks.blocks.end());
+      blocks.insert(blocks.end(), pool->large_blocks.blocks.begin(), pool->large_blocks.blocks.end());
+    }
     blocks.insert(blocks.end(), active_blocks.begin(), active_blocks.end());
     return blocks;
   }
 
+  // Interns the stack trace of the current allocation.
+  int64_t current_stack_id() {
+    // skip this frame and malloc
+    std::string stack = c10::get_backtrace(/*frames_to_skip=*/2);
+    auto it = stack_ids.find(stack);
+    if (it == stack_ids.end()) {
+      it = stack_ids.emplace(stack, stacks.size()).first;
+      stacks.push_back(std::move(stack));
+    }
+    return it->second;
+  }
+
+  void record_trace(TraceEntryAction action, const void* ptr, size_t size,
+                    cudaStream_t stream, int64_t stack_id) {
+    if (!record_history) {
+      return;
+    }
+    TraceEntry entry;
+    entry.action = action;
+    entry.address = reinterpret_cast<int64_t>(ptr);
+    entry.size = size;
+    entry.stream = reinterpret_cast<int64_t>(stream);
+    entry.time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+    entry.stack_id = stack_id;
+    if (history.size() < history_max_entries) {
+      history.push_back(entry);
+    } else {
+      history[history_next] = entry;
+      history_next = (history_next + 1) % history_max_entries;
+    }
+  }
+
   /** moves a block into a pool of cached free blocks */
   void free_block(Block* block)
   {
     TORCH_INTERNAL_ASSERT(!block->allocated && block->event_count == 0);
+    block->stack_id = -1;
 
     size_t original_block_size = block->size;
 
@@ -519,7 +907,10 @@ class DeviceCachingAllocator {
     }
 
     active_blocks.erase(block);
-    pool.insert(block);
+    pool.blocks.insert(block);
+    if (pool.owner_PrivatePool) {
+      pool.owner_PrivatePool->allocation_count--;
+    }
 
     if (block->is_split()) {
       net_change_inactive_split_blocks += 1;
@@ -559,13 +950,23 @@ class DeviceCachingAllocator {
 
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
-    pool.erase(src);
+    if (src->expandable_segment && src->expandable_segment->tail == src) {
+      src->expandable_segment->tail = dst;
+    }
+    pool.blocks.erase(src);
     delete src;
 
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
+  BlockPool& get_pool(size_t size, cudaStream_t stream) {
+    if (!stream_to_pool.empty()) {
+      auto it = stream_to_pool.find(stream);
+      if (it != stream_to_pool.end()) {
+        PrivatePool* private_pool = it->second;
+        return (size <= kSmallSize) ? private_pool->small_blocks : private_pool->large_blocks;
+      }
+    }
     if (size <= kSmallSize) {
       return small_blocks;
     } else {
@@ -574,23 +975,15 @@ class DeviceCachingAllocator {
   }
 
   StatType get_stat_type_for_pool(const BlockPool& pool) {
-    if (&pool == &small_blocks) {
-      return StatType::SMALL_POOL;
-    } else if (&pool == &large_blocks) {
-      return StatType::LARGE_POOL;
-    } else {
-      AT_ERROR("get_stat_type_for_pool: invalid pool");
-    }
+    return pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL;
   }
 
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
-    if (block->pool == &small_blocks) {
+    if (block->pool->is_small) {
       return remaining >= kMinBlockSize;
-    } else if (block->pool == &large_blocks) {
-      return remaining > kSmallSize;
     } else {
-      AT_ERROR("should_split: invalid pool");
+      return remaining > kSmallSize;
     }
   }
 
@@ -606,11 +999,11 @@ class DeviceCachingAllocator {
 
   bool get_free_block(AllocParams& p) {
     BlockPool& pool = *p.pool;
-    auto it = pool.lower_bound(&p.search_key);
-    if (it == pool.end() || (*it)->stream != p.stream())
+    auto it = pool.blocks.lower_bound(&p.search_key);
+    if (it == pool.blocks.end() || (*it)->stream != p.stream())
       return false;
     p.block = *it;
-    pool.erase(it);
+    pool.blocks.erase(it);
     return true;
   }
 
@@ -631,6 +1024,10 @@ class DeviceCachingAllocator {
       stats.num_alloc_retries += 1;
     }
 
+    if (CachingAllocatorConfig::expandable_segments()) {
+      return grow_expandable_segment(p);
+    }
+
     p.err = cudaMalloc(&ptr, size);
     if (p.err != cudaSuccess) {
       if (!isRetry || p.err == cudaErrorMemoryAllocation)
@@ -639,12 +1036,130 @@ class DeviceCachingAllocator {
     }
 
     p.block = new Block(p.device(), p.stream(), size, p.pool, (char*)ptr);
+    record_trace(TraceEntryAction::SEGMENT_ALLOC, ptr, size, p.stream(), p.stack_id);
     update_stat_array(stats.segment, 1, p.stat_types);
     update_stat_array(stats.reserved_bytes, size, p.stat_types);
 
     return (p.block != nullptr);
   }
 
+  ExpandableSegment* get_expandable_segment(AllocParams& p) {
+    for (const auto& segment : expandable_segments) {
+      if (segment->stream == p.stream() && segment->pool == p.pool) {
+        return segment.get();
+      }
+    }
+    size_t device_free;
+    size_t device_total;
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+    // Virtual address space is cheap: reserve a bit more than the whole device
+    // so that the segment never needs to move.
+    const size_t page_size = p.pool->is_small ? kSmallBuffer : kLargeBuffer;
+    expandable_segments.emplace_back(new ExpandableSegment(
+      p.device(), p.stream(), p.pool, page_size, device_total + device_total / 8));
+    update_stat_array(stats.segment, 1, p.stat_types);
+    return expandable_segments.back().get();
+  }
+
+  // Maps enough new memory at the end of the (stream, pool) segment to satisfy
+  // p, merging it with the free tail block if there is one.
+  bool grow_expandable_segment(AllocParams& p) {
+    ExpandableSegment* segment = get_expandable_segment(p);
+    Block* tail = segment->tail;
+    const bool tail_free =
+      tail && !tail->allocated && tail->event_count == 0 && tail->size < p.size();
+    const size_t needed = tail_free ? p.size() - tail->size : p.size();
+
+    char* end = segment->ptr() + segment->mapped_size();
+    const size_t grown = segment->grow(needed, &p.err);
+    if (grown == 0) {
+      if (p.err == cudaSuccess) {
+        p.err = cudaErrorMemoryAllocation;
+      }
+      return false;
+    }
+    update_stat_array(stats.reserved_bytes, grown, p.stat_types);
+    record_trace(TraceEntryAction::SEGMENT_MAP, end, grown, p.stream(), p.stack_id);
+
+    if (tail_free) {
+      p.pool->blocks.erase(tail);
+      tail->size += grown;
+      if (tail->is_split()) {
+        // the inactive split block at the tail grows with the segment
+        update_stat_array(stats.inactive_split_bytes, grown, p.stat_types);
+      }
+      p.block = tail;
+      return true;
+    }
+
+    Block* block = new Block(p.device(), p.stream(), grown, p.pool, end);
+    block->expandable_segment = segment;
+    block->prev = tail;
+    if (tail) {
+      tail->next = block;
+    }
+    segment->tail = block;
+    p.block = block;
+    return true;
+  }
+
+  // Unmaps the page-aligned part of each free tail block and releases
+  // segments that end up empty.
+  void release_expandable_segments()
+  {
+    auto it = expandable_segments.begin();
+    while (it != expandable_segments.end()) {
+      ExpandableSegment* segment = it->get();
+      Block* tail = segment->tail;
+      PrivatePool* owner = segment->pool->owner_PrivatePool;
+      const bool releasable = !owner || is_released(owner);
+      if (releasable && tail && !tail->allocated && tail->event_count == 0) {
+        char* base = segment->ptr();
+        const size_t page_size = segment->page_size();
+        const size_t tail_offset = static_cast<char*>(tail->ptr) - base;
+        const size_t new_size = page_size * ((tail_offset + page_size - 1) / page_size);
+        const size_t released = segment->mapped_size() - new_size;
+
+        StatTypes stat_types;
+        stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+        stat_types[static_cast<size_t>(get_stat_type_for_pool(*segment->pool))] = true;
+
+        if (released > 0) {
+          const bool was_split = tail->is_split();
+          segment->pool->blocks.erase(tail);
+          if (new_size == tail_offset) {
+            segment->tail = tail->prev;
+            if (tail->prev) {
+              tail->prev->next = nullptr;
+            }
+            if (was_split) {
+              update_stat_array(stats.inactive_split, -1, stat_types);
+              update_stat_array(stats.inactive_split_bytes, -tail->size, stat_types);
+            }
+            delete tail;
+          } else {
+            tail->size -= released;
+            segment->pool->blocks.insert(tail);
+            if (was_split) {
+              update_stat_array(stats.inactive_split_bytes, -released, stat_types);
+            }
+          }
+          segment->unmap_to(new_size);
+          record_trace(TraceEntryAction::SEGMENT_UNMAP, base + new_size, released,
+                       segment->stream, -1);
+          update_stat_array(stats.reserved_bytes, -released, stat_types);
+        }
+
+        if (segment->mapped_size() == 0) {
+          update_stat_array(stats.segment, -1, stat_types);
+          it = expandable_segments.erase(it);
+          continue;
+        }
+      }
+      ++it;
+    }
+  }
+
   bool free_cached_blocks()
   {
     // First ensure that all blocks that can't currently be allocated due to
@@ -654,17 +1169,65 @@ class DeviceCachingAllocator {
     // Free all non-split cached blocks
     free_blocks(large_blocks);
     free_blocks(small_blocks);
+    for (const auto& pool : released_private_pools) {
+      free_blocks(pool->large_blocks);
+      free_blocks(pool->small_blocks);
+    }
+    release_expandable_segments();
+    release_idle_private_pools();
     return true;
   }
 
-  void free_blocks(BlockPool& blocks)
+  bool is_released(const PrivatePool* pool) const {
+    for (const auto& released : released_private_pools) {
+      if (released.get() == pool) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Frees the memory of released private pools with no live allocations.
+  void release_idle_private_pools()
+  {
+    if (released_private_pools.empty()) {
+      return;
+    }
+    bool freed_any = false;
+    for (const auto& pool : released_private_pools) {
+      if (pool->allocation_count == 0) {
+        free_blocks(pool->large_blocks);
+        free_blocks(pool->small_blocks);
+        freed_any = true;
+      }
+    }
+    if (!freed_any) {
+      return;
+    }
+    release_expandable_segments();
+    auto it = released_private_pools.begin();
+    while (it != released_private_pools.end()) {
+      PrivatePool* pool = it->get();
+      if (pool->allocation_count == 0) {
+        TORCH_INTERNAL_ASSERT(pool->large_blocks.blocks.empty() && pool->small_blocks.blocks.empty());
+        it = released_private_pools.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void free_blocks(BlockPool& pool)
   {
     // Frees all non-split blocks
+    auto& blocks = pool.blocks;
     auto it = blocks.begin();
     while (it != blocks.end()) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
+      if (!block->prev && !block->next && !block->expandable_segment) {
+        ipc_mem_handles.erase(block->ptr);
         C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+        record_trace(TraceEntryAction::SEGMENT_FREE, block->ptr, block->size, block->stream, -1);
 
         StatTypes stat_types;
         stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
@@ -763,9 +1326,9 @@ class DeviceCachingAllocator {
   }
 
   // Accumulates sizes of all memory blocks for given device in given pool
-  void cache_info_aux(BlockPool& blocks, size_t* total, size_t* largest)
+  void cache_info_aux(const BlockPool& pool, size_t* total, size_t* largest)
   {
-    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+    for (auto it = pool.blocks.begin(); it != pool.blocks.end(); ++it) {
       size_t blocksize = (*it)->size;
       *total += blocksize;
       if (blocksize > *largest) {
@@ -861,6 +1424,15 @@ class THCCachingAllocator {
     return device_allocator[block->device]->getBaseAllocation(block, outSize);
   }
 
+  std::string getIpcMemHandle(void* ptr)
+  {
+    Block* block = get_allocated_block(ptr);
+    if (!block) {
+      AT_ERROR("invalid device pointer: ", ptr);
+    }
+    return device_allocator[block->device]->getIpcMemHandle(block);
+  }
+
   void recordStream(const DataPtr& ptr, cuda::CUDAStream stream) {
     // Empty tensor's storage().data() might be a null ptr. As there is no
     // blocks associated with those tensors, it is fine to do nothing here.
@@ -925,10 +1497,6 @@ void init(int device_count) {
   caching_allocator.init(device_count);
 }
 
-void emptyCache(void) {
-  caching_allocator.emptyCache();
-}
-
 void cacheInfo(int dev_id, size_t* cachedAndFree, size_t* largestBlock) {
   caching_allocator.device_allocator[dev_id]->cacheInfo(cachedAndFree, largestBlock);
 }
@@ -938,21 +1506,46 @@ void* getBaseAllocation(void *ptr, size_t *size)
   return caching_allocator.getBaseAllocation(ptr, size);
 }
 
+std::string getIpcMemHandle(void* ptr)
+{
+  return caching_allocator.getIpcMemHandle(ptr);
+}
+
+static inline void assertValidDevice(int device) {
+  int device_num = device_count();
+  AT_ASSERTM(0 <= device && device < device_num, "Invalid device argument.");
+}
+
 void recordStream(const DataPtr& ptr, cuda::CUDAStream stream)
 {
   caching_allocator.recordStream(ptr, stream);
 }
 
+MempoolId_t createPoolId() {
+  static std::atomic<MempoolId_t> next_pool_id(1);
+  return next_pool_id++;
+}
+
+void beginAllocateStreamToPool(int device, cudaStream_t stream, MempoolId_t pool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->beginAllocateStreamToPool(stream, pool_id);
+}
+
+void endAllocateStreamToPool(int device, cudaStream_t stream) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->endAllocateStreamToPool(stream);
+}
+
+void releasePool(int device, MempoolId_t pool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->releasePool(pool_id);
+}
+
 std::mutex* getFreeMutex()
 {
   return caching_allocator.getCudaFreeMutex();
 }
 
-static inline void assertValidDevice(int device) {
-  int device_num = device_count();
-  AT_ASSERTM(0 <= device && device < device_num, "Invalid device argument.");
-}
-
 DeviceStats getDeviceStats(int device) {
   assertValidDevice(device);
   return caching_allocator.device_allocator[device]->getStats();
@@ -972,6 +1565,17 @@ std::vector<SegmentInfo> snapshot() {
   return caching_allocator.snapshot();
 }
 
+void recordHistory(bool enabled, bool record_stacks, size_t max_entries) {
+  for (auto& allocator : caching_allocator.device_allocator) {
+    allocator->recordHistory(enabled, record_stacks, max_entries);
+  }
+}
+
+AllocatorHistory getHistory(int device) {
+  assertValidDevice(device);
+  return caching_allocator.device_allocator[device]->getHistory();
+}
+
 //
 // In CUDA IPC, sender sends a tensor to receiver, getIpcDevPtr
 // is called by the receiving process to map the CUDA memory from the sending
@@ -988,18 +1592,60 @@ std::vector<SegmentInfo> snapshot() {
 // will be used to reconstruct all storages in this CudaMalloc allocation.
 // And it will deleted in cudaIpcCloseMemHandle when its reference count is 0.
 //
+// A producer sending tensors every iteration mostly sends blocks of the same
+// few allocations, which its caching allocator hands out again. So that these
+// don't get opened and closed on every iteration, the most recently used
+// device pointers are kept open in ipcRecentDevPtrs() after their last storage
+// is gone, until they are pushed out or emptyCache() is called.
+//
 namespace {
   std::mutex IpcMutex;
   std::unordered_map<std::string, std::weak_ptr<void>> ipcMemHandle_to_devptr;
+  constexpr size_t kNumRecentIpcDevPtrs = 16;
+
+  // Leaked, so that the device pointers don't get closed during static
+  // destruction, when the CUDA runtime may be gone already
+  std::deque<std::shared_ptr<void>>& ipcRecentDevPtrs() {
+    static auto* devptrs = new std::deque<std::shared_ptr<void>>();
+    return *devptrs;
+  }
+
+  // Returns the device pointer that no longer fits in ipcRecentDevPtrs, if
+  // any. It must be released after IpcMutex, which its deleter takes.
+  std::shared_ptr<void> markIpcDevPtrUsed(const std::shared_ptr<void>& devptr) {
+    auto& recent = ipcRecentDevPtrs();
+    auto it = std::find(recent.begin(), recent.end(), devptr);
+    if (it != recent.end()) {
+      recent.erase(it);
+    }
+    recent.push_front(devptr);
+    std::shared_ptr<void> evicted;
+    if (recent.size() > kNumRecentIpcDevPtrs) {
+      evicted = std::move(recent.back());
+      recent.pop_back();
+    }
+    return evicted;
+  }
+
+  void releaseRecentIpcDevPtrs() {
+    std::deque<std::shared_ptr<void>> released;
+    std::lock_guard<std::mutex> lock(IpcMutex);
+    released.swap(ipcRecentDevPtrs());
+  }
 }
 
 std::shared_ptr<void> getIpcDevPtr(std::string handle) {
+  // Declared before the lock, so that it's released after it
+  std::shared_ptr<void> evicted;
   std::lock_guard<std::mutex> lock(IpcMutex);
 
   auto iter = ipcMemHandle_to_devptr.find(handle);
   if (iter != ipcMemHandle_to_devptr.end()) {
     auto devptr = iter->second.lock();
-    if (devptr) return devptr;
+    if (devptr) {
+      evicted = markIpcDevPtrUsed(devptr);
+      return devptr;
+    }
   }
   // This ipcMemHandle hasn't been opened, or already expired, open it to
   // enable IPC access to that mem block.
@@ -1022,10 +1668,16 @@ std::shared_ptr<void> getIpcDevPtr(std::string handle) {
   // But in the deleter for sp we erased the entry,
   // this should be safe to do now.
   ipcMemHandle_to_devptr.insert(iter, {handle, wp});
+  evicted = markIpcDevPtrUsed(sp);
 
   return sp;
 }
 
+void emptyCache(void) {
+  releaseRecentIpcDevPtrs();
+  caching_allocator.emptyCache();
+}
+
 void* raw_alloc(size_t nbytes) {
   if (nbytes == 0) {
     return nullptr;
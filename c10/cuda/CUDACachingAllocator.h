@@ -8,6 +8,8 @@
 
 #include <array>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace c10 {
 
@@ -92,6 +94,9 @@ struct BlockInfo {
   int64_t size = 0;
   bool allocated = false;
   bool active = false;
+  // index of the stack trace of the allocation in the AllocatorHistory::stacks
+  // of the device, or -1 if the allocator wasn't recording stacks then
+  int64_t stack_id = -1;
 };
 
 // Struct containing info of a memory segment (i.e. one contiguous cudaMalloc).
@@ -102,9 +107,42 @@ struct SegmentInfo {
   int64_t allocated_size = 0;
   int64_t active_size = 0;
   bool is_large = false;
+  bool is_expandable = false;
   std::vector<BlockInfo> blocks;
 };
 
+// Kinds of events in the allocation history.
+enum struct TraceEntryAction : uint8_t {
+  ALLOC,          // a block was handed out by malloc
+  FREE,           // a block was freed by the client (it may stay active until
+                  // the streams that used it are done)
+  SEGMENT_ALLOC,  // a segment was allocated with cudaMalloc
+  SEGMENT_FREE,   // a segment was released with cudaFree
+  SEGMENT_MAP,    // memory was mapped at the end of an expandable segment
+  SEGMENT_UNMAP,  // memory was unmapped from the end of an expandable segment
+  OOM             // an allocation failed, size is the requested size
+};
+
+// Struct containing an event of the allocation history of a device.
+struct TraceEntry {
+  TraceEntryAction action;
+  int64_t address = 0;
+  int64_t size = 0;
+  int64_t stream = 0;
+  // microseconds since the epoch of std::chrono::steady_clock
+  int64_t time_us = 0;
+  // index of the stack trace in AllocatorHistory::stacks, or -1
+  int64_t stack_id = -1;
+};
+
+// Struct containing the allocation history of a device.
+struct AllocatorHistory {
+  // the most recent events, oldest first
+  std::vector<TraceEntry> entries;
+  // the distinct stack traces of the entries and of the blocks in snapshot()
+  std::vector<std::string> stacks;
+};
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void* raw_alloc_with_stream(size_t nbytes, cudaStream_t stream);
 C10_CUDA_API void raw_delete(void* ptr);
@@ -114,12 +152,55 @@ C10_CUDA_API void init(int device_count);
 C10_CUDA_API void emptyCache();
 C10_CUDA_API void cacheInfo(int dev_id, size_t* cachedAndFree, size_t* largestBlock);
 C10_CUDA_API void* getBaseAllocation(void *ptr, size_t *size);
+// Returns the cudaIpcMemHandle_t, as bytes, of the cudaMalloc allocation that
+// ptr is in. The handle is computed once per allocation.
+C10_CUDA_API std::string getIpcMemHandle(void* ptr);
 C10_CUDA_API void recordStream(const DataPtr&, CUDAStream stream);
 C10_CUDA_API DeviceStats getDeviceStats(int device);
 C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
 C10_CUDA_API std::vector<SegmentInfo> snapshot();
 
+// Opt-in recorder of allocator events, for finding out what fragments memory
+// or exhausts it. While enabled, each device keeps its most recent
+// max_entries events in a ring buffer. Recording stack traces is slower,
+// since each allocation symbolizes the stack it comes from; without them an
+// event costs a few stores. Changing the settings drops the recorded events,
+// but not the stack traces, which the blocks in snapshot() may still refer to.
+C10_CUDA_API void recordHistory(bool enabled, bool record_stacks, size_t max_entries);
+C10_CUDA_API AllocatorHistory getHistory(int device);
+
+// Private memory pools. While a stream is routed to a pool with
+// beginAllocateStreamToPool, every allocation made on that stream is served
+// from and cached in that pool only, so a region of code that allocates the
+// same sizes on each run gets the same addresses back. A pool keeps its memory
+// across emptyCache() until releasePool(), which frees it as soon as all the
+// allocations it served have been freed.
+typedef uint64_t MempoolId_t;
+
+C10_CUDA_API MempoolId_t createPoolId();
+C10_CUDA_API void beginAllocateStreamToPool(int device, cudaStream_t stream, MempoolId_t pool_id);
+C10_CUDA_API void endAllocateStreamToPool(int device, cudaStream_t stream);
+C10_CUDA_API void releasePool(int device, MempoolId_t pool_id);
+
+// RAII guard that routes allocations on a stream to a private pool for the
+// lifetime of the guard.
+struct PrivatePoolGuard {
+  PrivatePoolGuard(int device, cudaStream_t stream, MempoolId_t pool_id)
+      : device_(device), stream_(stream) {
+    beginAllocateStreamToPool(device_, stream_, pool_id);
+  }
+  ~PrivatePoolGuard() {
+    endAllocateStreamToPool(device_, stream_);
+  }
+  PrivatePoolGuard(const PrivatePoolGuard&) = delete;
+  PrivatePoolGuard& operator=(const PrivatePoolGuard&) = delete;
+
+ private:
+  int device_;
+  cudaStream_t stream_;
+};
+
 C10_CUDA_API std::mutex* getFreeMutex();
 
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
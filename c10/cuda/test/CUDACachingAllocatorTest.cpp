@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAFunctions.h>
+
+using namespace c10::cuda;
+
+namespace {
+
+int64_t reservedBytes(int device) {
+  const auto stats = CUDACachingAllocator::getDeviceStats(device);
+  return stats.reserved_bytes[static_cast<size_t>(CUDACachingAllocator::StatType::AGGREGATE)].current;
+}
+
+} // namespace
+
+TEST(CUDACachingAllocatorTest, PrivatePoolReusesAddresses) {
+  if (device_count() == 0) {
+    return;
+  }
+  const int device = 0;
+  CUDACachingAllocator::init(device_count());
+  CUDAStream stream = getStreamFromPool(false, device);
+  const auto pool_id = CUDACachingAllocator::createPoolId();
+
+  std::vector<void*> first;
+  std::vector<void*> second;
+  for (auto* ptrs : {&first, &second}) {
+    CUDACachingAllocator::PrivatePoolGuard guard(device, stream.stream(), pool_id);
+    for (size_t nbytes : {512, 4096, 3 << 20, 30 << 20}) {
+      ptrs->push_back(CUDACachingAllocator::raw_alloc_with_stream(nbytes, stream.stream()));
+    }
+    for (void* ptr : *ptrs) {
+      CUDACachingAllocator::raw_delete(ptr);
+    }
+  }
+  ASSERT_EQ(first, second);
+
+  // emptyCache() must leave the private pool alone...
+  const int64_t reserved = reservedBytes(device);
+  CUDACachingAllocator::emptyCache();
+  ASSERT_EQ(reservedBytes(device), reserved);
+
+  // ...while releasePool() returns its memory to the device.
+  CUDACachingAllocator::releasePool(device, pool_id);
+  ASSERT_LT(reservedBytes(device), reserved);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CachingCPUAllocator.h>
+
+#include <thread>
+
+using namespace c10;
+
+TEST(CachingCPUAllocatorTest, ReusesFreedBlocks) {
+  auto* allocator = GetCachingCPUAllocator();
+  void* first = nullptr;
+  {
+    auto data = allocator->allocate(1000);
+    first = data.get();
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % gAlignment, 0);
+  }
+  // 1000 and 1024 bytes share a size class, so the block is recycled.
+  auto data = allocator->allocate(1024);
+  ASSERT_EQ(data.get(), first);
+}
+
+TEST(CachingCPUAllocatorTest, LargeAllocationsBypassCache) {
+  auto* allocator = GetCachingCPUAllocator();
+  allocator->emptyCache();
+  {
+    auto data = allocator->allocate(CachingCPUAllocator::kMaxCachedSize + 1);
+    ASSERT_NE(data.get(), nullptr);
+  }
+  allocator->emptyCache();
+  ASSERT_EQ(allocator->cachedBytes(), 0);
+}
+
+TEST(CachingCPUAllocatorTest, ThreadExitReturnsBlocksToCentralCache) {
+  auto* allocator = GetCachingCPUAllocator();
+  allocator->emptyCache();
+  std::thread([&] {
+    auto a = allocator->allocate(64);
+    auto b = allocator->allocate(4096);
+  }).join();
+  ASSERT_EQ(allocator->cachedBytes(), 64 + 4096);
+
+  // Blocks freed by one thread are reused by another.
+  auto data = allocator->allocate(4096);
+  ASSERT_EQ(allocator->cachedBytes(), 64);
+  allocator->emptyCache();
+  ASSERT_EQ(allocator->cachedBytes(), 0);
+}
+
+TEST(CachingCPUAllocatorTest, ZeroSizedAllocation) {
+  auto data = GetCachingCPUAllocator()->allocate(0);
+  ASSERT_EQ(data.get(), nullptr);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/InferenceMode.h>
+#include <c10/core/TensorImpl.h>
+
+using namespace c10;
+
+static bool autograd_excluded() {
+  return impl::tls_is_dispatch_key_excluded(DispatchKey::Autograd);
+}
+
+TEST(InferenceModeTest, Guard) {
+  ASSERT_FALSE(InferenceMode::is_enabled());
+  ASSERT_FALSE(autograd_excluded());
+  {
+    InferenceMode guard;
+    ASSERT_TRUE(InferenceMode::is_enabled());
+    ASSERT_TRUE(autograd_excluded());
+    {
+      InferenceMode inner_guard(false);
+      ASSERT_FALSE(InferenceMode::is_enabled());
+      ASSERT_FALSE(autograd_excluded());
+    }
+    ASSERT_TRUE(InferenceMode::is_enabled());
+    ASSERT_TRUE(autograd_excluded());
+  }
+  ASSERT_FALSE(InferenceMode::is_enabled());
+  ASSERT_FALSE(autograd_excluded());
+}
+
+TEST(InferenceModeTest, KeepsOuterAutogradExclusion) {
+  impl::ExcludeDispatchKeyGuard non_variable_guard(DispatchKey::Autograd);
+  {
+    InferenceMode guard;
+    ASSERT_TRUE(autograd_excluded());
+  }
+  ASSERT_TRUE(autograd_excluded());
+  ASSERT_FALSE(InferenceMode::is_enabled());
+}
+
+TEST(InferenceModeTest, DisabledVersionCounter) {
+  VariableVersion disabled(VariableVersion::DISABLED);
+  ASSERT_FALSE(disabled.enabled());
+  ASSERT_EQ(disabled.current_version(), 0);
+  ASSERT_ANY_THROW(disabled.bump());
+
+  VariableVersion version;
+  ASSERT_TRUE(version.enabled());
+  version.bump();
+  ASSERT_EQ(version.current_version(), 1);
+}
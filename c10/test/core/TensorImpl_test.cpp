@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/TensorImpl.h>
+
+#include <thread>
+
+using namespace c10;
+
+static c10::intrusive_ptr<TensorImpl> make_impl() {
+  return c10::make_intrusive<TensorImpl>(
+      DispatchKeySet(DispatchKey::CPU),
+      caffe2::TypeMeta::Make<float>(),
+      c10::nullopt);
+}
+
+namespace {
+struct LargerTensorImpl : public TensorImpl {
+  LargerTensorImpl()
+      : TensorImpl(
+            DispatchKeySet(DispatchKey::CPU),
+            caffe2::TypeMeta::Make<float>(),
+            c10::nullopt) {}
+  int64_t extra[4] = {1, 2, 3, 4};
+};
+} // namespace
+
+#if !defined(__SANITIZE_ADDRESS__)
+TEST(TensorImplTest, ReusesFreedTensorImpls) {
+  auto impl = make_impl();
+  const void* address = impl.get();
+  impl.reset();
+  impl = make_impl();
+  ASSERT_EQ(impl.get(), address);
+}
+#endif
+
+TEST(TensorImplTest, FreesAcrossThreads) {
+  auto impl = make_impl();
+  auto larger = c10::make_intrusive<LargerTensorImpl>();
+  std::thread([&] {
+    impl.reset();
+    larger.reset();
+    for (int i = 0; i < 1000; ++i) {
+      make_impl();
+    }
+  }).join();
+  ASSERT_FALSE(impl);
+  auto other = c10::make_intrusive<LargerTensorImpl>();
+  ASSERT_EQ(other->extra[3], 4);
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/thread_pool.h>
+
+#include <atomic>
+#include <future>
+
+using namespace c10;
+
+TEST(ThreadPoolTest, RunPendingTaskOutsidePool) {
+  ThreadPool pool(1);
+  ASSERT_FALSE(pool.runPendingTask());
+}
+
+TEST(ThreadPoolTest, NestedWaitOnSingleThread) {
+  // With a single thread, the outer task can only finish if it runs the
+  // inner one itself.
+  ThreadPool pool(1);
+  std::promise<bool> outer_done;
+  pool.run([&]() {
+    std::atomic<bool> inner_done{false};
+    pool.run([&]() { inner_done = true; });
+    while (!inner_done) {
+      if (!pool.runPendingTask()) {
+        std::this_thread::yield();
+      }
+    }
+    outer_done.set_value(pool.runPendingTask());
+  });
+  // The queue was drained by the outer task.
+  ASSERT_FALSE(outer_done.get_future().get());
+  pool.waitWorkComplete();
+}
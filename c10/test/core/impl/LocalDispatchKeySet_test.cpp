@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/impl/LocalDispatchKeySet.h>
+
+using namespace c10;
+using namespace c10::impl;
+
+// The uncached computation the dispatcher used to do on every call.
+static DispatchKeySet expected(DispatchKeySet ks) {
+  auto local = tls_local_dispatch_key_set();
+  return (ks | local.included_ | always_included) - local.excluded_;
+}
+
+static const DispatchKeySet cpu_tensor{DispatchKey::CPU};
+
+TEST(LocalDispatchKeySetTest, Default) {
+  auto local = tls_local_dispatch_key_set();
+  ASSERT_EQ(local.forced_, always_included);
+  ASSERT_EQ(local.apply(cpu_tensor), expected(cpu_tensor));
+}
+
+TEST(LocalDispatchKeySetTest, Guards) {
+  {
+    IncludeDispatchKeyGuard include_guard(DispatchKey::Tracer);
+    ASSERT_TRUE(tls_local_dispatch_key_set().forced_.has(DispatchKey::Tracer));
+    ASSERT_EQ(tls_local_dispatch_key_set().apply(cpu_tensor), expected(cpu_tensor));
+    {
+      ExcludeDispatchKeyGuard exclude_guard(DispatchKey::Autograd);
+      auto local = tls_local_dispatch_key_set();
+      ASSERT_FALSE(local.forced_.has(DispatchKey::Autograd));
+      ASSERT_TRUE(local.forced_.has(DispatchKey::Tracer));
+      ASSERT_EQ(local.apply(cpu_tensor), expected(cpu_tensor));
+    }
+    ASSERT_TRUE(tls_local_dispatch_key_set().forced_.has(DispatchKey::Autograd));
+  }
+  ASSERT_EQ(tls_local_dispatch_key_set().forced_, always_included);
+}
+
+TEST(LocalDispatchKeySetTest, ExcludedTensorKey) {
+  ExcludeDispatchKeyGuard exclude_guard(DispatchKey::CPU);
+  auto local = tls_local_dispatch_key_set();
+  ASSERT_FALSE(local.apply(cpu_tensor).has(DispatchKey::CPU));
+  ASSERT_EQ(local.apply(cpu_tensor), expected(cpu_tensor));
+}
+
+TEST(LocalDispatchKeySetTest, NonRAII) {
+  tls_set_dispatch_key_excluded(DispatchKey::BackendSelect, true);
+  ASSERT_FALSE(tls_local_dispatch_key_set().forced_.has(DispatchKey::BackendSelect));
+  tls_set_dispatch_key_excluded(DispatchKey::BackendSelect, false);
+  ASSERT_EQ(tls_local_dispatch_key_set().forced_, always_included);
+}
+
+TEST(LocalDispatchKeySetTest, Force) {
+  auto saved = tls_local_dispatch_key_set();
+  {
+    IncludeDispatchKeyGuard include_guard(DispatchKey::Tracer);
+    ExcludeDispatchKeyGuard exclude_guard(DispatchKey::Autograd);
+    auto inner = tls_local_dispatch_key_set();
+    _force_tls_local_dispatch_key_set(saved);
+    ASSERT_EQ(tls_local_dispatch_key_set().forced_, always_included);
+    _force_tls_local_dispatch_key_set(inner);
+    ASSERT_EQ(tls_local_dispatch_key_set().forced_, inner.forced_);
+    ASSERT_EQ(tls_local_dispatch_key_set().apply(cpu_tensor), expected(cpu_tensor));
+  }
+  ASSERT_EQ(tls_local_dispatch_key_set().forced_, always_included);
+}
@@ -1 +1,36 @@
 #include <c10/util/intrusive_ptr.h>
+
+namespace c10 {
+
+namespace {
+std::atomic<uint64_t>& refcountUpdates() {
+  static std::atomic<uint64_t> count{0};
+  return count;
+}
+} // namespace
+
+bool refcountStatsEnabled() {
+#ifdef USE_REFCOUNT_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint64_t getRefcountUpdates() {
+  return refcountUpdates().load(std::memory_order_relaxed);
+}
+
+void resetRefcountUpdates() {
+  refcountUpdates().store(0, std::memory_order_relaxed);
+}
+
+#ifdef USE_REFCOUNT_STATS
+namespace detail {
+void recordRefcountUpdate() {
+  refcountUpdates().fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace detail
+#endif
+
+} // namespace c10
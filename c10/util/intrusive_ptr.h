@@ -6,6 +6,19 @@
 #include <stdexcept>
 
 namespace c10 {
+
+// Counters of the atomic refcount updates done by intrusive_ptr and
+// weak_intrusive_ptr, to measure how many an operation costs.  Only builds
+// with USE_REFCOUNT_STATS count them; the getter returns 0 otherwise.
+C10_API bool refcountStatsEnabled();
+C10_API uint64_t getRefcountUpdates();
+C10_API void resetRefcountUpdates();
+#ifdef USE_REFCOUNT_STATS
+namespace detail {
+C10_API void recordRefcountUpdate();
+}
+#endif
+
 class intrusive_ptr_target;
 namespace raw {
   namespace weak_intrusive_ptr {
@@ -184,6 +197,9 @@ class intrusive_ptr final {
 
   void retain_() {
     if (target_ != NullType::singleton()) {
+#ifdef USE_REFCOUNT_STATS
+      detail::recordRefcountUpdate();
+#endif
       size_t new_refcount = ++target_->refcount_;
       TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
           new_refcount != 1,
@@ -192,6 +208,11 @@ class intrusive_ptr final {
   }
 
   void reset_() noexcept {
+#ifdef USE_REFCOUNT_STATS
+    if (target_ != NullType::singleton()) {
+      detail::recordRefcountUpdate();
+    }
+#endif
     if (target_ != NullType::singleton() && --target_->refcount_ == 0) {
       // justification for const_cast: release_resources is basically a destructor
       // and a destructor always mutates the object, even for const objects.
@@ -441,6 +462,9 @@ class weak_intrusive_ptr final {
 
   void retain_() {
     if (target_ != NullType::singleton()) {
+#ifdef USE_REFCOUNT_STATS
+      detail::recordRefcountUpdate();
+#endif
       size_t new_weakcount = ++target_->weakcount_;
       TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
           new_weakcount != 1,
@@ -449,6 +473,11 @@ class weak_intrusive_ptr final {
   }
 
   void reset_() noexcept {
+#ifdef USE_REFCOUNT_STATS
+    if (target_ != NullType::singleton()) {
+      detail::recordRefcountUpdate();
+    }
+#endif
     if (target_ != NullType::singleton() && --target_->weakcount_ == 0) {
       delete target_;
     }
@@ -21,6 +21,12 @@ C10_DEFINE_bool(
     false,
     "Serialize FLOAT16 tensors using byte_data field");
 
+C10_DEFINE_bool(
+    caffe2_serialize_float_as_bytes,
+    false,
+    "Serialize FLOAT tensors as their raw bytes in the byte_data field, "
+    "which skips the float_data repeated field");
+
 C10_DEFINE_bool(
     caffe2_serialize_using_bytes_as_holder,
     false,
@@ -164,8 +170,13 @@ void TensorSerializer::SerializeWithChunkSize(
   };
   std::vector<std::future<void>> futures;
   if (tensor.numel() > chunk_size) {
-    futures.reserve(FLAGS_caffe2_max_tensor_serializer_threads);
-    for (int i = 0; i < FLAGS_caffe2_max_tensor_serializer_threads; ++i) {
+    // No more threads than chunks, the extra ones would only be started
+    // and joined
+    const int64_t numChunks = (tensor.numel() + chunk_size - 1) / chunk_size;
+    const int numThreads = static_cast<int>(std::min<int64_t>(
+        FLAGS_caffe2_max_tensor_serializer_threads, numChunks));
+    futures.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
       futures.emplace_back(std::async(std::launch::async, task));
     }
   }
@@ -218,6 +229,25 @@ static bool EnableByteEncoding(
   return ret;
 }
 
+// Copies the raw bytes of the chunk straight into the byte_data field,
+// without an intermediate buffer
+template <typename S>
+static void SerializeAsBytes(
+    const Tensor& input,
+    size_t chunkBegin,
+    int32_t chunkSize,
+    BaseContext* context,
+    TensorProto& proto) {
+  const auto bufSize = sizeof(S) * chunkSize;
+  string* byteData = proto.mutable_byte_data();
+  byteData->resize(bufSize);
+  context->template CopyToCPU<uint8_t>(
+      bufSize,
+      reinterpret_cast<const uint8_t*>(input.template data<S>() + chunkBegin),
+      reinterpret_cast<uint8_t*>(&(*byteData)[0]));
+  context->FinishDeviceComputation();
+}
+
 template <typename T, typename S = T>
 static void SerializeUsingBytesOrInt32(
     const Tensor& input,
@@ -228,13 +258,7 @@ static void SerializeUsingBytesOrInt32(
     TensorProto& proto) {
   const auto typeSize = sizeof(T);
   if (EnableByteEncoding(dataType, typeSize)) {
-    const auto bufSize = typeSize * chunkSize;
-    auto* byteData =
-        reinterpret_cast<const uint8_t*>(input.template data<S>() + chunkBegin);
-    unique_ptr<uint8_t[]> buffer(new uint8_t[bufSize]);
-    context->template CopyToCPU<uint8_t>(bufSize, byteData, buffer.get());
-    context->FinishDeviceComputation();
-    proto.set_byte_data(buffer.release(), bufSize);
+    SerializeAsBytes<S>(input, chunkBegin, chunkSize, context, proto);
   } else {
     detail::CopyToProtoWithCast(
         chunkSize,
@@ -290,11 +314,16 @@ void TensorSerializer::Serialize(
   // A lot of copypaste is error prone. Should we create a macro for this?
   switch (data_type) {
     case TensorProto_DataType_FLOAT:
-      detail::CopyToProtoAsIs(
-          chunkSize,
-          input.template data<float>() + chunkBegin,
-          proto.mutable_float_data(),
-          uniq_ptr.get());
+      if (kIsLittleEndian && FLAGS_caffe2_serialize_float_as_bytes) {
+        SerializeAsBytes<float>(
+            input, chunkBegin, chunkSize, uniq_ptr.get(), proto);
+      } else {
+        detail::CopyToProtoAsIs(
+            chunkSize,
+            input.template data<float>() + chunkBegin,
+            proto.mutable_float_data(),
+            uniq_ptr.get());
+      }
       break;
     case TensorProto_DataType_INT32:
       detail::CopyToProtoAsIs(
@@ -575,11 +604,26 @@ void TensorDeserializer::DeserializeToTensor(
 
   switch (tensor_proto.data_type()) {
     case TensorProto_DataType_FLOAT:
-      detail::CopyFromProtoAsIs(
-          chunkSize,
-          tensor_proto.float_data(),
-          tensor->template mutable_data<float>() + chunkBegin,
-          context);
+      if (tensor_proto.has_byte_data()) {
+        // See caffe2_serialize_float_as_bytes
+        CAFFE_ENFORCE(
+            kIsLittleEndian,
+            "Serialization with bytes not supported on big endian platform.");
+        CAFFE_ENFORCE_EQ(
+            sizeof(float) * chunkSize,
+            tensor_proto.byte_data().size(),
+            "Incorrect proto field size.");
+        context->template CopyFromCPU<float>(
+            chunkSize,
+            reinterpret_cast<const float*>(tensor_proto.byte_data().data()),
+            tensor->template mutable_data<float>() + chunkBegin);
+      } else {
+        detail::CopyFromProtoAsIs(
+            chunkSize,
+            tensor_proto.float_data(),
+            tensor->template mutable_data<float>() + chunkBegin,
+            context);
+      }
       break;
     case TensorProto_DataType_INT32:
       detail::CopyFromProtoAsIs(
@@ -22,6 +22,7 @@
 C10_DEFINE_int64(caffe2_test_big_tensor_size, 100000000, "");
 C10_DECLARE_int(caffe2_tensor_chunk_size);
 C10_DECLARE_bool(caffe2_serialize_fp16_as_bytes);
+C10_DECLARE_bool(caffe2_serialize_float_as_bytes);
 C10_DECLARE_bool(caffe2_serialize_using_bytes_as_holder);
 
 namespace caffe2 {
@@ -748,6 +749,46 @@ TEST(TensorTest, Half) {
   }
 }
 
+TEST(TensorTest, FloatAsBytes) {
+  const int64_t kSize = 2500;
+  const int kChunkSize = 1000;
+  Blob blob;
+  TensorCPU* tensor = BlobGetMutableTensor(&blob, CPU);
+  tensor->Resize(kSize);
+  for (int i = 0; i < kSize; ++i) {
+    tensor->mutable_data<float>()[i] = i * 0.5f - 7.0f;
+  }
+  const bool float_as_bytes = FLAGS_caffe2_serialize_float_as_bytes;
+  FLAGS_caffe2_serialize_float_as_bytes = true;
+  std::mutex mutex;
+  std::vector<string> chunks;
+  auto acceptor = [&](const std::string& /*key*/, const std::string& value) {
+    std::lock_guard<std::mutex> guard(mutex);
+    chunks.push_back(value);
+  };
+  SerializeBlob(blob, "test", acceptor, kChunkSize);
+  FLAGS_caffe2_serialize_float_as_bytes = float_as_bytes;
+  EXPECT_EQ(chunks.size(), 3u);
+
+  Blob new_blob;
+  for (const auto& chunk : chunks) {
+    BlobProto proto;
+    CHECK(proto.ParseFromString(chunk));
+    const TensorProto& tensor_proto = proto.tensor();
+    const auto& segment = tensor_proto.segment();
+    EXPECT_EQ(tensor_proto.float_data_size(), 0);
+    EXPECT_EQ(
+        tensor_proto.byte_data().size(),
+        sizeof(float) * (segment.end() - segment.begin()));
+    EXPECT_NO_THROW(DeserializeBlob(chunk, &new_blob));
+  }
+  const TensorCPU& new_tensor = new_blob.Get<TensorCPU>();
+  EXPECT_EQ(new_tensor.numel(), kSize);
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(new_tensor.data<float>()[i], i * 0.5f - 7.0f);
+  }
+}
+
 TEST(TensorTest, TensorFactory) {
   Tensor a = empty({1, 2, 3}, at::device(CPU).dtype<float>());
   EXPECT_NE(a.data<float>(), nullptr);
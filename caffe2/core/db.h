@@ -228,16 +228,25 @@ class CAFFE2_API DBReader {
   void Read(string* key, string* value) const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
-    *key = cursor_->key();
-    *value = cursor_->value();
+    ReadAndAdvance(key, value);
+  }
 
-    // In sharded mode, each read skips num_shards_ records
-    for (uint32_t s = 0; s < num_shards_; s++) {
-      cursor_->Next();
-      if (!cursor_->Valid()) {
-        MoveToBeginning();
-        break;
-      }
+  /**
+   * Reads the next count sets of key and value, as if by calling Read()
+   * count times, but taking the lock only once. Thread safe.
+   *
+   * This is cheaper when several readers share a db, and keeps the records
+   * of a batch contiguous in the db.
+   */
+  void Read(int64_t count, vector<string>* keys, vector<string>* values)
+      const {
+    CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+    CAFFE_ENFORCE_GE(count, 0);
+    keys->resize(count);
+    values->resize(count);
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    for (int64_t i = 0; i < count; ++i) {
+      ReadAndAdvance(&(*keys)[i], &(*values)[i]);
     }
   }
 
@@ -274,6 +283,21 @@ class CAFFE2_API DBReader {
     SeekToFirst();
   }
 
+  // Requires reader_mutex_.
+  void ReadAndAdvance(string* key, string* value) const {
+    *key = cursor_->key();
+    *value = cursor_->value();
+
+    // In sharded mode, each read skips num_shards_ records
+    for (uint32_t s = 0; s < num_shards_; s++) {
+      cursor_->Next();
+      if (!cursor_->Valid()) {
+        MoveToBeginning();
+        break;
+      }
+    }
+  }
+
   void MoveToBeginning() const {
     cursor_->SeekToFirst();
     for (uint32_t s = 0; s < shard_id_; s++) {
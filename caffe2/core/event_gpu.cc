@@ -4,29 +4,76 @@
 
 #include <atomic>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 namespace caffe2 {
 
-struct CudaEventWrapper {
-  explicit CudaEventWrapper(const DeviceOption& option)
-      : cuda_stream_(nullptr),
-        device_id_(option.device_id()),
-        status_(EventStatus::EVENT_INITIALIZED) {
-    CAFFE_ENFORCE(option.device_type(), PROTO_CUDA);
-    CUDAGuard g(device_id_);
+namespace {
+
+// Recycles the cudaEvent_t of destroyed Caffe2 events, so that nets with
+// thousands of ops, created over and over, don't pay for a cudaEventCreate
+// and cudaEventDestroy per op every time. Re-recording an event that is still
+// pending is legal, and nothing refers to the event of a CudaEventWrapper
+// once it is destroyed.
+class CudaEventPool {
+ public:
+  cudaEvent_t acquire(int device_id) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& events = events_[device_id];
+      if (!events.empty()) {
+        cudaEvent_t event = events.back();
+        events.pop_back();
+        return event;
+      }
+    }
+    CUDAGuard g(device_id);
+    cudaEvent_t event;
     try {
       CUDA_ENFORCE(cudaEventCreateWithFlags(
-          &cuda_event_, cudaEventDefault | cudaEventDisableTiming));
+          &event, cudaEventDefault | cudaEventDisableTiming));
     } catch (const Error&) {
       std::cerr << "ERROR: Failed to load CUDA.\n"
                 << "HINT: Check that this binary contains GPU code."
                 << std::endl;
       throw;
     }
+    return event;
+  }
+
+  void release(int device_id, cudaEvent_t event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_[device_id].push_back(event);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<cudaEvent_t> events_[C10_COMPILE_TIME_MAX_GPUS];
+};
+
+// Leaked, the events may be released by static objects destroyed at exit
+CudaEventPool& getCudaEventPool() {
+  static auto* pool = new CudaEventPool();
+  return *pool;
+}
+
+} // namespace
+
+struct CudaEventWrapper {
+  explicit CudaEventWrapper(const DeviceOption& option)
+      : cuda_stream_(nullptr),
+        device_id_(option.device_id()),
+        status_(EventStatus::EVENT_INITIALIZED) {
+    CAFFE_ENFORCE(option.device_type(), PROTO_CUDA);
+    CAFFE_ENFORCE(
+        device_id_ >= 0 && device_id_ < C10_COMPILE_TIME_MAX_GPUS,
+        "Invalid gpu id: ",
+        device_id_);
+    cuda_event_ = getCudaEventPool().acquire(device_id_);
   }
   ~CudaEventWrapper() {
-    CUDAGuard g(device_id_);
-    CUDA_CHECK(cudaEventDestroy(cuda_event_));
+    getCudaEventPool().release(device_id_, cuda_event_);
   }
 
   cudaEvent_t cuda_event_;
@@ -47,4 +47,28 @@ TEST(EventCUDATest, EventBasics) {
   context_cuda.WaitEvent(event_cpu);
 }
 
+TEST(EventCUDATest, EventReuse) {
+  if (!HasCudaGPU())
+    return;
+  DeviceOption device_cuda;
+  device_cuda.set_device_type(PROTO_CUDA);
+  CUDAContext context_cuda(device_cuda);
+  context_cuda.SwitchToDevice();
+
+  // The CUDA events of destroyed events are handed to new ones, which start
+  // out initialized whatever the old ones went through
+  for (int i = 0; i < 3; ++i) {
+    std::vector<std::unique_ptr<Event>> events;
+    for (int j = 0; j < 4; ++j) {
+      events.push_back(std::make_unique<Event>(device_cuda));
+      EXPECT_EQ(events.back()->Query(), EventStatus::EVENT_INITIALIZED);
+      context_cuda.Record(events.back().get());
+    }
+    for (auto& event : events) {
+      event->Finish();
+      EXPECT_EQ(event->Query(), EventStatus::EVENT_SUCCESS);
+    }
+  }
+}
+
 } // namespace caffe2
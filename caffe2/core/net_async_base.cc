@@ -91,13 +91,19 @@ AsyncNetBase::AsyncNetBase(
   for (const auto& chain : chains_) {
     const auto& last_op = operators_[chain.back()];
     events_.push_back(&last_op->event());
-    // keep events for inner chain ops in case of profiling
+    // keep events for inner chain ops in case of profiling; ops of a chain
+    // run in order on the stream of the chain, so only the last op of the
+    // chain needs to record an event. Async CPU ops at the front of a chain
+    // finish their event from their async part, those are kept as well.
     if (!options_.report_stats_) {
       for (const auto& op_id : chain) {
-        if (op_id == chain.back() || op_id == chain.front()) {
+        const auto& op = operators_[op_id];
+        if (op_id == chain.back() ||
+            (op_id == chain.front() &&
+             IsCPUDeviceType(op->device_option().device_type()) &&
+             op->HasAsyncPart())) {
           continue;
         }
-        const auto& op = operators_[op_id];
         op->DisableEvent();
       }
     }
@@ -249,7 +255,7 @@ bool AsyncNetBase::canSchedule(
     bool can_schedule = Event::CanSchedule(
         operators_[last_parent_op_id]->event().GetType(),
         parent_status,
-        operators_[first_child_op_id]->event().GetType(),
+        operators_[first_child_op_id]->device_option().device_type(),
         operators_[first_child_op_id]->SupportsAsyncScheduling());
     if (!can_schedule) {
       return false;
@@ -266,7 +272,7 @@ bool AsyncNetBase::canSchedule(int parent_id, int child_id) {
   return Event::CanSchedule(
       parent_event.GetType(),
       parent_event.Query(),
-      first_child_op->event().GetType(),
+      first_child_op->device_option().device_type(),
       first_child_op->SupportsAsyncScheduling());
 }
 
@@ -599,6 +605,20 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
     }
+    if (arg.has_name() && arg.name() == "priority_scheduling") {
+      CAFFE_ENFORCE(arg.has_i(), "priority_scheduling should be an int");
+      use_priority_scheduling_ = arg.i() == 1;
+    }
+    if (arg.has_name() && arg.name() == "learn_priorities") {
+      CAFFE_ENFORCE(arg.has_i(), "learn_priorities should be an int");
+      learn_task_priorities_ = arg.i() == 1;
+    }
+  }
+
+  // op times are measured by the prof_dag counters
+  if (learn_task_priorities_) {
+    use_priority_scheduling_ = true;
+    report_stats_ = true;
   }
 
   if (FLAGS_caffe2_net_async_profile_operators) {
@@ -55,6 +55,10 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // run ready tasks by the longest remaining path to the end of the net
+  bool use_priority_scheduling_ = false;
+  // recompute the remaining paths from the measured op times after each run
+  bool learn_task_priorities_ = false;
 };
 
 struct CAFFE2_API AsyncNetCancelled : public std::exception {
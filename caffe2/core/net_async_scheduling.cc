@@ -2,12 +2,82 @@
 
 #include "caffe2/core/net_async_tracing.h"
 
+#include <algorithm>
+
 namespace caffe2 {
 
 AsyncSchedulingNet::AsyncSchedulingNet(
     const std::shared_ptr<const NetDef>& net_def,
     Workspace* ws)
-    : AsyncNetBase(net_def, ws), running_(false) {}
+    : AsyncNetBase(net_def, ws), running_(false) {
+  if (options_.use_priority_scheduling_) {
+    // until op times are measured, every op costs the same
+    computeTaskPriorities(std::vector<float>(operators_.size(), 1.0));
+  }
+}
+
+void AsyncSchedulingNet::computeTaskPriorities(
+    const std::vector<float>& op_costs) {
+  CAFFE_ENFORCE_EQ(op_costs.size(), operators_.size());
+  // visit the tasks children first, i.e. in reverse topological order
+  std::vector<int> num_children(tasksNum());
+  std::vector<int> order;
+  order.reserve(tasksNum());
+  for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
+    num_children[task_id] = children(task_id).size();
+    if (num_children[task_id] == 0) {
+      order.push_back(task_id);
+    }
+  }
+  std::vector<float> priorities(tasksNum(), 0.0);
+  for (size_t i = 0; i < order.size(); ++i) {
+    const auto task_id = order[i];
+    float remaining = 0.0;
+    for (auto child_id : children(task_id)) {
+      remaining = std::max(remaining, priorities[child_id]);
+    }
+    float cost = 0.0;
+    for (auto op_id : chains_[task_id]) {
+      cost += op_costs[op_id];
+    }
+    priorities[task_id] = cost + remaining;
+    for (auto parent_id : parents(task_id)) {
+      if (--num_children[parent_id] == 0) {
+        order.push_back(parent_id);
+      }
+    }
+  }
+  CAFFE_ENFORCE_EQ(
+      static_cast<int>(order.size()), tasksNum(), "Task graph has a cycle");
+
+  std::unique_lock<std::mutex> lock(ready_tasks_mutex_);
+  task_priorities_ = std::move(priorities);
+}
+
+void AsyncSchedulingNet::pushReadyTask(
+    TaskThreadPoolBase* task_pool,
+    int task_id) {
+  std::unique_lock<std::mutex> lock(ready_tasks_mutex_);
+  auto& ready_tasks = ready_tasks_[task_pool];
+  ready_tasks.push_back(task_id);
+  std::push_heap(
+      ready_tasks.begin(), ready_tasks.end(), [this](int lhs, int rhs) {
+        return task_priorities_[lhs] < task_priorities_[rhs];
+      });
+}
+
+int AsyncSchedulingNet::popReadyTask(TaskThreadPoolBase* task_pool) {
+  std::unique_lock<std::mutex> lock(ready_tasks_mutex_);
+  auto& ready_tasks = ready_tasks_[task_pool];
+  CAFFE_ENFORCE(!ready_tasks.empty(), "No ready task to run");
+  std::pop_heap(
+      ready_tasks.begin(), ready_tasks.end(), [this](int lhs, int rhs) {
+        return task_priorities_[lhs] < task_priorities_[rhs];
+      });
+  const auto task_id = ready_tasks.back();
+  ready_tasks.pop_back();
+  return task_id;
+}
 
 void AsyncSchedulingNet::reset() {
   AsyncNetBase::reset();
@@ -35,146 +105,175 @@ bool AsyncSchedulingNet::isInlineTask(int parent_id, int child_id) const {
 // schedule() is not supposed to throw, all exceptions in the ops are caught
 // and reported in the end of the graph's execution, the full graph of tasks
 // is expected to be scheduled
-void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
+void AsyncSchedulingNet::schedule(
+    int task_id,
+    bool run_inline,
+    int parent_stream_id) noexcept {
   if (!testAndSetScheduled(task_id)) {
     return;
   }
-  auto schedule_func = [this, task_id]() {
-    try {
-      if (success_) {
-        int stream_id = 0;
-        if (options_.streams_per_gpu_ > 1) {
-          try {
-            stream_id = stream(task_id);
-          } catch (const std::exception& e) {
-            C10_LOG_EVERY_MS(ERROR, 1000)
-                << "Failed to select a stream: " << e.what();
-          }
-        }
-        if (!run(task_id, stream_id)) {
-          success_ = false;
-        }
-      }
+  if (run_inline) {
+    runTask(task_id, parent_stream_id);
+    return;
+  }
+  auto* task_pool = pool(event(task_id).GetDeviceOption());
+  if (options_.use_priority_scheduling_) {
+    // the job runs the best ready task at the time it starts, which may not
+    // be this one
+    pushReadyTask(task_pool, task_id);
+    task_pool->run([this, task_pool]() { runTask(popReadyTask(task_pool)); });
+  } else {
+    task_pool->run(std::bind(&AsyncSchedulingNet::runTask, this, task_id));
+  }
+}
+
+void AsyncSchedulingNet::scheduleChild(
+    int task_id,
+    int child_id,
+    int* inline_stream_id) noexcept {
+  if (!isInlineTask(task_id, child_id)) {
+    schedule(child_id);
+    return;
+  }
+  const int stream_id = *inline_stream_id;
+  *inline_stream_id = -1;
+  schedule(child_id, /* run_inline */ true, stream_id);
+}
 
-      if (options_.report_stats_) {
+void AsyncSchedulingNet::runTask(int task_id, int parent_stream_id) noexcept {
+  int stream_id = 0;
+  try {
+    if (success_) {
+      if (parent_stream_id >= 0) {
+        stream_id = parent_stream_id;
+      } else if (options_.streams_per_gpu_ > 1) {
         try {
-          auto last_op_id = lastTaskOpId(task_id);
-          auto* last_op = lastTaskOp(task_id);
-          if (last_op->device_option().device_type() == PROTO_CPU &&
-              last_op->HasAsyncPart()) {
-            last_op->event().SetCallback([this, last_op_id] {
-              counters_.AddPerOpAsyncEndTime(last_op_id);
-            });
-          }
+          stream_id = stream(task_id);
         } catch (const std::exception& e) {
           C10_LOG_EVERY_MS(ERROR, 1000)
-              << "Failed to report operator stats: " << e.what();
+              << "Failed to select a stream: " << e.what();
         }
       }
+      if (!run(task_id, stream_id)) {
+        success_ = false;
+      }
+    }
 
-      for (auto child_id : children(task_id)) {
-        int parent_count = updateParentCount(child_id);
-        if (parent_count == 0) {
-          // Schedule a child if:
-          // - there is failure, we skip an op execution and finish the job
-          // - forced scheduling though always_schedule_child_
-          // - finish_chain_ is set, in this case parents are
-          //   guaranteed to be finished
-          // - in all other cases, check parents with canSchedule
-          if (!success_ || options_.always_schedule_child_ ||
-              options_.finish_chain_ || canSchedule(child_id)) {
-            // if DFS scheduling is enabled, run children inline,
-            // ignore DFS scheduling in callbacks
-            schedule(child_id, isInlineTask(task_id, child_id));
-          } else {
-            bool parent_failed = false;
-            bool parent_needs_polling = false;
-            std::vector<int> parents_with_callback;
-
-            for (auto parent_id : parents(child_id)) {
-              auto& parent_event = event(parent_id);
-              auto parent_status = parent_event.Query();
-
-              if (parent_status == EventStatus::EVENT_FAILED) {
-                parent_failed = true;
-                break;
-              } else if (parent_status == EventStatus::EVENT_SCHEDULED) {
-                // parent is not finished yet, check if this is blocking us
-                // from scheduling a child
-                if (!canSchedule(parent_id, child_id)) {
-                  // we can't schedule a child because of this parent,
-                  // check if parent supports callback
-                  if (parent_event.SupportsCallback()) {
-                    parents_with_callback.push_back(parent_id);
-                  } else {
-                    parent_needs_polling = true;
-                    break;
-                  }
+    if (options_.report_stats_) {
+      try {
+        auto last_op_id = lastTaskOpId(task_id);
+        auto* last_op = lastTaskOp(task_id);
+        if (last_op->device_option().device_type() == PROTO_CPU &&
+            last_op->HasAsyncPart()) {
+          last_op->event().SetCallback([this, last_op_id] {
+            counters_.AddPerOpAsyncEndTime(last_op_id);
+          });
+        }
+      } catch (const std::exception& e) {
+        C10_LOG_EVERY_MS(ERROR, 1000)
+            << "Failed to report operator stats: " << e.what();
+      }
+    }
+
+    // The first child run inline continues on the stream of this task, the
+    // waits on this task are then elided, see EventWaitCUDACUDA. Its siblings
+    // pick streams of their own so that they can still run concurrently.
+    int inline_stream_id = stream_id;
+    for (auto child_id : children(task_id)) {
+      int parent_count = updateParentCount(child_id);
+      if (parent_count == 0) {
+        // Schedule a child if:
+        // - there is failure, we skip an op execution and finish the job
+        // - forced scheduling though always_schedule_child_
+        // - finish_chain_ is set, in this case parents are
+        //   guaranteed to be finished
+        // - in all other cases, check parents with canSchedule
+        if (!success_ || options_.always_schedule_child_ ||
+            options_.finish_chain_ || canSchedule(child_id)) {
+          // if DFS scheduling is enabled, run children inline,
+          // ignore DFS scheduling in callbacks
+          scheduleChild(task_id, child_id, &inline_stream_id);
+        } else {
+          bool parent_failed = false;
+          bool parent_needs_polling = false;
+          std::vector<int> parents_with_callback;
+
+          for (auto parent_id : parents(child_id)) {
+            auto& parent_event = event(parent_id);
+            auto parent_status = parent_event.Query();
+
+            if (parent_status == EventStatus::EVENT_FAILED) {
+              parent_failed = true;
+              break;
+            } else if (parent_status == EventStatus::EVENT_SCHEDULED) {
+              // parent is not finished yet, check if this is blocking us
+              // from scheduling a child
+              if (!canSchedule(parent_id, child_id)) {
+                // we can't schedule a child because of this parent,
+                // check if parent supports callback
+                if (parent_event.SupportsCallback()) {
+                  parents_with_callback.push_back(parent_id);
+                } else {
+                  parent_needs_polling = true;
+                  break;
                 }
-              } else if (parent_status != EventStatus::EVENT_SUCCESS) {
-                VLOG(1) << "Unexpected parent task state: " << parent_status
-                        << ", task id: " << child_id
-                        << ", parent task id: " << parent_id;
-                parent_failed = true;
-                break;
               }
+            } else if (parent_status != EventStatus::EVENT_SUCCESS) {
+              VLOG(1) << "Unexpected parent task state: " << parent_status
+                      << ", task id: " << child_id
+                      << ", parent task id: " << parent_id;
+              parent_failed = true;
+              break;
             }
+          }
 
-            if (parent_failed) {
-              // one of parents failed, set failure flag and wrap up execution
-              success_ = false;
-              schedule(child_id, isInlineTask(task_id, child_id));
-            } else if (parent_needs_polling) {
-              // some parents are blocking us from scheduling a child and don't
-              // support callbacks, using polling
-              const auto& child_device_option =
-                  event(child_id).GetDeviceOption();
-              pool(child_device_option)
-                  ->run(std::bind(
-                      &AsyncSchedulingNet::pollAndSchedule, this, child_id));
-            } else if (!parents_with_callback.empty()) {
-              // some parents are blocking us from scheduling a child and they
-              // support callbacks
-              for (auto parent_id : parents_with_callback) {
-                event(parent_id).SetCallback(std::bind(
-                    &AsyncSchedulingNet::parentCallback, this, parent_id));
-              }
-            } else {
-              // we're ready to schedule a child
-              schedule(child_id, isInlineTask(task_id, child_id));
+          if (parent_failed) {
+            // one of parents failed, set failure flag and wrap up execution
+            success_ = false;
+            scheduleChild(task_id, child_id, &inline_stream_id);
+          } else if (parent_needs_polling) {
+            // some parents are blocking us from scheduling a child and don't
+            // support callbacks, using polling
+            const auto& child_device_option =
+                event(child_id).GetDeviceOption();
+            pool(child_device_option)
+                ->run(std::bind(
+                    &AsyncSchedulingNet::pollAndSchedule, this, child_id));
+          } else if (!parents_with_callback.empty()) {
+            // some parents are blocking us from scheduling a child and they
+            // support callbacks
+            for (auto parent_id : parents_with_callback) {
+              event(parent_id).SetCallback(std::bind(
+                  &AsyncSchedulingNet::parentCallback, this, parent_id));
             }
+          } else {
+            // we're ready to schedule a child
+            scheduleChild(task_id, child_id, &inline_stream_id);
           }
         }
       }
+    }
 
-      // In case of net's failure, make sure all pending tasks are finished
-      if (!success_) {
-        CancelAndFinishAsyncTasks();
-      }
-
-      // finishRun may cause waiters to wake up and destroy the net,
-      // before we call finishRun we need to make sure all other (finishing)
-      // tasks are done;
-      // Bumping and checking the counter after the task's job is done
-      auto tasks_num = tasksNum();
-      auto cur_processed_tasks = ++processed_tasks_num_;
-      if (cur_processed_tasks == tasks_num) {
-        finishRun();
-      }
-    } catch (const std::exception& e) {
-      // error of core scheduling and/or logic, will call terminate
-      LOG(FATAL) << "Unexpected error during graph scheduling run: "
-                 << e.what();
-    } catch (...) {
-      LOG(FATAL) << "Unknown error during graph scheduling run";
+    // In case of net's failure, make sure all pending tasks are finished
+    if (!success_) {
+      CancelAndFinishAsyncTasks();
     }
-  };
 
-  if (run_inline) {
-    schedule_func();
-  } else {
-    const auto& device_option = event(task_id).GetDeviceOption();
-    pool(device_option)->run(schedule_func);
+    // finishRun may cause waiters to wake up and destroy the net,
+    // before we call finishRun we need to make sure all other (finishing)
+    // tasks are done;
+    // Bumping and checking the counter after the task's job is done
+    auto tasks_num = tasksNum();
+    auto cur_processed_tasks = ++processed_tasks_num_;
+    if (cur_processed_tasks == tasks_num) {
+      finishRun();
+    }
+  } catch (const std::exception& e) {
+    // error of core scheduling and/or logic, will call terminate
+    LOG(FATAL) << "Unexpected error during graph scheduling run: "
+               << e.what();
+  } catch (...) {
+    LOG(FATAL) << "Unknown error during graph scheduling run";
   }
 }
 
@@ -218,6 +317,12 @@ void AsyncSchedulingNet::finishRun() {
   if (options_.report_stats_) {
     counters_.ReportRunEnd();
   }
+  if (options_.learn_task_priorities_) {
+    const auto op_times = counters_.GetPerOpMeanTimes();
+    if (!op_times.empty()) {
+      computeTaskPriorities(op_times);
+    }
+  }
   // notify observers and waiters
   StopAllObservers();
   running_ = false;
@@ -16,11 +16,24 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
 
   void Cancel() override;
 
+  const std::vector<float>& TEST_task_priorities() const {
+    return task_priorities_;
+  }
+
  protected:
   bool RunAsync() override;
 
   void pollAndSchedule(int task_id);
-  void schedule(int task_id, bool run_inline = false) noexcept;
+  // A task run inline may be given the stream of its parent, so that it
+  // doesn't need a cross-stream wait on the parent
+  void schedule(
+      int task_id,
+      bool run_inline = false,
+      int parent_stream_id = -1) noexcept;
+  void runTask(int task_id, int parent_stream_id = -1) noexcept;
+  // Schedules a ready child of task_id, inline_stream_id is the stream the
+  // next child run inline inherits, or -1 once it was handed out
+  void scheduleChild(int task_id, int child_id, int* inline_stream_id) noexcept;
   void reset() override;
   virtual void finishRun();
   void parentCallback(int parent_id);
@@ -28,6 +41,18 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
 
   void CancelAndFinishAsyncTasks();
 
+  // Priority scheduling: a task's priority is the cost of the longest path
+  // from its start to the end of the net, and each job run by a pool picks
+  // the ready task of that pool with the highest priority
+  void computeTaskPriorities(const std::vector<float>& op_costs);
+  void pushReadyTask(TaskThreadPoolBase* task_pool, int task_id);
+  int popReadyTask(TaskThreadPoolBase* task_pool);
+
+  std::vector<float> task_priorities_;
+  std::mutex ready_tasks_mutex_;
+  // heaps of ready task ids per pool, ordered by priority
+  std::unordered_map<TaskThreadPoolBase*, std::vector<int>> ready_tasks_;
+
   std::mutex running_mutex_;
   std::condition_variable running_cv_;
   std::atomic<bool> running_;
@@ -1,7 +1,9 @@
 #include "caffe2/core/net_simple_refcount.h"
 #include "caffe2/core/net.h"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -54,24 +56,195 @@ SimpleRefCountNet::SimpleRefCountNet(
               << " at operator #" << kv.second;
     }
   }
+
+  plan_memory_ =
+      ArgumentHelper(*net_def).GetSingleArgument<int>("plan_memory", 0) == 1;
+  if (!plan_memory_) {
+    return;
+  }
+  // The temporaries are the blobs of the delete list, living from their
+  // first producer to the op deleting them.
+  std::map<string, int> first_produced_at;
+  output_blobs_.resize(net_def->op_size());
+  for (int idx = 0; idx < net_def->op_size(); ++idx) {
+    for (const string& out_name : net_def->op(idx).output()) {
+      first_produced_at.emplace(out_name, idx);
+      output_blobs_[idx].push_back(ws->GetBlob(out_name));
+    }
+  }
+  for (const auto& kv : last_consumed_at) {
+    if (!created_by_me.count(kv.first)) {
+      input_blobs_.push_back(ws->GetBlob(kv.first));
+    } else if (kv.second > 0 && first_produced_at[kv.first] <= kv.second) {
+      PlannedBlob temporary;
+      temporary.blob = ws->GetBlob(kv.first);
+      temporary.first_op = first_produced_at[kv.first];
+      temporary.last_op = kv.second;
+      temporary_ids_[temporary.blob] = temporaries_.size();
+      temporaries_.push_back(std::move(temporary));
+    }
+  }
+  planned_at_.resize(net_def->op_size());
+}
+
+std::vector<std::vector<int64_t>> SimpleRefCountNet::inputShapes() const {
+  std::vector<std::vector<int64_t>> shapes;
+  shapes.reserve(input_blobs_.size());
+  for (const Blob* blob : input_blobs_) {
+    if (BlobIsTensorType(*blob, CPU)) {
+      shapes.push_back(blob->Get<Tensor>().sizes().vec());
+    } else {
+      shapes.emplace_back();
+    }
+  }
+  return shapes;
+}
+
+void SimpleRefCountNet::recordOutputs(int op_id) {
+  for (Blob* blob : output_blobs_[op_id]) {
+    live_ranges_.erase(blob);
+    if (!BlobIsTensorType(*blob, CPU)) {
+      continue;
+    }
+    const auto& tensor = blob->Get<Tensor>();
+    auto it = temporary_ids_.find(blob);
+    PlannedBlob* temporary =
+        it != temporary_ids_.end() ? &temporaries_[it->second] : nullptr;
+    if (temporary) {
+      if (op_id == temporary->first_op) {
+        temporary->dims = tensor.sizes().vec();
+        temporary->dtype = tensor.dtype();
+        temporary->recorded = true;
+      }
+      // in-place ops may grow it after its first producer
+      temporary->nbytes = std::max(temporary->nbytes, tensor.nbytes());
+    }
+    if (!tensor.storage_initialized() || tensor.nbytes() == 0) {
+      continue;
+    }
+    const char* begin = static_cast<const char*>(tensor.raw_data());
+    const char* end = begin + tensor.nbytes();
+    // the memory of a temporary can't be reused while another blob may
+    // still use it
+    for (const auto& kv : live_ranges_) {
+      if (begin < kv.second.second && kv.second.first < end) {
+        if (temporary) {
+          temporary->shared = true;
+        }
+        auto other = temporary_ids_.find(kv.first);
+        if (other != temporary_ids_.end()) {
+          temporaries_[other->second].shared = true;
+        }
+      }
+    }
+    live_ranges_[blob] = {begin, end};
+  }
+}
+
+void SimpleRefCountNet::planMemory() {
+  for (auto& blobs : planned_at_) {
+    blobs.clear();
+  }
+  std::vector<size_t> order;
+  for (size_t i = 0; i < temporaries_.size(); ++i) {
+    const auto& temporary = temporaries_[i];
+    if (temporary.recorded && !temporary.shared && temporary.nbytes > 0) {
+      order.push_back(i);
+    }
+  }
+  // place the largest tensors first, each at the lowest offset not used by
+  // an already placed tensor alive at the same time
+  std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+    return temporaries_[lhs].nbytes > temporaries_[rhs].nbytes;
+  });
+  std::vector<size_t> placed;
+  arena_size_ = 0;
+  for (auto i : order) {
+    auto& temporary = temporaries_[i];
+    const size_t size =
+        (temporary.nbytes + gAlignment - 1) / gAlignment * gAlignment;
+    std::vector<std::pair<size_t, size_t>> used;
+    for (auto j : placed) {
+      const auto& other = temporaries_[j];
+      if (other.first_op <= temporary.last_op &&
+          temporary.first_op <= other.last_op) {
+        used.emplace_back(
+            other.offset,
+            other.offset +
+                (other.nbytes + gAlignment - 1) / gAlignment * gAlignment);
+      }
+    }
+    std::sort(used.begin(), used.end());
+    size_t offset = 0;
+    for (const auto& range : used) {
+      if (offset + size <= range.first) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    temporary.offset = offset;
+    arena_size_ = std::max(arena_size_, offset + size);
+    placed.push_back(i);
+    planned_at_[temporary.first_op].push_back(i);
+  }
+  arena_ = GetCPUAllocator()->allocate(arena_size_);
+  VLOG(1) << "SimpleRefCountNet: planned " << placed.size()
+          << " temporaries in an arena of " << arena_size_ << " bytes";
 }
 
 bool SimpleRefCountNet::Run() {
   StartAllObservers();
   VLOG(1) << "Running net " << name_;
+  bool recording = false;
+  if (plan_memory_) {
+    auto input_shapes = inputShapes();
+    if (!planned_ || input_shapes != planned_input_shapes_) {
+      planned_ = false;
+      recording = true;
+      for (auto& temporary : temporaries_) {
+        temporary.nbytes = 0;
+        temporary.recorded = false;
+        temporary.shared = false;
+      }
+      live_ranges_.clear();
+      planned_input_shapes_ = std::move(input_shapes);
+    }
+  }
   for (auto op_id = 0U; op_id < operators_.size(); ++op_id) {
     auto& op = operators_[op_id];
     VLOG(1) << "Running operator " << op->debug_def().name() << "("
             << op->debug_def().type() << ").";
+    if (planned_) {
+      for (auto i : planned_at_[op_id]) {
+        const auto& temporary = temporaries_[i];
+        auto* tensor = BlobGetMutableTensor(temporary.blob, CPU);
+        tensor->Resize(temporary.dims);
+        tensor->ShareExternalPointer(
+            static_cast<char*>(arena_.get()) + temporary.offset,
+            temporary.dtype,
+            temporary.nbytes);
+      }
+    }
     bool res = op->Run();
     if (!res) {
       LOG(ERROR) << "Operator failed: " << ProtoDebugString(op->debug_def());
       return false;
     }
+    if (recording) {
+      recordOutputs(op_id);
+    }
     for (Blob* blob : delete_list_[op_id]) {
       blob->Reset();
+      if (recording) {
+        live_ranges_.erase(blob);
+      }
     }
   }
+  if (recording) {
+    live_ranges_.clear();
+    planMemory();
+    planned_ = true;
+  }
   StopAllObservers();
   return true;
 }
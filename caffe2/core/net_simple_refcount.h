@@ -1,6 +1,8 @@
 #ifndef CAFFE2_CORE_NET_SIMPLE_REFCOUNT_H_
 #define CAFFE2_CORE_NET_SIMPLE_REFCOUNT_H_
 
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "c10/util/Registry.h"
@@ -35,22 +37,68 @@ namespace caffe2 {
 // purposes and not product use, since it is not going to provide better
 // performance gain, and is implicitly incompatible with the contract that
 // earlier Nets expose - that all intermediate blobs are visible to the users.
+//
+// With the "plan_memory" net argument set to 1, the temporary CPU tensors are
+// also placed in a single arena: the first run records their sizes, types
+// and lifetimes, and assigns each one an offset in the arena so that tensors
+// that are never alive at the same time share memory. Later runs with the
+// same input shapes point the temporary tensors into the arena before their
+// first producer runs, so they don't allocate. On a change of the input
+// shapes, the next run records a new plan. Temporaries whose memory is
+// shared with another blob, e.g. by an alias op, are not planned.
 class SimpleRefCountNet final : public SimpleNet {
  public:
   SimpleRefCountNet(
       const std::shared_ptr<const NetDef>& net_def,
       Workspace* ws);
 
+  size_t TEST_arena_size() const {
+    return arena_size_;
+  }
+
  protected:
   bool Run() override;
 
   using SimpleNet::operators_;
 
  private:
+  struct PlannedBlob {
+    Blob* blob;
+    // ops producing the blob first and deleting it
+    int first_op;
+    int last_op;
+    // recorded on the first run
+    std::vector<int64_t> dims;
+    TypeMeta dtype;
+    size_t nbytes = 0;
+    bool recorded = false;
+    bool shared = false;
+    size_t offset = 0;
+  };
+
+  std::vector<std::vector<int64_t>> inputShapes() const;
+  void recordOutputs(int op_id);
+  void planMemory();
+
   // The list of blobs to delete when each operator finishes its run.
   // This will be populated during construction time.
   vector<vector<Blob*>> delete_list_;
 
+  // Memory planning
+  bool plan_memory_ = false;
+  bool planned_ = false;
+  vector<vector<Blob*>> output_blobs_;
+  vector<Blob*> input_blobs_;
+  vector<PlannedBlob> temporaries_;
+  std::unordered_map<Blob*, size_t> temporary_ids_;
+  // the temporaries placed in the arena before each operator
+  vector<vector<size_t>> planned_at_;
+  // the memory of the blobs alive in the recording run
+  std::unordered_map<Blob*, std::pair<const char*, const char*>> live_ranges_;
+  std::vector<std::vector<int64_t>> planned_input_shapes_;
+  at::DataPtr arena_;
+  size_t arena_size_ = 0;
+
   C10_DISABLE_COPY_AND_ASSIGN(SimpleRefCountNet);
 };
 
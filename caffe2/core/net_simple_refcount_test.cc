@@ -2,6 +2,7 @@
 #include "c10/util/StringUtil.h"
 #include "caffe2/core/net.h"
 #include "caffe2/core/net_async_scheduling.h"
+#include "caffe2/core/net_simple_refcount.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/scope_guard.h"
 
@@ -66,5 +67,74 @@ TEST(NetSimpleRefCountTest, TestCorrectness) {
   EXPECT_EQ(ws.GetBlob("e")->Get<int32_t>(), 4);
 }
 
+class NetSimpleRefCountAddOneOp final : public Operator<CPUContext> {
+ public:
+  NetSimpleRefCountAddOneOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<CPUContext>(operator_def, ws) {}
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+
+  bool RunOnDevice() override {
+    const auto& input = Input(0);
+    auto* output = Output(0, input.sizes(), at::dtype<float>());
+    const float* input_data = input.data<float>();
+    float* output_data = output->mutable_data<float>();
+    for (int64_t i = 0; i < input.numel(); ++i) {
+      output_data[i] = input_data[i] + 1;
+    }
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(NetSimpleRefCountAddOne, NetSimpleRefCountAddOneOp);
+
+OPERATOR_SCHEMA(NetSimpleRefCountAddOne).NumInputs(1).NumOutputs(1);
+
+TEST(NetSimpleRefCountTest, TestMemoryPlanning) {
+  Workspace ws;
+  NetDef net_def;
+  net_def.set_type("simple_refcount");
+  net_def.add_arg()->CopyFrom(MakeArgument<int>("plan_memory", 1));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetSimpleRefCountAddOne", "", {"a"}, {"b"}));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetSimpleRefCountAddOne", "", {"b"}, {"c"}));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetSimpleRefCountAddOne", "", {"c"}, {"d"}));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetSimpleRefCountAddOne", "", {"d"}, {"e"}));
+  net_def.add_external_output("e");
+
+  ws.CreateBlob("a");
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  auto* refcount_net =
+      caffe2::dynamic_cast_if_rtti<SimpleRefCountNet*>(net.get());
+  ASSERT_TRUE(refcount_net != nullptr);
+
+  // the plan of the first run is reused, and a new one is made when the
+  // input shape changes
+  for (int size : {6, 100}) {
+    auto* a = BlobGetMutableTensor(ws.GetBlob("a"), CPU);
+    a->Resize(size);
+    auto* a_data = a->mutable_data<float>();
+    for (int i = 0; i < size; ++i) {
+      a_data[i] = i;
+    }
+    for (int run = 0; run < 2; ++run) {
+      ASSERT_TRUE(net->Run());
+      // b, c and d are planned, b and d are never alive at the same time
+      const size_t padded = (size * sizeof(float) + gAlignment - 1) /
+          gAlignment * gAlignment;
+      EXPECT_EQ(refcount_net->TEST_arena_size(), 2 * padded);
+      EXPECT_EQ(ws.GetBlob("b")->GetRaw(), nullptr);
+      EXPECT_EQ(ws.GetBlob("d")->GetRaw(), nullptr);
+      const auto& e = ws.GetBlob("e")->Get<Tensor>();
+      ASSERT_EQ(e.numel(), size);
+      for (int i = 0; i < size; ++i) {
+        EXPECT_EQ(e.data<float>()[i], i + 4);
+      }
+    }
+  }
+}
+
 } // namespace
 } // namespace caffe2
@@ -765,6 +765,68 @@ REGISTER_CPU_OPERATOR(NotFinishingOp, NotFinishingOp);
 
 OPERATOR_SCHEMA(NotFinishingOp);
 
+TEST(NetTest, AsyncPriorityScheduling) {
+  const auto spec = R"DOC(
+        name: "example"
+        type: "async_scheduling"
+        external_input: "in"
+        op {
+          input: "in"
+          output: "a"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "a"
+          output: "b"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "b"
+          output: "c"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "c"
+          output: "out1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "a"
+          output: "out2"
+          type: "NetTestDummy"
+        }
+        arg {
+          name: "learn_priorities"
+          i: 1
+        }
+)DOC";
+
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+
+  Workspace ws;
+  ws.CreateBlob("in");
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  auto* async_net =
+      caffe2::dynamic_cast_if_rtti<AsyncSchedulingNet*>(net.get());
+  ASSERT_TRUE(async_net != nullptr);
+
+  // before any run every op costs 1, and the longest path goes through
+  // the first four ops
+  auto priorities = async_net->TEST_task_priorities();
+  ASSERT_FALSE(priorities.empty());
+  ASSERT_EQ(*std::max_element(priorities.begin(), priorities.end()), 4.0);
+  ASSERT_EQ(*std::min_element(priorities.begin(), priorities.end()), 1.0);
+
+  // priorities are then learned from the measured op times
+  counter.exchange(0);
+  for (int run = 0; run < 3; ++run) {
+    ASSERT_TRUE(net->Run());
+  }
+  ASSERT_EQ(counter.load(), 15);
+  ASSERT_EQ(async_net->TEST_task_priorities().size(), priorities.size());
+}
+
 TEST(NetTest, PendingOpsAndNetFailure) {
   const auto spec = R"DOC(
         name: "example"
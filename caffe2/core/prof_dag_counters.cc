@@ -124,6 +124,18 @@ ProfDAGReport ProfDAGCounters::GetReport() const {
   return report_;
 }
 
+std::vector<float> ProfDAGCounters::GetPerOpMeanTimes() const {
+  std::vector<float> mean_times;
+  if (!report_.hasStats()) {
+    return mean_times;
+  }
+  mean_times.reserve(report_.time_per_op_total_.size());
+  for (const auto& stats : report_.time_per_op_total_) {
+    mean_times.push_back(stats.computeMoments().first);
+  }
+  return mean_times;
+}
+
 bool ProfDAGReport::hasStats() const {
   return runtime_stats_.cnt() > 0;
 }
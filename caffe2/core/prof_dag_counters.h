@@ -105,6 +105,10 @@ class ProfDAGCounters {
   void AddPerOpAsyncEndTime(size_t op_id);
   ProfDAGReport GetReport() const;
 
+  // Returns the mean time of each operator over the reported runs, or an
+  // empty vector if no run was reported yet
+  std::vector<float> GetPerOpMeanTimes() const;
+
  private:
   Timer timer_;
 
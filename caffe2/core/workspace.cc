@@ -157,15 +157,22 @@ bool Workspace::RemoveBlob(const string& name) {
   return false;
 }
 
+const Blob* Workspace::FindBlob(const string& name) const {
+  const auto it = blob_map_.find(name);
+  if (it != blob_map_.end()) {
+    return it->second.get();
+  }
+  const auto forwarded = forwarded_blobs_.find(name);
+  if (forwarded != forwarded_blobs_.end()) {
+    return forwarded->second.first->FindBlob(forwarded->second.second);
+  }
+  return shared_ ? shared_->FindBlob(name) : nullptr;
+}
+
 const Blob* Workspace::GetBlob(const string& name) const {
-  if (blob_map_.count(name)) {
-    return blob_map_.at(name).get();
-  } else if (forwarded_blobs_.count(name)) {
-    const auto parent_ws = forwarded_blobs_.at(name).first;
-    const auto& parent_name = forwarded_blobs_.at(name).second;
-    return parent_ws->GetBlob(parent_name);
-  } else if (shared_ && shared_->HasBlob(name)) {
-    return shared_->GetBlob(name);
+  const Blob* blob = FindBlob(name);
+  if (blob) {
+    return blob;
   }
   LOG(WARNING) << "Blob " << name << " not in the workspace.";
   // TODO(Yangqing): do we want to always print out the list of blobs here?
@@ -177,18 +177,7 @@ class CAFFE2_API Workspace {
    * Checks if a blob with the given name is present in the current workspace.
    */
   inline bool HasBlob(const string& name) const {
-    // First, check the local workspace,
-    // Then, check the forwarding map, then the parent workspace
-    if (blob_map_.count(name)) {
-      return true;
-    } else if (forwarded_blobs_.count(name)) {
-      const auto parent_ws = forwarded_blobs_.at(name).first;
-      const auto& parent_name = forwarded_blobs_.at(name).second;
-      return parent_ws->HasBlob(parent_name);
-    } else if (shared_) {
-      return shared_->HasBlob(name);
-    }
-    return false;
+    return FindBlob(name) != nullptr;
   }
 
   void PrintBlobSizes();
@@ -216,6 +205,13 @@ class CAFFE2_API Workspace {
   /**
    * Gets the blob with the given name as a const pointer. If the blob does not
    * exist, a nullptr is returned.
+   *
+   * Lookups only read the blob maps of this workspace and of its parents, so
+   * any number of threads can look up blobs concurrently, e.g. the
+   * predictors sharing a parent workspace, as long as none of them creates,
+   * removes or renames blobs meanwhile. The blob pointers stay valid until
+   * their blob is removed or renamed, so code that runs many times over the
+   * same blobs should look them up once and keep the pointers.
    */
   const Blob* GetBlob(const string& name) const;
   /**
@@ -318,6 +314,11 @@ class CAFFE2_API Workspace {
 
   static std::shared_ptr<Bookkeeper> bookkeeper();
 
+  // GetBlob() without the warning for missing blobs. It looks in the local
+  // workspace, then in the forwarding map, then in the parent workspace, with
+  // a single lookup in each.
+  const Blob* FindBlob(const string& name) const;
+
   BlobMap blob_map_;
   const string root_folder_;
   const Workspace* shared_;
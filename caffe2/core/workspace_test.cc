@@ -1,4 +1,5 @@
 #include <iostream>
+#include <thread>
 
 #include "caffe2/core/operator.h"
 #include <gtest/gtest.h>
@@ -91,6 +92,37 @@ TEST(WorkspaceTest, Sharing) {
   }
 }
 
+TEST(WorkspaceTest, ConcurrentLookup) {
+  Workspace parent;
+  std::vector<const Blob*> blobs;
+  for (int i = 0; i < 100; ++i) {
+    blobs.push_back(parent.CreateBlob(c10::str("blob_", i)));
+  }
+  // Many child workspaces look up the blobs of their shared parent at once
+  std::vector<std::thread> threads;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&]() {
+      Workspace child(&parent);
+      child.CreateBlob("local");
+      for (int iter = 0; iter < 100; ++iter) {
+        for (int i = 0; i < 100; ++i) {
+          if (child.GetBlob(c10::str("blob_", i)) != blobs[i]) {
+            ++mismatches;
+          }
+        }
+        if (!child.HasBlob("local") || parent.HasBlob("local")) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(mismatches, 0);
+}
+
 TEST(WorkspaceTest, BlobMapping) {
   Workspace parent;
   EXPECT_FALSE(parent.HasBlob("a"));
@@ -200,5 +200,26 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(DBReaderBatchTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+
+  std::unique_ptr<DBReader> reader(new DBReader("leveldb", name, 3, 1));
+  vector<string> keys;
+  vector<string> values;
+  // A batch wraps around the end of the db like single reads do.
+  reader->Read(5, &keys, &values);
+  EXPECT_EQ(keys, (vector<string>{"01", "04", "07", "01", "04"}));
+  EXPECT_EQ(values, keys);
+  string key;
+  string value;
+  reader->Read(&key, &value);
+  EXPECT_EQ(key, "07");
+  EXPECT_EQ(value, "07");
+  reader->Read(0, &keys, &values);
+  EXPECT_TRUE(keys.empty());
+  EXPECT_TRUE(values.empty());
+}
+
 } // namespace db
 } // namespace caffe2
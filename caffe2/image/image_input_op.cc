@@ -149,6 +149,13 @@ The dimension of the output image will always be cropxcrop
         "random_scale",
         "[min, max] shortest-side desired for image resize. "
         "Defaults to [-1, -1] or no random resize desired.")
+    .Arg(
+        "reduced_decode",
+        "If 1, JPEG images at least twice as large as scale are decoded at"
+        " 1/2, 1/4 or 1/8 of their size before being scaled, which is much"
+        " cheaper than decoding them fully. Only used with scale, without"
+        " random scaling, bounding boxes or Inception-style jittering."
+        " Defaults to 0")
     .Input(0, "reader", "The input reader (a db::DBReader)")
     .Output(0, "data", "Tensor containing the images")
     .Output(1, "label", "Tensor containing the labels")
@@ -80,6 +80,8 @@ class ImageInputOp final : public PrefetchOperator<Context> {
       PerImageArg& info,
       int item_id,
       std::mt19937* randgen);
+  int DecodeFlags(const char* data, size_t size, const PerImageArg& info)
+      const;
   void DecodeAndTransform(
       const std::string& value,
       float* image_data,
@@ -126,6 +128,9 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   // it ensures that both dimensions of the image are at least minsize_
   int minsize_;
   bool warp_;
+  // Whether to decode large JPEGs at a reduced size when they are scaled
+  // down anyway
+  bool reduced_decode_;
   int crop_;
   std::vector<float> mean_;
   std::vector<float> std_;
@@ -195,6 +200,8 @@ ImageInputOp<Context>::ImageInputOp(
       scale_(OperatorBase::template GetSingleArgument<int>("scale", -1)),
       minsize_(OperatorBase::template GetSingleArgument<int>("minsize", -1)),
       warp_(OperatorBase::template GetSingleArgument<int>("warp", 0)),
+      reduced_decode_(
+          OperatorBase::template GetSingleArgument<int>("reduced_decode", 0)),
       crop_(OperatorBase::template GetSingleArgument<int>("crop", -1)),
       mirror_(OperatorBase::template GetSingleArgument<int>("mirror", 0)),
       is_test_(OperatorBase::template GetSingleArgument<int>(
@@ -366,6 +373,9 @@ ImageInputOp<Context>::ImageInputOp(
                 << (warp_ ? " with " : " without ") << "warping;";
     }
   }
+  if (reduced_decode_) {
+    LOG(INFO) << "    Decoding large JPEG images at a reduced size;";
+  }
   LOG(INFO) << "    " << (is_test_ ? "Central" : "Random")
             << " cropping image to " << crop_
             << (mirror_ ? " with " : " without ") << "random mirroring;";
@@ -445,6 +455,88 @@ bool RandomSizedCropping(cv::Mat* img, const int crop, std::mt19937* randgen) {
   return inception_scale_jitter;
 }
 
+// Reads the size of a JPEG image from the header of its frame, without
+// decoding it. Returns false if the data is not a JPEG image.
+inline bool
+GetJpegSize(const char* data, size_t size, int* height, int* width) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+  if (size < 4 || bytes[0] != 0xFF || bytes[1] != 0xD8) {
+    return false;
+  }
+  size_t pos = 2;
+  while (pos + 4 <= size) {
+    if (bytes[pos] != 0xFF) {
+      return false;
+    }
+    const uint8_t marker = bytes[pos + 1];
+    if (marker == 0xFF) {
+      // fill byte
+      ++pos;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+      // markers without a segment
+      pos += 2;
+      continue;
+    }
+    if (marker == 0xD9 || marker == 0xDA) {
+      // the image or its scan starts before any frame header
+      return false;
+    }
+    const size_t length = (bytes[pos + 2] << 8) | bytes[pos + 3];
+    // SOF0 - SOF15, except for DHT, JPG and DAC
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+        marker != 0xC8 && marker != 0xCC) {
+      if (length < 7 || pos + 9 > size) {
+        return false;
+      }
+      *height = (bytes[pos + 5] << 8) | bytes[pos + 6];
+      *width = (bytes[pos + 7] << 8) | bytes[pos + 8];
+      return *height > 0 && *width > 0;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+
+// Returns the cv::imdecode flags for the encoded image. With reduced_decode,
+// a JPEG image that is scaled down to scale_ anyway is decoded at the
+// smallest of 1/2, 1/4 and 1/8 of its size that is still no smaller than
+// scale_, so that libjpeg skips most of the IDCT and upsampling work. This
+// only applies when the size the image is scaled to doesn't depend on the
+// decoded size, and there is no bounding box in source pixel coordinates.
+template <class Context>
+int ImageInputOp<Context>::DecodeFlags(
+    const char* data,
+    size_t size,
+    const PerImageArg& info) const {
+  const int flags = color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE;
+#if CV_MAJOR_VERSION >= 4 || (CV_MAJOR_VERSION == 3 && CV_MINOR_VERSION >= 1)
+  if (!reduced_decode_ || scale_ <= 0 || random_scaling_ ||
+      info.bounding_params.valid ||
+      (scale_jitter_type_ == INCEPTION_STYLE && !is_test_)) {
+    return flags;
+  }
+  int height, width;
+  if (!GetJpegSize(data, size, &height, &width)) {
+    return flags;
+  }
+  // Both with and without warping, the shortest side must stay no smaller
+  // than scale_ for the image to still be scaled down.
+  const int shortest_side = std::min(height, width);
+  if (shortest_side >= 8 * scale_) {
+    return color_ ? cv::IMREAD_REDUCED_COLOR_8 : cv::IMREAD_REDUCED_GRAYSCALE_8;
+  }
+  if (shortest_side >= 4 * scale_) {
+    return color_ ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_GRAYSCALE_4;
+  }
+  if (shortest_side >= 2 * scale_) {
+    return color_ ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_REDUCED_GRAYSCALE_2;
+  }
+#endif
+  return flags;
+}
+
 template <class Context>
 bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     const string& value,
@@ -477,7 +569,7 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
                 datum.data().size(),
                 CV_8UC1,
                 const_cast<char*>(datum.data().data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+            DecodeFlags(datum.data().data(), datum.data().size(), info));
         if (src.rows == 0 || src.cols == 0) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
@@ -552,7 +644,7 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
                 &encoded_size,
                 CV_8UC1,
                 const_cast<char*>(encoded_image_str.data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+            DecodeFlags(encoded_image_str.data(), encoded_size, info));
         if (src.rows == 0 || src.cols == 0) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
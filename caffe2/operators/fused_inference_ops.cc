@@ -0,0 +1,342 @@
+#include "caffe2/operators/fused_inference_ops.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+#include "caffe2/operators/fc_inference.h"
+#include "caffe2/utils/eigen_utils.h"
+#include "caffe2/utils/math.h"
+
+namespace caffe2 {
+
+namespace {
+
+// Elements per block of the fused elementwise operators, 4KB of floats
+constexpr int64_t kBlockSize = 1024;
+
+template <FusedActivation Activation>
+void ApplyActivation(EigenVectorArrayMap<float>* y) {
+  switch (Activation) {
+    case FusedActivation::RELU:
+      *y = y->max(0.0f);
+      break;
+    case FusedActivation::SIGMOID:
+      *y = 1.0f / (1.0f + (-*y).exp());
+      break;
+    case FusedActivation::NONE:
+      break;
+  }
+}
+
+const std::unordered_map<std::string, FusedElementwiseOp::Kind>&
+ElementwiseKinds() {
+  static const std::unordered_map<std::string, FusedElementwiseOp::Kind>
+      kinds = {
+          {"Relu", FusedElementwiseOp::Kind::RELU},
+          {"Sigmoid", FusedElementwiseOp::Kind::SIGMOID},
+          {"Tanh", FusedElementwiseOp::Kind::TANH},
+          {"Exp", FusedElementwiseOp::Kind::EXP},
+          {"Log", FusedElementwiseOp::Kind::LOG},
+          {"Abs", FusedElementwiseOp::Kind::ABS},
+          {"Sqr", FusedElementwiseOp::Kind::SQR},
+          {"Sqrt", FusedElementwiseOp::Kind::SQRT},
+          {"Negative", FusedElementwiseOp::Kind::NEGATIVE},
+      };
+  return kinds;
+}
+
+std::vector<TensorShape> ConcatFCShapeInference(
+    const OperatorDef& /* unused */,
+    const vector<TensorShape>& in) {
+  std::vector<TensorShape> out(1);
+  out[0].set_data_type(in[2].data_type());
+  out[0].add_dims(in[2].dims(0));
+  out[0].add_dims(in[0].dims(0));
+  return out;
+}
+
+} // namespace
+
+template <FusedActivation Activation, bool ConcatInputs>
+bool FusedFCOp<Activation, ConcatInputs>::RunOnDevice() {
+  const int first_x = ConcatInputs ? 2 : 0;
+  const auto& W = Input(ConcatInputs ? 0 : 1);
+  const auto& b = Input(ConcatInputs ? 1 : 2);
+  const auto& X0 = Input(first_x);
+  CAFFE_ENFORCE_GE(X0.dim(), 1);
+  CAFFE_ENFORCE_GE(W.dim(), 1);
+  CAFFE_ENFORCE_EQ(b.dim(), 1);
+
+  const int M = X0.dim32(0);
+  const int N = W.dim32(0);
+  const int K = W.size_from_dim(1);
+  CAFFE_ENFORCE_EQ(b.dim32(0), N, "Dimension mismatch of W and b");
+  int64_t total_k = 0;
+  for (int i = first_x; i < InputSize(); ++i) {
+    const auto& X = Input(i);
+    CAFFE_ENFORCE_GE(X.dim(), 1);
+    CAFFE_ENFORCE_EQ(X.dim32(0), M, "Inputs must have the same batch size");
+    total_k += X.size_from_dim(1);
+  }
+  CAFFE_ENFORCE_EQ(
+      total_k, K, "Dimension mismatch: X: ", X0.sizes(), ", W: ", W.sizes());
+
+  auto* Y = Output(0, {M, N}, at::dtype<float>());
+  float* Y_data = Y->template mutable_data<float>();
+  if (M == 0) {
+    return true;
+  }
+
+  // Y = sum_i X_i * W[:, k_i:k_i + K_i]^T
+  int64_t k_offset = 0;
+  for (int i = first_x; i < InputSize(); ++i) {
+    const auto& X = Input(i);
+    const int K_i = X.size_from_dim(1);
+    if (K_i == 0) {
+      continue;
+    }
+    math::GemmEx<float, CPUContext>(
+        CblasNoTrans,
+        CblasTrans,
+        M,
+        N,
+        K_i,
+        1.0f,
+        X.template data<float>(),
+        K_i,
+        W.template data<float>() + k_offset,
+        K,
+        k_offset == 0 ? 0.0f : 1.0f,
+        Y_data,
+        N,
+        &context_);
+    k_offset += K_i;
+  }
+  if (k_offset == 0) {
+    math::Set<float, CPUContext>(M * N, 0.0f, Y_data, &context_);
+  }
+
+  // Bias and activation, row by row while the row is in cache
+  ConstEigenVectorArrayMap<float> bias(b.template data<float>(), N);
+  for (int i = 0; i < M; ++i) {
+    EigenVectorArrayMap<float> y(Y_data + static_cast<int64_t>(i) * N, N);
+    y += bias;
+    ApplyActivation<Activation>(&y);
+  }
+  return true;
+}
+
+bool SumReluOp::RunOnDevice() {
+  return DispatchHelper<TensorTypes<float, double, int32_t, int64_t>>::call(
+      this, Input(0));
+}
+
+template <typename T>
+bool SumReluOp::DoRunWithType() {
+  const auto& X0 = Input(0);
+  for (int i = 1; i < InputSize(); ++i) {
+    CAFFE_ENFORCE(
+        X0.sizes() == Input(i).sizes(),
+        "Inputs must have the same shape, got ",
+        X0.sizes(),
+        " and ",
+        Input(i).sizes());
+    CAFFE_ENFORCE(
+        Input(i).template IsType<T>(), "Inputs must have the same type");
+  }
+  auto* Y = Output(0, X0.sizes(), at::dtype<T>());
+  T* Y_data = Y->template mutable_data<T>();
+  const int64_t size = X0.numel();
+
+  // The sums go through a block on the stack, Y may be any of the inputs
+  T block[kBlockSize];
+  for (int64_t start = 0; start < size; start += kBlockSize) {
+    const int64_t n = std::min(kBlockSize, size - start);
+    EigenVectorArrayMap<T> acc(block, n);
+    acc = ConstEigenVectorArrayMap<T>(X0.template data<T>() + start, n);
+    for (int i = 1; i < InputSize(); ++i) {
+      acc += ConstEigenVectorArrayMap<T>(Input(i).template data<T>() + start, n);
+    }
+    EigenVectorArrayMap<T>(Y_data + start, n) = acc.max(T(0));
+  }
+  return true;
+}
+
+FusedElementwiseOp::FusedElementwiseOp(
+    const OperatorDef& operator_def,
+    Workspace* ws)
+    : Operator<CPUContext>(operator_def, ws) {
+  for (const auto& op :
+       this->GetRepeatedArgument<std::string>("ops")) {
+    const auto it = ElementwiseKinds().find(op);
+    CAFFE_ENFORCE(
+        it != ElementwiseKinds().end(), "Unsupported elementwise op: ", op);
+    kinds_.push_back(it->second);
+  }
+  CAFFE_ENFORCE(!kinds_.empty(), "FusedElementwise needs at least one op");
+}
+
+bool FusedElementwiseOp::IsSupported(const std::string& op_type) {
+  return ElementwiseKinds().count(op_type);
+}
+
+bool FusedElementwiseOp::RunOnDevice() {
+  const auto& X = Input(0);
+  auto* Y = Output(0, X.sizes(), at::dtype<float>());
+  const float* X_data = X.template data<float>();
+  float* Y_data = Y->template mutable_data<float>();
+  const int64_t size = X.numel();
+  for (int64_t start = 0; start < size; start += kBlockSize) {
+    const int64_t n = std::min(kBlockSize, size - start);
+    EigenVectorArrayMap<float> y(Y_data + start, n);
+    if (Y_data != X_data) {
+      y = ConstEigenVectorArrayMap<float>(X_data + start, n);
+    }
+    for (const auto kind : kinds_) {
+      switch (kind) {
+        case Kind::RELU:
+          y = y.max(0.0f);
+          break;
+        case Kind::SIGMOID:
+          y = 1.0f / (1.0f + (-y).exp());
+          break;
+        case Kind::TANH:
+          y = y.tanh();
+          break;
+        case Kind::EXP:
+          y = y.exp();
+          break;
+        case Kind::LOG:
+          y = y.log();
+          break;
+        case Kind::ABS:
+          y = y.abs();
+          break;
+        case Kind::SQR:
+          y = y.square();
+          break;
+        case Kind::SQRT:
+          y = y.sqrt();
+          break;
+        case Kind::NEGATIVE:
+          y = -y;
+          break;
+      }
+    }
+  }
+  return true;
+}
+
+REGISTER_CPU_OPERATOR(
+    FCRelu,
+    FusedFCOp<FusedActivation::RELU, /* ConcatInputs */ false>);
+REGISTER_CPU_OPERATOR(
+    FCSigmoid,
+    FusedFCOp<FusedActivation::SIGMOID, /* ConcatInputs */ false>);
+REGISTER_CPU_OPERATOR(
+    ConcatFC,
+    FusedFCOp<FusedActivation::NONE, /* ConcatInputs */ true>);
+REGISTER_CPU_OPERATOR(
+    ConcatFCRelu,
+    FusedFCOp<FusedActivation::RELU, /* ConcatInputs */ true>);
+REGISTER_CPU_OPERATOR(
+    ConcatFCSigmoid,
+    FusedFCOp<FusedActivation::SIGMOID, /* ConcatInputs */ true>);
+REGISTER_CPU_OPERATOR(SumRelu, SumReluOp);
+REGISTER_CPU_OPERATOR(FusedElementwise, FusedElementwiseOp);
+
+using namespace std::placeholders;
+
+OPERATOR_SCHEMA(FCRelu)
+    .NumInputs(3)
+    .NumOutputs(1)
+    .TensorInferenceFunction(std::bind(FCShapeInference, _1, _2, false))
+    .CostInferenceFunction(std::bind(CostInferenceForFC, _1, _2, false))
+    .SetDoc(R"DOC(
+FC with the default axis and axis_w followed by Relu, $Y = max(XW^T + b, 0)$.
+)DOC")
+    .Input(0, "X", "Input of shape $(M, K)$, or coerced into it")
+    .Input(1, "W", "Weights of shape $(N, K)$, or coerced into it")
+    .Input(2, "b", "Bias of shape $(N)$")
+    .Output(0, "Y", "Output of shape $(M, N)$");
+
+OPERATOR_SCHEMA(FCSigmoid)
+    .NumInputs(3)
+    .NumOutputs(1)
+    .TensorInferenceFunction(std::bind(FCShapeInference, _1, _2, false))
+    .CostInferenceFunction(std::bind(CostInferenceForFC, _1, _2, false))
+    .SetDoc(R"DOC(
+FC with the default axis and axis_w followed by Sigmoid,
+$Y = sigmoid(XW^T + b)$.
+)DOC")
+    .Input(0, "X", "Input of shape $(M, K)$, or coerced into it")
+    .Input(1, "W", "Weights of shape $(N, K)$, or coerced into it")
+    .Input(2, "b", "Bias of shape $(N)$")
+    .Output(0, "Y", "Output of shape $(M, N)$");
+
+OPERATOR_SCHEMA(ConcatFC)
+    .NumInputs(3, INT_MAX)
+    .NumOutputs(1)
+    .TensorInferenceFunction(ConcatFCShapeInference)
+    .SetDoc(R"DOC(
+FC over the concatenation of its inputs $X_i$ along axis 1, without
+materializing the concatenation, $Y = [X_0, ..., X_{n-1}]W^T + b$. Every $X_i$
+of shape $(M, K_i)$, or coerced into it, is multiplied by its slice of the
+columns of $W$. Note that the weights come first.
+)DOC")
+    .Input(0, "W", "Weights of shape $(N, \\sum K_i)$, or coerced into it")
+    .Input(1, "b", "Bias of shape $(N)$")
+    .Input(2, "X_0", "First input of shape $(M, K_0)$, followed by the others")
+    .Output(0, "Y", "Output of shape $(M, N)$");
+
+OPERATOR_SCHEMA(ConcatFCRelu)
+    .NumInputs(3, INT_MAX)
+    .NumOutputs(1)
+    .TensorInferenceFunction(ConcatFCShapeInference)
+    .SetDoc(R"DOC(
+ConcatFC followed by Relu.
+)DOC");
+
+OPERATOR_SCHEMA(ConcatFCSigmoid)
+    .NumInputs(3, INT_MAX)
+    .NumOutputs(1)
+    .TensorInferenceFunction(ConcatFCShapeInference)
+    .SetDoc(R"DOC(
+ConcatFC followed by Sigmoid.
+)DOC");
+
+OPERATOR_SCHEMA(SumRelu)
+    .NumInputs(1, INT_MAX)
+    .NumOutputs(1)
+    .AllowInplace({{0, 0}})
+    .IdenticalTypeAndShapeOfInput(0)
+    .SetDoc(R"DOC(
+Elementwise sum of the inputs, of the same shape and type, followed by Relu.
+)DOC")
+    .Input(0, "X_0", "First input, followed by the others")
+    .Output(0, "Y", "Output of the shape of the inputs");
+
+OPERATOR_SCHEMA(FusedElementwise)
+    .NumInputs(1)
+    .NumOutputs(1)
+    .AllowInplace({{0, 0}})
+    .IdenticalTypeAndShape()
+    .SetDoc(R"DOC(
+Applies a chain of float unary elementwise operators, among Relu, Sigmoid,
+Tanh, Exp, Log, Abs, Sqr, Sqrt and Negative, in the order given by `ops`, in
+a single pass over X.
+)DOC")
+    .Arg("ops", "(list of string) The operators of the chain, in order")
+    .Input(0, "X", "Input tensor")
+    .Output(0, "Y", "Output tensor");
+
+SHOULD_NOT_DO_GRADIENT(FCRelu);
+SHOULD_NOT_DO_GRADIENT(FCSigmoid);
+SHOULD_NOT_DO_GRADIENT(ConcatFC);
+SHOULD_NOT_DO_GRADIENT(ConcatFCRelu);
+SHOULD_NOT_DO_GRADIENT(ConcatFCSigmoid);
+SHOULD_NOT_DO_GRADIENT(SumRelu);
+SHOULD_NOT_DO_GRADIENT(FusedElementwise);
+
+} // namespace caffe2
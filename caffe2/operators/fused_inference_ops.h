@@ -0,0 +1,68 @@
+#ifndef CAFFE2_OPERATORS_FUSED_INFERENCE_OPS_H_
+#define CAFFE2_OPERATORS_FUSED_INFERENCE_OPS_H_
+
+#include <string>
+#include <vector>
+
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+
+namespace caffe2 {
+
+// The operators below are what the FuseCPUInference pass (see
+// caffe2/opt/fusion.h) rewrites chains of CPU inference operators into. Each
+// of them writes its output in a single pass, where the chain writes and
+// reads back an intermediate blob per operator.
+
+enum class FusedActivation { NONE, RELU, SIGMOID };
+
+// FC followed by an activation, with the bias and the activation applied in
+// the same pass over Y. With ConcatInputs, the inputs are W, b, X_0, ...,
+// X_{n-1} and X is the concatenation of the X_i along axis 1, which is never
+// materialized: every X_i is multiplied by its own slice of the columns of W.
+template <FusedActivation Activation, bool ConcatInputs>
+class FusedFCOp final : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  template <class... Args>
+  explicit FusedFCOp(Args&&... args)
+      : Operator<CPUContext>(std::forward<Args>(args)...) {}
+
+  bool RunOnDevice() override;
+};
+
+// Sum of the inputs followed by Relu
+class SumReluOp final : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  template <class... Args>
+  explicit SumReluOp(Args&&... args)
+      : Operator<CPUContext>(std::forward<Args>(args)...) {}
+
+  bool RunOnDevice() override;
+
+  template <typename T>
+  bool DoRunWithType();
+};
+
+// A chain of unary elementwise operators, named in order by the "ops"
+// argument, applied to blocks of X small enough to stay in cache.
+class FusedElementwiseOp final : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  FusedElementwiseOp(const OperatorDef& operator_def, Workspace* ws);
+
+  bool RunOnDevice() override;
+
+  // Whether operators of type `op_type` can be part of the chain
+  static bool IsSupported(const std::string& op_type);
+
+  enum class Kind { RELU, SIGMOID, TANH, EXP, LOG, ABS, SQR, SQRT, NEGATIVE };
+
+ private:
+  std::vector<Kind> kinds_;
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_OPERATORS_FUSED_INFERENCE_OPS_H_
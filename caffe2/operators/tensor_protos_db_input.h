@@ -1,9 +1,11 @@
 #ifndef CAFFE2_OPERATORS_TENSOR_PROTOS_DB_INPUT_H_
 #define CAFFE2_OPERATORS_TENSOR_PROTOS_DB_INPUT_H_
 
+#include <exception>
 #include <iostream>
 #include <mutex>
 
+#include "c10/core/thread_pool.h"
 #include "caffe2/core/db.h"
 #include "caffe2/operators/prefetch_op.h"
 
@@ -23,12 +25,22 @@ class TensorProtosDBInput final : public PrefetchOperator<Context> {
   bool CopyPrefetched() override;
 
  private:
+  // Deserializes the tensors of the item_id-th value of the batch.
+  void DeserializeItem(int item_id);
+
   // Prefetch will always just happen on the CPU side.
   vector<Blob> prefetched_blobs_;
   int batch_size_;
   bool shape_inferred_ = false;
   string key_;
   string value_;
+  // The records of a batch are read at once, and deserialized by
+  // decode_threads threads if there are more than one.
+  int num_decode_threads_;
+  std::shared_ptr<TaskThreadPool> thread_pool_;
+  vector<string> keys_;
+  vector<string> values_;
+  vector<vector<Tensor>> items_;
 };
 
 template <class Context>
@@ -38,7 +50,30 @@ TensorProtosDBInput<Context>::TensorProtosDBInput(
     : PrefetchOperator<Context>(operator_def, ws),
       prefetched_blobs_(operator_def.output_size()),
       batch_size_(
-          this->template GetSingleArgument<int>("batch_size", 0)) {}
+          this->template GetSingleArgument<int>("batch_size", 0)),
+      num_decode_threads_(
+          this->template GetSingleArgument<int>("decode_threads", 1)) {
+  CAFFE_ENFORCE_GE(num_decode_threads_, 1);
+  if (num_decode_threads_ > 1 && batch_size_ > 1) {
+    thread_pool_ = std::make_shared<TaskThreadPool>(num_decode_threads_);
+  }
+}
+
+template <class Context>
+void TensorProtosDBInput<Context>::DeserializeItem(int item_id) {
+  TensorProtos protos;
+  CAFFE_ENFORCE(protos.ParseFromString(values_[item_id]));
+  CAFFE_ENFORCE(protos.protos_size() == OutputSize());
+  TensorDeserializer deserializer;
+  auto& tensors = items_[item_id];
+  tensors.clear();
+  for (int i = 0; i < protos.protos_size(); ++i) {
+    if (protos.protos(i).has_device_detail()) {
+      protos.mutable_protos(i)->clear_device_detail();
+    }
+    tensors.push_back(deserializer.Deserialize(protos.protos(i)));
+  }
+}
 
 template <class Context>
 bool TensorProtosDBInput<Context>::Prefetch() {
@@ -62,21 +97,39 @@ bool TensorProtosDBInput<Context>::Prefetch() {
       //     CPU));
     }
   } else {
+    reader.Read(batch_size_, &keys_, &values_);
+    items_.resize(batch_size_);
+    if (thread_pool_) {
+      // Exceptions thrown on the pool threads are otherwise dropped.
+      vector<std::exception_ptr> errors(batch_size_);
+      for (int item_id = 0; item_id < batch_size_; ++item_id) {
+        thread_pool_->run([this, item_id, &errors]() {
+          try {
+            DeserializeItem(item_id);
+          } catch (...) {
+            errors[item_id] = std::current_exception();
+          }
+        });
+      }
+      thread_pool_->waitWorkComplete();
+      for (const auto& error : errors) {
+        if (error) {
+          std::rethrow_exception(error);
+        }
+      }
+    } else {
+      for (int item_id = 0; item_id < batch_size_; ++item_id) {
+        DeserializeItem(item_id);
+      }
+    }
+
     for (int item_id = 0; item_id < batch_size_; ++item_id) {
-      reader.Read(&key_, &value_);
-      TensorProtos protos;
-      CAFFE_ENFORCE(protos.ParseFromString(value_));
-      CAFFE_ENFORCE(protos.protos_size() == OutputSize());
       // Note: shape_inferred_ is ignored, we'll always get dimensions from
       // proto
-      for (int i = 0; i < protos.protos_size(); ++i) {
-        vector<int64_t> dims(
-            protos.protos(i).dims().begin(), protos.protos(i).dims().end());
+      for (int i = 0; i < OutputSize(); ++i) {
+        const Tensor& src = items_[item_id][i];
+        vector<int64_t> dims = src.sizes().vec();
         dims.insert(dims.begin(), batch_size_);
-        if (protos.protos(i).has_device_detail()) {
-          protos.mutable_protos(i)->clear_device_detail();
-        }
-        Tensor src = deserializer.Deserialize(protos.protos(i));
         Tensor* dst = BlobGetMutableTensor(
             &prefetched_blobs_[i], dims, at::dtype(src.dtype()).device(CPU));
         DCHECK_EQ(src.numel() * batch_size_, dst->numel());
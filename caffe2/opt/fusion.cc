@@ -1,7 +1,9 @@
 #include "caffe2/opt/fusion.h"
 #include "caffe2/core/logging.h"
+#include "caffe2/operators/fused_inference_ops.h"
 #include "caffe2/opt/converter.h"
 #include "caffe2/opt/passes.h"
+#include "caffe2/utils/proto_utils.h"
 
 namespace caffe2 {
 namespace opt {
@@ -121,5 +123,264 @@ void fuseConvBN(nom::repr::NNModule* nn, caffe2::Workspace* ws) {
 
 REGISTER_WS_OPT_PASS_FROM_FUNC(FuseConvBN, fuseConvBN);
 
+namespace {
+
+// The OperatorDef of `node` if it is an operator on the default CPU engine
+caffe2::OperatorDef* getCPUOpDef(repr::NNGraph::NodeRef node) {
+  NOM_REQUIRE_OR_RET_NULL(repr::nn::is<repr::NeuralNetOperator>(node));
+  auto* annotation =
+      repr::nn::get<repr::NeuralNetOperator>(node)->getMutableAnnotation();
+  NOM_REQUIRE_OR_RET_NULL(
+      annotation && isa<caffe2::Caffe2Annotation>(annotation));
+  auto* c2_annotation = dyn_cast<caffe2::Caffe2Annotation>(annotation);
+  NOM_REQUIRE_OR_RET_NULL(
+      c2_annotation->getDeviceType() == caffe2::PROTO_CPU);
+  auto* op = c2_annotation->getMutableOperatorDef();
+  NOM_REQUIRE_OR_RET_NULL(op->engine().empty());
+  return op;
+}
+
+// FC on the default axes, which is what FusedFCOp implements
+bool isDefaultFC(const caffe2::OperatorDef& op) {
+  ArgumentHelper args(op);
+  return op.type() == "FC" && args.GetSingleArgument<int>("axis", 1) == 1 &&
+      args.GetSingleArgument<int>("axis_w", 1) == 1 &&
+      !args.GetSingleArgument<bool>("float16_compute", false);
+}
+
+// The consumer of the single output of `node`, if that output is an
+// intermediate read only once, by an operator with one input and one output.
+repr::NNGraph::NodeRef getSoleConsumer(
+    repr::NNModule* nn,
+    repr::NNGraph::NodeRef node) {
+  auto outputs = repr::nn::getOutputs(node);
+  NOM_REQUIRE_OR_RET_NULL(outputs.size() == 1);
+  NOM_REQUIRE_OR_RET_NULL(!nn->outputs.count(outputs.front()));
+  auto consumers = repr::nn::getConsumers(outputs.front());
+  NOM_REQUIRE_OR_RET_NULL(consumers.size() == 1);
+  auto consumer = consumers.front();
+  NOM_REQUIRE_OR_RET_NULL(repr::nn::getInputs(consumer).size() == 1);
+  NOM_REQUIRE_OR_RET_NULL(repr::nn::getOutputs(consumer).size() == 1);
+  return consumer;
+}
+
+// Whether an operator that runs after `begin` and before `end` writes a
+// tensor named `name`, or reads it too with `check_reads`. Fusing moves the
+// reads of the inputs of `end` and the writes of the outputs of `end` to
+// `begin`, which is only correct if no operator in between touches them.
+bool isTouchedBetween(
+    repr::NNModule* nn,
+    repr::NNGraph::NodeRef begin,
+    repr::NNGraph::NodeRef end,
+    const std::string& name,
+    bool check_reads) {
+  bool between = false;
+  for (const auto& bbNode : nn->controlFlow.getMutableNodes()) {
+    for (const auto& instrNode : bbNode->data().getInstructions()) {
+      if (instrNode == end) {
+        return false;
+      }
+      if (between) {
+        for (const auto& output : repr::nn::getOutputs(instrNode)) {
+          if (repr::nn::getName(output) == name) {
+            return true;
+          }
+        }
+        for (const auto& input : repr::nn::getInputs(instrNode)) {
+          if (check_reads && repr::nn::getName(input) == name) {
+            return true;
+          }
+        }
+      }
+      between = between || instrNode == begin;
+    }
+  }
+  return false;
+}
+
+// Makes `node` write the output of its sole consumer `consumer`, then
+// deletes `consumer` and the intermediate between them.
+void absorbConsumer(
+    repr::NNModule* nn,
+    repr::NNGraph::NodeRef node,
+    repr::NNGraph::NodeRef consumer) {
+  auto intermediate = repr::nn::getOutputs(node).front();
+  auto output = repr::nn::getOutputs(consumer).front();
+  nn->dataFlow.deleteNode(consumer);
+  nn->dataFlow.deleteNode(intermediate);
+  nn->dataFlow.createEdge(node, output);
+}
+
+// Whether `consumer` can be absorbed by `node`. The fused operator writes
+// the output of `consumer`, so it must not be one of the inputs of `node`
+// unless the fused operator supports running in place.
+bool canAbsorbConsumer(
+    repr::NNModule* nn,
+    repr::NNGraph::NodeRef node,
+    repr::NNGraph::NodeRef consumer,
+    bool allow_inplace) {
+  const auto name = repr::nn::getName(repr::nn::getOutputs(consumer).front());
+  if (!allow_inplace) {
+    for (const auto& input : repr::nn::getInputs(node)) {
+      NOM_REQUIRE_OR_RET_FALSE(repr::nn::getName(input) != name);
+    }
+  }
+  return !isTouchedBetween(nn, node, consumer, name, /* check_reads */ true);
+}
+
+bool fuseConcatFCHelper(repr::NNModule* nn) {
+  for (auto concatNode : nn->dataFlow.getMutableNodes()) {
+    auto* concatDef = getCPUOpDef(concatNode);
+    NOM_REQUIRE_OR_CONT(concatDef && concatDef->type() == "Concat");
+    ArgumentHelper concatArgs(*concatDef);
+    NOM_REQUIRE_OR_CONT(
+        concatArgs.HasArgument("axis")
+            ? concatArgs.GetSingleArgument<int>("axis", -1) == 1
+            : concatArgs.GetSingleArgument<std::string>("order", "NCHW") ==
+                "NCHW");
+    NOM_REQUIRE_OR_CONT(!concatArgs.GetSingleArgument<int>("add_axis", 0));
+
+    // The split info output, if any, must be unused
+    auto concatOutputs = repr::nn::getOutputs(concatNode);
+    NOM_REQUIRE_OR_CONT(!concatOutputs.empty());
+    bool outputsUsed = false;
+    for (size_t i = 0; i < concatOutputs.size(); ++i) {
+      outputsUsed = outputsUsed || nn->outputs.count(concatOutputs[i]) ||
+          (i > 0 && repr::nn::hasConsumer(concatOutputs[i]));
+    }
+    NOM_REQUIRE_OR_CONT(!outputsUsed);
+
+    auto consumers = repr::nn::getConsumers(concatOutputs.front());
+    NOM_REQUIRE_OR_CONT(consumers.size() == 1);
+    auto fcNode = consumers.front();
+    auto* fcDef = getCPUOpDef(fcNode);
+    NOM_REQUIRE_OR_CONT(fcDef && isDefaultFC(*fcDef));
+    auto fcInputs = repr::nn::getInputs(fcNode);
+    NOM_REQUIRE_OR_CONT(
+        fcInputs.size() == 3 && fcInputs.front() == concatOutputs.front());
+
+    // ConcatFC reads the inputs of the Concat where the FC runs
+    auto concatInputs = repr::nn::getInputs(concatNode);
+    NOM_REQUIRE_OR_CONT(!concatInputs.empty());
+    const auto fcOutput =
+        repr::nn::getName(repr::nn::getOutputs(fcNode).front());
+    bool hazard = false;
+    for (const auto& input : concatInputs) {
+      const auto name = repr::nn::getName(input);
+      hazard = hazard || name == fcOutput ||
+          isTouchedBetween(
+                   nn, concatNode, fcNode, name, /* check_reads */ false);
+    }
+    NOM_REQUIRE_OR_CONT(!hazard);
+
+    // The inputs of the FC left are W and b, the X_i follow them
+    fcDef->set_type("ConcatFC");
+    nn->dataFlow.deleteNode(concatNode);
+    for (const auto& output : concatOutputs) {
+      nn->dataFlow.deleteNode(output);
+    }
+    for (const auto& input : concatInputs) {
+      nn->dataFlow.createEdge(input, fcNode);
+    }
+    return true;
+  }
+  return false;
+}
+
+bool fuseFCActivationHelper(repr::NNModule* nn) {
+  for (auto fcNode : nn->dataFlow.getMutableNodes()) {
+    auto* fcDef = getCPUOpDef(fcNode);
+    NOM_REQUIRE_OR_CONT(
+        fcDef && (isDefaultFC(*fcDef) || fcDef->type() == "ConcatFC"));
+    auto actNode = getSoleConsumer(nn, fcNode);
+    NOM_REQUIRE_OR_CONT(actNode);
+    auto* actDef = getCPUOpDef(actNode);
+    NOM_REQUIRE_OR_CONT(
+        actDef && (actDef->type() == "Relu" || actDef->type() == "Sigmoid"));
+    NOM_REQUIRE_OR_CONT(
+        canAbsorbConsumer(nn, fcNode, actNode, /* allow_inplace */ false));
+
+    fcDef->set_type(fcDef->type() + actDef->type());
+    absorbConsumer(nn, fcNode, actNode);
+    return true;
+  }
+  return false;
+}
+
+bool fuseSumReluHelper(repr::NNModule* nn) {
+  for (auto sumNode : nn->dataFlow.getMutableNodes()) {
+    auto* sumDef = getCPUOpDef(sumNode);
+    NOM_REQUIRE_OR_CONT(sumDef && sumDef->type() == "Sum");
+    auto reluNode = getSoleConsumer(nn, sumNode);
+    NOM_REQUIRE_OR_CONT(reluNode);
+    auto* reluDef = getCPUOpDef(reluNode);
+    NOM_REQUIRE_OR_CONT(reluDef && reluDef->type() == "Relu");
+    NOM_REQUIRE_OR_CONT(
+        canAbsorbConsumer(nn, sumNode, reluNode, /* allow_inplace */ true));
+
+    sumDef->set_type("SumRelu");
+    absorbConsumer(nn, sumNode, reluNode);
+    return true;
+  }
+  return false;
+}
+
+std::vector<std::string> getElementwiseOps(const caffe2::OperatorDef& op) {
+  if (op.type() == "FusedElementwise") {
+    return ArgumentHelper(op).GetRepeatedArgument<std::string>("ops");
+  }
+  if (caffe2::FusedElementwiseOp::IsSupported(op.type())) {
+    return {op.type()};
+  }
+  return {};
+}
+
+bool fuseElementwiseHelper(repr::NNModule* nn) {
+  for (auto node : nn->dataFlow.getMutableNodes()) {
+    auto* def = getCPUOpDef(node);
+    NOM_REQUIRE_OR_CONT(def && repr::nn::getInputs(node).size() == 1);
+    auto ops = getElementwiseOps(*def);
+    NOM_REQUIRE_OR_CONT(!ops.empty());
+    auto consumer = getSoleConsumer(nn, node);
+    NOM_REQUIRE_OR_CONT(consumer);
+    auto* consumerDef = getCPUOpDef(consumer);
+    NOM_REQUIRE_OR_CONT(consumerDef);
+    auto consumerOps = getElementwiseOps(*consumerDef);
+    NOM_REQUIRE_OR_CONT(!consumerOps.empty());
+    NOM_REQUIRE_OR_CONT(
+        canAbsorbConsumer(nn, node, consumer, /* allow_inplace */ true));
+
+    // Negative is the only one that takes more than floats, a chain of
+    // Negative alone may not run on floats
+    ops.insert(ops.end(), consumerOps.begin(), consumerOps.end());
+    NOM_REQUIRE_OR_CONT(std::any_of(
+        ops.begin(), ops.end(), [](const std::string& op) {
+          return op != "Negative";
+        }));
+
+    def->set_type("FusedElementwise");
+    def->clear_arg();
+    *def->add_arg() = MakeArgument("ops", ops);
+    absorbConsumer(nn, node, consumer);
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+void fuseCPUInference(repr::NNModule* nn) {
+  while (fuseConcatFCHelper(nn)) {
+  }
+  while (fuseFCActivationHelper(nn)) {
+  }
+  while (fuseSumReluHelper(nn)) {
+  }
+  while (fuseElementwiseHelper(nn)) {
+  }
+}
+
+REGISTER_OPT_PASS_FROM_FUNC(FuseCPUInference, fuseCPUInference);
+
 } // namespace opt
 } // namespace caffe2
@@ -27,6 +27,15 @@ using namespace nom;
 
 CAFFE2_API void fuseConvBN(repr::NNModule* nn, caffe2::Workspace* ws);
 
+// Rewrites chains of CPU inference operators into the single pass operators
+// of caffe2/operators/fused_inference_ops.h: Concat along axis 1 feeding an
+// FC into ConcatFC, FC and ConcatFC followed by Relu or Sigmoid into
+// FCRelu, ConcatFCSigmoid..., Sum followed by Relu into SumRelu, and chains
+// of float unary elementwise operators into FusedElementwise. Only chains
+// whose intermediates are read by nothing else and are not external outputs
+// are fused.
+CAFFE2_API void fuseCPUInference(repr::NNModule* nn);
+
 // Generic activation fusion helper.
 //
 // \tparam OperationT The operator to be fused.
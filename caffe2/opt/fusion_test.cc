@@ -0,0 +1,124 @@
+#include <caffe2/core/common.h>
+#include <caffe2/core/test_utils.h>
+#include <caffe2/core/workspace.h>
+#include <caffe2/opt/converter.h>
+#include <caffe2/opt/fusion.h>
+#include <caffe2/utils/proto_utils.h>
+
+#include <gtest/gtest.h>
+
+using namespace caffe2::testing;
+using namespace caffe2;
+
+namespace {
+
+NetDef fuse(const NetDef& net) {
+  auto nn = convertToNNModule(net);
+  opt::fuseCPUInference(&nn);
+  return convertToCaffe2Proto(nn, net);
+}
+
+void fillInputs(
+    const std::vector<std::pair<std::string, std::vector<int64_t>>>& inputs,
+    Workspace* ws) {
+  for (const auto& input : inputs) {
+    auto* tensor = createTensor(input.first, ws);
+    tensor->Resize(input.second);
+    randomFill(tensor->mutable_data<float>(), tensor->numel(), -1.0, 1.0);
+  }
+}
+
+// Runs both nets on the same inputs and compares their outputs
+void checkSameOutputs(
+    const NetDef& net,
+    const NetDef& fused,
+    const std::vector<std::pair<std::string, std::vector<int64_t>>>& inputs) {
+  Workspace ws;
+  Workspace fusedWs;
+  fillInputs(inputs, &ws);
+  fillInputs(inputs, &fusedWs);
+  ASSERT_TRUE(ws.RunNetOnce(net));
+  ASSERT_TRUE(fusedWs.RunNetOnce(fused));
+  std::vector<std::string> outputs(
+      net.external_output().begin(), net.external_output().end());
+  assertTensorListEquals(outputs, ws, fusedWs);
+}
+
+} // namespace
+
+TEST(FuseCPUInference, FCRelu) {
+  NetDef net;
+  NetMutator(&net)
+      .newOp("FC", {"X", "W", "b"}, {"Y"})
+      .newOp("Relu", {"Y"}, {"Z"})
+      .externalInputs({"X", "W", "b"})
+      .externalOutputs({"Z"});
+
+  auto fused = fuse(net);
+  ASSERT_EQ(fused.op_size(), 1);
+  EXPECT_EQ(fused.op(0).type(), "FCRelu");
+  EXPECT_EQ(fused.op(0).input_size(), 3);
+  EXPECT_EQ(fused.op(0).output(0), "Z");
+  checkSameOutputs(net, fused, {{"X", {5, 7}}, {"W", {3, 7}}, {"b", {3}}});
+}
+
+TEST(FuseCPUInference, ConcatFCSigmoid) {
+  NetDef net;
+  NetMutator(&net)
+      .newOp("Concat", {"X0", "X1"}, {"C", "split_info"})
+      .addArgument("axis", 1)
+      .newOp("FC", {"C", "W", "b"}, {"Y"})
+      .newOp("Sigmoid", {"Y"}, {"Y"})
+      .externalInputs({"X0", "X1", "W", "b"})
+      .externalOutputs({"Y"});
+
+  auto fused = fuse(net);
+  ASSERT_EQ(fused.op_size(), 1);
+  EXPECT_EQ(fused.op(0).type(), "ConcatFCSigmoid");
+  ASSERT_EQ(fused.op(0).input_size(), 4);
+  EXPECT_EQ(fused.op(0).input(0), "W");
+  EXPECT_EQ(fused.op(0).input(1), "b");
+  EXPECT_EQ(fused.op(0).input(2), "X0");
+  EXPECT_EQ(fused.op(0).input(3), "X1");
+  checkSameOutputs(
+      net,
+      fused,
+      {{"X0", {4, 3}}, {"X1", {4, 5}}, {"W", {6, 8}}, {"b", {6}}});
+}
+
+TEST(FuseCPUInference, SumReluAndElementwiseChain) {
+  NetDef net;
+  NetMutator(&net)
+      .newOp("Sum", {"A", "B"}, {"S"})
+      .newOp("Relu", {"S"}, {"S"})
+      .newOp("Tanh", {"S"}, {"T"})
+      .newOp("Negative", {"T"}, {"T"})
+      .newOp("Exp", {"T"}, {"Out"})
+      .externalInputs({"A", "B"})
+      .externalOutputs({"Out"});
+
+  auto fused = fuse(net);
+  ASSERT_EQ(fused.op_size(), 2);
+  EXPECT_EQ(fused.op(0).type(), "SumRelu");
+  EXPECT_EQ(fused.op(1).type(), "FusedElementwise");
+  EXPECT_EQ(
+      ArgumentHelper(fused.op(1)).GetRepeatedArgument<std::string>("ops"),
+      std::vector<std::string>({"Tanh", "Negative", "Exp"}));
+  EXPECT_EQ(fused.op(1).output(0), "Out");
+  checkSameOutputs(net, fused, {{"A", {3000}}, {"B", {3000}}});
+}
+
+TEST(FuseCPUInference, KeepsUsedIntermediates) {
+  NetDef net;
+  NetMutator(&net)
+      .newOp("FC", {"X", "W", "b"}, {"Y"})
+      .newOp("Relu", {"Y"}, {"Z"})
+      .newOp("Sigmoid", {"Z"}, {"Out"})
+      .externalInputs({"X", "W", "b"})
+      .externalOutputs({"Y", "Out"});
+
+  auto fused = fuse(net);
+  ASSERT_EQ(fused.op_size(), 2);
+  EXPECT_EQ(fused.op(0).type(), "FC");
+  EXPECT_EQ(fused.op(1).type(), "FusedElementwise");
+}
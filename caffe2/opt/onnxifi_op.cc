@@ -2,6 +2,8 @@
 #include "caffe2/operators/slice_op.h"
 #include "caffe2/opt/bound_shape_inferencer.h"
 
+#include <algorithm>
+
 namespace caffe2 {
 
 namespace {
@@ -199,6 +201,63 @@ uint64_t getOnnxifiDataType(caffe2::TensorProto::DataType t) {
 #undef CAFFE2_TO_ONNXIFI_TYPE
 }
 
+// Scales the dims of a shape hint at max_batch_size down to batch_size. The
+// dim types are in `dim_types`, see wrapShapeInfoIntoTensorProto.
+template <typename DimTypes, typename Dims>
+void scaleShapeHintToBatchSize(
+    const DimTypes& dim_types,
+    int max_batch_size,
+    int batch_size,
+    Dims* dims) {
+  for (int j = 0; j < dims->size() && j < dim_types.size(); ++j) {
+    switch (static_cast<TensorBoundShape::DimType>(dim_types.Get(j))) {
+      case TensorBoundShape_DimType_BATCH:
+        dims->Set(j, batch_size);
+        break;
+      case TensorBoundShape_DimType_BATCH_OF_FEATURE_MAX:
+      case TensorBoundShape_DimType_BATCH_OF_FEATURE_MAX_DEFAULT:
+        // Proportional to the batch size
+        dims->Set(
+            j,
+            (dims->Get(j) * batch_size + max_batch_size - 1) / max_batch_size);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+ShapeInfo shapeInfoFromTensorProto(const TensorProto& t) {
+  TensorShape shape;
+  shape.set_data_type(t.data_type());
+  std::vector<TensorBoundShape::DimType> dim_types;
+  for (int j = 0; j < t.dims_size(); ++j) {
+    shape.add_dims(t.dims(j));
+    dim_types.push_back(
+        j < t.int32_data_size()
+            ? static_cast<TensorBoundShape::DimType>(t.int32_data(j))
+            : TensorBoundShape_DimType_CONSTANT);
+  }
+  return ShapeInfo(dim_types, std::move(shape));
+}
+
+ShapeInfo shapeInfoFromQTensorProto(const QTensorProto& t) {
+  TensorShape shape;
+  shape.set_data_type(t.data_type());
+  std::vector<TensorBoundShape::DimType> dim_types;
+  for (int j = 0; j < t.dims_size(); ++j) {
+    shape.add_dims(t.dims(j));
+    dim_types.push_back(
+        j < t.data_size() ? static_cast<TensorBoundShape::DimType>(t.data(j))
+                          : TensorBoundShape_DimType_CONSTANT);
+  }
+  QShapeInfo q_info;
+  q_info.axis = t.axis();
+  q_info.scale.assign(t.scales().begin(), t.scales().end());
+  q_info.offset.assign(t.biases().begin(), t.biases().end());
+  return ShapeInfo(dim_types, std::move(shape), true, q_info);
+}
+
 } // namespace
 
 namespace details {
@@ -297,13 +356,115 @@ details::OutputReshapeInfo OnnxifiOp<CPUContext>::initOutputReshapeInfo()
 }
 
 template <>
-int OnnxifiOp<CPUContext>::extractOutputBatchSizes() {
+void OnnxifiOp<CPUContext>::buildBatchBuckets(
+    Workspace* ws,
+    const std::vector<uint64_t>& property_pointers,
+    std::vector<int> batch_sizes) {
+  std::sort(batch_sizes.begin(), batch_sizes.end());
+  batch_sizes.erase(
+      std::unique(batch_sizes.begin(), batch_sizes.end()), batch_sizes.end());
+  for (const int batch_size : batch_sizes) {
+    CAFFE_ENFORCE_GT(batch_size, 0, "Batch buckets must be positive");
+    if (batch_size >= max_batch_size_) {
+      // Served by the max_batch_size graph
+      continue;
+    }
+
+    // The backend compiles the net at the bounds of its input shape hints, so
+    // the net of the bucket is the same net with the hints at its batch size.
+    NetDef netdef = netdef_;
+    ShapeInfoMap input_shape_info = input_shape_info_;
+    bool has_shape_hints = false;
+    for (auto& arg : *netdef.mutable_arg()) {
+      if (arg.name() == "input_shape_info") {
+        has_shape_hints = true;
+        for (auto& t : *arg.mutable_tensors()) {
+          scaleShapeHintToBatchSize(
+              t.int32_data(), max_batch_size_, batch_size, t.mutable_dims());
+          input_shape_info[t.name()] = shapeInfoFromTensorProto(t);
+        }
+      } else if (arg.name() == "input_qshape_info") {
+        for (auto& t : *arg.mutable_qtensors()) {
+          scaleShapeHintToBatchSize(
+              t.data(), max_batch_size_, batch_size, t.mutable_dims());
+          input_shape_info[t.name()] = shapeInfoFromQTensorProto(t);
+        }
+      }
+    }
+    CAFFE_ENFORCE(
+        has_shape_hints,
+        "batch_buckets requires the input_shape_info of the onnxifi net");
+
+    details::BatchBucket bucket;
+    bucket.batch_size = batch_size;
+    bucket.op_id_string = op_id_string_ + ":" + c10::to_string(batch_size);
+
+    // Output shapes at the batch size of the bucket
+    BoundShapeSpec spec(batch_size, max_seq_size_);
+    auto bound_shape_inferencer =
+        BoundShapeInferencerRegistry()->Create("C10", spec);
+    bound_shape_inferencer->InferBoundShapeAndType(
+        netdef, input_shape_info, nullptr, false);
+    const auto& shape_info = bound_shape_inferencer->shape_info();
+    for (const auto& kv : output_shape_hints_) {
+      const auto it = shape_info.find(output_names_[kv.first]);
+      CAFFE_ENFORCE(
+          it != shape_info.end(),
+          "Cannot infer the shape of ",
+          output_names_[kv.first],
+          " at batch size ",
+          batch_size);
+      details::TensorInfo info(kv.second);
+      info.dims.assign(
+          it->second.shape.dims().begin(), it->second.shape.dims().end());
+      bucket.output_shape_hints.emplace(kv.first, std::move(info));
+    }
+
+    std::string onnx_model_str;
+    CAFFE_ENFORCE(netdef.SerializeToString(&onnx_model_str));
+    bucket.all_scales.reserve(ws->Blobs().size());
+    bucket.all_offsets.reserve(ws->Blobs().size());
+    auto creator = [this, ws, &property_pointers, &onnx_model_str, &bucket]() {
+      return createBackendGraph(
+          ws,
+          property_pointers,
+          onnx_model_str,
+          &bucket.all_scales,
+          &bucket.all_offsets);
+    };
+    bucket.backend_graph_shared_ptr =
+        backend_graph_map_ptr_->insert(bucket.op_id_string, creator);
+    batch_buckets_.push_back(std::move(bucket));
+  }
+}
+
+template <>
+const details::BatchBucket* OnnxifiOp<CPUContext>::selectBatchBucket() const {
+  if (batch_buckets_.empty()) {
+    return nullptr;
+  }
+  const auto& t = Input(nominal_batch_idx_);
+  CAFFE_ENFORCE(
+      !t.sizes().empty(), input_names_[nominal_batch_idx_], " cannot be empty");
+  const int current_batch_size = t.size(0);
+  const auto it = std::lower_bound(
+      batch_buckets_.begin(),
+      batch_buckets_.end(),
+      current_batch_size,
+      [](const details::BatchBucket& bucket, int batch_size) {
+        return bucket.batch_size < batch_size;
+      });
+  return it == batch_buckets_.end() ? nullptr : &*it;
+}
+
+template <>
+int OnnxifiOp<CPUContext>::extractOutputBatchSizes(int graph_batch_size) {
   if (use_onnx_ || !adjust_output_batch_) {
     return max_batch_size_;
   }
 
-  // Get the real batch size from nominal input. If it's equal to
-  // max_batch_size, mark that we don't need to adjust batch size and return.
+  // Get the real batch size from nominal input. If it's equal to the batch
+  // size of the graph, mark that we don't need to adjust batch size and return.
   // Otherwise, do a pass of shape inference to get the real shapes of the
   // outputs.
   const auto& t = Input(nominal_batch_idx_);
@@ -312,8 +473,8 @@ int OnnxifiOp<CPUContext>::extractOutputBatchSizes() {
   const auto dims = t.sizes();
   const int current_batch_size = dims[0];
 
-  if (current_batch_size == max_batch_size_) {
-    return max_batch_size_;
+  if (current_batch_size == graph_batch_size) {
+    return graph_batch_size;
   }
 
   // We still need to adjust output size but we can skip the shape inference as
@@ -413,13 +574,15 @@ void OnnxifiOp<CPUContext>::adjustOutputBatchSizes(int current_batch_size) {
 }
 
 template <>
-void OnnxifiOp<CPUContext>::setOutputShapeAndType(int output_idx) {
+void OnnxifiOp<CPUContext>::setOutputShapeAndType(
+    int output_idx,
+    const std::unordered_map<int, details::TensorInfo>& output_shape_hints) {
   tensor_dims_int64_.clear();
   std::vector<size_t> tensor_dims;
   uint64_t type = ONNXIFI_DATATYPE_FLOAT32;
-  const auto it = output_shape_hints_.find(output_idx);
+  const auto it = output_shape_hints.find(output_idx);
   CAFFE_ENFORCE(
-      it != output_shape_hints_.end(),
+      it != output_shape_hints.end(),
       "Cannot find shape hint for output: ",
       output_names_[output_idx]);
   const auto& info = it->second;
@@ -487,15 +650,23 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     setInputTensorDescriptorTypeAndBuffer(input_tensor, &tensor_descriptor);
   }
 
+  // Run the graph of the smallest batch size bucket that fits the inputs
+  const details::BatchBucket* bucket = selectBatchBucket();
+  const int graph_batch_size = bucket ? bucket->batch_size : max_batch_size_;
+  onnxBackend backend =
+      bucket ? bucket->backend_graph_shared_ptr->backend : backend_;
+  onnxGraph graph = bucket ? bucket->backend_graph_shared_ptr->graph : graph_;
+
   CAFFE_ENFORCE_EQ(output_desc_.size(), OutputSize());
   for (unsigned i = 0U; i < OutputSize(); ++i) {
-    setOutputShapeAndType(i);
+    setOutputShapeAndType(
+        i, bucket ? bucket->output_shape_hints : output_shape_hints_);
   }
   bool ext_supported = false;
   onnxMemoryFenceV1 input_fence;
   onnxMemoryFenceV1 output_fence;
   std::vector<int> output_batch_sizes;
-  int current_batch_size = max_batch_size_;
+  int current_batch_size = graph_batch_size;
 #ifdef ONNXIFI_ENABLE_EXT
   /**
    * If onnxifi extension mode is enabled,
@@ -521,7 +692,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     }
     CAFFE_ENFORCE_EQ(
         (*onnxSetIOAndRunGraphPointer_)(
-            graph_,
+            graph,
             input_desc_.size(),
             input_desc_.data(),
             output_desc_.size(),
@@ -529,7 +700,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
             &output_fence,
             traces_.get()),
         ONNXIFI_STATUS_SUCCESS);
-    current_batch_size = extractOutputBatchSizes();
+    current_batch_size = extractOutputBatchSizes(graph_batch_size);
     onnxEventState eventState;
     onnxStatus eventStatus;
     CAFFE_ENFORCE_EQ(
@@ -550,7 +721,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
   if (!ext_supported) {
     CAFFE_ENFORCE_EQ(
         lib_->onnxSetGraphIO(
-            graph_,
+            graph,
             input_desc_.size(),
             input_desc_.data(),
             output_desc_.size(),
@@ -560,7 +731,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     input_fence.tag = ONNXIFI_TAG_MEMORY_FENCE_V1;
     input_fence.type = ONNXIFI_SYNCHRONIZATION_EVENT;
     CAFFE_ENFORCE_EQ(
-        lib_->onnxInitEvent(backend_, &input_fence.event),
+        lib_->onnxInitEvent(backend, &input_fence.event),
         ONNXIFI_STATUS_SUCCESS);
     output_fence.tag = ONNXIFI_TAG_MEMORY_FENCE_V1;
     output_fence.type = ONNXIFI_SYNCHRONIZATION_EVENT;
@@ -568,11 +739,11 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     // Call the async run on backend, signal event on input fence and wait for
     // the event on output fence
     CAFFE_ENFORCE_EQ(
-        lib_->onnxRunGraph(graph_, &input_fence, &output_fence),
+        lib_->onnxRunGraph(graph, &input_fence, &output_fence),
         ONNXIFI_STATUS_SUCCESS);
     CAFFE_ENFORCE_EQ(
         lib_->onnxSignalEvent(input_fence.event), ONNXIFI_STATUS_SUCCESS);
-    current_batch_size = extractOutputBatchSizes();
+    current_batch_size = extractOutputBatchSizes(graph_batch_size);
     CAFFE_ENFORCE_EQ(
         lib_->onnxWaitEvent(output_fence.event), ONNXIFI_STATUS_SUCCESS);
 
@@ -593,7 +764,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     }
   }
 
-  if (adjust_output_batch_ && current_batch_size != max_batch_size_) {
+  if (adjust_output_batch_ && current_batch_size != graph_batch_size) {
     adjustOutputBatchSizes(current_batch_size);
   }
   enable_tracing_ = false;
@@ -615,5 +786,8 @@ OPERATOR_SCHEMA(Onnxifi)
         "Initialization pair indicating the mapping of the name between NetDef and ONNX model")
     .Arg(
         "output_resize_hints",
-        "A list of key/value pairs indicating which input index to look up for real batch size for the given max output batch size");
+        "A list of key/value pairs indicating which input index to look up for real batch size for the given max output batch size")
+    .Arg(
+        "batch_buckets",
+        "(list of int) Batch sizes below max_batch_size to compile a graph for upfront. Each run uses the graph of the smallest batch size that fits the input batch. Requires adjust_output_batch");
 } // namespace caffe2
@@ -35,9 +35,24 @@ struct TensorInfo {
   std::vector<int32_t> biases;
   explicit TensorInfo(const TensorProto& t);
   explicit TensorInfo(const QTensorProto& t);
+  TensorInfo(const TensorInfo&) = default;
   TensorInfo(TensorInfo&&) = default;
   TensorInfo& operator=(TensorInfo&&) = default;
 };
+
+/// A backend graph compiled for a batch size below max_batch_size, so that
+/// smaller batches don't pay for the whole max_batch_size graph. Inputs of up
+/// to batch_size are routed to the graph of the smallest bucket that fits.
+struct BatchBucket {
+  int batch_size;
+  std::string op_id_string;
+  onnx::SharedPtrBackendGraphInfo backend_graph_shared_ptr;
+  // Output shape hints at batch_size
+  std::unordered_map<int, TensorInfo> output_shape_hints;
+  // Multi group quantization info of the weights of the graph
+  std::vector<std::vector<float>> all_scales;
+  std::vector<std::vector<int32_t>> all_offsets;
+};
 } // namespace details
 
 template <typename Context>
@@ -138,9 +153,24 @@ class OnnxifiOp final : public Operator<Context> {
     // cached backend and therefore there is no need to repeat the above
     // process.
     buildBackendAndGraph(ws, property_pointers, onnx_model_str);
+
+    // Compile a graph for every batch size bucket upfront, so that the run
+    // only picks one of them and never waits on the backend compiler.
+    auto batch_buckets =
+        this->template GetRepeatedArgument<int>("batch_buckets");
+    if (!batch_buckets.empty()) {
+      CAFFE_ENFORCE(
+          !use_onnx_ && adjust_output_batch_,
+          "batch_buckets requires a Caffe2 model and adjust_output_batch");
+      buildBatchBuckets(ws, property_pointers, batch_buckets);
+    }
   }
 
   ~OnnxifiOp() {
+    for (auto& bucket : batch_buckets_) {
+      bucket.backend_graph_shared_ptr.reset();
+      backend_graph_map_ptr_->remove(bucket.op_id_string);
+    }
     backend_graph_shared_ptr_.reset();
     backend_graph_map_ptr_->remove(op_id_string_);
 #ifdef ONNXIFI_ENABLE_EXT
@@ -160,7 +190,9 @@ class OnnxifiOp final : public Operator<Context> {
   }
 #endif
  private:
-  void setOutputShapeAndType(int output_idx);
+  void setOutputShapeAndType(
+      int output_idx,
+      const std::unordered_map<int, details::TensorInfo>& output_shape_hints);
 
   void buildPropertyList(
       const OperatorDef& /* unused */,
@@ -178,95 +210,9 @@ class OnnxifiOp final : public Operator<Context> {
         this->template GetSingleArgument<std::string>("model_id", "") + ":" +
         this->template GetSingleArgument<std::string>("net_pos", "");
 
-    auto initializers =
-        this->template GetRepeatedArgument<std::string>("initializers");
-    // Build the Onnxifi engine
-    auto backend_index = this->template GetSingleArgument<int>("backend_id", 0);
-    auto creator = [this,
-                    ws,
-                    property_pointers,
-                    backend_index,
-                    &onnx_model_str,
-                    &initializers]() {
-      std::vector<onnxBackendID> backend_ids;
-      size_t num_backends{0};
-      CAFFE_ENFORCE_EQ(
-          lib_->onnxGetBackendIDs(nullptr, &num_backends),
-          ONNXIFI_STATUS_FALLBACK);
-      CAFFE_ENFORCE_GT(
-          num_backends, 0, "At least 1 onnxifi backend should be available");
-      CAFFE_ENFORCE_LT(
-          backend_index,
-          num_backends,
-          "Backend idx out of bound: ",
-          backend_index,
-          ", #backends: ",
-          num_backends);
-      backend_ids.resize(num_backends);
-      CAFFE_ENFORCE_EQ(
-          lib_->onnxGetBackendIDs(backend_ids.data(), &num_backends),
-          ONNXIFI_STATUS_SUCCESS);
-
-      onnxBackendID backend_id = backend_ids[backend_index];
-      onnxBackend backend{nullptr};
-
-      CAFFE_ENFORCE_EQ(
-          lib_->onnxInitBackend(backend_id, property_pointers.data(), &backend),
-          ONNXIFI_STATUS_SUCCESS);
-
-      // Release unused backend ids.
-      for (size_t i = 0; i < num_backends; ++i) {
-        if (i == backend_index) {
-          continue;
-        }
-        lib_->onnxReleaseBackendID(backend_ids[i]);
-      }
-
-      // Get weights
-      std::vector<std::string> weight_names;
-      std::vector<std::vector<uint64_t>> weight_shapes;
-      auto weight_descs = buildInitializationList(
-          ws,
-          initializers,
-          &weight_names,
-          &weight_shapes,
-          &all_scales_,
-          &all_offsets_);
-
-      // Extra weight shapes
-      std::unordered_map<std::string, ShapeInfo> weight_shape_info;
-      for (size_t i = 0; i < weight_names.size(); ++i) {
-        TensorShape shape;
-        const auto& shape0 = weight_shapes[i];
-        for (const auto d : shape0) {
-          shape.add_dims(d);
-        }
-        weight_shape_info[weight_names[i]] = ShapeInfo(
-            std::vector<TensorBoundShape::DimType>(
-                shape0.size(), TensorBoundShape_DimType_CONSTANT),
-            std::move(shape));
-      }
-
-      Blob* defered_blob_reader = nullptr;
-      if (ws->HasBlob("__DEFERRED_BLOB_READER__")) {
-        defered_blob_reader = ws->GetBlob("__DEFERRED_BLOB_READER__");
-      }
-      onnxGraph graph{nullptr};
-      CAFFE_ENFORCE_EQ(
-          lib_->onnxInitGraph(
-              backend,
-              nullptr,
-              onnx_model_str.size(),
-              (const void*)(onnx_model_str.c_str()),
-              weight_descs.size(),
-              weight_descs.data(),
-              &graph,
-              static_cast<uint32_t>(max_seq_size_),
-              defered_blob_reader),
-          ONNXIFI_STATUS_SUCCESS);
-
-      return std::make_shared<onnx::BackendGraphInfo>(
-          backend_id, backend, graph, lib_, std::move(weight_shape_info));
+    auto creator = [this, ws, &property_pointers, &onnx_model_str]() {
+      return createBackendGraph(
+          ws, property_pointers, onnx_model_str, &all_scales_, &all_offsets_);
     };
     backend_graph_shared_ptr_ =
         backend_graph_map_ptr_->insert(op_id_string_, creator);
@@ -279,6 +225,109 @@ class OnnxifiOp final : public Operator<Context> {
     getExtFunctionPointers();
   }
 
+  /// Initializes a backend and builds the graph of `onnx_model_str` on it,
+  /// with the weights from the workspace.
+  onnx::SharedPtrBackendGraphInfo createBackendGraph(
+      Workspace* ws,
+      const std::vector<uint64_t>& property_pointers,
+      const std::string& onnx_model_str,
+      std::vector<std::vector<float>>* all_scales,
+      std::vector<std::vector<int32_t>>* all_offsets) {
+    auto initializers =
+        this->template GetRepeatedArgument<std::string>("initializers");
+    // Build the Onnxifi engine
+    auto backend_index = this->template GetSingleArgument<int>("backend_id", 0);
+    std::vector<onnxBackendID> backend_ids;
+    size_t num_backends{0};
+    CAFFE_ENFORCE_EQ(
+        lib_->onnxGetBackendIDs(nullptr, &num_backends),
+        ONNXIFI_STATUS_FALLBACK);
+    CAFFE_ENFORCE_GT(
+        num_backends, 0, "At least 1 onnxifi backend should be available");
+    CAFFE_ENFORCE_LT(
+        backend_index,
+        num_backends,
+        "Backend idx out of bound: ",
+        backend_index,
+        ", #backends: ",
+        num_backends);
+    backend_ids.resize(num_backends);
+    CAFFE_ENFORCE_EQ(
+        lib_->onnxGetBackendIDs(backend_ids.data(), &num_backends),
+        ONNXIFI_STATUS_SUCCESS);
+
+    onnxBackendID backend_id = backend_ids[backend_index];
+    onnxBackend backend{nullptr};
+
+    CAFFE_ENFORCE_EQ(
+        lib_->onnxInitBackend(backend_id, property_pointers.data(), &backend),
+        ONNXIFI_STATUS_SUCCESS);
+
+    // Release unused backend ids.
+    for (size_t i = 0; i < num_backends; ++i) {
+      if (i == backend_index) {
+        continue;
+      }
+      lib_->onnxReleaseBackendID(backend_ids[i]);
+    }
+
+    // Get weights
+    std::vector<std::string> weight_names;
+    std::vector<std::vector<uint64_t>> weight_shapes;
+    auto weight_descs = buildInitializationList(
+        ws,
+        initializers,
+        &weight_names,
+        &weight_shapes,
+        all_scales,
+        all_offsets);
+
+    // Extra weight shapes
+    std::unordered_map<std::string, ShapeInfo> weight_shape_info;
+    for (size_t i = 0; i < weight_names.size(); ++i) {
+      TensorShape shape;
+      const auto& shape0 = weight_shapes[i];
+      for (const auto d : shape0) {
+        shape.add_dims(d);
+      }
+      weight_shape_info[weight_names[i]] = ShapeInfo(
+          std::vector<TensorBoundShape::DimType>(
+              shape0.size(), TensorBoundShape_DimType_CONSTANT),
+          std::move(shape));
+    }
+
+    Blob* defered_blob_reader = nullptr;
+    if (ws->HasBlob("__DEFERRED_BLOB_READER__")) {
+      defered_blob_reader = ws->GetBlob("__DEFERRED_BLOB_READER__");
+    }
+    onnxGraph graph{nullptr};
+    CAFFE_ENFORCE_EQ(
+        lib_->onnxInitGraph(
+            backend,
+            nullptr,
+            onnx_model_str.size(),
+            (const void*)(onnx_model_str.c_str()),
+            weight_descs.size(),
+            weight_descs.data(),
+            &graph,
+            static_cast<uint32_t>(max_seq_size_),
+            defered_blob_reader),
+        ONNXIFI_STATUS_SUCCESS);
+
+    return std::make_shared<onnx::BackendGraphInfo>(
+        backend_id, backend, graph, lib_, std::move(weight_shape_info));
+  }
+
+  /// Builds the graphs of batch_buckets_, see details::BatchBucket.
+  void buildBatchBuckets(
+      Workspace* ws,
+      const std::vector<uint64_t>& property_pointers,
+      std::vector<int> batch_sizes);
+
+  /// Returns the smallest bucket that fits the batch of the nominal input, or
+  /// nullptr if only the max_batch_size graph does.
+  const details::BatchBucket* selectBatchBucket() const;
+
   /// Set up function pointer if onnxifi_ext is enabled
   void getExtFunctionPointers() {
 #ifdef ONNXIFI_ENABLE_EXT
@@ -313,9 +362,9 @@ class OnnxifiOp final : public Operator<Context> {
   }
 
   /// Extract output batch size. If the output batch size is going to be at
-  /// max_batch_size_, return true indicating that no output shape adjustment is
-  /// needed. Otherwise, return false.
-  int extractOutputBatchSizes();
+  /// graph_batch_size, the batch size the graph was run at, no output shape
+  /// adjustment is needed.
+  int extractOutputBatchSizes(int graph_batch_size);
 
   /// Adjust output tensor shape based on the current input batch size.
   /// If the output shape is conditioned on first dim (batch size), we have a
@@ -426,6 +475,9 @@ class OnnxifiOp final : public Operator<Context> {
   // Whether we need to resize outputs or not
   bool adjust_output_batch_{false};
 
+  // Graphs for batches smaller than max_batch_size, sorted by batch size
+  std::vector<details::BatchBucket> batch_buckets_;
+
   // Whether we enable tracing in one run of inference
   bool enable_tracing_{false};
 
@@ -7,30 +7,96 @@ import sys
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
 
+class Isa(object):
+    """The vector registers and intrinsics the kernels are generated with."""
+
+    def __init__(
+        self,
+        name,
+        suffix,
+        width,
+        vec,
+        prefix,
+        half_load,
+        uint8_load,
+        half_load_generic,
+        uint8_load_generic,
+    ):
+        self.name = name
+        # suffix of the generated functions, see perfkernels/common.h
+        self.suffix = suffix
+        # number of floats in a register
+        self.width = width
+        self.vec = vec
+        self.prefix = prefix
+        # expressions loading (and converting to float) `width` elements of
+        # the given type at %s
+        self.half_load = half_load
+        self.uint8_load = uint8_load
+        # same, laid out for the deeper indentation of generic()
+        self.half_load_generic = half_load_generic
+        self.uint8_load_generic = uint8_load_generic
+
+
+isas = {
+    "avx2": Isa(
+        "AVX2",
+        "__avx2_fma",
+        8,
+        "__m256",
+        "_mm256",
+        "_mm256_cvtph_ps(\n"
+        "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(%s)))",
+        "_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
+        "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(%s))))",
+        "_mm256_cvtph_ps(_mm_loadu_si128(\n"
+        "                      reinterpret_cast<const __m128i*>(%s)))",
+        "_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"
+        "                      reinterpret_cast<const __m128i*>(%s))))",
+    ),
+    "avx512": Isa(
+        "AVX512",
+        "__avx512",
+        16,
+        "__m512",
+        "_mm512",
+        "_mm512_cvtph_ps(\n"
+        "                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(%s)))",
+        "_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(\n"
+        "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(%s))))",
+        "_mm512_cvtph_ps(_mm256_loadu_si256(\n"
+        "                      reinterpret_cast<const __m256i*>(%s)))",
+        "_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(\n"
+        "                      reinterpret_cast<const __m128i*>(%s))))",
+    ),
+}
+
+
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
+        ip = "ip + (%d)" % regid
         if InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
-                % (regid, regid, regid)
+                "        vop%d = %s_fmadd_ps(vwgt, %s_loadu_ps(%s), vop%d);"  # noqa
+                % (regid, isa.prefix, isa.prefix, ip, regid)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                "            %s,\n"
+                "            vop%d);"
+                % (regid, isa.prefix, isa.half_load % ip, regid)
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                "            %s,\n"
+                "            %s_add_ps(vop%d, vbio));"
+                % (regid, isa.prefix, isa.uint8_load % ip, isa.prefix, regid)
             )
         else:
             assert False
@@ -66,8 +132,10 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = isa.width * i
+        code.append(
+            "      " + isa.vec + " vop" + str(j) + " = " + isa.prefix + "_setzero_ps();"
+        )
 
     # inner loop
     if use_offsets:
@@ -120,7 +188,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        {} vbio = {}_set1_ps(bio);".format(isa.vec, isa.prefix))
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -128,7 +196,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa.vec, isa.prefix))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -150,7 +218,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = isa.width * i
         cachelinesize = 64
         byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
@@ -162,20 +230,32 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = isa.width * i
+        code.append(
+            "        " + isa.prefix + "_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");"
+        )
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / length);".format(isa.vec, isa.prefix)
+        )
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / lengths[rangeIndex]);".format(
+                isa.vec, isa.prefix
+            )
+        )
     for i in range(0, uf):
-        j = 8 * i
+        j = isa.width * i
         code.append(
-            "        _mm256_storeu_ps(&op["
+            "        "
+            + isa.prefix
+            + "_storeu_ps(&op["
             + str(j)
-            + "], _mm256_mul_ps("
+            + "], "
+            + isa.prefix
+            + "_mul_ps("
             + "vop"
             + str(j)
             + ", vlen_inv));"
@@ -191,30 +271,37 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         code = []
         if InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                "              %s_fmadd_ps(\n"
+                "                  vwgt, %s_loadu_ps(&ip[j]), %s_loadu_ps(&op[j])));"  # noqa
+                % ((isa.prefix,) * 4)
             )
         elif InType == "at::Half":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                "                  %s,\n"
+                "                  %s_loadu_ps(&op[j])));"
+                % (isa.prefix, isa.prefix, isa.half_load_generic % "&ip[j]", isa.prefix)
             )
         elif InType == "uint8_t":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
-                "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                "                  %s,\n"
+                "                  %s_add_ps(%s_loadu_ps(&op[j]), vbio)));"
+                % (
+                    isa.prefix,
+                    isa.prefix,
+                    isa.uint8_load_generic % "&ip[j]",
+                    isa.prefix,
+                    isa.prefix,
+                )
             )
         else:
             assert False
@@ -249,8 +336,12 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append(
+        "      for (; j + {0} <= block_size; j += {0}) {{".format(isa.width)
+    )
+    code.append(
+        "        {0}_storeu_ps(op + j, {0}_setzero_ps());".format(isa.prefix)
+    )
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -307,7 +398,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        {} vbio = {}_set1_ps(bio);".format(isa.vec, isa.prefix))
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -315,7 +406,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa.vec, isa.prefix))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -337,7 +428,9 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append(
+        "        for (; j + {0} <= block_size; j += {0}) {{".format(isa.width)
+    )
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
@@ -366,12 +459,16 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append("        {} vlen_inv = {}_set1_ps(len_inv);".format(isa.vec, isa.prefix))
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "        for (; j + {0} <= block_size; j += {0}) {{".format(isa.width)
+    )
+    code.append(
+        "          {0}_storeu_ps(\n"
+        "              &op[j], {0}_mul_ps({0}_loadu_ps(&op[j]), vlen_inv));".format(
+            isa.prefix
+        )
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -389,19 +486,27 @@ parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(isas.keys()), default="avx2")
+parser.add_argument(
+    "--prefetch-distance",
+    type=int,
+    default=16,
+    help="how many indices ahead the rows are prefetched",
+)
 opts = parser.parse_args()
+isa = isas[opts.isa]
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
@@ -438,7 +543,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa.suffix
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -460,7 +565,9 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
+    code.append(
+        "  const " + IndexType + " prefdist_T0 = " + str(opts.prefetch_distance) + ";"
+    )
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
@@ -474,17 +581,24 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    # the common block sizes are fully unrolled
+    for i, block_size in enumerate([128, 64, 32, 16]):
+        code.append(
+            "  {}if (block_size == {}) {{".format("} else " if i else "", block_size)
+        )
+        code += unroll(
+            block_size // isa.width,
+            IndexType,
+            InType,
+            OutType,
+            True,
+            isa,
+            opts.fused,
+            opts.use_offsets,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(IndexType, InType, OutType, True, isa, opts.fused, opts.use_offsets)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
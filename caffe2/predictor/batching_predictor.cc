@@ -0,0 +1,202 @@
+#include "caffe2/predictor/batching_predictor.h"
+
+#include "caffe2/core/context.h"
+
+namespace caffe2 {
+
+namespace {
+
+int64_t batchSize(const Predictor::TensorList& inputs) {
+  CAFFE_ENFORCE(!inputs.empty(), "BatchingPredictor requires inputs");
+  int64_t batch_size = -1;
+  for (const auto& input : inputs) {
+    CAFFE_ENFORCE_GE(
+        input.dim(), 1, "BatchingPredictor inputs require a batch dimension");
+    if (batch_size < 0) {
+      batch_size = input.size(0);
+    } else {
+      CAFFE_ENFORCE_EQ(
+          input.size(0),
+          batch_size,
+          "The inputs of a request must have the same batch size");
+    }
+  }
+  return batch_size;
+}
+
+// Whether the inputs only differ by their batch size
+bool canBatch(
+    const Predictor::TensorList& lhs,
+    const Predictor::TensorList& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (lhs[i].dtype() != rhs[i].dtype() ||
+        lhs[i].sizes().slice(1) != rhs[i].sizes().slice(1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+BatchingPredictor::BatchingPredictor(
+    Predictor* predictor,
+    BatchingPredictorOptions options)
+    : predictor_(predictor), options_(options) {
+  CAFFE_ENFORCE(predictor_, "BatchingPredictor requires a predictor");
+  CAFFE_ENFORCE_GT(options_.max_batch_size, 0);
+  worker_ = std::thread(&BatchingPredictor::workerLoop, this);
+}
+
+BatchingPredictor::~BatchingPredictor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  // the queued requests still run
+  worker_.join();
+}
+
+bool BatchingPredictor::operator()(
+    const TensorList& inputs,
+    TensorList* outputs) {
+  CAFFE_ENFORCE(outputs);
+  outputs->clear();
+  Request request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+  request.batch_size = batchSize(inputs);
+  request.enqueue_time = std::chrono::steady_clock::now();
+  auto done = request.done.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CAFFE_ENFORCE(!stop_, "BatchingPredictor is being destroyed");
+    queue_.push_back(&request);
+  }
+  cv_.notify_all();
+  return done.get();
+}
+
+std::vector<size_t> BatchingPredictor::nextBatch(int64_t* rows) const {
+  // Requests are taken in order, skipping the ones that can't be batched
+  // with the first one, until the next one would overflow the batch
+  std::vector<size_t> batch;
+  *rows = 0;
+  for (size_t i = 0; i < queue_.size(); ++i) {
+    const auto* request = queue_[i];
+    if (!batch.empty() &&
+        !canBatch(*queue_[batch.front()]->inputs, *request->inputs)) {
+      continue;
+    }
+    if (!batch.empty() &&
+        *rows + request->batch_size > options_.max_batch_size) {
+      break;
+    }
+    batch.push_back(i);
+    *rows += request->batch_size;
+  }
+  return batch;
+}
+
+void BatchingPredictor::workerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    const auto deadline = queue_.front()->enqueue_time + options_.max_delay;
+    cv_.wait_until(lock, deadline, [this] {
+      int64_t rows = 0;
+      nextBatch(&rows);
+      return stop_ || rows >= options_.max_batch_size;
+    });
+
+    int64_t rows = 0;
+    const auto indices = nextBatch(&rows);
+    std::vector<Request*> batch;
+    batch.reserve(indices.size());
+    for (auto it = indices.rbegin(); it != indices.rend(); ++it) {
+      batch.push_back(queue_[*it]);
+      queue_.erase(queue_.begin() + *it);
+    }
+    std::reverse(batch.begin(), batch.end());
+
+    lock.unlock();
+    runBatch(batch, rows);
+    lock.lock();
+  }
+}
+
+void BatchingPredictor::runBatch(
+    const std::vector<Request*>& batch,
+    int64_t rows) {
+  try {
+    CPUContext context;
+    const auto& first_inputs = *batch.front()->inputs;
+    TensorList inputs;
+    inputs.reserve(first_inputs.size());
+    for (size_t i = 0; i < first_inputs.size(); ++i) {
+      if (batch.size() == 1) {
+        inputs.emplace_back(first_inputs[i].UnsafeSharedInstance());
+        continue;
+      }
+      auto dims = first_inputs[i].sizes().vec();
+      dims[0] = rows;
+      const auto& meta = first_inputs[i].dtype();
+      Tensor input = empty(dims, at::dtype(meta).device(CPU));
+      auto* dst = static_cast<char*>(input.raw_mutable_data(meta));
+      for (const auto* request : batch) {
+        const auto& part = (*request->inputs)[i];
+        context.CopyItemsSameDevice(meta, part.numel(), part.raw_data(), dst);
+        dst += part.nbytes();
+      }
+      inputs.emplace_back(std::move(input));
+    }
+
+    TensorList outputs;
+    const bool success = (*predictor_)(inputs, &outputs);
+    if (success) {
+      // the outputs are owned by the predictor's workspace, and are
+      // overwritten by its next run
+      for (const auto& output : outputs) {
+        CAFFE_ENFORCE(
+            output.dim() >= 1 && output.size(0) == rows,
+            "BatchingPredictor outputs must have the batch size of the "
+            "inputs, expected ",
+            rows,
+            " got ",
+            output.sizes());
+        const auto& meta = output.dtype();
+        const auto row_numel = output.size_from_dim(1);
+        const auto* src = static_cast<const char*>(output.raw_data());
+        for (auto* request : batch) {
+          auto dims = output.sizes().vec();
+          dims[0] = request->batch_size;
+          Tensor part = empty(dims, at::dtype(meta).device(CPU));
+          context.CopyItemsSameDevice(
+              meta,
+              request->batch_size * row_numel,
+              src,
+              part.raw_mutable_data(meta));
+          src += part.nbytes();
+          request->outputs->emplace_back(std::move(part));
+        }
+      }
+    }
+    for (auto* request : batch) {
+      request->done.set_value(success);
+    }
+  } catch (...) {
+    for (auto* request : batch) {
+      request->outputs->clear();
+      request->done.set_exception(std::current_exception());
+    }
+  }
+}
+
+} // namespace caffe2
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "caffe2/predictor/predictor.h"
+
+namespace caffe2 {
+
+struct BatchingPredictorOptions {
+  // A batch runs once it has at least this many rows
+  int64_t max_batch_size = 32;
+  // or once its first request waited this long
+  std::chrono::microseconds max_delay{1000};
+};
+
+/*
+ * A thread-safe front end to a Predictor, batching concurrent requests.
+ *
+ * Requests are queued, and a worker thread concatenates the inputs of the
+ * queued requests along their first (batch) dimension, runs the predictor
+ * once on the batch, and splits its outputs along their first dimension
+ * back into the outputs of each request. A batch is run as soon as it has
+ * max_batch_size rows, or when its first request has waited max_delay.
+ * A request is never split, and requests whose inputs don't have the same
+ * number, types and non-batch dimensions as those of the first request of
+ * the batch go into a later batch.
+ *
+ * The outputs of the net must have the batch dimension of the inputs.
+ * The predictor must outlive the BatchingPredictor, and must not be run
+ * directly meanwhile.
+ */
+class CAFFE2_API BatchingPredictor {
+ public:
+  using TensorList = Predictor::TensorList;
+
+  BatchingPredictor(
+      Predictor* predictor,
+      BatchingPredictorOptions options = BatchingPredictorOptions());
+
+  ~BatchingPredictor();
+
+  // Same as Predictor::operator(), except that the outputs are owned by the
+  // caller. Blocks until the batch of the request ran, and rethrows the
+  // exception of the batch, if any.
+  bool operator()(const TensorList& inputs, TensorList* outputs);
+
+ private:
+  struct Request {
+    const TensorList* inputs;
+    TensorList* outputs;
+    int64_t batch_size;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::promise<bool> done;
+  };
+
+  // Returns the indices in the queue of the requests of the next batch, and
+  // its number of rows. Requires mutex_.
+  std::vector<size_t> nextBatch(int64_t* rows) const;
+  void workerLoop();
+  void runBatch(const std::vector<Request*>& batch, int64_t rows);
+
+  Predictor* predictor_;
+  const BatchingPredictorOptions options_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request*> queue_;
+  bool stop_ = false;
+  std::thread worker_;
+
+  C10_DISABLE_COPY_AND_ASSIGN(BatchingPredictor);
+};
+
+} // namespace caffe2
@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "caffe2/core/timer.h"
+#include "caffe2/predictor/batching_predictor.h"
+#include "caffe2/predictor/emulator/data_filler.h"
+#include "caffe2/predictor/emulator/emulator.h"
+
+namespace caffe2 {
+namespace emulator {
+
+/*
+ * A load generator for a BatchingPredictor: @threads client threads send
+ * concurrent requests, whose inputs are generated by @filler, until
+ * @iterations requests ran. The latencies of the requests of the last run
+ * are kept, e.g. to compare batching options under the same load.
+ */
+class BatchingPredictorEmulator : public Emulator {
+ public:
+  BatchingPredictorEmulator(
+      BatchingPredictor* predictor,
+      const Filler* filler,
+      int threads)
+      : predictor_(predictor), filler_(filler), threads_(threads) {
+    CAFFE_ENFORCE(predictor_, "predictor is null");
+    CAFFE_ENFORCE(filler_, "filler is null");
+    CAFFE_ENFORCE_GT(threads_, 0);
+  }
+
+  void init() override {
+    inputs_.resize(threads_);
+    for (auto& inputs : inputs_) {
+      filler_->fill_input(&inputs);
+    }
+  }
+
+  void run(const uint64_t iterations) override {
+    CAFFE_ENFORCE_EQ(
+        inputs_.size(), static_cast<size_t>(threads_), "init() wasn't called");
+    latencies_ms_.clear();
+    latencies_ms_.reserve(iterations);
+    std::atomic<uint64_t> next_request{0};
+    std::vector<std::thread> clients;
+    for (int thread = 0; thread < threads_; ++thread) {
+      clients.emplace_back([this, thread, iterations, &next_request]() {
+        std::vector<float> latencies_ms;
+        TensorList_t outputs;
+        while (next_request++ < iterations) {
+          Timer timer;
+          CAFFE_ENFORCE((*predictor_)(inputs_[thread], &outputs));
+          latencies_ms.push_back(timer.MilliSeconds());
+        }
+        std::lock_guard<std::mutex> lock(latencies_mutex_);
+        latencies_ms_.insert(
+            latencies_ms_.end(), latencies_ms.begin(), latencies_ms.end());
+      });
+    }
+    for (auto& client : clients) {
+      client.join();
+    }
+    std::sort(latencies_ms_.begin(), latencies_ms_.end());
+    if (!latencies_ms_.empty()) {
+      LOG(INFO) << "Request latency p50: " << latency_percentile_ms(50)
+                << " ms, p99: " << latency_percentile_ms(99) << " ms";
+    }
+  }
+
+  // Returns the latency of the given percentile of the last run, in ms
+  float latency_percentile_ms(int percentile) const {
+    CAFFE_ENFORCE(!latencies_ms_.empty(), "No request ran");
+    const auto index = std::min(
+        latencies_ms_.size() - 1, latencies_ms_.size() * percentile / 100);
+    return latencies_ms_[index];
+  }
+
+ private:
+  BatchingPredictor* predictor_;
+  const Filler* filler_;
+  const int threads_;
+  std::vector<TensorList_t> inputs_;
+  std::mutex latencies_mutex_;
+  std::vector<float> latencies_ms_;
+};
+
+} // namespace emulator
+} // namespace caffe2
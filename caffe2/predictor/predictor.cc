@@ -21,8 +21,8 @@ Blob* getBlob(Workspace* ws, const std::string& name) {
   return blob;
 }
 
-const Tensor& getTensor(Workspace* ws, const std::string& name) {
-  return *BlobGetMutableTensor(getBlob(ws, name), CPU);
+const Tensor& getTensor(Blob* blob) {
+  return *BlobGetMutableTensor(blob, CPU);
 }
 
 } // namespace
@@ -51,6 +51,41 @@ Predictor::Predictor(PredictorConfig config) : config_(std::move(config)) {
     }
   }
   CAFFE_ENFORCE(config_.ws->CreateNet(config_.predict_net));
+
+  // The net has created its outputs by now
+  auto resolve = [&](const std::string& name) {
+    auto it = resolved_blobs_.find(name);
+    if (it == resolved_blobs_.end()) {
+      Blob* blob =
+          config_.ws->HasBlob(name) ? config_.ws->GetBlob(name) : nullptr;
+      it = resolved_blobs_.emplace(name, blob).first;
+    }
+    return it->second;
+  };
+  for (const auto& name : config_.predict_net->external_input()) {
+    input_blobs_.push_back(resolve(name));
+  }
+  for (const auto& name : config_.predict_net->external_output()) {
+    output_blobs_.push_back(resolve(name));
+  }
+  for (const auto& name : output_names()) {
+    resolve(name);
+  }
+}
+
+Blob* Predictor::getResolvedBlob(Blob* blob, const std::string& name) {
+  if (!blob) {
+    return getBlob(config_.ws.get(), name);
+  }
+  CAFFE_ENFORCE(
+      BlobIsTensorType(*blob, CPU), "Blob is not a CPU Tensor: ", name);
+  return blob;
+}
+
+Blob* Predictor::getResolvedBlob(const std::string& name) {
+  const auto it = resolved_blobs_.find(name);
+  return getResolvedBlob(
+      it == resolved_blobs_.end() ? nullptr : it->second, name);
 }
 
 bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
@@ -60,7 +95,8 @@ bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
   for (size_t i = 0; i < inputs.size(); ++i) {
     // This is evil and shares the same underlying tensor
     BlobSetTensor(
-        getBlob(config_.ws.get(), config_.predict_net->external_input(i)),
+        getResolvedBlob(
+            input_blobs_[i], config_.predict_net->external_input(i)),
         inputs[i].UnsafeSharedInstance());
   }
 
@@ -70,7 +106,9 @@ bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
   outputs->clear();
   for (size_t i = 0; i < config_.predict_net->external_output_size(); ++i) {
     outputs->emplace_back(
-        getTensor(config_.ws.get(), config_.predict_net->external_output(i))
+        getTensor(getResolvedBlob(
+                      output_blobs_[i],
+                      config_.predict_net->external_output(i)))
             .UnsafeSharedInstance());
   }
   return true;
@@ -90,8 +128,7 @@ bool Predictor::run_map_workspace(const TensorMap& inputs) {
     }
     // This is evil and shares the same underlying tensor
     BlobSetTensor(
-        getBlob(config_.ws.get(), input.first),
-        input.second.UnsafeSharedInstance());
+        getResolvedBlob(input.first), input.second.UnsafeSharedInstance());
   }
 
   return config_.ws->RunNet(config_.predict_net->name());
@@ -104,7 +141,9 @@ bool Predictor::operator()(const TensorMap& inputs, TensorList* outputs) {
   outputs->clear();
   for (size_t i = 0; i < config_.predict_net->external_output_size(); ++i) {
     outputs->push_back(
-        getTensor(config_.ws.get(), config_.predict_net->external_output(i))
+        getTensor(getResolvedBlob(
+                      output_blobs_[i],
+                      config_.predict_net->external_output(i)))
             .UnsafeSharedInstance());
   }
   return true;
@@ -118,7 +157,7 @@ bool Predictor::operator()(const TensorMap& inputs, TensorMap* outputs) {
   for (const std::string& outputName : output_names()) {
     outputs->emplace(
         outputName,
-        getTensor(config_.ws.get(), outputName).UnsafeSharedInstance());
+        getTensor(getResolvedBlob(outputName)).UnsafeSharedInstance());
   }
   return true;
 }
@@ -65,6 +65,18 @@ class CAFFE2_API Predictor {
  private:
   bool run_map_workspace(const TensorMap& inputs);
 
+  // The blob of the given input or output, from the blobs resolved at
+  // construction, or looked up in the workspace for any other name
+  Blob* getResolvedBlob(const std::string& name);
+  Blob* getResolvedBlob(Blob* blob, const std::string& name);
+
+  // The blobs of run_net's external inputs and outputs, in their order, and
+  // by name together with the ones of output_names(). They are looked up once
+  // rather than on every run, see Workspace::GetBlob().
+  std::vector<Blob*> input_blobs_;
+  std::vector<Blob*> output_blobs_;
+  std::unordered_map<std::string, Blob*> resolved_blobs_;
+
  protected:
   PredictorConfig config_;
 };
@@ -1,11 +1,14 @@
 #include "caffe2/core/context.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/tensor.h"
+#include "caffe2/predictor/batching_predictor.h"
 #include "caffe2/predictor/predictor.h"
 #include "caffe2/utils/math.h"
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -205,4 +208,44 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+TEST_F(PredictorTest, BatchingPredictor) {
+  // requests of 1 to 4 rows from concurrent threads
+  const int kRequests = 16;
+  std::vector<std::unique_ptr<Blob>> inputData;
+  std::vector<Predictor::TensorList> inputs(kRequests);
+  std::vector<Predictor::TensorList> expected(kRequests);
+  for (int i = 0; i < kRequests; ++i) {
+    inputData.push_back(randomTensor({i % 4 + 1, 4}, ctx_.get()));
+    inputs[i].emplace_back(
+        BlobGetMutableTensor(inputData.back().get(), CPU)->Alias());
+    Predictor::TensorList output;
+    ASSERT_TRUE((*p_)(inputs[i], &output));
+    expected[i].emplace_back(output.front().Clone());
+  }
+
+  BatchingPredictorOptions options;
+  options.max_batch_size = 8;
+  options.max_delay = std::chrono::milliseconds(10);
+  BatchingPredictor batching(p_.get(), options);
+  std::vector<Predictor::TensorList> outputs(kRequests);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kRequests; ++i) {
+    threads.emplace_back(
+        [&, i]() { EXPECT_TRUE(batching(inputs[i], &outputs[i])); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kRequests; ++i) {
+    ASSERT_EQ(outputs[i].size(), 1);
+    const auto& output = outputs[i].front();
+    ASSERT_EQ(output.sizes(), expected[i].front().sizes());
+    for (int64_t j = 0; j < output.numel(); ++j) {
+      EXPECT_NEAR(
+          output.data<float>()[j], expected[i].front().data<float>()[j], 1E-5);
+    }
+  }
+}
+
 } // namespace caffe2
@@ -1,6 +1,7 @@
 #include "dynamic_histogram.h"
 #include "dnnlowp_op.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <limits>
@@ -20,19 +21,77 @@ void Histogram::Add(float f, uint64_t cnt) {
   histogram_[bin] += cnt;
 }
 
+namespace {
+
+// Inputs shorter than this per thread are not worth waking up threads for
+constexpr int MIN_ELEMENTS_PER_THREAD = 1 << 16;
+
+int NumThreadsFor(int len) {
+  return std::max(
+      1,
+      std::min(
+          caffe2::dnnlowp_get_max_threads(), len / MIN_ELEMENTS_PER_THREAD));
+}
+
+// The [begin, end) range of the elements processed by the calling thread
+// when len elements are split among the threads of the parallel region.
+void GetThreadRange(int len, int* begin, int* end) {
+  int nthreads = caffe2::dnnlowp_get_num_threads();
+  int tid = caffe2::dnnlowp_get_thread_num();
+  int chunk = (len + nthreads - 1) / nthreads;
+  *begin = std::min(len, tid * chunk);
+  *end = std::min(len, *begin + chunk);
+}
+
+void AddToBins(
+    const float* f,
+    int len,
+    float min,
+    float bin_width,
+    int nbins,
+    uint64_t* bins) {
+  for (auto i = 0; i < len; ++i) {
+    int bin = std::min(static_cast<int>((f[i] - min) / bin_width), nbins - 1);
+    bin = std::max(0, bin);
+    ++bins[bin];
+  }
+}
+
+} // namespace
+
 void Histogram::Add(const float* f, int len) {
   int nbins = histogram_.size();
   float bin_width = (max_ - min_) / nbins;
 
   if (bin_width > 0.0) {
-    uint64_t* my_histogram = nullptr;
-    my_histogram = histogram_.data();
-
-    for (auto i = 0; i < len; ++i) {
-      int bin =
-          std::min(static_cast<int>((f[i] - min_) / bin_width), nbins - 1);
-      bin = std::max(0, bin);
-      ++my_histogram[bin];
+    int nthreads = NumThreadsFor(len);
+    if (nthreads == 1) {
+      AddToBins(f, len, min_, bin_width, nbins, histogram_.data());
+      return;
+    }
+
+    // Each thread counts into its own histogram, so that there is no
+    // synchronization on the bins, and the histograms are summed at the end.
+    vector<uint64_t> per_thread_histograms(nthreads * nbins);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#endif
+    {
+      int begin, end;
+      GetThreadRange(len, &begin, &end);
+      AddToBins(
+          f + begin,
+          end - begin,
+          min_,
+          bin_width,
+          nbins,
+          per_thread_histograms.data() +
+              caffe2::dnnlowp_get_thread_num() * nbins);
+    }
+    for (int t = 0; t < nthreads; ++t) {
+      for (int bin = 0; bin < nbins; ++bin) {
+        histogram_[bin] += per_thread_histograms[t * nbins + bin];
+      }
     }
   } else {
     histogram_[0] += len;
@@ -130,9 +189,31 @@ void DynamicHistogram::Add(float f) {
 
 void DynamicHistogram::Add(const float* f, int len) {
   float minimum = min_, maximum = max_;
-  for (int i = 0; i < len; ++i) {
-    minimum = std::min(f[i], minimum);
-    maximum = std::max(f[i], maximum);
+  int nthreads = NumThreadsFor(len);
+  if (nthreads == 1) {
+    for (int i = 0; i < len; ++i) {
+      minimum = std::min(f[i], minimum);
+      maximum = std::max(f[i], maximum);
+    }
+  } else {
+    vector<float> per_thread_min(nthreads, minimum);
+    vector<float> per_thread_max(nthreads, maximum);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads)
+#endif
+    {
+      int begin, end;
+      GetThreadRange(len, &begin, &end);
+      float my_min = minimum, my_max = maximum;
+      for (int i = begin; i < end; ++i) {
+        my_min = std::min(f[i], my_min);
+        my_max = std::max(f[i], my_max);
+      }
+      per_thread_min[caffe2::dnnlowp_get_thread_num()] = my_min;
+      per_thread_max[caffe2::dnnlowp_get_thread_num()] = my_max;
+    }
+    minimum = *std::min_element(per_thread_min.begin(), per_thread_min.end());
+    maximum = *std::max_element(per_thread_max.begin(), per_thread_max.end());
   }
   min_ = std::max(numeric_limits<float>::lowest(), minimum);
   max_ = std::min(numeric_limits<float>::max(), maximum);
@@ -73,3 +73,32 @@ TEST(DynamicHistogram, HistSimilar) {
     EXPECT_TRUE(errors[i] < 0.3);
   }
 }
+
+TEST(Histogram, AddLargeInput) {
+  default_random_engine generator;
+  normal_distribution<float> distribution;
+
+  // Large enough to be split among threads
+  constexpr int n = 1 << 20;
+  vector<float> data(n);
+  for (int i = 0; i < n; ++i) {
+    data[i] = distribution(generator);
+  }
+  float minimum = *min_element(data.begin(), data.end());
+  float maximum = *max_element(data.begin(), data.end());
+
+  int nbins = 256;
+  Histogram hist(nbins, minimum, maximum);
+  Histogram ref_hist(nbins, minimum, maximum);
+  hist.Add(data.data(), n);
+  for (int i = 0; i < n; ++i) {
+    ref_hist.Add(data[i]);
+  }
+  EXPECT_EQ(*hist.GetHistogram(), *ref_hist.GetHistogram());
+
+  DynamicHistogram dynamic_hist(nbins);
+  dynamic_hist.Add(data.data(), n);
+  const Histogram* dynamic_hist_result = dynamic_hist.Finalize();
+  EXPECT_EQ(dynamic_hist_result->Min(), minimum);
+  EXPECT_EQ(dynamic_hist_result->Max(), maximum);
+}
@@ -18,18 +18,22 @@ TensorQuantizationParams KLDivergenceMinimization::ChooseQuantizationParams(
   double bin_width = (max - min) / nbins;
   int zero_bin = round(-min / bin_width);
 
-  double total_sum = 0;
+  // prefix_sums[i] is the number of values in the first i bins, so that the
+  // outliers of every candidate range are counted in constant time.
+  vector<uint64_t> prefix_sums(nbins + 1, 0);
   for (int i = 0; i < nbins; ++i) {
-    total_sum += bins[i];
+    prefix_sums[i + 1] = prefix_sums[i] + bins[i];
   }
+  double total_sum = prefix_sums[nbins];
 
   vector<pair<int, double>> best_start_bins(nbins + 1);
 
   // Look at mapping [start_bin, start_bin + nbins_selected) to
   // [0, 1 << precision) for every (start_bin, nbins_selected) combination and
-  // pick the one with smallest KL divergence
+  // pick the one with smallest KL divergence. There are fewer start bins to
+  // try for wider ranges, so the iterations are scheduled dynamically.
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
 #endif
   for (int nbins_selected = 1; nbins_selected <= nbins; ++nbins_selected) {
     // if (nbins_selected % dst_nbins != 0) continue;
@@ -52,16 +56,12 @@ TensorQuantizationParams KLDivergenceMinimization::ChooseQuantizationParams(
       double kl = 0;
 
       // sum outliers
-      uint64_t left_outliers = 0;
+      uint64_t left_outliers =
+          prefix_sums[std::max(0, std::min(start_bin, nbins))];
+      uint64_t right_outliers = prefix_sums[nbins] -
+          prefix_sums[std::max(
+              0, std::min(start_bin + nbins_selected, nbins))];
       int src_bin;
-      for (src_bin = 0; src_bin < start_bin; ++src_bin) {
-        left_outliers += bins[src_bin];
-      }
-
-      uint64_t right_outliers = 0;
-      for (src_bin = start_bin + nbins_selected; src_bin < nbins; ++src_bin) {
-        right_outliers += bins[src_bin];
-      }
 
       // each destination bin corresponds to a quantized value
       for (int dst_bin = 0; dst_bin < dst_nbins; ++dst_bin) {
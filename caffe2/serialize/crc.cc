@@ -1,13 +1,43 @@
 #include "miniz.h"
 #include <iostream>
+#include <vector>
 
+#include <ATen/Parallel.h>
 #include "caffe2/serialize/crc_alt.h"
 
+namespace {
+// Records of large tensors are checksummed in chunks of this size on the
+// intra-op threads, and the CRCs of the chunks are then combined.
+constexpr size_t kParallelCrcChunkSize = 4 * 1024 * 1024;
+
+uint32_t crc32_parallel(const mz_uint8* ptr, size_t buf_len, uint32_t crc) {
+  const int64_t num_chunks = static_cast<int64_t>(
+      (buf_len + kParallelCrcChunkSize - 1) / kParallelCrcChunkSize);
+  if (num_chunks < 2 || at::get_num_threads() < 2 || at::in_parallel_region()) {
+    return crc32_fast(ptr, buf_len, crc);
+  }
+  std::vector<uint32_t> chunk_crcs(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const size_t offset = i * kParallelCrcChunkSize;
+      chunk_crcs[i] = crc32_fast(
+          ptr + offset, std::min(kParallelCrcChunkSize, buf_len - offset));
+    }
+  });
+  for (int64_t i = 0; i < num_chunks; i++) {
+    const size_t offset = i * kParallelCrcChunkSize;
+    crc = crc32_combine(
+        crc, chunk_crcs[i], std::min(kParallelCrcChunkSize, buf_len - offset));
+  }
+  return crc;
+}
+} // namespace
+
 extern "C" {
 // See: miniz.h
 #if defined(USE_EXTERNAL_MZCRC) 
 mz_ulong mz_crc32(mz_ulong crc, const mz_uint8* ptr, size_t buf_len) {
-  auto z = crc32_fast(ptr, buf_len, crc);
+  auto z = crc32_parallel(ptr, buf_len, crc);
   return z;
 };
 #endif
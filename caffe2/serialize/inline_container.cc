@@ -182,6 +182,7 @@ static size_t getPadding(
 }
 
 bool PyTorchStreamReader::hasRecord(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   std::string ss = archive_name_plus_slash_ + name;
   mz_zip_reader_locate_file(ar_.get(), ss.c_str(), nullptr, 0);
   bool result = ar_->m_last_error != MZ_ZIP_FILE_NOT_FOUND;
@@ -193,6 +194,7 @@ bool PyTorchStreamReader::hasRecord(const std::string& name) {
 }
 
 std::vector<std::string> PyTorchStreamReader::getAllRecords() {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   mz_uint num_files = mz_zip_reader_get_num_files(ar_.get());
   std::vector<std::string> out;
   char buf[MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE];
@@ -215,13 +217,73 @@ size_t PyTorchStreamReader::getRecordID(const std::string& name) {
 
 // return dataptr, size
 std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string& name) {
+  std::unique_lock<std::mutex> guard(reader_lock_);
   size_t key = getRecordID(name);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
+  if (stat.m_is_encrypted ||
+      (stat.m_method != 0 && stat.m_method != MZ_DEFLATED)) {
+    // encrypted or compressed with an unsupported method, miniz reports it
+    at::DataPtr retval = c10::GetCPUAllocator()->allocate(stat.m_uncomp_size);
+    mz_zip_reader_extract_to_mem(ar_.get(), key, retval.get(), stat.m_uncomp_size, 0);
+    valid("reading file ", name.c_str());
+    return std::make_tuple(std::move(retval), stat.m_uncomp_size);
+  }
+
+  // Records that are stored as they are and aligned the way
+  // PyTorchStreamWriter aligns them can be handed out without a copy if the
+  // adapter supports it.
+  if (stat.m_method == 0 && stat.m_uncomp_size > 0) {
+    size_t offset = getRecordOffsetForID(key);
+    if (offset % kFieldAlignment == 0) {
+      at::DataPtr data_ptr = in_->getDataPtr(offset, stat.m_uncomp_size);
+      if (data_ptr) {
+        return std::make_tuple(std::move(data_ptr), stat.m_uncomp_size);
+      }
+    }
+  }
+
+  // Only the raw bytes are read under the lock, the (comparatively
+  // expensive) inflating and CRC check run concurrently with other readers.
   at::DataPtr retval = c10::GetCPUAllocator()->allocate(stat.m_uncomp_size);
-  mz_zip_reader_extract_to_mem(ar_.get(), key, retval.get(), stat.m_uncomp_size, 0);
+  std::vector<char> compressed;
+  if (stat.m_method == 0) {
+    mz_zip_reader_extract_to_mem(
+        ar_.get(), key, retval.get(), stat.m_uncomp_size, MZ_ZIP_FLAG_COMPRESSED_DATA);
+  } else {
+    compressed.resize(stat.m_comp_size);
+    mz_zip_reader_extract_to_mem(
+        ar_.get(), key, compressed.data(), stat.m_comp_size, MZ_ZIP_FLAG_COMPRESSED_DATA);
+  }
   valid("reading file ", name.c_str());
+  guard.unlock();
+
+  if (stat.m_method == MZ_DEFLATED) {
+    size_t size = tinfl_decompress_mem_to_mem(
+        retval.get(),
+        stat.m_uncomp_size,
+        compressed.data(),
+        compressed.size(),
+        TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+    if (size != stat.m_uncomp_size) {
+      CAFFE_THROW(
+          "PytorchStreamReader failed reading file ",
+          name,
+          ": ",
+          mz_zip_get_error_string(MZ_ZIP_DECOMPRESSION_FAILED));
+    }
+  }
+  if (mz_crc32(
+          MZ_CRC32_INIT,
+          static_cast<const mz_uint8*>(retval.get()),
+          stat.m_uncomp_size) != stat.m_crc32) {
+    CAFFE_THROW(
+        "PytorchStreamReader failed reading file ",
+        name,
+        ": ",
+        mz_zip_get_error_string(MZ_ZIP_CRC_CHECK_FAILED));
+  }
 
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
@@ -231,9 +293,14 @@ static int64_t read_le_16(uint8_t* buf) {
 }
 
 size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
+  return getRecordOffsetForID(getRecordID(name));
+}
+
+size_t PyTorchStreamReader::getRecordOffsetForID(size_t key) {
   mz_zip_archive_file_stat stat;
-  mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
-  valid("retrieving file meta-data for ", name.c_str());
+  mz_zip_reader_file_stat(ar_.get(), key, &stat);
+  valid("retrieving file meta-data");
   uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
   in_->read(
       stat.m_local_header_ofs,
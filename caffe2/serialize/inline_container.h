@@ -5,6 +5,7 @@
 #include <cstring>
 #include <fstream>
 #include <istream>
+#include <mutex>
 #include <ostream>
 
 #include <c10/core/Allocator.h>
@@ -148,6 +149,9 @@ static_assert(kProducedBytecodeVersion >= kProducedFileFormatVersion,
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
 
+// PyTorchStreamReader is thread-safe. Only locating a record and reading its
+// raw bytes is serialized; checking its CRC and inflating compressed records
+// happen outside of the lock, so records can be read concurrently.
 class CAFFE2_API PyTorchStreamReader final {
  public:
   explicit PyTorchStreamReader(const std::string& file_name);
@@ -170,6 +174,7 @@ class CAFFE2_API PyTorchStreamReader final {
   size_t read(uint64_t pos, char* buf, size_t n);
   void valid(const char* what, const char* info = "");
   size_t getRecordID(const std::string& name);
+  size_t getRecordOffsetForID(size_t key);
 
   friend size_t
   istream_read_func(void* pOpaque, uint64_t file_ofs, void* pBuf, size_t n);
@@ -178,6 +183,8 @@ class CAFFE2_API PyTorchStreamReader final {
   std::string archive_name_plus_slash_;
   std::unique_ptr<ReadAdapterInterface> in_;
   int64_t version_;
+  // guards ar_ and in_
+  std::mutex reader_lock_;
 };
 
 class CAFFE2_API PyTorchStreamWriter final {
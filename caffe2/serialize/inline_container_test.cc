@@ -1,10 +1,15 @@
 #include <cstdio>
 #include <string>
 #include <array>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include <c10/core/CPUAllocator.h>
+
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_adapter.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -63,6 +68,86 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, ConcurrentReads) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  constexpr int kNumRecords = 8;
+  std::vector<std::vector<char>> data(kNumRecords);
+  for (int i = 0; i < kNumRecords; ++i) {
+    data[i].resize(1000 + i * 997);
+    for (size_t j = 0; j < data[i].size(); ++j) {
+      data[i][j] = (i + j) % 7;
+    }
+    // every other record is compressed
+    writer.writeRecord(
+        "key" + c10::to_string(i), data[i].data(), data[i].size(), i % 2);
+  }
+  writer.writeEndOfFile();
+
+  std::istringstream iss(oss.str());
+  PyTorchStreamReader reader(&iss);
+  std::vector<std::thread> threads;
+  std::vector<int> mismatches(kNumRecords, 0);
+  for (int t = 0; t < kNumRecords; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int k = 0; k < 10; ++k) {
+        int i = (t + k) % kNumRecords;
+        at::DataPtr data_ptr;
+        int64_t size;
+        std::tie(data_ptr, size) = reader.getRecord("key" + c10::to_string(i));
+        if (size != data[i].size() ||
+            memcmp(data_ptr.get(), data[i].data(), size) != 0) {
+          mismatches[t]++;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (int t = 0; t < kNumRecords; ++t) {
+    ASSERT_EQ(mismatches[t], 0);
+  }
+}
+
+#ifndef _WIN32
+TEST(PyTorchStreamWriterAndReader, LoadWithMmap) {
+  const std::string file_name = "output_mmap.zip";
+  std::array<char, 127> data1;
+  for (int i = 0; i < data1.size(); ++i) {
+    data1[i] = data1.size() - i;
+  }
+  {
+    PyTorchStreamWriter writer(file_name);
+    writer.writeRecord("key1", data1.data(), data1.size());
+    writer.writeEndOfFile();
+  }
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  {
+    PyTorchStreamReader reader(std::make_unique<MmapReadAdapter>(file_name));
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    // the record is not a copy made by the CPU allocator
+    ASSERT_NE(data_ptr.get_deleter(), c10::GetCPUAllocator()->raw_deleter());
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data_ptr.get()) % kFieldAlignment, 0);
+  }
+  // the record stays valid after the reader is gone
+  ASSERT_EQ(size, data1.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+
+  // writing to the record doesn't modify the file
+  static_cast<char*>(data_ptr.get())[0] = 0;
+  PyTorchStreamReader reader(std::make_unique<MmapReadAdapter>(file_name));
+  std::tie(data_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  std::remove(file_name.c_str());
+}
+#endif
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
@@ -0,0 +1,94 @@
+#include "caffe2/serialize/mmap_adapter.h"
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+namespace {
+
+// Context of a record returned by getDataPtr; keeps the mapping alive.
+struct RecordContext {
+  std::shared_ptr<void> mapping;
+};
+
+void deleteRecordContext(void* ctx) {
+  delete static_cast<RecordContext*>(ctx);
+}
+
+} // namespace
+
+MmapReadAdapter::MmapReadAdapter(const std::string& file_name) {
+#ifdef _WIN32
+  AT_ERROR("MmapReadAdapter is not supported on Windows, file path: ", file_name);
+#else
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd == -1) {
+    AT_ERROR("open file failed, file path: ", file_name, ", ", strerror(errno));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    int err = errno;
+    close(fd);
+    AT_ERROR("fstat failed, file path: ", file_name, ", ", strerror(err));
+  }
+  size_ = file_stat.st_size;
+  if (size_ > 0) {
+    // Private and writable: tensors loaded from the mapping can be modified
+    // in place like any other tensor, which only copies the touched pages.
+    void* data =
+        mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      int err = errno;
+      close(fd);
+      AT_ERROR("mmap failed, file path: ", file_name, ", ", strerror(err));
+    }
+    data_ = static_cast<char*>(data);
+    const size_t size = size_;
+    mapping_ = std::shared_ptr<void>(data, [size](void* p) { munmap(p, size); });
+  }
+  // the mapping stays valid after the descriptor is closed
+  close(fd);
+#endif
+}
+
+size_t MmapReadAdapter::size() const {
+  return size_;
+}
+
+size_t MmapReadAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos >= size_) {
+    return 0;
+  }
+  n = std::min<size_t>(n, size_ - pos);
+  memcpy(buf, data_ + pos, n);
+  return n;
+}
+
+at::DataPtr MmapReadAdapter::getDataPtr(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos <= size_ && n <= size_ - pos,
+      "record at offset ", pos, " of size ", n,
+      " is out of bounds of the mapped file of size ", size_);
+  return at::DataPtr(
+      data_ + pos,
+      new RecordContext{mapping_},
+      &deleteRecordContext,
+      at::Device(at::DeviceType::CPU));
+}
+
+MmapReadAdapter::~MmapReadAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
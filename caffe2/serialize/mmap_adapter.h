@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// Reads an archive by memory-mapping the whole file.
+//
+// Records that are stored uncompressed (everything PyTorchStreamWriter
+// writes) are returned by PyTorchStreamReader::getRecord without copying:
+// the DataPtr points straight into the mapping and keeps it alive, so tensor
+// storages loaded this way outlive the reader. The mapping is private, i.e.
+// pages are shared through the page cache with every other process mapping
+// the same file until they are written to, and writes never reach the file.
+//
+//   auto module = torch::jit::load(
+//       std::make_unique<caffe2::serialize::MmapReadAdapter>(file_name));
+//
+// Not available on Windows.
+class CAFFE2_API MmapReadAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapReadAdapter);
+  explicit MmapReadAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr getDataPtr(uint64_t pos, size_t n) const override;
+  ~MmapReadAdapter();
+
+ private:
+  char* data_ = nullptr;
+  size_t size_ = 0;
+  // unmaps the file once the adapter and all records are gone
+  std::shared_ptr<void> mapping_;
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +17,10 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // Returns a DataPtr aliasing bytes [pos, pos + n) of the underlying data
+  // without copying them, or an empty DataPtr if the adapter can't do that
+  // (the default), in which case the caller falls back to read().
+  virtual at::DataPtr getDataPtr(uint64_t pos, size_t n) const;
   virtual ~ReadAdapterInterface();
 };
 
@@ -106,10 +106,22 @@ if(INTERN_BUILD_ATEN_OPS)
     if(MSVC)
       list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG}/arch:AVX2")
     else(MSVC)
-      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx2 -mfma ${CPU_NO_AVX256_SPLIT_FLAGS}")
+      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx2 -mfma -mf16c ${CPU_NO_AVX256_SPLIT_FLAGS}")
     endif(MSVC)
   endif(CXX_AVX2_FOUND)
 
+  # The AVX512 kernels use at::vec::Vectorized (Vec512) where they have been
+  # ported and fall back to the AVX2 Vec256 code everywhere else, hence
+  # -DCPU_CAPABILITY_AVX2 on top of the AVX512 flags.
+  if(CXX_AVX2_FOUND AND NOT MSVC)
+    check_cxx_compiler_flag("-mavx512f -mavx512bw -mavx512vl -mavx512dq" COMPILER_SUPPORTS_AVX512_KERNELS)
+    if(COMPILER_SUPPORTS_AVX512_KERNELS)
+      set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DHAVE_AVX512_CPU_DEFINITION")
+      list(APPEND CPU_CAPABILITY_NAMES "AVX512")
+      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx512f -mavx512bw -mavx512vl -mavx512dq -mfma -mf16c ${CPU_NO_AVX256_SPLIT_FLAGS} -DCPU_CAPABILITY_AVX2")
+    endif(COMPILER_SUPPORTS_AVX512_KERNELS)
+  endif()
+
   list(LENGTH CPU_CAPABILITY_NAMES NUM_CPU_CAPABILITY_NAMES)
   math(EXPR NUM_CPU_CAPABILITY_NAMES "${NUM_CPU_CAPABILITY_NAMES}-1")
 
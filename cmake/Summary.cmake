@@ -22,6 +22,8 @@ function(caffe2_print_configuration_summary)
   message(STATUS "  CAFFE2_VERSION        : ${CAFFE2_VERSION}")
   message(STATUS "  BUILD_CAFFE2_MOBILE   : ${BUILD_CAFFE2_MOBILE}")
   message(STATUS "  USE_STATIC_DISPATCH   : ${USE_STATIC_DISPATCH}")
+  message(STATUS "  USE_DISPATCH_STATS    : ${USE_DISPATCH_STATS}")
+  message(STATUS "  USE_REFCOUNT_STATS    : ${USE_REFCOUNT_STATS}")
   message(STATUS "  BUILD_BINARY          : ${BUILD_BINARY}")
   message(STATUS "  BUILD_CUSTOM_PROTOBUF : ${BUILD_CUSTOM_PROTOBUF}")
   if(${CAFFE2_LINK_LOCAL_PROTOBUF})
@@ -253,6 +253,28 @@ else()
       ${LIBNVTOOLSEXT})
 endif()
 
+# cupti, used by the autograd profiler to trace CUDA kernels
+find_library(CUPTI_LIBRARY_PATH cupti
+    PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/lib64
+          ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/lib
+          ${CUDA_TOOLKIT_ROOT_DIR}/lib64
+    NO_DEFAULT_PATH)
+find_path(CUPTI_INCLUDE_DIR cupti.h
+    PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/include
+          ${CUDA_INCLUDE_DIRS}
+    NO_DEFAULT_PATH)
+if(CUPTI_LIBRARY_PATH AND CUPTI_INCLUDE_DIR)
+  add_library(torch::cupti INTERFACE IMPORTED)
+  set_property(
+      TARGET torch::cupti PROPERTY INTERFACE_LINK_LIBRARIES
+      ${CUPTI_LIBRARY_PATH})
+  set_property(
+      TARGET torch::cupti PROPERTY INTERFACE_INCLUDE_DIRECTORIES
+      ${CUPTI_INCLUDE_DIR})
+else()
+  message(STATUS "CUPTI not found, CUDA kernel tracing in the profiler is disabled")
+endif()
+
 # cudnn
 # static linking is handled by USE_STATIC_CUDNN environment variable
 if(CAFFE2_USE_CUDNN)
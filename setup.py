@@ -153,6 +153,10 @@
 #       OMP - use OpenMP for intra-op and native backend for inter-op tasks
 #       NATIVE - use native thread pool for both intra- and inter-op tasks
 #       TBB - using TBB for intra- and native thread pool for inter-op parallelism
+#       NATIVE_WS - use native work-stealing thread pool for intra-op and
+#                   native backend for inter-op tasks
+#       NATIVE_PTHREADPOOL - NATIVE, sharing the intra-op pool with the
+#                            QNNPACK and XNNPACK kernels, as on mobile
 #
 #   USE_TBB
 #      enable TBB support
@@ -776,6 +780,8 @@ if __name__ == '__main__':
                 'include/ATen/*.h',
                 'include/ATen/cpu/*.h',
                 'include/ATen/cpu/vec256/*.h',
+                'include/ATen/cpu/vec512/*.h',
+                'include/ATen/cpu/vec/*.h',
                 'include/ATen/core/*.h',
                 'include/ATen/cuda/*.cuh',
                 'include/ATen/cuda/*.h',
@@ -2,6 +2,10 @@
 
 #include <torch/torch.h>
 
+#include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/functions/accumulate_grad.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
 #include <test/cpp/api/support.h>
 
 using namespace torch::autograd;
@@ -152,6 +156,158 @@ TEST(AutogradAPITests, RetainGrad) {
   ASSERT_VARIABLE_EQ(input * 18, input.grad());
 }
 
+TEST(AutogradAPITests, GradReadyCallback) {
+  auto input = torch::rand({3}, torch::requires_grad());
+  auto accumulator = std::dynamic_pointer_cast<torch::autograd::AccumulateGrad>(
+      torch::autograd::impl::grad_accumulator(input));
+  ASSERT_TRUE(accumulator);
+
+  std::vector<size_t> keys;
+  auto callback = [](void* context, size_t key) {
+    static_cast<std::vector<size_t>*>(context)->push_back(key);
+  };
+  auto handle = accumulator->add_grad_ready_callback(callback, &keys, 7);
+  (input * 2).sum().backward();
+  ASSERT_EQ(keys, std::vector<size_t>{7});
+  ASSERT_VARIABLE_EQ(input.grad(), torch::full({3}, 2.));
+
+  ASSERT_TRUE(accumulator->del_grad_ready_callback(handle));
+  ASSERT_FALSE(accumulator->del_grad_ready_callback(handle));
+  (input * 2).sum().backward();
+  ASSERT_EQ(keys.size(), 1);
+}
+
+TEST(CustomAutogradTest, NodePriority) {
+  static std::vector<int64_t> order;
+  struct Record : public Function<Record> {
+    static Variable forward(AutogradContext *ctx, Variable input, int64_t tag) {
+      ctx->saved_data["tag"] = tag;
+      return input.clone();
+    }
+
+    static variable_list backward(AutogradContext *ctx, variable_list grad_output) {
+      order.push_back(ctx->saved_data["tag"].toInt());
+      return {grad_output[0], Variable()};
+    }
+  };
+
+  auto x = torch::randn({3}, torch::requires_grad());
+  auto a = Record::apply(x, 0);
+  auto b = Record::apply(x, 1);
+  auto out = (a + b).sum();
+
+  // Both branches become ready together; by default the one created last
+  // (higher sequence number) runs first.
+  out.backward({}, /*keep_graph=*/true);
+  ASSERT_EQ(order, std::vector<int64_t>({1, 0}));
+
+  order.clear();
+  a.grad_fn()->set_priority(1);
+  out.backward();
+  ASSERT_EQ(order, std::vector<int64_t>({0, 1}));
+  ASSERT_VARIABLE_EQ(x.grad(), torch::full({3}, 4.));
+}
+
+TEST(AutogradAPITests, MultiThreadedCPUBackward) {
+  auto& engine = Engine::get_default_engine();
+  const int saved_num_cpu_threads = engine.num_cpu_threads();
+
+  // Many independent towers that all feed the same inputs, so that their
+  // gradients are accumulated by several threads.
+  auto run = [](int num_threads) {
+    Engine::get_default_engine().set_num_cpu_threads(num_threads);
+    torch::manual_seed(0);
+    auto x = torch::randn({16, 32}, torch::requires_grad());
+    auto w = torch::randn({32, 32}, torch::requires_grad());
+    std::vector<Variable> towers;
+    for (int i = 0; i < 16; ++i) {
+      auto h = x;
+      for (int j = 0; j < 4; ++j) {
+        h = torch::tanh(h.mm(w) * (i + j + 1) / 8.);
+      }
+      towers.push_back(h.sum());
+    }
+    torch::stack(towers).sum().backward();
+    return std::make_pair(x.grad(), w.grad());
+  };
+
+  const auto expected = run(1);
+  for (int attempt = 0; attempt < 3; ++attempt) {
+    const auto result = run(4);
+    ASSERT_VARIABLE_EQ(result.first, expected.first);
+    ASSERT_VARIABLE_EQ(result.second, expected.second);
+    // Gradients from several threads are accumulated in a fixed order.
+    ASSERT_TRUE(torch::equal(result.first, run(4).first));
+  }
+
+  ASSERT_THROWS_WITH(engine.set_num_cpu_threads(0), "must be positive");
+  engine.set_num_cpu_threads(saved_num_cpu_threads);
+}
+
+TEST(AutogradAPITests, SavedVariableHooks) {
+  struct CountingHooks : public SavedVariableHooks {
+    CountingHooks(int& packed, int& unpacked)
+        : packed_(packed), unpacked_(unpacked) {}
+    void call_pack_hook(const at::Tensor& tensor) override {
+      packed_++;
+      tensor_ = tensor.clone();
+    }
+    at::Tensor call_unpack_hook() override {
+      unpacked_++;
+      return tensor_;
+    }
+    int& packed_;
+    int& unpacked_;
+    at::Tensor tensor_;
+  };
+
+  int packed = 0, unpacked = 0;
+  auto x = torch::randn({4, 4}, torch::requires_grad());
+  Variable y;
+  {
+    SavedVariableHooksGuard guard([&](const at::Tensor& /* tensor */) {
+      return std::unique_ptr<SavedVariableHooks>(
+          new CountingHooks(packed, unpacked));
+    });
+    y = (x * x).sin().sum();
+  }
+  ASSERT_EQ(packed, 3);
+  ASSERT_EQ(SavedVariableHooksGuard::current(), nullptr);
+  y.backward();
+  ASSERT_EQ(unpacked, 3);
+  ASSERT_VARIABLE_EQ(x.grad(), 2 * x * (x * x).cos());
+}
+
+TEST(AutogradAPITests, Checkpoint) {
+  auto fn = [](const variable_list& inputs) -> variable_list {
+    return {torch::tanh(inputs[0].mm(inputs[1])).sigmoid() * inputs[0]};
+  };
+  auto x = torch::randn({8, 8}, torch::requires_grad());
+  auto w = torch::randn({8, 8}, torch::requires_grad());
+
+  fn({x, w})[0].sum().backward();
+  const auto x_grad = x.grad().clone();
+  const auto w_grad = w.grad().clone();
+  x.grad().zero_();
+  w.grad().zero_();
+
+  checkpoint(fn, {x, w})[0].sum().backward();
+  ASSERT_VARIABLE_EQ(x.grad(), x_grad);
+  ASSERT_VARIABLE_EQ(w.grad(), w_grad);
+
+  // A function that saves a different number of tensors when run again.
+  int calls = 0;
+  auto unstable_fn = [&](const variable_list& inputs) -> variable_list {
+    auto out = inputs[0] * inputs[0];
+    if (calls++ > 0) {
+      out = out.exp();
+    }
+    return {out};
+  };
+  auto z = checkpoint(unstable_fn, {x})[0].sum();
+  ASSERT_THROWS_WITH(z.backward(), "same operations");
+}
+
 TEST(CustomAutogradTest, CustomFunction) {
   struct MyFunction : public Function<MyFunction> {
     static Variable forward(AutogradContext *ctx, Variable var1, int mul, Variable var2) {
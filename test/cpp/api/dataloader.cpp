@@ -485,6 +485,54 @@ TEST(DataTest, StackTransformWorksForTensorExample) {
   ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
 }
 
+struct StackedTestDataset
+    : public datasets::StackedDataset<StackedTestDataset> {
+  Example<> get(size_t index) override {
+    return {tensor[index], 1 + tensor[index]};
+  }
+
+  void get_into(size_t index, Example<>& slot) override {
+    ++in_place_examples;
+    slot.data.copy_(tensor[index]);
+    slot.target.fill_(1).add_(tensor[index]);
+  }
+
+  torch::optional<size_t> size() const override {
+    return tensor.size(0);
+  }
+
+  torch::Tensor tensor{torch::eye(4)};
+  size_t in_place_examples = 0;
+};
+
+TEST(DataTest, StackedDatasetMatchesStackTransform) {
+  StackedTestDataset d;
+  Example<> batch = d.get_batch({2, 0, 3});
+  ASSERT_EQ(d.in_place_examples, 2);
+
+  auto expected = torch::eye(4).index_select(0, torch::tensor({2, 0, 3}));
+  ASSERT_TRUE(batch.data.equal(expected));
+  ASSERT_TRUE(batch.target.equal(1 + expected));
+}
+
+TEST(DataTest, StackedDatasetChecksExampleShapes) {
+  struct D : public datasets::StackedDataset<D, TensorExample> {
+    TensorExample get(size_t index) override {
+      return torch::ones(index + 1);
+    }
+
+    torch::optional<size_t> size() const override {
+      return 3;
+    }
+  };
+
+  D d;
+  ASSERT_TRUE(d.get_batch({1, 1}).data.equal(torch::ones({2, 2})));
+  ASSERT_THROWS_WITH(
+      d.get_batch({0, 1}),
+      "StackedDataset expects all examples to have the same shape");
+}
+
 // Template classes cannot be nested in functions.
 template <typename Target>
 struct T : transforms::TensorTransform<Target> {
@@ -1030,6 +1078,8 @@ TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   ASSERT_EQ(full_options.max_jobs, 0);
   ASSERT_FALSE(full_options.timeout.has_value());
   ASSERT_TRUE(full_options.enforce_ordering);
+  ASSERT_FALSE(full_options.pin_memory);
+  ASSERT_FALSE(full_options.device.has_value());
 }
 
 TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
@@ -1039,6 +1089,47 @@ TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
   ASSERT_EQ(full_options.max_jobs, 2 * 10);
 }
 
+TEST(DataLoaderTest, TransferLeavesValuesOtherThanTensorsUnchanged) {
+  detail::Transfer options;
+  options.device = torch::Device(torch::kCPU);
+  std::vector<Example<torch::Tensor, std::string>> batch = {
+      {torch::ones(2), "a"}, {torch::zeros(2), "b"}};
+  auto moved = detail::transfer(batch, options);
+  ASSERT_EQ(moved.size(), 2);
+  ASSERT_TRUE(moved[0].data.equal(torch::ones(2)));
+  ASSERT_EQ(moved[0].target, "a");
+  ASSERT_TRUE(moved[1].data.equal(torch::zeros(2)));
+  ASSERT_EQ(moved[1].target, "b");
+  ASSERT_EQ(detail::transfer(3, options), 3);
+}
+
+TEST(DataLoaderTest, PinsAndMovesBatchesToDevice_CUDA) {
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        datasets::TensorDataset(torch::arange(10))
+            .map(transforms::Stack<TensorExample>()),
+        DataLoaderOptions(4).workers(workers).pin_memory(true).device(
+            torch::Device(torch::kCUDA)));
+    int64_t sum = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.is_cuda());
+      sum += batch.data.sum().item<int64_t>();
+    }
+    ASSERT_EQ(sum, 45);
+  }
+}
+
+TEST(DataLoaderTest, PinsBatches_CUDA) {
+  auto data_loader = torch::data::make_data_loader(
+      datasets::TensorDataset(torch::arange(10))
+          .map(transforms::Stack<TensorExample>()),
+      DataLoaderOptions(4).workers(2).pin_memory(true));
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.device().is_cpu());
+    ASSERT_TRUE(batch.data.is_pinned());
+  }
+}
+
 TEST(DataLoaderTest, MakeDataLoaderDefaultsAsExpected) {
   auto data_loader = torch::data::make_data_loader(
       DummyDataset().map(transforms::Lambda<int>([](int x) { return x + 1; })));
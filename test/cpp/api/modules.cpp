@@ -3252,32 +3252,31 @@ namespace detail {
       torch::Tensor _V = source_hid_tensor;
       torch::Tensor _K = source_hid_tensor;
 
-      torch::Tensor result;
-      torch::Tensor result_weight;
-      if (multihead_attn_module->_qkv_same_embed_dim) {
-        std::tie(result, result_weight) = F::multi_head_attention_forward(
-          _Q, _K, _V,
-          F::MultiheadAttentionForwardFuncOptions(
-            /*embed_dim_to_check=*/d_model,
-            /*num_heads=*/nheads,
-            /*in_proj_weight=*/multihead_attn_module->in_proj_weight,
-            /*in_proj_bias=*/multihead_attn_module->in_proj_bias,
-            /*bias_k=*/multihead_attn_module->bias_k,
-            /*bias_v=*/multihead_attn_module->bias_v,
-            /*add_zero_attn=*/multihead_attn_module->options.add_zero_attn(),
-            /*dropout_p=*/multihead_attn_module->options.dropout(),
-            /*out_proj_weight=*/multihead_attn_module->out_proj->weight,
-            /*out_proj_bias=*/multihead_attn_module->out_proj->bias
-          )
-          .training(multihead_attn_module->is_training())
-          .key_padding_mask(key_padding_mask_tensor)
-          .need_weights(true)
-          .attn_mask(attn_mask_tensor)
-          .static_k(saved_k_tensor)
-          .static_v(saved_v_tensor)
-        );
-      } else {
-        std::tie(result, result_weight) = F::multi_head_attention_forward(
+      const auto forward = [&](bool need_weights) {
+        if (multihead_attn_module->_qkv_same_embed_dim) {
+          return F::multi_head_attention_forward(
+            _Q, _K, _V,
+            F::MultiheadAttentionForwardFuncOptions(
+              /*embed_dim_to_check=*/d_model,
+              /*num_heads=*/nheads,
+              /*in_proj_weight=*/multihead_attn_module->in_proj_weight,
+              /*in_proj_bias=*/multihead_attn_module->in_proj_bias,
+              /*bias_k=*/multihead_attn_module->bias_k,
+              /*bias_v=*/multihead_attn_module->bias_v,
+              /*add_zero_attn=*/multihead_attn_module->options.add_zero_attn(),
+              /*dropout_p=*/multihead_attn_module->options.dropout(),
+              /*out_proj_weight=*/multihead_attn_module->out_proj->weight,
+              /*out_proj_bias=*/multihead_attn_module->out_proj->bias
+            )
+            .training(multihead_attn_module->is_training())
+            .key_padding_mask(key_padding_mask_tensor)
+            .need_weights(need_weights)
+            .attn_mask(attn_mask_tensor)
+            .static_k(saved_k_tensor)
+            .static_v(saved_v_tensor)
+          );
+        }
+        return F::multi_head_attention_forward(
           _Q, _K, _V,
           F::MultiheadAttentionForwardFuncOptions(
             /*embed_dim_to_check=*/d_model,
@@ -3293,7 +3292,7 @@ namespace detail {
           )
           .training(multihead_attn_module->is_training())
           .key_padding_mask(key_padding_mask_tensor)
-          .need_weights(true)
+          .need_weights(need_weights)
           .attn_mask(attn_mask_tensor)
           .use_separate_proj_weight(true)
           .q_proj_weight(multihead_attn_module->q_proj_weight)
@@ -3302,7 +3301,14 @@ namespace detail {
           .static_k(saved_k_tensor)
           .static_v(saved_v_tensor)
         );
-      }
+      };
+      torch::Tensor result;
+      torch::Tensor result_weight;
+      std::tie(result, result_weight) = forward(/*need_weights=*/true);
+      // Without the weights, the attention goes through the fused kernel
+      const auto fused_result = std::get<0>(forward(/*need_weights=*/false));
+      ASSERT_TRUE(torch::allclose(
+        fused_result, result, 1e-5, 1e-5, /*equal_nan=*/true));
       result = result.squeeze(0).detach();
       torch::Tensor q_proj_weight;
       torch::Tensor k_proj_weight;
@@ -325,6 +325,36 @@ TEST(OptimTest, ProducesPyTorchValues_AdagradWithWeightDecayAndLRDecay) {
       expected_parameters::Adagrad_with_weight_decay_and_lr_decay());
 }
 
+// An uncoalesced sparse gradient, as produced by EmbeddingBag(sparse=true),
+// must update the parameter exactly like the equivalent dense gradient.
+void check_sparse_adagrad_matches_dense(AdagradOptions options) {
+  torch::manual_seed(0);
+  auto sparse_param = torch::randn({10, 17});
+  auto dense_param = sparse_param.clone();
+  Adagrad sparse_optimizer({sparse_param}, options);
+  Adagrad dense_optimizer({dense_param}, options);
+
+  for (int64_t step = 0; step < 3; step++) {
+    auto indices = torch::tensor({7, 2, 7, 0, 2, 7}, torch::kLong).view({1, -1});
+    auto values = torch::randn({6, 17});
+    auto grad = torch::sparse_coo_tensor(indices, values, {10, 17});
+    ASSERT_FALSE(grad.is_coalesced());
+    sparse_param.grad() = grad;
+    dense_param.grad() = grad.to_dense();
+    sparse_optimizer.step();
+    dense_optimizer.step();
+    ASSERT_TRUE(sparse_param.allclose(dense_param));
+  }
+}
+
+TEST(OptimTest, SparseGradient_Adagrad) {
+  check_sparse_adagrad_matches_dense(AdagradOptions(0.1).lr_decay(1e-3));
+}
+
+TEST(OptimTest, SparseGradient_AdagradRowwise) {
+  check_sparse_adagrad_matches_dense(AdagradOptions(0.1).rowwise(true));
+}
+
 TEST(OptimTest, ProducesPyTorchValues_RMSprop) {
   check_exact_values<RMSprop>(
       RMSpropOptions(0.1), expected_parameters::RMSprop());
@@ -291,3 +291,44 @@ TEST_F(ParallelTest, DataParallelNumericalEquivalence_MultiCUDA) {
       }
     }
 }
+
+TEST_F(ParallelTest, DataParallelReplicaCache_MultiCUDA) {
+  auto model = torch::nn::Linear(3, 2);
+  auto model_dp = torch::nn::Linear(3, 2);
+  {
+    torch::NoGradGuard no_grad;
+    model_dp->weight.copy_(model->weight);
+    model_dp->bias.copy_(model->bias);
+  }
+  model_dp->to(torch::Device(torch::kCUDA, 0));
+  parallel::ReplicaCache<torch::nn::Linear> replicas(
+      model_dp,
+      {torch::Device(torch::kCUDA, 0), torch::Device(torch::kCUDA, 1)});
+
+  torch::optim::SGD optim(model->parameters(), torch::optim::SGDOptions(0.1));
+  torch::optim::SGD optim_dp(
+      model_dp->parameters(), torch::optim::SGDOptions(0.1));
+  const auto* replica_weight =
+      replicas.replicas()[1]->weight.unsafeGetTensorImpl();
+  for (int i = 0; i < 3; ++i) {
+    auto input = torch::ones({8, 3}) * i;
+
+    optim.zero_grad();
+    auto output = model->forward(input);
+    torch::mse_loss(output, torch::zeros_like(output)).backward();
+    optim.step();
+
+    optim_dp.zero_grad();
+    auto output_dp = parallel::data_parallel(replicas, input);
+    torch::mse_loss(output_dp, torch::zeros_like(output_dp)).backward();
+    optim_dp.step();
+
+    ASSERT_TRUE(torch::allclose(model->weight, model_dp->weight.cpu()));
+    ASSERT_TRUE(torch::allclose(model->bias, model_dp->bias.cpu()));
+  }
+
+  // The replicas were updated in-place, and are up to date.
+  auto& updated = replicas.replicas();
+  ASSERT_EQ(updated[1]->weight.unsafeGetTensorImpl(), replica_weight);
+  ASSERT_TRUE(torch::allclose(model->weight, updated[1]->weight.cpu()));
+}
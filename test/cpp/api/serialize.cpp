@@ -977,3 +977,56 @@ TEST(SerializeTest, UnserializableSubmoduleIsIgnoredWhenLoadingModule) {
   // serialization.
   ASSERT_EQ(output, 5);
 }
+
+TEST(SerializeTest, DeltaCheckpoints) {
+  torch::manual_seed(0);
+
+  auto model = torch::nn::Sequential(
+      torch::nn::Linear(4, 8), torch::nn::Linear(8, 2));
+  torch::serialize::CheckpointTracker tracker;
+  auto save_delta = [&](const std::string& filename) {
+    torch::serialize::OutputArchive archive;
+    model->save(archive);
+    archive.save_delta_to(filename, tracker);
+  };
+
+  // Nothing recorded yet: the first delta holds every tensor.
+  auto base = c10::make_tempfile();
+  save_delta(base.name);
+  torch::serialize::InputArchive base_archive;
+  base_archive.load_from(base.name);
+  auto full = torch::nn::Sequential(
+      torch::nn::Linear(4, 8), torch::nn::Linear(8, 2));
+  full->load(base_archive);
+  for (const auto& p : model->named_parameters()) {
+    ASSERT_TRUE(p.value().equal(full->named_parameters()[p.key()]));
+  }
+
+  // Only the tensor updated in place is saved again.
+  {
+    torch::NoGradGuard no_grad;
+    model->named_parameters()["1.weight"].add_(1);
+  }
+  auto delta = c10::make_tempfile();
+  save_delta(delta.name);
+  torch::serialize::InputArchive delta_archive;
+  delta_archive.load_from(delta.name);
+  torch::serialize::InputArchive child;
+  ASSERT_TRUE(delta_archive.try_read("0", child));
+  torch::Tensor tensor;
+  ASSERT_FALSE(child.try_read("weight", tensor));
+  ASSERT_TRUE(delta_archive.try_read("1", child));
+  ASSERT_TRUE(child.try_read("weight", tensor));
+  ASSERT_FALSE(child.try_read("bias", tensor));
+
+  // The base with the delta applied is the current state.
+  torch::serialize::InputArchive archive;
+  archive.load_from(base.name);
+  archive.load_delta_from(delta.name);
+  auto loaded = torch::nn::Sequential(
+      torch::nn::Linear(4, 8), torch::nn::Linear(8, 2));
+  loaded->load(archive);
+  for (const auto& p : model->named_parameters()) {
+    ASSERT_TRUE(p.value().equal(loaded->named_parameters()[p.key()]));
+  }
+}
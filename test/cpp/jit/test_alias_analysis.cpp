@@ -572,6 +572,31 @@ void testWriteTracking() {
     AT_ASSERT(aliasDb.hasWriters(add));
     AT_ASSERT(aliasDb.isMutable(add));
   }
+  {
+    // removeWrites() only forgets a location once no node writes to it
+    auto graph = std::make_shared<Graph>();
+    std::unordered_map<std::string, Value*> vmap;
+    parseIR(
+        R"IR(
+  graph(%x: Tensor, %y : Tensor):
+    %c1 : int = prim::Constant[value=1]()
+    %a : Tensor = aten::add_(%x, %y, %c1)
+    %b : Tensor = aten::mul_(%x, %y)
+    return (%b)
+    )IR",
+        &*graph,
+        vmap);
+    auto add = vmap["a"]->node();
+    auto mul = vmap["b"]->node();
+    AliasDb aliasDb(graph);
+    AT_ASSERT(aliasDb.hasWriters(vmap["x"]));
+    aliasDb.removeWrites(add);
+    AT_ASSERT(!aliasDb.isMutable(add));
+    AT_ASSERT(aliasDb.hasWriters(vmap["x"]));
+    aliasDb.removeWrites(mul);
+    AT_ASSERT(!aliasDb.hasWriters(vmap["x"]));
+    AT_ASSERT(!aliasDb.hasWriters(vmap["y"]));
+  }
 }
 
 void testContainerAliasing() {
@@ -68,8 +68,31 @@ class TestBackend : public PyTorchBackendInterface {
   }
 };
 
+// The test backend, compiling its methods ahead of time.
+class TestBackendCompileAhead : public TestBackend {
+ public:
+  c10::IValue compileAhead(
+      c10::IValue processed,
+      c10::impl::GenericDict method_compile_spec) override {
+    // The handles are the compiled payloads.
+    return compile(processed, method_compile_spec);
+  }
+
+  c10::impl::GenericDict loadCompiled(
+      c10::IValue compiled,
+      c10::impl::GenericDict method_compile_spec) override {
+    auto handles = compiled.toGenericDict();
+    for (const auto& e : method_compile_spec) {
+      TORCH_INTERNAL_ASSERT(handles.contains(e.key()));
+    }
+    return handles;
+  }
+};
+
 namespace {
 static auto cls = torch::jit::backend<TestBackend>("test_backend");
+static auto cls_compile_ahead =
+    torch::jit::backend<TestBackendCompileAhead>("test_backend_compile_ahead");
 }
 
 } // namespace jit
@@ -10,6 +10,7 @@
 #include <torch/csrc/jit/codegen/cuda/kernel.h>
 #include <torch/csrc/jit/codegen/cuda/lower2device.h>
 #include <torch/csrc/jit/codegen/cuda/mutator.h>
+#include <torch/csrc/jit/codegen/cuda/scheduler.h>
 #include <torch/csrc/jit/codegen/cuda/transform_replay.h>
 #include <torch/csrc/jit/codegen/cuda/transform_rfactor.h>
 
@@ -17,7 +18,17 @@
 #include <torch/csrc/jit/codegen/cuda/parser.h>
 #include "torch/csrc/jit/ir/irparser.h"
 
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <thread>
+#include <tuple>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
 
 // Tests go in torch::jit
 namespace torch {
@@ -3880,6 +3891,163 @@ void testGPU_FusionZeroDimReduction() {
       aten_output.sub(output).abs().max());
 }
 
+
+void testGPU_FusionReductionScheduler() {
+  using torch::jit::fuser::cuda::ReductionParams;
+
+  // Short rows are packed into a block, long ones get more threads
+  ReductionParams short_rows =
+      torch::jit::fuser::cuda::reductionHeuristic(1000, 40, true);
+  TORCH_CHECK(short_rows.bdimx == 32 && short_rows.bdimy == 4);
+  ReductionParams long_rows =
+      torch::jit::fuser::cuda::reductionHeuristic(10, 5000, true);
+  TORCH_CHECK(long_rows.bdimx == 512 && long_rows.bdimy == 1);
+  ReductionParams few_columns =
+      torch::jit::fuser::cuda::reductionHeuristic(7, 300, false);
+  TORCH_CHECK(few_columns.bdimx == 8 && few_columns.bdimy == 64);
+
+  // {fastest_dim, number of outputs, reduction size}
+  const std::vector<std::tuple<bool, int, int>> problems = {
+      {true, 1000, 40},
+      {true, 10, 5000},
+      {true, 129, 1025},
+      {false, 7, 300},
+      {false, 1000, 1025}};
+  for (const auto& problem : problems) {
+    const bool fastest_dim = std::get<0>(problem);
+    const int num_outputs = std::get<1>(problem);
+    const int reduction_size = std::get<2>(problem);
+
+    torch::jit::fuser::cuda::CudaKernel prog;
+    Fusion& fusion = *prog.fusion_;
+    FusionGuard fg(&fusion);
+
+    TensorView* tv0 = makeDummyTensor(2);
+    fusion.addInput(tv0);
+    TensorView* tv1 = reductionOp(
+        BinaryOpType::Add, {fastest_dim ? 1 : 0}, new Float(0), tv0);
+    fusion.addOutput(tv1);
+    if (!fastest_dim) {
+      // [R, I] -> [I, R]
+      tv1->reorder({{0, 1}, {1, 0}});
+    }
+
+    const auto params = torch::jit::fuser::cuda::reductionHeuristic(
+        num_outputs, reduction_size, fastest_dim);
+    torch::jit::fuser::cuda::scheduleReduction(&fusion, params);
+
+    prog.device_ = 0;
+    prog.grid(
+        torch::jit::fuser::cuda::reductionGridDim(params, num_outputs));
+    prog.block(params.bdimx, params.bdimy);
+
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    at::Tensor input = fastest_dim
+        ? at::rand({num_outputs, reduction_size}, options)
+        : at::rand({reduction_size, num_outputs}, options);
+    at::Tensor cg_output = at::empty({num_outputs}, options);
+
+    torch::jit::fuser::cuda::compileKernel(&prog);
+    torch::jit::fuser::cuda::runTestKernel(&prog, {input}, {cg_output});
+
+    auto aten_output = input.sum({fastest_dim ? 1 : 0});
+    TORCH_CHECK(
+        aten_output.allclose(cg_output),
+        "Error of: ",
+        aten_output.sub(cg_output).abs().max());
+  }
+}
+
+// tv2 = tv0 + (tv1 + 2) over [64, 2, 128] inputs, see FusionSimplePWise
+static void scheduleSimplePWise(torch::jit::fuser::cuda::CudaKernel& prog) {
+  Fusion& fusion = *prog.fusion_;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeDummyTensor(3);
+  TensorView* tv1 = makeDummyTensor(3);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  TensorView* tv2 = add(tv0, add(tv1, new Float(2.0)));
+  fusion.addOutput(tv2);
+
+  tv2->merge(1);
+  tv2->merge(0);
+  tv2->split(-1, 128 * 2);
+  tv2->split(-1, 128);
+  tv0->computeAt(tv2, -1);
+  tv1->computeAt(tv2, -1);
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  tv2->axis(-2)->parallelize(ParallelType::TIDy);
+  tv2->axis(-1)->parallelize(ParallelType::TIDx);
+
+  prog.device_ = 0;
+  prog.grid(64);
+  prog.block(128, 2);
+}
+
+static void checkSimplePWise(torch::jit::fuser::cuda::CudaKernel& prog) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input1 = at::randn({64, 2, 128}, options);
+  at::Tensor input2 = at::rand_like(input1);
+  at::Tensor output = at::empty_like(input1);
+  torch::jit::fuser::cuda::runTestKernel(&prog, {input1, input2}, {output});
+  TORCH_CHECK(output.equal(input1 + (input2 + 2.0)));
+}
+
+void testGPU_FusionCompileKernelAsync() {
+  using CompileStatus = torch::jit::fuser::cuda::CudaKernel::CompileStatus;
+  torch::jit::fuser::cuda::CudaKernel prog;
+  scheduleSimplePWise(prog);
+
+  torch::jit::fuser::cuda::compileKernelAsync(&prog);
+  while (prog.compile_status_.load() == CompileStatus::Compiling) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  TORCH_CHECK(prog.isCompiled());
+  checkSimplePWise(prog);
+}
+
+void testGPU_FusionKernelCacheDir() {
+#ifndef _WIN32
+  char dir_template[] = "/tmp/cuda_fuser_cache_XXXXXX";
+  const char* cache_dir = mkdtemp(dir_template);
+  TORCH_CHECK(cache_dir);
+  setenv("PYTORCH_CUDA_FUSER_CACHE_DIR", cache_dir, 1);
+
+  auto cached_files = [&]() {
+    std::vector<std::string> files;
+    DIR* dir = opendir(cache_dir);
+    while (dirent* entry = readdir(dir)) {
+      if (entry->d_name[0] != '.') {
+        files.push_back(std::string(cache_dir) + "/" + entry->d_name);
+      }
+    }
+    closedir(dir);
+    return files;
+  };
+
+  // The first kernel gets compiled and stored, the second one, with the same
+  // code, gets loaded from the cache.
+  torch::jit::fuser::cuda::CudaKernel prog1;
+  scheduleSimplePWise(prog1);
+  torch::jit::fuser::cuda::compileKernel(&prog1);
+  const auto files = cached_files();
+  TORCH_CHECK(files.size() == 1);
+
+  torch::jit::fuser::cuda::CudaKernel prog2;
+  scheduleSimplePWise(prog2);
+  torch::jit::fuser::cuda::compileKernel(&prog2);
+  TORCH_CHECK(cached_files() == files);
+  checkSimplePWise(prog2);
+
+  unsetenv("PYTORCH_CUDA_FUSER_CACHE_DIR");
+  for (const auto& file : files) {
+    std::remove(file.c_str());
+  }
+  rmdir(cache_dir);
+#endif
+}
+
 } // namespace jit
 } // namespace torch
 #endif // #if defined(USE_CUDA)
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/mobile/import.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/custom_class.h>
 #include <torch/torch.h>
@@ -358,6 +359,49 @@ void testLiteInterpreterBuiltinFunction() {
   AT_ASSERT(str == expected);
 }
 
+void testLiteInterpreterOpSampling() {
+  Module m("m");
+  m.define(R"(
+    def forward(self, x):
+      return x + x * 2
+  )");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+
+  auto& config = torch::observerConfig();
+  config.getOpStats().reset();
+  // Sampling every op
+  config.setOpSamplingPeriod(1);
+  const uint64_t num_runs = 3;
+  for (uint64_t i = 0; i < num_runs; ++i) {
+    bc.forward(std::vector<IValue>{torch::ones({64, 64})});
+  }
+  config.setOpSamplingPeriod(0);
+  bc.forward(std::vector<IValue>{torch::ones({64, 64})});
+
+  auto stats = config.getOpStats().getStats();
+  for (const char* op_name : {"aten::add.Tensor", "aten::mul.Scalar"}) {
+    auto it = stats.find(op_name);
+    ASSERT_TRUE(it != stats.end());
+    const auto& op_stats = it->second;
+    ASSERT_EQ(op_stats.num_samples, num_runs);
+    uint64_t histogram_samples = 0;
+    for (auto count : op_stats.latency_histogram) {
+      histogram_samples += count;
+    }
+    ASSERT_EQ(histogram_samples, num_runs);
+    // Every run allocates the output of the op
+    ASSERT_GE(op_stats.num_allocations, num_runs);
+    ASSERT_GE(op_stats.allocated_bytes, num_runs * 64 * 64 * sizeof(float));
+  }
+  ASSERT_NE(
+      config.getOpStats().serialize().find("aten::add.Tensor 3 "),
+      std::string::npos);
+  config.getOpStats().reset();
+  ASSERT_TRUE(config.getOpStats().getStats().empty());
+}
+
 namespace {
 static auto reg =
     torch::class_<TorchBindLiteInterpreterTestStruct>(
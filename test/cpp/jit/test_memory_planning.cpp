@@ -0,0 +1,58 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
+#include <torch/csrc/jit/runtime/interpreter.h>
+#include <torch/csrc/jit/testing/file_check.h>
+
+namespace torch {
+namespace jit {
+void testMemoryPlanning() {
+  const std::string input =
+      R"IR(
+graph(%x : Float(4, 4),
+      %y : Float(4, 4)):
+  %one : int = prim::Constant[value=1]()
+  %a : Float(4, 4) = aten::add(%x, %y, %one)
+  %b : Float(4, 4) = aten::mul(%a, %y)
+  %c : Float(4, 4) = aten::add(%b, %x, %one)
+  %d : Float(4, 4) = aten::mul(%c, %c)
+  %e : Float(4, 4) = aten::sub(%d, %x, %one)
+  return (%e)
+)IR";
+  auto reference = std::make_shared<Graph>();
+  parseIR(input, reference.get());
+  auto graph = reference->copy();
+  PlanMemory(graph);
+
+  // %e is returned, the others are planned; %a and %c, and %b and %d, are
+  // never live at the same time and share their memory.
+  testing::FileCheck()
+      .check("prim::AllocateArena[size=128]")
+      ->check_count("prim::ArenaTensor", 4, /*exactly*/ true)
+      ->run(*graph);
+  std::vector<int64_t> offsets;
+  for (Node* node : graph->nodes()) {
+    if (node->kind() == prim::ArenaTensor) {
+      offsets.push_back(node->i(attr::offset));
+    }
+  }
+  ASSERT_EQ(offsets, std::vector<int64_t>({0, 64, 0, 64}));
+
+  auto x = at::randn({4, 4});
+  auto y = at::randn({4, 4});
+  Code reference_code(reference, "");
+  InterpreterState reference_interp(reference_code);
+  auto expected = run(reference_interp, {x, y});
+
+  // the second run reuses the arena of the first one
+  Code code(graph, "");
+  for (int i = 0; i < 2; ++i) {
+    InterpreterState interp(code);
+    auto outputs = run(interp, {x, y});
+    ASSERT_TRUE(exactlyEqual(outputs[0], expected[0]));
+  }
+}
+} // namespace jit
+} // namespace torch
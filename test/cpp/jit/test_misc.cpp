@@ -930,6 +930,22 @@ void testRecordFunction() {
   TORCH_CHECK(sampled_cb_ctr == 1000);
   clearCallbacks();
 
+  // test pre-sampling: with only low probability global callbacks, the
+  // sampling is done before RecordFunction is constructed
+  bool pre_sampled = false;
+  sampled_cb_ctr = 0;
+  handle = setup_sampled_callback(0.0);
+  shouldRunRecordFunction(&pre_sampled);
+  TORCH_CHECK(pre_sampled);
+  run_test_function();
+  TORCH_CHECK(sampled_cb_ctr == 0);
+
+  addGlobalCallback(RecordFunctionCallback(
+      [](const RecordFunction&) {}, [](const RecordFunction&) {}));
+  TORCH_CHECK(shouldRunRecordFunction(&pre_sampled));
+  TORCH_CHECK(!pre_sampled);
+  clearCallbacks();
+
   // test the scope of the callbacks
   checkScopeCallbacks();
   clearCallbacks();
@@ -1082,6 +1098,35 @@ void testRecordFunction() {
   t.join();
   clearCallbacks();
 
+  // test that a state taken after the TLS callbacks change doesn't reuse
+  // the previous one
+  std::thread t_changed([]() {
+    RecordFunctionGuard enable_rec_fn;
+    std::string recorded_op;
+    auto handle = addThreadLocalCallback(RecordFunctionCallback(
+        [&recorded_op](const RecordFunction& fn) {
+          recorded_op = fn.name().str();
+        },
+        [](const RecordFunction&) {}));
+    ThreadLocalState state_with_callback;
+    removeCallback(handle);
+    ThreadLocalState state_without_callback;
+    std::thread t_child([state_without_callback]() {
+      ThreadLocalStateGuard g_tls(state_without_callback);
+      RECORD_USER_SCOPE("test_without_callback");
+    });
+    t_child.join();
+    TORCH_CHECK(recorded_op.empty());
+    std::thread t_child_with_callback([state_with_callback]() {
+      ThreadLocalStateGuard g_tls(state_with_callback);
+      RECORD_USER_SCOPE("test_with_callback");
+    });
+    t_child_with_callback.join();
+    TORCH_CHECK(recorded_op == "test_with_callback");
+  });
+  t_changed.join();
+  clearCallbacks();
+
   // test set ids
   bool has_ids = false;
   addGlobalCallback(
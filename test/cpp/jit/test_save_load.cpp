@@ -2,6 +2,7 @@
 #include <test/cpp/jit/test_utils.h>
 #include <sstream>
 
+#include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/jit/serialization/export.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/csrc/jit/serialization/import_source.h>
@@ -121,5 +122,36 @@ void testTypeTags() {
   }
 }
 
+void testSaveLoadExecutorProfile() {
+  const auto script = R"JIT(
+    def forward(self, x):
+        return x * 2 + 1
+  )JIT";
+
+  auto old_profiling_mode = getProfilingMode().exchange(true);
+  auto old_executor_mode = getExecutorMode().exchange(true);
+  Module m("m");
+  m.define(script);
+  auto input = torch::randn({2, 3});
+  // One more run than the profiling runs builds the optimized plan.
+  for (size_t i = 0; i <= getNumProfiledRuns(); ++i) {
+    m.forward({input});
+  }
+  ASSERT_FALSE(m.get_method("forward").get_executor().getProfile().isNone());
+
+  std::stringstream ss;
+  m.save(ss);
+  ss.seekg(0);
+  auto loaded = torch::jit::load(ss);
+  // The loaded method has its profile, and so its optimized plan, before it
+  // ever ran.
+  ASSERT_FALSE(
+      loaded.get_method("forward").get_executor().getProfile().isNone());
+  ASSERT_TRUE(almostEqual(
+      loaded.forward({input}).toTensor(), m.forward({input}).toTensor()));
+  getProfilingMode() = old_profiling_mode;
+  getExecutorMode() = old_executor_mode;
+}
+
 } // namespace jit
 } // namespace torch
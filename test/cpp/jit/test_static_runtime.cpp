@@ -0,0 +1,52 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+#include <torch/torch.h>
+
+namespace torch {
+namespace jit {
+
+void testStaticRuntime() {
+  Module m("m");
+  m.register_parameter("weight", torch::randn({8, 16}), false);
+  m.register_parameter("bias", torch::randn({8}), false);
+  m.define(R"(
+    def forward(self, x, y):
+      h = torch.addmm(self.bias, x, self.weight.t())
+      h = torch.relu(h) * torch.sigmoid(y)
+      z = torch.cat([h, y], 1) - 1.0
+      return torch.tanh(z + y.repeat(1, 2))
+  )");
+  m.eval();
+
+  StaticRuntime runtime(m);
+  size_t native = 0;
+  size_t boxed = 0;
+  for (const auto& node : runtime.nodes()) {
+    node.hasNativeKernel() ? ++native : ++boxed;
+  }
+  // addmm, relu, sigmoid, mul, add and tanh call their kernels directly,
+  // cat, sub with a scalar and repeat go through their Operation
+  ASSERT_EQ(native, 6);
+  ASSERT_GT(boxed, 0);
+
+  for (int i = 0; i < 2; ++i) {
+    auto x = torch::randn({4, 16});
+    auto y = torch::randn({4, 8});
+    auto expected = m.forward({x, y}).toTensor();
+    auto outputs = runtime.run(std::vector<at::Tensor>{x, y});
+    ASSERT_EQ(outputs.size(), 1);
+    ASSERT_TRUE(outputs[0].allclose(expected));
+    ASSERT_FALSE(outputs[0].requires_grad());
+  }
+
+  // a runtime created from the graph of another one runs the same graph
+  StaticRuntime copy(runtime.graph());
+  auto x = torch::randn({4, 16});
+  auto y = torch::randn({4, 8});
+  auto outputs = copy.run(std::vector<IValue>{x, y});
+  ASSERT_TRUE(outputs[0].toTensor().allclose(m.forward({x, y}).toTensor()));
+}
+
+} // namespace jit
+} // namespace torch
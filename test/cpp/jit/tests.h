@@ -69,7 +69,10 @@ namespace jit {
   _(ExtraFilesHookPreference)          \
   _(SaveExtraFilesHook)                \
   _(TypeTags)                          \
+  _(SaveLoadExecutorProfile)           \
   _(DCE)                               \
+  _(MemoryPlanning)                    \
+  _(StaticRuntime)                     \
   _(CustomFusionNestedBlocks)          \
   _(ClassDerive)                       \
   _(SaveLoadTorchbind)                 \
@@ -95,6 +98,7 @@ namespace jit {
   _(LiteInterpreterSetState)           \
   _(TorchbindIValueAPI)                \
   _(LiteInterpreterDict)               \
+  _(LiteInterpreterOpSampling)         \
   _(FusionAliasing)
 
 #if defined(USE_CUDA)
@@ -166,7 +170,10 @@ namespace jit {
   _(GPU_FusionZeroDimComputeAt)   \
   _(GPU_FusionZeroDimBroadcast)   \
   _(GPU_FusionZeroDimReduction)   \
-  _(GPU_FusionReductionMultiConsumer)
+  _(GPU_FusionReductionMultiConsumer) \
+  _(GPU_FusionReductionScheduler)     \
+  _(GPU_FusionCompileKernelAsync)     \
+  _(GPU_FusionKernelCacheDir)
 #else
 #define TH_FORALL_TESTS_CUDA(_) \
   _(ArgumentSpec)               \
@@ -105,5 +105,119 @@ void testKernel_3() {
   }
 }
 
+void testKernelSpecializations() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(4:8,8:1),
+            %1 : Float(4:8,8:1)):
+        %2 : Float(4:8,8:1) = aten::mul(%0, %1)
+        %3 : Float(4:8,8:1) = aten::mul(%0, %2)
+        return (%3))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+  TensorExprKernel k(graph);
+
+  auto check = [&](const at::Tensor& a, const at::Tensor& b) {
+    std::vector<IValue> stack = {a, b};
+    k.run(stack);
+    ASSERT_TRUE(stack[0].toTensor().allclose(a * (a * b)));
+  };
+  auto rand = [](at::IntArrayRef sizes) {
+    return at::rand(sizes, TensorOptions(kCPU).dtype(at::kFloat));
+  };
+
+  // The shapes the subgraph was compiled for don't need a specialization.
+  check(rand({4, 8}), rand({4, 8}));
+  ASSERT_EQ(k.specializationStats().misses, 0);
+
+  // Other sizes share a kernel with symbolic sizes...
+  check(rand({6, 8}), rand({6, 8}));
+  check(rand({10, 3}), rand({10, 3}));
+  ASSERT_EQ(k.specializationStats().misses, 1);
+  ASSERT_EQ(k.specializationStats().hits, 1);
+
+  // ...but not another broadcasting pattern, or non matching sizes.
+  check(rand({6, 8}), rand({1, 8}));
+  check(rand({6, 8}), rand({1, 8}));
+  ASSERT_EQ(k.specializationStats().misses, 2);
+  ASSERT_EQ(k.specializationStats().hits, 2);
+  std::vector<IValue> stack = {rand({6, 8}), rand({5, 8})};
+  ASSERT_ANY_THROW(k.run(stack));
+
+  // The least recently used specialization, for a {1, 8} second input, is
+  // evicted, and compiled again the next time it is needed.
+  auto cacheSize = getTEKernelCacheSize();
+  getTEKernelCacheSize() = 2;
+  check(rand({1, 8}), rand({6, 8}));
+  ASSERT_EQ(k.specializationStats().misses, 3);
+  ASSERT_EQ(k.specializationStats().evictions, 1);
+  check(rand({6, 8}), rand({1, 8}));
+  ASSERT_EQ(k.specializationStats().misses, 4);
+  getTEKernelCacheSize() = cacheSize;
+}
+
+void testKernelReductions() {
+  KernelScope kernel_scope;
+  bool oldFallbackAllowed = setFallbackAllowed(false);
+
+  // Normalizations, and a reduction with an elementwise epilogue, that keep
+  // the outer dim, which is large enough to be split between threads.
+  const auto graph_string = R"IR(
+      graph(%x : Float(4096:16,16:1),
+            %w : Float(16:1),
+            %b : Float(16:1)):
+        %none : None = prim::Constant()
+        %true : bool = prim::Constant[value=1]()
+        %one : int = prim::Constant[value=1]()
+        %minus_one : int = prim::Constant[value=-1]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %dims : int[] = prim::Constant[value=[1]]()
+        %shape : int[] = prim::Constant[value=[16]]()
+        %s : Float(4096:16,16:1) = aten::softmax(%x, %minus_one, %none)
+        %l : Float(4096:16,16:1) = aten::log_softmax(%x, %one, %none)
+        %n : Float(4096:16,16:1) = aten::layer_norm(%x, %shape, %w, %b, %eps, %true)
+        %m : Float(4096:1,1:1) = aten::mean(%x, %dims, %true, %none)
+        %c : Float(4096:16,16:1) = aten::sub(%x, %m, %one)
+        %r : Float(4096:16,16:1) = aten::relu(%c)
+        return (%s, %l, %n, %r))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+  TensorExprKernel k(graph);
+
+  auto x = at::randn({4096, 16}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto w = at::randn({16}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto b = at::randn({16}, TensorOptions(kCPU).dtype(at::kFloat));
+  std::vector<IValue> stack = {x, w, b};
+  k.run(stack);
+  ASSERT_TRUE(stack[0].toTensor().allclose(at::softmax(x, -1)));
+  ASSERT_TRUE(stack[1].toTensor().allclose(at::log_softmax(x, 1)));
+  ASSERT_TRUE(stack[2].toTensor().allclose(
+      at::layer_norm(x, {16}, w, b), 1e-04, 1e-05));
+  ASSERT_TRUE(stack[3].toTensor().allclose(at::relu(x - x.mean(1, true))));
+
+  // Reductions over the outer dim, with and without keeping it.
+  const auto outer_graph_string = R"IR(
+      graph(%x : Float(8:16,16:1)):
+        %none : None = prim::Constant()
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %dims : int[] = prim::Constant[value=[0]]()
+        %s : Float(16:1) = aten::sum(%x, %dims, %false, %none)
+        %m : Float(1:16,16:1) = aten::mean(%x, %dims, %true, %none)
+        return (%s, %m))IR";
+  auto outer_graph = std::make_shared<Graph>();
+  parseIR(outer_graph_string, &*outer_graph);
+  TensorExprKernel outer_k(outer_graph);
+
+  auto y = at::randn({8, 16}, TensorOptions(kCPU).dtype(at::kFloat));
+  stack = {y};
+  outer_k.run(stack);
+  ASSERT_TRUE(stack[0].toTensor().allclose(y.sum(0), 1e-04, 1e-05));
+  ASSERT_TRUE(stack[1].toTensor().allclose(y.mean(0, true), 1e-04, 1e-05));
+
+  setFallbackAllowed(oldFallbackAllowed);
+}
+
 } // namespace jit
 } // namespace torch
@@ -5,14 +5,18 @@
 #include "test/cpp/tensorexpr/test_utils.h"
 #include "torch/csrc/jit/tensorexpr/buffer.h"
 #include "torch/csrc/jit/tensorexpr/eval.h"
+#include "torch/csrc/jit/tensorexpr/execution_counter.h"
 #include "torch/csrc/jit/tensorexpr/function.h"
 #include "torch/csrc/jit/tensorexpr/ir.h"
 #include "torch/csrc/jit/tensorexpr/ir_printer.h"
 #include "torch/csrc/jit/tensorexpr/ir_simplifier.h"
+#include "torch/csrc/jit/tensorexpr/kernel.h"
 #include "torch/csrc/jit/tensorexpr/llvm_codegen.h"
 #include "torch/csrc/jit/tensorexpr/loopnest.h"
 #include "torch/csrc/jit/tensorexpr/tensor.h"
 
+#include <llvm/Support/FileSystem.h>
+
 #include <numeric>
 
 namespace torch {
@@ -1383,6 +1387,91 @@ void testLLVMRFactorVectorizedReduction() {
   ExpectAllNear(b_v, b_ref, 1e-5);
 }
 
+void testLLVMParallelLoop() {
+  KernelScope kernel_scope;
+  auto testWithSize = [](int32_t M) {
+    const int N = 37;
+    VarHandle m("m", kInt);
+    Buffer a(BufHandle("a", {m, N}, kFloat));
+    Buffer b(BufHandle("b", {m, N}, kFloat));
+    Tensor* c = Compute(
+        "c", {{m, "m"}, {N, "n"}}, [&](const VarHandle& i, const VarHandle& j) {
+          return a(i, j) * b(i, j) + Cast::make(kFloat, i);
+        });
+    LoopNest l({c});
+    std::vector<For*> loops = l.getLoopStmtsFor(c);
+    For* outer;
+    For* inner;
+    For* tail;
+    l.splitWithTail(loops[1], 8, &outer, &inner, &tail);
+    l.vectorize(inner);
+    l.setParallel(loops[0]);
+    l.prepareForCodegen();
+    Stmt* s = IRSimplifier::simplify(l.root_stmt());
+
+    std::ostringstream oss;
+    oss << *s;
+    ASSERT_NE(oss.str().find("/* parallel */"), std::string::npos);
+
+    LLVMCodeGen cg(s, {a, b, c, m});
+    std::vector<float> aData(M * N);
+    std::vector<float> bData(M * N, 2.0f);
+    std::vector<float> cData(M * N, 0.0f);
+    std::vector<float> cRef(M * N);
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        aData[i * N + j] = j;
+        cRef[i * N + j] = 2.0f * j + i;
+      }
+    }
+    cg.call({aData, bData, cData, M});
+    ExpectAllNear(cData, cRef, 1e-7);
+  };
+  testWithSize(0);
+  testWithSize(1);
+  testWithSize(2048);
+}
+
+void testLLVMObjectCache() {
+  KernelScope kernel_scope;
+  llvm::SmallString<128> cacheDir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("te_llvm_cache", cacheDir));
+  std::string oldCacheDir = getTELLVMCacheDir();
+  getTELLVMCacheDir() = cacheDir.str().str();
+  ExecutionCounter cacheHits(*ExecutionTriggerList::GetInstance().FindByName(
+      "llvm_codegen_cache_hit"));
+
+  auto compileAndRun = [](float scale) {
+    const int N = 64;
+    Buffer a(BufHandle("a", {N}, kFloat));
+    Tensor* b = Compute("b", {{N, "i"}}, [&](const VarHandle& i) {
+      return a(i) * FloatImm::make(scale) + FloatImm::make(1.0f);
+    });
+    LoopNest l({b});
+    l.prepareForCodegen();
+    Stmt* s = IRSimplifier::simplify(l.root_stmt());
+    LLVMCodeGen cg(s, {a, b});
+    std::vector<float> aData(N, 2.0f);
+    std::vector<float> bData(N, 0.0f);
+    cg.call({aData, bData});
+    ExpectAllNear(bData, std::vector<float>(N, 2.0f * scale + 1.0f), 1e-7);
+  };
+  compileAndRun(3.0f);
+  ASSERT_EQ(cacheHits.elapsed_value(), 0);
+  // The same kernel, built again, is loaded from the cache.
+  compileAndRun(3.0f);
+  ASSERT_EQ(cacheHits.elapsed_value(), 1);
+  // A different one is not.
+  compileAndRun(5.0f);
+  ASSERT_EQ(cacheHits.elapsed_value(), 1);
+  compileAndRun(5.0f);
+  ASSERT_EQ(cacheHits.elapsed_value(), 2);
+
+  getTELLVMCacheDir() = oldCacheDir;
+  llvm::sys::fs::remove_directories(cacheDir);
+}
+
 } // namespace jit
 } // namespace torch
 
@@ -191,6 +191,8 @@ namespace jit {
   _(Kernel_1)                               \
   _(Kernel_2)                               \
   _(Kernel_3)                               \
+  _(KernelSpecializations)                  \
+  _(KernelReductions)                       \
   _(FuserPass_1)                            \
   _(FuserPass_2)
 
@@ -316,7 +318,9 @@ namespace jit {
   _(LLVMVectorizerLoadStoreTest)           \
   _(LLVMSimpleReduction)                   \
   _(LLVMRFactorReduction)                  \
-  _(LLVMRFactorVectorizedReduction)
+  _(LLVMRFactorVectorizedReduction)        \
+  _(LLVMParallelLoop)                      \
+  _(LLVMObjectCache)
 
 #define TH_FORALL_TENSOREXPR_TESTS_CUDA(_) \
   _(CudaTestVectorAdd01)                   \
@@ -25,6 +25,7 @@ from torch import nn
 import torch.nn.functional as F
 import torch.distributed as c10d
 import torch.distributed as dist
+from torch.distributed.algorithms.ddp_comm_hooks import default_hooks
 from torch.nn.parallel import DistributedDataParallel
 
 from torch.testing._internal.common_distributed import MultiProcessTestCase, \
@@ -215,6 +216,27 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def test_multi_set_get(self):
+        fs = self._create_store()
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", "value2"])
+        fs.set("key3", "value3")
+        self.assertEqual(
+            [b"value3", b"value0", b"value2"],
+            fs.multi_get(["key3", "key0", "key2"]))
+        self.assertEqual(b"value1", fs.get("key1"))
+        self.assertEqual([], fs.multi_get([]))
+        with self.assertRaisesRegex(ValueError, "as many values as keys"):
+            fs.multi_set(["key0", "key1"], ["value0"])
+
+    def test_compare_set(self):
+        fs = self._create_store()
+        # A key that isn't set compares equal to an empty value.
+        self.assertEqual(b"", fs.compare_set("key", "other", "value0"))
+        self.assertEqual(b"value0", fs.compare_set("key", "", "value0"))
+        self.assertEqual(b"value0", fs.compare_set("key", "other", "value1"))
+        self.assertEqual(b"value1", fs.compare_set("key", "value0", "value1"))
+        self.assertEqual(b"value1", fs.get("key"))
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -1497,6 +1519,141 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
                 continue
             self.assertEqual(torch.tensor([i]), outputs[i])
 
+    def test_reduce_scatter_basics(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Rank r contributes r + i to the output of rank i
+        inputs = [
+            torch.tensor([self.rank + i, 2 * (self.rank + i)], dtype=torch.float)
+            for i in range(self.world_size)
+        ]
+        output = torch.zeros(2)
+        pg.reduce_scatter(output, inputs).wait()
+        expected = sum(r + self.rank for r in range(self.world_size))
+        self.assertEqual(torch.tensor([expected, 2 * expected], dtype=torch.float), output)
+        # The inputs are not modified
+        self.assertEqual(torch.tensor([self.rank, 2 * self.rank], dtype=torch.float), inputs[0])
+
+        opts = c10d.ReduceScatterOptions()
+        opts.reduceOp = c10d.ReduceOp.MAX
+        pg.reduce_scatter([output], [inputs], opts).wait()
+        expected = self.world_size - 1 + self.rank
+        self.assertEqual(torch.tensor([expected, 2 * expected], dtype=torch.float), output)
+
+    def test_reduce_scatter_checks(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        t1 = torch.zeros([1], dtype=torch.float32)
+        t2 = torch.zeros([1], dtype=torch.float64)
+
+        with self.assertRaisesRegex(ValueError, "Incorrect input list size"):
+            pg.reduce_scatter([t1], [[t1] * (self.world_size + 1)])
+
+        with self.assertRaisesRegex(ValueError, "invalid tensor type"):
+            pg.reduce_scatter([t1], [[t2] * self.world_size])
+
+    def _test_alltoall_base_basics(self, fn):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Equal splits: rank r sends r * world_size + i to rank i
+        input = fn(torch.arange(self.world_size) + self.rank * self.world_size)
+        output = fn(torch.full((self.world_size,), -1, dtype=torch.long))
+        pg.alltoall_base(output, input, [], []).wait()
+        expected = torch.arange(self.world_size) * self.world_size + self.rank
+        self.assertEqual(expected, output.cpu())
+
+        # Variable splits: rank r sends i + 1 copies of r to rank i
+        input_splits = [i + 1 for i in range(self.world_size)]
+        output_splits = [self.rank + 1] * self.world_size
+        input = fn(torch.full((sum(input_splits),), self.rank, dtype=torch.long))
+        output = fn(torch.full((sum(output_splits),), -1, dtype=torch.long))
+        pg.alltoall_base(output, input, output_splits, input_splits).wait()
+        expected = torch.cat([
+            torch.full((self.rank + 1,), i, dtype=torch.long)
+            for i in range(self.world_size)
+        ])
+        self.assertEqual(expected, output.cpu())
+
+    def test_alltoall_base_basics(self):
+        self._test_alltoall_base_basics(lambda t: t.clone())
+
+    @skip_if_not_multigpu
+    def test_alltoall_base_basics_cuda(self):
+        self._test_alltoall_base_basics(lambda t: t.clone().cuda())
+
+    def test_alltoall_base_checks(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        t1 = torch.zeros(self.world_size)
+        with self.assertRaisesRegex(RuntimeError, "Split sizes doesn't match"):
+            pg.alltoall_base(t1, t1, [], [2] * self.world_size)
+
+        with self.assertRaisesRegex(ValueError, "same type"):
+            pg.alltoall_base(t1, t1.long(), [], [])
+
+        with self.assertRaisesRegex(ValueError, "contiguous"):
+            t2 = torch.zeros(2, self.world_size).t()
+            pg.alltoall_base(t2, t2, [], [])
+
+    def test_sharded_embedding_bag(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Every rank owns a table of a different size and the first one two
+        table_dims = [4, 3, 2, 5, 6]
+        num_embeddings = [10, 7, 12, 5, 9]
+        table_ranks = [t % self.world_size for t in range(len(table_dims))]
+        batch_size = 3
+        torch.manual_seed(0)
+        weights = [
+            torch.randn(n, d) for n, d in zip(num_embeddings, table_dims)
+        ]
+
+        # The bags and output gradients of every rank, generated the same on
+        # all of them for the reference
+        def batch(rank):
+            generator = torch.Generator().manual_seed(rank)
+            indices, offsets, grads = [], [], []
+            for n, d in zip(num_embeddings, table_dims):
+                lengths = torch.randint(1, 4, (batch_size,), generator=generator)
+                offsets.append(torch.cumsum(lengths, 0) - lengths)
+                indices.append(torch.randint(
+                    n, (int(lengths.sum()),), generator=generator))
+                grads.append(torch.randn(batch_size, d, generator=generator))
+            return indices, offsets, grads
+
+        local_tables = [
+            t for t in range(len(table_dims)) if table_ranks[t] == self.rank
+        ]
+        for mode, mode_name in enumerate(["sum", "mean", "max"]):
+            embedding_bag = c10d._ShardedEmbeddingBag(
+                pg,
+                table_ranks,
+                table_dims,
+                [weights[t] for t in local_tables],
+                mode,
+            )
+            indices, offsets, grads = batch(self.rank)
+            outputs = embedding_bag.forward(indices, offsets).wait()
+            weight_grads = embedding_bag.backward(grads).wait()
+
+            references = [w.clone().requires_grad_() for w in weights]
+            for rank in range(self.world_size):
+                rank_indices, rank_offsets, rank_grads = batch(rank)
+                for t, reference in enumerate(references):
+                    output = F.embedding_bag(
+                        rank_indices[t], reference, rank_offsets[t], mode=mode_name
+                    )
+                    if rank == self.rank:
+                        self.assertEqual(output, outputs[t])
+                    output.backward(rank_grads[t])
+            for t, weight_grad in zip(local_tables, weight_grads):
+                self.assertEqual(references[t].grad, weight_grad)
+
     def test_barrier_implies_wait(self):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
@@ -1532,6 +1689,35 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
             pg.broadcast(tensor, root=0).wait()
             self.assertEqual(torch.full([100, 100], 0.), tensor)
 
+    def test_round_robin_striped(self):
+        num_process_groups = 3
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d._round_robin_process_groups([
+            c10d.ProcessGroupGloo(
+                c10d.PrefixStore(str(i), store),
+                self.rank,
+                self.world_size)
+            for i in range(num_process_groups)
+        ], stripe_threshold_bytes=1024)
+
+        # Large enough to be striped across all process groups
+        tensor = torch.arange(1000, dtype=torch.float).view(10, 100) * (self.rank + 1)
+        pg.allreduce(tensor).wait()
+        expected_factor = sum(range(1, self.world_size + 1))
+        self.assertEqual(
+            torch.arange(1000, dtype=torch.float).view(10, 100) * expected_factor,
+            tensor)
+
+        tensor = torch.full([1000], float(self.rank))
+        fut = pg.broadcast(tensor, root=1).get_future()
+        fut.wait()
+        self.assertEqual(torch.full([1000], 1.), tensor)
+
+        # Small tensors still go to a single process group
+        tensor = torch.ones([10])
+        pg.allreduce(tensor).wait()
+        self.assertEqual(torch.full([10], float(self.world_size)), tensor)
+
     def test_round_robin_create_destroy(self):
         store = c10d.FileStore(self.file_name, self.world_size)
 
@@ -1594,6 +1780,26 @@ class ProcessGroupNCCLTest(TestCase):
         pg.reduce_scatter(ys, xs).wait()
         self.assertEqual(0, ys[0].numel())
 
+    def test_alltoall_base_ops(self):
+        if torch.cuda.nccl.version() < 2700:
+            raise unittest.SkipTest("alltoall_base requires NCCL 2.7+")
+
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        input = torch.arange(6, dtype=torch.float).cuda()
+        output = torch.zeros(6).cuda()
+        pg.alltoall_base(output, input, [], []).wait()
+        self.assertEqual(input, output)
+
+        output = torch.zeros(6).cuda()
+        pg.alltoall_base(output, input, [6], [6]).wait()
+        self.assertEqual(input, output)
+
+        outputs = [torch.zeros(6).cuda()]
+        pg.alltoall(outputs, [input]).wait()
+        self.assertEqual(input, outputs[0])
+
     def test_broadcast_ops(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -1673,6 +1879,48 @@ class ProcessGroupNCCLTest(TestCase):
         for i in range(self.num_gpus):
             self.assertEqual(torch.tensor([self.num_gpus]), tensors[i])
 
+    def test_allreduce_coalesced_ops(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        # tensors of different sizes and types, reduced in a single NCCL group
+        tensors = [
+            torch.full((i + 1,), float(i), device="cuda:0")
+            for i in range(10)
+        ] + [torch.tensor([7], device="cuda:0")]
+        expected = [t.clone() * self.world_size for t in tensors]
+
+        opts = c10d.AllreduceCoalescedOptions()
+        opts.reduceOp = c10d.ReduceOp.SUM
+        pg.allreduce_coalesced(tensors, opts).wait()
+
+        for t, e in zip(tensors, expected):
+            self.assertEqual(e, t)
+
+        with self.assertRaisesRegex(RuntimeError, "same GPU device"):
+            pg.allreduce_coalesced(
+                [torch.ones(1, device="cuda:0"), torch.ones(1, device="cuda:1")],
+                opts)
+
+    def test_allgather_coalesced_ops(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        inputs = [
+            torch.full((i + 1,), float(self.rank + i), device="cuda:0")
+            for i in range(10)
+        ]
+        outputs = [
+            [torch.zeros_like(t) for t in inputs]
+            for _ in range(self.world_size)
+        ]
+
+        pg.allgather_coalesced(outputs, inputs).wait()
+
+        for rank, rank_outputs in enumerate(outputs):
+            for i, t in enumerate(rank_outputs):
+                self.assertEqual(torch.full((i + 1,), float(rank + i)), t)
+
     def test_reduce_ops(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -2989,6 +3237,121 @@ class DistributedDataParallelTest(MultiProcessTestCase):
             with self.assertRaisesRegex(RuntimeError, ".* appears not to match strides of the same param in process 0"):
                 m_ddp = DistributedDataParallel(m, device_ids=[dev0], process_group=process_group)
 
+    def _run_and_verify_comm_hook(self, process_group, register):
+        torch.manual_seed(0)
+        net = Net()
+        reference = DistributedDataParallel(
+            copy.deepcopy(net), process_group=process_group, bucket_cap_mb=0.001
+        )
+        hooked = DistributedDataParallel(
+            copy.deepcopy(net), process_group=process_group, bucket_cap_mb=0.001
+        )
+        register(hooked)
+
+        torch.manual_seed(self.rank)
+        input = torch.randn(4, 2)
+        reference(input).sum().backward()
+        hooked(input).sum().backward()
+        for p, q in zip(reference.parameters(), hooked.parameters()):
+            self.assertEqual(p.grad, q.grad, rtol=1e-3, atol=1e-3)
+
+    @requires_gloo()
+    def test_ddp_comm_hook_allreduce_hook(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+        self._run_and_verify_comm_hook(
+            process_group,
+            lambda model: model.register_comm_hook(
+                process_group, default_hooks.allreduce_hook
+            ),
+        )
+
+    @requires_gloo()
+    def test_ddp_comm_hook_fp16_compress_hook(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+        self._run_and_verify_comm_hook(
+            process_group,
+            lambda model: model.register_comm_hook(
+                process_group, default_hooks.fp16_compress_hook
+            ),
+        )
+
+    @requires_gloo()
+    def test_ddp_builtin_comm_hooks(self):
+        for hook_type in [
+            c10d.BuiltinCommHookType.ALLREDUCE,
+            c10d.BuiltinCommHookType.FP16_COMPRESS,
+        ]:
+            store = c10d.FileStore(self.file_name + str(hook_type), self.world_size)
+            process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+            self._run_and_verify_comm_hook(
+                process_group,
+                lambda model: model._register_builtin_comm_hook(hook_type),
+            )
+
+    @requires_gloo()
+    def test_ddp_comm_hook_register_twice(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+        model = DistributedDataParallel(Net(), process_group=process_group)
+        model.register_comm_hook(process_group, default_hooks.allreduce_hook)
+        with self.assertRaisesRegex(
+            RuntimeError, "register_comm_hook can only be called once."
+        ):
+            model.register_comm_hook(process_group, default_hooks.allreduce_hook)
+
+    @requires_gloo()
+    def test_ddp_comm_hook_must_return_future(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+        model = DistributedDataParallel(Net(), process_group=process_group)
+
+        def hook(state, bucket):
+            return bucket.get_tensors()
+
+        model.register_comm_hook(None, hook)
+        with self.assertRaisesRegex(
+            RuntimeError, "callback must return a torch.futures.Future"
+        ):
+            model(torch.randn(4, 2)).sum().backward()
+
+    @requires_gloo()
+    def test_ddp_gradient_as_bucket_view(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        torch.manual_seed(0)
+        net = Net()
+        reference = DistributedDataParallel(
+            copy.deepcopy(net), process_group=process_group, bucket_cap_mb=0.001
+        )
+        view_model = DistributedDataParallel(
+            copy.deepcopy(net),
+            process_group=process_group,
+            bucket_cap_mb=0.001,
+            gradient_as_bucket_view=True,
+        )
+        reference_opt = torch.optim.SGD(reference.parameters(), lr=0.1)
+        view_opt = torch.optim.SGD(view_model.parameters(), lr=0.1)
+
+        torch.manual_seed(self.rank)
+        grad_ptrs = None
+        for _ in range(4):
+            input = torch.randn(4, 2)
+            for model, opt in [(reference, reference_opt), (view_model, view_opt)]:
+                opt.zero_grad()
+                model(input).sum().backward()
+                opt.step()
+            for p, q in zip(reference.parameters(), view_model.parameters()):
+                self.assertEqual(p.grad, q.grad)
+                self.assertEqual(p, q)
+            # Once the grads are views into the buckets, they stay in place.
+            ptrs = [p.grad.data_ptr() for p in view_model.parameters()]
+            if grad_ptrs is not None:
+                self.assertEqual(grad_ptrs, ptrs)
+            grad_ptrs = ptrs
+
 
 class ReducerModule(nn.Module):
     def __init__(self):
@@ -2,10 +2,13 @@ from torch.testing._internal.jit_utils import JitTestCase
 import io
 import os
 import sys
+import unittest
 
 import torch
 import torch._C
-from torch.testing._internal.common_utils import TEST_WITH_ROCM, skipIfRocm
+import torch.nn.functional as F
+import torch.nn.quantized as nnq
+from torch.testing._internal.common_utils import IS_WINDOWS, TEST_WITH_ROCM, skipIfRocm
 
 # Make the helper files in test/ importable
 pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
@@ -39,6 +42,16 @@ class MyModule(torch.nn.Module):
         return x - h
 
 
+class ModuleWithSubmodule(torch.nn.Module):
+    def __init__(self):
+        super(ModuleWithSubmodule, self).__init__()
+        self.sub = MyModule()
+
+    def forward(self, x, h):
+        accum, sub_accum = self.sub(x, h)
+        return accum * 2, sub_accum
+
+
 class TestBackends(JitTestCase):
     def setUp(self):
         super().setUp()
@@ -113,3 +126,94 @@ class TestBackends(JitTestCase):
         self.compare_py_jit_backend("accum", input)
         self.compare_py_jit_backend("sub_accum", input)
         self.compare_py_jit_backend("forward", input)
+
+    @skipIfRocm
+    def test_compile_ahead(self):
+        """
+        This tests that the payloads compiled ahead of time by a backend are saved with the lowered module, which
+        loads them instead of compiling.
+        """
+        lowered_module = torch._C._jit_to_backend(
+            "test_backend_compile_ahead", self.scripted_module._c, {"forward": {"": ""}})
+        self.assertEqual(lowered_module.__getattr__("__compiled"), {"forward": "forward"})
+
+        buffer = io.BytesIO()
+        torch.jit.save(lowered_module, buffer)
+        buffer.seek(0)
+        loaded_module = torch.jit.load(buffer)
+        self.assertEqual(loaded_module.__getattr__("__compiled"), {"forward": "forward"})
+
+        input = torch.randn(5)
+        self.assertEqual(self.module(input, input), loaded_module(input, input))
+
+    @skipIfRocm
+    def test_selective(self):
+        """
+        This tests lowering only a submodule, the rest of the module keeps running on the interpreter.
+        """
+        module = ModuleWithSubmodule()
+        lowered_module = torch._C._jit_to_backend_selective(
+            "test_backend", torch.jit.script(module)._c, {"forward": {"": ""}}, ["sub"])
+        self.assertIn("LoweredModule", lowered_module.__getattr__("sub")._type().name())
+
+        input = torch.randn(5)
+        self.assertEqual(module(input, input), lowered_module.__getattr__("forward")(input, input))
+
+        buffer = io.BytesIO()
+        torch.jit.save(lowered_module, buffer)
+        buffer.seek(0)
+        self.assertEqual(module(input, input), torch.jit.load(buffer)(input, input))
+
+        with self.assertRaisesRegex(RuntimeError, "not a submodule"):
+            torch._C._jit_to_backend_selective(
+                "test_backend", torch.jit.script(module)._c, {"forward": {"": ""}}, ["sub.accum"])
+
+
+class QuantizedCNN(torch.nn.Module):
+    def __init__(self):
+        super(QuantizedCNN, self).__init__()
+        self.conv = nnq.Conv2d(3, 8, 3, padding=1)
+        self.linear = nnq.Linear(8, 4)
+
+    def forward(self, x):
+        x = F.relu(self.conv(x))
+        x = F.adaptive_avg_pool2d(x, 1)
+        return self.linear(torch.flatten(x, 1))
+
+
+@unittest.skipIf(IS_WINDOWS, "The NNAPI backend is not built on Windows")
+@unittest.skipIf('qnnpack' not in torch.backends.quantized.supported_engines and
+                 'fbgemm' not in torch.backends.quantized.supported_engines,
+                 "Quantized operations require FBGEMM or QNNPACK")
+class TestNnapiBackend(JitTestCase):
+    def example_input(self):
+        return torch.quantize_per_tensor(torch.rand(1, 3, 8, 8), 1. / 128, 0, torch.quint8)
+
+    def test_lowering(self):
+        """
+        Lowers a quantized CNN for NNAPI, which runs it where NNAPI is available.
+        """
+        module = torch.jit.script(QuantizedCNN())
+        x = self.example_input()
+        lowered = torch._C._jit_to_backend("nnapi", module._c, {"forward": [x]})
+        try:
+            output = lowered.forward(x)
+        except RuntimeError as e:
+            self.assertIn("NNAPI is not available", str(e))
+            return
+        # NNAPI only has to be as accurate as the quantization
+        expected = module(x)
+        self.assertEqual(output.dequantize(), expected.dequantize(),
+                         atol=3 * expected.q_scale(), rtol=0)
+
+    def test_unsupported_operation(self):
+        """
+        Lowering methods with operations NNAPI can't run fails.
+        """
+        class Unsupported(torch.nn.Module):
+            def forward(self, x):
+                return torch.sigmoid(x)
+
+        module = torch.jit.script(Unsupported())
+        with self.assertRaisesRegex(RuntimeError, "NNAPI does not support"):
+            torch._C._jit_to_backend("nnapi", module._c, {"forward": [self.example_input()]})
@@ -0,0 +1,94 @@
+import os
+import sys
+import tempfile
+
+import torch
+from torch.testing._internal.jit_utils import JitTestCase
+
+
+# Make the helper files in test/ importable
+pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+sys.path.append(pytorch_test_dir)
+
+if __name__ == "__main__":
+    raise RuntimeError(
+        "This test file is not meant to be run directly, use:\n\n"
+        "\tpython test/test_jit.py TESTNAME\n\n"
+        "instead."
+    )
+
+
+class TestCompilationCache(JitTestCase):
+    """
+    Tests for the on-disk cache of the graphs emitted for free functions.
+    """
+
+    def setUp(self):
+        super(TestCompilationCache, self).setUp()
+        self.cache_dir = tempfile.TemporaryDirectory()
+        self.old_cache_dir = torch._C._jit_get_compilation_cache_dir()
+        torch._C._jit_set_compilation_cache_dir(self.cache_dir.name)
+
+    def tearDown(self):
+        torch._C._jit_set_compilation_cache_dir(self.old_cache_dir)
+        self.cache_dir.cleanup()
+        super(TestCompilationCache, self).tearDown()
+
+    def _compile(self, src, env=None):
+        env = env or {}
+        cu = torch._C.CompilationUnit()
+        cu.define(src, lambda name: env.get(name))
+        return cu.find_function("foo")
+
+    def _from_cache(self, fn):
+        # cached graphs have no source ranges
+        return "<string>" not in fn.graph.str()
+
+    def test_cache_hit(self):
+        src = """
+def foo(x, y: int):
+    z = x * y
+    if y > 2:
+        z = z + 1
+    return z
+"""
+        first = self._compile(src)
+        self.assertFalse(self._from_cache(first))
+        self.assertEqual(len(os.listdir(self.cache_dir.name)), 1)
+
+        second = self._compile(src)
+        self.assertTrue(self._from_cache(second))
+        self.assertEqual(first.graph.str(False), second.graph.str(False))
+        self.assertEqual(str(first.schema), str(second.schema))
+        x = torch.randn(3)
+        for y in [1, 3]:
+            self.assertEqual(first(x, y), second(x, y))
+
+    def test_changed_source(self):
+        self._compile("def foo(x):\n    return x + 1\n")
+        fn = self._compile("def foo(x):\n    return x + 2\n")
+        self.assertFalse(self._from_cache(fn))
+        self.assertEqual(fn(torch.ones(2)), torch.full((2,), 3.))
+
+    def test_changed_global(self):
+        src = "def foo(x):\n    return x + K\n"
+        self._compile(src, {"K": 1})
+        fn = self._compile(src, {"K": 2})
+        self.assertFalse(self._from_cache(fn))
+        self.assertEqual(fn(torch.ones(2)), torch.full((2,), 3.))
+        fn = self._compile(src, {"K": 2})
+        self.assertTrue(self._from_cache(fn))
+
+    def test_calls_not_cached(self):
+        src = """
+def bar(x):
+    return x + 1
+
+def foo(x):
+    return bar(x) * 2
+"""
+        self._compile(src)
+        fn = self._compile(src)
+        # foo inlines bar, so its graph depends on the source of bar
+        self.assertFalse(self._from_cache(fn))
+        self.assertEqual(fn(torch.ones(2)), torch.full((2,), 4.))
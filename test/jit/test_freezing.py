@@ -1025,3 +1025,133 @@ class TestFreezing(JitTestCase):
         fm = torch._C._freeze_module(m._c, ["modify_a"])
         FileCheck().check('prim::GetAttr[name="a"]').run(fm.forward.graph)
         FileCheck().check('prim::GetAttr[name="b"]').run(fm.modify_a.graph)
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_freeze_module_convert_ops_to_mkldnn(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = nn.Conv2d(8, 8, 1)
+                self.pool = nn.AdaptiveAvgPool2d(1)
+                self.fc = nn.Linear(8, 4)
+
+            def forward(self, x):
+                x = torch.relu(self.conv1(x))
+                x = torch.max_pool2d(self.conv2(x), 2)
+                x = self.pool(x)
+                return self.fc(torch.flatten(x, 1))
+
+        m = torch.jit.script(Net())
+        m.eval()
+        fm = torch._C._freeze_module(m._c)
+        torch._C._jit_pass_convert_frozen_ops_to_mkldnn(fm.forward.graph)
+        # flatten isn't supported, the other ops form two MKLDNN regions
+        FileCheck().check_count("aten::to_mkldnn", 2, exactly=True).run(fm.forward.graph)
+        FileCheck().check_count("aten::to_dense", 2, exactly=True).run(fm.forward.graph)
+        FileCheck().check("aten::to_mkldnn").check("aten::conv2d").check("aten::relu") \
+            .check("aten::conv2d").check("aten::max_pool2d").check("aten::adaptive_avg_pool2d") \
+            .check("aten::to_dense").check("aten::flatten").check("aten::to_mkldnn") \
+            .check("aten::linear").check("aten::to_dense").run(fm.forward.graph)
+        input = torch.randn(2, 3, 8, 8)
+        self.assertEqual(fm.forward(input), m.forward(input))
+
+    @unittest.skipIf(not torch._C.has_mkl, "MKL build is disabled")
+    def test_freeze_module_prepack_linear_weights(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.weight = nn.Parameter(torch.randn(8, 4))
+                self.bias = nn.Parameter(torch.randn(4))
+
+            def forward(self, x):
+                return torch._C._nn.linear(x, self.weight.t(), self.bias)
+
+        m = torch.jit.script(Net())
+        m.eval()
+        fm = torch._C._freeze_module(m._c)
+        input = torch.randn(3, 5, 8)
+        graph = fm.forward.graph
+        list(graph.inputs())[1].inferTypeFrom(input)
+        torch._C._jit_pass_prepack_frozen_weights(graph)
+        FileCheck().check_not("aten::t(").check("aten::_mkl_linear") \
+            .check_not("aten::linear").run(graph)
+        self.assertEqual(fm.forward(input), m.forward(input))
+        # the weight is packed for 15 rows, other inputs go through linear
+        input = torch.randn(2, 8)
+        self.assertEqual(fm.forward(input), m.forward(input))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_freeze_module_prepack_conv2d_weights(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.conv = nn.Conv2d(3, 8, 3, padding=1, groups=1)
+
+            def forward(self, x):
+                return self.conv(x)
+
+        m = torch.jit.script(Net())
+        m.eval()
+        fm = torch._C._freeze_module(m._c)
+        input = torch.randn(2, 3, 8, 8)
+        graph = fm.forward.graph
+        list(graph.inputs())[1].inferTypeFrom(input)
+        torch._C._jit_pass_prepack_frozen_weights(graph)
+        FileCheck().check("aten::mkldnn_convolution").check_not("aten::conv2d").run(graph)
+        self.assertEqual(fm.forward(input), m.forward(input))
+        self.assertEqual(fm.forward(input.transpose(2, 3)), m.forward(input.transpose(2, 3)))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_freeze_module_fuse_conv2d_epilogues(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = nn.Conv2d(8, 3, 3, padding=1)
+
+            def forward(self, x):
+                y = nn.functional.hardtanh(self.conv1(x), 0., 6.)
+                # the input of conv2 is the output of a fused convolution
+                return torch.relu(self.conv2(y) + x)
+
+        m = torch.jit.script(Net())
+        m.eval()
+        fm = torch._C._freeze_module(m._c)
+        input = torch.randn(2, 3, 8, 8)
+        graph = fm.forward.graph
+        list(graph.inputs())[1].inferTypeFrom(input)
+        torch._C._jit_pass_fuse_frozen_epilogues(graph)
+        FileCheck().check_count("aten::_mkldnn_convolution_fused", 2, exactly=True) \
+            .check_not("aten::conv2d").check_not("aten::add").check_not("aten::relu") \
+            .check_not("aten::hardtanh").run(graph)
+        self.assertEqual(fm.forward(input), m.forward(input))
+        torch._C._jit_pass_prepack_frozen_weights(graph)
+        self.assertEqual(fm.forward(input), m.forward(input))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_freeze_module_fuse_linear_epilogues(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.weight = nn.Parameter(torch.randn(16, 8))
+                self.bias = nn.Parameter(torch.randn(16))
+
+            def forward(self, x, other):
+                y = torch._C._nn.linear(x, self.weight, self.bias)
+                z = torch._C._nn.linear(x, self.weight, None)
+                return nn.functional.gelu(y), z + other
+
+        m = torch.jit.script(Net())
+        m.eval()
+        fm = torch._C._freeze_module(m._c)
+        input = torch.randn(4, 8)
+        other = torch.randn(4, 16)
+        graph = fm.forward.graph
+        list(graph.inputs())[1].inferTypeFrom(input)
+        torch._C._jit_pass_fuse_frozen_epilogues(graph)
+        FileCheck().check_count("aten::_mkldnn_linear_fused", 2, exactly=True) \
+            .check_not("aten::gelu").run(graph)
+        self.assertEqual(fm.forward(input, other), m.forward(input, other))
+        # other of another size is broadcast by the unfused add
+        self.assertEqual(fm.forward(input, other[0]), m.forward(input, other[0]))
@@ -1,8 +1,15 @@
 # -*- coding: utf-8 -*-
 # torch
 import torch
+import torch.nn.functional as F
+from torch.quantization import default_qconfig
+from torch.quantization.quantize_jit import quantize_jit
 from torch.testing import FileCheck
-from torch.testing._internal.common_quantization import QuantizationTestCase
+from torch.testing._internal.common_quantization import (
+    QuantizationTestCase,
+    skipIfNoFBGEMM,
+    test_only_eval_fn,
+)
 
 class TestFusionPasses(QuantizationTestCase):
     def test_quantized_add_relu_fusion(self):
@@ -117,3 +124,36 @@ class TestFusionPasses(QuantizationTestCase):
                    .run(scripted_m.graph)
         output = scripted_m(qA, 3., qC)
         self.assertEqual(ref_output, output)
+
+    @skipIfNoFBGEMM
+    def test_quantized_conv_add_relu_fusion(self):
+        class ConvAdd(torch.nn.Module):
+            def __init__(self, relu):
+                super(ConvAdd, self).__init__()
+                self.conv1 = torch.nn.Conv2d(2, 2, 3, padding=1).float()
+                self.conv2 = torch.nn.Conv2d(2, 2, 3, padding=1).float()
+                self.relu = relu
+
+            def forward(self, x):
+                y = self.conv1(x)
+                z = y + self.conv2(y)
+                if self.relu:
+                    z = F.relu(z)
+                return z
+
+        data = [[torch.rand((2, 2, 5, 5), dtype=torch.float)]]
+        for relu in [True, False]:
+            m = torch.jit.script(ConvAdd(relu)).eval()
+            m = quantize_jit(m, {'': default_qconfig}, test_only_eval_fn, [data])
+            ref_output = m(data[0][0])
+            torch._C._jit_pass_fuse_quantized_conv_add(m.graph)
+            fused = "quantized::conv2d_add_relu(" if relu else "quantized::conv2d_add("
+            # The output of conv1 is also the other operand of the addition,
+            # so only conv2 is fused.
+            FileCheck().check_count("quantized::conv2d(", 1, exactly=True) \
+                       .check_count(fused, 1, exactly=True) \
+                       .run(m.graph)
+            FileCheck().check_not("quantized::add") \
+                       .run(m.graph)
+            output = m(data[0][0])
+            self.assertEqual(ref_output, output)
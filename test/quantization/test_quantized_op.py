@@ -2237,6 +2237,35 @@ class TestDynamicQuantizedLinear(TestCase):
         self.assertEqual(Y_fp32, Y_fp32_ref,
                          msg="torch.ops.quantized.linear_dynamic results are off")
 
+    @skipIfNoFBGEMM
+    def test_qlinear_input_range_cache(self):
+        with override_quantized_engine('fbgemm'):
+            W_q = torch.quantize_per_tensor(torch.randn(8, 16), 0.1, 0, torch.qint8)
+            W_prepack = torch.ops.quantized.linear_prepack(W_q, None)
+            # All the inputs have the range [-1, 1], so the cached range is
+            # exactly the measured one.
+            X = [torch.rand(4, 16) * 2 - 1 for _ in range(6)]
+            for x in X:
+                x[0, 0] = -1
+                x[0, 1] = 1
+            expected = [torch.ops.quantized.linear_dynamic(x, W_prepack) for x in X]
+
+            W_prepack.set_input_range_cache(0.5, 0.0, 3)
+            for x, y in zip(X, expected):
+                self.assertEqual(torch.ops.quantized.linear_dynamic(x, W_prepack), y)
+
+            # The range of the second input isn't measured, so its values
+            # saturate to the cached range.
+            torch.ops.quantized.linear_dynamic(X[0], W_prepack)
+            cached = torch.ops.quantized.linear_dynamic(X[1] * 10, W_prepack)
+            W_prepack.set_input_range_cache(0.5, 0.0, 1)
+            self.assertNotEqual(cached, torch.ops.quantized.linear_dynamic(X[1] * 10, W_prepack))
+
+            with self.assertRaisesRegex(RuntimeError, "averaging_constant"):
+                W_prepack.set_input_range_cache(0.0, 0.0, 3)
+            with self.assertRaisesRegex(RuntimeError, "refresh_interval"):
+                W_prepack.set_input_range_cache(0.5, 0.0, 0)
+
 class TestDynamicQuantizedRNNOp(TestCase):
     """Tests the correctness of the dynamic quantized lstm/gru."""
 
@@ -2712,14 +2741,17 @@ class TestQuantizedEmbeddingBag(TestCase):
             embedding_dim, num_offsets, enable_per_sample_weights,
             include_last_offset, atol, rtol):
         # PyTorch ops require weights to be fused and N bit rowwise quantized.
-        # TODO(radkris) Remove the usage of C2 conversion ops once
-        # embedding_bag_prepack op have been landed.
-        from caffe2.python import core, workspace
-        conversion_op = "FloatToFused8BitRowwiseQuantized"
+        prepack_op = torch.ops.quantized.embedding_bag_byte_prepack
+        unpack_op = torch.ops.quantized.embedding_bag_byte_unpack
         pt_op = torch.ops.quantized.embedding_bag_byte_rowwise_offsets
         if bit_rate == 4:
-            conversion_op = "FloatToFused4BitRowwiseQuantized"
+            prepack_op = torch.ops.quantized.embedding_bag_4bit_prepack
+            unpack_op = torch.ops.quantized.embedding_bag_4bit_unpack
             pt_op = torch.ops.quantized.embedding_bag_4bit_rowwise_offsets
+        elif bit_rate == 2:
+            prepack_op = torch.ops.quantized.embedding_bag_2bit_prepack
+            unpack_op = torch.ops.quantized.embedding_bag_2bit_unpack
+            pt_op = torch.ops.quantized.embedding_bag_2bit_rowwise_offsets
 
         weights = torch.from_numpy((np.random.random_sample((
             num_embeddings, embedding_dim)) + 1).astype(np.float32))
@@ -2746,21 +2778,7 @@ class TestQuantizedEmbeddingBag(TestCase):
         indices = torch.from_numpy(np.random.randint(
             low=0, high=num_embeddings, size=num_indices, dtype=np.int64))
 
-        # TODO(radkris) Remove the usage of C2 conversion ops once
-        # embedding_bag_prepack op have been landed.
-        def get_quantized_weights(weights):
-            workspace.ResetWorkspace()
-
-            workspace.FeedBlob("weights", weights)
-            workspace.RunOperatorOnce(
-                core.CreateOperator(
-                    conversion_op, ["weights"], ["quantized_weights"]
-                )
-            )
-            emb_q = workspace.FetchBlob("quantized_weights")
-            return torch.from_numpy(emb_q)
-
-        q_weights = get_quantized_weights(weights)
+        q_weights = prepack_op(weights)
         per_sample_weights = torch.from_numpy(np.random.uniform(
             low=0.01, high=0.5, size=[len(indices)]).astype(np.float32)) if \
             enable_per_sample_weights else None
@@ -2769,7 +2787,8 @@ class TestQuantizedEmbeddingBag(TestCase):
                 (offsets, torch.tensor([indices.size(0)], dtype=torch.long)), 0
             )
 
-        # Reference result will be the floating point torch.nn.EmbeddingBag.
+        # Reference result will be the floating point torch.nn.EmbeddingBag
+        # over the dequantized weights, so that only the lookup is tested.
         def get_reference_result(
                 num_embeddings, embedding_dim,
                 include_last_offset, weights, per_sample_weights,
@@ -2784,8 +2803,8 @@ class TestQuantizedEmbeddingBag(TestCase):
                                  per_sample_weights=per_sample_weights)
 
         reference_result = get_reference_result(
-            num_embeddings, embedding_dim, include_last_offset, weights,
-            per_sample_weights, indices, offsets)
+            num_embeddings, embedding_dim, include_last_offset,
+            unpack_op(q_weights), per_sample_weights, indices, offsets)
         result = pt_op(
             q_weights,
             indices,
@@ -2826,6 +2845,49 @@ class TestQuantizedEmbeddingBag(TestCase):
                                                include_last_offset, atol=0.1,
                                                rtol=1e-2)
 
+    @given(num_embeddings=st.integers(10, 100),
+           embedding_dim=st.integers(5, 50).filter(lambda x: x % 4 == 0),
+           num_offsets=st.integers(1, 20),
+           enable_per_sample_weights=st.booleans(),
+           include_last_offset=st.booleans())
+    def test_embedding_bag_2bit_rowwise_offsets(self, num_embeddings,
+                                                embedding_dim, num_offsets,
+                                                enable_per_sample_weights,
+                                                include_last_offset):
+        self.embedding_bag_rowwise_offsets_run(2, num_embeddings,
+                                               embedding_dim, num_offsets,
+                                               enable_per_sample_weights,
+                                               include_last_offset, atol=1e-3,
+                                               rtol=1e-3)
+
+    @given(num_embeddings=st.integers(10, 100),
+           embedding_dim=st.integers(5, 50).filter(lambda x: x % 4 == 0),
+           bit_rate=st.sampled_from([8, 4, 2]))
+    def test_embedding_bag_prepack_unpack(self, num_embeddings,
+                                          embedding_dim, bit_rate):
+        suffix = {8: 'byte', 4: '4bit', 2: '2bit'}[bit_rate]
+        prepack_op = getattr(torch.ops.quantized,
+                             'embedding_bag_{}_prepack'.format(suffix))
+        unpack_op = getattr(torch.ops.quantized,
+                            'embedding_bag_{}_unpack'.format(suffix))
+        weights = torch.from_numpy((np.random.random_sample((
+            num_embeddings, embedding_dim)) + 1).astype(np.float32))
+
+        q_weights = prepack_op(weights)
+        # 8-bit rows carry a float scale and bias, N-bit rows fp16 ones.
+        scale_bias_bytes = 8 if bit_rate == 8 else 4
+        self.assertEqual(q_weights.dtype, torch.uint8)
+        self.assertEqual(
+            q_weights.size(1),
+            embedding_dim * bit_rate // 8 + scale_bias_bytes)
+
+        # Every element is within half a quantization step of the original;
+        # the fp16 rounding of the N-bit scale and bias adds a little slack.
+        row_range = weights.max(1)[0] - weights.min(1)[0]
+        half_step = row_range / ((1 << bit_rate) - 1) / 2
+        error = (unpack_op(q_weights) - weights).abs()
+        self.assertTrue((error <= half_step.unsqueeze(1) + 2e-3).all())
+
 
 class TestQuantizedConv(unittest.TestCase):
     def _test_qconv_unpack_impl(
@@ -3103,6 +3165,32 @@ class TestQuantizedConv(unittest.TestCase):
             qconv_prepack, qconv_unpack, inputs, (stride_h, stride_w),
             (pad_h, pad_w), channelwise)
 
+    @override_qengines
+    def test_qconv2d_add(self):
+        qX = torch.quantize_per_tensor(
+            torch.rand(2, 4, 8, 8), 0.05, 0, torch.quint8)
+        qW = torch.quantize_per_tensor(
+            torch.randn(6, 4, 3, 3), 0.05, 0, torch.qint8)
+        packed = torch.ops.quantized.conv2d_prepack(
+            qW, torch.randn(6), [1, 1], [1, 1], [1, 1], 1)
+        qAccum = torch.quantize_per_tensor(
+            torch.randn(2, 6, 8, 8), 0.1, 64, torch.quint8)
+        conv_out = torch.ops.quantized.conv2d(qX, packed, 0.2, 64)
+        for fused_op, add_op in [
+                (torch.ops.quantized.conv2d_add, torch.ops.quantized.add),
+                (torch.ops.quantized.conv2d_add_relu, torch.ops.quantized.add_relu)]:
+            ref = add_op(conv_out, qAccum, 0.3, 32)
+            out = fused_op(qX, qAccum, packed, 0.2, 64, 0.3, 32)
+            self.assertEqual(out.q_scale(), ref.q_scale())
+            self.assertEqual(out.q_zero_point(), ref.q_zero_point())
+            # QNNPACK adds with its own kernel, which may round differently.
+            self.assertEqual(out.int_repr().to(torch.double),
+                             ref.int_repr().to(torch.double), atol=1.0, rtol=0)
+
+        with self.assertRaisesRegex(RuntimeError, "shape"):
+            torch.ops.quantized.conv2d_add(
+                qX, qAccum[:1], packed, 0.2, 64, 0.3, 32)
+
     @given(
         inputs=hu.tensor_conv(
             spatial_dim=1, batch_size_range=(1, 3),
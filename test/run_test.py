@@ -76,6 +76,7 @@ TESTS = [
     'test_profiler',
     'distributed/nn/jit/test_instantiator',
     'distributed/nn/api/test_remote_module_spawn',
+    'distributed/pipeline/test_pipeline_spawn',
     'distributed/rpc/faulty_agent/test_dist_autograd_spawn',
     'distributed/rpc/faulty_agent/test_rpc_spawn',
     'distributed/rpc/jit/test_dist_autograd_spawn',
@@ -97,6 +98,7 @@ TESTS = [
 WINDOWS_BLACKLIST = [
     'distributed/nn/jit/test_instantiator',
     'distributed/nn/api/test_remote_module_spawn',
+    'distributed/pipeline/test_pipeline_spawn',
     'distributed/rpc/faulty_agent/test_dist_autograd_spawn',
     'distributed/rpc/faulty_agent/test_rpc_spawn',
     'distributed/rpc/jit/test_dist_autograd_spawn',
@@ -115,6 +117,7 @@ WINDOWS_BLACKLIST = [
 ROCM_BLACKLIST = [
     'distributed/nn/jit/test_instantiator',
     'distributed/nn/api/test_remote_module_spawn',
+    'distributed/pipeline/test_pipeline_spawn',
     'distributed/rpc/faulty_agent/test_dist_autograd_spawn',
     'distributed/rpc/faulty_agent/test_rpc_spawn',
     'distributed/rpc/jit/test_dist_autograd_spawn',
@@ -163,6 +166,7 @@ SLOW_TESTS = [
     'test_torch',
     'distributed/nn/jit/test_instantiator',
     'distributed/nn/api/test_remote_module_spawn',
+    'distributed/pipeline/test_pipeline_spawn',
     'distributed/test_distributed',
     'distributed/rpc/tensorpipe/test_dist_autograd_spawn',
     'distributed/rpc/tensorpipe/test_dist_optimizer_spawn',
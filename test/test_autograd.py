@@ -909,6 +909,61 @@ class TestAutograd(TestCase):
             w = adder(x, y)
             self.assertFalse(torch.is_grad_enabled())
 
+    def test_inference_mode(self):
+        x = torch.ones(5, 5, requires_grad=True)
+        with torch.inference_mode():
+            self.assertTrue(torch.is_inference_mode_enabled())
+            self.assertFalse(torch.is_grad_enabled())
+            y = x * 2
+            c = torch.ones(5, 5)
+            # In-place updates are fine in the mode, and aren't tracked.
+            c.add_(1)
+        self.assertFalse(torch.is_inference_mode_enabled())
+        self.assertTrue(torch.is_grad_enabled())
+
+        for t in (y, c):
+            self.assertTrue(t.is_inference())
+            self.assertFalse(t.requires_grad)
+            self.assertIsNone(t.grad_fn)
+        self.assertFalse(x.is_inference())
+        self.assertEqual(c, torch.full((5, 5), 2.))
+
+        @torch.inference_mode()
+        def doubler(x):
+            return x * 2
+
+        z = doubler(x)
+        self.assertTrue(z.is_inference())
+        self.assertTrue(torch.is_grad_enabled())
+
+        # Nested modes restore the outer state.
+        with torch.inference_mode():
+            with torch.enable_grad():
+                self.assertTrue(torch.is_grad_enabled())
+                self.assertTrue(doubler(x).is_inference())
+                self.assertTrue(torch.is_inference_mode_enabled())
+            self.assertFalse(torch.is_grad_enabled())
+
+    def test_inference_mode_errors(self):
+        x = torch.ones(5, 5, requires_grad=True)
+        with torch.inference_mode():
+            y = torch.ones(5, 5)
+
+        with self.assertRaisesRegex(RuntimeError, "Inference tensors cannot require grad"):
+            y.requires_grad_()
+        with self.assertRaisesRegex(RuntimeError, "Inference tensors cannot be saved for backward"):
+            x * y
+        with self.assertRaisesRegex(RuntimeError, "Inplace update to inference tensor outside InferenceMode"):
+            y.add_(1)
+        self.assertEqual(y, torch.ones(5, 5))
+
+        # Functional ops outside the mode and clones are fine.
+        self.assertFalse((y + 1).is_inference())
+        w = y.clone()
+        self.assertFalse(w.is_inference())
+        (x * w).sum().backward()
+        self.assertEqual(x.grad, w)
+
     def test_set_grad_generator_functions(self):
         @torch.no_grad()
         def gen_no_grad():
@@ -3004,6 +3059,83 @@ class TestAutograd(TestCase):
             ]
         )
 
+    def test_preallocate_grad(self):
+        param = torch.randn(2, 3, 4, 4).to(memory_format=torch.channels_last).requires_grad_()
+        torch.autograd.preallocate_grad(param)
+        grad = param.grad
+        self.assertEqual(grad, torch.zeros_like(param))
+        self.assertEqual(grad.stride(), param.stride())
+
+        (param * 2).sum().backward()
+        self.assertEqual(param.grad.data_ptr(), grad.data_ptr())
+        self.assertEqual(param.grad, torch.full_like(param, 2))
+
+        # the next gradient is copied into the buffer
+        param.grad = None
+        (param * 3).sum().backward()
+        self.assertEqual(param.grad.data_ptr(), grad.data_ptr())
+        self.assertEqual(param.grad, torch.full_like(param, 3))
+        (param * 2).sum().backward()
+        self.assertEqual(param.grad.data_ptr(), grad.data_ptr())
+        self.assertEqual(param.grad, torch.full_like(param, 5))
+
+        optimizer = torch.optim.SGD([param], lr=0.1)
+        optimizer.zero_grad(set_to_none=True)
+        self.assertIsNone(param.grad)
+        (param * 4).sum().backward()
+        self.assertEqual(param.grad.data_ptr(), grad.data_ptr())
+        self.assertEqual(param.grad, torch.full_like(param, 4))
+
+        with self.assertRaisesRegex(RuntimeError, "not a leaf requiring grad"):
+            torch.autograd.preallocate_grad(param * 2)
+
+    def test_memory_profiler_stats(self):
+        x = torch.rand(100, 100, requires_grad=True)
+        nbytes = x.numel() * x.element_size()
+        with profile(profile_memory=True) as prof:
+            with record_function("test_temporary"):
+                t = x * 2
+                del t
+            with record_function("test_activation"):
+                y = x.sigmoid()
+        print(prof.key_averages().table(sort_by="cpu_memory_stats.saved"))
+        stats = {evt.key: evt.cpu_memory_stats for evt in prof.key_averages()}
+
+        temporary = stats["test_temporary"]
+        self.assertGreaterEqual(temporary.allocated, nbytes)
+        self.assertGreaterEqual(temporary.freed, nbytes)
+        self.assertGreaterEqual(temporary.peak, nbytes)
+        self.assertEqual(temporary.retained, 0)
+        self.assertEqual(temporary.saved, 0)
+
+        # sigmoid saves its result for backward
+        activation = stats["test_activation"]
+        self.assertGreaterEqual(activation.retained, nbytes)
+        self.assertGreaterEqual(activation.saved, nbytes)
+        self.assertGreaterEqual(stats["sigmoid"].saved, nbytes)
+        y.sum().backward()
+
+    def test_profiler_perf_counters(self):
+        x = torch.rand(100, 100)
+        try:
+            with profile(profile_perf_counters=True) as prof:
+                torch.mm(x, x)
+        except RuntimeError as e:
+            if "hardware performance counters" not in str(e):
+                raise
+            self.skipTest("perf events are not available")
+        print(prof.key_averages().table(sort_by="perf_counters.cycles"))
+        mm = [evt for evt in prof.function_events if evt.name == "mm"][0]
+        self.assertGreater(mm.perf_counters.cycles, 0)
+        self.assertGreater(mm.perf_counters.instructions, 0)
+        self.assertGreater(mm.perf_counters.ipc, 0)
+
+        with tempfile.NamedTemporaryFile(mode="w+") as f:
+            prof.export_chrome_trace(f.name)
+            trace = json.load(f)
+        mm_trace = [evt for evt in trace if evt["name"] == "mm"][0]
+        self.assertEqual(mm_trace["args"]["cycles"], mm.perf_counters.cycles)
+
     def test_record_function(self):
         x = torch.randn(10, 10)
 
@@ -3314,6 +3446,35 @@ class TestAutograd(TestCase):
                     out.backward()
             self.assertIn('MyFunc.apply', str(w[0].message))
 
+    def test_anomaly_detect_lightweight(self):
+        size = 10
+
+        class MyFunc(Function):
+            @staticmethod
+            def forward(ctx, inp1, inp2):
+                return inp1.sum(0, keepdim=True)
+
+            @staticmethod
+            def backward(ctx, gO):
+                gI = gO.clone().expand(size)
+                gI[0] = 1
+                gI[0] /= 0  # Generate an inf
+                return None, gI
+
+        inp = torch.rand(size, requires_grad=True)
+        with detect_anomaly(lightweight=True):
+            self.assertFalse(torch.is_anomaly_enabled())
+            (inp * 2).sum().backward()
+        self.assertEqual(inp.grad, torch.full_like(inp, 2))
+
+        with self.assertRaisesRegex(
+                RuntimeError, r"Function 'MyFuncBackward' \(sequence number \d+\) returned nan or inf values in its "
+                r"1th output. Functions that ran before it: .*'SumBackward0'"):
+            with detect_anomaly(lightweight=True):
+                out = MyFunc.apply(inp, inp)
+                out.sum().backward()
+        self.assertFalse(torch._C._is_anomaly_lightweight_enabled())
+
     def test_anomaly_grad_warnings(self):
         # PyTorch won't throw warnings if there is an error
         # but we'd want to at least see them in stderr
@@ -45,6 +45,8 @@ TEST_MAGMA = TEST_CUDA
 TEST_LARGE_TENSOR = TEST_CUDA
 TEST_MEDIUM_TENSOR = TEST_CUDA
 TEST_CUDNN = TEST_CUDA
+TEST_CUDA_GRAPH = TEST_CUDA and not TEST_WITH_ROCM and \
+    int(torch.version.cuda.split(".")[0]) >= 11
 if TEST_CUDA:
     torch.ones(1).cuda()  # has_magma shows up after cuda is initialized
     TEST_CUDNN = TEST_CUDA and (TEST_WITH_ROCM or
@@ -303,6 +305,47 @@ class TestCuda(TestCase):
                 torch.cuda.caching_allocator_delete(mem)
                 self.assertEqual(torch.cuda.memory_allocated(), prev)
 
+    def test_memory_history(self):
+        torch.cuda.record_memory_history(record_stacks=True, max_entries=4)
+        try:
+            x = torch.empty(3 * 1024 * 1024, dtype=torch.uint8, device='cuda')
+            address = x.data_ptr()
+            block_stack_ids = [b['stack_id'] for s in torch.cuda.memory_snapshot()
+                               for b in s['blocks'] if b['state'] == 'active_allocated']
+            del x
+            history = torch.cuda.memory_history()
+            # only the last max_entries events are kept
+            self.assertLessEqual(len(history['entries']), 4)
+            alloc, free = history['entries'][-2:]
+            self.assertEqual(alloc['action'], 'alloc')
+            self.assertEqual(free['action'], 'free')
+            self.assertEqual(alloc['address'], address)
+            self.assertEqual(free['address'], address)
+            self.assertGreaterEqual(alloc['size'], 3 * 1024 * 1024)
+            self.assertLessEqual(alloc['time_us'], free['time_us'])
+            self.assertIn(alloc['stack_id'], block_stack_ids)
+            self.assertGreater(len(history['stacks'][alloc['stack_id']]), 0)
+        finally:
+            torch.cuda.record_memory_history(enabled=False)
+        self.assertEqual(torch.cuda.memory_history()['entries'], [])
+
+    def test_expandable_segments(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_CUDA_ALLOC_CONF="expandable_segments:True")
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+tensors = [torch.empty(n * 1024 * 1024, dtype=torch.uint8, device='cuda') for n in (3, 7, 30, 4)]
+segments = [s for s in torch.cuda.memory_snapshot() if s['segment_type'] == 'large']
+assert len(segments) == 1 and segments[0]['is_expandable'], segments
+del tensors[1]
+tensors.append(torch.empty(5 * 1024 * 1024, dtype=torch.uint8, device='cuda'))
+reserved = torch.cuda.memory_reserved()
+del tensors
+torch.cuda.empty_cache()
+assert torch.cuda.memory_reserved() < reserved
+assert torch.cuda.memory_stats()['segment.all.current'] == 0
+"""], env=env)
+
     def test_cuda_get_device_name(self):
         # Testing the behaviour with None as an argument
         current_device = torch.cuda.current_device()
@@ -1420,6 +1463,40 @@ class TestCuda(TestCase):
                             self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 10)  # default is cuda:0
                         self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 11)  # default is cuda:1
 
+    @skipIfRocm
+    def test_cufft_plan_cache_padded_size(self):
+        plan_cache = torch.backends.cuda.cufft_plan_cache
+        plan_cache.clear()
+        # Without cached plans, pad to a size with prime factors of at most 7.
+        self.assertEqual(plan_cache.padded_size(97), 98)
+        self.assertEqual(plan_cache.padded_size(128), 128)
+
+        x = torch.randn(4, 100, device='cuda')
+        x.rfft(1)
+        self.assertEqual(plan_cache.padded_size(97), 100)
+        self.assertEqual(plan_cache.padded_size(97, max_padding=0), 98)
+        self.assertEqual(plan_cache.padded_size(101), 105)
+
+        with self.assertRaisesRegex(RuntimeError, r"positive size"):
+            plan_cache.padded_size(0)
+        with self.assertRaisesRegex(RuntimeError, r"non-negative max_padding"):
+            plan_cache.padded_size(10, max_padding=-1)
+        plan_cache.clear()
+
+    @skipIfRocm
+    def test_fft_multi_stream(self):
+        x = torch.randn(8, 64, 2, device='cuda')
+        expected = x.fft(1)
+        streams = [torch.cuda.Stream() for _ in range(4)]
+        results = []
+        for s in streams:
+            s.wait_stream(torch.cuda.current_stream())
+            with torch.cuda.stream(s):
+                results.append(x.fft(1))
+        for s, result in zip(streams, results):
+            torch.cuda.current_stream().wait_stream(s)
+            self.assertEqual(result, expected)
+
     def test_multinomial_ext(self):
         # Test two corner cases from older PyTorch (Issue #4858)
         freqs = torch.cuda.FloatTensor([
@@ -2567,6 +2644,45 @@ t2.start()
                         type_no_autocast = torch.norm(a_ignore).dtype
                     self.assertTrue(torch.norm(a_ignore).dtype is type_no_autocast)
 
+    def test_autocast_persistent_cache(self):
+        weight = torch.randn((8, 8), device="cuda:0", requires_grad=True)
+        x = torch.randn((8, 8), device="cuda:0")
+        cast_bytes = weight.numel() * 2
+
+        def cache_bytes():
+            return torch.cuda.memory_stats()["autocast_cache_bytes.current"]
+
+        base = cache_bytes()
+        with torch.cuda.amp.autocast():
+            torch.mm(x, weight)
+            self.assertEqual(cache_bytes(), base + cast_bytes)
+        self.assertEqual(cache_bytes(), base)
+
+        with torch.no_grad():
+            with torch.cuda.amp.autocast(persistent_cache=True):
+                out1 = torch.mm(x, weight)
+            self.assertEqual(cache_bytes(), base + cast_bytes)
+            with torch.cuda.amp.autocast(persistent_cache=True):
+                out2 = torch.mm(x, weight)
+            self.assertEqual(out1, out2)
+            self.assertEqual(cache_bytes(), base + cast_bytes)
+
+            # In-place updates of the weight invalidate its cast.
+            weight.add_(1)
+            with torch.cuda.amp.autocast(persistent_cache=True):
+                out3 = torch.mm(x, weight)
+            self.assertEqual(out3, torch.mm(x.half(), weight.half()))
+            self.assertEqual(cache_bytes(), base + cast_bytes)
+
+        # Casts made under no_grad aren't reused when grad mode is enabled.
+        with torch.cuda.amp.autocast(persistent_cache=True):
+            out4 = torch.mm(x, weight)
+        self.assertTrue(out4.requires_grad)
+        self.assertEqual(cache_bytes(), base + cast_bytes)
+
+        torch.clear_autocast_cache()
+        self.assertEqual(cache_bytes(), base)
+
     def test_autocast_custom_enabled(self):
         class MyMM(torch.autograd.Function):
             @staticmethod
@@ -2668,6 +2784,39 @@ t2.start()
     def test_to_numpy(self):
         self.assertRaises(TypeError, lambda: torch.empty(1, device="cuda").numpy())
 
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_capture_simple(self):
+        s = torch.cuda.Stream()
+        with torch.cuda.stream(s):
+            a = torch.full((1000,), 1, device="cuda")
+            g = torch.cuda.CUDAGraph()
+            g.capture_begin()
+            b = a
+            for _ in range(10):
+                b = b + 1
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        g.replay()
+        self.assertEqual(b.sum().item(), 11000.)
+
+        a.fill_(2)
+        g.replay()
+        self.assertEqual(b.sum().item(), 12000.)
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_make_graphed_callable(self):
+        model = torch.nn.Sequential(torch.nn.Linear(8, 16), torch.nn.ReLU(),
+                                    torch.nn.Linear(16, 4)).cuda()
+        for fn in (model, torch.jit.script(model)):
+            graphed = torch.cuda.make_graphed_callable(fn)
+            for shape in ((3, 8), (5, 8), (3, 8)):
+                x = torch.randn(shape, device="cuda")
+                with torch.no_grad():
+                    expected = model(x)
+                self.assertEqual(graphed(x), expected)
+            self.assertEqual(len(graphed.graphs), 2)
+
 
 class TestCudaComm(TestCase):
     def _test_broadcast(self, input):
@@ -2770,6 +2919,16 @@ class TestCudaComm(TestCase):
         ]
         self._test_broadcast_coalesced(tensors, num_bytes * 5 // 2)
 
+    @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
+    def test_broadcast_coalesced_shared_storage(self):
+        # Contiguous tensors back to back in one storage are broadcast without
+        # being flattened first; the small buffer size makes several buckets
+        flat = torch.randn(40).cuda()
+        tensors = [flat[0:10], flat[10:15], flat[15:40].view(5, 5)]
+        self._test_broadcast_coalesced(tensors, 80)
+        # ...and ones that are not, with gaps or out of order, still are
+        self._test_broadcast_coalesced([flat[0:10], flat[12:15], flat[30:40], flat[15:30]], 80)
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_broadcast_coalesced_empty_tensors(self):
         tensors = [
@@ -9,7 +9,7 @@ from jit.test_tracer import TestTracer, TestMixTracingScripting  # noqa: F401
 from jit.test_recursive_script import TestRecursiveScript  # noqa: F401
 from jit.test_type_sharing import TestTypeSharing  # noqa: F401
 from jit.test_logging import TestLogging  # noqa: F401
-from jit.test_backends import TestBackends  # noqa: F401
+from jit.test_backends import TestBackends, TestNnapiBackend  # noqa: F401
 from jit.test_list_dict import TestList, TestDict  # noqa: F401
 from jit.test_async import TestAsync  # noqa: F401
 from jit.test_data_parallel import TestDataParallel  # noqa: F401
@@ -29,6 +29,7 @@ from jit.test_op_normalization import TestOpNormalization  # noqa: F401
 from jit.test_module_interface import TestModuleInterface  # noqa: F401
 from jit.test_onnx_export import TestONNXExport  # noqa: F401
 from jit.test_with import TestWith  # noqa: F401
+from jit.test_compilation_cache import TestCompilationCache  # noqa: F401
 
 # Torch
 from torch import Tensor
@@ -10449,6 +10450,27 @@ a")
             self.assertEqual(torch.autograd.grad(sout.sum(), inputs),
                              torch.autograd.grad(out.sum(), inputs))
 
+    def test_linear_batching(self):
+        def heads(x, w1, b1, w2, b2, w3, b3):
+            return (torch.addmm(b1, x, w1.t()),
+                    torch.addmm(b2, x, w2.t()),
+                    torch.addmm(b3, x, w3.t()))
+
+        with enable_profiling_mode_for_profiling_tests():
+            inputs = [torch.randn(4, 8)]
+            # the heads have different numbers of output features
+            for out_features in (3, 5, 7):
+                inputs += [torch.randn(out_features, 8), torch.randn(out_features)]
+            sheads = torch.jit.script(heads)
+            for _ in range(3):
+                sheads(*inputs)
+
+            # the legacy executor decomposes addmm into mm and add
+            if GRAPH_EXECUTOR == ProfilingMode.PROFILING:
+                FileCheck().check("prim::BatchLinear").check_not("aten::addmm") \
+                    .run(sheads.graph_for(*inputs))
+            self.assertEqual(sheads(*inputs), heads(*inputs))
+
     def test_loop_unrolling(self):
         def fn(x):
             y = 0
@@ -79,6 +79,21 @@ def send_and_delete_tensors(queue, event, device, dtype, count, size=5):
     event.wait()
 
 
+def send_reused_tensors(queue, ack_queue, event, count):
+    # Every tensor is released by the receiver before the next one is
+    # allocated, so the caching allocator hands out the same blocks again.
+    # Emptying the cache now and then frees them, so that the memory handle
+    # cached for a block is dropped with it.
+    for i in range(count):
+        t = torch.full([5], i, device='cuda', dtype=torch.long)
+        queue.put(t)
+        del t
+        ack_queue.get()
+        if i % 10 == 9:
+            torch.cuda.empty_cache()
+    event.wait()
+
+
 def receive_and_send_sum(queue, out_queue, event, device, dtype, count, size=5):
     s = torch.full([size], 0, device=device, dtype=dtype)
     for i in range(count):
@@ -352,7 +367,8 @@ class TestMultiprocessing(TestCase):
     @unittest.skipIf(not HAS_SHM_FILES, "don't not how to check if shm files exist")
     def test_fs(self):
         def queue_put():
-            x = torch.DoubleStorage(4)
+            # Large enough for a segment of its own, see test_fs_small_storages
+            x = torch.DoubleStorage(1 << 18)
             q = mp.Queue()
             self.assertFalse(lc.has_shm_files())
             q.put(x)
@@ -364,6 +380,26 @@ class TestMultiprocessing(TestCase):
             for _ in range(TEST_REPEATS):
                 queue_put()
 
+    @unittest.skipIf(not HAS_SHM_FILES, "don't not how to check if shm files exist")
+    def test_fs_small_storages(self):
+        # Small storages get blocks of the regions of the shared memory
+        # manager, which recycles them, rather than files of their own
+        def queue_put():
+            x = torch.DoubleStorage(4).fill_(3)
+            q = mp.Queue()
+            q.put(x)
+            time.sleep(0.05)  # queue serializes asynchronously
+            self.assertFalse(lc.has_shm_files(wait=False))
+            y = q.get()
+            self.assertEqual(y.tolist(), [3] * 4)
+            return x._share_filename_()[1]
+
+        with fs_sharing(), leak_checker(self) as lc:
+            handles = [queue_put() for _ in range(TEST_REPEATS)]
+            self.assertTrue(all(b'@' in handle for handle in handles))
+            gc.collect()
+            self.assertLess(len(set(handles)), TEST_REPEATS)
+
     def test_inherit_tensor(self):
         t = torch.zeros(5, 5)
         p = SubProcess(t.share_memory_())
@@ -411,6 +447,25 @@ class TestMultiprocessing(TestCase):
         e.set()
         p.join(1)
 
+    @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
+                     don't support multiprocessing with spawn start method")
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    def test_cuda_reuse_ipc_handles(self):
+        ctx = mp.get_context('spawn')
+        q = ctx.Queue()
+        ack = ctx.Queue()
+        e = ctx.Event()
+        count = 50
+        p = ctx.Process(target=send_reused_tensors, args=(q, ack, e, count))
+        p.start()
+        for i in range(count):
+            t = q.get()
+            self.assertEqual(t, torch.full([5], i, device='cuda', dtype=torch.long))
+            del t
+            ack.put(i)
+        e.set()
+        p.join(1)
+
     @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
                      don't support multiprocessing with spawn start method")
     @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
@@ -595,6 +595,10 @@ class TestNN(NNTestCase):
         self.assertEqual(module.weight.grad.data, module.weight.data.clone().zero_())
         self.assertEqual(module.bias.grad.data, module.bias.data.clone().zero_())
 
+        # Force set to None.
+        module.zero_grad(set_to_none=True)
+        self.assertIsNone(module.weight.grad)
+
     def test_no_grad(self):
         for dtype in [torch.bfloat16, torch.float, torch.double]:
             module = nn.Conv2d(2, 5, kernel_size=3, padding=1).to(dtype)
@@ -3869,6 +3873,25 @@ class TestNN(NNTestCase):
             bias=True).cuda()
         result = m(x)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_benchmark_cache_save_load(self):
+        x = torch.randn(2, 3, 9, 9, device="cuda", requires_grad=True)
+        conv = torch.nn.Conv2d(3, 4, 3).cuda()
+        with cudnn.flags(enabled=True, benchmark=True):
+            conv(x).sum().backward()
+        with TemporaryFileName() as fname:
+            saved = cudnn.save_benchmark_cache(fname)
+            # forward, backward data and backward filter
+            self.assertGreaterEqual(saved, 3)
+            self.assertEqual(cudnn.load_benchmark_cache(fname), saved)
+            with open(fname, 'r+b') as f:
+                f.write(b'\0' * 8)
+            with warnings.catch_warnings(record=True) as w:
+                warnings.simplefilter("always")
+                self.assertEqual(cudnn.load_benchmark_cache(fname), 0)
+                self.assertEqual(len(w), 1)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
     def test_Conv2d_inconsistent_types_on_GPU_with_cudnn(self):
@@ -4238,6 +4261,28 @@ class TestNN(NNTestCase):
 
                 hx.sum().backward()
 
+    def test_LSTM_GRU_cell_fused_cpu(self):
+        # CPU cells that require grad go through _thnn_fused_lstm_cell and
+        # _thnn_fused_gru_cell, whose backward is fused too
+        for bias in (True, False):
+            input = torch.randn(3, 10, dtype=torch.double, requires_grad=True)
+            hx = torch.randn(3, 20, dtype=torch.double, requires_grad=True)
+            cx = torch.randn(3, 20, dtype=torch.double, requires_grad=True)
+            lstm = nn.LSTMCell(10, 20, bias=bias).double()
+            gru = nn.GRUCell(10, 20, bias=bias).double()
+            params = tuple(lstm.parameters())
+            gradcheck(lambda *args: lstm(args[0], (args[1], args[2])),
+                      (input, hx, cx) + params)
+            gradcheck(lambda i, h, *_: lstm(i, (h, cx))[1], (input, hx) + params)
+            gradcheck(lambda i, h, *_: gru(i, h), (input, hx) + tuple(gru.parameters()))
+
+            # the same as the unfused cells
+            gates = F.linear(input, lstm.weight_ih, lstm.bias_ih) + F.linear(hx, lstm.weight_hh, lstm.bias_hh)
+            ingate, forgetgate, cellgate, outgate = gates.chunk(4, 1)
+            cy = torch.sigmoid(forgetgate) * cx + torch.sigmoid(ingate) * torch.tanh(cellgate)
+            hy = torch.sigmoid(outgate) * torch.tanh(cy)
+            self.assertEqual(lstm(input, (hx, cx)), (hy, cy))
+
     def _test_loss_equal_input_target_shape(self, cast):
         # Tests losses whose inputs should have the same size.
         losses = {
@@ -4623,6 +4668,32 @@ class TestNN(NNTestCase):
 
             (hx + cx).sum().backward()
 
+    def test_RNN_cpu_no_grad_matches_grad(self):
+        # without grad, the CPU LSTM and GRU cells apply their gates through
+        # fused kernels, which must match the autograd ops they replace
+        for dtype, hidden_size in itertools.product((torch.float, torch.double), (20, 5)):
+            for module in (nn.LSTM, nn.GRU):
+                rnn = module(10, hidden_size, num_layers=2).to(dtype)
+                input = torch.randn(7, 3, 10, dtype=dtype)
+                expected, expected_hidden = rnn(input)
+                with torch.no_grad():
+                    output, hidden = rnn(input)
+                self.assertEqual(output, expected)
+                if module is nn.LSTM:
+                    self.assertEqual(hidden[0], expected_hidden[0])
+                    self.assertEqual(hidden[1], expected_hidden[1])
+                else:
+                    self.assertEqual(hidden, expected_hidden)
+            for module in (nn.LSTMCell, nn.GRUCell):
+                cell = module(10, hidden_size).to(dtype)
+                input = torch.randn(3, 10, dtype=dtype)
+                hx = torch.randn(3, hidden_size, dtype=dtype)
+                state = (hx, torch.randn(3, hidden_size, dtype=dtype)) if module is nn.LSTMCell else hx
+                expected = cell(input, state)
+                with torch.no_grad():
+                    output = cell(input, state)
+                self.assertEqual(output, expected)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_pack_sequence_batch_sizes_throw(self):
         with self.assertRaisesRegex(ValueError, r"batch_sizes should always be on CPU"):
@@ -5666,6 +5737,27 @@ class TestNN(NNTestCase):
         # Because of dropout randomness, can only compare dropout=0 and dropout=1
         self._test_RNN_cpu_vs_cudnn(1)
 
+    @unittest.skipIf(not TEST_CUDNN, "needs cudnn")
+    def test_RNN_cpu_vs_cudnn_small_hidden_variable_length(self):
+        # Small hidden sizes over long sequences may take the persistent
+        # kernel, and calls of varying lengths reuse the cached descriptors.
+        lstm = nn.LSTM(16, 32)
+        lstm_cuda = deepcopy(lstm).cuda()
+        for seq_length, batch in [(40, 8), (24, 8), (40, 4)]:
+            input = torch.randn(seq_length, batch, 16)
+            expected_output, (expected_hy, expected_cy) = lstm(input)
+            output, (hy, cy) = lstm_cuda(input.cuda())
+            self.assertEqual(output, expected_output, atol=1e-4, rtol=0)
+            self.assertEqual(hy, expected_hy, atol=1e-4, rtol=0)
+            self.assertEqual(cy, expected_cy, atol=1e-4, rtol=0)
+
+        lengths = [20, 17, 17, 9, 3]
+        input = torch.randn(20, len(lengths), 16)
+        packed = rnn_utils.pack_padded_sequence(input, lengths)
+        expected_output, _ = lstm(packed)
+        output, _ = lstm_cuda(rnn_utils.pack_padded_sequence(input.cuda(), lengths))
+        self.assertEqual(output.data, expected_output.data, atol=1e-4, rtol=0)
+
     @unittest.skipIf(not TEST_CUDNN, "needs cudnn")
     def test_RNN_cudnn_weight_norm(self):
         input_size = 10
@@ -6196,6 +6288,62 @@ class TestNN(NNTestCase):
         self.assertEqual(bn.bias.grad, ref_bn.bias.grad)
         self.assertEqual(input.grad, ref_input.grad)
 
+    def test_thnn_conv2d_tiles(self):
+        # Frames are computed in tiles of output rows, which don't divide the
+        # height evenly here. The first case has multiple tiles per frame
+        # whatever the number of threads.
+        for n, c, h, w, k, stride, pad in [(1, 64, 100, 100, 3, 1, 1),
+                                           (2, 8, 33, 20, 5, 2, 2),
+                                           (3, 16, 50, 7, 1, 1, 0)]:
+            input = torch.randn(n, c, h, w, dtype=torch.double, requires_grad=True)
+            weight = torch.randn(4, c, k, k, dtype=torch.double, requires_grad=True)
+            bias = torch.randn(4, dtype=torch.double, requires_grad=True)
+            out = torch._C._nn.thnn_conv2d(input, weight, (k, k), bias, (stride, stride), (pad, pad))
+
+            output_height = (h + 2 * pad - k) // stride + 1
+            output_width = (w + 2 * pad - k) // stride + 1
+            columns = F.unfold(input, k, padding=pad, stride=stride)
+            ref = (weight.view(4, -1).matmul(columns) + bias.view(4, 1)).view(n, 4, output_height, output_width)
+            self.assertEqual(out, ref)
+
+            grad = torch.randn_like(out)
+            self.assertEqual(torch.autograd.grad(out, (input, weight, bias), grad),
+                             torch.autograd.grad(ref, (input, weight, bias), grad))
+
+    def test_batchnorm_nhwc_cpu(self):
+        def helper(self, size, train):
+            channels = size[1]
+            input = torch.randn(size, dtype=torch.float32, requires_grad=True)
+            input = input.contiguous(memory_format=torch.channels_last)
+            input.retain_grad()
+            grad = torch.randn(size, dtype=torch.float32)
+            grad = grad.contiguous(memory_format=torch.channels_last)
+            bn = nn.BatchNorm2d(channels).float().train(train)
+            bn.weight.data.uniform_()
+            bn.bias.data.uniform_()
+
+            ref_input = input.detach().clone().contiguous().requires_grad_(True)
+            ref_grad = grad.detach().clone().contiguous()
+            ref_bn = nn.BatchNorm2d(channels).float().train(train)
+            ref_bn.load_state_dict(bn.state_dict())
+
+            out = bn(input)
+            out.backward(grad)
+            ref_out = ref_bn(ref_input)
+            ref_out.backward(ref_grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(ref_out.is_contiguous())
+            self.assertEqual(out, ref_out)
+            self.assertEqual(bn.weight.grad, ref_bn.weight.grad)
+            self.assertEqual(bn.bias.grad, ref_bn.bias.grad)
+            self.assertEqual(input.grad, ref_input.grad)
+
+        # channels that don't fill whole vectors, and a single channel
+        for size in [(4, 8, 2, 2), (4, 19, 5, 5), (4, 1, 5, 5)]:
+            helper(self, size, train=True)
+            helper(self, size, train=False)
+
     @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
     def test_batchnorm_cudnn_half(self):
         # THNN
@@ -9323,6 +9471,47 @@ class TestNNDeviceType(NNTestCase):
             input = input.bfloat16()
             self._test_dropout(nn.Dropout, device, input)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_dropout_packed_mask(self, device, dtype):
+        p = 0.3
+        for n in (1, 13, 1003, 100000):
+            x = torch.randn(n, device=device, dtype=dtype, requires_grad=True)
+            out, mask = torch._fused_dropout_packed(x, 1 - p)
+            self.assertEqual(mask.dtype, torch.uint8)
+            self.assertEqual(mask.shape, ((n + 7) // 8,))
+            # The bit j of the byte i is set when the element 8 * i + j is kept
+            bits = (mask.unsqueeze(1) >> torch.arange(8, dtype=torch.uint8)) & 1
+            kept = bits.view(-1)[:n].bool()
+            self.assertEqual(out, torch.where(kept, x / (1 - p), torch.zeros_like(x)))
+            out.backward(torch.ones_like(out))
+            self.assertEqual(x.grad, kept.to(dtype) / (1 - p))
+        self.assertLess(abs(kept.to(dtype).mean().item() - (1 - p)), 0.01)
+
+        # NaNs are kept, as with the unfused dropout
+        x = torch.full((16,), float('nan'), device=device, dtype=dtype)
+        self.assertTrue(torch._fused_dropout_packed(x, 1 - p)[0].isnan().all())
+
+        mask = torch._fused_dropout_packed(torch.randn(10, device=device, dtype=dtype), 1 - p)[1]
+        g = torch.randn(10, device=device, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(lambda g: torch._masked_scale_packed(g, mask, 2.), (g,)))
+        self.assertTrue(gradgradcheck(lambda g: torch._masked_scale_packed(g, mask, 2.), (g,)))
+        with self.assertRaisesRegex(RuntimeError, "expected a packed Byte mask of 2 elements"):
+            torch._masked_scale_packed(g, mask[:1], 2.)
+
+        # The result only depends on the seed, not on the number of threads
+        num_threads = torch.get_num_threads()
+        x = torch.randn(1 << 18, device=device, dtype=dtype)
+        results = []
+        try:
+            for threads in (1, num_threads):
+                torch.set_num_threads(threads)
+                torch.manual_seed(0)
+                results.append(F.dropout(x, p, training=True))
+        finally:
+            torch.set_num_threads(num_threads)
+        self.assertEqual(results[0], results[1], atol=0, rtol=0)
+
     def test_Dropout2d(self, device):
         b = random.randint(1, 5)
         w = random.randint(1, 5)
@@ -9664,7 +9853,7 @@ class TestNNDeviceType(NNTestCase):
         helper(1, 100000, 32, 32, ks=4)
         helper(1, 100000, 1, 4, ks=(1, 4))  # test for max_pool1d
 
-    @onlyCUDA
+    @dtypes(torch.float, torch.double)
     @dtypesIfCUDA(torch.half, torch.float, torch.double)
     def test_max_pool2d_nhwc(self, device, dtype):
         def helper(n, c, h, w, kernel_size, stride=None):
@@ -9691,11 +9880,58 @@ class TestNNDeviceType(NNTestCase):
             self.assertTrue(torch.allclose(input.grad, ref_input.grad))
 
         helper(4, 8, 8, 8, 7)
-        helper(200, 512, 28, 28, 2)
+        if self.device_type == 'cuda':
+            helper(200, 512, 28, 28, 2)
         helper(4, 8, 7, 7, 3, stride=1)
         helper(10, 512, 31, 31, 3, stride=2)
         helper(1, 129, 8, 8, 3, stride=2)
 
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.float, torch.double)
+    def test_adaptive_avg_pool2d_nhwc(self, device, dtype):
+        def helper(n, c, h, w, output_size):
+            input = torch.randn(n, c, h, w, dtype=dtype, device=device)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            grad = torch.randn(n, c, output_size[0], output_size[1], dtype=dtype, device=device)
+            pool = torch.nn.AdaptiveAvgPool2d(output_size).to(device)
+
+            ref_input = input.detach().clone().contiguous().requires_grad_(True)
+            ref_grad = grad.detach().clone().contiguous()
+            ref_pool = torch.nn.AdaptiveAvgPool2d(output_size).to(device)
+
+            out = pool(input)
+            out.backward(grad)
+            ref_out = ref_pool(ref_input)
+            ref_out.backward(ref_grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(ref_out.is_contiguous())
+            self.assertEqual(out, ref_out)
+            self.assertEqual(input.grad, ref_input.grad)
+
+        helper(4, 8, 8, 8, (7, 7))
+        helper(4, 19, 10, 7, (3, 4))
+        helper(2, 64, 7, 7, (1, 1))
+        helper(1, 3, 5, 5, (5, 5))
+
+    @dtypes(torch.float, torch.double)
+    def test_max_pool2d_nhwc_indices(self, device, dtype):
+        def helper(n, c, h, w, kernel_size, stride, padding, dilation):
+            input = torch.randn(n, c, h, w, dtype=dtype, device=device)
+            input[0, 0, 0, 0] = float('nan')
+            pool = torch.nn.MaxPool2d(kernel_size, stride, padding, dilation, return_indices=True)
+
+            out, indices = pool(input.contiguous(memory_format=torch.channels_last))
+            ref_out, ref_indices = pool(input.contiguous())
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(indices.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out)
+            self.assertEqual(indices, ref_indices)
+
+        helper(2, 19, 9, 9, 3, 2, 1, 1)
+        helper(2, 16, 10, 10, 3, 1, 1, 2)
+
     @onlyCUDA
     def test_max_pool2d_indices(self, device):
         def helper(n, c, h, w, ks):
@@ -9876,6 +10112,29 @@ class TestNNDeviceType(NNTestCase):
             # test non-persistent softmax kernel
             _test_helper((4, 1536))
 
+    @onlyCUDA
+    @dtypes(torch.float, torch.double)
+    def test_softmax_layer_norm_long_rows(self, device, dtype):
+        # rows that fit in shared memory, that don't, and that can't be
+        # accessed with vectorized loads
+        for n in (4096, 4097, 16384):
+            x = torch.randn(3, n, dtype=dtype, device=device, requires_grad=True)
+            x_cpu = x.detach().cpu().requires_grad_()
+            weight = torch.randn(n, dtype=dtype, device=device, requires_grad=True)
+            weight_cpu = weight.detach().cpu().requires_grad_()
+            for fn in (lambda t, w: F.softmax(t, -1),
+                       lambda t, w: F.log_softmax(t, -1),
+                       lambda t, w: F.layer_norm(t, (n,), w)):
+                out = fn(x, weight)
+                out_cpu = fn(x_cpu, weight_cpu)
+                self.assertEqual(out, out_cpu)
+                grad = torch.randn_like(out_cpu)
+                out.backward(grad.to(device))
+                out_cpu.backward(grad)
+                self.assertEqual(x.grad, x_cpu.grad)
+                x.grad = None
+                x_cpu.grad = None
+
     @largeCUDATensorTest('12GB')
     def test_conv_large_nosplit(self, device):
         # Here we just test the convolution correctly route to the fallback implementation
@@ -10715,6 +10974,68 @@ class TestNNDeviceType(NNTestCase):
         self.assertEqual(q.size(), out[0].size())
         self.assertEqual(dtype, out[0].dtype)
 
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_fused_attention(self, device, dtype):
+        acc_dtype = torch.float if dtype == torch.half else dtype
+
+        def reference(query, key, value, mask):
+            scores = query.to(acc_dtype) @ key.to(acc_dtype).transpose(-2, -1)
+            if mask is not None:
+                if mask.dtype == torch.bool:
+                    mask = torch.zeros(mask.shape, device=device).masked_fill(mask, float('-inf'))
+                scores = scores + mask.to(acc_dtype)
+            return (torch.softmax(scores, -1) @ value.to(acc_dtype)).to(dtype), torch.logsumexp(scores, -1)
+
+        # batch sizes, query, key and value lengths, embedding and value sizes
+        for batch, num_queries, num_keys, embed_dim, value_dim in [
+                ((2, 3), 5, 7, 4, 6),
+                ((1,), 70, 130, 16, 16),
+                ((3,), 1, 1, 1, 1),
+                ((2,), 300, 40, 160, 9)]:
+            query = torch.randn(*batch, num_queries, embed_dim, device=device, dtype=dtype)
+            key = torch.randn(*batch, num_keys, embed_dim, device=device, dtype=dtype)
+            value = torch.randn(*batch, num_keys, value_dim, device=device, dtype=dtype)
+            masks = [
+                None,
+                torch.randn(num_queries, num_keys, device=device, dtype=dtype),
+                torch.rand(*batch[:-1], 1, 1, num_keys, device=device) < 0.3,
+            ]
+            for mask in masks:
+                output, logsumexp = torch._fused_attention(query, key, value, mask)
+                expected_output, expected_logsumexp = reference(query, key, value, mask)
+                tol = 1e-2 if dtype == torch.half else None
+                self.assertEqual(output, expected_output, atol=tol, rtol=tol)
+                self.assertEqual(logsumexp, expected_logsumexp, atol=tol, rtol=tol)
+
+        # Fully masked rows have no softmax, as in torch.softmax
+        query = torch.randn(2, 3, 4, device=device, dtype=dtype)
+        key = torch.randn(2, 5, 4, device=device, dtype=dtype)
+        value = torch.randn(2, 5, 4, device=device, dtype=dtype)
+        mask = torch.zeros(3, 5, dtype=torch.bool, device=device)
+        mask[1] = True
+        output, _ = torch._fused_attention(query, key, value, mask)
+        self.assertTrue(output[:, 1].isnan().all())
+        self.assertFalse(output[:, [0, 2]].isnan().any())
+
+        with self.assertRaisesRegex(RuntimeError, "same embedding size"):
+            torch._fused_attention(query, key[..., :3], value)
+
+    @dtypes(torch.double)
+    def test_fused_attention_backward(self, device, dtype):
+        def fused_attention(query, key, value, mask):
+            return torch._fused_attention(query, key, value, mask)[0]
+
+        for num_queries, num_keys in [(3, 4), (40, 70)]:
+            query = torch.randn(2, num_queries, 5, device=device, dtype=dtype, requires_grad=True)
+            key = torch.randn(2, num_keys, 5, device=device, dtype=dtype, requires_grad=True)
+            value = torch.randn(2, num_keys, 3, device=device, dtype=dtype, requires_grad=True)
+            mask = torch.randn(num_queries, num_keys, device=device, dtype=dtype)
+            mask.masked_fill_(torch.rand(num_queries, num_keys, device=device) < 0.2, float('-inf'))
+            mask[:, 0] = 0
+            for attn_mask in [None, mask]:
+                self.assertTrue(gradcheck(fused_attention, (query, key, value, attn_mask)))
+
     @dtypesIfCUDA(*ALL_TENSORTYPES2)
     @dtypes(torch.float)
     def test_Conv2d_naive_groups(self, device, dtype):
@@ -10750,6 +11071,35 @@ class TestNNDeviceType(NNTestCase):
                          torch.cat([m1.weight.grad.data, m2.weight.grad.data], 0),
                          atol=dtype2prec_DONTUSE[dtype], rtol=0)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_conv_depthwise_cpu(self, device, dtype):
+        # Inference goes through the direct depthwise kernels, which have to
+        # match the grouped convolution autograd records
+        configs = [
+            # kernel_size, stride, padding, dilation, multiplier
+            (3, 1, 1, 1, 1),
+            (5, 1, 2, 1, 1),
+            (5, 2, 2, 1, 1),
+            (3, 1, 2, 2, 1),
+            ((3, 7), (2, 3), (0, 3), (1, 2), 1),
+            (3, 2, 1, 1, 2),
+        ]
+        for (kernel_size, stride, padding, dilation, multiplier), channels_last, bias in \
+                product(configs, [False, True], [False, True]):
+            m = nn.Conv2d(19, 19 * multiplier, kernel_size, stride=stride, padding=padding,
+                          dilation=dilation, groups=19, bias=bias).to(device, dtype)
+            input = torch.randn(2, 19, 17, 20, device=device, dtype=dtype)
+            if channels_last:
+                input = input.contiguous(memory_format=torch.channels_last)
+            with torch.backends.mkldnn.flags(enabled=False):
+                expected = m(input.detach().requires_grad_())
+                with torch.no_grad():
+                    output = m(input)
+            self.assertEqual(output, expected)
+            if channels_last and multiplier == 1:
+                self.assertTrue(output.is_contiguous(memory_format=torch.channels_last))
+
     def _test_batchnorm_grad(self, device, dtype=torch.double):
         bs, n_feat, size_feat = 4, 5, 6
         input = torch.arange(bs * n_feat * size_feat, device=device,
@@ -11454,6 +11804,57 @@ class TestNNDeviceType(NNTestCase):
         helper([2, 3, 5, 7])
         helper([2, 3, 5, 7, 9])
 
+    def _cross_entropy_reference(self, input, target, weight, ignore_index, reduction, label_smoothing):
+        n_classes = input.size(1)
+        w = weight if weight is not None else torch.ones(n_classes, dtype=input.dtype, device=input.device)
+        valid = target != ignore_index
+        safe_target = target.masked_fill(~valid, 0)
+        dist = torch.zeros_like(input).scatter_(1, safe_target.unsqueeze(1), (1 - label_smoothing) * w[safe_target].unsqueeze(1))
+        dist = (dist + label_smoothing / n_classes * w) * valid.unsqueeze(1).to(input.dtype)
+        losses = -(dist * torch.log_softmax(input, 1)).sum(1)
+        if reduction == 'none':
+            return losses
+        if reduction == 'sum':
+            return losses.sum()
+        return losses.sum() / (w[safe_target] * valid.to(input.dtype)).sum()
+
+    def test_cross_entropy_label_smoothing(self, device):
+        for n_classes, weighted, reduction, label_smoothing in product(
+                [5, 3000], [False, True], ['none', 'mean', 'sum'], [0.0, 0.1, 1.0]):
+            input = torch.randn(7, n_classes, dtype=torch.double, device=device, requires_grad=True)
+            target = torch.randint(n_classes, (7,), device=device)
+            target[2] = -100
+            weight = torch.rand(n_classes, dtype=torch.double, device=device) if weighted else None
+            expected = self._cross_entropy_reference(input, target, weight, -100, reduction, label_smoothing)
+            out = F.cross_entropy(input, target, weight, reduction=reduction, label_smoothing=label_smoothing)
+            self.assertEqual(out, expected)
+            grad_expected, = torch.autograd.grad(expected.sum(), input)
+            grad, = torch.autograd.grad(out.sum(), input)
+            self.assertEqual(grad, grad_expected)
+            # the composite path taken by inputs with spatial dimensions
+            out = F.cross_entropy(input.unsqueeze(2), target.unsqueeze(1), weight,
+                                  reduction=reduction, label_smoothing=label_smoothing)
+            self.assertEqual(out.squeeze(1) if reduction == 'none' else out, expected)
+
+        if not device.startswith('cuda'):
+            input = torch.randn(3, 4, device=device)
+            with self.assertRaisesRegex(IndexError, 'out of bounds'):
+                F.cross_entropy(input, torch.tensor([0, 4, 1], device=device))
+        with self.assertRaisesRegex(ValueError, 'label_smoothing'):
+            F.cross_entropy(torch.randn(3, 4, device=device), torch.zeros(3, dtype=torch.long, device=device),
+                            label_smoothing=1.5)
+
+    def test_fused_cross_entropy_gradcheck(self, device):
+        input = torch.randn(4, 6, dtype=torch.double, device=device, requires_grad=True)
+        target = torch.tensor([1, 5, 3, 0], device=device)
+        weight = torch.rand(6, dtype=torch.double, device=device)
+        for reduction, weight in product(['none', 'mean', 'sum'], [None, weight]):
+            def func(input):
+                return F.cross_entropy(input, target, weight, ignore_index=3, reduction=reduction,
+                                       label_smoothing=0.2)
+            self.assertTrue(gradcheck(func, (input,)))
+            self.assertTrue(gradgradcheck(func, (input,)))
+
     def test_softshrink_negative(self, device):
         input = torch.randn(5, device=device, requires_grad=True)
         m = torch.nn.Softshrink(-1)
@@ -81,7 +81,7 @@ class TestNumbaIntegration(common.TestCase):
                     AttributeError, lambda: sparse_cuda_t.__cuda_array_interface__
                 )
 
-            # CUDA tensors have the attribute and v2 interface
+            # CUDA tensors have the attribute and v3 interface
             cudat = tp(10).cuda()
 
             self.assertTrue(hasattr(cudat, "__cuda_array_interface__"))
@@ -89,7 +89,7 @@ class TestNumbaIntegration(common.TestCase):
             ar_dict = cudat.__cuda_array_interface__
 
             self.assertEqual(
-                set(ar_dict.keys()), {"shape", "strides", "typestr", "data", "version"}
+                set(ar_dict.keys()), {"shape", "strides", "typestr", "data", "stream", "version"}
             )
 
             self.assertEqual(ar_dict["shape"], (10,))
@@ -97,7 +97,9 @@ class TestNumbaIntegration(common.TestCase):
             # typestr from numpy, cuda-native little-endian
             self.assertEqual(ar_dict["typestr"], numpy.dtype(npt).newbyteorder("<").str)
             self.assertEqual(ar_dict["data"], (cudat.data_ptr(), False))
-            self.assertEqual(ar_dict["version"], 2)
+            # The legacy default stream
+            self.assertEqual(ar_dict["stream"], 1)
+            self.assertEqual(ar_dict["version"], 3)
 
     @unittest.skipIf(not TEST_CUDA, "No cuda")
     @unittest.skipIf(not TEST_NUMBA_CUDA, "No numba.cuda")
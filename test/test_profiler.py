@@ -1,5 +1,7 @@
 import collections
 import gc
+import json
+import tempfile
 import unittest
 
 import torch
@@ -44,5 +46,38 @@ class TestProfiler_cuda(TestCase):
         self.assertTrue(not (is_increasing and max_diff > 100 * 1024),
                         msg='memory usage is increasing, {}'.format(str(last_rss)))
 
+
+@unittest.skipIf(not torch.cuda.is_available(), "CUDA is required")
+class TestProfilerCUPTI(TestCase):
+    def test_kernels(self):
+        """Checks that the kernels and memcpys traced with CUPTI are attributed
+        to the ops that launched them and exported in the Chrome trace
+        """
+        x = torch.randn(64, 64, device='cuda')
+        try:
+            with profile(use_cupti=True) as prof:
+                y = torch.mm(x, x)
+                y.cpu()
+        except RuntimeError as e:
+            if 'without CUPTI' in str(e):
+                self.skipTest('PyTorch was built without CUPTI')
+            raise
+
+        events = prof.function_events
+        mm_events = [evt for evt in events if evt.name.endswith('mm')]
+        self.assertTrue(mm_events)
+        self.assertTrue(any(len(evt.kernels) > 0 for evt in mm_events))
+        self.assertGreater(sum(evt.cuda_time_total for evt in mm_events), 0)
+        kernel_names = [k.name for evt in events for k in evt.kernels]
+        self.assertIn('Memcpy DtoH', kernel_names)
+
+        with tempfile.NamedTemporaryFile(mode='w+', suffix='.json') as f:
+            prof.export_chrome_trace(f.name)
+            trace = json.load(f)
+        cuda_events = [evt for evt in trace
+                       if evt['pid'] == 'CUDA functions' and evt['ph'] == 'X']
+        self.assertEqual(len(cuda_events), len(kernel_names))
+
+
 if __name__ == '__main__':
     run_tests()
@@ -738,6 +738,37 @@ class TestSerialization(TestCase, SerializationMixin):
             torch.save(model, path)
             torch.load(path)
 
+    def test_async_save(self):
+        model = torch.nn.Linear(4, 3)
+        base = torch.arange(10.)
+        data = {'model': model.state_dict(), 'tensors': [base, base[2:5]],
+                'step': 3, 'pair': (base[1], 'a')}
+        expected = copy.deepcopy(data)
+
+        buf = io.BytesIO()
+        future = torch.serialization.async_save(data, buf)
+        # The tensors were snapshotted, so updating them doesn't change the file.
+        with torch.no_grad():
+            for p in model.parameters():
+                p.add_(1)
+        base.zero_()
+        future.result()
+
+        buf.seek(0)
+        result = torch.load(buf)
+        self.assertEqual(result, expected)
+        self.assertEqual(result['tensors'][1].storage().data_ptr(),
+                         result['tensors'][0].storage().data_ptr())
+        self.assertEqual(result['model']._metadata, data['model']._metadata)
+
+    def test_async_save_parallel_crc(self):
+        # Large enough to be checksummed in several chunks.
+        t = torch.randn(3 * 1024 * 1024)
+        buf = io.BytesIO()
+        torch.serialization.async_save(t, buf).result()
+        buf.seek(0)
+        self.assertEqual(torch.load(buf), t)
+
     def run(self, *args, **kwargs):
         with serialization_method(use_zip=True):
             return super(TestSerialization, self).run(*args, **kwargs)
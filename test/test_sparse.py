@@ -1720,6 +1720,30 @@ class TestSparse(TestCase):
 
         self.assertFalse(z._indices().numel() != 2 and z.is_coalesced())
 
+    def test_coalesce_add_many_nnz(self):
+        # enough entries for the coalesce and add kernels to split the work
+        nnz = 100000
+        for shape_v in [[], [3]]:
+            shape = [500, 400] + shape_v
+            i = torch.stack([torch.randint(500, (nnz,), device=self.device),
+                             torch.randint(400, (nnz,), device=self.device)])
+            v = torch.randn([nnz] + shape_v, dtype=self.value_dtype, device=self.device)
+            x = self.sparse_tensor(i, v, shape)
+            expected = torch.zeros(shape, dtype=self.value_dtype, device=self.device).index_put_((i[0], i[1]), v, accumulate=True)
+            xc = x.coalesce()
+            self.assertTrue(xc.is_coalesced())
+            self.assertEqual(xc._nnz(), torch.unique(i[0] * 400 + i[1]).numel())
+            self.assertEqual(xc.to_dense(), expected)
+
+            i2 = torch.stack([torch.randint(500, (nnz,), device=self.device),
+                              torch.randint(400, (nnz,), device=self.device)])
+            y = self.sparse_tensor(i2, torch.randn([nnz] + shape_v, dtype=self.value_dtype, device=self.device), shape)
+            yc = y.coalesce()
+            z = torch.add(xc, yc, alpha=2)
+            self.assertTrue(z.is_coalesced())
+            self.assertEqual(z.to_dense(), expected + 2 * yc.to_dense())
+            self.assertEqual((x + y).to_dense(), expected + y.to_dense())
+
     @cuda_only
     def test_storage_not_null(self):
         x = torch.cuda.sparse.FloatTensor(2)
@@ -2726,5 +2750,94 @@ class TestSparseOneOff(TestCase):
             x + sparse_y
 
 
+class TestSparseCSR(TestCase):
+    def setUp(self):
+        super(TestSparseCSR, self).setUp()
+        self.device = 'cpu'
+
+    def _gen_sparse_csr(self, rows, cols, nnz, dtype=torch.double):
+        dense = torch.zeros(rows * cols, dtype=dtype, device=self.device)
+        dense[torch.randperm(rows * cols, device=self.device)[:nnz]] = torch.randn(nnz, device=self.device).to(dtype)
+        dense = dense.view(rows, cols)
+        return dense.to_sparse_csr(), dense
+
+    def test_sparse_csr_constructor(self):
+        crow_indices = torch.tensor([0, 2, 2, 3], device=self.device)
+        col_indices = torch.tensor([0, 2, 1], device=self.device)
+        values = torch.tensor([1., 2., 3.], device=self.device)
+        s = torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 3])
+        self.assertEqual(s.layout, torch.sparse_csr)
+        self.assertTrue(s.is_sparse_csr)
+        self.assertFalse(s.is_sparse)
+        self.assertEqual(s.shape, (3, 3))
+        self.assertEqual(s._nnz(), 3)
+        self.assertEqual(s.crow_indices(), crow_indices)
+        self.assertEqual(s.col_indices(), col_indices)
+        self.assertEqual(s.values(), values)
+        self.assertEqual(s.to_dense(), torch.tensor([[1., 0., 2.], [0., 0., 0.], [0., 3., 0.]], device=self.device))
+        self.assertIn('layout=torch.sparse_csr', repr(s))
+
+        with self.assertRaisesRegex(RuntimeError, "expected crow_indices to have size"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values, [2, 3])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices\\[-1\\]"):
+            torch.sparse_csr_tensor(crow_indices, col_indices[:2], values[:2], [3, 3])
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 2])
+
+    def test_sparse_csr_conversions(self):
+        for rows, cols, nnz in [(5, 7, 10), (1, 4, 0), (0, 3, 0), (6, 6, 36)]:
+            s, dense = self._gen_sparse_csr(rows, cols, nnz)
+            self.assertEqual(s._nnz(), nnz)
+            self.assertEqual(s.to_dense(), dense)
+            self.assertEqual(s.to_sparse().to_dense(), dense)
+            self.assertEqual(dense.to_sparse().to_sparse_csr().to_dense(), dense)
+            self.assertEqual(s.clone().to_dense(), dense)
+
+    def test_sparse_csr_matmul(self):
+        dtypes = [torch.float, torch.double]
+        if self.device == 'cpu':
+            dtypes.append(torch.long)
+        for dtype in dtypes:
+            for m, k, n, nnz in [(5, 7, 3, 10), (10, 4, 1, 0), (3, 3, 8, 9)]:
+                s, dense = self._gen_sparse_csr(m, k, nnz, dtype)
+                mat = torch.randn(k, n, device=self.device).to(dtype)
+                self.assertEqual(torch.mm(s, mat), dense.mm(mat))
+                self.assertEqual(torch.mm(s, mat.t().contiguous().t()), dense.mm(mat))
+                vec = torch.randn(k, device=self.device).to(dtype)
+                self.assertEqual(torch.mv(s, vec), dense.mv(vec))
+                t = torch.randn(m, n, device=self.device).to(dtype)
+                self.assertEqual(torch.addmm(t, s, mat, beta=2, alpha=3), torch.addmm(t, dense, mat, beta=2, alpha=3))
+                out = torch.empty(n, m, device=self.device, dtype=dtype).t()
+                torch.addmm(t, s, mat, out=out)
+                self.assertEqual(out, torch.addmm(t, dense, mat))
+
+    def test_sparse_csr_elementwise(self):
+        s1, d1 = self._gen_sparse_csr(4, 6, 10)
+        s2, d2 = self._gen_sparse_csr(4, 6, 8)
+        self.assertEqual((s1 + s2).to_dense(), d1 + d2)
+        self.assertEqual(torch.add(s1, s1, alpha=2).to_dense(), 3 * d1)
+        self.assertEqual((s1 * s2).to_dense(), d1 * d2)
+        self.assertEqual((s1 * 3).to_dense(), 3 * d1)
+        self.assertEqual((s1 * d2).to_dense(), d1 * d2)
+        self.assertEqual(s1 + d2, d1 + d2)
+        self.assertEqual(d2 + s1, d1 + d2)
+        d = d2.clone()
+        d.add_(s1, alpha=2)
+        self.assertEqual(d, d2 + 2 * d1)
+
+    def test_sparse_csr_mm_backward(self):
+        s, dense = self._gen_sparse_csr(4, 5, 7)
+        mat = torch.randn(5, 3, device=self.device, requires_grad=True)
+        torch.mm(s, mat).sum().backward()
+        self.assertEqual(mat.grad, dense.t().mm(torch.ones(4, 3, device=self.device)))
+
+
+@unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+class TestCudaSparseCSR(TestSparseCSR):
+    def setUp(self):
+        super(TestCudaSparseCSR, self).setUp()
+        self.device = 'cuda'
+
+
 if __name__ == '__main__':
     run_tests()
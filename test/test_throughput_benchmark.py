@@ -1,7 +1,11 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 
-import torch
+import os
+import sys
 import tempfile
+import unittest
+
+import torch
 from torch.utils import ThroughputBenchmark
 from torch.testing import assert_allclose
 
@@ -76,6 +80,36 @@ class TestThroughputBenchmark(TestCase):
     def test_module(self):
         self.linear_test(TwoLayerNetModule)
 
+    def test_latency_percentiles(self):
+        module = TwoLayerNet(10, 5, 15)
+        bench = ThroughputBenchmark(module)
+        bench.add_input(torch.randn(8, 10), torch.randn(8, 10))
+
+        for target_qps in (0, 1000):
+            stats = bench.benchmark(
+                num_calling_threads=2,
+                num_warmup_iters=10,
+                num_iters=200,
+                target_qps=target_qps,
+            )
+            self.assertGreater(stats.latency_p50_ms, 0)
+            self.assertLessEqual(stats.latency_p50_ms, stats.latency_p90_ms)
+            self.assertLessEqual(stats.latency_p90_ms, stats.latency_p99_ms)
+            self.assertLessEqual(stats.latency_p99_ms, stats.latency_p999_ms)
+
+    @unittest.skipIf(not sys.platform.startswith('linux'), "CPU pinning is only supported on Linux")
+    def test_cpu_affinity(self):
+        module = TwoLayerNet(10, 5, 15)
+        bench = ThroughputBenchmark(module)
+        bench.add_input(torch.randn(8, 10), torch.randn(8, 10))
+        cpus = sorted(os.sched_getaffinity(0))
+        stats = bench.benchmark(
+            num_calling_threads=2,
+            num_iters=100,
+            cpu_affinity=cpus[:2],
+        )
+        self.assertEqual(stats.num_iters, 100)
+
     def test_profiling(self):
         with tempfile.NamedTemporaryFile(delete=False) as f:
             self.linear_test(TwoLayerNetModule, profiler_output_path=f.name)
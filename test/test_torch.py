@@ -797,6 +797,26 @@ class AbstractTestCases:
             self.assertEqual(y[:, 0], range(100))
             self.assertEqual(y[:, 40], range(4000, 4100))
 
+        @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+        def test_copy_transpose_blocked(self):
+            # sizes around the tiles of the blocked transpose copy
+            for dtype in [torch.uint8, torch.int16, torch.half, torch.int32, torch.float,
+                          torch.double, torch.complex64, torch.bool]:
+                for n, m in [(16, 16), (37, 70), (64, 129)]:
+                    x = torch.randn(n, m).mul(10).to(dtype)
+                    expected = torch.from_numpy(np.ascontiguousarray(x.numpy().T))
+                    self.assertEqual(x.t().contiguous(), expected)
+                    y = torch.empty(n, m, dtype=dtype).t()
+                    y.copy_(expected)
+                    self.assertEqual(y, expected)
+
+                # NCHW <-> NHWC
+                x = torch.randn(2, 19, 17, 18).mul(10).to(dtype)
+                self.assertEqual(x.permute(0, 2, 3, 1).contiguous().numpy(),
+                                 np.ascontiguousarray(x.numpy().transpose(0, 2, 3, 1)))
+                nhwc = x.contiguous(memory_format=torch.channels_last)
+                self.assertEqual(nhwc.contiguous(), x)
+
         def test_device(self):
             cpu = torch.device('cpu')
             self.assertEqual('cpu', str(cpu))
@@ -3731,6 +3751,28 @@ class AbstractTestCases:
             self.assertEqual(bools.size(), 4)
             self.assertEqual(bools.tolist(), [False, True, True, True])
 
+        def test_small_tensor_storage(self):
+            # Storages of at most 64 bytes keep their data inline, make sure
+            # they behave like the others when resized, shared or swapped.
+            x = torch.arange(8, dtype=torch.float)
+            y = torch.zeros(0).set_(x.storage())
+            y[0] = -1
+            self.assertEqual(x[0], -1)
+
+            x.resize_(100)
+            self.assertEqual(x[:8], torch.tensor([-1., 1, 2, 3, 4, 5, 6, 7]))
+            x[1] = -2
+            self.assertEqual(y[1], -2)
+
+            z = torch.arange(4, dtype=torch.double)
+            z.share_memory_()
+            self.assertTrue(z.is_shared())
+            self.assertEqual(z, torch.arange(4, dtype=torch.double))
+
+            s = torch.DoubleStorage([1, 2, 3])
+            self.assertEqual(s.clone().tolist(), [1, 2, 3])
+            self.assertEqual(torch.tensor(3.).item(), 3.)
+
         def test_storage_casts(self):
             storage = torch.IntStorage([-1, 0, 1, 2, 3, 4])
             self.assertEqual(storage.size(), 6)
@@ -4426,6 +4468,48 @@ tensor([[[1.+1.j, 1.+1.j, 1.+1.j,  ..., 1.+1.j, 1.+1.j, 1.+1.j],
             x.strides = (3,)
             self.assertRaises(ValueError, lambda: torch.from_numpy(x))
 
+        @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+        def test_from_numpy_copy_if_needed(self):
+            incorrect_byteorder = '>' if sys.byteorder == 'little' else '<'
+            x = np.arange(12.).reshape(3, 4)
+            expected = torch.arange(12.).view(3, 4)
+            for array, expected_copy in ((x[::-1, ::2], expected.flip(0)[:, ::2]),
+                                         (x.astype(incorrect_byteorder + 'f8'), expected)):
+                self.assertRaises(ValueError, lambda: torch.from_numpy(array))
+                tensor = torch.from_numpy(array, copy_if_needed=True)
+                self.assertEqual(tensor, expected_copy)
+                self.assertTrue(tensor.is_contiguous())
+                # torch.tensor copies the array anyway
+                self.assertEqual(torch.tensor(array), expected_copy)
+
+            # arrays that can be shared still are
+            tensor = torch.from_numpy(x, copy_if_needed=True)
+            tensor[0, 0] = -1
+            self.assertEqual(x[0, 0], -1)
+
+            x = np.array([3., 5., 8.])
+            x.strides = (3,)
+            self.assertRaises(ValueError, lambda: torch.from_numpy(x))
+            self.assertEqual(torch.from_numpy(x, copy_if_needed=True), torch.from_numpy(x.copy()))
+
+        @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+        @unittest.skipIf(not torch.cuda.is_available(), "CUDA not available")
+        def test_from_numpy_pin_memory(self):
+            x = np.arange(12.).reshape(3, 4)
+            for tensor in (torch.from_numpy(x, pin_memory=True),
+                           torch.from_numpy(x[::-1], copy_if_needed=True, pin_memory=True),
+                           torch.tensor(x, pin_memory=True),
+                           torch.tensor(x, dtype=torch.float, pin_memory=True)):
+                self.assertTrue(tensor.is_pinned())
+                self.assertEqual(tensor.numpy().sum(), x.sum())
+                # the pinned tensor is a copy
+                tensor.zero_()
+                self.assertEqual(x[1, 0], 4)
+
+            # a pinned array is copied as well
+            y = torch.tensor(x, pin_memory=True).numpy()
+            self.assertNotEqual(torch.tensor(y, pin_memory=True).data_ptr(), y.ctypes.data)
+
         @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
         def test_ctor_with_numpy_scalar_ctor(self) -> None:
             dtypes = [
@@ -5194,6 +5278,52 @@ tensor([[[1.+1.j, 1.+1.j, 1.+1.j,  ..., 1.+1.j, 1.+1.j, 1.+1.j],
             z = x + y
             self.assertEqual(z.size(), (2 ** 20, 2 ** 20))
 
+        def test_meta_device(self):
+            x = torch.empty(2 ** 20, 2 ** 20, device='meta')
+            self.assertTrue(x.is_meta)
+            self.assertEqual(x.device, torch.device('meta'))
+            self.assertEqual(torch.empty_strided((3, 4), (1, 3), device='meta').stride(), (1, 3))
+            self.assertTrue(torch.zeros(3, device='meta').is_meta)
+            self.assertTrue(torch.randn(3, device='meta').is_meta)
+            self.assertTrue(torch.empty_like(x).is_meta)
+
+            # Views and shapes
+            self.assertEqual(x.t().size(), (2 ** 20, 2 ** 20))
+            self.assertEqual(x[1].size(), (2 ** 20,))
+            self.assertEqual(x[:, 1:3].stride(), (2 ** 20, 1))
+            self.assertEqual(x.view(-1, 2).size(), (2 ** 39, 2))
+            self.assertEqual(x.reshape(2 ** 19, -1).size(), (2 ** 19, 2 ** 21))
+            self.assertEqual((x[0].unsqueeze(1) * x[0]).size(), (2 ** 20, 2 ** 20))
+            self.assertRaisesRegex(RuntimeError, "Expected self.size", lambda: x[0, :3] - x[0, :4])
+
+            # In-place initializers
+            y = torch.empty(4, 5, device='meta')
+            for init in (torch.nn.init.ones_, torch.nn.init.zeros_, torch.nn.init.normal_,
+                         torch.nn.init.uniform_, torch.nn.init.kaiming_uniform_,
+                         torch.nn.init.xavier_normal_):
+                self.assertIs(init(y), y)
+            y.copy_(torch.randn(5))
+            self.assertRaisesRegex(RuntimeError, "Cannot copy out of meta tensor",
+                                   lambda: torch.empty(4, 5).copy_(y))
+
+        def test_meta_module(self):
+            m = torch.nn.Sequential(torch.nn.Embedding(2 ** 20, 2 ** 10, padding_idx=0, device='meta'),
+                                    torch.nn.Linear(2 ** 10, 2 ** 20, device='meta'),
+                                    torch.nn.LayerNorm(2 ** 20, device='meta'))
+            for p in m.parameters():
+                self.assertTrue(p.is_meta)
+                self.assertTrue(p.requires_grad)
+            self.assertEqual(m[1].weight.size(), (2 ** 20, 2 ** 10))
+
+            m = torch.nn.Linear(5, 3, dtype=torch.double, device='meta')
+            self.assertIs(m.to_empty(device='cpu'), m)
+            for p in m.parameters():
+                self.assertFalse(p.is_meta)
+                self.assertEqual(p.device, torch.device('cpu'))
+                self.assertEqual(p.dtype, torch.double)
+            m.reset_parameters()
+            self.assertEqual(m(torch.ones(2, 5, dtype=torch.double)).size(), (2, 3))
+
         def test_tensor_grad_warnings(self):
             dummy = torch.empty(1)
 
@@ -6649,6 +6779,24 @@ class TestTorchDeviceType(TestCase):
             torch.pow(m1, 1, out=out)
             self.assertEqual(out, m1)
 
+    @dtypes(torch.uint8, torch.int8, torch.int16, torch.int32, torch.int64,
+            torch.float32, torch.float64)
+    def test_pow_small_integral_exponents(self, device, dtype):
+        # Exponents up to 8 are unrolled into multiplications on CPU
+        for exponent in range(2, 10):
+            if dtype.is_floating_point:
+                base = torch.randn(3, 67, dtype=dtype, device=device)
+            else:
+                # Keeps the powers of the 8 bit types in range
+                low = 0 if dtype == torch.uint8 else -1
+                high = 2 if dtype in (torch.uint8, torch.int8) else 4
+                base = torch.randint(low, high, (3, 67), dtype=dtype, device=device)
+            for b in (base, base.t()):
+                expected = torch.from_numpy(np.power(b.cpu().numpy(), exponent))
+                self.assertEqual(b.pow(exponent), expected.to(device))
+                if dtype.is_floating_point:
+                    self.assertEqual(b.pow(float(exponent)), expected.to(device))
+
 
     def test_neg(self, device):
         int_types = [torch.int, torch.short, torch.int8, torch.uint8]
@@ -7157,6 +7305,23 @@ class TestTorchDeviceType(TestCase):
             self.assertTrue(res2.is_contiguous(memory_format=torch.channels_last))
             self.assertEqual(res1, res2)
 
+    def test_cat_many_inputs(self, device):
+        # many small inputs of different sizes, in a result both below and
+        # above the grain size
+        for dtype, dim, rows in product([torch.float, torch.int16, torch.bool, torch.complex64],
+                                        [0, 1, -1], [3, 200]):
+            shapes = [[rows, 5, 3] for _ in range(1000)]
+            for i, shape in enumerate(shapes):
+                shape[dim] = i % 4
+            inputs = [torch.randn(shape, device=device).mul(10).to(dtype) for shape in shapes]
+            res = torch.cat(inputs, dim=dim)
+            expected = torch.empty(res.shape, dtype=dtype, device=device)
+            offset = 0
+            for t in inputs:
+                expected.narrow(dim, offset, t.size(dim)).copy_(t)
+                offset += t.size(dim)
+            self.assertEqual(res, expected)
+
     @onlyCUDA
     def test_cat_preserve_channels_last(self, device):
         x = torch.randn((4, 3, 8, 8), device=device)
@@ -7999,6 +8164,37 @@ class TestTorchDeviceType(TestCase):
         B = torch.mm(L, L.t())
         self.assertEqual(A, B, atol=1e-14, rtol=0, msg='cholesky (lower) did not allow rebuilding the original matrix')
 
+    @onlyCPU
+    @skipCPUIfNoLapack
+    @dtypes(torch.float, torch.double)
+    def test_linalg_small_matrices_batched(self, device, dtype):
+        from torch.testing._internal.common_utils import random_fullrank_matrix_distinct_singular_value, \
+            random_symmetric_pd_matrix
+
+        # sizes up to 4 use the unrolled kernels, the others LAPACK
+        for n in range(1, 7):
+            A = random_fullrank_matrix_distinct_singular_value(n, 1000, dtype=dtype, device=device)
+            b = torch.randn(1000, n, 2, dtype=dtype, device=device)
+            x, lu = torch.solve(b, A)
+            self.assertEqual(torch.matmul(A, x), b)
+            self.assertEqual(lu, torch.lu(A)[0])
+            eye = torch.eye(n, dtype=dtype, device=device).expand(1000, n, n)
+            self.assertEqual(torch.matmul(A, torch.inverse(A)), eye)
+
+            S = random_symmetric_pd_matrix(n, 1000, dtype=dtype, device=device)
+            L = torch.cholesky(S)
+            self.assertEqual(S, torch.matmul(L, L.transpose(-2, -1)))
+            self.assertEqual(L, L.tril())
+            U = torch.cholesky(S, upper=True)
+            self.assertEqual(S, torch.matmul(U.transpose(-2, -1), U))
+            self.assertEqual(U, U.triu())
+
+            A[7] = 0
+            with self.assertRaisesRegex(RuntimeError, "For batch 7: U\\(1,1\\) is zero"):
+                torch.solve(b, A)
+            with self.assertRaisesRegex(RuntimeError, "For batch 7: U\\(1,1\\) is zero"):
+                torch.inverse(A)
+
     def test_view(self, device):
         tensor = torch.rand(15, device=device)
         template = torch.rand(3, 5, device=device)
@@ -9343,6 +9539,38 @@ class TestTorchDeviceType(TestCase):
         with self.assertRaisesRegex(RuntimeError, rmsg):
             torch.min(x, dim=0, out=(illegal_values, illegal_indices))
 
+    @dtypes(torch.float, torch.double, torch.int64, torch.int32, torch.uint8)
+    def test_aminmax(self, device, dtype):
+        for shape in [(5,), (7, 33), (300, 200)]:
+            if dtype.is_floating_point:
+                x = torch.randn(shape, device=device, dtype=dtype)
+            else:
+                x = torch.randint(0, 100, shape, device=device, dtype=dtype)
+            min_val, max_val = torch._aminmax(x)
+            self.assertEqual(min_val, torch.min(x))
+            self.assertEqual(max_val, torch.max(x))
+            for dim in range(x.dim()):
+                for keepdim in [False, True]:
+                    min_vals, max_vals = torch._aminmax(x, dim, keepdim)
+                    self.assertEqual(min_vals, torch.min(x, dim, keepdim)[0])
+                    self.assertEqual(max_vals, torch.max(x, dim, keepdim)[0])
+            # non-contiguous input
+            min_val, max_val = torch._aminmax(x.t())
+            self.assertEqual(min_val, torch.min(x))
+            self.assertEqual(max_val, torch.max(x))
+
+        if dtype.is_floating_point:
+            x = torch.randn(10, 70, device=device, dtype=dtype)
+            x[3, 4] = float('nan')
+            min_val, max_val = torch._aminmax(x)
+            self.assertTrue(torch.isnan(min_val) and torch.isnan(max_val))
+            min_vals, max_vals = torch._aminmax(x, 1)
+            self.assertEqual(min_vals, torch.min(x, 1)[0])
+            self.assertEqual(max_vals, torch.max(x, 1)[0])
+
+        with self.assertRaisesRegex(RuntimeError, "identity"):
+            torch._aminmax(torch.empty(0, device=device, dtype=dtype))
+
     @dtypes(torch.float, torch.double, torch.int64, torch.int32, torch.int16)
     @dtypesIfCUDA(torch.float, torch.double, torch.int64, torch.int32, torch.int16, torch.half)
     def test_dim_arg_reduction_scalar(self, device, dtype):
@@ -9361,6 +9589,27 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(x.argmin(dim=0, keepdim=True), torch.tensor(0, dtype=torch.int64))
 
 
+    # Parallel reductions split the outputs, the reduced dims or both,
+    # depending on the shape
+    @onlyCPU
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    def test_parallel_reduction_strategies(self, device):
+        cases = [((8, 1 << 14), (1,)),
+                 ((1 << 14, 8), (0,)),
+                 ((3, 1 << 13, 5), (1,)),
+                 ((16, 1024, 8), (0, 2)),
+                 ((2, 1 << 12, 16), (1,)),
+                 ((300, 301), (0,))]
+        for shape, dims in cases:
+            x = torch.randint(-100, 100, shape, device=device)
+            expected = torch.from_numpy(x.numpy().sum(axis=dims))
+            self.assertEqual(x.sum(dims), expected, atol=0, rtol=0)
+            xt = x.transpose(0, -1)
+            self.assertEqual(xt.sum(dims), torch.from_numpy(xt.numpy().sum(axis=dims)), atol=0, rtol=0)
+            y = x.float()
+            expected = torch.from_numpy(y.numpy().min(axis=dims))
+            self.assertEqual(y.min_values(dims), expected, atol=0, rtol=0)
+
     def test_dim_reduction(self, device):
         example = [[-1, 2, 1], [5, 3, 6]]
 
@@ -9989,6 +10238,18 @@ class TestTorchDeviceType(TestCase):
                 expected = start + weight * (end - start)
                 self.assertEqual(expected, actual)
 
+    @dtypes(torch.float32, torch.float64)
+    def test_lerp_weights_around_half(self, device, dtype):
+        # Elements on either side of a weight of 0.5 use different formulas
+        start = torch.randn(3, 67, dtype=dtype, device=device)
+        end = torch.randn(3, 67, dtype=dtype, device=device)
+        weight = torch.rand(3, 67, dtype=dtype, device=device) * 2 - 0.5
+        expected = start + weight * (end - start)
+        self.assertEqual(torch.lerp(start, end, weight), expected)
+        self.assertEqual(torch.lerp(start.t(), end.t(), weight.t()), expected.t())
+        for w in (0.25, 0.5, 0.75, 1.0):
+            self.assertEqual(torch.lerp(start, end, w), start + w * (end - start))
+
     def _test_logaddexp(self, device, dtype, base2):
         if base2:
             ref_func = np.logaddexp2
@@ -11202,6 +11463,37 @@ class TestTorchDeviceType(TestCase):
                 # Ensure we are notified when NumPy changes its behavior
                 self.compare_with_numpy(torch.exp, np.exp, nan_real_inf_imag_in)
 
+    # Large contiguous fills are split across threads, with a result that
+    # only depends on the seed
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_parallel_random_fill_deterministic(self, device, dtype):
+        num_threads = torch.get_num_threads()
+        fills = [lambda t: t.uniform_(-2, 3),
+                 lambda t: t.normal_(1, 2),
+                 lambda t: t.bernoulli_(0.3)]
+        try:
+            for size in (1 << 16, (1 << 16) + 7):
+                for fill in fills:
+                    results = []
+                    for threads in (1, num_threads):
+                        torch.set_num_threads(threads)
+                        torch.manual_seed(123)
+                        t = fill(torch.empty(size, dtype=dtype, device=device))
+                        # The generator advances past the fill
+                        self.assertNotEqual(t, fill(torch.empty_like(t)))
+                        results.append(t)
+                    self.assertEqual(results[0], results[1], atol=0, rtol=0)
+        finally:
+            torch.set_num_threads(num_threads)
+
+        torch.manual_seed(123)
+        t = torch.empty(1 << 20, dtype=dtype, device=device)
+        self.assertEqual(t.uniform_(-2, 3).mean().item(), 0.5, atol=0.01, rtol=0)
+        self.assertEqual(t.normal_(1, 2).mean().item(), 1, atol=0.01, rtol=0)
+        self.assertEqual(t.std().item(), 2, atol=0.01, rtol=0)
+        self.assertEqual(t.bernoulli_(0.3).mean().item(), 0.3, atol=0.01, rtol=0)
+
     @skipIfNoSciPy
     @dtypes(*torch.testing.get_all_fp_dtypes())
     def test_uniform_kstest(self, device, dtype):
@@ -11945,6 +12237,28 @@ class TestTorchDeviceType(TestCase):
                 'expected scalar_type Double but found Float'):
             torch.logcumsumexp(b, axis, out=inplace_out)
 
+    # Long scans with few of them are split into blocks scanned in parallel
+    @onlyCPU
+    @unittest.skipIf(not TEST_NUMPY, 'Numpy not found')
+    @dtypes(torch.double, torch.long)
+    def test_cum_ops_long_dim(self, device, dtype):
+        n = 1 << 20
+        if dtype.is_floating_point:
+            x = torch.randn(2, n, device=device, dtype=dtype)
+        else:
+            x = torch.randint(-5, 5, (2, n), device=device, dtype=dtype)
+        for t, dim in ((x[0], 0), (x[1, ::2], 0), (x, 1), (x.t(), 0)):
+            self.assertEqual(torch.cumsum(t, dim), np.cumsum(t.numpy(), dim))
+            # Products of values close to 1 in magnitude, so that they don't
+            # overflow
+            if dtype.is_floating_point:
+                t_prod = 1 + t * 1e-4
+            else:
+                t_prod = (t >= 0).to(dtype) * 2 - 1
+            self.assertEqual(torch.cumprod(t_prod, dim), np.cumprod(t_prod.numpy(), dim))
+            if dtype.is_floating_point:
+                self.assertEqual(torch.logcumsumexp(t, dim), np.logaddexp.accumulate(t.numpy(), dim))
+
     def test_std_mean(self, device):
         x = torch.rand(100, 50, 20, device=device)
         for dim in range(x.dim()):
@@ -12122,6 +12436,25 @@ class TestTorchDeviceType(TestCase):
             expanded = torch.randn(1, 5, 1, 2, device=device).expand(3, 5, 7, 2)
             test_against_np(expanded)
 
+    # Large enough for the CPU kernels to split the inputs between threads
+    @dtypes(torch.float, torch.double)
+    def test_histc_bincount_large(self, device, dtype):
+        x = torch.randint(0, 10, (300000,), device=device)
+        weights = torch.rand(300000, device=device, dtype=dtype)
+        expected = torch.zeros(10, device=device, dtype=torch.long)
+        expected.index_add_(0, x, torch.ones_like(x))
+        self.assertEqual(torch.bincount(x), expected)
+        self.assertEqual(torch.bincount(x, minlength=12)[:10], expected)
+        self.assertEqual(torch.histc(x.to(dtype), bins=10, min=0, max=10), expected.to(dtype))
+        expected_weighted = torch.zeros(10, device=device, dtype=dtype).index_add_(0, x, weights)
+        self.assertEqual(torch.bincount(x, weights), expected_weighted)
+
+        # many bins, most of them empty
+        x = torch.randint(0, 100000, (300000,), device=device)
+        expected = torch.zeros(100000, device=device, dtype=torch.long)
+        expected.index_add_(0, x, torch.ones_like(x))
+        self.assertEqual(torch.bincount(x), expected)
+
     def test_bool_tensor_comparison_ops(self, device):
         a = torch.tensor([True, False, True, False, True, False], dtype=torch.bool, device=device)
         b = torch.tensor([True, False, True, True, True, True], dtype=torch.bool, device=device)
@@ -12686,6 +13019,32 @@ class TestTorchDeviceType(TestCase):
         for i in range(idx.size(0)):
             self.assertEqual(dest[i], src[idx[i]])
 
+    @onlyCPU
+    def test_index_select_gather_random(self, device):
+        # large random gathers, which take the prefetching and vectorized kernels
+        for dtype in [torch.int8, torch.int16, torch.half, torch.float, torch.double,
+                      torch.complex64, torch.complex128, torch.bool]:
+            for row_size in [1, 3, 64]:
+                src = torch.randn(1000, row_size, device=device).mul(10).to(dtype)
+                idx = torch.randint(1000, (5000,), device=device)
+                self.assertEqual(torch.index_select(src, 0, idx), src[idx])
+            src = torch.randn(1000, device=device).mul(10).to(dtype)
+            self.assertEqual(torch.index_select(src, 0, idx), src[idx])
+
+            src = torch.randn(50, 100, device=device).mul(10).to(dtype)
+            idx = torch.randint(100, (50, 300), device=device)
+            self.assertEqual(torch.gather(src, 1, idx), src[torch.arange(50).unsqueeze(1), idx])
+
+        src = torch.randn(1000, device=device)
+        idx = torch.randint(1000, (5000,), device=device)
+        idx[4321] = 1000
+        with self.assertRaisesRegex(IndexError, 'out of range'):
+            torch.index_select(src, 0, idx)
+        with self.assertRaisesRegex(IndexError, 'out of range'):
+            torch.index_select(src.view(1000, 1).expand(1000, 8).contiguous(), 0, idx)
+        with self.assertRaisesRegex(RuntimeError, 'index 1000 is out of bounds'):
+            torch.gather(src.view(1, 1000), 1, idx.view(1, 5000))
+
     def test_take_empty(self, device):
         for input_shape in [(0,), (0, 1, 2, 0), (1, 2, 3)]:
             for indices_shape in [(0,), (0, 1, 2, 0)]:
@@ -12781,6 +13140,59 @@ class TestTorchDeviceType(TestCase):
                          torch.tensor([[3], [1]], device=device,
                                       dtype=torch.float32).repeat(1, width))
 
+    @dtypes(torch.float, torch.double)
+    def test_scatter_add_1d_non_unique_index(self, device, dtype):
+        # 1-d inputs are split between threads, which accumulate atomically
+        index = torch.randint(100, (100000,), device=device)
+        src = torch.ones(100000, device=device, dtype=dtype)
+        input = torch.zeros(100, device=device, dtype=dtype)
+        input.scatter_add_(0, index, src)
+        self.assertEqual(input, torch.bincount(index, minlength=100).to(dtype))
+
+        input = torch.zeros(100, device=device, dtype=dtype)
+        input.index_put_((index,), src, accumulate=True)
+        self.assertEqual(input, torch.bincount(index, minlength=100).to(dtype))
+
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_index_add_scatter_add_sorted(self, device, dtype):
+        # Many values per row and deterministic mode sort the indices instead
+        # of accumulating atomically; compare against the CPU results.
+        index = torch.randint(8, (4096,), device=device)
+        src = torch.randn(4096, 3, 5, device=device, dtype=dtype)
+        out = torch.zeros(8, 3, 5, device=device, dtype=dtype).index_add_(0, index, src)
+        expected = torch.zeros(8, 3, 5, dtype=torch.double).index_add_(0, index.cpu(), src.cpu().double())
+        self.assertEqual(out.double(), expected, atol=1e-1 if dtype == torch.half else 1e-5, rtol=1e-3)
+
+        out = torch.zeros(3, 8, 5, device=device, dtype=dtype).index_add_(1, index, src.transpose(0, 1))
+        self.assertEqual(out.double(), expected.transpose(0, 1), atol=1e-1 if dtype == torch.half else 1e-5, rtol=1e-3)
+
+        scatter_index = torch.randint(4, (512, 3), device=device)
+        scatter_src = torch.randn(512, 5, device=device, dtype=dtype)
+        out = torch.zeros(4, 3, device=device, dtype=dtype).scatter_add_(0, scatter_index, scatter_src)
+        expected = torch.zeros(4, 3, dtype=torch.double).scatter_add_(0, scatter_index.cpu(), scatter_src.cpu().double())
+        self.assertEqual(out.double(), expected, atol=1e-1 if dtype == torch.half else 1e-5, rtol=1e-3)
+
+        with self.assertRaises(IndexError):
+            torch.zeros(4, 3, device=device, dtype=dtype).scatter_add_(0, scatter_index + 4, scatter_src)
+
+        was_deterministic = torch.is_deterministic()
+        try:
+            torch.set_deterministic(True)
+            index = torch.randint(1000, (1000,), device=device)
+            src = torch.randn(1000, 7, device=device, dtype=dtype)
+            first = torch.zeros(1000, 7, device=device, dtype=dtype).index_add_(0, index, src)
+            for _ in range(3):
+                self.assertEqual(torch.zeros(1000, 7, device=device, dtype=dtype).index_add_(0, index, src),
+                                 first, atol=0, rtol=0)
+            scatter_index = torch.randint(1000, (1000, 7), device=device)
+            first = torch.zeros(1000, 7, device=device, dtype=dtype).scatter_add_(0, scatter_index, src)
+            for _ in range(3):
+                self.assertEqual(torch.zeros(1000, 7, device=device, dtype=dtype).scatter_add_(0, scatter_index, src),
+                                 first, atol=0, rtol=0)
+        finally:
+            torch.set_deterministic(was_deterministic)
+
     @onlyCPU
     def test_scatter_reduce_non_unique_index(self, device):
         height = 2
@@ -14740,6 +15152,50 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(val, expected_val, atol=0, rtol=0)
         self.assertEqual(ind, expected_ind, atol=0, rtol=0)
 
+    @dtypes(torch.float, torch.int64)
+    def test_sort_topk_large_slice(self, device, dtype):
+        # large slices are sorted, and their top k selected, in parallel chunks
+        x = torch.randperm(300000, device=device).to(dtype)
+        if dtype.is_floating_point:
+            x[1000] = float('nan')
+        for descending in (False, True):
+            val, idx = x.sort(descending=descending)
+            self.assertEqual(x[idx], val, atol=0, rtol=0)
+            self.assertEqual(idx.sort()[0], torch.arange(x.numel(), device=device))
+            finite = val
+            if dtype.is_floating_point:
+                # NaN goes last when ascending and first when descending
+                self.assertTrue(torch.isnan(val[0] if descending else val[-1]))
+                finite = val[1:] if descending else val[:-1]
+            diff = finite[1:] - finite[:-1]
+            self.assertTrue((diff <= 0).all() if descending else (diff >= 0).all())
+        expected = x.sort(descending=True)[0][:10]
+        val, idx = x.topk(10)
+        self.assertEqual(val, expected, atol=0, rtol=0)
+        self.assertEqual(x[idx], expected, atol=0, rtol=0)
+
+    @dtypesIfCUDA(torch.half, torch.float, torch.double, torch.int64)
+    @dtypes(torch.float, torch.double, torch.int64)
+    def test_sort_topk_small_slices(self, device, dtype):
+        # many small slices are sorted by warps, several slices per block
+        for slice_size in (2, 5, 8, 13, 32):
+            x = torch.randn(1000, slice_size, device=device).mul(100).to(dtype)
+            if dtype.is_floating_point:
+                x[::7, 0] = float('nan')
+            for dim in (-1, 0):
+                t = x if dim == -1 else x.t()
+                for descending in (False, True):
+                    val, idx = t.sort(dim=dim, descending=descending)
+                    expected = t.cpu().double().sort(dim=dim, descending=descending)[0]
+                    self.assertEqual(val, expected.to(dtype), atol=0, rtol=0)
+                    self.assertEqual(t.gather(dim, idx), val, atol=0, rtol=0)
+        # the top k of large slices are sorted in place for a small k
+        x = torch.randn(100, 5000, device=device).mul(100).to(dtype)
+        for k in (1, 7, 32):
+            val, idx = x.topk(k)
+            self.assertEqual(val, x.sort(descending=True)[0][:, :k], atol=0, rtol=0)
+            self.assertEqual(x.gather(-1, idx), val, atol=0, rtol=0)
+
 
 
 
@@ -15194,6 +15650,115 @@ class TestTorchDeviceType(TestCase):
             self._test_unique_with_expects(device, dtype, f, x, expected_unique, expected_inverse, expected_counts, (3, 3))
             self._test_unique_scalar_empty(dtype, device, f)
 
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_segment_reduce(self, device, dtype):
+        data = torch.randn(10, 3, 2, device=device, dtype=dtype)
+        lengths = torch.tensor([3, 0, 5, 2], device=device)
+        offsets = torch.tensor([0, 3, 3, 8], device=device)
+        starts = [0, 3, 3, 8]
+        for reduce in ('sum', 'mean', 'max'):
+            expected = []
+            for start, length in zip(starts, lengths.tolist()):
+                segment = data[start:start + length]
+                if length == 0:
+                    value = {'sum': 0., 'mean': nan, 'max': -inf}[reduce]
+                    expected.append(torch.full((3, 2), value, device=device, dtype=dtype))
+                elif reduce == 'max':
+                    expected.append(segment.max(0)[0])
+                else:
+                    expected.append(getattr(segment, reduce)(0))
+            expected = torch.stack(expected)
+            atol = 1e-3 if dtype == torch.half else None
+            rtol = 1e-3 if dtype == torch.half else None
+            self.assertEqual(torch.segment_reduce(data, reduce, lengths=lengths), expected, atol=atol, rtol=rtol)
+            self.assertEqual(torch.segment_reduce(data, reduce, offsets=offsets), expected, atol=atol, rtol=rtol)
+
+            if dtype == torch.double:
+                # empty segments are constant inf or NaN, which gradcheck can't compare
+                nonempty_lengths = torch.tensor([3, 5, 2], device=device)
+                self.assertTrue(torch.autograd.gradcheck(
+                    lambda x: torch.segment_reduce(x, reduce, lengths=nonempty_lengths),
+                    (data.clone().requires_grad_(),)))
+
+        with self.assertRaisesRegex(RuntimeError, "cover the 10 rows"):
+            torch.segment_reduce(data, 'sum', lengths=torch.tensor([3, 3], device=device))
+        with self.assertRaisesRegex(RuntimeError, "reduce argument"):
+            torch.segment_reduce(data, 'min', lengths=lengths)
+        with self.assertRaisesRegex(RuntimeError, "exactly one of lengths or offsets"):
+            torch.segment_reduce(data, 'sum')
+
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_foreach_add_mul(self, device, dtype):
+        # more tensors and chunks than a single multi tensor apply launch
+        # covers, some of them empty or not aligned for vectorized accesses
+        sizes = [(3,), (0,), (70000,), (5, 7)] * 40
+        tensors1 = [torch.randn(size, device=device, dtype=dtype) for size in sizes]
+        tensors2 = [torch.randn(size, device=device, dtype=dtype) for size in sizes]
+        tensors1.append(torch.randn(9, device=device, dtype=dtype)[1:])
+        tensors2.append(torch.randn(8, device=device, dtype=dtype))
+
+        self.assertEqual(torch._foreach_add(tensors1, 2), [t + 2 for t in tensors1])
+        self.assertEqual(torch._foreach_mul(tensors1, 2), [t * 2 for t in tensors1])
+        self.assertEqual(torch._foreach_add(tensors1, tensors2, alpha=3),
+                         [t1 + 3 * t2 for t1, t2 in zip(tensors1, tensors2)])
+        self.assertEqual(torch._foreach_mul(tensors1, tensors2),
+                         [t1 * t2 for t1, t2 in zip(tensors1, tensors2)])
+
+        expected = [(t1 + 2) * t2 for t1, t2 in zip(tensors1, tensors2)]
+        torch._foreach_add_(tensors1, 2)
+        torch._foreach_mul_(tensors1, tensors2)
+        self.assertEqual(tensors1, expected)
+
+        with self.assertRaisesRegex(RuntimeError, "same number of tensors"):
+            torch._foreach_add(tensors1, tensors2[:-1])
+
+    @dtypes(torch.float, torch.double)
+    def test_fused_optimizer_steps(self, device, dtype):
+        def make():
+            return [torch.randn(size, device=device, dtype=dtype) for size in [(3,), (70000,), (5, 7)]]
+
+        params, grads, exp_avgs = make(), make(), make()
+        exp_avg_sqs = [t.abs() for t in make()]
+        ref_params = [p.clone() for p in params]
+        for p, g, m, v in zip(ref_params, grads, [m.clone() for m in exp_avgs], [v.clone() for v in exp_avg_sqs]):
+            g = g + 0.1 * p
+            m.mul_(0.9).add_(g, alpha=0.1)
+            v.mul_(0.99).addcmul_(g, g, value=0.01)
+            denom = v.sqrt() / math.sqrt(1 - 0.99 ** 3) + 1e-8
+            p.addcdiv_(m, denom, value=-0.01 / (1 - 0.9 ** 3))
+        torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, 0.01, 0.9, 0.99, 1e-8, 0.1, 3)
+        self.assertEqual(params, ref_params)
+
+        for nesterov in (False, True):
+            params, grads, bufs = make(), make(), make()
+            ref_params = [p.clone() for p in params]
+            ref_bufs = [b.clone() for b in bufs]
+            for p, g, b in zip(ref_params, grads, ref_bufs):
+                g = g + 0.1 * p
+                b.mul_(0.9).add_(g, alpha=0.8)
+                p.add_(g + 0.9 * b if nesterov else b, alpha=-0.01)
+            torch._fused_sgd_(params, grads, bufs, 0.01, 0.9, 0.2, 0.1, nesterov)
+            self.assertEqual(params, ref_params)
+            self.assertEqual(bufs, ref_bufs)
+
+    @dtypes(torch.int64, torch.float)
+    def test_unique_large(self, device, dtype):
+        # large inputs are deduplicated in parallel chunks
+        x = torch.randint(1000, (200000,), device=device).to(dtype)
+        unique, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+        self.assertEqual(unique, torch.arange(1000, device=device, dtype=dtype))
+        self.assertEqual(unique[inverse], x)
+        self.assertEqual(counts, torch.stack([(x == v).sum() for v in unique]))
+
+        y = x.sort()[0]
+        unique, inverse, counts = torch.unique_consecutive(y, return_inverse=True, return_counts=True)
+        self.assertEqual(unique, torch.arange(1000, device=device, dtype=dtype))
+        self.assertEqual(unique[inverse], y)
+        self.assertEqual(counts.sum(), y.numel())
+        self.assertEqual(counts.cumsum(0)[:-1], (y[1:] != y[:-1]).nonzero().view(-1) + 1)
+
     @dtypesIfCUDA(torch.half, torch.float, torch.double)
     @dtypes(torch.float, torch.double)
     def test_erfinv(self, device, dtype):
@@ -15252,6 +15817,29 @@ class TestTorchDeviceType(TestCase):
         z = from_dlpack(to_dlpack(x))
         self.assertEqual(z, x)
 
+    def test_dlpack_protocol(self, device):
+        x = torch.randn(1, 2, 3, 4, device=device, dtype=torch.float)
+        device_type, device_id = x.__dlpack_device__()
+        self.assertEqual(device_type, 2 if x.is_cuda else 1)
+        self.assertEqual(device_id, x.device.index if x.is_cuda else 0)
+        z = from_dlpack(x)
+        self.assertEqual(z, x)
+        self.assertEqual(z.data_ptr(), x.data_ptr())
+
+    @onlyCUDA
+    def test_dlpack_protocol_stream(self, device):
+        # The consumer stream only sees the data after the producer's kernels.
+        producer = torch.cuda.Stream(device)
+        consumer = torch.cuda.Stream(device)
+        with torch.cuda.stream(producer):
+            x = torch.zeros(1 << 20, device=device)
+            torch.cuda._sleep(1 << 24)
+            x.fill_(1)
+            capsule = x.__dlpack__(stream=consumer.cuda_stream)
+        with torch.cuda.stream(consumer):
+            z = from_dlpack(capsule)
+            self.assertEqual(z.sum().item(), x.numel())
+
     @onlyCUDA
     @unittest.skipIf(PYTORCH_CUDA_MEMCHECK, "is_pinned uses failure to detect pointer property")
     def test_pin_memory_from_constructor(self, device):
@@ -15749,6 +16337,86 @@ class TestTorchDeviceType(TestCase):
         else:
             check_sum_all(torch.tensor([True, False, True], dtype=torch.bool, device=device))
 
+    @onlyCPU
+    @dtypes(torch.half, torch.bfloat16)
+    def test_reduced_precision_accumulation(self, device, dtype):
+        # Half and BFloat16 are summed in float, so that a long sum or product
+        # only has the rounding error of its result
+        x = torch.full((100, 100), 0.1, dtype=dtype, device=device)
+        expected = x.float().sum()
+        self.assertEqual(x.sum().float(), expected, atol=0, rtol=1e-2)
+        self.assertEqual(x.sum(0).float(), x.float().sum(0), atol=0, rtol=1e-2)
+        self.assertEqual(x.t().sum(0).float(), x.float().t().sum(0), atol=0, rtol=1e-2)
+        if dtype == torch.half:
+            v = x.reshape(-1)
+            self.assertEqual(v.dot(v).float(), v.float().dot(v.float()), atol=0, rtol=1e-2)
+        else:
+            self.assertEqual(x.mv(x[0]).float(), x.float().mv(x[0].float()), atol=0, rtol=1e-2)
+
+        # The vectorized conversions round like the scalar ones
+        values = torch.randn(1000, device=device)
+        values[10] = float('nan')
+        values[11] = float('inf')
+        values[12] = 1e-6
+        converted = values.to(dtype)
+        self.assertEqual(converted, torch.tensor(values.tolist(), dtype=dtype, device=device))
+        self.assertEqual(converted.float().tolist(), converted.tolist())
+
+    @onlyCPU
+    @dtypes(torch.bfloat16)
+    def test_bfloat16_matmul_accumulation(self, device, dtype):
+        # BFloat16 products accumulate in float, so that products of small
+        # integers, whose float sums are exact, round once to their BFloat16 value
+        def small_ints(*size):
+            return torch.randint(-4, 5, size, device=device).to(dtype)
+
+        a, b, c = small_ints(17, 300), small_ints(300, 19), small_ints(17, 19)
+        expected = (a.float() @ b.float()).to(dtype)
+        self.assertEqual(a.mm(b), expected, atol=0, rtol=0)
+        self.assertEqual(torch.addmm(c, a, b, beta=0), expected, atol=0, rtol=0)
+        expected = (c.float() * 2 + (a.float() @ b.float()) * 3).to(dtype)
+        self.assertEqual(torch.addmm(c, a, b, beta=2, alpha=3), expected, atol=0, rtol=0)
+        self.assertEqual(c.clone().addmm_(a, b, beta=2, alpha=3), expected, atol=0, rtol=0)
+        out = torch.empty(19, 17, dtype=dtype, device=device).t()
+        torch.addmm(c, a, b, beta=2, alpha=3, out=out)
+        self.assertEqual(out, expected, atol=0, rtol=0)
+
+        batch1, batch2 = small_ints(3, 17, 300), small_ints(3, 19, 300).transpose(1, 2)
+        expected = torch.bmm(batch1.float(), batch2.float()).to(dtype)
+        self.assertEqual(torch.bmm(batch1, batch2), expected, atol=0, rtol=0)
+        batch_c = small_ints(3, 17, 19)
+        expected = (batch_c.float() + torch.bmm(batch1.float(), batch2.float()) * 2).to(dtype)
+        self.assertEqual(torch.baddbmm(batch_c, batch1, batch2, alpha=2), expected, atol=0, rtol=0)
+
+    @onlyCPU
+    @dtypes(torch.complex64, torch.complex128)
+    def test_complex_vectorized_ops(self, device, dtype):
+        # Long enough for the vectorized loops and their scalar tails
+        x = torch.randn(1003, dtype=dtype, device=device)
+        y = torch.randn(1003, dtype=dtype, device=device)
+        x_np, y_np = x.numpy(), y.numpy()
+
+        self.assertEqual(torch._mul_conj(x, y), x_np * np.conj(y_np))
+        self.assertEqual(torch._mul_conj(x, y[0]), x_np * np.conj(y_np[0]))
+        self.assertEqual(x.log(), np.log(x_np))
+        self.assertEqual(x.abs(), np.abs(x_np))
+        self.assertEqual(x.angle(), np.angle(x_np))
+        # The strided inputs take the scalar loops
+        self.assertEqual(x[::2].abs(), np.abs(x_np[::2]))
+        self.assertEqual(x[::2].angle(), np.angle(x_np[::2]))
+        out = torch.empty(0, dtype=torch.double, device=device)
+        self.assertEqual(torch.abs(x, out=out), np.abs(x_np))
+
+        x.requires_grad_()
+        y.requires_grad_()
+        grad = torch.randn_like(x)
+        torch._mul_conj(x, y).backward(grad)
+        x_grad, y_grad = x.grad, y.grad
+        x.grad = y.grad = None
+        (x * y.conj()).backward(grad)
+        self.assertEqual(x_grad, x.grad)
+        self.assertEqual(y_grad, y.grad)
+
     def _test_memory_format_transformations(self, device, input_generator_fn, transformation_fn,
                                             memory_format, compare_data=True, default_is_preserve=False):
 
@@ -17817,6 +18485,27 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
         t_copy.abs_()
         self.assertEqual(t, t_copy)
 
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    @dtypes(torch.float, torch.double, torch.int)
+    def test_bucketization_against_np(self, device, dtype):
+        # small boundaries take the branchless search on CPU, large ones don't
+        for n in [1, 7, 1024, 5000]:
+            boundaries = torch.randint(-100, 100, (n,), device=device).sort()[0].to(dtype)
+            values = torch.randint(-110, 110, (20, 500), device=device).to(dtype)
+            for right in [False, True]:
+                expected = np.searchsorted(boundaries.cpu().numpy(), values.cpu().numpy(),
+                                           side='right' if right else 'left')
+                self.assertEqual(torch.bucketize(values, boundaries, right=right).cpu(),
+                                 torch.from_numpy(expected))
+                self.assertEqual(torch.bucketize(values, boundaries, right=right, out_int32=True).cpu(),
+                                 torch.from_numpy(expected).int())
+            # one sorted sequence per row of values
+            boundaries_2d = torch.randint(-100, 100, (20, n), device=device).sort()[0].to(dtype)
+            actual = torch.searchsorted(boundaries_2d, values).cpu()
+            for i in range(20):
+                expected = np.searchsorted(boundaries_2d[i].cpu().numpy(), values[i].cpu().numpy())
+                self.assertEqual(actual[i], torch.from_numpy(expected))
+
     def test_bucketization(self, device):
         values_1d = torch.tensor([1, 2, 3, 4, 5, 6, 7, 8, 9], device=device)
         values_3d = torch.tensor([[[1, 3, 5], [2, 4, 6]], [[1, 2, 3], [4, 5, 6]]], device=device)
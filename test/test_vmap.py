@@ -116,13 +116,30 @@ class TestVmapAPI(TestCase):
         self.assertEqual(output, x.view(3, 1).expand(3, 5))
 
     def test_unsupported_op_err_msg(self):
+        # Operators without a batching rule run through the for-loop fallback,
+        # which doesn't support view operations.
         def foo(x):
-            return torch.cos(x)
+            return x.as_strided([2], [1])
 
-        x = torch.randn(3)
-        with self.assertRaisesRegex(RuntimeError, 'NYI: Calling aten::cos inside of vmap'):
+        x = torch.randn(3, 3)
+        with self.assertRaisesRegex(RuntimeError, 'Batching rule not implemented for aten::as_strided'):
             vmap(foo)(x)
 
+    def test_fallback(self):
+        x = torch.randn(5, 3)
+        y = torch.randn(7, 3)
+        # aten::cumsum has no batching rule
+        self.assertEqual(vmap(lambda x: torch.cumsum(x, 0))(x), torch.cumsum(x, 1))
+        self.assertEqual(vmap(lambda x: torch.cumsum(x, -1), in_dims=(1,))(x),
+                         torch.cumsum(x.t(), 1))
+        # multiple BatchedTensors with different levels
+        output = vmap(lambda x: vmap(lambda y: torch.dist(x, y))(y))(x)
+        expected = torch.stack([torch.stack([torch.dist(a, b) for b in y]) for a in x])
+        self.assertEqual(output, expected)
+        # BatchedTensor and regular Tensor
+        output = vmap(torch.lerp, in_dims=(0, None, None))(x, y[0], torch.tensor(0.3))
+        self.assertEqual(output, torch.lerp(x, y[0], torch.tensor(0.3)))
+
     def test_unsupported_inplace_op_err_msg(self):
         def foo(x):
             return x.cos_()
@@ -433,5 +450,125 @@ class TestVmapAPI(TestCase):
         vmap(foo, in_dims=(0,))(torch.randn(2, 3))
         vmap(foo, in_dims=(1,))(torch.randn(2, 3))
 
+
+class TestVmapOperators(TestCase):
+    def _vmap_test(self, op, inputs, in_dims=0):
+        # Compares vmap(op) against running op on each example. in_dims is an
+        # int or one int/None per input.
+        if not isinstance(in_dims, tuple):
+            in_dims = (in_dims,) * len(inputs)
+        batch_size = [x.size(d) for x, d in zip(inputs, in_dims) if d is not None][0]
+        expected = []
+        for b in range(batch_size):
+            examples = [x if d is None else x.select(d, b) for x, d in zip(inputs, in_dims)]
+            expected.append(op(*examples))
+        self.assertEqual(vmap(op, in_dims)(*inputs), torch.stack(expected))
+
+    def test_unary_pointwise(self):
+        x = torch.rand(4, 3, 2) + 0.5
+        for op in [torch.abs, torch.cos, torch.exp, torch.log, torch.neg, torch.relu,
+                   torch.sigmoid, torch.sin, torch.sqrt, torch.tanh, torch.trunc]:
+            self._vmap_test(op, [x])
+            self._vmap_test(op, [x], in_dims=2)
+        self._vmap_test(lambda x: torch.pow(x, 2), [x])
+        self._vmap_test(lambda x: x * 2.5, [x])
+        self._vmap_test(lambda x: x.add(1, alpha=2), [x], in_dims=1)
+
+    def test_binary_pointwise(self):
+        x = torch.randn(4, 3)
+        y = torch.randn(4, 3)
+        for op in [torch.add, torch.sub, torch.mul, torch.div, torch.atan2]:
+            self._vmap_test(op, [x, y])
+            self._vmap_test(op, [x, y], in_dims=(0, 1))
+            self._vmap_test(op, [x, y[0]], in_dims=(0, None))
+            self._vmap_test(op, [x[0], y], in_dims=(None, 0))
+            # broadcasting between the logical shapes
+            self._vmap_test(op, [x, torch.randn(2, 4, 3)], in_dims=(0, 1))
+        self._vmap_test(lambda x, y: torch.add(x, y, alpha=3), [x, y])
+
+        # a Python number stays a wrapped number and doesn't promote the dtype
+        self.assertEqual(vmap(lambda x: x * 2.)(x.float()).dtype, torch.float)
+
+    def test_reductions(self):
+        x = torch.randn(4, 3, 5)
+        for op in [torch.sum, torch.mean]:
+            self._vmap_test(op, [x])
+            self._vmap_test(lambda x: op(x, 1), [x], in_dims=2)
+            self._vmap_test(lambda x: op(x, [0, 1], keepdim=True), [x])
+            self._vmap_test(lambda x: op(x, -1, dtype=torch.double), [x])
+            # reducing a (logical) scalar
+            self._vmap_test(op, [torch.randn(4)])
+            self._vmap_test(lambda x: op(x, 0), [torch.randn(4)])
+        self.assertEqual(vmap(torch.sum)(torch.ones(4, 3, dtype=torch.int)).dtype, torch.long)
+
+    def test_view_ops(self):
+        x = torch.randn(4, 3, 6)
+        self._vmap_test(lambda x: x.view(2, 9), [x])
+        self._vmap_test(lambda x: x.view(-1), [x], in_dims=1)
+        self._vmap_test(lambda x: x.reshape(9, 2), [x], in_dims=2)
+        self._vmap_test(lambda x: x.select(1, 2), [x])
+        self._vmap_test(lambda x: x[:, 1:5:2], [x])
+        self._vmap_test(lambda x: x.narrow(0, 1, 2), [x], in_dims=1)
+        self._vmap_test(lambda x: x.t(), [x], in_dims=2)
+        self._vmap_test(lambda x: x.flatten(), [x], in_dims=1)
+        self._vmap_test(lambda x: x.diagonal(0, 0, 1), [x])
+        self._vmap_test(lambda x: x.unfold(1, 2, 2), [x])
+        self._vmap_test(lambda x: x.unsqueeze(1).squeeze(), [x])
+        for op in [lambda x: torch.unbind(x, 1), lambda x: x.split(2, -1), lambda x: x.chunk(3)]:
+            outputs = vmap(op)(x)
+            expected = op(x[0])
+            self.assertEqual(len(outputs), len(expected))
+            for i, output in enumerate(outputs):
+                self.assertEqual(output, torch.stack([op(example)[i] for example in x]))
+
+    def test_squeeze_keeps_batch_dims(self):
+        x = torch.randn(1, 3, 1)
+        self.assertEqual(vmap(torch.squeeze)(x), x.view(1, 3))
+
+    def test_matmul(self):
+        B = 5
+        for self_shape, other_shape in [((3,), (3,)), ((2, 3), (3,)), ((3,), (3, 4)),
+                                        ((2, 3), (3, 4)), ((6, 2, 3), (3, 4)),
+                                        ((3,), (6, 3, 4)), ((6, 2, 3), (6, 3, 4)),
+                                        ((6, 2, 3), (3,)), ((1, 2, 3), (6, 3, 4))]:
+            x = torch.randn(B, *self_shape)
+            y = torch.randn(B, *other_shape)
+            self._vmap_test(torch.matmul, [x, y])
+            self._vmap_test(torch.matmul, [x, y[0]], in_dims=(0, None))
+            self._vmap_test(torch.matmul, [x[0], y], in_dims=(None, 0))
+
+        x = torch.randn(B, 2, 3)
+        y = torch.randn(B, 3, 4)
+        self._vmap_test(torch.mm, [x, y])
+        self._vmap_test(torch.mm, [x, y[0]], in_dims=(0, None))
+        self._vmap_test(torch.mv, [x, torch.randn(B, 3)])
+        self._vmap_test(torch.dot, [torch.randn(B, 3), torch.randn(3, B)], in_dims=(0, 1))
+        self._vmap_test(torch.bmm, [torch.randn(B, 6, 2, 3), torch.randn(6, 3, 4)], in_dims=(0, None))
+        with self.assertRaisesRegex(RuntimeError, 'mm: expected two matrices'):
+            vmap(torch.mm)(torch.randn(B, 3), y)
+
+        # nested vmaps, e.g. all pairs of examples
+        x = torch.randn(4, 3)
+        y = torch.randn(6, 3)
+        output = vmap(lambda a: vmap(lambda b: torch.dot(a, b))(y))(x)
+        self.assertEqual(output, x @ y.t())
+
+    def test_conv2d(self):
+        x = torch.randn(4, 2, 3, 7, 7)
+        weight = torch.randn(6, 3, 3, 3)
+        bias = torch.randn(6)
+        # per-example inputs, shared parameters
+        self._vmap_test(lambda x: torch.conv2d(x, weight, bias, padding=1), [x])
+        self._vmap_test(lambda x: torch.conv2d(x, weight[:, :1], groups=3), [x], in_dims=1)
+        # batched parameters
+        weights = torch.randn(4, 6, 3, 3, 3)
+        biases = torch.randn(4, 6)
+        self._vmap_test(lambda x, w, b: torch.conv2d(x, w, b, stride=2), [x, weights, biases])
+        self._vmap_test(lambda x, w: torch.conv2d(x, w), [x[0], weights], in_dims=(None, 0))
+        self._vmap_test(lambda x, w, b: torch.conv2d(x, w, b), [x[0], weight, biases],
+                        in_dims=(None, None, 0))
+        self._vmap_test(lambda x, w: torch.conv2d(x, w, groups=3), [x, weights[:, :, :1]])
+
+
 if __name__ == '__main__':
     run_tests()
@@ -602,7 +602,7 @@ Tensor clamp_backward(const Tensor & grad, const Tensor &self, const optional<Sc
 
 Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, const Tensor & mat1, const Scalar & alpha) {
   // if input was column-major, return grad as column-order for efficiency
-  if (mat1.is_sparse()) {
+  if (mat1.is_sparse() || mat1.is_sparse_csr()) {
     throw std::runtime_error("calculating the gradient of a sparse Tensor argument to mm is not supported.");
   }
   at::IntArrayRef sizes = mat1.sizes();
@@ -614,7 +614,9 @@ Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, const Tensor &
   }
 }
 
-Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef sizes, IntArrayRef strides, const Scalar & alpha) {
+Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1_, IntArrayRef sizes, IntArrayRef strides, const Scalar & alpha) {
+  // sparse CSR matrices can't be transposed, so they go through the COO kernels
+  const Tensor mat1 = mat1_.is_sparse_csr() ? mat1_.to_sparse() : mat1_;
   // if input was column-major, return grad as column-order for efficiency
   if (strides[0] == 1 && strides[1] == sizes[0]) {
     if (mat1.is_sparse()) {
@@ -1129,6 +1131,46 @@ Tensor soft_margin_loss_double_backward_grad_output(const Tensor & grad, const T
   return (r * grad).sum();
 }
 
+// s[i] * A[i] of Note [Fused cross entropy] as an (N, 1) tensor, s being the
+// gradient of the unreduced loss of row i.
+static Tensor fused_cross_entropy_scaled_mass(const Tensor & grad_output, const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index, double label_smoothing) {
+  const auto n_classes = self.size(1);
+  auto valid = target.ne(ignore_index).to(self.scalar_type());
+  auto target_weight = valid;
+  auto smooth_mass = valid * n_classes;
+  if (weight.defined()) {
+    target_weight = weight.index_select(0, target.masked_fill(target.eq(ignore_index), 0)) * valid;
+    smooth_mass = valid * weight.sum();
+  }
+  auto mass = (1 - label_smoothing) * target_weight + label_smoothing / n_classes * smooth_mass;
+  Tensor scale;
+  if (reduction == at::Reduction::None) {
+    scale = grad_output.reshape({-1});
+  } else {
+    scale = grad_output.reshape({});
+    if (reduction == at::Reduction::Mean) {
+      auto total_weight = target_weight.sum();
+      scale = scale / (target.numel() > 0 ? total_weight.masked_fill(total_weight.eq(0), 1) : total_weight);
+    }
+  }
+  return (scale * mass).unsqueeze(1);
+}
+
+Tensor fused_cross_entropy_double_backward(const Tensor & grad, const Tensor & grad_output, const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index, double label_smoothing) {
+  // grad_input = s * (A * softmax(self) - a), where only softmax depends on self
+  auto probs = at::softmax(self, 1);
+  auto scaled_mass = fused_cross_entropy_scaled_mass(grad_output, self, target, weight, reduction, ignore_index, label_smoothing);
+  return scaled_mass * probs * (grad - (grad * probs).sum(1, true));
+}
+
+Tensor fused_cross_entropy_double_backward_grad_output(const Tensor & grad, const Tensor & grad_output, const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index, double label_smoothing, const Tensor & logsumexp) {
+  auto r = at::_fused_cross_entropy_backward(ones_like(grad_output), self, target, weight, reduction, ignore_index, label_smoothing, logsumexp);
+  if (reduction == at::Reduction::None) {
+    return (r * grad).sum(1);
+  }
+  return (r * grad).sum();
+}
+
 Tensor softplus_double_backward(const Tensor & grad, const Tensor & input, Scalar beta, Scalar threshold) {
   auto x = (input * beta);
   return sigmoid_backward(grad, x.sigmoid()) * (x < threshold).type_as(grad) * beta;
@@ -2698,6 +2740,24 @@ Tensor sparse_constructor_values_backward(const Tensor& sparse_grad_out, const T
   return flattened_dense_grad.index_select(0, flattened_indices);
 }
 
+Tensor sparse_csr_constructor_values_backward(const Tensor& grad, const Tensor& crow_indices, const Tensor& col_indices) {
+  auto dense_grad = grad.layout() == c10::kStrided ? grad : grad.to_dense();
+  // row of every stored element, as csr_row_indices in native/sparse/SparseCsrTensor.cpp computes it
+  auto rows = at::searchsorted(
+      crow_indices.narrow(0, 1, crow_indices.numel() - 1),
+      at::arange(col_indices.numel(), col_indices.options()),
+      /*out_int32=*/false,
+      /*right=*/true);
+  return at::index(dense_grad, {rows, col_indices});
+}
+
+Tensor values_backward(const Tensor& grad, const Tensor& self) {
+  if (self.is_sparse_csr()) {
+    return at::sparse_csr_tensor(self.crow_indices(), self.col_indices(), grad, self.sizes());
+  }
+  return at::_sparse_coo_tensor_unsafe(self.indices(), grad, self.sizes())._coalesced_(true);
+}
+
 // Because the backward of pad(input, pads) is just pad(grad_output, [-p for p in pads])
 Tensor constant_pad_nd_backward(const Tensor& grad, IntArrayRef pad) {
   auto negated_pad = pad.vec();
@@ -396,11 +396,18 @@ static PyObject * THPVariable_as_tensor(PyObject* self, PyObject* args, PyObject
 
 // implemented on python object here because PyObject currently not natively declarable
 // See: ATen/native/README.md for more context
-static PyObject * THPVariable_from_numpy(PyObject* module, PyObject* arg)
+static PyObject * THPVariable_from_numpy(PyObject* module, PyObject* args, PyObject* kwargs)
 {
   HANDLE_TH_ERRORS
+  static PythonArgParser parser({
+    "from_numpy(PyObject* ndarray, *, bool copy_if_needed=False, bool pin_memory=False)",
+  }, /*traceable=*/false);
+
+  ParsedArgs<3> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
   jit::tracer::warn("torch.from_numpy", jit::tracer::WARN_CONSTRUCTOR);
-  return THPVariable_Wrap(torch::utils::tensor_from_numpy(arg));
+  return THPVariable_Wrap(torch::utils::tensor_from_numpy(
+      r.pyobject(0), /*copy_if_needed=*/r.toBool(1), /*pin_memory=*/r.toBool(2)));
   END_HANDLE_TH_ERRORS
 }
 
@@ -493,7 +500,7 @@ static PyMethodDef torch_functions[] = {
   {"arange", (PyCFunction)(void(*)(void))THPVariable_arange, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
   {"as_tensor", (PyCFunction)(void(*)(void))THPVariable_as_tensor, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
   {"dsmm", (PyCFunction)(void(*)(void))THPVariable_mm, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
-  {"from_numpy", (PyCFunction)THPVariable_from_numpy, METH_STATIC | METH_O, NULL},
+  {"from_numpy", (PyCFunction)(void(*)(void))THPVariable_from_numpy, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
   {"full", (PyCFunction)(void(*)(void))THPVariable_full, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
   {"hsmm", (PyCFunction)(void(*)(void))THPVariable_hspmm, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
   {"nonzero", (PyCFunction)(void(*)(void))THPVariable_nonzero, METH_VARARGS | METH_KEYWORDS | METH_STATIC, NULL},
@@ -86,6 +86,7 @@ jit_core_sources = [
 
 core_sources_common = [
     "torch/csrc/autograd/profiler.cpp",
+    "torch/csrc/autograd/profiler_perf.cpp",
     "torch/csrc/jit/frontend/edit_distance.cpp",
     "torch/csrc/jit/frontend/string_to_type.cpp",
     "torch/csrc/jit/mobile/type_parser.cpp",
@@ -121,6 +122,7 @@ core_sources_full = [
     "torch/csrc/autograd/input_buffer.cpp",
     "torch/csrc/autograd/record_function_ops.cpp",
     "torch/csrc/autograd/saved_variable.cpp",
+    "torch/csrc/autograd/saved_variable_hooks.cpp",
     "torch/csrc/autograd/variable.cpp",
     "torch/csrc/jit/api/function_impl.cpp",
     "torch/csrc/jit/api/module.cpp",
@@ -136,6 +138,7 @@ core_sources_full = [
     "torch/csrc/jit/frontend/builtin_functions.cpp",
     "torch/csrc/jit/frontend/versioned_symbols.cpp",
     "torch/csrc/jit/frontend/canonicalize_modified_loop.cpp",
+    "torch/csrc/jit/frontend/compilation_cache.cpp",
     "torch/csrc/jit/frontend/convert_to_ssa.cpp",
     "torch/csrc/jit/frontend/exit_transforms.cpp",
     "torch/csrc/jit/frontend/inline_loop_condition.cpp",
@@ -171,6 +174,9 @@ core_sources_full = [
     "torch/csrc/jit/passes/erase_number_types.cpp",
     "torch/csrc/jit/passes/fixup_trace_scope_blocks.cpp",
     "torch/csrc/jit/passes/freeze_module.cpp",
+    "torch/csrc/jit/passes/frozen_epilogue_fusion.cpp",
+    "torch/csrc/jit/passes/frozen_ops_to_mkldnn.cpp",
+    "torch/csrc/jit/passes/frozen_weight_prepacking.cpp",
     "torch/csrc/jit/passes/fuse_linear.cpp",
     "torch/csrc/jit/passes/fuse_relu.cpp",
     "torch/csrc/jit/passes/graph_fuser.cpp",
@@ -183,6 +189,7 @@ core_sources_full = [
     "torch/csrc/jit/passes/insert_guards.cpp",
     "torch/csrc/jit/passes/lift_closures.cpp",
     "torch/csrc/jit/passes/liveness.cpp",
+    "torch/csrc/jit/passes/memory_planning.cpp",
     "torch/csrc/jit/passes/loop_unrolling.cpp",
     "torch/csrc/jit/passes/lower_grad_of.cpp",
     "torch/csrc/jit/passes/lower_tuples.cpp",
@@ -220,6 +227,8 @@ core_sources_full = [
     "torch/csrc/jit/runtime/logging.cpp",
     "torch/csrc/jit/runtime/profiling_graph_executor_impl.cpp",
     "torch/csrc/jit/runtime/profiling_record.cpp",
+    "torch/csrc/jit/runtime/static/impl.cpp",
+    "torch/csrc/jit/runtime/static/ops.cpp",
     "torch/csrc/jit/runtime/symbolic_script.cpp",
     "torch/csrc/jit/serialization/import.cpp",
     "torch/csrc/jit/serialization/import_export_helpers.cpp",
@@ -289,6 +298,7 @@ libtorch_distributed_sources = [
     "torch/csrc/distributed/rpc/torchscript_functions.cpp",
     "torch/csrc/distributed/rpc/types.cpp",
     "torch/csrc/distributed/rpc/utils.cpp",
+    "torch/csrc/distributed/rpc/metrics/latency_histogram.cpp",
     "torch/csrc/distributed/rpc/metrics/registry.cpp",
 ]
 
@@ -307,6 +317,14 @@ libtorch_core_jit_sources = sorted(jit_sources_common + jit_sources_full)
 
 libtorch_cmake_sources = libtorch_core_sources + libtorch_core_jit_sources
 
+# The NNAPI backend lowers on the host and loads NNAPI at runtime, so it is
+# built wherever the NNAPI headers compile rather than only for Android
+libtorch_nnapi_sources = [
+    "torch/csrc/jit/backends/nnapi/nnapi_backend.cpp",
+    "torch/csrc/jit/backends/nnapi/nnapi_compilation.cpp",
+    "torch/csrc/jit/backends/nnapi/nnapi_serializer.cpp",
+]
+
 libtorch_extra_sources = libtorch_core_jit_sources + [
     "torch/csrc/autograd/TraceTypeManual.cpp",
     "torch/csrc/autograd/VariableTypeManual.cpp",
@@ -325,7 +343,7 @@ libtorch_extra_sources = libtorch_core_jit_sources + [
 ]
 
 def libtorch_sources(gencode_pattern = ":generate-code[{}]"):
-    return libtorch_generated_sources(gencode_pattern) + libtorch_core_sources + libtorch_distributed_sources + libtorch_extra_sources
+    return libtorch_generated_sources(gencode_pattern) + libtorch_core_sources + libtorch_distributed_sources + libtorch_extra_sources + libtorch_nnapi_sources
 
 libtorch_cuda_sources = [
     "torch/csrc/cuda/comm.cpp",
@@ -361,6 +379,7 @@ libtorch_cuda_sources = [
     "torch/csrc/jit/codegen/cuda/parser.cpp",
     "torch/csrc/jit/codegen/cuda/partition.cpp",
     "torch/csrc/jit/codegen/cuda/predicate_compute.cpp",
+    "torch/csrc/jit/codegen/cuda/scheduler.cpp",
     "torch/csrc/jit/codegen/cuda/tensor_view.cpp",
     "torch/csrc/jit/codegen/cuda/transform_iter.cpp",
     "torch/csrc/jit/codegen/cuda/transform_replay.cpp",
@@ -429,6 +448,7 @@ torch_cpp_srcs = [
 
 libtorch_python_cuda_core_sources = [
     "torch/csrc/cuda/Event.cpp",
+    "torch/csrc/cuda/Graph.cpp",
     "torch/csrc/cuda/Module.cpp",
     "torch/csrc/cuda/python_comm.cpp",
     "torch/csrc/cuda/Storage.cpp",
@@ -524,8 +544,12 @@ libtorch_python_core_sources = [
 libtorch_python_distributed_sources = [
     "torch/csrc/distributed/autograd/init.cpp",
     "torch/csrc/distributed/c10d/comm.cpp",
+    "torch/csrc/distributed/c10d/default_comm_hooks.cpp",
     "torch/csrc/distributed/c10d/init.cpp",
+    "torch/csrc/distributed/c10d/python_comm_hook.cpp",
     "torch/csrc/distributed/c10d/reducer.cpp",
+    "torch/csrc/distributed/c10d/sharded_embedding_bag.cpp",
+    "torch/csrc/distributed/c10d/sharded_optimizer.cpp",
     "torch/csrc/distributed/rpc/init.cpp",
     "torch/csrc/distributed/rpc/process_group_agent.cpp",
     "torch/csrc/distributed/rpc/py_rref.cpp",
@@ -578,6 +602,7 @@ def glob_libtorch_python_sources(gencode_pattern = ":generate-code[{}]"):
         "test/cpp/jit/test_irparser.cpp",
         "test/cpp/jit/test_jit_type.cpp",
         "test/cpp/jit/test_lite_interpreter.cpp",
+        "test/cpp/jit/test_memory_planning.cpp",
         "test/cpp/jit/test_misc.cpp",
         "test/cpp/jit/test_mobile_type_parser.cpp",
         "test/cpp/jit/test_module_api.cpp",
@@ -585,6 +610,7 @@ def glob_libtorch_python_sources(gencode_pattern = ":generate-code[{}]"):
         "test/cpp/jit/test_qualified_name.cpp",
         "test/cpp/jit/test_save_load.cpp",
         "test/cpp/jit/test_schema_matching.cpp",
+        "test/cpp/jit/test_static_runtime.cpp",
         "test/cpp/jit/test_subgraph_matcher.cpp",
         "test/cpp/jit/test_subgraph_rewriter.cpp",
         "test/cpp/jit/test_subgraph_utils.cpp",
@@ -1375,6 +1375,29 @@ See also :meth:`Tensor.values`.
   :meth:`Tensor.coalesce` for details.
 """)
 
+add_docstr_all('crow_indices',
+               r"""
+crow_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of the contained row pointers: the stored elements of row
+``i`` are ``crow_indices[i]`` to ``crow_indices[i + 1] - 1``. Otherwise, this
+throws an error.
+
+See also :meth:`Tensor.col_indices` and :meth:`Tensor.values`.
+""")
+
+add_docstr_all('col_indices',
+               r"""
+col_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of the contained column indices of the stored elements.
+Otherwise, this throws an error.
+
+See also :meth:`Tensor.crow_indices` and :meth:`Tensor.values`.
+""")
+
 add_docstr_all('get_device',
                r"""
 get_device() -> Device ordinal (Integer)
@@ -1394,11 +1417,11 @@ add_docstr_all('values',
                r"""
 values() -> Tensor
 
-If :attr:`self` is a sparse COO tensor (i.e., with ``torch.sparse_coo`` layout),
-this returns a view of the contained values tensor. Otherwise, this throws an
-error.
+If :attr:`self` is a sparse COO tensor (i.e., with ``torch.sparse_coo`` layout)
+or a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout), this returns a
+view of the contained values tensor. Otherwise, this throws an error.
 
-See also :meth:`Tensor.indices`.
+See also :meth:`Tensor.indices` and :meth:`Tensor.crow_indices`.
 
 .. note::
   This method can only be called on a coalesced sparse tensor. See
@@ -1649,6 +1672,14 @@ Args:
         order. Default: ``torch.contiguous_format``.
 """)
 
+add_docstr_all('is_inference',
+               r"""
+is_inference() -> bool
+
+Returns True if :attr:`self` was created in :class:`torch.inference_mode`.
+Inference tensors have no version counter, so they can't be used in autograd.
+""")
+
 add_docstr_all('is_pinned',
                r"""
 Returns true if this tensor resides in pinned memory.
@@ -3269,6 +3300,23 @@ Example::
            size=(3, 3), nnz=1, layout=torch.sparse_coo)
 """)
 
+add_docstr_all('to_sparse_csr',
+               r"""
+to_sparse_csr() -> Tensor
+Returns a copy of the matrix in :ref:`compressed sparse row format <sparse-csr-docs>`.
+:attr:`self` must be a 2-dimensional strided tensor or a sparse COO matrix
+without dense dimensions.
+
+Example::
+
+    >>> d = torch.tensor([[0, 0, 0], [9, 0, 10], [0, 0, 0]])
+    >>> d.to_sparse_csr()
+    tensor(crow_indices=tensor([0, 0, 2, 2]),
+           col_indices=tensor([0, 2]),
+           values=tensor([ 9, 10]),
+           size=(3, 3), nnz=2, layout=torch.sparse_csr)
+""")
+
 add_docstr_all('to_mkldnn',
                r"""
 to_mkldnn() -> Tensor
@@ -3845,6 +3893,11 @@ add_docstr_all('is_quantized',
 Is ``True`` if the Tensor is quantized, ``False`` otherwise.
 """)
 
+add_docstr_all('is_sparse_csr',
+               r"""
+Is ``True`` if the Tensor uses the ``torch.sparse_csr`` layout, ``False`` otherwise.
+""")
+
 add_docstr_all('is_meta',
                r"""
 Is ``True`` if the Tensor is a meta tensor, ``False`` otherwise.  Meta tensors
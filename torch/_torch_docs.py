@@ -2415,7 +2415,7 @@ Example::
 
 add_docstr(torch.from_numpy,
            r"""
-from_numpy(ndarray) -> Tensor
+from_numpy(ndarray, *, copy_if_needed=False, pin_memory=False) -> Tensor
 
 Creates a :class:`Tensor` from a :class:`numpy.ndarray`.
 
@@ -2423,11 +2423,27 @@ The returned tensor and :attr:`ndarray` share the same memory. Modifications to
 the tensor will be reflected in the :attr:`ndarray` and vice versa. The returned
 tensor is not resizable.
 
+Arrays with a negative stride, a stride that isn't a multiple of the element
+size, or a byte order other than the native one, can't be shared and raise an
+error, unless :attr:`copy_if_needed` is ``True``.
+
 It currently accepts :attr:`ndarray` with dtypes of ``numpy.float64``,
 ``numpy.float32``, ``numpy.float16``, ``numpy.complex64``, ``numpy.complex128``,
 ``numpy.int64``, ``numpy.int32``, ``numpy.int16``, ``numpy.int8``, ``numpy.uint8``,
 and ``numpy.bool``.
 
+Args:
+    ndarray (numpy.ndarray): the array
+
+Keyword args:
+    copy_if_needed (bool, optional): if ``True``, an array that can't be shared
+        is copied into a tensor in the native byte order instead, and the
+        returned tensor doesn't share its memory. Default: ``False``.
+    pin_memory (bool, optional): if ``True``, the array is copied into pinned
+        memory, from which copies to CUDA devices can be asynchronous. The
+        returned tensor doesn't share the memory of the array.
+        Default: ``False``.
+
 Example::
 
     >>> a = numpy.array([1, 2, 3])
@@ -5590,6 +5606,35 @@ Example::
             [3, 2, 1, 0]])
 """.format(**common_args))
 
+add_docstr(torch.sparse_csr_tensor,
+           r"""
+sparse_csr_tensor(crow_indices, col_indices, values, size) -> Tensor
+
+Constructs a 2-D sparse tensor in :ref:`compressed sparse row format <sparse-csr-docs>`
+with the given :attr:`values` at the given :attr:`col_indices` of the rows
+delimited by :attr:`crow_indices`. The data type and the device of the result
+are the ones of :attr:`values`.
+
+Args:
+    crow_indices (Tensor): 1-D int64 tensor of size ``size[0] + 1``. The stored
+        elements of row ``i`` are ``crow_indices[i]`` to ``crow_indices[i + 1] - 1``,
+        so ``crow_indices[0]`` is 0 and ``crow_indices[-1]`` is the number of values.
+    col_indices (Tensor): 1-D int64 tensor with the column of each stored element.
+    values (Tensor): 1-D tensor with the value of each stored element.
+    size (list, tuple, or :class:`torch.Size`): Size of the 2-D sparse tensor.
+
+Example::
+
+    >>> crow_indices = torch.tensor([0, 2, 2, 3])
+    >>> col_indices = torch.tensor([0, 2, 1])
+    >>> values = torch.tensor([1., 2., 3.])
+    >>> torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 3])
+    tensor(crow_indices=tensor([0, 2, 2, 3]),
+           col_indices=tensor([0, 2, 1]),
+           values=tensor([1., 2., 3.]),
+           size=(3, 3), nnz=3, layout=torch.sparse_csr)
+""")
+
 add_docstr(torch.sparse_coo_tensor,
            r"""
 sparse_coo_tensor(indices, values, size=None, dtype=None, device=None, requires_grad=False) -> Tensor
@@ -8147,6 +8192,44 @@ Example::
     device(type='cpu')
 """)
 
+add_docstr(torch.segment_reduce,
+           r"""
+segment_reduce(data, reduce, *, lengths=None, offsets=None, axis=0, unsafe=False) -> Tensor
+
+Reduces consecutive segments of rows of :attr:`data`. The segments are given
+either by their :attr:`lengths`, or by the :attr:`offsets` of their first
+rows, as for :func:`torch.nn.functional.embedding_bag`. The i-th row of the
+result is the reduction of the rows of the i-th segment.
+
+Empty segments are 0 for ``'sum'``, NaN for ``'mean'`` and ``-inf`` for
+``'max'``. The gradient of ``'max'`` is split evenly between the maxima of
+each segment.
+
+Args:
+    data (Tensor): the floating point tensor to reduce
+    reduce (str): the reduction, ``'sum'``, ``'mean'`` or ``'max'``
+
+Keyword args:
+    lengths (LongTensor, optional): the lengths of the segments, which add up
+        to ``data.size(0)``
+    offsets (LongTensor, optional): the start of each segment, beginning with
+        0, each segment ending where the next one starts and the last one at
+        the end of :attr:`data`
+    axis (int, optional): the dimension to reduce, only 0 is supported
+    unsafe (bool, optional): skips checking the segments, which synchronizes
+        with the device for CUDA tensors
+
+Example::
+
+    >>> data = torch.tensor([[1., 2.], [3., 4.], [5., 6.]])
+    >>> torch.segment_reduce(data, 'sum', lengths=torch.tensor([2, 1]))
+    tensor([[4., 6.],
+            [5., 6.]])
+    >>> torch.segment_reduce(data, 'max', offsets=torch.tensor([0, 1]))
+    tensor([[1., 2.],
+            [5., 6.]])
+""")
+
 add_docstr(torch.searchsorted,
            r"""
 searchsorted(sorted_sequence, values, out_int32=False, right=False, out=None) -> Tensor
@@ -14,7 +14,7 @@ from torch.types import _TensorOrTensors
 from .variable import Variable
 from .function import Function, NestedIOFunction
 from .gradcheck import gradcheck, gradgradcheck
-from .grad_mode import no_grad, enable_grad, set_grad_enabled
+from .grad_mode import no_grad, enable_grad, set_grad_enabled, inference_mode
 from .anomaly_mode import detect_anomaly, set_detect_anomaly
 from . import profiler
 from . import functional
@@ -192,6 +192,25 @@ def grad(
         inputs, allow_unused)
 
 
+def preallocate_grad(tensors: _TensorOrTensors) -> None:
+    r"""Preallocates the ``.grad`` of leaf tensors, with their exact strides.
+
+    The ``.grad`` of each tensor keeps its values, or is zero filled if it was
+    ``None``. Gradients are then always accumulated in place into the
+    preallocated memory when ``create_graph=False``, including after
+    ``.grad`` is reset to ``None``, e.g. by ``zero_grad(set_to_none=True)``: the
+    first gradient of the next ``backward()`` is copied into it, without
+    zero filling it in a separate pass. See :ref:`default-grad-layouts`.
+
+    Arguments:
+        tensors (sequence of Tensor): leaf tensors that require grad, such as
+            the parameters of a model.
+    """
+    tensors = (tensors,) if isinstance(tensors, torch.Tensor) else tuple(tensors)
+    for tensor in tensors:
+        torch.autograd._preallocate_grad(tensor)
+
+
 # This function applies in case of gradient checkpointing for memory
 # optimization. Currently, for gradient checkpointing, we only support imperative
 # backwards call i.e. torch.autograd.backward() and the torch.autograd.grad() won't
@@ -16,6 +16,19 @@ class detect_anomaly(object):
         This mode should be enabled only for debugging as the different tests
         will slow down your program execution.
 
+    With ``lightweight=True``, no traceback is recorded in the forward pass,
+    and the backward pass reduces every output of every backward computation
+    to its sum, which is checked for "nan" and "inf" values all at once when
+    the backward pass is done. It only synchronizes once per device and
+    backward pass, so that it can be left enabled while training. An anomaly
+    raises an error naming the backward function that first returned non
+    finite values, and the functions that ran before it; running the forward
+    pass again in the full mode gives its traceback.
+
+    Arguments:
+        lightweight (bool): Whether to only check the backward outputs for
+            "nan" and "inf" values, cheaply. Default: ``False``.
+
     Example:
 
         >>> import torch
@@ -67,17 +80,24 @@ class detect_anomaly(object):
 
     """
 
-    def __init__(self) -> None:
+    def __init__(self, lightweight: bool = False) -> None:
+        self.lightweight = lightweight
         self.prev = torch.is_anomaly_enabled()
-        warnings.warn('Anomaly Detection has been enabled. '
-                      'This mode will increase the runtime '
-                      'and should only be enabled for debugging.', stacklevel=2)
+        self.prev_lightweight = torch._C._is_anomaly_lightweight_enabled()
+        if not lightweight:
+            warnings.warn('Anomaly Detection has been enabled. '
+                          'This mode will increase the runtime '
+                          'and should only be enabled for debugging.', stacklevel=2)
 
     def __enter__(self) -> None:
-        torch.set_anomaly_enabled(True)
+        if self.lightweight:
+            torch._C._set_anomaly_lightweight_enabled(True)
+        else:
+            torch.set_anomaly_enabled(True)
 
     def __exit__(self, *args: Any) -> None:
         torch.set_anomaly_enabled(self.prev)
+        torch._C._set_anomaly_lightweight_enabled(self.prev_lightweight)
 
 
 class set_detect_anomaly(object):
@@ -92,15 +112,22 @@ class set_detect_anomaly(object):
     Arguments:
         mode (bool): Flag whether to enable anomaly detection (``True``),
                      or disable (``False``).
+        lightweight (bool): Whether to set the lightweight anomaly detection
+                     instead. Default: ``False``.
 
     """
 
-    def __init__(self, mode: bool) -> None:
+    def __init__(self, mode: bool, lightweight: bool = False) -> None:
         self.prev = torch.is_anomaly_enabled()
-        torch.set_anomaly_enabled(mode)
+        self.prev_lightweight = torch._C._is_anomaly_lightweight_enabled()
+        if lightweight:
+            torch._C._set_anomaly_lightweight_enabled(mode)
+        else:
+            torch.set_anomaly_enabled(mode)
 
     def __enter__(self) -> None:
         pass
 
     def __exit__(self, *args: Any) -> None:
         torch.set_anomaly_enabled(self.prev)
+        torch._C._set_anomaly_lightweight_enabled(self.prev_lightweight)
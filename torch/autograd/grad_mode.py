@@ -150,3 +150,49 @@ class set_grad_enabled(object):
 
     def __exit__(self, *args):
         torch.set_grad_enabled(self.prev)
+
+
+class inference_mode(_DecoratorContextManager):
+    r"""Context-manager for code that will never call :meth:`Tensor.backward()`,
+    e.g. when serving a model.
+
+    Like :class:`~no_grad`, it disables gradient calculation. On top of that,
+    operations skip the autograd kernels entirely, and the tensors created in
+    this mode (see :meth:`Tensor.is_inference`) don't track their in-place
+    updates. This makes small operations cheaper than under :class:`~no_grad`,
+    at the price that these tensors can't be used in autograd afterwards:
+    saving one for backward, setting ``requires_grad=True`` on it or
+    modifying it in-place outside of this mode raises an error. Use
+    :meth:`Tensor.clone` to get a normal tensor out of an inference tensor.
+
+    Tensors created outside of this mode can be used in it, but their version
+    counter is not bumped by in-place updates either, so don't modify tensors
+    saved for a pending backward pass in it.
+
+    This context manager is thread local; it will not affect computation
+    in other threads.
+
+    Also functions as a decorator. (Make sure to instantiate with parenthesis.)
+
+
+    Example::
+
+        >>> x = torch.ones(1, 2, 3, requires_grad=True)
+        >>> with torch.inference_mode():
+        ...   y = x * x
+        >>> y.requires_grad
+        False
+        >>> y.is_inference()
+        True
+        >>> y.add_(1)
+        RuntimeError: Inplace update to inference tensor outside InferenceMode is not allowed. [...]
+    """
+    def __enter__(self):
+        self.prev_grad = torch.is_grad_enabled()
+        self.prev = torch.is_inference_mode_enabled()
+        torch._C._set_inference_mode_enabled(True)
+        torch._C.set_grad_enabled(False)
+
+    def __exit__(self, *args):
+        torch._C._set_inference_mode_enabled(self.prev)
+        torch.set_grad_enabled(self.prev_grad)
@@ -25,10 +25,12 @@ class EventList(list):
     def __init__(self, *args, **kwargs):
         use_cuda = kwargs.pop('use_cuda', True)
         profile_memory = kwargs.pop('profile_memory', False)
+        profile_perf_counters = kwargs.pop('profile_perf_counters', False)
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
         self._use_cuda = use_cuda
         self._profile_memory = profile_memory
+        self._profile_perf_counters = profile_perf_counters
 
     def __str__(self):
         return self.table()
@@ -113,7 +115,9 @@ class EventList(list):
                 they are printed in the same order as they were registered.
                 Valid keys include: ``cpu_time``, ``cuda_time``, ``cpu_time_total``,
                 ``cuda_time_total``, ``cpu_memory_usage``, ``cuda_memory_usage``,
-                ``self_cpu_memory_usage``, ``self_cuda_memory_usage``, ``count``.
+                ``self_cpu_memory_usage``, ``self_cuda_memory_usage``, ``count``,
+                and the fields of the memory stats and the perf counters, like
+                ``cpu_memory_stats.peak`` or ``perf_counters.llc_misses``.
 
         Returns:
             A string containing the table.
@@ -124,7 +128,8 @@ class EventList(list):
             row_limit=row_limit,
             header=header,
             use_cuda=self._use_cuda,
-            profile_memory=self._profile_memory)
+            profile_memory=self._profile_memory,
+            profile_perf_counters=self._profile_perf_counters)
 
     def export_chrome_trace(self, path):
         """Exports an EventList as a Chrome tracing tools file.
@@ -149,7 +154,7 @@ class EventList(list):
                     '"dur": %s, '
                     '"tid": %s, '
                     '"pid": "CPU functions", '
-                    '"args": {}}, '
+                    '"args": {%s}}, '
                     % (
                         evt.name,
                         evt.cpu_interval.start,
@@ -157,6 +162,7 @@ class EventList(list):
                         evt.thread
                         if not evt.is_remote
                         else f'" node_id:{evt.node_id}, thread_id:{evt.thread} "',
+                        evt.perf_counters.trace_args(),
                     )
                 )
                 for k in evt.kernels:
@@ -216,7 +222,11 @@ class EventList(list):
         for evt in self:
             stats[get_key(evt, group_by_input_shapes)].add(
                 evt, group_by_input_shapes)
-        return EventList(stats.values(), use_cuda=self._use_cuda, profile_memory=self._profile_memory)
+        return EventList(
+            stats.values(),
+            use_cuda=self._use_cuda,
+            profile_memory=self._profile_memory,
+            profile_perf_counters=self._profile_perf_counters)
 
     def total_average(self):
         """Averages all events.
@@ -258,7 +268,26 @@ class profile(object):
             self cpu time might be artificially increased because of the shape
             collection.
 
-        profile_memory (bool, optional): Whether to report memory usage, default: ``False``
+        profile_memory (bool, optional): Whether to report memory usage, default: ``False``.
+            Besides the net memory usage, every function reports the bytes it
+            allocated and freed, its peak, the bytes it retained and those of them
+            saved for backward in ``cpu_memory_stats`` and ``cuda_memory_stats``
+            (see :class:`MemoryStats`).
+
+        use_cupti (bool, optional): Records the CUDA kernels, memcpys and memsets
+            launched by each operator with CUPTI, along with their device side
+            durations. They are reported as the CUDA time of the operators and are
+            included in the exported Chrome trace. Requires PyTorch to be built with
+            CUPTI, takes precedence over ``use_cuda``. Default: ``False``
+
+        profile_perf_counters (bool, optional): Counts the cycles, instructions
+            and last level cache misses of every function on the CPU with the
+            hardware performance counters of Linux perf, reported in
+            ``perf_counters`` (see :class:`PerfCounters`) along with the IPC and
+            the memory bandwidth of the misses. The counts include the
+            children of the functions but not the intra-op threads they use.
+            Requires perf events the kernel's ``perf_event_paranoid`` setting
+            allows. Default: ``False``
 
     .. warning:
         Enabling memory profiling incurs additional profiler overhead
@@ -297,15 +326,19 @@ class profile(object):
             enabled=True,
             use_cuda=False,
             record_shapes=False,
-            profile_memory=False):
+            profile_memory=False,
+            use_cupti=False,
+            profile_perf_counters=False):
         self.enabled = enabled
-        self.use_cuda = use_cuda
+        self.use_cuda = use_cuda or use_cupti
+        self.use_cupti = use_cupti
         self.function_events = None
         if not self.enabled:
             return
         self.entered = False
         self.record_shapes = record_shapes
         self.profile_memory = profile_memory
+        self.profile_perf_counters = profile_perf_counters
 
     def __enter__(self):
         if not self.enabled:
@@ -313,10 +346,15 @@ class profile(object):
         if self.entered:
             raise RuntimeError("autograd profiler traces are not reentrant")
         self.entered = True
-        profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
-            else torch.autograd.ProfilerState.CPU
-
-        config = torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory)
+        if self.use_cupti:
+            profiler_kind = torch.autograd.ProfilerState.CUPTI
+        elif self.use_cuda:
+            profiler_kind = torch.autograd.ProfilerState.CUDA
+        else:
+            profiler_kind = torch.autograd.ProfilerState.CPU
+
+        config = torch.autograd.ProfilerConfig(
+            profiler_kind, self.record_shapes, self.profile_memory, self.profile_perf_counters)
         torch.autograd._enable_profiler(config)
         return self
 
@@ -327,7 +365,8 @@ class profile(object):
         self.function_events = EventList(
             parse_cpu_trace(records),
             use_cuda=self.use_cuda,
-            profile_memory=self.profile_memory)
+            profile_memory=self.profile_memory,
+            profile_perf_counters=self.profile_perf_counters)
         return False
 
     def __repr__(self):
@@ -643,11 +682,88 @@ class Interval(object):
 Kernel = namedtuple('Kernel', ['name', 'device', 'interval'])
 
 
+class MemoryStats(object):
+    """Memory allocated on a device while a function ran, in bytes.
+
+    ``allocated`` and ``freed`` sum the allocations and the frees, and
+    ``peak`` is the largest net allocation at any point while it ran.
+    ``retained`` counts the allocations it made that were still alive when
+    it returned, and ``saved`` those of them that autograd saved for
+    backward, which are the activations the function keeps alive.
+    """
+    __slots__ = ['allocated', 'freed', 'peak', 'retained', 'saved']
+
+    def __init__(self):
+        self.allocated = 0
+        self.freed = 0
+        self.peak = 0
+        self.retained = 0
+        self.saved = 0
+
+    def add(self, other):
+        self.allocated += other.allocated
+        self.freed += other.freed
+        self.peak = max(self.peak, other.peak)
+        self.retained += other.retained
+        self.saved += other.saved
+        return self
+
+    def __repr__(self):
+        return (
+            '<MemoryStats allocated={} freed={} peak={} retained={} saved={}>'.format(
+                self.allocated, self.freed, self.peak, self.retained, self.saved))
+
+
+class PerfCounters(object):
+    """Hardware performance counters of a function on the thread it ran on.
+
+    ``cycles`` and ``instructions`` count the CPU cycles and the instructions
+    retired, and ``llc_misses`` the last level cache misses, each of which
+    reads a cache line from memory.
+    """
+    __slots__ = ['cycles', 'instructions', 'llc_misses']
+
+    CACHE_LINE_BYTES = 64
+
+    def __init__(self, cycles=0, instructions=0, llc_misses=0):
+        self.cycles = cycles
+        self.instructions = instructions
+        self.llc_misses = llc_misses
+
+    def add(self, other):
+        self.cycles += other.cycles
+        self.instructions += other.instructions
+        self.llc_misses += other.llc_misses
+        return self
+
+    @property
+    def ipc(self):
+        """Instructions per cycle"""
+        return self.instructions / self.cycles if self.cycles > 0 else 0.
+
+    def memory_bandwidth(self, time_us):
+        """Bytes per second the cache misses read in ``time_us``"""
+        if time_us <= 0:
+            return 0.
+        return self.llc_misses * self.CACHE_LINE_BYTES / (time_us / 1e6)
+
+    def trace_args(self):
+        if self.cycles == 0:
+            return ''
+        return '"cycles": {}, "instructions": {}, "llc_misses": {}'.format(
+            self.cycles, self.instructions, self.llc_misses)
+
+    def __repr__(self):
+        return '<PerfCounters cycles={} instructions={} llc_misses={}>'.format(
+            self.cycles, self.instructions, self.llc_misses)
+
+
 class FunctionEvent(FormattedTimesMixin):
     """Profiling information about a single function."""
     def __init__(
             self, id, node_id, name, thread, cpu_start, cpu_end, input_shapes=None,
-            cpu_memory_usage=0, cuda_memory_usage=0, is_async=False, is_remote=True):
+            cpu_memory_usage=0, cuda_memory_usage=0, is_async=False, is_remote=True,
+            cpu_memory_stats=None, cuda_memory_stats=None, perf_counters=None):
         self.id = id
         self.node_id = node_id
         self.name = name
@@ -659,6 +775,9 @@ class FunctionEvent(FormattedTimesMixin):
         self.input_shapes = input_shapes
         self.cpu_memory_usage = cpu_memory_usage
         self.cuda_memory_usage = cuda_memory_usage
+        self.cpu_memory_stats = cpu_memory_stats or MemoryStats()
+        self.cuda_memory_stats = cuda_memory_stats or MemoryStats()
+        self.perf_counters = perf_counters or PerfCounters()
         self.is_async = is_async
         self.is_remote = is_remote
 
@@ -751,6 +870,9 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_memory_usage = 0
         self.self_cpu_memory_usage = 0
         self.self_cuda_memory_usage = 0
+        self.cpu_memory_stats = MemoryStats()
+        self.cuda_memory_stats = MemoryStats()
+        self.perf_counters = PerfCounters()
 
     def add(self, other, group_by_input_shapes=False):
         if self.key is None:
@@ -776,6 +898,9 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_memory_usage += other.cuda_memory_usage
         self.self_cpu_memory_usage += other.self_cpu_memory_usage
         self.self_cuda_memory_usage += other.self_cuda_memory_usage
+        self.cpu_memory_stats.add(other.cpu_memory_stats)
+        self.cuda_memory_stats.add(other.cuda_memory_stats)
+        self.perf_counters.add(other.perf_counters)
         self.count += other.count
         return self
 
@@ -813,6 +938,33 @@ class StringTable(defaultdict):
 ################################################################################
 # CPU checkpoints
 
+def update_memory_stats(record, memory_stats, net_memory_allocs, live_allocs):
+    """Attributes a memory_alloc record to the open ranges."""
+    device_idx = 1 if record.cuda_memory_usage() != 0 else 0
+    size = record.cuda_memory_usage() if device_idx else record.cpu_memory_usage()
+    key = (device_idx, record.memory_address())
+    for handle, net in net_memory_allocs.items():
+        stats = memory_stats[handle][device_idx]
+        net[device_idx] += size
+        if size > 0:
+            stats.allocated += size
+            stats.retained += size
+            stats.peak = max(stats.peak, net[device_idx])
+        else:
+            stats.freed -= size
+    if size > 0:
+        # [size, ranges that made it, whether it was saved for backward]
+        live_allocs[key] = [size, list(net_memory_allocs.keys()), False]
+    else:
+        alloc = live_allocs.pop(key, None)
+        if alloc is not None:
+            for handle in alloc[1]:
+                if handle in net_memory_allocs:
+                    memory_stats[handle][device_idx].retained -= alloc[0]
+                    if alloc[2]:
+                        memory_stats[handle][device_idx].saved -= alloc[0]
+
+
 def parse_cpu_trace(thread_records):
     def get_record_key(record):
         """
@@ -825,6 +977,10 @@ def parse_cpu_trace(thread_records):
     start_record = None
     cuda_records = {}
     functions = []
+    functions_by_key = {}
+    kernel_records = []
+    # key of the range a filtered out duplicate range was merged into
+    merged_into = {}
     record_stack = []
     string_table = StringTable()
 
@@ -865,6 +1021,13 @@ def parse_cpu_trace(thread_records):
         # accumulated memory allocations per handle
         cpu_memory_allocs = {}
         cuda_memory_allocs = {}
+        # memory stats per handle, and the net allocation of the open
+        # ranges the peaks are computed from
+        memory_stats = {}
+        net_memory_allocs = {}
+        # allocations alive during the profiling, by device and address,
+        # with the open ranges that made them
+        live_allocs = {}
         # ranges per handle
         range_starts = {}
 
@@ -872,6 +1035,10 @@ def parse_cpu_trace(thread_records):
         prev_record = None
         for record in thread_record_list:
             record_key = get_record_key(record)
+            if record.kind() == 'kernel':
+                # attributed once all the ranges are known
+                kernel_records.append(record)
+                continue
             if (record.name() in filtered_out_names or
                     record_key in filtered_handles):
                 filtered_handles.add(record_key)
@@ -888,11 +1055,14 @@ def parse_cpu_trace(thread_records):
                     )
                     if duplicate:
                         filtered_handles.add(record_key)
+                        merged_into[record_key] = get_record_key(prev_record)
                         continue
 
                 range_starts[record_key] = record
                 cpu_memory_allocs[record_key] = 0
                 cuda_memory_allocs[record_key] = 0
+                memory_stats[record_key] = (MemoryStats(), MemoryStats())
+                net_memory_allocs[record_key] = [0, 0]
             elif record.kind() == 'pop':
                 assert (
                     record_key in range_starts
@@ -907,6 +1077,12 @@ def parse_cpu_trace(thread_records):
                 cuda_memory_usage = cuda_memory_allocs[record_key]
                 is_async = start.thread_id() != record.thread_id()
                 is_remote_event = record.is_remote()
+                perf_counters = None
+                start_counters = start.perf_counters()
+                end_counters = record.perf_counters()
+                if not is_async and start_counters and end_counters:
+                    perf_counters = PerfCounters(*[
+                        end - begin for begin, end in zip(start_counters, end_counters)])
 
                 fe = FunctionEvent(
                     id=record.handle(),
@@ -920,6 +1096,9 @@ def parse_cpu_trace(thread_records):
                     cuda_memory_usage=cuda_memory_usage,
                     is_async=is_async,
                     is_remote=is_remote_event,
+                    cpu_memory_stats=memory_stats[record_key][0],
+                    cuda_memory_stats=memory_stats[record_key][1],
+                    perf_counters=perf_counters,
                 )
                 # note: async events have only cpu total time
                 if not is_async and start.has_cuda():
@@ -931,16 +1110,44 @@ def parse_cpu_trace(thread_records):
                         cuda_start,
                         cuda_end)
                 functions.append(fe)
+                functions_by_key[record_key] = fe
                 del range_starts[record_key]
                 del cpu_memory_allocs[record_key]
                 del cuda_memory_allocs[record_key]
+                del net_memory_allocs[record_key]
             elif record.kind() == 'memory_alloc':
                 for handle in cpu_memory_allocs.keys():
                     cpu_memory_allocs[handle] += record.cpu_memory_usage()
                 for handle in cuda_memory_allocs.keys():
                     cuda_memory_allocs[handle] += record.cuda_memory_usage()
+                update_memory_stats(record, memory_stats, net_memory_allocs, live_allocs)
+            elif record.kind() == 'memory_saved':
+                device_idx = 1 if record.cuda_memory_usage() != 0 else 0
+                alloc = live_allocs.get((device_idx, record.memory_address()))
+                # the allocations saved more than once, through views or by
+                # several functions, count once
+                if alloc is not None and not alloc[2]:
+                    alloc[2] = True
+                    for handle in alloc[1]:
+                        memory_stats[handle][device_idx].saved += alloc[0]
             prev_record = record
 
+    # kernels traced with CUPTI are attributed to the innermost range that
+    # launched them
+    for record in kernel_records:
+        record_key = get_record_key(record)
+        while record_key in merged_into:
+            record_key = merged_into[record_key]
+        fe = functions_by_key.get(record_key)
+        if fe is None or fe.is_async:
+            continue
+        kernel_start = start_record.cpu_elapsed_us(record)
+        fe.append_kernel(
+            string_table[record.name()],
+            record.device(),
+            kernel_start,
+            kernel_start + record.device_duration_us())
+
     # Sort functions by start time then by end time ascending.
     # This ensures that--in the case of nested events which
     # have the same start time (which may happen due to the
@@ -1038,15 +1245,17 @@ def build_table(
         header=None,
         row_limit=100,
         use_cuda=True,
-        profile_memory=False):
+        profile_memory=False,
+        profile_perf_counters=False):
     """Prints a summary of events (which can be a list of FunctionEvent or FunctionEventAvg)."""
     if len(events) == 0:
         return ""
 
     if sort_by is not None:
         events = EventList(sorted(
-            events, key=lambda evt: getattr(evt, sort_by), reverse=True
-        ), use_cuda=use_cuda, profile_memory=profile_memory)
+            events, key=attrgetter(sort_by), reverse=True
+        ), use_cuda=use_cuda, profile_memory=profile_memory,
+            profile_perf_counters=profile_perf_counters)
 
     has_input_shapes = any(
         [event.input_shapes is not None for event in events])
@@ -1072,12 +1281,23 @@ def build_table(
         headers.extend([
             'CPU Mem',
             'Self CPU Mem',
+            'CPU Peak Mem',
+            'CPU Saved Mem',
         ])
         if torch.cuda.is_available():
             headers.extend([
                 'CUDA Mem',
                 'Self CUDA Mem',
+                'CUDA Peak Mem',
+                'CUDA Saved Mem',
             ])
+    if profile_perf_counters:
+        headers.extend([
+            'Cycles',
+            'IPC',
+            'LLC Misses',
+            'Mem Bandwidth',
+        ])
     headers.append(
         'Number of Calls'
     )
@@ -1154,6 +1374,10 @@ def build_table(
                 format_memory(evt.cpu_memory_usage),
                 # Self CPU Mem Total
                 format_memory(evt.self_cpu_memory_usage),
+                # CPU Peak Mem
+                format_memory(evt.cpu_memory_stats.peak),
+                # CPU Mem saved for backward
+                format_memory(evt.cpu_memory_stats.saved),
             ])
             if torch.cuda.is_available():
                 row_values.extend([
@@ -1161,7 +1385,19 @@ def build_table(
                     format_memory(evt.cuda_memory_usage),
                     # Self CUDA Mem Total
                     format_memory(evt.self_cuda_memory_usage),
+                    # CUDA Peak Mem
+                    format_memory(evt.cuda_memory_stats.peak),
+                    # CUDA Mem saved for backward
+                    format_memory(evt.cuda_memory_stats.saved),
                 ])
+        if profile_perf_counters:
+            row_values.extend([
+                evt.perf_counters.cycles,
+                '{:.2f}'.format(evt.perf_counters.ipc),
+                evt.perf_counters.llc_misses,
+                # Bandwidth of the cache misses over the CPU time
+                format_memory(int(evt.perf_counters.memory_bandwidth(evt.cpu_time_total))) + '/s',
+            ])
         row_values.append(
             evt.count,  # Number of calls
         )
@@ -29,8 +29,8 @@ class cuFFTPlanCacheAttrContextProp(object):
 class cuFFTPlanCache(object):
     r"""
     Represents a specific plan cache for a specific `device_index`. The
-    attributes `size` and `max_size`, and method `clear`, can fetch and/ or
-    change properties of the C++ cuFFT plan cache.
+    attributes `size` and `max_size`, and methods `clear` and `padded_size`,
+    can fetch and/ or change properties of the C++ cuFFT plan cache.
     """
     def __init__(self, device_index):
         self.device_index = device_index
@@ -46,6 +46,17 @@ class cuFFTPlanCache(object):
     def clear(self):
         return torch._cufft_clear_plan_cache(self.device_index)
 
+    def padded_size(self, n, max_padding=0.25):
+        r"""Returns the length to zero-pad a signal of length `n` to so that it
+        reuses a cached plan: the smallest cached signal length in
+        ``[n, n * (1 + max_padding)]``, or else the smallest length of at least
+        `n` whose prime factors are all at most 7.
+
+        Zero-padding changes the transform, so this is only suitable where the
+        spectrum of the padded signal is acceptable.
+        """
+        return torch._cufft_get_plan_cache_padded_size(self.device_index, n, max_padding)
+
 
 class cuFFTPlanCacheManager(object):
     r"""
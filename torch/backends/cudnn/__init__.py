@@ -83,6 +83,31 @@ def is_acceptable(tensor):
     return True
 
 
+def save_benchmark_cache(path):
+    r"""Saves the convolution algorithms cuDNN selected so far, e.g. by
+    benchmarking them when :attr:`torch.backends.cudnn.benchmark` is set, to
+    the file ``path``, and returns their number.
+
+    The file can be loaded by :func:`load_benchmark_cache` in later
+    processes, or before their first convolution by setting the
+    ``TORCH_CUDNN_BENCHMARK_CACHE`` environment variable to its path. It is
+    only loaded with the same cuDNN version, GPU model and PyTorch build.
+    """
+    if not _init() or not _cudnn.is_cuda:
+        raise RuntimeError("save_benchmark_cache requires cuDNN")
+    return _cudnn._save_conv_benchmark_cache(path)
+
+
+def load_benchmark_cache(path):
+    r"""Adds the convolution algorithms saved by :func:`save_benchmark_cache`
+    in ``path`` to the cache, so that their convolution shapes aren't
+    benchmarked again, and returns their number.
+    """
+    if not _init() or not _cudnn.is_cuda:
+        raise RuntimeError("load_benchmark_cache requires cuDNN")
+    return _cudnn._load_conv_benchmark_cache(path)
+
+
 def set_flags(_enabled, _benchmark, _deterministic):
     orig_flags = (torch._C._get_cudnn_enabled(),
                   torch._C._get_cudnn_benchmark(),
@@ -4,6 +4,9 @@
 #include <map>
 #include <mutex>
 #include <random>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #ifdef _MSC_VER
 #include <windows.h>
@@ -25,9 +28,19 @@ void warnProducerTerminatedBeforeSharedTensorsReleased() {
   }
 }
 
+// IPC events pooled for reuse
+using CudaIPCEvent = std::pair<cudaEvent_t, cudaIpcEventHandle_t>;
+
 struct CudaIPCGlobalEntities {
   std::mutex ref_counters_mutex_;
   std::atomic<int64_t> sync_events_used_;
+  // Interprocess events of sent data that all consumers released, by device.
+  // Once released, no consumer waits on an event anymore, so it can be
+  // recorded again for the next sent data, which spares the creation of the
+  // event and of its IPC handle, and lets consumers reuse the event they
+  // opened from that handle.
+  std::mutex free_events_mutex_;
+  std::unordered_map<c10::DeviceIndex, std::vector<CudaIPCEvent>> free_events_;
   std::map<std::string, std::shared_ptr<CudaIPCRefCountersFile>>
       ref_counters_files_;
   std::shared_ptr<CudaIPCRefCountersFile> next_available_ref_counters_file_;
@@ -141,16 +154,31 @@ CudaIPCSentData::CudaIPCSentData(
   //  [i.record() for i in a]
   //  ```
   //
-  if (cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
-    // TODO: More efficient would be to create event inside of main thread (at
-    // the moment of the queue.put). The reason this is more efficient is
-    // because the main thread may have queued extra work on the stream, which
-    // this event will consequently wait for (uselessly).
+  bool have_event = false;
+  {
+    std::lock_guard<std::mutex> lock(cuda_ipc_global_entities.free_events_mutex_);
+    auto& free_events = cuda_ipc_global_entities.free_events_[device.index()];
+    if (!free_events.empty()) {
+      std::tie(event_, event_handle_) = free_events.back();
+      free_events.pop_back();
+      have_event = true;
+    }
+  }
+  if (!have_event && cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
+    // Counts pooled events as well, they are never destroyed
     cuda_ipc_global_entities.sync_events_used_ ++;
     C10_CUDA_CHECK(cudaEventCreateWithFlags(
         &event_,
         cudaEventDisableTiming | cudaEventInterprocess |
             cudaEventBlockingSync));
+    C10_CUDA_CHECK(cudaIpcGetEventHandle(&event_handle_, event_));
+    have_event = true;
+  }
+  if (have_event) {
+    // TODO: More efficient would be to record event inside of main thread (at
+    // the moment of the queue.put). The reason this is more efficient is
+    // because the main thread may have queued extra work on the stream, which
+    // this event will consequently wait for (uselessly).
     C10_CUDA_CHECK(cudaEventRecord(
         event_, c10::cuda::getCurrentCUDAStream(device.index())));
     event_sync_required_ = true;
@@ -173,9 +201,10 @@ CudaIPCSentData::~CudaIPCSentData() {
 #ifndef __HIP_PLATFORM_HCC__
   try {
     if (event_sync_required_) {
-      at::cuda::CUDAGuard device_guard(device_.index());
-      cudaEventDestroy(event_);
-      cuda_ipc_global_entities.sync_events_used_ --;
+      std::lock_guard<std::mutex> lock(
+          cuda_ipc_global_entities.free_events_mutex_);
+      cuda_ipc_global_entities.free_events_[device_.index()].emplace_back(
+          event_, event_handle_);
     }
   } catch (...) { /* No throw */
   }
@@ -228,6 +257,23 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
   return at::DataPtr(data, sent_data, CudaIPCSentDataDelete, device);
 }
 
+#ifndef __HIP_PLATFORM_HCC__
+cudaEvent_t CudaIPCOpenEvent(const std::string& handle) {
+  static std::mutex mutex;
+  // Never closed: the producer may record the event again for another send
+  static auto* opened_events = new std::unordered_map<std::string, cudaEvent_t>();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = opened_events->find(handle);
+  if (it == opened_events->end()) {
+    cudaEvent_t event;
+    C10_CUDA_CHECK(cudaIpcOpenEventHandle(
+        &event, *reinterpret_cast<const cudaIpcEventHandle_t*>(handle.data())));
+    it = opened_events->emplace(handle, event).first;
+  }
+  return it->second;
+}
+#endif
+
 bool CudaIPCCollect() {
   bool freed_memory = cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
   if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() == 0) {
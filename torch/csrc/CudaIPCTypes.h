@@ -24,7 +24,8 @@ struct CudaIPCSentData final {
   int64_t offset_;
   int64_t* counter_ptr_; // Reference counter shared memory block
   at::DataPtr original_ptr_; // Original mem allocation
-  cudaEvent_t event_; // Sync cuEventDestroy
+  cudaEvent_t event_; // Pooled, see CudaIPCGlobalEntities
+  cudaIpcEventHandle_t event_handle_; // IPC handle of event_
   bool event_sync_required_;
   at::Device device_;
 
@@ -49,6 +50,12 @@ struct CudaIPCSentData final {
 
 at::DataPtr GetNewRefCountedSentData(void* data, at::Device device);
 
+#ifndef __HIP_PLATFORM_HCC__
+// Returns the event for the given IPC event handle, opened at most once per
+// process: producers reuse their events, see CudaIPCGlobalEntities.
+cudaEvent_t CudaIPCOpenEvent(const std::string& handle);
+#endif
+
 namespace {
 
 constexpr int64_t CUDA_IPC_REF_COUNTER_FILE_SIZE = 10000;
@@ -5,6 +5,7 @@
 #include <Windows.h>
 #endif
 #include <structmember.h>
+#include <pybind11/pybind11.h>
 
 #define THP_HOST_HALF
 
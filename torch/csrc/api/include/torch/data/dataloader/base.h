@@ -3,6 +3,7 @@
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
 #include <torch/data/detail/sequencers.h>
+#include <torch/data/detail/transfer.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
 #include <torch/data/worker_exception.h>
@@ -37,7 +38,8 @@ class DataLoaderBase {
       std::unique_ptr<Dataset> main_thread_dataset = nullptr)
       : options_(std::move(options)),
         main_thread_dataset_(std::move(main_thread_dataset)),
-        sequencer_(new_sequencer()) {}
+        sequencer_(new_sequencer()),
+        transfer_{options_.pin_memory, options_.device} {}
 
   virtual ~DataLoaderBase() {
     join();
@@ -173,7 +175,8 @@ class DataLoaderBase {
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      return transfer(
+          this->main_thread_dataset_->get_batch(std::move(*batch_request)));
     }
     return nullopt;
   }
@@ -186,7 +189,8 @@ class DataLoaderBase {
         break;
       }
       try {
-        auto batch = dataset.get_batch(std::move(*job.batch_request));
+        auto batch =
+            transfer(dataset.get_batch(std::move(*job.batch_request)));
         shuttle_.push_result({std::move(batch), job.sequence_number});
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
@@ -194,6 +198,16 @@ class DataLoaderBase {
     }
   }
 
+  /// Pins and/or moves the tensors of a freshly loaded batch, according to the
+  /// `pin_memory` and `device` options.
+  template <typename T>
+  T transfer(T batch) const {
+    if (transfer_.is_noop()) {
+      return batch;
+    }
+    return detail::transfer(std::move(batch), transfer_);
+  }
+
   /// Convenience method that calls `shuttle_.push_job()` with the next sequence
   /// number.
   template <typename T>
@@ -241,6 +255,10 @@ class DataLoaderBase {
 
   /// True if the DataLoader has joined its worker threads.
   bool joined_ = false;
+
+  /// Where to move the tensors of each batch, from the `pin_memory` and
+  /// `device` options.
+  const detail::Transfer transfer_;
 };
 } // namespace data
 } // namespace torch
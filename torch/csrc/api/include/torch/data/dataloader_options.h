@@ -37,6 +37,18 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// Whether to copy the tensors of each batch into pinned (page-locked)
+  /// memory before returning it, which makes copying it to a CUDA device
+  /// faster and asynchronous. Requires CUDA.
+  TORCH_ARG(bool, pin_memory) = false;
+
+  /// An optional device to move the tensors of each batch to before returning
+  /// it. When loading with worker threads, each batch is moved by the worker
+  /// that loaded it, so that the copies of the next batches overlap with the
+  /// processing of the current one; together with `pin_memory`, the copies are
+  /// non-blocking.
+  TORCH_ARG(optional<Device>, device);
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,7 +64,9 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs().value_or(2 * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        pin_memory(options.pin_memory()),
+        device(options.device()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +74,8 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  bool pin_memory;
+  optional<Device> device;
 };
 } // namespace data
 } // namespace torch
@@ -5,5 +5,6 @@
 #include <torch/data/datasets/map.h>
 #include <torch/data/datasets/mnist.h>
 #include <torch/data/datasets/shared.h>
+#include <torch/data/datasets/stacked.h>
 #include <torch/data/datasets/stateful.h>
 #include <torch/data/datasets/tensor.h>
@@ -87,12 +87,25 @@ class BatchDataBuffer {
     lock.unlock();
     cv_write_.notify_all();
 
-    return batch.batch_data;
+    return std::move(batch.batch_data);
   }
 
   /// Push preloaded chunks to batch queue. Called from the ChunkDataset worker
   /// threads.
   void add_chunk_data(UnwrappedBatchType data) {
+    auto data_size = data.size();
+    // Sample the order of the examples before taking the queue lock, so that
+    // preloaders only contend on the queue while they move their examples into
+    // batches.
+    BatchRequestType indices;
+    {
+      std::lock_guard<std::mutex> lock(sampler_mutex_);
+      example_sampler_.reset(data_size);
+      auto example_indices = example_sampler_.next(data_size);
+      AT_ASSERT(example_indices && example_indices->size() == data_size);
+      indices = std::move(*example_indices);
+    }
+
     std::unique_lock<std::mutex> lock(queue_mutex_);
     cv_write_.wait(lock, [this] {
       // stop loading if we have preloaded enough data.
@@ -105,17 +118,12 @@ class BatchDataBuffer {
       return;
     }
 
-    auto data_size = data.size();
     auto remaining_size = data_size;
-    example_sampler_.reset(data_size);
+    auto next_index = indices.begin();
 
     auto fill_batch = [&](size_t example_count, UnwrappedBatchType& batch) {
-      auto batch_example_indices = this->example_sampler_.next(example_count);
-      AT_ASSERT(
-          batch_example_indices &&
-          batch_example_indices.value().size() == example_count);
-      BatchRequestType& indices = batch_example_indices.value();
-      for (size_t i : indices) {
+      for (size_t count = 0; count < example_count; ++count, ++next_index) {
+        const size_t i = *next_index;
         TORCH_CHECK(i < data_size, "Index out of range");
         batch.emplace_back(std::move(data[i]));
       }
@@ -230,6 +238,9 @@ class BatchDataBuffer {
 
   ExampleSampler& example_sampler_;
 
+  // sync example_sampler_ use, which happens outside of queue_mutex_.
+  std::mutex sampler_mutex_;
+
   // configurable maximun number of elements the queue can hold at one time.
   size_t queue_capacity_;
 
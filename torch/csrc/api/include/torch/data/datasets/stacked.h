@@ -0,0 +1,122 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace detail {
+inline Tensor new_stacked(const Tensor& first, size_t batch_size) {
+  auto sizes = first.sizes().vec();
+  sizes.insert(sizes.begin(), static_cast<int64_t>(batch_size));
+  return torch::empty(sizes, first.options());
+}
+
+inline void copy_into_slot(const Tensor& source, Tensor& slot) {
+  TORCH_CHECK(
+      source.sizes() == slot.sizes(),
+      "StackedDataset expects all examples to have the same shape, "
+      "but got an example of shape ",
+      source.sizes(),
+      " for a batch of examples of shape ",
+      slot.sizes());
+  slot.copy_(source);
+}
+
+inline void check_slot(const Tensor& slot, const Tensor& row) {
+  TORCH_CHECK(
+      slot.is_same(row),
+      "StackedDataset::get_into() must write into the tensors of its slot "
+      "in place, not replace them");
+}
+
+inline Example<> new_stacked(const Example<>& first, size_t batch_size) {
+  return {new_stacked(first.data, batch_size),
+          new_stacked(first.target, batch_size)};
+}
+
+inline Example<> slot_of(const Example<>& batch, size_t index) {
+  return {batch.data[index], batch.target[index]};
+}
+
+inline void copy_into_slot(const Example<>& source, Example<>& slot) {
+  copy_into_slot(source.data, slot.data);
+  copy_into_slot(source.target, slot.target);
+}
+
+inline void check_slot(const Example<>& slot, const Example<>& row) {
+  check_slot(slot.data, row.data);
+  check_slot(slot.target, row.target);
+}
+
+inline TensorExample new_stacked(const TensorExample& first, size_t batch_size) {
+  return new_stacked(first.data, batch_size);
+}
+
+inline TensorExample slot_of(const TensorExample& batch, size_t index) {
+  return batch.data[index];
+}
+
+inline void copy_into_slot(const TensorExample& source, TensorExample& slot) {
+  copy_into_slot(source.data, slot.data);
+}
+
+inline void check_slot(const TensorExample& slot, const TensorExample& row) {
+  check_slot(slot.data, row.data);
+}
+} // namespace detail
+
+/// A dataset of examples whose tensors all have the same shape, which yields
+/// the same batches as a `Dataset` mapped with `transforms::Stack`, but writes
+/// each example straight into its row of the batch.
+///
+/// `get_batch()` gets the first example of the batch with `get()`, allocates
+/// the batch tensors from its shape and options, and then has `get_into()`
+/// fill a slot of the batch for each other example. That makes one allocation
+/// per batch tensor, and, for datasets overriding `get_into()` to decode or
+/// read their data in place, no per example allocation nor stacking copy.
+/// `SingleExample` may be `Example<>` or `TensorExample`.
+template <typename Self, typename SingleExample = Example<>>
+class StackedDataset : public BatchDataset<Self, SingleExample> {
+ public:
+  using ExampleType = SingleExample;
+
+  /// Returns the example at the given index.
+  virtual ExampleType get(size_t index) = 0;
+
+  /// Writes the example at the given index into `slot`, whose tensors are
+  /// views of one row of the batch tensors. They must be written in place,
+  /// e.g. with `copy_()` or through their `data_ptr()`. The default
+  /// implementation copies the result of `get()`.
+  virtual void get_into(size_t index, ExampleType& slot) {
+    detail::copy_into_slot(get(index), slot);
+  }
+
+  /// Returns the stacked batch of the examples at the given indices.
+  ExampleType get_batch(ArrayRef<size_t> indices) override {
+    TORCH_CHECK(!indices.empty(), "StackedDataset got an empty batch request");
+    ExampleType first = get(indices[0]);
+    ExampleType batch = detail::new_stacked(first, indices.size());
+    ExampleType first_slot = detail::slot_of(batch, 0);
+    detail::copy_into_slot(first, first_slot);
+    for (size_t i = 1; i < indices.size(); ++i) {
+      const ExampleType row = detail::slot_of(batch, i);
+      ExampleType slot = row;
+      get_into(indices[i], slot);
+      detail::check_slot(slot, row);
+    }
+    return batch;
+  }
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <mutex>
 #include <queue>
+#include <utility>
 
 namespace torch {
 namespace data {
@@ -55,7 +56,7 @@ class Queue {
       cv_.wait(lock, [this] { return !this->queue_.empty(); });
     }
     AT_ASSERT(!queue_.empty());
-    T value = queue_.front();
+    T value = std::move(queue_.front());
     queue_.pop();
     lock.unlock();
     return value;
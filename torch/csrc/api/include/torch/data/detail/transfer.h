@@ -0,0 +1,109 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <c10/util/Optional.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Where the `DataLoader` moves the tensors of each batch before handing it
+/// out: into pinned (page-locked) memory, and/or onto a device.
+struct Transfer {
+  bool pin_memory = false;
+  optional<Device> device;
+
+  /// Whether batches are left as they are.
+  bool is_noop() const noexcept {
+    return !pin_memory && !device.has_value();
+  }
+};
+
+/// Applies a `Transfer` to every tensor of a batch. Batches may be tensors,
+/// `Example`s, `optional`s or `vector`s of those; values of any other type are
+/// returned unchanged, since there is no way to know which tensors they hold.
+///
+/// Copies to a device are non-blocking when the memory is pinned, so that when
+/// called from a worker thread the copy of a batch can overlap with the main
+/// thread enqueuing work for the previous one.
+inline Tensor transfer(Tensor tensor, const Transfer& options) {
+  if (!tensor.defined()) {
+    return tensor;
+  }
+  if (options.pin_memory && tensor.device().is_cpu()) {
+    tensor = tensor.pin_memory();
+  }
+  if (options.device && tensor.device() != *options.device) {
+    tensor = tensor.to(
+        *options.device,
+        tensor.scalar_type(),
+        /*non_blocking=*/options.pin_memory);
+  }
+  return tensor;
+}
+
+template <typename T>
+T transfer(T value, const Transfer& options);
+
+template <typename Data, typename Target>
+Example<Data, Target> transfer(
+    Example<Data, Target> example,
+    const Transfer& options);
+
+template <typename Data>
+Example<Data, example::NoTarget> transfer(
+    Example<Data, example::NoTarget> example,
+    const Transfer& options);
+
+template <typename T>
+optional<T> transfer(optional<T> value, const Transfer& options);
+
+template <typename T>
+std::vector<T> transfer(std::vector<T> values, const Transfer& options);
+
+template <typename T>
+T transfer(T value, const Transfer& /*options*/) {
+  return value;
+}
+
+template <typename Data, typename Target>
+Example<Data, Target> transfer(
+    Example<Data, Target> example,
+    const Transfer& options) {
+  example.data = transfer(std::move(example.data), options);
+  example.target = transfer(std::move(example.target), options);
+  return example;
+}
+
+template <typename Data>
+Example<Data, example::NoTarget> transfer(
+    Example<Data, example::NoTarget> example,
+    const Transfer& options) {
+  example.data = transfer(std::move(example.data), options);
+  return example;
+}
+
+template <typename T>
+optional<T> transfer(optional<T> value, const Transfer& options) {
+  if (value) {
+    value = transfer(std::move(*value), options);
+  }
+  return value;
+}
+
+template <typename T>
+std::vector<T> transfer(std::vector<T> values, const Transfer& options) {
+  for (auto& value : values) {
+    value = transfer(std::move(value), options);
+  }
+  return values;
+}
+
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -795,6 +795,42 @@ inline std::tuple<Tensor, Tensor> multi_head_attention_forward(
         }, /*dim=*/1);
     }
   }
+  if (!need_weights && (!training || dropout_p == 0)) {
+    // Without the attention weights, the fused kernel computes the attention
+    // blockwise instead of materializing the [tgt_len, src_len] matrix of
+    // every head
+    Tensor mask = attn_mask_;
+    if (mask.defined()) {
+      if (mask.dim() == 3) {
+        mask = mask.view({bsz, num_heads, tgt_len, src_len});
+      }
+      if (mask.scalar_type() == torch::kBool) {
+        mask = torch::zeros(
+          mask.sizes(),
+          at::TensorOptions(q.dtype()).device(q.device())
+        ).masked_fill_(mask, -std::numeric_limits<double>::infinity());
+      } else {
+        mask = mask.to(q.dtype());
+      }
+    }
+    if (key_padding_mask_.defined()) {
+      auto padding_mask = torch::zeros(
+        {bsz, 1, 1, src_len},
+        at::TensorOptions(q.dtype()).device(q.device())
+      ).masked_fill_(
+        key_padding_mask_.to(torch::kBool).view({bsz, 1, 1, src_len}),
+        -std::numeric_limits<double>::infinity());
+      mask = mask.defined() ? mask + padding_mask : padding_mask;
+    }
+    auto attn_output = std::get<0>(torch::_fused_attention(
+      q.view({bsz, num_heads, tgt_len, head_dim}),
+      k.view({bsz, num_heads, src_len, head_dim}),
+      v.view({bsz, num_heads, src_len, head_dim}),
+      mask));
+    attn_output = attn_output.permute({2, 0, 1, 3}).contiguous().view({tgt_len, bsz, embed_dim});
+    attn_output = F::linear(attn_output, out_proj_weight, out_proj_bias);
+    return std::make_tuple(attn_output, Tensor());
+  }
   auto attn_output_weights = torch::bmm(q, k.transpose(1, 2));
   TORCH_CHECK(attn_output_weights.sizes() == IntArrayRef({bsz * num_heads, tgt_len, src_len}));
   if (attn_mask_.defined()) {
@@ -7,7 +7,10 @@
 
 #include <torch/csrc/autograd/functions/comm.h>
 #include <torch/csrc/autograd/functions/utils.h>
+#include <torch/csrc/cuda/comm.h>
 #include <ATen/core/functional.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDACachingAllocator.h>
 
 #include <ATen/Device.h>
 #include <ATen/Parallel.h>
@@ -283,6 +286,167 @@ Tensor data_parallel(
       .front();
 }
 
+/// Keeps replicas of a module on a list of devices across iterations of
+/// `data_parallel`, instead of replicating the module on every call. When the
+/// replicas are asked for, the parameters and buffers of the module that
+/// changed since, e.g. in an optimizer step, are broadcast into the replicas
+/// in-place, through NCCL when it is available. The replicas are created anew
+/// if the shapes of the module's tensors changed, or the tensors were replaced.
+///
+/// \rst
+/// .. code-block:: cpp
+///
+///   torch::nn::parallel::ReplicaCache<Net> replicas(model, devices);
+///   for (auto& batch : *data_loader) {
+///     auto output = torch::nn::parallel::data_parallel(replicas, batch.data);
+///     ...
+///     optimizer.step();
+///   }
+/// \endrst
+template <typename ModuleType>
+class ReplicaCache {
+ public:
+  ReplicaCache(ModuleType module, std::vector<Device> devices)
+      : module_(std::move(module)), devices_(std::move(devices)) {
+    TORCH_CHECK(!devices_.empty(), "Expected at least one device to replicate to");
+  }
+
+  /// Returns the replicas, one per device, up to date with the module.
+  std::vector<ModuleType>& replicas() {
+    auto sources = module_->parameters();
+    for (auto& buffer : module_->buffers()) {
+      sources.push_back(std::move(buffer));
+    }
+    if (!can_update(sources)) {
+      replicas_ = replicate(module_, devices_);
+      targets_.assign(sources.size(), {});
+      for (auto& replica : replicas_) {
+        auto replica_sources = replica->parameters();
+        for (auto& buffer : replica->buffers()) {
+          replica_sources.push_back(std::move(buffer));
+        }
+        for (size_t i = 0; i < sources.size(); ++i) {
+          // Written to without recording history, or bumping the version of
+          // the replica's tensor.
+          targets_[i].push_back(replica_sources[i].variable_data());
+        }
+      }
+    } else {
+      NoGradGuard no_grad;
+      for (size_t i = 0; i < sources.size(); ++i) {
+        if (sources_[i].data_ptr() != sources[i].data_ptr() ||
+            versions_[i] != version_of(sources[i])) {
+          broadcast_into(sources[i], targets_[i]);
+        }
+      }
+    }
+    sources_ = std::move(sources);
+    versions_.clear();
+    for (const auto& source : sources_) {
+      versions_.push_back(version_of(source));
+    }
+    return replicas_;
+  }
+
+  const std::vector<Device>& devices() const {
+    return devices_;
+  }
+
+  const ModuleType& module() const {
+    return module_;
+  }
+
+ private:
+  // Whether the tensors of the replicas still are copies of `sources`.
+  bool can_update(const std::vector<Tensor>& sources) const {
+    if (replicas_.empty() || sources.size() != sources_.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < sources.size(); ++i) {
+      if (!sources[i].is_same(sources_[i]) ||
+          sources[i].sizes() != targets_[i].front().sizes() ||
+          sources[i].dtype() != targets_[i].front().dtype()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static uint32_t version_of(const Tensor& tensor) {
+    return tensor.unsafeGetTensorImpl()->version_counter().current_version();
+  }
+
+  static void broadcast_into(const Tensor& source, std::vector<Tensor>& targets) {
+    std::vector<Tensor> peers;
+    for (auto& target : targets) {
+      if (source.is_cuda() && target.device() != source.device()) {
+        peers.push_back(target);
+      } else {
+        target.copy_(source, /*non_blocking=*/true);
+      }
+    }
+    if (!peers.empty()) {
+      torch::cuda::broadcast_out(source, peers);
+    }
+  }
+
+  ModuleType module_;
+  std::vector<Device> devices_;
+  std::vector<ModuleType> replicas_;
+  // The parameters and buffers of the module, and their versions, as of the
+  // last call of replicas().
+  std::vector<Tensor> sources_;
+  std::vector<uint32_t> versions_;
+  // The tensors of the replicas corresponding to every tensor of sources_.
+  std::vector<std::vector<Tensor>> targets_;
+};
+
+/// Like `data_parallel` above, with the replicas of `replicas`. The input is
+/// scattered on side streams of the devices, so that the copies don't wait
+/// for the work of the previous iteration still queued on the replicas'
+/// devices, such as the gather of its outputs.
+template <typename ModuleType>
+Tensor data_parallel(
+    ReplicaCache<ModuleType>& replicas,
+    Tensor input,
+    optional<Device> output_device = nullopt,
+    int64_t dim = 0) {
+  auto devices = replicas.devices();
+  if (!output_device) {
+    output_device = devices.front();
+  }
+
+  std::vector<c10::optional<at::cuda::CUDAStream>> streams;
+  streams.reserve(devices.size());
+  for (const auto& device : devices) {
+    streams.emplace_back(at::cuda::getStreamFromPool(
+        /*isHighPriority=*/false, device.index()));
+  }
+  autograd::Scatter scatter(devices, /*chunk_sizes=*/nullopt, dim, streams);
+  auto scattered_inputs = fmap<Tensor>(scatter.apply({input}));
+  for (size_t i = 0; i < scattered_inputs.size(); ++i) {
+    if (devices[i] == input.device()) {
+      continue;
+    }
+    // The replicas run on the current streams
+    const auto current = at::cuda::getCurrentCUDAStream(devices[i].index());
+    at::cuda::CUDAEvent copied;
+    copied.record(*streams[i]);
+    copied.block(current);
+    c10::cuda::CUDACachingAllocator::recordStream(
+        scattered_inputs[i].storage().data_ptr(), current);
+  }
+
+  auto& all_replicas = replicas.replicas();
+  std::vector<ModuleType> used_replicas(
+      all_replicas.begin(), all_replicas.begin() + scattered_inputs.size());
+  devices.resize(scattered_inputs.size());
+  auto outputs = parallel_apply(used_replicas, scattered_inputs, devices);
+  return autograd::Gather(*output_device, dim)
+      .apply(fmap<autograd::Variable>(std::move(outputs)))
+      .front();
+}
+
 } // namespace parallel
 } // namespace nn
 } // namespace torch
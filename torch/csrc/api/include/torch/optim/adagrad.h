@@ -26,6 +26,10 @@ struct TORCH_API AdagradOptions : public OptimizerCloneableOptions<AdagradOption
   TORCH_ARG(double, weight_decay) = 0;
   TORCH_ARG(double, initial_accumulator_value) = 0;
   TORCH_ARG(double, eps) = 1e-10;
+  /// Keep a single accumulator per row (the first dimension) of each
+  /// parameter, which grows by the mean of the squared gradient of the row,
+  /// instead of one accumulator per element.
+  TORCH_ARG(bool, rowwise) = false;
 public:
   void serialize(torch::serialize::InputArchive& archive) override;
   void serialize(torch::serialize::OutputArchive& archive) const override;
@@ -55,10 +59,16 @@ class TORCH_API Adagrad : public Optimizer {
     TORCH_CHECK(defaults.eps() >= 0, "Invalid epsilon value: ", defaults.eps());
 
     for (const auto& group : param_groups_) {
+      const bool rowwise = static_cast<const AdagradOptions&>(group.options()).rowwise();
       for (const auto& p : group.params()) {
         auto state = std::make_unique<AdagradParamState>();
         state->step(0);
-        state->sum(torch::full_like(p.data(), defaults.initial_accumulator_value(), at::MemoryFormat::Preserve));
+        if (rowwise) {
+          TORCH_CHECK(p.dim() >= 1, "rowwise Adagrad expects parameters with at least one dimension");
+          state->sum(torch::full({p.size(0)}, defaults.initial_accumulator_value(), p.options()));
+        } else {
+          state->sum(torch::full_like(p.data(), defaults.initial_accumulator_value(), at::MemoryFormat::Preserve));
+        }
         state_[c10::guts::to_string(p.unsafeGetTensorImpl())] = std::move(state);
       }
     }
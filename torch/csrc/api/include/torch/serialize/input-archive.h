@@ -94,6 +94,20 @@ class TORCH_API InputArchive final {
        const std::function<size_t(void)>& size_func,
        c10::optional<torch::Device> device = c10::nullopt);
 
+  /// Loads a delta checkpoint written by `OutputArchive::save_delta_to` from
+  /// the file at `filename`, and applies it on top of the loaded archive:
+  /// the values in the delta replace or add to the ones of the archive.
+  /// A checkpoint is restored by loading its base checkpoint with
+  /// `load_from`, then applying the chain of deltas in the order they were
+  /// saved.
+  void load_delta_from(const std::string& filename,
+      c10::optional<torch::Device> device = c10::nullopt);
+
+  /// Loads a delta checkpoint from the given `stream`, and applies it on top
+  /// of the loaded archive.
+  void load_delta_from(std::istream& stream,
+      c10::optional<torch::Device> device = c10::nullopt);
+
   // Returns the vector of keys in the input archive.
   std::vector<std::string> keys();
 
@@ -6,7 +6,9 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace at {
 class Tensor;
@@ -21,6 +23,35 @@ struct Module;
 
 namespace torch {
 namespace serialize {
+/// Remembers the version counters of the tensors of the checkpoints saved
+/// with `OutputArchive::save_delta_to`, so that the next delta checkpoint
+/// only contains the tensors modified since. Tensors are identified by their
+/// key in the archive hierarchy, e.g. `"fc.weight"`.
+///
+/// Changes that don't bump the version counter, such as ones through
+/// `tensor.data()` views made with `variable_data()`, aren't seen; `clear()`
+/// the tracker to write a full checkpoint after them.
+class TORCH_API CheckpointTracker {
+ public:
+  /// Returns whether `tensor` is not the tensor last recorded under `key`, or
+  /// was modified in-place since.
+  bool is_modified(const std::string& key, const Tensor& tensor) const;
+
+  /// Records the current version of `tensor` under `key`.
+  void record(const std::string& key, const Tensor& tensor);
+
+  /// Forgets all tensors, so that the next delta checkpoint is a full one.
+  void clear();
+
+ private:
+  struct Entry {
+    // Keeps the TensorImpl from being reused by another tensor.
+    c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl> impl;
+    uint32_t version;
+  };
+  std::unordered_map<std::string, Entry> entries_;
+};
+
 class TORCH_API OutputArchive final {
  public:
   explicit OutputArchive(std::shared_ptr<jit::CompilationUnit> cu);
@@ -64,6 +95,23 @@ class TORCH_API OutputArchive final {
   /// given writer function.
   void save_to(const std::function<size_t(const void*, size_t)>& func);
 
+  /// Saves a delta checkpoint of the `OutputArchive` into a file at
+  /// `filename`. It only contains the tensors that `tracker` reports as
+  /// modified, along with all non-tensor values, and records the versions
+  /// of all tensors in `tracker`. With an empty tracker the checkpoint is a
+  /// full one, which later delta checkpoints build on; see
+  /// `InputArchive::load_delta_from`.
+  void save_delta_to(const std::string& filename, CheckpointTracker& tracker);
+
+  /// Saves a delta checkpoint of the `OutputArchive` into the given `stream`.
+  void save_delta_to(std::ostream& stream, CheckpointTracker& tracker);
+
+  /// Saves a delta checkpoint of the `OutputArchive` using the given writer
+  /// function.
+  void save_delta_to(
+      const std::function<size_t(const void*, size_t)>& func,
+      CheckpointTracker& tracker);
+
   /// Forwards all arguments to `write()`.
   /// Useful for generic code that can be re-used for both `OutputArchive` and
   /// `InputArchive` (where `operator()` forwards to `read()`).
@@ -73,6 +121,12 @@ class TORCH_API OutputArchive final {
   }
 
  private:
+  // Returns a copy of `module_` without the tensors that aren't modified
+  // according to `tracker`, and appends all tensors to `tensors`.
+  jit::Module delta_module(
+      const CheckpointTracker& tracker,
+      std::vector<std::pair<std::string, Tensor>>& tensors) const;
+
   std::shared_ptr<jit::CompilationUnit> cu_;
   jit::Module module_;
 };
@@ -2,6 +2,7 @@
 
 #include <ATen/Parallel.h>
 #include <ATen/record_function.h>
+#include <c10/core/InferenceMode.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/api/include/torch/types.h>
 #include <cstdint>
@@ -66,6 +67,25 @@ using NoGradGuard = at::NoGradGuard;
 /// @endcode
 using AutoGradMode = at::AutoGradMode;
 
+/// A RAII, thread-local guard for code that never calls backward, e.g. when
+/// serving a model.
+///
+/// Calls skip the autograd kernels entirely, and tensors created in this mode
+/// don't track in-place updates; they can't be used in autograd later on.
+/// Unlike `NoGradGuard`, it doesn't change grad mode: combine the two if
+/// code in the scope checks `GradMode::is_enabled()`.
+///
+/// Example:
+/// @code
+/// torch::Tensor y;
+/// {
+///   torch::InferenceMode guard;
+///   y = model->forward(x);
+/// }
+/// std::cout << y.is_inference() << std::endl; // prints `true`
+/// @endcode
+using InferenceMode = c10::InferenceMode;
+
 /// Sets the global random seed for all newly created CPU and CUDA tensors.
 using at::manual_seed;
 
@@ -8,6 +8,7 @@
 #include <ATen/ATen.h>
 
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
@@ -19,7 +20,8 @@ bool operator==(const AdagradOptions& lhs, const AdagradOptions& rhs) {
           (lhs.lr_decay() == rhs.lr_decay()) &&
           (lhs.weight_decay() == rhs.weight_decay()) &&
           (lhs.initial_accumulator_value() == rhs.initial_accumulator_value()) &&
-          (lhs.eps() == rhs.eps());
+          (lhs.eps() == rhs.eps()) &&
+          (lhs.rowwise() == rhs.rowwise());
 }
 
 void AdagradOptions::serialize(torch::serialize::OutputArchive& archive) const {
@@ -28,6 +30,7 @@ void AdagradOptions::serialize(torch::serialize::OutputArchive& archive) const {
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(weight_decay);
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(initial_accumulator_value);
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(eps);
+  _TORCH_OPTIM_SERIALIZE_TORCH_ARG(rowwise);
 }
 
 void AdagradOptions::serialize(torch::serialize::InputArchive& archive) {
@@ -36,6 +39,11 @@ void AdagradOptions::serialize(torch::serialize::InputArchive& archive) {
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(double, weight_decay);
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(double, initial_accumulator_value);
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(double, eps);
+  // archives saved before `rowwise` was added use the elementwise update
+  c10::IValue rowwise_ivalue;
+  if (archive.try_read("rowwise", rowwise_ivalue)) {
+    rowwise(rowwise_ivalue.toBool());
+  }
 }
 
 bool operator==(const AdagradParamState& lhs, const AdagradParamState& rhs) {
@@ -81,7 +89,36 @@ Tensor Adagrad::step(LossClosure closure) {
       const auto clr = options.lr() /
           (1 + static_cast<double>(state.step() - 1) * options.lr_decay());
 
-      if (grad.is_sparse()) {
+      if (grad.is_sparse() && !grad.is_cuda() && grad.sparse_dim() == 1 &&
+          p.is_contiguous() && state.sum().is_contiguous() &&
+          at::isFloatingType(p.scalar_type()) && p.scalar_type() == grad.scalar_type()) {
+        // e.g. the weight of EmbeddingBag(sparse=true): update only the rows
+        // in the gradient, without coalescing it first.
+        torch::_fused_sparse_adagrad_(p, state.sum(), grad, clr, options.eps(), options.rowwise());
+      }
+      else if (options.rowwise()) {
+        std::vector<int64_t> row_shape(p.dim(), 1);
+        if (grad.is_sparse()) {
+          TORCH_CHECK(grad.sparse_dim() == 1, "rowwise Adagrad expects sparse gradients with one sparse dimension");
+          grad = grad.coalesce();
+          if (grad._nnz() == 0) {
+            continue;
+          }
+          const auto rows = grad._indices().select(0, 0);
+          const auto grad_values = grad._values();
+          state.sum().index_add_(0, rows, grad_values.pow(2).reshape({grad_values.size(0), -1}).mean(1));
+          row_shape[0] = grad_values.size(0);
+          const auto std = state.sum().index_select(0, rows).sqrt_().add_(options.eps());
+          p.index_add_(0, rows, (grad_values / std.view(row_shape)).mul_(-clr));
+        }
+        else {
+          state.sum().add_(grad.pow(2).reshape({grad.size(0), -1}).mean(1));
+          row_shape[0] = grad.size(0);
+          const auto std = state.sum().sqrt().add_(options.eps());
+          p.addcdiv_(grad, std.view(row_shape), -clr);
+        }
+      }
+      else if (grad.is_sparse()) {
         grad = grad.coalesce();
         auto grad_indices = grad._indices();
         auto grad_values = grad._values();
@@ -7,8 +7,10 @@
 
 #include <ATen/ATen.h>
 
+#include <array>
 #include <cmath>
 #include <functional>
+#include <map>
 
 namespace torch {
 namespace optim {
@@ -69,6 +71,9 @@ Tensor Adam::step(LossClosure closure)  {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    // Without amsgrad, the parameters at the same step are updated together
+    // by a fused kernel: params, grads, exp_avgs and exp_avg_sqs by step.
+    std::map<int64_t, std::array<std::vector<Tensor>, 4>> fused_updates;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -99,6 +104,14 @@ Tensor Adam::step(LossClosure closure)  {
       auto& max_exp_avg_sq = state.max_exp_avg_sq();
 
       state.step(state.step()+1);
+      if (!options.amsgrad()) {
+        auto& update = fused_updates[state.step()];
+        update[0].push_back(p);
+        update[1].push_back(grad);
+        update[2].push_back(exp_avg);
+        update[3].push_back(exp_avg_sq);
+        continue;
+      }
       auto beta1 = std::get<0>(options.betas());
       auto beta2 = std::get<1>(options.betas());
 
@@ -113,19 +126,31 @@ Tensor Adam::step(LossClosure closure)  {
       exp_avg.mul_(beta1).add_(grad, 1 - beta1);
       exp_avg_sq.mul_(beta2).addcmul_(grad, grad, 1 - beta2);
 
-      Tensor denom;
-      if(options.amsgrad()) {
-        // Maintains the maximum of all 2nd moment running avg. till now
-        torch::max_out(max_exp_avg_sq, exp_avg_sq, max_exp_avg_sq);
-        // Use the max. for normalizing running avg. of gradient
-        denom = (max_exp_avg_sq.sqrt() / sqrt(bias_correction2)).add_(options.eps());
-      } else {
-        denom = (exp_avg_sq.sqrt() / sqrt(bias_correction2)).add_(options.eps());
-      }
+      // Maintains the maximum of all 2nd moment running avg. till now
+      torch::max_out(max_exp_avg_sq, exp_avg_sq, max_exp_avg_sq);
+      // Use the max. for normalizing running avg. of gradient
+      auto denom = (max_exp_avg_sq.sqrt() / sqrt(bias_correction2)).add_(options.eps());
 
       auto step_size = options.lr() / bias_correction1;
       p.addcdiv_(exp_avg, denom, -step_size);
     }
+    auto& options = static_cast<AdamOptions&>(group.options());
+    for (auto& update : fused_updates) {
+      torch::_fused_adam_(
+          update.second[0],
+          update.second[1],
+          update.second[2],
+          update.second[3],
+          options.lr(),
+          std::get<0>(options.betas()),
+          std::get<1>(options.betas()),
+          options.eps(),
+          options.weight_decay(),
+          update.first);
+      for (auto& p : update.second[0]) {
+        torch::autograd::impl::bump_version(p);
+      }
+    }
   }
   return loss;
 }
@@ -66,10 +66,25 @@ Tensor SGD::step(LossClosure closure)  {
     auto dampening = options.dampening();
     auto nesterov = options.nesterov();
 
+    // Parameters that already have a momentum buffer are updated together
+    // by a fused kernel.
+    std::vector<Tensor> fused_params;
+    std::vector<Tensor> fused_grads;
+    std::vector<Tensor> fused_momentum_buffers;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
       }
+      if (momentum != 0 && !p.grad().is_sparse()) {
+        auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
+        if (param_state != state_.end()) {
+          fused_params.push_back(p.data());
+          fused_grads.push_back(p.grad().data());
+          fused_momentum_buffers.push_back(
+              static_cast<SGDParamState&>(*param_state->second).momentum_buffer());
+          continue;
+        }
+      }
       auto d_p = p.grad().data();
       if (weight_decay != 0) {
         d_p = d_p.add(p.data(), weight_decay);
@@ -94,6 +109,17 @@ Tensor SGD::step(LossClosure closure)  {
       }
       p.data().add_(d_p, -1 * options.lr());
     }
+    if (!fused_params.empty()) {
+      torch::_fused_sgd_(
+          fused_params,
+          fused_grads,
+          fused_momentum_buffers,
+          options.lr(),
+          momentum,
+          dampening,
+          weight_decay,
+          nesterov);
+    }
   }
   return loss;
 }
@@ -15,6 +15,26 @@
 
 namespace torch {
 namespace serialize {
+namespace {
+void apply_delta(jit::Module& module, const jit::Module& delta) {
+  const auto& type = delta.type();
+  for (size_t i = 0; i < type->numAttributes(); ++i) {
+    const auto name = type->getAttributeName(i);
+    const auto& value = delta._ivalue()->getSlot(i);
+    if (value.isModule() && module.hasattr(name) && module.attr(name).isModule()) {
+      auto child = module.attr(name).toModule();
+      apply_delta(child, value.toModule());
+    } else if (value.isModule()) {
+      module.register_module(name, value.toModule());
+    } else if (module.hasattr(name)) {
+      module.setattr(name, value);
+    } else {
+      module.register_attribute(
+          name, type->getAttribute(i), value, type->is_parameter(i), type->is_buffer(i));
+    }
+  }
+}
+} // namespace
 
 InputArchive::InputArchive() : module_("Module", std::make_shared<jit::CompilationUnit>()) {}
 
@@ -157,6 +177,16 @@ void InputArchive::load_from(
   module_ = torch::jit::load(std::move(adapter), std::move(device));
 }
 
+void InputArchive::load_delta_from(const std::string& filename,
+    c10::optional<torch::Device> device /*= c10::nullopt*/) {
+  apply_delta(module_, torch::jit::load(filename, std::move(device)));
+}
+
+void InputArchive::load_delta_from(std::istream& stream,
+    c10::optional<torch::Device> device /*= c10::nullopt*/) {
+  apply_delta(module_, torch::jit::load(stream, std::move(device)));
+}
+
 std::vector<std::string> InputArchive::keys() {
   std::vector<std::string> all_keys;
   all_keys.reserve(module_.named_attributes(/*recurse=*/false).size());
@@ -14,6 +14,66 @@
 
 namespace torch {
 namespace serialize {
+namespace {
+void delta_module_impl(
+    const jit::Module& module,
+    jit::Module& delta,
+    const std::shared_ptr<jit::CompilationUnit>& cu,
+    const std::string& prefix,
+    const CheckpointTracker& tracker,
+    std::vector<std::pair<std::string, Tensor>>& tensors) {
+  const auto& type = module.type();
+  for (size_t i = 0; i < type->numAttributes(); ++i) {
+    const auto name = type->getAttributeName(i);
+    const auto& value = module._ivalue()->getSlot(i);
+    const auto key = prefix + name;
+    if (value.isModule()) {
+      jit::Module delta_child("__torch__.Module", cu, /*shouldMangle=*/true);
+      delta_module_impl(value.toModule(), delta_child, cu, key + ".", tracker, tensors);
+      delta.register_module(name, delta_child);
+    } else if (value.isTensor()) {
+      const auto& tensor = value.toTensor();
+      tensors.emplace_back(key, tensor);
+      if (tracker.is_modified(key, tensor)) {
+        delta.register_attribute(
+            name, type->getAttribute(i), value, type->is_parameter(i), type->is_buffer(i));
+      }
+    } else {
+      delta.register_attribute(
+          name, type->getAttribute(i), value, type->is_parameter(i), type->is_buffer(i));
+    }
+  }
+}
+
+uint32_t version_of(const Tensor& tensor) {
+  return tensor.unsafeGetTensorImpl()->version_counter().current_version();
+}
+} // namespace
+
+bool CheckpointTracker::is_modified(const std::string& key, const Tensor& tensor) const {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return true;
+  }
+  const auto& entry = it->second;
+  // Inference tensors have no version counter to go by.
+  return entry.impl.expired() ||
+      entry.impl._unsafe_get_target() != tensor.unsafeGetTensorImpl() ||
+      tensor.unsafeGetTensorImpl()->is_inference() ||
+      entry.version != version_of(tensor);
+}
+
+void CheckpointTracker::record(const std::string& key, const Tensor& tensor) {
+  entries_[key] = Entry{
+      c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl>(
+          tensor.getIntrusivePtr()),
+      version_of(tensor)};
+}
+
+void CheckpointTracker::clear() {
+  entries_.clear();
+}
+
 OutputArchive::OutputArchive(std::shared_ptr<jit::CompilationUnit> cu)
     : cu_(std::move(cu)),
       module_("__torch__.Module", cu_, /*shouldMangle=*/true) {}
@@ -47,5 +107,45 @@ void OutputArchive::save_to(
     const std::function<size_t(const void*, size_t)>& func) {
   jit::ExportModule(module_, func);
 }
+
+jit::Module OutputArchive::delta_module(
+    const CheckpointTracker& tracker,
+    std::vector<std::pair<std::string, Tensor>>& tensors) const {
+  jit::Module delta("__torch__.Module", cu_, /*shouldMangle=*/true);
+  delta_module_impl(module_, delta, cu_, "", tracker, tensors);
+  return delta;
+}
+
+void OutputArchive::save_delta_to(
+    const std::string& filename,
+    CheckpointTracker& tracker) {
+  std::vector<std::pair<std::string, Tensor>> tensors;
+  jit::ExportModule(delta_module(tracker, tensors), filename);
+  // Only once the checkpoint is written, so that a failed save is retried in
+  // full.
+  for (const auto& kv : tensors) {
+    tracker.record(kv.first, kv.second);
+  }
+}
+
+void OutputArchive::save_delta_to(
+    std::ostream& stream,
+    CheckpointTracker& tracker) {
+  std::vector<std::pair<std::string, Tensor>> tensors;
+  jit::ExportModule(delta_module(tracker, tensors), stream);
+  for (const auto& kv : tensors) {
+    tracker.record(kv.first, kv.second);
+  }
+}
+
+void OutputArchive::save_delta_to(
+    const std::function<size_t(const void*, size_t)>& func,
+    CheckpointTracker& tracker) {
+  std::vector<std::pair<std::string, Tensor>> tensors;
+  jit::ExportModule(delta_module(tracker, tensors), func);
+  for (const auto& kv : tensors) {
+    tracker.record(kv.first, kv.second);
+  }
+}
 } // namespace serialize
 } // namespace torch
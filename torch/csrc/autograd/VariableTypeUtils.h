@@ -41,6 +41,11 @@ namespace torch { namespace autograd {
 
 inline void check_inplace(const Tensor& tensor) {
   auto& var = static_cast<const Variable&>(tensor);
+  // Checked here as well as in VariableVersion::bump so that the error comes
+  // before the update, not after it.
+  TORCH_CHECK(!var.is_inference(),
+    "Inplace update to inference tensor outside InferenceMode is not allowed. "
+    "You can make a clone to get a normal tensor before doing inplace update.");
   if (var.requires_grad() && GradMode::is_enabled()) {
     if (var.is_view()) {
       // NB: is_view() ==> get_autograd_meta()
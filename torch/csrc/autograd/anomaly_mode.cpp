@@ -3,6 +3,7 @@
 namespace torch { namespace autograd {
 
 bool AnomalyMode::_enabled = false;
+bool AnomalyMode::_lightweight_enabled = false;
 
 AnomalyMetadata::~AnomalyMetadata() = default;
 
@@ -13,8 +13,19 @@ struct TORCH_API AnomalyMode {
     _enabled = enabled;
   }
 
+  // The lightweight mode checks the outputs of the backward functions for nan
+  // and inf values, but doesn't record the forward stacks, and synchronizes
+  // once per backward pass. See Note [Lightweight anomaly detection].
+  static bool is_lightweight_enabled() {
+    return _lightweight_enabled;
+  }
+  static void set_lightweight_enabled(bool enabled) {
+    _lightweight_enabled = enabled;
+  }
+
 private:
   static bool _enabled;
+  static bool _lightweight_enabled;
 };
 
 
@@ -18,6 +18,7 @@
 #include <c10/util/Optional.h>
 #include <c10/core/StreamGuard.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -28,6 +29,8 @@
 #include <set>
 #include <string>
 #include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <typeinfo>
 #include <sstream>
@@ -404,6 +407,20 @@ auto Engine::thread_main(const std::shared_ptr<GraphTask>& graph_task) -> void {
         ready_queue_by_index(local_graph_task->cpu_ready_queue_, base_owner)
             ->push(NodeTask(local_graph_task, nullptr, InputBuffer(0)));
       }
+
+      // Likewise, the CPU helper threads and the owning thread may all be
+      // sleeping on the shared cpu_ready_queue_, and none of them is woken up
+      // above when the task is completed on a CPU thread. Wake all of them
+      // up, once.
+      const int num_helpers = local_graph_task->num_cpu_helper_threads_;
+      if (num_helpers > 0 &&
+          !local_graph_task->cpu_helpers_released_.exchange(true)) {
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i <= num_helpers; ++i) {
+          local_graph_task->cpu_ready_queue_->push(
+              NodeTask(local_graph_task, nullptr, InputBuffer(0)));
+        }
+      }
     }
   }
 }
@@ -476,6 +493,60 @@ void GraphTask::mark_as_completed_and_run_post_processing() {
   }
 }
 
+// Note [Lightweight anomaly detection]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The anomaly detection mode records the Python stack of every Node created
+// in the forward, and synchronizes with the device to check every output of
+// every backward function for nan values, which slows down training several
+// times. In the lightweight mode, evaluate_function reduces each floating
+// point output to its sum, in which nan and inf values propagate, and only
+// records whether the sum is finite, asynchronously. The checks are gathered
+// after all the leaf streams were synchronized with the default streams, so
+// that the whole backward pass only synchronizes once per device. Since no
+// stacks were recorded, a failure names the first function that returned
+// non finite values, with its sequence number (the one of its forward
+// operation in the profiler), and a breadcrumb of the functions that ran
+// before it. Running again with the full mode gives the traceback of its
+// forward call.
+static void check_lightweight_anomalies(
+    const std::vector<GraphTask::AnomalyCheck>& checks) {
+  std::unordered_map<c10::Device, std::vector<at::Tensor>> finite_by_device;
+  for (const auto& check : checks) {
+    finite_by_device[check.finite.device()].push_back(check.finite);
+  }
+  bool all_finite = true;
+  for (auto& entry : finite_by_device) {
+    c10::OptionalStreamGuard stream_guard;
+    if (entry.first.is_cuda()) {
+      const auto guard = c10::impl::VirtualGuardImpl{c10::DeviceType::CUDA};
+      stream_guard.reset_stream(guard.getDefaultStream(entry.first));
+    }
+    all_finite &= at::stack(entry.second).all().item<bool>();
+  }
+  if (all_finite) {
+    return;
+  }
+
+  constexpr size_t kBreadcrumbSize = 8;
+  for (size_t i = 0; i < checks.size(); ++i) {
+    const auto& check = checks[i];
+    if (check.finite.item<bool>()) {
+      continue;
+    }
+    std::stringstream ss;
+    ss << "Function '" << check.node_name << "' (sequence number "
+       << check.sequence_nr << ") returned nan or inf values in its "
+       << check.output_nr << "th output. Functions that ran before it:";
+    for (size_t j = i > kBreadcrumbSize ? i - kBreadcrumbSize : 0; j < i;
+         ++j) {
+      ss << " '" << checks[j].node_name << "'";
+    }
+    ss << ". Enable the full anomaly detection for the traceback of the "
+       << "forward call that created it.";
+    throw std::runtime_error(ss.str());
+  }
+}
+
 void GraphTask::exec_post_processing() {
   if (!not_ready_.empty()) {
     throw std::runtime_error("could not compute gradients for some functions");
@@ -509,6 +580,10 @@ void GraphTask::exec_post_processing() {
       default_stream.wait(event);
     }
   }
+
+  if (!anomaly_checks_.empty()) {
+    check_lightweight_anomalies(anomaly_checks_);
+  }
 }
 
 void GraphTask::set_exception_without_signal(const std::shared_ptr<Node>& fn) {
@@ -641,8 +716,10 @@ static variable_list call_function(
   checkpoint_valid =
       graph_task->can_checkpoint() && prev_checkpoint_valid_state;
   auto& fn = *func;
-  auto inputs =
-      call_pre_hooks(fn, InputBuffer::variables(std::move(inputBuffer)));
+  auto inputs = InputBuffer::variables(std::move(inputBuffer));
+  if (!fn.pre_hooks().empty()) {
+    inputs = call_pre_hooks(fn, std::move(inputs));
+  }
 
   if (!graph_task->keep_graph_) {
     fn.will_release_variables();
@@ -690,6 +767,58 @@ static variable_list call_function(
   return outputs;
 }
 
+// Note [Deterministic accumulation with CPU helper threads]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// With a single CPU thread the order in which the ready tasks run, and hence
+// the order in which the gradients flowing into a node are summed in its
+// InputBuffer, only depends on the graph. When several threads execute CPU
+// tasks, producers of the same node may finish in any order. As floating
+// point addition is not associative, the gradients reaching a node that is
+// not ready yet are then kept aside in GraphTask::pending_inputs_, and summed
+// in the order of (producer sequence number, producer output number) once the
+// last one arrives.
+static void stash_pending_input(
+    GraphTask& graph_task,
+    const Node& producer,
+    uint32_t producer_output_nr,
+    const Edge& next,
+    Variable&& variable,
+    const c10::optional<c10::Stream>& opt_producer_stream) {
+  graph_task.pending_inputs_[next.function.get()].push_back(
+      GraphTask::PendingInput{producer.sequence_nr(),
+                              producer_output_nr,
+                              next.input_nr,
+                              std::move(variable),
+                              opt_producer_stream});
+}
+
+static void add_pending_inputs(
+    GraphTask& graph_task,
+    Node* fn,
+    InputBuffer& input_buffer,
+    const c10::optional<c10::Stream>& opt_consumer_stream) {
+  auto it = graph_task.pending_inputs_.find(fn);
+  if (it == graph_task.pending_inputs_.end()) {
+    return;
+  }
+  auto& pending = it->second;
+  std::stable_sort(
+      pending.begin(),
+      pending.end(),
+      [](const GraphTask::PendingInput& a, const GraphTask::PendingInput& b) {
+        return std::tie(a.producer_sequence_nr, a.producer_output_nr) <
+            std::tie(b.producer_sequence_nr, b.producer_output_nr);
+      });
+  for (auto& input : pending) {
+    input_buffer.add(
+        input.input_nr,
+        std::move(input.variable),
+        input.producer_stream,
+        opt_consumer_stream);
+  }
+  graph_task.pending_inputs_.erase(it);
+}
+
 void Engine::evaluate_function(
     std::shared_ptr<GraphTask>& graph_task,
     Node* func,
@@ -749,9 +878,37 @@ void Engine::evaluate_function(
         throw std::runtime_error(ss.str());
       }
     }
+  } else if (AnomalyMode::is_lightweight_enabled()) {
+    // See Note [Lightweight anomaly detection]
+    AutoGradMode grad_mode(false);
+    std::vector<GraphTask::AnomalyCheck> checks;
+    for (int i = 0; i < num_outputs; ++i) {
+      const auto& output = outputs[i];
+      if (!output.defined() || output.is_sparse() ||
+          !(at::isFloatingType(output.scalar_type()) ||
+            at::isComplexType(output.scalar_type()))) {
+        continue;
+      }
+      at::OptionalDeviceGuard guard(device_of(output));
+      // Reduced (b)float16 values would overflow
+      const auto dtype = output.scalar_type();
+      auto sum = (dtype == at::kHalf || dtype == at::kBFloat16)
+          ? output.sum(at::kFloat)
+          : output.sum();
+      checks.push_back({fn.name(), fn.sequence_nr(), static_cast<size_t>(i),
+                        at::isfinite(sum)});
+    }
+    std::lock_guard<std::mutex> lock(graph_task->mutex_);
+    for (auto& check : checks) {
+      graph_task->anomaly_checks_.push_back(std::move(check));
+    }
   }
 
-  // Lock mutex for the accesses to GraphTask dependencies_, not_ready_ and cpu_ready_queue_ below
+  // See Note [Deterministic accumulation with CPU helper threads]
+  const bool defer_accumulation = graph_task->num_cpu_helper_threads_ > 0;
+
+  // Lock mutex for the accesses to GraphTask dependencies_, not_ready_,
+  // pending_inputs_ and cpu_ready_queue_ below
   std::lock_guard<std::mutex> lock(graph_task->mutex_);
   for (int i = 0; i < num_outputs; ++i) {
     auto& output = outputs[i];
@@ -787,10 +944,15 @@ void Engine::evaluate_function(
 
       // Accumulates into buffer
       const auto opt_next_stream = next.function->stream(c10::DeviceType::CUDA);
-      input_buffer.add(next.input_nr,
-                       std::move(output),
-                       opt_parent_stream,
-                       opt_next_stream);
+      if (defer_accumulation && !is_ready) {
+        stash_pending_input(
+            *graph_task, fn, i, next, std::move(output), opt_parent_stream);
+      } else {
+        input_buffer.add(next.input_nr,
+                         std::move(output),
+                         opt_parent_stream,
+                         opt_next_stream);
+      }
 
       if (is_ready) {
         auto queue = ready_queue(cpu_ready_queue, input_buffer.device());
@@ -805,10 +967,19 @@ void Engine::evaluate_function(
 
       // Accumulates into buffer
       const auto opt_next_stream = next.function->stream(c10::DeviceType::CUDA);
-      input_buffer.add(next.input_nr,
-                       std::move(output),
-                       opt_parent_stream,
-                       opt_next_stream);
+      if (defer_accumulation) {
+        stash_pending_input(
+            *graph_task, fn, i, next, std::move(output), opt_parent_stream);
+        if (is_ready) {
+          add_pending_inputs(
+              *graph_task, next.function.get(), input_buffer, opt_next_stream);
+        }
+      } else {
+        input_buffer.add(next.input_nr,
+                         std::move(output),
+                         opt_parent_stream,
+                         opt_next_stream);
+      }
       if (is_ready) {
         auto queue = ready_queue(cpu_ready_queue, input_buffer.device());
         queue->push(
@@ -903,9 +1074,17 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
     // set the graph_task owner to the current device
     graph_task->owner_ = worker_device;
 
+    // Threads from the reentrant pool help the owning thread with the CPU
+    // tasks: reentrant_thread_init() points them at the owner's ready queue.
+    const int num_helpers = num_cpu_threads_.load() - 1;
+    graph_task->num_cpu_helper_threads_ = std::max(0, num_helpers);
+
     // The owning thread start to drive the engine execution with the GraphTask
     // that has already been pushed to the current CPU thread's ready_queue
     lock.unlock();
+    for (int i = 0; i < num_helpers; ++i) {
+      add_thread_pool_task(graph_task);
+    }
     thread_main(graph_task);
     TORCH_INTERNAL_ASSERT(graph_task->future_result_->completed());
     // reset the worker_device after the completion of the graph_task, this is so
@@ -979,6 +1158,18 @@ bool Engine::is_checkpoint_valid() {
   return checkpoint_valid;
 }
 
+void Engine::set_num_cpu_threads(int num_threads) {
+  TORCH_CHECK(
+      num_threads >= 1,
+      "The number of autograd CPU threads must be positive, but got ",
+      num_threads);
+  num_cpu_threads_.store(num_threads);
+}
+
+int Engine::num_cpu_threads() const {
+  return num_cpu_threads_.load();
+}
+
 void Engine::init_local_ready_queue(std::shared_ptr<ReadyQueue> ready_queue) {
   if (ready_queue) {
     // if ready_queue provided in the caller, use the caller's ready_queue to initialize local_ready_queue
@@ -155,6 +155,37 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
   // tasks are done.
   std::shared_ptr<FutureVariableList> future_result_;
 
+  // Number of threads, besides the owning thread, that execute the CPU tasks
+  // of this GraphTask from cpu_ready_queue_; see Engine::set_num_cpu_threads.
+  // Set before any task of the GraphTask runs, safe to read without
+  // synchronization afterwards.
+  int num_cpu_helper_threads_ = 0;
+  // Set by the thread that wakes up the helper threads once this GraphTask is
+  // completed, so that they are only woken up once.
+  std::atomic_bool cpu_helpers_released_{false};
+
+  // See Note [Deterministic accumulation with CPU helper threads]
+  struct PendingInput {
+    uint64_t producer_sequence_nr;
+    uint32_t producer_output_nr;
+    uint32_t input_nr;
+    Variable variable;
+    c10::optional<c10::Stream> producer_stream;
+  };
+  // Protected by mutex_.
+  std::unordered_map<Node*, std::vector<PendingInput>> pending_inputs_;
+
+  // See Note [Lightweight anomaly detection]
+  struct AnomalyCheck {
+    std::string node_name;
+    uint64_t sequence_nr;
+    size_t output_nr;
+    // Whether the sum of the output is finite, 0-dim bool tensor
+    at::Tensor finite;
+  };
+  // Protected by mutex_.
+  std::vector<AnomalyCheck> anomaly_checks_;
+
   // Final callbacks installed during execution of this GraphTask
   std::vector<std::function<void()>> final_callbacks_;
   // To protect reads and writes to final_callbacks_. Intentionally no reusing
@@ -219,7 +250,9 @@ struct NodeTask {
 struct ReadyQueue {
  private:
   // Returns true when t2 should be (weakly) BEFORE t1 in the queue.
-  // Shutdown tasks are first and then empty NodeTask are next.
+  // Shutdown tasks are first and then empty NodeTask are next. Other tasks
+  // are ordered by reentrant depth, then by Node::priority(), then by
+  // sequence number.
   struct CompareNodeTaskTime {
     bool operator()(NodeTask const & t1, NodeTask const & t2) {
       if (t2.isShutdownTask_) {
@@ -229,6 +262,11 @@ struct ReadyQueue {
       } else if (!t2.fn_) {
         return true;
       } else if (t1.getReentrantDepth() == t2.getReentrantDepth()) {
+        const auto p1 = t1.fn_->priority();
+        const auto p2 = t2.fn_->priority();
+        if (p1 != p2) {
+          return p1 < p2;
+        }
         return t1.fn_->sequence_nr() < t2.fn_->sequence_nr();
       } else {
         return t1.getReentrantDepth() < t2.getReentrantDepth();
@@ -312,6 +350,13 @@ struct TORCH_API Engine {
   // Should be called after fork to notify that worker threads are gone
   void release_workers();
 
+  // Sets the number of threads, including the calling thread, that execute
+  // the ready CPU nodes of a backward pass started from a CPU thread. The
+  // additional threads come from the thread pool used for reentrant
+  // backwards. The default of 1 runs all CPU nodes on the calling thread.
+  void set_num_cpu_threads(int num_threads);
+  int num_cpu_threads() const;
+
   // Initializes a device thread for the autograd engine.
   virtual void thread_init(
       int device,
@@ -354,6 +399,9 @@ struct TORCH_API Engine {
   // How many nested reentrant calls are allowed until a new thread is used
   int max_recursion_depth_;
 
+  // See set_num_cpu_threads()
+  std::atomic<int> num_cpu_threads_{1};
+
   struct ThreadPoolShared {
     // Data structures used by the threads for executing reentrant backwards
     // tasks. See Note [Reentrant backwards]
@@ -14,6 +14,7 @@
 #include <c10/util/Exception.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <initializer_list>
 #include <memory>
@@ -87,8 +88,9 @@ TORCH_API void deleteNode(Node* function);
 struct TORCH_API Node : std::enable_shared_from_this<Node> {
  public:
   /// Construct a new `Node` with the given `next_edges`. `sequence_nr` is
-  /// a (currently THE) hint to prioritization in the backward() pass, with
-  /// higher sequence numbers prioritized before lower sequence numbers.
+  /// a hint to prioritization in the backward() pass, with higher sequence
+  /// numbers prioritized before lower sequence numbers. It is only consulted
+  /// between ready nodes of the same `priority()`.
   explicit Node(
       uint64_t sequence_nr,
       edge_list&& next_edges = edge_list())
@@ -221,6 +223,21 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
     return sequence_nr_;
   }
 
+  /// The scheduling priority of this `Node` in the backward pass. Among the
+  /// nodes that are ready to run on the same device (and at the same
+  /// reentrant depth), the engine runs those with a higher priority first,
+  /// and falls back to `sequence_nr()` between equal priorities. Defaults to
+  /// 0. Since only ready nodes are ordered, priorities never change the
+  /// result of the pass, only the order in which independent nodes run; DDP
+  /// uses them to produce the gradients of the first bucket early.
+  int64_t priority() const noexcept {
+    return priority_.load(std::memory_order_relaxed);
+  }
+
+  void set_priority(int64_t priority) noexcept {
+    priority_.store(priority, std::memory_order_relaxed);
+  }
+
   /// Returns the name of the dynamic type of the function, for debugging.
   virtual std::string name() const;
 
@@ -346,6 +363,10 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   // fields.
   const uint64_t sequence_nr_;
 
+  // Set from outside the engine (e.g. by the DDP Reducer) while other
+  // threads may be ordering ready tasks, hence atomic.
+  std::atomic<int64_t> priority_{0};
+
   // Note [Thread Safety on Autograd Node]
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   // Autograd Engine let the owning thread which calls Engine::execute to drive the
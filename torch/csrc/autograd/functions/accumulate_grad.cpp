@@ -5,6 +5,7 @@
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/autograd/functions/tensor.h>
 #include <torch/csrc/autograd/functions/utils.h>
+#include <torch/csrc/autograd/grad_mode.h>
 
 #include <cstdint>
 #include <stdexcept>
@@ -22,6 +23,48 @@ AccumulateGrad::AccumulateGrad(Variable variable_)
   add_input_metadata(variable);
 }
 
+AccumulateGrad::~AccumulateGrad() {
+  auto entry = grad_ready_callbacks_.load();
+  while (entry) {
+    auto next = entry->next;
+    delete entry;
+    entry = next;
+  }
+}
+
+uintptr_t AccumulateGrad::add_grad_ready_callback(
+    GradReadyCallback callback,
+    void* context,
+    size_t key) {
+  auto entry = new GradReadyEntry{callback, context, key};
+  entry->next = grad_ready_callbacks_.load(std::memory_order_relaxed);
+  while (!grad_ready_callbacks_.compare_exchange_weak(
+      entry->next, entry, std::memory_order_release)) {
+  }
+  return reinterpret_cast<uintptr_t>(entry);
+}
+
+bool AccumulateGrad::del_grad_ready_callback(uintptr_t handle) {
+  for (auto entry = grad_ready_callbacks_.load(std::memory_order_acquire);
+       entry;
+       entry = entry->next) {
+    if (reinterpret_cast<uintptr_t>(entry) == handle) {
+      return !entry->deleted.exchange(true);
+    }
+  }
+  return false;
+}
+
+void AccumulateGrad::notify_grad_ready() const {
+  for (auto entry = grad_ready_callbacks_.load(std::memory_order_acquire);
+       entry;
+       entry = entry->next) {
+    if (!entry->deleted.load(std::memory_order_acquire)) {
+      entry->callback(entry->context, entry->key);
+    }
+  }
+}
+
 auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
   check_input_variables("AccumulateGrad", grads, 1, 0);
 
@@ -43,21 +86,44 @@ auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
   // when updating the gradients. We don't ensure thread safety on hooks
   // and rely on user to provide thread safe hooks
   // see Note [Thread Safety on Autograd Node]
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  // If the function has post hooks (for example, a DDP allreduce hook),
-  // call_function in Engine.cpp will temporarily bump the expected refcount
-  // by one, hence the addition of !post_hooks().empty() for 'num_expected_refs'
-  // in addition to the one reference that we're holding.
-  // 'num_expected_refs' is used to determine whether or not we should clone
-  // the grad or can steal the grad.
-  accumulateGrad(
-      variable,
-      grad,
-      new_grad,
-      1 + !post_hooks().empty() /* num_expected_refs */,
-      [&grad](at::Tensor&& grad_update) { grad = std::move(grad_update); });
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // A preallocated grad (see impl::preallocate_grad) that was reset is
+    // overwritten in place, which also zero fills it.
+    bool copied_into_buffer = false;
+    if (!grad.defined() && !GradMode::is_enabled() && !new_grad.is_sparse()) {
+      const auto& buffer = impl::get_autograd_meta(variable)->grad_buffer_;
+      if (buffer.defined() && buffer.sizes() == variable.sizes() &&
+          buffer.scalar_type() == variable.scalar_type() &&
+          buffer.device() == variable.device() &&
+          utils::obeys_layout_contract(buffer, variable)) {
+        grad = buffer;
+        grad.copy_(new_grad);
+        copied_into_buffer = true;
+      }
+    }
+
+    if (!copied_into_buffer) {
+      // If the function has post hooks (for example, a user hook),
+      // call_function in Engine.cpp will temporarily bump the expected
+      // refcount by one, hence the addition of !post_hooks().empty() for
+      // 'num_expected_refs' in addition to the one reference that we're
+      // holding. 'num_expected_refs' is used to determine whether or not we
+      // should clone the grad or can steal the grad. The grad ready
+      // callbacks don't hold any reference.
+      accumulateGrad(
+          variable,
+          grad,
+          new_grad,
+          1 + !post_hooks().empty() /* num_expected_refs */,
+          [&grad](at::Tensor&& grad_update) {
+            grad = std::move(grad_update);
+          });
+    }
+  }
 
+  notify_grad_ready();
   return variable_list();
 }
 }} // namespace torch::autograd
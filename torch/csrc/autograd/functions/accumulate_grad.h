@@ -5,6 +5,7 @@
 #include <torch/csrc/autograd/utils/grad_layout_contract.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <atomic>
 #include <mutex>
 
 namespace torch { namespace autograd {
@@ -23,9 +24,25 @@ namespace torch { namespace autograd {
 
 struct TORCH_API AccumulateGrad : public Node {
   explicit AccumulateGrad(Variable variable_);
+  ~AccumulateGrad() override;
 
   variable_list apply(variable_list&& grads) override;
 
+  // Called with its context and key after each accumulation of the grad,
+  // for "grad ready" notifications like those of DDP (c10d::Reducer).
+  // Unlike a post hook it isn't a std::function, and the engine doesn't
+  // keep a copy of the inputs for it, so the incoming grad can still be
+  // stolen instead of cloned.
+  using GradReadyCallback = void (*)(void* context, size_t key);
+
+  // Returns a handle for del_grad_ready_callback. The callbacks are a lock
+  // free list, they can be added and deleted while the backward runs.
+  uintptr_t add_grad_ready_callback(
+      GradReadyCallback callback,
+      void* context,
+      size_t key);
+  bool del_grad_ready_callback(uintptr_t handle);
+
   static at::Tensor callHooks(
       const Variable& variable,
       at::Tensor new_grad) {
@@ -207,6 +224,20 @@ struct TORCH_API AccumulateGrad : public Node {
   }
 
   Variable variable;
+
+ private:
+  void notify_grad_ready() const;
+
+  // Only ever prepended to, a deleted callback is marked as such and freed
+  // with the node, so that the readers never see a dangling entry
+  struct GradReadyEntry {
+    GradReadyCallback callback;
+    void* context;
+    size_t key;
+    std::atomic<bool> deleted{false};
+    GradReadyEntry* next;
+  };
+  std::atomic<GradReadyEntry*> grad_ready_callbacks_{nullptr};
 };
 
 #undef CHECK_RESULT
@@ -24,8 +24,10 @@ namespace torch { namespace autograd { namespace profiler {
 
 namespace {
 
-  constexpr auto kProfilerConfigIValuesSize = 3;
-  constexpr auto kEventIValuesSize = 11;
+  constexpr auto kProfilerConfigIValuesSize = 4;
+  constexpr auto kEventIValuesSize = 15;
+  // Events serialized before kernel events were added
+  constexpr auto kEventIValuesMinSize = 11;
   enum EventIValueIdx {
     KIND = 0,
     NAME,
@@ -37,13 +39,18 @@ namespace {
     CUDA_RECORDED,
     CUDA_MEM_USAGE,
     CUDA_DEVICE,
-    CUDA_US
+    CUDA_US,
+    STREAM,
+    DEVICE_DURATION_NS,
+    MEMORY_ADDRESS,
+    PERF_COUNTERS
   };
 
   enum ProfilerIValueIdx {
     STATE = 0,
     REPORT_INPUT_SHAPES,
     PROFILE_MEMORY,
+    PROFILE_PERF_COUNTERS,
   };
 
 CUDAStubs default_stubs;
@@ -214,7 +221,7 @@ struct ProfilerThreadLocalState
       cuda_stubs->nvtxRangePushA(getNvtxStr(
           name, msg, sequence_nr, shapes).c_str());
     } else {
-      getEventList().record(
+      Event evt(
           EventKind::PushRange,
           name,
           at::RecordFunction::currentThreadId(),
@@ -222,6 +229,10 @@ struct ProfilerThreadLocalState
           handle,
           std::move(shapes),
           at::RecordFunction::getDefaultNodeId());
+      // Read after the range started, and before it ends in popRange, to
+      // leave the profiler out of the counts
+      recordPerfCounters(evt);
+      getEventList().record(std::move(evt));
     }
   }
 
@@ -236,16 +247,30 @@ struct ProfilerThreadLocalState
       // called on a different thread than pushRange
       // As a convention, we put the async pop on the original
       // thread and save current thread id in pop event
+      PerfCounterValues counters;
+      const bool has_counters =
+          config_.profile_perf_counters && readPerfCounters(counters);
       Event evt(EventKind::PopRange,
           at::StringView(""),
           at::RecordFunction::currentThreadId(),
           config_.state == ProfilerState::CUDA,
           handle);
       evt.setNodeId(at::RecordFunction::getDefaultNodeId());
+      if (has_counters) {
+        evt.setPerfCounters(counters);
+      }
       getEventList(thread_id).record(std::move(evt));
     }
   }
 
+  // Records CUDA activities into the event lists of the threads that
+  // launched them
+  void addCUDAActivities(const std::vector<CUDAActivity>& activities) {
+    for (const auto& activity : activities) {
+      getEventList(activity.thread_id).record(activity);
+    }
+  }
+
   void setCallbackHandle(at::CallbackHandle handle) {
     handle_ = handle;
   }
@@ -255,24 +280,42 @@ struct ProfilerThreadLocalState
   }
 
   void reportMemoryUsage(
-      void* /* unused */, int64_t alloc_size, c10::Device device) override {
+      void* ptr, int64_t alloc_size, c10::Device device) override {
+    recordMemoryEvent(EventKind::MemoryAlloc, ptr, alloc_size, device);
+  }
+
+  void reportSavedTensor(
+      const void* ptr, int64_t nbytes, c10::Device device) {
+    recordMemoryEvent(EventKind::MemorySaved, ptr, nbytes, device);
+  }
+
+  bool memoryProfilingEnabled() const override {
+    return config_.profile_memory;
+  }
+
+ private:
+  void recordPerfCounters(Event& evt) const {
+    PerfCounterValues counters;
+    if (config_.profile_perf_counters && readPerfCounters(counters)) {
+      evt.setPerfCounters(counters);
+    }
+  }
+
+  void recordMemoryEvent(
+      EventKind kind, const void* ptr, int64_t size, c10::Device device) {
     if (config_.profile_memory && config_.state != ProfilerState::Disabled) {
       uint64_t thread_id = at::RecordFunction::currentThreadId();
       Event evt(
-          EventKind::MemoryAlloc,
+          kind,
           at::StringView(""),
           thread_id,
           config_.state == ProfilerState::CUDA);
-      evt.updateMemoryStats(alloc_size, device);
+      evt.updateMemoryStats(size, device);
+      evt.setMemoryAddress(ptr);
       getEventList(thread_id).record(std::move(evt));
     }
   }
 
-  bool memoryProfilingEnabled() const override {
-    return config_.profile_memory;
-  }
-
- private:
   std::string getNvtxStr(
       const at::StringView& name,
       const char* msg,
@@ -404,6 +447,7 @@ at::IValue ProfilerConfig::toIValue() const {
   eventIValueList.emplace_back(static_cast<int64_t>(state));
   eventIValueList.emplace_back(report_input_shapes);
   eventIValueList.emplace_back(profile_memory);
+  eventIValueList.emplace_back(profile_perf_counters);
   return eventIValueList;
 }
 
@@ -422,7 +466,8 @@ ProfilerConfig ProfilerConfig::fromIValue(
   return ProfilerConfig(
       static_cast<ProfilerState>(ivalues.get(ProfilerIValueIdx::STATE).toInt()),
       ivalues.get(ProfilerIValueIdx::REPORT_INPUT_SHAPES).toBool(),
-      ivalues.get(ProfilerIValueIdx::PROFILE_MEMORY).toBool());
+      ivalues.get(ProfilerIValueIdx::PROFILE_MEMORY).toBool(),
+      ivalues.get(ProfilerIValueIdx::PROFILE_PERF_COUNTERS).toBool());
 }
 
 ProfilerConfig getProfilerConfig() {
@@ -433,6 +478,15 @@ ProfilerConfig getProfilerConfig() {
   return state_ptr->config();
 }
 
+void reportSavedTensor(const at::Tensor& tensor) {
+  auto state_ptr = getProfilerTLSState();
+  if (!state_ptr || !tensor.has_storage() || !tensor.storage().data()) {
+    return;
+  }
+  state_ptr->reportSavedTensor(
+      tensor.storage().data(), tensor.storage().nbytes(), tensor.device());
+}
+
 bool profilerEnabled() {
   auto state_ptr = getProfilerTLSState();
   return state_ptr && state_ptr->config().state != ProfilerState::Disabled;
@@ -441,6 +495,16 @@ bool profilerEnabled() {
 void enableProfiler(const ProfilerConfig& new_config) {
   TORCH_CHECK(new_config.state != ProfilerState::NVTX || cuda_stubs->enabled(),
     "Can't use NVTX profiler - PyTorch was compiled without CUDA");
+  TORCH_CHECK(
+      new_config.state != ProfilerState::CUPTI ||
+          cuda_stubs->activitiesEnabled(),
+      "Can't use CUPTI profiler - PyTorch was compiled without CUPTI");
+  PerfCounterValues counters;
+  TORCH_CHECK(
+      !new_config.profile_perf_counters || readPerfCounters(counters),
+      "Can't profile the hardware performance counters, perf_event_open is "
+      "not supported here or not allowed by "
+      "/proc/sys/kernel/perf_event_paranoid");
 
   auto state_ptr = getProfilerTLSState();
   TORCH_CHECK(!state_ptr, "Profiler is already enabled on this thread");
@@ -451,6 +515,10 @@ void enableProfiler(const ProfilerConfig& new_config) {
   pushProfilingCallbacks();
   g_.emplace_back(std::make_shared<at::RecordFunctionGuard>());
 
+  if (new_config.state == ProfilerState::CUPTI) {
+    cuda_stubs->startActivities();
+  }
+
   if (new_config.state == ProfilerState::CUDA) {
     // event recording appears to have some startup overhead, so we need to
     // to generate some dummy events first before recording synchronization events
@@ -485,6 +553,10 @@ thread_event_lists disableProfiler() {
     return thread_event_lists();
   }
 
+  if (state_ptr->config().state == ProfilerState::CUPTI) {
+    state_ptr->addCUDAActivities(cuda_stubs->stopActivities());
+  }
+
   state_ptr->mark("__stop_profile");
 
   return state_ptr->consolidate();
@@ -510,9 +582,9 @@ void Event::record(bool record_cuda) {
       "Expected IValue to contain type c10::impl::GenericList");
   auto ivalues = eventIValue.toList();
   TORCH_INTERNAL_ASSERT(
-      ivalues.size() >= kEventIValuesSize,
+      ivalues.size() >= kEventIValuesMinSize,
       "Expected at least ",
-      kEventIValuesSize,
+      kEventIValuesMinSize,
       " elements to reconstruct Event.");
 
   Event evt(
@@ -532,6 +604,25 @@ void Event::record(bool record_cuda) {
       ivalues.get(EventIValueIdx::CUDA_DEVICE).toInt(), // device
       ivalues.get(EventIValueIdx::CUDA_US).toInt() // cuda_us
   );
+  if (ivalues.size() > EventIValueIdx::DEVICE_DURATION_NS) {
+    evt.setDeviceActivity(
+        ivalues.get(EventIValueIdx::STREAM).toInt(),
+        ivalues.get(EventIValueIdx::DEVICE_DURATION_NS).toInt());
+  }
+  if (ivalues.size() > EventIValueIdx::MEMORY_ADDRESS) {
+    evt.setMemoryAddress(reinterpret_cast<const void*>(static_cast<intptr_t>(
+        ivalues.get(EventIValueIdx::MEMORY_ADDRESS).toInt())));
+  }
+  if (ivalues.size() > EventIValueIdx::PERF_COUNTERS) {
+    const auto counters = ivalues.get(EventIValueIdx::PERF_COUNTERS).toList();
+    if (counters.size() == NUM_PERF_COUNTERS) {
+      PerfCounterValues values;
+      for (size_t i = 0; i < NUM_PERF_COUNTERS; ++i) {
+        values[i] = counters.get(i).toInt();
+      }
+      evt.setPerfCounters(values);
+    }
+  }
   return evt;
 }
 
@@ -551,6 +642,11 @@ at::IValue Event::toIValue() const {
   eventIValueList.emplace_back(static_cast<int64_t>(cuda_memory_usage_));
   eventIValueList.emplace_back(device_);
   eventIValueList.emplace_back(cuda_us_);
+  // CUDA activity information
+  eventIValueList.emplace_back(stream_);
+  eventIValueList.emplace_back(device_duration_ns_);
+  eventIValueList.emplace_back(memory_address_);
+  eventIValueList.emplace_back(c10::List<int64_t>(perf_counters()));
   return at::IValue(eventIValueList);
 }
 
@@ -579,9 +675,40 @@ static jit::CodeTemplate event_template(R"(
   "dur": ${dur},
   "tid": ${tid},
   "pid": "CPU Functions",
-  "args": {}
+  "args": {${args}}
 })");
 
+static jit::CodeTemplate kernel_template(R"(
+{
+  "name": "${name}",
+  "ph": "X",
+  "ts": ${ts},
+  "dur": ${dur},
+  "tid": "stream ${stream}",
+  "pid": "CUDA Functions (device ${device})",
+  "args": {"correlation": ${handle}}
+})");
+
+// The hardware counters a range counted, for the args of its trace event.
+// They are only meaningful for the ranges that ended on the thread that
+// started them.
+static std::string perfCountersArgs(const Event& start, const Event& end) {
+  static const char* names[NUM_PERF_COUNTERS] = {
+      "cycles", "instructions", "llc_misses"};
+  const auto start_counters = start.perf_counters();
+  const auto end_counters = end.perf_counters();
+  if (start_counters.empty() || end_counters.empty() ||
+      start.thread_id() != end.thread_id()) {
+    return "";
+  }
+  std::stringstream args;
+  for (size_t i = 0; i < NUM_PERF_COUNTERS; ++i) {
+    args << (i > 0 ? ", " : "") << "\"" << names[i]
+         << "\": " << end_counters[i] - start_counters[i];
+  }
+  return args.str();
+}
+
 void writeProfilerEventsToStream(std::ostream& out, const std::vector<Event*>& events) {
   TORCH_CHECK(out, "Could not open file");
   Event* profiler_start = nullptr;
@@ -620,7 +747,21 @@ void writeProfilerEventsToStream(std::ostream& out, const std::vector<Event*>& e
       env.d("ts", profiler_start->cpu_elapsed_us(*evt_start));
       env.d("dur", evt_start->cpu_elapsed_us(*evt));
       env.d("tid", evt_start->thread_id());
+      env.s("args", perfCountersArgs(*evt_start, *evt));
       out << event_template.format(env);
+    } else if (evt->kind() == "kernel") {
+      if (!first) {
+        out << ",\n";
+      }
+      first = false;
+      jit::TemplateEnv env;
+      env.s("name", evt->name());
+      env.d("ts", profiler_start->cpu_elapsed_us(*evt));
+      env.d("dur", evt->device_duration_us());
+      env.d("stream", evt->stream());
+      env.d("device", evt->device());
+      env.d("handle", evt->handle());
+      out << kernel_template.format(env);
     }
   }
   out << "]\n";
@@ -11,6 +11,7 @@
 #include <tuple>
 #include <ATen/ATen.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/profiler_perf.h>
 #ifndef _WIN32
 #include <ctime>
 #endif
@@ -29,6 +30,21 @@ struct Node;
 
 namespace profiler {
 
+// A kernel, memcpy or memset executed on a CUDA device, as recorded by the
+// CUPTI activity collector; times are on the getTime() clock
+struct TORCH_API CUDAActivity {
+  std::string name;
+  int device;
+  int64_t stream;
+  int64_t start_ns;
+  int64_t end_ns;
+  // Handle of the RecordFunction that was current on the launching thread,
+  // 0 if there was none
+  at::RecordFunctionHandle handle;
+  // RecordFunction::currentThreadId() of the launching thread
+  uint64_t thread_id;
+};
+
 struct TORCH_API CUDAStubs {
   virtual void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) {
     fail();
@@ -55,12 +71,28 @@ struct TORCH_API CUDAStubs {
   virtual void synchronize() {
     fail();
   }
+  // Whether CUDA activities can be traced, i.e. PyTorch was built with CUPTI
+  virtual bool activitiesEnabled() {
+    return false;
+  }
+  virtual void startActivities() {
+    failActivities();
+  }
+  // Waits for the work on all the devices to finish and returns the
+  // activities recorded since startActivities
+  virtual std::vector<CUDAActivity> stopActivities() {
+    failActivities();
+    return {};
+  }
   virtual ~CUDAStubs();
 
 private:
   void fail() {
     AT_ERROR("CUDA used in profiler but not enabled.");
   }
+  void failActivities() {
+    AT_ERROR("CUDA activities used in profiler, but PyTorch was built without CUPTI.");
+  }
 };
 
 TORCH_API void registerCUDAMethods(CUDAStubs* stubs);
@@ -99,20 +131,25 @@ enum class TORCH_API ProfilerState {
     CPU, // CPU-only profiling
     CUDA, // CPU + CUDA events
     NVTX,  // only emit NVTX markers
+    CUPTI, // CPU + CUDA kernels and memory copies traced with CUPTI
 };
 
 struct TORCH_API ProfilerConfig {
   ProfilerConfig(
       ProfilerState state,
       bool report_input_shapes,
-      bool profile_memory)
+      bool profile_memory,
+      bool profile_perf_counters = false)
       : state(state),
         report_input_shapes(report_input_shapes),
-        profile_memory(profile_memory) {}
+        profile_memory(profile_memory),
+        profile_perf_counters(profile_perf_counters) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
   bool profile_memory;
+  // Read the hardware counters of profiler_perf.h at the push and pop events
+  bool profile_perf_counters;
 
   // Returns IValues corresponding to ProfilerConfig struct, to be used for
   // serialization.
@@ -128,6 +165,8 @@ enum class TORCH_API EventKind : uint16_t {
   PushRange,
   PopRange,
   MemoryAlloc,
+  Kernel,
+  MemorySaved,
 };
 #ifndef _MSC_VER
 #  pragma GCC diagnostic pop
@@ -186,6 +225,19 @@ struct TORCH_API Event final {
     }
   }
 
+  // Constructor for CUDA activities, attributed to the range with the given
+  // handle started on thread_id.
+  explicit Event(const CUDAActivity& activity)
+      : cpu_ns_(activity.start_ns),
+        name_(activity.name),
+        kind_(EventKind::Kernel),
+        thread_id_(activity.thread_id),
+        handle_(activity.handle),
+        device_(activity.device),
+        node_id_(at::RecordFunction::getDefaultNodeId()),
+        stream_(activity.stream),
+        device_duration_ns_(activity.end_ns - activity.start_ns) {}
+
   // Returns IValues corresponding to event structure, to be used for
   // serialization.
   at::IValue toIValue() const;
@@ -200,6 +252,8 @@ struct TORCH_API Event final {
       case EventKind::PushRange: return "push";
       case EventKind::PopRange: return "pop";
       case EventKind::MemoryAlloc: return "memory_alloc";
+      case EventKind::Kernel: return "kernel";
+      case EventKind::MemorySaved: return "memory_saved";
     }
     throw std::runtime_error("unknown EventKind");
   }
@@ -255,6 +309,30 @@ struct TORCH_API Event final {
     return cuda_memory_usage_;
   }
 
+  // Address of the allocation of memory events, used to match the frees and
+  // the saved tensors with the allocations
+  int64_t memory_address() const {
+    return memory_address_;
+  }
+
+  void setMemoryAddress(const void* ptr) {
+    memory_address_ = reinterpret_cast<intptr_t>(ptr);
+  }
+
+  // Hardware counters of the thread when the event was recorded, in the
+  // order of PerfCounter, or empty when they weren't profiled
+  std::vector<int64_t> perf_counters() const {
+    if (!has_perf_counters_) {
+      return {};
+    }
+    return std::vector<int64_t>(perf_counters_.begin(), perf_counters_.end());
+  }
+
+  void setPerfCounters(const PerfCounterValues& values) {
+    perf_counters_ = values;
+    has_perf_counters_ = true;
+  }
+
   at::RecordFunctionHandle handle() const {
     return handle_;
   }
@@ -281,6 +359,21 @@ struct TORCH_API Event final {
     cuda_us_ = cuda_us;
 }
 
+  // Stream a kernel event ran on
+  int64_t stream() const {
+    return stream_;
+  }
+
+  // Time a kernel event took on the device
+  double device_duration_us() const {
+    return device_duration_ns_ / 1000.0;
+  }
+
+  void setDeviceActivity(int64_t stream, int64_t device_duration_ns) {
+    stream_ = stream;
+    device_duration_ns_ = device_duration_ns;
+  }
+
 private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -296,6 +389,11 @@ private:
   int node_id_ = 0;
   bool is_remote_ = false;
   int64_t cuda_us_ = -1;
+  int64_t stream_ = -1;
+  int64_t device_duration_ns_ = 0;
+  int64_t memory_address_ = 0;
+  PerfCounterValues perf_counters_ {};
+  bool has_perf_counters_ = false;
 };
 
 // a linked-list of fixed sized vectors, to avoid
@@ -347,6 +445,9 @@ TORCH_API thread_event_lists disableProfiler();
 TORCH_API void addEventList(std::vector<Event>&& profiledEvents);
 // Returns if the profiler is currently enabled in the current thread.
 TORCH_API bool profilerEnabled();
+// Records that the storage of tensor is saved for backward, when profiling
+// memory. The profiler attributes it to the ranges that allocated it.
+TORCH_API void reportSavedTensor(const at::Tensor& tensor);
 // Retrieve the thread_local ProfilerConfig.
 TORCH_API ProfilerConfig getProfilerConfig();
 // Writes profiled events to a stream.
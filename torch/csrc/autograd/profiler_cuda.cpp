@@ -1,8 +1,13 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <nvToolsExt.h>
+#ifdef USE_CUPTI
+#include <cupti.h>
+#endif
 
+#include <atomic>
 #include <sstream>
+#include <unordered_map>
 
 namespace torch { namespace autograd { namespace profiler {
 
@@ -31,6 +36,232 @@ static inline void cudaCheck(cudaError_t result, const char * file, int line) {
 }
 #define TORCH_CUDA_CHECK(result) cudaCheck(result,__FILE__,__LINE__);
 
+#ifdef USE_CUPTI
+#define TORCH_CUPTI_CHECK(result)                            \
+  do {                                                       \
+    CUptiResult status = (result);                           \
+    if (status != CUPTI_SUCCESS) {                           \
+      const char* err_str = nullptr;                         \
+      cuptiGetResultString(status, &err_str);                \
+      AT_ERROR("CUPTI error: ", err_str ? err_str : "unknown"); \
+    }                                                        \
+  } while (0)
+
+// Collects the kernels, memcpys and memsets executed on the devices through
+// the CUPTI activity API. Each activity is attributed to the RecordFunction
+// that was current on the thread that launched it, found with a CUPTI
+// callback on the launching runtime and driver API calls, which shares the
+// correlation id of the activity record.
+//
+// CUPTI is process wide, so only one profiler can collect activities at a
+// time.
+class CUPTIActivityCollector {
+ public:
+  static CUPTIActivityCollector& get() {
+    static CUPTIActivityCollector collector;
+    return collector;
+  }
+
+  void start() {
+    bool expected = false;
+    TORCH_CHECK(
+        active_.compare_exchange_strong(expected, true),
+        "CUPTI profiler is already running on another thread");
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      launches_.clear();
+      activities_.clear();
+    }
+    // The CUPTI timestamps and getTime() use different clocks
+    uint64_t cupti_ns = 0;
+    TORCH_CUPTI_CHECK(cuptiGetTimestamp(&cupti_ns));
+    clock_offset_ns_ = getTime() - static_cast<int64_t>(cupti_ns);
+
+    TORCH_CUPTI_CHECK(cuptiActivityRegisterCallbacks(
+        &CUPTIActivityCollector::bufferRequested,
+        &CUPTIActivityCollector::bufferCompleted));
+    TORCH_CUPTI_CHECK(cuptiSubscribe(
+        &subscriber_,
+        (CUpti_CallbackFunc)&CUPTIActivityCollector::apiCallback,
+        this));
+    for (auto cbid : kRuntimeCallbacks) {
+      TORCH_CUPTI_CHECK(cuptiEnableCallback(
+          1, subscriber_, CUPTI_CB_DOMAIN_RUNTIME_API, cbid));
+    }
+    TORCH_CUPTI_CHECK(cuptiEnableCallback(
+        1, subscriber_, CUPTI_CB_DOMAIN_DRIVER_API,
+        CUPTI_DRIVER_TRACE_CBID_cuLaunchKernel));
+    TORCH_CUPTI_CHECK(cuptiActivityEnable(CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL));
+    TORCH_CUPTI_CHECK(cuptiActivityEnable(CUPTI_ACTIVITY_KIND_MEMCPY));
+    TORCH_CUPTI_CHECK(cuptiActivityEnable(CUPTI_ACTIVITY_KIND_MEMSET));
+  }
+
+  std::vector<CUDAActivity> stop() {
+    TORCH_CUDA_CHECK(cudaDeviceSynchronize());
+    TORCH_CUPTI_CHECK(cuptiActivityFlushAll(0));
+    TORCH_CUPTI_CHECK(cuptiActivityDisable(CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL));
+    TORCH_CUPTI_CHECK(cuptiActivityDisable(CUPTI_ACTIVITY_KIND_MEMCPY));
+    TORCH_CUPTI_CHECK(cuptiActivityDisable(CUPTI_ACTIVITY_KIND_MEMSET));
+    TORCH_CUPTI_CHECK(cuptiUnsubscribe(subscriber_));
+
+    std::vector<CUDAActivity> result;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      result.swap(activities_);
+      launches_.clear();
+    }
+    active_ = false;
+    return result;
+  }
+
+ private:
+  struct Launch {
+    at::RecordFunctionHandle handle;
+    uint64_t thread_id;
+  };
+
+  static constexpr size_t kBufferSize = 8 * 1024 * 1024;
+  static constexpr size_t kAlignSize = 8;
+
+  // Runtime API calls that launch device activities
+  static constexpr CUpti_CallbackId kRuntimeCallbacks[] = {
+    CUPTI_RUNTIME_TRACE_CBID_cudaLaunch_v3020,
+    CUPTI_RUNTIME_TRACE_CBID_cudaLaunchKernel_v7000,
+    CUPTI_RUNTIME_TRACE_CBID_cudaMemcpy_v3020,
+    CUPTI_RUNTIME_TRACE_CBID_cudaMemcpyAsync_v3020,
+    CUPTI_RUNTIME_TRACE_CBID_cudaMemcpy2DAsync_v3020,
+    CUPTI_RUNTIME_TRACE_CBID_cudaMemcpyPeerAsync_v4000,
+    CUPTI_RUNTIME_TRACE_CBID_cudaMemset_v3020,
+    CUPTI_RUNTIME_TRACE_CBID_cudaMemsetAsync_v3020,
+  };
+
+  static void CUPTIAPI apiCallback(
+      void* userdata,
+      CUpti_CallbackDomain /* domain */,
+      CUpti_CallbackId /* cbid */,
+      const CUpti_CallbackData* cbdata) {
+    if (cbdata->callbackSite != CUPTI_API_ENTER) {
+      return;
+    }
+    auto* collector = static_cast<CUPTIActivityCollector*>(userdata);
+    auto* rf = at::RecordFunction::current();
+    std::lock_guard<std::mutex> guard(collector->mutex_);
+    collector->launches_[cbdata->correlationId] = Launch{
+        rf ? rf->handle() : 0, at::RecordFunction::currentThreadId()};
+  }
+
+  static void CUPTIAPI bufferRequested(
+      uint8_t** buffer, size_t* size, size_t* max_num_records) {
+    auto* raw = static_cast<uint8_t*>(malloc(kBufferSize + kAlignSize));
+    *buffer = reinterpret_cast<uint8_t*>(
+        ceilToMultiple(reinterpret_cast<size_t>(raw), kAlignSize));
+    auto& collector = get();
+    std::lock_guard<std::mutex> guard(collector.mutex_);
+    collector.raw_buffers_[*buffer] = raw;
+    *size = kBufferSize;
+    *max_num_records = 0;
+  }
+
+  static void CUPTIAPI bufferCompleted(
+      CUcontext /* ctx */,
+      uint32_t /* stream_id */,
+      uint8_t* buffer,
+      size_t /* size */,
+      size_t valid_size) {
+    auto& collector = get();
+    CUpti_Activity* record = nullptr;
+    while (cuptiActivityGetNextRecord(buffer, valid_size, &record) ==
+           CUPTI_SUCCESS) {
+      collector.addRecord(record);
+    }
+    std::lock_guard<std::mutex> guard(collector.mutex_);
+    auto it = collector.raw_buffers_.find(buffer);
+    if (it != collector.raw_buffers_.end()) {
+      free(it->second);
+      collector.raw_buffers_.erase(it);
+    }
+  }
+
+  void addRecord(const CUpti_Activity* record) {
+    CUDAActivity activity;
+    uint32_t correlation_id = 0;
+    switch (record->kind) {
+      case CUPTI_ACTIVITY_KIND_KERNEL:
+      case CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL: {
+        auto* kernel = reinterpret_cast<const CUpti_ActivityKernel4*>(record);
+        activity.name = kernel->name;
+        activity.device = kernel->deviceId;
+        activity.stream = kernel->streamId;
+        activity.start_ns = kernel->start;
+        activity.end_ns = kernel->end;
+        correlation_id = kernel->correlationId;
+        break;
+      }
+      case CUPTI_ACTIVITY_KIND_MEMCPY: {
+        auto* copy = reinterpret_cast<const CUpti_ActivityMemcpy*>(record);
+        activity.name = memcpyName(copy->copyKind);
+        activity.device = copy->deviceId;
+        activity.stream = copy->streamId;
+        activity.start_ns = copy->start;
+        activity.end_ns = copy->end;
+        correlation_id = copy->correlationId;
+        break;
+      }
+      case CUPTI_ACTIVITY_KIND_MEMSET: {
+        auto* set = reinterpret_cast<const CUpti_ActivityMemset*>(record);
+        activity.name = "Memset";
+        activity.device = set->deviceId;
+        activity.stream = set->streamId;
+        activity.start_ns = set->start;
+        activity.end_ns = set->end;
+        correlation_id = set->correlationId;
+        break;
+      }
+      default:
+        return;
+    }
+    activity.start_ns += clock_offset_ns_;
+    activity.end_ns += clock_offset_ns_;
+    activity.handle = 0;
+    activity.thread_id = 0;
+
+    // The API callback of a launch always runs before its activity record is
+    // completed
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = launches_.find(correlation_id);
+    if (it != launches_.end()) {
+      activity.handle = it->second.handle;
+      activity.thread_id = it->second.thread_id;
+      launches_.erase(it);
+    }
+    activities_.push_back(std::move(activity));
+  }
+
+  static const char* memcpyName(uint8_t kind) {
+    switch (kind) {
+      case CUPTI_ACTIVITY_MEMCPY_KIND_HTOD: return "Memcpy HtoD";
+      case CUPTI_ACTIVITY_MEMCPY_KIND_DTOH: return "Memcpy DtoH";
+      case CUPTI_ACTIVITY_MEMCPY_KIND_DTOD: return "Memcpy DtoD";
+      case CUPTI_ACTIVITY_MEMCPY_KIND_PTOP: return "Memcpy PtoP";
+      default: return "Memcpy";
+    }
+  }
+
+  std::atomic<bool> active_{false};
+  CUpti_SubscriberHandle subscriber_ = nullptr;
+  int64_t clock_offset_ns_ = 0;
+
+  std::mutex mutex_;
+  // Launches seen by the API callback, by correlation id
+  std::unordered_map<uint32_t, Launch> launches_;
+  std::vector<CUDAActivity> activities_;
+  // Aligned buffers handed to CUPTI and the allocations they come from
+  std::unordered_map<uint8_t*, uint8_t*> raw_buffers_;
+};
+
+constexpr CUpti_CallbackId CUPTIActivityCollector::kRuntimeCallbacks[];
+#endif // USE_CUPTI
+
 struct CUDAMethods : public CUDAStubs {
   void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) override {
     TORCH_CUDA_CHECK(cudaGetDevice(device));
@@ -73,6 +304,17 @@ struct CUDAMethods : public CUDAStubs {
   bool enabled() override {
     return true;
   }
+#ifdef USE_CUPTI
+  bool activitiesEnabled() override {
+    return true;
+  }
+  void startActivities() override {
+    CUPTIActivityCollector::get().start();
+  }
+  std::vector<CUDAActivity> stopActivities() override {
+    return CUPTIActivityCollector::get().stop();
+  }
+#endif
 
 };
 
@@ -0,0 +1,95 @@
+#include <torch/csrc/autograd/profiler_perf.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace torch { namespace autograd { namespace profiler {
+
+#ifdef __linux__
+
+namespace {
+
+// The counters of a thread, opened as one group so that they are scheduled
+// together and read with a single read
+struct ThreadPerfCounters {
+  ThreadPerfCounters() {
+    for (const auto config :
+         {PERF_COUNT_HW_CPU_CYCLES,
+          PERF_COUNT_HW_INSTRUCTIONS,
+          PERF_COUNT_HW_CACHE_MISSES}) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = config;
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      const int fd = syscall(
+          __NR_perf_event_open,
+          &attr,
+          /*pid=*/0,
+          /*cpu=*/-1,
+          /*group_fd=*/fds[0],
+          /*flags=*/0);
+      if (fd < 0) {
+        close();
+        return;
+      }
+      fds[num_fds++] = fd;
+    }
+  }
+
+  ~ThreadPerfCounters() {
+    close();
+  }
+
+  bool read(PerfCounterValues& values) const {
+    if (num_fds != NUM_PERF_COUNTERS) {
+      return false;
+    }
+    // The number of counters, followed by their values
+    uint64_t buffer[1 + NUM_PERF_COUNTERS];
+    if (::read(fds[0], buffer, sizeof(buffer)) != sizeof(buffer)) {
+      return false;
+    }
+    for (size_t i = 0; i < NUM_PERF_COUNTERS; ++i) {
+      values[i] = static_cast<int64_t>(buffer[1 + i]);
+    }
+    return true;
+  }
+
+  void close() {
+    // The members first, then the group leader
+    while (num_fds > 0) {
+      ::close(fds[--num_fds]);
+    }
+    fds[0] = -1;
+  }
+
+  int fds[NUM_PERF_COUNTERS] = {-1};
+  size_t num_fds = 0;
+};
+
+} // namespace
+
+bool readPerfCounters(PerfCounterValues& values) {
+  static thread_local ThreadPerfCounters counters;
+  return counters.read(values);
+}
+
+#else
+
+bool readPerfCounters(PerfCounterValues& /* unused */) {
+  return false;
+}
+
+#endif
+
+}}} // namespace torch::autograd::profiler
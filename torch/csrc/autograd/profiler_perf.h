@@ -0,0 +1,28 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <array>
+#include <cstdint>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Hardware performance counters of the calling thread, read with
+// perf_event_open on Linux. The counters of a thread count its user space
+// events since it first read them, in the order of PerfCounter.
+enum PerfCounter {
+  CYCLES = 0,
+  INSTRUCTIONS,
+  // Last level cache misses, each one a cache line read from memory
+  LLC_MISSES,
+  NUM_PERF_COUNTERS
+};
+
+using PerfCounterValues = std::array<int64_t, NUM_PERF_COUNTERS>;
+
+// Reads the counters of the calling thread, opening them on its first call.
+// Returns false where they can't be opened, when the platform has no perf
+// events or the kernel's perf_event_paranoid setting doesn't allow them.
+TORCH_API bool readPerfCounters(PerfCounterValues& values);
+
+}}} // namespace torch::autograd::profiler
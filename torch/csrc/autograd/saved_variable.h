@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
 
 #include <ATen/ATen.h>
 
@@ -16,6 +17,8 @@ TORCH_API extern const char* ERR_BACKWARD_TWICE;
 
 /// A snapshot of a variable at a certain version. A `SavedVariable` stores
 /// enough information to reconstruct a variable from a certain point in time.
+/// If a `SavedVariableHooksGuard` is active when it is constructed, the tensor
+/// is handed to the hooks made by its factory instead of being kept alive.
 class TORCH_API SavedVariable {
  public:
   SavedVariable() = default;
@@ -29,6 +32,7 @@ class TORCH_API SavedVariable {
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
   void reset_data() {
+    hooks_.reset();
     return data_.reset();
   }
 
@@ -38,6 +42,8 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // When set, owns the saved tensor in place of data_.
+  std::unique_ptr<SavedVariableHooks> hooks_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
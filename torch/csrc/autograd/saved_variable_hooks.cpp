@@ -0,0 +1,142 @@
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/utils/memory.h>
+
+#include <mutex>
+#include <utility>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+thread_local std::shared_ptr<SavedVariableHooksFactory> current_factory;
+
+struct CPUOffloadHooks : public SavedVariableHooks {
+  void call_pack_hook(const at::Tensor& tensor) override {
+    device_ = tensor.device();
+    host_ = at::empty(
+        tensor.sizes(),
+        tensor.options().device(at::kCPU).pinned_memory(true));
+    // The copy is ordered on the current stream before any later kernel that
+    // could reuse the memory of `tensor` once it is freed.
+    host_.copy_(tensor, /*non_blocking=*/true);
+  }
+
+  at::Tensor call_unpack_hook() override {
+    return host_.to(device_, /*non_blocking=*/true);
+  }
+
+ private:
+  at::Device device_ = at::kCPU;
+  at::Tensor host_;
+};
+
+// The tensors saved by one call to checkpoint(), and how to compute them
+// again.
+struct CheckpointFrame {
+  std::function<variable_list(const variable_list&)> fn;
+  // Detached, so that the frame doesn't keep the graph that produced the
+  // inputs alive.
+  variable_list inputs;
+  std::vector<bool> inputs_require_grad;
+  // Number of tensors saved by the first run of fn.
+  size_t num_saved = 0;
+
+  std::mutex mutex;
+  bool is_recomputed = false;
+  std::vector<at::Tensor> recomputed;
+
+  void recompute() {
+    variable_list detached_inputs;
+    detached_inputs.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      auto input = inputs[i].defined() ? inputs[i].detach() : inputs[i];
+      if (inputs_require_grad[i]) {
+        input.requires_grad_(true);
+      }
+      detached_inputs.push_back(std::move(input));
+    }
+    // Record the tensors the operations of fn save, in order; they are kept
+    // by the SavedVariables of the recomputed graph until it is dropped at
+    // the end of this function, and by `recomputed` for the original graph.
+    AutoGradMode enable_grad(true);
+    SavedVariableHooksGuard guard([this](const at::Tensor& tensor) {
+      recomputed.push_back(tensor);
+      return std::unique_ptr<SavedVariableHooks>();
+    });
+    fn(detached_inputs);
+  }
+};
+
+struct CheckpointHooks : public SavedVariableHooks {
+  CheckpointHooks(std::shared_ptr<CheckpointFrame> frame, size_t index)
+      : frame_(std::move(frame)), index_(index) {}
+
+  void call_pack_hook(const at::Tensor& /* tensor */) override {}
+
+  at::Tensor call_unpack_hook() override {
+    std::lock_guard<std::mutex> lock(frame_->mutex);
+    if (!frame_->is_recomputed) {
+      frame_->recompute();
+      frame_->is_recomputed = true;
+    }
+    TORCH_CHECK(
+        frame_->recomputed.size() == frame_->num_saved,
+        "checkpoint: the recomputation saved ", frame_->recomputed.size(),
+        " tensors for backward, but the forward pass saved ",
+        frame_->num_saved, ". The checkpointed function must perform the ",
+        "same operations every time it is called.");
+    return frame_->recomputed[index_];
+  }
+
+ private:
+  std::shared_ptr<CheckpointFrame> frame_;
+  size_t index_;
+};
+
+} // namespace
+
+SavedVariableHooksGuard::SavedVariableHooksGuard(
+    SavedVariableHooksFactory factory)
+    : factory_(std::make_shared<SavedVariableHooksFactory>(std::move(factory))),
+      prev_factory_(std::move(current_factory)) {
+  current_factory = factory_;
+}
+
+SavedVariableHooksGuard::~SavedVariableHooksGuard() {
+  current_factory = std::move(prev_factory_);
+}
+
+const SavedVariableHooksFactory* SavedVariableHooksGuard::current() {
+  return current_factory.get();
+}
+
+SavedVariableHooksFactory cpu_offload_saved_variable_hooks(int64_t min_bytes) {
+  return [min_bytes](const at::Tensor& tensor)
+      -> std::unique_ptr<SavedVariableHooks> {
+    if (!tensor.is_cuda() ||
+        tensor.numel() * static_cast<int64_t>(tensor.element_size()) < min_bytes) {
+      return nullptr;
+    }
+    return torch::make_unique<CPUOffloadHooks>();
+  };
+}
+
+variable_list checkpoint(
+    const std::function<variable_list(const variable_list&)>& fn,
+    const variable_list& inputs) {
+  auto frame = std::make_shared<CheckpointFrame>();
+  frame->fn = fn;
+  for (const auto& input : inputs) {
+    frame->inputs.push_back(input.defined() ? input.detach() : input);
+    frame->inputs_require_grad.push_back(input.defined() && input.requires_grad());
+  }
+  SavedVariableHooksGuard guard([frame](const at::Tensor& /* tensor */)
+      -> std::unique_ptr<SavedVariableHooks> {
+    return torch::make_unique<CheckpointHooks>(frame, frame->num_saved++);
+  });
+  return fn(inputs);
+}
+
+}} // namespace torch::autograd
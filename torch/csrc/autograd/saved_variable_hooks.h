@@ -0,0 +1,70 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/ATen.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+using Variable = at::Tensor;
+using variable_list = std::vector<Variable>;
+
+/// Decides how the tensor of a single `SavedVariable` is stored between the
+/// forward and the backward pass. `call_pack_hook` is called once, when the
+/// variable is saved; when hooks are present, the `SavedVariable` does not
+/// keep a reference to the tensor itself. `call_unpack_hook` must then
+/// return a tensor with the same content every time the variable is
+/// unpacked.
+struct TORCH_API SavedVariableHooks {
+  virtual ~SavedVariableHooks() = default;
+  virtual void call_pack_hook(const at::Tensor& tensor) = 0;
+  virtual at::Tensor call_unpack_hook() = 0;
+};
+
+/// Called with every tensor saved for backward while installed by a
+/// `SavedVariableHooksGuard`. Returning nullptr keeps the tensor saved as
+/// usual.
+using SavedVariableHooksFactory =
+    std::function<std::unique_ptr<SavedVariableHooks>(const at::Tensor&)>;
+
+/// Installs `factory` as the saved tensor policy of the current thread for the
+/// lifetime of the guard, restoring the previous one on destruction.
+class TORCH_API SavedVariableHooksGuard {
+ public:
+  explicit SavedVariableHooksGuard(SavedVariableHooksFactory factory);
+  ~SavedVariableHooksGuard();
+
+  SavedVariableHooksGuard(const SavedVariableHooksGuard&) = delete;
+  SavedVariableHooksGuard& operator=(const SavedVariableHooksGuard&) = delete;
+
+  /// The policy installed on the current thread, nullptr if there is none.
+  static const SavedVariableHooksFactory* current();
+
+ private:
+  std::shared_ptr<SavedVariableHooksFactory> factory_;
+  std::shared_ptr<SavedVariableHooksFactory> prev_factory_;
+};
+
+/// A policy that moves saved CUDA tensors of at least `min_bytes` to pinned
+/// host memory with an asynchronous copy on the current stream, and copies
+/// them back to their device, again asynchronously, when they are unpacked.
+/// Other tensors are saved as usual.
+TORCH_API SavedVariableHooksFactory cpu_offload_saved_variable_hooks(
+    int64_t min_bytes = 0);
+
+/// Runs `fn(inputs)` without keeping any of the tensors that autograd saves
+/// for the backward of the operations in `fn`. The first time one of them is
+/// needed in backward, `fn` is run once more on `inputs` and the recomputed
+/// tensors are used instead. `fn` must save the same tensors, in the same
+/// order, each time it is called, so it should not depend on random numbers
+/// or on state that changes between the forward and the backward pass.
+TORCH_API variable_list checkpoint(
+    const std::function<variable_list(const variable_list&)>& fn,
+    const variable_list& inputs);
+
+}} // namespace torch::autograd
@@ -34,6 +34,19 @@ inline at::Tensor clone_obey_contract(const at::Tensor& new_grad, const at::Tens
   }
 }
 
+// Creates an uninitialized tensor the sizes of variable that obeys the
+// contract with it.
+inline at::Tensor empty_obey_contract(const at::Tensor& variable) {
+  if (variable.is_non_overlapping_and_dense()) {
+    // (1)
+    return at::empty_strided(variable.sizes(), variable.strides(),
+                             variable.options().memory_format(c10::nullopt));
+  } else {
+    // (2)
+    return at::empty(variable.sizes(), variable.options());
+  }
+}
+
 } // namespace utils
 } // namespace autograd
 } // namespace torch
@@ -7,6 +7,8 @@
 #include <torch/csrc/autograd/functions/accumulate_grad.h>
 #include <torch/csrc/autograd/functions/tensor.h>
 #include <torch/csrc/autograd/generated/Functions.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/utils/grad_layout_contract.h>
 
 #include <ATen/core/VariableHooksInterface.h>
 
@@ -233,6 +235,25 @@ namespace impl {
     materialize_autograd_meta(self)->hooks_.clear();
   }
 
+  void preallocate_grad(const Variable& self) {
+    TORCH_CHECK(
+        self.is_leaf() && self.requires_grad(),
+        "can't preallocate the grad of a tensor that is not a leaf requiring "
+        "grad");
+    TORCH_CHECK(
+        !self.is_sparse(), "can't preallocate the grad of a sparse tensor");
+    AutoGradMode grad_mode(false);
+    auto meta = materialize_autograd_meta(self);
+    auto buffer = utils::empty_obey_contract(self);
+    if (meta->grad_.defined()) {
+      buffer.copy_(meta->grad_);
+    } else {
+      buffer.zero_();
+    }
+    meta->grad_ = buffer;
+    meta->grad_buffer_ = std::move(buffer);
+  }
+
   void set_name(const Variable& self, const std::string& name) {
     materialize_autograd_meta(self)->name_ = name;
   }
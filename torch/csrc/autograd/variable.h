@@ -175,6 +175,15 @@ namespace impl {
   TORCH_API void clear_hooks(const Variable&);
 
   TORCH_API void create_cpp_hook(const Variable&);
+
+  /// Preallocates the grad of a leaf `Variable` that requires grad, with the
+  /// layout of the "Gradient Layout Contract" (see accumulate_grad.h). The
+  /// grad keeps its values, or is zero filled if it was undefined. Whenever
+  /// the grad is reset to undefined afterwards (`zero_grad(set_to_none=True)`),
+  /// AccumulateGrad copies the next gradient into the preallocated buffer
+  /// rather than allocating a new grad, so that the grad always lives in the
+  /// same memory and is never zero filled in a separate pass.
+  TORCH_API void preallocate_grad(const Variable&);
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -190,6 +199,8 @@ struct TORCH_API AutogradMeta : public c10::AutogradMetaInterface {
   std::string name_;
 
   Variable grad_;
+  // Only meaningful on leaf variables, see impl::preallocate_grad
+  Variable grad_buffer_;
   std::shared_ptr<Node> grad_fn_;
   std::weak_ptr<Node> grad_accumulator_;
 
@@ -222,6 +233,10 @@ struct TORCH_API AutogradMeta : public c10::AutogradMetaInterface {
     TORCH_CHECK(
       !requires_grad || isDifferentiableType(at::typeMetaToScalarType(self_impl->dtype())),
       "Only Tensors of floating point and complex dtype can require gradients");
+    TORCH_CHECK(
+      !requires_grad || !self_impl->is_inference(),
+      "Inference tensors cannot require grad. You can make a clone to get a "
+      "normal tensor and use it in autograd.");
     requires_grad_ = requires_grad;
   }
 
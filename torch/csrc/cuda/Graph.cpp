@@ -0,0 +1,27 @@
+#include <torch/csrc/python_headers.h>
+#include <torch/csrc/utils/pybind.h>
+
+#include <ATen/cuda/CUDAGraph.h>
+
+namespace torch { namespace cuda {
+
+void initGraphBindings(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+
+  py::class_<::at::cuda::CUDAGraph>(m, "_CUDAGraph")
+      .def(py::init<>())
+      .def("capture_begin",
+           &::at::cuda::CUDAGraph::capture_begin,
+           py::call_guard<py::gil_scoped_release>())
+      .def("capture_end",
+           &::at::cuda::CUDAGraph::capture_end,
+           py::call_guard<py::gil_scoped_release>())
+      .def("replay",
+           &::at::cuda::CUDAGraph::replay,
+           py::call_guard<py::gil_scoped_release>())
+      .def("reset",
+           &::at::cuda::CUDAGraph::reset,
+           py::call_guard<py::gil_scoped_release>());
+}
+
+}} // namespace torch::cuda
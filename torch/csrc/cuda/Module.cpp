@@ -5,6 +5,7 @@
 #include <sstream>
 #include <TH/TH.h>
 #include <ATen/ATen.h>
+#include <ATen/autocast_mode.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/CUDAGeneratorImpl.h>
 #include <c10/cuda/CUDAFunctions.h>
@@ -150,6 +151,37 @@ PyObject * THCPModule_setStream_wrap(PyObject *self, PyObject *obj)
   END_HANDLE_TH_ERRORS
 }
 
+// Makes the raw stream `waiting` wait for the work queued so far on the raw
+// stream `recorded` through an event, without synchronizing the device. The
+// streams may be owned by other libraries, as in the DLPack and
+// __cuda_array_interface__ protocols, so they are passed as plain handles.
+PyObject * THCPModule_streamWaitStream(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *waiting_o = nullptr;
+  PyObject *recorded_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OO", &waiting_o, &recorded_o) ||
+      !THPUtils_checkLong(waiting_o) || !THPUtils_checkLong(recorded_o)) {
+    THPUtils_invalidArguments(
+        args, nullptr, "_cuda_streamWaitStream", 1,
+        "(int waiting_stream, int recorded_stream)");
+    return nullptr;
+  }
+  auto waiting = reinterpret_cast<cudaStream_t>(PyLong_AsVoidPtr(waiting_o));
+  auto recorded = reinterpret_cast<cudaStream_t>(PyLong_AsVoidPtr(recorded_o));
+  {
+    pybind11::gil_scoped_release no_gil;
+    cudaEvent_t event;
+    THCudaCheck(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    THCudaCheck(cudaEventRecord(event, recorded));
+    THCudaCheck(cudaStreamWaitEvent(waiting, event, 0));
+    // The event is released once the wait is done.
+    THCudaCheck(cudaEventDestroy(event));
+  }
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THCPModule_isDriverSufficient(PyObject *self, PyObject *noargs)
 {
   int count;
@@ -342,6 +374,13 @@ PyObject * THCPModule_memoryStats(PyObject *_unused, PyObject *arg)
   result["active_bytes"] = statArrayToDict(stats.active_bytes);
   result["inactive_split_bytes"] = statArrayToDict(stats.inactive_split_bytes);
 
+  // Part of allocated_bytes, held by autocast's cache of weight casts.
+  const auto cast_cache_stats = at::autocast::cast_cache_stats(device);
+  py::dict cast_cache_dict;
+  cast_cache_dict["current"] = cast_cache_stats.current_bytes;
+  cast_cache_dict["peak"] = cast_cache_stats.peak_bytes;
+  result["autocast_cache_bytes"] = cast_cache_dict;
+
   return result.release().ptr();
   END_HANDLE_TH_ERRORS
 }
@@ -362,6 +401,7 @@ PyObject * THCPModule_resetPeakMemoryStats(PyObject *_unused, PyObject *arg)
   THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to reset_peak_memory_stats");
   const int device = (int) THPUtils_unpackLong(arg);
   c10::cuda::CUDACachingAllocator::resetPeakStats(device);
+  at::autocast::reset_peak_cast_cache_stats(device);
   END_HANDLE_TH_ERRORS
   Py_RETURN_NONE;
 }
@@ -381,12 +421,14 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     segmentDict["allocated_size"] = segmentInfo.allocated_size;
     segmentDict["active_size"] = segmentInfo.active_size;
     segmentDict["segment_type"] = (segmentInfo.is_large ? "large" : "small");
+    segmentDict["is_expandable"] = segmentInfo.is_expandable;
 
     py::list blocks;
     for (const auto& blockInfo : segmentInfo.blocks) {
       py::dict blockDict;
       blockDict["size"] = blockInfo.size;
       blockDict["state"] = (blockInfo.allocated ? "active_allocated" : (blockInfo.active ? "active_pending_free" : "inactive"));
+      blockDict["stack_id"] = blockInfo.stack_id;
       blocks.append(blockDict);
     }
     segmentDict["blocks"] = blocks;
@@ -405,6 +447,64 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_recordMemoryHistory(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  int enabled = 0;
+  int record_stacks = 0;
+  Py_ssize_t max_entries = 0;
+  if (!PyArg_ParseTuple(args, "ppn", &enabled, &record_stacks, &max_entries) ||
+      max_entries < 0) {
+    THPUtils_invalidArguments(
+        args, nullptr, "_cuda_recordMemoryHistory", 1,
+        "(bool enabled, bool record_stacks, int max_entries)");
+    return nullptr;
+  }
+  c10::cuda::CUDACachingAllocator::recordHistory(enabled, record_stacks, max_entries);
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_memoryHistory(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to memory_history");
+  const int device = (int) THPUtils_unpackLong(arg);
+
+  using c10::cuda::CUDACachingAllocator::TraceEntryAction;
+
+  const auto actionToString = [](TraceEntryAction action) {
+    switch (action) {
+      case TraceEntryAction::ALLOC: return "alloc";
+      case TraceEntryAction::FREE: return "free";
+      case TraceEntryAction::SEGMENT_ALLOC: return "segment_alloc";
+      case TraceEntryAction::SEGMENT_FREE: return "segment_free";
+      case TraceEntryAction::SEGMENT_MAP: return "segment_map";
+      case TraceEntryAction::SEGMENT_UNMAP: return "segment_unmap";
+      case TraceEntryAction::OOM: return "oom";
+    }
+    return "unknown";
+  };
+
+  const auto history = c10::cuda::CUDACachingAllocator::getHistory(device);
+  py::list entries;
+  for (const auto& entry : history.entries) {
+    py::dict entryDict;
+    entryDict["action"] = actionToString(entry.action);
+    entryDict["address"] = entry.address;
+    entryDict["size"] = entry.size;
+    entryDict["stream"] = entry.stream;
+    entryDict["time_us"] = entry.time_us;
+    entryDict["stack_id"] = entry.stack_id;
+    entries.append(entryDict);
+  }
+  py::dict result;
+  result["entries"] = entries;
+  result["stacks"] = history.stacks;
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
@@ -523,6 +623,7 @@ static struct PyMethodDef _THCPModule_methods[] = {
     (PyCFunction)THCPModule_getDefaultStream_wrap, METH_O, nullptr},
   {"_cuda_getCurrentBlasHandle", (PyCFunction)THCPModule_getCurrentBlasHandle_wrap, METH_NOARGS, nullptr},
   {"_cuda_setStream",    (PyCFunction)THCPModule_setStream_wrap,  METH_O, nullptr},
+  {"_cuda_streamWaitStream", (PyCFunction)THCPModule_streamWaitStream, METH_VARARGS, nullptr},
   {"_cuda_isDriverSufficient", (PyCFunction)THCPModule_isDriverSufficient, METH_NOARGS, nullptr},
   {"_cuda_getDriverVersion", (PyCFunction)THCPModule_getDriverVersion, METH_NOARGS, nullptr},
   {"_cuda_getCompiledVersion", (PyCFunction)THCPModule_getCompiledVersion, METH_NOARGS, nullptr},
@@ -532,6 +633,8 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_resetAccumulatedMemoryStats", (PyCFunction) THCPModule_resetAccumulatedMemoryStats, METH_O, nullptr},
   {"_cuda_resetPeakMemoryStats", (PyCFunction) THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
   {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_recordMemoryHistory", (PyCFunction) THCPModule_recordMemoryHistory, METH_VARARGS, nullptr},
+  {"_cuda_memoryHistory", (PyCFunction) THCPModule_memoryHistory, METH_O, nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_alloc", (PyCFunction)THCPModule_cudaCachingAllocator_raw_alloc, METH_VARARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_delete", (PyCFunction)THCPModule_cudaCachingAllocator_raw_delete, METH_O, nullptr},
@@ -569,6 +672,8 @@ void initCudnnBindings(PyObject* module);
 
 } // namespace shared
 
+void initGraphBindings(PyObject* module);
+
 void initModule(PyObject *module) {
   python::initCommMethods(module);
   // As weird as it seems, this file is also compiled for ROCm,
@@ -578,6 +683,7 @@ void initModule(PyObject *module) {
 #if defined(USE_CUDNN) || defined(__HIP_PLATFORM_HCC__)
   shared::initCudnnBindings(module);
 #endif
+  initGraphBindings(module);
   registerCudaDeviceProperties(module);
 }
 
@@ -10,6 +10,9 @@
 #include <ATen/ATen.h>
 #include <ATen/WrapDimUtils.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <ATen/cuda/CUDAMultiStreamGuard.h>
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/util/Optional.h>
 #include <torch/csrc/autograd/variable.h>
@@ -150,6 +153,38 @@ std::vector<Tensor> broadcast(const Tensor& tensor, IntArrayRef devices) {
 //
 // Similarly for reduce_add_coalesced, when the output are newly created
 // Variables.
+//
+// Pipelining
+// ~~~~~~~~~~
+//
+// When there is more than one bucket, consecutive buckets are flattened and
+// broadcast on different side streams of the devices, so that flattening a
+// bucket overlaps with the transfer of the previous one. The current streams
+// wait for the side streams before the function returns, and the outputs are
+// marked as used on the current streams for the caching allocator.
+static constexpr size_t kBroadcastStreams = 2;
+
+namespace {
+
+// Returns the flattened `tensors` as a view, if they are contiguous and lie
+// back to back in the same storage, as the parameters of a module flattened
+// beforehand do. Returns an undefined tensor otherwise.
+at::Tensor flat_view(const std::vector<at::Tensor>& tensors) {
+  const auto& first = tensors.front();
+  int64_t numel = 0;
+  for (const auto& tensor : tensors) {
+    if (!tensor.is_contiguous() || tensor.dtype() != first.dtype() ||
+        !tensor.storage().is_alias_of(first.storage()) ||
+        tensor.storage_offset() != first.storage_offset() + numel) {
+      return at::Tensor();
+    }
+    numel += tensor.numel();
+  }
+  return first.as_strided({numel}, {1}, first.storage_offset());
+}
+
+} // namespace
+
 tensor_list2d broadcast_coalesced(
     TensorList tensors,
     IntArrayRef devices,
@@ -172,7 +207,35 @@ tensor_list2d broadcast_coalesced(
 
   unique_type_checker type_checker;
   at::cuda::CUDAGuard device_guard(devices[0]);
-  for (auto& chunk : utils::take_tensors(tensors, buffer_size)) {
+  auto chunks = utils::take_tensors(tensors, buffer_size);
+
+  // side_streams[k][i] is the k-th side stream of devices[i]
+  std::vector<std::vector<at::cuda::CUDAStream>> side_streams;
+  std::vector<at::cuda::CUDAStream> current_streams;
+  if (chunks.size() > 1) {
+    for (auto device : devices) {
+      current_streams.push_back(at::cuda::getCurrentCUDAStream(device));
+    }
+    side_streams.resize(std::min(chunks.size(), kBroadcastStreams));
+    for (auto& streams : side_streams) {
+      for (size_t i = 0; i < devices.size(); ++i) {
+        streams.push_back(at::cuda::getStreamFromPool(
+            /*isHighPriority=*/false, devices[i]));
+        // The inputs, and the memory of the outputs, are ready on the
+        // current streams
+        at::cuda::CUDAEvent ready;
+        ready.record(current_streams[i]);
+        ready.block(streams.back());
+      }
+    }
+  }
+
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    auto& chunk = chunks[c];
+    c10::optional<at::cuda::CUDAMultiStreamGuard> stream_guard;
+    if (!side_streams.empty()) {
+      stream_guard.emplace(side_streams[c % side_streams.size()]);
+    }
     auto& type = chunk.type();
     type_checker.show(type);
     std::vector<at::Tensor> results;
@@ -194,8 +257,11 @@ tensor_list2d broadcast_coalesced(
         }
       }
     } else {
-      auto results =
-          broadcast(utils::flatten_dense_tensors(chunk.tensors), devices);
+      auto flat = flat_view(chunk.tensors);
+      if (!flat.defined()) {
+        flat = utils::flatten_dense_tensors(chunk.tensors);
+      }
+      auto results = broadcast(flat, devices);
       for (size_t i = 1, num_devices = devices.size(); i < num_devices; ++i) {
         device_guard.set_index(devices[i]);
         auto& device_outputs = outputs[i];
@@ -209,6 +275,26 @@ tensor_list2d broadcast_coalesced(
     }
   }
 
+  for (auto& streams : side_streams) {
+    for (size_t i = 0; i < devices.size(); ++i) {
+      at::cuda::CUDAEvent done;
+      done.record(streams[i]);
+      done.block(current_streams[i]);
+    }
+  }
+  if (!side_streams.empty()) {
+    for (size_t i = 1; i < devices.size(); ++i) {
+      for (auto& output : outputs[i]) {
+        for (const auto& dense : output.is_sparse()
+                 ? std::vector<at::Tensor>{output._indices(), output._values()}
+                 : std::vector<at::Tensor>{output}) {
+          c10::cuda::CUDACachingAllocator::recordStream(
+              dense.storage().data_ptr(), current_streams[i]);
+        }
+      }
+    }
+  }
+
   // If we only saw a single tensor type, then we can skip expensive reordering
   if (!type_checker.unique) {
     for (auto& o : outputs)
@@ -11,6 +11,7 @@ using version_tuple = std::tuple<size_t, size_t, size_t>;
 }
 
 #ifdef USE_CUDNN
+#include <ATen/native/cudnn/ConvBenchmarkCache.h>
 #include <cudnn.h>
 
 namespace {
@@ -87,6 +88,11 @@ void initCudnnBindings(PyObject* module) {
   cudnn.def("getRuntimeVersion", getRuntimeVersion);
   cudnn.def("getCompileVersion", getCompileVersion);
   cudnn.def("getVersionInt", getVersionInt);
+
+#ifdef USE_CUDNN
+  cudnn.def("_save_conv_benchmark_cache", at::native::cudnn_save_conv_benchmark_cache);
+  cudnn.def("_load_conv_benchmark_cache", at::native::cudnn_load_conv_benchmark_cache);
+#endif
 }
 
 } // namespace shared
@@ -4,6 +4,7 @@
 
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/functions/accumulate_grad.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
 
 namespace torch {
 namespace distributed {
@@ -145,13 +146,64 @@ void DistAutogradContext::addOutstandingRpc(
   outStandingRpcs_.push_back(futureMessage);
 }
 
+void DistAutogradContext::addPendingGradients(
+    rpc::worker_id_t workerId,
+    const AutogradMetadata& autogradMetadata,
+    std::vector<torch::autograd::Variable> grads,
+    bool retainGraph) {
+  std::unique_lock<std::mutex> lock(lock_);
+  auto& pending = pendingGradients_[workerId];
+  for (const auto& grad : grads) {
+    pending.nbytes += grad.numel() * grad.element_size();
+  }
+  pending.autogradMetadata.push_back(autogradMetadata);
+  pending.grads.push_back(std::move(grads));
+  pending.retainGraph = retainGraph;
+  if (pending.nbytes < kPendingGradientsFlushBytes) {
+    return;
+  }
+  auto full = std::move(pending);
+  pendingGradients_.erase(workerId);
+  lock.unlock();
+  sendGradients(workerId, std::move(full));
+}
+
+void DistAutogradContext::sendPendingGradients() {
+  std::unique_lock<std::mutex> lock(lock_);
+  auto pendingGradients = std::move(pendingGradients_);
+  pendingGradients_.clear();
+  lock.unlock();
+
+  for (auto& entry : pendingGradients) {
+    sendGradients(entry.first, std::move(entry.second));
+  }
+}
+
+void DistAutogradContext::sendGradients(
+    rpc::worker_id_t workerId,
+    PendingGradients&& pending) {
+  PropagateGradientsReq gradCall(
+      std::move(pending.autogradMetadata),
+      std::move(pending.grads),
+      pending.retainGraph);
+
+  auto rpcAgent = rpc::RpcAgent::getCurrentRpcAgent();
+  auto futureMessage = rpcAgent->send(
+      rpcAgent->getWorkerInfo(workerId), std::move(gradCall).toMessage());
+  addOutstandingRpc(futureMessage);
+}
+
 void DistAutogradContext::clearOutstandingRpcs() {
   std::unique_lock<std::mutex> lock(lock_);
   outStandingRpcs_.clear();
+  pendingGradients_.clear();
 }
 
 std::shared_ptr<rpc::FutureMessage> DistAutogradContext::
     clearAndWaitForOutstandingRpcsAsync() {
+  // The buffered gradients have to be sent before the RPCs can be waited on.
+  sendPendingGradients();
+
   std::unique_lock<std::mutex> lock(lock_);
   auto outStandingRpcs = std::move(outStandingRpcs_);
   lock.unlock();
@@ -250,6 +302,40 @@ ContextPtr ThreadLocalDistAutogradContext::getContextPtr() {
   return tl_context_ptr;
 }
 
+namespace {
+thread_local PendingGradientsGuard* current_pending_gradients_guard = nullptr;
+} // namespace
+
+PendingGradientsGuard::PendingGradientsGuard()
+    : prev_guard_(current_pending_gradients_guard) {
+  current_pending_gradients_guard = this;
+}
+
+PendingGradientsGuard::~PendingGradientsGuard() {
+  current_pending_gradients_guard = prev_guard_;
+}
+
+PendingGradientsGuard* PendingGradientsGuard::current() {
+  return current_pending_gradients_guard;
+}
+
+void PendingGradientsGuard::addContext(const ContextPtr& context) {
+  for (const auto& c : contexts_) {
+    if (c == context) {
+      return;
+    }
+  }
+  contexts_.push_back(context);
+}
+
+void PendingGradientsGuard::sendPendingGradients() {
+  auto contexts = std::move(contexts_);
+  contexts_.clear();
+  for (const auto& context : contexts) {
+    context->sendPendingGradients();
+  }
+}
+
 } // namespace autograd
 } // namespace distributed
 } // namespace torch
@@ -7,6 +7,7 @@
 #include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
 #include <torch/csrc/distributed/autograd/functions/sendrpc_backward.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/autograd_metadata.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
 namespace torch {
@@ -54,6 +55,20 @@ class TORCH_API DistAutogradContext {
   void addOutstandingRpc(
       const std::shared_ptr<rpc::FutureMessage>& futureMessage);
 
+  // Buffers the gradients of a 'recv' function to be sent to the given worker
+  // along with the other gradients buffered for it, in a single
+  // PropagateGradientsReq. The buffered gradients are sent once they reach
+  // kPendingGradientsFlushBytes, or by sendPendingGradients().
+  void addPendingGradients(
+      rpc::worker_id_t workerId,
+      const AutogradMetadata& autogradMetadata,
+      std::vector<torch::autograd::Variable> grads,
+      bool retainGraph);
+
+  // Sends all the buffered gradients, one RPC per worker, and records the
+  // futures as outstanding RPCs.
+  void sendPendingGradients();
+
   // Returns all gradients.
   const c10::Dict<torch::Tensor, torch::Tensor> getGradients() const;
 
@@ -108,6 +123,16 @@ class TORCH_API DistAutogradContext {
 
   void clearOutstandingRpcs();
 
+  // The gradients buffered for a worker by addPendingGradients.
+  struct PendingGradients {
+    std::vector<AutogradMetadata> autogradMetadata;
+    std::vector<std::vector<torch::autograd::Variable>> grads;
+    size_t nbytes = 0;
+    bool retainGraph = false;
+  };
+
+  void sendGradients(rpc::worker_id_t workerId, PendingGradients&& pending);
+
   const int64_t contextId_;
 
   // Set containing known worker IDs, used in cleaning up autograd context.
@@ -136,12 +161,48 @@ class TORCH_API DistAutogradContext {
   // successfully only if all these futures are done and are successful.
   std::vector<std::shared_ptr<rpc::FutureMessage>> outStandingRpcs_;
 
+  // Gradients computed by 'recv' functions that haven't been sent yet, by
+  // the worker they are sent to.
+  std::unordered_map<rpc::worker_id_t, PendingGradients> pendingGradients_;
+
   // Lock to protect concurrent modification of the context.
   mutable std::mutex lock_;
 };
 
 using ContextPtr = std::shared_ptr<DistAutogradContext>;
 
+// The buffered gradients of a worker are sent as soon as they reach this
+// size.
+constexpr size_t kPendingGradientsFlushBytes = 1 << 20;
+
+// While an instance of this class is alive, the 'recv' functions run by the
+// current thread buffer their gradients in their autograd context instead of
+// sending them right away, so that gradients for the same worker are sent
+// together. The owner is expected to call sendPendingGradients() before it
+// waits on anything that depends on the buffered gradients. Threads which
+// don't hold an instance send the gradients right away.
+class TORCH_API PendingGradientsGuard {
+ public:
+  PendingGradientsGuard();
+  ~PendingGradientsGuard();
+
+  PendingGradientsGuard(const PendingGradientsGuard&) = delete;
+  PendingGradientsGuard& operator=(const PendingGradientsGuard&) = delete;
+
+  // Retrieve the guard of the current thread, or null.
+  static PendingGradientsGuard* current();
+
+  // Records that gradients were buffered in the given context.
+  void addContext(const ContextPtr& context);
+
+  // Sends the gradients buffered in all the recorded contexts.
+  void sendPendingGradients();
+
+ private:
+  PendingGradientsGuard* prev_guard_;
+  std::vector<ContextPtr> contexts_;
+};
+
 // This class stores a shared_ptr to a DistAutogradContext instance in a
 // thread local variable. The instance is given by the call site. The class
 // doesn't know the current context. It's just a util class.
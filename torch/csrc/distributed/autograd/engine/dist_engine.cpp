@@ -294,6 +294,9 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
 
   torch::autograd::set_device(torch::autograd::CPU_DEVICE);
   graph_task->owner_ = torch::autograd::CPU_DEVICE;
+  // Buffer the gradients of the 'recv' functions run below, so that all the
+  // gradients for a node are sent in a single RPC once the queue is drained.
+  PendingGradientsGuard pendingGradientsGuard;
   while (!cpu_ready_queue->empty()) {
     std::shared_ptr<GraphTask> local_graph_task;
     {
@@ -322,6 +325,15 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
     // Decrement the outstanding task.
     --local_graph_task->outstanding_tasks_;
   }
+  try {
+    pendingGradientsGuard.sendPendingGradients();
+  } catch (std::exception& e) {
+    // Fail the backward pass like a 'recv' function failing to send would.
+    graph_task->set_exception_without_signal(nullptr);
+    if (!graph_task->future_completed_.exchange(true)) {
+      graph_task->future_result_->setErrorIfNeeded(e.what());
+    }
+  }
   // Check if we've completed execution.
   if (graph_task->completed()) {
     // We don't need to explicitly notify the owner thread, since
@@ -468,6 +480,16 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
   }
 }
 
+std::shared_ptr<rpc::FutureMessage> DistEngine::executeLocalSendFunctionAsync(
+    const ContextPtr& autogradContext,
+    int64_t autogradMessageId,
+    variable_list grads,
+    bool retainGraph) {
+  auto sendFunction = autogradContext->retrieveSendFunction(autogradMessageId);
+  sendFunction->setGrads(std::move(grads));
+  return executeSendFunctionAsync(autogradContext, sendFunction, retainGraph);
+}
+
 void DistEngine::execute(
     int64_t contextId,
     const variable_list& roots,
@@ -49,6 +49,16 @@ class TORCH_API DistEngine {
       const std::shared_ptr<torch::autograd::Node>& sendFunction,
       bool retainGraph);
 
+  // Used by a 'recv' function whose 'send' function is on this node, which
+  // happens for RPCs to self. Attaches the gradients to the 'send' function of
+  // the autograd context with the given message id and executes it, the way
+  // a PropagateGradientsReq would, without going through the RPC agent.
+  std::shared_ptr<rpc::FutureMessage> executeLocalSendFunctionAsync(
+      const ContextPtr& autogradContext,
+      int64_t autogradMessageId,
+      torch::autograd::variable_list grads,
+      bool retainGraph);
+
   // Number of backward passes currently running for the Distributed Engine.
   size_t numBackwardPasses() const;
 
@@ -1,5 +1,7 @@
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
 #include <ATen/core/functional.h>
+#include <torch/csrc/distributed/autograd/context/container.h>
+#include <torch/csrc/distributed/autograd/engine/dist_engine.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
@@ -38,12 +40,33 @@ variable_list RecvRpcBackward::apply(variable_list&& grads) {
           "means the autograd context was cleaned up by a different thread due ",
           "to an error before RecvRcpBackward had a chance to run"));
 
+  bool retainGraph = sharedContext->retrieveGraphTask()->keep_graph_;
+
+  // The 'send' function is on this node for RPCs to self, hand the gradients
+  // to it directly instead of serializing them.
+  if (fromWorkerId_ == DistAutogradContainer::getInstance().getWorkerId()) {
+    sharedContext->addOutstandingRpc(
+        DistEngine::getInstance().executeLocalSendFunctionAsync(
+            sharedContext,
+            autogradMetadata_.autogradMessageId,
+            std::move(outputGrads),
+            retainGraph));
+    return variable_list();
+  }
+
+  // On threads running the distributed engine, the gradients are buffered and
+  // sent along with the other gradients for the same node.
+  if (auto pendingGuard = PendingGradientsGuard::current()) {
+    sharedContext->addPendingGradients(
+        fromWorkerId_, autogradMetadata_, std::move(outputGrads), retainGraph);
+    pendingGuard->addContext(sharedContext);
+    return variable_list();
+  }
+
   // Send the gradients over the wire and record the future in the autograd
   // context.
   PropagateGradientsReq gradCall(
-      autogradMetadata_,
-      outputGrads,
-      sharedContext->retrieveGraphTask()->keep_graph_);
+      autogradMetadata_, std::move(outputGrads), retainGraph);
 
   // Send the gradients over to the appropriate node.
   auto rpcAgent = rpc::RpcAgent::getCurrentRpcAgent();
@@ -2,6 +2,8 @@
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <torch/csrc/jit/serialization/pickle.h>
 
+#include <algorithm>
+
 namespace torch {
 namespace distributed {
 namespace autograd {
@@ -14,20 +16,42 @@ PropagateGradientsReq::PropagateGradientsReq(
     const AutogradMetadata& autogradMetadata,
     std::vector<Variable> grads,
     bool retainGraph)
-    : autogradMetadata_(autogradMetadata),
+    : retainGraph_(retainGraph) {
+  autogradMetadata_.push_back(autogradMetadata);
+  grads_.push_back(std::move(grads));
+}
+
+PropagateGradientsReq::PropagateGradientsReq(
+    std::vector<AutogradMetadata> autogradMetadata,
+    std::vector<std::vector<Variable>> grads,
+    bool retainGraph)
+    : autogradMetadata_(std::move(autogradMetadata)),
       grads_(std::move(grads)),
-      retainGraph_(retainGraph) {}
+      retainGraph_(retainGraph) {
+  TORCH_INTERNAL_ASSERT(
+      !autogradMetadata_.empty() && autogradMetadata_.size() == grads_.size());
+  for (const auto& metadata : autogradMetadata_) {
+    TORCH_INTERNAL_ASSERT(
+        metadata.autogradContextId == autogradMetadata_[0].autogradContextId);
+  }
+}
 
 Message PropagateGradientsReq::toMessageImpl() && {
   std::vector<at::IValue> ivalues;
-  // Add all the grad tensors.
-  for (const auto& grad : grads_) {
-    ivalues.emplace_back(grad);
+  // Add the grad tensors of every send function, followed by their number and
+  // the autograd message id of the send function.
+  for (size_t i = 0; i < grads_.size(); i++) {
+    for (const auto& grad : grads_[i]) {
+      ivalues.emplace_back(grad);
+    }
+    ivalues.emplace_back(static_cast<int64_t>(grads_[i].size()));
+    ivalues.emplace_back(autogradMetadata_[i].autogradMessageId);
   }
 
-  // Now add autograd metadata.
-  ivalues.emplace_back(autogradMetadata_.autogradContextId);
-  ivalues.emplace_back(autogradMetadata_.autogradMessageId);
+  // Now add the autograd context id, shared by all send functions, and their
+  // number.
+  ivalues.emplace_back(autogradMetadata_[0].autogradContextId);
+  ivalues.emplace_back(static_cast<int64_t>(autogradMetadata_.size()));
 
   // Add retain graph.
   ivalues.emplace_back(retainGraph_);
@@ -56,38 +80,58 @@ std::unique_ptr<PropagateGradientsReq> PropagateGradientsReq::fromMessage(
   std::vector<at::IValue> tupleElements = tuple.toTuple()->elements();
 
   // Build PropagateGradientsReq.
-  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 3);
+  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 5);
 
   // Retrieve retainGraph.
   bool retainGraph = tupleElements.back().toBool();
   tupleElements.pop_back();
 
-  // Build AutogradMetadata.
-  int64_t autogradContextId, autogradMessageId;
-  autogradMessageId = tupleElements.back().toInt();
+  // Retrieve the number of send functions and the autograd context id.
+  int64_t numSendFunctions = tupleElements.back().toInt();
   tupleElements.pop_back();
-  autogradContextId = tupleElements.back().toInt();
+  int64_t autogradContextId = tupleElements.back().toInt();
   tupleElements.pop_back();
-
-  AutogradMetadata autogradMetadata(autogradContextId, autogradMessageId);
-
-  // Retrieve the gradient tensors.
-  std::vector<Variable> grads(tupleElements.size());
-  for (size_t i = 0; i < tupleElements.size(); i++) {
-    grads[i] = tupleElements[i].toTensor();
+  TORCH_INTERNAL_ASSERT(numSendFunctions > 0);
+
+  // Retrieve the autograd metadata and the gradient tensors of every send
+  // function, starting from the last one.
+  std::vector<AutogradMetadata> autogradMetadata;
+  std::vector<std::vector<Variable>> grads(numSendFunctions);
+  autogradMetadata.reserve(numSendFunctions);
+  for (int64_t i = numSendFunctions - 1; i >= 0; i--) {
+    TORCH_INTERNAL_ASSERT(tupleElements.size() >= 2);
+    int64_t autogradMessageId = tupleElements.back().toInt();
+    tupleElements.pop_back();
+    int64_t numGrads = tupleElements.back().toInt();
+    tupleElements.pop_back();
+    TORCH_INTERNAL_ASSERT(
+        numGrads >= 0 && static_cast<size_t>(numGrads) <= tupleElements.size());
+
+    autogradMetadata.emplace_back(autogradContextId, autogradMessageId);
+    grads[i].resize(numGrads);
+    for (int64_t j = numGrads - 1; j >= 0; j--) {
+      grads[i][j] = tupleElements.back().toTensor();
+      tupleElements.pop_back();
+    }
   }
+  TORCH_INTERNAL_ASSERT(tupleElements.empty());
+  std::reverse(autogradMetadata.begin(), autogradMetadata.end());
+
+  return std::unique_ptr<PropagateGradientsReq>(new PropagateGradientsReq(
+      std::move(autogradMetadata), std::move(grads), retainGraph));
+}
 
-  return std::unique_ptr<PropagateGradientsReq>(
-      new PropagateGradientsReq(autogradMetadata, grads, retainGraph));
+size_t PropagateGradientsReq::numSendFunctions() const {
+  return autogradMetadata_.size();
 }
 
-const AutogradMetadata& PropagateGradientsReq::getAutogradMetadata() {
-  return autogradMetadata_;
+const AutogradMetadata& PropagateGradientsReq::getAutogradMetadata(size_t i) {
+  return autogradMetadata_.at(i);
 }
 
-const std::vector<torch::autograd::Variable>& PropagateGradientsReq::
-    getGrads() {
-  return grads_;
+const std::vector<torch::autograd::Variable>& PropagateGradientsReq::getGrads(
+    size_t i) {
+  return grads_.at(i);
 }
 
 bool PropagateGradientsReq::retainGraph() {
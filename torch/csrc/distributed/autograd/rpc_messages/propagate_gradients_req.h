@@ -11,7 +11,9 @@ namespace autograd {
 
 // Used to propagate gradients from one node to another during a distributed
 // backwards pass. This RPC call is invoked when we hit a `recv` autograd
-// function during backward pass execution.
+// function during backward pass execution. The gradients of several `recv`
+// functions of the same autograd context can be sent in a single request, in
+// the order they were computed.
 class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
  public:
   PropagateGradientsReq(
@@ -19,9 +21,17 @@ class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
       std::vector<torch::autograd::Variable> grads,
       bool retainGraph = false);
 
-  const AutogradMetadata& getAutogradMetadata();
+  PropagateGradientsReq(
+      std::vector<AutogradMetadata> autogradMetadata,
+      std::vector<std::vector<torch::autograd::Variable>> grads,
+      bool retainGraph = false);
+
+  // The number of `send` functions the request holds gradients for.
+  size_t numSendFunctions() const;
+
+  const AutogradMetadata& getAutogradMetadata(size_t i = 0);
 
-  const std::vector<torch::autograd::Variable>& getGrads();
+  const std::vector<torch::autograd::Variable>& getGrads(size_t i = 0);
 
   // Serialization and deserialization methods.
   rpc::Message toMessageImpl() && override;
@@ -32,8 +42,8 @@ class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
   bool retainGraph();
 
  private:
-  AutogradMetadata autogradMetadata_;
-  std::vector<torch::autograd::Variable> grads_;
+  std::vector<AutogradMetadata> autogradMetadata_;
+  std::vector<std::vector<torch::autograd::Variable>> grads_;
   bool retainGraph_;
 };
 
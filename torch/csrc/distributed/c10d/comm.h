@@ -3,6 +3,7 @@
 #include <memory>
 
 #include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
 #include <c10d/ProcessGroup.hpp>
 
 namespace c10d {
@@ -13,4 +14,41 @@ void broadcast_coalesced(
     at::TensorList tensors,
     size_t buffer_size);
 
+// The gradients of one bucket that are passed to a communication hook: one
+// flattened tensor per model replica. The tensors have already been divided
+// by the world size, so summing them across processes yields the average.
+class GradBucket {
+ public:
+  explicit GradBucket(std::vector<at::Tensor> tensors)
+      : tensors_(std::move(tensors)) {}
+
+  // Each tensor in the list returned by getTensors() corresponds to a replica
+  // and holds the flattened gradients of all variables in the bucket.
+  const std::vector<at::Tensor>& getTensors() const {
+    return tensors_;
+  }
+
+ private:
+  std::vector<at::Tensor> tensors_;
+};
+
+// A communication hook replaces the allreduce the Reducer would otherwise run
+// for each (dense) bucket, e.g. to compress the gradients before they are
+// sent. Hooks run in the backward pass, in the same order on all processes.
+class CommHookInterface {
+ public:
+  virtual ~CommHookInterface() {}
+
+  // Starts communicating the gradients of the bucket and returns a future.
+  // The Reducer waits on it at the end of the backward pass, before it writes
+  // the result back to the parameter gradients.
+  virtual c10::intrusive_ptr<c10::ivalue::Future> runHook(
+      const GradBucket& bucket) = 0;
+
+  // Turns the value of the completed future into one tensor per replica,
+  // with the same number of elements as the bucket tensors. These are
+  // copied into the bucket unless they already alias it.
+  virtual std::vector<at::Tensor> processFuture(c10::IValue future_value) = 0;
+};
+
 } // namespace c10d
@@ -0,0 +1,51 @@
+#include <torch/csrc/distributed/c10d/default_comm_hooks.h>
+
+namespace c10d {
+
+c10::intrusive_ptr<c10::ivalue::Future> AllReduceCommHook::runHook(
+    const GradBucket& bucket) {
+  std::vector<at::Tensor> tensors = bucket.getTensors();
+  auto work = process_group_->allreduce(tensors);
+  return work->getFuture()->then(
+      [tensors]() { return c10::IValue(tensors); },
+      c10::ListType::ofTensors());
+}
+
+std::vector<at::Tensor> AllReduceCommHook::processFuture(
+    c10::IValue future_value) {
+  return future_value.toTensorVector();
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> FP16CompressCommHook::runHook(
+    const GradBucket& bucket) {
+  std::vector<at::Tensor> compressed;
+  compressed.reserve(bucket.getTensors().size());
+  for (const auto& tensor : bucket.getTensors()) {
+    compressed.push_back(tensor.to(at::kHalf));
+  }
+  auto work = process_group_->allreduce(compressed);
+  return work->getFuture()->then(
+      [compressed]() { return c10::IValue(compressed); },
+      c10::ListType::ofTensors());
+}
+
+std::vector<at::Tensor> FP16CompressCommHook::processFuture(
+    c10::IValue future_value) {
+  // The Reducer copies the result into the bucket, which casts it back to
+  // the bucket's dtype.
+  return future_value.toTensorVector();
+}
+
+std::unique_ptr<CommHookInterface> makeBuiltinCommHook(
+    BuiltinCommHookType type,
+    std::shared_ptr<ProcessGroup> process_group) {
+  switch (type) {
+    case BuiltinCommHookType::ALLREDUCE:
+      return std::make_unique<AllReduceCommHook>(std::move(process_group));
+    case BuiltinCommHookType::FP16_COMPRESS:
+      return std::make_unique<FP16CompressCommHook>(std::move(process_group));
+  }
+  TORCH_CHECK(false, "Unknown built-in DDP communication hook type.");
+}
+
+} // namespace c10d
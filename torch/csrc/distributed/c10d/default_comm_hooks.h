@@ -0,0 +1,49 @@
+#pragma once
+
+#include <torch/csrc/distributed/c10d/comm.h>
+
+namespace c10d {
+
+// Communication hooks that are implemented in C++ and can be registered
+// without going through Python.
+enum class BuiltinCommHookType {
+  // Allreduces the bucket, i.e. does what the Reducer does without a hook.
+  ALLREDUCE = 1,
+  // Casts the bucket to float16 before allreducing it and back afterwards,
+  // which halves the amount of data sent.
+  FP16_COMPRESS = 2,
+};
+
+class AllReduceCommHook : public CommHookInterface {
+ public:
+  explicit AllReduceCommHook(std::shared_ptr<ProcessGroup> process_group)
+      : process_group_(std::move(process_group)) {}
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(
+      const GradBucket& bucket) override;
+
+  std::vector<at::Tensor> processFuture(c10::IValue future_value) override;
+
+ private:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+class FP16CompressCommHook : public CommHookInterface {
+ public:
+  explicit FP16CompressCommHook(std::shared_ptr<ProcessGroup> process_group)
+      : process_group_(std::move(process_group)) {}
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(
+      const GradBucket& bucket) override;
+
+  std::vector<at::Tensor> processFuture(c10::IValue future_value) override;
+
+ private:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+std::unique_ptr<CommHookInterface> makeBuiltinCommHook(
+    BuiltinCommHookType type,
+    std::shared_ptr<ProcessGroup> process_group);
+
+} // namespace c10d
@@ -23,7 +23,11 @@
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/comm.h>
+#include <torch/csrc/distributed/c10d/default_comm_hooks.h>
+#include <torch/csrc/distributed/c10d/python_comm_hook.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
+#include <torch/csrc/distributed/c10d/sharded_embedding_bag.h>
+#include <torch/csrc/jit/python/pybind_utils.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
@@ -35,6 +39,8 @@ namespace {
 
 #ifdef USE_C10D_GLOO
 constexpr char* GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
+constexpr char* GLOO_HIERARCHICAL_ALLREDUCE_ENV =
+    "TORCH_GLOO_HIERARCHICAL_ALLREDUCE";
 #endif
 
 std::vector<std::string> split(char separator, const std::string& string) {
@@ -115,6 +121,48 @@ PyObject* c10d_init(PyObject* _unused) {
 
   auto module = py::handle(c10d_module).cast<py::module>();
 
+  module.def(
+      "_register_comm_hook",
+      [](::c10d::Reducer& reducer, py::object state, py::object comm_hook) {
+        reducer.register_comm_hook(std::make_unique<::c10d::PythonCommHook>(
+            std::move(state), std::move(comm_hook)));
+      },
+      py::arg("reducer"),
+      py::arg("state"),
+      py::arg("comm_hook"));
+
+  module.def(
+      "_register_builtin_comm_hook",
+      [](::c10d::Reducer& reducer,
+         std::shared_ptr<::c10d::ProcessGroup> process_group,
+         ::c10d::BuiltinCommHookType comm_hook_type) {
+        reducer.register_comm_hook(::c10d::makeBuiltinCommHook(
+            comm_hook_type, std::move(process_group)));
+      },
+      py::arg("reducer"),
+      py::arg("process_group"),
+      py::arg("comm_hook_type"),
+      py::call_guard<py::gil_scoped_release>());
+
+  shared_ptr_class_<::c10d::GradBucket>(module, "_GradBucket")
+      .def(py::init<std::vector<at::Tensor>>(), py::arg("tensors"))
+      .def(
+          "get_tensors",
+          &::c10d::GradBucket::getTensors,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+            ``get_tensors`` returns a list of ``torch.Tensor``. Each tensor in
+            the list refers to the replica on each device. There will be
+            multiple replicas only in the case of single process multiple
+            device mode. In the single process single device mode, this list
+            would consist of only a single tensor.
+           )");
+
+  py::enum_<::c10d::BuiltinCommHookType>(module, "BuiltinCommHookType", R"(
+An enum-like class for built-in communication hooks: ``ALLREDUCE`` and ``FP16_COMPRESS``.)")
+      .value("ALLREDUCE", ::c10d::BuiltinCommHookType::ALLREDUCE)
+      .value("FP16_COMPRESS", ::c10d::BuiltinCommHookType::FP16_COMPRESS);
+
   shared_ptr_class_<::c10d::Reducer>(module, "Reducer")
       .def(
           py::init<
@@ -123,6 +171,7 @@ PyObject* c10d_init(PyObject* _unused) {
               std::shared_ptr<::c10d::ProcessGroup>,
               std::vector<std::vector<bool>>,
               int64_t,
+              bool,
               bool>(),
           py::arg("replicas"),
           py::arg("bucket_indices"),
@@ -130,6 +179,7 @@ PyObject* c10d_init(PyObject* _unused) {
           py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>(),
           py::arg("bucket_bytes_cap") = ::c10d::kDefaultBucketBytesCap,
           py::arg("find_unused_parameters") = false,
+          py::arg("gradient_as_bucket_view") = false,
           py::call_guard<py::gil_scoped_release>())
       .def(
           "initialize_buckets",
@@ -146,6 +196,58 @@ PyObject* c10d_init(PyObject* _unused) {
           py::call_guard<py::gil_scoped_release>())
       .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
 
+  shared_ptr_class_<::c10d::ShardedEmbeddingBag>(module, "_ShardedEmbeddingBag")
+      .def(
+          py::init<
+              std::shared_ptr<::c10d::ProcessGroup>,
+              std::vector<int64_t>,
+              std::vector<int64_t>,
+              std::vector<at::Tensor>,
+              int64_t,
+              bool>(),
+          py::arg("process_group"),
+          py::arg("table_ranks"),
+          py::arg("table_dims"),
+          py::arg("weights"),
+          py::arg("mode"),
+          py::arg("sparse") = false,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "forward",
+          [](::c10d::ShardedEmbeddingBag& self,
+             std::vector<at::Tensor> indices,
+             std::vector<at::Tensor> offsets)
+              -> std::shared_ptr<torch::jit::PythonFutureWrapper> {
+            return std::make_shared<torch::jit::PythonFutureWrapper>(
+                self.forward(std::move(indices), std::move(offsets)));
+          },
+          py::arg("indices"),
+          py::arg("offsets"),
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+            Starts looking up the bags of every table for the local batch and
+            returns a ``torch._C.Future`` whose value is the list of the pooled
+            embeddings of every table.
+           )")
+      .def(
+          "backward",
+          [](::c10d::ShardedEmbeddingBag& self,
+             std::vector<at::Tensor> grad_outputs)
+              -> std::shared_ptr<torch::jit::PythonFutureWrapper> {
+            return std::make_shared<torch::jit::PythonFutureWrapper>(
+                self.backward(std::move(grad_outputs)));
+          },
+          py::arg("grad_outputs"),
+          py::call_guard<py::gil_scoped_release>(),
+          R"(
+            Starts sending the gradients of the pooled embeddings of the last
+            ``forward`` to the owners of their tables and returns a
+            ``torch._C.Future`` whose value is the list of the gradients of the
+            local weights.
+           )")
+      .def_property_readonly(
+          "weights", &::c10d::ShardedEmbeddingBag::weights);
+
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
 ``MIN``, ``MAX``, ``BAND``, ``BOR``, and ``BXOR``.
@@ -258,7 +360,57 @@ They are used in specifying strategies for reduction collectives, e.g.,
                  const std::chrono::milliseconds& timeout) {
                 store.wait(keys, timeout);
               },
-              py::call_guard<py::gil_scoped_release>());
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                py::gil_scoped_release release;
+                store.multiSet(keys, values_);
+              })
+          // Convert from std::vector<uint8_t> to py::bytes, with the GIL
+          // held.
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (const auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size()));
+                }
+                return result;
+              })
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected_value,
+                 const std::string& desired_value) -> py::bytes {
+                std::vector<uint8_t> value;
+                {
+                  py::gil_scoped_release release;
+                  value = store.compareSet(
+                      key,
+                      std::vector<uint8_t>(
+                          expected_value.begin(), expected_value.end()),
+                      std::vector<uint8_t>(
+                          desired_value.begin(), desired_value.end()));
+                }
+                return py::bytes(
+                    reinterpret_cast<char*>(value.data()), value.size());
+              });
 
   shared_ptr_class_<::c10d::FileStore>(module, "FileStore", store)
       .def(py::init<const std::string&, int>());
@@ -549,16 +701,22 @@ They are used in specifying strategies for reduction collectives, e.g.,
 
   module.def(
       "_round_robin_process_groups",
-      [](std::vector<std::shared_ptr<::c10d::ProcessGroup>> processGroups)
+      [](std::vector<std::shared_ptr<::c10d::ProcessGroup>> processGroups,
+         size_t stripeThresholdBytes)
           -> std::shared_ptr<::c10d::ProcessGroup> {
         if (processGroups.size() == 0) {
           throw std::invalid_argument("Specify at least 1 process group");
         }
         const auto& first = processGroups.front();
         return std::make_shared<::c10d::ProcessGroupRoundRobin>(
-            first->getRank(), first->getSize(), std::move(processGroups));
+            first->getRank(),
+            first->getSize(),
+            std::move(processGroups),
+            stripeThresholdBytes);
       },
       py::arg("process_groups"),
+      py::arg("stripe_threshold_bytes") =
+          ::c10d::ProcessGroupRoundRobin::kDefaultStripeThresholdBytes,
       py::call_guard<py::gil_scoped_release>());
 
 #ifdef USE_C10D_GLOO
@@ -572,7 +730,13 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "hierarchical_allreduce",
+          &::c10d::ProcessGroupGloo::Options::hierarchicalAllreduce)
+      .def_readwrite(
+          "hierarchical_allreduce_slot_bytes",
+          &::c10d::ProcessGroupGloo::Options::hierarchicalAllreduceSlotBytes);
 
   processGroupGloo.def_static(
       "create_device",
@@ -618,6 +782,13 @@ They are used in specifying strategies for reduction collectives, e.g.,
                   ::c10d::ProcessGroupGloo::createDefaultDevice());
             }
 
+            // Use hierarchical allreduce if
+            // "TORCH_GLOO_HIERARCHICAL_ALLREDUCE" is set to 1.
+            char* hierarchicalEnv = getenv(GLOO_HIERARCHICAL_ALLREDUCE_ENV);
+            if (hierarchicalEnv && std::string(hierarchicalEnv) == "1") {
+              options.hierarchicalAllreduce = true;
+            }
+
             options.timeout = timeout;
             options.threads = options.devices.size() * 2;
             return std::make_shared<::c10d::ProcessGroupGloo>(
@@ -671,7 +842,19 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(
           "wait",
           &::c10d::ProcessGroup::Work::wait,
-          py::call_guard<py::gil_scoped_release>());
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "get_future",
+          [](::c10d::ProcessGroup::Work& work)
+              -> std::shared_ptr<torch::jit::PythonFutureWrapper> {
+            return std::make_shared<torch::jit::PythonFutureWrapper>(
+                work.getFuture());
+          },
+          R"(
+            Returns a ``torch._C.Future`` that is completed once the work has
+            finished. Its value is ``None``; chain ``then`` onto it to operate
+            on the result of the collective, e.g. in a DDP communication hook.
+           )");
 
   module.def(
       "_compute_bucket_assignment_by_size",
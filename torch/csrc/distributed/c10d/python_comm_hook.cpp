@@ -0,0 +1,55 @@
+#include <torch/csrc/distributed/c10d/python_comm_hook.h>
+
+#include <torch/csrc/jit/python/pybind_utils.h>
+
+namespace c10d {
+
+PythonCommHook::~PythonCommHook() {
+  // The Reducer that owns this hook may be destroyed without holding the GIL.
+  py::gil_scoped_acquire ag;
+  state_.dec_ref();
+  hook_.dec_ref();
+  // Explicitly set state_ and hook_ to nullptr to prevent py::object's dtor
+  // to decref on the PyObject again.
+  // See Note [Destructing py::object] in python_ivalue.h
+  state_.ptr() = nullptr;
+  hook_.ptr() = nullptr;
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> PythonCommHook::runHook(
+    const GradBucket& bucket) {
+  py::gil_scoped_acquire acquire;
+
+  py::object py_fut = hook_(state_, bucket);
+
+  try {
+    return py_fut.cast<std::shared_ptr<torch::jit::PythonFutureWrapper>>()
+        ->fut;
+  } catch (const py::cast_error& e) {
+    auto type = py_fut.get_type();
+    auto errMsg = c10::str(
+        e.what(),
+        ". DDP communication hook's callback must return a "
+        "torch.futures.Future or torch._C.Future object, but got ",
+        type.attr("__module__").cast<std::string>(),
+        ".",
+        type.attr("__qualname__").cast<std::string>());
+    throw std::runtime_error(errMsg);
+  }
+}
+
+std::vector<at::Tensor> PythonCommHook::processFuture(
+    c10::IValue future_value) {
+  // Values set by Future.then() callbacks written in Python are opaque
+  // Python objects; convert them to a list of tensors.
+  if (future_value.isPyObject()) {
+    py::gil_scoped_acquire ag;
+    py::object obj = torch::jit::toPyObject(future_value);
+    auto value = torch::jit::toIValue(
+        obj, c10::ListType::create(c10::TensorType::get()));
+    return value.toTensorVector();
+  }
+  return future_value.toTensorVector();
+}
+
+} // namespace c10d
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/distributed/c10d/comm.h>
+
+#include <torch/csrc/utils/pybind.h>
+
+namespace c10d {
+
+// A communication hook written in Python. The hook is called as
+// `hook(state, bucket)` and must return a torch.futures.Future whose value is
+// a list of tensors, one per model replica.
+class PythonCommHook : public CommHookInterface {
+ public:
+  // Takes a state and a callable hook. Both are Python objects; the state is
+  // passed back to the hook unchanged on every call.
+  PythonCommHook(py::object state, py::object hook)
+      : state_(std::move(state)), hook_(std::move(hook)) {}
+
+  ~PythonCommHook() override;
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(
+      const GradBucket& bucket) override;
+
+  std::vector<at::Tensor> processFuture(c10::IValue future_value) override;
+
+ private:
+  py::object state_;
+  py::object hook_;
+};
+
+} // namespace c10d
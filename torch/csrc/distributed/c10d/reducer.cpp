@@ -1,5 +1,6 @@
 #include <torch/csrc/distributed/c10d/reducer.h>
 
+#include <algorithm>
 #include <functional>
 
 #include <c10/core/DeviceGuard.h>
@@ -10,7 +11,6 @@
 #include <torch/csrc/autograd/functions/accumulate_grad.h>
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/utils/grad_layout_contract.h>
-#include <torch/csrc/autograd/utils/lambda_post_hook.h>
 #include <torch/csrc/distributed/c10d/comm.h>
 #include <torch/csrc/utils/hash.h>
 #include <torch/csrc/utils/memory.h>
@@ -30,7 +30,8 @@ Reducer::Reducer(
     std::shared_ptr<c10d::ProcessGroup> process_group,
     std::vector<std::vector<bool>> expect_sparse_gradients,
     int64_t bucket_bytes_cap,
-    bool find_unused_parameters)
+    bool find_unused_parameters,
+    bool gradient_as_bucket_view)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_sparse_gradients_(std::move(expect_sparse_gradients)),
@@ -42,7 +43,8 @@ Reducer::Reducer(
       local_used_maps_reduced_(false),
       backward_stats_base_(0),
       has_rebuilt_bucket_(false),
-      bucket_bytes_cap_(bucket_bytes_cap) {
+      bucket_bytes_cap_(bucket_bytes_cap),
+      gradient_as_bucket_view_(gradient_as_bucket_view) {
   C10_LOG_API_USAGE_ONCE("torch.distributed.ddp.reducer");
   TORCH_CHECK(replicas_.size() >= 1, "Expected at least one model replica.");
   TORCH_CHECK(replicas_[0].size() >= 1, "Expected at least one parameter.");
@@ -91,19 +93,21 @@ Reducer::Reducer(
         auto grad_accumulator =
             torch::autograd::impl::grad_accumulator(variable);
 
-        using torch::distributed::autograd::ThreadLocalDistAutogradContext;
-        // Hook to execute after the gradient accumulator has executed.
+        // Callback to execute after the gradient accumulator has executed.
+        // A grad ready callback rather than a post hook, which would also
+        // keep the gradient from being stolen by the accumulator.
+        TORCH_INTERNAL_ASSERT(
+            dynamic_cast<torch::autograd::AccumulateGrad*>(
+                grad_accumulator.get()));
         hooks_.emplace_back(
-            grad_accumulator->add_post_hook(
-                torch::make_unique<torch::autograd::utils::LambdaPostHook>(
-                    [=](const torch::autograd::variable_list& outputs,
-                        const torch::autograd::variable_list& /* unused */) {
-                      this->rpc_context_.set(
-                          ThreadLocalDistAutogradContext::getContextPtr());
-                      this->autograd_hook(index);
-                      return outputs;
-                    })),
+            static_cast<torch::autograd::AccumulateGrad*>(
+                grad_accumulator.get())
+                ->add_grad_ready_callback(
+                    &Reducer::grad_ready_callback,
+                    this,
+                    grad_ready_indices_.size()),
             grad_accumulator);
+        grad_ready_indices_.push_back(index);
 
         // Map raw function pointer to replica index and parameter index.
         // This is used later on when the autograd graph is traversed
@@ -179,7 +183,8 @@ Reducer::~Reducer() noexcept(false) {
     auto& key = hook.first;
     auto& grad_accumulator = hook.second;
     TORCH_CHECK(
-        grad_accumulator->del_post_hook(key),
+        static_cast<torch::autograd::AccumulateGrad*>(grad_accumulator.get())
+            ->del_grad_ready_callback(key),
         "Reducer attempts to delete a non-existing hook.");
   }
 }
@@ -303,6 +308,13 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
   // as part of the current backwards pass, and zero the part
   // of the bucket it would otherwise hold.
   runGradCallbackForVariable(variable, [&](auto& grad) {
+    if (gradient_as_bucket_view_ && grad.defined() &&
+        grad.is_alias_of(bucket_view)) {
+      // See Note [Gradient as bucket view]. Autograd has accumulated into
+      // the bucket already; only the division is left.
+      bucket_view.div_(process_group_->getSize());
+      return false;
+    }
     if (grad.defined()) {
       // Ensure that the gradient type matches the bucket type.
       TORCH_CHECK(
@@ -311,10 +323,10 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
           bucket_view.toString(),
           ", got ",
           grad.toString());
-      // Assert that the grad tensor and the bucket don't share storage.
-      // If they did, we could avoid the copy altogether.
-      // The reason for not doing this is that existing code calls
-      // `detach_` from `zero_grad`, which is incompatible with views.
+      // Unless gradient_as_bucket_view is set, the grad tensor and the bucket
+      // never share storage. If it is set, the grad was replaced by a new
+      // tensor (e.g. zero_grad(set_to_none) or a user assignment) and is
+      // made a view again below.
       TORCH_INTERNAL_ASSERT(!grad.is_alias_of(bucket_view));
       TORCH_INTERNAL_ASSERT(grad.device() == bucket_view.device());
       TORCH_INTERNAL_ASSERT(grad.numel() == bucket_view.numel());
@@ -344,6 +356,11 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
       wrapped.unsafeGetTensorImpl()->set_wrapped_number(true);
       // Divides while copying into the bucket view.
       at::native::mul_out(bucket_view, grad, wrapped);
+      if (gradient_as_bucket_view_) {
+        grad = bucket_view;
+        // The grad is modified and needs to be written back.
+        return true;
+      }
     } else {
       bucket_view.zero_();
     }
@@ -378,6 +395,13 @@ void Reducer::mark_variable_ready_sparse(VariableIndex index) {
   });
 }
 
+void Reducer::grad_ready_callback(void* reducer, size_t key) {
+  using torch::distributed::autograd::ThreadLocalDistAutogradContext;
+  auto self = static_cast<Reducer*>(reducer);
+  self->rpc_context_.set(ThreadLocalDistAutogradContext::getContextPtr());
+  self->autograd_hook(self->grad_ready_indices_[key]);
+}
+
 // The function `autograd_hook` is called after the gradient for a
 // model parameter has been accumulated into its gradient tensor.
 // This function is only to be called from the autograd thread.
@@ -575,7 +599,14 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
       //
       tensors.push_back(replica.contents);
     }
-    bucket.work = process_group_->allreduce(tensors);
+    // Sparse buckets are always allreduced; a communication hook only sees
+    // the flattened contents of dense buckets.
+    if (comm_hook_ == nullptr || bucket.expect_sparse_gradient) {
+      bucket.work = process_group_->allreduce(tensors);
+    } else {
+      bucket.work = nullptr;
+      bucket.future_work = comm_hook_->runHook(GradBucket(tensors));
+    }
   }
 }
 
@@ -721,6 +752,38 @@ void Reducer::initialize_buckets(
                 replica.contents.narrow(0, offset, length).view(v.sizes()));
           }
         }
+
+        // Note [Gradient as bucket view]
+        //
+        // With gradient_as_bucket_view, every grad is made a view into its
+        // bucket view, so that autograd accumulates directly into the
+        // communication buffer and no copy in or out of the bucket is needed.
+        // Grads that already exist (e.g. after the buckets are rebuilt, when
+        // they still point into the previous contents tensor) are moved over.
+        // Grads that don't exist yet become views the first time their
+        // bucket is finalized. Unlike the copying mode, the grad of a
+        // parameter that is unused in an iteration is reduced along with
+        // the rest of its bucket, since it is the bucket.
+        if (gradient_as_bucket_view_) {
+          for (size_t i = 0; i < replica.variables.size(); i++) {
+            auto& bucket_view = replica.bucket_views[i];
+            runGradCallbackForVariable(replica.variables[i], [&](auto& grad) {
+              if (!grad.defined() || grad.is_alias_of(bucket_view)) {
+                return false;
+              }
+              TORCH_CHECK(
+                  grad.options().type_equal(bucket_view.options()),
+                  "Expected ",
+                  bucket_view.toString(),
+                  ", got ",
+                  grad.toString());
+              bucket_view.copy_(grad);
+              grad = bucket_view;
+              // The grad is modified and needs to be written back.
+              return true;
+            });
+          }
+        }
       }
 
       // Add bucket replica to enclosing bucket.
@@ -751,11 +814,11 @@ void Reducer::initialize_buckets(
 // for reduction as soon as the first autograd hook is called. This is not
 // done immediately because the model output may be ignored, and we only
 // want to start performing reductions on `torch.autograd.backward()`.
+// The same traversal sets the backward priority of every node in the graph
+// so that the gradients of earlier buckets are computed first.
 void Reducer::prepare_for_backward(
     const std::vector<torch::autograd::Variable>& outputs) {
   std::lock_guard<std::mutex> lock(mutex_);
-  std::unordered_set<torch::autograd::Node*> seen;
-  std::vector<torch::autograd::Node*> queue;
 
   // Check that any prior reduction has finished.
   // The variable `require_finalize_` is true until all gradients
@@ -799,38 +862,65 @@ void Reducer::prepare_for_backward(
 
   // If find_unused_parameters_ is false, we assume that autograd hooks for ALL
   // variables will be called, and we don't have to search the autograd graph
-  // for presence of these hooks.
+  // for presence of these hooks. The graph nodes then keep their default
+  // backward priority.
   if (!find_unused_parameters_) {
     return;
   }
 
-  // Seed queue with the grad functions of all outputs.
+  // For every node in the graph, the lowest index of a bucket that one of
+  // its gradients flows into. Nodes that don't lead to any of our parameters
+  // map to `buckets_.size()`.
+  const size_t no_bucket = buckets_.size();
+  std::unordered_map<torch::autograd::Node*, size_t> first_bucket;
+  // Depth first traversal stack of (node, index of the next edge to visit).
+  std::vector<std::pair<torch::autograd::Node*, size_t>> stack;
+
+  // Seed the stack with the grad functions of all outputs.
   for (const auto& output : outputs) {
     const auto& grad_fn = output.grad_fn();
-    if (grad_fn) {
-      queue.push_back(grad_fn.get());
+    if (grad_fn && first_bucket.emplace(grad_fn.get(), no_bucket).second) {
+      stack.emplace_back(grad_fn.get(), 0);
     }
   }
 
-  // Traverse the autograd graph starting at the specified output.
-  while (!queue.empty()) {
-    auto fn = queue.back();
-    queue.pop_back();
-    for (const auto& edge : fn->next_edges()) {
-      if (auto next_ptr = edge.function.get()) {
-        const bool was_inserted = seen.insert(next_ptr).second;
-        if (was_inserted) {
-          queue.push_back(next_ptr);
-        }
+  // Traverse the autograd graph starting at the specified output. A node is
+  // finished once all of its next functions are, at which point its bucket
+  // is known and turns into its backward priority: buckets are reduced in
+  // index order, so the engine should first run the ready nodes that feed
+  // the lowest bucket, letting its allreduce overlap with the rest of the
+  // backward pass.
+  while (!stack.empty()) {
+    const auto fn = stack.back().first;
+    const auto& next_edges = fn->next_edges();
+    if (stack.back().second < next_edges.size()) {
+      const auto next_ptr = next_edges[stack.back().second++].function.get();
+      if (next_ptr && first_bucket.emplace(next_ptr, no_bucket).second) {
+        stack.emplace_back(next_ptr, 0);
+      }
+      continue;
+    }
+    stack.pop_back();
+
+    size_t bucket = no_bucket;
+    const auto it = func_.find(fn);
+    if (it != func_.end()) {
+      bucket = variable_locators_[it->second.variable_index].bucket_index;
+    }
+    for (const auto& edge : next_edges) {
+      if (const auto next_ptr = edge.function.get()) {
+        bucket = std::min(bucket, first_bucket[next_ptr]);
       }
     }
+    first_bucket[fn] = bucket;
+    fn->set_priority(static_cast<int64_t>(no_bucket - bucket));
   }
 
   // Find accumulator functions that don't show up in this graph.
   for (const auto& it : func_) {
     // If the accumulator function is present in the graph, we know
     // a gradient will be computed for the corresponding parameter.
-    if (seen.count(it.first) > 0) {
+    if (first_bucket.count(it.first) > 0) {
       continue;
     }
 
@@ -892,7 +982,17 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
       runGradCallbackForVariable(variable, [&](auto& grad) {
         // If a parameter is globally unused, we keep its grad untouched.
         if (!global_unused) {
-          if (!grad.defined()) {
+          if (gradient_as_bucket_view_) {
+            // See Note [Gradient as bucket view].
+            if (!grad.defined()) {
+              grad = bucket_view;
+            } else if (!grad.is_alias_of(bucket_view)) {
+              grad.copy_(bucket_view);
+            } else {
+              // The result is in the grad already.
+              return false;
+            }
+          } else if (!grad.defined()) {
             // Creates grad according to the "Gradient Layout Contract"
             // (see torch/csrc/grad/AccumulateGrad.h)
             grad = torch::autograd::utils::clone_obey_contract(
@@ -924,8 +1024,42 @@ void Reducer::finalize_backward() {
 
   // Wait for asynchronous reduction to complete and unflatten contents.
   for (auto& bucket : buckets_) {
-    TORCH_INTERNAL_ASSERT(bucket.work);
-    bucket.work->wait();
+    if (bucket.future_work) {
+      bucket.future_work->wait();
+      if (bucket.future_work->hasError()) {
+        TORCH_CHECK(
+            false,
+            "DDP communication hook failed: ",
+            bucket.future_work->error()->what());
+      }
+      auto result =
+          comm_hook_->processFuture(bucket.future_work->value());
+      TORCH_CHECK(
+          result.size() == bucket.replicas.size(),
+          "DDP communication hook must return one tensor per model replica, "
+          "got ",
+          result.size(),
+          " tensors for ",
+          bucket.replicas.size(),
+          " replicas.");
+      for (size_t i = 0; i < result.size(); i++) {
+        auto& contents = bucket.replicas[i].contents;
+        TORCH_CHECK(
+            result[i].numel() == contents.numel(),
+            "DDP communication hook returned a tensor with ",
+            result[i].numel(),
+            " elements for a bucket of ",
+            contents.numel(),
+            " elements.");
+        if (!result[i].is_same(contents)) {
+          contents.copy_(result[i].view_as(contents));
+        }
+      }
+      bucket.future_work = nullptr;
+    } else {
+      TORCH_INTERNAL_ASSERT(bucket.work);
+      bucket.work->wait();
+    }
     if (!bucket.expect_sparse_gradient) {
       // We don't need to finalize the sparse bucket since the sparse grad and
       // the bucket essentially point to the same storage. As a result, once
@@ -953,6 +1087,18 @@ void Reducer::finalize_backward() {
   }
 }
 
+void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> iface) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(
+      comm_hook_ == nullptr,
+      "register_comm_hook can only be called once.");
+  TORCH_CHECK(
+      !expect_autograd_hooks_ && !require_finalize_,
+      "register_comm_hook must be called before the backward pass "
+      "starts.");
+  comm_hook_ = std::move(iface);
+}
+
 void Reducer::runGradCallbackForVariable(
     torch::autograd::Variable& variable,
     GradCallback&& cb) {
@@ -11,6 +11,7 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/distributed/autograd/context/context.h>
+#include <torch/csrc/distributed/c10d/comm.h>
 
 namespace c10d {
 
@@ -29,7 +30,8 @@ class Reducer {
       std::shared_ptr<c10d::ProcessGroup> process_group,
       std::vector<std::vector<bool>> expect_sparse_gradients,
       int64_t bucket_bytes_cap,
-      bool find_unused_parameters);
+      bool find_unused_parameters,
+      bool gradient_as_bucket_view = false);
 
   ~Reducer() noexcept(false);
 
@@ -53,6 +55,11 @@ class Reducer {
     return backward_stats_;
   }
 
+  // Registers a hook that takes over the communication of every dense bucket
+  // from the default allreduce. It can only be registered once, before the
+  // first backward pass.
+  void register_comm_hook(std::unique_ptr<CommHookInterface> iface);
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -73,6 +80,8 @@ class Reducer {
   std::unordered_map<torch::autograd::Node*, VariableIndex> func_;
   std::vector<std::pair<uintptr_t, std::shared_ptr<torch::autograd::Node>>>
       hooks_;
+  // The variables of the grad ready callbacks, by callback key
+  std::vector<VariableIndex> grad_ready_indices_;
 
   bool expect_autograd_hooks_;
   bool require_finalize_;
@@ -111,6 +120,10 @@ class Reducer {
 
   void autograd_hook(VariableIndex index);
 
+  // Grad ready callback of the gradient accumulators, see
+  // AccumulateGrad::add_grad_ready_callback
+  static void grad_ready_callback(void* reducer, size_t key);
+
   void mark_bucket_ready(size_t bucket_index);
 
   void finalize_bucket_dense(Bucket& replica);
@@ -197,6 +210,10 @@ class Reducer {
     // Keep work handle around when this set of buckets is being reduced.
     std::shared_ptr<c10d::ProcessGroup::Work> work;
 
+    // Future returned by the communication hook instead of `work`, if a hook
+    // is registered.
+    c10::intrusive_ptr<c10::ivalue::Future> future_work;
+
     // If this bucket should expect a single sparse gradient.
     // Implies: replicas[i].variables.size() == 1.
     bool expect_sparse_gradient = false;
@@ -204,6 +221,10 @@ class Reducer {
 
   std::vector<Bucket> buckets_;
 
+  // Communication hook for dense buckets; the default allreduce is used if
+  // none is registered.
+  std::unique_ptr<CommHookInterface> comm_hook_;
+
   // A variable locator locates a particular variable in the bucket
   // structure. The `bucket_index` field points to the bucket in the `buckets_`
   // vector. The `intra_bucket_index` field points to the index of the variable
@@ -230,6 +251,10 @@ class Reducer {
   std::vector<int64_t> rebuilt_param_indices_;
   const int64_t bucket_bytes_cap_;
 
+  // If true, the grads of the variables are views into the bucket contents
+  // (see Note [Gradient as bucket view]).
+  const bool gradient_as_bucket_view_;
+
   struct RpcContext {
     using ContextPtr = torch::distributed::autograd::ContextPtr;
     // The shared_ptr is to hold the context instance.
@@ -0,0 +1,332 @@
+#include <torch/csrc/distributed/c10d/sharded_embedding_bag.h>
+
+#include <numeric>
+#include <tuple>
+
+#include <ATen/Parallel.h>
+#include <ATen/core/grad_mode.h>
+
+namespace c10d {
+
+ShardedEmbeddingBag::ShardedEmbeddingBag(
+    std::shared_ptr<ProcessGroup> process_group,
+    std::vector<int64_t> table_ranks,
+    std::vector<int64_t> table_dims,
+    std::vector<at::Tensor> weights,
+    int64_t mode,
+    bool sparse)
+    : process_group_(std::move(process_group)),
+      table_ranks_(std::move(table_ranks)),
+      table_dims_(std::move(table_dims)),
+      weights_(std::move(weights)),
+      mode_(mode),
+      sparse_(sparse),
+      batch_size_(0) {
+  const int64_t world_size = process_group_->getSize();
+  const int64_t rank = process_group_->getRank();
+  TORCH_CHECK(
+      table_ranks_.size() == table_dims_.size(),
+      "Expected as many table ranks as table dims, got ",
+      table_ranks_.size(),
+      " and ",
+      table_dims_.size());
+  TORCH_CHECK(mode_ >= 0 && mode_ <= 2, "Unknown embedding_bag mode ", mode_);
+
+  rank_tables_.resize(world_size);
+  rank_dims_.resize(world_size, 0);
+  for (size_t t = 0; t < table_ranks_.size(); ++t) {
+    TORCH_CHECK(
+        table_ranks_[t] >= 0 && table_ranks_[t] < world_size,
+        "Table ",
+        t,
+        " is owned by rank ",
+        table_ranks_[t],
+        ", which is not in the process group");
+    TORCH_CHECK(table_dims_[t] > 0, "Table ", t, " has no columns");
+    rank_tables_[table_ranks_[t]].push_back(t);
+    rank_dims_[table_ranks_[t]] += table_dims_[t];
+  }
+  for (int64_t r = 0; r < world_size; ++r) {
+    TORCH_CHECK(!rank_tables_[r].empty(), "Rank ", r, " owns no tables");
+  }
+
+  const auto& local_tables = rank_tables_[rank];
+  TORCH_CHECK(
+      weights_.size() == local_tables.size(),
+      "Rank ",
+      rank,
+      " owns ",
+      local_tables.size(),
+      " tables, but got ",
+      weights_.size(),
+      " weights");
+  for (size_t j = 0; j < weights_.size(); ++j) {
+    const auto& weight = weights_[j];
+    TORCH_CHECK(
+        weight.dim() == 2 && weight.size(1) == table_dims_[local_tables[j]],
+        "The weight of table ",
+        local_tables[j],
+        " has to be of size [num_embeddings, ",
+        table_dims_[local_tables[j]],
+        "], got ",
+        weight.sizes());
+    TORCH_CHECK(
+        weight.options().type_equal(weights_[0].options()),
+        "All weights have to have the same type and device");
+  }
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> ShardedEmbeddingBag::forward(
+    std::vector<at::Tensor> indices,
+    std::vector<at::Tensor> offsets) {
+  const size_t num_tables = table_ranks_.size();
+  TORCH_CHECK(
+      indices.size() == num_tables && offsets.size() == num_tables,
+      "Expected the indices and offsets of ",
+      num_tables,
+      " tables");
+  for (size_t t = 0; t < num_tables; ++t) {
+    TORCH_CHECK(
+        indices[t].dim() == 1 && offsets[t].dim() == 1,
+        "The indices and offsets of table ",
+        t,
+        " have to be 1-D");
+    TORCH_CHECK(
+        indices[t].scalar_type() == at::kLong &&
+            offsets[t].scalar_type() == at::kLong,
+        "The indices and offsets of table ",
+        t,
+        " have to be int64");
+    TORCH_CHECK(
+        offsets[t].size(0) == offsets[0].size(0),
+        "All tables have to have the same number of bags");
+  }
+  TORCH_CHECK(offsets[0].size(0) > 0, "Expected at least one bag");
+  batch_size_ = offsets[0].size(0);
+
+  return launch([this, indices, offsets]() {
+    return run_forward(indices, offsets);
+  });
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> ShardedEmbeddingBag::backward(
+    std::vector<at::Tensor> grad_outputs) {
+  TORCH_CHECK(
+      grad_outputs.size() == table_ranks_.size(),
+      "Expected the gradients of ",
+      table_ranks_.size(),
+      " tables");
+  for (size_t t = 0; t < grad_outputs.size(); ++t) {
+    TORCH_CHECK(
+        grad_outputs[t].dim() == 2 &&
+            grad_outputs[t].size(0) == batch_size_ &&
+            grad_outputs[t].size(1) == table_dims_[t],
+        "The gradient of table ",
+        t,
+        " has to be of size [",
+        batch_size_,
+        ", ",
+        table_dims_[t],
+        "], got ",
+        grad_outputs[t].sizes());
+  }
+
+  return launch(
+      [this, grad_outputs]() { return run_backward(grad_outputs); });
+}
+
+std::vector<at::Tensor> ShardedEmbeddingBag::run_forward(
+    const std::vector<at::Tensor>& indices,
+    const std::vector<at::Tensor>& offsets) {
+  const int64_t world_size = process_group_->getSize();
+  const int64_t rank = process_group_->getRank();
+  const auto& local_tables = rank_tables_[rank];
+  const int64_t num_local = local_tables.size();
+
+  // Send the bag lengths and indices of every table to its owner.
+  std::vector<at::Tensor> send_lengths;
+  std::vector<at::Tensor> send_indices;
+  std::vector<int64_t> lengths_splits(world_size);
+  std::vector<int64_t> indices_splits(world_size, 0);
+  for (int64_t r = 0; r < world_size; ++r) {
+    for (const auto t : rank_tables_[r]) {
+      const auto ends = at::cat(
+          {offsets[t].slice(0, 1),
+           at::full({1}, indices[t].numel(), offsets[t].options())});
+      send_lengths.push_back(ends - offsets[t]);
+      send_indices.push_back(indices[t]);
+      indices_splits[r] += indices[t].numel();
+    }
+    lengths_splits[r] = rank_tables_[r].size() * batch_size_;
+  }
+  auto lengths_input = at::cat(send_lengths);
+  auto lengths_output = at::empty(
+      {world_size * num_local * batch_size_}, lengths_input.options());
+  alltoall(
+      lengths_output,
+      lengths_input,
+      std::vector<int64_t>(world_size, num_local * batch_size_),
+      lengths_splits);
+
+  // The number of indices of each local table sent by each rank
+  const auto recv_lengths =
+      lengths_output.view({world_size, num_local, batch_size_});
+  const auto counts = recv_lengths.sum(2).cpu().contiguous();
+  const auto counts_data = counts.data_ptr<int64_t>();
+  std::vector<int64_t> counts_splits(counts_data, counts_data + counts.numel());
+  std::vector<int64_t> recv_splits(world_size, 0);
+  for (int64_t r = 0; r < world_size; ++r) {
+    for (int64_t j = 0; j < num_local; ++j) {
+      recv_splits[r] += counts_splits[r * num_local + j];
+    }
+  }
+  auto indices_input = at::cat(send_indices);
+  auto indices_output = at::empty(
+      {std::accumulate(recv_splits.begin(), recv_splits.end(), int64_t(0))},
+      indices_input.options());
+  alltoall(indices_output, indices_input, recv_splits, indices_splits);
+
+  // Pool the bags of all ranks, the backward of the weights is computed by
+  // run_backward() from the saved bags instead of autograd.
+  at::NoGradGuard no_grad;
+  const auto pieces = indices_output.split_with_sizes(counts_splits);
+  std::vector<at::Tensor> send_pooled;
+  local_bags_.clear();
+  local_bags_.reserve(num_local);
+  for (int64_t j = 0; j < num_local; ++j) {
+    std::vector<at::Tensor> table_indices;
+    table_indices.reserve(world_size);
+    for (int64_t r = 0; r < world_size; ++r) {
+      table_indices.push_back(pieces[r * num_local + j]);
+    }
+    const auto bag_lengths = recv_lengths.select(1, j).reshape({-1});
+    LocalBags bags;
+    bags.indices = at::cat(table_indices);
+    bags.offsets = bag_lengths.cumsum(0) - bag_lengths;
+    at::Tensor pooled;
+    std::tie(pooled, bags.offset2bag, bags.bag_size, bags.max_indices) =
+        at::_embedding_bag(
+            weights_[j],
+            bags.indices,
+            bags.offsets,
+            /*scale_grad_by_freq=*/false,
+            mode_,
+            sparse_,
+            /*per_sample_weights=*/at::Tensor(),
+            /*include_last_offset=*/false);
+    // The bags of rank r are rows [r * batch_size_, (r + 1) * batch_size_)
+    send_pooled.push_back(pooled.view({world_size, -1}));
+    local_bags_.push_back(std::move(bags));
+  }
+
+  // Send the pooled embeddings back, [world_size, batch_size_ * local dims]
+  auto pooled_input = at::cat(send_pooled, 1).view({-1});
+  std::vector<int64_t> pooled_splits(world_size);
+  for (int64_t r = 0; r < world_size; ++r) {
+    pooled_splits[r] = batch_size_ * rank_dims_[r];
+  }
+  auto pooled_output = at::empty(
+      {std::accumulate(
+          pooled_splits.begin(), pooled_splits.end(), int64_t(0))},
+      pooled_input.options());
+  alltoall(
+      pooled_output,
+      pooled_input,
+      pooled_splits,
+      std::vector<int64_t>(world_size, batch_size_ * rank_dims_[rank]));
+
+  std::vector<int64_t> table_splits;
+  for (int64_t r = 0; r < world_size; ++r) {
+    for (const auto t : rank_tables_[r]) {
+      table_splits.push_back(batch_size_ * table_dims_[t]);
+    }
+  }
+  const auto tables = pooled_output.split_with_sizes(table_splits);
+  std::vector<at::Tensor> outputs(table_ranks_.size());
+  size_t i = 0;
+  for (int64_t r = 0; r < world_size; ++r) {
+    for (const auto t : rank_tables_[r]) {
+      outputs[t] = tables[i++].view({batch_size_, table_dims_[t]});
+    }
+  }
+  return outputs;
+}
+
+std::vector<at::Tensor> ShardedEmbeddingBag::run_backward(
+    const std::vector<at::Tensor>& grad_outputs) {
+  const int64_t world_size = process_group_->getSize();
+  const int64_t rank = process_group_->getRank();
+  const auto& local_tables = rank_tables_[rank];
+  TORCH_CHECK(
+      local_bags_.size() == local_tables.size(),
+      "backward() has to follow a completed forward()");
+
+  // Send the gradients of the pooled embeddings to the owners of the tables.
+  std::vector<at::Tensor> send_grads;
+  std::vector<int64_t> grads_splits(world_size);
+  for (int64_t r = 0; r < world_size; ++r) {
+    for (const auto t : rank_tables_[r]) {
+      send_grads.push_back(grad_outputs[t].contiguous().view({-1}));
+    }
+    grads_splits[r] = batch_size_ * rank_dims_[r];
+  }
+  auto grads_input = at::cat(send_grads);
+  auto grads_output = at::empty(
+      {world_size * batch_size_ * rank_dims_[rank]}, grads_input.options());
+  alltoall(
+      grads_output,
+      grads_input,
+      std::vector<int64_t>(world_size, batch_size_ * rank_dims_[rank]),
+      grads_splits);
+
+  const auto grads = grads_output.view({world_size, -1});
+  std::vector<at::Tensor> weight_grads;
+  weight_grads.reserve(local_tables.size());
+  int64_t column = 0;
+  for (size_t j = 0; j < local_tables.size(); ++j) {
+    const int64_t dim = table_dims_[local_tables[j]];
+    const auto grad = grads.narrow(1, column, batch_size_ * dim)
+                          .reshape({world_size * batch_size_, dim});
+    column += batch_size_ * dim;
+    const auto& bags = local_bags_[j];
+    weight_grads.push_back(at::_embedding_bag_backward(
+        grad,
+        bags.indices,
+        bags.offsets,
+        bags.offset2bag,
+        bags.bag_size,
+        bags.max_indices,
+        weights_[j].size(0),
+        /*scale_grad_by_freq=*/false,
+        mode_,
+        sparse_,
+        /*per_sample_weights=*/at::Tensor()));
+  }
+  return weight_grads;
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> ShardedEmbeddingBag::launch(
+    std::function<std::vector<at::Tensor>()> fn) {
+  auto future =
+      c10::make_intrusive<c10::ivalue::Future>(c10::ListType::ofTensors());
+  at::launch([future, fn = std::move(fn)]() {
+    try {
+      future->markCompleted(c10::IValue(fn()));
+    } catch (const std::exception& e) {
+      future->setError(e.what());
+    }
+  });
+  return future;
+}
+
+void ShardedEmbeddingBag::alltoall(
+    at::Tensor& output,
+    at::Tensor& input,
+    std::vector<int64_t> output_split_sizes,
+    std::vector<int64_t> input_split_sizes) {
+  auto work = process_group_->alltoall_base(
+      output, input, output_split_sizes, input_split_sizes);
+  work->wait();
+}
+
+} // namespace c10d
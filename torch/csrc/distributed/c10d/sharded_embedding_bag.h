@@ -0,0 +1,117 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// Table-wise sharded EmbeddingBags for model parallel embeddings, e.g. the
+// sparse features of recommendation models, whose tables don't fit on one
+// process. Every table is owned by a single rank, and every rank looks up
+// bags of all tables for its local batch:
+//
+//   1. The bag lengths and indices of every table are sent to its owner with
+//      two alltoall_base calls, the second one with the lengths received by
+//      the first one as its split sizes.
+//   2. The owner pools the bags of all ranks with a single embedding_bag per
+//      table.
+//   3. The pooled embeddings are sent back with a third alltoall_base.
+//
+// The lookup runs on the inter-op thread pool and its result is returned as
+// a future, so that the caller can run the dense part of the model, e.g. the
+// bottom MLP of DLRM, while the lookup communicates. backward() sends the
+// gradients of the pooled embeddings to the owners in the same way and
+// returns the gradients of the local weights, to be applied by the caller.
+//
+// All ranks have to call forward() and backward() in the same order, with
+// the same batch size, and with a single lookup outstanding at a time:
+// backward() uses the bags of the last forward(), whose future has to have
+// completed. The ShardedEmbeddingBag has to outlive the futures it returns.
+class ShardedEmbeddingBag {
+ public:
+  // Table t has `table_dims[t]' columns and is owned by `table_ranks[t]'.
+  // `weights' are the tables owned by this rank, in increasing order of t;
+  // every rank has to own at least one table. `mode' is the pooling mode of
+  // at::embedding_bag: 0 for sum, 1 for mean and 2 for max. If `sparse' is
+  // set, backward() returns sparse gradients.
+  ShardedEmbeddingBag(
+      std::shared_ptr<ProcessGroup> process_group,
+      std::vector<int64_t> table_ranks,
+      std::vector<int64_t> table_dims,
+      std::vector<at::Tensor> weights,
+      int64_t mode,
+      bool sparse = false);
+
+  // Starts looking up the bags of the local batch, for every table t given
+  // by the 1-D int64 `indices[t]' and the `offsets[t]' of its bags, like
+  // at::embedding_bag. All tables have the same number of bags. The value
+  // of the returned future is the list of the pooled embeddings of every
+  // table, of size [number of bags, table_dims[t]].
+  c10::intrusive_ptr<c10::ivalue::Future> forward(
+      std::vector<at::Tensor> indices,
+      std::vector<at::Tensor> offsets);
+
+  // Starts sending the gradients of the pooled embeddings of the last
+  // forward() to the owners of their tables. The value of the returned
+  // future is the list of the gradients of the local weights.
+  c10::intrusive_ptr<c10::ivalue::Future> backward(
+      std::vector<at::Tensor> grad_outputs);
+
+  const std::vector<at::Tensor>& weights() const {
+    return weights_;
+  }
+
+ private:
+  // The bags of the batches of all ranks that a local table pooled, which
+  // its backward needs.
+  struct LocalBags {
+    at::Tensor indices;
+    at::Tensor offsets;
+    at::Tensor offset2bag;
+    at::Tensor bag_size;
+    at::Tensor max_indices;
+  };
+
+  std::vector<at::Tensor> run_forward(
+      const std::vector<at::Tensor>& indices,
+      const std::vector<at::Tensor>& offsets);
+
+  std::vector<at::Tensor> run_backward(
+      const std::vector<at::Tensor>& grad_outputs);
+
+  // Runs `fn' on the inter-op thread pool and completes the returned future
+  // with the tensors it returns, or with the error it throws.
+  c10::intrusive_ptr<c10::ivalue::Future> launch(
+      std::function<std::vector<at::Tensor>()> fn);
+
+  // Waits for an alltoall_base of the 1-D `input' into 1-D `output'.
+  void alltoall(
+      at::Tensor& output,
+      at::Tensor& input,
+      std::vector<int64_t> output_split_sizes,
+      std::vector<int64_t> input_split_sizes);
+
+  const std::shared_ptr<ProcessGroup> process_group_;
+  const std::vector<int64_t> table_ranks_;
+  const std::vector<int64_t> table_dims_;
+  std::vector<at::Tensor> weights_;
+  const int64_t mode_;
+  const bool sparse_;
+
+  // The tables owned by each rank, in increasing order, which is the order
+  // the buffers exchanged with a rank are laid out in.
+  std::vector<std::vector<int64_t>> rank_tables_;
+  // The number of columns of all tables owned by each rank.
+  std::vector<int64_t> rank_dims_;
+
+  // The number of bags of the local batch of the last forward().
+  int64_t batch_size_;
+  std::vector<LocalBags> local_bags_;
+};
+
+} // namespace c10d
@@ -0,0 +1,139 @@
+#include <torch/csrc/distributed/c10d/sharded_optimizer.h>
+
+#include <algorithm>
+
+#include <ATen/core/grad_mode.h>
+
+namespace c10d {
+
+ShardedOptimizer::ShardedOptimizer(
+    std::vector<at::Tensor> parameters,
+    std::shared_ptr<ProcessGroup> process_group,
+    const OptimizerFactory& make_optimizer,
+    bool reduce_gradients)
+    : parameters_(std::move(parameters)),
+      process_group_(std::move(process_group)),
+      reduce_gradients_(reduce_gradients),
+      buffer_size_(0) {
+  TORCH_CHECK(!parameters_.empty(), "Expected at least one parameter");
+  const auto& options = parameters_[0].options();
+  for (const auto& parameter : parameters_) {
+    TORCH_CHECK(
+        parameter.layout() == at::kStrided,
+        "ShardedOptimizer only supports dense parameters");
+    TORCH_CHECK(
+        parameter.options().type_equal(options),
+        "All parameters have to have the same type and device, got ",
+        parameter.toString(),
+        " and ",
+        parameters_[0].toString());
+  }
+
+  const int64_t world_size = process_group_->getSize();
+  std::vector<int64_t> rank_sizes(world_size, 0);
+  rank_parameters_.resize(world_size);
+  rank_offsets_.resize(world_size);
+  parameter_ranks_.reserve(parameters_.size());
+  for (size_t i = 0; i < parameters_.size(); ++i) {
+    const int64_t rank =
+        std::min_element(rank_sizes.begin(), rank_sizes.end()) -
+        rank_sizes.begin();
+    parameter_ranks_.push_back(rank);
+    rank_parameters_[rank].push_back(i);
+    rank_offsets_[rank].push_back(rank_sizes[rank]);
+    rank_sizes[rank] += parameters_[i].numel();
+  }
+  buffer_size_ = *std::max_element(rank_sizes.begin(), rank_sizes.end());
+
+  std::vector<at::Tensor> local_parameters;
+  for (const auto i : rank_parameters_[process_group_->getRank()]) {
+    local_parameters.push_back(parameters_[i]);
+  }
+  optimizer_ = make_optimizer(std::move(local_parameters));
+  TORCH_CHECK(optimizer_, "The optimizer factory returned no optimizer");
+}
+
+void ShardedOptimizer::step() {
+  at::NoGradGuard no_grad;
+  const int64_t world_size = process_group_->getSize();
+  const int64_t rank = process_group_->getRank();
+  const auto& local_parameters = rank_parameters_[rank];
+  const auto& local_offsets = rank_offsets_[rank];
+
+  if (reduce_gradients_) {
+    const auto grads = flatten([this](size_t i) {
+      const auto& grad = parameters_[i].grad();
+      TORCH_CHECK(
+          !grad.defined() || grad.layout() == at::kStrided,
+          "ShardedOptimizer only supports dense gradients");
+      return grad;
+    });
+    std::vector<std::vector<at::Tensor>> inputs = {grads.unbind(0)};
+    std::vector<at::Tensor> outputs = {
+        at::empty({buffer_size_}, grads.options())};
+    process_group_->reduce_scatter(outputs, inputs)->wait();
+    const auto& reduced = outputs[0].div_(world_size);
+    for (size_t k = 0; k < local_parameters.size(); ++k) {
+      auto& parameter = parameters_[local_parameters[k]];
+      parameter.grad() = reduced.narrow(0, local_offsets[k], parameter.numel())
+                             .view_as(parameter);
+    }
+  }
+
+  optimizer_->step();
+
+  auto buffer = at::zeros({buffer_size_}, parameters_[0].options());
+  for (size_t k = 0; k < local_parameters.size(); ++k) {
+    const auto& parameter = parameters_[local_parameters[k]];
+    buffer.narrow(0, local_offsets[k], parameter.numel())
+        .copy_(parameter.reshape({-1}));
+  }
+  std::vector<at::Tensor> inputs = {buffer};
+  std::vector<std::vector<at::Tensor>> outputs(1);
+  for (int64_t r = 0; r < world_size; ++r) {
+    outputs[0].push_back(at::empty_like(buffer));
+  }
+  process_group_->allgather(outputs, inputs)->wait();
+  for (int64_t r = 0; r < world_size; ++r) {
+    if (r == rank) {
+      continue;
+    }
+    for (size_t k = 0; k < rank_parameters_[r].size(); ++k) {
+      auto& parameter = parameters_[rank_parameters_[r][k]];
+      parameter.copy_(outputs[0][r]
+                          .narrow(0, rank_offsets_[r][k], parameter.numel())
+                          .view_as(parameter));
+    }
+  }
+}
+
+void ShardedOptimizer::zero_grad() {
+  // The gradients of the parameters of the other ranks are accumulated by
+  // the backward pass as well
+  for (auto& parameter : parameters_) {
+    if (parameter.grad().defined()) {
+      parameter.grad().detach_();
+      parameter.grad().zero_();
+    }
+  }
+}
+
+at::Tensor ShardedOptimizer::flatten(
+    const std::function<at::Tensor(size_t)>& get) const {
+  const int64_t world_size = process_group_->getSize();
+  auto buffer =
+      at::zeros({world_size, buffer_size_}, parameters_[0].options());
+  for (int64_t r = 0; r < world_size; ++r) {
+    auto row = buffer.select(0, r);
+    for (size_t k = 0; k < rank_parameters_[r].size(); ++k) {
+      const auto tensor = get(rank_parameters_[r][k]);
+      if (tensor.defined()) {
+        row.narrow(0, rank_offsets_[r][k], tensor.numel())
+            .copy_(tensor.reshape({-1}));
+      }
+    }
+  }
+  return buffer;
+}
+
+} // namespace c10d
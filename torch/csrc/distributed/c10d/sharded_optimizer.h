@@ -0,0 +1,86 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+#include <torch/optim/optimizer.h>
+
+namespace c10d {
+
+// An optimizer whose state is sharded across the ranks of a process group,
+// like stage 2 of ZeRO: every parameter is owned by a single rank, and each
+// rank only keeps the optimizer state of its own parameters, instead of all
+// ranks keeping all of it, which for Adam is twice the size of the model.
+//
+// step() runs on all ranks, in three steps:
+//
+//   1. A reduce_scatter hands each rank the averaged gradients of its
+//      parameters. The gradients of every rank's parameters are laid out in
+//      a flat buffer, padded to the size of the largest one.
+//   2. The local optimizer steps the parameters of this rank.
+//   3. An allgather of the flat buffers of the parameters hands every rank
+//      the updated parameters of the others.
+//
+// When the gradients have already been averaged by the Reducer, whose
+// allreduce overlaps with the backward pass, pass `reduce_gradients' false
+// and step() skips the reduce_scatter.
+//
+// The local optimizer has to update every element of a parameter from its
+// own gradient and state only, like SGD, Adam, Adagrad or RMSprop do, since
+// it is constructed over the local parameters only.
+class ShardedOptimizer {
+ public:
+  using OptimizerFactory =
+      std::function<std::unique_ptr<torch::optim::Optimizer>(
+          std::vector<at::Tensor> parameters)>;
+
+  // `parameters' are the same dense tensors of the same type and device on
+  // all ranks. They are assigned to ranks in order, each to the rank with the
+  // fewest elements so far. `make_optimizer' constructs the local optimizer
+  // over the parameters of this rank, which may be none.
+  ShardedOptimizer(
+      std::vector<at::Tensor> parameters,
+      std::shared_ptr<ProcessGroup> process_group,
+      const OptimizerFactory& make_optimizer,
+      bool reduce_gradients = true);
+
+  // Reduces the gradients, steps the local parameters and gathers them from
+  // the other ranks. Parameters without a gradient on any rank are treated
+  // as having a zero gradient on that rank.
+  void step();
+
+  void zero_grad();
+
+  // The local optimizer, constructed over the parameters this rank owns.
+  torch::optim::Optimizer& local_optimizer() {
+    return *optimizer_;
+  }
+
+  // The rank that owns each parameter.
+  const std::vector<int64_t>& parameter_ranks() const {
+    return parameter_ranks_;
+  }
+
+ private:
+  // Flattens the tensors `get' returns for every parameter of each rank into
+  // one padded, flat buffer per rank, the rows of the returned tensor.
+  at::Tensor flatten(const std::function<at::Tensor(size_t)>& get) const;
+
+  std::vector<at::Tensor> parameters_;
+  const std::shared_ptr<ProcessGroup> process_group_;
+  const bool reduce_gradients_;
+
+  std::vector<int64_t> parameter_ranks_;
+  // The parameters of each rank, in order, and their offsets in its buffer
+  std::vector<std::vector<size_t>> rank_parameters_;
+  std::vector<std::vector<int64_t>> rank_offsets_;
+  // The number of elements of the largest buffer
+  int64_t buffer_size_;
+
+  std::unique_ptr<torch::optim::Optimizer> optimizer_;
+};
+
+} // namespace c10d
@@ -485,12 +485,16 @@ PyObject* rpc_init(PyObject* /* unused */) {
               optional<std::vector<std::string>>,
               optional<std::vector<std::string>>,
               float,
-              std::string>(),
+              std::string,
+              int,
+              int64_t>(),
           py::arg("num_worker_threads") = kDefaultNumWorkerThreads,
           py::arg("_transports") = optional<std::vector<std::string>>(),
           py::arg("_channels") = optional<std::vector<std::string>>(),
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
-          py::arg("init_method") = kDefaultInitMethod)
+          py::arg("init_method") = kDefaultInitMethod,
+          py::arg("_num_large_message_pipes") = kDefaultNumLargeMessagePipes,
+          py::arg("_large_message_threshold") = kDefaultLargeMessageThreshold)
       .def_readwrite(
           "num_worker_threads",
           &TensorPipeRpcBackendOptions::numWorkerThreads,
@@ -502,6 +506,10 @@ PyObject* rpc_init(PyObject* /* unused */) {
 
   module.attr("_DEFAULT_NUM_WORKER_THREADS") =
       py::cast(kDefaultNumWorkerThreads);
+  module.attr("_DEFAULT_NUM_LARGE_MESSAGE_PIPES") =
+      py::cast(kDefaultNumLargeMessagePipes);
+  module.attr("_DEFAULT_LARGE_MESSAGE_THRESHOLD") =
+      py::cast(kDefaultLargeMessageThreshold);
 
   shared_ptr_class_<TensorPipeAgent>(module, "TensorPipeAgent", rpcAgent)
       .def(
@@ -0,0 +1,129 @@
+#include <torch/csrc/distributed/rpc/metrics/latency_histogram.h>
+
+#include <c10/util/StringUtil.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+constexpr const char* kStageNames[] = {"queue", "serialize", "round_trip"};
+
+size_t bucketOf(uint64_t us) {
+  size_t bucket = 0;
+  while (us > 0 && bucket + 1 < LatencyHistogram::kNumBuckets) {
+    us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : count_(0), sumUs_(0), maxUs_(0) {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::record(std::chrono::microseconds latency) {
+  const uint64_t us = latency.count() > 0 ? latency.count() : 0;
+  buckets_[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sumUs_.fetch_add(us, std::memory_order_relaxed);
+  uint64_t max = maxUs_.load(std::memory_order_relaxed);
+  while (us > max &&
+         !maxUs_.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t LatencyHistogram::count() const {
+  return count_.load(std::memory_order_relaxed);
+}
+
+std::string LatencyHistogram::summary() const {
+  std::array<uint64_t, kNumBuckets> buckets;
+  uint64_t count = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    count += buckets[i];
+  }
+  const uint64_t max = maxUs_.load(std::memory_order_relaxed);
+  auto percentile = [&](uint64_t p) -> uint64_t {
+    // The rank of the percentile, counting from 1.
+    const uint64_t rank = std::max<uint64_t>((count * p + 99) / 100, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        return std::min<uint64_t>(i == 0 ? 1 : uint64_t(1) << i, max);
+      }
+    }
+    return max;
+  };
+  return c10::str(
+      "count=",
+      count,
+      " mean=",
+      count == 0 ? 0 : sumUs_.load(std::memory_order_relaxed) / count,
+      " p50=",
+      percentile(50),
+      " p90=",
+      percentile(90),
+      " p99=",
+      percentile(99),
+      " max=",
+      max);
+}
+
+RpcLatencyHistograms::RpcLatencyHistograms(size_t numWorkers)
+    : numWorkers_(numWorkers),
+      stages_(new LatencyHistogram[kNumStages * numWorkers]) {}
+
+void RpcLatencyHistograms::record(
+    RpcLatencyStage stage,
+    worker_id_t dst,
+    std::chrono::microseconds latency) {
+  const size_t stageIndex = static_cast<size_t>(stage);
+  if (dst < 0 || static_cast<size_t>(dst) >= numWorkers_) {
+    return;
+  }
+  stages_[stageIndex * numWorkers_ + dst].record(latency);
+}
+
+void RpcLatencyHistograms::recordExecution(
+    MessageType type,
+    std::chrono::microseconds latency) {
+  if (type < 0 || static_cast<size_t>(type) >= kNumMessageTypes) {
+    return;
+  }
+  execution_[type].record(latency);
+}
+
+std::unordered_map<std::string, std::string> RpcLatencyHistograms::summaries()
+    const {
+  std::unordered_map<std::string, std::string> summaries;
+  for (size_t stage = 0; stage < kNumStages; ++stage) {
+    for (size_t dst = 0; dst < numWorkers_; ++dst) {
+      const auto& histogram = stages_[stage * numWorkers_ + dst];
+      if (histogram.count() > 0) {
+        summaries[c10::str("agent.latency_us.", kStageNames[stage], ".", dst)] =
+            histogram.summary();
+      }
+    }
+  }
+  for (size_t type = 0; type < kNumMessageTypes; ++type) {
+    if (execution_[type].count() > 0) {
+      summaries[c10::str("agent.latency_us.execute.", type)] =
+          execution_[type].summary();
+    }
+  }
+  return summaries;
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/distributed/rpc/types.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// A histogram of latencies in power of two buckets of microseconds. Bucket 0
+// counts the latencies under 1us and bucket i those in [2^(i-1), 2^i) us. It
+// is only updated with relaxed atomics, so that agents can record into it on
+// every RPC, and a summary taken while it is recorded into may be slightly
+// inconsistent.
+class TORCH_API LatencyHistogram {
+ public:
+  static constexpr size_t kNumBuckets = 32;
+
+  LatencyHistogram();
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void record(std::chrono::microseconds latency);
+
+  uint64_t count() const;
+
+  // Returns "count=<n> mean=<us> p50=<us> p90=<us> p99=<us> max=<us>", where
+  // the percentiles are the upper bounds of their buckets.
+  std::string summary() const;
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sumUs_;
+  std::atomic<uint64_t> maxUs_;
+};
+
+// The stages of an RPC whose latency an agent records per destination.
+enum class RpcLatencyStage {
+  // From send() to the start of the serialization of the message.
+  QUEUE = 0,
+  // The serialization of the message.
+  SERIALIZE = 1,
+  // From send() to the arrival of the response, the network time is this
+  // minus the execution time on the destination.
+  ROUND_TRIP = 2,
+};
+
+// The latency histograms of an agent, per destination worker for the client
+// side stages of the RPCs and per message type for the execution of the
+// requests it receives. All histograms are allocated upfront, so that
+// recording takes no lock.
+class TORCH_API RpcLatencyHistograms {
+ public:
+  explicit RpcLatencyHistograms(size_t numWorkers);
+
+  void record(
+      RpcLatencyStage stage,
+      worker_id_t dst,
+      std::chrono::microseconds latency);
+
+  // Records the time from the start of the processing of a request to its
+  // response being ready.
+  void recordExecution(MessageType type, std::chrono::microseconds latency);
+
+  // The summaries of the non-empty histograms, with keys like
+  // "agent.latency_us.round_trip.<worker id>" and
+  // "agent.latency_us.execute.<message type>".
+  std::unordered_map<std::string, std::string> summaries() const;
+
+ private:
+  static constexpr size_t kNumStages = 3;
+  // Message types are below 64, see message.h.
+  static constexpr size_t kNumMessageTypes = 64;
+
+  const size_t numWorkers_;
+  // Indexed by stage * numWorkers_ + dst.
+  std::unique_ptr<LatencyHistogram[]> stages_;
+  std::array<LatencyHistogram, kNumMessageTypes> execution_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -16,7 +16,13 @@ const std::string kRPCTimeoutErrorStr =
 
 namespace {
 constexpr auto kSecToMsConversion = 1000;
-}
+
+// The message type in the preamble of a frame of coalesced messages, whose
+// id is the number of messages. Each message of the payload is preceded by
+// its type, id and size, as int64_t.
+constexpr int64_t kCoalescedFrameType = -1;
+constexpr size_t kCoalescedHeaderBytes = 3 * sizeof(int64_t);
+} // namespace
 
 //////////////////////////  MessageCounter  /////////////////////////////////
 
@@ -111,6 +117,7 @@ ProcessGroupAgent::ProcessGroupAgent(
       recvCounts_(pg_->getSize()),
       nextId_(0),
       sendMutexes_(pg_->getSize()),
+      sendQueues_(pg_->getSize()),
       threadPool_(numSendRecvThreads),
       timeoutThreadEnabled_{false} {
   // initialize metric info counters
@@ -143,6 +150,7 @@ ProcessGroupAgent::ProcessGroupAgent(
   for (worker_id_t rank = 0; rank < worldSize; ++rank) {
     allWorkerInfo_.emplace_back(std::move(tmpWorkerIds[rank]), rank);
   }
+  latencyHistograms_ = std::make_unique<RpcLatencyHistograms>(worldSize);
 }
 
 ProcessGroupAgent::~ProcessGroupAgent() {
@@ -348,7 +356,8 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
       futures_.emplace(
           std::piecewise_construct,
           std::forward_as_tuple(requestId),
-          std::forward_as_tuple(FutureInfo(future, endTime, to.id_, timeout)));
+          std::forward_as_tuple(FutureInfo(
+              future, endTime, to.id_, timeout, futureStartTime)));
       // insert future into timeouts map to keep track of its timeout
       auto& requestIds = futureTimeouts_[endTime];
       requestIds.insert(requestId);
@@ -392,20 +401,39 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
 }
 
 void ProcessGroupAgent::handleSend(const SendWork& work) {
-  auto serializedPayload = std::make_unique<std::string>(std::move(
-      wireSerialize(work.message_.payload(), work.message_.tensors())));
+  sendSerialized(
+      work,
+      std::make_unique<std::string>(
+          wireSerialize(work.message_.payload(), work.message_.tensors())));
+}
+
+void ProcessGroupAgent::sendSerialized(
+    const SendWork& work,
+    std::unique_ptr<std::string> data) {
+  const auto dst = work.to_.id_;
+  sendCounts_.increment(dst);
+  sendFrame(
+      dst,
+      (int64_t)work.message_.type(),
+      (int64_t)work.message_.id(),
+      std::move(data));
+}
 
+void ProcessGroupAgent::sendFrame(
+    worker_id_t dst,
+    int64_t type,
+    int64_t id,
+    std::unique_ptr<std::string> serializedPayload) {
   std::vector<torch::Tensor> preamble = {torch::tensor(
       {(int64_t)pg_->getRank(),
        (int64_t)serializedPayload->length(),
-       (int64_t)work.message_.type(),
-       (int64_t)work.message_.id()},
+       type,
+       id},
       {torch::kInt64})};
 
   // ProcessGroup is not thread-safe when sending with the same tag,
   // hence the lock
   std::vector<std::shared_ptr<c10d::ProcessGroup::Work>> pendingSends;
-  const auto dst = work.to_.id_;
 
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   auto serializedPayloadData = const_cast<char*>(serializedPayload->data());
@@ -418,8 +446,6 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
       {torch::kChar})};
   pendingSends.reserve(2);
 
-  sendCounts_.increment(dst);
-
   {
     std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
     pendingSends.emplace_back(pg_->send(preamble, dst, dst /* channelTag */));
@@ -453,6 +479,125 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
   }
 }
 
+void ProcessGroupAgent::flushSendQueue(worker_id_t dst) {
+  while (true) {
+    std::deque<SendWork> works;
+    {
+      std::lock_guard<std::mutex> guard(sendQueueMutex_);
+      auto& queue = sendQueues_[dst];
+      if (queue.works_.empty()) {
+        queue.flushing_ = false;
+        return;
+      }
+      works.swap(queue.works_);
+    }
+    sendCoalesced(works);
+  }
+}
+
+void ProcessGroupAgent::sendCoalesced(const std::deque<SendWork>& works) {
+  // The small messages of the frame being built, and their serialization.
+  std::vector<std::pair<const SendWork*, std::unique_ptr<std::string>>> frame;
+  size_t frameBytes = 0;
+  auto flushFrame = [&]() {
+    if (frame.size() == 1) {
+      try {
+        sendSerialized(*frame[0].first, std::move(frame[0].second));
+      } catch (std::exception& e) {
+        handleSendError(*frame[0].first, e);
+      }
+    } else if (!frame.empty()) {
+      auto data = std::make_unique<std::string>();
+      data->reserve(frameBytes);
+      for (const auto& entry : frame) {
+        const int64_t header[] = {(int64_t)entry.first->message_.type(),
+                                  (int64_t)entry.first->message_.id(),
+                                  (int64_t)entry.second->size()};
+        data->append(
+            reinterpret_cast<const char*>(header), kCoalescedHeaderBytes);
+        data->append(*entry.second);
+      }
+      const auto dst = frame[0].first->to_.id_;
+      for (size_t i = 0; i < frame.size(); ++i) {
+        sendCounts_.increment(dst);
+      }
+      try {
+        sendFrame(
+            dst, kCoalescedFrameType, (int64_t)frame.size(), std::move(data));
+      } catch (std::exception& e) {
+        for (const auto& entry : frame) {
+          handleSendError(*entry.first, e);
+        }
+      }
+    }
+    frame.clear();
+    frameBytes = 0;
+  };
+
+  for (const auto& work : works) {
+    std::unique_ptr<std::string> data;
+    const auto serializeStartTime = std::chrono::steady_clock::now();
+    latencyHistograms_->record(
+        RpcLatencyStage::QUEUE,
+        work.to_.id_,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            serializeStartTime - work.enqueueTime_));
+    try {
+      data = std::make_unique<std::string>(
+          wireSerialize(work.message_.payload(), work.message_.tensors()));
+    } catch (std::exception& e) {
+      handleSendError(work, e);
+      continue;
+    }
+    latencyHistograms_->record(
+        RpcLatencyStage::SERIALIZE,
+        work.to_.id_,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - serializeStartTime));
+    // Large messages go on their own, after the ones queued before them.
+    const size_t bytes = kCoalescedHeaderBytes + data->size();
+    if (data->size() > kMaxCoalescedBytes ||
+        frameBytes + bytes > kMaxCoalescedBytes) {
+      flushFrame();
+    }
+    if (data->size() > kMaxCoalescedBytes) {
+      try {
+        sendSerialized(work, std::move(data));
+      } catch (std::exception& e) {
+        handleSendError(work, e);
+      }
+      continue;
+    }
+    frame.emplace_back(&work, std::move(data));
+    frameBytes += bytes;
+  }
+  flushFrame();
+}
+
+void ProcessGroupAgent::handleSendError(
+    const SendWork& work,
+    const std::exception& e) {
+  auto errorStr = c10::str(
+      "Encountered exception in ProcessGroupAgent::enqueueSend: ",
+      e.what(),
+      " on node: ",
+      RpcAgent::getWorkerInfo().id_);
+  auto exceptionMsg =
+      rpc::createExceptionResponse(errorStr, work.message_.id());
+  if (work.message_.isRequest()) {
+    // Mark the future with corresponding to this request with an error.
+    markFutureWithError(exceptionMsg);
+  } else if (work.message_.isResponse()) {
+    // Try sending the error along.
+    try {
+      handleSend(SendWork(work.to_, std::move(exceptionMsg)));
+    } catch (std::exception& sendError) {
+      LOG(ERROR) << "Failed to send the error of a response to node "
+                 << work.to_.id_ << ": " << sendError.what();
+    }
+  }
+}
+
 void ProcessGroupAgent::sendToSelf(Message&& message) {
   threadPool_.run(std::bind(
       [this](const Message& message) {
@@ -487,38 +632,36 @@ void ProcessGroupAgent::sendToSelf(Message&& message) {
 }
 
 void ProcessGroupAgent::enqueueSend(SendWork work) {
-  // NB: this can be changed to use a native move capture when moved to C++14
-  threadPool_.run(std::bind(
-      [this](const SendWork& work) {
-        try {
-          handleSend(work);
-        } catch (std::exception& e) {
-          auto errorStr = c10::str(
-              "Encountered exception in ProcessGroupAgent::enqueueSend: ",
-              e.what(),
-              " on node: ",
-              RpcAgent::getWorkerInfo().id_);
-          auto exceptionMsg =
-              rpc::createExceptionResponse(errorStr, work.message_.id());
-          if (work.message_.isRequest()) {
-            // Mark the future with corresponding to this request with an error.
-            markFutureWithError(exceptionMsg);
-          } else if (work.message_.isResponse()) {
-            // Try sending the error along.
-            handleSend(SendWork(work.to_, std::move(exceptionMsg)));
-          }
-        }
-      },
-      std::move(work)));
+  const auto dst = work.to_.id_;
+  {
+    std::lock_guard<std::mutex> guard(sendQueueMutex_);
+    auto& queue = sendQueues_[dst];
+    queue.works_.push_back(std::move(work));
+    if (queue.flushing_) {
+      // The thread flushing the queue picks the work up once it is done with
+      // the messages it is sending.
+      return;
+    }
+    queue.flushing_ = true;
+  }
+  threadPool_.run([this, dst]() { flushSendQueue(dst); });
 }
 
 bool ProcessGroupAgent::handleRecv(RecvWork& work) {
   torch::Tensor& payload = work.payload_;
-  auto data = wireDeserialize(payload.storage().data(), payload.numel());
+  auto data = wireDeserialize(payload.data_ptr(), payload.numel());
   Message message(
       std::move(data.first), std::move(data.second), work.type_, work.id_);
   if (message.isRequest()) {
     ++serverActiveCalls_;
+    const auto requestType = message.type();
+    const auto executeStartTime = std::chrono::steady_clock::now();
+    auto recordExecution = [this, requestType, executeStartTime]() {
+      latencyHistograms_->recordExecution(
+          requestType,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - executeStartTime));
+    };
     std::shared_ptr<FutureMessage> futureResponse;
     try {
       futureResponse = cb_->operator()(message);
@@ -528,6 +671,7 @@ bool ProcessGroupAgent::handleRecv(RecvWork& work) {
     }
     if (futureResponse->completed()) {
       --serverActiveCalls_;
+      recordExecution();
       if (!futureResponse->hasError()) {
         send(work.from_, std::move(*futureResponse).moveValue());
       } else {
@@ -546,12 +690,14 @@ bool ProcessGroupAgent::handleRecv(RecvWork& work) {
       futureResponse->addCallback([this,
                                    fromId,
                                    requestId,
+                                   recordExecution,
                                    weak = std::weak_ptr<FutureMessage>(
                                        futureResponse)]() {
         auto futureResponse = weak.lock();
         TORCH_INTERNAL_ASSERT(futureResponse);
         --serverActiveCalls_;
         --serverActiveAsyncCalls_;
+        recordExecution();
         if (!futureResponse->hasError()) {
           send(getWorkerInfo(fromId), std::move(*futureResponse).moveValue());
         } else {
@@ -578,6 +724,12 @@ bool ProcessGroupAgent::handleRecv(RecvWork& work) {
       // Use futureInfo before destructing it.
       fm = futureInfo->second.future_;
       auto endTime = futureInfo->second.endTime_;
+      latencyHistograms_->record(
+          RpcLatencyStage::ROUND_TRIP,
+          futureInfo->second.dstRank_,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() -
+              futureInfo->second.startTime_));
       futures_.erase(id);
       // look up the corresponding future by its time out and request
       // ID, and remove it from the timeouts map
@@ -734,7 +886,7 @@ void ProcessGroupAgent::listenLoopInternal() {
 
     auto srcRank = preamble_items[0];
     auto size = preamble_items[1];
-    MessageType type = MessageType(preamble_items[2]);
+    int64_t type = preamble_items[2];
     int64_t id = preamble_items[3];
 
     std::vector<torch::Tensor> tensors = {torch::empty({size}, {torch::kChar})};
@@ -749,8 +901,28 @@ void ProcessGroupAgent::listenLoopInternal() {
       return;
     }
 
-    enqueueRecv(
-        RecvWork(allWorkerInfo_[srcRank], type, id, std::move(tensors[0])));
+    if (type != kCoalescedFrameType) {
+      enqueueRecv(RecvWork(
+          allWorkerInfo_[srcRank],
+          MessageType(type),
+          id,
+          std::move(tensors[0])));
+      continue;
+    }
+    // Split a frame of coalesced messages into views of its payload.
+    const char* data = static_cast<const char*>(tensors[0].data_ptr());
+    int64_t offset = 0;
+    for (int64_t i = 0; i < id; ++i) {
+      int64_t header[3];
+      memcpy(header, data + offset, kCoalescedHeaderBytes);
+      offset += kCoalescedHeaderBytes;
+      enqueueRecv(RecvWork(
+          allWorkerInfo_[srcRank],
+          MessageType(header[0]),
+          header[1],
+          tensors[0].narrow(0, offset, header[2])));
+      offset += header[2];
+    }
   }
 }
 
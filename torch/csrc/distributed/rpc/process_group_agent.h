@@ -5,6 +5,7 @@
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
 #include <atomic>
+#include <deque>
 #include <thread>
 
 namespace torch {
@@ -13,6 +14,11 @@ namespace rpc {
 
 constexpr auto kDefaultNumSendRecvThreads = 4;
 
+// Messages to the same destination whose serialized payload is at most this
+// many bytes are coalesced into frames of up to about this size, which are
+// sent with a single preamble and a single payload send.
+constexpr size_t kMaxCoalescedBytes = 64 * 1024;
+
 struct ProcessGroupRpcBackendOptions : public RpcBackendOptions {
   ProcessGroupRpcBackendOptions(
       int num_send_recv_threads,
@@ -34,10 +40,14 @@ struct ProcessGroupRpcBackendOptions : public RpcBackendOptions {
 // worker threads from the same ThreadPool.
 struct SendWork {
   SendWork(const WorkerInfo& to, Message&& message)
-      : to_(to), message_(message) {}
+      : to_(to),
+        message_(message),
+        enqueueTime_(std::chrono::steady_clock::now()) {}
 
   const WorkerInfo& to_;
   Message message_;
+  // When the work was created, for the queueing latency histogram.
+  const std::chrono::steady_clock::time_point enqueueTime_;
 };
 
 // SendWork wraps a Message and RecvWork wraps a Tensor. The difference here is
@@ -132,15 +142,18 @@ class ProcessGroupAgent : public RpcAgent {
     steady_clock_time_point endTime_;
     int dstRank_;
     std::chrono::milliseconds timeout_;
+    steady_clock_time_point startTime_;
     FutureInfo(
         const std::shared_ptr<FutureMessage>& future,
         const steady_clock_time_point& endTime,
         int dstRank,
-        const std::chrono::milliseconds timeout)
+        const std::chrono::milliseconds timeout,
+        const steady_clock_time_point& startTime)
         : future_(future),
           endTime_(endTime),
           dstRank_(dstRank),
-          timeout_(timeout) {}
+          timeout_(timeout),
+          startTime_(startTime) {}
     FutureInfo() = delete;
   };
 
@@ -149,6 +162,23 @@ class ProcessGroupAgent : public RpcAgent {
   // object, and sends the message to the receiver using the underlying
   // ProcessGroup.
   void handleSend(const SendWork& work);
+  // Sends the SendWorks queued for dst until its queue is empty, coalescing
+  // the small messages that were queued together. Only one thread of the pool
+  // flushes a given queue at a time, so that the messages sent to a busy
+  // destination pile up and go out in larger frames.
+  void flushSendQueue(worker_id_t dst);
+  void sendCoalesced(const std::deque<SendWork>& works);
+  // Sends a serialized message on its own.
+  void sendSerialized(const SendWork& work, std::unique_ptr<std::string> data);
+  // Sends a preamble and its payload to dst, and waits for the sends.
+  void sendFrame(
+      worker_id_t dst,
+      int64_t type,
+      int64_t id,
+      std::unique_ptr<std::string> serializedPayload);
+  // Fails the future of a request which couldn't be sent, or sends the error
+  // to the caller in place of a response.
+  void handleSendError(const SendWork& work, const std::exception& e);
   // put RecvWork into a queue and notify the worker thread
   void enqueueRecv(RecvWork work);
   // handle a RecvWork request. Return true if we should increment recvCounts,
@@ -239,6 +269,14 @@ class ProcessGroupAgent : public RpcAgent {
       currentPendingSends_;
   // Lock to serialize access to the above map.
   std::mutex pendingSendMutex_;
+  // The SendWorks waiting to be sent to a destination rank, and whether a
+  // thread of the pool is flushing them.
+  struct SendQueue {
+    std::deque<SendWork> works_;
+    bool flushing_ = false;
+  };
+  std::vector<SendQueue> sendQueues_;
+  std::mutex sendQueueMutex_;
   // A threadPool that processing both SendWork and RecvWork. There are two
   // motivations for adding a ThreadPool:
   // (1) RPC serialization/deserialization and processing can be expensive,
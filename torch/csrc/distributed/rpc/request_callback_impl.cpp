@@ -690,36 +690,52 @@ void RequestCallbackImpl::processRpc(
     }
     case MessageType::BACKWARD_AUTOGRAD_REQ: {
       auto& gradientsCall = static_cast<PropagateGradientsReq&>(rpc);
-      const auto& autogradMetadata = gradientsCall.getAutogradMetadata();
+      const size_t numSendFunctions = gradientsCall.numSendFunctions();
 
-      // Retrieve the appropriate autograd context.
+      // Retrieve the appropriate autograd context, shared by all the send
+      // functions of the request.
       auto autogradContext =
           DistAutogradContainer::getInstance().retrieveContext(
-              autogradMetadata.autogradContextId);
-
-      // Lookup the appropriate 'send' function to enqueue.
-      std::shared_ptr<SendRpcBackward> sendFunction =
-          autogradContext->retrieveSendFunction(
-              autogradMetadata.autogradMessageId);
-
-      // Attach the gradients to the send function.
-      sendFunction->setGrads(gradientsCall.getGrads());
-
-      // Now execute the autograd graph using the "distributed engine."
-      auto execFuture = DistEngine::getInstance().executeSendFunctionAsync(
-          autogradContext, sendFunction, gradientsCall.retainGraph());
-
-      // Our response is satisfied when the rpcs come back.
-      execFuture->addCallback(
-          [responseFuture, messageId](const FutureMessage& execFuture) {
-            if (!execFuture.hasError()) {
-              Message m = std::move(PropagateGradientsResp()).toMessage();
-              m.setId(messageId);
-              responseFuture->markCompleted(std::move(m));
-            } else {
-              responseFuture->setError(*(execFuture.error()));
-            }
-          });
+              gradientsCall.getAutogradMetadata().autogradContextId);
+
+      // Lookup the appropriate 'send' functions to enqueue.
+      std::vector<std::shared_ptr<SendRpcBackward>> sendFunctions;
+      sendFunctions.reserve(numSendFunctions);
+      for (size_t i = 0; i < numSendFunctions; i++) {
+        sendFunctions.push_back(autogradContext->retrieveSendFunction(
+            gradientsCall.getAutogradMetadata(i).autogradMessageId));
+      }
+
+      // Our response is satisfied when the rpcs of all the send functions
+      // come back.
+      struct State {
+        explicit State(size_t count) : remaining(count) {}
+        std::atomic<size_t> remaining;
+        std::atomic<bool> alreadySentError{false};
+      };
+      auto state = std::make_shared<State>(numSendFunctions);
+
+      for (size_t i = 0; i < numSendFunctions; i++) {
+        // Attach the gradients to the send function.
+        sendFunctions[i]->setGrads(gradientsCall.getGrads(i));
+
+        // Now execute the autograd graph using the "distributed engine."
+        auto execFuture = DistEngine::getInstance().executeSendFunctionAsync(
+            autogradContext, sendFunctions[i], gradientsCall.retainGraph());
+
+        execFuture->addCallback(
+            [responseFuture, messageId, state](const FutureMessage& execFuture) {
+              if (!execFuture.hasError()) {
+                if (--state->remaining == 0) {
+                  Message m = std::move(PropagateGradientsResp()).toMessage();
+                  m.setId(messageId);
+                  responseFuture->markCompleted(std::move(m));
+                }
+              } else if (!state->alreadySentError.exchange(true)) {
+                responseFuture->setError(*(execFuture.error()));
+              }
+            });
+      }
       return;
     };
     case MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ: {
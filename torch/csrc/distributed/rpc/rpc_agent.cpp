@@ -290,7 +290,13 @@ std::unordered_map<std::string, std::string> RpcAgent::getDebugInfo() {
   /* This would later include more info other than metrics for eg: may include
      stack traces for the threads owned by the agent */
   // Default implementation: return getMetrics().
-  return getMetrics();
+  auto info = getMetrics();
+  if (latencyHistograms_) {
+    for (auto& entry : latencyHistograms_->summaries()) {
+      info.emplace(entry.first, std::move(entry.second));
+    }
+  }
+  return info;
 }
 
 std::ostream& operator<<(std::ostream& os, const WorkerInfo& workerInfo) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/distributed/rpc/metrics/latency_histogram.h>
 #include <torch/csrc/distributed/rpc/request_callback.h>
 #include <torch/csrc/distributed/rpc/types.h>
 
@@ -239,7 +240,8 @@ class TORCH_API RpcAgent {
   // Retrieve metrics as KV map
   virtual std::unordered_map<std::string, std::string> getMetrics() = 0;
 
-  // Retrive debug info in addition to metrics as KV map
+  // Retrive debug info in addition to metrics as KV map, including the
+  // summaries of the latency histograms if the agent records them.
   virtual std::unordered_map<std::string, std::string> getDebugInfo();
 
   // Flag to control whether GIL wait times
@@ -266,6 +268,9 @@ class TORCH_API RpcAgent {
   // whether several background threads should be running. It is set in
   // RpcAgent::start() and unset in the derived class shutdown().
   std::atomic<bool> rpcAgentRunning_;
+  // Always-on latency histograms of the RPCs, set by the agents that record
+  // them once they know the number of workers, and null otherwise.
+  std::unique_ptr<RpcLatencyHistograms> latencyHistograms_;
 
  private:
   static std::shared_ptr<RpcAgent> currentRpcAgent_;
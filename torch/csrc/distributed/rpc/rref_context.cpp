@@ -91,14 +91,17 @@ std::vector<c10::intrusive_ptr<RRef>> RRefContext::destroyInstance(
   }
   ctx.checkRRefLeaks(ignoreRRefLeak);
   std::vector<c10::intrusive_ptr<RRef>> deletedRRefs;
-  for (auto& entry : ctx.owners_) {
-    auto rref = entry.second;
-    if (rref->isPyObj()) {
-      deletedRRefs.emplace_back(std::move(rref));
+  for (auto& shard : ctx.ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    for (auto& entry : shard.owners_) {
+      auto rref = entry.second;
+      if (rref->isPyObj()) {
+        deletedRRefs.emplace_back(std::move(rref));
+      }
     }
+    shard.owners_.clear();
+    shard.pendingOwners_.clear();
   }
-  ctx.owners_.clear();
-  ctx.pendingOwners_.clear();
   return deletedRRefs;
 }
 
@@ -113,7 +116,7 @@ RRefContext::RRefContext(std::shared_ptr<RpcAgent> agent)
     : agent_(std::move(agent)), destroyed_(false) {}
 
 RRefContext::~RRefContext() {
-  if (!owners_.empty()) {
+  if (!noOwners()) {
     VLOG(1) << "Destructing RRefContext with non-empty OwnerRRef set. "
             << "This would likely cause Python deref error. "
             << "Make sure destroyInstance() is invoked before destruction.";
@@ -122,14 +125,20 @@ RRefContext::~RRefContext() {
 
 std::unordered_map<std::string, std::string> RRefContext::getDebugInfo() {
   std::unordered_map<std::string, std::string> info;
-  std::unique_lock<std::mutex> lock(mutex_);
-  auto ownerSize = owners_.size();
-  auto numPendingUsers = pendingUsers_.size();
+  size_t ownerSize = 0;
+  size_t numPendingUsers = 0;
   int numForks = 0;
-  for (const auto& owner : forks_) {
-    numForks += owner.second.size();
+  for (auto& shard : ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    ownerSize += shard.owners_.size();
+    for (const auto& owner : shard.forks_) {
+      numForks += owner.second.size();
+    }
+  }
+  for (auto& shard : userShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    numPendingUsers += shard.pendingUsers_.size();
   }
-  lock.unlock();
   info[kNumOwnerRRefs] = c10::to_string(ownerSize);
   info[kNumPendingFutures] = c10::to_string(numPendingFutures_.load());
   info[kNumPendingUsers] = c10::to_string(numPendingUsers);
@@ -138,16 +147,20 @@ std::unordered_map<std::string, std::string> RRefContext::getDebugInfo() {
 }
 
 void RRefContext::checkRRefLeaks(bool ignoreRRefLeak) {
-  if (!forks_.empty()) {
-    std::stringstream ss;
-    for (auto& entry : forks_) {
+  std::stringstream ss;
+  bool leaking = false;
+  for (auto& shard : ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    for (auto& entry : shard.forks_) {
       const RRefId& rrefId = entry.first;
       for (const auto& forkId : entry.second) {
         ss << "Leaking RRef " << rrefId << " with fork Id " << forkId
            << std::endl;
       }
+      leaking = true;
     }
-
+  }
+  if (leaking) {
     LOG(WARNING)
         << "Detected RRef Leaks during shutdown. This usually "
         << "occurs when the application code still holds references to RRef "
@@ -220,8 +233,9 @@ void RRefContext::delUser(
     }
   }
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  confirmedUsers_.erase(forkId);
+  auto& shard = userShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  shard.confirmedUsers_.erase(forkId);
 }
 
 void RRefContext::delAllUsersAndUnforkedOwners(
@@ -232,15 +246,19 @@ void RRefContext::delAllUsersAndUnforkedOwners(
   std::unordered_map<ForkId, c10::weak_intrusive_ptr<RRef>, ForkId::Hash>
       tempConfirmedUsers;
   {
-    std::unique_lock<std::mutex> lock(mutex_);
-    bool noPending = deleteAllUsersCV_.wait_for(lock, timeoutMillis, [this]() {
-      return pendingUsers_.size() == 0 && pendingChildren_.size() == 0;
-    });
+    std::unique_lock<std::mutex> lock(deleteAllUsersMutex_);
+    bool noPending = deleteAllUsersCV_.wait_for(
+        lock, timeoutMillis, [this]() { return noPendingUsersOrChildren(); });
     if (!noPending) {
       LOG(ERROR)
           << "Timed out waiting for pending UserRRefs to be confirmed by owner and parent.";
     }
-    tempConfirmedUsers.swap(confirmedUsers_);
+  }
+  for (auto& shard : userShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    tempConfirmedUsers.insert(
+        shard.confirmedUsers_.begin(), shard.confirmedUsers_.end());
+    shard.confirmedUsers_.clear();
   }
 
   // Start sending UserRRef delete messages, after all pendings are confirmed.
@@ -260,28 +278,28 @@ void RRefContext::delAllUsersAndUnforkedOwners(
   // corresponding message from the forking node(s) telling us to delete the
   // RRef. Hence we delete the RRef here. This can occur when a remote call is
   // sent to self and times out.
-  {
-    std::unique_lock<std::mutex> lock(mutex_);
+  for (auto& shard : ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
     std::vector<RRefId> unforkedOwners;
-    for (const auto& it : owners_) {
+    for (const auto& it : shard.owners_) {
       auto rrefId = it.first;
-      if (forks_.find(rrefId) == forks_.end()) {
+      if (shard.forks_.find(rrefId) == shard.forks_.end()) {
         // Successful fork of owner was never processed.
         unforkedOwners.push_back(rrefId);
       }
     }
     for (auto& rrefId : unforkedOwners) {
       LOG(INFO) << "Removing unforked OwnerRRef with RRefId: " << rrefId;
-      auto iter = owners_.find(rrefId);
-      owners_.erase(iter);
+      auto iter = shard.owners_.find(rrefId);
+      shard.owners_.erase(iter);
     }
   }
   // Wait for this node to process all delete UserRRef messages it may get for
   // the OwnerRRefs that exist on this node.
   {
-    std::unique_lock<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(deleteAllUsersMutex_);
     bool noOwner = deleteAllUsersCV_.wait_for(
-        lock, timeoutMillis, [this]() { return owners_.size() == 0; });
+        lock, timeoutMillis, [this]() { return noOwners(); });
     if (!noOwner) {
       LOG(ERROR) << "Timed out waiting for pending OwnerRRefs to be deleted.";
     }
@@ -304,19 +322,20 @@ c10::intrusive_ptr<RRef> RRefContext::getOrCreateRRef(
 c10::intrusive_ptr<OwnerRRef> RRefContext::getOrCreateOwnerRRef(
     const RRefId& rrefId,
     const TypePtr& type) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  const auto iter = owners_.find(rrefId);
-  if (iter == owners_.end()) {
+  auto& shard = ownerShard(rrefId);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  const auto iter = shard.owners_.find(rrefId);
+  if (iter == shard.owners_.end()) {
     // Scenario (1) the first time this owner knows about this RRef
     //
     // NB: cannot use make_shared here as the constructor of OwnerRRef is
     // private.
     auto rref = c10::make_intrusive<OwnerRRef>(getWorkerId(), rrefId, type);
-    owners_[rref->rrefId()] = rref;
-    const auto pendingOwnerIter = pendingOwners_.find(rrefId);
-    if (pendingOwnerIter != pendingOwners_.end()) {
+    shard.owners_[rref->rrefId()] = rref;
+    const auto pendingOwnerIter = shard.pendingOwners_.find(rrefId);
+    if (pendingOwnerIter != shard.pendingOwners_.end()) {
       pendingOwnerIter->second->markCompleted(rref);
-      pendingOwners_.erase(pendingOwnerIter);
+      shard.pendingOwners_.erase(pendingOwnerIter);
     }
     return rref;
   } else {
@@ -367,20 +386,21 @@ c10::intrusive_ptr<OwnerRRef> RRefContext::createOwnerRRef(
 
 std::shared_ptr<Future<c10::intrusive_ptr<OwnerRRef>>> RRefContext::
     getOwnerRRef(const RRefId& rrefId, bool forceCreated) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  const auto iter = owners_.find(rrefId);
-  if (iter == owners_.end()) {
+  auto& shard = ownerShard(rrefId);
+  std::unique_lock<std::mutex> lock(shard.mutex_);
+  const auto iter = shard.owners_.find(rrefId);
+  if (iter == shard.owners_.end()) {
     if (forceCreated) {
       TORCH_INTERNAL_ASSERT(
           false,
           c10::str("Expected OwnerRRef with id ", rrefId, " to be created."));
     }
     // Scenario (1) RRef is used before it is created
-    const auto pendingOwnerIter = pendingOwners_.find(rrefId);
-    if (pendingOwnerIter == pendingOwners_.end()) {
+    const auto pendingOwnerIter = shard.pendingOwners_.find(rrefId);
+    if (pendingOwnerIter == shard.pendingOwners_.end()) {
       auto futureOwner =
           std::make_shared<Future<c10::intrusive_ptr<OwnerRRef>>>();
-      pendingOwners_[rrefId] = futureOwner;
+      shard.pendingOwners_[rrefId] = futureOwner;
       return futureOwner;
     } else {
       return pendingOwnerIter->second;
@@ -421,8 +441,9 @@ RRefForkData RRefContext::prepareChildFork(
     // ensure that this RRef is in the owners_ list to keep it alive.
     // this is needed for OwnerRRefs that were created locally.
     {
-      std::lock_guard<std::mutex> lock(mutex_);
-      owners_[rref->rrefId()] = rref;
+      auto& shard = ownerShard(rref->rrefId());
+      std::lock_guard<std::mutex> lock(shard.mutex_);
+      shard.owners_[rref->rrefId()] = rref;
     }
   } else {
     // Note [Useful Phantom Fork ID for User to Owner Call]
@@ -467,7 +488,7 @@ void RRefContext::notifyOwnerAndParentOfFork(
       // Hence, it is not necessary to send another RREF_CHILD_ACCEPT or
       // RREF_FORK_REQUEST back to the owner. See Note [Early Fork
       // Registration].
-      std::lock_guard<std::mutex> lock(mutex_);
+      std::lock_guard<std::mutex> lock(userShard(forkId).mutex_);
       addConfirmedUser(forkId, rref);
     }
     return;
@@ -511,23 +532,25 @@ void RRefContext::addPendingChild(
   // fork.
   TORCH_INTERNAL_ASSERT(
       !rref->isOwner(), "OwnerRRef should not have a pending child.");
-  std::lock_guard<std::mutex> lock(mutex_);
+  auto& shard = userShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
   TORCH_INTERNAL_ASSERT(
-      pendingChildren_.find(forkId) == pendingChildren_.end(),
+      shard.pendingChildren_.find(forkId) == shard.pendingChildren_.end(),
       "Inconsistent states: attempt to add the same child fork twice.");
-  pendingChildren_[forkId] = rref;
+  shard.pendingChildren_[forkId] = rref;
 }
 
 void RRefContext::delPendingChild(const ForkId& forkId) {
   c10::intrusive_ptr<RRef> deletedUser;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto iter = pendingChildren_.find(forkId);
+    auto& shard = userShard(forkId);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto iter = shard.pendingChildren_.find(forkId);
     // We first check whether the child exists in pendingChildren_. It's
     // possible the child may have been removed by a previous send attempt, and
     // this check (as opposed to an assertion here) ensures that messages that
     // trigger this function are idempotent.
-    if (iter != pendingChildren_.end()) {
+    if (iter != shard.pendingChildren_.end()) {
       // Since this UserRRef is removed from the map,
       // the refcount of this UserRRef could reach to 0,
       // so the "destructor", `release_resources()`, might be called,
@@ -536,13 +559,13 @@ void RRefContext::delPendingChild(const ForkId& forkId) {
       // Meet this constraint by creating a temporary pointer to increase the
       // refcount, extending its lifetime untill lock released.
       deletedUser = iter->second; // Increase refcount.
-      pendingChildren_.erase(iter); // Decrease refcount.
+      shard.pendingChildren_.erase(iter); // Decrease refcount.
     } else {
       LOG(INFO) << "Ignoring duplicate request to delete child UserRRef with "
                 << "ForkId = " << forkId;
     }
   }
-  deleteAllUsersCV_.notify_all();
+  notifyDeleteAllUsers();
   // The refcount of this UserRRef could reach to 0,
   // so the "destructor", release_resources(), might be called,
   // in which the lock is acquired again,
@@ -567,12 +590,13 @@ void RRefContext::addPendingUser(
     userTable_.push_back(state);
   }
 
-  std::lock_guard<std::mutex> lock(mutex_);
+  auto& shard = userShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
   TORCH_INTERNAL_ASSERT(
-      pendingUsers_.find(forkId) == pendingUsers_.end(),
+      shard.pendingUsers_.find(forkId) == shard.pendingUsers_.end(),
       "Inconsistent states: attempt to add the same UserRRef twice.");
 
-  pendingUsers_.emplace(
+  shard.pendingUsers_.emplace(
       std::piecewise_construct,
       std::forward_as_tuple(forkId),
       std::forward_as_tuple(state));
@@ -581,10 +605,11 @@ void RRefContext::addPendingUser(
 void RRefContext::delPendingUser(const ForkId& forkId) {
   std::shared_ptr<PendingUserState> deletedState = nullptr;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto iter = pendingUsers_.find(forkId);
+    auto& shard = userShard(forkId);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto iter = shard.pendingUsers_.find(forkId);
     TORCH_INTERNAL_ASSERT(
-        iter != pendingUsers_.end(),
+        iter != shard.pendingUsers_.end(),
         "Inconsistent states: attempt to delete a non-exist UserRRef.");
 
     // There are two reasons for keeping the deleted PendingUserState alive
@@ -608,28 +633,28 @@ void RRefContext::delPendingUser(const ForkId& forkId) {
     deletedState = iter->second; // Increase refcount
 
     addConfirmedUser(forkId, iter->second->rref_);
-    pendingUsers_.erase(iter); // Decrease refcount.
+    shard.pendingUsers_.erase(iter); // Decrease refcount.
   }
   deletedState->confirm();
-  deleteAllUsersCV_.notify_all();
+  notifyDeleteAllUsers();
   deletedState.reset(); // Decrease refcount.
 }
 
 void RRefContext::addConfirmedUser(
     const ForkId& forkId,
     const c10::intrusive_ptr<RRef>& rref) {
-  // Notice, caller need to hold the mutex for confirmedUsers_.
-  // std::lock_guard<std::mutex> lock(mutex_);
-  confirmedUsers_.emplace(
+  // Notice, caller need to hold the mutex of the shard of forkId.
+  userShard(forkId).confirmedUsers_.emplace(
       std::piecewise_construct,
       std::forward_as_tuple(forkId),
       std::forward_as_tuple(rref));
 }
 
 c10::intrusive_ptr<RRef> RRefContext::getPendingUser(const ForkId& forkId) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = pendingUsers_.find(forkId);
-  if (it == pendingUsers_.end()) {
+  auto& shard = userShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  auto it = shard.pendingUsers_.find(forkId);
+  if (it == shard.pendingUsers_.end()) {
     TORCH_INTERNAL_ASSERT(
         false, "Pending user with forkId ", forkId, " not found");
   }
@@ -683,10 +708,11 @@ void RRefContext::finishForkRequest(const ForkId& forkId, worker_id_t parent) {
 }
 
 void RRefContext::addSelfAsFork(c10::intrusive_ptr<OwnerRRef>& rref) {
-  std::lock_guard<std::mutex> lock(mutex_);
   const auto& rrefId = rref->rrefId();
-  owners_[rrefId] = rref;
-  auto& rrefForks = forks_[rrefId];
+  auto& shard = ownerShard(rrefId);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  shard.owners_[rrefId] = rref;
+  auto& rrefForks = shard.forks_[rrefId];
   TORCH_INTERNAL_ASSERT(
       rrefForks.find(rrefId) == rrefForks.end(),
       "Attempt to add self as fork twice ",
@@ -695,8 +721,9 @@ void RRefContext::addSelfAsFork(c10::intrusive_ptr<OwnerRRef>& rref) {
 }
 
 void RRefContext::addForkOfOwner(const RRefId& rrefId, const ForkId& forkId) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto& rrefForks = forks_[rrefId];
+  auto& shard = ownerShard(rrefId);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  auto& rrefForks = shard.forks_[rrefId];
   TORCH_INTERNAL_ASSERT(
       rrefForks.find(forkId) == rrefForks.end(),
       "Got fork notification twice on the same RRef ",
@@ -707,8 +734,9 @@ void RRefContext::addForkOfOwner(const RRefId& rrefId, const ForkId& forkId) {
 void RRefContext::addForkOfOwnerIfNotPresent(
     const RRefId& rrefId,
     const ForkId& forkId) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto& rrefForks = forks_[rrefId];
+  auto& shard = ownerShard(rrefId);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  auto& rrefForks = shard.forks_[rrefId];
   // We first check whether the child exists in rrefForks. It's possible
   // the child may have been added by a previous send attempt, and this check
   // (as opposed to an assertion here) ensures that messages that trigger this
@@ -732,9 +760,10 @@ c10::intrusive_ptr<RRef> RRefContext::delForkOfOwner(
   // statements to ensure this function is idempotent. This makes it safe to
   // retry RRefUserDelete messages.
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto rrefIter = forks_.find(rrefId);
-    if (rrefIter != forks_.end()) {
+    auto& shard = ownerShard(rrefId);
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto rrefIter = shard.forks_.find(rrefId);
+    if (rrefIter != shard.forks_.end()) {
       auto& rrefForks = rrefIter->second;
       auto forkIter = rrefForks.find(forkId);
       if (forkIter != rrefForks.end()) {
@@ -746,13 +775,13 @@ c10::intrusive_ptr<RRef> RRefContext::delForkOfOwner(
             << ", likely because it was deleted by a previously retried message";
       }
       if (rrefForks.empty()) {
-        auto ownerIter = owners_.find(rrefId);
-        if (ownerIter != owners_.end()) {
+        auto ownerIter = shard.owners_.find(rrefId);
+        if (ownerIter != shard.owners_.end()) {
           deletedRRef = ownerIter->second;
-          owners_.erase(ownerIter);
+          shard.owners_.erase(ownerIter);
           ownerReduced = true;
         }
-        forks_.erase(rrefIter);
+        shard.forks_.erase(rrefIter);
       }
     } else {
       LOG(INFO)
@@ -761,11 +790,38 @@ c10::intrusive_ptr<RRef> RRefContext::delForkOfOwner(
     }
   }
   if (ownerReduced) {
-    deleteAllUsersCV_.notify_all();
+    notifyDeleteAllUsers();
   }
   return deletedRRef;
 }
 
+bool RRefContext::noPendingUsersOrChildren() {
+  for (auto& shard : userShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    if (!shard.pendingUsers_.empty() || !shard.pendingChildren_.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RRefContext::noOwners() {
+  for (auto& shard : ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    if (!shard.owners_.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RRefContext::notifyDeleteAllUsers() {
+  // Holding the mutex makes sure the waiter is either still to check the
+  // shards, or already waiting.
+  std::lock_guard<std::mutex> lock(deleteAllUsersMutex_);
+  deleteAllUsersCV_.notify_all();
+}
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
@@ -8,6 +8,7 @@
 #include <torch/csrc/distributed/rpc/utils.h>
 #include <torch/csrc/utils/future.h>
 
+#include <array>
 #include <atomic>
 
 namespace torch {
@@ -240,59 +241,94 @@ class TORCH_API RRefContext {
   static std::atomic<local_id_t> nextLocalId_;
 
   const std::shared_ptr<RpcAgent> agent_;
-  mutable std::mutex mutex_;
-  // Keep OwnerRRefs alive until there is no living UserRRefs.
-  std::unordered_map<RRefId, c10::intrusive_ptr<RRef>, RRefId::Hash> owners_;
-  // A map to track OwnerRRefs that are requested but not yet created. This can
-  // happen if the to_here() message is processed on the owner before the
-  // corresponding creator rpc.remote() message. If this happens, instead of
-  // to_here() RPC thread to block waiting for the OwnerRRef creation, the
-  // RRefContext returns a Future, so that the RPC request processing logic can
-  // attach subsequent code as a callback to that Future.
-  // NB: the OwnerRRefs in this map must be cleared when the corresponding
-  // OwnerRRef is created.
-  std::unordered_map<
-      RRefId,
-      std::shared_ptr<Future<c10::intrusive_ptr<OwnerRRef>>>,
-      RRefId::Hash>
-      pendingOwners_;
-  // Tracks known living UserRRefs of an OwnerRRef
-  std::unordered_map<
-      RRefId,
-      std::unordered_set<ForkId, ForkId::Hash>,
-      RRefId::Hash>
-      forks_;
 
-  // This cond var is used by deleteAllUsers(), a event notificaton is sent if
-  // number of pending UserRRef or UserRRef children is reduced, or
-  // number of owned OwnerRRef is reduced.
-  std::condition_variable deleteAllUsersCV_;
+  // The maps below are split into shards, by the hash of the RRefId for the
+  // ones kept by owners and of the ForkId for the ones kept by users, so that
+  // RRefs whose ids fall into different shards can be created, confirmed and
+  // deleted concurrently. Every operation touches a single shard, except for
+  // the shutdown and debugging ones.
+  static constexpr size_t kNumShards = 32;
+
+  struct OwnerShard {
+    std::mutex mutex_;
+    // Keep OwnerRRefs alive until there is no living UserRRefs.
+    std::unordered_map<RRefId, c10::intrusive_ptr<RRef>, RRefId::Hash> owners_;
+    // A map to track OwnerRRefs that are requested but not yet created. This
+    // can happen if the to_here() message is processed on the owner before the
+    // corresponding creator rpc.remote() message. If this happens, instead of
+    // to_here() RPC thread to block waiting for the OwnerRRef creation, the
+    // RRefContext returns a Future, so that the RPC request processing logic
+    // can attach subsequent code as a callback to that Future.
+    // NB: the OwnerRRefs in this map must be cleared when the corresponding
+    // OwnerRRef is created.
+    std::unordered_map<
+        RRefId,
+        std::shared_ptr<Future<c10::intrusive_ptr<OwnerRRef>>>,
+        RRefId::Hash>
+        pendingOwners_;
+    // Tracks known living UserRRefs of an OwnerRRef
+    std::unordered_map<
+        RRefId,
+        std::unordered_set<ForkId, ForkId::Hash>,
+        RRefId::Hash>
+        forks_;
+  };
+
   // The follow 3 maps keep UserRRefs alive by holding a intrusive_ptr to the
   // RRef instances. A UserRRef must be added into this map if any of the
   // following two conditions is true:
-  //
-  // (1) A UserRRef has not been accepted by owner yet.
-  //
-  //     It can be used or shared, but cannot be deleted, and hence kept alive
-  //     in this map. A message of type RREF_USER_ACCEPT will move the
-  //     corresponding RRef from pendingUsers_ map to confirmedUsers_ map.
-  std::unordered_map<ForkId, std::shared_ptr<PendingUserState>, ForkId::Hash>
-      pendingUsers_;
-  //     UserRRefs are added into this map when it is confirmed by the owner.
-  //     When destroying RRefContext this map helps to find local UserRRefs
-  //     and send delete messages if they are still not deleted by Python
-  //     garbage collection.
-  std::unordered_map<ForkId, c10::weak_intrusive_ptr<RRef>, ForkId::Hash>
-      confirmedUsers_;
-
-  // (2) A UserRRef has forked a child UserRRef which has not been accepted by
-  //     the owner yet.
-  //
-  //     In this case, this UserRRef cannot send out RREF_USER_DELETE message,
-  //     as it could potentially trigger the OwnerRRef been deleted before the
-  //     owner learns about the forked child.
-  std::unordered_map<ForkId, c10::intrusive_ptr<RRef>, ForkId::Hash>
-      pendingChildren_;
+  struct UserShard {
+    std::mutex mutex_;
+    // (1) A UserRRef has not been accepted by owner yet.
+    //
+    //     It can be used or shared, but cannot be deleted, and hence kept
+    //     alive in this map. A message of type RREF_USER_ACCEPT will move the
+    //     corresponding RRef from pendingUsers_ map to confirmedUsers_ map.
+    std::unordered_map<ForkId, std::shared_ptr<PendingUserState>, ForkId::Hash>
+        pendingUsers_;
+    //     UserRRefs are added into this map when it is confirmed by the owner.
+    //     When destroying RRefContext this map helps to find local UserRRefs
+    //     and send delete messages if they are still not deleted by Python
+    //     garbage collection.
+    std::unordered_map<ForkId, c10::weak_intrusive_ptr<RRef>, ForkId::Hash>
+        confirmedUsers_;
+
+    // (2) A UserRRef has forked a child UserRRef which has not been accepted
+    //     by the owner yet.
+    //
+    //     In this case, this UserRRef cannot send out RREF_USER_DELETE
+    //     message, as it could potentially trigger the OwnerRRef been deleted
+    //     before the owner learns about the forked child.
+    std::unordered_map<ForkId, c10::intrusive_ptr<RRef>, ForkId::Hash>
+        pendingChildren_;
+  };
+
+  inline OwnerShard& ownerShard(const RRefId& rrefId) {
+    return ownerShards_[RRefId::Hash()(rrefId) % kNumShards];
+  }
+
+  inline UserShard& userShard(const ForkId& forkId) {
+    return userShards_[ForkId::Hash()(forkId) % kNumShards];
+  }
+
+  // Whether no shard has pending users or children, or, respectively, owners.
+  // They lock the shards one at a time.
+  bool noPendingUsersOrChildren();
+  bool noOwners();
+
+  // Wakes up delAllUsersAndUnforkedOwners() after a pending user or child, or
+  // an owner, has been deleted.
+  void notifyDeleteAllUsers();
+
+  std::array<OwnerShard, kNumShards> ownerShards_;
+  std::array<UserShard, kNumShards> userShards_;
+
+  // This cond var is used by deleteAllUsers(), a event notificaton is sent if
+  // number of pending UserRRef or UserRRef children is reduced, or
+  // number of owned OwnerRRef is reduced. Its mutex is only held while waiting
+  // and notifying, and is always taken before the one of a shard.
+  std::mutex deleteAllUsersMutex_;
+  std::condition_variable deleteAllUsersCV_;
 
   // The RRef context performs its operations through async RPC requests, in
   // order to not block the user code. Therefore the RRef context's state may be
@@ -566,27 +566,43 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
     throw std::runtime_error(err);
   }
 
+  // The tensors of a tensorpipe::Message are plain host buffers, and none of
+  // the TensorPipe channels can read from or write to device memory, so CUDA
+  // tensors would have to be staged through host memory on both ends. We
+  // leave that to the caller, who can overlap and batch the copies, until
+  // TensorPipe gains CUDA-aware channels.
+  int64_t messageSize = requestMessage.payload().size();
   for (const auto& tensor : requestMessage.tensors()) {
     TORCH_CHECK(
         tensor.device().is_cpu(),
         "TensorPipe RPC backend only supports CPU tensors, please move your ",
         "tensors to CPU before sending them over RPC. Found tensor on device: ",
         tensor.device());
+    messageSize += tensor.numel() * tensor.element_size();
   }
 
   const auto& url = findWorkerURL(toWorkerInfo);
 
   std::unique_lock<std::mutex> lock(mutex_);
 
-  // See if we already have a connection to this address or not
-  auto it = connectedPipes_.find(toWorkerInfo.id_);
-  if (it == connectedPipes_.end()) {
-    std::tie(it, std::ignore) = connectedPipes_.emplace(
-        toWorkerInfo.id_,
-        ClientPipe(context_->connect(
-            url, tensorpipe::PipeOptions().remoteName(toWorkerInfo.name_))));
+  // Pick the pipe for the size of the message, and connect it if this is the
+  // first message to go over it
+  ClientPipes& clientPipes = connectedPipes_[toWorkerInfo.id_];
+  if (clientPipes.pipes.empty()) {
+    clientPipes.pipes.resize(1 + opts_.numLargeMessagePipes);
   }
-  ClientPipe& clientPipe = it->second;
+  size_t pipeIdx = 0;
+  if (opts_.numLargeMessagePipes > 0 &&
+      messageSize >= opts_.largeMessageThreshold) {
+    pipeIdx = 1 + clientPipes.nextLargeMessagePipe;
+    clientPipes.nextLargeMessagePipe =
+        (clientPipes.nextLargeMessagePipe + 1) % opts_.numLargeMessagePipes;
+  }
+  if (!clientPipes.pipes[pipeIdx]) {
+    clientPipes.pipes[pipeIdx] = std::make_unique<ClientPipe>(context_->connect(
+        url, tensorpipe::PipeOptions().remoteName(toWorkerInfo.name_)));
+  }
+  ClientPipe& clientPipe = *clientPipes.pipes[pipeIdx];
   auto& pendingResponseMessage = clientPipe.pendingResponseMessage_;
 
   auto futureResponseMessage = std::make_shared<AtomicFutureMessage>();
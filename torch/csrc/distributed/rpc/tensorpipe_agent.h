@@ -34,6 +34,10 @@ struct ChannelRegistration {
 C10_DECLARE_REGISTRY(TensorPipeChannelRegistry, ChannelRegistration);
 
 constexpr auto kDefaultNumWorkerThreads = 16;
+// Messages whose payload and tensors take at least this many bytes are sent
+// over the large message pipes to their destination, see TensorPipeAgent.
+constexpr int64_t kDefaultLargeMessageThreshold = 1 << 20;
+constexpr auto kDefaultNumLargeMessagePipes = 2;
 
 struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
   TensorPipeRpcBackendOptions(
@@ -41,15 +45,27 @@ struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
       optional<std::vector<std::string>> transports,
       optional<std::vector<std::string>> channels,
       float rpc_timeout,
-      std::string init_method)
+      std::string init_method,
+      int numLargeMessagePipes = kDefaultNumLargeMessagePipes,
+      int64_t largeMessageThreshold = kDefaultLargeMessageThreshold)
       : RpcBackendOptions(rpc_timeout, init_method),
         numWorkerThreads(numWorkerThreads),
         transports(std::move(transports)),
-        channels(std::move(channels)) {
+        channels(std::move(channels)),
+        numLargeMessagePipes(numLargeMessagePipes),
+        largeMessageThreshold(largeMessageThreshold) {
     TORCH_CHECK(
         numWorkerThreads > 0,
         "num_worker_threads must be positive, got ",
         numWorkerThreads);
+    TORCH_CHECK(
+        numLargeMessagePipes >= 0,
+        "_num_large_message_pipes must be non-negative, got ",
+        numLargeMessagePipes);
+    TORCH_CHECK(
+        largeMessageThreshold >= 0,
+        "_large_message_threshold must be non-negative, got ",
+        largeMessageThreshold);
 
     if (transports.has_value()) {
       for (const std::string& transportName : transports.value()) {
@@ -73,6 +89,8 @@ struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
   int numWorkerThreads;
   const optional<std::vector<std::string>> transports;
   const optional<std::vector<std::string>> channels;
+  const int numLargeMessagePipes;
+  const int64_t largeMessageThreshold;
 };
 
 // Struct to track the network source metrics
@@ -93,6 +111,13 @@ struct AggregatedNetworkData {
 // to transparently move tensors and payloads through the fastest available
 // transport or channel. It acts like a hybrid RPC transport, providing shared
 // memory (linux) and TCP (linux & mac) support. CUDA support is in progress.
+//
+// The agent opens several pipes to every destination. Small messages, which
+// are mostly control messages (RRef forks, autograd, ...), go over a pipe of
+// their own, so that they never wait behind the tensors of a large message.
+// Large messages go round robin over the numLargeMessagePipes other pipes,
+// so that several of them are transferred at a time; with no large message
+// pipes every message goes over the single pipe to the destination.
 class TensorPipeAgent : public RpcAgent {
  public:
   TensorPipeAgent(
@@ -200,8 +225,6 @@ class TensorPipeAgent : public RpcAgent {
   // Maintains state per client pipe to track pending response messages and
   // error states. pendingResponseMessage_ should be protected by a mutex since
   // it can be raced with user send() call.
-  // TODO: To achieve better performance we can have a pipe pool per
-  // client that can be configured using RpcBackendOptions.
   struct ClientPipe {
     explicit ClientPipe(std::shared_ptr<tensorpipe::Pipe> pipe) : pipe_(pipe) {}
     std::shared_ptr<tensorpipe::Pipe> pipe_;
@@ -216,7 +239,13 @@ class TensorPipeAgent : public RpcAgent {
   ThreadPool threadPool_;
   std::shared_ptr<tensorpipe::Context> context_;
   std::shared_ptr<tensorpipe::Listener> listener_;
-  std::unordered_map<worker_id_t, ClientPipe> connectedPipes_;
+  // The pipes to every destination, opened when they are first used: the one
+  // for small messages, followed by those for large messages.
+  struct ClientPipes {
+    std::vector<std::unique_ptr<ClientPipe>> pipes;
+    size_t nextLargeMessagePipe{0};
+  };
+  std::unordered_map<worker_id_t, ClientPipes> connectedPipes_;
 
   // Maps keyed on name and id for easy WorkerInfo lookup.
   std::unordered_map<worker_id_t, WorkerInfo> workerIdToInfo_;
@@ -65,7 +65,12 @@ static PyObject * THPStorage_(pyNewFilenameStorage)(PyObject *_unused, PyObject
   if (!PyArg_ParseTuple(args, "L", &size)) {
     return nullptr;
   }
-  return THPStorage_(New)(THPStorage_(newFilenameStorage)(size));
+  THWStorage* storage;
+  {
+    pybind11::gil_scoped_release no_gil;
+    storage = THPStorage_(newFilenameStorage)(size);
+  }
+  return THPStorage_(New)(storage);
   END_HANDLE_TH_ERRORS
 }
 
@@ -79,10 +84,16 @@ static PyObject * THPStorage_(shareFilename)(THPStorage *self, PyObject *noargs)
     // done
   } else {
     // TODO: retry on collision
-    // TODO: free GIL - but remember to reacquire it when an exception is thrown
-    THWStoragePtr new_storage(
-        THPStorage_(newFilenameStorage)(storage->nbytes() / sizeof(scalar_t)));
-    THWStorage_(copy)(new_storage, storage);
+    // The GIL is released while the segment is created, registered with the
+    // manager and filled, but the storage is only swapped once it is held
+    // again, as other threads may be using it.
+    THWStoragePtr new_storage;
+    {
+      pybind11::gil_scoped_release no_gil;
+      new_storage = THPStorage_(newFilenameStorage)(
+          storage->nbytes() / sizeof(scalar_t));
+      THWStorage_(copy)(new_storage, storage);
+    }
     THWStorage_(swap)(storage, new_storage);
     ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
     AT_ASSERT(ctx);
@@ -121,11 +132,15 @@ static PyObject * THPStorage_(newSharedFilename)(PyObject *_unused, PyObject *ar
   int64_t size = THPUtils_unpackLong(_size);
   int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM |
               TH_ALLOCATOR_MAPPED_NOCREATE;
-  return THPStorage_(New)(
-          THWStorage_(newWithDataAndAllocator)(
-            THManagedMapAllocator::makeDataPtr(manager_handle, object_handle, flags, size * sizeof(scalar_t)),
-            size,
-            /* allocator */ nullptr));
+  THWStorage* storage;
+  {
+    pybind11::gil_scoped_release no_gil;
+    storage = THWStorage_(newWithDataAndAllocator)(
+        THManagedMapAllocator::makeDataPtr(manager_handle, object_handle, flags, size * sizeof(scalar_t)),
+        size,
+        /* allocator */ nullptr);
+  }
+  return THPStorage_(New)(storage);
   END_HANDLE_TH_ERRORS
 }
 
@@ -147,7 +162,12 @@ static PyObject * THPStorage_(pyNewFdStorage)(PyObject *_unused, PyObject *args)
   if (!PyArg_ParseTuple(args, "L", &size)) {
     return nullptr;
   }
-  return THPStorage_(New)(THPStorage_(newFdStorage)(size));
+  THWStorage* storage;
+  {
+    pybind11::gil_scoped_release no_gil;
+    storage = THPStorage_(newFdStorage)(size);
+  }
+  return THPStorage_(New)(storage);
   END_HANDLE_TH_ERRORS
 }
 
@@ -160,9 +180,14 @@ static PyObject * THPStorage_(shareFd)(THPStorage *self, PyObject *noargs)
   if ((ctx = THMapAllocator::fromDataPtr(storage->data_ptr()))) {
     // done
   } else {
-    THWStoragePtr new_storage(
-        THPStorage_(newFdStorage)(storage->nbytes() / sizeof(scalar_t)));
-    THWStorage_(copy)(new_storage, storage);
+    // See shareFilename for why the swap happens with the GIL held.
+    THWStoragePtr new_storage;
+    {
+      pybind11::gil_scoped_release no_gil;
+      new_storage =
+          THPStorage_(newFdStorage)(storage->nbytes() / sizeof(scalar_t));
+      THWStorage_(copy)(new_storage, storage);
+    }
     THWStorage_(swap)(storage, new_storage);
     ctx = THMapAllocator::fromDataPtr(storage->data_ptr());
     AT_ASSERT(ctx);
@@ -204,11 +229,15 @@ static PyObject * THPStorage_(newSharedFd)(PyObject *_unused, PyObject *args)
               TH_ALLOCATOR_MAPPED_NOCREATE |
               TH_ALLOCATOR_MAPPED_KEEPFD |
               TH_ALLOCATOR_MAPPED_FROMFD;
-  return THPStorage_(New)(
-          THWStorage_(newWithDataAndAllocator)(
-            // TODO: Maybe we should read out the scalar_t size and use it for size
-            THMapAllocator::makeDataPtr(WITH_FD, nullptr, fd, flags, size * sizeof(scalar_t), nullptr),
-            size, /* allocator */ nullptr));
+  THWStorage* storage;
+  {
+    pybind11::gil_scoped_release no_gil;
+    storage = THWStorage_(newWithDataAndAllocator)(
+        // TODO: Maybe we should read out the scalar_t size and use it for size
+        THMapAllocator::makeDataPtr(WITH_FD, nullptr, fd, flags, size * sizeof(scalar_t), nullptr),
+        size, /* allocator */ nullptr);
+  }
+  return THPStorage_(New)(storage);
   END_HANDLE_TH_ERRORS
 }
 
@@ -243,10 +272,10 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
     void *base_ptr = c10::cuda::CUDACachingAllocator::getBaseAllocation(THWStorage_(data)(LIBRARY_STATE storage), &base_size);
     ptrdiff_t offset_bytes = (char*)storage->data<scalar_t>() - (char*)base_ptr;
 
-    cudaIpcMemHandle_t handle;
-    THCudaCheck(cudaIpcGetMemHandle(&handle, base_ptr));
+    // Cached by the allocator, as the same allocations get sent over and over
+    std::string handle = c10::cuda::CUDACachingAllocator::getIpcMemHandle(base_ptr);
 
-    _handle = PyBytes_FromStringAndSize((char *)&handle, CUDA_IPC_HANDLE_SIZE);
+    _handle = PyBytes_FromStringAndSize(handle.data(), CUDA_IPC_HANDLE_SIZE);
     _offset_bytes = PyLong_FromSsize_t((Py_ssize_t)offset_bytes);
 
     // Put Storage Data behind new ref counting context
@@ -259,15 +288,9 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
     _ref_counter_offset = PyLong_FromLong(sent_data->offset());
 
 
-    cudaIpcEventHandle_t ipc_event_handle;
-
-#ifndef __HIP_PLATFORM_HCC__
-    if (sent_data->event_sync_required_) {
-      THCudaCheck(cudaIpcGetEventHandle(&ipc_event_handle, sent_data->event_));
-    }
-#else
-    // ipc_event_handle unused in storage receiver, we can leave it uninitialized.
-#endif
+    // Unused in storage receiver unless event_sync_required_, it can be left
+    // uninitialized then.
+    cudaIpcEventHandle_t ipc_event_handle = sent_data->event_handle_;
 
     _event_handle = PyBytes_FromStringAndSize((char *)&ipc_event_handle, CUDA_IPC_HANDLE_SIZE);
     _event_sync_required = PyBool_FromLong(sent_data->event_sync_required_);
@@ -380,10 +403,7 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
     // Ensure that producer prepared all tensor's data
     std::string s_ipc_event_handle =
         THPStorage_(bytesAsHandleString)(_event_handle);
-    auto ipc_event_handle = reinterpret_cast<const cudaIpcEventHandle_t*>(
-        s_ipc_event_handle.c_str());
-    cudaEvent_t event;
-    cudaIpcOpenEventHandle(&event, *ipc_event_handle);
+    cudaEvent_t event = torch::CudaIPCOpenEvent(s_ipc_event_handle);
     AT_CUDA_CHECK(
         cudaStreamWaitEvent(c10::cuda::getCurrentCUDAStream(device), event, 0));
   }
@@ -33,7 +33,15 @@ class backend {
             ._def_unboxed(
                 "execute",
                 detail::getExecuteFunc<TBackendInterface>(),
-                detail::getExecuteSchema());
+                detail::getExecuteSchema())
+            ._def_unboxed(
+                "compile_ahead",
+                detail::getCompileAheadFunc<TBackendInterface>(),
+                detail::getCompileAheadSchema())
+            ._def_unboxed(
+                "load_compiled",
+                detail::getLoadCompiledFunc<TBackendInterface>(),
+                detail::getLoadCompiledSchema());
   }
 };
 
@@ -47,6 +47,36 @@ c10::FunctionSchema getExecuteSchema() {
       /*arguments=*/{self, handle, input},
       /*returns=*/{output});
 }
+
+c10::FunctionSchema getCompileAheadSchema() {
+  c10::Argument self("self", c10::AnyType::get());
+  c10::Argument mod("processed", c10::AnyType::get());
+  c10::Argument method_compile_spec(
+      "method_compile_spec",
+      c10::DictType::create(c10::StringType::get(), c10::AnyType::get()));
+  c10::Argument compiled("compiled", c10::AnyType::get());
+
+  return c10::FunctionSchema(
+      "compile_ahead",
+      /*overload_name=*/"",
+      /*arguments=*/{self, mod, method_compile_spec},
+      /*returns=*/{compiled});
+}
+
+c10::FunctionSchema getLoadCompiledSchema() {
+  c10::Argument self("self", c10::AnyType::get());
+  c10::Argument compiled("compiled", c10::AnyType::get());
+  auto any_dict_ty =
+      c10::DictType::create(c10::StringType::get(), c10::AnyType::get());
+  c10::Argument method_compile_spec("method_compile_spec", any_dict_ty);
+  c10::Argument handles("handles", any_dict_ty);
+
+  return c10::FunctionSchema(
+      "load_compiled",
+      /*overload_name=*/"",
+      /*arguments=*/{self, compiled, method_compile_spec},
+      /*returns=*/{handles});
+}
 } // namespace detail
 } // namespace jit
 } // namespace torch
@@ -11,6 +11,8 @@ constexpr static auto kBackendsNamespace = "__backends__";
 c10::FunctionSchema TORCH_API getPreprocessSchema();
 c10::FunctionSchema TORCH_API getCompileSchema();
 c10::FunctionSchema TORCH_API getExecuteSchema();
+c10::FunctionSchema TORCH_API getCompileAheadSchema();
+c10::FunctionSchema TORCH_API getLoadCompiledSchema();
 
 template <typename TBackendInterface>
 std::function<void(Stack&)> getPreprocessFunc() {
@@ -45,6 +47,28 @@ std::function<void(Stack&)> getExecuteFunc() {
     push(stack, res);
   };
 }
+
+template <typename TBackendInterface>
+std::function<void(Stack&)> getCompileAheadFunc() {
+  return [](Stack& stack) {
+    auto method_compile_spec = pop(stack).toGenericDict();
+    auto processed = pop(stack);
+    auto self = pop(stack).toCustomClass<TBackendInterface>();
+    auto ret = self->compileAhead(processed, method_compile_spec);
+    push(stack, ret);
+  };
+}
+
+template <typename TBackendInterface>
+std::function<void(Stack&)> getLoadCompiledFunc() {
+  return [](Stack& stack) {
+    auto method_compile_spec = pop(stack).toGenericDict();
+    auto compiled = pop(stack);
+    auto self = pop(stack).toCustomClass<TBackendInterface>();
+    auto ret = self->loadCompiled(compiled, method_compile_spec);
+    push(stack, ret);
+  };
+}
 } // namespace detail
 } // namespace jit
 } // namespace torch
@@ -6,5 +6,20 @@ namespace jit {
 PyTorchBackendInterface::PyTorchBackendInterface() = default;
 PyTorchBackendInterface::~PyTorchBackendInterface() = default;
 
+c10::IValue PyTorchBackendInterface::compileAhead(
+    c10::IValue processed,
+    c10::impl::GenericDict method_compile_spec) {
+  return c10::IValue();
+}
+
+c10::impl::GenericDict PyTorchBackendInterface::loadCompiled(
+    c10::IValue compiled,
+    c10::impl::GenericDict method_compile_spec) {
+  TORCH_CHECK(
+      false,
+      "This backend returned compiled payloads from compileAhead but "
+      "doesn't implement loadCompiled");
+}
+
 } // namespace jit
 } // namespace torch
@@ -32,6 +32,22 @@ class TORCH_API PyTorchBackendInterface : public torch::CustomClassHolder {
   virtual c10::impl::GenericList execute(
       c10::IValue handle,
       c10::impl::GenericList inputs) = 0;
+
+  // Compile the module contained in \p processed ahead of time, when the
+  // module is lowered. \returns opaque compiled payloads (e.g. a Dict[str,
+  // Tensor] of blobs) that are serialized with the lowered module and passed
+  // to loadCompiled in place of calling compile when it is loaded, or None if
+  // the backend only compiles on load, which is the default.
+  virtual c10::IValue compileAhead(
+      c10::IValue processed,
+      c10::impl::GenericDict method_compile_spec);
+
+  // Restore the backend handles of the methods in \p method_compile_spec from
+  // \p compiled, the payloads returned by compileAhead. \returns the handles
+  // like compile does. Backends overriding compileAhead must override this.
+  virtual c10::impl::GenericDict loadCompiled(
+      c10::IValue compiled,
+      c10::impl::GenericDict method_compile_spec);
 };
 } // namespace jit
 } // namespace torch
@@ -0,0 +1,100 @@
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/backends/backend.h>
+#include <torch/csrc/jit/backends/nnapi/nnapi_compilation.h>
+#include <torch/csrc/jit/backends/nnapi/nnapi_serializer.h>
+
+#include <memory>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace nnapi {
+
+// JIT backend running quantized CNNs on Android NNAPI, which dispatches
+// them to the NPUs and DSPs of the device. Lowering a module, for example
+//
+//   torch._C._jit_to_backend("nnapi", scripted._c, {"forward": [example]})
+//
+// maps every method to the list of its example inputs, quint8 per tensor
+// affine tensors that the method will be called on the sizes and
+// quantization parameters of. preprocess lowers the methods to NNAPI models
+// (see nnapi_serializer.h), and compile builds and compiles them for the
+// device when the lowered module is loaded. The lowered module can be saved
+// anywhere, but only runs where libneuralnetworks.so can be loaded.
+class NnapiBackend : public PyTorchBackendInterface {
+ public:
+  NnapiBackend() = default;
+  ~NnapiBackend() override = default;
+
+  c10::IValue preprocess(
+      c10::IValue mod,
+      c10::impl::GenericDict method_compile_spec) override {
+    const Module module(mod.toObject());
+    c10::Dict<std::string, c10::IValue> processed;
+    for (const auto& entry : method_compile_spec) {
+      const auto& method_name = entry.key().toStringRef();
+      TORCH_CHECK(
+          entry.value().isTensorList() ||
+              (entry.value().isList() &&
+               entry.value().toListRef().empty()),
+          "The compile spec of ",
+          method_name,
+          " for NNAPI must be the list of its example inputs");
+      processed.insert(
+          method_name,
+          serializeMethod(
+              module, method_name, entry.value().toTensorVector()));
+    }
+    return c10::impl::toGenericDict(processed);
+  }
+
+  c10::impl::GenericDict compile(
+      c10::IValue processed,
+      c10::impl::GenericDict method_compile_spec) override {
+    auto models = c10::impl::toTypedDict<std::string, c10::IValue>(
+        processed.toGenericDict());
+    c10::Dict<std::string, std::string> handles;
+    for (const auto& entry : method_compile_spec) {
+      const auto& method_name = entry.key().toStringRef();
+      // Lowering compiles the module too, which is not expected to succeed
+      // off device. execute reports the missing compilations.
+      if (NnapiCompilation::isAvailable()) {
+        const auto& model = models.at(method_name).toTuple()->elements();
+        compilations_[method_name] = std::make_unique<NnapiCompilation>(
+            model.at(0).toTensor(), model.at(1).toTensorVector());
+      }
+      handles.insert(method_name, method_name);
+    }
+    return c10::impl::toGenericDict(handles);
+  }
+
+  c10::impl::GenericList execute(
+      c10::IValue handle,
+      c10::impl::GenericList inputs) override {
+    const auto& method_name = handle.toStringRef();
+    auto it = compilations_.find(method_name);
+    TORCH_CHECK(
+        it != compilations_.end(),
+        "NNAPI is not available on this device, ",
+        method_name,
+        " can't run");
+    std::vector<at::Tensor> input_tensors;
+    for (const auto& input : inputs) {
+      input_tensors.push_back(input.toTensor());
+    }
+    return c10::impl::toList(
+        c10::List<at::Tensor>(it->second->run(input_tensors)));
+  }
+
+ private:
+  std::unordered_map<std::string, std::unique_ptr<NnapiCompilation>>
+      compilations_;
+};
+
+namespace {
+static auto cls = torch::jit::backend<NnapiBackend>("nnapi");
+} // namespace
+
+} // namespace nnapi
+} // namespace jit
+} // namespace torch
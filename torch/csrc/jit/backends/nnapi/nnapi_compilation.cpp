@@ -0,0 +1,312 @@
+#include <torch/csrc/jit/backends/nnapi/nnapi_compilation.h>
+
+#include <torch/csrc/jit/backends/nnapi/nnapi_serializer.h>
+
+#include "caffe2/mobile/contrib/nnapi/NeuralNetworks.h"
+
+#include <dlfcn.h>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+
+namespace torch {
+namespace jit {
+namespace nnapi {
+
+#define NNAPI_FORALL_FUNCTIONS(_)                  \
+  _(ANeuralNetworksModel_create)                   \
+  _(ANeuralNetworksModel_finish)                   \
+  _(ANeuralNetworksModel_free)                     \
+  _(ANeuralNetworksModel_addOperand)               \
+  _(ANeuralNetworksModel_setOperandValue)          \
+  _(ANeuralNetworksModel_addOperation)             \
+  _(ANeuralNetworksModel_identifyInputsAndOutputs) \
+  _(ANeuralNetworksCompilation_create)             \
+  _(ANeuralNetworksCompilation_free)               \
+  _(ANeuralNetworksCompilation_setPreference)      \
+  _(ANeuralNetworksCompilation_finish)             \
+  _(ANeuralNetworksExecution_create)               \
+  _(ANeuralNetworksExecution_free)                 \
+  _(ANeuralNetworksExecution_setInput)             \
+  _(ANeuralNetworksExecution_setOutput)            \
+  _(ANeuralNetworksExecution_startCompute)         \
+  _(ANeuralNetworksEvent_wait)                     \
+  _(ANeuralNetworksEvent_free)
+
+struct NnapiLibrary {
+#define DECLARE_FUNCTION(name) decltype(&::name) name = nullptr;
+  NNAPI_FORALL_FUNCTIONS(DECLARE_FUNCTION)
+#undef DECLARE_FUNCTION
+};
+
+namespace {
+
+// Loaded once, and never unloaded since the compilations of the loaded
+// modules may outlive any other owner
+const NnapiLibrary* loadNnapi() {
+  static const NnapiLibrary* library = []() -> const NnapiLibrary* {
+    void* handle = dlopen("libneuralnetworks.so", RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+      return nullptr;
+    }
+    auto lib = std::make_unique<NnapiLibrary>();
+#define LOAD_FUNCTION(name)                                                \
+  lib->name = reinterpret_cast<decltype(lib->name)>(dlsym(handle, #name)); \
+  if (!lib->name) {                                                        \
+    dlclose(handle);                                                       \
+    return nullptr;                                                        \
+  }
+    NNAPI_FORALL_FUNCTIONS(LOAD_FUNCTION)
+#undef LOAD_FUNCTION
+    return lib.release();
+  }();
+  return library;
+}
+
+#define NNAPI_CHECK(call)                   \
+  do {                                      \
+    const int result = (call);              \
+    TORCH_CHECK(                            \
+        result == ANEURALNETWORKS_NO_ERROR, \
+        #call,                              \
+        " failed with NNAPI error ",        \
+        result);                            \
+  } while (0)
+
+// Reads a serialized model, see nnapi_serializer.h for the layout
+class ModelReader {
+ public:
+  explicit ModelReader(const at::Tensor& serialized_model)
+      : model_(serialized_model.contiguous()) {
+    TORCH_CHECK(
+        model_.scalar_type() == at::kInt && model_.dim() == 1,
+        "A serialized NNAPI model is a 1D int32 tensor");
+  }
+
+  int32_t next() {
+    TORCH_CHECK(pos_ < model_.numel(), "Truncated serialized NNAPI model");
+    return model_.data_ptr<int32_t>()[pos_++];
+  }
+
+  float nextFloat() {
+    const int32_t bits = next();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  std::vector<uint32_t> nextList(int32_t size) {
+    std::vector<uint32_t> list(size);
+    for (auto& element : list) {
+      element = next();
+    }
+    return list;
+  }
+
+  bool done() const {
+    return pos_ == model_.numel();
+  }
+
+ private:
+  at::Tensor model_;
+  int64_t pos_ = 0;
+};
+
+} // namespace
+
+bool NnapiCompilation::isAvailable() {
+  return loadNnapi() != nullptr;
+}
+
+NnapiCompilation::NnapiCompilation(
+    const at::Tensor& serialized_model,
+    std::vector<at::Tensor> constants)
+    : nnapi_(loadNnapi()), constants_(std::move(constants)) {
+  TORCH_CHECK(nnapi_, "NNAPI is not available on this device");
+  for (auto& constant : constants_) {
+    constant = constant.contiguous();
+  }
+
+  ModelReader reader(serialized_model);
+  TORCH_CHECK(
+      reader.next() == kSerializedModelVersion,
+      "Unsupported serialized NNAPI model version");
+  const int32_t num_operands = reader.next();
+  const int32_t num_operations = reader.next();
+  const int32_t num_inputs = reader.next();
+  const int32_t num_outputs = reader.next();
+
+  NNAPI_CHECK(nnapi_->ANeuralNetworksModel_create(&model_));
+  try {
+    std::vector<TensorInfo> operands(num_operands);
+    for (int32_t i = 0; i < num_operands; ++i) {
+      ANeuralNetworksOperandType type;
+      type.type = reader.next();
+      const auto dims = reader.nextList(reader.next());
+      type.dimensionCount = dims.size();
+      type.dimensions = dims.empty() ? nullptr : dims.data();
+      type.scale = reader.nextFloat();
+      type.zeroPoint = reader.next();
+      NNAPI_CHECK(nnapi_->ANeuralNetworksModel_addOperand(model_, &type));
+
+      const auto kind = static_cast<ValueKind>(reader.next());
+      const int32_t value = reader.next();
+      if (kind == ValueKind::IMMEDIATE) {
+        NNAPI_CHECK(nnapi_->ANeuralNetworksModel_setOperandValue(
+            model_, i, &value, sizeof(value)));
+      } else if (kind == ValueKind::CONSTANT) {
+        TORCH_CHECK(
+            value >= 0 && value < static_cast<int32_t>(constants_.size()),
+            "Serialized NNAPI model without constant ",
+            value);
+        const auto& constant = constants_[value];
+        NNAPI_CHECK(nnapi_->ANeuralNetworksModel_setOperandValue(
+            model_, i, constant.data_ptr(), constant.nbytes()));
+      }
+
+      std::vector<int64_t> sizes(dims.begin(), dims.end());
+      if (sizes.size() == 4) {
+        sizes = {sizes[0], sizes[3], sizes[1], sizes[2]};
+      }
+      operands[i] = {std::move(sizes), type.scale, type.zeroPoint};
+    }
+
+    for (int32_t i = 0; i < num_operations; ++i) {
+      const int32_t type = reader.next();
+      const auto inputs = reader.nextList(reader.next());
+      const auto outputs = reader.nextList(reader.next());
+      NNAPI_CHECK(nnapi_->ANeuralNetworksModel_addOperation(
+          model_,
+          type,
+          inputs.size(),
+          inputs.data(),
+          outputs.size(),
+          outputs.data()));
+    }
+
+    const auto inputs = reader.nextList(num_inputs);
+    const auto outputs = reader.nextList(num_outputs);
+    TORCH_CHECK(reader.done(), "Trailing data in serialized NNAPI model");
+    for (const auto input : inputs) {
+      TORCH_CHECK(input < operands.size(), "Bad NNAPI model input");
+      inputs_.push_back(operands[input]);
+    }
+    for (const auto output : outputs) {
+      TORCH_CHECK(output < operands.size(), "Bad NNAPI model output");
+      outputs_.push_back(operands[output]);
+    }
+    NNAPI_CHECK(nnapi_->ANeuralNetworksModel_identifyInputsAndOutputs(
+        model_, inputs.size(), inputs.data(), outputs.size(), outputs.data()));
+    NNAPI_CHECK(nnapi_->ANeuralNetworksModel_finish(model_));
+
+    NNAPI_CHECK(
+        nnapi_->ANeuralNetworksCompilation_create(model_, &compilation_));
+    NNAPI_CHECK(nnapi_->ANeuralNetworksCompilation_setPreference(
+        compilation_, ANEURALNETWORKS_PREFER_SUSTAINED_SPEED));
+    NNAPI_CHECK(nnapi_->ANeuralNetworksCompilation_finish(compilation_));
+  } catch (...) {
+    if (compilation_) {
+      nnapi_->ANeuralNetworksCompilation_free(compilation_);
+    }
+    nnapi_->ANeuralNetworksModel_free(model_);
+    throw;
+  }
+}
+
+NnapiCompilation::~NnapiCompilation() {
+  nnapi_->ANeuralNetworksCompilation_free(compilation_);
+  nnapi_->ANeuralNetworksModel_free(model_);
+}
+
+std::vector<at::Tensor> NnapiCompilation::run(
+    const std::vector<at::Tensor>& inputs) {
+  TORCH_CHECK(
+      inputs.size() == inputs_.size(),
+      "The NNAPI model takes ",
+      inputs_.size(),
+      " inputs, got ",
+      inputs.size());
+
+  ANeuralNetworksExecution* raw_execution = nullptr;
+  NNAPI_CHECK(
+      nnapi_->ANeuralNetworksExecution_create(compilation_, &raw_execution));
+  std::unique_ptr<
+      ANeuralNetworksExecution,
+      std::function<void(ANeuralNetworksExecution*)>>
+      execution(raw_execution, [this](ANeuralNetworksExecution* e) {
+        nnapi_->ANeuralNetworksExecution_free(e);
+      });
+
+  std::vector<at::Tensor> input_data;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& input = inputs[i];
+    const auto& info = inputs_[i];
+    TORCH_CHECK(
+        input.scalar_type() == at::kQUInt8 &&
+            input.qscheme() == at::kPerTensorAffine,
+        "NNAPI input ",
+        i,
+        " must be a quint8 per tensor affine tensor");
+    TORCH_CHECK(
+        input.sizes() == info.sizes,
+        "NNAPI input ",
+        i,
+        " was lowered for sizes ",
+        info.sizes,
+        ", got ",
+        input.sizes());
+    TORCH_CHECK(
+        static_cast<float>(input.q_scale()) == info.scale &&
+            input.q_zero_point() == info.zero_point,
+        "NNAPI input ",
+        i,
+        " was lowered for scale ",
+        info.scale,
+        " and zero point ",
+        info.zero_point,
+        ", got ",
+        input.q_scale(),
+        " and ",
+        input.q_zero_point());
+    input_data.push_back(input.contiguous(
+        input.dim() == 4 ? at::MemoryFormat::ChannelsLast
+                         : at::MemoryFormat::Contiguous));
+    NNAPI_CHECK(nnapi_->ANeuralNetworksExecution_setInput(
+        execution.get(),
+        i,
+        nullptr,
+        input_data.back().data_ptr(),
+        input_data.back().nbytes()));
+  }
+
+  std::vector<at::Tensor> outputs;
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    const auto& info = outputs_[i];
+    outputs.push_back(at::_empty_affine_quantized(
+        info.sizes,
+        at::device(at::kCPU).dtype(at::kQUInt8),
+        info.scale,
+        info.zero_point,
+        info.sizes.size() == 4 ? at::MemoryFormat::ChannelsLast
+                               : at::MemoryFormat::Contiguous));
+    NNAPI_CHECK(nnapi_->ANeuralNetworksExecution_setOutput(
+        execution.get(),
+        i,
+        nullptr,
+        outputs.back().data_ptr(),
+        outputs.back().nbytes()));
+  }
+
+  ANeuralNetworksEvent* event = nullptr;
+  NNAPI_CHECK(
+      nnapi_->ANeuralNetworksExecution_startCompute(execution.get(), &event));
+  const int status = nnapi_->ANeuralNetworksEvent_wait(event);
+  nnapi_->ANeuralNetworksEvent_free(event);
+  NNAPI_CHECK(status);
+  return outputs;
+}
+
+} // namespace nnapi
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+#include <vector>
+
+struct ANeuralNetworksModel;
+struct ANeuralNetworksCompilation;
+
+namespace torch {
+namespace jit {
+namespace nnapi {
+
+struct NnapiLibrary;
+
+// An NNAPI model built and compiled for the device from a method lowered by
+// serializeMethod (see nnapi_serializer.h). NNAPI is loaded from
+// libneuralnetworks.so at runtime, so that the backend builds without the
+// NDK. Constructing a compilation throws where it can't be loaded.
+class NnapiCompilation {
+ public:
+  NnapiCompilation(
+      const at::Tensor& serialized_model,
+      std::vector<at::Tensor> constants);
+  NnapiCompilation(const NnapiCompilation&) = delete;
+  NnapiCompilation& operator=(const NnapiCompilation&) = delete;
+  ~NnapiCompilation();
+
+  // Whether NNAPI could be loaded on this device
+  static bool isAvailable();
+
+  // Runs the model on quint8 tensors of the sizes and quantization
+  // parameters of the example inputs of the lowering. The 4D inputs and
+  // outputs are NCHW tensors in channels last memory, which is the NHWC
+  // layout of NNAPI.
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inputs);
+
+ private:
+  struct TensorInfo {
+    // In TorchScript order, NCHW for 4D tensors
+    std::vector<int64_t> sizes;
+    float scale;
+    int32_t zero_point;
+  };
+
+  const NnapiLibrary* nnapi_;
+  ANeuralNetworksModel* model_ = nullptr;
+  ANeuralNetworksCompilation* compilation_ = nullptr;
+  // NNAPI reads large operand values from these until the model is freed
+  std::vector<at::Tensor> constants_;
+  std::vector<TensorInfo> inputs_;
+  std::vector<TensorInfo> outputs_;
+};
+
+} // namespace nnapi
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,720 @@
+#include <torch/csrc/jit/backends/nnapi/nnapi_serializer.h>
+
+#include <ATen/ATen.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/runtime/vararg_functions.h>
+
+#include "caffe2/mobile/contrib/nnapi/NeuralNetworks.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace nnapi {
+
+namespace {
+
+struct Operand {
+  int32_t type;
+  std::vector<int64_t> dims;
+  float scale;
+  int32_t zero_point;
+  ValueKind kind;
+  int32_t value;
+};
+
+// Runs a boxed operator on a single argument, such as the accessors of the
+// packed weights of the quantized operators.
+Stack callOp(const char* name, c10::IValue arg) {
+  auto op = c10::Dispatcher::singleton().findSchemaOrThrow(name, "");
+  Stack stack{std::move(arg)};
+  op.callBoxed(&stack);
+  return stack;
+}
+
+// The uint8 values and zero point of a per tensor quantized weight. NNAPI
+// 1.0 only has asymmetric uint8 tensors, qint8 weights are shifted by 128.
+std::pair<at::Tensor, int32_t> toQuint8(const at::Tensor& weight) {
+  TORCH_CHECK(
+      weight.qscheme() == at::kPerTensorAffine,
+      "NNAPI only supports per tensor quantized weights");
+  if (weight.scalar_type() == at::kQUInt8) {
+    return {weight.int_repr(), weight.q_zero_point()};
+  }
+  TORCH_CHECK(
+      weight.scalar_type() == at::kQInt8,
+      "NNAPI only supports quint8 and qint8 weights");
+  return {(weight.int_repr().to(at::kShort) + 128).to(at::kByte),
+          weight.q_zero_point() + 128};
+}
+
+// The int32 bias of a quantized conv or linear, whose scale NNAPI requires
+// to be the product of the scales of the input and of the weight.
+at::Tensor toInt32Bias(
+    const c10::IValue& bias,
+    int64_t size,
+    double input_scale,
+    double weight_scale) {
+  if (bias.isNone() || !bias.toTensor().defined()) {
+    return at::zeros({size}, at::kInt);
+  }
+  const auto scaled = bias.toTensor().to(at::kDouble) /
+      (input_scale * weight_scale);
+  return scaled.round().to(at::kInt).contiguous();
+}
+
+int32_t floatBits(float value) {
+  int32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+class Serializer {
+ public:
+  c10::IValue serialize(
+      const Module& module,
+      const std::string& method_name,
+      const std::vector<at::Tensor>& example_inputs);
+
+ private:
+  int32_t addOperand(Operand operand);
+  int32_t addTensorOperand(
+      const std::vector<int64_t>& dims,
+      float scale,
+      int32_t zero_point);
+  int32_t addImmediate(int32_t value);
+  int32_t addConstant(
+      int32_t type,
+      const at::Tensor& data,
+      float scale,
+      int32_t zero_point);
+  void addOperation(
+      int32_t type,
+      const std::vector<int32_t>& inputs,
+      const std::vector<int32_t>& outputs);
+
+  void serializeBlock(Block* block);
+  void serializeNode(Node* node);
+  void evaluateNode(Node* node);
+
+  // The operand of a quantized tensor computed by the model
+  int32_t tensorOperand(Value* value);
+  // The value of a value known at lowering time
+  const c10::IValue& constantValue(Value* value);
+  bool isTensorOperand(Value* value) const {
+    return tensor_operands_.count(value);
+  }
+
+  // The TorchScript sizes of the tensor of an operand, NCHW for 4D tensors
+  std::vector<int64_t> torchSizes(int32_t operand) const;
+
+  void addConv2d(Node* node, bool relu);
+  void addLinear(Node* node, bool relu);
+  void addAdd(Node* node, bool relu);
+  void addRelu(Node* node);
+  void addPool2d(
+      Node* node,
+      int32_t type,
+      std::vector<int64_t> kernel_size,
+      std::vector<int64_t> stride,
+      const std::vector<int64_t>& padding);
+  void addMaxPool2d(Node* node);
+  void addAvgPool2d(Node* node);
+  void addAdaptiveAvgPool2d(Node* node);
+  void addFlatten(Node* node);
+
+  std::vector<Operand> operands_;
+  std::vector<int32_t> operations_;
+  int32_t num_operations_ = 0;
+  std::vector<at::Tensor> constants_;
+  std::unordered_map<Value*, int32_t> tensor_operands_;
+  std::unordered_map<Value*, c10::IValue> values_;
+};
+
+int32_t Serializer::addOperand(Operand operand) {
+  operands_.push_back(std::move(operand));
+  return operands_.size() - 1;
+}
+
+int32_t Serializer::addTensorOperand(
+    const std::vector<int64_t>& dims,
+    float scale,
+    int32_t zero_point) {
+  return addOperand({ANEURALNETWORKS_TENSOR_QUANT8_ASYMM,
+                     dims,
+                     scale,
+                     zero_point,
+                     ValueKind::NONE,
+                     0});
+}
+
+int32_t Serializer::addImmediate(int32_t value) {
+  return addOperand(
+      {ANEURALNETWORKS_INT32, {}, 0.0f, 0, ValueKind::IMMEDIATE, value});
+}
+
+int32_t Serializer::addConstant(
+    int32_t type,
+    const at::Tensor& data,
+    float scale,
+    int32_t zero_point) {
+  constants_.push_back(data.contiguous());
+  return addOperand({type,
+                     data.sizes().vec(),
+                     scale,
+                     zero_point,
+                     ValueKind::CONSTANT,
+                     static_cast<int32_t>(constants_.size() - 1)});
+}
+
+void Serializer::addOperation(
+    int32_t type,
+    const std::vector<int32_t>& inputs,
+    const std::vector<int32_t>& outputs) {
+  operations_.push_back(type);
+  operations_.push_back(inputs.size());
+  operations_.insert(operations_.end(), inputs.begin(), inputs.end());
+  operations_.push_back(outputs.size());
+  operations_.insert(operations_.end(), outputs.begin(), outputs.end());
+  ++num_operations_;
+}
+
+int32_t Serializer::tensorOperand(Value* value) {
+  auto it = tensor_operands_.find(value);
+  TORCH_CHECK(
+      it != tensor_operands_.end(),
+      "NNAPI can only run operations on the inputs of the method and the "
+      "outputs of other NNAPI operations, ",
+      value->debugName(),
+      " is neither");
+  return it->second;
+}
+
+const c10::IValue& Serializer::constantValue(Value* value) {
+  auto it = values_.find(value);
+  TORCH_CHECK(
+      it != values_.end(),
+      "NNAPI needs ",
+      value->debugName(),
+      " to be known at lowering time");
+  return it->second;
+}
+
+std::vector<int64_t> Serializer::torchSizes(int32_t operand) const {
+  auto dims = operands_[operand].dims;
+  if (dims.size() == 4) {
+    return {dims[0], dims[3], dims[1], dims[2]};
+  }
+  return dims;
+}
+
+void Serializer::addConv2d(Node* node, bool relu) {
+  const auto input = tensorOperand(node->input(0));
+  const auto input_dims = operands_[input].dims;
+  TORCH_CHECK(input_dims.size() == 4, "NNAPI conv2d needs a 4D input");
+  const auto& packed = constantValue(node->input(1));
+  const auto weight_bias = callOp("quantized::conv2d_unpack", packed);
+  const auto stride =
+      callOp("quantized::conv2d_stride", packed)[0].toIntVector();
+  const auto padding =
+      callOp("quantized::conv2d_padding", packed)[0].toIntVector();
+  const auto dilation =
+      callOp("quantized::conv2d_dilation", packed)[0].toIntVector();
+  const auto groups = callOp("quantized::conv2d_groups", packed)[0].toInt();
+  const auto num_inputs = node->inputs().size();
+  const float output_scale =
+      constantValue(node->input(num_inputs - 2)).toDouble();
+  const int32_t output_zero_point =
+      constantValue(node->input(num_inputs - 1)).toInt();
+  TORCH_CHECK(
+      dilation == std::vector<int64_t>({1, 1}),
+      "NNAPI 1.0 does not support dilated conv2d");
+
+  const auto& weight = weight_bias[0].toTensor();
+  const int64_t in_channels = input_dims[3];
+  const int64_t out_channels = weight.size(0);
+  const bool depthwise = groups > 1;
+  TORCH_CHECK(
+      groups == 1 || (groups == in_channels && weight.size(1) == 1),
+      "NNAPI only supports regular and depthwise conv2d");
+  TORCH_CHECK(
+      weight.size(1) * groups == in_channels,
+      "conv2d weight of ",
+      weight.sizes(),
+      " for an input of ",
+      in_channels,
+      " channels");
+
+  // OIHW to OHWI for a regular conv, to 1HWO for a depthwise one
+  const auto values_zero_point = toQuint8(weight);
+  const auto filter_data = depthwise
+      ? values_zero_point.first.permute({1, 2, 3, 0})
+      : values_zero_point.first.permute({0, 2, 3, 1});
+  const float input_scale = operands_[input].scale;
+  const float weight_scale = weight.q_scale();
+  const auto filter = addConstant(
+      ANEURALNETWORKS_TENSOR_QUANT8_ASYMM,
+      filter_data,
+      weight_scale,
+      values_zero_point.second);
+  const auto bias = addConstant(
+      ANEURALNETWORKS_TENSOR_INT32,
+      toInt32Bias(weight_bias[1], out_channels, input_scale, weight_scale),
+      input_scale * weight_scale,
+      0);
+
+  const int64_t kernel_h = weight.size(2);
+  const int64_t kernel_w = weight.size(3);
+  const int64_t out_h =
+      (input_dims[1] + 2 * padding[0] - kernel_h) / stride[0] + 1;
+  const int64_t out_w =
+      (input_dims[2] + 2 * padding[1] - kernel_w) / stride[1] + 1;
+  const auto output = addTensorOperand(
+      {input_dims[0], out_h, out_w, out_channels},
+      output_scale,
+      output_zero_point);
+
+  std::vector<int32_t> inputs{input,
+                              filter,
+                              bias,
+                              addImmediate(padding[1]),
+                              addImmediate(padding[1]),
+                              addImmediate(padding[0]),
+                              addImmediate(padding[0]),
+                              addImmediate(stride[1]),
+                              addImmediate(stride[0])};
+  if (depthwise) {
+    inputs.push_back(addImmediate(out_channels / in_channels));
+  }
+  inputs.push_back(addImmediate(
+      relu ? ANEURALNETWORKS_FUSED_RELU : ANEURALNETWORKS_FUSED_NONE));
+  addOperation(
+      depthwise ? ANEURALNETWORKS_DEPTHWISE_CONV_2D : ANEURALNETWORKS_CONV_2D,
+      inputs,
+      {output});
+  tensor_operands_[node->output()] = output;
+}
+
+void Serializer::addLinear(Node* node, bool relu) {
+  const auto input = tensorOperand(node->input(0));
+  const auto input_dims = operands_[input].dims;
+  TORCH_CHECK(input_dims.size() == 2, "NNAPI linear needs a 2D input");
+  const auto weight_bias =
+      callOp("quantized::linear_unpack", constantValue(node->input(1)));
+  const float output_scale = constantValue(node->input(2)).toDouble();
+  const int32_t output_zero_point = constantValue(node->input(3)).toInt();
+
+  const auto& weight = weight_bias[0].toTensor();
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.size(1) == input_dims[1],
+      "linear weight of ",
+      weight.sizes(),
+      " for an input of ",
+      input_dims[1],
+      " features");
+  const auto values_zero_point = toQuint8(weight);
+  const float input_scale = operands_[input].scale;
+  const float weight_scale = weight.q_scale();
+  const auto weights = addConstant(
+      ANEURALNETWORKS_TENSOR_QUANT8_ASYMM,
+      values_zero_point.first,
+      weight_scale,
+      values_zero_point.second);
+  const auto bias = addConstant(
+      ANEURALNETWORKS_TENSOR_INT32,
+      toInt32Bias(weight_bias[1], weight.size(0), input_scale, weight_scale),
+      input_scale * weight_scale,
+      0);
+  const auto output = addTensorOperand(
+      {input_dims[0], weight.size(0)}, output_scale, output_zero_point);
+  addOperation(
+      ANEURALNETWORKS_FULLY_CONNECTED,
+      {input,
+       weights,
+       bias,
+       addImmediate(
+           relu ? ANEURALNETWORKS_FUSED_RELU : ANEURALNETWORKS_FUSED_NONE)},
+      {output});
+  tensor_operands_[node->output()] = output;
+}
+
+void Serializer::addAdd(Node* node, bool relu) {
+  const auto a = tensorOperand(node->input(0));
+  const auto b = tensorOperand(node->input(1));
+  TORCH_CHECK(
+      operands_[a].dims == operands_[b].dims,
+      "NNAPI add needs inputs of the same sizes");
+  const auto output = addTensorOperand(
+      operands_[a].dims,
+      constantValue(node->input(2)).toDouble(),
+      constantValue(node->input(3)).toInt());
+  addOperation(
+      ANEURALNETWORKS_ADD,
+      {a,
+       b,
+       addImmediate(
+           relu ? ANEURALNETWORKS_FUSED_RELU : ANEURALNETWORKS_FUSED_NONE)},
+      {output});
+  tensor_operands_[node->output()] = output;
+}
+
+void Serializer::addRelu(Node* node) {
+  const auto input = tensorOperand(node->input(0));
+  const auto output = addTensorOperand(
+      operands_[input].dims,
+      operands_[input].scale,
+      operands_[input].zero_point);
+  addOperation(ANEURALNETWORKS_RELU, {input}, {output});
+  tensor_operands_[node->output()] = output;
+}
+
+void Serializer::addPool2d(
+    Node* node,
+    int32_t type,
+    std::vector<int64_t> kernel_size,
+    std::vector<int64_t> stride,
+    const std::vector<int64_t>& padding) {
+  const auto input = tensorOperand(node->input(0));
+  const auto input_dims = operands_[input].dims;
+  TORCH_CHECK(input_dims.size() == 4, "NNAPI pooling needs a 4D input");
+  if (kernel_size.size() == 1) {
+    kernel_size.push_back(kernel_size[0]);
+  }
+  if (stride.empty()) {
+    stride = kernel_size;
+  } else if (stride.size() == 1) {
+    stride.push_back(stride[0]);
+  }
+  auto pad = padding;
+  if (pad.size() == 1) {
+    pad.push_back(pad[0]);
+  }
+  TORCH_CHECK(
+      kernel_size.size() == 2 && stride.size() == 2 && pad.size() == 2,
+      "NNAPI only supports 2D pooling");
+  const int64_t out_h =
+      (input_dims[1] + 2 * pad[0] - kernel_size[0]) / stride[0] + 1;
+  const int64_t out_w =
+      (input_dims[2] + 2 * pad[1] - kernel_size[1]) / stride[1] + 1;
+  const auto output = addTensorOperand(
+      {input_dims[0], out_h, out_w, input_dims[3]},
+      operands_[input].scale,
+      operands_[input].zero_point);
+  addOperation(
+      type,
+      {input,
+       addImmediate(pad[1]),
+       addImmediate(pad[1]),
+       addImmediate(pad[0]),
+       addImmediate(pad[0]),
+       addImmediate(stride[1]),
+       addImmediate(stride[0]),
+       addImmediate(kernel_size[1]),
+       addImmediate(kernel_size[0]),
+       addImmediate(ANEURALNETWORKS_FUSED_NONE)},
+      {output});
+  tensor_operands_[node->output()] = output;
+}
+
+void Serializer::addMaxPool2d(Node* node) {
+  // max_pool2d(self, kernel_size, stride, padding, dilation, ceil_mode)
+  const auto dilation = constantValue(node->input(4)).toIntVector();
+  for (const auto d : dilation) {
+    TORCH_CHECK(d == 1, "NNAPI does not support dilated max_pool2d");
+  }
+  TORCH_CHECK(
+      !constantValue(node->input(5)).toBool(),
+      "NNAPI does not support max_pool2d with ceil_mode");
+  addPool2d(
+      node,
+      ANEURALNETWORKS_MAX_POOL_2D,
+      constantValue(node->input(1)).toIntVector(),
+      constantValue(node->input(2)).toIntVector(),
+      constantValue(node->input(3)).toIntVector());
+}
+
+void Serializer::addAvgPool2d(Node* node) {
+  // avg_pool2d(self, kernel_size, stride, padding, ceil_mode,
+  // count_include_pad, divisor_override). NNAPI leaves the padding out of
+  // the averages, which only matches count_include_pad without padding.
+  const auto padding = constantValue(node->input(3)).toIntVector();
+  for (const auto p : padding) {
+    TORCH_CHECK(p == 0, "NNAPI only supports avg_pool2d without padding");
+  }
+  TORCH_CHECK(
+      !constantValue(node->input(4)).toBool(),
+      "NNAPI does not support avg_pool2d with ceil_mode");
+  TORCH_CHECK(
+      constantValue(node->input(6)).isNone(),
+      "NNAPI does not support avg_pool2d with divisor_override");
+  addPool2d(
+      node,
+      ANEURALNETWORKS_AVERAGE_POOL_2D,
+      constantValue(node->input(1)).toIntVector(),
+      constantValue(node->input(2)).toIntVector(),
+      padding);
+}
+
+void Serializer::addAdaptiveAvgPool2d(Node* node) {
+  const auto input_dims = operands_[tensorOperand(node->input(0))].dims;
+  TORCH_CHECK(
+      input_dims.size() == 4, "NNAPI adaptive_avg_pool2d needs a 4D input");
+  const auto output_size = constantValue(node->input(1)).toIntVector();
+  TORCH_CHECK(output_size.size() == 2, "adaptive_avg_pool2d of 2 sizes");
+  TORCH_CHECK(
+      input_dims[1] % output_size[0] == 0 &&
+          input_dims[2] % output_size[1] == 0,
+      "NNAPI only supports adaptive_avg_pool2d to a size that divides the "
+      "input");
+  const std::vector<int64_t> kernel_size{input_dims[1] / output_size[0],
+                                         input_dims[2] / output_size[1]};
+  addPool2d(
+      node, ANEURALNETWORKS_AVERAGE_POOL_2D, kernel_size, kernel_size, {0, 0});
+}
+
+void Serializer::addFlatten(Node* node) {
+  const auto input = tensorOperand(node->input(0));
+  const auto input_dims = operands_[input].dims;
+  const auto start_dim = constantValue(node->input(1)).toInt();
+  const auto end_dim = constantValue(node->input(2)).toInt();
+  // NHWC and NCHW only flatten in the same order for 1x1 feature maps
+  TORCH_CHECK(
+      input_dims.size() == 4 && input_dims[1] == 1 && input_dims[2] == 1 &&
+          start_dim == 1 && (end_dim == -1 || end_dim == 3),
+      "NNAPI only supports flattening 1x1 feature maps from dim 1");
+  const auto shape = addConstant(
+      ANEURALNETWORKS_TENSOR_INT32,
+      at::tensor(
+          std::vector<int32_t>{static_cast<int32_t>(input_dims[0]),
+                               static_cast<int32_t>(input_dims[3])},
+          at::kInt),
+      0.0f,
+      0);
+  const auto output = addTensorOperand(
+      {input_dims[0], input_dims[3]},
+      operands_[input].scale,
+      operands_[input].zero_point);
+  addOperation(ANEURALNETWORKS_RESHAPE, {input, shape}, {output});
+  tensor_operands_[node->output()] = output;
+}
+
+void Serializer::evaluateNode(Node* node) {
+  // Sizes of tensors of the model are known at lowering time
+  if (node->kind() == aten::size && isTensorOperand(node->input(0))) {
+    const auto sizes = torchSizes(tensorOperand(node->input(0)));
+    if (node->inputs().size() == 1) {
+      values_[node->output()] = sizes;
+    } else {
+      auto dim = constantValue(node->input(1)).toInt();
+      dim = dim < 0 ? dim + sizes.size() : dim;
+      TORCH_CHECK(dim >= 0 && dim < static_cast<int64_t>(sizes.size()));
+      values_[node->output()] = sizes[dim];
+    }
+    return;
+  }
+  if (node->kind() == aten::dim && isTensorOperand(node->input(0))) {
+    const auto input = tensorOperand(node->input(0));
+    values_[node->output()] =
+        static_cast<int64_t>(operands_[input].dims.size());
+    return;
+  }
+
+  Stack stack;
+  for (auto* input : node->inputs()) {
+    stack.push_back(constantValue(input));
+  }
+  switch (node->kind()) {
+    case prim::ListConstruct:
+      listConstruct(
+          stack,
+          node->output()->type()->expect<ListType>(),
+          node->inputs().size());
+      break;
+    case prim::TupleConstruct:
+      tupleConstruct(stack, node->inputs().size());
+      break;
+    case prim::ListUnpack:
+      listUnpack(stack, node->outputs().size());
+      break;
+    case prim::TupleUnpack:
+      tupleUnpack(stack);
+      break;
+    default:
+      TORCH_CHECK(
+          node->maybeOperator(),
+          "NNAPI does not support ",
+          node->kind().toQualString());
+      node->getOperation()(&stack);
+  }
+  TORCH_INTERNAL_ASSERT(stack.size() == node->outputs().size());
+  for (size_t i = 0; i < stack.size(); ++i) {
+    values_[node->output(i)] = std::move(stack[i]);
+  }
+}
+
+void Serializer::serializeNode(Node* node) {
+  switch (node->kind()) {
+    case prim::Constant:
+      values_[node->output()] = *toIValue(node->output());
+      return;
+    case prim::GetAttr:
+      values_[node->output()] = constantValue(node->input(0))
+                                    .toObject()
+                                    ->getAttr(node->s(attr::name));
+      return;
+    case prim::If: {
+      // Branches on shapes and types, whose values are known
+      const bool cond = constantValue(node->input(0)).toBool();
+      auto* block = node->blocks().at(cond ? 0 : 1);
+      serializeBlock(block);
+      for (size_t i = 0; i < node->outputs().size(); ++i) {
+        auto* output = block->outputs()[i];
+        if (isTensorOperand(output)) {
+          tensor_operands_[node->output(i)] = tensorOperand(output);
+        } else {
+          values_[node->output(i)] = constantValue(output);
+        }
+      }
+      return;
+    }
+    case prim::RaiseException:
+      TORCH_CHECK(
+          false,
+          "The method raises an exception for the example inputs: ",
+          constantValue(node->input(0)).toStringRef());
+    default:
+      break;
+  }
+
+  const auto kind = node->kind().toQualString();
+  if (!strcmp(kind, "quantized::conv2d")) {
+    addConv2d(node, /*relu=*/false);
+  } else if (!strcmp(kind, "quantized::conv2d_relu")) {
+    addConv2d(node, /*relu=*/true);
+  } else if (!strcmp(kind, "quantized::linear")) {
+    addLinear(node, /*relu=*/false);
+  } else if (!strcmp(kind, "quantized::linear_relu")) {
+    addLinear(node, /*relu=*/true);
+  } else if (!strcmp(kind, "quantized::add")) {
+    addAdd(node, /*relu=*/false);
+  } else if (!strcmp(kind, "quantized::add_relu")) {
+    addAdd(node, /*relu=*/true);
+  } else if (node->kind() == aten::relu || node->kind() == aten::relu_) {
+    addRelu(node);
+  } else if (node->kind() == aten::max_pool2d) {
+    addMaxPool2d(node);
+  } else if (node->kind() == aten::avg_pool2d) {
+    addAvgPool2d(node);
+  } else if (node->kind() == aten::adaptive_avg_pool2d) {
+    addAdaptiveAvgPool2d(node);
+  } else if (node->kind() == aten::flatten) {
+    addFlatten(node);
+  } else {
+    for (auto* input : node->inputs()) {
+      TORCH_CHECK(
+          !isTensorOperand(input),
+          "NNAPI does not support ",
+          kind,
+          ", lower the submodules without it instead");
+    }
+    evaluateNode(node);
+  }
+}
+
+void Serializer::serializeBlock(Block* block) {
+  for (auto* node : block->nodes()) {
+    serializeNode(node);
+  }
+}
+
+c10::IValue Serializer::serialize(
+    const Module& module,
+    const std::string& method_name,
+    const std::vector<at::Tensor>& example_inputs) {
+  auto graph = module.get_method(method_name).graph()->copy();
+  Inline(*graph);
+
+  TORCH_CHECK(
+      graph->inputs().size() == example_inputs.size() + 1,
+      method_name,
+      " takes ",
+      graph->inputs().size() - 1,
+      " inputs, got ",
+      example_inputs.size(),
+      " example inputs");
+  values_[graph->inputs()[0]] = module._ivalue();
+  std::vector<int32_t> inputs;
+  for (size_t i = 0; i < example_inputs.size(); ++i) {
+    const auto& example = example_inputs[i];
+    TORCH_CHECK(
+        example.scalar_type() == at::kQUInt8 &&
+            example.qscheme() == at::kPerTensorAffine,
+        "NNAPI needs quint8 per tensor affine inputs");
+    auto dims = example.sizes().vec();
+    if (dims.size() == 4) {
+      dims = {dims[0], dims[2], dims[3], dims[1]};
+    }
+    inputs.push_back(addTensorOperand(
+        dims, example.q_scale(), example.q_zero_point()));
+    tensor_operands_[graph->inputs()[i + 1]] = inputs.back();
+  }
+
+  serializeBlock(graph->block());
+
+  // A tensor, or a tuple of tensors
+  std::vector<Value*> output_values{graph->outputs()[0]};
+  auto* producer = output_values[0]->node();
+  if (producer->kind() == prim::TupleConstruct) {
+    output_values.assign(
+        producer->inputs().begin(), producer->inputs().end());
+  }
+  std::vector<int32_t> outputs;
+  for (auto* value : output_values) {
+    const auto operand = tensorOperand(value);
+    TORCH_CHECK(
+        std::find(inputs.begin(), inputs.end(), operand) == inputs.end(),
+        "NNAPI can't return the inputs of the model");
+    outputs.push_back(operand);
+  }
+
+  std::vector<int32_t> serialized{kSerializedModelVersion,
+                                  static_cast<int32_t>(operands_.size()),
+                                  num_operations_,
+                                  static_cast<int32_t>(inputs.size()),
+                                  static_cast<int32_t>(outputs.size())};
+  for (const auto& operand : operands_) {
+    serialized.push_back(operand.type);
+    serialized.push_back(operand.dims.size());
+    for (const auto dim : operand.dims) {
+      serialized.push_back(dim);
+    }
+    serialized.push_back(floatBits(operand.scale));
+    serialized.push_back(operand.zero_point);
+    serialized.push_back(static_cast<int32_t>(operand.kind));
+    serialized.push_back(operand.value);
+  }
+  serialized.insert(serialized.end(), operations_.begin(), operations_.end());
+  serialized.insert(serialized.end(), inputs.begin(), inputs.end());
+  serialized.insert(serialized.end(), outputs.begin(), outputs.end());
+
+  return c10::ivalue::Tuple::create(
+      {at::tensor(serialized, at::kInt), c10::List<at::Tensor>(constants_)});
+}
+
+} // namespace
+
+c10::IValue serializeMethod(
+    const Module& module,
+    const std::string& method_name,
+    const std::vector<at::Tensor>& example_inputs) {
+  return Serializer().serialize(module, method_name, example_inputs);
+}
+
+} // namespace nnapi
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+
+namespace torch {
+namespace jit {
+namespace nnapi {
+
+// Lowering of TorchScript methods to Android NNAPI models.
+//
+// A lowered method is a Tuple(Tensor serialized_model, Tensor[] constants).
+// serialized_model is an int32 tensor laid out as
+//
+//   kSerializedModelVersion, #operands, #operations, #inputs, #outputs
+//   every operand: type, rank, dims..., scale (float bits), zero point,
+//                  value kind, value
+//   every operation: type, #inputs, inputs..., #outputs, outputs...
+//   the operands of the model inputs, then of the model outputs
+//
+// where types are the NNAPI operand and operation codes, and the value of an
+// operand is an immediate int32 or the index of its data in constants, see
+// ValueKind. The dims of operands are in NNAPI order, which is NHWC for 4D
+// tensors. TorchScript sees those tensors as NCHW.
+//
+// The lowered methods may only contain the operations of quantized (quint8,
+// per tensor affine) CNNs NNAPI 1.0 can run: quantized::conv2d (regular and
+// depthwise), quantized::linear, quantized::add, their _relu variants,
+// aten::relu, aten::max_pool2d, aten::avg_pool2d, aten::adaptive_avg_pool2d
+// and aten::flatten of 1x1 feature maps. Control flow and shape arithmetic
+// are evaluated away at lowering time for the example inputs. The rest of a
+// model stays on the interpreter: lower the submodules that NNAPI supports,
+// not the whole model.
+
+constexpr int32_t kSerializedModelVersion = 1;
+
+enum class ValueKind : int32_t {
+  // Model inputs and outputs of operations
+  NONE = 0,
+  // A scalar, the value is the scalar
+  IMMEDIATE = 1,
+  // A constant tensor, the value is its index in constants
+  CONSTANT = 2,
+};
+
+// Lowers method `method_name` of `module` for inputs of the sizes and
+// quantization parameters of `example_inputs`. Throws if the method has an
+// operation that NNAPI can't run.
+TORCH_API c10::IValue serializeMethod(
+    const Module& module,
+    const std::string& method_name,
+    const std::vector<at::Tensor>& example_inputs);
+
+} // namespace nnapi
+} // namespace jit
+} // namespace torch
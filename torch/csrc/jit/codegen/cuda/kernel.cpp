@@ -2,8 +2,10 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/nvrtc_stub/ATenNVRTC.h>
 #include <c10/core/ScalarType.h>
+#include <c10/core/thread_pool.h>
 #include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/util/ArrayRef.h>
+#include <c10/util/ConstexprCrc.h>
 
 #include <torch/csrc/jit/codegen/cuda/kernel.h>
 #include <torch/csrc/jit/codegen/cuda/kernel_arg.h>
@@ -12,8 +14,13 @@
 #include <torch/csrc/jit/codegen/cuda/parser.h>
 
 #include <torch/csrc/jit/resource_guard.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <random>
+#include <thread>
 
 namespace torch {
 namespace jit {
@@ -370,6 +377,177 @@ std::array<size_t, 2> gridReductionTempBufferSizes(CudaKernel* entry) {
   return {{buffer_size, sync_flag_size}};
 }
 
+// Compiles code with NVRTC. Returns the PTX and the lowered name of func_name.
+std::pair<std::vector<char>, std::string> nvrtcCompile(
+    const std::string& code,
+    const std::string& func_name,
+    int major,
+    int minor) {
+  nvrtcProgram program;
+  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
+      &program, code.c_str(), nullptr, 0, nullptr, nullptr));
+  ResourceGuard holdProgram(
+      [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
+
+  const std::string compute = "--gpu-architecture=compute_" +
+      std::to_string(major) + std::to_string(minor);
+  const std::vector<const char*> args = {
+      "--std=c++14", compute.c_str(), "-default-device"};
+
+  nvrtc().nvrtcAddNameExpression(program, func_name.c_str());
+  const auto result =
+      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
+  if (result != NVRTC_SUCCESS) {
+    size_t logsize;
+    nvrtc().nvrtcGetProgramLogSize(program, &logsize);
+    std::vector<char> log(logsize);
+    nvrtc().nvrtcGetProgramLog(program, log.data());
+
+    TORCH_INTERNAL_ASSERT(
+        false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
+  }
+  const char* lowered_kernel_name;
+  nvrtc().nvrtcGetLoweredName(program, func_name.c_str(), &lowered_kernel_name);
+
+  AT_CUDA_NVRTC_CHECK(result);
+  size_t ptx_size;
+  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
+  std::vector<char> ptx;
+  ptx.resize(ptx_size);
+  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx.data()));
+  // The lowered name belongs to the program, copy it before it's destroyed
+  return std::make_pair(std::move(ptx), std::string(lowered_kernel_name));
+}
+
+// Links ptx into a CUBIN for the device of the current context.
+std::string linkCubin(const std::vector<char>& ptx) {
+  CUlinkState linkState;
+  AT_CUDA_DRIVER_CHECK(nvrtc().cuLinkCreate(0, nullptr, nullptr, &linkState));
+  ResourceGuard holdLinkState(
+      [&] { AT_CUDA_DRIVER_CHECK(nvrtc().cuLinkDestroy(linkState)); });
+  AT_CUDA_DRIVER_CHECK(nvrtc().cuLinkAddData(
+      linkState,
+      CU_JIT_INPUT_PTX,
+      const_cast<char*>(ptx.data()),
+      ptx.size(),
+      "compiling PTX",
+      0,
+      nullptr,
+      nullptr));
+  size_t cubinSize;
+  void* cubin;
+  AT_CUDA_DRIVER_CHECK(nvrtc().cuLinkComplete(linkState, &cubin, &cubinSize));
+  // The CUBIN belongs to the link state
+  return std::string(static_cast<const char*>(cubin), cubinSize);
+}
+
+// [ On-disk kernel cache ]
+//
+// A cache file, named after the hash of the generated code, the GPU arch and
+// the NVRTC version, holds:
+//   1. the generated code, so that hash collisions are a cache miss;
+//   2. the lowered kernel name;
+//   3. the CUBIN.
+// each of them prefixed by its size. Files are written to a temporary name
+// and then renamed, so that concurrent processes sharing the cache directory
+// never read partial files.
+constexpr char kKernelCacheMagic[] = "CUDAFUSERCUBIN1";
+
+std::string kernelCachePath(
+    const std::string& cache_dir,
+    const std::string& code,
+    int major,
+    int minor,
+    int nvrtc_major,
+    int nvrtc_minor) {
+  std::stringstream path;
+  path << cache_dir << "/kernel_" << std::hex
+       << c10::util::crc64(code.data(), code.size()).checksum() << std::dec
+       << "_sm" << major << minor << "_nvrtc" << nvrtc_major << nvrtc_minor
+       << ".cubin";
+  return path.str();
+}
+
+bool readSizedString(std::istream& in, std::string* str) {
+  uint64_t size = 0;
+  // Also bounds the allocation for corrupted files
+  constexpr uint64_t kMaxSize = 1ull << 30;
+  if (!in.read(reinterpret_cast<char*>(&size), sizeof(size)) ||
+      size > kMaxSize) {
+    return false;
+  }
+  str->resize(size);
+  return static_cast<bool>(in.read(&(*str)[0], size));
+}
+
+void writeSizedString(std::ostream& out, const std::string& str) {
+  const uint64_t size = str.size();
+  out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.write(str.data(), str.size());
+}
+
+// Leaves cubin empty unless path holds the kernel compiled from code.
+void loadCachedKernel(
+    const std::string& path,
+    const std::string& code,
+    std::string* lowered_kernel_name,
+    std::string* cubin) {
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  if (!in.is_open()) {
+    return;
+  }
+  std::string magic(sizeof(kKernelCacheMagic), '\0');
+  std::string cached_code;
+  std::string cached_name;
+  std::string cached_cubin;
+  if (!in.read(&magic[0], magic.size()) ||
+      magic.compare(0, magic.size(), kKernelCacheMagic, magic.size()) != 0 ||
+      !readSizedString(in, &cached_code) || cached_code != code ||
+      !readSizedString(in, &cached_name) ||
+      !readSizedString(in, &cached_cubin) || cached_cubin.empty()) {
+    return;
+  }
+  *lowered_kernel_name = std::move(cached_name);
+  *cubin = std::move(cached_cubin);
+}
+
+void storeCachedKernel(
+    const std::string& path,
+    const std::string& code,
+    const std::string& lowered_kernel_name,
+    const std::string& cubin) {
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp"
+           << std::hash<std::thread::id>()(std::this_thread::get_id())
+           << "_" << std::random_device()();
+  {
+    std::ofstream out(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (!out.is_open()) {
+      return;
+    }
+    out.write(kKernelCacheMagic, sizeof(kKernelCacheMagic));
+    writeSizedString(out, code);
+    writeSizedString(out, lowered_kernel_name);
+    writeSizedString(out, cubin);
+    if (!out) {
+      out.close();
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  // Failing to cache the kernel only means compiling it again next time
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
+// Threads compiling kernels handed to compileKernelAsync
+c10::ThreadPool& compilationPool() {
+  static c10::ThreadPool pool(std::max<int>(
+      1, std::min<int>(4, std::thread::hardware_concurrency())));
+  return pool;
+}
+
 } // namespace
 
 bool NaivePWKernelArgsReq::matchKernelSize(const at::ArrayRef<IValue> inputs) {
@@ -390,26 +568,62 @@ bool NaivePWKernelArgsReq::matchKernelSize(const at::ArrayRef<IValue> inputs) {
   return true;
 }
 
+bool ReductionKernelArgsReq::matchKernelSize(
+    const at::ArrayRef<IValue> inputs) {
+  if (!NaivePWKernelArgsReq::matchKernelSize(inputs)) {
+    return false;
+  }
+  // See [ Note - broadcast support in integration ]
+  int64_t n_dims = 0;
+  for (const auto& input : inputs) {
+    if (input.isTensor()) {
+      n_dims = std::max(n_dims, input.toTensor().dim());
+    }
+  }
+  std::vector<int64_t> sizes(n_dims, 1);
+  for (const auto& input : inputs) {
+    if (input.isTensor()) {
+      const auto& tensor = input.toTensor();
+      const int64_t offset = n_dims - tensor.dim();
+      for (int64_t i = 0; i < tensor.dim(); i++) {
+        if (sizes[offset + i] == 1) {
+          sizes[offset + i] = tensor.size(i);
+        }
+      }
+    }
+  }
+  int64_t reduction_size = 1;
+  int64_t num_outputs = 1;
+  for (int64_t i = 0; i < n_dims; i++) {
+    if (std::find(reduction_axes_.begin(), reduction_axes_.end(), i) !=
+        reduction_axes_.end()) {
+      reduction_size *= sizes[i];
+    } else {
+      num_outputs *= sizes[i];
+    }
+  }
+  return reductionHeuristic(num_outputs, reduction_size, params_.fastest_dim) ==
+      params_;
+}
+
 void compileKernel(CudaKernel* entry) {
   // generating cuda code;
   std::string code;
   std::string func_name;
   std::tie(func_name, code) = codeGeneration(entry->fusion_.get());
 
-  static int32_t compiled_kernel_id = 0;
+  static std::atomic<int32_t> compiled_kernel_id{0};
   // We increment the id here instead of at the end of the function to avoid
   // error during jit-compilation that would make debug message confusing.
-  compiled_kernel_id++;
+  const int32_t kernel_id = ++compiled_kernel_id;
   const char* debug_env = getenv("PYTORCH_CUDA_FUSER_DEBUG");
   if (debug_env && atoi(debug_env)) {
-    std::cout << "\n==== codegen output for kernel: " << compiled_kernel_id
+    std::cout << "\n==== codegen output for kernel: " << kernel_id
               << " ====" << std::endl
               << code << std::endl
               << "====================================" << std::endl;
   }
 
-  // vvv NVRTC COMPILATION vvv
-
   // lazily construct context if non-existing yet;
   CUcontext pctx = nullptr;
   AT_CUDA_DRIVER_CHECK(nvrtc().cuCtxGetCurrent(&pctx));
@@ -435,87 +649,66 @@ void compileKernel(CudaKernel* entry) {
   int major, minor;
   major = prop->major;
   minor = prop->minor;
-  nvrtcProgram program;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
-      &program, code.c_str(), nullptr, 0, nullptr, nullptr));
-  ResourceGuard holdProgram(
-      [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
 
-  const std::string compute = "--gpu-architecture=compute_" +
-      std::to_string(major) + std::to_string(minor);
-  const std::vector<const char*> args = {
-      "--std=c++14", compute.c_str(), "-default-device"};
-
-  nvrtc().nvrtcAddNameExpression(program, func_name.c_str());
-  const auto result =
-      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
-  if (result != NVRTC_SUCCESS) {
-    size_t logsize;
-    nvrtc().nvrtcGetProgramLogSize(program, &logsize);
-    std::vector<char> log(logsize);
-    nvrtc().nvrtcGetProgramLog(program, log.data());
-
-    TORCH_INTERNAL_ASSERT(
-        false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
+  const char* cache_dir = getenv("PYTORCH_CUDA_FUSER_CACHE_DIR");
+  std::string cache_path;
+  std::string lowered_kernel_name;
+  std::string cubin;
+  if (cache_dir) {
+    cache_path = kernelCachePath(
+        cache_dir, code, major, minor, nvrtc_major, nvrtc_minor);
+    loadCachedKernel(cache_path, code, &lowered_kernel_name, &cubin);
   }
-  const char* lowered_kernel_name;
-  nvrtc().nvrtcGetLoweredName(program, func_name.c_str(), &lowered_kernel_name);
-
-  AT_CUDA_NVRTC_CHECK(result);
-  size_t ptx_size;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
-  std::vector<char> ptx;
-  ptx.resize(ptx_size);
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx.data()));
 
-  // TODO: We do go through different code path, should investigate whether this
-  // has an impact on generated binary.
-  const char* prefix_env = getenv("PYTORCH_CUDA_FUSER_CUBIN");
-  if (prefix_env) {
-    // Output ptx file
-    std::stringstream ptx_file_name;
-    ptx_file_name << prefix_env << "_" << compiled_kernel_id << ".ptx";
-    std::ofstream myPtxFile(ptx_file_name.str().c_str(), std::ios::out);
-    if (myPtxFile.is_open()) {
-      myPtxFile.write(ptx.data(), ptx.size());
-      myPtxFile.close();
+  if (cubin.empty()) {
+    std::vector<char> ptx;
+    std::tie(ptx, lowered_kernel_name) =
+        nvrtcCompile(code, func_name, major, minor);
+
+    // TODO: We do go through different code path, should investigate whether
+    // this has an impact on generated binary.
+    const char* prefix_env = getenv("PYTORCH_CUDA_FUSER_CUBIN");
+    if (prefix_env) {
+      // Output ptx file
+      std::stringstream ptx_file_name;
+      ptx_file_name << prefix_env << "_" << kernel_id << ".ptx";
+      std::ofstream myPtxFile(ptx_file_name.str().c_str(), std::ios::out);
+      if (myPtxFile.is_open()) {
+        myPtxFile.write(ptx.data(), ptx.size());
+        myPtxFile.close();
+      }
     }
 
-    CUlinkState linkState;
-
-    AT_CUDA_DRIVER_CHECK(nvrtc().cuLinkCreate(0, nullptr, nullptr, &linkState));
-    AT_CUDA_DRIVER_CHECK(nvrtc().cuLinkAddData(
-        linkState,
-        CU_JIT_INPUT_PTX,
-        ptx.data(),
-        ptx_size,
-        "compiling PTX",
-        0,
-        nullptr,
-        nullptr));
-    size_t cubinSize;
-    void* cubin;
-    AT_CUDA_DRIVER_CHECK(nvrtc().cuLinkComplete(linkState, &cubin, &cubinSize));
-
-    // Output binary file
-    std::stringstream cubin_file_name;
-    cubin_file_name << prefix_env << "_" << compiled_kernel_id << ".cubin";
-    std::ofstream myCubinFile(
-        cubin_file_name.str().c_str(), std::ios::out | std::ios::binary);
-    if (myCubinFile.is_open()) {
-      myCubinFile.write(static_cast<const char*>(cubin), cubinSize);
-      myCubinFile.close();
+    if (prefix_env || cache_dir) {
+      cubin = linkCubin(ptx);
+      if (prefix_env) {
+        // Output binary file
+        std::stringstream cubin_file_name;
+        cubin_file_name << prefix_env << "_" << kernel_id << ".cubin";
+        std::ofstream myCubinFile(
+            cubin_file_name.str().c_str(), std::ios::out | std::ios::binary);
+        if (myCubinFile.is_open()) {
+          myCubinFile.write(cubin.data(), cubin.size());
+          myCubinFile.close();
+        }
+      }
+      if (cache_dir) {
+        storeCachedKernel(cache_path, code, lowered_kernel_name, cubin);
+      }
+    } else {
+      // load ptx directly
+      AT_CUDA_DRIVER_CHECK(
+          nvrtc().cuModuleLoadData(&(entry->module_), ptx.data()));
     }
-
+  }
+  if (!cubin.empty()) {
     // load compiled cubin
-    AT_CUDA_DRIVER_CHECK(nvrtc().cuModuleLoadData(&(entry->module_), cubin));
-  } else {
-    // load ptx directly
     AT_CUDA_DRIVER_CHECK(
-        nvrtc().cuModuleLoadData(&(entry->module_), ptx.data()));
+        nvrtc().cuModuleLoadData(&(entry->module_), cubin.data()));
   }
+
   AT_CUDA_DRIVER_CHECK(nvrtc().cuModuleGetFunction(
-      &(entry->function_), entry->module_, lowered_kernel_name));
+      &(entry->function_), entry->module_, lowered_kernel_name.c_str()));
 #if defined(__HIP_PLATFORM_HCC__) && HIP_VERSION < 305
   // HIP function signature is not compatible yet
   uint32_t max_blocks;
@@ -527,6 +720,19 @@ void compileKernel(CudaKernel* entry) {
       &entry->max_blocks_, entry->function_, 128, 0));
 #endif
   entry->max_blocks_ *= prop->multiProcessorCount;
+  entry->compile_status_ = CudaKernel::CompileStatus::Compiled;
+}
+
+void compileKernelAsync(CudaKernel* entry) {
+  entry->compile_status_ = CudaKernel::CompileStatus::Compiling;
+  compilationPool().run([entry]() {
+    try {
+      compileKernel(entry);
+    } catch (const std::exception& e) {
+      TORCH_WARN("CUDA fuser kernel compilation failed: ", e.what());
+      entry->compile_status_ = CudaKernel::CompileStatus::Failed;
+    }
+  });
 }
 
 void runKernel(
@@ -549,16 +755,10 @@ void runKernel(
   int thread_y = 1;
   if (!entry->reduction_axes_.empty()) {
     // TODO: MAJOR HACK! Expr evaluation makes launch configuration much easier
-    blocks = numel;
-    // Translated to `fcd_reduction`
-    if (entry->reduction_axes_.back() ==
-        outputs[0].dim() + ((int)entry->reduction_axes_.size()) - 1) {
-      thread_x = kFcdReductionThreadX;
-      thread_y = 1;
-    } else {
-      thread_x = kNonFcdReductionThreadX;
-      thread_y = kNonFcdReductionThreadY;
-    }
+    const auto& params = entry->reduction_params_;
+    blocks = reductionGridDim(params, numel);
+    thread_x = params.bdimx;
+    thread_y = params.bdimy;
   } else {
     // TODO: we can't randomly clap down this until we got striding.
     blocks = ceilDiv(numel, kPwThreadX * entry->unroll_factor_);
@@ -5,6 +5,9 @@
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
 #include <torch/csrc/jit/codegen/cuda/fusion.h>
+#include <torch/csrc/jit/codegen/cuda/scheduler.h>
+
+#include <atomic>
 
 /*
  * The exposed APIs in this file is used by manager.h/cpp
@@ -40,12 +43,27 @@ struct NaivePWKernelArgsReq : KernelArgsReq {
   std::vector<int> dims_;
 };
 
+// reduction kernels also require the problem size to pick the same
+// ReductionParams, as they are specialized for them.
+struct ReductionKernelArgsReq : NaivePWKernelArgsReq {
+  bool matchKernelSize(const at::ArrayRef<c10::IValue> inputs) override;
+  // of the reduction input, to which all input tensors are broadcasted
+  std::vector<int> reduction_axes_;
+  ReductionParams params_;
+};
+
 class CudaKernel {
  public:
+  enum class CompileStatus { NotCompiled, Compiling, Compiled, Failed };
+
   CudaKernel() {
     fusion_ = std::make_unique<Fusion>();
   }
 
+  bool isCompiled() const {
+    return compile_status_.load() == CompileStatus::Compiled;
+  }
+
   CUmodule& getModule() {
     return module_;
   }
@@ -61,6 +79,8 @@ class CudaKernel {
   int unroll_factor_ = 1;
   // mark reduction axes;
   std::vector<int> reduction_axes_;
+  // how the reduction is scheduled, see scheduleReduction;
+  ReductionParams reduction_params_;
 
   // WARNING:
   // Block and Grid dimension setting is here for testing purposes only
@@ -78,13 +98,26 @@ class CudaKernel {
   bool has_random_;
 
   std::unique_ptr<Fusion> fusion_;
+
+  // Set by compileKernel, which may run on a compilation thread, see
+  // compileKernelAsync. Nothing else but the status may be touched while the
+  // kernel is Compiling.
+  std::atomic<CompileStatus> compile_status_{CompileStatus::NotCompiled};
 };
 
 // compile Fusion to CUDA functions:
 // 1. JIT compilation via nvrtc to generate CUDA c++ kernel code;
 // 2. CUDA Drive API to load CUDA c++ kernel code as function_;
+//
+// When the env variable PYTORCH_CUDA_FUSER_CACHE_DIR is set, compiled CUBINs
+// are kept in that directory, by hash of the generated code and by GPU arch,
+// and loaded from there instead of running NVRTC again.
 TORCH_CUDA_API void compileKernel(CudaKernel* entry);
 
+// compileKernel on a compilation thread. entry->compile_status_ becomes
+// Compiled, or Failed if compileKernel throws, once it's done.
+TORCH_CUDA_API void compileKernelAsync(CudaKernel* entry);
+
 // run loaded kernel through Function.
 // inputs/outputs is given in the sense of a PyTorch JIT ir node. This function
 // wraps IO data structure for tensors on host.
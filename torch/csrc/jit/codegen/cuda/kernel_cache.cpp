@@ -12,16 +12,17 @@ at::optional<CudaKernel*> CudaKernelCache::getKernelPtr(
     const at::ArrayRef<c10::IValue> inputs) {
   for (auto& iter : kernels_) {
     if (iter.first->matchKernelSize(inputs)) {
-      return &(iter.second);
+      return iter.second.get();
     }
   }
   return at::nullopt;
 }
 
 CudaKernel* CudaKernelCache::allocateKernelInCache(
-    std::unique_ptr<KernelArgsReq>&& args_req) {
-  kernels_.emplace_back(std::move(args_req), CudaKernel());
-  return &(kernels_.back().second);
+    std::unique_ptr<KernelArgsReq>&& args_req,
+    std::unique_ptr<CudaKernel>&& kernel) {
+  kernels_.emplace_back(std::move(args_req), std::move(kernel));
+  return kernels_.back().second.get();
 }
 
 } // namespace cuda
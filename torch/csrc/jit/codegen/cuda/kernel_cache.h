@@ -19,7 +19,9 @@ class CudaKernelCache {
 
   at::optional<CudaKernel*> getKernelPtr(
       const at::ArrayRef<c10::IValue> inputs);
-  CudaKernel* allocateKernelInCache(std::unique_ptr<KernelArgsReq>&& args_req);
+  CudaKernel* allocateKernelInCache(
+      std::unique_ptr<KernelArgsReq>&& args_req,
+      std::unique_ptr<CudaKernel>&& kernel);
 
   // private:
   // TODO: In theory we should assume contiguity remain constant across runs
@@ -27,7 +29,11 @@ class CudaKernelCache {
   //       want to be safe and cache on that as well.
   // Assuming constant nDims. Cache of kernels targetting different tensor size;
   // We should flatten
-  std::vector<std::pair<std::unique_ptr<KernelArgsReq>, CudaKernel>> kernels_;
+  // Kernels are held by pointer, as compileKernelAsync keeps using them while
+  // more get allocated.
+  std::vector<
+      std::pair<std::unique_ptr<KernelArgsReq>, std::unique_ptr<CudaKernel>>>
+      kernels_;
 };
 
 } // namespace cuda
@@ -16,12 +16,40 @@ namespace fuser {
 namespace cuda {
 
 namespace {
-std::unique_ptr<KernelArgsReq> makePWKernelSupport(
-    const at::ArrayRef<IValue>& inputs) {
-  auto req_ptr = std::make_unique<NaivePWKernelArgsReq>();
+
+bool disableFallback() {
+  const char* disable_fb_env = getenv("PYTORCH_CUDA_FUSER_DISABLE_FALLBACK");
+  return disable_fb_env && atoi(disable_fb_env);
+}
+
+// Kernels are compiled on a compilation thread, the fallback runs until they
+// are ready, unless PYTORCH_CUDA_FUSER_ASYNC_COMPILE=0. Without fallback
+// there is nothing to run meanwhile, so they are compiled on the spot then.
+bool compileAsync() {
+  const char* async_env = getenv("PYTORCH_CUDA_FUSER_ASYNC_COMPILE");
+  return (!async_env || atoi(async_env)) && !disableFallback();
+}
+
+std::unique_ptr<KernelArgsReq> makeKernelArgsReq(
+    const at::ArrayRef<IValue>& inputs,
+    const CudaKernel& cuda_kernel) {
+  std::vector<int> dims;
   for (const auto& input : inputs) {
-    req_ptr->dims_.push_back(input.isTensor() ? input.toTensor().dim() : -1);
+    dims.push_back(input.isTensor() ? input.toTensor().dim() : -1);
+  }
+  if (!cuda_kernel.reduction_axes_.empty()) {
+    auto req_ptr = std::make_unique<ReductionKernelArgsReq>();
+    req_ptr->dims_ = dims;
+    req_ptr->reduction_axes_ = cuda_kernel.reduction_axes_;
+    req_ptr->params_ = cuda_kernel.reduction_params_;
+    // Unless the kernel was scheduled with default parameters, for lack of
+    // sizes, in which case it suits all sizes.
+    if (req_ptr->matchKernelSize(inputs)) {
+      return req_ptr;
+    }
   }
+  auto req_ptr = std::make_unique<NaivePWKernelArgsReq>();
+  req_ptr->dims_ = std::move(dims);
   return req_ptr;
 }
 
@@ -74,7 +102,10 @@ class CudaFusionManager {
     return graph_cache_[repr];
   };
 
-  void runFusionNode(
+  // Returns false, without running anything, while the kernel for this input
+  // configuration is still being compiled or if it failed to compile. The
+  // caller is expected to run the fallback then.
+  bool runFusionNode(
       int32_t kernel_id,
       std::shared_ptr<Graph>& graph,
       const at::ArrayRef<IValue> inputs,
@@ -86,15 +117,8 @@ class CudaFusionManager {
 
     // TODO: temporary hack
     auto cuda_kernel = kernel_cache_[kernel_id].getKernelPtr(inputs);
-    if (cuda_kernel) {
-      // TODO: update launch config for specific sizes;
-      //       maybe we should store it in CudaKernel and compute it later
-      runKernel(*cuda_kernel, inputs, outputs, broadcasted_shape);
-    } else {
-      // TODO: this should somehow be done after kernel compilation.
-      //       we will want compileKernel to return a heuristic
-      cuda_kernel = kernel_cache_[kernel_id].allocateKernelInCache(
-          makePWKernelSupport(inputs));
+    if (!cuda_kernel) {
+      auto new_kernel = std::make_unique<CudaKernel>();
 
       // lower torch::jit::Graph to torch::jit::fuser::cuda::fusion
       // TODO: pass contiguity infor as well as size req, so we can apply proper
@@ -102,7 +126,7 @@ class CudaFusionManager {
       // we should propagate more information back:
       //   1. device;
       //   2. launch config;
-      parseJitIR(graph, cuda_kernel.value());
+      parseJitIR(graph, new_kernel.get());
 
       // find device in inputs.
       for (const auto& input : inputs) {
@@ -110,16 +134,32 @@ class CudaFusionManager {
           const auto& device = input.toTensor().device();
           TORCH_INTERNAL_ASSERT(
               device.is_cuda(), "Could only fuser operations on cuda device");
-          cuda_kernel.value()->device_ = device.index();
+          new_kernel->device_ = device.index();
           break;
         }
       }
 
+      // The scheduling picked by the parser decides which inputs the kernel
+      // can be reused for.
+      auto args_req = makeKernelArgsReq(inputs, *new_kernel);
+      cuda_kernel = kernel_cache_[kernel_id].allocateKernelInCache(
+          std::move(args_req), std::move(new_kernel));
+
       // NVRTC compile kernel
-      compileKernel(cuda_kernel.value());
+      if (compileAsync()) {
+        compileKernelAsync(cuda_kernel.value());
+      } else {
+        compileKernel(cuda_kernel.value());
+      }
+    }
 
-      runKernel(*cuda_kernel, inputs, outputs, broadcasted_shape);
+    if (!cuda_kernel.value()->isCompiled()) {
+      return false;
     }
+    // TODO: update launch config for specific sizes;
+    //       maybe we should store it in CudaKernel and compute it later
+    runKernel(*cuda_kernel, inputs, outputs, broadcasted_shape);
+    return true;
   }
 
  private:
@@ -236,32 +276,43 @@ void runCudaFusionGroup(const Node* fusion_node, Stack& stack) {
       }
     }
 
-    CudaFusionManager::getManager().runFusionNode(
-        kernel_id, graph, inputs, outputs, broadcasted_shape);
+    if (!CudaFusionManager::getManager().runFusionNode(
+            kernel_id, graph, inputs, outputs, broadcasted_shape)) {
+      return false;
+    }
     drop(stack, inputs.size());
     stack.insert(
         stack.end(),
         std::make_move_iterator(outputs.begin()),
         std::make_move_iterator(outputs.end()));
+    return true;
   };
 
-  const char* disable_fb_env = getenv("PYTORCH_CUDA_FUSER_DISABLE_FALLBACK");
-  int disable_fb_flag = disable_fb_env ? atoi(disable_fb_env) : 0;
-  if (disable_fb_flag) {
-    execute_lambda();
+  auto run_fallback = [&]() {
+    EraseShapeInformation(graph);
+    InterpreterState{Code(graph, "fallback_cuda_fuser")}.run(stack);
+  };
+
+  bool executed = false;
+  if (disableFallback()) {
+    executed = execute_lambda();
   } else {
     try {
-      execute_lambda();
+      executed = execute_lambda();
     } catch (...) {
       TORCH_WARN(
           "FALLBACK path is taken. This is an indication that codegen"
           "Failed for some reason. To debug try disable codegen fallback path"
           "via setting the env variable"
           "`export PYTORCH_CUDA_FUSER_DISABLE_FALLBACK=1`");
-      EraseShapeInformation(graph);
-      InterpreterState{Code(graph, "fallback_cuda_fuser")}.run(stack);
+      run_fallback();
+      return;
     }
   }
+  // The kernel isn't compiled yet
+  if (!executed) {
+    run_fallback();
+  }
 }
 
 } // namespace cuda
@@ -12,6 +12,9 @@
  *
  * After compilation, we assign the key to cached kernel as an integer attribute
  * on the node `attr::cache_id`.
+ *
+ * Kernels get compiled with NVRTC on a background thread when a new input
+ * configuration is first run; the fallback runs until they are ready.
  */
 
 namespace torch {
@@ -3,10 +3,12 @@
 #include <torch/csrc/jit/codegen/cuda/arith.h>
 #include <torch/csrc/jit/codegen/cuda/ir_all_nodes.h>
 #include <torch/csrc/jit/codegen/cuda/ir_iostream.h>
+#include <torch/csrc/jit/codegen/cuda/scheduler.h>
 
 #include <torch/csrc/jit/frontend/function_schema_parser.h>
 #include <torch/csrc/jit/ir/constants.h>
 
+#include <algorithm>
 #include <unordered_map>
 #include <utility>
 
@@ -229,56 +231,9 @@ class IrParser {
     }
 
     if (has_reduction) {
-      // Run through outputs, grab all inputs of outputs
-      // squeeze with computeAt to set overall structure.
-      for (auto output : cuda_kernel_->fusion_->outputs()) {
-        if (output->getValType() != ValType::TensorView)
-          continue;
-        TensorView* out_tv = static_cast<TensorView*>(output);
-
-        // fcd_reduction could be queried later via
-        // cuda_kernel_->reduction_axes_, which would ensure we have proper
-        // launch configuratoin.
-        TensorView* intermediate;
-        if (fcd_reduction) {
-          out_tv->split(-1, kFcdReductionThreadX);
-          // necessary to avoid dynamic allocation on intermediates;
-          intermediate = out_tv->rFactor({-2});
-        } else {
-          // TODO: we don't need a full warp here, this should be determined by
-          //       element data type
-          out_tv->split(0, kNonFcdReductionThreadX);
-          out_tv->split(
-              -1, kNonFcdReductionThreadY); // necessary to avoid dynamic
-                                            // allocation on intermediates;
-          intermediate = out_tv->rFactor({-2});
-        }
-        for (Val* inp : cuda_kernel_->fusion_->inputsOf(output)) {
-          // scheduling of inputs shouldn't change with different fcd_reduction
-          if (inp->getValType().value() == ValType::TensorView) {
-            static_cast<TensorView*>(inp)->computeAt(intermediate, -1);
-          }
-        }
-        // scheduling of inputs shouldn't change with different fcd_reduction
-        intermediate->computeAt(out_tv, -2);
-        if (fcd_reduction) {
-          out_tv->axis(0)->parallelize(ParallelType::BIDx);
-        } else {
-          out_tv->axis(0)->parallelize(ParallelType::BIDx);
-          out_tv->axis(1)->parallelize(ParallelType::TIDx);
-        }
-      }
-      // Run through all values, unroll, and bind their axes
-      for (auto val : cuda_kernel_->fusion_->vals()) {
-        if (val->getValType().value() != ValType::TensorView)
-          continue;
-        TensorView* tv = static_cast<TensorView*>(val);
-        if (fcd_reduction) {
-          tv->axis(-1)->parallelize(ParallelType::TIDx);
-        } else {
-          tv->axis(-1)->parallelize(ParallelType::TIDy);
-        }
-      }
+      cuda_kernel_->reduction_params_ = reductionParams(fcd_reduction);
+      scheduleReduction(
+          cuda_kernel_->fusion_.get(), cuda_kernel_->reduction_params_);
     } else {
       // Run through outputs, grab all inputs of outputs
       // squeeze with computeAt to set overall structure.
@@ -312,6 +267,35 @@ class IrParser {
     }
   }
 
+  // Picks the reduction parameters from the size of the reduction input, when
+  // the graph has it.
+  ReductionParams reductionParams(bool fcd_reduction) {
+    const auto reduction_input_type = graph_->block()
+                                          ->outputs()[0]
+                                          ->node()
+                                          ->inputs()[0]
+                                          ->type()
+                                          ->cast<TensorType>();
+    const auto sizes = reduction_input_type
+        ? reduction_input_type->sizes().concrete_sizes()
+        : c10::nullopt;
+    if (!sizes) {
+      return defaultReductionParams(fcd_reduction);
+    }
+    int64_t reduction_size = 1;
+    int64_t num_outputs = 1;
+    const auto& reduction_axes = cuda_kernel_->reduction_axes_;
+    for (size_t i = 0; i < sizes->size(); i++) {
+      if (std::find(reduction_axes.begin(), reduction_axes.end(), (int)i) !=
+          reduction_axes.end()) {
+        reduction_size *= (*sizes)[i];
+      } else {
+        num_outputs *= (*sizes)[i];
+      }
+    }
+    return reductionHeuristic(num_outputs, reduction_size, fcd_reduction);
+  }
+
   static bool canParseNode(const Node* node) {
     if (init_registry_) {
       // TODO: mutex this guy;
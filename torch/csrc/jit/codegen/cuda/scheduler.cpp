@@ -0,0 +1,136 @@
+#include <torch/csrc/jit/codegen/cuda/scheduler.h>
+
+#include <torch/csrc/jit/codegen/cuda/ir_all_nodes.h>
+#include <torch/csrc/jit/codegen/cuda/parser.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cuda {
+
+namespace {
+
+constexpr int kWarpSize = 32;
+// The block reduction keeps a value per thread in the 4KB of shared memory of
+// the kernel, see code_template_block_reduction. 512 threads leave room for
+// doubles.
+constexpr int kMaxThreadsPerBlock = 512;
+// Blocks smaller than this don't hide latency well. With short rows, more
+// rows are packed into a block instead.
+constexpr int kMinThreadsPerBlock = 128;
+// Each thread reduces at least that many elements on its own before the block
+// reduction, which is synchronized and so expensive.
+constexpr int64_t kMinElementsPerThread = 4;
+
+int64_t ceilDiv(int64_t a, int64_t b) {
+  return (a + b - 1) / b;
+}
+
+int nextPow2(int64_t n) {
+  int pow2 = 1;
+  while (pow2 < n && pow2 < kMaxThreadsPerBlock) {
+    pow2 *= 2;
+  }
+  return pow2;
+}
+
+} // namespace
+
+ReductionParams reductionHeuristic(
+    int64_t num_outputs,
+    int64_t reduction_size,
+    bool fastest_dim) {
+  ReductionParams params;
+  params.fastest_dim = fastest_dim;
+  const int threads_for_reduction =
+      nextPow2(ceilDiv(reduction_size, kMinElementsPerThread));
+  if (fastest_dim) {
+    // At least a warp on each row, so that loads are coalesced.
+    params.bdimx =
+        std::max(kWarpSize, std::min(kMaxThreadsPerBlock, threads_for_reduction));
+    params.bdimy = std::max(
+        1, std::min(kMinThreadsPerBlock / params.bdimx, nextPow2(num_outputs)));
+  } else {
+    params.bdimx = std::min(kWarpSize, nextPow2(num_outputs));
+    params.bdimy =
+        std::min(kMaxThreadsPerBlock / params.bdimx, threads_for_reduction);
+  }
+  return params;
+}
+
+ReductionParams defaultReductionParams(bool fastest_dim) {
+  ReductionParams params;
+  params.fastest_dim = fastest_dim;
+  if (fastest_dim) {
+    params.bdimx = kFcdReductionThreadX;
+  } else {
+    params.bdimx = kNonFcdReductionThreadX;
+    params.bdimy = kNonFcdReductionThreadY;
+  }
+  return params;
+}
+
+void scheduleReduction(Fusion* fusion, const ReductionParams& params) {
+  FusionGuard fg(fusion);
+  // Run through outputs, grab all inputs of outputs
+  // squeeze with computeAt to set overall structure.
+  for (auto output : fusion->outputs()) {
+    if (output->getValType() != ValType::TensorView)
+      continue;
+    TensorView* out_tv = static_cast<TensorView*>(output);
+
+    TensorView* intermediate;
+    if (params.fastest_dim) {
+      // [I, R] -> [I/bdimy, bdimy, R/bdimx, bdimx]
+      out_tv->split(-1, params.bdimx);
+      if (params.bdimy > 1) {
+        out_tv->split(0, params.bdimy);
+      }
+      // necessary to avoid dynamic allocation on intermediates;
+      intermediate = out_tv->rFactor({-2});
+    } else {
+      // [I, R] -> [I/bdimx, bdimx, R/bdimy, bdimy]
+      out_tv->split(0, params.bdimx);
+      // necessary to avoid dynamic allocation on intermediates;
+      out_tv->split(-1, params.bdimy);
+      intermediate = out_tv->rFactor({-2});
+    }
+    for (Val* inp : fusion->inputsOf(output)) {
+      // scheduling of inputs shouldn't change with different fcd_reduction
+      if (inp->getValType().value() == ValType::TensorView) {
+        static_cast<TensorView*>(inp)->computeAt(intermediate, -1);
+      }
+    }
+    // scheduling of inputs shouldn't change with different fcd_reduction
+    intermediate->computeAt(out_tv, -2);
+    out_tv->axis(0)->parallelize(ParallelType::BIDx);
+    if (!params.fastest_dim) {
+      out_tv->axis(1)->parallelize(ParallelType::TIDx);
+    }
+  }
+  // Run through all values, unroll, and bind their axes
+  for (auto val : fusion->vals()) {
+    if (val->getValType().value() != ValType::TensorView)
+      continue;
+    TensorView* tv = static_cast<TensorView*>(val);
+    if (params.fastest_dim) {
+      tv->axis(-1)->parallelize(ParallelType::TIDx);
+      if (params.bdimy > 1) {
+        tv->axis(1)->parallelize(ParallelType::TIDy);
+      }
+    } else {
+      tv->axis(-1)->parallelize(ParallelType::TIDy);
+    }
+  }
+}
+
+int64_t reductionGridDim(const ReductionParams& params, int64_t num_outputs) {
+  return ceilDiv(num_outputs, params.fastest_dim ? params.bdimy : params.bdimx);
+}
+
+} // namespace cuda
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <torch/csrc/jit/codegen/cuda/fusion.h>
+
+/*
+ * Scheduling of reduction fusions.
+ *
+ * reductionHeuristic picks the thread block shape from the size of the
+ * problem, scheduleReduction applies it to the fusion: splits, rfactor,
+ * computeAt and parallelization. The launch configuration follows from the
+ * same parameters, see reductionGridDim.
+ */
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cuda {
+
+struct ReductionParams {
+  // Whether the reduction is along the fastest changing dimension (FCD).
+  bool fastest_dim = true;
+  // With fastest_dim, x threads reduce a row together and y threads take
+  // different rows. Otherwise x threads take adjacent outputs, so that loads
+  // are coalesced, and y threads reduce a column together.
+  int bdimx = 1;
+  int bdimy = 1;
+
+  bool operator==(const ReductionParams& other) const {
+    return fastest_dim == other.fastest_dim && bdimx == other.bdimx &&
+        bdimy == other.bdimy;
+  }
+
+  bool operator!=(const ReductionParams& other) const {
+    return !(*this == other);
+  }
+};
+
+// Parameters for num_outputs reductions of reduction_size elements each.
+TORCH_CUDA_API ReductionParams reductionHeuristic(
+    int64_t num_outputs,
+    int64_t reduction_size,
+    bool fastest_dim);
+
+// Parameters used when the problem size isn't known.
+TORCH_CUDA_API ReductionParams defaultReductionParams(bool fastest_dim);
+
+// Schedules the outputs of fusion, which are reductions with all iteration
+// domains merged into axis 0 and all reduction domains merged into axis 1.
+TORCH_CUDA_API void scheduleReduction(
+    Fusion* fusion,
+    const ReductionParams& params);
+
+// Number of blocks to launch for num_outputs reductions scheduled with
+// params.
+TORCH_CUDA_API int64_t
+reductionGridDim(const ReductionParams& params, int64_t num_outputs);
+
+} // namespace cuda
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -10,10 +10,15 @@
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_spec.h>
 #include <torch/csrc/jit/codegen/fuser/tensor_info.h>
+#include <torch/csrc/jit/passes/shape_analysis.h>
+#include <torch/csrc/jit/passes/tensorexpr_fuser.h>
+#include <torch/csrc/jit/tensorexpr/ir_printer.h>
+#include <torch/csrc/jit/tensorexpr/kernel.h>
 
 #include <algorithm>
 #include <iostream> // TODO: remove, debugging only
 #include <map>
+#include <sstream>
 #include <stdexcept>
 #include <tuple>
 #include <vector>
@@ -323,6 +328,64 @@ void launchFusion(
   }
 }
 
+#ifdef TORCH_ENABLE_LLVM
+// Compiles the fusion for the types of the inputs with the tensorexpr LLVM
+// backend, which vectorizes the kernel and runs its outer loops on the intra-op
+// thread pool, instead of the C++ compiler of the CPU backend. Other sizes of
+// the inputs are handled by the specializations of the kernel. Returns null if
+// tensorexpr doesn't implement some node of the fusion, e.g. rand_like or
+// FusedConcat.
+static std::shared_ptr<tensorexpr::TensorExprKernel> compileTensorExprKernel(
+    const KernelSpec& spec,
+    at::ArrayRef<IValue> all_inputs) {
+  for (Node* n : spec.graph()->nodes()) {
+    if (n->kind() != prim::Constant && !tensorexpr::isSupported(n)) {
+      return nullptr;
+    }
+  }
+  auto graph = spec.graph()->copy();
+  for (size_t i = 0; i < all_inputs.size(); i++) {
+    if (all_inputs[i].isTensor()) {
+      graph->inputs()[i]->setType(
+          TensorType::create(all_inputs[i].toTensor()));
+    }
+  }
+  // The kernel takes the dtypes of the intermediates from their types
+  PropagateInputShapes(graph);
+  return std::make_shared<tensorexpr::TensorExprKernel>(graph);
+}
+
+static bool runTensorExprFusion(
+    const KernelSpec& spec,
+    const ArgSpec& arg_spec,
+    Stack& stack,
+    std::string* code_out) {
+  auto maybe_kernel = spec.findTensorExprKernel(arg_spec);
+  if (!maybe_kernel) {
+    spec.cacheTensorExprKernel(
+        arg_spec, compileTensorExprKernel(spec, last(stack, spec.nInputs())));
+    maybe_kernel = spec.findTensorExprKernel(arg_spec);
+  }
+  AT_ASSERT(maybe_kernel);
+  const auto& kernel = *maybe_kernel;
+  if (!kernel) {
+    return false;
+  }
+
+  if (code_out) {
+    std::ostringstream code;
+    if (tensorexpr::Stmt* stmt = kernel->getCodeGenStmt()) {
+      code << *stmt;
+    }
+    *code_out = code.str();
+  }
+
+  // Pops the inputs and pushes the outputs
+  kernel->run(stack);
+  return true;
+}
+#endif // TORCH_ENABLE_LLVM
+
 bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
   // Short-circuits if fusion isn't enabled
   if (!canFuseOnCPU() && !canFuseOnGPU())
@@ -369,6 +432,15 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
   // Tries to run fallback if map size can't be computed
   if (!maybe_map_size)
     return false;
+
+#ifdef TORCH_ENABLE_LLVM
+  // tensorexpr broadcasts the inputs itself, so they aren't expanded
+  if (device.is_cpu()) {
+    return runTensorExprFusion(
+        spec, ArgSpec{inputs, device.index()}, stack, code_out);
+  }
+#endif // TORCH_ENABLE_LLVM
+
   if (spec.hasRandom()) {
     bool hasBroadcast = shouldExpandArgs(spec, inputs, *maybe_map_size);
     if (hasBroadcast)
@@ -18,6 +18,10 @@
 
 namespace torch {
 namespace jit {
+namespace tensorexpr {
+class TensorExprKernel;
+} // namespace tensorexpr
+
 namespace fuser {
 
 // Helper struct containing partition information: the number of tensors
@@ -128,6 +132,23 @@ struct TORCH_API KernelSpec {
     kernels_.emplace(arg_spec, kernel);
   }
 
+  // CPU fusions are compiled in process by tensorexpr, see runFusion. A null
+  // kernel records that tensorexpr doesn't implement the fusion.
+  c10::optional<std::shared_ptr<tensorexpr::TensorExprKernel>>
+  findTensorExprKernel(const ArgSpec& arg_spec) const {
+    std::lock_guard<std::mutex> guard{mutex_};
+    const auto it = te_kernels_.find(arg_spec);
+    if (it == te_kernels_.end())
+      return c10::nullopt;
+    return it->second;
+  }
+  void cacheTensorExprKernel(
+      const ArgSpec& arg_spec,
+      std::shared_ptr<tensorexpr::TensorExprKernel> kernel) const {
+    std::lock_guard<std::mutex> guard{mutex_};
+    te_kernels_.emplace(arg_spec, kernel);
+  }
+
  private:
   int64_t key_;
   std::shared_ptr<Graph> graph_;
@@ -141,6 +162,11 @@ struct TORCH_API KernelSpec {
   mutable std::
       unordered_map<ArgSpec, std::shared_ptr<FusedKernel>, torch::hash<ArgSpec>>
           kernels_;
+  mutable std::unordered_map<
+      ArgSpec,
+      std::shared_ptr<tensorexpr::TensorExprKernel>,
+      torch::hash<ArgSpec>>
+      te_kernels_;
 };
 
 } // namespace fuser
@@ -0,0 +1,296 @@
+#include <torch/csrc/jit/frontend/compilation_cache.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/StringUtil.h>
+#include <torch/csrc/jit/api/function_impl.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/frontend/function_schema_parser.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/jit_log.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <set>
+#include <sstream>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+struct ResolvedName {
+  bool is_type;
+  std::string name;
+  std::string description;
+};
+
+std::string describe(const std::shared_ptr<SugaredValue>& sv) {
+  if (!sv) {
+    return "<none>";
+  }
+  std::stringstream ss;
+  ss << sv->kind();
+  if (auto simple = std::dynamic_pointer_cast<SimpleValue>(sv)) {
+    if (auto ivalue = toIValue(simple->getValue())) {
+      ss << " " << *ivalue;
+    }
+  }
+  return ss.str();
+}
+
+std::string describe(const TypePtr& type) {
+  return type ? type->repr_str() : "<none>";
+}
+
+// Records the names looked up by the emitter, see Note [Compilation cache].
+struct RecordingResolver : public Resolver {
+  explicit RecordingResolver(ResolverPtr resolver)
+      : resolver_(std::move(resolver)) {}
+
+  std::shared_ptr<SugaredValue> resolveValue(
+      const std::string& name,
+      Function& m,
+      const SourceRange& loc) override {
+    auto sv = resolver_->resolveValue(name, m, loc);
+    record(/*is_type=*/false, name, describe(sv));
+    return sv;
+  }
+
+  TypePtr resolveType(const std::string& name, const SourceRange& loc)
+      override {
+    auto type = resolver_->resolveType(name, loc);
+    record(/*is_type=*/true, name, describe(type));
+    return type;
+  }
+
+  const std::vector<ResolvedName>& resolved() const {
+    return resolved_;
+  }
+
+ private:
+  void record(bool is_type, const std::string& name, std::string description) {
+    if (seen_.emplace(is_type, name).second) {
+      resolved_.push_back({is_type, name, std::move(description)});
+    }
+  }
+
+  ResolverPtr resolver_;
+  std::set<std::pair<bool, std::string>> seen_;
+  std::vector<ResolvedName> resolved_;
+};
+
+// Strings are written with their size, so that they can hold anything.
+void writeString(std::ostream& out, const std::string& str) {
+  out << str.size() << '\n' << str;
+}
+
+bool readString(std::istream& in, std::string& str) {
+  size_t size = 0;
+  if (!(in >> size) || in.get() != '\n') {
+    return false;
+  }
+  str.resize(size);
+  return static_cast<bool>(in.read(&str[0], size));
+}
+
+// FNV-1a, which unlike std::hash is the same in every process.
+uint64_t hashString(const std::string& str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : str) {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string cacheKey(const Def& def, const Function& method) {
+  std::stringstream ss;
+  writeString(ss, c10::str(kCompilationCacheVersion));
+  writeString(ss, method.qualname().qualifiedName());
+  writeString(ss, getInlineEverythingMode() ? "inline" : "no inline");
+  writeString(ss, def.range().text());
+  return ss.str();
+}
+
+std::string entryPath(const std::string& key) {
+  std::stringstream ss;
+  ss << getCompilationCacheDir() << "/" << std::hex << std::setw(16)
+     << std::setfill('0') << hashString(key) << ".ir";
+  return ss.str();
+}
+
+bool isCacheable(Block* block) {
+  for (Node* n : block->nodes()) {
+    if (n->callstack() || n->kind() == prim::CallFunction ||
+        n->kind() == prim::CallMethod) {
+      return false;
+    }
+    for (Block* b : n->blocks()) {
+      if (!isCacheable(b)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<Graph> parseGraph(const std::string& str) {
+  auto graph = std::make_shared<Graph>();
+  try {
+    parseIR(str, graph.get());
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+  return graph;
+}
+
+c10::optional<c10::FunctionSchema> parseSchemaString(const std::string& str) {
+  try {
+    return parseSchema(str);
+  } catch (const std::exception&) {
+    return c10::nullopt;
+  }
+}
+
+bool loadEntry(
+    const std::string& key,
+    const Def& def,
+    const ResolverPtr& resolver,
+    Function& method) {
+  std::ifstream in(entryPath(key), std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::string stored_key, schema_str, graph_str, num_resolved_str;
+  if (!readString(in, stored_key) || stored_key != key ||
+      !readString(in, schema_str) || !readString(in, graph_str) ||
+      !readString(in, num_resolved_str)) {
+    return false;
+  }
+  // Resolving may insert constants into the function it is given
+  GraphFunction scratch(
+      method.qualname(), std::make_shared<Graph>(), /*function_creator=*/nullptr);
+  const size_t num_resolved = std::stoul(num_resolved_str);
+  for (size_t i = 0; i < num_resolved; ++i) {
+    std::string is_type, name, description;
+    if (!readString(in, is_type) || !readString(in, name) ||
+        !readString(in, description)) {
+      return false;
+    }
+    const std::string current = is_type == "type"
+        ? describe(resolver->resolveType(name, def.range()))
+        : describe(resolver->resolveValue(name, scratch, def.range()));
+    if (current != description) {
+      GRAPH_DEBUG(
+          "Compilation cache entry of ",
+          method.qualname().qualifiedName(),
+          " is stale, ",
+          name,
+          " now resolves to ",
+          current);
+      return false;
+    }
+  }
+
+  auto graph = parseGraph(graph_str);
+  auto schema = parseSchemaString(schema_str);
+  if (!graph || !schema) {
+    return false;
+  }
+  method.graph()->block()->cloneFrom(graph->block(), [](Value* v) -> Value* {
+    TORCH_INTERNAL_ASSERT(false, "cached graph uses a value not in scope");
+  });
+  method.setSchema(std::move(*schema));
+  GRAPH_UPDATE(
+      "Loaded ", method.qualname().qualifiedName(), " from the compilation cache");
+  return true;
+}
+
+void storeEntry(
+    const std::string& key,
+    const RecordingResolver& resolver,
+    const Function& method) {
+  const auto& graph = method.graph();
+  if (!isCacheable(graph->block())) {
+    return;
+  }
+  const std::string graph_str = graph->toString(/*print_source_locations=*/false);
+  const std::string schema_str = c10::str(method.getSchema());
+  auto parsed_graph = parseGraph(graph_str);
+  auto parsed_schema = parseSchemaString(schema_str);
+  if (!parsed_graph || !parsed_schema ||
+      parsed_graph->toString(/*print_source_locations=*/false) != graph_str ||
+      c10::str(*parsed_schema) != schema_str) {
+    return;
+  }
+
+  std::stringstream entry;
+  writeString(entry, key);
+  writeString(entry, schema_str);
+  writeString(entry, graph_str);
+  writeString(entry, c10::str(resolver.resolved().size()));
+  for (const auto& resolved : resolver.resolved()) {
+    writeString(entry, resolved.is_type ? "type" : "value");
+    writeString(entry, resolved.name);
+    writeString(entry, resolved.description);
+  }
+
+  // Written next to the entry and renamed, so that other processes never see
+  // a partial entry.
+  const std::string path = entryPath(key);
+  const std::string tmp_path =
+      c10::str(path, ".", std::random_device()(), ".tmp");
+  {
+    std::ofstream out(tmp_path, std::ios::binary);
+    if (!out || !(out << entry.str()) || !out.flush()) {
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+} // namespace
+
+std::string& getCompilationCacheDir() {
+  static std::string dir = [] {
+    const char* env = std::getenv("PYTORCH_JIT_COMPILATION_CACHE_DIR");
+    return std::string(env ? env : "");
+  }();
+  return dir;
+}
+
+void emitWithCompilationCache(
+    const Def& def,
+    const ResolverPtr& resolver,
+    Function& method,
+    const std::function<void(const ResolverPtr&)>& emit) {
+  if (getCompilationCacheDir().empty()) {
+    emit(resolver);
+    return;
+  }
+  const std::string key = cacheKey(def, method);
+  bool loaded = false;
+  try {
+    loaded = loadEntry(key, def, resolver, method);
+  } catch (const std::exception& e) {
+    // A corrupted entry, or a name that no longer resolves, the emitter
+    // reports the latter properly.
+    GRAPH_DEBUG("Ignoring the compilation cache entry of ",
+        method.qualname().qualifiedName(), ": ", e.what());
+  }
+  if (loaded) {
+    return;
+  }
+  auto recording = std::make_shared<RecordingResolver>(resolver);
+  emit(recording);
+  storeEntry(key, *recording, method);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/frontend/resolver.h>
+#include <torch/csrc/jit/frontend/tree_views.h>
+
+#include <functional>
+#include <string>
+
+namespace torch {
+namespace jit {
+
+// Note [Compilation cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// The graphs that the IR emitter produces for free functions can be stored on
+// disk, before any optimization, and reused by the next processes that
+// compile the same function. An entry is keyed by a hash of the source of the
+// def, the qualified name of the function, the inline everything mode and
+// kCompilationCacheVersion, which has to be bumped when the emitter changes
+// the graphs it produces.
+//
+// An entry also records every name the emitter looked up through the
+// resolver, with what it resolved to (the kind of the sugared value, the
+// value of constants, or the type). The entry is only used if these names
+// resolve to the same things again, so that changing a global seen by the
+// function invalidates it. Attributes of resolved python modules aren't
+// recorded, a constant read as `module.CONSTANT` isn't tracked.
+//
+// Graphs that call or inline other functions aren't cached, since their
+// graphs depend on the source of the callee, nor are graphs that don't print
+// and parse back to the same graph (e.g. the ones using class types).
+// Cached graphs have no source ranges.
+
+constexpr int64_t kCompilationCacheVersion = 1;
+
+// The directory of the cache, the cache is disabled when it is empty. Defaults
+// to $PYTORCH_JIT_COMPILATION_CACHE_DIR.
+TORCH_API std::string& getCompilationCacheDir();
+
+// Defines `method` from the cache if the cache has an entry for `def`,
+// otherwise runs `emit`, which defines `method` from `def` with the resolver
+// it is given, and stores the result in the cache.
+TORCH_API void emitWithCompilationCache(
+    const Def& def,
+    const ResolverPtr& resolver,
+    Function& method,
+    const std::function<void(const ResolverPtr&)>& emit);
+
+} // namespace jit
+} // namespace torch
@@ -3,6 +3,7 @@
 #include <c10/util/StringUtil.h>
 #include <torch/csrc/jit/api/function_impl.h>
 #include <torch/csrc/jit/frontend/canonicalize_modified_loop.h>
+#include <torch/csrc/jit/frontend/compilation_cache.h>
 #include <torch/csrc/jit/frontend/convert_to_ssa.h>
 #include <torch/csrc/jit/frontend/parser.h>
 #include <torch/csrc/jit/frontend/schema_matching.h>
@@ -3735,7 +3736,15 @@ std::unique_ptr<Function> CompilationUnit::define(
       call_name = atoms.at(atoms.size() - 2) + "." + atoms.at(atoms.size() - 1);
     }
     ErrorReport::CallStack call(call_name, def.range());
-    to_ir(def, _resolver, self, method);
+    if (self) {
+      to_ir(def, _resolver, self, method);
+      return;
+    }
+    // see Note [Compilation cache]
+    emitWithCompilationCache(
+        def, _resolver, method, [&](const ResolverPtr& resolver) {
+          to_ir(def, resolver, self, method);
+        });
   };
   auto name = prefix ? QualifiedName(*prefix, def.name().name())
                      : QualifiedName(def.name().name());
@@ -149,6 +149,7 @@ AliasDb::AliasDb(std::shared_ptr<Graph> graph, bool isFrozen)
       isFrozen_(isFrozen),
       memoryDAGBuilder_(std::make_unique<MemoryDAGBuilder>()),
       writeRegistry_(std::make_unique<AliasDb::WriteRegistry>()) {
+  GRAPH_PASS_TIMER("AliasDb construction");
   analyze(graph_);
 
   memoryDAG_ = std::make_unique<MemoryDAG>(std::move(memoryDAGBuilder_));
@@ -205,6 +206,11 @@ AliasDb::AliasDb(std::shared_ptr<Graph> graph, bool isFrozen)
 
   // initialize the write cache
   writtenToLocationsIndex_ = buildWrittenToLocationsIndex();
+  for (const auto& pr : *writeIndex_) {
+    for (unsigned loc : pr.second) {
+      writesPerLocation_[loc]++;
+    }
+  }
   GRAPH_DEBUG(toString());
 }
 
@@ -491,6 +497,7 @@ void AliasDb::analyzeImpl(Node* node) {
     case prim::FusedConcat:
     case prim::MMTreeReduce:
     case prim::MMBatchSide:
+    case prim::BatchLinear:
     case prim::BroadcastSizes:
     case prim::ChunkSizes:
     case prim::Function:
@@ -1096,6 +1103,22 @@ void AliasDb::replaceWithNewValue(Value* existing, Value* new_value) {
   existing_elem->values = {new_value};
 }
 
+void AliasDb::removeWrites(Node* n) {
+  auto it = writeIndex_->find(n);
+  if (it == writeIndex_->end()) {
+    return;
+  }
+  for (unsigned loc : it->second) {
+    auto count = writesPerLocation_.find(loc);
+    TORCH_INTERNAL_ASSERT(count != writesPerLocation_.end());
+    if (--count->second == 0) {
+      writesPerLocation_.erase(count);
+      writtenToLocationsIndex_->reset(loc);
+    }
+  }
+  writeIndex_->erase(it);
+}
+
 void AliasDb::copyValue(Value* from, Value* to) {
   TORCH_INTERNAL_ASSERT(
       *unshapedType(from->type()) == *unshapedType(to->type()),
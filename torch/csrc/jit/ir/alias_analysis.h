@@ -134,6 +134,9 @@ class AliasDb {
   void copyValue(Value* from, Value* to);
   // Create a new `value` that does not alias anything else.
   void createValue(const Value* value);
+  // Forget the writes of `n`, which is about to be destroyed. This keeps the
+  // write indices up to date without rebuilding them.
+  void removeWrites(Node* n);
 
   friend struct MutationRemover;
 
@@ -256,6 +259,9 @@ class AliasDb {
   // Collection of all memory locations that are written to.
   c10::optional<MemoryLocations> writtenToLocationsIndex_;
   MemoryLocations buildWrittenToLocationsIndex() const;
+  // Number of nodes in the write index that write to each memory location, so
+  // that removeWrites() knows when a location is no longer written to.
+  ska::flat_hash_map<unsigned, size_t> writesPerLocation_;
 
   std::unordered_set<const Value*> wildcards_;
 
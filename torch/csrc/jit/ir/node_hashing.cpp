@@ -16,6 +16,11 @@ namespace jit {
 namespace {
 
 bool tensorEqual(const at::Tensor& lhs, const at::Tensor& rhs) {
+  // MKLDNN tensors don't support equal(), e.g. the weights inserted by
+  // ConvertFrozenOpsToMKLDNN
+  if (lhs.is_mkldnn() || rhs.is_mkldnn()) {
+    return lhs.is_same(rhs);
+  }
   return lhs.options().type_equal(rhs.options()) && lhs.equal(rhs);
 }
 
@@ -1,6 +1,7 @@
 
 #include <cstdlib>
 #include <iomanip>
+#include <iostream>
 #include <sstream>
 #include <vector>
 
@@ -71,6 +72,29 @@ bool is_enabled(const char* cfname, JitLoggingLevels level) {
   return level <= static_cast<JitLoggingLevels>(it->second);
 }
 
+JitPassTimer::JitPassTimer(const char* pass_name, const char* fn, int l)
+    : pass_name_(pass_name),
+      fn_(fn),
+      l_(l),
+      enabled_(is_enabled(fn, JitLoggingLevels::GRAPH_DUMP)) {
+  if (enabled_) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+JitPassTimer::~JitPassTimer() {
+  if (!enabled_) {
+    return;
+  }
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start_;
+  std::cerr << jit_log_prefix(
+      JitLoggingLevels::GRAPH_DUMP,
+      fn_,
+      l_,
+      c10::str(pass_name_, " took ", elapsed.count(), " ms"));
+}
+
 // Unfortunately, in `GraphExecutor` where `log_function` is invoked
 // we won't have access to an original function, so we have to construct
 // a dummy function to give to PythonPrint
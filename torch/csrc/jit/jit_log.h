@@ -1,5 +1,7 @@
 #pragma once
+#include <c10/macros/Macros.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -35,6 +37,9 @@
 // `GRAPH_DEBUG` as there is no logging level that is
 // higher than `GRAPH_DEBUG`.
 
+// `GRAPH_PASS_TIMER` reports the time a pass takes at the `GRAPH_DUMP` level,
+// e.g. `PYTORCH_JIT_LOG_LEVEL=constant_pooling:remove_mutation`.
+
 namespace torch {
 namespace jit {
 
@@ -97,5 +102,24 @@ TORCH_API std::ostream& operator<<(
 // pass
 #define GRAPH_DEBUG(...) \
   JIT_LOG(::torch::jit::JitLoggingLevels::GRAPH_DEBUG, __VA_ARGS__);
+
+// Logs the time from its construction to its destruction if logging is
+// enabled for `fn`.
+struct TORCH_API JitPassTimer {
+  JitPassTimer(const char* pass_name, const char* fn, int l);
+  ~JitPassTimer();
+
+ private:
+  const char* pass_name_;
+  const char* fn_;
+  int l_;
+  bool enabled_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// use GRAPH_PASS_TIMER at the beginning of a pass to report how long it takes
+#define GRAPH_PASS_TIMER(NAME)                                    \
+  ::torch::jit::JitPassTimer C10_ANONYMOUS_VARIABLE(jit_pass_timer)( \
+      NAME, __FILE__, __LINE__);
 } // namespace jit
 } // namespace torch
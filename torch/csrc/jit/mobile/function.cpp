@@ -35,21 +35,23 @@ bool Function::append_operator(
   auto opname = code_->op_names_.back();
 
   auto opname_c10 = opname;
-  std::function<void(Stack&)> fn;
+  Operation fn;
 
+  // Resolve the operation once here rather than on every call, which for a
+  // JIT operator would copy its Operation out of the registry each time.
   auto jit_op = findOperatorFor(opname);
   if (jit_op) {
-    fn = [jit_op](Stack& stack) { jit_op->getOperation()(&stack); };
+    fn = jit_op->getOperation();
   } else {
     auto op = c10::Dispatcher::singleton().findSchema(opname_c10);
     if (op.has_value()) {
-      fn = [op](Stack& stack) { op->callBoxed(&stack); };
+      fn = [op](Stack* stack) { op->callBoxed(stack); };
     } else {
       return false;
     }
   }
 
-  code_->operators_.emplace_back(fn);
+  code_->operators_.emplace_back(std::move(fn));
   return true;
 }
 
@@ -65,7 +67,23 @@ void Function::set_register_size(size_t size) {
   code_->register_size_ = size;
 }
 
-bool Function::run(Stack& stack) const {
+void Function::set_initializer(std::function<void(Function&)> initializer) {
+  initializer_ = std::move(initializer);
+}
+
+bool Function::run(Stack& stack) {
+  if (initializer_) {
+    std::call_once(initialized_, [this]() {
+      try {
+        initializer_(*this);
+      } catch (...) {
+        // Don't leave a partially initialized function behind; call_once
+        // runs the initializer again on the next run.
+        code_ = std::make_shared<Code>();
+        throw;
+      }
+    });
+  }
   InterpreterState interp_state(code_);
   return interp_state.run(stack);
 }
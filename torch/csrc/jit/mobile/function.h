@@ -1,6 +1,8 @@
 #pragma once
 #include <ATen/core/ivalue.h>
 //#include <aten/src/Aten/core/operator_name.h>
+#include <functional>
+#include <mutex>
 #include <vector>
 
 namespace torch {
@@ -14,7 +16,7 @@ struct Code;
 class Function {
  public:
   Function(c10::QualifiedName name);
-  bool run(Stack& stack) const;
+  bool run(Stack& stack);
   const std::string& name() const;
   const c10::QualifiedName& qualname() const;
   void append_instruction(OpCode op, int X, int N);
@@ -26,9 +28,16 @@ class Function {
 
   void set_register_size(size_t size);
 
+  // Defers appending the instructions, operators, constants and types of the
+  // function to its first run, so that the methods of a module that are never
+  // called don't pay for resolving their operators and parsing their types.
+  void set_initializer(std::function<void(Function&)> initializer);
+
  private:
   c10::QualifiedName name_;
   std::shared_ptr<Code> code_;
+  std::function<void(Function&)> initializer_;
+  std::once_flag initialized_;
 };
 
 } // namespace mobile
@@ -81,6 +81,66 @@ void print_unsupported_ops_and_throw(
   TORCH_CHECK(false, "Following ops cannot be found:", error_message);
 }
 
+void parseMethod(
+    const std::string& function_name,
+    const IValue& table,
+    mobile::Function& function) {
+  const auto& ins_list =
+      expect_field(table, "instructions", BYTECODE_INDEX_INSTRUCTION)
+          .toTuple()
+          ->elements();
+  const auto& ops_list =
+      expect_field(table, "operators", BYTECODE_INDEX_OPERATOR)
+          .toTuple()
+          ->elements();
+  const auto& consts_list =
+      expect_field(table, "constants", BYTECODE_INDEX_CONSTANT)
+          .toTuple()
+          ->elements();
+  const auto& types_list =
+      expect_field(table, "types", BYTECODE_INDEX_TYPE).toTuple()->elements();
+  const auto& register_size = expect_field(table, "register_size", 4).toInt();
+
+  for (const auto& ins : ins_list) {
+    auto ins_item = ins.toTuple()->elements();
+    TORCH_CHECK(
+        ins_item.size() == 3,
+        "There should be three parts in an instruction. The function name is ",
+        function_name);
+    OpCode op_code = parseOpCode(ins_item[0].toString()->string().c_str());
+    int X = ins_item[1].toInt();
+    int N = ins_item[2].toInt();
+    function.append_instruction(op_code, X, N);
+  }
+
+  std::unordered_set<std::string> unsupported_op_names;
+  for (const auto& op : ops_list) {
+    auto op_item = op.toTuple()->elements();
+    TORCH_CHECK(
+        op_item.size() == 2,
+        "There should be two parts in an operator name.");
+    auto op_found = function.append_operator(
+        op_item[0].toString()->string(), op_item[1].toString()->string());
+    if (!op_found) {
+      unsupported_op_names.emplace(operator_str(
+          op_item[0].toString()->string(), op_item[1].toString()->string()));
+    }
+  }
+  if (!unsupported_op_names.empty()) {
+    print_unsupported_ops_and_throw(unsupported_op_names);
+  };
+
+  for (const auto& constant : consts_list) {
+    function.append_constant(constant);
+  }
+
+  for (const auto& t : types_list) {
+    function.append_type(c10::parseType(t.toStringRef()));
+  }
+
+  function.set_register_size(register_size);
+}
+
 void parseMethods(
     const std::vector<IValue>& vals,
     mobile::CompilationUnit& mcu) {
@@ -110,62 +170,12 @@ void parseMethods(
 
     auto function = std::unique_ptr<mobile::Function>(
         new mobile::Function(c10::QualifiedName(function_name)));
-
-    const auto& ins_list =
-        expect_field(table, "instructions", BYTECODE_INDEX_INSTRUCTION)
-            .toTuple()
-            ->elements();
-    const auto& ops_list =
-        expect_field(table, "operators", BYTECODE_INDEX_OPERATOR)
-            .toTuple()
-            ->elements();
-    const auto& consts_list =
-        expect_field(table, "constants", BYTECODE_INDEX_CONSTANT)
-            .toTuple()
-            ->elements();
-    const auto& types_list =
-        expect_field(table, "types", BYTECODE_INDEX_TYPE).toTuple()->elements();
-    const auto& register_size = expect_field(table, "register_size", 4).toInt();
-
-    for (const auto& ins : ins_list) {
-      auto ins_item = ins.toTuple()->elements();
-      TORCH_CHECK(
-          ins_item.size() == 3,
-          "There should be three parts in an instruction. The function name is ",
-          function_name);
-      OpCode op_code = parseOpCode(ins_item[0].toString()->string().c_str());
-      int X = ins_item[1].toInt();
-      int N = ins_item[2].toInt();
-      function->append_instruction(op_code, X, N);
-    }
-
-    std::unordered_set<std::string> unsupported_op_names;
-    for (const auto& op : ops_list) {
-      auto op_item = op.toTuple()->elements();
-      TORCH_CHECK(
-          op_item.size() == 2,
-          "There should be two parts in an operator name.");
-      auto op_found = function->append_operator(
-          op_item[0].toString()->string(), op_item[1].toString()->string());
-      if (!op_found) {
-        unsupported_op_names.emplace(operator_str(
-            op_item[0].toString()->string(), op_item[1].toString()->string()));
-      }
-    }
-    if (!unsupported_op_names.empty()) {
-      print_unsupported_ops_and_throw(unsupported_op_names);
-    };
-
-    for (const auto& constant : consts_list) {
-      function->append_constant(constant);
-    }
-
-    for (const auto& t : types_list) {
-      function->append_type(c10::parseType(t.toStringRef()));
-    }
-
-    function->set_register_size(register_size);
-
+    // The bytecode of the method is only decoded, and its operators resolved,
+    // the first time it runs.
+    function->set_initializer(
+        [function_name, table](mobile::Function& fn) {
+          parseMethod(function_name, table, fn);
+        });
     mcu.register_function(std::move(function));
   }
 }
@@ -6,8 +6,11 @@
 #include <torch/csrc/jit/runtime/vararg_functions.h>
 
 #include <ATen/record_function.h>
+#include <c10/core/CPUAllocator.h>
 #include <torch/csrc/jit/mobile/observer.h>
 
+#include <chrono>
+
 namespace torch {
 namespace jit {
 char const* toString(OpCode op);
@@ -20,6 +23,59 @@ InterpreterState::InterpreterState(std::shared_ptr<Code> code)
 
 using namespace at;
 
+namespace {
+
+// Whether to sample the op about to run, see
+// MobileObserverConfig::setOpSamplingPeriod
+bool sampleOp() {
+  const uint32_t sampling_period =
+      torch::observerConfig().getOpSamplingPeriod();
+  if (C10_LIKELY(sampling_period == 0)) {
+    return false;
+  }
+  thread_local uint32_t ops_until_sample = 0;
+  if (ops_until_sample > 0) {
+    --ops_until_sample;
+    return false;
+  }
+  ops_until_sample = sampling_period - 1;
+  return true;
+}
+
+void runOp(Code& code, size_t op_idx, size_t pc, Stack& stack) {
+  // Without any callback, there is nothing to record and the op can be
+  // called right away, which matters for small models where the
+  // overhead of each op is a large share of their run time.
+  if (!at::hasCallbacks()) {
+    code.operators_[op_idx](&stack);
+    return;
+  }
+  if (at::hasGlobalCallbacks()) {
+    if (auto debug_info = c10::ThreadLocalDebugInfo::get(
+            c10::DebugInfoKind::MOBILE_RUNTIME_INFO)) {
+      if (auto* mobile_debug_info =
+              dynamic_cast<MobileDebugInfo*>(debug_info.get())) {
+        mobile_debug_info->setOpIdx(pc);
+      }
+    }
+  }
+
+  // TODO(iliacher): remove the workaround after RecordFunction is in
+  // Dispatcher
+  bool prev_value = isRecordFunctionEnabled();
+  if (!prev_value) {
+    // enable only for the RecordFunction
+    enableRecordFunction(true);
+  }
+  RECORD_FUNCTION(code.op_names_[op_idx].name, stack);
+  if (!prev_value) {
+    enableRecordFunction(false);
+  }
+  code.operators_[op_idx](&stack);
+}
+
+} // namespace
+
 bool InterpreterState::run(Stack& stack) {
   size_t pc = 0;
   while (true) {
@@ -35,33 +91,29 @@ bool InterpreterState::run(Stack& stack) {
     //    std::cout << std::endl;
     switch (inst.op) {
       case OP: {
-        if (at::hasGlobalCallbacks()) {
-          if (auto debug_info = c10::ThreadLocalDebugInfo::get(
-                  c10::DebugInfoKind::MOBILE_RUNTIME_INFO)) {
-            if (auto* mobile_debug_info =
-                    dynamic_cast<MobileDebugInfo*>(debug_info.get())) {
-              mobile_debug_info->setOpIdx(pc);
-            }
-          }
-        }
-
-        // TODO(iliacher): remove the workaround after RecordFunction is in
-        // Dispatcher
-        bool prev_value = isRecordFunctionEnabled();
-        if (!prev_value) {
-          // enable only for the RecordFunction
-          enableRecordFunction(true);
-        }
-        RECORD_FUNCTION(code_->op_names_[inst.X].name, stack);
-        if (!prev_value) {
-          enableRecordFunction(false);
+        if (C10_UNLIKELY(sampleOp())) {
+          const auto allocations = c10::thread_cpu_allocation_counters();
+          const auto start = std::chrono::steady_clock::now();
+          runOp(*code_, inst.X, pc, stack);
+          const auto latency = std::chrono::steady_clock::now() - start;
+          const auto allocations_after = c10::thread_cpu_allocation_counters();
+          const auto& op_name = code_->op_names_[inst.X];
+          torch::observerConfig().getOpStats().record(
+              op_name.overload_name.empty()
+                  ? op_name.name
+                  : op_name.name + "." + op_name.overload_name,
+              std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+                  .count(),
+              allocations_after.num_allocations - allocations.num_allocations,
+              allocations_after.allocated_bytes - allocations.allocated_bytes);
+        } else {
+          runOp(*code_, inst.X, pc, stack);
         }
-        code_->operators_[inst.X](stack);
         ++pc;
       } break;
       case OPN: {
         stack.push_back(inst.N);
-        code_->operators_[inst.X](stack);
+        code_->operators_[inst.X](&stack);
         ++pc;
       } break;
       case INTERFACE_CALL: {
@@ -2,6 +2,7 @@
 #include <ATen/core/dispatch/Dispatcher.h>
 #include <ATen/core/ivalue.h>
 #include <ATen/core/operator_name.h>
+#include <ATen/core/stack.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 
 namespace torch {
@@ -11,7 +12,8 @@ using Stack = std::vector<c10::IValue>;
 struct Code {
   std::vector<Instruction> instructions_;
   std::vector<c10::OperatorName> op_names_;
-  std::vector<std::function<void(Stack&)>> operators_;
+  // The operations of op_names_, resolved when the function is loaded.
+  std::vector<Operation> operators_;
   std::vector<c10::IValue> constants_;
   std::vector<c10::TypePtr> types_;
   size_t register_size_; // Aggregated output size.
@@ -1,7 +1,60 @@
 #include <torch/csrc/jit/mobile/observer.h>
 
+#include <sstream>
+
 namespace torch {
 
+constexpr size_t MobileOpStats::kNumLatencyBuckets;
+
+void MobileOpStats::record(
+    const std::string& op_name,
+    uint64_t latency_ns,
+    uint64_t num_allocations,
+    uint64_t allocated_bytes) {
+  const uint64_t latency_us = latency_ns / 1000;
+  size_t bucket = 0;
+  while (bucket + 1 < kNumLatencyBuckets && (latency_us >> (bucket + 1))) {
+    ++bucket;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  OpStats& stats = stats_[op_name];
+  ++stats.num_samples;
+  stats.total_latency_ns += latency_ns;
+  ++stats.latency_histogram[bucket];
+  stats.num_allocations += num_allocations;
+  stats.allocated_bytes += allocated_bytes;
+}
+
+std::unordered_map<std::string, MobileOpStats::OpStats> MobileOpStats::
+    getStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+std::string MobileOpStats::serialize() const {
+  std::ostringstream out;
+  for (const auto& entry : getStats()) {
+    const OpStats& stats = entry.second;
+    out << entry.first << " " << stats.num_samples << " "
+        << stats.total_latency_ns << " " << stats.num_allocations << " "
+        << stats.allocated_bytes;
+    size_t num_buckets = kNumLatencyBuckets;
+    while (num_buckets > 0 && stats.latency_histogram[num_buckets - 1] == 0) {
+      --num_buckets;
+    }
+    for (size_t bucket = 0; bucket < num_buckets; ++bucket) {
+      out << " " << stats.latency_histogram[bucket];
+    }
+    out << "\n";
+  }
+  return out.str();
+}
+
+void MobileOpStats::reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  stats_.clear();
+}
+
 MobileObserverConfig& observerConfig() {
   static MobileObserverConfig instance;
   return instance;
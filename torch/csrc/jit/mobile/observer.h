@@ -1,7 +1,12 @@
 #pragma once
 
 #include <c10/util/ThreadLocalDebugInfo.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace torch {
 
@@ -52,6 +57,47 @@ class MobileModuleObserver {
   virtual void onFailLoadModel(const std::string&) {}
 };
 
+// Latency and allocations of the ops run by the lite interpreter, aggregated
+// by op over the sampled runs of the ops, see
+// MobileObserverConfig::setOpSamplingPeriod.
+class MobileOpStats {
+ public:
+  // Bucket i of the latency histogram counts the samples that took
+  // [2^i, 2^(i+1)) microseconds, except the first bucket, which starts at 0,
+  // and the last one, which has no upper bound.
+  static constexpr size_t kNumLatencyBuckets = 16;
+
+  struct OpStats {
+    uint64_t num_samples = 0;
+    uint64_t total_latency_ns = 0;
+    std::array<uint32_t, kNumLatencyBuckets> latency_histogram{};
+    // CPU allocations made by the sampled runs of the op
+    uint64_t num_allocations = 0;
+    uint64_t allocated_bytes = 0;
+  };
+
+  void record(
+      const std::string& op_name,
+      uint64_t latency_ns,
+      uint64_t num_allocations,
+      uint64_t allocated_bytes);
+
+  // The statistics of every op sampled since the last reset, keyed by the
+  // op name and its overload name, as in "aten::add.Tensor"
+  std::unordered_map<std::string, OpStats> getStats() const;
+
+  // A compact text form of getStats() to upload, one line per op:
+  // <op> <samples> <total ns> <allocations> <bytes> <histogram buckets>...
+  // where the histogram only lists its buckets up to the last nonzero one.
+  std::string serialize() const;
+
+  void reset();
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, OpStats> stats_;
+};
+
 class MobileObserverConfig {
  public:
   void setModuleObserver(std::unique_ptr<MobileModuleObserver> reporter) {
@@ -61,8 +107,23 @@ class MobileObserverConfig {
     return module_observer_.get();
   }
 
+  // Times, and counts the allocations of, one op out of every
+  // sampling_period ops run by the lite interpreter on each thread, into
+  // getOpStats(). 0, the default, disables the sampling.
+  void setOpSamplingPeriod(uint32_t sampling_period) {
+    op_sampling_period_.store(sampling_period, std::memory_order_relaxed);
+  }
+  uint32_t getOpSamplingPeriod() const {
+    return op_sampling_period_.load(std::memory_order_relaxed);
+  }
+  MobileOpStats& getOpStats() {
+    return op_stats_;
+  }
+
  private:
   std::unique_ptr<MobileModuleObserver> module_observer_;
+  std::atomic<uint32_t> op_sampling_period_{0};
+  MobileOpStats op_stats_;
 };
 
 MobileObserverConfig& observerConfig();
@@ -309,6 +309,16 @@ void BatchMMTreeReduce(Block* block) {
   }
 }
 
+// Whether matrices can be concatenated along dim, i.e. have the same size
+// along the other one; they don't need to have the same shape.
+bool can_cat_matrices(at::TensorList inputs, int64_t dim) {
+  const int64_t other_dim = 1 - dim;
+  const int64_t expected_size = inputs[0].size(other_dim);
+  return std::all_of(inputs.begin(), inputs.end(), [&](const at::Tensor& t) {
+    return t.dim() == 2 && t.size(other_dim) == expected_size;
+  });
+}
+
 bool shape_is_fast_for_side(const at::Tensor& other_side_input) {
   // Cutoff chosed by benchmarking on a TITAN V
   return other_side_input.numel() <= 1024 * 2048;
@@ -330,18 +340,18 @@ RegisterOperators mm_batch_side_reg({Operator(
         drop(stack, num_other_side_inputs);
         pop(stack, side_input);
 
-        auto any_other_input = other_side_inputs[0];
-        if (have_same_shape(other_side_inputs) &&
+        const int64_t cat_dim = single_side == Side::LHS ? 1 : 0;
+        if (can_cat_matrices(other_side_inputs, cat_dim) &&
             shape_is_fast_for_side(other_side_inputs[0])) {
-          auto other_side_input =
-              at::cat(other_side_inputs, single_side == Side::LHS ? 1 : 0);
+          auto other_side_input = at::cat(other_side_inputs, cat_dim);
           auto mm_out = single_side == Side::LHS
               ? side_input.mm(other_side_input)
               : other_side_input.mm(side_input);
-          auto outputs = at::chunk(
-              mm_out,
-              num_other_side_inputs,
-              /*dim=*/single_side == Side::LHS ? 1 : 0);
+          auto outputs = mm_out.split_with_sizes(
+              fmap(
+                  other_side_inputs,
+                  [cat_dim](const at::Tensor& t) { return t.size(cat_dim); }),
+              cat_dim);
           stack->insert(
               stack->end(),
               std::make_move_iterator(outputs.begin()),
@@ -361,33 +371,33 @@ RegisterOperators mm_batch_side_reg({Operator(
     },
     aliasAnalysisIsSpecialCase())});
 
-std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
-    Value* value,
+// Filters out the nodes that depend on an earlier one, so that the remaining
+// ones can be moved next to each other. This algorithm might do very badly if
+// e.g. you have a lot of independent nodes, that depend on the first one, but
+// I doubt this will be a common scenario.
+std::vector<Node*> filterIndependent(
+    std::vector<Node*> nodes,
     AliasDb& alias_db) {
-  const auto postprocess = [&](std::vector<Node*> mms) {
-    if (mms.size() == 0) {
-      return mms;
-    }
-    std::sort(mms.begin(), mms.end(), [](Node* n, Node* m) {
-      return n->isBefore(m);
-    });
-    // Filter out dependent MMs. This algorithm might do very badly if e.g. you
-    // have a lot of independent MMs, that depend on the first one, but I doubt
-    // this will be a common scenario.
-    for (size_t i = 0; i < mms.size(); ++i) {
-      if (mms[i] == nullptr)
+  std::sort(nodes.begin(), nodes.end(), [](Node* n, Node* m) {
+    return n->isBefore(m);
+  });
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i] == nullptr)
+      continue;
+    for (size_t j = i + 1; j < nodes.size(); ++j) {
+      if (nodes[j] == nullptr)
         continue;
-      for (size_t j = i + 1; j < mms.size(); ++j) {
-        if (mms[j] == nullptr)
-          continue;
-        if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
-          mms[j] = nullptr;
-        }
+      if (!alias_db.couldMoveBeforeTopologically(nodes[j], nodes[i])) {
+        nodes[j] = nullptr;
       }
     }
-    return c10::filter(mms, [](Node* n) { return n != nullptr; });
-  };
+  }
+  return c10::filter(nodes, [](Node* n) { return n != nullptr; });
+}
 
+std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
+    Value* value,
+    AliasDb& alias_db) {
   Block* block = value->node()->owningBlock();
   std::vector<Node*> lhses; // Will contain nodes where value is used as an lhs
   std::vector<Node*> rhses; // Like above, but rhs
@@ -401,7 +411,9 @@ std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
       }
     }
   }
-  return std::make_pair(postprocess(lhses), postprocess(rhses));
+  return std::make_pair(
+      filterIndependent(std::move(lhses), alias_db),
+      filterIndependent(std::move(rhses), alias_db));
 }
 
 void BatchMMSide(Block* block, AliasDb& alias_db) {
@@ -452,6 +464,194 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+// Linear layers sharing their input, e.g. the heads of multi-head attention or
+// the towers of a multi-tower model, are batched into a single linear layer
+// whose weight and bias are the concatenation of theirs (along the output
+// features), and whose output is split into theirs. Unlike the MMs batched by
+// BatchMMSide, their weights usually have different numbers of output
+// features.
+//
+// An aten::addmm with a beta and an alpha of 1 is the linear layer whose
+// weight is its transposed mat2; as mat2 is usually the transposed weight of
+// a layer, the transposes cancel out in the peephole optimization run at the
+// end of BatchMM.
+
+// Tunable parameter. Lower than how_many_is_many of BatchMMSide, since there
+// are usually only a handful of heads or towers.
+static constexpr size_t min_linear_batch_size = 3;
+
+// Whether the weights and biases of linear layers can be concatenated into
+// those of a single one: the weights must be matrices with the same number of
+// input features, and the biases either all missing or all vectors of the
+// numbers of output features of their layers.
+bool can_batch_linear(at::TensorList weights, at::TensorList biases) {
+  const bool has_bias = biases[0].defined();
+  for (size_t i = 0; i < weights.size(); ++i) {
+    const at::Tensor& weight = weights[i];
+    const at::Tensor& bias = biases[i];
+    if (weight.dim() != 2 || weight.size(1) != weights[0].size(1) ||
+        weight.scalar_type() != weights[0].scalar_type() ||
+        weight.device() != weights[0].device() ||
+        bias.defined() != has_bias) {
+      return false;
+    }
+    if (has_bias &&
+        (bias.dim() != 1 || bias.size(0) != weight.size(0) ||
+         bias.scalar_type() != weight.scalar_type() ||
+         bias.device() != weight.device())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RegisterOperators batch_linear_reg({Operator(
+    prim::BatchLinear,
+    [](const Node* node) -> Operation {
+      size_t num_linears = (node->inputs().size() - 1) / 2;
+      return [num_linears](Stack* stack) {
+        std::vector<at::Tensor> weights;
+        std::vector<at::Tensor> biases;
+        weights.reserve(num_linears);
+        biases.reserve(num_linears);
+        auto it = stack->end() - 2 * num_linears;
+        for (size_t i = 0; i < num_linears; ++i, ++it) {
+          weights.push_back(std::move(*it).toTensor());
+        }
+        for (size_t i = 0; i < num_linears; ++i, ++it) {
+          biases.push_back(
+              it->isNone() ? at::Tensor() : std::move(*it).toTensor());
+        }
+        drop(stack, 2 * num_linears);
+        at::Tensor input;
+        pop(stack, input);
+
+        if (can_batch_linear(weights, biases)) {
+          auto bias = biases[0].defined() ? at::cat(biases, /*dim=*/0)
+                                          : at::Tensor();
+          auto out = at::linear(input, at::cat(weights, /*dim=*/0), bias);
+          auto outputs = out.split_with_sizes(
+              fmap(weights, [](const at::Tensor& w) { return w.size(0); }),
+              /*dim=*/-1);
+          stack->insert(
+              stack->end(),
+              std::make_move_iterator(outputs.begin()),
+              std::make_move_iterator(outputs.end()));
+        } else {
+          for (size_t i = 0; i < num_linears; ++i) {
+            stack->emplace_back(at::linear(input, weights[i], biases[i]));
+          }
+        }
+      };
+    },
+    aliasAnalysisIsSpecialCase())});
+
+bool isLinear(Node* node) {
+  return node->matches(
+      "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor");
+}
+
+bool isBatchableLinear(Node* node) {
+  if (isLinear(node)) {
+    return true;
+  }
+  if (!node->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor")) {
+    return false;
+  }
+  auto beta = node->get<at::Scalar>(attr::beta);
+  auto alpha = node->get<at::Scalar>(attr::alpha);
+  return beta && alpha && beta->toDouble() == 1.0 && alpha->toDouble() == 1.0;
+}
+
+Value* linearInput(Node* linear) {
+  return linear->inputs().at(isLinear(linear) ? 0 : 1);
+}
+
+std::vector<Node*> gatherIndependentLinearUses(
+    Value* value,
+    AliasDb& alias_db) {
+  Block* block = value->node()->owningBlock();
+  std::vector<Node*> linears;
+  for (Use u : value->uses()) {
+    if (u.user->owningBlock() == block && isBatchableLinear(u.user) &&
+        u.offset == (isLinear(u.user) ? 0 : 1)) {
+      linears.push_back(u.user);
+    }
+  }
+  return filterIndependent(std::move(linears), alias_db);
+}
+
+void gatherLinearBatches(
+    Block* block,
+    AliasDb& alias_db,
+    std::vector<std::vector<Node*>>& batches) {
+  std::unordered_set<Value*> considered_values;
+  for (Node* node : block->nodes()) {
+    if (isBatchableLinear(node)) {
+      Value* input = linearInput(node);
+      if (/*bool not_inserted = */ !considered_values.emplace(input).second) {
+        continue;
+      }
+      auto linears = gatherIndependentLinearUses(input, alias_db);
+      if (linears.size() >= min_linear_batch_size) {
+        batches.push_back(std::move(linears));
+      }
+    } else {
+      for (Block* subblock : node->blocks()) {
+        gatherLinearBatches(subblock, alias_db, batches);
+      }
+    }
+  }
+}
+
+void BatchLinearSide(Block* block, AliasDb& alias_db) {
+  // The batches are all gathered, and their linear layers moved next to each
+  // other, before any of them is replaced, since alias_db doesn't know about
+  // the nodes inserted for the replacements.
+  std::vector<std::vector<Node*>> batches;
+  gatherLinearBatches(block, alias_db, batches);
+  for (auto& linears : batches) {
+    for (int64_t i = static_cast<int64_t>(linears.size()) - 2; i >= 0; --i) {
+      bool move_ok =
+          alias_db.moveBeforeTopologicallyValid(linears[i], linears[i + 1]);
+      AT_ASSERT(move_ok);
+    }
+  }
+
+  for (auto& linears : batches) {
+    WithInsertPoint insert_guard{linears[0]};
+    Graph* graph = linears[0]->owningGraph();
+    std::vector<Value*> weights;
+    std::vector<Value*> biases;
+    for (Node* linear : linears) {
+      if (isLinear(linear)) {
+        weights.push_back(linear->inputs().at(1));
+        biases.push_back(linear->inputs().at(2));
+      } else {
+        weights.push_back(graph->insert(aten::t, {linear->inputs().at(2)}));
+        biases.push_back(linear->inputs().at(0));
+      }
+    }
+    Node* batch_linear = graph->create(
+        prim::BatchLinear,
+        /*inputs=*/{},
+        /*num_outputs=*/linears.size());
+    graph->insertNode(batch_linear);
+    batch_linear->addInput(linearInput(linears[0]));
+    for (Value* weight : weights) {
+      batch_linear->addInput(weight);
+    }
+    for (Value* bias : biases) {
+      batch_linear->addInput(bias);
+    }
+    for (size_t i = 0; i < linears.size(); ++i) {
+      batch_linear->outputs().at(i)->setType(linears[i]->output()->type());
+      linears[i]->output()->replaceAllUsesWith(batch_linear->outputs().at(i));
+    }
+  }
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -472,6 +672,9 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
   AliasDb alias_db(graph);
   BatchMMTreeReduce(graph->block());
   BatchMMSide(graph->block(), alias_db);
+  // alias_db doesn't know about the nodes inserted by BatchMMSide.
+  AliasDb linear_alias_db(graph);
+  BatchLinearSide(graph->block(), linear_alias_db);
   EliminateDeadCode(graph);
   // It's possible that transpose rearrangements have created sequences of
   // consecutive transposes that didn't exist before.
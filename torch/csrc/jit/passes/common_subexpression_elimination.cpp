@@ -88,8 +88,9 @@ void EliminateCommonSubexpression(
 } // namespace
 
 void EliminateCommonSubexpression(const std::shared_ptr<Graph>& graph) {
-  AliasDb aliasDb(graph);
   GRAPH_DUMP("Before CSE", graph);
+  GRAPH_PASS_TIMER("EliminateCommonSubexpression");
+  AliasDb aliasDb(graph);
   EliminateCommonSubexpression(
       graph->block(), aliasDb, [](Node*) { return nullptr; });
 }
@@ -3,6 +3,8 @@
 #include <torch/csrc/jit/ir/alias_analysis.h>
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/ir/node_hashing.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/utils/memory.h>
 #include <unordered_set>
 
 namespace torch {
@@ -12,10 +14,13 @@ namespace {
 
 // Very similar to the common subexpression elimination pass
 // Move all constants to the beginning of the graph, and deduplicate
+// The AliasDb is built on the first duplicate of a mutable type, most graphs
+// don't have any and building it is expensive on large graphs.
 void ConstantPooling(
     Block* block,
     std::unordered_set<Node*, HashNode, EqualNode>& constants,
-    const AliasDb& aliasDb) {
+    const std::shared_ptr<Graph>& graph,
+    std::unique_ptr<AliasDb>& aliasDb) {
   for (auto it = block->nodes().begin(); it != block->nodes().end();) {
     auto node = *it;
     // node may be moved to a different block so advance iterator now
@@ -23,7 +28,7 @@ void ConstantPooling(
     if (!node->blocks().empty()) {
       // Traverse sub-blocks.
       for (auto block : node->blocks()) {
-        ConstantPooling(block, constants, aliasDb);
+        ConstantPooling(block, constants, graph, aliasDb);
       }
       continue;
     }
@@ -45,10 +50,14 @@ void ConstantPooling(
       bool same_identity =
           (old_ivalue && new_ivalue && (old_ivalue->is(new_ivalue)));
 
-      if (!same_identity &&
-          !aliasDb.safeToChangeAliasingRelationship(
-              node->outputs(), existing->outputs())) {
-        continue;
+      if (!same_identity && AliasDb::isMutableType(node->output())) {
+        if (!aliasDb) {
+          aliasDb = torch::make_unique<AliasDb>(graph);
+        }
+        if (!aliasDb->safeToChangeAliasingRelationship(
+                node->outputs(), existing->outputs())) {
+          continue;
+        }
       }
 
       // constant exists, replace the uses of node, and destroy it.
@@ -66,9 +75,10 @@ void ConstantPooling(
 } // anonymous namespace
 
 void ConstantPooling(const std::shared_ptr<Graph>& graph) {
-  AliasDb aliasDb(graph);
+  GRAPH_PASS_TIMER("ConstantPooling");
+  std::unique_ptr<AliasDb> aliasDb;
   std::unordered_set<Node*, HashNode, EqualNode> constants;
-  ConstantPooling(graph->block(), constants, aliasDb);
+  ConstantPooling(graph->block(), constants, graph, aliasDb);
 }
 } // namespace jit
 } // namespace torch
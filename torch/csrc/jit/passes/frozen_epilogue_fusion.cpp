@@ -0,0 +1,219 @@
+#include <torch/csrc/jit/passes/frozen_epilogue_fusion.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/StringUtil.h>
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+#include <limits>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using graph_rewrite_helper::getIValue;
+using graph_rewrite_helper::getValue;
+
+// An op whose output %y the epilogue is fused into.
+struct FusableOp {
+  // The inputs of the op in the pattern graph
+  std::string params;
+  // Computes %y
+  std::string call;
+  // The fused op, called with its own arguments followed by the epilogue
+  std::string fused_call;
+  // The numbers of dimensions of the inputs the fused op supports
+  int64_t min_input_dim;
+  int64_t max_input_dim;
+};
+
+// The pointwise ops applied to %y, producing %r.
+struct Epilogue {
+  // The inputs of the epilogue in the pattern graph
+  std::string params;
+  std::string body;
+  // The arguments of the fused op, see Note [MKLDNN fused epilogues]
+  std::string other;
+  std::string attr;
+  std::string alpha;
+  std::string beta;
+};
+
+std::vector<FusableOp> fusableOps() {
+  return {
+      {"%input, %weight, %bias, %stride, %padding, %dilation, %groups",
+       "%y = aten::conv2d(%input, %weight, %bias, %stride, %padding, %dilation, %groups)",
+       "aten::_mkldnn_convolution_fused(%input, %weight, %bias, %padding, %stride, %dilation, %groups",
+       4,
+       4},
+      {"%input, %weight, %bias",
+       "%y = aten::linear(%input, %weight, %bias)",
+       "aten::_mkldnn_linear_fused(%input, %weight, %bias",
+       2,
+       std::numeric_limits<int64_t>::max()},
+  };
+}
+
+std::vector<Epilogue> epilogues() {
+  std::vector<Epilogue> result;
+  for (const char* relu : {"aten::relu", "aten::relu_"}) {
+    result.push_back({"", c10::str("%r = ", relu, "(%y)"), "%none", "relu",
+                      "%zero", "%zero"});
+  }
+  result.push_back({"", "%r = aten::gelu(%y)", "%none", "gelu", "%zero",
+                    "%zero"});
+  for (const char* clamp :
+       {"aten::hardtanh", "aten::hardtanh_", "aten::clamp", "aten::clamp_"}) {
+    result.push_back({", %min, %max", c10::str("%r = ", clamp, "(%y, %min, %max)"),
+                      "%none", "clamp", "%min", "%max"});
+  }
+  // In-place adds into other would also write to other, so they are left
+  // alone. The patterns are rewritten in order, the add followed by a relu
+  // has to come before the add alone.
+  for (const char* add :
+       {"aten::add(%y, %other, %alpha)",
+        "aten::add(%other, %y, %alpha)",
+        "aten::add_(%y, %other, %alpha)"}) {
+    for (const char* relu : {"aten::relu", "aten::relu_"}) {
+      result.push_back({", %other, %alpha",
+                        c10::str("%z = ", add, "\n        %r = ", relu, "(%z)"),
+                        "%other", "relu", "%zero", "%zero"});
+    }
+    result.push_back({", %other, %alpha", c10::str("%r = ", add), "%other",
+                      "none", "%zero", "%zero"});
+  }
+  return result;
+}
+
+// The type of `v` if it is a tensor. The outputs of the rewrites have no
+// particular type, those of the fused ops are the type of their input up to
+// the sizes.
+TensorTypePtr tensorType(const Value* v) {
+  const Node* n = v->node();
+  if (n->kind() ==
+          Symbol::fromQualString("aten::_mkldnn_convolution_fused") ||
+      n->kind() == Symbol::fromQualString("aten::_mkldnn_linear_fused")) {
+    const auto input_type = tensorType(n->input(0));
+    return input_type ? input_type->dimensionedOnly() : nullptr;
+  }
+  return v->type()->cast<TensorType>();
+}
+
+// Whether `v` is known to be a float CPU tensor.
+bool isFloatCPUTensor(const Value* v) {
+  const auto type = tensorType(v);
+  return type && type->scalarType() == at::kFloat && type->device() &&
+      type->device()->is_cpu();
+}
+
+// Whether `n` may write to a value. The fused op runs where the last node of
+// the pattern was, so such nodes can't be between the op and that node.
+bool mayWrite(Node* n) {
+  if (n->kind() == prim::Constant || n->kind() == prim::ListConstruct ||
+      n->kind() == prim::TupleConstruct) {
+    return false;
+  }
+  if (!n->blocks().empty() || n->hasSideEffects() || !n->maybeSchema()) {
+    return true;
+  }
+  return n->schema().is_mutable();
+}
+
+bool isFusable(
+    const FusableOp& op,
+    const Match& match,
+    const std::unordered_map<std::string, Value*>& vmap) {
+  const auto& match_vmap = match.values_map;
+  Value* input = getValue("input", match_vmap, vmap);
+  Value* weight = getValue("weight", match_vmap, vmap);
+  Value* bias = getValue("bias", match_vmap, vmap);
+  if (!isFloatCPUTensor(input) || !isFloatCPUTensor(weight) ||
+      !(bias->type()->isSubtypeOf(NoneType::get()) ||
+        isFloatCPUTensor(bias))) {
+    return false;
+  }
+  const auto input_dim = tensorType(input)->dim();
+  if (!input_dim || *input_dim < op.min_input_dim ||
+      *input_dim > op.max_input_dim) {
+    return false;
+  }
+
+  if (vmap.count("other")) {
+    auto alpha = getIValue("alpha", match_vmap, vmap);
+    if (!getValue("other", match_vmap, vmap)
+             ->type()
+             ->isSubtypeOf(TensorType::get()) ||
+        !alpha || !(alpha->isInt() || alpha->isDouble()) ||
+        alpha->toScalar().to<double>() != 1) {
+      return false;
+    }
+  }
+  if (vmap.count("min")) {
+    for (const char* bound : {"min", "max"}) {
+      auto value = getIValue(bound, match_vmap, vmap);
+      if (!value || !(value->isInt() || value->isDouble())) {
+        return false;
+      }
+    }
+  }
+
+  Node* op_node = getValue("y", match_vmap, vmap)->node();
+  if (op_node->owningBlock() != match.anchor->owningBlock()) {
+    return false;
+  }
+  std::unordered_set<const Node*> matched_nodes;
+  for (const auto& nodes : match.nodes_map) {
+    matched_nodes.insert(nodes.second);
+  }
+  for (Node* n = op_node->next(); n != match.anchor; n = n->next()) {
+    if (!matched_nodes.count(n) && mayWrite(n)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+void FuseFrozenEpilogues(std::shared_ptr<Graph>& graph) {
+  if (!at::hasMKLDNN() || !at::globalContext().userEnabledMkldnn()) {
+    return;
+  }
+  GRAPH_PASS_TIMER("FuseFrozenEpilogues");
+  for (const FusableOp& op : fusableOps()) {
+    SubgraphRewriter rewriter;
+    for (const Epilogue& epilogue : epilogues()) {
+      const std::string pattern = c10::str(
+          "\n    graph(", op.params, epilogue.params, "):",
+          "\n        ", op.call,
+          "\n        ", epilogue.body,
+          "\n        return (%r))");
+      const std::string replacement = c10::str(
+          "\n    graph(", op.params, epilogue.params, "):",
+          "\n        %none : NoneType = prim::Constant()",
+          "\n        %zero : int = prim::Constant[value=0]()",
+          "\n        %attr : str = prim::Constant[value=\"", epilogue.attr, "\"]()",
+          "\n        %r = ", op.fused_call, ", ", epilogue.other, ", %attr, ",
+          epilogue.alpha, ", ", epilogue.beta, ")",
+          "\n        return (%r))");
+      rewriter.RegisterRewritePattern(pattern, replacement);
+    }
+    rewriter.runOnGraph(
+        graph,
+        [&op](
+            const Match& match,
+            const std::unordered_map<std::string, Value*>& vmap) {
+          return isFusable(op, match, vmap);
+        });
+  }
+  EliminateDeadCode(graph);
+  GRAPH_DUMP("After FuseFrozenEpilogues: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
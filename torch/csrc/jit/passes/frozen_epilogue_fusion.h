@@ -0,0 +1,27 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Fuses the pointwise ops that follow the convolutions and linears of a
+// frozen CPU inference graph into them, as oneDNN post-ops that run on the
+// output while it is still in cache:
+//
+// - aten::conv2d followed by relu, gelu, hardtanh or clamp is replaced by
+//   aten::_mkldnn_convolution_fused, and aten::linear by
+//   aten::_mkldnn_linear_fused.
+// - The same holds for conv2d and linear followed by the add of a tensor,
+//   e.g. a residual connection, with or without a relu after the add.
+//
+// The input and the weight of the op must be known to be float CPU tensors,
+// conv2d inputs 4-d ones, the bounds of hardtanh and clamp must be constants,
+// and the alpha of the add must be 1. The in-place variants of the
+// pointwise ops are fused too, since the output of the op has no other use.
+// Running PrepackFrozenWeights afterwards also reorders the weights of the
+// fused convolutions. It is a no-op if PyTorch was built without MKLDNN.
+TORCH_API void FuseFrozenEpilogues(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,229 @@
+#include <torch/csrc/jit/passes/frozen_ops_to_mkldnn.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/remove_mutation.h>
+
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+#if AT_MKLDNN_ENABLED()
+
+namespace {
+
+// Returns the value of `v` if it is a constant dense float CPU tensor with
+// `dim` dimensions.
+c10::optional<at::Tensor> constantWeight(const Value* v, int64_t dim) {
+  const auto ivalue = toIValue(v);
+  if (!ivalue || !ivalue->isTensor()) {
+    return c10::nullopt;
+  }
+  const at::Tensor weight = ivalue->toTensor();
+  if (!weight.defined() || !weight.device().is_cpu() ||
+      weight.layout() != at::kStrided ||
+      weight.scalar_type() != at::kFloat || weight.dim() != dim) {
+    return c10::nullopt;
+  }
+  return weight;
+}
+
+bool isNone(const Value* v) {
+  return v->type()->isSubtypeOf(NoneType::get());
+}
+
+class MKLDNNConverter {
+ public:
+  explicit MKLDNNConverter(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), aliasDb_(graph_) {}
+
+  void run() {
+    convertBlock(graph_->block());
+    EliminateDeadCode(graph_);
+  }
+
+ private:
+  void convertBlock(Block* block) {
+    for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+      // aten::to_dense nodes are inserted after the converted node, so they
+      // are skipped by advancing first.
+      Node* node = *it++;
+      for (Block* sub_block : node->blocks()) {
+        convertBlock(sub_block);
+      }
+      if (node->outputs().size() != 1 ||
+          aliasDb_.hasWriters(node->output())) {
+        continue;
+      }
+      if (startsRegion(node)) {
+        convertWeights(node);
+        convertNode(node, /*num_tensor_inputs=*/1);
+      } else if (staysInRegion(node)) {
+        convertNode(node, isAdd(node) ? 2 : 1);
+      }
+    }
+  }
+
+  bool isAdd(const Node* node) const {
+    return node->matches(
+        "aten::add(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor");
+  }
+
+  bool inRegion(Value* v) const {
+    return mkldnn_values_.count(v);
+  }
+
+  bool startsRegion(const Node* node) const {
+    if (node->matches(
+            "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+      return constantWeight(node->input(1), 4) &&
+          (isNone(node->input(2)) || constantWeight(node->input(2), 1));
+    }
+    // mkldnn_linear requires a bias
+    if (node->matches(
+            "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor")) {
+      return constantWeight(node->input(1), 2) &&
+          constantWeight(node->input(2), 1);
+    }
+    return false;
+  }
+
+  bool staysInRegion(const Node* node) const {
+    if (!inRegion(node->input(0))) {
+      return false;
+    }
+    if (node->matches("aten::relu(Tensor self) -> Tensor") ||
+        node->matches(
+            "aten::max_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, int[] dilation, bool ceil_mode) -> Tensor")) {
+      return true;
+    }
+    if (node->matches(
+            "aten::avg_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, bool ceil_mode, bool count_include_pad, int? divisor_override) -> Tensor")) {
+      return isNone(node->input(6));
+    }
+    // mkldnn_adaptive_avg_pool2d only supports output sizes dividing the
+    // input size, which is always the case for global pooling.
+    if (node->matches(
+            "aten::adaptive_avg_pool2d(Tensor self, int[] output_size) -> Tensor")) {
+      const auto output_size = toIValue(node->input(1));
+      if (!output_size) {
+        return false;
+      }
+      const auto sizes = output_size->toIntVector();
+      return std::all_of(sizes.begin(), sizes.end(), [](int64_t size) {
+        return size == 1;
+      });
+    }
+    // mkldnn_add doesn't broadcast, so the sizes of both operands must be
+    // known to be the same.
+    if (isAdd(node)) {
+      if (!inRegion(node->input(1))) {
+        return false;
+      }
+      const auto self_type = node->input(0)->type()->cast<TensorType>();
+      const auto other_type = node->input(1)->type()->cast<TensorType>();
+      if (!self_type || !other_type) {
+        return false;
+      }
+      const auto self_sizes = self_type->sizes().concrete_sizes();
+      const auto other_sizes = other_type->sizes().concrete_sizes();
+      return self_sizes && other_sizes && *self_sizes == *other_sizes;
+    }
+    return false;
+  }
+
+  // MKLDNN tensors have no storage, so they can't be inserted with
+  // insertConstant().
+  Value* insertMKLDNNConstant(const at::Tensor& tensor) {
+    Node* constant = graph_->create(prim::Constant);
+    constant->t_(attr::value, tensor);
+    constant->output()->setType(TensorType::get());
+    return graph_->insertNode(constant)->output();
+  }
+
+  void convertWeights(Node* node) {
+    WithInsertPoint guard(node);
+    const bool is_conv = node->kind() == aten::conv2d;
+    at::Tensor weight =
+        constantWeight(node->input(1), is_conv ? 4 : 2)->to_mkldnn();
+    if (is_conv) {
+      // Reorder the weight into the layout the convolution uses, which
+      // otherwise happens on every call.
+      const auto stride = toIValue(node->input(3));
+      const auto padding = toIValue(node->input(4));
+      const auto dilation = toIValue(node->input(5));
+      const auto groups = toIValue(node->input(6));
+      if (stride && padding && dilation && groups) {
+        weight = at::mkldnn_reorder_conv2d_weight(
+            weight,
+            padding->toIntVector(),
+            stride->toIntVector(),
+            dilation->toIntVector(),
+            groups->toInt());
+      }
+    }
+    node->replaceInput(1, insertMKLDNNConstant(weight));
+    if (!isNone(node->input(2))) {
+      node->replaceInput(
+          2,
+          insertMKLDNNConstant(
+              constantWeight(node->input(2), 1)->to_mkldnn()));
+    }
+  }
+
+  // Runs the first `num_tensor_inputs` inputs of `node` on MKLDNN tensors,
+  // and converts its output back for the users outside of the region.
+  void convertNode(Node* node, size_t num_tensor_inputs) {
+    for (size_t i = 0; i < num_tensor_inputs; ++i) {
+      Value* input = node->input(i);
+      auto it = mkldnn_values_.find(input);
+      if (it != mkldnn_values_.end()) {
+        node->replaceInput(i, it->second);
+        continue;
+      }
+      WithInsertPoint guard(node);
+      Node* to_mkldnn = graph_->insertNode(
+          graph_->create(Symbol::fromQualString("aten::to_mkldnn"), {input}));
+      to_mkldnn->output()->setType(TensorType::get());
+      node->replaceInput(i, to_mkldnn->output());
+    }
+
+    Value* output = node->output();
+    Node* to_dense = graph_->create(aten::to_dense, {output});
+    to_dense->insertAfter(node);
+    to_dense->output()->setType(output->type());
+    output->replaceAllUsesWith(to_dense->output());
+    to_dense->replaceInput(0, output);
+    output->setType(TensorType::get());
+    mkldnn_values_[to_dense->output()] = output;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+  // Maps the dense values of the converted nodes to their MKLDNN values.
+  std::unordered_map<Value*, Value*> mkldnn_values_;
+};
+
+} // namespace
+
+void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph) {
+  if (!at::hasMKLDNN()) {
+    return;
+  }
+  // Fewer in-place ops means fewer outputs that can't be converted.
+  RemoveTensorMutation(graph);
+  MKLDNNConverter(graph).run();
+}
+
+#else
+
+void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph) {}
+
+#endif
+
+} // namespace jit
+} // namespace torch
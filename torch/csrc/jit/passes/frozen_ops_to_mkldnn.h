@@ -0,0 +1,28 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Runs the ops of a frozen CPU inference graph that MKLDNN supports on
+// MKLDNN tensors, keeping the tensors passed between them in the blocked
+// layout instead of converting them to and from the dense layout around
+// every op.
+//
+// aten::conv2d and aten::linear nodes with constant float weights start an
+// MKLDNN region: their weights and biases are converted to MKLDNN constants,
+// conv2d weights being reordered into the layout the convolution expects,
+// and their input is converted with aten::to_mkldnn unless it already is an
+// MKLDNN tensor. relu, max_pool2d, avg_pool2d, adaptive_avg_pool2d, and the
+// add of two tensors of the same known size, then stay in the region when
+// their inputs are in it. Values used outside of a region are converted back
+// with aten::to_dense. Outputs that are mutated, or alias a mutated value,
+// are not converted.
+//
+// The resulting graph holds MKLDNN constants and can't be serialized. It is
+// a no-op if PyTorch was built without MKLDNN.
+TORCH_API void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,259 @@
+#include <torch/csrc/jit/passes/frozen_weight_prepacking.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Returns the value of `v` if it is a constant dense float CPU tensor with
+// `dim` dimensions.
+c10::optional<at::Tensor> constantWeight(const Value* v, int64_t dim) {
+  const auto ivalue = toIValue(v);
+  if (!ivalue || !ivalue->isTensor()) {
+    return c10::nullopt;
+  }
+  const at::Tensor weight = ivalue->toTensor();
+  if (!weight.defined() || !weight.device().is_cpu() ||
+      weight.layout() != at::kStrided ||
+      weight.scalar_type() != at::kFloat || weight.dim() != dim) {
+    return c10::nullopt;
+  }
+  return weight;
+}
+
+bool isNone(const Value* v) {
+  return v->type()->isSubtypeOf(NoneType::get());
+}
+
+// Whether `v` is known to be a float CPU tensor.
+bool isFloatCPUTensor(const Value* v) {
+  const auto type = v->type()->cast<TensorType>();
+  return type && type->scalarType() == at::kFloat && type->device() &&
+      type->device()->is_cpu();
+}
+
+class FrozenWeightPrepacker {
+ public:
+  explicit FrozenWeightPrepacker(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), aliasDb_(graph_) {}
+
+  void run() {
+    prepackBlock(graph_->block());
+    EliminateDeadCode(graph_);
+  }
+
+ private:
+  void prepackBlock(Block* block) {
+    for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+      Node* node = *it++;
+      for (Block* sub_block : node->blocks()) {
+        prepackBlock(sub_block);
+      }
+      if (isWeightTranspose(node)) {
+        foldTranspose(node);
+      } else if (node->matches(
+                     "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor")) {
+        prepackLinear(node);
+      } else if (node->matches(
+                     "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+        prepackConv2d(node);
+      } else if (node->matches(
+                     "aten::_mkldnn_convolution_fused(Tensor self, Tensor weight, Tensor? bias, int[] padding, int[] stride, int[] dilation, int groups, Tensor? other, str attr, Scalar alpha=0, Scalar beta=0) -> Tensor")) {
+        prepackFusedConv2d(node);
+      }
+    }
+  }
+
+  // Values created by this pass aren't in the AliasDb, and have no writers.
+  bool isMutated(Value* v) const {
+    return aliasDb_.hasWriters(v);
+  }
+
+  bool isWeightTranspose(Node* node) const {
+    if (!node->matches("aten::t(Tensor(a) self) -> Tensor(a)") &&
+        !node->matches(
+            "aten::transpose.int(Tensor(a) self, int dim0, int dim1) -> Tensor(a)") &&
+        !node->matches(
+            "aten::permute(Tensor(a) self, int[] dims) -> Tensor(a)")) {
+      return false;
+    }
+    const auto self = toIValue(node->input(0));
+    return self && self->isTensor() &&
+        std::all_of(
+            node->inputs().begin(),
+            node->inputs().end(),
+            [](Value* v) { return v->node()->kind() == prim::Constant; }) &&
+        // A write through the view would change the weight, and the other
+        // way around.
+        !isMutated(node->input(0)) && !isMutated(node->output());
+  }
+
+  void foldTranspose(Node* node) {
+    auto outputs = runNodeIfInputsAreConstant(node);
+    if (!outputs) {
+      return;
+    }
+    WithInsertPoint guard(node);
+    Value* folded =
+        graph_->insertConstant(outputs->at(0).toTensor().contiguous());
+    folded->setType(node->output()->type());
+    GRAPH_UPDATE("Folding ", *node, " into a contiguous constant");
+    node->output()->replaceAllUsesWith(folded);
+  }
+
+  void prepackLinear(Node* node) {
+#if AT_MKL_ENABLED()
+    if (!at::hasMKL() || isMutated(node->input(1)) ||
+        !isFloatCPUTensor(node->input(0))) {
+      return;
+    }
+    const auto weight = constantWeight(node->input(1), 2);
+    if (!weight || !(isNone(node->input(2)) ||
+                     constantWeight(node->input(2), 1))) {
+      return;
+    }
+    const auto sizes = node->input(0)
+                           ->type()
+                           ->expect<TensorType>()
+                           ->sizes()
+                           .concrete_sizes();
+    if (!sizes || sizes->empty() || sizes->back() != weight->size(1)) {
+      return;
+    }
+    int64_t batch_size = 1;
+    for (size_t i = 0; i + 1 < sizes->size(); ++i) {
+      batch_size *= (*sizes)[i];
+    }
+    const int64_t int_max = std::numeric_limits<int>::max();
+    if (batch_size == 0 || batch_size > int_max || weight->numel() == 0 ||
+        weight->size(0) > int_max || weight->size(1) > int_max) {
+      return;
+    }
+
+    WithInsertPoint guard(node);
+    Value* packed = graph_->insertConstant(
+        at::_mkl_reorder_linear_weight(*weight, batch_size));
+    Value* output = graph_->insert(
+        Symbol::fromQualString("aten::_mkl_linear"),
+        {node->input(0),
+         packed,
+         node->input(1),
+         node->input(2),
+         graph_->insertConstant(batch_size)});
+    output->setType(node->output()->type());
+    GRAPH_UPDATE("Packing the weight of ", *node);
+    node->output()->replaceAllUsesWith(output);
+#endif
+  }
+
+  void prepackConv2d(Node* node) {
+#if AT_MKLDNN_ENABLED()
+    if (!at::hasMKLDNN() || !at::globalContext().userEnabledMkldnn() ||
+        isMutated(node->input(1)) || !isFloatCPUTensor(node->input(0)) ||
+        node->input(0)->type()->expect<TensorType>()->dim() != 4) {
+      return;
+    }
+    const auto weight = constantWeight(node->input(1), 4);
+    const auto bias = isNone(node->input(2))
+        ? c10::optional<at::Tensor>(at::Tensor())
+        : constantWeight(node->input(2), 1);
+    const auto stride = toIValue(node->input(3));
+    const auto padding = toIValue(node->input(4));
+    const auto dilation = toIValue(node->input(5));
+    const auto groups = toIValue(node->input(6));
+    // mkldnn_convolution reads dense tensors as contiguous ones
+    if (!weight || !bias || (bias->defined() && !bias->is_contiguous()) ||
+        !stride || !padding || !dilation || !groups) {
+      return;
+    }
+
+    WithInsertPoint guard(node);
+    Value* reordered = insertReorderedConv2dWeight(
+        *weight, *padding, *stride, *dilation, *groups);
+    Value* input = graph_->insert(aten::contiguous, {node->input(0)});
+    Value* output = graph_->insert(
+        aten::mkldnn_convolution,
+        {input,
+         reordered,
+         node->input(2),
+         node->input(4),
+         node->input(3),
+         node->input(5),
+         node->input(6)});
+    output->setType(node->output()->type());
+    GRAPH_UPDATE("Reordering the weight of ", *node);
+    node->output()->replaceAllUsesWith(output);
+#endif
+  }
+
+  // _mkldnn_convolution_fused, see FuseFrozenEpilogues, takes the reordered
+  // weight in place of the dense one.
+  void prepackFusedConv2d(Node* node) {
+#if AT_MKLDNN_ENABLED()
+    if (!at::hasMKLDNN() || isMutated(node->input(1))) {
+      return;
+    }
+    const auto weight = constantWeight(node->input(1), 4);
+    const auto padding = toIValue(node->input(3));
+    const auto stride = toIValue(node->input(4));
+    const auto dilation = toIValue(node->input(5));
+    const auto groups = toIValue(node->input(6));
+    if (!weight || !padding || !stride || !dilation || !groups) {
+      return;
+    }
+    WithInsertPoint guard(node);
+    GRAPH_UPDATE("Reordering the weight of ", *node);
+    node->replaceInput(
+        1,
+        insertReorderedConv2dWeight(
+            *weight, *padding, *stride, *dilation, *groups));
+#endif
+  }
+
+#if AT_MKLDNN_ENABLED()
+  Value* insertReorderedConv2dWeight(
+      const at::Tensor& weight,
+      const IValue& padding,
+      const IValue& stride,
+      const IValue& dilation,
+      const IValue& groups) {
+    const at::Tensor reordered = at::mkldnn_reorder_conv2d_weight(
+        weight.to_mkldnn(),
+        padding.toIntVector(),
+        stride.toIntVector(),
+        dilation.toIntVector(),
+        groups.toInt());
+    // MKLDNN tensors have no storage, so they can't be inserted with
+    // insertConstant().
+    Node* reordered_constant = graph_->create(prim::Constant);
+    reordered_constant->t_(attr::value, reordered);
+    reordered_constant->output()->setType(TensorType::get());
+    return graph_->insertNode(reordered_constant)->output();
+  }
+#endif
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+};
+
+} // namespace
+
+void PrepackFrozenWeights(std::shared_ptr<Graph>& graph) {
+  GRAPH_PASS_TIMER("PrepackFrozenWeights");
+  FrozenWeightPrepacker(graph).run();
+  GRAPH_DUMP("After PrepackFrozenWeights: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Moves the transformations of the constant weights of a frozen CPU inference
+// graph from every call to freezing time:
+//
+// - aten::t, aten::transpose and aten::permute of constant tensors are folded
+//   into contiguous constants.
+// - aten::linear with a constant float weight, and an input whose sizes are
+//   known, is replaced by aten::_mkl_linear with the weight packed by MKL for
+//   the number of rows of the input. Inputs of other sizes go through
+//   aten::linear.
+// - aten::conv2d with a constant float weight, and an input known to be a
+//   4-d float CPU tensor, for which aten::_convolution picks MKLDNN, is
+//   replaced by aten::mkldnn_convolution with the weight already reordered
+//   into the layout of the convolution. The weights of
+//   aten::_mkldnn_convolution_fused, see FuseFrozenEpilogues, are reordered
+//   in place.
+//
+// Weights that are mutated, or alias a mutated value, are left alone. The
+// sizes of the inputs come from the types of the graph, e.g. after shape
+// propagation. The resulting graph holds packed constants that are specific
+// to the machine and can't be serialized. The linear and conv2d rewrites are
+// no-ops if PyTorch was built without MKL and MKLDNN respectively.
+TORCH_API void PrepackFrozenWeights(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,309 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <ATen/ATen.h>
+#include <c10/core/CPUAllocator.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/liveness.h>
+#include <torch/csrc/jit/runtime/custom_operator.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// The arena of a prim::AllocateArena node, shared by all the runs of its
+// graph; a run that finds it in use by another, concurrent run gets an arena
+// of its own.
+class Arena {
+ public:
+  explicit Arena(int64_t size) : size_(size) {}
+
+  at::Tensor acquire() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!tensor_.defined()) {
+      tensor_ = at::empty({size_}, at::dtype(at::kByte));
+    } else if (tensor_.use_count() > 1 || tensor_.storage().use_count() > 1) {
+      return at::empty({size_}, at::dtype(at::kByte));
+    }
+    return tensor_;
+  }
+
+ private:
+  const int64_t size_;
+  std::mutex mutex_;
+  at::Tensor tensor_;
+};
+
+RegisterOperators reg_arena_ops({
+    Operator(
+        "prim::AllocateArena() -> Tensor",
+        [](const Node* node) -> Operation {
+          auto arena = std::make_shared<Arena>(node->i(attr::size));
+          return [arena](Stack* stack) { push(stack, arena->acquire()); };
+        },
+        aliasAnalysisFromSchema()),
+    Operator(
+        "prim::ArenaTensor(Tensor(a) arena) -> Tensor(a)",
+        [](const Node* node) -> Operation {
+          const auto offset = node->i(attr::offset);
+          const auto sizes = node->is(attr::sizes);
+          const auto dtype = static_cast<at::ScalarType>(node->i(attr::dtype));
+          return [offset, sizes, dtype](Stack* stack) {
+            auto arena = pop(stack).toTensor();
+            auto storage = arena.storage();
+            // the deleter keeps the arena alive, and marks it as in use,
+            // for as long as the tensor lives
+            push(
+                stack,
+                at::from_blob(
+                    static_cast<uint8_t*>(arena.data_ptr()) + offset,
+                    sizes,
+                    [storage](void* /* unused */) {},
+                    arena.options().dtype(dtype)));
+          };
+        },
+        aliasAnalysisFromSchema()),
+});
+
+// A tensor output whose memory is planned; lifetime is the range of the
+// indices of the top-level nodes it is live at, inclusive.
+struct PlannedValue {
+  Node* node;
+  std::vector<int64_t> sizes;
+  at::ScalarType dtype;
+  size_t nbytes;
+  size_t first;
+  size_t last;
+  size_t offset;
+};
+
+// Whether the op of node has an out= variant, taking the same arguments
+// followed by the tensor to write to.
+bool hasOutVariant(Node* node) {
+  const auto& schema = node->schema();
+  const auto& arguments = schema.arguments();
+  for (const auto& op : getAllOperatorsFor(node->kind())) {
+    const auto& out_schema = op->schema();
+    const auto& out_arguments = out_schema.arguments();
+    if (out_arguments.size() != arguments.size() + 1 ||
+        out_schema.returns().size() != 1) {
+      continue;
+    }
+    const auto& out = out_arguments.back();
+    if (out.name() != "out" || !out.alias_info() ||
+        !out.alias_info()->isWrite()) {
+      continue;
+    }
+    bool matches = true;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+      if (out_arguments[i].name() != arguments[i].name() ||
+          *out_arguments[i].type() != *arguments[i].type()) {
+        matches = false;
+        break;
+      }
+    }
+    if (matches) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool isContiguous(
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides) {
+  int64_t expected = 1;
+  for (int64_t i = sizes.size() - 1; i >= 0; --i) {
+    if (sizes[i] != 1 && strides[i] != expected) {
+      return false;
+    }
+    expected *= sizes[i];
+  }
+  return true;
+}
+
+c10::optional<PlannedValue> tryPlan(
+    Node* node,
+    size_t index,
+    const AliasDb& alias_db,
+    const std::shared_ptr<Graph>& graph) {
+  if (!node->kind().is_aten() || node->outputs().size() != 1 ||
+      !node->blocks().empty() || !node->maybeSchema() ||
+      node->schema().is_mutable()) {
+    return c10::nullopt;
+  }
+  Value* output = node->output();
+  auto type = output->type()->cast<TensorType>();
+  if (!type || !type->scalarType() || !type->device() ||
+      !type->device()->is_cpu() || type->requiresGrad().value_or(false)) {
+    return c10::nullopt;
+  }
+  auto sizes = type->sizes().concrete_sizes();
+  if (!sizes) {
+    return c10::nullopt;
+  }
+  auto strides = type->strides().concrete_sizes();
+  if (strides && !isContiguous(*sizes, *strides)) {
+    return c10::nullopt;
+  }
+
+  // The planned tensor must die with its value: it may not be returned,
+  // stored in a container or viewed by another value.
+  for (Value* graph_output : graph->outputs()) {
+    if (alias_db.mayContainAlias(output, graph_output)) {
+      return c10::nullopt;
+    }
+  }
+  for (Value* input : node->inputs()) {
+    if (alias_db.mayAlias(input, output)) {
+      return c10::nullopt;
+    }
+  }
+  for (const Use& use : output->uses()) {
+    for (Value* user_output : use.user->outputs()) {
+      if (alias_db.mayContainAlias(output, user_output)) {
+        return c10::nullopt;
+      }
+    }
+  }
+
+  if (!hasOutVariant(node)) {
+    return c10::nullopt;
+  }
+  int64_t numel = 1;
+  for (auto size : *sizes) {
+    numel *= size;
+  }
+  const size_t nbytes = numel * c10::elementSize(*type->scalarType());
+  if (nbytes == 0) {
+    return c10::nullopt;
+  }
+  return PlannedValue{
+      node, *sizes, *type->scalarType(), nbytes, index, index, 0};
+}
+
+// Assigns offsets to the planned values, largest first, putting each at the
+// lowest offset that doesn't overlap with the values placed so far that are
+// live at the same time; returns the arena size.
+size_t assignOffsets(std::vector<PlannedValue>& planned) {
+  std::vector<PlannedValue*> order;
+  for (auto& value : planned) {
+    order.push_back(&value);
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [](PlannedValue* a, PlannedValue* b) {
+        return a->nbytes > b->nbytes;
+      });
+
+  size_t arena_size = 0;
+  std::vector<PlannedValue*> placed;
+  for (PlannedValue* value : order) {
+    std::vector<PlannedValue*> conflicts;
+    for (PlannedValue* other : placed) {
+      if (other->first <= value->last && value->first <= other->last) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(
+        conflicts.begin(),
+        conflicts.end(),
+        [](PlannedValue* a, PlannedValue* b) { return a->offset < b->offset; });
+    size_t offset = 0;
+    for (PlannedValue* other : conflicts) {
+      if (offset + value->nbytes <= other->offset) {
+        break;
+      }
+      offset = std::max(
+          offset,
+          c10::gAlignment *
+              ((other->offset + other->nbytes + c10::gAlignment - 1) /
+               c10::gAlignment));
+    }
+    value->offset = offset;
+    placed.push_back(value);
+    arena_size = std::max(arena_size, offset + value->nbytes);
+  }
+  return arena_size;
+}
+
+} // namespace
+
+void PlanMemory(std::shared_ptr<Graph>& graph) {
+  AliasDb alias_db(graph);
+  std::vector<PlannedValue> planned;
+  std::unordered_map<Value*, size_t> planned_index;
+  std::vector<Node*> nodes;
+  for (Node* node : graph->nodes()) {
+    nodes.push_back(node);
+    if (auto value = tryPlan(node, nodes.size() - 1, alias_db, graph)) {
+      planned_index[node->output()] = planned.size();
+      planned.push_back(std::move(*value));
+    }
+  }
+  if (planned.empty()) {
+    return;
+  }
+
+  // A value is live from its definition to the last top-level node whose
+  // liveness set holds it; uses in nested blocks keep it live at the node
+  // owning the block.
+  auto liveness = BuildLivenessSets(graph);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    auto it = liveness.find(nodes[i]);
+    if (it == liveness.end()) {
+      continue;
+    }
+    for (Value* value : it->second) {
+      auto planned_it = planned_index.find(value);
+      if (planned_it != planned_index.end()) {
+        auto& planned_value = planned[planned_it->second];
+        planned_value.last = std::max(planned_value.last, i);
+      }
+    }
+  }
+
+  const size_t arena_size = assignOffsets(planned);
+
+  WithInsertPoint arena_guard(*graph->nodes().begin());
+  Node* allocate = graph->insertNode(
+      graph->create(prim::AllocateArena)
+          ->i_(attr::size, static_cast<int64_t>(arena_size)));
+  allocate->output()->setType(TensorType::get());
+
+  for (auto& value : planned) {
+    Node* node = value.node;
+    WithInsertPoint guard(node);
+    Node* slice = graph->insertNode(
+        graph->create(prim::ArenaTensor, {allocate->output()})
+            ->i_(attr::offset, static_cast<int64_t>(value.offset))
+            ->is_(attr::sizes, value.sizes)
+            ->i_(attr::dtype, static_cast<int64_t>(value.dtype)));
+    slice->output()->setType(node->output()->type());
+
+    std::vector<Value*> inputs(node->inputs().begin(), node->inputs().end());
+    inputs.push_back(slice->output());
+    Node* out_node = graph->insertNode(graph->create(node->kind(), inputs));
+    out_node->output()->setType(node->output()->type());
+    if (!out_node->maybeOperator()) {
+      out_node->destroy();
+      slice->destroy();
+      continue;
+    }
+    GRAPH_UPDATE(
+        "Planning ", node->output()->debugName(), " at offset ", value.offset);
+    node->output()->replaceAllUsesWith(out_node->output());
+    node->destroy();
+  }
+  if (!allocate->hasUses()) {
+    allocate->destroy();
+  }
+  GRAPH_DUMP("After PlanMemory: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
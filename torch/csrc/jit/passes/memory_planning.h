@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Plans the memory of the intermediate tensors of a graph with static shapes,
+// e.g. a frozen inference graph after profiling or shape propagation.
+//
+// Every top-level node with a single CPU tensor output of a complete, known
+// size that doesn't escape the graph or alias anything else, and whose op
+// has an out= variant, is rewritten to that variant, writing into a slice of
+// a single arena. The lifetimes of the tensors come from the liveness sets of
+// the graph, and tensors with disjoint lifetimes share the same memory. The
+// arena is created by a prim::AllocateArena node at the start of the graph
+// and is reused across runs, so a planned graph doesn't call the allocator
+// for the planned tensors after its first run.
+//
+// The planned graph must be run with the same input shapes, with grad mode
+// disabled.
+TORCH_API void PlanMemory(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -53,11 +53,44 @@ void fuseQuantizeAddReluImpl(std::shared_ptr<Graph>& graph) {
       quantized_add_scalar_out_relu_pattern, fused_add_scalar_out_relu_pattern);
   fused_add_relu_rewriter.runOnGraph(graph);
 }
+
+void fuseQuantizedConvAddImpl(std::shared_ptr<Graph>& graph) {
+  SubgraphRewriter fused_conv_add_rewriter;
+  for (const std::string add : {"add", "add_relu"}) {
+    // The output of the convolution may be either operand of the addition.
+    std::string quantized_conv_add_pattern = R"(
+    graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %conv_out = quantized::conv2d(%a_quant, %packed_params, %conv_scale, %conv_zero_point)
+         %r = quantized::)" +
+        add + R"((%conv_out, %b_quant, %scale, %zero_point)
+         return (%r) )";
+    std::string quantized_add_conv_pattern = R"(
+    graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %conv_out = quantized::conv2d(%a_quant, %packed_params, %conv_scale, %conv_zero_point)
+         %r = quantized::)" +
+        add + R"((%b_quant, %conv_out, %scale, %zero_point)
+         return (%r) )";
+    std::string fused_conv_add_pattern = R"(
+    graph(%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point):
+         %r = quantized::conv2d_)" +
+        add + R"((%a_quant, %b_quant, %packed_params, %conv_scale, %conv_zero_point, %scale, %zero_point)
+         return (%r) )";
+    fused_conv_add_rewriter.RegisterRewritePattern(
+        quantized_conv_add_pattern, fused_conv_add_pattern);
+    fused_conv_add_rewriter.RegisterRewritePattern(
+        quantized_add_conv_pattern, fused_conv_add_pattern);
+  }
+  fused_conv_add_rewriter.runOnGraph(graph);
+}
 } // namespace
 
 void FuseQuantizedAddRelu(std::shared_ptr<Graph>& graph) {
   fuseQuantizeAddReluImpl(graph);
 }
 
+void FuseQuantizedConvAdd(std::shared_ptr<Graph>& graph) {
+  fuseQuantizedConvAddImpl(graph);
+}
+
 } // namespace jit
 } // namespace torch
@@ -5,5 +5,11 @@
 namespace torch {
 namespace jit {
 TORCH_API void FuseQuantizedAddRelu(std::shared_ptr<Graph>& graph);
+
+// Fuses quantized::conv2d followed by quantized::add or quantized::add_relu of
+// its output into quantized::conv2d_add or quantized::conv2d_add_relu, when
+// the output of the convolution has no other use. Run FuseQuantizedAddRelu
+// first to fold an aten::relu following the addition.
+TORCH_API void FuseQuantizedConvAdd(std::shared_ptr<Graph>& graph);
 } // namespace jit
 } // namespace torch
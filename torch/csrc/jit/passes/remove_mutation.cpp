@@ -1,6 +1,7 @@
 #include <torch/csrc/jit/passes/remove_mutation.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/utils/memory.h>
 
 namespace torch {
@@ -152,12 +153,8 @@ struct MutationRemover {
       Node* list_construct = mutated_value->node();
       list_construct->addInput(node->inputs().at(1));
       node->output()->replaceAllUsesWith(mutated_value);
-      aliasDb_->writeIndex_->erase(node);
+      aliasDb_->removeWrites(node);
       node->destroy();
-
-      // TODO: don't strictly need to reset write cache, evaluate on models
-      aliasDb_->writtenToLocationsIndex_ =
-          aliasDb_->buildWrittenToLocationsIndex();
     }
   }
 
@@ -213,13 +210,8 @@ struct MutationRemover {
       aliasDb_->createValue(mutated_value);
 
       // We must erase the destroyed node from the AliasDb lists of writes
-      aliasDb_->writeIndex_->erase(node);
+      aliasDb_->removeWrites(node);
       node->destroy();
-
-      // now that we have removed a mutating op, the write cache is stale
-      // TODO: don't strictly need to reset write cache, evaluate on models
-      aliasDb_->writtenToLocationsIndex_ =
-          aliasDb_->buildWrittenToLocationsIndex();
     }
   }
 
@@ -229,11 +221,13 @@ struct MutationRemover {
 };
 
 void RemoveListMutation(const std::shared_ptr<Graph>& graph) {
+  GRAPH_PASS_TIMER("RemoveListMutation");
   MutationRemover mr(graph);
   mr.removeListMutation();
 }
 
 void RemoveTensorMutation(const std::shared_ptr<Graph>& graph) {
+  GRAPH_PASS_TIMER("RemoveTensorMutation");
   MutationRemover mr(graph);
   mr.removeTensorMutation();
 }
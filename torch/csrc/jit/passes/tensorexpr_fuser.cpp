@@ -1,6 +1,7 @@
 #include <torch/csrc/jit/passes/tensorexpr_fuser.h>
 #include <ATen/record_function.h>
 #include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
@@ -14,6 +15,33 @@ namespace torch {
 namespace jit {
 
 namespace tensorexpr {
+// The reductions are lowered for float tensors on the CPU, over constant dims;
+// the kernel moves their loops around, which the GPU backend doesn't support.
+static bool isSupportedReduction(Node* node) {
+  auto const tt = node->input(0)->type()->cast<TensorType>();
+  if (!tt || tt->scalarType() != at::kFloat || !tt->device() ||
+      !tt->device()->is_cpu()) {
+    return false;
+  }
+  if (node->matches(
+          "aten::sum.dim_IntList(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+          {attr::dim, attr::keepdim, attr::dtype}) ||
+      node->matches(
+          "aten::mean.dim(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+          {attr::dim, attr::keepdim, attr::dtype}) ||
+      node->matches(
+          "aten::softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+          {attr::dim, attr::dtype}) ||
+      node->matches(
+          "aten::log_softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+          {attr::dim, attr::dtype})) {
+    return toIValue(node->namedInput(attr::dtype))->isNone();
+  }
+  return node->matches(
+      "aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight=None, Tensor? bias=None, float eps=1e-05, bool cudnn_enable=True) -> Tensor",
+      {attr::normalized_shape, attr::eps});
+}
+
 bool isSupported(Node* node) {
   // TODO:
   switch (node->kind()) {
@@ -93,6 +121,12 @@ bool isSupported(Node* node) {
         return false;
       }
       return true;
+    case aten::sum:
+    case aten::mean:
+    case aten::softmax:
+    case aten::log_softmax:
+    case aten::layer_norm:
+      return isSupportedReduction(node);
     default:
       return false;
   }
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/backends/backend_init.h>
 #include <torch/csrc/jit/codegen/fuser/interface.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
+#include <torch/csrc/jit/frontend/compilation_cache.h>
 #include <torch/csrc/jit/frontend/ir_emitter.h>
 #include <torch/csrc/jit/frontend/tracer.h>
 #include <torch/csrc/jit/ir/irparser.h>
@@ -20,6 +21,9 @@
 #include <torch/csrc/jit/passes/erase_number_types.h>
 #include <torch/csrc/jit/passes/fold_conv_bn.h>
 #include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/frozen_ops_to_mkldnn.h>
+#include <torch/csrc/jit/passes/frozen_epilogue_fusion.h>
+#include <torch/csrc/jit/passes/frozen_weight_prepacking.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
 #include <torch/csrc/jit/passes/fuse_relu.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
@@ -28,6 +32,7 @@
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/normalize_ops.h>
 #include <torch/csrc/jit/passes/onnx.h>
 #include <torch/csrc/jit/passes/onnx/cast_all_constant_to_floating.h>
@@ -188,6 +193,11 @@ void initJITBindings(PyObject* module) {
           [](std::shared_ptr<Graph>& g) {
             return FuseQuantizedAddRelu(g); // overload resolution
           })
+      .def(
+          "_jit_pass_fuse_quantized_conv_add",
+          [](std::shared_ptr<Graph>& g) {
+            return FuseQuantizedConvAdd(g); // overload resolution
+          })
       .def(
           "_jit_pass_insert_observers",
           [](Module& module,
@@ -240,6 +250,11 @@ void initJITBindings(PyObject* module) {
           },
           py::arg("module"),
           py::arg("preservedAttrs") = std::vector<std::string>())
+      .def(
+          "_jit_pass_convert_frozen_ops_to_mkldnn",
+          &ConvertFrozenOpsToMKLDNN)
+      .def("_jit_pass_prepack_frozen_weights", &PrepackFrozenWeights)
+      .def("_jit_pass_fuse_frozen_epilogues", &FuseFrozenEpilogues)
       .def("_jit_pass_fuse_linear", &FuseLinear)
       .def(
           "_jit_pass_fuse_add_relu",
@@ -457,6 +472,12 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_get_inline_everything_mode",
           []() { return getInlineEverythingMode(); })
+      .def(
+          "_jit_set_compilation_cache_dir",
+          [](const std::string& dir) { getCompilationCacheDir() = dir; })
+      .def(
+          "_jit_get_compilation_cache_dir",
+          []() { return getCompilationCacheDir(); })
       .def(
           "_jit_try_infer_type",
           [](py::object obj) -> TypePtr {
@@ -510,6 +531,30 @@ void initJITBindings(PyObject* module) {
             using namespace torch::jit::tensorexpr;
             return getTECudaPointwiseBlockSize() = block_size;
           })
+      .def(
+          "_jit_get_te_kernel_cache_size",
+          []() -> int {
+            using namespace torch::jit::tensorexpr;
+            return getTEKernelCacheSize();
+          })
+      .def(
+          "_jit_set_te_kernel_cache_size",
+          [](int size) {
+            using namespace torch::jit::tensorexpr;
+            return getTEKernelCacheSize() = size;
+          })
+      .def(
+          "_jit_get_te_llvm_cache_dir",
+          []() -> std::string {
+            using namespace torch::jit::tensorexpr;
+            return getTELLVMCacheDir();
+          })
+      .def(
+          "_jit_set_te_llvm_cache_dir",
+          [](const std::string& dir) {
+            using namespace torch::jit::tensorexpr;
+            getTELLVMCacheDir() = dir;
+          })
       .def("_jit_set_texpr_fuser_enabled", &setTensorExprFuserEnabled)
       .def("_jit_texpr_fuser_enabled", &tensorExprFuserEnabled)
       .def("_jit_texpr_fallback_allowed", &tensorexpr::fallbackAllowed)
@@ -525,6 +570,7 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_remove_dropout",
           [](script::Module& module) { return removeDropout(module); })
+      .def("_jit_pass_plan_memory", PlanMemory)
       .def(
           "_jit_pass_insert_prepacked_ops",
           [](std::shared_ptr<Graph>& graph) {
@@ -680,6 +726,8 @@ void initJITBindings(PyObject* module) {
       .def(py::init<std::string>())
       .def(py::init([](const py::object& buffer) {
         auto writer_func = [=](const void* data, size_t size) {
+          // write_record releases the GIL.
+          py::gil_scoped_acquire acquire;
           auto bytes = py::bytes(reinterpret_cast<const char*>(data), size);
           buffer.attr("write")(std::move(bytes));
           return size;
@@ -692,8 +740,14 @@ void initJITBindings(PyObject* module) {
           [](PyTorchStreamWriter& self,
              const std::string& name,
              const char* data,
-             size_t size) { return self.writeRecord(name, data, size); })
-      .def("write_end_of_file", &PyTorchStreamWriter::writeEndOfFile)
+             size_t size) { return self.writeRecord(name, data, size); },
+          // Checksumming and writing large records doesn't need the GIL, which
+          // lets torch.serialization.async_save run next to training.
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "write_end_of_file",
+          &PyTorchStreamWriter::writeEndOfFile,
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "write_record",
           [](PyTorchStreamWriter& self,
@@ -702,7 +756,8 @@ void initJITBindings(PyObject* module) {
              size_t size) {
             return self.writeRecord(
                 name, reinterpret_cast<const char*>(data), size);
-          });
+          },
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<MobileOptimizerType>(m, "MobileOptimizerType")
       .value("CONV_BN_FUSION", MobileOptimizerType::CONV_BN_FUSION)
@@ -691,6 +691,14 @@ GraphExecutorState GraphExecutor::getDebugState() {
   return pImpl->getDebugState();
 }
 
+IValue GraphExecutor::getProfile() {
+  return pImpl->getProfile();
+}
+
+bool GraphExecutor::loadProfile(const IValue& profile) {
+  return pImpl->loadProfile(profile);
+}
+
 TORCH_API bool IsNewExecutorEnabled() {
   static const auto disable_new_executor =
       std::getenv("TORCH_JIT_DISABLE_NEW_EXECUTOR");
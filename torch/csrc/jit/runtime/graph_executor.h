@@ -70,6 +70,15 @@ struct TORCH_API GraphExecutor {
   std::shared_ptr<Graph> graph() const;
   GraphExecutorState getDebugState();
 
+  // The types a profiling executor profiled and specialized its optimized plan
+  // for, or None until it has built that plan. Loading them into an executor
+  // of the same graph, e.g. after the module is saved and loaded again, builds
+  // its optimized plan right away, skipping the profiling runs; the plan still
+  // bails out of the inputs its guards reject. Returns false if the executor
+  // doesn't profile or the profile doesn't match its graph.
+  IValue getProfile();
+  bool loadProfile(const IValue& profile);
+
   static size_t getDefaultNumBailOuts();
 
  private:
@@ -72,6 +72,12 @@ struct GraphExecutorImplBase {
       Stack& stack,
       size_t remaining_bailout_depth) = 0;
   virtual GraphExecutorState getDebugState() = 0;
+  virtual IValue getProfile() {
+    return IValue();
+  }
+  virtual bool loadProfile(const IValue& profile) {
+    return false;
+  }
   virtual ~GraphExecutorImplBase() = default;
 
  protected:
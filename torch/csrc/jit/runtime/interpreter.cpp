@@ -28,6 +28,7 @@
 using torch::distributed::autograd::DistAutogradContainer;
 #endif
 
+#include <atomic>
 #include <exception>
 #include <iostream>
 #include <memory>
@@ -429,6 +430,10 @@ struct CodeImpl {
       profile_function_table_;
 
   int register_size_ = 0;
+  // Capacity the stack needed on previous runs, so that later runs can
+  // reserve it upfront instead of growing the stack op by op. Only a hint,
+  // runs on several threads may race on it.
+  std::atomic<size_t> stack_size_hint_{0};
   size_t n_outputs;
   size_t n_inputs;
   TypePtr return_type_;
@@ -969,9 +974,25 @@ struct CodeImpl {
 // InterpreterState state that and used to compute a Code
 struct InterpreterStateImpl : c10::intrusive_ptr_target {
   InterpreterStateImpl(const Code& code) {
+    // Reuse the buffers of a run that finished on this thread.
+    auto& cache = buffer_cache();
+    registers.swap(cache.registers);
+    frames.swap(cache.frames);
     enterFrame(code, 0);
   }
 
+  ~InterpreterStateImpl() override {
+    registers.clear();
+    frames.clear();
+    auto& cache = buffer_cache();
+    if (registers.capacity() > cache.registers.capacity()) {
+      registers.swap(cache.registers);
+    }
+    if (frames.capacity() > cache.frames.capacity()) {
+      frames.swap(cache.frames);
+    }
+  }
+
  private:
   // if we need to suspend, where do we reset the stack?
   // answer: to where it was when we were called, not
@@ -1042,6 +1063,18 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
 
   std::vector<Frame> frames;
 
+  // Empty registers and frames, kept with their capacity between runs on
+  // the same thread so that most runs don't allocate them.
+  struct BufferCache {
+    std::vector<IValue> registers;
+    std::vector<Frame> frames;
+  };
+
+  static BufferCache& buffer_cache() {
+    static thread_local BufferCache cache;
+    return cache;
+  }
+
   c10::intrusive_ptr<InterpreterStateImpl> intrusive_from_this() {
     c10::raw::intrusive_ptr::incref(this);
     return c10::intrusive_ptr<InterpreterStateImpl>::reclaim(this);
@@ -1118,6 +1151,10 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     if (stack_start_ == -1) {
       TORCH_INTERNAL_ASSERT(stack.size() >= frames.back().function->n_inputs);
       stack_start_ = stack.size() - frames.back().function->n_inputs;
+      stack.reserve(
+          stack_start_ +
+          frames.back().function->stack_size_hint_.load(
+              std::memory_order_relaxed));
     } else {
       // during restarts, all of the stack is always our own, so we leave
       // nothing
@@ -1261,6 +1298,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               af = ActiveFrame(frames.back());
               break;
             }
+            recordStackSize(stack);
             if (future_) {
               auto num_outputs = frames.back().function->n_outputs;
               if (num_outputs == 1) {
@@ -1490,6 +1528,14 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     }
   }
 
+  void recordStackSize(const Stack& stack) {
+    auto& hint = frames.front().function->stack_size_hint_;
+    const size_t size = stack.capacity() - stack_start_;
+    if (size > hint.load(std::memory_order_relaxed)) {
+      hint.store(size, std::memory_order_relaxed);
+    }
+  }
+
   void formatStackTrace(std::ostream& out) {
     std::vector<StackEntry> entries;
     for (size_t i = 0; i < frames.size(); ++i) {
@@ -1545,6 +1591,11 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
 
   void run(Stack& stack) {
     if (runImpl(stack)) {
+      // On an inter-op thread, the forks this wait is for may still be
+      // queued behind it. Run queued tasks instead of blocking, so that
+      // nested forks don't use up the pool.
+      while (!future_->completed() && at::internal::run_pending_interop_task()) {
+      }
       future_->wait();
 
       auto num_outputs = frames.front().function->n_outputs;
@@ -174,15 +174,7 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
 
   // if a profiling graph hasn't been created yet
   if (!pr_) {
-    auto copy = graph->copy();
-    runProfilingInsensitiveOptimizations(copy);
-    if (remaining_bailout_depth == getBailoutDepth()) {
-      PeelProfilingLoops(copy);
-    }
-    pr_ = ProfilingRecord::instrumentGraph(copy);
-    auto pr_copy = pr_->graph()->copy();
-    GRAPH_DUMP("Profiled Graph: ", pr_copy);
-    profiling_plan_ = ExecutionPlan(pr_copy, function_name_);
+    createProfilingPlan(remaining_bailout_depth);
     // fall-through
   }
 
@@ -191,6 +183,24 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     return *profiling_plan_;
   }
 
+  return createOptimizedPlan(remaining_bailout_depth);
+}
+
+void ProfilingGraphExecutorImpl::createProfilingPlan(
+    size_t remaining_bailout_depth) {
+  auto copy = graph->copy();
+  runProfilingInsensitiveOptimizations(copy);
+  if (remaining_bailout_depth == getBailoutDepth()) {
+    PeelProfilingLoops(copy);
+  }
+  pr_ = ProfilingRecord::instrumentGraph(copy);
+  auto pr_copy = pr_->graph()->copy();
+  GRAPH_DUMP("Profiled Graph: ", pr_copy);
+  profiling_plan_ = ExecutionPlan(pr_copy, function_name_);
+}
+
+const ExecutionPlan& ProfilingGraphExecutorImpl::createOptimizedPlan(
+    size_t remaining_bailout_depth) {
   auto copy = pr_->graph()->copy();
   runProfilingOptimizations(copy);
   // cache
@@ -199,6 +209,181 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
   return *optimized_plan_;
 }
 
+// A profile is a list with, for each prim::profile node of the profiled graph
+// in order, the kind of the node using its output and the type profiled for
+// it: a tuple of its scalar type, device, sizes, strides, requires_grad and
+// undefined properties, each None if unknown. The sizes that vary are
+// negative, numbering their shape symbols across the profile, and the strides
+// are (stride_index, contiguous, stride) tuples.
+
+static std::string profiledUserKind(Value* v) {
+  return v->uses().empty() ? "" : v->uses()[0].user->kind().toQualString();
+}
+
+static IValue encodeSize(const c10::optional<size_t>& size) {
+  return size ? IValue(static_cast<int64_t>(*size)) : IValue();
+}
+
+static IValue encodeBool(const c10::optional<bool>& value) {
+  return value ? IValue(*value) : IValue();
+}
+
+static IValue encodeTensorType(
+    const TensorTypePtr& type,
+    std::map<c10::ShapeSymbol, int64_t>& symbols) {
+  IValue scalar_type = type->scalarType()
+      ? IValue(static_cast<int64_t>(*type->scalarType()))
+      : IValue();
+  IValue device = type->device() ? IValue(type->device()->str()) : IValue();
+  IValue sizes;
+  if (auto dims = type->symbolic_sizes().sizes()) {
+    c10::List<int64_t> encoded;
+    for (const c10::ShapeSymbol& dim : *dims) {
+      if (dim.is_static()) {
+        encoded.push_back(dim.static_size());
+      } else {
+        const int64_t id = -static_cast<int64_t>(symbols.size()) - 1;
+        encoded.push_back(symbols.emplace(dim, id).first->second);
+      }
+    }
+    sizes = encoded;
+  }
+  IValue strides;
+  if (const auto& props = type->stride_properties().sizes()) {
+    c10::impl::GenericList encoded(AnyType::get());
+    for (const auto& stride : *props) {
+      if (!stride) {
+        encoded.emplace_back();
+        continue;
+      }
+      encoded.emplace_back(c10::ivalue::Tuple::create(
+          {encodeSize(stride->stride_index_),
+           encodeBool(stride->contiguous_),
+           encodeSize(stride->stride_)}));
+    }
+    strides = encoded;
+  }
+  return c10::ivalue::Tuple::create(
+      {scalar_type,
+       device,
+       sizes,
+       strides,
+       encodeBool(type->requiresGrad()),
+       encodeBool(type->undefined())});
+}
+
+static c10::optional<size_t> decodeSize(const IValue& v) {
+  return v.isNone() ? c10::nullopt
+                    : c10::optional<size_t>(static_cast<size_t>(v.toInt()));
+}
+
+static c10::optional<bool> decodeBool(const IValue& v) {
+  return v.isNone() ? c10::nullopt : c10::optional<bool>(v.toBool());
+}
+
+static TensorTypePtr decodeTensorType(
+    const IValue& v,
+    std::map<int64_t, c10::ShapeSymbol>& symbols) {
+  const auto& elements = v.toTuple()->elements();
+  TORCH_CHECK(elements.size() == 6, "Malformed profiled tensor type");
+  c10::optional<at::ScalarType> scalar_type;
+  if (!elements[0].isNone()) {
+    scalar_type = static_cast<at::ScalarType>(elements[0].toInt());
+  }
+  c10::optional<at::Device> device;
+  if (!elements[1].isNone()) {
+    device = at::Device(elements[1].toStringRef());
+  }
+  c10::SymbolicShape sizes;
+  if (!elements[2].isNone()) {
+    std::vector<c10::ShapeSymbol> dims;
+    for (int64_t dim : elements[2].toIntVector()) {
+      if (dim >= 0) {
+        dims.push_back(c10::ShapeSymbol::fromStaticSize(dim));
+      } else {
+        auto it = symbols.find(dim);
+        if (it == symbols.end()) {
+          it = symbols.emplace(dim, c10::ShapeSymbol::newSymbol()).first;
+        }
+        dims.push_back(it->second);
+      }
+    }
+    sizes = c10::SymbolicShape(dims);
+  }
+  c10::VaryingShape<c10::Stride> strides;
+  if (!elements[3].isNone()) {
+    std::vector<c10::optional<c10::Stride>> props;
+    for (const IValue& stride : elements[3].toListRef()) {
+      if (stride.isNone()) {
+        props.emplace_back();
+        continue;
+      }
+      const auto& fields = stride.toTuple()->elements();
+      TORCH_CHECK(fields.size() == 3, "Malformed profiled tensor strides");
+      props.emplace_back(c10::Stride(
+          decodeSize(fields[0]), decodeBool(fields[1]), decodeSize(fields[2])));
+    }
+    strides = c10::VaryingShape<c10::Stride>(props);
+  }
+  return TensorType::create(
+      scalar_type,
+      device,
+      sizes,
+      strides,
+      decodeBool(elements[4]),
+      decodeBool(elements[5]));
+}
+
+IValue ProfilingGraphExecutorImpl::getProfile() {
+  std::lock_guard<std::mutex> lock(compile_mutex);
+  if (!pr_ || !pr_->ready()) {
+    return IValue();
+  }
+  c10::impl::GenericList profile(AnyType::get());
+  std::map<c10::ShapeSymbol, int64_t> symbols;
+  for (Value* v : pr_->profiledValues()) {
+    profile.emplace_back(c10::ivalue::Tuple::create(
+        {profiledUserKind(v),
+         encodeTensorType(v->type()->expect<TensorType>(), symbols)}));
+  }
+  return profile;
+}
+
+bool ProfilingGraphExecutorImpl::loadProfile(const IValue& profile) {
+  std::lock_guard<std::mutex> lock(compile_mutex);
+  const size_t remaining_bailout_depth = GraphExecutor::getDefaultNumBailOuts();
+  if (optimized_plan_ || remaining_bailout_depth == 0) {
+    return false;
+  }
+  if (!pr_) {
+    createProfilingPlan(remaining_bailout_depth);
+  }
+
+  // The graph must be profiled at the same values, used by the same ops.
+  auto values = pr_->profiledValues();
+  auto entries = profile.toListRef();
+  if (entries.size() != values.size()) {
+    return false;
+  }
+  std::vector<TensorTypePtr> types;
+  std::map<int64_t, c10::ShapeSymbol> symbols;
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto& entry = entries[i].toTuple()->elements();
+    TORCH_CHECK(entry.size() == 2, "Malformed profile");
+    if (entry[0].toStringRef() != profiledUserKind(values[i])) {
+      return false;
+    }
+    types.push_back(decodeTensorType(entry[1], symbols));
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i]->setType(types[i]);
+  }
+  pr_->markReady();
+  GRAPH_DEBUG("Loaded the profile of ProfilingGraphExecutorImpl ", this);
+  createOptimizedPlan(remaining_bailout_depth);
+  return true;
+}
+
 GraphExecutorState ProfilingGraphExecutorImpl::getDebugState() {
   GraphExecutorState state;
   TORCH_INTERNAL_ASSERT(optimized_plan_);
@@ -12,9 +12,13 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   ExecutionPlan getPlanFor(Stack& stack, size_t remaining_bailout_depth)
       override;
   GraphExecutorState getDebugState() override;
+  IValue getProfile() override;
+  bool loadProfile(const IValue& profile) override;
   ~ProfilingGraphExecutorImpl() override = default;
 
  private:
+  void createProfilingPlan(size_t remaining_bailout_depth);
+  const ExecutionPlan& createOptimizedPlan(size_t remaining_bailout_depth);
   void runProfilingInsensitiveOptimizations(std::shared_ptr<Graph>& graph);
   void runProfilingOptimizations(std::shared_ptr<Graph>& graph);
   std::unique_ptr<ProfilingRecord> pr_;
@@ -217,6 +217,23 @@ void ProfilingRecord::instrumentBlock(Block* block) {
   }
 }
 
+static void collectProfiledValues(Block* block, std::vector<Value*>& values) {
+  for (Node* n : block->nodes()) {
+    if (n->kind() == prim::profile && n->outputs().size() == 1) {
+      values.push_back(n->output());
+    }
+    for (Block* b : n->blocks()) {
+      collectProfiledValues(b, values);
+    }
+  }
+}
+
+std::vector<Value*> ProfilingRecord::profiledValues() const {
+  std::vector<Value*> values;
+  collectProfiledValues(profiled_graph_->block(), values);
+  return values;
+}
+
 std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
     const std::shared_ptr<Graph>& graph) {
   auto new_g = graph->copy();
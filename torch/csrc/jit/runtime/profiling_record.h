@@ -196,6 +196,17 @@ struct ProfilingRecord {
   bool ready() const {
     return profiling_count_ == 0;
   }
+
+  // Ends profiling, e.g. once the types of profiledValues() are set to the
+  // ones profiled by a previous run of the same graph.
+  void markReady() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profiling_count_ = 0;
+  }
+
+  // The outputs of the prim::profile nodes of the graph, in the order they
+  // are found in, whose types are the profiled ones once ready.
+  std::vector<Value*> profiledValues() const;
   std::shared_ptr<Graph> graph() const {
     return profiled_graph_;
   }
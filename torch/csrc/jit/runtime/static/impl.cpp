@@ -0,0 +1,167 @@
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/inliner.h>
+
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+ProcessedNode::ProcessedNode(
+    Node* node,
+    std::vector<size_t> inputs,
+    std::vector<size_t> outputs)
+    : node_(node),
+      inputs_(std::move(inputs)),
+      outputs_(std::move(outputs)),
+      op_(node->getOperation()),
+      kernel_(getNativeKernel(node)) {}
+
+void ProcessedNode::run(std::vector<IValue>& reg, Stack& stack) const {
+  if (kernel_ && kernel_(this, reg)) {
+    return;
+  }
+  runBoxed(reg, stack);
+}
+
+void ProcessedNode::runBoxed(std::vector<IValue>& reg, Stack& stack) const {
+  stack.clear();
+  for (size_t input : inputs_) {
+    stack.push_back(reg[input]);
+  }
+  op_(&stack);
+  TORCH_INTERNAL_ASSERT(
+      stack.size() == outputs_.size(),
+      node_->kind().toQualString(),
+      " returned ",
+      stack.size(),
+      " values, expected ",
+      outputs_.size());
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    reg[outputs_[i]] = std::move(stack[i]);
+  }
+  stack.clear();
+}
+
+StaticRuntime::StaticRuntime(std::shared_ptr<Graph> graph)
+    : graph_(graph->copy()) {
+  init();
+}
+
+StaticRuntime::StaticRuntime(const Module& module) {
+  TORCH_CHECK(
+      !module.is_training(), "StaticRuntime: the module must be in eval mode");
+  auto frozen = freeze_module(module);
+  graph_ = frozen.get_method("forward").graph()->copy();
+  TORCH_CHECK(
+      !graph_->inputs().empty() && !graph_->inputs()[0]->hasUses(),
+      "StaticRuntime: the forward method of the frozen module still uses ",
+      "self, which is only possible if it mutates the module");
+  graph_->eraseInput(0);
+  init();
+}
+
+void StaticRuntime::init() {
+  Inline(*graph_);
+  ConstantPropagation(graph_);
+  EliminateDeadCode(graph_);
+
+  std::unordered_map<Value*, size_t> value_to_reg;
+  auto newReg = [&](Value* value) {
+    const size_t index = value_to_reg.size();
+    value_to_reg[value] = index;
+    return index;
+  };
+  for (Value* input : graph_->inputs()) {
+    input_regs_.push_back(newReg(input));
+  }
+  std::vector<std::pair<size_t, IValue>> constants;
+  for (Node* node : graph_->nodes()) {
+    TORCH_CHECK(
+        node->blocks().empty(),
+        "StaticRuntime only runs straight-line graphs, but found ",
+        node->kind().toQualString());
+    if (node->kind() == prim::Constant) {
+      auto value = toIValue(node->output());
+      TORCH_CHECK(
+          value,
+          "StaticRuntime: unsupported constant of type ",
+          node->output()->type()->str());
+      constants.emplace_back(newReg(node->output()), std::move(*value));
+      continue;
+    }
+    std::vector<size_t> inputs;
+    for (Value* input : node->inputs()) {
+      inputs.push_back(value_to_reg.at(input));
+    }
+    std::vector<size_t> outputs;
+    for (Value* output : node->outputs()) {
+      outputs.push_back(newReg(output));
+    }
+    temporary_regs_.insert(
+        temporary_regs_.end(), outputs.begin(), outputs.end());
+    nodes_.emplace_back(node, std::move(inputs), std::move(outputs));
+  }
+  for (Value* output : graph_->outputs()) {
+    output_regs_.push_back(value_to_reg.at(output));
+  }
+
+  reg_.resize(value_to_reg.size());
+  for (auto& constant : constants) {
+    reg_[constant.first] = std::move(constant.second);
+  }
+}
+
+std::vector<IValue> StaticRuntime::run(std::vector<IValue> inputs) {
+  TORCH_CHECK(
+      inputs.size() == input_regs_.size(),
+      "StaticRuntime: expected ",
+      input_regs_.size(),
+      " inputs, but got ",
+      inputs.size());
+  torch::autograd::AutoGradMode no_grad(false);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    reg_[input_regs_[i]] = std::move(inputs[i]);
+  }
+  for (const auto& node : nodes_) {
+    node.run(reg_, stack_);
+  }
+
+  std::vector<IValue> outputs;
+  outputs.reserve(output_regs_.size());
+  for (size_t output : output_regs_) {
+    outputs.push_back(reg_[output]);
+  }
+  // Don't keep the inputs and the intermediate values alive between runs.
+  for (size_t input : input_regs_) {
+    reg_[input] = IValue();
+  }
+  for (size_t temporary : temporary_regs_) {
+    reg_[temporary] = IValue();
+  }
+  return outputs;
+}
+
+std::vector<at::Tensor> StaticRuntime::run(
+    const std::vector<at::Tensor>& inputs) {
+  std::vector<IValue> outputs =
+      run(std::vector<IValue>(inputs.begin(), inputs.end()));
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(outputs.size());
+  for (auto& output : outputs) {
+    TORCH_CHECK(
+        output.isTensor(),
+        "StaticRuntime: expected tensor outputs, but got ",
+        output.tagKind());
+    tensors.push_back(std::move(output).toTensor());
+  }
+  return tensors;
+}
+
+} // namespace jit
+} // namespace torch
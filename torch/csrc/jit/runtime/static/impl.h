@@ -0,0 +1,100 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// A node of the graph of a StaticRuntime, with the registers it reads its
+// inputs from and writes its outputs to fixed when the runtime is created.
+class ProcessedNode {
+ public:
+  ProcessedNode(
+      Node* node,
+      std::vector<size_t> inputs,
+      std::vector<size_t> outputs);
+
+  void run(std::vector<IValue>& reg, Stack& stack) const;
+
+  const Node* node() const {
+    return node_;
+  }
+
+  const IValue& input(size_t i, const std::vector<IValue>& reg) const {
+    return reg[inputs_[i]];
+  }
+
+  IValue& output(size_t i, std::vector<IValue>& reg) const {
+    return reg[outputs_[i]];
+  }
+
+  // Whether the op runs through an unboxed kernel of ops.h rather than its
+  // Operation.
+  bool hasNativeKernel() const {
+    return static_cast<bool>(kernel_);
+  }
+
+ private:
+  void runBoxed(std::vector<IValue>& reg, Stack& stack) const;
+
+  Node* node_;
+  std::vector<size_t> inputs_;
+  std::vector<size_t> outputs_;
+  Operation op_;
+  SROperator kernel_;
+};
+
+// An executor for straight-line inference graphs, e.g. the forward method of
+// a frozen module, that doesn't have the per op overhead of the interpreter.
+//
+// Every value of the graph is given a register when the runtime is created,
+// constants are loaded into theirs once, and each node reads its inputs and
+// writes its outputs at fixed registers. The common ops on dense CPU tensors
+// call their ATen CPU kernels directly, skipping the dispatcher, autograd and
+// the boxing of their arguments on a Stack; the others run through their
+// Operation. The graph must not have blocks, and runs with grad mode
+// disabled.
+//
+// A StaticRuntime is not thread safe; create one per thread from the same
+// graph to run it concurrently.
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(std::shared_ptr<Graph> graph);
+
+  // Freezes and inlines the forward method of module, which must be in eval
+  // mode.
+  explicit StaticRuntime(const Module& module);
+
+  std::vector<IValue> run(std::vector<IValue> inputs);
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+
+  const std::vector<ProcessedNode>& nodes() const {
+    return nodes_;
+  }
+
+ private:
+  void init();
+
+  std::shared_ptr<Graph> graph_;
+  std::vector<ProcessedNode> nodes_;
+  std::vector<size_t> input_regs_;
+  std::vector<size_t> output_regs_;
+  // Registers that hold neither constants nor inputs, cleared after each run.
+  std::vector<size_t> temporary_regs_;
+  std::vector<IValue> reg_;
+  Stack stack_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,104 @@
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <ATen/NativeFunctions.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// The kernels below are the CPU implementations of their ops, so they may only
+// be called on dense CPU tensors.
+bool isDenseCPU(const at::Tensor& tensor) {
+  return tensor.device().is_cpu() && tensor.layout() == at::kStrided &&
+      !tensor.is_quantized();
+}
+
+template <at::Tensor (*F)(const at::Tensor&)>
+SROperator unaryKernel() {
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto self = p_node->input(0, reg).toTensor();
+    if (!isDenseCPU(self)) {
+      return false;
+    }
+    p_node->output(0, reg) = F(self);
+    return true;
+  };
+}
+
+template <at::Tensor (*F)(const at::Tensor&, const at::Tensor&)>
+SROperator binaryKernel() {
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto self = p_node->input(0, reg).toTensor();
+    auto other = p_node->input(1, reg).toTensor();
+    if (!isDenseCPU(self) || !isDenseCPU(other)) {
+      return false;
+    }
+    p_node->output(0, reg) = F(self, other);
+    return true;
+  };
+}
+
+template <at::Tensor (*F)(const at::Tensor&, const at::Tensor&, at::Scalar)>
+SROperator binaryWithAlphaKernel() {
+  return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+    auto self = p_node->input(0, reg).toTensor();
+    auto other = p_node->input(1, reg).toTensor();
+    if (!isDenseCPU(self) || !isDenseCPU(other)) {
+      return false;
+    }
+    p_node->output(0, reg) = F(self, other, p_node->input(2, reg).toScalar());
+    return true;
+  };
+}
+
+} // namespace
+
+SROperator getNativeKernel(const Node* node) {
+  if (node->matches(
+          "aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor")) {
+    return binaryWithAlphaKernel<at::native::add>();
+  }
+  if (node->matches(
+          "aten::sub.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor")) {
+    return binaryWithAlphaKernel<at::native::sub>();
+  }
+  if (node->matches("aten::mul.Tensor(Tensor self, Tensor other) -> Tensor")) {
+    return binaryKernel<at::native::mul>();
+  }
+  if (node->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor")) {
+    return binaryKernel<at::native::mm_cpu>();
+  }
+  if (node->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor")) {
+    return [](const ProcessedNode* p_node, std::vector<IValue>& reg) {
+      auto self = p_node->input(0, reg).toTensor();
+      auto mat1 = p_node->input(1, reg).toTensor();
+      auto mat2 = p_node->input(2, reg).toTensor();
+      if (!isDenseCPU(self) || !isDenseCPU(mat1) || !isDenseCPU(mat2)) {
+        return false;
+      }
+      p_node->output(0, reg) = at::native::addmm_cpu(
+          self,
+          mat1,
+          mat2,
+          p_node->input(3, reg).toScalar(),
+          p_node->input(4, reg).toScalar());
+      return true;
+    };
+  }
+  if (node->matches("aten::relu(Tensor self) -> Tensor")) {
+    return unaryKernel<at::native::relu>();
+  }
+  if (node->matches("aten::sigmoid(Tensor self) -> Tensor")) {
+    return unaryKernel<at::native::sigmoid>();
+  }
+  if (node->matches("aten::tanh(Tensor self) -> Tensor")) {
+    return unaryKernel<at::native::tanh>();
+  }
+  return nullptr;
+}
+
+} // namespace jit
+} // namespace torch
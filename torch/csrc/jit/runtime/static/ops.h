@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <functional>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+class ProcessedNode;
+
+// An unboxed kernel for the op of a ProcessedNode, reading its inputs from and
+// writing its outputs to the registers of a StaticRuntime. Returns false,
+// without writing anything, when it can't handle the inputs it is given, in
+// which case the op is run through its Operation instead.
+using SROperator =
+    std::function<bool(const ProcessedNode*, std::vector<IValue>&)>;
+
+// The unboxed kernel for node, or an empty function if its op doesn't have
+// one.
+SROperator getNativeKernel(const Node* node);
+
+} // namespace jit
+} // namespace torch
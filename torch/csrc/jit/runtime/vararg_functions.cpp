@@ -3,9 +3,52 @@
 namespace torch {
 namespace jit {
 
+namespace {
+
+// The element vectors of the last tuples this thread unpacked, which the
+// next tuples it constructs reuse. Returning and unpacking a tuple through
+// the interpreter then allocates the Tuple, but not its elements.
+constexpr size_t kMaxCachedTupleElements = 8;
+constexpr size_t kMaxCachedTupleCapacity = 16;
+thread_local std::vector<std::vector<IValue>> cached_tuple_elements;
+
+std::vector<IValue> takeTupleElements(size_t size) {
+  if (cached_tuple_elements.empty() || size > kMaxCachedTupleCapacity) {
+    std::vector<IValue> elements;
+    elements.reserve(size);
+    return elements;
+  }
+  auto elements = std::move(cached_tuple_elements.back());
+  cached_tuple_elements.pop_back();
+  elements.reserve(size);
+  return elements;
+}
+
+void cacheTupleElements(std::vector<IValue>&& elements) {
+  if (cached_tuple_elements.size() < kMaxCachedTupleElements &&
+      elements.capacity() > 0 &&
+      elements.capacity() <= kMaxCachedTupleCapacity) {
+    elements.clear();
+    cached_tuple_elements.push_back(std::move(elements));
+  }
+}
+
+} // namespace
+
 void tupleUnpack(Stack& stack) {
   auto tuple = pop(stack).toTuple();
-  stack.insert(stack.end(), tuple->elements().begin(), tuple->elements().end());
+  auto& elements = tuple->elements();
+  if (tuple.unique()) {
+    // Nothing else refers to the tuple, so its elements are moved out
+    // instead of copied, saving their refcount updates
+    stack.insert(
+        stack.end(),
+        std::make_move_iterator(elements.begin()),
+        std::make_move_iterator(elements.end()));
+    cacheTupleElements(std::move(elements));
+  } else {
+    stack.insert(stack.end(), elements.begin(), elements.end());
+  }
 }
 
 void format(Stack& stack, size_t num_inputs) {
@@ -46,12 +89,21 @@ void listUnpack(Stack& stack, size_t num_outputs) {
       num_outputs,
       " elements in a list but found ",
       list.size());
-  stack.insert(stack.end(), list.begin(), list.end());
+  if (list.use_count() == 1) {
+    for (size_t i = 0; i < num_outputs; ++i) {
+      stack.push_back(list.extract(i));
+    }
+  } else {
+    stack.insert(stack.end(), list.begin(), list.end());
+  }
 }
 
 void tupleConstruct(Stack& stack, size_t num_inputs) {
-  std::vector<IValue> elems{std::make_move_iterator(stack.end() - num_inputs),
-                            std::make_move_iterator(stack.end())};
+  auto elems = takeTupleElements(num_inputs);
+  elems.insert(
+      elems.end(),
+      std::make_move_iterator(stack.end() - num_inputs),
+      std::make_move_iterator(stack.end()));
   drop(stack, num_inputs);
   push(stack, c10::ivalue::Tuple::create(std::move(elems)));
 }
@@ -60,8 +112,11 @@ void namedTupleConstruct(
     Stack& stack,
     at::TupleTypePtr type,
     size_t num_inputs) {
-  std::vector<IValue> elems{std::make_move_iterator(stack.end() - num_inputs),
-                            std::make_move_iterator(stack.end())};
+  auto elems = takeTupleElements(num_inputs);
+  elems.insert(
+      elems.end(),
+      std::make_move_iterator(stack.end() - num_inputs),
+      std::make_move_iterator(stack.end()));
   drop(stack, num_inputs);
   push(
       stack,
@@ -116,8 +171,7 @@ void isinstance(Stack& stack, at::ArrayRef<at::TypePtr> types) {
 
 void tupleSlice(Stack& stack, size_t begin, size_t end) {
   auto tuple = pop(stack).toTuple();
-  std::vector<IValue> output_elems;
-  output_elems.reserve(end - begin);
+  auto output_elems = takeTupleElements(end - begin);
   for (size_t i = begin; i < end; ++i) {
     output_elems.emplace_back(tuple->elements()[i]);
   }
@@ -164,7 +164,13 @@ void CreateExternalFile(
         std::string("ONNX export failed. Could not open file or directory: ") +
         fullFilePath);
   }
-  fwrite(tensor.data_ptr(), tensor.element_size(), tensor.numel(), fp.get());
+  // Written straight from the storage of the tensor, which is contiguous.
+  const size_t num_bytes = tensor.element_size() * tensor.numel();
+  if (fwrite(tensor.data_ptr(), 1, num_bytes, fp.get()) != num_bytes) {
+    throw std::runtime_error(
+        std::string("ONNX export failed. Could not write to file: ") +
+        fullFilePath);
+  }
 } // fclose() called here through CloseFile(), if FILE* is not a null pointer.
 
 class EncoderBase {
@@ -173,7 +179,9 @@ class EncoderBase {
       onnx_torch::OperatorExportTypes operator_export_type,
       bool strip_doc);
 
-  onnx::ModelProto get_model_proto() {
+  // The proto holds the initializers that aren't stored externally, so it
+  // isn't copied.
+  const onnx::ModelProto& get_model_proto() const {
     return model_proto_;
   }
 
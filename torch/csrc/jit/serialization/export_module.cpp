@@ -195,6 +195,7 @@ class ScriptModuleSerializer {
     std::vector<IValue> ivalue_constants(
         constant_table_.begin(), constant_table_.end());
     writeArchive("constants", c10::ivalue::Tuple::create(ivalue_constants));
+    writeExecutorProfiles(module);
     if (bytecode_format) {
       writeByteCode(module);
     }
@@ -238,6 +239,31 @@ class ScriptModuleSerializer {
     }
   }
 
+  // The profiles of the executors of the methods that ran under the profiling
+  // executor, keyed by the path of the method in the module, so that the
+  // methods of the loaded module start on their optimized plans.
+  void writeExecutorProfiles(const Module& module) {
+    c10::Dict<std::string, IValue> profiles;
+    std::unordered_set<const Function*> functions;
+    for (const auto& item : module.named_modules()) {
+      for (const Method& method : item.value.get_methods()) {
+        if (!functions.insert(&method.function()).second) {
+          continue;
+        }
+        IValue profile = method.function().get_executor().getProfile();
+        if (!profile.isNone()) {
+          profiles.insert(
+              item.name.empty() ? method.name()
+                                : item.name + "." + method.name(),
+              std::move(profile));
+        }
+      }
+    }
+    if (profiles.size() > 0) {
+      writeArchive("profiles", profiles);
+    }
+  }
+
   void writeExtraFiles(const Module& module, const ExtraFilesMap& extra_files) {
     // Write out extra files.
     for (const auto& kv : extra_files) {
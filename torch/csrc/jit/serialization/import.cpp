@@ -18,9 +18,12 @@
 #include <caffe2/serialize/istream_adapter.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <fmt/format.h>
 
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -55,6 +58,127 @@ void postSetStateValidate(const IValue& v) {
   }
 }
 
+namespace {
+
+// Reads the records of an archive on the inter-op thread pool, in archive
+// order, while the unpickler is still parsing the pickle that refers to them.
+// A record that is asked for before a worker got to it is read by the asking
+// thread itself, so this never waits for the pool to become free.
+class RecordPrefetcher {
+ public:
+  RecordPrefetcher(
+      PyTorchStreamReader& reader,
+      std::vector<std::string> names)
+      : state_(std::make_shared<State>(reader, std::move(names))) {
+    const size_t num_workers = std::min<size_t>(
+        at::get_num_interop_threads(), state_->slots.size());
+    for (size_t i = 0; i < num_workers; ++i) {
+      auto state = state_;
+      at::launch([state]() { worker(*state); });
+    }
+  }
+
+  ~RecordPrefetcher() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->stopped = true;
+    state_->cv.wait(lock, [this] { return state_->running == 0; });
+  }
+
+  at::DataPtr get(const std::string& name) {
+    State& state = *state_;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    auto it = state.index.find(name);
+    if (it == state.index.end()) {
+      lock.unlock();
+      return std::get<0>(state.reader.getRecord(name));
+    }
+    Slot& slot = state.slots[it->second];
+    switch (slot.status) {
+      case Status::kPending:
+      case Status::kConsumed:
+        slot.status = Status::kConsumed;
+        lock.unlock();
+        return std::get<0>(state.reader.getRecord(name));
+      case Status::kReading:
+        state.cv.wait(lock, [&slot] { return slot.status == Status::kDone; });
+        break;
+      case Status::kDone:
+        break;
+    }
+    slot.status = Status::kConsumed;
+    if (slot.error) {
+      std::rethrow_exception(slot.error);
+    }
+    return std::move(slot.data);
+  }
+
+ private:
+  enum class Status { kPending, kReading, kDone, kConsumed };
+
+  struct Slot {
+    Status status = Status::kPending;
+    at::DataPtr data;
+    std::exception_ptr error;
+  };
+
+  // Shared with the workers, which may start after the prefetcher is gone.
+  struct State {
+    State(PyTorchStreamReader& reader, std::vector<std::string> names)
+        : reader(reader), slots(names.size()), names(std::move(names)) {
+      for (size_t i = 0; i < this->names.size(); ++i) {
+        index.emplace(this->names[i], i);
+      }
+    }
+
+    // only used by workers that are counted in running
+    PyTorchStreamReader& reader;
+    std::vector<Slot> slots;
+    const std::vector<std::string> names;
+    std::unordered_map<std::string, size_t> index;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t next = 0;
+    bool stopped = false;
+    int running = 0;
+  };
+
+  static void worker(State& state) {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    if (state.stopped) {
+      return;
+    }
+    state.running++;
+    while (!state.stopped && state.next < state.slots.size()) {
+      const size_t i = state.next++;
+      Slot& slot = state.slots[i];
+      if (slot.status != Status::kPending) {
+        continue;
+      }
+      slot.status = Status::kReading;
+      lock.unlock();
+      at::DataPtr data;
+      std::exception_ptr error;
+      try {
+        data = std::get<0>(state.reader.getRecord(state.names[i]));
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      slot.data = std::move(data);
+      slot.error = std::move(error);
+      slot.status = Status::kDone;
+      state.cv.notify_all();
+    }
+    state.running--;
+    state.cv.notify_all();
+  }
+
+  std::shared_ptr<State> state_;
+};
+
+} // namespace
+
 IValue readArchiveAndTensors(
     const std::string& archive_name,
     c10::optional<TypeResolver> type_resolver,
@@ -81,9 +205,23 @@ IValue readArchiveAndTensors(
   };
 
   std::string archive_name_plus_slash = archive_name + "/";
+
+  // getAllRecords() returns the names including the top level directory
+  std::vector<std::string> record_names;
+  for (const auto& record : stream_reader.getAllRecords()) {
+    auto pos = record.find('/');
+    if (pos != std::string::npos &&
+        record.compare(
+            pos + 1,
+            archive_name_plus_slash.size(),
+            archive_name_plus_slash) == 0) {
+      record_names.push_back(record.substr(pos + 1));
+    }
+  }
+  RecordPrefetcher prefetcher(stream_reader, std::move(record_names));
   auto read_record = [&](const std::string& name) {
     std::string ss = archive_name_plus_slash + name;
-    return std::get<0>(stream_reader.getRecord(ss));
+    return prefetcher.get(ss);
   };
 
   Unpickler unpickler(
@@ -238,6 +376,22 @@ graph(%x, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_ze
   }
 }
 
+// Loads the profiles written by ExportModule into the executors of the methods
+// of module, which build their optimized plans right away. The ones that don't
+// match the graphs of their methods are ignored.
+void loadExecutorProfiles(const Module& module, const IValue& profiles) {
+  auto dict = profiles.toGenericDict();
+  for (const auto& item : module.named_modules()) {
+    for (const Method& method : item.value.get_methods()) {
+      auto it = dict.find(
+          item.name.empty() ? method.name() : item.name + "." + method.name());
+      if (it != dict.end()) {
+        method.function().get_executor().loadProfile(it->value());
+      }
+    }
+  }
+}
+
 Module ScriptModuleDeserializer::deserialize(
     c10::optional<at::Device> device,
     ExtraFilesMap& extra_files) {
@@ -268,6 +422,9 @@ Module ScriptModuleDeserializer::deserialize(
   }
   auto m = Module(readArchive("data").toObject());
   rewriteQuantizedConvForBC(m);
+  if (reader_->hasRecord("profiles.pkl")) {
+    loadExecutorProfiles(m, readArchive("profiles"));
+  }
   return m;
 }
 
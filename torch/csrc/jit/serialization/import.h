@@ -60,6 +60,10 @@ TORCH_API Module load(
 /// The reader adapter, which is for customized input stream, must contain a
 /// serialized `Module`, exported either via `ScriptModule.save()` in
 /// Python or `torch::jit::ExportModule` in C++.
+///
+/// Passing a `caffe2::serialize::MmapReadAdapter` maps the file instead of
+/// reading it: the storages of tensors loaded to CPU then point directly into
+/// the (private, copy-on-write) mapping rather than into copies of the data.
 TORCH_API Module load(
     std::unique_ptr<caffe2::serialize::ReadAdapterInterface> rai,
     c10::optional<c10::Device> device = c10::nullopt,
@@ -2,10 +2,16 @@
 
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
+#include <torch/csrc/jit/tensorexpr/var_substitutor.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 using namespace torch::jit;
 using namespace torch::jit::tensorexpr;
@@ -17,6 +23,7 @@ namespace tensorexpr {
 static int te_cuda_pointwise_loop_levels = -1;
 static int te_cuda_pointwise_block_count = -1;
 static int te_cuda_pointwise_block_size = -1;
+static int te_kernel_cache_size = 8;
 static bool fallback_allowed = true;
 
 bool setFallbackAllowed(bool value) {
@@ -48,6 +55,18 @@ int& getTECudaPointwiseBlockSize() {
   return te_cuda_pointwise_block_size;
 }
 
+int& getTEKernelCacheSize() {
+  return te_kernel_cache_size;
+}
+
+std::string& getTELLVMCacheDir() {
+  static std::string cache_dir = []() -> std::string {
+    const char* dir = std::getenv("PYTORCH_TENSOREXPR_LLVM_CACHE_DIR");
+    return dir ? dir : "";
+  }();
+  return cache_dir;
+}
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
@@ -189,6 +208,17 @@ static bool isOne(ExprHandle e) {
   return n->value() == 1;
 }
 
+// Whether all the stores in the loop f write to an element indexed by its
+// var, i.e. whether its iterations write to distinct elements.
+static bool storesByIndex(For* f) {
+  for (Store* store : NodeFinder<Store>::find(f)) {
+    if (!VarFinder().findVars(store->flat_index()).count(f->var())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
     const std::vector<ExprHandle>& a,
     const std::vector<ExprHandle>& b) {
@@ -413,6 +443,225 @@ Tensor* TensorExprKernel::computeFourOperand(
       });
 }
 
+// The values of a constant int list.
+static std::vector<int64_t> constantIntList(const torch::jit::Value* v) {
+  auto const value = toIValue(v);
+  if (!value || !value->isIntList()) {
+    throw malformed_input("expected a constant int list");
+  }
+  return value->toIntVector();
+}
+
+// Wraps the negative dims around rank; the dims are sorted and deduplicated.
+static std::vector<size_t> normalizeDims(
+    const std::vector<int64_t>& dims,
+    size_t rank) {
+  std::vector<size_t> result;
+  for (int64_t dim : dims) {
+    if (dim < 0) {
+      dim += rank;
+    }
+    if (dim < 0 || dim >= static_cast<int64_t>(rank)) {
+      throw malformed_input("reduction dim out of range");
+    }
+    result.push_back(dim);
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+Tensor* TensorExprKernel::computeReduction(
+    const std::string& name,
+    const std::vector<ExprHandle>& shape,
+    const std::vector<size_t>& dims,
+    bool keepdim,
+    const Reducer& reducer,
+    const std::function<ExprHandle(const std::vector<VarHandle>&)>& body) {
+  auto isReduced = [&dims](size_t i) {
+    return std::find(dims.begin(), dims.end(), i) != dims.end();
+  };
+  std::vector<DimArg> outputArgs;
+  std::vector<DimArg> reduceArgs;
+  for (size_t i = 0; i < shape.size(); i++) {
+    if (isReduced(i)) {
+      reduceArgs.emplace_back(shape[i], "r" + c10::to_string(i));
+      if (keepdim) {
+        outputArgs.emplace_back(IntImm::make(1), "i" + c10::to_string(i));
+      }
+    } else {
+      outputArgs.emplace_back(shape[i], "i" + c10::to_string(i));
+    }
+  }
+
+  const size_t nOutputArgs = outputArgs.size();
+  Tensor* t = Reduce(
+      name,
+      outputArgs,
+      reducer,
+      [&](ParameterList& vars) {
+        std::vector<VarHandle> axes;
+        size_t outputIdx = 0;
+        size_t reduceIdx = nOutputArgs;
+        for (size_t i = 0; i < shape.size(); i++) {
+          if (isReduced(i)) {
+            axes.push_back(vars[reduceIdx++]);
+            outputIdx += keepdim ? 1 : 0;
+          } else {
+            axes.push_back(vars[outputIdx++]);
+          }
+        }
+        return body(axes);
+      },
+      reduceArgs);
+
+  reductions_.push_back(t);
+  if (dims.size() == 1 && dims[0] + 1 < shape.size()) {
+    reorderableReductions_.insert(t);
+  }
+  return t;
+}
+
+Tensor* TensorExprKernel::computeSum(const torch::jit::Value* v) {
+  auto const& n = v->node();
+  auto const& shape = valueShape(n->inputs()[0]);
+  auto dims = normalizeDims(constantIntList(n->inputs()[1]), shape.size());
+  // An empty list of dims reduces all of them.
+  if (dims.empty()) {
+    for (size_t i = 0; i < shape.size(); i++) {
+      dims.push_back(i);
+    }
+  }
+  bool keepdim = toIValue(n->inputs()[2]).value().toBool();
+
+  Tensor* sum = computeReduction(
+      "aten_sum",
+      shape,
+      dims,
+      keepdim,
+      Sum(),
+      [this, n](const std::vector<VarHandle>& axes) {
+        return tensorOrConstant(n->inputs()[0], axes);
+      });
+  if (n->kind() == aten::sum) {
+    return sum;
+  }
+
+  ExprHandle count = IntImm::make(1);
+  for (size_t dim : dims) {
+    count = count * shape[dim];
+  }
+  return Compute(
+      "aten_mean",
+      c10::fmap<DimArg>(ExprVectorToExprHandleVector(sum->dims())),
+      [this, v, sum, count](const std::vector<VarHandle>& axes) {
+        return demoteOutput(
+            sum->call(axes) / cast<float>(count), v->node()->output());
+      });
+}
+
+Tensor* TensorExprKernel::computeSoftmax(
+    const torch::jit::Value* v,
+    bool logSoftmax) {
+  // softmax(x) = exp(x - max(x)) / sum(exp(x - max(x))), where the max and
+  // the sum are over dim, and log_softmax(x) = x - max(x) - log(sum(...)).
+  auto const& n = v->node();
+  auto const& shape = valueShape(n->inputs()[0]);
+  auto const dims =
+      normalizeDims({toIValue(n->inputs()[1]).value().toInt()}, shape.size());
+  auto input = [this, n](const std::vector<VarHandle>& axes) {
+    return tensorOrConstant(n->inputs()[0], axes);
+  };
+
+  Tensor* maxima = computeReduction(
+      "aten_softmax_max",
+      shape,
+      dims,
+      true,
+      Maximum(ExprHandle(-std::numeric_limits<float>::infinity())),
+      input);
+  Tensor* sums = computeReduction(
+      "aten_softmax_sum",
+      shape,
+      dims,
+      true,
+      Sum(),
+      [this, input, maxima](const std::vector<VarHandle>& axes) {
+        return exp(input(axes) - broadcast(maxima, axes));
+      });
+  return Compute(
+      logSoftmax ? "aten_log_softmax" : "aten_softmax",
+      c10::fmap<DimArg>(shape),
+      [this, v, input, maxima, sums, logSoftmax](
+          const std::vector<VarHandle>& axes) {
+        ExprHandle shifted = input(axes) - broadcast(maxima, axes);
+        ExprHandle result = logSoftmax
+            ? shifted - log(broadcast(sums, axes))
+            : exp(shifted) / broadcast(sums, axes);
+        return demoteOutput(result, v->node()->output());
+      });
+}
+
+Tensor* TensorExprKernel::computeLayerNorm(const torch::jit::Value* v) {
+  // layer_norm(x) = (x - mean(x)) * rsqrt(var(x) + eps) * weight + bias,
+  // with the mean and the biased variance over the normalized dims, the
+  // innermost ones.
+  auto const& n = v->node();
+  auto const& shape = valueShape(n->inputs()[0]);
+  auto const normalizedShape = constantIntList(n->inputs()[1]);
+  if (normalizedShape.empty() || normalizedShape.size() > shape.size()) {
+    throw malformed_input("invalid normalized_shape in layer_norm");
+  }
+  std::vector<size_t> dims;
+  ExprHandle count = IntImm::make(1);
+  for (size_t i = 0; i < normalizedShape.size(); i++) {
+    size_t dim = shape.size() - normalizedShape.size() + i;
+    auto const size = shape[dim].AsNode<IntImm>();
+    if (size && size->value() != normalizedShape[i]) {
+      throw malformed_input("normalized_shape doesn't match the input");
+    }
+    dims.push_back(dim);
+    count = count * shape[dim];
+  }
+  auto input = [this, n](const std::vector<VarHandle>& axes) {
+    return tensorOrConstant(n->inputs()[0], axes);
+  };
+
+  Tensor* sums =
+      computeReduction("aten_layer_norm_sum", shape, dims, true, Sum(), input);
+  auto mean = [this, sums, count](const std::vector<VarHandle>& axes) {
+    return broadcast(sums, axes) / cast<float>(count);
+  };
+  Tensor* squares = computeReduction(
+      "aten_layer_norm_var_sum",
+      shape,
+      dims,
+      true,
+      Sum(),
+      [input, mean](const std::vector<VarHandle>& axes) {
+        ExprHandle diff = input(axes) - mean(axes);
+        return diff * diff;
+      });
+  return Compute(
+      "aten_layer_norm",
+      c10::fmap<DimArg>(shape),
+      [this, v, input, mean, squares, count](
+          const std::vector<VarHandle>& axes) {
+        auto const& n = v->node();
+        ExprHandle var = broadcast(squares, axes) / cast<float>(count);
+        ExprHandle result = (input(axes) - mean(axes)) *
+            rsqrt(var + constant(n->inputs()[4]));
+        // weight and bias are optional.
+        if (tensors_.count(n->inputs()[2]->unique())) {
+          result = result * tensorOrConstant(n->inputs()[2], axes);
+        }
+        if (tensors_.count(n->inputs()[3]->unique())) {
+          result = result + tensorOrConstant(n->inputs()[3], axes);
+        }
+        return demoteOutput(result, n->output());
+      });
+}
+
 Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
   switch (v->node()->kind()) {
     case aten::add: {
@@ -958,6 +1207,23 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
           });
     }
 
+    case aten::sum:
+    case aten::mean: {
+      return computeSum(v);
+    } break;
+
+    case aten::softmax: {
+      return computeSoftmax(v, false);
+    } break;
+
+    case aten::log_softmax: {
+      return computeSoftmax(v, true);
+    } break;
+
+    case aten::layer_norm: {
+      return computeLayerNorm(v);
+    } break;
+
     case aten::_tanh_backward: {
       return computeTwoOperand(
           "aten_tanh_backward",
@@ -1023,9 +1289,11 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
 
   torch::jit::tensorexpr::LoopNest l(flatTensorOutputs_);
 
-  // Compute non-output tensors_ inline
+  // Compute non-output tensors_ inline, except for the reductions, whose
+  // consumers read their results from a buffer.
   for (auto& p : tensors_) {
-    if (!l.hasLoopBodyFor(p.second)) {
+    if (!l.hasLoopBodyFor(p.second) ||
+        dynamic_cast<const ReduceOp*>(p.second->body())) {
       continue;
     }
     Stmt* loop = l.getLoopBodyFor(p.second);
@@ -1082,6 +1350,20 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
     }
   }
 
+  if (backendType == kLLVMCodeGen) {
+    // Move the reduction loop out of the innermost output loop, which can
+    // then be vectorized.
+    for (Tensor* t : reductions_) {
+      if (!reorderableReductions_.count(t) || !l.hasLoopBodyFor(t)) {
+        continue;
+      }
+      std::vector<For*> loops = l.getLoopStmtsFor(t);
+      if (loops.size() >= 2) {
+        l.reorderAxis(loops[loops.size() - 2], loops.back());
+      }
+    }
+  }
+
   l.prepareForCodegen();
 
   if (backendType == kLLVMCodeGen) {
@@ -1123,7 +1405,12 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
         }
       }
 
-      if (!containsSubLoops) {
+      if (containsSubLoops) {
+        continue;
+      }
+      // Don't vectorize the loops of reductions, which store to the same
+      // element at each iteration.
+      if (storesByIndex(f)) {
         innerLoops.push_back(f);
       }
     }
@@ -1147,6 +1434,18 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
         l.vectorize(split2);
       }
     }
+
+    // Run the iterations of the outer loops in parallel when they write to
+    // distinct elements. Each tensor computed into a buffer has its own loop
+    // nest, so the iterations of one only read what the previous ones wrote.
+    if (Block* body = dynamic_cast<Block*>(l.root_stmt())) {
+      for (Stmt* s : *body) {
+        For* f = dynamic_cast<For*>(s);
+        if (f && storesByIndex(f) && !isOne(ExprHandle(f->stop()))) {
+          l.setParallel(f);
+        }
+      }
+    }
   }
 
   Stmt* stmt = l.root_stmt();
@@ -1306,12 +1605,39 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
           ToDtype(static_cast<ScalarType>(*tt->scalarType())),
           {0});
       std::vector<DimArg> inputTensorDims;
-      for (size_t i = 0; i < *tt->sizes().size(); i++) {
-        auto const size = *tt->sizes()[i];
-        inputTensorDims.emplace_back(
-            DimArg(IntImm::make(size), "i" + c10::to_string(i)));
+      std::vector<ExprHandle> strides;
+      std::vector<ShapeArg> sizeArgs;
+      std::vector<ShapeArg> strideArgs;
+      auto const rank = *tt->sizes().size();
+      auto const knownStrides = tt->strides().size().has_value();
+      for (size_t i = 0; i < rank; i++) {
+        // Sizes and strides the type leaves unknown are arguments of the
+        // kernel; all the inputs share the size argument of a dimension.
+        ExprHandle size;
+        if (auto const staticSize = tt->sizes()[i]) {
+          size = IntImm::make(*staticSize);
+        } else {
+          auto const dim = maxRank_ - rank + i;
+          auto it = symbolicDims_.find(dim);
+          if (it == symbolicDims_.end()) {
+            it = symbolicDims_
+                     .emplace(dim, VarHandle("dim" + c10::to_string(dim), kInt))
+                     .first;
+            sizeArgs.emplace_back(i, it->second);
+          }
+          size = it->second;
+        }
+        inputTensorDims.emplace_back(DimArg(size, "i" + c10::to_string(i)));
+
+        if (knownStrides && tt->strides()[i]) {
+          strides.push_back(IntImm::make(*tt->strides()[i]));
+        } else {
+          VarHandle stride(
+              "stride" + input->debugName() + "_" + c10::to_string(i), kInt);
+          strideArgs.emplace_back(i, stride);
+          strides.push_back(stride);
+        }
       }
-      auto const strides = tt->strides();
       tensors_.emplace(
           input->unique(),
           Compute(
@@ -1320,12 +1646,12 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
               [&](const std::vector<VarHandle>& axes) {
                 ExprHandle idx = 0;
                 for (size_t i = 0; i < axes.size(); i++) {
-                  idx = idx + axes[i] * IntImm::make(*strides[i]);
+                  idx = idx + axes[i] * strides[i];
                 }
                 return inBuffer(idx);
               }));
       kernelArgs_.emplace_back(
-          inBuffer, std::vector<ShapeArg>(), std::vector<ShapeArg>());
+          inBuffer, std::move(sizeArgs), std::move(strideArgs));
       break;
     }
     case TypeKind::FloatType: {
@@ -1358,6 +1684,12 @@ void TensorExprKernel::compile() {
 
   // Bind inputs to buffers.
   nInputs_ = graph_->inputs().size();
+  for (auto const& input : graph_->inputs()) {
+    auto tt = input->type()->cast<TensorType>();
+    if (tt && tt->sizes().size()) {
+      maxRank_ = std::max(maxRank_, *tt->sizes().size());
+    }
+  }
   for (auto const& input : graph_->inputs()) {
     bindInput(input);
     inputTypes_.push_back(input->type());
@@ -1389,6 +1721,23 @@ void TensorExprKernel::compile() {
     tensors_.erase(output->unique());
   }
 
+  // The outputs are allocated before the kernel is called, so their sizes
+  // must be static or arguments of the kernel.
+  for (auto const& o : tensorOutputs_) {
+    for (const Expr* dim : o->dims()) {
+      if (dynamic_cast<const IntImm*>(dim)) {
+        continue;
+      }
+      bool isArg = false;
+      for (auto const& symbolicDim : symbolicDims_) {
+        isArg |= symbolicDim.second.node() == dim;
+      }
+      if (!isArg) {
+        throw malformed_input("output size is not known before the call", dim);
+      }
+    }
+  }
+
   device_ = pickDeviceType(graph_->inputs());
   BackendType backendType = inferBackendTypeFromDevice(device_);
   Stmt* stmt = generateStmt(backendType);
@@ -1402,6 +1751,8 @@ void TensorExprKernel::compile() {
 
 TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
     : graph_(subgraph), code_(subgraph, "") {
+  nInputs_ = graph_->inputs().size();
+  symbolicShapesAllowed_ = hasOnlyElementwiseOps();
   if (!fallbackAllowed()) {
     compile();
     return;
@@ -1414,7 +1765,222 @@ TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
   }
 }
 
+bool TensorExprKernel::hasOnlyElementwiseOps() {
+  // These ops compute their sizes, or the indices they load from, from the
+  // static sizes of their inputs, or check their arguments against them.
+  for (auto const& n : graph_->nodes()) {
+    switch (n->kind()) {
+      case prim::ConstantChunk:
+      case prim::ListConstruct:
+      case aten::cat:
+      case aten::slice:
+      case aten::unsqueeze:
+      case aten::layer_norm:
+        return false;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+bool TensorExprKernel::canRunWith(const at::ArrayRef<IValue>& inputs) {
+  if (inputs.size() != inputTypes_.size()) {
+    return false;
+  }
+  // For each dimension, aligned from the innermost one, the size the inputs
+  // broadcast to and the value of its size argument, if it has one.
+  std::vector<int64_t> dimSizes(maxRank_, 1);
+  std::vector<c10::optional<int64_t>> symbolicSizes(maxRank_);
+  for (size_t i = 0; i < inputs.size(); i++) {
+    auto tt = inputTypes_[i]->cast<TensorType>();
+    if (!tt) {
+      continue;
+    }
+    if (!inputs[i].isTensor()) {
+      return false;
+    }
+    auto const& t = inputs[i].toTensor();
+    auto const rank = static_cast<size_t>(t.dim());
+    if (!t.defined() ||
+        !isValidPrimProperty(tt->scalarType(), t.scalar_type()) ||
+        !isValidPrimProperty(tt->device(), t.device()) ||
+        *tt->sizes().size() != rank) {
+      return false;
+    }
+    auto const knownStrides = tt->strides().size().has_value();
+    for (size_t j = 0; j < rank; j++) {
+      auto const size = t.sizes()[j];
+      auto const dim = maxRank_ - rank + j;
+      if (auto const staticSize = tt->sizes()[j]) {
+        if (*staticSize != size) {
+          return false;
+        }
+      } else {
+        if (symbolicSizes[dim] && *symbolicSizes[dim] != size) {
+          return false;
+        }
+        symbolicSizes[dim] = size;
+      }
+      if (knownStrides && tt->strides()[j] &&
+          *tt->strides()[j] != t.strides()[j]) {
+        return false;
+      }
+      if (size != 1) {
+        if (dimSizes[dim] != 1 && dimSizes[dim] != size) {
+          return false;
+        }
+        dimSizes[dim] = size;
+      }
+    }
+  }
+  // The kernel broadcasts a dimension only where an input has a static size
+  // of 1, so a size argument must be the size the dimension broadcasts to.
+  for (size_t dim = 0; dim < maxRank_; dim++) {
+    if (symbolicSizes[dim] && *symbolicSizes[dim] != dimSizes[dim]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<Graph> TensorExprKernel::specializeGraph(
+    const at::ArrayRef<IValue>& inputs,
+    bool symbolic) {
+  auto graph = graph_->copy();
+  for (size_t i = 0; i < inputs.size(); i++) {
+    if (!inputs[i].isTensor()) {
+      continue;
+    }
+    auto const& t = inputs[i].toTensor();
+    if (!symbolic) {
+      graph->inputs()[i]->setType(TensorType::create(t));
+      continue;
+    }
+    std::vector<c10::optional<int64_t>> sizes;
+    for (auto const size : t.sizes()) {
+      sizes.push_back(size == 1 ? c10::optional<int64_t>(1) : c10::nullopt);
+    }
+    graph->inputs()[i]->setType(TensorType::create(
+        t.scalar_type(),
+        t.device(),
+        c10::VaryingShape<int64_t>(sizes),
+        c10::VaryingShape<int64_t>(t.dim()),
+        /*requires_grad=*/false));
+  }
+  if (!symbolic) {
+    // ops like cat and slice need the static sizes of their outputs
+    PropagateInputShapes(graph);
+  }
+  return graph;
+}
+
+std::shared_ptr<TensorExprKernel> TensorExprKernel::getSpecialization(
+    const at::ArrayRef<IValue>& inputs) {
+  auto makeKey = [&](bool symbolic) {
+    SpecializationKey key{symbolic};
+    for (auto const& input : inputs) {
+      if (!input.isTensor()) {
+        key.push_back(-1);
+        continue;
+      }
+      auto const& t = input.toTensor();
+      key.push_back(static_cast<int64_t>(t.scalar_type()));
+      key.push_back(static_cast<int64_t>(t.device().type()));
+      key.push_back(t.device().index());
+      key.push_back(t.dim());
+      for (auto const size : t.sizes()) {
+        key.push_back(symbolic ? size == 1 : size);
+      }
+      if (!symbolic) {
+        key.insert(key.end(), t.strides().begin(), t.strides().end());
+      }
+    }
+    return key;
+  };
+
+  std::lock_guard<std::mutex> guard(specializationsMutex_);
+  auto key = makeKey(symbolicShapesAllowed_);
+  auto it = specializationIndex_.find(key);
+  if (it != specializationIndex_.end()) {
+    specializationStats_.hits++;
+    specializations_.splice(
+        specializations_.begin(), specializations_, it->second);
+    return it->second->second;
+  }
+  specializationStats_.misses++;
+
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<TensorExprKernel> kernel;
+  if (symbolicShapesAllowed_) {
+    try {
+      kernel = std::make_shared<TensorExprKernel>(specializeGraph(inputs, true));
+    } catch (...) {
+    }
+    if (!kernel || kernel->fallback_) {
+      GRAPH_DEBUG("Cannot compile the subgraph with symbolic sizes");
+      symbolicShapesAllowed_ = false;
+      kernel = nullptr;
+      key = makeKey(false);
+    }
+  }
+  if (!kernel) {
+    kernel = std::make_shared<TensorExprKernel>(specializeGraph(inputs, false));
+  }
+  auto const compileMs = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  specializationStats_.compileMs += compileMs;
+
+  specializations_.emplace_front(std::move(key), kernel);
+  specializationIndex_[specializations_.front().first] =
+      specializations_.begin();
+  while (specializations_.size() >
+         static_cast<size_t>(std::max(getTEKernelCacheSize(), 1))) {
+    specializationIndex_.erase(specializations_.back().first);
+    specializations_.pop_back();
+    specializationStats_.evictions++;
+  }
+
+  auto const& stats = specializationStats_;
+  GRAPH_DEBUG(
+      "Compiled ",
+      symbolicShapesAllowed_ ? "a symbolic" : "a static",
+      " specialization in ",
+      compileMs,
+      " ms; ",
+      stats.hits,
+      " hits, ",
+      stats.misses,
+      " misses, ",
+      stats.evictions,
+      " evictions, ",
+      stats.compileMs,
+      " ms compiling");
+  return kernel;
+}
+
 void TensorExprKernel::run(Stack& stack) {
+  if (fallbackAllowed() && fallback_) {
+    fallback(stack);
+    return;
+  }
+
+  auto inputs = last(stack, nInputs_);
+  if (canRunWith(inputs)) {
+    runOrFallback(stack);
+    return;
+  }
+  auto specialization = getSpecialization(inputs);
+  if (specialization->canRunWith(inputs)) {
+    specialization->runOrFallback(stack);
+  } else {
+    // e.g. the sizes of the inputs don't broadcast
+    fallback(stack);
+  }
+}
+
+void TensorExprKernel::runOrFallback(Stack& stack) {
   if (!fallbackAllowed()) {
     runKernel(stack);
     return;
@@ -1482,7 +2048,7 @@ std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
 }
 
 Stmt* TensorExprKernel::getCodeGenStmt() {
-  return codegen_->stmt();
+  return codegen_ ? codegen_->stmt() : nullptr;
 }
 
 void TensorExprKernel::runKernel(Stack& stack) {
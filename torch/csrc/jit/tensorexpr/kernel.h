@@ -1,10 +1,16 @@
 #pragma once
 
+#include <c10/util/hash.h>
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
 #include <torch/csrc/jit/tensorexpr/codegen.h>
 #include <torch/csrc/jit/tensorexpr/tensor.h>
 
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
 namespace torch {
 namespace jit {
 namespace tensorexpr {
@@ -13,7 +19,11 @@ template <typename T>
 inline std::vector<int64_t> bufferSizes(const T& t) {
   std::vector<int64_t> sizes;
   for (size_t i = 0; i < t->buf()->ndim(); i++) {
-    sizes.push_back(dynamic_cast<const IntImm*>(t->buf()->dim(i))->value());
+    auto const size = dynamic_cast<const IntImm*>(t->buf()->dim(i));
+    if (!size) {
+      throw malformed_input("expected a static size", t->buf()->dim(i));
+    }
+    sizes.push_back(size->value());
   }
   return sizes;
 }
@@ -42,16 +52,46 @@ inline std::vector<ExprHandle> computeIndicesToBroadcast(
   return bcast;
 }
 
+// A kernel for a fusion group, compiled for the input types of its subgraph.
+//
+// Inputs that don't match those types are run by kernels specialized for
+// their shapes, kept in a bounded LRU cache. When the subgraph only has
+// elementwise ops, a specialization is compiled with symbolic sizes, passed
+// to the kernel as arguments, for all the dimensions whose size isn't 1, so
+// all the inputs of the same ranks, dtypes, devices and broadcasting pattern
+// share a single kernel. Otherwise a specialization is compiled for the exact
+// sizes and strides of the inputs.
+//
+// Reductions (sum, mean, and the ones softmax, log_softmax and layer_norm are
+// lowered to) are computed into buffers, with the elementwise ops around them
+// inlined into their bodies and consumers. With LLVM, the outer loops whose
+// iterations write to distinct elements run in parallel on the ATen intra-op
+// thread pool.
 class TORCH_API TensorExprKernel {
  public:
   explicit TensorExprKernel(const std::shared_ptr<Graph>& subgraph);
 
   void run(Stack& stack);
 
+  struct SpecializationStats {
+    // Runs by the kernel compiled for the subgraph or one in the cache.
+    size_t hits = 0;
+    // Runs that had to compile a new specialization.
+    size_t misses = 0;
+    size_t evictions = 0;
+    double compileMs = 0;
+  };
+
+  SpecializationStats specializationStats() {
+    std::lock_guard<std::mutex> guard(specializationsMutex_);
+    return specializationStats_;
+  }
+
   void fallback(Stack& stack) {
     InterpreterState(code_).run(stack);
   }
 
+  // Null if the subgraph failed to compile and runs in the fallback.
   Stmt* getCodeGenStmt();
 
  private:
@@ -65,6 +105,17 @@ class TORCH_API TensorExprKernel {
   void compile();
 
   void runKernel(Stack& stack);
+  void runOrFallback(Stack& stack);
+
+  // Whether the compiled kernel handles inputs, given the sizes and strides
+  // its input types leave symbolic.
+  bool canRunWith(const at::ArrayRef<IValue>& inputs);
+  bool hasOnlyElementwiseOps();
+  std::shared_ptr<TensorExprKernel> getSpecialization(
+      const at::ArrayRef<IValue>& inputs);
+  std::shared_ptr<Graph> specializeGraph(
+      const at::ArrayRef<IValue>& inputs,
+      bool symbolic);
 
   ExprHandle constant(const torch::jit::Value* v);
 
@@ -153,6 +204,21 @@ class TORCH_API TensorExprKernel {
           const ExprHandle&,
           const ExprHandle&)>& innerExpr);
 
+  // Reduces the values body computes over the dims of shape, which must be
+  // sorted, keeping them as dims of size one when keepdim is set. body is
+  // given the axes of shape, reduced and not.
+  Tensor* computeReduction(
+      const std::string& name,
+      const std::vector<ExprHandle>& shape,
+      const std::vector<size_t>& dims,
+      bool keepdim,
+      const Reducer& reducer,
+      const std::function<ExprHandle(const std::vector<VarHandle>&)>& body);
+
+  Tensor* computeSum(const torch::jit::Value* v);
+  Tensor* computeSoftmax(const torch::jit::Value* v, bool logSoftmax);
+  Tensor* computeLayerNorm(const torch::jit::Value* v);
+
   Tensor* computeValue(const torch::jit::Value* v);
 
   void flattenTensors(BackendType backendType);
@@ -204,7 +270,16 @@ class TORCH_API TensorExprKernel {
     std::vector<ShapeArg> strideArgs_;
   };
 
+  using SpecializationKey = std::vector<int64_t>;
+  using SpecializationList = std::list<
+      std::pair<SpecializationKey, std::shared_ptr<TensorExprKernel>>>;
+
   int64_t nInputs_ = 0;
+  // The highest rank of the tensor inputs; the inputs share a single size
+  // argument for each symbolic dimension, aligned from the innermost one as in
+  // broadcasting.
+  size_t maxRank_ = 0;
+  std::unordered_map<size_t, VarHandle> symbolicDims_;
   std::vector<KernelArg> kernelArgs_;
   std::vector<Tensor*> tensorOutputs_;
   std::vector<Tensor*> flatTensorOutputs_;
@@ -219,11 +294,35 @@ class TORCH_API TensorExprKernel {
   bool fallback_{false};
   bool hasRandom_{false};
   bool hasBroadcast_{false};
+
+  // The tensors computed by reductions, which are never inlined into their
+  // consumers, and those of them whose innermost reduced dim isn't the last
+  // one, whose reduction loop is moved out of the innermost output loop.
+  std::vector<Tensor*> reductions_;
+  std::unordered_set<Tensor*> reorderableReductions_;
+
+  bool symbolicShapesAllowed_{false};
+  std::mutex specializationsMutex_;
+  // Most recently used first.
+  SpecializationList specializations_;
+  std::unordered_map<
+      SpecializationKey,
+      SpecializationList::iterator,
+      c10::hash<SpecializationKey>>
+      specializationIndex_;
+  SpecializationStats specializationStats_;
 };
 
 TORCH_API int& getTECudaPointwiseLoopLevels();
 TORCH_API int& getTECudaPointwiseBlockCount();
 TORCH_API int& getTECudaPointwiseBlockSize();
+// Maximum number of specializations kept by each kernel.
+TORCH_API int& getTEKernelCacheSize();
+// Directory LLVMCodeGen caches the object code of its kernels in, keyed by
+// their IR, the target CPU and the LLVM version, so that they are compiled
+// once for all the processes sharing it. Empty, which disables the cache,
+// unless PYTORCH_TENSOREXPR_LLVM_CACHE_DIR is set.
+TORCH_API std::string& getTELLVMCacheDir();
 TORCH_API bool fallbackAllowed();
 TORCH_API bool setFallbackAllowed(bool value);
 
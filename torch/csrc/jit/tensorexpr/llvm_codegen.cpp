@@ -3,23 +3,34 @@
 #include <torch/csrc/jit/tensorexpr/llvm_codegen.h>
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
+#include <c10/util/SmallVector.h>
+
 #include <memory>
+#include <sstream>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 
 #include <torch/csrc/jit/tensorexpr/buffer.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
+#include <torch/csrc/jit/tensorexpr/hash_provider.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
+#include <torch/csrc/jit/tensorexpr/kernel.h>
 #include <torch/csrc/jit/tensorexpr/types.h>
+#include <torch/csrc/jit/tensorexpr/var_substitutor.h>
 
 #define DEBUG_PRINT 0
 
@@ -27,6 +38,7 @@ using namespace torch::jit::tensorexpr;
 
 DEFINE_TRIGGER(llvm_codegen_created);
 DEFINE_TRIGGER(llvm_codegen_executed);
+DEFINE_TRIGGER(llvm_codegen_cache_hit);
 
 namespace torch {
 namespace jit {
@@ -42,7 +54,6 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::BasicBlock* bb_;
   llvm::Value* value_{nullptr};
   llvm::JITTargetAddress kernelAddress_;
-  std::unique_ptr<void* []> argv_ { nullptr };
 
 #define LLVM_TYPE_DECLARE(_1, Name) llvm::Type* Name##Ty_;
   AT_FORALL_SCALAR_TYPES_AND2(Bool, Half, LLVM_TYPE_DECLARE);
@@ -57,6 +68,14 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Type* dtypeToLLVMPtr(Dtype dtype);
   void emitWrapper(const std::vector<llvm::Type*>& params);
   void emitKernel(Stmt* stmt, const std::vector<llvm::Type*>& params);
+  std::unique_ptr<llvm::MemoryBuffer> emitObject();
+  std::string objectCacheKey(
+      Stmt* stmt,
+      const std::vector<CodeGen::BufferArg>& args,
+      Dtype dtype);
+  void emitParallelFor(const For* v);
+  llvm::Value* emitIterationCost(Stmt* s);
+  bool isDefined(const Expr* e);
 
  public:
   LLVMCodeGenImpl(
@@ -67,7 +86,6 @@ class LLVMCodeGenImpl : public IRVisitor {
   ~LLVMCodeGenImpl() = default;
 
   llvm::JITTargetAddress getKernelAddress() const;
-  void** getArgvAddress() const;
 
   void visit(const Add* v) override;
   void visit(const Sub* v) override;
@@ -189,16 +207,35 @@ void LLVMCodeGen::call(const std::vector<CallArg>& args) {
     throw malformed_input("wrong number of args in call");
   }
 
-  void** argv = impl_->getArgvAddress();
+  // The arguments are kept on the stack of the caller, so that the kernel
+  // can be called from several threads at once.
+  c10::SmallVector<void*, 16> argv(buf_args.size());
   for (size_t i = 0, e = buf_args.size(); i < e; i++) {
     auto const& bufferArg = buf_args[i];
     auto const& callArg = args[i];
     argv[i] = argToPtr(bufferArg, callArg);
   }
-  value<float>(argv);
+  value<float>(argv.data());
   USE_TRIGGER(llvm_codegen_executed);
 }
 
+void DispatchParallel(
+    int8_t* func,
+    int32_t start,
+    int32_t stop,
+    int64_t cost,
+    int8_t* packed_data) {
+  // As in the kernels of ATen, a chunk computes at least GRAIN_SIZE elements.
+  auto loop = reinterpret_cast<void (*)(int32_t, int8_t*)>(func);
+  const int64_t grainSize = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(cost, 1));
+  at::parallel_for(start, stop, grainSize, [&](int64_t begin, int64_t end) {
+    for (int64_t index = begin; index < end; index++) {
+      loop(static_cast<int32_t>(index), packed_data);
+    }
+  });
+}
+
 void* LLVMCodeGen::getKernelAddress(LLVMCodeGenImpl* impl) {
   return (void*)impl->getKernelAddress();
 }
@@ -207,8 +244,67 @@ llvm::JITTargetAddress LLVMCodeGenImpl::getKernelAddress() const {
   return kernelAddress_;
 }
 
-void** LLVMCodeGenImpl::getArgvAddress() const {
-  return argv_.get();
+// Bumped when the code LLVMCodeGen emits changes in ways its inputs don't
+// reflect, e.g. the runtime functions it calls, to invalidate the cache.
+static constexpr int kObjectCacheVersion = 1;
+
+static std::string objectCachePath(
+    const std::string& cacheDir,
+    const std::string& key) {
+  std::ostringstream name;
+  name << std::hex << std::hash<std::string>()(key) << ".o";
+  llvm::SmallString<128> path(cacheDir);
+  llvm::sys::path::append(path, name.str());
+  return path.str().str();
+}
+
+// A cache file holds its key, on the first line, followed by the object code.
+// Files that can't be read, or whose key doesn't match, are ignored and
+// overwritten.
+static std::unique_ptr<llvm::MemoryBuffer> loadCachedObject(
+    const std::string& path,
+    const std::string& key) {
+  auto file = llvm::MemoryBuffer::getFile(path);
+  if (!file) {
+    return nullptr;
+  }
+  llvm::StringRef contents = (*file)->getBuffer();
+  if (!contents.startswith(key + "\n")) {
+    return nullptr;
+  }
+  return llvm::MemoryBuffer::getMemBufferCopy(
+      contents.drop_front(key.size() + 1), path);
+}
+
+// Writes to a temporary file renamed in place, so that the processes sharing
+// the cache never read a partial file. Failures only leave the kernel
+// uncached.
+static void storeCachedObject(
+    const std::string& cacheDir,
+    const std::string& path,
+    const std::string& key,
+    const llvm::MemoryBuffer& object) {
+  if (llvm::sys::fs::create_directories(cacheDir)) {
+    return;
+  }
+  int fd;
+  llvm::SmallString<128> tmpPath;
+  if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tmpPath)) {
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << key << "\n" << object.getBuffer();
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(tmpPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(tmpPath, path)) {
+    llvm::sys::fs::remove(tmpPath);
+  }
 }
 
 LLVMCodeGenImpl::LLVMCodeGenImpl(
@@ -235,6 +331,23 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   TM_ = llvm::cantFail(JTMB.createTargetMachine());
 
   jit_ = std::make_unique<llvm::orc::PytorchLLVMJIT>();
+
+  // Load the object code of the kernel if it is in the cache.
+  const std::string cacheDir = getTELLVMCacheDir();
+  std::string cacheKey;
+  std::string cachePath;
+  if (!cacheDir.empty()) {
+    cacheKey = objectCacheKey(stmt, args, dtype);
+    cachePath = objectCachePath(cacheDir, cacheKey);
+    if (auto object = loadCachedObject(cachePath, cacheKey)) {
+      cantFail(jit_->addObject(std::move(object)));
+      kernelAddress_ = cantFail(jit_->findSymbol("wrapper").getAddress());
+      USE_TRIGGER(llvm_codegen_cache_hit);
+      USE_TRIGGER(llvm_codegen_created);
+      return;
+    }
+  }
+
   module_ = std::make_unique<llvm::Module>("pytorch", getContext());
   module_->setDataLayout(cantFail(JTMB.getDefaultDataLayoutForTarget()));
   module_->setTargetTriple(JTMB.getTargetTriple().str());
@@ -263,15 +376,43 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   emitWrapper(params);
   emitKernel(stmt, params);
 
-  cantFail(jit_->addModule(
-      llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  if (!cacheKey.empty()) {
+    auto object = emitObject();
+    storeCachedObject(cacheDir, cachePath, cacheKey, *object);
+    cantFail(jit_->addObject(std::move(object)));
+  } else {
+    cantFail(jit_->addModule(
+        llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  }
   auto sym = jit_->findSymbol("wrapper");
   kernelAddress_ = cantFail(sym.getAddress());
-  argv_ = std::make_unique<void*[]>(params.size());
 
   USE_TRIGGER(llvm_codegen_created);
 }
 
+// The key of a kernel in the object cache: the hash of its stmt and of its
+// arguments, with the names HashProvider gives their vars in the order they
+// are visited, and what else its object code depends on.
+std::string LLVMCodeGenImpl::objectCacheKey(
+    Stmt* stmt,
+    const std::vector<CodeGen::BufferArg>& args,
+    Dtype dtype) {
+  HashProvider hasher;
+  SimplifierHashType hash = hasher.hash_combine(dtype);
+  for (auto const& arg : args) {
+    hash = hasher.hash_combine(
+        hash, arg.isVar() ? "var" : "buf", arg.dtype(), hasher.hash(arg.var()));
+  }
+  hash = hasher.hash_combine(hash, hasher.hash(stmt));
+
+  std::ostringstream key;
+  key << "pytorch-tensorexpr-" << kObjectCacheVersion << " llvm-"
+      << LLVM_VERSION_STRING << " " << TM_->getTargetTriple().str() << " "
+      << TM_->getTargetCPU().str() << " " << TM_->getTargetFeatureString().str()
+      << " " << std::hex << hash._h;
+  return key.str();
+}
+
 llvm::LLVMContext& LLVMCodeGenImpl::getContext() {
   return *context_.getContext();
 }
@@ -455,6 +596,23 @@ void LLVMCodeGenImpl::emitKernel(
 #endif
 }
 
+std::unique_ptr<llvm::MemoryBuffer> LLVMCodeGenImpl::emitObject() {
+  llvm::SmallVector<char, 0> objectBuffer;
+  llvm::raw_svector_ostream objectStream(objectBuffer);
+  llvm::legacy::PassManager PM;
+#if LLVM_VERSION_MAJOR >= 10
+  const auto fileType = llvm::CGFT_ObjectFile;
+#else
+  const auto fileType = llvm::TargetMachine::CGFT_ObjectFile;
+#endif
+  if (TM_->addPassesToEmitFile(PM, objectStream, nullptr, fileType)) {
+    throw std::runtime_error("The target machine can't emit object files");
+  }
+  PM.run(*module_);
+  return llvm::MemoryBuffer::getMemBufferCopy(
+      llvm::StringRef(objectBuffer.data(), objectBuffer.size()), "pytorch");
+}
+
 // TODO: The binary ops are copypasta.
 
 void LLVMCodeGenImpl::visit(const Add* v) {
@@ -961,6 +1119,11 @@ void LLVMCodeGenImpl::visit(const Load* v) {
 }
 
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
@@ -1010,6 +1173,129 @@ void LLVMCodeGenImpl::visit(const For* v) {
   value_ = llvm::ConstantInt::get(IntTy_, 0);
 }
 
+// The body of a parallel loop is outlined into a function of the loop index
+// and of an array of pointers to the values of the kernel it may use, which
+// DispatchParallel calls for each iteration.
+void LLVMCodeGenImpl::emitParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = this->value_;
+  v->stop()->accept(this);
+  auto stop = this->value_;
+  auto cost = emitIterationCost(v->body());
+
+  // Pack all the values defined at the loop; the outlined function only loads
+  // the ones it uses once optimized.
+  std::vector<std::pair<const Var*, llvm::Value*>> captures;
+  for (auto const& arg : varToArg_) {
+    captures.emplace_back(arg.first, fn_->arg_begin() + arg.second);
+  }
+  for (auto const& val : varToVal_) {
+    captures.emplace_back(val.first, val.second);
+  }
+  auto i8PtrTy = llvm::Type::getInt8PtrTy(getContext());
+  llvm::IRBuilder<> entry(&fn_->getEntryBlock(), fn_->getEntryBlock().begin());
+  auto packed = entry.CreateAlloca(
+      i8PtrTy, llvm::ConstantInt::get(IntTy_, captures.size()));
+  for (size_t i = 0; i < captures.size(); i++) {
+    llvm::Value* val = captures[i].second;
+    auto slot = entry.CreateAlloca(val->getType());
+    irb_.CreateStore(val, slot);
+    irb_.CreateStore(
+        irb_.CreatePointerCast(slot, i8PtrTy),
+        irb_.CreateGEP(packed, llvm::ConstantInt::getSigned(IntTy_, i)));
+  }
+
+  auto bodyFn = llvm::Function::Create(
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()), {IntTy_, i8PtrTy}, false),
+      llvm::Function::PrivateLinkage,
+      "parallel_loop",
+      module_.get());
+  auto callerFn = fn_;
+  auto callerBlock = irb_.GetInsertBlock();
+  auto callerVarToArg = std::move(varToArg_);
+  auto callerVarToVal = std::move(varToVal_);
+  varToArg_.clear();
+  varToVal_.clear();
+
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto packedArg =
+      irb_.CreatePointerCast(fn_->arg_begin() + 1, i8PtrTy->getPointerTo());
+  for (size_t i = 0; i < captures.size(); i++) {
+    auto slot = irb_.CreateLoad(
+        irb_.CreateGEP(packedArg, llvm::ConstantInt::getSigned(IntTy_, i)));
+    varToVal_.emplace(
+        captures[i].first,
+        irb_.CreateLoad(irb_.CreatePointerCast(
+            slot, captures[i].second->getType()->getPointerTo())));
+  }
+  varToVal_.emplace(v->var(), fn_->arg_begin());
+  v->body()->accept(this);
+  irb_.CreateRetVoid();
+  if (llvm::verifyFunction(*fn_, &llvm::outs())) {
+    throw std::runtime_error("Function verification failed");
+  }
+
+  fn_ = callerFn;
+  varToArg_ = std::move(callerVarToArg);
+  varToVal_ = std::move(callerVarToVal);
+  irb_.SetInsertPoint(callerBlock);
+
+  auto dispatch = module_->getOrInsertFunction(
+      "DispatchParallel",
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()),
+          {i8PtrTy, IntTy_, IntTy_, LongTy_, i8PtrTy},
+          false));
+  irb_.CreateCall(
+      dispatch,
+      {irb_.CreatePointerCast(bodyFn, i8PtrTy),
+       start,
+       stop,
+       cost,
+       irb_.CreatePointerCast(packed, i8PtrTy)});
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
+// An estimate of the number of elements s computes, which sets the grain size
+// of a parallel loop: the trip counts of the loops of s whose bounds are
+// defined outside of it multiply the lanes of its stores.
+llvm::Value* LLVMCodeGenImpl::emitIterationCost(Stmt* s) {
+  if (auto block = dynamic_cast<Block*>(s)) {
+    llvm::Value* cost = llvm::ConstantInt::get(LongTy_, 0);
+    for (Stmt* stmt : *block) {
+      cost = irb_.CreateAdd(cost, emitIterationCost(stmt));
+    }
+    return cost;
+  }
+  if (auto loop = dynamic_cast<For*>(s)) {
+    llvm::Value* cost = emitIterationCost(loop->body());
+    if (isDefined(loop->start()) && isDefined(loop->stop())) {
+      loop->start()->accept(this);
+      auto start = this->value_;
+      loop->stop()->accept(this);
+      auto stop = this->value_;
+      cost = irb_.CreateMul(
+          cost, irb_.CreateSExt(irb_.CreateSub(stop, start), LongTy_));
+    }
+    return cost;
+  }
+  if (auto store = dynamic_cast<Store*>(s)) {
+    return llvm::ConstantInt::get(LongTy_, store->value()->dtype().lanes());
+  }
+  return llvm::ConstantInt::get(LongTy_, 1);
+}
+
+bool LLVMCodeGenImpl::isDefined(const Expr* e) {
+  for (const Var* var : VarFinder().findVars(e)) {
+    if (!varToArg_.count(var) && !varToVal_.count(var)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void LLVMCodeGenImpl::visit(const Block* v) {
   for (auto pair : v->varBindings()) {
     const Var* v = pair.first;
@@ -77,6 +77,13 @@ class TORCH_API PytorchLLVMJITImpl {
         *Mangle("remainderf"),
         {llvm::pointerToJITTargetAddress(&remainderf), {}}));
 
+    // Runtime of the parallel loops
+    cantFail(LLJ->defineAbsolute(
+        *Mangle("DispatchParallel"),
+        {llvm::pointerToJITTargetAddress(
+             &torch::jit::tensorexpr::DispatchParallel),
+         {}}));
+
     // FP32 Sleef functions -- SSE
     cantFail(LLJ->defineAbsolute(
         *Mangle("Sleef_acosf4"),
@@ -425,6 +432,10 @@ class TORCH_API PytorchLLVMJITImpl {
     return Error::success();
   }
 
+  Error addObject(std::unique_ptr<MemoryBuffer> Obj) {
+    return LLJ->addObjectFile(std::move(Obj));
+  }
+
   JITSymbol findSymbol(const std::string Name) {
     return cantFail(LLJ->lookup(Name));
   }
@@ -443,6 +454,10 @@ Error PytorchLLVMJIT::addModule(ThreadSafeModule M) {
   return impl_->addModule(std::move(M));
 }
 
+Error PytorchLLVMJIT::addObject(std::unique_ptr<MemoryBuffer> Obj) {
+  return impl_->addObject(std::move(Obj));
+}
+
 JITSymbol PytorchLLVMJIT::findSymbol(const std::string Name) {
   return impl_->findSymbol(std::move(Name));
 }
@@ -6,11 +6,32 @@
 #include <llvm/ExecutionEngine/JITSymbol.h>
 #include <llvm/ExecutionEngine/Orc/Core.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Target/TargetMachine.h>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
+namespace torch {
+namespace jit {
+namespace tensorexpr {
+
+// Runs func(index, packed_data) for the indices in [start, stop) on the ATen
+// intra-op thread pool, given an estimate of the number of elements each
+// iteration computes. Called by the kernels of LLVMCodeGen for their parallel
+// loops, whose bodies are outlined into func.
+void DispatchParallel(
+    int8_t* func,
+    int32_t start,
+    int32_t stop,
+    int64_t cost,
+    int8_t* packed_data);
+
+} // namespace tensorexpr
+} // namespace jit
+} // namespace torch
+
 namespace llvm {
 namespace orc {
 
@@ -23,6 +44,9 @@ class TORCH_API PytorchLLVMJIT {
 
   Error addModule(ThreadSafeModule M);
 
+  // Adds object code compiled for the target machine of the JIT.
+  Error addObject(std::unique_ptr<MemoryBuffer> Obj);
+
   JITSymbol findSymbol(const std::string Name);
 
   TargetMachine& getTargetMachine();
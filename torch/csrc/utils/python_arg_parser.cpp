@@ -724,6 +724,67 @@ bool FunctionSignature::parse(PyObject* args, PyObject* kwargs, PyObject* dst[],
   return true;
 }
 
+namespace {
+
+enum class TensorMatch { ALWAYS, NEVER, DEPENDS };
+
+// Whether FunctionParameter::check accepts an exact Tensor for `param`
+TensorMatch tensor_match(const FunctionParameter& param) {
+  switch (param.type_) {
+    case ParameterType::TENSOR:
+    case ParameterType::PYOBJECT:
+      return TensorMatch::ALWAYS;
+    case ParameterType::TENSOR_LIST:
+    case ParameterType::INT_LIST:
+    case ParameterType::GENERATOR:
+    case ParameterType::BOOL:
+    case ParameterType::STORAGE:
+    case ParameterType::SCALARTYPE:
+    case ParameterType::LAYOUT:
+    case ParameterType::MEMORY_FORMAT:
+    case ParameterType::QSCHEME:
+    case ParameterType::DEVICE:
+    case ParameterType::STRING:
+      return TensorMatch::NEVER;
+    default:
+      // Numbers take zero-dim Tensors
+      return TensorMatch::DEPENDS;
+  }
+}
+
+// Whether FunctionSignature::parse accepts `nargs` positional exact Tensors
+// and no keyword arguments
+TensorMatch tensor_args_match(const FunctionSignature& signature, ssize_t nargs) {
+  if (signature.max_pos_args == 1 &&
+      signature.params[0].type_ == ParameterType::INT_LIST) {
+    // Var-args IntArrayRef, which takes zero-dim integer Tensors
+    return TensorMatch::DEPENDS;
+  }
+  if (nargs > signature.max_pos_args) {
+    return TensorMatch::NEVER;
+  }
+  auto result = TensorMatch::ALWAYS;
+  for (ssize_t i = 0; i < static_cast<ssize_t>(signature.params.size()); ++i) {
+    const auto& param = signature.params[i];
+    if (i >= nargs) {
+      if (!param.optional) {
+        return TensorMatch::NEVER;
+      }
+      continue;
+    }
+    const auto match = tensor_match(param);
+    if (match == TensorMatch::NEVER) {
+      return TensorMatch::NEVER;
+    }
+    if (match == TensorMatch::DEPENDS) {
+      result = TensorMatch::DEPENDS;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
  : max_args(0)
  , traceable(traceable)
@@ -747,6 +808,22 @@ PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
     [](const FunctionSignature & sig) {
       return !sig.deprecated;
     });
+
+  // Mirrors the order raw_parse tries the signatures in
+  for (ssize_t nargs = 0; nargs <= max_args; ++nargs) {
+    int match = -1;
+    for (size_t i = 0; i < signatures_.size(); ++i) {
+      const auto signature_match = tensor_args_match(signatures_[i], nargs);
+      if (signature_match == TensorMatch::ALWAYS) {
+        match = i;
+        break;
+      }
+      if (signature_match == TensorMatch::DEPENDS) {
+        break;
+      }
+    }
+    tensor_args_signatures_.push_back(match);
+  }
 }
 
 void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
@@ -768,6 +845,27 @@ void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
 }
 
 PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]) {
+  const auto nargs = PyTuple_GET_SIZE(args);
+  if (nargs < static_cast<ssize_t>(tensor_args_signatures_.size()) &&
+      tensor_args_signatures_[nargs] >= 0 &&
+      (!kwargs || PyDict_Size(kwargs) == 0)) {
+    bool tensor_args = true;
+    for (ssize_t i = 0; i < nargs && tensor_args; ++i) {
+      tensor_args = THPVariable_CheckExact(PyTuple_GET_ITEM(args, i));
+    }
+    if (tensor_args) {
+      // What FunctionSignature::parse would bind: exact Tensors have no
+      // __torch_function__ overrides, and the other parameters default
+      auto& signature = signatures_[tensor_args_signatures_[nargs]];
+      signature.overloaded_args.clear();
+      for (ssize_t i = 0; i < static_cast<ssize_t>(signature.params.size()); ++i) {
+        parsed_args[i] = i < nargs ? PyTuple_GET_ITEM(args, i) : nullptr;
+      }
+      check_deprecated(signature);
+      return PythonArgs(traceable, signature, parsed_args);
+    }
+  }
+
   if (signatures_.size() == 1) {
     auto& signature = signatures_[0];
     signature.parse(args, kwargs, parsed_args, true);
@@ -109,6 +109,13 @@ private:
   PythonArgs raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
 
   std::vector<FunctionSignature> signatures_;
+  // Index in signatures_ of the signature that a call with i positional
+  // arguments that are all exact Tensors, and no keyword arguments, binds to.
+  // -1 if no signature does, or if which one does depends on the values of the
+  // Tensors (e.g. a Scalar parameter takes zero-dim Tensors only). Computed
+  // once from the signatures, so that a + b or x.relu() can skip checking the
+  // arguments against every overload.
+  std::vector<int> tensor_args_signatures_;
   std::string function_name;
   ssize_t max_args;
   bool traceable;
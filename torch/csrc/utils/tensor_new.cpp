@@ -269,12 +269,23 @@ Tensor internal_new_from_data(
   }
 
   if (PyArray_Check(data)) {
-    TORCH_CHECK(!pin_memory, "Can't pin tensor constructed from numpy");
-    auto tensor = tensor_from_numpy(data);
+    TORCH_CHECK(!pin_memory || copy_numpy, "Can't pin tensor aliasing a numpy array");
+    // The arrays that can't be aliased are converted when the result is a
+    // copy anyway
+    auto tensor = tensor_from_numpy(data, /*copy_if_needed=*/copy_numpy);
     const auto& inferred_scalar_type = type_inference ? tensor.scalar_type() : scalar_type;
     auto device = device_opt.has_value() ? *device_opt : at::Device(computeDeviceType(dispatch_key));
     pybind11::gil_scoped_release no_gil;
     maybe_initialize_cuda(device);
+    if (pin_memory) {
+      // Copies the array straight into pinned memory. The array itself may be
+      // pinned, e.g. by Tensor.numpy(), so pin_memory() could alias it.
+      auto pinned = at::empty(
+          tensor.sizes(),
+          tensor.options().dtype(inferred_scalar_type).pinned_memory(true));
+      pinned.copy_(tensor);
+      return pinned.to(device, inferred_scalar_type, /*non_blocking=*/false, /*copy=*/false);
+    }
     return tensor.to(device, inferred_scalar_type, /*non_blocking=*/false, /*copy=*/copy_numpy);
   }
 #endif
@@ -7,7 +7,7 @@ namespace torch { namespace utils {
 PyObject* tensor_to_numpy(const at::Tensor& tensor) {
   throw std::runtime_error("PyTorch was compiled without NumPy support");
 }
-at::Tensor tensor_from_numpy(PyObject* obj) {
+at::Tensor tensor_from_numpy(PyObject* obj, bool copy_if_needed, bool pin_memory) {
   throw std::runtime_error("PyTorch was compiled without NumPy support");
 }
 bool is_numpy_int(PyObject* obj) {
@@ -26,6 +26,8 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/autograd/python_variable.h>
 #include <torch/csrc/utils/object_ptr.h>
+#include <torch/csrc/utils/pybind.h>
+#include <torch/csrc/utils/python_numbers.h>
 
 #include <ATen/ATen.h>
 #include <ATen/TensorUtils.h>
@@ -125,13 +127,44 @@ PyObject* tensor_to_numpy(const at::Tensor& tensor) {
   return array.release();
 }
 
-at::Tensor tensor_from_numpy(PyObject* obj) {
+// Whether a tensor can't alias the data of the array: it isn't in the native
+// byte order, it isn't aligned, or one of its strides is negative or not a
+// multiple of the element size.
+static bool needs_native_copy(PyArrayObject* array) {
+  if (!PyArray_EquivByteorders(PyArray_DESCR(array)->byteorder, NPY_NATIVE) ||
+      !PyArray_ISALIGNED(array)) {
+    return true;
+  }
+  auto element_size_in_bytes = PyArray_ITEMSIZE(array);
+  for (int i = 0; i < PyArray_NDIM(array); i++) {
+    auto stride = PyArray_STRIDES(array)[i];
+    if (stride < 0 || stride % element_size_in_bytes != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+at::Tensor tensor_from_numpy(PyObject* obj, bool copy_if_needed, bool pin_memory) {
   if (!PyArray_Check(obj)) {
     throw TypeError("expected np.ndarray (got %s)", Py_TYPE(obj)->tp_name);
   }
   auto array = (PyArrayObject*)obj;
 
-  if (!PyArray_ISWRITEABLE(array)) {
+  if (copy_if_needed && needs_native_copy(array)) {
+    // Check the dtype before NumPy converts anything
+    numpy_dtype_to_aten(PyArray_TYPE(array));
+    PyArray_Descr* descr =
+        PyArray_DescrNewByteorder(PyArray_DESCR(array), NPY_NATIVE);
+    if (!descr) throw python_error();
+    // A C contiguous copy in the native byte order, steals descr
+    auto copy = THPObjectPtr(PyArray_CastToType(array, descr, 0));
+    if (!copy) throw python_error();
+    return tensor_from_numpy(copy.get(), /*copy_if_needed=*/false, pin_memory);
+  }
+
+  // The pinned tensor is a copy, writes to it don't reach the array
+  if (!pin_memory && !PyArray_ISWRITEABLE(array)) {
     TORCH_WARN_ONCE(
       "The given NumPy array is not writeable, and PyTorch does "
       "not support non-writeable tensors. This means you can write to the "
@@ -151,7 +184,8 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
     if (stride%element_size_in_bytes != 0) {
       throw ValueError(
         "given numpy array strides not a multiple of the element byte size. "
-        "Copy the numpy array to reallocate the memory.");
+        "Copy the numpy array to reallocate the memory, or pass "
+        "copy_if_needed=True.");
     }
     stride /= element_size_in_bytes;
   }
@@ -163,7 +197,7 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
           "At least one stride in the given numpy array is negative, "
           "and tensors with negative strides are not currently supported. "
           "(You can probably work around this by making a copy of your array "
-          " with array.copy().) ");
+          " with array.copy(), or by passing copy_if_needed=True.) ");
     }
     // XXX: this won't work for negative strides
     storage_size += (sizes[i] - 1) * strides[i];
@@ -173,10 +207,10 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
   if (!PyArray_EquivByteorders(PyArray_DESCR(array)->byteorder, NPY_NATIVE)) {
     throw ValueError(
         "given numpy array has byte order different from the native byte order. "
-        "Conversion between byte orders is currently not supported.");
+        "Pass copy_if_needed=True to convert it to the native byte order.");
   }
   Py_INCREF(obj);
-  return at::from_blob(
+  auto tensor = at::from_blob(
       data_ptr,
       sizes,
       strides,
@@ -186,6 +220,12 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
       },
       at::device(kCPU).dtype(numpy_dtype_to_aten(PyArray_TYPE(array)))
   );
+  if (pin_memory) {
+    // Copies into page-locked memory, from which copies to CUDA devices can be
+    // non-blocking
+    return tensor.pin_memory();
+  }
+  return tensor;
 }
 
 int aten_to_numpy_dtype(const ScalarType scalar_type) {
@@ -332,6 +372,22 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
     }
   }
 
+  // Extract the `obj.__cuda_array_interface__['stream']` attribute. It is the
+  // stream the data is produced on, the current stream waits for it.
+  {
+    PyObject *py_stream = PyDict_GetItemString(cuda_dict, "stream");
+    if (py_stream != nullptr && py_stream != Py_None) {
+      if (!THPUtils_checkLong(py_stream)) {
+        throw TypeError("`stream` must be an int or None");
+      }
+      if (THPUtils_unpackLong(py_stream) == 0) {
+        throw ValueError("`stream` must not be 0, use 1 for the legacy default stream");
+      }
+      py::module::import("torch.cuda").attr("_stream_wait_raw")(
+          py::none(), py::handle(py_stream));
+    }
+  }
+
   Py_INCREF(obj);
   return at::from_blob(
       data_ptr,
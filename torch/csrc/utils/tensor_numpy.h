@@ -6,7 +6,13 @@
 namespace torch { namespace utils {
 
 PyObject* tensor_to_numpy(const at::Tensor& tensor);
-at::Tensor tensor_from_numpy(PyObject* obj);
+// Aliases the data of obj. If copy_if_needed, arrays that can't be aliased,
+// e.g. with a negative stride or a non-native byte order, are copied instead.
+// If pin_memory, the result is copied into pinned memory.
+at::Tensor tensor_from_numpy(
+    PyObject* obj,
+    bool copy_if_needed = false,
+    bool pin_memory = false);
 
 int aten_to_numpy_dtype(const at::ScalarType scalar_type);
 at::ScalarType numpy_dtype_to_aten(int dtype);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <random>
 #include <thread>
 
@@ -20,6 +21,7 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   TORCH_CHECK(
       config.num_worker_threads == 1,
       "Only parallelization by callers is supported");
+  TORCH_CHECK(config.target_qps >= 0, "target_qps must be non-negative");
 
   LOG(INFO) << at::get_parallel_info();
 
@@ -57,10 +59,26 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   bool start{false};
   std::atomic<int64_t> num_attempted_iters{0};
   std::vector<std::thread> callers;
+  // Every thread writes the latencies of its own iterations only, so that
+  // recording them doesn't synchronize the threads
+  std::vector<std::vector<float>> thread_latencies(config.num_calling_threads);
+
+  using Clock = std::chrono::high_resolution_clock;
+  using TimePoint = std::chrono::time_point<Clock>;
+  TimePoint start_time;
+  const bool open_loop = config.target_qps > 0;
+  const std::chrono::duration<double, std::nano> issue_interval(
+      open_loop ? 1e9 / config.target_qps : 0);
 
   for (auto thread_id = 0; thread_id < config.num_calling_threads;
        ++thread_id) {
     callers.emplace_back([&, thread_id]() {
+      if (!config.cpu_affinity.empty()) {
+        pinCurrentThread(
+            config.cpu_affinity[thread_id % config.cpu_affinity.size()]);
+      }
+      auto& latencies = thread_latencies[thread_id];
+      latencies.reserve(config.num_iters);
       // We use conditional variable as a barrier to make sure each thread
       // performs required warmeup iterations before we start measuring
       for (auto j = 0; j < config.num_warmup_iters; ++j) {
@@ -76,9 +94,25 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
         }
       }
       LOG(INFO) << "Starting forward thread " << thread_id;
-      while (num_attempted_iters.fetch_add(1) < config.num_iters) {
+      int64_t iter;
+      while ((iter = num_attempted_iters.fetch_add(1)) < config.num_iters) {
+        TimePoint iter_start;
+        if (open_loop) {
+          // Iterations keep their schedule when the model falls behind, so
+          // that the time spent queued shows up in the latency
+          iter_start = start_time +
+              std::chrono::duration_cast<Clock::duration>(issue_interval * iter);
+          std::this_thread::sleep_until(iter_start);
+        } else {
+          iter_start = Clock::now();
+        }
         runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
         ++input_iters[thread_id];
+        latencies.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - iter_start)
+                .count() /
+            1000.0 / 1000.0);
       }
 
       {
@@ -92,10 +126,6 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     });
   }
 
-  using Clock = std::chrono::high_resolution_clock;
-  using TimePoint = std::chrono::time_point<Clock>;
-  TimePoint start_time;
-
   std::unique_ptr<torch::autograd::profiler::RecordProfile> profiler_guard;
   {
     std::unique_lock<std::mutex> lock(m);
@@ -138,6 +168,18 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   for (auto& t : callers) {
     t.join();
   }
+
+  std::vector<float> latencies;
+  latencies.reserve(config.num_iters);
+  for (const auto& thread_latency : thread_latencies) {
+    latencies.insert(
+        latencies.end(), thread_latency.begin(), thread_latency.end());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  stats.latency_p50_ms = latencyPercentile(latencies, 50);
+  stats.latency_p90_ms = latencyPercentile(latencies, 90);
+  stats.latency_p99_ms = latencyPercentile(latencies, 99);
+  stats.latency_p999_ms = latencyPercentile(latencies, 99.9);
   return stats;
 }
 
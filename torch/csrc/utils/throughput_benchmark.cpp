@@ -3,11 +3,22 @@
 #include <pybind11/pybind11.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 
+#include <cmath>
+#include <cstring>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace torch {
 namespace throughput_benchmark {
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkExecutionStats& value) {
     return os << "Average latency / iter (ms): " << value.latency_avg_ms
+              << "\n Latency p50 / p90 / p99 / p99.9 (ms): "
+              << value.latency_p50_ms << " / " << value.latency_p90_ms << " / "
+              << value.latency_p99_ms << " / " << value.latency_p999_ms
               << "\n Total number of iters: " << value.num_iters;
 }
 
@@ -120,6 +131,32 @@ void ModuleBenchmark::addInput(py::args&& args, py::kwargs&& kwargs) {
   inputs_.emplace_back(std::move(args), std::move(kwargs));
 }
 
+void pinCurrentThread(int cpu) {
+#if defined(__linux__)
+  TORCH_CHECK(
+      cpu >= 0 && cpu < CPU_SETSIZE, "Invalid CPU in cpu_affinity: ", cpu);
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  const int err =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  TORCH_CHECK(err == 0, "Failed to pin a calling thread to CPU ", cpu,
+      ": ", strerror(err));
+#else
+  TORCH_CHECK(false, "cpu_affinity is only supported on Linux");
+#endif
+}
+
+float latencyPercentile(const std::vector<float>& latencies, double p) {
+  if (latencies.empty()) {
+    return -1;
+  }
+  // The epsilon keeps rounding errors from bumping exact ranks to the next one
+  const auto rank =
+      static_cast<size_t>(std::ceil(p / 100 * latencies.size() - 1e-9));
+  return latencies[std::min(std::max<size_t>(rank, 1), latencies.size()) - 1];
+}
+
 template <>
 ModuleInput cloneInput<ModuleInput>(const ModuleInput& input) {
   pybind11::gil_scoped_acquire gil_guard;
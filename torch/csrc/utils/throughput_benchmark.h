@@ -23,6 +23,13 @@ namespace throughput_benchmark {
 struct BenchmarkExecutionStats {
   float latency_avg_ms{-1};
   int64_t num_iters{-1};
+  // Percentiles of the latencies of the individual iterations. In the
+  // open-loop mode these also count the time an iteration waited past its
+  // scheduled start.
+  float latency_p50_ms{-1};
+  float latency_p90_ms{-1};
+  float latency_p99_ms{-1};
+  float latency_p999_ms{-1};
 };
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkExecutionStats& value);
@@ -57,6 +64,16 @@ struct BenchmarkConfig {
   // before the main benchmark loop (but after the warmup):
   // RecordProfile guard(profiler_output_path);
   std::string profiler_output_path{""};
+  // If not empty, calling thread i is pinned to the CPU
+  // cpu_affinity[i % cpu_affinity.size()] for the whole run, warmup included.
+  // Only supported on Linux
+  std::vector<int> cpu_affinity;
+  // If positive, the benchmark runs open-loop: iterations are issued at this
+  // rate (per second, across all calling threads) no matter how long the
+  // previous ones took, and each one's latency is measured from the time it
+  // was scheduled at. Otherwise every calling thread issues the next iteration
+  // as soon as its previous one is done (closed-loop)
+  double target_qps{0};
 };
 
 namespace detail {
@@ -112,6 +129,13 @@ typedef at::IValue ScriptModuleOutput;
 template<class Input>
 Input cloneInput(const Input& input);
 
+// Pins the calling thread to the given CPU
+void pinCurrentThread(int cpu);
+
+// Returns the latency at percentile `p` (in [0, 100]) of the sorted
+// `latencies`, using the nearest-rank method
+float latencyPercentile(const std::vector<float>& latencies, double p);
+
 typedef BenchmarkHelper<
     ScriptModuleInput,
     at::IValue,
@@ -439,6 +439,29 @@ def default_stream(device: Optional[_device_t] = None) -> Stream:
         _get_device_index(device, optional=True)))
 
 
+def _stream_wait_raw(waiting: Optional[int], recorded: Optional[int],
+                     device: Optional[_device_t] = None) -> None:
+    r"""Makes the CUDA stream ``waiting`` wait for the work queued so far on
+    the CUDA stream ``recorded``, without synchronizing the device.
+
+    Both are raw ``cudaStream_t`` handles of :attr:`device`, possibly owned by
+    another library, or ``None`` for the current stream. As in the DLPack and
+    ``__cuda_array_interface__`` protocols, 1 stands for the legacy default
+    stream and 2 for the per-thread default stream.
+    """
+    def normalize(stream):
+        if stream is None:
+            stream = current_stream(device).cuda_stream
+        # PyTorch's default stream is the legacy default stream.
+        return 0 if stream == 1 else stream
+
+    waiting = normalize(waiting)
+    recorded = normalize(recorded)
+    if waiting != recorded:
+        with torch.cuda.device(device):
+            torch._C._cuda_streamWaitStream(waiting, recorded)
+
+
 def current_blas_handle():
     r"""Returns cublasHandle_t pointer to current cuBLAS handle"""
     _lazy_init()
@@ -450,6 +473,9 @@ from .memory import *
 
 from .random import *
 
+
+from .graphs import CUDAGraph, make_graphed_callable
+
 ################################################################################
 # Define Storage and Tensor classes
 ################################################################################
@@ -106,15 +106,35 @@ class autocast(object):
     :class:`torch.nn.parallel.DistributedDataParallel` when used with more than one GPU per process
     (see :ref:`Working with Multiple GPUs<amp-multigpu>`).
 
+    Autocast caches the ``float16`` casts of ``float32`` leaf tensors that require grad, such as
+    model weights, for as long as they aren't modified in-place.  By default, the cache is cleared
+    when exiting the outermost autocast region.  For inference, where every region reuses the
+    same weights, ``persistent_cache=True`` keeps it across regions instead::
+
+        model.eval()
+        with torch.no_grad():
+            for input in data:
+                with autocast(persistent_cache=True):
+                    output = model(input)
+
+    The casts of the persistent cache are made again once the weight's version counter changes,
+    e.g. by an optimizer step, or when switching between grad and no-grad mode.  Changes that
+    don't bump the version counter, like ones through ``weight.data``, aren't seen:
+    call ``torch.clear_autocast_cache()`` after them.  The memory held by the cache is reported
+    as ``autocast_cache_bytes`` in :func:`torch.cuda.memory_stats`.
+
     Arguments:
         enabled(bool, optional, default=True):  Whether autocasting should be enabled in the region.
+        persistent_cache(bool, optional, default=False):  Whether to keep the cache of weight
+            casts when exiting the outermost autocast region.
     """
-    def __init__(self, enabled=True):
+    def __init__(self, enabled=True, persistent_cache=False):
         if enabled and not torch.cuda.is_available():
             warnings.warn("torch.cuda.amp.autocast only affects CUDA ops, but CUDA is not available.  Disabling.")
             self._enabled = False
         else:
             self._enabled = enabled
+        self._persistent_cache = persistent_cache
 
     def __enter__(self):
         self.prev = torch.is_autocast_enabled()
@@ -123,7 +143,7 @@ class autocast(object):
 
     def __exit__(self, *args):
         # Drop the cache when we exit to a nesting level that's outside any instance of autocast.
-        if torch.autocast_decrement_nesting() == 0:
+        if torch.autocast_decrement_nesting() == 0 and not self._persistent_cache:
             torch.clear_autocast_cache()
         torch.set_autocast_enabled(self.prev)
         return False
@@ -0,0 +1,124 @@
+import torch
+
+from ._utils import _dummy_type
+
+
+if not hasattr(torch._C, '_CUDAGraph'):
+    # Define dummy base classes
+    torch._C.__dict__['_CUDAGraph'] = _dummy_type('_CUDAGraph')
+
+
+class CUDAGraph(torch._C._CUDAGraph):
+    r"""Wrapper around a CUDA graph.
+
+    The kernels launched on the current stream between :meth:`capture_begin`
+    and :meth:`capture_end` are recorded instead of run, and :meth:`replay`
+    launches all of them again at once, which removes most of the CPU launch
+    overhead of workloads made of many small kernels.
+
+    Every replay reads and writes the same memory as the capture: the tensors
+    allocated during the capture come from a private memory pool that lives
+    until :meth:`reset`, and new inputs must be copied into the tensors used
+    as inputs during the capture, whose outputs are overwritten on each
+    replay.
+
+    .. warning::
+        The capture must run on a stream other than the default stream, after
+        a warmup run on that stream that did the lazy initializations (cuBLAS
+        and cuDNN handles, cuDNN benchmarking). Operations that synchronize
+        with the CPU can't be captured, and random number generators replay
+        the numbers drawn during the capture. Requires CUDA 11.
+    """
+
+    def __new__(cls, **kwargs):
+        return super(CUDAGraph, cls).__new__(cls, **kwargs)
+
+    def capture_begin(self):
+        r"""Begins capturing the work of the current stream."""
+        super(CUDAGraph, self).capture_begin()
+
+    def capture_end(self):
+        r"""Ends the capture, and instantiates the graph for replays."""
+        super(CUDAGraph, self).capture_end()
+
+    def replay(self):
+        r"""Launches the captured work on the current stream."""
+        super(CUDAGraph, self).replay()
+
+    def reset(self):
+        r"""Deletes the graph, and frees its memory pool once the tensors
+        allocated during the capture are freed."""
+        super(CUDAGraph, self).reset()
+
+
+def _flatten(outputs):
+    if isinstance(outputs, torch.Tensor):
+        return [outputs]
+    if isinstance(outputs, (list, tuple)):
+        return [t for o in outputs for t in _flatten(o)]
+    raise TypeError("Graphed callables must return tensors or (nested) lists "
+                    "or tuples of tensors, got {}".format(type(outputs)))
+
+
+class _GraphedCallable(object):
+    def __init__(self, callable, warmup_iters):
+        self.callable = callable
+        self.warmup_iters = warmup_iters
+        # (static inputs, graph, static outputs) of each input signature
+        self.graphs = {}
+
+    def _capture(self, args):
+        static_args = tuple(a.clone() for a in args)
+        stream = torch.cuda.Stream()
+        stream.wait_stream(torch.cuda.current_stream())
+        graph = CUDAGraph()
+        with torch.cuda.stream(stream):
+            for _ in range(self.warmup_iters):
+                self.callable(*static_args)
+            graph.capture_begin()
+            try:
+                static_outputs = self.callable(*static_args)
+            finally:
+                graph.capture_end()
+        torch.cuda.current_stream().wait_stream(stream)
+        _flatten(static_outputs)
+        return static_args, graph, static_outputs
+
+    def __call__(self, *args):
+        for a in args:
+            if not isinstance(a, torch.Tensor) or not a.is_cuda:
+                raise TypeError("Graphed callables only take CUDA tensors")
+        key = tuple((a.shape, a.dtype, a.device) for a in args)
+        with torch.no_grad():
+            entry = self.graphs.get(key)
+            if entry is None:
+                entry = self._capture(args)
+                self.graphs[key] = entry
+            static_args, graph, static_outputs = entry
+            for static_arg, arg in zip(static_args, args):
+                static_arg.copy_(arg)
+            graph.replay()
+        return static_outputs
+
+
+def make_graphed_callable(callable, warmup_iters=3):
+    r"""Wraps an inference callable, like an ``nn.Module`` or a
+    ``torch.jit.ScriptModule``, into one that replays a :class:`CUDAGraph`.
+
+    The callable must take CUDA tensors and return tensors or lists or tuples
+    of tensors, and must launch the same work for inputs of the same shapes.
+    The first call with a new combination of input shapes, dtypes and devices
+    runs :attr:`warmup_iters` iterations on a side stream, then captures a
+    graph; later calls with that combination copy the inputs into the inputs
+    of the capture and replay its graph. Calls run under ``torch.no_grad()``.
+
+    .. warning::
+        The returned tensors are the outputs of the capture, which the next
+        call with the same input shapes overwrites: clone them to keep them.
+
+    Arguments:
+        callable: the function or module to graph.
+        warmup_iters (int, optional): number of runs before each capture.
+            Default: 3.
+    """
+    return _GraphedCallable(callable, warmup_iters)
@@ -4,7 +4,7 @@ import warnings
 from typing import Any, Dict, Union
 
 import torch
-from . import is_initialized, _get_device_index
+from . import is_initialized, _get_device_index, _lazy_init
 from torch.types import Device
 
 def _host_allocator():
@@ -137,6 +137,13 @@ def memory_stats(device: Union[Device, int] = None) -> Dict[str, Any]:
       result in a cache flush and retry.
     - ``"num_ooms"``: number of out-of-memory errors thrown.
 
+    Finally, the memory held by the weight casts that
+    :class:`torch.cuda.amp.autocast` caches is reported, as part of the
+    allocated memory:
+
+    - ``"autocast_cache_bytes.{current,peak}"``: amount of memory held by the
+      cached casts of all threads.
+
     Arguments:
         device (torch.device or int, optional): selected device. Returns
             statistics for the current device, given by :func:`~torch.cuda.current_device`,
@@ -368,6 +375,62 @@ def memory_snapshot():
     return torch._C._cuda_memorySnapshot()
 
 
+def record_memory_history(enabled: bool = True, record_stacks: bool = False,
+                          max_entries: int = 100000) -> None:
+    r"""Starts or stops recording the events of the CUDA memory allocator.
+
+    While recording, each device keeps its last :attr:`max_entries` events:
+    allocations and frees made by tensors, segments allocated and released
+    from CUDA, and out of memory errors. :func:`~torch.cuda.memory_history`
+    returns them. Calling this function again drops the recorded events.
+
+    Arguments:
+        enabled (bool, optional): whether to record events (default: True).
+        record_stacks (bool, optional): whether to record the C++ stack trace
+            of each allocation (default: False). This slows down allocations
+            considerably, recording events without stacks is cheap.
+        max_entries (int, optional): number of events recorded per device
+            (default: 100000).
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    _lazy_init()
+    torch._C._cuda_recordMemoryHistory(enabled, record_stacks, max_entries)
+
+
+def memory_history(device: Union[Device, int] = None) -> Dict[str, Any]:
+    r"""Returns the events of the CUDA memory allocator recorded for a given
+    device since :func:`~torch.cuda.record_memory_history` was called.
+
+    The result is a dictionary with two keys:
+
+    - ``"entries"``: the events, oldest first. Each is a dictionary with the
+      ``"action"`` (``"alloc"``, ``"free"``, ``"segment_alloc"``,
+      ``"segment_free"``, ``"segment_map"``, ``"segment_unmap"`` or
+      ``"oom"``), the ``"address"`` and ``"size"`` of the memory, the
+      ``"stream"``, the ``"time_us"`` of the event and its ``"stack_id"``.
+    - ``"stacks"``: the stack traces recorded, indexed by the ``"stack_id"``
+      of the events and of the blocks in :func:`~torch.cuda.memory_snapshot`,
+      which is -1 where no stack was recorded.
+
+    Arguments:
+        device (torch.device or int, optional): selected device. Returns
+            the history of the current device, given by
+            :func:`~torch.cuda.current_device`, if :attr:`device` is ``None``
+            (default).
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    if not is_initialized():
+        return {"entries": [], "stacks": []}
+    device = _get_device_index(device, optional=True)
+    return torch._C._cuda_memoryHistory(device)
+
+
 def memory_summary(device: Union[Device, int] = None, abbreviated: bool = False) -> str:
     r"""Returns a human-readable printout of the current memory allocator
     statistics for a given device.
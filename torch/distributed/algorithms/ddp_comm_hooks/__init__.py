@@ -0,0 +1,54 @@
+from enum import Enum
+from functools import partial
+
+import torch.distributed as dist
+
+from . import default_hooks as default
+from . import powerSGD_hook as powerSGD
+
+
+def _ddp_comm_hook_wrapper(comm_hook, model, state):
+    model.register_comm_hook(state, comm_hook)
+
+
+def _powerSGD_comm_hook_wrapper(comm_hook, model, state, matrix_approximation_rank):
+    powerSGD_state = powerSGD.PowerSGDState(
+        process_group=state,
+        matrix_approximation_rank=matrix_approximation_rank,
+    )
+    model.register_comm_hook(powerSGD_state, comm_hook)
+
+
+class DDPCommHookType(Enum):
+    r"""
+    Enumerates the Python communication hooks in ``ddp_comm_hooks`` and
+    ``ddp_comm_hook_wrapper`` partials with their hook. Use it to register a
+    hook by name, e.g. ``DDPCommHookType.FP16_COMPRESS.value(model=model, state=process_group)``.
+    """
+    ALLREDUCE = partial(_ddp_comm_hook_wrapper, comm_hook=default.allreduce_hook)
+    FP16_COMPRESS = partial(
+        _ddp_comm_hook_wrapper, comm_hook=default.fp16_compress_hook
+    )
+    POWER_SGD = partial(
+        _powerSGD_comm_hook_wrapper,
+        comm_hook=powerSGD.powerSGD_hook,
+        matrix_approximation_rank=1,
+    )
+    POWER_SGD_RANK2 = partial(
+        _powerSGD_comm_hook_wrapper,
+        comm_hook=powerSGD.powerSGD_hook,
+        matrix_approximation_rank=2,
+    )
+
+
+def register_ddp_comm_hook(comm_hook_type: DDPCommHookType, model, state=None):
+    r"""
+    Registers the hook named by ``comm_hook_type`` on the DDP ``model``.
+    ``state`` is the process group to communicate over; ``None`` means the
+    default group.
+    """
+    comm_hook_type.value(model=model, state=state)
+
+
+# Hooks that are implemented in C++ and run without taking the GIL.
+BuiltinCommHookType = dist.BuiltinCommHookType
@@ -0,0 +1,47 @@
+import torch
+import torch.distributed as dist
+
+
+def allreduce_hook(process_group, bucket):
+    r"""
+    Allreduces the bucket, i.e. does what DDP does without a hook. The
+    gradients in the bucket have already been divided by the world size, so
+    the sum is the average. Mostly useful as a template for new hooks.
+
+    Like the other Python hooks, this only supports the single-process
+    single-device mode, where the bucket holds a single tensor.
+
+    Example::
+        >>> ddp_model.register_comm_hook(process_group, allreduce_hook)
+    """
+    group_to_use = process_group if process_group is not None else dist.group.WORLD
+
+    tensor = bucket.get_tensors()[0]
+    fut = dist.all_reduce(tensor, group=group_to_use, async_op=True).get_future()
+
+    def then_callback(fut):
+        return [tensor]
+
+    return fut.then(then_callback)
+
+
+def fp16_compress_hook(process_group, bucket):
+    r"""
+    Casts the bucket to ``torch.float16``, allreduces it, and casts the result
+    back to the original dtype. This halves the bytes on the wire at the cost
+    of precision.
+
+    Example::
+        >>> ddp_model.register_comm_hook(process_group, fp16_compress_hook)
+    """
+    group_to_use = process_group if process_group is not None else dist.group.WORLD
+
+    compressed_tensor = bucket.get_tensors()[0].to(torch.float16)
+    fut = dist.all_reduce(
+        compressed_tensor, group=group_to_use, async_op=True
+    ).get_future()
+
+    def decompress(fut):
+        return [compressed_tensor.to(bucket.get_tensors()[0].dtype)]
+
+    return fut.then(decompress)
@@ -0,0 +1,128 @@
+import math
+
+import torch
+import torch.distributed as dist
+
+
+def _orthogonalize(matrix, epsilon=1e-8):
+    r"""
+    Orthonormalizes the columns of ``matrix`` in place with Gram-Schmidt.
+    """
+    num_cols = matrix.shape[1]
+    for i in range(num_cols):
+        col = matrix[:, i : i + 1]
+        col /= torch.norm(col) + epsilon
+        if i + 1 < num_cols:
+            rest = matrix[:, i + 1 :]
+            rest -= torch.sum(col * rest, dim=0) * col
+
+
+class PowerSGDState(object):
+    r"""
+    State of :func:`powerSGD_hook`, kept across iterations.
+
+    Args:
+        process_group: The process group to communicate over; ``None`` means
+            the default group.
+        matrix_approximation_rank: Rank of the low-rank approximation of each
+            bucket. Higher ranks are more accurate and send more data.
+        use_error_feedback: Adds the approximation error of the previous
+            iteration to the bucket before compressing, which is needed for
+            convergence in most cases.
+        random_seed: Seed used to initialize the ``Q`` matrices; it must be
+            the same on all processes.
+    """
+
+    __slots__ = [
+        "process_group",
+        "matrix_approximation_rank",
+        "use_error_feedback",
+        "rng",
+        "error_dict",
+        "q_memory_dict",
+    ]
+
+    def __init__(
+        self,
+        process_group,
+        matrix_approximation_rank=1,
+        use_error_feedback=True,
+        random_seed=0,
+    ):
+        self.process_group = process_group
+        self.matrix_approximation_rank = matrix_approximation_rank
+        self.use_error_feedback = use_error_feedback
+        self.rng = torch.Generator().manual_seed(random_seed)
+        # Keyed by the data pointer of the bucket, which stays the same across
+        # iterations as long as the buckets are not rebuilt.
+        self.error_dict = {}
+        self.q_memory_dict = {}
+
+
+def powerSGD_hook(state, bucket):
+    r"""
+    Compresses each bucket with PowerSGD (Vogels et al., NeurIPS 2019).
+
+    The flattened bucket is viewed as an ``n x m`` matrix ``M`` and
+    approximated as ``P Q^T`` with ``P`` of shape ``n x r`` and ``Q`` of shape
+    ``m x r``, where ``r`` is ``state.matrix_approximation_rank``:
+
+    1. ``P = M Q`` is allreduced and orthonormalized;
+    2. ``Q = M^T P`` is allreduced;
+    3. the bucket is replaced by ``P Q^T``.
+
+    Only ``(n + m) * r`` elements are sent instead of ``n * m``. ``Q`` is
+    reused as the starting point of the next iteration, which makes a single
+    power iteration per step sufficient.
+
+    Like the other Python hooks, this only supports the single-process
+    single-device mode, where the bucket holds a single tensor.
+
+    Example::
+        >>> state = PowerSGDState(process_group=process_group, matrix_approximation_rank=1)
+        >>> ddp_model.register_comm_hook(state, powerSGD_hook)
+    """
+    process_group = state.process_group
+    group_to_use = process_group if process_group is not None else dist.group.WORLD
+
+    input_tensor = bucket.get_tensors()[0]
+    device = input_tensor.device
+    dtype = input_tensor.dtype
+    total_length = input_tensor.numel()
+    key = input_tensor.data_ptr()
+
+    # View the bucket as a (roughly) square matrix, padding it with zeros.
+    square_side_length = math.ceil(math.sqrt(total_length))
+    padded_total_length = square_side_length ** 2
+    matrix = torch.zeros(padded_total_length, device=device, dtype=dtype)
+    matrix[:total_length].copy_(input_tensor)
+    if state.use_error_feedback:
+        if key in state.error_dict:
+            matrix += state.error_dict[key]
+        input_tensor_cp = matrix.clone()
+    matrix = matrix.view(square_side_length, square_side_length)
+
+    rank = min(state.matrix_approximation_rank, square_side_length)
+    if key not in state.q_memory_dict:
+        q = torch.randn(
+            square_side_length, rank, generator=state.rng, device="cpu"
+        ).to(device=device, dtype=dtype)
+        _orthogonalize(q)
+        state.q_memory_dict[key] = q
+    q = state.q_memory_dict[key]
+
+    p = torch.matmul(matrix, q)
+    dist.all_reduce(p, group=group_to_use)
+    _orthogonalize(p)
+
+    torch.matmul(matrix.t(), p, out=q)
+    fut = dist.all_reduce(q, group=group_to_use, async_op=True).get_future()
+
+    def decompress(fut):
+        approximation = torch.matmul(p, q.t()).view(-1)
+        if state.use_error_feedback:
+            state.error_dict[key] = input_tensor_cp - approximation
+        input_tensor.copy_(approximation[:total_length])
+        return [input_tensor]
+
+    return fut.then(decompress)
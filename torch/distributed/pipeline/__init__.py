@@ -0,0 +1,6 @@
+"""
+:mod:`torch.distributed.pipeline` exposes Pipeline, which trains a model
+split into stages, whose modules live on RPC workers, with pipeline
+parallelism over micro-batches.
+"""
+from .pipeline import Pipeline
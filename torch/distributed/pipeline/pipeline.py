@@ -0,0 +1,398 @@
+import threading
+
+import torch
+import torch.distributed.rpc as rpc
+from torch.utils.checkpoint import checkpoint as _checkpoint
+
+
+_SCHEDULES = ("1f1b", "gpipe")
+_CHECKPOINTS = ("always", "except_last", "never")
+
+
+def _schedule(schedule, stage, num_stages, chunks):
+    r"""
+    Returns the order in which ``stage`` runs the forward and backward passes
+    of the micro-batches, as ``(forward, chunk)`` pairs.
+    """
+    if schedule == "gpipe":
+        return ([(True, i) for i in range(chunks)] +
+                [(False, i) for i in reversed(range(chunks))])
+    # 1F1B: after the forward passes that fill the pipeline, each stage
+    # alternates between the forward pass of the next micro-batch and the
+    # backward pass of the oldest one, so that at most ``num_stages - stage``
+    # micro-batches hold activations at a time, instead of all of them.
+    warmup = min(num_stages - stage - 1, chunks)
+    order = [(True, i) for i in range(warmup)]
+    for i in range(chunks - warmup):
+        order += [(True, warmup + i), (False, i)]
+    order += [(False, i) for i in range(chunks - warmup, chunks)]
+    return order
+
+
+class _PipelineStage(object):
+    r"""
+    Runs one stage of a :class:`Pipeline` on the owner of its module. The
+    activations and gradients of the micro-batches arrive from the adjacent
+    stages through :meth:`receive`, which completes the future that
+    :meth:`run` waits for.
+    """
+    def __init__(self, module_rref, stage, num_stages, schedule, loss_fn,
+                 optimizer):
+        self.module = module_rref.local_value()
+        self.stage = stage
+        self.num_stages = num_stages
+        self.schedule = schedule
+        self.loss_fn = loss_fn
+        self.optimizer = (optimizer(self.module.parameters())
+                          if optimizer is not None else None)
+        param = next(self.module.parameters(), None)
+        self.device = param.device if param is not None else torch.device("cpu")
+        self.prev = None
+        self.next = None
+        self.lock = threading.Lock()
+        # (step, kind, chunk) -> future of the tensor received for it
+        self.mailbox = {}
+        self.received = set()
+        # step -> the error that aborted it on another stage
+        self.errors = {}
+        self.last_step = -1
+
+    def connect(self, prev, next):
+        self.prev = prev
+        self.next = next
+
+    def _slot(self, key):
+        with self.lock:
+            if key not in self.mailbox:
+                self.mailbox[key] = torch.futures.Future()
+                if key[0] in self.errors:
+                    self.received.add(key)
+                    self.mailbox[key].set_result(self.errors[key[0]])
+            return self.mailbox[key]
+
+    def receive(self, key, value):
+        fut = self._slot(key)
+        with self.lock:
+            if key in self.received:
+                # The step has been aborted already
+                return
+            self.received.add(key)
+        fut.set_result(value)
+
+    def abort(self, step, error):
+        r"""
+        Fails the waits of ``step`` with ``error``, and forwards it to the
+        adjacent stages, which would otherwise wait forever for this one.
+        """
+        with self.lock:
+            if step <= self.last_step or step in self.errors:
+                return
+            self.errors[step] = error
+            pending = [(key, fut) for key, fut in self.mailbox.items()
+                       if key[0] == step and key not in self.received]
+            self.received.update(key for key, _ in pending)
+        for _, fut in pending:
+            fut.set_result(error)
+        self._send_abort(step, error)
+
+    def _send_abort(self, step, error):
+        for stage in (self.prev, self.next):
+            if stage is not None:
+                rpc.rpc_async(stage.owner(), _abort, args=(stage, step, error))
+
+    def _wait(self, key):
+        value = self._slot(key).wait()
+        if isinstance(value, Exception):
+            raise value
+        return value.to(self.device)
+
+    def _send(self, stage, key, tensor):
+        return rpc.rpc_async(
+            stage.owner(), _receive, args=(stage, key, tensor.detach().cpu()))
+
+    def run(self, step, chunks, train, checkpoint, inputs, targets, batch_size):
+        try:
+            return self._run(
+                step, chunks, train, checkpoint, inputs, targets, batch_size)
+        except Exception as e:
+            error = RuntimeError(
+                "Stage {} of the pipeline failed: {}".format(self.stage, e))
+            with self.lock:
+                forward = step not in self.errors
+                self.errors.setdefault(step, error)
+            if forward:
+                self._send_abort(step, error)
+            raise
+        finally:
+            with self.lock:
+                self.last_step = step
+                self.errors.pop(step, None)
+                for key in [key for key in self.mailbox if key[0] == step]:
+                    del self.mailbox[key]
+                    self.received.discard(key)
+
+    def _run(self, step, chunks, train, checkpoint, inputs, targets, batch_size):
+        first = self.stage == 0
+        last = self.stage == self.num_stages - 1
+        if train:
+            order = _schedule(self.schedule, self.stage, self.num_stages, chunks)
+        else:
+            order = [(True, i) for i in range(chunks)]
+
+        # chunk -> (input, output) of the forward passes awaiting a backward
+        activations = {}
+        outputs = []
+        sends = []
+        loss = 0.
+        for forward, i in order:
+            if forward:
+                x = inputs[i].to(self.device) if first else \
+                    self._wait((step, "activation", i))
+                if not train:
+                    with torch.no_grad():
+                        y = self.module(x)
+                    if last:
+                        outputs.append(y.cpu())
+                    else:
+                        sends.append(self._send(
+                            self.next, (step, "activation", i), y))
+                    continue
+
+                recompute = (checkpoint == "always" or
+                             (checkpoint == "except_last" and i != chunks - 1))
+                if not first or (recompute and x.is_floating_point()):
+                    # The gradient of the input is sent to the previous stage,
+                    # and checkpoint() only recomputes outputs that require
+                    # grad, for which one of its inputs has to.
+                    x.requires_grad_(x.is_floating_point())
+                if recompute and x.requires_grad:
+                    y = _checkpoint(self.module, x)
+                else:
+                    y = self.module(x)
+                if last:
+                    # Mean reduced losses of the micro-batches add up to the
+                    # loss of the whole batch once weighted by their sizes
+                    target = targets[i].to(self.device)
+                    y = self.loss_fn(y, target) * (target.size(0) / batch_size)
+                    loss += y.item()
+                else:
+                    sends.append(self._send(
+                        self.next, (step, "activation", i), y))
+                activations[i] = (x, y)
+            else:
+                x, y = activations.pop(i)
+                if last:
+                    torch.autograd.backward(y)
+                else:
+                    torch.autograd.backward(
+                        y, self._wait((step, "gradient", i)))
+                if not first:
+                    grad = x.grad if x.grad is not None else torch.zeros_like(x)
+                    sends.append(self._send(
+                        self.prev, (step, "gradient", i), grad))
+        torch.futures.wait_all(sends)
+        if not last:
+            return None
+        return loss if train else torch.cat(outputs)
+
+    def step(self):
+        self.optimizer.step()
+
+    def zero_grad(self):
+        if self.optimizer is not None:
+            self.optimizer.zero_grad()
+        else:
+            self.module.zero_grad()
+
+
+def _new_stage(module_rref, stage, num_stages, schedule, loss_fn, optimizer):
+    return rpc.RRef(_PipelineStage(
+        module_rref, stage, num_stages, schedule, loss_fn, optimizer))
+
+
+def _call_method(method, stage_rref, *args):
+    return method(stage_rref.local_value(), *args)
+
+
+def _receive(stage_rref, key, value):
+    stage_rref.local_value().receive(key, value)
+
+
+def _abort(stage_rref, step, error):
+    stage_rref.local_value().abort(step, error)
+
+
+def _wait_for_all(rpc_futs):
+    exception = None
+    results = []
+    for fut in rpc_futs:
+        try:
+            results.append(fut.wait())
+        except Exception as e:
+            results.append(e)
+            exception = e
+    if exception is not None:
+        raise exception
+    return results
+
+
+class Pipeline(object):
+    r"""
+    Trains a model split into stages, whose modules live on RPC workers, with
+    pipeline parallelism: every batch is split into ``chunks`` micro-batches,
+    which flow through the stages such that the stages work on different
+    micro-batches at the same time.
+
+    Every stage runs its forward and backward passes in the order of the
+    schedule on the worker that owns its module. The output of its forward
+    pass of a micro-batch is sent asynchronously to the next stage, and the
+    gradient of its input to the previous stage, directly over RPC, so that
+    the caller only sends a single RPC per stage for every batch. The
+    backward passes run on the local autograd engine of each stage, and
+    accumulate the gradients into the ``grad`` of the stage's parameters,
+    like ``loss.backward()`` does on a single worker.
+
+    Two schedules are supported:
+
+    - ``"1f1b"``: every stage alternates between the forward pass of a
+      micro-batch and the backward pass of an earlier one, once the pipeline
+      is full. Stage ``i`` of ``n`` keeps the activations of at most ``n - i``
+      micro-batches.
+    - ``"gpipe"``: every stage runs the forward passes of all micro-batches,
+      then the backward passes, and keeps the activations of all of them.
+
+    To save the memory of activations, the forward pass of a micro-batch can
+    be recomputed during its backward pass with
+    :func:`torch.utils.checkpoint.checkpoint`: ``checkpoint="always"`` does
+    it for all micro-batches, ``"except_last"`` for all but the last one,
+    whose backward pass comes next, and ``"never"`` for none of them.
+
+    The module of every stage takes and returns a single tensor; tensors
+    passed between stages have to be floating point. Stage modules that
+    have parameters run on the device of their first parameter.
+
+    Arguments:
+        stages (list[RRef]): remote references to the ``nn.Module`` of every
+            stage, in order, e.g. created with
+            :meth:`~torch.distributed.rpc.remote`.
+        loss_fn (callable): takes the output of the last stage for a
+            micro-batch and its target, and returns its loss. It is pickled
+            to the owner of the last stage.
+        chunks (int): the number of micro-batches to split a batch into.
+        schedule (str): ``"1f1b"`` (default) or ``"gpipe"``.
+        checkpoint (str): ``"never"`` (default), ``"except_last"`` or
+            ``"always"``.
+        optimizer (callable, optional): takes the parameters of a stage and
+            returns the optimizer :meth:`step` runs on them, e.g.
+            ``functools.partial(torch.optim.SGD, lr=0.1)``.
+
+    Example::
+        >>> import functools
+        >>> import torch.distributed.rpc as rpc
+        >>> from torch import nn, optim
+        >>> from torch.distributed.pipeline import Pipeline
+        >>>
+        >>> stages = [
+        >>>     rpc.remote("worker1", nn.Linear, args=(16, 32)),
+        >>>     rpc.remote("worker2", nn.Linear, args=(32, 4)),
+        >>> ]
+        >>> pipe = Pipeline(stages, nn.MSELoss(), chunks=4,
+        >>>                 optimizer=functools.partial(optim.SGD, lr=0.1))
+        >>> for input, target in data:
+        >>>     pipe.zero_grad()
+        >>>     loss = pipe.forward_backward(input, target)
+        >>>     pipe.step()
+    """
+    def __init__(self, stages, loss_fn, chunks, schedule="1f1b",
+                 checkpoint="never", optimizer=None):
+        if len(stages) == 0:
+            raise ValueError("A pipeline needs at least one stage")
+        if chunks <= 0:
+            raise ValueError("chunks must be positive, got {}".format(chunks))
+        if schedule not in _SCHEDULES:
+            raise ValueError("schedule must be one of {}, got '{}'".format(
+                _SCHEDULES, schedule))
+        if checkpoint not in _CHECKPOINTS:
+            raise ValueError("checkpoint must be one of {}, got '{}'".format(
+                _CHECKPOINTS, checkpoint))
+        self.chunks = chunks
+        self.checkpoint = checkpoint
+        self.has_optimizer = optimizer is not None
+        self._step = 0
+
+        num_stages = len(stages)
+        self.stages = _wait_for_all([
+            rpc.rpc_async(
+                module_rref.owner(),
+                _new_stage,
+                args=(module_rref, i, num_stages, schedule,
+                      loss_fn if i == num_stages - 1 else None, optimizer),
+            )
+            for i, module_rref in enumerate(stages)
+        ])
+        self._run_on_stages(_PipelineStage.connect, lambda i: (
+            self.stages[i - 1] if i > 0 else None,
+            self.stages[i + 1] if i < num_stages - 1 else None))
+
+    def _run_on_stages(self, method, args=lambda i: ()):
+        return _wait_for_all([
+            rpc.rpc_async(
+                stage.owner(),
+                _call_method,
+                args=(method, stage) + tuple(args(i)))
+            for i, stage in enumerate(self.stages)
+        ])
+
+    def _run(self, input, target, train):
+        inputs = input.chunk(self.chunks)
+        targets = target.chunk(self.chunks) if train else None
+        if train and len(targets) != len(inputs):
+            raise ValueError(
+                "The batch sizes of the input and target differ: {} and {}".format(
+                    input.size(0), target.size(0)))
+        step = self._step
+        self._step += 1
+        last = len(self.stages) - 1
+        return self._run_on_stages(_PipelineStage.run, lambda i: (
+            step, len(inputs), train, self.checkpoint,
+            inputs if i == 0 else None,
+            targets if i == last else None,
+            input.size(0)))[-1]
+
+    def forward_backward(self, input, target):
+        r"""
+        Runs the forward and backward passes of a batch through the pipeline
+        and accumulates the gradients of the parameters of every stage.
+
+        Arguments:
+            input (Tensor): the input of the first stage for the batch, which
+                is split along its first dimension.
+            target (Tensor): the target of the batch, split like ``input``.
+
+        Returns:
+            The loss of the batch: the losses of the micro-batches, weighted
+            by their share of the batch, which is their average for losses
+            that are averaged over the batch.
+        """
+        return self._run(input, target, train=True)
+
+    def forward(self, input):
+        r"""
+        Runs the forward pass of a batch through the pipeline without
+        recording it for autograd, and returns the output of the last stage.
+        """
+        return self._run(input, None, train=False)
+
+    def step(self):
+        r"""
+        Runs the optimizer of every stage, see the ``optimizer`` argument.
+        """
+        if not self.has_optimizer:
+            raise RuntimeError("The pipeline was constructed without an optimizer")
+        self._run_on_stages(_PipelineStage.step)
+
+    def zero_grad(self):
+        r"""
+        Sets the gradients of the parameters of every stage to zero.
+        """
+        self._run_on_stages(_PipelineStage.zero_grad)
@@ -158,6 +158,8 @@ def _tensorpipe_construct_rpc_backend_options_handler(
     num_worker_threads=rpc_constants.DEFAULT_NUM_WORKER_THREADS,
     _transports=None,
     _channels=None,
+    _num_large_message_pipes=rpc_constants.DEFAULT_NUM_LARGE_MESSAGE_PIPES,
+    _large_message_threshold=rpc_constants.DEFAULT_LARGE_MESSAGE_THRESHOLD,
     **kwargs
 ):
     from . import TensorPipeRpcBackendOptions
@@ -168,6 +170,8 @@ def _tensorpipe_construct_rpc_backend_options_handler(
         num_worker_threads=num_worker_threads,
         _transports=_transports,
         _channels=_channels,
+        _num_large_message_pipes=_num_large_message_pipes,
+        _large_message_threshold=_large_message_threshold,
     )
 
 
@@ -2,6 +2,8 @@ from datetime import timedelta
 
 from . import (
     _DEFAULT_INIT_METHOD,
+    _DEFAULT_LARGE_MESSAGE_THRESHOLD,
+    _DEFAULT_NUM_LARGE_MESSAGE_PIPES,
     _DEFAULT_NUM_SEND_RECV_THREADS,
     _DEFAULT_NUM_WORKER_THREADS,
     _DEFAULT_RPC_TIMEOUT_SEC,
@@ -17,6 +19,8 @@ DEFAULT_INIT_METHOD = _DEFAULT_INIT_METHOD
 DEFAULT_NUM_SEND_RECV_THREADS = _DEFAULT_NUM_SEND_RECV_THREADS
 # For TensorPipeAgent.
 DEFAULT_NUM_WORKER_THREADS = _DEFAULT_NUM_WORKER_THREADS
+DEFAULT_NUM_LARGE_MESSAGE_PIPES = _DEFAULT_NUM_LARGE_MESSAGE_PIPES
+DEFAULT_LARGE_MESSAGE_THRESHOLD = _DEFAULT_LARGE_MESSAGE_THRESHOLD
 # Ensure that we don't time out when there are long periods of time without
 # any operations against the underlying ProcessGroup.
 DEFAULT_PROCESS_GROUP_TIMEOUT = timedelta(milliseconds=2 ** 31 - 1)
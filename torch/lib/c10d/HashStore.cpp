@@ -87,4 +87,18 @@ bool HashStore::check(const std::vector<std::string>& keys) {
   return true;
 }
 
+std::vector<uint8_t> HashStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::unique_lock<std::mutex> lock(m_);
+  auto it = map_.find(key);
+  if (it != map_.end() ? it->second != expectedValue : !expectedValue.empty()) {
+    return it != map_.end() ? it->second : std::vector<uint8_t>();
+  }
+  map_[key] = desiredValue;
+  cv_.notify_all();
+  return desiredValue;
+}
+
 } // namespace c10d
@@ -48,20 +48,60 @@ void ProcessGroup::Work::abort() {
   TORCH_CHECK(false, "ProcessGroup::Work::abort not implemented.")
 }
 
+c10::intrusive_ptr<c10::ivalue::Future> ProcessGroup::Work::getFuture() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (future_) {
+    return future_;
+  }
+  future_ = c10::make_intrusive<c10::ivalue::Future>(c10::NoneType::get());
+  // If the work is not done yet, finish() completes the future.
+  if (completed_) {
+    auto future = future_;
+    lock.unlock();
+    completeFuture(future);
+    return future;
+  }
+  return future_;
+}
+
+void ProcessGroup::Work::completeFuture(
+    const c10::intrusive_ptr<c10::ivalue::Future>& future) {
+  std::exception_ptr exception = this->exception();
+  if (exception) {
+    try {
+      std::rethrow_exception(exception);
+    } catch (const std::exception& e) {
+      future->setError(e.what());
+    }
+    return;
+  }
+  synchronize();
+  future->markCompleted();
+}
+
 void ProcessGroup::Work::finish(std::exception_ptr exception) {
   std::unique_lock<std::mutex> lock(mutex_);
   completed_ = true;
   exception_ = exception;
+  auto future = future_;
   lock.unlock();
   cv_.notify_all();
+  if (future) {
+    completeFuture(future);
+  }
 }
 
 void ProcessGroup::Work::finishAndThrow(std::exception_ptr exception) {
   std::unique_lock<std::mutex> lock(mutex_);
   completed_ = true;
   exception_ = exception;
-  if (exception_) {
-    std::rethrow_exception(exception_);
+  auto future = future_;
+  lock.unlock();
+  if (future) {
+    completeFuture(future);
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
   }
 }
 
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
 
 #include <c10d/Types.hpp>
 
@@ -87,6 +88,12 @@ class ProcessGroup {
 
     virtual void abort();
 
+    // Returns a Future that completes (with no value) when this work does,
+    // or with an error if the work failed. Callbacks attached to it may run
+    // on the thread that completes the work; synchronize() has been called
+    // on that thread before, so they can safely use the output tensors.
+    virtual c10::intrusive_ptr<c10::ivalue::Future> getFuture();
+
    protected:
     // Completes the work object and optionally sets the exception in a
     // thread-safe manner. Notifies all waiting condition variables as well.
@@ -100,6 +107,13 @@ class ProcessGroup {
     std::condition_variable cv_;
     bool completed_ = false;
     std::exception_ptr exception_;
+
+   private:
+    void completeFuture(
+        const c10::intrusive_ptr<c10::ivalue::Future>& future);
+
+    // Created by getFuture(), completed by finish().
+    c10::intrusive_ptr<c10::ivalue::Future> future_;
   };
 
   explicit ProcessGroup(int rank, int size);
@@ -7,11 +7,17 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
 #include <type_traits>
 
 #include <gloo/allgather.h>
 #include <gloo/allgatherv.h>
 #include <gloo/allreduce.h>
+#include <gloo/alltoall.h>
+#include <gloo/alltoallv.h>
 #include <gloo/barrier.h>
 #include <gloo/broadcast.h>
 #include <gloo/gather.h>
@@ -19,6 +25,7 @@
 #include <gloo/scatter.h>
 
 #include <ATen/SparseTensorUtils.h>
+#include <TH/THAllocator.h>
 
 #ifdef USE_CUDA
 #include <ATen/cuda/CUDAEvent.h>
@@ -218,6 +225,16 @@ void setOutput(O& opts, at::Tensor& tensor, std::vector<size_t>& counts) {
   opts.setOutput(getDataPointer<T>(tensor), counts);
 }
 
+template <typename T, typename O>
+void setInput(O& opts, at::Tensor& tensor, std::vector<int64_t>& counts) {
+  opts.setInput(getDataPointer<T>(tensor), counts);
+}
+
+template <typename T, typename O>
+void setOutput(O& opts, at::Tensor& tensor, std::vector<int64_t>& counts) {
+  opts.setOutput(getDataPointer<T>(tensor), counts);
+}
+
 #ifdef USE_CUDA
 
 at::Tensor pinnedLike(at::Tensor& tensor) {
@@ -380,7 +397,10 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      hierarchicalAllreduce(false),
+      hierarchicalAllreduceSlotBytes(4 * 1024 * 1024) {}
 
 namespace {
 
@@ -490,6 +510,235 @@ std::shared_ptr<::gloo::transport::Device> ProcessGroupGloo::
 }
 #endif
 
+// Note [Hierarchical allreduce]
+//
+// With Options::hierarchicalAllreduce, the ranks that share a host map one
+// shared memory segment: a small header followed by one slot of
+// hierarchicalAllreduceSlotBytes per local rank. Every allreduce is run in
+// chunks of one slot, and for every chunk
+//
+//   1. every local rank copies its chunk into its slot;
+//   2. every local rank reduces its 1/localSize slice of the chunk over all
+//      slots, into slot 0;
+//   3. the lowest rank on every host (its leader) allreduces slot 0 with the
+//      other leaders, through a Gloo context that only connects the leaders;
+//   4. every local rank copies slot 0 back into its tensor;
+//
+// with a barrier in shared memory after every step. Only the leaders send
+// data over the network.
+//
+// The segment is shared by all hierarchical allreduces of the process group,
+// so they must run one at a time and in the order they were issued, which is
+// the same on every rank. Each one takes a ticket when it is issued and waits
+// for its turn before touching the segment.
+class ProcessGroupGloo::IntraNodeGroup {
+ public:
+  // Size of the header at the start of the shared memory segment.
+  static constexpr size_t kHeaderBytes = 128;
+
+  IntraNodeGroup(
+      int localRank,
+      int localSize,
+      at::DataPtr shm,
+      size_t slotBytes,
+      std::chrono::milliseconds timeout,
+      std::shared_ptr<::gloo::Context> leaderContext)
+      : localRank(localRank),
+        localSize(localSize),
+        slotBytes(slotBytes),
+        leaderContext(std::move(leaderContext)),
+        shm_(std::move(shm)),
+        header_(static_cast<Header*>(shm_.get())),
+        timeout_(timeout) {}
+
+  // Called by the leader on a fresh segment before anyone else maps it.
+  static void initializeHeader(void* shm) {
+    new (shm) Header();
+  }
+
+  const int localRank;
+  const int localSize;
+  const size_t slotBytes;
+
+  // Connects the leaders of all hosts. Null on all other ranks, and if all
+  // ranks share a single host.
+  const std::shared_ptr<::gloo::Context> leaderContext;
+
+  char* slot(int index) const {
+    return static_cast<char*>(shm_.get()) + kHeaderBytes + index * slotBytes;
+  }
+
+  // Waits until all local ranks have called barrier().
+  void barrier() {
+    const auto generation = header_->generation.load(std::memory_order_acquire);
+    if (header_->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+        static_cast<uint32_t>(localSize)) {
+      header_->arrived.store(0, std::memory_order_relaxed);
+      header_->generation.store(generation + 1, std::memory_order_release);
+      return;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + timeout_;
+    size_t spins = 0;
+    while (header_->generation.load(std::memory_order_acquire) == generation) {
+      if (++spins < kSpinsBeforeYield) {
+        continue;
+      }
+      std::this_thread::yield();
+      if (std::chrono::steady_clock::now() > deadline) {
+        throw std::runtime_error(
+            "Timed out waiting for the other ranks on this host in "
+            "hierarchical allreduce");
+      }
+    }
+  }
+
+  uint64_t nextTicket() {
+    return nextTicket_++;
+  }
+
+  // Blocks until all allreduces issued before the one holding `ticket`
+  // have released the segment.
+  void acquire(uint64_t ticket) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return currentTicket_ == ticket; });
+  }
+
+  void release() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    currentTicket_++;
+    lock.unlock();
+    cv_.notify_all();
+  }
+
+ private:
+  static constexpr size_t kSpinsBeforeYield = 1000;
+
+  struct Header {
+    alignas(64) std::atomic<uint32_t> arrived{0};
+    alignas(64) std::atomic<uint32_t> generation{0};
+  };
+  static_assert(sizeof(Header) <= kHeaderBytes, "header must fit");
+  static_assert(
+      ATOMIC_INT_LOCK_FREE == 2,
+      "barrier in shared memory requires lock-free atomics");
+
+  at::DataPtr shm_;
+  Header* header_;
+  const std::chrono::milliseconds timeout_;
+
+  std::atomic<uint64_t> nextTicket_{0};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t currentTicket_ = 0;
+};
+
+constexpr size_t ProcessGroupGloo::IntraNodeGroup::kHeaderBytes;
+constexpr size_t ProcessGroupGloo::IntraNodeGroup::kSpinsBeforeYield;
+
+void ProcessGroupGloo::initHierarchicalAllreduce(
+    const std::shared_ptr<Store>& store,
+    const Options& options) {
+#ifdef __linux__
+  const std::string prefix = "hierarchical_allreduce/";
+  auto toBytes = [](const std::string& str) {
+    return std::vector<uint8_t>(str.begin(), str.end());
+  };
+  auto fromBytes = [](const std::vector<uint8_t>& bytes) {
+    return std::string(bytes.begin(), bytes.end());
+  };
+
+  // Ranks that report the same hostname are assumed to share memory.
+  std::array<char, HOST_NAME_MAX + 1> hostname{};
+  if (gethostname(hostname.data(), HOST_NAME_MAX) != 0) {
+    throw std::system_error(errno, std::system_category());
+  }
+  const std::string host(hostname.data());
+  store->set(prefix + "host/" + std::to_string(rank_), toBytes(host));
+
+  std::vector<int> localRanks;
+  std::vector<int> leaders;
+  std::unordered_map<std::string, int> hostLeaders;
+  for (int i = 0; i < size_; i++) {
+    const auto peerHost = i == rank_
+        ? host
+        : fromBytes(store->get(prefix + "host/" + std::to_string(i)));
+    if (hostLeaders.emplace(peerHost, i).second) {
+      leaders.push_back(i);
+    }
+    if (peerHost == host) {
+      localRanks.push_back(i);
+    }
+  }
+  if (leaders.size() == static_cast<size_t>(size_)) {
+    // No two ranks share a host; the flat algorithms do as well.
+    return;
+  }
+
+  const int localSize = localRanks.size();
+  const int localRank =
+      std::find(localRanks.begin(), localRanks.end(), rank_) -
+      localRanks.begin();
+  const int leader = localRanks[0];
+
+  TORCH_CHECK(
+      options.hierarchicalAllreduceSlotBytes > 0,
+      "hierarchicalAllreduceSlotBytes must be positive");
+  // Keep every slot cache line aligned.
+  const size_t slotBytes =
+      (options.hierarchicalAllreduceSlotBytes + 63) / 64 * 64;
+  const size_t shmBytes =
+      IntraNodeGroup::kHeaderBytes + localSize * slotBytes;
+
+  // The leader creates the segment and publishes its name. It is unlinked
+  // by whichever rank unmaps it last.
+  const auto shmKey = prefix + "shm/" + std::to_string(leader);
+  at::DataPtr shm;
+  if (rank_ == leader) {
+    std::random_device rd;
+    const auto name = c10::str("/torch_gloo_", getpid(), "_", rd(), rd());
+    shm = THRefcountedMapAllocator::makeDataPtr(
+        name.c_str(),
+        TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE,
+        shmBytes,
+        nullptr);
+    IntraNodeGroup::initializeHeader(shm.get());
+    store->set(shmKey, toBytes(name));
+  } else {
+    const auto name = fromBytes(store->get(shmKey));
+    shm = THRefcountedMapAllocator::makeDataPtr(
+        name.c_str(),
+        TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE,
+        shmBytes,
+        nullptr);
+  }
+
+  std::shared_ptr<::gloo::Context> leaderContext;
+  if (rank_ == leader && leaders.size() > 1) {
+    const int leaderRank =
+        std::find(leaders.begin(), leaders.end(), rank_) - leaders.begin();
+    auto context = std::make_shared<::gloo::rendezvous::Context>(
+        leaderRank, leaders.size());
+    auto leaderStore =
+        ::gloo::rendezvous::PrefixStore(prefix + "leaders", *store_);
+    context->setTimeout(options.timeout);
+    context->connectFullMesh(leaderStore, options.devices[0]);
+    leaderContext = std::move(context);
+  }
+
+  intraNodeGroup_ = std::make_shared<IntraNodeGroup>(
+      localRank,
+      localSize,
+      std::move(shm),
+      slotBytes,
+      options.timeout,
+      std::move(leaderContext));
+#else
+  TORCH_WARN_ONCE(
+      "Hierarchical allreduce is only supported on Linux; "
+      "using the flat algorithms instead.");
+#endif
+}
+
 ProcessGroupGloo::ProcessGroupGloo(
     const std::shared_ptr<Store>& store,
     int rank,
@@ -525,6 +774,10 @@ ProcessGroupGloo::ProcessGroupGloo(
     contexts_.push_back(std::move(context));
   }
 
+  if (options.hierarchicalAllreduce) {
+    initHierarchicalAllreduce(store, options);
+  }
+
   // Every worker thread stores the AsyncWork object it's currently
   // working on in the workInProgress_ vector. It must have size equal
   // to the number of workers such that they can simply index into it
@@ -827,6 +1080,107 @@ class AsyncAllreduceCoalescedWork : public AsyncAllreduceWork {
   }
 };
 
+template <typename T>
+void setOutputPointer(
+    gloo::AllreduceOptions& opts,
+    void* ptr,
+    size_t count) {
+  opts.setOutput(static_cast<T*>(ptr), count);
+}
+
+// See Note [Hierarchical allreduce].
+class AsyncHierarchicalAllreduceWork : public AsyncAllreduceWork {
+ public:
+  AsyncHierarchicalAllreduceWork(
+      std::shared_ptr<ProcessGroupGloo::IntraNodeGroup> group,
+      std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : AsyncAllreduceWork(group->leaderContext, inputs, reduceOp, tag),
+        group(std::move(group)),
+        ticket(this->group->nextTicket()) {}
+
+  const std::shared_ptr<ProcessGroupGloo::IntraNodeGroup> group;
+  const uint64_t ticket;
+
+  void run() override {
+    at::Tensor tensor = inputs[0].contiguous();
+    const auto& scalarType = tensor.scalar_type();
+    const auto fn = getFunction(scalarType, reduceOp);
+    char* data = static_cast<char*>(tensor.data_ptr());
+    const size_t numel = tensor.numel();
+
+    // Reduce the tensors of this process first.
+    for (size_t i = 1; i < inputs.size(); i++) {
+      const auto input = inputs[i].contiguous();
+      fn(data, data, input.data_ptr(), numel);
+    }
+
+    group->acquire(ticket);
+    std::exception_ptr exception;
+    try {
+      allreduceChunks(scalarType, fn, data, numel, tensor.element_size());
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    group->release();
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+
+    for (auto& input : inputs) {
+      if (!input.is_same(tensor)) {
+        input.copy_(tensor);
+      }
+    }
+  }
+
+ private:
+  void allreduceChunks(
+      const at::ScalarType& scalarType,
+      const gloo::AllreduceOptions::Func& fn,
+      char* data,
+      size_t numel,
+      size_t elementSize) {
+    const size_t localSize = group->localSize;
+    const size_t localRank = group->localRank;
+    const size_t chunkElements = group->slotBytes / elementSize;
+    char* result = group->slot(0);
+    for (size_t offset = 0; offset < numel; offset += chunkElements) {
+      const size_t count = std::min(chunkElements, numel - offset);
+      char* chunk = data + offset * elementSize;
+
+      std::memcpy(group->slot(localRank), chunk, count * elementSize);
+      group->barrier();
+
+      const size_t sliceElements = (count + localSize - 1) / localSize;
+      const size_t begin = std::min(count, localRank * sliceElements);
+      const size_t end = std::min(count, begin + sliceElements);
+      if (begin < end) {
+        char* slice = result + begin * elementSize;
+        for (size_t i = 1; i < localSize; i++) {
+          fn(slice, slice, group->slot(i) + begin * elementSize, end - begin);
+        }
+      }
+      group->barrier();
+
+      if (context) {
+        gloo::AllreduceOptions opts(context);
+        opts.setReduceFunction(fn);
+        opts.setTag(tag);
+        GENERATE_ALL_TYPES(scalarType, setOutputPointer, opts, result, count);
+        gloo::allreduce(opts);
+      }
+      group->barrier();
+
+      std::memcpy(chunk, result, count * elementSize);
+      // Nobody may overwrite slot 0 with the next chunk before everyone has
+      // copied this one out.
+      group->barrier();
+    }
+  }
+};
+
 class AsyncSparseAllreduceWork : public ProcessGroupGloo::AsyncWork {
  public:
   AsyncSparseAllreduceWork(
@@ -1259,7 +1613,10 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   auto tag = nextTag();
   auto context = getContext(tag);
   if (device.type() == at::kCPU) {
-    if (layout == c10::kStrided) {
+    if (layout == c10::kStrided && intraNodeGroup_) {
+      work = std::make_shared<AsyncHierarchicalAllreduceWork>(
+          intraNodeGroup_, inputs, opts.reduceOp, tag);
+    } else if (layout == c10::kStrided) {
       work = std::make_shared<AsyncAllreduceWork>(
           std::move(context), inputs, opts.reduceOp, tag);
     } else if (layout == c10::kSparse) {
@@ -2229,11 +2586,256 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::scatter(
   return work;
 }
 
+namespace {
+
+// Gloo has no reduce_scatter for arbitrary types and reductions, so the
+// inputs of all ranks are flattened into a single buffer, which is
+// allreduced, and each rank copies its own part out of it.
+class AsyncReduceScatterWork : public AsyncAllreduceWork {
+ public:
+  AsyncReduceScatterWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& outputs,
+      std::vector<at::Tensor>& flatInputs,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : AsyncAllreduceWork(context, flatInputs, reduceOp, tag),
+        outputs(outputs) {}
+
+  std::vector<at::Tensor> outputs;
+
+  void run() override {
+    allreduce(inputs);
+    const auto numel = outputs[0].numel();
+    outputs[0].copy_(
+        inputs[0].narrow(0, context->rank * numel, numel).view_as(outputs[0]));
+  }
+};
+
+} // namespace
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce_scatter(
     std::vector<at::Tensor>& outputs,
     std::vector<std::vector<at::Tensor>>& inputs,
     const ReduceScatterOptions& opts) {
-  throw std::runtime_error("ProcessGroupGloo does not support reduce_scatter");
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::reduce_scatter: " + msg);
+  };
+
+  assertSingleElementOutput(invalidArgument, outputs);
+  assertDense(invalidArgument, outputs);
+  assertCPU(invalidArgument, outputs);
+  if (inputs.size() != 1) {
+    invalidArgument(
+        "requires a single-element input list containing a list with " +
+        std::to_string(getSize()) + " tensors");
+  } else if (inputs[0].size() != static_cast<size_t>(getSize())) {
+    invalidArgument(
+        "Incorrect input list size " + std::to_string(inputs[0].size()) +
+        ". Input list size should be " + std::to_string(getSize()) +
+        ", same as size of the process group.");
+  }
+  const auto& options = outputs[0].options();
+  const auto& sizes = outputs[0].sizes();
+  assertTypeAndSizesMatch(invalidArgument, inputs[0], options, sizes);
+
+  // at::cat copies the inputs, which the allreduce must not modify.
+  static const auto flatten = [](const at::Tensor& t) {
+    return t.contiguous().view({-1});
+  };
+  std::vector<at::Tensor> flatInputs = {at::cat(fmap(inputs[0], flatten))};
+  auto tag = nextTag();
+  auto work = std::make_shared<AsyncReduceScatterWork>(
+      getContext(tag), outputs, flatInputs, opts.reduceOp, tag);
+  enqueue(work);
+  return work;
+}
+
+namespace {
+
+class AsyncAlltoallWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncAlltoallWork(
+      const std::shared_ptr<gloo::Context>& context,
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputCounts,
+      std::vector<int64_t>& inputCounts,
+      uint32_t tag)
+      : context(context),
+        outputTensor(outputTensor),
+        inputTensor(inputTensor),
+        outputCounts(outputCounts),
+        inputCounts(inputCounts),
+        tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  at::Tensor outputTensor;
+  at::Tensor inputTensor;
+  std::vector<int64_t> outputCounts;
+  std::vector<int64_t> inputCounts;
+  const uint32_t tag;
+
+  void alltoall(at::Tensor& outputTensor, at::Tensor& inputTensor) {
+    const auto scalarType = outputTensor.scalar_type();
+    if (outputCounts.size() == 0 && inputCounts.size() == 0) {
+      // Equal splits
+      gloo::AlltoallOptions opts(context);
+      opts.setTag(tag);
+      GENERATE_ALL_TYPES(scalarType, setInput, opts, inputTensor);
+      GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputTensor);
+      gloo::alltoall(opts);
+    } else {
+      // Variable splits, gloo::alltoallv() takes the number of elements
+      // exchanged with each rank
+      std::vector<int64_t> sendCounts(context->size);
+      std::vector<int64_t> sendOffsets(context->size);
+      std::vector<int64_t> recvCounts(context->size);
+      std::vector<int64_t> recvOffsets(context->size);
+      computeLengthsAndOffsets(
+          inputCounts, inputTensor, &sendCounts, &sendOffsets);
+      computeLengthsAndOffsets(
+          outputCounts, outputTensor, &recvCounts, &recvOffsets);
+      gloo::AlltoallvOptions opts(context);
+      opts.setTag(tag);
+      GENERATE_ALL_TYPES(scalarType, setInput, opts, inputTensor, sendCounts);
+      GENERATE_ALL_TYPES(
+          scalarType, setOutput, opts, outputTensor, recvCounts);
+      gloo::alltoallv(opts);
+    }
+  }
+
+  void run() override {
+    alltoall(outputTensor, inputTensor);
+  }
+};
+
+#ifdef USE_CUDA
+
+class AsyncAlltoallCUDAWork : public AsyncAlltoallWork {
+ public:
+  AsyncAlltoallCUDAWork(
+      const std::shared_ptr<gloo::Context>& context,
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputCounts,
+      std::vector<int64_t>& inputCounts,
+      uint32_t tag)
+      : AsyncAlltoallWork(
+            context,
+            outputTensor,
+            inputTensor,
+            outputCounts,
+            inputCounts,
+            tag) {
+    std::vector<at::Tensor> inputs = {inputTensor};
+    std::vector<at::Tensor> outputs = {outputTensor};
+    initializeStreamsEvents(inputs, inputStreams, inputEvents);
+    initializeStreamsEvents(outputs, outputStreams, outputEvents);
+
+    // Kick off copy from CUDA tensors to pinned CPU tensors.
+    at::cuda::OptionalCUDAStreamGuard guard;
+    guard.reset_stream(inputStreams.front());
+    cpuInput = pinnedLike(inputTensor).copy_(inputTensor, true);
+
+    guard.reset_stream(outputStreams.front());
+    cpuOutput = pinnedLike(outputTensor);
+  }
+
+  void run() override {
+    // Synchronize with copy operations.
+    at::cuda::OptionalCUDAGuard device_guard;
+    device_guard.set_index(inputTensor.get_device());
+    AT_CUDA_CHECK(cudaStreamSynchronize(inputStreams.front()));
+    device_guard.set_index(outputTensor.get_device());
+    AT_CUDA_CHECK(cudaStreamSynchronize(outputStreams.front()));
+
+    // Run alltoall on host side tensors.
+    alltoall(cpuOutput, cpuInput);
+
+    // Kick off copy back to the CUDA tensors.
+    at::cuda::OptionalCUDAStreamGuard stream_guard;
+    stream_guard.reset_stream(outputStreams.front());
+    outputTensor.copy_(cpuOutput, /* non_blocking */ true);
+    outputEvents.front().record(outputStreams.front());
+  }
+
+  void synchronize() override {
+    // Synchronize with the copy back to CUDA tensors.
+    at::cuda::OptionalCUDAGuard guard;
+    guard.set_index(static_cast<at::DeviceIndex>(outputTensor.get_device()));
+    outputEvents.front().block(at::cuda::getCurrentCUDAStream());
+  }
+
+  at::Tensor cpuOutput;
+  std::vector<at::cuda::CUDAStream> outputStreams;
+  std::vector<at::cuda::CUDAEvent> outputEvents;
+
+  at::Tensor cpuInput;
+  std::vector<at::cuda::CUDAStream> inputStreams;
+  std::vector<at::cuda::CUDAEvent> inputEvents;
+};
+
+#endif
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputCounts,
+    std::vector<int64_t>& inputCounts,
+    const AllToAllOptions& /* unused */) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::alltoall_base: " + msg);
+  };
+
+  TORCH_CHECK(
+      outputTensor.device() == inputTensor.device(),
+      "output tensor and input tensor must be on the same type of device");
+  assertDense(invalidArgument, {outputTensor});
+  assertDense(invalidArgument, {inputTensor});
+  if (!outputTensor.is_contiguous() || !inputTensor.is_contiguous()) {
+    invalidArgument("requires contiguous input and output tensors");
+  }
+  if (outputTensor.scalar_type() != inputTensor.scalar_type()) {
+    invalidArgument("requires input and output tensors of the same type");
+  }
+  if (outputCounts.size() == 0 && inputCounts.size() == 0 &&
+      outputTensor.numel() != inputTensor.numel()) {
+    invalidArgument(
+        "requires input and output tensors with the same number of elements");
+  }
+  checkSplitSizes(inputCounts, inputTensor, size_);
+  checkSplitSizes(outputCounts, outputTensor, size_);
+
+  const auto& device = outputTensor.device();
+  std::shared_ptr<AsyncAlltoallWork> work;
+  auto tag = nextTag();
+  auto context = getContext(tag);
+  if (device.type() == at::kCPU) {
+    work = std::make_shared<AsyncAlltoallWork>(
+        std::move(context),
+        outputTensor,
+        inputTensor,
+        outputCounts,
+        inputCounts,
+        tag);
+#ifdef USE_CUDA
+  } else if (device.type() == at::kCUDA) {
+    work = std::make_shared<AsyncAlltoallCUDAWork>(
+        std::move(context),
+        outputTensor,
+        inputTensor,
+        outputCounts,
+        inputCounts,
+        tag);
+#endif
+  } else {
+    invalidArgument(c10::str("unsupported device type ", device.type()));
+  }
+  enqueue(work);
+  return work;
 }
 
 at::Tensor& checkSingleTensor(std::vector<at::Tensor>& tensors) {
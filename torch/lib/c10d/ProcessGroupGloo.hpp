@@ -35,6 +35,13 @@ namespace c10d {
 // multi-threaded usage of process groups, you can use consider using
 // multiple process group instances.
 //
+// The rank and size of a process group are fixed. Every context connects
+// a full mesh of Gloo pairs through the store when the process group is
+// constructed, and the pairs belong to the transport context of that size,
+// so they can't be carried over to a group with other members. Adding or
+// removing ranks means constructing a new process group, with a new store
+// prefix, on every member.
+//
 // The Gloo algorithms that this class calls into are cached by their
 // signature (see description of AlgorithmKey above). This cache works
 // as follows: every function call instantiates an AlgorithmKey and
@@ -129,8 +136,22 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // Run dense CPU allreduce hierarchically: reduce through shared memory
+    // among the ranks on the same host, allreduce across one leader per
+    // host, and share the result through shared memory again. The topology
+    // is discovered through the store. Only supported on Linux.
+    bool hierarchicalAllreduce;
+
+    // Bytes of shared memory every rank contributes per step of the
+    // hierarchical allreduce. Larger tensors are reduced in chunks.
+    size_t hierarchicalAllreduceSlotBytes;
   };
 
+  // Ranks on the same host that run allreduce through shared memory.
+  // See Note [Hierarchical allreduce].
+  class IntraNodeGroup;
+
   // Helper functions to create a new device object.
   // They are static functions on this class to keep them logically
   // separate from the rest of the code base (e.g. torch/csrc/distributed).
@@ -204,6 +225,13 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputs,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputCounts,
+      std::vector<int64_t>& inputCounts,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> send(
       std::vector<at::Tensor>& tensors,
       int dstRank,
@@ -248,6 +276,15 @@ class ProcessGroupGloo : public ProcessGroup {
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
+  // Discovers which ranks share a host and sets up intraNodeGroup_.
+  void initHierarchicalAllreduce(
+      const std::shared_ptr<Store>& store,
+      const Options& options);
+
+  // Set if Options::hierarchicalAllreduce is set and at least two ranks
+  // share a host.
+  std::shared_ptr<IntraNodeGroup> intraNodeGroup_;
+
   // Queue work to run on worker thread.
   void enqueue(std::shared_ptr<AsyncWork> work);
 
@@ -1,16 +1,27 @@
 #include <c10d/ProcessGroupMPI.hpp>
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <map>
 
 #include <c10/core/DeviceGuard.h>
 
+#ifdef USE_CUDA
+#include <c10/cuda/CUDAStream.h>
+#endif
+
 #if defined(OPEN_MPI) && OPEN_MPI
 #include <mpi-ext.h> // Needed for CUDA-aware check
 #endif
 
 namespace c10d {
 
+static_assert(
+    MPI_VERSION >= 3,
+    "ProcessGroupMPI needs the nonblocking collectives of MPI-3");
+
 #define MPI_CHECK(cmd)                                                   \
   do {                                                                   \
     int mpiStatus = cmd;                                                 \
@@ -42,19 +53,40 @@ std::map<at::ScalarType, MPI_Datatype> mpiDatatype = {
     {at::kShort, MPI_SHORT},
 };
 
-// Checking CUDA-aware MPI support, currently we only support CUDA aware
-// MPI ops through Open MPI
+// How long the worker thread waits for new work before testing the requests
+// in flight again.
+constexpr auto kInFlightPollInterval = std::chrono::microseconds(50);
+
+// Returns 0 or 1 if the environment variable is set to it, and -1 otherwise.
+int readBoolEnv(const char* name) {
+  const char* value = std::getenv(name);
+  if (value == nullptr) {
+    return -1;
+  }
+  if (std::strcmp(value, "0") == 0) {
+    return 0;
+  }
+  if (std::strcmp(value, "1") == 0) {
+    return 1;
+  }
+  return -1;
+}
+
+// Checking CUDA-aware MPI support, see ProcessGroupMPI::isCudaAware.
 bool cudaAwareMpiCheck() {
+  const int forced = readBoolEnv("TORCH_MPI_CUDA_AWARE");
+  if (forced != -1) {
+    return forced == 1;
+  }
 // Run time check
 #if defined(MPIX_CUDA_AWARE_SUPPORT)
   if (MPIX_Query_cuda_support() == 1) {
     return true;
-  } else {
-    return false;
   }
-#else // !defined(MPIX_CUDA_AWARE_SUPPORT)
-  return false;
 #endif // MPIX_CUDA_AWARE_SUPPORT
+  // MVAPICH2 and Cray MPICH are only CUDA-aware when asked to be.
+  return readBoolEnv("MV2_USE_CUDA") == 1 ||
+      readBoolEnv("MPICH_RDMA_ENABLED_CUDA") == 1;
 }
 
 // Checking the input tensor's validity
@@ -65,10 +97,11 @@ void checkSingleTensorHelper(const at::Tensor& tensor) {
   if (tensor.is_sparse()) {
     throw std::runtime_error("input tensor has to be dense");
   }
-  if (tensor.is_cuda() && !cudaAwareMpiCheck()) {
+  if (tensor.is_cuda() && !ProcessGroupMPI::isCudaAware()) {
     throw std::runtime_error(
         "CUDA tensor detected and the MPI used doesn't "
-        "have CUDA-aware MPI support");
+        "have CUDA-aware MPI support (set TORCH_MPI_CUDA_AWARE=1 if it "
+        "does)");
   }
 }
 
@@ -92,72 +125,6 @@ void checkSameSizeAndType(
   }
 }
 
-void checkSplitSizes(
-    const std::vector<int64_t>& split_sizes,
-    const at::Tensor& tensor,
-    int group_size) {
-  if (split_sizes.size() == 0) {
-    TORCH_CHECK(
-        tensor.size(0) % group_size == 0,
-        "Tensor's dim 0 does not divide equally across group size");
-  } else {
-    TORCH_CHECK(
-        split_sizes.size() == group_size,
-        "Number of tensor splits not equal to group size");
-    int sum = std::accumulate(split_sizes.begin(), split_sizes.end(), 0);
-    TORCH_CHECK(
-        sum == tensor.size(0), "Split sizes doesn't match total dim 0 size");
-  }
-}
-
-int64_t computeLengthsAndOffsets(
-    const std::vector<int64_t>& split_sizes,
-    const at::Tensor& tensor,
-    std::vector<int>* lengths,
-    std::vector<int>* offsets) {
-  int64_t group_size = lengths->size();
-  bool equal_splits = false;
-  int64_t dim0_size = tensor.size(0);
-  int64_t row_size = (dim0_size ? tensor.numel() / dim0_size : 1);
-  int64_t split_size = 0;
-  int64_t offset = 0;
-
-  if (split_sizes.size() == 0) {
-    equal_splits = true;
-    split_size = tensor.size(0) / group_size;
-  }
-  for (int i = 0; i < group_size; i++) {
-    int64_t length = row_size * (equal_splits ? split_size : split_sizes[i]);
-    TORCH_INTERNAL_ASSERT(
-        length <= std::numeric_limits<int>::max() &&
-            offset <= std::numeric_limits<int>::max(),
-        "Length or offset larger than INT_MAX not supported");
-    (*lengths)[i] = length;
-    (*offsets)[i] = offset;
-    offset += length;
-  }
-  return offset;
-}
-
-int64_t computeLengthsAndOffsets(
-    const std::vector<at::Tensor>& tensors,
-    std::vector<int>* lengths,
-    std::vector<int>* offsets) {
-  int64_t group_size = lengths->size();
-  int64_t offset = 0;
-  for (int i = 0; i < group_size; i++) {
-    int64_t length = tensors[i].numel();
-    TORCH_INTERNAL_ASSERT(
-        length <= std::numeric_limits<int>::max() &&
-            offset <= std::numeric_limits<int>::max(),
-        "Length or offset larger than INT_MAX not supported");
-    (*lengths)[i] = length;
-    (*offsets)[i] = offset;
-    offset += length;
-  }
-  return offset;
-}
-
 } // namespace
 
 ProcessGroupMPI::AsyncWork::AsyncWork(at::Tensor tensor, MPI_Request request)
@@ -265,6 +232,11 @@ void ProcessGroupMPI::initMPIOnce() {
   });
 }
 
+bool ProcessGroupMPI::isCudaAware() {
+  static const bool cudaAware = cudaAwareMpiCheck();
+  return cudaAware;
+}
+
 std::shared_ptr<ProcessGroupMPI> ProcessGroupMPI::createProcessGroupMPI(
     std::vector<int> ranks) {
   // Once initialization
@@ -345,11 +317,22 @@ void ProcessGroupMPI::abort() {
 }
 
 void ProcessGroupMPI::runLoop() {
+  // The work whose nonblocking MPI call was started, in order.
+  std::deque<WorkType> inFlight;
   std::unique_lock<std::mutex> lock(pgMutex_);
 
-  while (!stop_) {
+  while (!stop_ || !inFlight.empty()) {
     if (queue_.empty()) {
-      queueProduceCV_.wait(lock);
+      if (inFlight.empty()) {
+        queueProduceCV_.wait(lock);
+        continue;
+      }
+      lock.unlock();
+      progressInFlight(inFlight);
+      lock.lock();
+      if (queue_.empty() && !inFlight.empty()) {
+        queueProduceCV_.wait_for(lock, kInFlightPollInterval);
+      }
       continue;
     }
 
@@ -364,18 +347,73 @@ void ProcessGroupMPI::runLoop() {
     queueConsumeCV_.notify_one();
 
     try {
+#ifdef USE_CUDA
+      for (const auto& event : workEntry->events) {
+        event.synchronize();
+      }
+#endif
       workEntry->run(workEntry);
-      work->finish();
+      if (workEntry->request != MPI_REQUEST_NULL) {
+        inFlight.push_back(std::move(workTuple));
+      } else {
+        if (workEntry->complete) {
+          workEntry->complete(workEntry);
+        }
+        work->finish();
+      }
     } catch (...) {
       work->finish(std::current_exception());
     }
 
+    // Collectives started back to back progress together.
+    if (!inFlight.empty()) {
+      progressInFlight(inFlight);
+    }
+
     lock.lock();
   }
 }
 
+void ProcessGroupMPI::progressInFlight(std::deque<WorkType>& inFlight) {
+  for (auto it = inFlight.begin(); it != inFlight.end();) {
+    auto& workEntry = std::get<0>(*it);
+    auto& work = std::get<1>(*it);
+    try {
+      int flag = 0;
+      MPI_Status status;
+      {
+        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        MPI_CHECK(MPI_Test(&workEntry->request, &flag, &status));
+      }
+      if (!flag) {
+        ++it;
+        continue;
+      }
+      if (workEntry->complete) {
+        workEntry->complete(workEntry);
+      }
+      work->finish();
+    } catch (...) {
+      work->finish(std::current_exception());
+    }
+    it = inFlight.erase(it);
+  }
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::enqueue(
     std::unique_ptr<WorkEntry> entry) {
+#ifdef USE_CUDA
+  for (const auto* tensors : {&entry->src, &entry->dst}) {
+    for (const auto& tensor : *tensors) {
+      if (!tensor.is_cuda()) {
+        continue;
+      }
+      at::cuda::CUDAEvent event;
+      event.record(at::cuda::getCurrentCUDAStream(tensor.device().index()));
+      entry->events.push_back(std::move(event));
+    }
+  }
+#endif
   auto work = std::make_shared<WorkMPI>();
   std::unique_lock<std::mutex> lock(pgMutex_);
   queue_.push_back(std::make_tuple(std::move(entry), work));
@@ -393,12 +431,13 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::broadcast(
         auto data = (entry->src)[0];
         c10::DeviceGuard guard(data.device());
         std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Bcast(
+        MPI_CHECK(MPI_Ibcast(
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            pgComm_,
+            &entry->request));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -415,13 +454,14 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allreduce(
         auto data = (entry->src)[0];
         c10::DeviceGuard guard(data.device());
         std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Allreduce(
+        MPI_CHECK(MPI_Iallreduce(
             MPI_IN_PLACE,
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             mpiOp.at(opts.reduceOp),
-            pgComm_));
+            pgComm_,
+            &entry->request));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -449,14 +489,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce(
 
         c10::DeviceGuard guard(data.device());
         std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Reduce(
+        MPI_CHECK(MPI_Ireduce(
             sendbuf,
             recvbuf,
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             mpiOp.at(opts.reduceOp),
             opts.rootRank,
-            pgComm_));
+            pgComm_,
+            &entry->request));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -484,26 +525,32 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allgather(
   std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
       [this](std::unique_ptr<WorkEntry>& entry) {
         auto data = (entry->src)[0];
-        std::vector<at::Tensor>& outputDataVec = entry->dst;
-        auto flatOutputTensor = newLikeFlat(outputDataVec);
+        auto flatOutputTensor = newLikeFlat(entry->dst);
+        entry->buffers.push_back(flatOutputTensor);
 
         c10::DeviceGuard guard(data.device());
         std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Allgather(
+        MPI_CHECK(MPI_Iallgather(
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             flatOutputTensor.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
-            pgComm_));
-
+            pgComm_,
+            &entry->request));
+      };
+  std::function<void(std::unique_ptr<WorkEntry>&)> completeFunc =
+      [](std::unique_ptr<WorkEntry>& entry) {
+        std::vector<at::Tensor>& outputDataVec = entry->dst;
+        const auto& flatOutputTensor = entry->buffers[0];
         for (size_t i = 0; i < outputDataVec.size(); ++i) {
           outputDataVec[i].copy_(flatOutputTensor[i]);
         }
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&inputTensors, &outputTensors[0], std::move(runFunc)));
+  entry->complete = std::move(completeFunc);
   return enqueue(std::move(entry));
 }
 
@@ -548,11 +595,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::gather(
         if (rank_ == opts.rootRank) {
           flatOutputTensor = newLikeFlat(entry->dst);
           recvbuf = flatOutputTensor.data_ptr();
+          entry->buffers.push_back(flatOutputTensor);
         }
 
         c10::DeviceGuard guard(data.device());
         std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Gather(
+        MPI_CHECK(MPI_Igather(
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
@@ -560,20 +608,21 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::gather(
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
-
-        if (rank_ == opts.rootRank) {
-          std::vector<at::Tensor>& outputDataVec = entry->dst;
-          // copy the flattened output tensors to the outputs
-          for (size_t i = 0; i < outputDataVec.size(); ++i) {
-            outputDataVec.at(i).copy_(flatOutputTensor[i]);
-          }
-        }
+            pgComm_,
+            &entry->request));
       };
 
   if (rank_ == opts.rootRank) {
     auto entry = std::unique_ptr<WorkEntry>(
         new WorkEntry(&inputTensors, &outputTensors[0], std::move(runFunc)));
+    entry->complete = [](std::unique_ptr<WorkEntry>& entry) {
+      std::vector<at::Tensor>& outputDataVec = entry->dst;
+      const auto& flatOutputTensor = entry->buffers[0];
+      // copy the flattened output tensors to the outputs
+      for (size_t i = 0; i < outputDataVec.size(); ++i) {
+        outputDataVec.at(i).copy_(flatOutputTensor[i]);
+      }
+    };
     return enqueue(std::move(entry));
   } else {
     auto entry = std::unique_ptr<WorkEntry>(
@@ -617,6 +666,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::scatter(
           std::vector<at::Tensor>& inputDataVec = entry->src;
           flatInputTensor = newLikeFlat(inputDataVec);
           sendbuf = flatInputTensor.data_ptr();
+          entry->buffers.push_back(flatInputTensor);
 
           // copy the input tensors to the flatten large send buffer
           for (size_t i = 0; i < inputDataVec.size(); ++i) {
@@ -626,7 +676,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::scatter(
 
         c10::DeviceGuard guard(data.device());
         std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Scatter(
+        MPI_CHECK(MPI_Iscatter(
             sendbuf,
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
@@ -634,7 +684,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::scatter(
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            pgComm_,
+            &entry->request));
       };
 
   if (rank_ == opts.rootRank) {
@@ -680,14 +731,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
           auto dstdata = (entry->dst)[0];
           c10::DeviceGuard guard(srcdata.device());
           std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-          MPI_CHECK(MPI_Alltoall(
+          MPI_CHECK(MPI_Ialltoall(
               srcdata.data_ptr(),
               srcdata.numel() / size_,
               mpiDatatype.at(srcdata.scalar_type()),
               dstdata.data_ptr(),
               dstdata.numel() / size_,
               mpiDatatype.at(dstdata.scalar_type()),
-              pgComm_));
+              pgComm_,
+              &entry->request));
         };
     std::vector<at::Tensor> inputTensors = {inputTensor};
     std::vector<at::Tensor> outputTensors = {outputTensor};
@@ -867,7 +919,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::barrier(
   std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
       [this](std::unique_ptr<WorkEntry>& entry) {
         std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Barrier(pgComm_));
+        MPI_CHECK(MPI_Ibarrier(pgComm_, &entry->request));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(nullptr, nullptr, std::move(runFunc)));
@@ -12,6 +12,10 @@
 #include <c10d/Types.hpp>
 #include <c10d/Utils.hpp>
 
+#ifdef USE_CUDA
+#include <ATen/cuda/CUDAEvent.h>
+#endif
+
 #include <mpi.h>
 
 namespace c10d {
@@ -44,6 +48,23 @@ struct WorkEntry {
   // src rank returned, for recv only
   int* srcRank = nullptr;
   std::function<void(std::unique_ptr<WorkEntry>&)> run;
+
+  // Set by run to the request of the nonblocking MPI call it started. The
+  // work completes along with the request.
+  MPI_Request request = MPI_REQUEST_NULL;
+  // Intermediate tensors the MPI call reads or writes, kept alive until the
+  // request completes.
+  std::vector<at::Tensor> buffers;
+  // If set, run once the request completed, e.g. to copy the result out of
+  // the intermediate tensors.
+  std::function<void(std::unique_ptr<WorkEntry>&)> complete;
+
+#ifdef USE_CUDA
+  // Recorded on the current streams of the CUDA tensors when the work is
+  // enqueued. The worker thread waits for them, and not for the whole device,
+  // before handing the tensors to MPI.
+  std::vector<at::cuda::CUDAEvent> events;
+#endif
 };
 
 // ProcessGroupMPI implements MPI bindings for c10d.
@@ -68,8 +89,14 @@ struct WorkEntry {
 // Also note that ProcessGroupMPI only supports a single Tensor operation. In
 // other words, the size of the input Tensor vector should always be 1.
 //
-// CUDA tensor can be supported if the MPI used is CUDA-aware MPI, and
-// ProcessGroupMPI will automatically detect this support.
+// The collectives are started in order by the worker thread through the
+// nonblocking MPI calls, so that several of them can be in flight at once,
+// and the worker thread completes their work as their requests complete.
+// Only the all-to-alls going through MPI_Alltoallv block the worker thread.
+//
+// CUDA tensor can be supported if the MPI used is CUDA-aware MPI, see
+// isCudaAware(). The tensors are then passed to MPI as they are, without
+// being staged through host memory.
 class ProcessGroupMPI : public ProcessGroup {
  public:
   class WorkMPI : public ProcessGroup::Work {
@@ -188,11 +215,21 @@ class ProcessGroupMPI : public ProcessGroup {
   static std::shared_ptr<ProcessGroupMPI> createProcessGroupMPI(
       std::vector<int> ranks = {});
 
+  // Whether the MPI used can be given CUDA tensors. This is queried from Open
+  // MPI, and read from the environment variables enabling CUDA support of
+  // MVAPICH2 (MV2_USE_CUDA) and Cray MPICH (MPICH_RDMA_ENABLED_CUDA). It can
+  // be set explicitly with TORCH_MPI_CUDA_AWARE=0 or 1 for other
+  // implementations.
+  static bool isCudaAware();
+
  protected:
   using WorkType =
       std::tuple<std::unique_ptr<WorkEntry>, std::shared_ptr<WorkMPI>>;
   // Worker thread loop
   void runLoop();
+  // Tests the requests of the work in flight, and completes the work of
+  // those that are done.
+  void progressInFlight(std::deque<WorkType>& inFlight);
   // Helper function that is called by the destructor
   void destroy();
 
@@ -129,6 +129,25 @@ std::string getNcclAbortedCommStoreKey(const std::string ncclIdStr) {
   return std::string(kNCCLAbortedCommStoreKey) + ":" + ncclIdStr;
 }
 
+// Parses an environment variable that is either unset, 0 or 1.
+bool parseEnvVarFlag(const char* envVarName) {
+  char* stringValue = getenv(envVarName);
+  if (stringValue == nullptr) {
+    return false;
+  }
+  try {
+    auto val = std::stoi(stringValue);
+    if (val == 1) {
+      return true;
+    } else if (val == 0) {
+      return false;
+    }
+  } catch (const std::exception&) {
+  }
+  throw std::runtime_error(
+      "Invalid value for environment variable: " + std::string(envVarName));
+}
+
 } // namespace
 
 const int64_t ProcessGroupNCCL::kWatchdogThreadSleepMillis = 10000;
@@ -202,6 +221,16 @@ void ProcessGroupNCCL::WorkNCCL::checkAndThrowException() {
   }
 }
 
+bool ProcessGroupNCCL::WorkNCCL::timedOut() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - workStartTime_) > opTimeout_;
+}
+
+void ProcessGroupNCCL::WorkNCCL::setException(std::exception_ptr exception) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  exception_ = exception;
+}
+
 // Waiting on the work's corresponding CUDA events
 void ProcessGroupNCCL::WorkNCCL::synchronize() {
   for (size_t i = 0; i < devices_.size(); ++i) {
@@ -210,13 +239,17 @@ void ProcessGroupNCCL::WorkNCCL::synchronize() {
     cudaEvents_[i].block(currentStream);
   }
 
+  // With async error handling, throw the errors found so far, by us or by the
+  // watchdog thread, without waiting for the operation to complete.
+  if (asyncErrorHandling_ && !blockingWait_) {
+    checkAndThrowException();
+  }
+
   // In case of blocking, wait for the operation to complete.
   if (blockingWait_) {
     // Wait for the operation to complete.
     while (!isCompleted()) {
-      auto currentTimepoint = std::chrono::steady_clock::now();
-      if (std::chrono::duration_cast<std::chrono::milliseconds>(
-              currentTimepoint - workStartTime_) > opTimeout_) {
+      if (timedOut()) {
         // When operation times out due to some errors that are not
         // detected by nccl communicators, ncclCommWatchdog can not check this
         // time out error and thus can not abort ncclComms accordingly.
@@ -260,6 +293,19 @@ bool ProcessGroupNCCL::WorkNCCL::wait() {
   return true;
 }
 
+c10::intrusive_ptr<c10::ivalue::Future> ProcessGroupNCCL::WorkNCCL::
+    getFuture() {
+  auto future = c10::make_intrusive<c10::ivalue::Future>(c10::NoneType::get());
+  try {
+    synchronize();
+  } catch (const std::exception& e) {
+    future->setError(e.what());
+    return future;
+  }
+  future->markCompleted();
+  return future;
+}
+
 void ProcessGroupNCCL::WorkNCCL::abort() {
   TORCH_CHECK(false, "ProcessGroupNCCL::WorkNCCL::abort not implemented.");
 }
@@ -274,28 +320,20 @@ ProcessGroupNCCL::ProcessGroupNCCL(
       ncclCommCounter_(0),
       terminateWatchdog_(false),
       opTimeout_(opTimeout) {
-  char* blockingWait = getenv(NCCL_BLOCKING_WAIT);
-  try {
-    if (blockingWait != nullptr) {
-      auto val = std::stoi(blockingWait);
-      if (val == 1) {
-        // Make wait() and synchronize() a blocking call.
-        blockingWait_ = true;
-      } else if (val != 0) {
-        throw std::runtime_error(
-            "Invalid value for environment variable: " +
-            std::string(NCCL_BLOCKING_WAIT));
-      }
-    }
-  } catch (std::exception& e) {
-    throw std::runtime_error(
-        "Invalid value for environment variable: " +
-        std::string(NCCL_BLOCKING_WAIT));
-  }
+  // Make wait() and synchronize() a blocking call.
+  blockingWait_ = parseEnvVarFlag(NCCL_BLOCKING_WAIT);
+  asyncErrorHandling_ = parseEnvVarFlag(NCCL_ASYNC_ERROR_HANDLING);
 
 #ifdef ENABLE_NCCL_ERROR_CHECKING
   ncclCommWatchdogThread_ =
       std::thread(&ProcessGroupNCCL::ncclCommWatchdog, this);
+#else
+  if (asyncErrorHandling_) {
+    // Without the watchdog thread, nothing would check the works.
+    LOG(WARNING) << NCCL_ASYNC_ERROR_HANDLING
+                 << " requires NCCL error checking, and is ignored";
+    asyncErrorHandling_ = false;
+  }
 #endif
 }
 
@@ -349,7 +387,7 @@ void ProcessGroupNCCL::ncclCommWatchdogInternal() {
         if (checkForNCCLErrors(ncclComms)) {
           LOG(INFO) << "Received NCCL errors for communicators in the cache";
 
-          if (blockingWait_) {
+          if (blockingWait_ || asyncErrorHandling_) {
             LOG(INFO) << "Aborting communicators that received errors";
             // We should not abort the communicators if we are performing a
             // non-blocking wait(). The reason for this is that if we abort the
@@ -377,7 +415,11 @@ void ProcessGroupNCCL::ncclCommWatchdogInternal() {
       }
     }
 
-    if (blockingWait_) {
+    if (asyncErrorHandling_) {
+      checkWorkList(abortedCommIds);
+    }
+
+    if (blockingWait_ || asyncErrorHandling_) {
       // When we abort a communicator on one rank, it is likely that might cause
       // other ranks to hang indefinitely. As a result, whenever we abort a
       // communicator, we write its ID to the store. The watchdog on other ranks
@@ -431,6 +473,43 @@ void ProcessGroupNCCL::ncclCommWatchdogInternal() {
   }
 }
 
+void ProcessGroupNCCL::enqueueWork(const std::shared_ptr<WorkNCCL>& work) {
+  if (!asyncErrorHandling_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(workListMutex_);
+  workList_.push_back(work);
+}
+
+void ProcessGroupNCCL::checkWorkList(
+    std::unordered_set<std::string>& abortedCommIds) {
+  std::lock_guard<std::mutex> lock(workListMutex_);
+  for (auto it = workList_.begin(); it != workList_.end();) {
+    const auto& work = *it;
+    if (work->isCompleted()) {
+      if (!work->exception()) {
+        it = workList_.erase(it);
+        continue;
+      }
+      LOG(INFO) << "Aborting communicators of a failed NCCL operation";
+    } else if (work->timedOut()) {
+      LOG(INFO) << "Aborting communicators of a timed out NCCL operation";
+      work->setException(
+          std::make_exception_ptr(std::runtime_error("Operation timed out!")));
+    } else {
+      ++it;
+      continue;
+    }
+    // See the note on not removing aborted communicators from the cache in
+    // ncclCommWatchdogInternal.
+    for (const auto& ncclComm : work->ncclComms_) {
+      ncclComm->ncclCommAbort();
+      abortedCommIds.emplace(buildNcclUniqueIdStr(ncclComm->getNcclId()));
+    }
+    it = workList_.erase(it);
+  }
+}
+
 std::exception_ptr ProcessGroupNCCL::WorkNCCL::checkForNCCLErrors(
     const std::vector<std::shared_ptr<NCCLComm>>& ncclComms) const {
   return checkForNCCLErrorsInternal(ncclComms);
@@ -596,6 +675,97 @@ void check_gpu_tensors(const std::vector<at::Tensor>& tensors) {
   }
 }
 
+// Check that all `tensors' of a coalesced collective are dense and reside on
+// the same GPU. Unlike the tensors of the other collectives they may have
+// different types and sizes, since each is communicated on its own.
+void check_coalesced_gpu_tensors(const std::vector<at::Tensor>& tensors) {
+  if (tensors.size() == 0) {
+    throw std::runtime_error("Tensor list must be nonempty");
+  }
+
+  const auto& first = tensors.front();
+  for (const auto& t : tensors) {
+    if (!t.is_cuda() || t.is_sparse()) {
+      throw std::runtime_error("Tensors must be CUDA and dense");
+    }
+    if (t.get_device() != first.get_device()) {
+      throw std::runtime_error(
+          "Tensors of a coalesced collective must be on the same GPU device");
+    }
+    if (!t.is_non_overlapping_and_dense()) {
+      throw std::runtime_error("Tensors must be non-overlapping and dense");
+    }
+  }
+}
+
+// Check that `input' and `output' of an all-to-all are contiguous dense CUDA
+// tensors of the same type on the same GPU, so that the split exchanged with
+// each rank is a range of their storage.
+void check_alltoall_gpu_tensors(
+    const at::Tensor& input,
+    const at::Tensor& output) {
+  for (const auto& t : {input, output}) {
+    if (!t.is_cuda() || t.is_sparse()) {
+      throw std::runtime_error("Tensors must be CUDA and dense");
+    }
+    if (!t.is_contiguous()) {
+      throw std::runtime_error("Tensors must be contiguous");
+    }
+  }
+  if (input.get_device() != output.get_device()) {
+    throw std::runtime_error(
+        "Input and output tensors of alltoall must be on the same GPU device");
+  }
+  if (input.scalar_type() != output.scalar_type()) {
+    throw std::runtime_error(
+        "Input and output tensors of alltoall must have identical type");
+  }
+}
+
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+
+// Issues the sends and receives of an all-to-all, where `lengths' and
+// `offsets' are counted in elements of `type'. They must be issued within a
+// NCCL group, otherwise the sends to ranks that haven't posted their
+// receives yet deadlock.
+template <typename T>
+ncclResult_t ncclAlltoallv(
+    void* sendbuff,
+    const std::vector<T>& send_lengths,
+    const std::vector<T>& send_offsets,
+    void* recvbuff,
+    const std::vector<T>& recv_lengths,
+    const std::vector<T>& recv_offsets,
+    size_t element_size,
+    ncclDataType_t type,
+    ncclComm_t comm,
+    cudaStream_t stream) {
+  for (size_t r = 0; r < send_lengths.size(); ++r) {
+    // NCCL synchronizes the peers of a 0 byte message, skip them instead
+    if (send_lengths[r] != 0) {
+      C10D_NCCL_CHECK(ncclSend(
+          static_cast<char*>(sendbuff) + send_offsets[r] * element_size,
+          send_lengths[r],
+          type,
+          r,
+          comm,
+          stream));
+    }
+    if (recv_lengths[r] != 0) {
+      C10D_NCCL_CHECK(ncclRecv(
+          static_cast<char*>(recvbuff) + recv_offsets[r] * element_size,
+          recv_lengths[r],
+          type,
+          r,
+          comm,
+          stream));
+    }
+  }
+  return ncclSuccess;
+}
+
+#endif
+
 // Flatten each list in `tensor_lists' for a gather or scatter operation, and
 // ensure compatibility with the corresponding tensor in `other'.
 std::vector<at::Tensor> flatten_for_scatter_gather(
@@ -700,9 +870,11 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     work->cudaEvents_[i].record(ncclStream);
     work->ncclComms_[i] = ncclComms[i];
     work->blockingWait_ = blockingWait_;
+    work->asyncErrorHandling_ = asyncErrorHandling_;
     work->opTimeout_ = opTimeout_;
     work->store_ = store_;
   }
+  enqueueWork(work);
 
   return work;
 }
@@ -720,6 +892,45 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
       [](std::vector<at::cuda::CUDAStream>&) {});
 }
 
+template <typename Fn>
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::coalescedCollective(
+    std::vector<at::Tensor>& inputs,
+    Fn fn) {
+  const std::vector<at::Device> devices{inputs.front().device()};
+  const auto key = getKeyFromDevices(devices);
+  auto& ncclComms = getNCCLComm(key, devices);
+
+  // First let the NCCL stream wait for input tensors allocation streams
+  syncStreams(devices, ncclEvents_[key], ncclStreams_[key]);
+
+  auto work = initWork(devices);
+
+  at::cuda::OptionalCUDAGuard gpuGuard(devices[0]);
+  at::cuda::CUDAStream& ncclStream = ncclStreams_[key][0];
+
+  // See [Sync Streams].
+  for (const auto& input : inputs) {
+    c10::cuda::CUDACachingAllocator::recordStream(
+        input.storage().data_ptr(), ncclStream);
+  }
+
+  {
+    AutoNcclGroup nccl_group_guard;
+    fn(ncclComms[0]->getNcclComm(), ncclStream);
+  }
+
+  // Event should only be recorded after the ncclGroupEnd()
+  work->cudaEvents_[0].record(ncclStream);
+  work->ncclComms_[0] = ncclComms[0];
+  work->blockingWait_ = blockingWait_;
+  work->asyncErrorHandling_ = asyncErrorHandling_;
+  work->opTimeout_ = opTimeout_;
+  work->store_ = store_;
+  enqueueWork(work);
+
+  return work;
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
     std::vector<at::Tensor>& tensors,
     const AllreduceOptions& opts) {
@@ -746,8 +957,23 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
-  throw std::runtime_error(
-      "allreduce_coalesced is currently not supported with NCCL");
+  check_coalesced_gpu_tensors(tensors);
+
+  // Each tensor is reduced in place, so unlike ProcessGroupGloo there is no
+  // need to flatten them into, and copy them back out of, a single buffer.
+  return coalescedCollective(
+      tensors, [&](ncclComm_t comm, at::cuda::CUDAStream& stream) {
+        for (auto& tensor : tensors) {
+          C10D_NCCL_CHECK(ncclAllReduce(
+              tensor.data_ptr(),
+              tensor.data_ptr(),
+              tensor.numel(),
+              getNcclDataType(tensor.scalar_type()),
+              ncclOp[opts.reduceOp],
+              comm,
+              stream.stream()));
+        }
+      });
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
@@ -842,11 +1068,56 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_coalesced(
-    std::vector<std::vector<at::Tensor>>& /* unused */,
-    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& outputTensorLists,
+    std::vector<at::Tensor>& inputTensors,
     const AllgatherOptions& /* unused */) {
-  throw std::runtime_error(
-      "ProcessGroupNCCL does not support allgather_coalesced");
+  check_coalesced_gpu_tensors(inputTensors);
+  if (outputTensorLists.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "allgather_coalesced requires one output tensor list per rank");
+  }
+  for (const auto& outputTensors : outputTensorLists) {
+    if (outputTensors.size() != inputTensors.size()) {
+      throw std::runtime_error(
+          "Output tensor lists of allgather_coalesced must have as many "
+          "tensors as the input tensor list");
+    }
+    for (size_t i = 0; i < inputTensors.size(); ++i) {
+      const auto& input = inputTensors[i];
+      const auto& output = outputTensors[i];
+      if (output.device() != input.device() ||
+          output.scalar_type() != input.scalar_type() ||
+          output.sizes() != input.sizes() ||
+          output.strides() != input.strides()) {
+        throw std::runtime_error(
+            "Output tensors of allgather_coalesced must have the same device, "
+            "type, size and strides as their input tensors");
+      }
+    }
+  }
+
+  // Each rank broadcasts its inputs straight into the outputs of the others,
+  // so there is no need for the flattened buffers of allgather.
+  return coalescedCollective(
+      inputTensors, [&](ncclComm_t comm, at::cuda::CUDAStream& stream) {
+        for (int root = 0; root < size_; ++root) {
+          for (size_t i = 0; i < inputTensors.size(); ++i) {
+            auto& input = inputTensors[i];
+            auto& output = outputTensorLists[root][i];
+            // See [Sync Streams].
+            c10::cuda::CUDACachingAllocator::recordStream(
+                output.storage().data_ptr(), stream);
+            C10D_NCCL_CHECK(ncclBroadcast(
+                input.data_ptr(),
+                output.data_ptr(),
+                input.numel(),
+                getNcclDataType(input.scalar_type()),
+                root,
+                comm,
+                stream.stream()));
+          }
+        }
+      });
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
@@ -893,6 +1164,137 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
       [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {});
 }
 
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& /* unused */) {
+  check_alltoall_gpu_tensors(inputTensor, outputTensor);
+  if (outputSplitSizes.size() == 0 && inputSplitSizes.size() == 0) {
+    if (outputTensor.numel() != inputTensor.numel()) {
+      throw std::runtime_error(
+          "Input and output tensors of alltoall must have the same number "
+          "of elements");
+    }
+  }
+  checkSplitSizes(inputSplitSizes, inputTensor, size_);
+  checkSplitSizes(outputSplitSizes, outputTensor, size_);
+
+  // Equal splits are a special case of the computed lengths and offsets,
+  // both are exchanged with a single group of sends and receives.
+  std::vector<size_t> sendLengths(size_);
+  std::vector<size_t> sendOffsets(size_);
+  std::vector<size_t> recvLengths(size_);
+  std::vector<size_t> recvOffsets(size_);
+  computeLengthsAndOffsets(
+      inputSplitSizes, inputTensor, &sendLengths, &sendOffsets);
+  computeLengthsAndOffsets(
+      outputSplitSizes, outputTensor, &recvLengths, &recvOffsets);
+
+  std::vector<at::Tensor> inputTensors = {inputTensor};
+  std::vector<at::Tensor> outputTensors = {outputTensor};
+  return collective(
+      inputTensors,
+      outputTensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        // See [Sync Streams].
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data_ptr(), stream);
+        return ncclAlltoallv(
+            input.data_ptr(),
+            sendLengths,
+            sendOffsets,
+            output.data_ptr(),
+            recvLengths,
+            recvOffsets,
+            input.element_size(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      });
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall(
+    std::vector<at::Tensor>& outputTensors,
+    std::vector<at::Tensor>& inputTensors,
+    const AllToAllOptions& /* unused */) {
+  if (inputTensors.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "Number of input tensors are not equal to group size");
+  }
+  if (outputTensors.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "Number of output tensors are not equal to group size");
+  }
+  for (int r = 0; r < size_; ++r) {
+    check_alltoall_gpu_tensors(inputTensors[r], outputTensors[r]);
+    if (inputTensors[r].get_device() != inputTensors[0].get_device()) {
+      throw std::runtime_error(
+          "Tensors of alltoall must be on the same GPU device");
+    }
+  }
+
+  // Each tensor is sent to, or received from, its rank as it is, so unlike
+  // ProcessGroupMPI there is no need to flatten them into a single buffer.
+  return coalescedCollective(
+      inputTensors, [&](ncclComm_t comm, at::cuda::CUDAStream& stream) {
+        for (int r = 0; r < size_; ++r) {
+          auto& input = inputTensors[r];
+          auto& output = outputTensors[r];
+          // See [Sync Streams].
+          c10::cuda::CUDACachingAllocator::recordStream(
+              output.storage().data_ptr(), stream);
+          if (input.numel() != 0) {
+            C10D_NCCL_CHECK(ncclSend(
+                input.data_ptr(),
+                input.numel(),
+                getNcclDataType(input.scalar_type()),
+                r,
+                comm,
+                stream.stream()));
+          }
+          if (output.numel() != 0) {
+            C10D_NCCL_CHECK(ncclRecv(
+                output.data_ptr(),
+                output.numel(),
+                getNcclDataType(output.scalar_type()),
+                r,
+                comm,
+                stream.stream()));
+          }
+        }
+      });
+}
+
+#else
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
+    at::Tensor& /* unused */,
+    at::Tensor& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    const AllToAllOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupNCCL only supports alltoall_base for NCCL lib version "
+      ">= 2.7.0");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const AllToAllOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupNCCL only supports alltoall for NCCL lib version >= 2.7.0");
+}
+
+#endif
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::barrier(
     const BarrierOptions& opts) {
   std::vector<at::Device> devices;
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <list>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <c10d/NCCLUtils.hpp>
 #include <c10d/ProcessGroup.hpp>
@@ -17,6 +19,11 @@ namespace c10d {
 // non-blocking.
 constexpr const char* NCCL_BLOCKING_WAIT = "NCCL_BLOCKING_WAIT";
 
+// Environment variable which controls whether the watchdog thread handles
+// failed and timed out operations without blocking wait(): it aborts their
+// communicators, and wait() throws the error once it has been found.
+constexpr const char* NCCL_ASYNC_ERROR_HANDLING = "NCCL_ASYNC_ERROR_HANDLING";
+
 // ProcessGroupNCCL implements NCCL bindings for c10d.
 //
 // All functions of the class are expected to be called in the same order
@@ -52,6 +59,14 @@ constexpr const char* NCCL_BLOCKING_WAIT = "NCCL_BLOCKING_WAIT";
 //   work->wait()
 //
 //   // Now continue on other work in the current stream.
+//
+// By default, a collective that fails or hangs on some rank hangs the others
+// forever. With NCCL_BLOCKING_WAIT, wait() blocks the host until the work
+// completes, and throws if it fails or times out. With
+// NCCL_ASYNC_ERROR_HANDLING, wait() stays non-blocking: the watchdog thread
+// tracks the outstanding works, aborts the communicators of the ones that
+// failed or timed out, on this and the other ranks, and wait() (or a later
+// collective on the aborted communicators) throws the error.
 class ProcessGroupNCCL : public ProcessGroup {
  public:
   class WorkNCCL : public ProcessGroup::Work {
@@ -77,6 +92,12 @@ class ProcessGroupNCCL : public ProcessGroup {
     // completion.
     void synchronize() override;
 
+    // NCCL work is ordered on the GPU: the future is completed right away,
+    // after the current streams have been made to wait on the NCCL streams.
+    // Operations enqueued on the current streams from its callbacks are
+    // therefore correctly sequenced after the NCCL kernels.
+    c10::intrusive_ptr<c10::ivalue::Future> getFuture() override;
+
     // Helper function that checks if the NCCL kernels have finished
     // execution on the GPUs
     bool finishedGPUExecution();
@@ -97,6 +118,9 @@ class ProcessGroupNCCL : public ProcessGroup {
     // Clone of blockingWait_ from ProcessGroupNCCL.
     bool blockingWait_ = false;
 
+    // Clone of asyncErrorHandling_ from ProcessGroupNCCL.
+    bool asyncErrorHandling_ = false;
+
     // Clone of opTimeout_ from ProcessGroupNCCL.
     std::chrono::milliseconds opTimeout_;
 
@@ -119,6 +143,12 @@ class ProcessGroupNCCL : public ProcessGroup {
     // exception_ptr.
     bool finishedGPUExecutionInternal() const;
 
+    // Checks whether the work has been running for longer than opTimeout_.
+    bool timedOut() const;
+
+    // Sets the exception found by the watchdog thread.
+    void setException(std::exception_ptr exception);
+
     // Reference to the store so that we can write aborted communicators
     // to the store.
     std::shared_ptr<Store> store_;
@@ -198,6 +228,20 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputTensors,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  // The all-to-all collectives are issued as grouped ncclSend() and
+  // ncclRecv() calls, which need NCCL 2.7+, and throw with older versions.
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> alltoall(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> barrier(
       const BarrierOptions& opts = BarrierOptions()) override;
 
@@ -265,6 +309,20 @@ class ProcessGroupNCCL : public ProcessGroup {
       PreProcess pre,
       PostProcess post);
 
+  // Helper for the coalesced collectives, whose tensors all reside on a single
+  // device. `fn' issues the NCCL calls for all of them, which are batched into
+  // a single NCCL group, so that many small collectives pay a single launch
+  // overhead. Its signature is
+  //
+  //    void fn(ncclComm_t, at::cuda::CUDAStream&);
+  //
+  // Like in `collective', only `inputs' are recorded on the ncclStream, and
+  // recording the outputs is left to `fn'.
+  template <typename Fn>
+  std::shared_ptr<ProcessGroup::Work> coalescedCollective(
+      std::vector<at::Tensor>& inputs,
+      Fn fn);
+
   // Checks for NCCL errors on each of the communicators and returns an
   // appropriate exception_ptr (nullptr if no errors).
   static std::exception_ptr checkForNCCLErrorsInternal(
@@ -283,6 +341,15 @@ class ProcessGroupNCCL : public ProcessGroup {
 
   void ncclCommWatchdogInternal();
 
+  // Records a work for the watchdog thread to check, if asyncErrorHandling_
+  // is enabled.
+  void enqueueWork(const std::shared_ptr<WorkNCCL>& work);
+
+  // Checks the outstanding works for errors and timeouts, aborting the
+  // communicators of the failed ones, which are added to abortedCommIds, and
+  // drops the completed ones.
+  void checkWorkList(std::unordered_set<std::string>& abortedCommIds);
+
  protected:
   static const int64_t kWatchdogThreadSleepMillis;
 
@@ -369,7 +436,19 @@ class ProcessGroupNCCL : public ProcessGroup {
   // for the operation to complete.
   bool blockingWait_ = false;
 
-  // Timeout for operations. This is only used when blockingWait_ is enabled.
+  // Whether the watchdog thread aborts the communicators of failed and timed
+  // out works without wait() blocking on them.
+  bool asyncErrorHandling_ = false;
+
+  // The works that the watchdog thread checks when asyncErrorHandling_ is
+  // enabled, until they complete.
+  std::list<std::shared_ptr<WorkNCCL>> workList_;
+
+  // Mutex to guard workList_.
+  std::mutex workListMutex_;
+
+  // Timeout for operations. This is only used when blockingWait_ or
+  // asyncErrorHandling_ is enabled.
   std::chrono::milliseconds opTimeout_;
 
   // Set of communicators that this process group has aborted and their
@@ -1,12 +1,119 @@
 #include <c10d/ProcessGroupRoundRobin.hpp>
 
+#include <atomic>
+
 namespace c10d {
 
+// The striped work is done when the work of all its stripes is, and fails
+// with the first error of a stripe.
+class ProcessGroupRoundRobin::StripedWork : public ProcessGroup::Work {
+ public:
+  StripedWork(
+      std::vector<std::shared_ptr<ProcessGroup::Work>> works,
+      std::vector<at::Tensor> outputs)
+      : works_(std::move(works)), outputs_(std::move(outputs)) {}
+
+  bool isCompleted() override {
+    for (const auto& work : works_) {
+      if (!work->isCompleted()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool isSuccess() const override {
+    for (const auto& work : works_) {
+      if (!work->isSuccess()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::exception_ptr exception() const override {
+    for (const auto& work : works_) {
+      if (auto exception = work->exception()) {
+        return exception;
+      }
+    }
+    return nullptr;
+  }
+
+  std::vector<at::Tensor> result() const override {
+    return outputs_;
+  }
+
+  void synchronize() override {
+    for (const auto& work : works_) {
+      work->synchronize();
+    }
+  }
+
+  bool wait() override {
+    // Wait for all stripes even if one of them fails, they still use the
+    // tensors.
+    std::exception_ptr exception;
+    bool success = true;
+    for (const auto& work : works_) {
+      try {
+        success = work->wait() && success;
+      } catch (...) {
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+    }
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+    return success;
+  }
+
+  void abort() override {
+    for (const auto& work : works_) {
+      work->abort();
+    }
+  }
+
+  c10::intrusive_ptr<c10::ivalue::Future> getFuture() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stripedFuture_) {
+      return stripedFuture_;
+    }
+    stripedFuture_ =
+        c10::make_intrusive<c10::ivalue::Future>(c10::NoneType::get());
+    auto remaining = std::make_shared<std::atomic<size_t>>(works_.size());
+    for (const auto& work : works_) {
+      auto stripeFuture = work->getFuture();
+      stripeFuture->addCallback(
+          [future = stripedFuture_, stripeFuture, remaining]() {
+            if (stripeFuture->hasError()) {
+              future->setErrorIfNeeded(stripeFuture->error()->what());
+            } else if (--*remaining == 0 && !future->completed()) {
+              future->markCompleted();
+            }
+          });
+    }
+    return stripedFuture_;
+  }
+
+ private:
+  const std::vector<std::shared_ptr<ProcessGroup::Work>> works_;
+  const std::vector<at::Tensor> outputs_;
+  c10::intrusive_ptr<c10::ivalue::Future> stripedFuture_;
+};
+
+constexpr size_t ProcessGroupRoundRobin::kDefaultStripeThresholdBytes;
+
 ProcessGroupRoundRobin::ProcessGroupRoundRobin(
     int rank,
     int size,
-    std::vector<std::shared_ptr<ProcessGroup>> processGroups)
-    : ProcessGroup(rank, size), processGroups_(std::move(processGroups)) {
+    std::vector<std::shared_ptr<ProcessGroup>> processGroups,
+    size_t stripeThresholdBytes)
+    : ProcessGroup(rank, size),
+      processGroups_(std::move(processGroups)),
+      stripeThresholdBytes_(stripeThresholdBytes) {
   TORCH_CHECK(processGroups_.size() >= 1);
   for (const auto& processGroup : processGroups_) {
     TORCH_CHECK(processGroup->getRank() == rank_);
@@ -20,12 +127,30 @@ ProcessGroupRoundRobin::~ProcessGroupRoundRobin() {}
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::broadcast(
     std::vector<at::Tensor>& tensors,
     const BroadcastOptions& opts) {
+  auto tensorStripes = stripes(tensors);
+  if (!tensorStripes.empty()) {
+    return runStriped(
+        tensors,
+        std::move(tensorStripes),
+        [&opts](ProcessGroup& processGroup, std::vector<at::Tensor>& stripe) {
+          return processGroup.broadcast(stripe, opts);
+        });
+  }
   return next()->broadcast(tensors, opts);
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allreduce(
     std::vector<at::Tensor>& tensors,
     const AllreduceOptions& opts) {
+  auto tensorStripes = stripes(tensors);
+  if (!tensorStripes.empty()) {
+    return runStriped(
+        tensors,
+        std::move(tensorStripes),
+        [&opts](ProcessGroup& processGroup, std::vector<at::Tensor>& stripe) {
+          return processGroup.allreduce(stripe, opts);
+        });
+  }
   return next()->allreduce(tensors, opts);
 }
 
@@ -38,6 +163,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allreduce_coalesced(
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::reduce(
     std::vector<at::Tensor>& tensors,
     const ReduceOptions& opts) {
+  auto tensorStripes = stripes(tensors);
+  if (!tensorStripes.empty()) {
+    return runStriped(
+        tensors,
+        std::move(tensorStripes),
+        [&opts](ProcessGroup& processGroup, std::vector<at::Tensor>& stripe) {
+          return processGroup.reduce(stripe, opts);
+        });
+  }
   return next()->reduce(tensors, opts);
 }
 
@@ -110,6 +244,38 @@ const std::shared_ptr<ProcessGroup>& ProcessGroupRoundRobin::next() {
   return processGroup;
 }
 
+std::vector<at::Tensor> ProcessGroupRoundRobin::stripes(
+    const std::vector<at::Tensor>& tensors) const {
+  // The stripes are decided from the sizes of the tensors only, so that all
+  // processes split them the same way.
+  if (processGroups_.size() < 2 || tensors.size() != 1) {
+    return {};
+  }
+  const auto& tensor = tensors[0];
+  if (tensor.layout() != at::kStrided || !tensor.is_contiguous() ||
+      tensor.numel() < static_cast<int64_t>(processGroups_.size()) ||
+      tensor.numel() * tensor.element_size() <
+          static_cast<int64_t>(stripeThresholdBytes_)) {
+    return {};
+  }
+  return tensor.view({-1}).chunk(processGroups_.size());
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::runStriped(
+    const std::vector<at::Tensor>& tensors,
+    std::vector<at::Tensor> stripes,
+    const std::function<std::shared_ptr<ProcessGroup::Work>(
+        ProcessGroup&,
+        std::vector<at::Tensor>&)>& fn) {
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works;
+  works.reserve(stripes.size());
+  for (size_t i = 0; i < stripes.size(); ++i) {
+    std::vector<at::Tensor> stripe = {stripes[i]};
+    works.push_back(fn(*processGroups_[i], stripe));
+  }
+  return std::make_shared<StripedWork>(std::move(works), tensors);
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allgather_base(
     at::Tensor& /*unused */,
     at::Tensor& /*unused */,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include <c10d/ProcessGroup.hpp>
@@ -12,16 +13,25 @@ namespace c10d {
 // one of the specified process groups in a round robin fashion. Each process
 // group instance must have the same rank and size.
 //
+// A broadcast, allreduce or reduce of a single dense tensor of at least
+// stripeThresholdBytes is instead split into one stripe per process group,
+// which run on all of them at once, so that process groups using different
+// devices (e.g. Gloo devices bound to different NICs) share the transfer.
+// The returned work completes when the work of all stripes does.
+//
 // All functions of the class are expected to be called in the same order
 // across all processes in the process group. This is the only way that we
 // can guarantee to match up the same calls among all processes.
 //
 class ProcessGroupRoundRobin final : public ProcessGroup {
  public:
+  static constexpr size_t kDefaultStripeThresholdBytes = 4 << 20;
+
   explicit ProcessGroupRoundRobin(
       int rank,
       int size,
-      std::vector<std::shared_ptr<ProcessGroup>> processGroups);
+      std::vector<std::shared_ptr<ProcessGroup>> processGroups,
+      size_t stripeThresholdBytes = kDefaultStripeThresholdBytes);
 
   ~ProcessGroupRoundRobin() override;
 
@@ -90,11 +100,28 @@ class ProcessGroupRoundRobin final : public ProcessGroup {
       const BarrierOptions& opts = BarrierOptions()) override;
 
  private:
+  // The work of a collective striped across the process groups.
+  class StripedWork;
+
   std::vector<std::shared_ptr<ProcessGroup>> processGroups_;
   std::vector<std::shared_ptr<ProcessGroup>>::const_iterator iterator_;
+  const size_t stripeThresholdBytes_;
 
   // Returns the next ProcessGroup to use.
   const std::shared_ptr<ProcessGroup>& next();
+
+  // Returns the stripes of the tensors of a collective, one per process
+  // group, or nothing if they shouldn't be striped.
+  std::vector<at::Tensor> stripes(const std::vector<at::Tensor>& tensors)
+      const;
+
+  // Runs the collective on every stripe with its process group.
+  std::shared_ptr<ProcessGroup::Work> runStriped(
+      const std::vector<at::Tensor>& tensors,
+      std::vector<at::Tensor> stripes,
+      const std::function<std::shared_ptr<ProcessGroup::Work>(
+          ProcessGroup&,
+          std::vector<at::Tensor>&)>& fn);
 };
 
 } // namespace c10d
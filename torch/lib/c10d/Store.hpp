@@ -38,9 +38,33 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Sets several keys at once. Stores that talk to a server override this
+  // to send them in a single request; the default sets them one by one.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  // Gets several keys at once, waiting for all of them like get() does. The
+  // default gets them one by one.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  // Atomically sets key to desiredValue if its current value is
+  // expectedValue, where a key that isn't set compares equal to an empty
+  // value. Returns the value of key after the operation, which is
+  // desiredValue if and only if the swap happened or was not needed.
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
+  static void checkMultiSetArgs(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
   std::chrono::milliseconds timeout_;
 };
 
@@ -94,7 +94,8 @@ class CollectiveTest {
  public:
   static std::vector<CollectiveTest> initialize(
       const std::string& path,
-      int num) {
+      int num,
+      bool hierarchical = false) {
     std::vector<CollectiveTest> tests;
     for (auto i = 0; i < num; i++) {
       tests.push_back(CollectiveTest(path));
@@ -102,8 +103,9 @@ class CollectiveTest {
 
     std::vector<std::thread> threads;
     for (auto i = 0; i < num; i++) {
-      threads.push_back(
-          std::thread([i, &tests] { tests[i].start(i, tests.size()); }));
+      threads.push_back(std::thread([i, hierarchical, &tests] {
+        tests[i].start(i, tests.size(), hierarchical);
+      }));
     }
     for (auto& thread : threads) {
       thread.join();
@@ -123,13 +125,16 @@ class CollectiveTest {
     return *pg_;
   }
 
-  void start(int rank, int size) {
+  void start(int rank, int size, bool hierarchical) {
     auto store = std::make_shared<::c10d::FileStore>(path_, size);
 
     // Set a timeout that is small enough to make this test run fast, but also
     // make sure that we don't get timeouts in the ProcessGroupGloo constructor.
     ::c10d::ProcessGroupGloo::Options options;
     options.timeout = std::chrono::milliseconds(1000);
+    options.hierarchicalAllreduce = hierarchical;
+    // Small enough to split the test tensors into several chunks.
+    options.hierarchicalAllreduceSlotBytes = 256;
     options.devices.push_back(
         ::c10d::ProcessGroupGloo::createDeviceForHostname("127.0.0.1"));
 
@@ -156,9 +161,12 @@ std::vector<std::vector<at::Tensor>> copyTensors(
   return outputs;
 }
 
-void testAllreduce(const std::string& path, const at::DeviceType b) {
+void testAllreduce(
+    const std::string& path,
+    const at::DeviceType b,
+    bool hierarchical = false) {
   const auto size = 4;
-  auto tests = CollectiveTest::initialize(path, size);
+  auto tests = CollectiveTest::initialize(path, size, hierarchical);
 
   // Generate inputs
   std::vector<std::vector<at::Tensor>> inputs(size);
@@ -382,6 +390,13 @@ TEST(ProcessGroupGlooTest, testAllReduceCPU) {
   }
 }
 
+TEST(ProcessGroupGlooTest, testHierarchicalAllReduceCPU) {
+  {
+    TemporaryFile file;
+    testAllreduce(file.path, at::DeviceType::CPU, /* hierarchical */ true);
+  }
+}
+
 TEST(ProcessGroupGlooTest, testBroadcastCPU) {
   {
     TemporaryFile file;
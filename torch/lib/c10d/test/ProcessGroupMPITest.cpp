@@ -58,6 +58,37 @@ void testAllreduce(int iter = 1000) {
   }
 }
 
+// Kicks off different collectives back to back, so that several of them are
+// in flight at once.
+void testMixedCollectives(int iter = 1000) {
+  auto pg = c10d::ProcessGroupMPI::createProcessGroupMPI();
+  std::vector<std::vector<at::Tensor>> allreduceTensors(iter);
+  std::vector<std::vector<at::Tensor>> broadcastTensors(iter);
+  std::vector<std::shared_ptr<::c10d::ProcessGroup::Work>> works;
+  for (auto i = 0; i < iter; ++i) {
+    allreduceTensors[i] = {at::ones({16, 16}) * i};
+    broadcastTensors[i] = {at::ones({16, 16}) * (pg->getRank() == 0 ? i : -1)};
+    works.push_back(pg->allreduce(allreduceTensors[i]));
+    works.push_back(pg->broadcast(broadcastTensors[i]));
+    if (i % 100 == 0) {
+      works.push_back(pg->barrier());
+    }
+  }
+
+  waitWork(pg, works);
+
+  const auto worldSize = pg->getSize();
+  for (int i = 0; i < iter; ++i) {
+    auto allreduceData = allreduceTensors[i][0].data_ptr<float>();
+    auto broadcastData = broadcastTensors[i][0].data_ptr<float>();
+    for (auto j = 0; j < allreduceTensors[i][0].numel(); ++j) {
+      if (allreduceData[j] != worldSize * i || broadcastData[j] != i) {
+        throw std::runtime_error("BOOM!");
+      }
+    }
+  }
+}
+
 void testBroadcast(int iter = 10000) {
   auto pg = c10d::ProcessGroupMPI::createProcessGroupMPI();
   // Generate inputs
@@ -342,6 +373,7 @@ int main(int argc, char** argv) {
 
   testAllreduce();
   testBroadcast();
+  testMixedCollectives();
   testReduce();
   testAllgather();
   testGather();
@@ -1,4 +1,5 @@
 #include <chrono>
+#include <thread>
 
 #include <c10d/FileStore.hpp>
 #include <c10d/ProcessGroupNCCL.hpp>
@@ -152,6 +153,7 @@ class ProcessGroupNCCLErrorsTest : public ::testing::Test {
 
   void TearDown() override {
     ASSERT_TRUE(setenv(c10d::NCCL_BLOCKING_WAIT, "0", 1) == 0);
+    ASSERT_TRUE(setenv(c10d::NCCL_ASYNC_ERROR_HANDLING, "0", 1) == 0);
   }
 
   std::vector<at::Tensor> tensors_;
@@ -246,3 +248,35 @@ TEST_F(ProcessGroupNCCLErrorsTest, testNCCLErrorsNonBlocking) {
 
   // Communicators might be aborted here, further operations would fail.
 }
+
+TEST_F(ProcessGroupNCCLErrorsTest, testNCCLTimedoutErrorsAsync) {
+  bool skip;
+  std::string skipReason;
+  std::tie(skip, skipReason) = skipTest();
+  if (skip) {
+    LOG(INFO) << skipReason;
+    return;
+  }
+
+  ASSERT_TRUE(setenv(c10d::NCCL_ASYNC_ERROR_HANDLING, "1", 1) == 0);
+  ProcessGroupNCCLTimedOutErrors pg(
+      store_, 0, 1, std::chrono::milliseconds(1000));
+
+  auto work = pg.allreduce(tensors_);
+  work->wait();
+  pg.barrier()->wait();
+  EXPECT_TRUE(work->isSuccess());
+  EXPECT_EQ(1, pg.getNCCLCommCacheSize());
+
+  // Now run all reduce with a timed out error, which the watchdog finds once
+  // it wakes up after the timeout.
+  pg.set_timedout_error();
+  work = pg.allreduce(tensors_);
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(1000) + 2 * pg.getWatchdogSleepInterval());
+
+  // wait() is non-blocking, but throws the error found by the watchdog.
+  EXPECT_THROW(work->wait(), std::runtime_error);
+
+  // Communicators are aborted here, further operations would fail.
+}
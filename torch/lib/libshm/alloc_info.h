@@ -2,8 +2,37 @@
 
 #include <unistd.h>
 
+#include <cstddef>
+
+// The kinds of messages the clients send to the manager
+enum AllocKind : char {
+  // A segment was created or opened, the manager replies with an OK and
+  // unlinks the segment when it exits.
+  ALLOC_REGISTER = 0,
+  // A segment was closed.
+  ALLOC_FREE = 1,
+  // Asks for a block of the pool of at least `size` bytes, the manager
+  // replies with an AllocInfo holding the name of the block, which is empty
+  // if the pool can't hand one out.
+  ALLOC_POOL = 2,
+  // The last reference to a block of the pool is gone, the block can be
+  // handed out again.
+  ALLOC_POOL_FREE = 3,
+};
+
 struct AllocInfo {
   pid_t pid;
-  char free;
+  char kind;
+  // The name of a segment, or "<region>@<offset>" for a block of the pool
   char filename[60];
+  size_t size;
 };
+
+// Storages of up to kPoolMaxBlockSize bytes, refcount included, get a block
+// of a pool owned by the manager instead of a segment of their own. The
+// blocks are carved from shared memory regions of kPoolRegionSize bytes, in
+// power of two size classes starting at kPoolMinBlockSize, and are recycled
+// until the manager exits.
+constexpr size_t kPoolRegionSize = 64 << 20;
+constexpr size_t kPoolMinBlockSize = 4096;
+constexpr size_t kPoolMaxBlockSize = 1 << 20;
@@ -1,4 +1,9 @@
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <atomic>
 #include <cstring>
+#include <mutex>
+#include <new>
 #include <string>
 #include <unordered_map>
 
@@ -9,11 +14,14 @@
 
 std::unordered_map<std::string, ClientSocket> managers;
 std::string manager_executable_path;
+// Guards managers and the messages sent through their sockets, as segments
+// are allocated and freed without holding the GIL.
+std::mutex managers_mutex;
 
-AllocInfo get_alloc_info(const char* filename) {
+AllocInfo get_alloc_info(char kind, const char* filename) {
   AllocInfo info = {0};
   info.pid = getpid();
-  info.free = false;
+  info.kind = kind;
   size_t len = strlen(filename);
   if (len >= sizeof(info.filename)) {
     throw std::runtime_error("THMapAllocatorContext_filename too long");
@@ -78,10 +86,47 @@ void libshm_init(const char *manager_exec_path) {
   manager_executable_path = std::string(manager_exec_path);
 }
 
-THManagedMapAllocatorInit::THManagedMapAllocatorInit(const char* manager_handle, const char* filename)
+namespace {
+
+// The bytes before the data of a block of the pool, they hold its refcount
+// like those of the segments of THRefcountedMapAllocator.
+constexpr size_t kBlockHeaderSize = 64;
+
+struct BlockHeader {
+  std::atomic<int> refcount;
+};
+
+// The regions of the pools mapped in this process, by name. They stay mapped
+// until the process exits. Guarded by managers_mutex.
+std::unordered_map<std::string, char*> mapped_regions;
+
+char* map_region(const std::string& name) {
+  auto it = mapped_regions.find(name);
+  if (it != mapped_regions.end()) {
+    return it->second;
+  }
+  int fd;
+  SYSCHECK_ERR_RETURN_NEG1(fd = shm_open(name.c_str(), O_RDWR, 0));
+  void* base = mmap(nullptr, kPoolRegionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int mmap_errno = errno;
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    throw std::system_error(mmap_errno, std::system_category());
+  }
+  mapped_regions.emplace(name, static_cast<char*>(base));
+  return static_cast<char*>(base);
+}
+
+bool is_block_name(const char* filename) {
+  return strchr(filename, '@') != nullptr;
+}
+
+} // namespace
+
+THManagedMapAllocator::THManagedMapAllocator(const char* manager_handle, const char* filename, int flags, ptrdiff_t size)
   : manager_handle_(manager_handle ? manager_handle : "") {
-  // TODO: unlock GIL when contacting the manager
   try {
+    std::lock_guard<std::mutex> lock(managers_mutex);
     ClientSocket *socket;
     if (!manager_handle_.empty()) {
       socket = &get_manager_socket(manager_handle_);
@@ -93,23 +138,84 @@ THManagedMapAllocatorInit::THManagedMapAllocatorInit(const char* manager_handle,
       manager_handle_ = manager->first;
       socket = &manager->second;
     }
-    AllocInfo info = get_alloc_info(filename);
+    const bool create = flags & TH_ALLOCATOR_MAPPED_EXCLUSIVE;
+    std::string block_name;
+    if (create && size + kBlockHeaderSize <= kPoolMaxBlockSize) {
+      AllocInfo info = get_alloc_info(ALLOC_POOL, "");
+      info.size = size + kBlockHeaderSize;
+      // Empty if the pool can't hand out a block
+      block_name = socket->allocate_block(info).filename;
+    } else if (!create && is_block_name(filename)) {
+      block_name = filename;
+    }
+    if (!block_name.empty()) {
+      openBlock(block_name, create);
+      return;
+    }
+    AllocInfo info = get_alloc_info(ALLOC_REGISTER, filename);
     socket->register_allocation(info);
   } catch(std::exception &e) {
     THError(e.what());
   }
+  segment_.reset(new THRefcountedMapAllocator(filename, flags, size));
 }
 
-THManagedMapAllocator::THManagedMapAllocator(const char *manager_handle, const char *filename, int flags, ptrdiff_t size)
-  : THManagedMapAllocatorInit(manager_handle, filename), THRefcountedMapAllocator(filename, flags, size) {}
+// Must be called with managers_mutex held
+void THManagedMapAllocator::openBlock(const std::string& block_name, bool create) {
+  const auto separator = block_name.rfind('@');
+  const size_t offset = std::stoull(block_name.substr(separator + 1));
+  if (offset + kBlockHeaderSize > kPoolRegionSize) {
+    throw std::runtime_error("invalid shared memory block " + block_name);
+  }
+  block_ = map_region(block_name.substr(0, separator)) + offset;
+  auto* header = static_cast<BlockHeader*>(block_);
+  if (create) {
+    new (&header->refcount) std::atomic<int>(1);
+  } else {
+    header->refcount++;
+  }
+  block_name_ = block_name;
+}
 
 void THManagedMapAllocator::close() {
   if (closed_) return;
-  AllocInfo info = get_alloc_info(filename());
-  info.free = true;
-  ClientSocket &socket = get_manager_socket(manager_handle_);
-  THRefcountedMapAllocator::close();
-  socket.register_deallocation(info);
+  closed_ = true;
+  if (segment_) {
+    AllocInfo info = get_alloc_info(ALLOC_FREE, segment_->filename());
+    segment_->close();
+    std::lock_guard<std::mutex> lock(managers_mutex);
+    ClientSocket &socket = get_manager_socket(manager_handle_);
+    socket.register_deallocation(info);
+  } else if (block_ && --static_cast<BlockHeader*>(block_)->refcount == 0) {
+    // No process maps the block anymore, it goes back to the pool
+    AllocInfo info = get_alloc_info(ALLOC_POOL_FREE, block_name_.c_str());
+    std::lock_guard<std::mutex> lock(managers_mutex);
+    ClientSocket &socket = get_manager_socket(manager_handle_);
+    socket.free_block(info);
+  }
+}
+
+const char* THManagedMapAllocator::filename() const {
+  return segment_ ? segment_->filename() : block_name_.c_str();
+}
+
+void* THManagedMapAllocator::data() const {
+  return segment_ ? segment_->data() : static_cast<char*>(block_) + kBlockHeaderSize;
+}
+
+void THManagedMapAllocator::incref() {
+  if (segment_) {
+    segment_->incref();
+  } else {
+    ++static_cast<BlockHeader*>(block_)->refcount;
+  }
+}
+
+int THManagedMapAllocator::decref() {
+  if (segment_) {
+    return segment_->decref();
+  }
+  return --static_cast<BlockHeader*>(block_)->refcount == 0;
 }
 
 static void deleteTHManagedMapAllocator(void* ptr) {
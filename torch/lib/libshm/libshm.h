@@ -4,23 +4,26 @@
 
 #ifdef __cplusplus
 
-void libshm_init(const char *manager_exec_path);
+#include <memory>
+#include <string>
 
-// Superclass to run a constructor before THRefcountedMapAllocator
-class THManagedMapAllocatorInit {
-protected:
-  THManagedMapAllocatorInit(const char* manager_handle, const char* filename);
-  std::string manager_handle_;
-};
+void libshm_init(const char *manager_exec_path);
 
 // Like a THRefcountedMapAllocator, but it also makes use of an external
 // shared memory manager process to ensure that shared memory regions actually
 // get freed in the end (even if processes lose the memory).
-class THManagedMapAllocator : private THManagedMapAllocatorInit, public THRefcountedMapAllocator {
+//
+// Small storages are not given a segment of their own, but a block of a pool
+// of large regions owned by the manager, see alloc_info.h. Their filename is
+// the name of the block, which is recycled once the last process closes it,
+// and the filename given to the constructor is only used for segments.
+class THManagedMapAllocator {
 public:
   THManagedMapAllocator(const char* manager_handle, const char* filename, int flags, ptrdiff_t size);
+  THManagedMapAllocator(const THManagedMapAllocator&) = delete;
+  THManagedMapAllocator& operator=(const THManagedMapAllocator&) = delete;
 
-  void close() override;
+  void close();
 
   ~THManagedMapAllocator() { close(); }
 
@@ -28,6 +31,22 @@ public:
   static THManagedMapAllocator* fromDataPtr(const at::DataPtr&);
 
   const char* manager_handle() const { return manager_handle_.c_str(); }
+  const char* filename() const;
+  void* data() const;
+
+  void incref();
+  int decref();
+
+private:
+  void openBlock(const std::string& block_name, bool create);
+
+  std::string manager_handle_;
+  // The segment of a storage too large for the pool, or null
+  std::unique_ptr<THRefcountedMapAllocator> segment_;
+  // The block of the pool of the other storages
+  std::string block_name_;
+  void* block_ = nullptr;
+  bool closed_ = false;
 };
 
 #endif
@@ -7,6 +7,7 @@
 #include <set>
 #include <algorithm>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 #include <c10/util/tempfile.h>
@@ -81,6 +82,72 @@ void free_used_object(const std::string &name) {
   }
 }
 
+// The regions the blocks of the pool are carved from, see alloc_info.h
+std::vector<std::string> pool_regions;
+// The offset of the free space at the end of the last region
+size_t pool_region_used = kPoolRegionSize;
+// The free blocks of each size class
+std::unordered_map<size_t, std::vector<std::string>> free_blocks;
+// The size classes of the blocks handed out
+std::unordered_map<std::string, size_t> used_blocks;
+
+bool add_pool_region() {
+  std::string name = "/torch_pool_" + std::to_string(getpid()) + "_" +
+      std::to_string(pool_regions.size());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd == -1) {
+    DEBUG("could not create region %s", name.c_str());
+    return false;
+  }
+  bool resized = ftruncate(fd, kPoolRegionSize) == 0;
+  close(fd);
+  if (!resized) {
+    shm_unlink(name.c_str());
+    return false;
+  }
+  DEBUG("created region %s", name.c_str());
+  pool_regions.push_back(std::move(name));
+  pool_region_used = 0;
+  return true;
+}
+
+// Returns the name of a block of at least `size` bytes, or an empty one if
+// the block would be too large or the pool can't grow.
+std::string allocate_block(size_t size) {
+  if (size > kPoolMaxBlockSize) {
+    return "";
+  }
+  size_t block_size = kPoolMinBlockSize;
+  while (block_size < size) {
+    block_size *= 2;
+  }
+  std::string name;
+  auto &blocks = free_blocks[block_size];
+  if (!blocks.empty()) {
+    name = std::move(blocks.back());
+    blocks.pop_back();
+  } else {
+    // The end of a region too small for the block is left unused
+    if (pool_region_used + block_size > kPoolRegionSize && !add_pool_region()) {
+      return "";
+    }
+    name = pool_regions.back() + "@" + std::to_string(pool_region_used);
+    pool_region_used += block_size;
+  }
+  used_blocks.emplace(name, block_size);
+  return name;
+}
+
+void free_block(const std::string &name) {
+  auto it = used_blocks.find(name);
+  if (it == used_blocks.end()) {
+    DEBUG("block %s was not handed out", name.c_str());
+    return;
+  }
+  free_blocks[it->second].push_back(name);
+  used_blocks.erase(it);
+}
+
 int main(int argc, char *argv[]) {
   setsid();  // Daemonize the process
 
@@ -137,9 +204,18 @@ int main(int argc, char *argv[]) {
           auto &session = client_sessions.at(pfd.fd);
           AllocInfo info = session.socket.receive();
           session.pid = info.pid;
-          DEBUG("got alloc info: %d %d %s", (int)info.free, info.pid, info.filename);
-          if (info.free) {
+          DEBUG("got alloc info: %d %d %s", (int)info.kind, info.pid, info.filename);
+          if (info.kind == ALLOC_FREE) {
             free_used_object(info.filename);
+          } else if (info.kind == ALLOC_POOL) {
+            AllocInfo block = info;
+            std::string name = allocate_block(info.size);
+            strncpy(block.filename, name.c_str(), sizeof(block.filename) - 1);
+            block.filename[sizeof(block.filename) - 1] = '\0';
+            DEBUG("allocated block %s", block.filename);
+            session.socket.reply(block);
+          } else if (info.kind == ALLOC_POOL_FREE) {
+            free_block(info.filename);
           } else {
             used_objects.insert(info.filename);
             DEBUG("registered object %s", info.filename);
@@ -162,6 +238,10 @@ int main(int argc, char *argv[]) {
     DEBUG("freeing %s", obj_name.c_str());
     shm_unlink(obj_name.c_str());
   }
+  for (auto &region_name: pool_regions) {
+    DEBUG("freeing %s", region_name.c_str());
+    shm_unlink(region_name.c_str());
+  }
 
   DEBUG("manager done");
   return 0;
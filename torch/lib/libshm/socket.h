@@ -93,6 +93,10 @@ public:
     send("OK", 2);
   }
 
+  void reply(const AllocInfo &info) {
+    send(&info, sizeof(info));
+  }
+
 };
 
 
@@ -151,4 +155,16 @@ public:
     send(&info, sizeof(info));
   }
 
+  AllocInfo allocate_block(AllocInfo &info) {
+    AllocInfo block;
+    send(&info, sizeof(info));
+    recv(&block, sizeof(block));
+    block.filename[sizeof(block.filename) - 1] = '\0';
+    return block;
+  }
+
+  void free_block(AllocInfo &info) {
+    send(&info, sizeof(info));
+  }
+
 };
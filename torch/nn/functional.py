@@ -2367,9 +2367,24 @@ def kl_div(input, target, size_average=None, reduce=None, reduction='mean', log_
     return reduced
 
 
+def _cross_entropy_is_fusable(input, target, weight):
+    # type: (Tensor, Tensor, Optional[Tensor]) -> bool
+    # Whether cross_entropy can call _fused_cross_entropy, which only takes
+    # (N, C) inputs. The fused op isn't exported to ONNX, so it isn't traced.
+    if not torch.jit.is_scripting() and torch._C._get_tracing_state():
+        return False
+    if input.dim() != 2 or target.dim() != 1 or target.dtype != torch.long or input.is_sparse:
+        return False
+    if weight is not None and (weight.dtype != input.dtype or weight.device != input.device):
+        return False
+    if input.is_cuda:
+        return input.dtype in (torch.float, torch.double, torch.half)
+    return input.device.type == 'cpu' and input.dtype in (torch.float, torch.double)
+
+
 def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-100,
-                  reduce=None, reduction='mean'):
-    # type: (Tensor, Tensor, Optional[Tensor], Optional[bool], int, Optional[bool], str) -> Tensor
+                  reduce=None, reduction='mean', label_smoothing=0.0):
+    # type: (Tensor, Tensor, Optional[Tensor], Optional[bool], int, Optional[bool], str, float) -> Tensor
     r"""This criterion combines `log_softmax` and `nll_loss` in a single
     function.
 
@@ -2402,6 +2417,10 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
             elements in the output, ``'sum'``: the output will be summed. Note: :attr:`size_average`
             and :attr:`reduce` are in the process of being deprecated, and in the meantime,
             specifying either of those two args will override :attr:`reduction`. Default: ``'mean'``
+        label_smoothing (float, optional): A float in [0.0, 1.0]. Specifies the amount
+            of smoothing when computing the loss, where 0.0 means no smoothing. The targets
+            become a mixture of the original ground truth and a uniform distribution over
+            the classes. Default: :math:`0.0`
 
     Examples::
 
@@ -2416,10 +2435,42 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
             return handle_torch_function(
                 cross_entropy, tens_ops, input, target, weight=weight,
                 size_average=size_average, ignore_index=ignore_index, reduce=reduce,
-                reduction=reduction)
+                reduction=reduction, label_smoothing=label_smoothing)
     if size_average is not None or reduce is not None:
         reduction = _Reduction.legacy_get_string(size_average, reduce)
-    return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
+    if label_smoothing < 0.0 or label_smoothing > 1.0:
+        raise ValueError("label_smoothing must be between 0.0 and 1.0, but got {}".format(label_smoothing))
+    if _cross_entropy_is_fusable(input, target, weight):
+        return torch._C._nn._fused_cross_entropy(input, target, weight, _Reduction.get_enum(reduction),
+                                                 ignore_index, label_smoothing)[0]
+    log_probs = log_softmax(input, 1)
+    loss = nll_loss(log_probs, target, weight, None, ignore_index, None, reduction)
+    if label_smoothing == 0.0:
+        return loss
+    # The smoothing term is the loss against the (weighted) uniform target
+    # distribution, reduced like the nll_loss above.
+    n_classes = input.size(1)
+    ignore_mask = target == ignore_index
+    if weight is not None:
+        weight_shape = [1] * input.dim()
+        weight_shape[1] = n_classes
+        smooth_loss = -(log_probs * weight.view(weight_shape)).sum(1)
+    else:
+        smooth_loss = -log_probs.sum(1)
+    smooth_loss = smooth_loss.masked_fill(ignore_mask, 0.)
+    if reduction == 'mean':
+        if weight is not None:
+            target_weight = weight.index_select(0, target.masked_fill(ignore_mask, 0).flatten())
+            total_weight = target_weight.masked_fill(ignore_mask.flatten(), 0.).sum()
+        else:
+            total_weight = (~ignore_mask).sum().to(smooth_loss.dtype)
+        # a zero total weight gives a zero loss, as in nll_loss
+        if target.numel() > 0:
+            total_weight = total_weight.masked_fill(total_weight == 0, 1.)
+        smooth_loss = smooth_loss.sum() / total_weight
+    elif reduction == 'sum':
+        smooth_loss = smooth_loss.sum()
+    return (1 - label_smoothing) * loss + label_smoothing / n_classes * smooth_loss
 
 
 def binary_cross_entropy(input, target, weight=None, size_average=None,
@@ -512,6 +512,35 @@ class Module:
         """
         return self._apply(lambda t: t.bfloat16() if t.is_floating_point() else t)
 
+    def to_empty(self: T, *, device: Union[str, device]) -> T:
+        r"""Moves the parameters and buffers to the specified device without
+        copying their values.
+
+        This materializes a module constructed on the ``meta`` device, whose
+        tensors have no data, e.g. once it has been decided where its
+        parameters go. The new tensors are uninitialized; initialize them
+        with ``reset_parameters()`` or :func:`torch.nn.init`, or load them
+        with :meth:`load_state_dict`. To materialize a parameter as a shard
+        instead, replace it with a tensor of the shard's shape created on the
+        target device.
+
+        Arguments:
+            device (:class:`torch.device`): the desired device of the
+                parameters and buffers in this module
+
+        Returns:
+            Module: self
+
+        Example::
+
+            >>> m = nn.Linear(4096, 4096, device='meta')
+            >>> m.weight.is_meta
+            True
+            >>> m.to_empty(device='cuda')
+            >>> m.reset_parameters()
+        """
+        return self._apply(lambda t: torch.empty_like(t, device=device))
+
     @overload
     def to(self: T, device: Optional[Union[int, device]] = ..., dtype: Optional[Union[dtype, str]] = ...,
            non_blocking: bool = ...) -> T:
@@ -1310,8 +1339,14 @@ class Module:
             p.requires_grad_(requires_grad)
         return self
 
-    def zero_grad(self) -> None:
-        r"""Sets gradients of all model parameters to zero."""
+    def zero_grad(self, set_to_none: bool = False) -> None:
+        r"""Sets gradients of all model parameters to zero. See similar function
+        under :class:`torch.optim.Optimizer` for more context.
+
+        Arguments:
+            set_to_none (bool): instead of filling them with zeros, sets the
+                grads to None. See :meth:`torch.optim.Optimizer.zero_grad`.
+        """
         if getattr(self, '_is_replica', False):
             warnings.warn(
                 "Calling .zero_grad() from a module created with nn.DataParallel() has no effect. "
@@ -1321,8 +1356,14 @@ class Module:
 
         for p in self.parameters():
             if p.grad is not None:
-                p.grad.detach_()
-                p.grad.zero_()
+                if set_to_none:
+                    p.grad = None
+                else:
+                    if p.grad.grad_fn is not None:
+                        p.grad.detach_()
+                    else:
+                        p.grad.requires_grad_(False)
+                    p.grad.zero_()
 
     def share_memory(self: T) -> T:
         return self._apply(lambda t: t.share_memory_())
@@ -248,6 +248,17 @@ class DistributedDataParallel(Module):
                          are getting different gradients, which should not
                          happen if DistributedDataParallel is correctly used.
                          (default: ``False``)
+        gradient_as_bucket_view (bool): When set to ``True``, gradients will be
+                         views pointing to different offsets of the allreduce
+                         communication buckets. Autograd then accumulates
+                         directly into the buckets, which saves the copies in
+                         and out of them and the memory of a second copy of all
+                         gradients. ``param.grad`` must then not be replaced by
+                         or ``detach_()``-ed into another tensor, or the
+                         savings are lost (results stay correct). Note that
+                         the gradients are views after the first backward pass,
+                         so the peak memory saving only appears from the
+                         second iteration on. (default: ``False``)
 
     Attributes:
         module (Module): the module to be parallelized
@@ -262,7 +273,8 @@ class DistributedDataParallel(Module):
                  process_group=None,
                  bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 gradient_as_bucket_view=False):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -309,6 +321,7 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.gradient_as_bucket_view = gradient_as_bucket_view
         self.require_backward_grad_sync = True
         self.require_forward_param_sync = True
 
@@ -443,7 +456,8 @@ class DistributedDataParallel(Module):
             self.process_group,
             expect_sparse_gradient,
             self.bucket_bytes_cap,
-            self.find_unused_parameters)
+            self.find_unused_parameters,
+            self.gradient_as_bucket_view)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -461,6 +475,7 @@ class DistributedDataParallel(Module):
         super(DistributedDataParallel, self).__setstate__(state)
         self.__dict__.setdefault('require_forward_param_sync', True)
         self.__dict__.setdefault('require_backward_grad_sync', True)
+        self.__dict__.setdefault('gradient_as_bucket_view', False)
         self._ddp_init_helper()
 
     def _check_default_group(self):
@@ -545,6 +560,60 @@ class DistributedDataParallel(Module):
         for module in self._module_copies[1:]:
             module.train(mode)
 
+    def register_comm_hook(self, state, hook):
+        r"""
+        Registers a communication hook, which replaces the allreduce DDP runs
+        for every gradient bucket. This can be used to compress gradients
+        (see ``torch.distributed.algorithms.ddp_comm_hooks``) or to implement
+        other gradient synchronization schemes.
+
+        Arguments:
+            state (object): Passed to the hook on every call, e.g. a process
+                group or the state of a compression algorithm that has to be
+                kept across iterations.
+            hook (callable): Called as ``hook(state, bucket)``, where
+                ``bucket`` is a ``dist._GradBucket`` whose ``get_tensors()``
+                holds the flattened gradients (one tensor per replica), already
+                divided by the world size. It must return a
+                ``torch.futures.Future`` whose value is a list of tensors of the
+                same shapes; DDP waits on it before writing the result back to
+                the parameters' ``.grad``.
+
+        .. warning ::
+            The hook can only be registered once, before the first backward
+            pass, and it must run the same collectives on every process.
+
+        .. warning ::
+            Sparse gradients are always allreduced without the hook.
+
+        Example::
+            >>> def noop(state: object, bucket: dist._GradBucket) -> torch.futures.Future:
+            >>>     fut = torch.futures.Future()
+            >>>     fut.set_result(bucket.get_tensors())
+            >>>     return fut
+
+            >>> ddp.register_comm_hook(state=None, hook=noop)
+        """
+        self._check_comm_hook(hook)
+        dist._register_comm_hook(self.reducer, state, hook)
+
+    def _register_builtin_comm_hook(self, comm_hook_type):
+        r"""
+        Registers one of the communication hooks that are implemented in C++
+        (``dist.BuiltinCommHookType``). These communicate over
+        ``self.process_group`` and never take the GIL.
+
+        Example::
+            >>> ddp._register_builtin_comm_hook(dist.BuiltinCommHookType.FP16_COMPRESS)
+        """
+        dist._register_builtin_comm_hook(
+            self.reducer, self.process_group, comm_hook_type
+        )
+
+    def _check_comm_hook(self, hook):
+        if not callable(hook):
+            raise TypeError("Communication hook must be callable.")
+
     def _distributed_broadcast_coalesced(self, tensors, buffer_size):
         dist._broadcast_coalesced(self.process_group, tensors, buffer_size)
 
@@ -573,7 +642,10 @@ class DistributedDataParallel(Module):
                         # to zero the grads on all model replicas as well.
                         # This snippet is copied from torch.optim.Optimizer.
                         if param.grad is not None:
-                            param.grad.detach_()
+                            if param.grad.grad_fn is not None:
+                                param.grad.detach_()
+                            else:
+                                param.grad.requires_grad_(False)
                             param.grad.zero_()
 
             # module buffer sync
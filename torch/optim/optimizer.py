@@ -163,13 +163,28 @@ class Optimizer(object):
             update_group(g, ng) for g, ng in zip(groups, saved_groups)]
         self.__setstate__({'state': state, 'param_groups': param_groups})
 
-    def zero_grad(self):
-        r"""Clears the gradients of all optimized :class:`torch.Tensor` s."""
+    def zero_grad(self, set_to_none: bool = False):
+        r"""Clears the gradients of all optimized :class:`torch.Tensor` s.
+
+        Arguments:
+            set_to_none (bool): instead of filling them with zeros, sets the
+                grads to None, which saves a pass over them. The next
+                ``backward()`` creates them again, or copies into the grads
+                preallocated by :func:`torch.autograd.preallocate_grad`.
+                Optimizers skip the parameters whose grads are None, so
+                the ones without gradients are not updated.
+        """
         for group in self.param_groups:
             for p in group['params']:
                 if p.grad is not None:
-                    p.grad.detach_()
-                    p.grad.zero_()
+                    if set_to_none:
+                        p.grad = None
+                    else:
+                        if p.grad.grad_fn is not None:
+                            p.grad.detach_()
+                        else:
+                            p.grad.requires_grad_(False)
+                        p.grad.zero_()
 
     def step(self, closure):
         r"""Performs a single optimization step (parameter update).
@@ -1,13 +1,16 @@
+import copy
 import difflib
 import os
 import io
 import shutil
 import struct
 import sys
+import threading
 import torch
 import tarfile
 import tempfile
 import warnings
+from concurrent.futures import ThreadPoolExecutor
 from contextlib import closing, contextmanager
 from ._utils import _import_dotted_name
 from ._six import string_classes as _string_classes
@@ -374,6 +377,109 @@ def save(obj, f: Union[str, os.PathLike, BinaryIO],
         _legacy_save(obj, opened_file, pickle_module, pickle_protocol)
 
 
+_async_save_executor = None
+_async_save_executor_lock = threading.Lock()
+
+
+def _snapshot(obj, storages, locations, cuda_devices):
+    """Returns a copy of ``obj`` in which the tensors nested in dicts, lists
+    and tuples are replaced by copies in host memory, pinned for CUDA tensors.
+    Storage sharing is preserved through ``storages``; ``locations`` maps the
+    copied storages to the location of the originals."""
+    if isinstance(obj, torch.Tensor):
+        if obj.layout != torch.strided or obj.is_quantized:
+            return obj.detach().clone()
+        storage = obj.storage()
+        if storage._cdata not in storages:
+            whole = obj.detach().new_empty(0).set_(storage)
+            if whole.is_cuda:
+                host = torch.empty(whole.shape, dtype=whole.dtype, pin_memory=True)
+                host.copy_(whole, non_blocking=True)
+                cuda_devices.add(whole.device)
+            else:
+                host = whole.clone()
+            locations[host.storage()._cdata] = location_tag(storage)
+            storages[storage._cdata] = host.storage()
+        snapshot = torch.empty(0, dtype=obj.dtype).set_(
+            storages[storage._cdata], obj.storage_offset(), obj.size(), obj.stride())
+        if isinstance(obj, torch.nn.Parameter):
+            return torch.nn.Parameter(snapshot, obj.requires_grad)
+        return snapshot.requires_grad_(obj.requires_grad)
+    if isinstance(obj, dict):
+        # A shallow copy keeps the type and attributes, e.g. the _metadata of
+        # state dicts.
+        result = copy.copy(obj)
+        for k, v in obj.items():
+            result[k] = _snapshot(v, storages, locations, cuda_devices)
+        return result
+    if isinstance(obj, (list, tuple)):
+        values = [_snapshot(v, storages, locations, cuda_devices) for v in obj]
+        if isinstance(obj, list):
+            return values
+        if hasattr(obj, '_fields'):
+            return type(obj)(*values)
+        return tuple(values)
+    return obj
+
+
+def async_save(obj, f: Union[str, os.PathLike, BinaryIO],
+               pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
+    """Saves an object to a disk file like :func:`torch.save`, but writes it
+    in the background.
+
+    The tensors nested in dicts, lists and tuples of ``obj``, e.g. those of
+    ``state_dict()``\ s, are first copied to host memory (pinned memory for
+    CUDA tensors), so they can be modified again as soon as this function
+    returns. The copies are then written to ``f`` from a background thread,
+    which doesn't hold the GIL while it checksums and writes them. Saves run
+    in the order they were started.
+
+    The file has the same format, including the devices of the tensors, as
+    one written by :func:`torch.save`.
+
+    Args:
+        obj: saved object. Its objects other than the nested tensors,
+           dicts, lists and tuples are pickled from the background thread,
+           and must not be modified until the save is done.
+        f: a file-like object (has to implement write and flush) or a string or
+           os.PathLike object containing a file name
+        pickle_module: module used for pickling metadata and objects
+        pickle_protocol: can be specified to override the default protocol
+
+    Returns:
+        A :class:`concurrent.futures.Future` that is done once the file is
+        written, and raises the error of the save if there was one.
+
+    .. note::
+        Until the save is done, the snapshot takes as much host memory as the
+        tensors of ``obj``.
+
+    Example:
+        >>> future = torch.serialization.async_save(model.state_dict(), 'checkpoint.pt')
+        >>> # ...continue training...
+        >>> future.result()
+    """
+    global _async_save_executor
+    _check_dill_version(pickle_module)
+
+    locations: Dict[int, str] = {}
+    cuda_devices: set = set()
+    snapshot = _snapshot(obj, {}, locations, cuda_devices)
+    for device in cuda_devices:
+        torch.cuda.current_stream(device).synchronize()
+
+    def save_snapshot():
+        with _open_file_like(f, 'wb') as opened_file:
+            with _open_zipfile_writer(opened_file) as opened_zipfile:
+                _save(snapshot, opened_zipfile, pickle_module, pickle_protocol,
+                      storage_locations=locations)
+
+    with _async_save_executor_lock:
+        if _async_save_executor is None:
+            _async_save_executor = ThreadPoolExecutor(max_workers=1)
+        return _async_save_executor.submit(save_snapshot)
+
+
 def _legacy_save(obj, f, pickle_module, pickle_protocol) -> None:
     import torch.nn as nn
     serialized_container_types = {}
@@ -407,7 +513,12 @@ def _legacy_save(obj, f, pickle_module, pickle_protocol) -> None:
             # with the old serialization format (which supported storage views)
             offset = 0
             obj_key = str(obj._cdata)
-            location = location_tag(obj)
+            # Snapshots of async_save are saved with the location of the
+            # original storage.
+            if storage_locations is not None and obj._cdata in storage_locations:
+                location = storage_locations[obj._cdata]
+            else:
+                location = location_tag(obj)
             serialized_storages[obj_key] = obj
             is_view = obj._cdata != obj._cdata
             if is_view:
@@ -447,7 +558,7 @@ def _legacy_save(obj, f, pickle_module, pickle_protocol) -> None:
         serialized_storages[key]._write_file(f, _should_read_directly(f), True)
 
 
-def _save(obj, zip_file, pickle_module, pickle_protocol):
+def _save(obj, zip_file, pickle_module, pickle_protocol, storage_locations=None):
     serialized_storages = {}
 
     def persistent_id(obj):
@@ -560,7 +560,39 @@ class Tensor(torch._C._TensorBase):
         data_ptr = self.data_ptr() if self.numel() > 0 else 0
         data = (data_ptr, False)  # read-only is false
 
-        return dict(typestr=typestr, shape=shape, strides=strides, data=data, version=2)
+        # The consumer synchronizes with the stream the data is produced on.
+        # __cuda_array_interface__ v3 disallows 0, the legacy default stream
+        # is 1.
+        stream = torch.cuda.current_stream(self.device).cuda_stream
+        stream = 1 if stream == 0 else stream
+
+        return dict(typestr=typestr, shape=shape, strides=strides, data=data,
+                    stream=stream, version=3)
+
+    def __dlpack__(self, stream=None):
+        """Exports the tensor as a DLPack capsule, see the DLPack protocol and
+        :func:`torch.utils.dlpack.from_dlpack`.
+
+        Arguments:
+            stream (int, optional): the raw handle of the CUDA stream the
+                consumer will use the tensor on. For CUDA tensors, that stream
+                is made to wait for the work queued so far on the current
+                stream, through an event rather than a device synchronization.
+                1 stands for the legacy default stream and 2 for the
+                per-thread default stream. Default: ``None``, no
+                synchronization.
+        """
+        if stream is not None and self.is_cuda:
+            torch.cuda._stream_wait_raw(stream, None, self.device)
+        return torch._C._to_dlpack(self)
+
+    def __dlpack_device__(self):
+        """Returns the ``(device_type, device_id)`` of the tensor in the DLPack
+        protocol."""
+        # kDLCPU and kDLGPU of DLDeviceType.
+        if self.is_cuda:
+            return (2, self.device.index)
+        return (1, 0)
 
     def refine_names(self, *names):
         r"""Refines the dimension names of :attr:`self` according to :attr:`names`.
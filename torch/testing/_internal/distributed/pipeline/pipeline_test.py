@@ -0,0 +1,168 @@
+#!/usr/bin/python3
+import functools
+
+import torch
+import torch.distributed.rpc as rpc
+import torch.testing._internal.dist_utils as dist_utils
+from torch import nn
+from torch.distributed.pipeline import Pipeline
+from torch.testing._internal.distributed.rpc.rpc_agent_test_fixture import (
+    RpcAgentTestFixture,
+)
+
+
+def _create_stage(seed, in_features, out_features):
+    torch.manual_seed(seed)
+    return nn.Sequential(nn.Linear(in_features, out_features), nn.Tanh())
+
+
+def _get_parameters(module_rref):
+    return [p.detach().clone() for p in module_rref.local_value().parameters()]
+
+
+def _get_grads(module_rref):
+    return [p.grad.clone() for p in module_rref.local_value().parameters()]
+
+
+class _FailingModule(nn.Module):
+    def forward(self, x):
+        raise ValueError("Expected failure")
+
+
+class PipelineTest(RpcAgentTestFixture):
+    @property
+    def world_size(self):  # Override setting in RpcAgentTestFixture
+        return 3
+
+    _SIZES = [(4, 8), (8, 3)]
+
+    def _create_stages(self):
+        return [
+            rpc.remote(
+                dist_utils.worker_name(i + 1),
+                _create_stage,
+                args=(i,) + sizes,
+            )
+            for i, sizes in enumerate(self._SIZES)
+        ]
+
+    def _create_local_model(self):
+        return nn.Sequential(
+            *[_create_stage(i, *sizes) for i, sizes in enumerate(self._SIZES)]
+        )
+
+    def _remote_values(self, func, stages):
+        values = []
+        for stage in stages:
+            values += rpc.rpc_sync(stage.owner(), func, args=(stage,))
+        return values
+
+    def _test_forward_backward(self, schedule, checkpoint, chunks):
+        stages = self._create_stages()
+        pipe = Pipeline(
+            stages,
+            nn.MSELoss(),
+            chunks=chunks,
+            schedule=schedule,
+            checkpoint=checkpoint,
+        )
+        model = self._create_local_model()
+        input = torch.randn(10, 4)
+        target = torch.randn(10, 3)
+
+        loss = pipe.forward_backward(input, target)
+        expected_loss = nn.MSELoss()(model(input), target)
+        expected_loss.backward()
+
+        self.assertAlmostEqual(loss, expected_loss.item(), places=5)
+        grads = self._remote_values(_get_grads, stages)
+        expected_grads = [p.grad for p in model.parameters()]
+        self.assertEqual(len(grads), len(expected_grads))
+        for grad, expected_grad in zip(grads, expected_grads):
+            self.assertEqual(grad, expected_grad)
+
+    @dist_utils.dist_init
+    def test_forward_backward_1f1b(self):
+        if self.rank != 0:
+            return
+        for checkpoint in ["never", "except_last", "always"]:
+            for chunks in [1, 3, 10]:
+                self._test_forward_backward("1f1b", checkpoint, chunks)
+
+    @dist_utils.dist_init
+    def test_forward_backward_gpipe(self):
+        if self.rank != 0:
+            return
+        for checkpoint in ["never", "except_last", "always"]:
+            for chunks in [1, 3, 10]:
+                self._test_forward_backward("gpipe", checkpoint, chunks)
+
+    @dist_utils.dist_init
+    def test_step(self):
+        if self.rank != 0:
+            return
+        stages = self._create_stages()
+        pipe = Pipeline(
+            stages,
+            nn.MSELoss(),
+            chunks=2,
+            optimizer=functools.partial(torch.optim.SGD, lr=0.1),
+        )
+        model = self._create_local_model()
+        optimizer = torch.optim.SGD(model.parameters(), lr=0.1)
+        for _ in range(3):
+            input = torch.randn(6, 4)
+            target = torch.randn(6, 3)
+            pipe.zero_grad()
+            pipe.forward_backward(input, target)
+            pipe.step()
+            optimizer.zero_grad()
+            nn.MSELoss()(model(input), target).backward()
+            optimizer.step()
+
+        parameters = self._remote_values(_get_parameters, stages)
+        for parameter, expected in zip(parameters, model.parameters()):
+            self.assertEqual(parameter, expected.detach())
+
+    @dist_utils.dist_init
+    def test_forward(self):
+        if self.rank != 0:
+            return
+        pipe = Pipeline(self._create_stages(), nn.MSELoss(), chunks=3)
+        model = self._create_local_model()
+        input = torch.randn(7, 4)
+        output = pipe.forward(input)
+        self.assertFalse(output.requires_grad)
+        self.assertEqual(output, model(input).detach())
+
+    @dist_utils.dist_init
+    def test_stage_failure(self):
+        if self.rank != 0:
+            return
+        stages = self._create_stages()
+        stages.insert(
+            1, rpc.remote(dist_utils.worker_name(2), _FailingModule)
+        )
+        pipe = Pipeline(stages, nn.MSELoss(), chunks=2)
+        with self.assertRaisesRegex(Exception, "Expected failure"):
+            pipe.forward_backward(torch.randn(4, 4), torch.randn(4, 3))
+
+    @dist_utils.dist_init
+    def test_invalid_arguments(self):
+        if self.rank != 0:
+            return
+        stages = self._create_stages()
+        with self.assertRaisesRegex(ValueError, "at least one stage"):
+            Pipeline([], nn.MSELoss(), chunks=2)
+        with self.assertRaisesRegex(ValueError, "chunks must be positive"):
+            Pipeline(stages, nn.MSELoss(), chunks=0)
+        with self.assertRaisesRegex(ValueError, "schedule must be one of"):
+            Pipeline(stages, nn.MSELoss(), chunks=2, schedule="interleaved")
+        with self.assertRaisesRegex(ValueError, "checkpoint must be one of"):
+            Pipeline(stages, nn.MSELoss(), chunks=2, checkpoint="sometimes")
+
+        pipe = Pipeline(stages, nn.MSELoss(), chunks=2)
+        with self.assertRaisesRegex(RuntimeError, "without an optimizer"):
+            pipe.step()
+        with self.assertRaisesRegex(ValueError, "batch sizes"):
+            pipe.forward_backward(torch.randn(4, 4), torch.randn(1, 3))
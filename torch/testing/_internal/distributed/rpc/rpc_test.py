@@ -857,6 +857,20 @@ class RpcTest(RpcAgentTestFixture):
             )
             self.assertEqual(ret, torch.ones(n, n) * 2)
 
+    @dist_init
+    def test_many_rpc_async(self):
+        # Many small messages to the same destination, with a few large ones
+        # in between, which the ProcessGroupAgent doesn't coalesce.
+        dst_rank = (self.rank + 1) % self.world_size
+        futs = []
+        for i in range(200):
+            n = 200 if i % 50 == 0 else 2
+            futs.append(rpc.rpc_async(
+                worker_name(dst_rank), torch.add, args=(torch.ones(n, n), i)))
+        for i, fut in enumerate(futs):
+            n = 200 if i % 50 == 0 else 2
+            self.assertEqual(fut.wait(), torch.ones(n, n) + i)
+
     def _run_uneven_workload(self, num_repeat=30):
         # worker0 drives and waits for worker1 and worker2
         # throughout the test.
@@ -2358,6 +2372,30 @@ class RpcTest(RpcAgentTestFixture):
         info = rpc.api._get_current_rpc_agent().get_debug_info()
         self.assertIn("agent.gil_average_wait_time_us", info)
 
+    @dist_init
+    @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
+    @_skip_if_tensorpipe_agent
+    def test_process_group_latency_histograms(self):
+        dst_rank = (self.rank + 1) % self.world_size
+        for _ in range(10):
+            rpc.rpc_sync(
+                worker_name(dst_rank), torch.add, args=(torch.ones(1), torch.ones(1))
+            )
+        info = rpc.api._get_current_rpc_agent().get_debug_info()
+        for stage in ["queue", "serialize", "round_trip"]:
+            key = "agent.latency_us.{}.{}".format(stage, dst_rank)
+            self.assertIn(key, info)
+            summary = dict(item.split("=") for item in info[key].split())
+            self.assertGreaterEqual(int(summary["count"]), 10)
+            self.assertLessEqual(int(summary["p50"]), int(summary["max"]))
+
+        # The execution of a request is recorded before its response is sent.
+        rpc.rpc_sync(
+            worker_name(self.rank), torch.add, args=(torch.ones(1), torch.ones(1))
+        )
+        info = rpc.api._get_current_rpc_agent().get_debug_info()
+        self.assertIn("agent.latency_us.execute.0", info)
+
     @dist_init
     @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
     @_skip_if_tensorpipe_agent
@@ -3759,6 +3797,43 @@ class TensorPipeAgentRpcTest(TensorPipeRpcAgentTestFixture, RpcTest):
         self.assertEqual(default_timeout, timeout)
         rpc.shutdown()
 
+    @dist_init(setup_rpc=False)
+    def test_tensorpipe_large_message_pipes(self):
+        # Messages of at least 1000 bytes go round robin over two pipes of
+        # their own, while the small ones keep a pipe for themselves.
+        rpc_backend_options = rpc.TensorPipeRpcBackendOptions(
+            init_method=self.rpc_backend_options.init_method,
+            num_worker_threads=self.rpc_backend_options.num_worker_threads,
+            _num_large_message_pipes=2,
+            _large_message_threshold=1000,
+        )
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=rpc_backend_options,
+        )
+
+        dst = worker_name((self.rank + 1) % self.world_size)
+        futs = []
+        for i in range(10):
+            small = torch.ones(2, 2) * i
+            large = torch.ones(100, 100) * i
+            futs.append((small, rpc.rpc_async(dst, torch.add, args=(small, 1))))
+            futs.append((large, rpc.rpc_async(dst, torch.add, args=(large, 1))))
+        for t, fut in futs:
+            self.assertEqual(fut.wait(), t + 1)
+        rpc.shutdown()
+
+    @dist_init(setup_rpc=False)
+    def test_tensorpipe_options_throw_on_negative_large_message_pipes(self):
+        with self.assertRaisesRegex(RuntimeError, "_num_large_message_pipes"):
+            rpc.TensorPipeRpcBackendOptions(
+                init_method=self.rpc_backend_options.init_method,
+                _num_large_message_pipes=-1,
+            )
+
     # FIXME Merge this test with the corresponding one in RpcTest.
     @dist_init(setup_rpc=False)
     def test_tensorpipe_options_throw_on_timedelta_timeout(self):
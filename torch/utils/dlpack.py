@@ -1,20 +1,42 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 import torch
 
-from torch._C import _from_dlpack as from_dlpack
 from torch._C import _to_dlpack as to_dlpack
 
-torch._C._add_docstr(from_dlpack, r"""from_dlpack(dlpack) -> Tensor
+# kDLGPU of DLDeviceType.
+_DL_GPU = 2
 
-Decodes a DLPack to a tensor.
 
-Args:
-    dlpack: a PyCapsule object with the dltensor
+def from_dlpack(ext_tensor):
+    r"""from_dlpack(ext_tensor) -> Tensor
+
+    Decodes a DLPack to a tensor.
+
+    Args:
+        ext_tensor: a PyCapsule object with the dltensor, or an object that
+            implements the ``__dlpack__`` and ``__dlpack_device__`` protocol,
+            e.g. an array of another library or a tensor.
+
+    The tensor will share the memory with the object represented
+    in the dlpack.
+    Note that each dlpack can only be consumed once.
+
+    For a CUDA object exported through ``__dlpack__``, the current stream of
+    the device is passed as the consumer stream, so that the producer makes it
+    wait for the data instead of synchronizing the device.
+    """
+    if hasattr(ext_tensor, '__dlpack__'):
+        device_type, device_index = ext_tensor.__dlpack_device__()
+        if device_type == _DL_GPU:
+            stream = torch.cuda.current_stream(device_index).cuda_stream
+            # The protocol disallows 0, the legacy default stream is 1.
+            dlpack = ext_tensor.__dlpack__(stream=1 if stream == 0 else stream)
+        else:
+            dlpack = ext_tensor.__dlpack__()
+    else:
+        dlpack = ext_tensor
+    return torch._C._from_dlpack(dlpack)
 
-The tensor will share the memory with the object represented
-in the dlpack.
-Note that each dlpack can only be consumed once.
-""")
 
 torch._C._add_docstr(to_dlpack, r"""to_dlpack(tensor) -> PyCapsule
 
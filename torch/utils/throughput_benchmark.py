@@ -37,6 +37,22 @@ class ExecutionStats(object):
     def num_iters(self):
         return self._c_stats.num_iters
 
+    @property
+    def latency_p50_ms(self):
+        return self._c_stats.latency_p50_ms
+
+    @property
+    def latency_p90_ms(self):
+        return self._c_stats.latency_p90_ms
+
+    @property
+    def latency_p99_ms(self):
+        return self._c_stats.latency_p99_ms
+
+    @property
+    def latency_p999_ms(self):
+        return self._c_stats.latency_p999_ms
+
     @property
     def iters_per_second(self):
         '''
@@ -53,6 +69,10 @@ class ExecutionStats(object):
     def __str__(self):
         return '\n'.join([
             "Average latency per example: " + format_time(time_ms=self.latency_avg_ms),
+            "Latency p50 / p90 / p99 / p99.9: " + " / ".join(
+                format_time(time_ms=latency) for latency in (
+                    self.latency_p50_ms, self.latency_p90_ms,
+                    self.latency_p99_ms, self.latency_p999_ms)),
             "Total number of iterations: {}".format(self.num_iters),
             "Total number of iterations per second (across all threads): {:.2f}".format(self.iters_per_second),
             "Total time: " + format_time(time_s=self.total_time_seconds)
@@ -122,7 +142,9 @@ class ThroughputBenchmark(object):
             num_calling_threads=1,
             num_warmup_iters=10,
             num_iters=100,
-            profiler_output_path=""):
+            profiler_output_path="",
+            cpu_affinity=None,
+            target_qps=0):
         '''
         Args:
             num_warmup_iters (int): Warmup iters are used to make sure we run a module
@@ -142,16 +164,33 @@ class ThroughputBenchmark(object):
                 execution (but not the warmup phase). The full trace will be saved
                 into the file path provided by this argument
 
+            cpu_affinity (list of int, optional): CPUs to pin the calling threads to.
+                Calling thread i runs on CPU cpu_affinity[i % len(cpu_affinity)],
+                warmup included. Only supported on Linux. By default the threads
+                are not pinned
+
+            target_qps (float): If positive, the benchmark generates an open-loop load:
+                iterations are issued at this rate per second across all the calling
+                threads, regardless of how long the previous ones took, and their
+                latency is measured from the time they were scheduled at, so that
+                queueing delays are accounted for. By default every calling thread
+                starts its next iteration as soon as the previous one is done
+
 
         This function returns BenchmarkExecutionStats object which is defined via pybind11.
-        It currently has two fields:
+        It currently has the following fields:
             - num_iters - number of actual iterations the benchmark have made
             - avg_latency_ms - average time it took to infer on one input example in milliseconds
+            - latency_p50_ms, latency_p90_ms, latency_p99_ms, latency_p999_ms - percentiles
+              of the latencies of the individual iterations in milliseconds
         '''
         config = torch._C.BenchmarkConfig()
         config.num_calling_threads = num_calling_threads
         config.num_warmup_iters = num_warmup_iters
         config.num_iters = num_iters
         config.profiler_output_path = profiler_output_path
+        if cpu_affinity is not None:
+            config.cpu_affinity = list(cpu_affinity)
+        config.target_qps = target_qps
         c_stats = self._benchmark.benchmark(config)
         return ExecutionStats(c_stats, config)